@@ -127,7 +127,8 @@ AiaAlertManager_t* AiaAlertManager_Create(
 
 /**
  * Returns the alert tokens known by the @c AiaAlertManager_t instance as a
- * list of quoted strings; i.e. "token1", "token2", "token3"
+ * list of quoted strings; i.e. "token1", "token2", "token3". Tokens shorter
+ * than @c AIA_ALERT_TOKEN_CHARS are followed by whitespace padding.
  *
  * @param alertManager The @c AiaAlertManager_t to get the alert tokens from.
  * @param[out] alertTokens Buffer to hold the alert tokens.
@@ -198,4 +199,32 @@ void AiaAlertManager_Destroy( AiaAlertManager_t* alertManager );
 bool AiaAlertManager_DeleteAlert( AiaAlertManager_t* alertManager,
                                   const char* alertToken );
 
+/**
+ * Sets whether @c SetAlert and @c DeleteAlert directives are persisted
+ * immediately, or applied in memory and then persisted in a single storage
+ * transaction and acknowledged together once the whole directive message has
+ * been handled. Deferred persistence requires @c
+ * AiaAlertManager_OnDirectiveBatchHandled() to be called at the end of each
+ * directive message. It is disabled by default.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param deferPersistence Whether to defer persistence.
+ */
+void AiaAlertManager_SetDeferredPersistence( AiaAlertManager_t* alertManager,
+                                             bool deferPersistence );
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges alerts held in memory to a budget. A @c SetAlert directive for a new
+ * alert which does not fit in the budget is answered with @c SetAlertFailed.
+ * Alerts loaded from persistent storage are always kept, even over budget.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param memoryBudget The budget to charge, or @c NULL to stop charging.
+ * Alerts already held are moved to this budget even if they do not fit.
+ */
+void AiaAlertManager_SetMemoryBudget( AiaAlertManager_t* alertManager,
+                                      AiaMemoryBudget_t* memoryBudget );
+#endif
+
 #endif /* ifndef AIA_ALERT_MANAGER_H_ */
@@ -30,9 +30,6 @@
 /** This type is used to hold information relevant to an alert. */
 typedef struct AiaAlertSlot
 {
-    /** The actual link in the list. */
-    AiaListDouble( Link_t ) link;
-
     /** Type of this alert */
     AiaAlertType_t alertType;
 
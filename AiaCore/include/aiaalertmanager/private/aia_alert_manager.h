@@ -72,4 +72,16 @@ void AiaAlertManager_OnSetAlertVolumeDirectiveReceived(
     void* manager, const void* payload, size_t size,
     AiaSequenceNumber_t sequenceNumber, size_t index );
 
+/**
+ * This function may be used to notify the @c alertManager that all of the
+ * directives in a sequenced directive message have been handled. If
+ * persistence is deferred, this commits the alert changes made by the message
+ * and sends their acknowledgements.
+ *
+ * @param manager The manager instance to act on.
+ * @param sequenceNumber The sequence number of the message.
+ */
+void AiaAlertManager_OnDirectiveBatchHandled(
+    void* manager, AiaSequenceNumber_t sequenceNumber );
+
 #endif /* ifndef PRIVATE_AIA_ALERT_MANAGER_H_ */
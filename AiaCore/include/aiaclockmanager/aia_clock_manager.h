@@ -31,7 +31,11 @@
 
 /**
  * This class manages synchronization of the device clock with AIA to prevent
- * clock drift.
+ * clock drift. The one-way delay of each @c SetClock directive is estimated as
+ * half the round trip from the @c SynchronizeClock event it replies to. The
+ * drift of the local oscillator is measured across successive synchronizations
+ * and applied to the device clock in between, so that it stays accurate with
+ * infrequent synchronizations.
  *
  * @note Functions in this header which act on an @c AiaClockManager_t are
  *     thread-safe.
@@ -78,7 +82,8 @@ void AiaClockManager_Destroy( AiaClockManager_t* clockManager );
 
 /**
  * Attempts to synchronize the device clock with the AIA server. Responses from
- * the service will be sent to @c AiaClock_SetTimeMsSinceNTPEpoch.
+ * the service will be sent to @c AiaClock_SetTimeSinceNTPEpoch. The round trip
+ * is timed from this call.
  *
  * @param clockManager The @c AiaClockManager_t instance to act on.
  * @return @c true if an attempt was successfully made or @c false otherwise.
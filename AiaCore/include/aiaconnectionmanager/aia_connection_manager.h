@@ -27,6 +27,11 @@
 
 #include <aia_application_config.h>
 #include <aiaconnectionmanager/aia_connection_constants.h>
+#include <aiacore/aia_topic.h>
+
+#ifdef AIA_ENABLE_MQTT_MUX
+#include <aiacore/aia_mqtt_mux.h>
+#endif
 
 #include AiaTaskPool( HEADER )
 
@@ -80,7 +85,53 @@ AiaConnectionManager_t* AiaConnectionManager_Create(
     AiaMqttConnectionPointer_t mqttConnection, AiaTaskPool_t taskPool );
 
 /**
- * Send a Connect message to the Service.
+ * Sets the handler for messages received on one of the subscribed IoT topics
+ * in place of the @c onMqttMessageReceived passed to @c
+ * AiaConnectionManager_Create(). Since each topic is subscribed to separately,
+ * this lets messages be routed when subscribing rather than by parsing the
+ * topic of every message.
+ *
+ * @param connectionManager The connection manager instance to act on.
+ * @param topic The topic to set the handler for.
+ * @param handler The handler for messages on @c topic, or @c NULL to use @c
+ * onMqttMessageReceived again.
+ * @param userData User data to pass to @c handler.
+ * @return @c true if the handler was set, or @c false if @c topic is not
+ * subscribed to.
+ * @note This takes effect on the next call to @c
+ * AiaConnectionManager_Connect(), and must not be called concurrently with it.
+ */
+bool AiaConnectionManager_SetTopicHandler(
+    AiaConnectionManager_t* connectionManager, AiaTopic_t topic,
+    AiaMqttTopicHandler_t handler, void* userData );
+
+#ifdef AIA_ENABLE_MQTT_MUX
+/**
+ * Shares the MQTT connection with other connection managers through @c
+ * mqttMux. This routes the device topic root to this connection manager, and
+ * topics are then subscribed to with @c AiaMqttMux_MessageReceived(), which
+ * passes messages on to the handlers set by @c
+ * AiaConnectionManager_SetTopicHandler() or to @c onMqttMessageReceived. The
+ * route is removed by @c AiaConnectionManager_Destroy().
+ *
+ * @param connectionManager The connection manager instance to act on.
+ * @param mqttMux The mux of the MQTT connection passed to @c
+ * AiaConnectionManager_Create(), which must outlive the connection manager.
+ * @return @c true if the device topic root was routed, or @c false otherwise,
+ * including if another connection manager on @c mqttMux has the same device
+ * topic root or a mux was already set.
+ * @note This takes effect on the next call to @c
+ * AiaConnectionManager_Connect(), and must not be called concurrently with it.
+ */
+bool AiaConnectionManager_SetMqttMux( AiaConnectionManager_t* connectionManager,
+                                      AiaMqttMux_t* mqttMux );
+#endif
+
+/**
+ * Send a Connect message to the Service. If the Service asked the client to
+ * wait before reconnecting (see @c AIA_CONNECTION_DISCONNECT_GOING_OFFLINE),
+ * the message is instead sent once that wait, plus a per-device spread derived
+ * from the IoT Client Id, has elapsed.
  *
  * @param connectionManager The connection manager instance to act on.
  * @return @c true if the connection request is sent and connection callbacks
@@ -89,7 +140,11 @@ AiaConnectionManager_t* AiaConnectionManager_Create(
 bool AiaConnectionManager_Connect( AiaConnectionManager_t* connectionManager );
 
 /**
- * Disconnects from the Service.
+ * Disconnects from the Service. The IoT topics subscribed to by @c
+ * AiaConnectionManager_Connect() are unsubscribed from, unless built with @c
+ * AIA_ENABLE_PERSISTENT_MQTT_SUBSCRIPTIONS, in which case they are kept for
+ * the next @c AiaConnectionManager_Connect() and released by @c
+ * AiaConnectionManager_Destroy().
  *
  * @param connectionManager The connection manager instance to act on.
  * @param code The disconnect code to send to the service.
@@ -133,6 +188,30 @@ void AiaConnectionManager_OnConnectionDisconnectReceived(
     AiaConnectionManager_t* connectionManager, const char* payload,
     size_t size );
 
+/** Counters describing the activity of an @c AiaConnectionManager_t. */
+typedef struct AiaConnectionManagerMetrics
+{
+    /** The number of Connect messages sent after backing off from an
+     * unacknowledged or rejected attempt. */
+    uint32_t reconnectAttempts;
+
+    /** The number of topic subscription requests sent. Topics stay subscribed
+     * across Connect attempts, so this only grows once per connection unless
+     * subscriptions are released on disconnect. */
+    uint32_t subscribeRequests;
+} AiaConnectionManagerMetrics_t;
+
+/**
+ * Takes a snapshot of the counters of @c connectionManager. Counters wrap on
+ * overflow.
+ *
+ * @param connectionManager The connection manager instance to act on.
+ * @param[out] metrics The counters of @c connectionManager.
+ * @note This method is safe to call without external synchronization.
+ */
+void AiaConnectionManager_GetMetrics( AiaConnectionManager_t* connectionManager,
+                                      AiaConnectionManagerMetrics_t* metrics );
+
 /**
  * Releases a @c AiaConnectionManager_t previously allocated by @c
  * AiaConnectionManager_Create().
@@ -0,0 +1,236 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_audio_features.h
+ * @brief User-facing functions of the @c AiaAudioFeatures_t type.
+ *
+ * Wake word engines and voice activity detectors typically start from the same
+ * log-mel or MFCC features. @c AiaAudioFeatures_Process() computes them once
+ * per hop from the microphone @c AiaDataStreamBuffer_t and writes them to a
+ * second @c AiaDataStreamBuffer_t, each of whose words is one frame of
+ * features, so that every engine reads them through its own @c
+ * AiaDataStreamReader_t instead of running its own FFT. As in
+ * aia_pcm_resampler.h, the per-bin loops are branch-free and operate on
+ * non-aliasing split real and imaginary arrays so that compilers can vectorize
+ * them for the target without any platform-specific code.
+ */
+
+#ifndef AIA_AUDIO_FEATURES_H_
+#define AIA_AUDIO_FEATURES_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The largest FFT size, which is also the longest frame. */
+#define AIA_AUDIO_FEATURES_MAX_FFT_SIZE 512
+
+/** The most mel bands a filter bank can have. */
+#define AIA_AUDIO_FEATURES_MAX_MEL_BANDS 64
+
+/** The most cepstral coefficients which can be computed from the bands. */
+#define AIA_AUDIO_FEATURES_MAX_COEFFICIENTS 32
+
+/** How features are computed from 16-bit mono PCM. */
+typedef struct AiaAudioFeaturesConfig
+{
+    /** The sample rate of the PCM, in Hz. */
+    uint32_t sampleRate;
+
+    /** The number of samples each frame of features is computed from. */
+    size_t frameLength;
+
+    /** The number of samples between the starts of consecutive frames, from
+     * @c 1 to @c frameLength. */
+    size_t hopLength;
+
+    /** The FFT size, which must be a power of two no smaller than @c
+     * frameLength. Frames are zero-padded up to it. */
+    size_t fftSize;
+
+    /** The number of mel bands, from @c 1 to @c
+     * AIA_AUDIO_FEATURES_MAX_MEL_BANDS. */
+    size_t numMelBands;
+
+    /** The lower edge of the lowest mel band, in Hz. */
+    uint32_t lowFrequency;
+
+    /** The upper edge of the highest mel band in Hz, or @c 0 for the Nyquist
+     * frequency. */
+    uint32_t highFrequency;
+
+    /** The number of MFCCs to compute from the log-mel energies, up to @c
+     * numMelBands and @c AIA_AUDIO_FEATURES_MAX_COEFFICIENTS, or @c 0 to output
+     * the log-mel energies themselves. */
+    size_t numCoefficients;
+
+    /** The pre-emphasis coefficient, typically @c 0.97, or @c 0 for none. */
+    float preEmphasis;
+} AiaAudioFeaturesConfig_t;
+
+/**
+ * A log-mel and MFCC front end. The DC offset of each frame is removed before
+ * pre-emphasis and a Hann window are applied, and the power spectrum from a
+ * real FFT is summed into triangular mel bands whose natural logarithms are the
+ * log-mel energies. The filter bank, the FFT tables and the samples carried
+ * between hops are held in the object itself, so that nothing is allocated
+ * after @c AiaAudioFeatures_Init(). The object is about 24 KB and is typically
+ * allocated statically. Methods of this object are not thread-safe.
+ *
+ * @note The members of this struct are private and should only be accessed
+ * through the functions below.
+ */
+typedef struct AiaAudioFeatures
+{
+    /** How features are computed. */
+    AiaAudioFeaturesConfig_t config;
+
+    /** The number of floats in each frame of features. */
+    size_t numOutputs;
+
+    /** The Hann window, over @c frameLength samples. */
+    float window[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE ];
+
+    /** The input permutation of the half-size complex FFT. */
+    uint16_t bitReversed[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 ];
+
+    /** The twiddle factors of each stage of the half-size complex FFT, stored
+     * contiguously from the stage with the smallest butterflies. */
+    float twiddleReal[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 ];
+
+    /** The imaginary parts of @c twiddleReal. */
+    float twiddleImag[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 ];
+
+    /** The factors which split the half-size FFT into the real FFT. */
+    float splitReal[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 + 1 ];
+
+    /** The imaginary parts of @c splitReal. */
+    float splitImag[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 + 1 ];
+
+    /** The first FFT bin of each mel band. */
+    uint16_t melFirstBin[ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+
+    /** The number of FFT bins in each mel band. */
+    uint16_t melNumBins[ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+
+    /** The offset of the weights of each mel band in @c melWeights. */
+    uint16_t melOffset[ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+
+    /** The weights of the FFT bins of each band, which are in at most two
+     * bands each. */
+    float melWeights[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE + 2 ];
+
+    /** The DCT-II which computes MFCCs from the log-mel energies. */
+    float dct[ AIA_AUDIO_FEATURES_MAX_COEFFICIENTS ]
+             [ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+
+    /** The preprocessed frame, zero-padded to @c fftSize. */
+    float frame[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE ];
+
+    /** The real parts of the half-size FFT. */
+    float real[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 ];
+
+    /** The imaginary parts of the half-size FFT. */
+    float imag[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 ];
+
+    /** The power spectrum. */
+    float power[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE / 2 + 1 ];
+
+    /** The log-mel energies. */
+    float logMel[ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+
+    /** Samples read by @c AiaAudioFeatures_Process() for the next frame. */
+    int16_t samples[ AIA_AUDIO_FEATURES_MAX_FFT_SIZE ];
+
+    /** The number of samples in @c samples. */
+    size_t numSamples;
+} AiaAudioFeatures_t;
+
+/**
+ * Fills in a 16 kHz configuration with 25 ms frames every 10 ms, a 512 point
+ * FFT and 40 mel bands from 20 Hz to the Nyquist frequency, which outputs
+ * log-mel energies.
+ *
+ * @param[out] config The configuration to fill in.
+ */
+void AiaAudioFeatures_GetDefaultConfig( AiaAudioFeaturesConfig_t* config );
+
+/**
+ * Initializes a front end and computes its filter bank and FFT tables.
+ *
+ * @param[out] features The front end to initialize.
+ * @param config How features are computed.
+ * @return @c true if the front end was initialized or @c false otherwise,
+ * including if a mel band would not contain any FFT bin.
+ */
+bool AiaAudioFeatures_Init( AiaAudioFeatures_t* features,
+                            const AiaAudioFeaturesConfig_t* config );
+
+/**
+ * Discards the samples carried between calls to @c AiaAudioFeatures_Process(),
+ * e.g. after its reader has been moved with @c AiaDataStreamReader_Seek().
+ *
+ * @param features The front end to act on.
+ */
+void AiaAudioFeatures_Reset( AiaAudioFeatures_t* features );
+
+/**
+ * @param features The front end to act on.
+ * @return The size of one frame of features in bytes, which is the word size
+ * of the @c AiaDataStreamBuffer_t written by @c AiaAudioFeatures_Process().
+ */
+size_t AiaAudioFeatures_GetFrameSize( const AiaAudioFeatures_t* features );
+
+/**
+ * Computes one frame of features.
+ *
+ * @param features The front end to act on.
+ * @param samples The @c frameLength samples to compute features from.
+ * @param[out] output The @c AiaAudioFeatures_GetFrameSize() bytes of features.
+ * @return @c true if features were computed, else @c false.
+ */
+bool AiaAudioFeatures_Compute( AiaAudioFeatures_t* features,
+                               const int16_t* samples, float* output );
+
+/**
+ * Computes the features of every hop available from @c pcmReader and writes
+ * them to @c featureWriter, one word per frame. The first frame starts at the
+ * first sample read, and the samples of a frame which is not complete yet are
+ * kept for the next call. Frames which @c featureWriter could not write are
+ * logged and dropped, so a @c AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE writer
+ * keeps slow consumers from stalling the others.
+ *
+ * @param features The front end to act on.
+ * @param pcmReader A reader of 16-bit mono PCM.
+ * @param featureWriter A writer whose word size is @c
+ * AiaAudioFeatures_GetFrameSize().
+ * @return The number of frames computed, or if there were none, the result of
+ * the last read from @c pcmReader, i.e. zero once the stream has closed or a
+ * negative @c AiaDataStreamReaderError_t. Samples kept for the next frame are
+ * discarded on @c AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN.
+ */
+ssize_t AiaAudioFeatures_Process( AiaAudioFeatures_t* features,
+                                  AiaDataStreamReader_t* pcmReader,
+                                  AiaDataStreamWriter_t* featureWriter );
+
+#endif /* ifndef AIA_AUDIO_FEATURES_H_ */
@@ -37,4 +37,39 @@
 AiaDurationMs_t AiaBackoff_GetBackoffTimeMilliseconds(
     size_t retryNum, AiaDurationMs_t maxBackoff );
 
+/**
+ * Get a backoff time before retrying an action using decorrelated jitter. Each
+ * backoff is drawn uniformly from [@c baseBackoff, 3 * @c previousBackoff] and
+ * capped at @c maxBackoff, so that clients which started retrying at the same
+ * time drift apart instead of retrying in lockstep. The first backoff is drawn
+ * from [@c baseBackoff, 3 * @c baseBackoff].
+ *
+ * @param previousBackoff The backoff time returned for the previous retry
+ * attempt, or @c 0 for the first retry attempt.
+ * @param baseBackoff The minimum backoff time able to return.
+ * @param maxBackoff The maximum backoff time able to return.
+ *
+ * @return The backoff time in milliseconds, or @c 0 if @c baseBackoff or @c
+ * maxBackoff is @c 0.
+ */
+AiaDurationMs_t AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+    AiaDurationMs_t previousBackoff, AiaDurationMs_t baseBackoff,
+    AiaDurationMs_t maxBackoff );
+
+/**
+ * Get a deterministic delay in [0, @c maxSpread) derived from @c seed. Seeding
+ * this with a per-device identifier spreads the retries of a fleet of devices
+ * over @c maxSpread while keeping each device's own delay stable.
+ *
+ * @param seed The bytes to derive the delay from.
+ * @param seedLen The number of bytes in @c seed.
+ * @param maxSpread The exclusive upper bound of the delay.
+ *
+ * @return The delay in milliseconds, or @c 0 if @c seed is @c NULL or @c
+ * maxSpread is @c 0.
+ */
+AiaDurationMs_t AiaBackoff_GetSpreadMilliseconds( const char *seed,
+                                                  size_t seedLen,
+                                                  AiaDurationMs_t maxSpread );
+
 #endif /* ifndef AIA_BACKOFF_H_ */
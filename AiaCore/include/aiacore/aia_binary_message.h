@@ -95,13 +95,127 @@ AiaBinaryMessage_t* AiaBinaryMessage_Create( AiaBinaryMessageLength_t length,
 
 /**
  * Uninitializes and deallocates a binary message previously created by a call
- * to
- * @c AiaBinaryMessage_Create().
+ * to @c AiaBinaryMessage_Create(), or returns a message created by a call to @c
+ * AiaBinaryMessagePool_CreateMessage() to its pool.
  *
  * @param binaryMessage The binary message to destroy.
  */
 void AiaBinaryMessage_Destroy( AiaBinaryMessage_t* binaryMessage );
 
+/**
+ * Allocates a data buffer of @c capacity bytes from the heap, together with
+ * the binary message which will carry it, in a single allocation. The buffer is
+ * zeroed. It must either be handed to @c AiaBinaryMessage_CreateInline() or
+ * released with @c AiaBinaryMessage_FreeInline().
+ *
+ * @param capacity The size (in bytes) of the data buffer.
+ * @return A data buffer, or @c NULL on failure.
+ */
+void* AiaBinaryMessage_AllocateInline( size_t capacity );
+
+/**
+ * Deallocates an unused data buffer previously allocated with @c
+ * AiaBinaryMessage_AllocateInline().
+ *
+ * @param data The data buffer to deallocate.
+ */
+void AiaBinaryMessage_FreeInline( void* data );
+
+/**
+ * Initializes the binary message which carries @c data inline. Messages created
+ * with this function should be released using @c AiaBinaryMessage_Destroy(),
+ * which frees the message and @c data together.
+ *
+ * @param length The length of @c data. This may not exceed the @c capacity
+ * that @c data was allocated with.
+ * @param type The "type" of this binary stream message.
+ * @param count The number of binary stream data chunks included in this
+ * message.
+ * @param data A data buffer allocated using @c
+ * AiaBinaryMessage_AllocateInline(). Ownership of @c data is transferred upon
+ * success. On failure, @c data remains owned by the caller.
+ * @return The binary message if successful, else NULL.
+ */
+AiaBinaryMessage_t* AiaBinaryMessage_CreateInline(
+    AiaBinaryMessageLength_t length, AiaBinaryMessageType_t type,
+    AiaBinaryMessageCount_t count, void* data );
+
+/**
+ * A fixed-capacity pool of binary messages and the data buffers they carry.
+ * Producers which emit binary messages at a steady rate (e.g. microphone
+ * streaming) can use this to avoid a heap allocation per message. Messages
+ * created from a pool are released using @c AiaBinaryMessage_Destroy() like any
+ * other message, which returns them and their data to the pool rather than the
+ * heap. Methods of this object are thread-safe.
+ */
+typedef struct AiaBinaryMessagePool AiaBinaryMessagePool_t;
+
+/**
+ * Allocates and initializes a new @c AiaBinaryMessagePool_t, including all of
+ * its messages and data buffers, from the heap. The returned pointer should be
+ * destroyed using @c AiaBinaryMessagePool_Destroy().
+ *
+ * @param numMessages The number of messages the pool can have outstanding at
+ * once.
+ * @param dataBufferSize The size (in bytes) of the data buffer backing each
+ * message.
+ * @return The newly created pool if successful, else @c NULL.
+ */
+AiaBinaryMessagePool_t* AiaBinaryMessagePool_Create( size_t numMessages,
+                                                     size_t dataBufferSize );
+
+/**
+ * Uninitializes and deallocates a pool previously created by a call to @c
+ * AiaBinaryMessagePool_Create(). Messages acquired from @c pool may still be
+ * outstanding (e.g. queued in an @c AiaRegulator_t), in which case deallocation
+ * is deferred until the last of them has been destroyed.
+ *
+ * @param pool The pool to destroy.
+ */
+void AiaBinaryMessagePool_Destroy( AiaBinaryMessagePool_t* pool );
+
+/**
+ * Acquires an unused data buffer of @c dataBufferSize bytes from the pool. The
+ * buffer is not zeroed. It must either be handed to @c
+ * AiaBinaryMessagePool_CreateMessage() or returned with @c
+ * AiaBinaryMessagePool_ReleaseData().
+ *
+ * @param pool The pool to acquire from.
+ * @return A data buffer, or @c NULL if all of the buffers in @c pool are in
+ * use.
+ */
+void* AiaBinaryMessagePool_AcquireData( AiaBinaryMessagePool_t* pool );
+
+/**
+ * Returns an unused data buffer previously acquired with @c
+ * AiaBinaryMessagePool_AcquireData() to the pool.
+ *
+ * @param pool The pool @c data was acquired from.
+ * @param data The data buffer to return.
+ */
+void AiaBinaryMessagePool_ReleaseData( AiaBinaryMessagePool_t* pool,
+                                       void* data );
+
+/**
+ * Initializes the pooled binary message which carries @c data. Messages created
+ * with this function should be released using @c AiaBinaryMessage_Destroy(),
+ * which will return both the message and @c data to @c pool.
+ *
+ * @param pool The pool @c data was acquired from.
+ * @param length The length of @c data. This may not exceed the @c
+ * dataBufferSize of @c pool.
+ * @param type The "type" of this binary stream message.
+ * @param count The number of binary stream data chunks included in this
+ * message.
+ * @param data A data buffer acquired using @c
+ * AiaBinaryMessagePool_AcquireData(). Ownership of @c data is transferred upon
+ * success. On failure, @c data remains owned by the caller.
+ * @return The binary message if successful, else NULL.
+ */
+AiaBinaryMessage_t* AiaBinaryMessagePool_CreateMessage(
+    AiaBinaryMessagePool_t* pool, AiaBinaryMessageLength_t length,
+    AiaBinaryMessageType_t type, AiaBinaryMessageCount_t count, void* data );
+
 /**
  * Returns the "length" field of the binary message.
  *
@@ -156,4 +270,69 @@ bool AiaBinaryMessage_BuildMessage( const AiaBinaryMessage_t* binaryMessage,
                                     uint8_t* messageBuffer,
                                     size_t messageBufferSize );
 
+/**
+ * A zero-copy view of one entry of a serialized Aia binary stream, as produced
+ * by @c AiaBinaryMessage_BuildMessage().
+ */
+typedef struct AiaBinaryStreamEntry
+{
+    /** The "length" field of the entry. */
+    AiaBinaryMessageLength_t length;
+
+    /** The "type" field of the entry. */
+    AiaBinaryMessageType_t type;
+
+    /** The "count" field of the entry. */
+    AiaBinaryMessageCount_t count;
+
+    /** The @c length bytes of data of the entry, pointing into the stream. */
+    const uint8_t* data;
+} AiaBinaryStreamEntry_t;
+
+/**
+ * Walks the entries of a serialized Aia binary stream without copying them.
+ * This should be initialized with @c AiaBinaryStreamIterator_Init() and is
+ * only valid for as long as the stream it iterates over.
+ */
+typedef struct AiaBinaryStreamIterator
+{
+    /** The header of the next entry. */
+    const uint8_t* next;
+
+    /** The end of the stream. */
+    const uint8_t* end;
+} AiaBinaryStreamIterator_t;
+
+/**
+ * Initializes an iterator positioned at the first entry of a stream.
+ *
+ * @param[out] iterator The iterator to initialize.
+ * @param stream The serialized binary stream.
+ * @param size The size of @c stream.
+ */
+void AiaBinaryStreamIterator_Init( AiaBinaryStreamIterator_t* iterator,
+                                   const uint8_t* stream, size_t size );
+
+/**
+ * Checks whether any bytes of the stream remain to be iterated over.
+ *
+ * @param iterator The iterator to act on.
+ * @return @c true if @c AiaBinaryStreamIterator_Next() should be called again,
+ * or @c false at the end of the stream.
+ */
+bool AiaBinaryStreamIterator_HasNext(
+    const AiaBinaryStreamIterator_t* iterator );
+
+/**
+ * Parses the next entry of the stream and advances past it.
+ *
+ * @param iterator The iterator to act on.
+ * @param[out] entry The parsed entry, whose data points into the stream.
+ * @return @c true if an entry was parsed, or @c false if the remaining bytes
+ * are too short to hold its header or its data. The iterator is not advanced
+ * on failure.
+ */
+bool AiaBinaryStreamIterator_Next( AiaBinaryStreamIterator_t* iterator,
+                                   AiaBinaryStreamEntry_t* entry );
+
 #endif /* ifndef AIA_BINARY_MESSAGE_H_ */
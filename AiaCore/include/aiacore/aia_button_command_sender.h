@@ -75,10 +75,26 @@ void AiaButtonCommandSender_Destroy(
  *
  * @param buttonCommandSender The @c AiaButtonCommandSender_t to act on.
  * @param button The button that was pressed.
- * @return @c true if an event was successfully sent downstream or @c false
- * otherwise.
+ * @return @c true if an event was successfully sent downstream, or the press
+ * was coalesced into a pending event, or @c false otherwise.
  */
 bool AiaButtonCommandSender_OnButtonPressed(
     AiaButtonCommandSender_t* buttonCommandSender, AiaButtonCommand_t button );
 
+/**
+ * Sets how long button presses are coalesced for. Rapid presses, such as those
+ * from a rotary encoder or a repeating key, are then collected into a burst
+ * which starts with the first press and lasts for @c windowMs. A single @c
+ * ButtonCommandIssued event is sent at the end of the burst for the last button
+ * pressed, and local playback is stopped at most once per burst. Presses are
+ * not coalesced by default.
+ *
+ * @param buttonCommandSender The @c AiaButtonCommandSender_t to act on.
+ * @param windowMs The length of a burst in milliseconds, or zero to send an
+ * event for every press.
+ * @return @c true if the window was set or @c false otherwise.
+ */
+bool AiaButtonCommandSender_SetCoalescingWindow(
+    AiaButtonCommandSender_t* buttonCommandSender, AiaDurationMs_t windowMs );
+
 #endif /* ifndef AIA_BUTTON_COMMAND_SENDER_H_ */
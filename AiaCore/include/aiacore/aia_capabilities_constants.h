@@ -57,6 +57,14 @@
 #define AIA_CAPABILITIES_MICROPHONE_AUDIO_ENCODER "audioEncoder"
 #define AIA_CAPABILITIES_MICROPHONE_AUDIO_FORMAT \
     AIA_CAPABILITIES_SPEAKER_AUDIO_FORMAT
+#define AIA_CAPABILITIES_MICROPHONE_AUDIO_BITRATE \
+    AIA_CAPABILITIES_SPEAKER_AUDIO_BITRATE
+#define AIA_CAPABILITIES_MICROPHONE_AUDIO_TYPE \
+    AIA_CAPABILITIES_SPEAKER_AUDIO_TYPE
+#define AIA_CAPABILITIES_MICROPHONE_AUDIO_BITS_PER_SECOND \
+    AIA_CAPABILITIES_SPEAKER_AUDIO_BITS_PER_SECOND
+#define AIA_CAPABILITIES_MICROPHONE_NUM_CHANNELS \
+    AIA_CAPABILITIES_SPEAKER_NUM_CHANNELS
 
 #define AIA_ALERTS_VERSION "1.0"
 #define AIA_CAPABILITIES_ALERTS "Alerts"
@@ -0,0 +1,135 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_container.h
+ * @brief Type-specialized containers over caller-provided storage.
+ */
+
+#ifndef AIA_CONTAINER_H_
+#define AIA_CONTAINER_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * The macros below generate a container type named @c NAME_t holding elements
+ * of type @c TYPE by value, along with @c static @c inline functions named @c
+ * NAME_Verb that act on it. Elements live in an array supplied to @c
+ * NAME_Init(), typically embedded in the owning object, so that adding or
+ * removing elements never allocates and neighbouring elements share cache
+ * lines. Containers have a fixed capacity and report when they are full rather
+ * than growing. Methods of these containers are not thread-safe.
+ */
+
+/**
+ * Generates a first-in first-out ring of elements.
+ *
+ * - @c NAME_Init( ring, storage, capacity ) uses @c capacity elements at @c
+ *   storage.
+ * - @c NAME_PushBack( ring ) returns the element appended at the back for the
+ *   caller to fill in, or @c NULL if the ring is full.
+ * - @c NAME_Front( ring ) and @c NAME_At( ring, index ) return the element at
+ *   the front or @c index elements behind it, or @c NULL if there is none.
+ * - @c NAME_PopFront( ring ) removes the element at the front.
+ * - @c NAME_Size(), @c NAME_IsEmpty(), @c NAME_IsFull() and @c NAME_Clear()
+ *   do what their names say.
+ */
+#define AIA_DEFINE_RING( NAME, TYPE )                              \
+    typedef struct NAME                                            \
+    {                                                              \
+        TYPE* elements;                                            \
+        size_t capacity;                                           \
+        size_t head;                                               \
+        size_t size;                                               \
+    } NAME##_t;                                                    \
+                                                                   \
+    static inline void NAME##_Init( NAME##_t* ring, TYPE* storage, \
+                                    size_t capacity )              \
+    {                                                              \
+        ring->elements = storage;                                  \
+        ring->capacity = capacity;                                 \
+        ring->head = 0;                                            \
+        ring->size = 0;                                            \
+    }                                                              \
+                                                                   \
+    static inline size_t NAME##_Size( const NAME##_t* ring )       \
+    {                                                              \
+        return ring->size;                                         \
+    }                                                              \
+                                                                   \
+    static inline bool NAME##_IsEmpty( const NAME##_t* ring )      \
+    {                                                              \
+        return !ring->size;                                        \
+    }                                                              \
+                                                                   \
+    static inline bool NAME##_IsFull( const NAME##_t* ring )       \
+    {                                                              \
+        return ring->size == ring->capacity;                       \
+    }                                                              \
+                                                                   \
+    static inline TYPE* NAME##_At( NAME##_t* ring, size_t index )  \
+    {                                                              \
+        if( index >= ring->size )                                  \
+        {                                                          \
+            return NULL;                                           \
+        }                                                          \
+        index += ring->head;                                       \
+        if( index >= ring->capacity )                              \
+        {                                                          \
+            index -= ring->capacity;                               \
+        }                                                          \
+        return &ring->elements[ index ];                           \
+    }                                                              \
+                                                                   \
+    static inline TYPE* NAME##_Front( NAME##_t* ring )             \
+    {                                                              \
+        return NAME##_At( ring, 0 );                               \
+    }                                                              \
+                                                                   \
+    static inline TYPE* NAME##_PushBack( NAME##_t* ring )          \
+    {                                                              \
+        if( ring->size == ring->capacity )                         \
+        {                                                          \
+            return NULL;                                           \
+        }                                                          \
+        ++ring->size;                                              \
+        return NAME##_At( ring, ring->size - 1 );                  \
+    }                                                              \
+                                                                   \
+    static inline void NAME##_PopFront( NAME##_t* ring )           \
+    {                                                              \
+        if( !ring->size )                                          \
+        {                                                          \
+            return;                                                \
+        }                                                          \
+        if( ++ring->head == ring->capacity )                       \
+        {                                                          \
+            ring->head = 0;                                        \
+        }                                                          \
+        --ring->size;                                              \
+    }                                                              \
+                                                                   \
+    static inline void NAME##_Clear( NAME##_t* ring )              \
+    {                                                              \
+        ring->head = 0;                                            \
+        ring->size = 0;                                            \
+    }
+
+#endif /* ifndef AIA_CONTAINER_H_ */
@@ -32,7 +32,40 @@
 #include <stdint.h>
 
 /**
- * One time initialization for encryption/decryption functions.
+ * An independently keyed encryption/decryption context. Each context holds its
+ * own pre-expanded key so that operations on different contexts may proceed in
+ * parallel without re-keying. Methods of this object are not thread-safe;
+ * callers must serialize access to a given context.
+ *
+ * Encrypting with a context does not draw from the shared random number
+ * generator: 96-bit IVs are built from a random field drawn when the key is set
+ * followed by a per-context counter.
+ */
+typedef struct AiaCryptoMbedtlsContext AiaCryptoMbedtlsContext_t;
+
+/**
+ * A region of a message encrypted or decrypted as part of a scatter/gather
+ * operation. The regions of an operation are processed as one contiguous
+ * message, in order.
+ */
+typedef struct AiaCryptoMbedtlsSegment
+{
+    /** The data to encrypt or decrypt. */
+    const uint8_t *input;
+
+    /** The buffer to write the result to. This may be the same as @c input. */
+    uint8_t *output;
+
+    /** The size of @c input and of @c output. */
+    size_t length;
+} AiaCryptoMbedtlsSegment_t;
+
+/**
+ * One time initialization for encryption/decryption functions. This seeds the
+ * random number generator used for key pairs and initialization vectors. When
+ * built with @c AIA_ENABLE_ASYNC_CRYPTO_SEED, seeding runs on a background job
+ * instead so that startup can proceed, and the first function to need random
+ * numbers waits for it. Setting keys and decrypting never need random numbers.
  *
  * @return @c true if the initialization is successful, else @c false.
  */
@@ -59,6 +92,76 @@ bool AiaCryptoMbedtls_Decrypt( const uint8_t *inputData, const size_t inputLen,
                                const size_t ivLen, const uint8_t *tag,
                                const size_t tagLen );
 
+/**
+ * @copyDoc AiaCrypto_CreateContext()
+ */
+AiaCryptoMbedtlsContext_t *AiaCryptoMbedtls_CreateContext();
+
+/**
+ * @copyDoc AiaCrypto_SetContextKey()
+ */
+bool AiaCryptoMbedtls_SetContextKey(
+    AiaCryptoMbedtlsContext_t *context, const uint8_t *encryptKey,
+    size_t encryptKeySize, const AiaEncryptionAlgorithm_t encryptAlgorithm );
+
+/**
+ * @copyDoc AiaCrypto_EncryptWithContext()
+ */
+bool AiaCryptoMbedtls_EncryptWithContext( AiaCryptoMbedtlsContext_t *context,
+                                          const uint8_t *inputData,
+                                          const size_t inputLen,
+                                          uint8_t *outputData, uint8_t *iv,
+                                          size_t ivLen, uint8_t *tag,
+                                          const size_t tagLen );
+
+/**
+ * @copyDoc AiaCrypto_DecryptWithContext()
+ */
+bool AiaCryptoMbedtls_DecryptWithContext(
+    AiaCryptoMbedtlsContext_t *context, const uint8_t *inputData,
+    const size_t inputLen, uint8_t *outputData, const uint8_t *iv,
+    const size_t ivLen, const uint8_t *tag, const size_t tagLen );
+
+/**
+ * Encrypts the concatenation of @c segments using the key set on @c context.
+ *
+ * @param context The context to encrypt with.
+ * @param segments The regions of the message to encrypt.
+ * @param numSegments The number of entries in @c segments.
+ * @param [out] iv The initialization vector generated for the message.
+ * @param ivLen The length of @c iv.
+ * @param [out] tag The tag generated for the message.
+ * @param tagLen The length of @c tag.
+ * @return @c true if encryption is successful, else @c false.
+ */
+bool AiaCryptoMbedtls_EncryptSegmentsWithContext(
+    AiaCryptoMbedtlsContext_t *context,
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments, uint8_t *iv,
+    size_t ivLen, uint8_t *tag, size_t tagLen );
+
+/**
+ * Decrypts the concatenation of @c segments using the key set on @c context.
+ * If the tag does not match, the output of every segment is zeroed.
+ *
+ * @param context The context to decrypt with.
+ * @param segments The regions of the message to decrypt.
+ * @param numSegments The number of entries in @c segments.
+ * @param iv The initialization vector of the message.
+ * @param ivLen The length of @c iv.
+ * @param tag The tag to verify.
+ * @param tagLen The length of @c tag.
+ * @return @c true if decryption is successful, else @c false.
+ */
+bool AiaCryptoMbedtls_DecryptSegmentsWithContext(
+    AiaCryptoMbedtlsContext_t *context,
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments,
+    const uint8_t *iv, size_t ivLen, const uint8_t *tag, size_t tagLen );
+
+/**
+ * @copyDoc AiaCrypto_DestroyContext()
+ */
+void AiaCryptoMbedtls_DestroyContext( AiaCryptoMbedtlsContext_t *context );
+
 /**
  * @copyDoc AiaCrypto_GenerateKeyPair()
  */
@@ -67,8 +67,10 @@ typedef enum AiaDirective
 #endif
 #ifdef AIA_ENABLE_CLOCK
     /** Tells the device to set its clock to the provided time. */
-    AIA_DIRECTIVE_SET_CLOCK
+    AIA_DIRECTIVE_SET_CLOCK,
 #endif
+    /** Number of directives used in this SDK (not a real directive). */
+    AIA_NUM_DIRECTIVES
 } AiaDirective_t;
 
 /**
@@ -91,6 +93,39 @@ typedef enum AiaDirective
 
 /** @} */
 
+/** The number of slots in the directive name hash table. */
+#define AIA_DIRECTIVE_HASH_SLOTS 32
+
+/**
+ * Hashes a directive name from its length and its first and last characters.
+ * The multipliers were chosen so that every directive name maps to a distinct
+ * slot, which allows @c AiaDirective_FromString() to find a directive with a
+ * single comparison. This is usable in constant expressions so that the hash
+ * table can be built at compile time.
+ *
+ * @param length The length of the directive name.
+ * @param first The first character of the directive name.
+ * @param last The last character of the directive name.
+ * @return The hash table slot for the directive name.
+ */
+#define AIA_DIRECTIVE_HASH( length, first, last )                     \
+    ( ( 2 * (size_t)( length ) + 3 * (size_t)(unsigned char)( first ) + \
+        (size_t)(unsigned char)( last ) ) %                           \
+      AIA_DIRECTIVE_HASH_SLOTS )
+
+/**
+ * Declares the hash table entry for a directive. Entries hold the directive
+ * value plus one so that empty slots are zero.
+ *
+ * @param DIRECTIVE The @c AiaDirective_t value without the @c AIA_DIRECTIVE_
+ * prefix.
+ * @param first The first character of the directive name.
+ * @param last The last character of the directive name.
+ */
+#define AIA_DIRECTIVE_HASH_ENTRY( DIRECTIVE, first, last )                   \
+    [AIA_DIRECTIVE_HASH( sizeof( AIA_DIRECTIVE_##DIRECTIVE##_STRING ) - 1, \
+                         first, last )] = AIA_DIRECTIVE_##DIRECTIVE + 1
+
 /**
  * @param directive A directive to get the string representation of.
  * @return The string representation of @c directive.
@@ -131,6 +166,8 @@ inline const char* AiaDirective_ToString( AiaDirective_t directive )
             return AIA_DIRECTIVE_SET_ATTENTION_STATE_STRING;
         case AIA_DIRECTIVE_EXCEPTION:
             return AIA_DIRECTIVE_EXCEPTION_STRING;
+        case AIA_NUM_DIRECTIVES:
+            break;
     }
     AiaLogError( "Unknown directive %d.", directive );
     AiaAssert( false );
@@ -178,6 +215,8 @@ inline size_t AiaDirective_GetLength( AiaDirective_t directive )
             return sizeof( AIA_DIRECTIVE_SET_ATTENTION_STATE_STRING ) - 1;
         case AIA_DIRECTIVE_EXCEPTION:
             return sizeof( AIA_DIRECTIVE_EXCEPTION_STRING ) - 1;
+        case AIA_NUM_DIRECTIVES:
+            break;
     }
     AiaLogError( "Unknown directive %d.", directive );
     AiaAssert( false );
@@ -196,23 +235,29 @@ inline bool AiaDirective_FromString( const char* directiveString,
                                      size_t directiveStringLength,
                                      AiaDirective_t* directive )
 {
-    static const AiaDirective_t directives[] = {
+    /* A colliding entry is a duplicate initializer, which -Woverride-init
+     * reports at compile time. */
+    static const uint8_t directiveSlots[ AIA_DIRECTIVE_HASH_SLOTS ] = {
 #ifdef AIA_ENABLE_SPEAKER
-        AIA_DIRECTIVE_OPEN_SPEAKER,     AIA_DIRECTIVE_CLOSE_SPEAKER,
-        AIA_DIRECTIVE_SET_VOLUME,
+        AIA_DIRECTIVE_HASH_ENTRY( OPEN_SPEAKER, 'O', 'r' ),
+        AIA_DIRECTIVE_HASH_ENTRY( CLOSE_SPEAKER, 'C', 'r' ),
+        AIA_DIRECTIVE_HASH_ENTRY( SET_VOLUME, 'S', 'e' ),
 #endif
 #ifdef AIA_ENABLE_MICROPHONE
-        AIA_DIRECTIVE_OPEN_MICROPHONE,  AIA_DIRECTIVE_CLOSE_MICROPHONE,
+        AIA_DIRECTIVE_HASH_ENTRY( OPEN_MICROPHONE, 'O', 'e' ),
+        AIA_DIRECTIVE_HASH_ENTRY( CLOSE_MICROPHONE, 'C', 'e' ),
 #endif
 #ifdef AIA_ENABLE_ALERTS
-        AIA_DIRECTIVE_SET_ALERT_VOLUME, AIA_DIRECTIVE_SET_ALERT,
-        AIA_DIRECTIVE_DELETE_ALERT,
+        AIA_DIRECTIVE_HASH_ENTRY( SET_ALERT_VOLUME, 'S', 'e' ),
+        AIA_DIRECTIVE_HASH_ENTRY( SET_ALERT, 'S', 't' ),
+        AIA_DIRECTIVE_HASH_ENTRY( DELETE_ALERT, 'D', 't' ),
 #endif
 #ifdef AIA_ENABLE_CLOCK
-        AIA_DIRECTIVE_SET_CLOCK,
+        AIA_DIRECTIVE_HASH_ENTRY( SET_CLOCK, 'S', 'k' ),
 #endif
-        AIA_DIRECTIVE_ROTATE_SECRET,    AIA_DIRECTIVE_SET_ATTENTION_STATE,
-        AIA_DIRECTIVE_EXCEPTION
+        AIA_DIRECTIVE_HASH_ENTRY( ROTATE_SECRET, 'R', 't' ),
+        AIA_DIRECTIVE_HASH_ENTRY( SET_ATTENTION_STATE, 'S', 'e' ),
+        AIA_DIRECTIVE_HASH_ENTRY( EXCEPTION, 'E', 'n' )
     };
 
     if( !directiveString )
@@ -229,15 +274,21 @@ inline bool AiaDirective_FromString( const char* directiveString,
     {
         directiveStringLength = strlen( directiveString );
     }
-    for( size_t i = 0; i < AiaArrayLength( directives ); ++i )
+    if( directiveStringLength )
     {
-        if( AiaDirective_GetLength( directives[ i ] ) ==
-                directiveStringLength &&
-            strncmp( directiveString, AiaDirective_ToString( directives[ i ] ),
-                     directiveStringLength ) == 0 )
+        uint8_t slot = directiveSlots[ AIA_DIRECTIVE_HASH(
+            directiveStringLength, directiveString[ 0 ],
+            directiveString[ directiveStringLength - 1 ] ) ];
+        if( slot )
         {
-            *directive = directives[ i ];
-            return true;
+            AiaDirective_t candidate = (AiaDirective_t)( slot - 1 );
+            if( AiaDirective_GetLength( candidate ) == directiveStringLength &&
+                strncmp( directiveString, AiaDirective_ToString( candidate ),
+                         directiveStringLength ) == 0 )
+            {
+                *directive = candidate;
+                return true;
+            }
         }
     }
     AiaLogError( "Unknown directiveString \"%.*s\".", directiveStringLength,
@@ -0,0 +1,103 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_endian.h
+ * @brief Loads and stores of little-endian integers in byte buffers.
+ *
+ * Aia binary streams are little-endian and their fields are not aligned. These
+ * functions copy through @c memcpy(), which compilers turn into a single
+ * unaligned load or store, and only swap bytes on big-endian targets.
+ */
+
+#ifndef AIA_ENDIAN_H_
+#define AIA_ENDIAN_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+/** Converts between host and little-endian byte order. */
+/** @{ */
+#define AIA_ENDIAN_LE16( value ) __builtin_bswap16( value )
+#define AIA_ENDIAN_LE32( value ) __builtin_bswap32( value )
+#define AIA_ENDIAN_LE64( value ) __builtin_bswap64( value )
+/** @} */
+#else
+#define AIA_ENDIAN_LE16( value ) ( value )
+#define AIA_ENDIAN_LE32( value ) ( value )
+#define AIA_ENDIAN_LE64( value ) ( value )
+#endif
+
+/**
+ * Reads a little-endian integer from a byte buffer.
+ *
+ * @param bytes The buffer to read from, which need not be aligned.
+ * @return The integer in host byte order.
+ */
+/** @{ */
+inline uint16_t AiaEndian_LoadLe16( const uint8_t* bytes )
+{
+    uint16_t value;
+    memcpy( &value, bytes, sizeof( value ) );
+    return AIA_ENDIAN_LE16( value );
+}
+
+inline uint32_t AiaEndian_LoadLe32( const uint8_t* bytes )
+{
+    uint32_t value;
+    memcpy( &value, bytes, sizeof( value ) );
+    return AIA_ENDIAN_LE32( value );
+}
+
+inline uint64_t AiaEndian_LoadLe64( const uint8_t* bytes )
+{
+    uint64_t value;
+    memcpy( &value, bytes, sizeof( value ) );
+    return AIA_ENDIAN_LE64( value );
+}
+/** @} */
+
+/**
+ * Writes an integer to a byte buffer in little-endian byte order.
+ *
+ * @param[out] bytes The buffer to write to, which need not be aligned.
+ * @param value The integer in host byte order.
+ */
+/** @{ */
+inline void AiaEndian_StoreLe16( uint8_t* bytes, uint16_t value )
+{
+    value = AIA_ENDIAN_LE16( value );
+    memcpy( bytes, &value, sizeof( value ) );
+}
+
+inline void AiaEndian_StoreLe32( uint8_t* bytes, uint32_t value )
+{
+    value = AIA_ENDIAN_LE32( value );
+    memcpy( bytes, &value, sizeof( value ) );
+}
+
+inline void AiaEndian_StoreLe64( uint8_t* bytes, uint64_t value )
+{
+    value = AIA_ENDIAN_LE64( value );
+    memcpy( bytes, &value, sizeof( value ) );
+}
+/** @} */
+
+#endif /* ifndef AIA_ENDIAN_H_ */
@@ -124,4 +124,21 @@
  */
 #define AIA_EVENTS_EXCEPTION_ENCOUNTERED "ExceptionEncountered"
 
+/**
+ * @name Supersede keys of events which only report the latest value of some
+ * state.  A queued event with one of these keys is replaced by a newer one
+ * with the same key, see @c AiaMessage_SetSupersedeKey().
+ */
+/** @{ */
+#define AIA_EVENTS_BUFFER_STATE_CHANGED_SUPERSEDE_KEY 1
+#define AIA_EVENTS_VOLUME_CHANGED_SUPERSEDE_KEY 2
+#define AIA_EVENTS_ALERT_VOLUME_CHANGED_SUPERSEDE_KEY 3
+/** @} */
+
+/**
+ * Identifies @c SpeakerMarkerEncountered events for age-based expiry.  Every
+ * marker must be reported, so the client opts this key out of superseding.
+ */
+#define AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED_SUPERSEDE_KEY 4
+
 #endif /* ifndef AIA_EVENTS_H_ */
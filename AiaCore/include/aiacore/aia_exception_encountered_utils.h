@@ -43,6 +43,24 @@ required to free the returned message using @c AiaJsonMessage_Destroy().
 AiaJsonMessage_t* generateMalformedMessageExceptionEncounteredEvent(
     AiaSequenceNumber_t sequenceNumber, size_t index, AiaTopic_t topic );
 
+/**
+ * Generates a @c MALFORMED_MESSAGE @c ExceptionEncountered event which stands
+in for a run of malformed messages on the same topic. The count and the range of
+sequence numbers of the run are carried in the error description.
+ *
+ * @param firstSequenceNumber The sequence number of the first message in the
+run.
+ * @param sequenceNumber The sequence number of the last message in the run.
+ * @param index The index of the last message in the run.
+ * @param topic The topic that the exceptions occurred on.
+ * @param count The number of malformed messages in the run.
+ * @return The generated @c AiaJsonMessage_t or @c NULL on failures. Callers are
+required to free the returned message using @c AiaJsonMessage_Destroy().
+ */
+AiaJsonMessage_t* generateCoalescedMalformedMessageExceptionEncounteredEvent(
+    AiaSequenceNumber_t firstSequenceNumber, AiaSequenceNumber_t sequenceNumber,
+    size_t index, AiaTopic_t topic, size_t count );
+
 /* TODO: ADSER-1578 Add support for adding the optional "description" field. */
 /**
  * Generates an @c INTERNAL_ERROR @c ExceptionEncountered event which may be
@@ -0,0 +1,92 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_exception_limiter.h
+ * @brief User-facing functions of the @c AiaExceptionLimiter_t type.
+ */
+
+#ifndef AIA_EXCEPTION_LIMITER_H_
+#define AIA_EXCEPTION_LIMITER_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_message_constants.h>
+#include <aiacore/aia_topic.h>
+#include <aiaregulator/aia_regulator.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Rate limits the @c MALFORMED_MESSAGE @c ExceptionEncountered events sent for
+ * bad inbound messages, so that a corrupted stream cannot flood the event
+ * regulator and starve other events.
+ *
+ * Events are admitted by a token bucket. Reports which arrive while the bucket
+ * is empty are not sent individually; instead they are coalesced per topic into
+ * a count and a range of sequence numbers, which is carried by the next event
+ * admitted on that topic, or sent on its own once a token is returned to the
+ * bucket. A client shares one limiter between everything that reports
+ * malformed messages, so that the burst is not multiplied by their number.
+ * Methods of this object are thread-safe.
+ */
+typedef struct AiaExceptionLimiter AiaExceptionLimiter_t;
+
+/**
+ * Allocates and initializes a @c AiaExceptionLimiter_t object from the heap.
+ * The bucket starts full. The returned pointer should be destroyed using @c
+ * AiaExceptionLimiter_Destroy().
+ *
+ * @param eventRegulator Used to publish events.
+ * @param burst The number of events that may be sent back to back, i.e. the
+ * size of the bucket.
+ * @param refillIntervalMs The time in milliseconds it takes to return one
+ * event to the bucket.
+ * @return The newly created @c AiaExceptionLimiter_t if successful, or NULL
+ * otherwise.
+ */
+AiaExceptionLimiter_t* AiaExceptionLimiter_Create(
+    AiaRegulator_t* eventRegulator, size_t burst,
+    AiaDurationMs_t refillIntervalMs );
+
+/**
+ * Uninitializes and deallocates an @c AiaExceptionLimiter_t previously created
+ * by a call to @c AiaExceptionLimiter_Create(). Reports still being coalesced,
+ * which were made less than one refill interval ago, are dropped.
+ *
+ * @param limiter The @c AiaExceptionLimiter_t to destroy.
+ */
+void AiaExceptionLimiter_Destroy( AiaExceptionLimiter_t* limiter );
+
+/**
+ * Reports a malformed message. This sends a @c MALFORMED_MESSAGE @c
+ * ExceptionEncountered event if the bucket allows it, or coalesces the report
+ * otherwise.
+ *
+ * @param limiter The @c AiaExceptionLimiter_t to act on.
+ * @param sequenceNumber The sequence number of the malformed message.
+ * @param index The index of the message that was malformed.
+ * @param topic The topic that the malformed message was received on.
+ * @return @c true if the report was sent or coalesced, or @c false if the event
+ * could not be generated or written.
+ */
+bool AiaExceptionLimiter_ReportMalformedMessage(
+    AiaExceptionLimiter_t* limiter, AiaSequenceNumber_t sequenceNumber,
+    size_t index, AiaTopic_t topic );
+
+#endif /* ifndef AIA_EXCEPTION_LIMITER_H_ */
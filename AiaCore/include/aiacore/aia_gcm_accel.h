@@ -0,0 +1,136 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_gcm_accel.h
+ * @brief AES-GCM using the AES and carry-less multiply instructions of the CPU.
+ */
+
+#ifndef AIA_GCM_ACCEL_H_
+#define AIA_GCM_ACCEL_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Size of an AES block, which is also the size of a full gcm tag. */
+#define AIA_GCM_ACCEL_BLOCK_SIZE 16
+
+/** Number of round keys in the longest (AES-256) key schedule. */
+#define AIA_GCM_ACCEL_MAX_ROUND_KEYS 15
+
+/**
+ * An AES-GCM key and the state of one operation with it, laid out like @c
+ * mbedtls_gcm_context so that it can stand in for one: a key is set once, and
+ * each message is then processed with @c AiaGcmAccel_Starts(), any number of
+ * calls to @c AiaGcmAccel_Update() and @c AiaGcmAccel_Finish(). Additional
+ * authenticated data is not supported, as the SDK never uses any.
+ *
+ * The kernels use AES-NI and PCLMULQDQ on x86, and the ARMv8 Cryptography
+ * Extensions (AES and PMULL) on AArch64. Callers must check @c
+ * AiaGcmAccel_IsSupported() at runtime and use another implementation when it
+ * returns @c false. Methods of this object are not thread-safe.
+ */
+typedef struct AiaGcmAccel
+{
+    /** The expanded AES key. */
+    uint8_t roundKeys[ AIA_GCM_ACCEL_MAX_ROUND_KEYS ]
+                     [ AIA_GCM_ACCEL_BLOCK_SIZE ];
+
+    /** The number of AES rounds for the key in @c roundKeys. */
+    size_t numRounds;
+
+    /** The GHASH key H, byte-reversed as the multiplication expects it. */
+    uint8_t hashKey[ AIA_GCM_ACCEL_BLOCK_SIZE ];
+
+    /** The counter block of the next block of the current message. */
+    uint8_t counter[ AIA_GCM_ACCEL_BLOCK_SIZE ];
+
+    /** The first counter block of the current message, encrypted. */
+    uint8_t encryptedJ0[ AIA_GCM_ACCEL_BLOCK_SIZE ];
+
+    /** GHASH of the current message so far, byte-reversed. */
+    uint8_t hash[ AIA_GCM_ACCEL_BLOCK_SIZE ];
+
+    /** The number of bytes of the current message processed so far. */
+    uint64_t length;
+
+    /** Whether the current message is being decrypted. */
+    bool isDecrypting;
+} AiaGcmAccel_t;
+
+/**
+ * Checks whether this build has kernels for the CPU architecture, and whether
+ * the CPU it runs on implements the instructions they use.
+ *
+ * @return @c true if the other functions of this file may be used, else @c
+ * false.
+ */
+bool AiaGcmAccel_IsSupported();
+
+/**
+ * Expands a key into @c gcm. This must only be called if @c
+ * AiaGcmAccel_IsSupported() returns @c true.
+ *
+ * @param gcm The context to set the key of.
+ * @param key The AES key.
+ * @param keyBits The size of @c key in bits: 128, 192 or 256.
+ * @return @c true on success, else @c false.
+ */
+bool AiaGcmAccel_SetKey( AiaGcmAccel_t* gcm, const uint8_t* key,
+                         size_t keyBits );
+
+/**
+ * Starts encrypting or decrypting a message.
+ *
+ * @param gcm The context, which must have a key set.
+ * @param isDecrypting @c true to decrypt the message, @c false to encrypt it.
+ * @param iv The initialization vector of the message.
+ * @param ivLen The size of @c iv in bytes, which must be non-zero.
+ * @return @c true on success, else @c false.
+ */
+bool AiaGcmAccel_Starts( AiaGcmAccel_t* gcm, bool isDecrypting,
+                         const uint8_t* iv, size_t ivLen );
+
+/**
+ * Encrypts or decrypts the next bytes of the current message. As with @c
+ * mbedtls_gcm_update(), every call but the last for a message must be for a
+ * multiple of @c AIA_GCM_ACCEL_BLOCK_SIZE bytes. @c input and @c output may
+ * be the same buffer.
+ *
+ * @param gcm The started context.
+ * @param length The number of bytes to process.
+ * @param input The next @c length bytes of the message.
+ * @param[out] output Receives the @c length processed bytes.
+ * @return @c true on success, else @c false.
+ */
+bool AiaGcmAccel_Update( AiaGcmAccel_t* gcm, size_t length,
+                         const uint8_t* input, uint8_t* output );
+
+/**
+ * Finishes the current message and computes its tag.
+ *
+ * @param gcm The started context.
+ * @param[out] tag Receives the tag.
+ * @param tagLen The size of @c tag, between 4 and @c AIA_GCM_ACCEL_BLOCK_SIZE.
+ * @return @c true on success, else @c false.
+ */
+bool AiaGcmAccel_Finish( AiaGcmAccel_t* gcm, uint8_t* tag, size_t tagLen );
+
+#endif /* ifndef AIA_GCM_ACCEL_H_ */
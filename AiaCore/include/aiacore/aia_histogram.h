@@ -0,0 +1,130 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_histogram.h
+ * @brief User-facing functions of the @c AiaHistogram_t type.
+ */
+
+#ifndef AIA_HISTOGRAM_H_
+#define AIA_HISTOGRAM_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Each power of two is split into 2^@c AIA_HISTOGRAM_SUB_BUCKET_BITS linear
+ * buckets, so a recorded value is known to within 25%.
+ */
+#define AIA_HISTOGRAM_SUB_BUCKET_BITS 2
+
+/** Values of 2^@c AIA_HISTOGRAM_MAX_VALUE_BITS and above are all counted in
+ * the last bucket. */
+#define AIA_HISTOGRAM_MAX_VALUE_BITS 16
+
+/** The number of buckets in an @c AiaHistogram_t. */
+#define AIA_HISTOGRAM_BUCKETS                                              \
+    ( ( AIA_HISTOGRAM_MAX_VALUE_BITS - AIA_HISTOGRAM_SUB_BUCKET_BITS + 1 ) \
+      << AIA_HISTOGRAM_SUB_BUCKET_BITS )
+
+/**
+ * The most bytes @c AiaHistogram_Serialize() writes, which is when every
+ * bucket is in use.
+ */
+#define AIA_HISTOGRAM_MAX_SERIALIZED_SIZE ( 5 + AIA_HISTOGRAM_BUCKETS * 6 )
+
+/**
+ * A log-linear histogram of latencies in the style of HdrHistogram. Values
+ * below 2^@c AIA_HISTOGRAM_SUB_BUCKET_BITS get a bucket each, and each larger
+ * power of two is split into the same number of equal buckets. The histogram
+ * uses no memory beyond its own, and values are recorded with atomic
+ * operations only, so any number of threads may record into it at once.
+ *
+ * A zero-initialized @c AiaHistogram_t is empty. Its fields should only be
+ * read from a copy taken with @c AiaHistogram_Snapshot().
+ */
+typedef struct AiaHistogram
+{
+    /** The number of values recorded in each bucket. */
+    uint32_t counts[ AIA_HISTOGRAM_BUCKETS ];
+
+    /** The largest value recorded. */
+    uint32_t max;
+} AiaHistogram_t;
+
+/**
+ * Records a value. This may be called from any thread. Values are not
+ * recorded while the overload governor sheds @c AIA_OVERLOAD_WORK_TELEMETRY.
+ *
+ * @param histogram The @c AiaHistogram_t to act on.
+ * @param value The value to record.
+ */
+void AiaHistogram_Record( AiaHistogram_t* histogram, uint32_t value );
+
+/**
+ * Copies the counts of a histogram. Buckets are copied independently of each
+ * other, so values recorded during the copy may or may not be included.
+ *
+ * @param histogram The @c AiaHistogram_t to copy.
+ * @param[out] snapshot The copy.
+ */
+void AiaHistogram_Snapshot( const AiaHistogram_t* histogram,
+                            AiaHistogram_t* snapshot );
+
+/**
+ * Empties a histogram. Values recorded during the reset may be lost.
+ *
+ * @param histogram The @c AiaHistogram_t to act on.
+ */
+void AiaHistogram_Reset( AiaHistogram_t* histogram );
+
+/**
+ * @param histogram A snapshot taken with @c AiaHistogram_Snapshot().
+ * @return The number of values recorded.
+ */
+uint32_t AiaHistogram_GetCount( const AiaHistogram_t* histogram );
+
+/**
+ * Finds the value that a given percentage of recorded values are at or below.
+ *
+ * @param histogram A snapshot taken with @c AiaHistogram_Snapshot().
+ * @param percentile The percentage, from 0 to 100.
+ * @return The largest value which falls in the same bucket as the value at @c
+ * percentile, but no larger than the largest value recorded, or 0 if nothing
+ * has been recorded.
+ */
+uint32_t AiaHistogram_GetValueAtPercentile( const AiaHistogram_t* histogram,
+                                            double percentile );
+
+/**
+ * Encodes a histogram compactly for uplinking. The encoding is the largest
+ * value recorded followed by the index of each bucket in use and its count,
+ * in order of index. Indices are encoded as the difference from the previous
+ * index in use, and all numbers as unsigned LEB128 varints.
+ *
+ * @param histogram A snapshot taken with @c AiaHistogram_Snapshot().
+ * @param[out] buffer The buffer to encode into, or @c NULL to only calculate
+ * the size of the encoding.
+ * @param bufferSize The size of @c buffer.
+ * @return The size of the encoding, or 0 if it does not fit in @c buffer.
+ */
+size_t AiaHistogram_Serialize( const AiaHistogram_t* histogram,
+                               uint8_t* buffer, size_t bufferSize );
+
+#endif /* ifndef AIA_HISTOGRAM_H_ */
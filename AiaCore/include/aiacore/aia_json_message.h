@@ -142,4 +142,16 @@ bool AiaJsonMessage_BuildMessage( const AiaJsonMessage_t* jsonMessage,
                                   char* messageBuffer,
                                   size_t messageBufferSize );
 
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+/**
+ * Builds the message into an internal buffer, so that later calls to @c
+ * AiaJsonMessage_BuildMessage() only need to copy it.  This allows the message
+ * to be serialized on the thread creating it, rather than the one sending it.
+ *
+ * @param jsonMessage The JSON message to act on.
+ * @return @c true if the message was serialized successfully, else @c false.
+ */
+bool AiaJsonMessage_Serialize( AiaJsonMessage_t* jsonMessage );
+#endif
+
 #endif /* ifndef AIA_JSON_MESSAGE_H_ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_json_template.h
+ * @brief Declares a facility for rendering JSON payloads from precompiled
+ * templates.
+ */
+
+#ifndef AIA_JSON_TEMPLATE_H_
+#define AIA_JSON_TEMPLATE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include "aia_json_message.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Maximum length of a payload rendered by @c AiaJsonTemplate_CreateMessage().
+ */
+#define AIA_JSON_TEMPLATE_MAX_PAYLOAD_LENGTH 256
+
+/** A run of constant JSON text in an @c AiaJsonTemplate_t. */
+typedef struct AiaJsonTemplateSegment
+{
+    /** The constant text. */
+    const char* text;
+
+    /** The length of @c text, not including a terminating '\0'. */
+    size_t length;
+} AiaJsonTemplateSegment_t;
+
+/**
+ * Initializes an @c AiaJsonTemplateSegment_t from a string literal, measuring
+ * it at compile time.
+ *
+ * @param literal The constant JSON text.
+ */
+#define AIA_JSON_TEMPLATE_SEGMENT( literal ) \
+    {                                        \
+        literal, sizeof( literal ) - 1       \
+    }
+
+/**
+ * A JSON event whose payload consists of constant text interleaved with
+ * unsigned numeric fields. Templates are intended to be defined as @c static
+ * @c const data, so that the constant text is laid out once at compile time
+ * and only the numeric fields are formatted when an event is generated.
+ */
+typedef struct AiaJsonTemplate
+{
+    /** The "name" value of the JSON header of messages created from this
+     * template. */
+    const char* name;
+
+    /** The constant text of the payload. Field @c i is rendered between @c
+     * segments[ i ] and @c segments[ i + 1 ], so this has @c numFields + 1
+     * entries. */
+    const AiaJsonTemplateSegment_t* segments;
+
+    /** The number of numeric fields in the payload. */
+    size_t numFields;
+} AiaJsonTemplate_t;
+
+/**
+ * Renders the payload of a template.
+ *
+ * @param jsonTemplate The template to render.
+ * @param fields The values of the template's numeric fields, in order.
+ * @param[out] buffer The buffer to render the payload into. This will be
+ * '\0'-terminated on success.
+ * @param bufferSize The size (in bytes) of @c buffer.
+ * @return The length of the rendered payload, not including the terminating
+ * '\0', or zero if @c buffer was too small.
+ */
+size_t AiaJsonTemplate_Render( const AiaJsonTemplate_t* jsonTemplate,
+                               const uint64_t* fields, char* buffer,
+                               size_t bufferSize );
+
+/**
+ * Creates an @c AiaJsonMessage_t with a random message ID from a template.
+ *
+ * @param jsonTemplate The template to render.
+ * @param fields The values of the template's numeric fields, in order.
+ * @return The newly created message, to be destroyed with @c
+ * AiaJsonMessage_Destroy(), or @c NULL on failure.
+ */
+AiaJsonMessage_t* AiaJsonTemplate_CreateMessage(
+    const AiaJsonTemplate_t* jsonTemplate, const uint64_t* fields );
+
+#endif /* ifndef AIA_JSON_TEMPLATE_H_ */
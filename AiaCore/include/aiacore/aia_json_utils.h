@@ -78,6 +78,61 @@ bool AiaJsonUtils_GetArrayElement( const char* jsonArray,
                                    const char** jsonValue,
                                    size_t* jsonValueLength );
 
+/**
+ * Stateful iterator which yields the elements of a JSON array in a single pass.
+ * Quoted strings are treated as atomic, so commas, braces and brackets inside
+ * them do not delimit elements. This is intended to be allocated on the stack,
+ * initialized with @c AiaJsonArrayIterator_Initialize() and advanced with @c
+ * AiaJsonArrayIterator_Next(). The iterator does not copy @c jsonArray, which
+ * must remain valid for the lifetime of the iterator.
+ */
+typedef struct AiaJsonArrayIterator
+{
+    /** The JSON array being iterated (including the '[' and ']'). */
+    const char* jsonArray;
+
+    /** The length of @c jsonArray. */
+    size_t jsonArrayLength;
+
+    /** Offset into @c jsonArray at which scanning for the next element will
+     * resume. */
+    size_t offset;
+
+    /** Set once the closing ']' of the array has been consumed. */
+    bool complete;
+} AiaJsonArrayIterator_t;
+
+/**
+ * Initializes an @c AiaJsonArrayIterator_t to the first element of a JSON
+ * array.
+ *
+ * @param iterator The iterator to initialize.
+ * @param jsonArray A JSON array string (including the '[' and ']').
+ * @param jsonArrayLength The length of @c jsonArray (not including the
+ *     terminating `\0`).
+ * @return @c true if @c jsonArray looks like a JSON array and @c iterator was
+ *     initialized, else @c false.
+ */
+bool AiaJsonArrayIterator_Initialize( AiaJsonArrayIterator_t* iterator,
+                                      const char* jsonArray,
+                                      size_t jsonArrayLength );
+
+/**
+ * Advances an @c AiaJsonArrayIterator_t to the next element of its array.
+ *
+ * @param iterator The iterator to advance.
+ * @param [out] jsonValue Pointer to the start of the array element (may not be
+ *     null-terminated).
+ * @param [out] jsonValueLength Length of the array element string.
+ * @return @c true if the next array element was returned in @c jsonValue and
+ *     @c jsonValueLength, else @c false. Once @c false has been returned, @c
+ *     iterator->complete can be used to distinguish the end of the array from a
+ *     malformed array.
+ */
+bool AiaJsonArrayIterator_Next( AiaJsonArrayIterator_t* iterator,
+                                const char** jsonValue,
+                                size_t* jsonValueLength );
+
 /**
  * Utility function to extract an AIA long from a JSON payload.
  *
@@ -99,4 +154,88 @@ bool AiaJsonUtils_ExtractLong( const char* jsonDocument,
                                size_t jsonKeyLength,
                                AiaJsonLongType* longValue );
 
+/** The maximum number of members an @c AiaJsonObject_t can index. */
+#define AIA_JSON_OBJECT_MAX_MEMBERS 16
+
+/** A view of one member of a JSON object, borrowed from the document. */
+typedef struct AiaJsonMember
+{
+    /** The member's key, without its quotes. */
+    const char* key;
+
+    /** The length of @c key. */
+    size_t keyLength;
+
+    /** The member's value, in the same form @c AiaFindJsonValue() returns it
+     * (strings keep their quotes). */
+    const char* value;
+
+    /** The length of @c value. */
+    size_t valueLength;
+} AiaJsonMember_t;
+
+/**
+ * A flat table of the top-level members of a JSON object, built in a single
+ * pass by @c AiaJsonObject_Parse().  Directive handlers which read several
+ * fields can parse their payload once and then look each field up without
+ * rescanning the document.  This is intended to be allocated on the stack. The
+ * table does not copy the document, which must remain valid for the lifetime
+ * of the table.
+ */
+typedef struct AiaJsonObject
+{
+    /** The members of the object, in document order. */
+    AiaJsonMember_t members[ AIA_JSON_OBJECT_MAX_MEMBERS ];
+
+    /** The number of valid entries in @c members. */
+    size_t numMembers;
+} AiaJsonObject_t;
+
+/**
+ * Indexes the top-level members of a JSON object.  Nested objects and arrays
+ * are not descended into; their values may be parsed separately.
+ *
+ * @param[out] object The table to fill.
+ * @param jsonDocument A JSON object (including the '{' and '}'), which does not
+ *     need to be '\0' terminated.
+ * @param jsonDocumentLength The length of @c jsonDocument.
+ * @return @c true if @c jsonDocument was indexed, or @c false if it is not a
+ *     well-formed object or has more than @c AIA_JSON_OBJECT_MAX_MEMBERS
+ *     members.
+ */
+bool AiaJsonObject_Parse( AiaJsonObject_t* object, const char* jsonDocument,
+                          size_t jsonDocumentLength );
+
+/**
+ * Looks up the value of a top-level member of an object indexed by @c
+ * AiaJsonObject_Parse().
+ *
+ * @param object The table to search.
+ * @param jsonKey The key to search for (does not need to be '\0' terminated).
+ * @param jsonKeyLength The length of @c jsonKey.
+ * @param [out] jsonValue Pointer to the start of the value (may not be
+ *     null-terminated).
+ * @param [out] jsonValueLength Length of the value.
+ * @return @c true if the key was found, else @c false.
+ */
+bool AiaJsonObject_FindValue( const AiaJsonObject_t* object,
+                              const char* jsonKey, size_t jsonKeyLength,
+                              const char** jsonValue, size_t* jsonValueLength );
+
+/**
+ * Extracts an AIA long from a top-level member of an object indexed by @c
+ * AiaJsonObject_Parse().  This is the @c AiaJsonObject_t counterpart of @c
+ * AiaJsonUtils_ExtractLong().
+ *
+ * @param object The table to search.
+ * @param jsonKey The key to search for (does not need to be '\0' terminated).
+ * @param jsonKeyLength The length of @c jsonKey.
+ * @param [out] longValue The extracted long if it was able to be found.
+ * @return @c true if a long could be successfully parsed, or @c false
+ *     otherwise.
+ */
+bool AiaJsonObject_ExtractLong( const AiaJsonObject_t* object,
+                                const char* jsonKey, size_t jsonKeyLength,
+                                AiaJsonLongType* longValue );
+
 #endif /* ifndef AIA_JSON_UTILS_H_ */
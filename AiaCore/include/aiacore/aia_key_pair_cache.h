@@ -0,0 +1,91 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_key_pair_cache.h
+ * @brief User-facing functions of the @c AiaKeyPairCache_t type.
+ */
+
+#ifndef AIA_KEY_PAIR_CACHE_H_
+#define AIA_KEY_PAIR_CACHE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_secret_derivation_algorithm.h>
+
+#include AiaTaskPool( HEADER )
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Generates key pairs with @c AiaCrypto_GenerateKeyPair() ahead of time on a
+ * task pool job, so that the next registration can take a ready pair instead
+ * of generating one on its critical path. One pair is cached at a time, and
+ * the next one is generated after it is taken. Methods of this object are
+ * thread-safe.
+ */
+typedef struct AiaKeyPairCache AiaKeyPairCache_t;
+
+/**
+ * Allocates and initializes a @c AiaKeyPairCache_t object from the heap and
+ * schedules the generation of its first key pair. The returned pointer should
+ * be destroyed using @c AiaKeyPairCache_Destroy().
+ *
+ * @param taskPool The task pool to generate key pairs on.
+ * @param algorithm The secret derivation algorithm to generate key pairs for.
+ * @param privateKeyLen The length of the private keys.
+ * @param publicKeyLen The length of the public keys.
+ * @param delayMs How long to wait after the cache is created, and after each
+ * key pair is taken, before generating the next pair, so that the generation
+ * does not compete with the work done at boot or during registration.
+ * @return The newly created @c AiaKeyPairCache_t if successful, or @c NULL
+ * otherwise.
+ */
+AiaKeyPairCache_t* AiaKeyPairCache_Create(
+    AiaTaskPool_t taskPool, AiaSecretDerivationAlgorithm_t algorithm,
+    size_t privateKeyLen, size_t publicKeyLen, AiaDurationMs_t delayMs );
+
+/**
+ * Uninitializes and deallocates an @c AiaKeyPairCache_t previously created by
+ * a call to @c AiaKeyPairCache_Create(). This waits for a key pair being
+ * generated to finish, and wipes the cached key pair.
+ *
+ * @param cache The @c AiaKeyPairCache_t to destroy.
+ */
+void AiaKeyPairCache_Destroy( AiaKeyPairCache_t* cache );
+
+/**
+ * Takes the cached key pair and schedules the generation of the next one. If
+ * no key pair is cached yet, one is generated on the calling thread instead,
+ * so this always has the cost of generating a key pair at worst.
+ *
+ * @param cache The @c AiaKeyPairCache_t to act on.
+ * @param[out] privateKey The buffer to write binary private key data into.
+ * @param privateKeyLen The length of @c privateKey, which must match the
+ * length @c cache was created with.
+ * @param[out] publicKey The buffer to write binary public key data into.
+ * @param publicKeyLen The length of @c publicKey, which must match the length
+ * @c cache was created with.
+ * @return @c true if a key pair was written, else @c false.
+ */
+bool AiaKeyPairCache_Take( AiaKeyPairCache_t* cache, uint8_t* privateKey,
+                           size_t privateKeyLen, uint8_t* publicKey,
+                           size_t publicKeyLen );
+
+#endif /* ifndef AIA_KEY_PAIR_CACHE_H_ */
@@ -0,0 +1,114 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_lwa_credential_cache.h
+ * @brief User-facing functions of the @c AiaLwaCredentialCache_t type.
+ */
+
+#ifndef AIA_LWA_CREDENTIAL_CACHE_H_
+#define AIA_LWA_CREDENTIAL_CACHE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include AiaTaskPool( HEADER )
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** A copy of the LWA credentials held by the LWA port. */
+typedef struct AiaLwaCredentials
+{
+    /** The null-terminated LWA refresh token. */
+    const char* refreshToken;
+
+    /** The size of @c refreshToken, including the trailing @c '\0'. */
+    size_t refreshTokenLen;
+
+    /** The null-terminated LWA Client Id. */
+    const char* lwaClientId;
+
+    /** The size of @c lwaClientId, including the trailing @c '\0'. */
+    size_t lwaClientIdLen;
+} AiaLwaCredentials_t;
+
+/**
+ * Fetches the LWA credentials with @c AiaGetRefreshToken() and @c
+ * AiaGetLwaClientId(). The returned pointer should be destroyed using @c
+ * AiaLwaCredentials_Destroy().
+ *
+ * @return The credentials if successful, or @c NULL otherwise.
+ */
+AiaLwaCredentials_t* AiaLwaCredentials_Load();
+
+/**
+ * Wipes and deallocates credentials returned by @c AiaLwaCredentials_Load()
+ * or @c AiaLwaCredentialCache_Get().
+ *
+ * @param credentials The @c AiaLwaCredentials_t to destroy.
+ */
+void AiaLwaCredentials_Destroy( AiaLwaCredentials_t* credentials );
+
+/**
+ * Keeps a copy of the LWA credentials, so that registration does not wait on
+ * the secure storage the LWA port reads them from, and retries after a failed
+ * registration do not read them again. The credentials are fetched on a task
+ * pool job right after the cache is created and refreshed by the same job
+ * periodically, before they expire. A background refresh which fails keeps
+ * the previous credentials until they expire. Methods of this object are
+ * thread-safe.
+ */
+typedef struct AiaLwaCredentialCache AiaLwaCredentialCache_t;
+
+/**
+ * Allocates and initializes a @c AiaLwaCredentialCache_t object from the heap
+ * and schedules the first fetch of the credentials. The returned pointer
+ * should be destroyed using @c AiaLwaCredentialCache_Destroy().
+ *
+ * @param taskPool The task pool to fetch credentials on.
+ * @param refreshIntervalMs The time between two background fetches.
+ * @param maxAgeMs How long fetched credentials may be used for, which must be
+ * at least @c refreshIntervalMs.
+ * @return The newly created @c AiaLwaCredentialCache_t if successful, or @c
+ * NULL otherwise.
+ */
+AiaLwaCredentialCache_t* AiaLwaCredentialCache_Create(
+    AiaTaskPool_t taskPool, AiaDurationMs_t refreshIntervalMs,
+    AiaDurationMs_t maxAgeMs );
+
+/**
+ * Uninitializes and deallocates an @c AiaLwaCredentialCache_t previously
+ * created by a call to @c AiaLwaCredentialCache_Create(). This waits for a
+ * fetch in progress to finish, and wipes the cached credentials.
+ *
+ * @param cache The @c AiaLwaCredentialCache_t to destroy.
+ */
+void AiaLwaCredentialCache_Destroy( AiaLwaCredentialCache_t* cache );
+
+/**
+ * Returns a copy of the cached credentials. If none are cached yet, or they
+ * have expired, they are fetched on the calling thread instead, so this has
+ * the cost of @c AiaLwaCredentials_Load() at worst.
+ *
+ * @param cache The @c AiaLwaCredentialCache_t to act on.
+ * @return A copy of the credentials, to be destroyed using @c
+ * AiaLwaCredentials_Destroy(), or @c NULL on failure.
+ */
+AiaLwaCredentials_t* AiaLwaCredentialCache_Get(
+    AiaLwaCredentialCache_t* cache );
+
+#endif /* ifndef AIA_LWA_CREDENTIAL_CACHE_H_ */
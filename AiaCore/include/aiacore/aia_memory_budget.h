@@ -0,0 +1,121 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_budget.h
+ * @brief User-facing functions of the @c AiaMemoryBudget_t type.
+ */
+
+#ifndef AIA_MEMORY_BUDGET_H_
+#define AIA_MEMORY_BUDGET_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A limit on the memory a client may hold on to for data which can pile up,
+ * so that one misbehaving session cannot starve others sharing the heap.
+ *
+ * Components charge the budget for such data, and release the charge when
+ * they free the data. When a charge is refused
+ * each component degrades in its own way instead of allocating:
+ * - Sequencers drop out-of-order messages rather than buffer them, as if they
+ *   were lost, and rely on the sequence timeout.
+ * - Regulators refuse writes, as they do above their high watermark.
+ * - The alert manager fails new @c SetAlert directives.
+ *
+ * Methods of this object are lock-free and thread-safe, and a budget may be
+ * shared by several clients.
+ */
+typedef struct AiaMemoryBudget AiaMemoryBudget_t;
+
+/** Usage of an @c AiaMemoryBudget_t. */
+typedef struct AiaMemoryBudgetMetrics
+{
+    /** The number of bytes that may be charged. */
+    uint32_t limitBytes;
+
+    /** The number of bytes currently charged. */
+    uint32_t usedBytes;
+
+    /** The highest value @c usedBytes has reached. */
+    uint32_t peakBytes;
+
+    /** The number of charges refused. */
+    uint32_t refusals;
+} AiaMemoryBudgetMetrics_t;
+
+/**
+ * Allocates and initializes a @c AiaMemoryBudget_t object from the heap. The
+ * returned pointer should be destroyed using @c AiaMemoryBudget_Destroy(),
+ * after every component charging it.
+ *
+ * @param limitBytes The number of bytes that may be charged at once.
+ * @return The newly created @c AiaMemoryBudget_t if successful, or NULL
+ * otherwise.
+ */
+AiaMemoryBudget_t* AiaMemoryBudget_Create( size_t limitBytes );
+
+/**
+ * Uninitializes and deallocates an @c AiaMemoryBudget_t previously created by
+ * a call to @c AiaMemoryBudget_Create().
+ *
+ * @param budget The @c AiaMemoryBudget_t to destroy.
+ */
+void AiaMemoryBudget_Destroy( AiaMemoryBudget_t* budget );
+
+/**
+ * Charges bytes against the budget if they fit.
+ *
+ * @param budget The @c AiaMemoryBudget_t to act on.
+ * @param bytes The number of bytes to charge.
+ * @return @c true if @c bytes were charged, or @c false if they would exceed
+ * the limit.
+ */
+bool AiaMemoryBudget_Charge( AiaMemoryBudget_t* budget, size_t bytes );
+
+/**
+ * Charges bytes against the budget even if they exceed the limit, for data
+ * which must be kept, such as alerts restored from storage. Later charges
+ * are refused until enough is released.
+ *
+ * @param budget The @c AiaMemoryBudget_t to act on.
+ * @param bytes The number of bytes to charge.
+ */
+void AiaMemoryBudget_ForceCharge( AiaMemoryBudget_t* budget, size_t bytes );
+
+/**
+ * Releases bytes previously charged.
+ *
+ * @param budget The @c AiaMemoryBudget_t to act on.
+ * @param bytes The number of bytes to release.
+ */
+void AiaMemoryBudget_Release( AiaMemoryBudget_t* budget, size_t bytes );
+
+/**
+ * Takes a snapshot of the usage of a budget.
+ *
+ * @param budget The @c AiaMemoryBudget_t to act on.
+ * @param[out] metrics The usage of @c budget.
+ */
+void AiaMemoryBudget_GetMetrics( AiaMemoryBudget_t* budget,
+                                 AiaMemoryBudgetMetrics_t* metrics );
+
+#endif /* ifndef AIA_MEMORY_BUDGET_H_ */
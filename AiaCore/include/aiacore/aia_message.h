@@ -25,7 +25,9 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * This type is used to hold an unencrypted abstract Aia message.
@@ -43,4 +45,36 @@ typedef struct AiaMessage AiaMessage_t;
  */
 size_t AiaMessage_GetSize( const AiaMessage_t* message );
 
+/**
+ * Identifies messages which only report the latest value of some state, so
+ * that a queued message may be replaced by a newer one with the same key.
+ * Zero, the default, means the message is never replaced.
+ */
+typedef uint8_t AiaMessageSupersedeKey_t;
+
+/** The largest @c AiaMessageSupersedeKey_t. */
+#define AIA_MESSAGE_MAX_SUPERSEDE_KEY 31
+
+/**
+ * Tags a message with a supersede key.  Queues which support it, such as an @c
+ * AiaRegulator_t, then drop a queued message with the same key when this one
+ * is added.
+ *
+ * @param message The message to tag.
+ * @param key The key, from @c 1 to @c AIA_MESSAGE_MAX_SUPERSEDE_KEY, or zero to
+ * remove the tag.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaMessage_SetSupersedeKey( AiaMessage_t* message,
+                                 AiaMessageSupersedeKey_t key );
+
+/**
+ * Returns the supersede key of this message.
+ *
+ * @param message The message to get the key of.
+ * @return The key set with @c AiaMessage_SetSupersedeKey(), or zero.
+ */
+AiaMessageSupersedeKey_t AiaMessage_GetSupersedeKey(
+    const AiaMessage_t* message );
+
 #endif /* ifndef AIA_MESSAGE_H_ */
@@ -0,0 +1,83 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mpsc_queue.h
+ * @brief User-facing functions of the @c AiaMpscQueue_t type.
+ */
+
+#ifndef AIA_MPSC_QUEUE_H_
+#define AIA_MPSC_QUEUE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A bounded queue of fixed-size elements which any number of threads may push
+ * to and a single thread pops from. Pushing and popping take no locks: each
+ * slot carries a sequence number which producers claim slots against with a
+ * compare-and-swap, so a producer never waits on the consumer or on a mutex
+ * held by some other component.
+ */
+typedef struct AiaMpscQueue AiaMpscQueue_t;
+
+/**
+ * Allocates and initializes a @c AiaMpscQueue_t object from the heap. The
+ * returned pointer should be destroyed using @c AiaMpscQueue_Destroy().
+ *
+ * @param capacity The most elements the queue can hold, which must be a power
+ * of two.
+ * @param elementSize The size of each element.
+ * @return The newly created @c AiaMpscQueue_t if successful, or @c NULL
+ * otherwise.
+ */
+AiaMpscQueue_t* AiaMpscQueue_Create( size_t capacity, size_t elementSize );
+
+/**
+ * Uninitializes and deallocates an @c AiaMpscQueue_t previously created by a
+ * call to @c AiaMpscQueue_Create(). Elements still queued are discarded.
+ *
+ * @param queue The @c AiaMpscQueue_t to destroy.
+ */
+void AiaMpscQueue_Destroy( AiaMpscQueue_t* queue );
+
+/**
+ * Copies an element onto the tail of the queue. This may be called from any
+ * thread.
+ *
+ * @param queue The @c AiaMpscQueue_t to act on.
+ * @param element The element to copy, of the size passed to @c
+ * AiaMpscQueue_Create().
+ * @return @c true if the element was queued, or @c false if the queue is full.
+ */
+bool AiaMpscQueue_Push( AiaMpscQueue_t* queue, const void* element );
+
+/**
+ * Copies the element at the head of the queue out and removes it. Only one
+ * thread may pop from a queue at a time.
+ *
+ * @param queue The @c AiaMpscQueue_t to act on.
+ * @param[out] element The element popped.
+ * @return @c true if an element was popped, or @c false if the queue is empty.
+ * @note An element whose producer is still copying it in is not popped until
+ * the copy completes, even if elements pushed after it have completed.
+ */
+bool AiaMpscQueue_Pop( AiaMpscQueue_t* queue, void* element );
+
+#endif /* ifndef AIA_MPSC_QUEUE_H_ */
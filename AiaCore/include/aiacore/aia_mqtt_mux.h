@@ -0,0 +1,105 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mqtt_mux.h
+ * @brief User-facing functions of the @c AiaMqttMux_t type.
+ */
+
+#ifndef AIA_MQTT_MUX_H_
+#define AIA_MQTT_MUX_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Routes messages received on a single MQTT connection to one of several
+ * handlers by device topic root. This allows several endpoints, each with its
+ * own device topic root, to share one connection, and with it one TLS session
+ * and keepalive. Methods of this object are thread-safe.
+ */
+typedef struct AiaMqttMux AiaMqttMux_t;
+
+/**
+ * Allocates and initializes a @c AiaMqttMux_t object from the heap. The
+ * returned pointer should be destroyed using @c AiaMqttMux_Destroy().
+ *
+ * @param numBuckets The number of hash buckets to spread routes over. This
+ * should be around the number of routes expected.
+ * @return The newly created @c AiaMqttMux_t if successful, or NULL otherwise.
+ */
+AiaMqttMux_t* AiaMqttMux_Create( size_t numBuckets );
+
+/**
+ * Uninitializes and deallocates an @c AiaMqttMux_t previously created by a call
+ * to @c AiaMqttMux_Create(), removing any remaining routes. No messages may be
+ * passed to @c AiaMqttMux_MessageReceived() once this is called.
+ *
+ * @param mux The @c AiaMqttMux_t to destroy.
+ */
+void AiaMqttMux_Destroy( AiaMqttMux_t* mux );
+
+/**
+ * Routes messages on topics beginning with @c topicRoot to @c handler.
+ *
+ * @param mux The @c AiaMqttMux_t to act on.
+ * @param topicRoot The device topic root to route, which must end with '/'.
+ * This is copied.
+ * @param topicRootLength The length of @c topicRoot.
+ * @param handler The handler to pass messages on to, such as the dispatcher's
+ * @c messageReceivedCallback().
+ * @param userData Context to pass to @c handler.
+ * @return @c true if the route was added or @c false otherwise, including if
+ * @c topicRoot is already routed.
+ */
+bool AiaMqttMux_AddRoute( AiaMqttMux_t* mux, const char* topicRoot,
+                          size_t topicRootLength, AiaMqttTopicHandler_t handler,
+                          void* userData );
+
+/**
+ * Stops routing messages on topics beginning with @c topicRoot. This waits for
+ * calls to the handler of the route which are already in progress, so once
+ * this returns, the handler is not running and will not be called again.
+ *
+ * @param mux The @c AiaMqttMux_t to act on.
+ * @param topicRoot The device topic root to stop routing.
+ * @param topicRootLength The length of @c topicRoot.
+ * @return @c true if the route was removed or @c false if it was not found.
+ * @note This must not be called from the handler of the route being removed,
+ * which would wait for itself.
+ */
+bool AiaMqttMux_RemoveRoute( AiaMqttMux_t* mux, const char* topicRoot,
+                             size_t topicRootLength );
+
+/**
+ * Passes a received message on to the handler of the longest routed device
+ * topic root that its topic begins with. Messages on topics which are not
+ * routed are dropped. This is an @c AiaMqttTopicHandler_t which should be
+ * subscribed to the connection in place of the individual handlers.
+ *
+ * @param userData The @c AiaMqttMux_t to act on.
+ * @param callbackParam The received message.
+ * @note Handlers are called without the @c AiaMqttMux_t locked, so messages
+ * for different routes may be handled concurrently, and handlers may add or
+ * remove other routes.
+ */
+void AiaMqttMux_MessageReceived( void* userData,
+                                 AiaMqttCallbackParam_t* callbackParam );
+
+#endif /* ifndef AIA_MQTT_MUX_H_ */
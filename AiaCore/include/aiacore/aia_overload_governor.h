@@ -0,0 +1,124 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_overload_governor.h
+ * @brief Detects CPU overload and sheds non-essential work while it lasts.
+ *
+ * The realtime tasks of the SDK report whether they ran on time, and the
+ * regulators report how long data waited in their queues. Once per @c
+ * AIA_OVERLOAD_WINDOW_MS these reports are judged: a window in which at least
+ * @c AIA_OVERLOAD_MISS_PERCENT of task runs were late, or in which data waited
+ * @c AIA_OVERLOAD_MAX_QUEUE_AGE_MS, raises the shed level by one, and @c
+ * AIA_OVERLOAD_CALM_WINDOWS windows in a row without a late run lower it by
+ * one. Work is shed in the order of @c AiaOverloadWork_t, so the least
+ * essential work goes first and comes back last.
+ *
+ * There is one governor per process, since all clients share the CPU. Its
+ * functions are lock-free and may be called from any thread.
+ */
+
+#ifndef AIA_OVERLOAD_GOVERNOR_H_
+#define AIA_OVERLOAD_GOVERNOR_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** The length of the windows in which reports are judged. */
+#define AIA_OVERLOAD_WINDOW_MS 1000
+
+/** The share of late task runs in a window which raises the shed level. */
+#define AIA_OVERLOAD_MISS_PERCENT 10
+
+/** A queueing delay which raises the shed level. */
+#define AIA_OVERLOAD_MAX_QUEUE_AGE_MS 500
+
+/** The number of windows in a row without pressure which lower the shed
+ * level. */
+#define AIA_OVERLOAD_CALM_WINDOWS 3
+
+/** The work which may be shed, in the order it is shed. */
+typedef enum AiaOverloadWork
+{
+    /** @c AiaLogDebug() output. */
+    AIA_OVERLOAD_WORK_DEBUG_LOGS = 1,
+
+    /** UX observer callbacks, which are coalesced rather than dropped. */
+    AIA_OVERLOAD_WORK_UX_OBSERVER,
+
+    /** Non-critical events, which are coalesced rather than dropped. */
+    AIA_OVERLOAD_WORK_NON_CRITICAL_EVENTS,
+
+    /** Recording of latency histograms. */
+    AIA_OVERLOAD_WORK_TELEMETRY
+} AiaOverloadWork_t;
+
+/** The highest shed level, at which all of @c AiaOverloadWork_t is shed. */
+#define AIA_OVERLOAD_MAX_LEVEL AIA_OVERLOAD_WORK_TELEMETRY
+
+/** The realtime tasks which report whether they ran on time. */
+typedef enum AiaOverloadTask
+{
+    /** Pushing frames to the speaker. */
+    AIA_OVERLOAD_TASK_SPEAKER_PUSH,
+
+    /** Streaming microphone chunks. */
+    AIA_OVERLOAD_TASK_MICROPHONE_STREAMING
+} AiaOverloadTask_t;
+
+/**
+ * Reports one run of a realtime task.
+ *
+ * @param task The task which ran.
+ * @param isLate Whether the run missed its deadline.
+ */
+void AiaOverloadGovernor_ReportTaskRun( AiaOverloadTask_t task, bool isLate );
+
+/**
+ * Reports how long data waited in a queue before it was sent.
+ *
+ * @param ageMs The time the data waited.
+ */
+void AiaOverloadGovernor_ReportQueueAge( uint32_t ageMs );
+
+/**
+ * Judges the reports made since the last window ended and starts a new window.
+ * Reports do this once @c AIA_OVERLOAD_WINDOW_MS has passed, so this only
+ * needs calling to judge a window early.
+ */
+void AiaOverloadGovernor_EndWindow();
+
+/**
+ * @return The current shed level. All @c AiaOverloadWork_t up to and
+ * including this level is shed, and none is at level zero.
+ */
+uint32_t AiaOverloadGovernor_GetLevel();
+
+/**
+ * @param work The work to check.
+ * @return Whether @c work is currently shed.
+ */
+bool AiaOverloadGovernor_IsShed( AiaOverloadWork_t work );
+
+/**
+ * Restores all shed work and discards the reports of the current window.
+ */
+void AiaOverloadGovernor_Reset();
+
+#endif /* ifndef AIA_OVERLOAD_GOVERNOR_H_ */
@@ -0,0 +1,162 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm.h
+ * @brief Utilities for processing 16-bit linear PCM audio in place.
+ *
+ * The per-sample loops in these functions are branch-free and operate on
+ * non-aliasing buffers so that compilers can vectorize them for the target
+ * (e.g. NEON or SSE) without any platform-specific code.
+ */
+
+#ifndef AIA_PCM_H_
+#define AIA_PCM_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A linear gain in unsigned Q4.12 fixed point, allowing gains from @c 0 to just
+ * under @c 16.
+ */
+typedef uint16_t AiaPcmGain_t;
+
+/** The number of fractional bits in @c AiaPcmGain_t. */
+#define AIA_PCM_GAIN_FRACTIONAL_BITS 12
+
+/** A gain of @c 1, which leaves samples unchanged. */
+#define AIA_PCM_GAIN_UNITY \
+    ( (AiaPcmGain_t)( 1 << AIA_PCM_GAIN_FRACTIONAL_BITS ) )
+
+/** The energy of a block of samples, in the units of the samples. */
+typedef struct AiaPcmEnergy
+{
+    /** The largest absolute sample value, from @c 0 to @c 32768. */
+    uint32_t peak;
+
+    /** The root mean square of the samples, from @c 0 to @c 32768. */
+    uint32_t rms;
+} AiaPcmEnergy_t;
+
+/**
+ * State of a DC removal filter. This should be zero-initialized before the
+ * first call to @c AiaPcm_RemoveDc() on a new stream.
+ */
+typedef struct AiaPcmDcFilter
+{
+    /** The estimated DC offset in Q8 fixed point. */
+    int32_t offset;
+} AiaPcmDcFilter_t;
+
+/**
+ * Removes the DC offset from @c samples in place. The offset is tracked across
+ * calls as a running average of block means, so blocks should be tens of
+ * milliseconds long or more.
+ *
+ * @param filter The filter state for the stream @c samples belong to.
+ * @param[in,out] samples The samples to process.
+ * @param numSamples The number of samples in @c samples.
+ */
+void AiaPcm_RemoveDc( AiaPcmDcFilter_t* filter, int16_t* samples,
+                      size_t numSamples );
+
+/**
+ * Multiplies @c samples in place by @c gain, saturating at the limits of @c
+ * int16_t.
+ *
+ * @param[in,out] samples The samples to process.
+ * @param numSamples The number of samples in @c samples.
+ * @param gain The gain to apply.
+ */
+void AiaPcm_ApplyGain( int16_t* samples, size_t numSamples, AiaPcmGain_t gain );
+
+/**
+ * Measures the peak and RMS energy of @c samples.
+ *
+ * @param samples The samples to measure.
+ * @param numSamples The number of samples in @c samples.
+ * @param[out] energy The energy of @c samples. Both values are @c 0 when @c
+ * numSamples is @c 0.
+ */
+void AiaPcm_MeasureEnergy( const int16_t* samples, size_t numSamples,
+                           AiaPcmEnergy_t* energy );
+
+/**
+ * Counts the sign changes between adjacent samples of @c samples. Zero is
+ * counted as positive. The rate of zero crossings helps tell noise, which
+ * crosses often, from voiced speech of similar energy.
+ *
+ * @param samples The samples to measure.
+ * @param numSamples The number of samples in @c samples.
+ * @return The number of zero crossings in @c samples.
+ */
+size_t AiaPcm_CountZeroCrossings( const int16_t* samples, size_t numSamples );
+
+/**
+ * Mixes interleaved multi-channel @c frames down to one channel as a weighted
+ * sum of the channels, saturating at the limits of @c int16_t. Equal weights
+ * summing to @c AIA_PCM_GAIN_UNITY average the channels, while a single unity
+ * weight selects one channel, e.g. the beam chosen by a front end.
+ *
+ * @param frames The interleaved samples to mix.
+ * @param numChannels The number of channels in each frame of @c frames.
+ * @param weights The gain to apply to each channel, @c numChannels long.
+ * @param[out] out The mixed samples. This must not overlap @c frames.
+ * @param numFrames The number of frames in @c frames and samples in @c out.
+ */
+void AiaPcm_Downmix( const int16_t* frames, size_t numChannels,
+                     const AiaPcmGain_t* weights, int16_t* out,
+                     size_t numFrames );
+
+/**
+ * Computes the gain which would bring a block with the given @c peak to @c
+ * targetPeak, without exceeding @c maxGain.
+ *
+ * @param peak The peak of the block, as measured by @c AiaPcm_MeasureEnergy().
+ * @param targetPeak The desired peak, from @c 1 to @c 32767.
+ * @param maxGain The largest gain to return, which bounds the amplification of
+ * silence and noise.
+ * @return The normalization gain.
+ */
+AiaPcmGain_t AiaPcm_GetNormalizationGain( uint32_t peak, uint16_t targetPeak,
+                                          AiaPcmGain_t maxGain );
+
+/**
+ * Converts @c samples to floating point in the range [-1, 1).
+ *
+ * @param samples The samples to convert.
+ * @param[out] out The converted samples. This must not overlap @c samples.
+ * @param numSamples The number of samples in @c samples and @c out.
+ */
+void AiaPcm_Int16ToFloat( const int16_t* samples, float* out,
+                          size_t numSamples );
+
+/**
+ * Converts floating point @c samples in the range [-1, 1) to 16-bit PCM,
+ * rounding to the nearest value and saturating samples outside the range.
+ *
+ * @param samples The samples to convert.
+ * @param[out] out The converted samples. This must not overlap @c samples.
+ * @param numSamples The number of samples in @c samples and @c out.
+ */
+void AiaPcm_FloatToInt16( const float* samples, int16_t* out,
+                          size_t numSamples );
+
+#endif /* ifndef AIA_PCM_H_ */
@@ -0,0 +1,138 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm_resampler.h
+ * @brief User-facing functions of the @c AiaPcmResampler_t type.
+ *
+ * Like the functions in aia_pcm.h, the per-sample loops of the resampler are
+ * branch-free and operate on non-aliasing buffers so that compilers can
+ * vectorize them for the target without any platform-specific code.
+ */
+
+#ifndef AIA_PCM_RESAMPLER_H_
+#define AIA_PCM_RESAMPLER_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The number of input frames each output frame is filtered from. */
+#define AIA_PCM_RESAMPLER_TAPS 32
+
+/**
+ * The largest upsampling factor once the ratio of the rates is reduced, which
+ * covers conversions between 44.1 kHz and 48 kHz in either direction.
+ */
+#define AIA_PCM_RESAMPLER_MAX_PHASES 160
+
+/** The most interleaved channels a resampler can process. */
+#define AIA_PCM_RESAMPLER_MAX_CHANNELS 2
+
+/**
+ * A streaming polyphase resampler for 16-bit PCM, e.g. to play the output of
+ * @c AiaOpusDecoder_t on a codec running at 44.1 kHz. The filter and the input
+ * carried between calls are held in the object itself, so that nothing is
+ * allocated after @c AiaPcmResampler_Init(). The object is about 10 KB and is
+ * typically allocated statically. Methods of this object are not thread-safe.
+ *
+ * @note The members of this struct are private and should only be accessed
+ * through the functions below.
+ */
+typedef struct AiaPcmResampler
+{
+    /** The number of interleaved channels. */
+    size_t numChannels;
+
+    /** The upsampling factor, which is also the number of filter phases. */
+    uint32_t upFactor;
+
+    /** The downsampling factor. */
+    uint32_t downFactor;
+
+    /** The filter phase of the next output frame. */
+    uint32_t phase;
+
+    /** The index of the newest input frame the next output frame is filtered
+     * from, relative to the start of the next input. */
+    size_t position;
+
+    /** The filter of each phase in Q14 fixed point, oldest frame first. */
+    int16_t coefficients[ AIA_PCM_RESAMPLER_MAX_PHASES ]
+                        [ AIA_PCM_RESAMPLER_TAPS ];
+
+    /** The last @c AIA_PCM_RESAMPLER_TAPS - 1 input frames, followed by room
+     * for as many frames of the next input so that output frames which straddle
+     * two inputs can be filtered from one buffer. */
+    int16_t history[ 2 * ( AIA_PCM_RESAMPLER_TAPS - 1 ) *
+                     AIA_PCM_RESAMPLER_MAX_CHANNELS ];
+} AiaPcmResampler_t;
+
+/**
+ * Initializes a resampler and designs its filter, whose cutoff is at 90% of the
+ * lower of the two Nyquist frequencies.
+ *
+ * @param[out] resampler The resampler to initialize.
+ * @param inputRate The sample rate of the input, in Hz.
+ * @param outputRate The sample rate of the output, in Hz.
+ * @param numChannels The number of interleaved channels, from @c 1 to @c
+ * AIA_PCM_RESAMPLER_MAX_CHANNELS.
+ * @return @c true if the resampler was initialized or @c false otherwise,
+ * including if the reduced ratio of the rates needs more than @c
+ * AIA_PCM_RESAMPLER_MAX_PHASES phases.
+ */
+bool AiaPcmResampler_Init( AiaPcmResampler_t* resampler, uint32_t inputRate,
+                           uint32_t outputRate, size_t numChannels );
+
+/**
+ * Discards the input carried between calls, e.g. when playback is stopped, so
+ * that the next input starts a new stream.
+ *
+ * @param resampler The resampler to act on.
+ */
+void AiaPcmResampler_Reset( AiaPcmResampler_t* resampler );
+
+/**
+ * @param resampler The resampler to act on.
+ * @param numInputFrames A number of input frames.
+ * @return The most output frames @c AiaPcmResampler_Process() can produce from
+ * @c numInputFrames input frames.
+ */
+size_t AiaPcmResampler_GetMaxOutputFrames( const AiaPcmResampler_t* resampler,
+                                           size_t numInputFrames );
+
+/**
+ * Resamples a block of a stream. All of @c input is consumed, and output
+ * frames which depend on input not yet seen are produced by later calls.
+ *
+ * @param resampler The resampler to act on.
+ * @param input The interleaved frames to resample.
+ * @param numInputFrames The number of frames in @c input.
+ * @param[out] output The resampled interleaved frames. This must not overlap
+ * @c input.
+ * @param outputCapacity The number of frames @c output can hold, which must be
+ * at least @c AiaPcmResampler_GetMaxOutputFrames() of @c numInputFrames.
+ * @return The number of frames written to @c output. Nothing is consumed if
+ * this is @c 0 because of invalid arguments.
+ */
+size_t AiaPcmResampler_Process( AiaPcmResampler_t* resampler,
+                                const int16_t* input, size_t numInputFrames,
+                                int16_t* output, size_t outputCapacity );
+
+#endif /* ifndef AIA_PCM_RESAMPLER_H_ */
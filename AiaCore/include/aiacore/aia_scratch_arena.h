@@ -0,0 +1,99 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_scratch_arena.h
+ * @brief User-facing functions of the @c AiaScratchArena_t type.
+ */
+
+#ifndef AIA_SCRATCH_ARENA_H_
+#define AIA_SCRATCH_ARENA_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A bump allocator for short-lived scratch memory. Allocations are carved out
+ * of one buffer and are all released at once by @c AiaScratchArena_Reset(),
+ * which avoids heap traffic and fragmentation for objects that live only for
+ * the handling of one message. Allocations that do not fit fall back to the
+ * heap. Methods of this object are not thread-safe.
+ */
+typedef struct AiaScratchArena AiaScratchArena_t;
+
+/**
+ * Allocates and initializes a @c AiaScratchArena_t object from the heap. The
+ * returned pointer should be destroyed using @c AiaScratchArena_Destroy().
+ *
+ * @param capacity The number of bytes the arena can hand out between resets.
+ * @return The newly created @c AiaScratchArena_t if successful, or @c NULL
+ * otherwise.
+ */
+AiaScratchArena_t* AiaScratchArena_Create( size_t capacity );
+
+/**
+ * Uninitializes and deallocates an @c AiaScratchArena_t previously created by
+ * a call to @c AiaScratchArena_Create().
+ *
+ * @param arena The @c AiaScratchArena_t to destroy.
+ */
+void AiaScratchArena_Destroy( AiaScratchArena_t* arena );
+
+/**
+ * Allocates zeroed memory for an array of @c count elements of @c size bytes
+ * each, like @c AiaCalloc(). The memory comes from @c arena if it fits, or
+ * from the heap otherwise.
+ *
+ * @param arena The @c AiaScratchArena_t to allocate from, or @c NULL to
+ * allocate from the heap.
+ * @param count The number of elements.
+ * @param size The size of each element.
+ * @return The allocated memory, which must be released with @c
+ * AiaScratchArena_Free(), or @c NULL on failure.
+ */
+void* AiaScratchArena_Calloc( AiaScratchArena_t* arena, size_t count,
+                              size_t size );
+
+/**
+ * Releases memory returned by @c AiaScratchArena_Calloc(). Memory from the
+ * arena itself is only reclaimed by @c AiaScratchArena_Reset(), so this only
+ * frees heap fallbacks.
+ *
+ * @param arena The @c AiaScratchArena_t @c memory was allocated from, or @c
+ * NULL if it was allocated from the heap.
+ * @param memory The memory to release.
+ */
+void AiaScratchArena_Free( AiaScratchArena_t* arena, void* memory );
+
+/**
+ * Releases all memory handed out by @c arena. Memory from the arena must not
+ * be used after this is called.
+ *
+ * @param arena The @c AiaScratchArena_t to act on.
+ */
+void AiaScratchArena_Reset( AiaScratchArena_t* arena );
+
+/**
+ * @param arena The @c AiaScratchArena_t to act on.
+ * @return The most bytes of @c arena in use at once since it was created, for
+ * sizing the arena.
+ */
+size_t AiaScratchArena_GetHighWaterMark( const AiaScratchArena_t* arena );
+
+#endif /* ifndef AIA_SCRATCH_ARENA_H_ */
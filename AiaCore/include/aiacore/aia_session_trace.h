@@ -0,0 +1,136 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_session_trace.h
+ * @brief Binary format of recorded sessions, holding the decrypted messages
+ * the service sent to the dispatcher.
+ *
+ * A trace is a header followed by one record per message, in the order the
+ * messages were handled:
+ *
+ * | Field           | Encoding                                             |
+ * |-----------------|------------------------------------------------------|
+ * | delay           | LEB128 varint, milliseconds since the last record    |
+ * | topic           | one byte, the @c AiaTopic_t                          |
+ * | sequence number | LEB128 varint, zero for unsequenced topics           |
+ * | payload size    | LEB128 varint                                        |
+ * | payload         | the plaintext, without the encrypted sequence number |
+ *
+ * Speaker messages make up most of a session, and most of their records spend
+ * only five or six bytes besides the audio itself.
+ */
+
+#ifndef AIA_SESSION_TRACE_H_
+#define AIA_SESSION_TRACE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_message_constants.h>
+#include <aiacore/aia_topic.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The size of the header starting a trace. */
+#define AIA_SESSION_TRACE_HEADER_SIZE 5
+
+/** The most bytes a record can take besides its payload. */
+#define AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE 21
+
+/** One message of a recorded session. */
+typedef struct AiaSessionTraceRecord
+{
+    /** The time since the previous record, or since recording started. */
+    AiaDurationMs_t delayMs;
+
+    /** The topic the message arrived on. */
+    AiaTopic_t topic;
+
+    /** The sequence number of the message, or zero for unsequenced topics. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The plaintext of the message. */
+    const uint8_t* payload;
+
+    /** The size of @c payload. */
+    size_t payloadSize;
+} AiaSessionTraceRecord_t;
+
+/**
+ * Called with each message once it has been decrypted and sequenced, before
+ * it is handled.
+ *
+ * @param topic The topic of the message.
+ * @param sequenceNumber The sequence number of the message, or zero for
+ * unsequenced topics.
+ * @param plaintext The plaintext of the message, which is only valid during
+ * the call.
+ * @param size The size of @c plaintext.
+ * @param userData Context passed in along with this callback.
+ */
+typedef void ( *AiaSessionTraceObserver_t )(
+    AiaTopic_t topic, AiaSequenceNumber_t sequenceNumber,
+    const void* plaintext, size_t size, void* userData );
+
+/**
+ * Writes the header which starts a trace.
+ *
+ * @param[out] buffer The buffer to write to.
+ * @param size The size of @c buffer.
+ * @return The number of bytes written, or zero if @c buffer is too small.
+ */
+size_t AiaSessionTrace_WriteHeader( uint8_t* buffer, size_t size );
+
+/**
+ * Checks that a trace starts with a header this version can read.
+ *
+ * @param buffer The start of the trace.
+ * @param size The size of @c buffer.
+ * @return The size of the header, or zero if it is truncated or not readable.
+ */
+size_t AiaSessionTrace_ReadHeader( const uint8_t* buffer, size_t size );
+
+/**
+ * Writes every field of a record but its payload, which the caller writes
+ * after them. This lets recorders write payloads straight from the
+ * dispatcher's buffers.
+ *
+ * @param record The record to write. Its @c payload is not used.
+ * @param[out] buffer The buffer to write to, of at least @c
+ * AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE bytes to fit any record.
+ * @param size The size of @c buffer.
+ * @return The number of bytes written, or zero if @c buffer is too small or
+ * @c record is invalid.
+ */
+size_t AiaSessionTrace_WriteRecordHeader(
+    const AiaSessionTraceRecord_t* record, uint8_t* buffer, size_t size );
+
+/**
+ * Reads a record, payload included.
+ *
+ * @param buffer The start of the record.
+ * @param size The size of @c buffer.
+ * @param[out] record The record read. Its @c payload points into @c buffer.
+ * @return The number of bytes read, or zero if the record is truncated or
+ * malformed.
+ */
+size_t AiaSessionTrace_ReadRecord( const uint8_t* buffer, size_t size,
+                                   AiaSessionTraceRecord_t* record );
+
+#endif /* ifndef AIA_SESSION_TRACE_H_ */
@@ -0,0 +1,128 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_startup_trace.h
+ * @brief Marks the phases of bringing up a client, so that they can be timed.
+ *
+ * @c AiaClient_Create() marks the creation of each of its components, and
+ * components mark the storage loads they make on their way to ready, which
+ * may happen after creation when they are loaded lazily. Nothing is recorded
+ * unless an observer is set, so marks cost a single load otherwise.
+ *
+ * There is one observer per process, which should be set before any client is
+ * created and left in place until they are destroyed.
+ */
+
+#ifndef AIA_STARTUP_TRACE_H_
+#define AIA_STARTUP_TRACE_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <stdbool.h>
+
+/** The phases of bringing up a client. */
+typedef enum AiaStartupPhase
+{
+    /** Creating the secret manager, including @c AIA_STARTUP_PHASE_LOAD_SECRET.
+     */
+    AIA_STARTUP_PHASE_SECRET_MANAGER,
+
+    /** Loading the shared secret from storage. */
+    AIA_STARTUP_PHASE_LOAD_SECRET,
+
+    /** Creating the emitters and regulators of events and capabilities. */
+    AIA_STARTUP_PHASE_EVENT_PUBLISHING,
+
+    /** Creating the capabilities sender. */
+    AIA_STARTUP_PHASE_CAPABILITIES_SENDER,
+
+    /** Creating the dispatcher. */
+    AIA_STARTUP_PHASE_DISPATCHER,
+
+    /** Creating the connection manager and routing topics to the dispatcher.
+     */
+    AIA_STARTUP_PHASE_CONNECTION_MANAGER,
+
+    /** Creating the exception manager. */
+    AIA_STARTUP_PHASE_EXCEPTION_MANAGER,
+
+    /** Creating the speaker manager. */
+    AIA_STARTUP_PHASE_SPEAKER_MANAGER,
+
+    /** Creating the UX manager. */
+    AIA_STARTUP_PHASE_UX_MANAGER,
+
+    /** Creating the microphone manager, its emitter and its regulator. */
+    AIA_STARTUP_PHASE_MICROPHONE_MANAGER,
+
+    /** Creating the alert manager. */
+    AIA_STARTUP_PHASE_ALERT_MANAGER,
+
+    /** Loading alerts from storage. */
+    AIA_STARTUP_PHASE_LOAD_ALERTS,
+
+    /** Creating the clock manager. */
+    AIA_STARTUP_PHASE_CLOCK_MANAGER,
+
+    /** The number of phases. */
+    AIA_NUM_STARTUP_PHASES
+} AiaStartupPhase_t;
+
+/**
+ * This callback is used to observe the start and end of startup phases. It is
+ * called on the thread doing the work of the phase, and should only take a
+ * timestamp.
+ *
+ * @param phase The phase which started or ended.
+ * @param isEnd Whether @c phase ended rather than started.
+ * @param userData Optional user data pointer which was provided alongside the
+ * callback.
+ */
+typedef void ( *AiaStartupTraceObserver_t )( AiaStartupPhase_t phase,
+                                             bool isEnd, void* userData );
+
+/**
+ * Sets the observer of startup phases.
+ *
+ * @param observer The observer, or @c NULL to stop observing.
+ * @param userData User data to pass to @c observer.
+ */
+void AiaStartupTrace_SetObserver( AiaStartupTraceObserver_t observer,
+                                  void* userData );
+
+/**
+ * Marks the start of a phase.
+ *
+ * @param phase The phase starting.
+ */
+void AiaStartupTrace_Begin( AiaStartupPhase_t phase );
+
+/**
+ * Marks the end of a phase.
+ *
+ * @param phase The phase ending.
+ */
+void AiaStartupTrace_End( AiaStartupPhase_t phase );
+
+/**
+ * @param phase A phase to get the string representation of.
+ * @return The string representation of @c phase.
+ */
+const char* AiaStartupPhase_ToString( AiaStartupPhase_t phase );
+
+#endif /* ifndef AIA_STARTUP_TRACE_H_ */
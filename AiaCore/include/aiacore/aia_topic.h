@@ -85,6 +85,30 @@ typedef enum AiaTopic
 
 /** @} */
 
+/** The number of slots in the topic hash table. */
+#define AIA_TOPIC_HASH_SLOTS 32
+
+/**
+ * Hashes a topic string from its length alone. Every topic leaf node has a
+ * distinct length below @c AIA_TOPIC_HASH_SLOTS, so this is a perfect hash
+ * which allows @c AiaTopic_FromString() to find a topic with a single
+ * comparison.
+ *
+ * @param length The length of the topic string.
+ * @return The hash table slot for the topic string.
+ */
+#define AIA_TOPIC_HASH( length ) ( (size_t)( length ) % AIA_TOPIC_HASH_SLOTS )
+
+/**
+ * Declares the hash table entry for a topic. Entries hold the topic value plus
+ * one so that empty slots are zero.
+ *
+ * @param TOPIC The @c AiaTopic_t value without the @c AIA_TOPIC_ prefix.
+ */
+#define AIA_TOPIC_HASH_ENTRY( TOPIC )                          \
+    [AIA_TOPIC_HASH( sizeof( AIA_TOPIC_##TOPIC##_STRING ) - 1 )] = \
+        AIA_TOPIC_##TOPIC + 1
+
 /** The different topic types supported by this SDK. */
 typedef enum AiaTopicType
 {
@@ -309,15 +333,17 @@ inline size_t AiaTopic_GetLength( AiaTopic_t topic )
 inline bool AiaTopic_FromString( const char* topicString,
                                  size_t topicStringLength, AiaTopic_t* topic )
 {
-    static const AiaTopic_t topics[ AIA_NUM_TOPICS ] = {
-        AIA_TOPIC_CONNECTION_FROM_CLIENT,
-        AIA_TOPIC_CONNECTION_FROM_SERVICE,
-        AIA_TOPIC_CAPABILITIES_PUBLISH,
-        AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
-        AIA_TOPIC_DIRECTIVE,
-        AIA_TOPIC_EVENT,
-        AIA_TOPIC_MICROPHONE,
-        AIA_TOPIC_SPEAKER
+    /* A colliding entry is a duplicate initializer, which -Woverride-init
+     * reports at compile time. */
+    static const uint8_t topicSlots[ AIA_TOPIC_HASH_SLOTS ] = {
+        AIA_TOPIC_HASH_ENTRY( CONNECTION_FROM_CLIENT ),
+        AIA_TOPIC_HASH_ENTRY( CONNECTION_FROM_SERVICE ),
+        AIA_TOPIC_HASH_ENTRY( CAPABILITIES_PUBLISH ),
+        AIA_TOPIC_HASH_ENTRY( CAPABILITIES_ACKNOWLEDGE ),
+        AIA_TOPIC_HASH_ENTRY( DIRECTIVE ),
+        AIA_TOPIC_HASH_ENTRY( EVENT ),
+        AIA_TOPIC_HASH_ENTRY( MICROPHONE ),
+        AIA_TOPIC_HASH_ENTRY( SPEAKER )
     };
     if( !topicString )
     {
@@ -333,13 +359,15 @@ inline bool AiaTopic_FromString( const char* topicString,
     {
         topicStringLength = strlen( topicString );
     }
-    for( size_t i = 0; i < AiaArrayLength( topics ); ++i )
+    uint8_t slot = topicSlots[ AIA_TOPIC_HASH( topicStringLength ) ];
+    if( slot )
     {
-        if( AiaTopic_GetLength( topics[ i ] ) == topicStringLength &&
-            strncmp( topicString, AiaTopic_ToString( topics[ i ] ),
+        AiaTopic_t candidate = (AiaTopic_t)( slot - 1 );
+        if( AiaTopic_GetLength( candidate ) == topicStringLength &&
+            strncmp( topicString, AiaTopic_ToString( candidate ),
                      topicStringLength ) == 0 )
         {
-            *topic = topics[ i ];
+            *topic = candidate;
             return true;
         }
     }
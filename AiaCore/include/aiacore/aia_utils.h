@@ -105,7 +105,9 @@ inline void AiaReverseByteArray( uint8_t* byteArray, size_t byteArrayLen )
 }
 
 /**
- * Generates a random and unique null-terminated JSON message Id string.
+ * Generates a unique null-terminated JSON message Id string. IDs are a random
+ * per-process prefix offset by a counter, so they are unique but not
+ * unpredictable, and must not be used where secrecy is needed.
  *
  * @param [out] buffer buffer of length @c bufferLength to write a
  *     null-terminated message ID string into.
@@ -36,6 +36,22 @@
  */
 typedef struct AiaCapabilitiesSender AiaCapabilitiesSender_t;
 
+/**
+ * The speaker buffer configuration advertised in the @c Speaker capability,
+ * which defaults to @c AIA_AUDIO_BUFFER_SIZE and its warning thresholds.
+ */
+typedef struct AiaSpeakerBufferCapabilities
+{
+    /** Size of the speaker buffer in bytes. */
+    size_t size;
+
+    /** Buffered bytes above which the service is warned of an overrun. */
+    size_t overrunWarningThreshold;
+
+    /** Buffered bytes below which the service is warned of an underrun. */
+    size_t underrunWarningThreshold;
+} AiaSpeakerBufferCapabilities_t;
+
 /**
  * Allocates and initializes a @c AiaCapabilitiesSender_t object from the
  * heap. The returned pointer should be destroyed using @c
@@ -52,6 +68,27 @@ AiaCapabilitiesSender_t* AiaCapabilitiesSender_Create(
     AiaRegulator_t* capabilitiesRegulator,
     AiaCapabilitiesObserver_t stateObserver, void* stateObserverUserData );
 
+/**
+ * Allocates and initializes a @c AiaCapabilitiesSender_t object like @c
+ * AiaCapabilitiesSender_Create(), but advertises the given speaker buffer
+ * instead of the one from @c aia_capabilities_config.h.
+ *
+ * @param capabilitiesRegulator The regulator to use to publish messages on the
+ * capabilities topic.
+ * @param stateObserver The observer callback to be notified of state changes.
+ * @param stateObserverUserData Context associated with @c stateObserver.
+ * @param speakerBuffer The speaker buffer to advertise, or @c NULL for the
+ * default. Its thresholds must not exceed its size, and the underrun threshold
+ * must not exceed the overrun threshold. This is ignored without the speaker
+ * interface.
+ * @return The newly created @c AiaCapabilitiesSender_t if successful, or
+ * NULL otherwise.
+ */
+AiaCapabilitiesSender_t* AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+    AiaRegulator_t* capabilitiesRegulator,
+    AiaCapabilitiesObserver_t stateObserver, void* stateObserverUserData,
+    const AiaSpeakerBufferCapabilities_t* speakerBuffer );
+
 /**
  * Uninitializes and deallocates an @c AiaCapabilitiesSender_t previously
  * created by a call to @c AiaCapabilitiesSender_Create().
@@ -73,4 +110,45 @@ void AiaCapabilitiesSender_Destroy(
 bool AiaCapabilitiesSender_PublishCapabilities(
     AiaCapabilitiesSender_t* capabilitiesSender );
 
+/**
+ * Checks whether the capabilities from @c aia_capabilities_config.h have been
+ * accepted, so that they need not be published again. Accepted capabilities
+ * are persisted, so this also holds for capabilities accepted before a
+ * restart, in which case the state changes to @c
+ * AIA_CAPABILITIES_STATE_ACCEPTED.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @return @c true if the capabilities have been accepted or @c false if they
+ * should be published.
+ */
+bool AiaCapabilitiesSender_IsAccepted(
+    AiaCapabilitiesSender_t* capabilitiesSender );
+
+/**
+ * Returns a digest of the capabilities if they have been accepted, which can
+ * be kept in memory that survives a restart and handed to @c
+ * AiaCapabilitiesSender_RestoreAccepted() afterwards.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @param[out] digest If the capabilities have been accepted, this will be set
+ * to their digest.
+ * @return @c true if the capabilities have been accepted or @c false otherwise.
+ */
+bool AiaCapabilitiesSender_GetAcceptedDigest(
+    AiaCapabilitiesSender_t* capabilitiesSender, uint32_t* digest );
+
+/**
+ * Marks the capabilities as accepted without reading the persisted copy, if @c
+ * digest was returned by @c AiaCapabilitiesSender_GetAcceptedDigest() for the
+ * same capabilities. The state changes to @c AIA_CAPABILITIES_STATE_ACCEPTED
+ * if nothing has been published yet.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @param digest The digest of the accepted capabilities.
+ * @return @c true if the capabilities are now accepted or @c false if they
+ * should be published.
+ */
+bool AiaCapabilitiesSender_RestoreAccepted(
+    AiaCapabilitiesSender_t* capabilitiesSender, uint32_t digest );
+
 #endif /* ifndef AIA_CAPABILITIES_SENDER_H_ */
@@ -37,6 +37,95 @@ static const AiaDataStreamBufferWordSize_t AiaDataStreamBufferWordSize_MAX =
  */
 typedef struct AiaDataStreamBuffer AiaDataStreamBuffer_t;
 
+/**
+ * Callback used to maintain CPU caches over a range of a buffer in external
+ * memory, e.g. by cleaning or invalidating the cache lines which hold it.
+ *
+ * @param data The start of the range.
+ * @param size The size of the range in bytes.
+ * @param userData User data associated with this callback.
+ */
+typedef void ( *AiaDataStreamBufferCacheMaintenance_t )( void* data,
+                                                        size_t size,
+                                                        void* userData );
+
+/**
+ * An entry of the metadata ring of an @c AiaDataStreamBuffer_t, recorded by
+ * @c AiaDataStreamWriter_Mark() alongside the words written to the stream, e.g.
+ * to carry capture timestamps for latency measurement or echo cancellation
+ * alignment, or to flag the index of a wake word.
+ */
+typedef struct AiaDataStreamMetadataEntry
+{
+    /** A timestamp in units chosen by the writer, e.g. microseconds. */
+    uint64_t timestamp;
+
+    /** The index of the first word written after the entry was recorded. */
+    AiaDataStreamIndex_t index;
+
+    /** An application-defined value distinguishing kinds of entries. */
+    uint32_t tag;
+} AiaDataStreamMetadataEntry_t;
+
+/**
+ * Options for @c AiaDataStreamBuffer_CreateWithOptions(). Zero-initialized
+ * options create the same buffer as @c AiaDataStreamBuffer_Create().
+ */
+typedef struct AiaDataStreamBufferOptions
+{
+    /**
+     * The alignment in bytes of the start of the data, which must be zero or a
+     * power of two. Bytes at the start of the caller's buffer are skipped to
+     * reach it, e.g. to align the data to cache lines or to the requirements
+     * of a DMA controller.
+     */
+    size_t dataAlignment;
+
+    /**
+     * Whether to round the number of words the buffer holds down to a power of
+     * two, so that indices are wrapped with masks.
+     */
+    bool powerOfTwoCapacity;
+
+    /**
+     * Whether the buffer is in memory which CPU caches do not keep coherent
+     * with its other users, e.g. PSRAM which DMA writes to. The hooks below
+     * are only called if this is set.
+     */
+    bool isExternalMemory;
+
+    /**
+     * Called on words copied in by @c AiaDataStreamWriter_Write() before they
+     * are published, to write them back from the cache. This may be @c NULL.
+     */
+    AiaDataStreamBufferCacheMaintenance_t cleanRange;
+
+    /**
+     * Called on words published by @c AiaDataStreamWriter_Publish() before
+     * they are visible to readers, to discard stale cached copies of data
+     * written in place, e.g. by DMA into space reserved by @c
+     * AiaDataStreamWriter_Reserve(). This may be @c NULL.
+     */
+    AiaDataStreamBufferCacheMaintenance_t invalidateRange;
+
+    /** User data to be passed to @c cleanRange and @c invalidateRange. */
+    void* cacheMaintenanceUserData;
+
+    /**
+     * Storage for a ring of the @c metadataCapacity most recent entries
+     * recorded by @c AiaDataStreamWriter_Mark(), or @c NULL for a buffer
+     * without metadata. Ownership is left to the caller, as for the data.
+     */
+    AiaDataStreamMetadataEntry_t* metadata;
+
+    /**
+     * The number of entries @c metadata holds, which must be at least two:
+     * the oldest entry is not returned by @c AiaDataStreamBuffer_FindMetadata()
+     * once the ring is full, as the writer may be overwriting it.
+     */
+    size_t metadataCapacity;
+} AiaDataStreamBufferOptions_t;
+
 /**
  * Allocates and initializes a @c AiaDataStreamBuffer_t object from the heap.
  * The returned pointer should be destroyed using @c
@@ -54,12 +143,99 @@ typedef struct AiaDataStreamBuffer AiaDataStreamBuffer_t;
  *
  * @return The newly created @c AiaDataStreamBuffer_t if successful, or NULL
  * otherwise.
+ *
+ * @note Buffers holding a power-of-two number of words, with a power-of-two
+ * @c wordSize, locate and wrap data with masks and shifts instead of divisions
+ * and multiplications.
  */
 AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
                                                    size_t bufferSize,
                                                    size_t wordSize,
                                                    size_t maxReaders );
 
+/**
+ * Allocates and initializes a @c AiaDataStreamBuffer_t object from the heap
+ * with control over where its data is placed, e.g. so that I2S DMA can write
+ * microphone samples straight into space reserved by @c
+ * AiaDataStreamWriter_Reserve() without a bounce buffer. The returned pointer
+ * should be destroyed using @c AiaDataStreamBuffer_Destroy().
+ *
+ * @param buffer The raw buffer which this abstraction will use to stream
+ * data into and from. Any existing data in the buffer will be overwritten.
+ * Ownership of the buffer is left to the caller but is no longer usable until a
+ * call to @c AiaDataStreamBuffer_Destroy().
+ * @param bufferSize The size of @c buffer in bytes.
+ * @param wordSize The size (in bytes) of words in the stream.
+ * @param maxReaders The maximum number readers of readers to allow to consume
+ * from the buffer.
+ * @param options Options for placing the data, or @c NULL for defaults.
+ *
+ * @return The newly created @c AiaDataStreamBuffer_t if successful, or NULL
+ * otherwise, including if no whole word fits in @c buffer after alignment.
+ *
+ * @note Cache maintenance callbacks receive the exact ranges of words written,
+ * which only cover whole cache lines if the data is aligned to cache lines and
+ * written in multiples of them.
+ */
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateWithOptions(
+    void* buffer, size_t bufferSize, size_t wordSize, size_t maxReaders,
+    const AiaDataStreamBufferOptions_t* options );
+
+/**
+ * Allocates and initializes a @c AiaDataStreamBuffer_t object from the heap
+ * which supports exactly one reader. Read operations on such a buffer advance
+ * the writer's barrier directly from the reader's cursor instead of scanning
+ * all readers under a lock, which makes committing reads lock-free. The
+ * returned pointer should be destroyed using @c AiaDataStreamBuffer_Destroy().
+ *
+ * @param buffer The raw buffer which this abstraction will use to stream
+ * data into and from. Any existing data in the buffer will be overwritten.
+ * Ownership of the buffer is left to the caller but is no longer usable until a
+ * call to @c AiaDataStreamBuffer_Destroy().
+ * @param bufferSize The size of @c buffer in bytes.
+ * @param wordSize The size (in bytes) of words in the stream.
+ *
+ * @return The newly created @c AiaDataStreamBuffer_t if successful, or NULL
+ * otherwise.
+ *
+ * @note The single reader must not be used concurrently from more than one
+ * thread, which is already a requirement of @c AiaDataStreamReader_t.
+ */
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateSingleReader(
+    void* buffer, size_t bufferSize, size_t wordSize );
+
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+/**
+ * Allocates and initializes a @c AiaDataStreamBuffer_t object from the heap
+ * whose data is mapped twice, back to back, so that any run of up to @c
+ * AiaDataStreamBuffer_GetDataSize() words is contiguous. Reads and writes are
+ * then never split at the end of the buffer, and @c AiaDataStreamReader_Peek()
+ * and @c AiaDataStreamWriter_Reserve() always return a single span, which can
+ * be handed to a decoder or cipher as is. Unlike the other buffers, the data
+ * is owned by the buffer. The returned pointer should be destroyed using @c
+ * AiaDataStreamBuffer_Destroy(). Only available on Linux.
+ *
+ * @param bufferSize The minimum size of the data in bytes, which is rounded up
+ * to a whole number of pages and of words.
+ * @param wordSize The size (in bytes) of words in the stream.
+ * @param maxReaders The maximum number of readers to allow to consume from the
+ * buffer.
+ * @param options Options for the buffer, or @c NULL for defaults. The data is
+ * page-aligned, so @c dataAlignment may be up to the page size, @c
+ * powerOfTwoCapacity needs a power-of-two @c wordSize, and @c isExternalMemory
+ * is not supported.
+ *
+ * @return The newly created @c AiaDataStreamBuffer_t if successful, or NULL
+ * otherwise.
+ *
+ * @note The data takes at least one page of memory, and twice its size of
+ * address space.
+ */
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateMirrored(
+    size_t bufferSize, size_t wordSize, size_t maxReaders,
+    const AiaDataStreamBufferOptions_t* options );
+#endif
+
 /**
  * Uninitializes and deallocates an @c AiaDataStreamBuffer previously created by
  * a call to
@@ -98,6 +274,46 @@ size_t AiaDataStreamBuffer_GetDataSize(
 size_t AiaDataStreamBuffer_GetWordSize(
     const AiaDataStreamBuffer_t* dataStream );
 
+/**
+ * This function moves the stream's data to a new buffer of a different size,
+ * such as to grow a buffer while a burst is written and return the memory
+ * once readers catch up. Indices are unchanged: the most recent words, up to
+ * the smaller of the two sizes, are copied to where the new size places them,
+ * and readers continue from their cursors. The buffer must not shrink below
+ * the words which writers that do not overwrite readers must keep intact. The
+ * alignment and power-of-two capacity options are not applied to the new
+ * buffer, and buffers in external memory or created by @c
+ * AiaDataStreamBuffer_CreateMirrored() cannot be resized. This function is
+ * not thread-safe: no reader or writer of the stream may be used concurrently,
+ * and no reservation may be outstanding.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer_t to act on.
+ * @param buffer The new buffer to use for the stream. The previous buffer may
+ * be freed once this function returns successfully.
+ * @param bufferSize The size (in bytes) of @c buffer.
+ * @return @c true if the data was moved to @c buffer, else @c false, in which
+ * case the stream still uses the previous buffer.
+ */
+bool AiaDataStreamBuffer_Resize( AiaDataStreamBuffer_t* dataStream,
+                                 void* buffer, size_t bufferSize );
+
+/**
+ * This function finds the most recent metadata entry recorded at or before a
+ * given index, i.e. the entry which describes the word at that index. Entries
+ * are ordered by index, so this is a binary search over the ring. The search
+ * does not take any locks, and is repeated if the writer overwrote an entry it
+ * examined. This function is thread-safe.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer_t to act on.
+ * @param index The index of the word to look up.
+ * @param[out] entry The entry found, if any.
+ * @return @c true if an entry was found, or @c false if the buffer has no
+ * metadata ring, or no entry at or before @c index is still held by it.
+ */
+bool AiaDataStreamBuffer_FindMetadata( AiaDataStreamBuffer_t* dataStream,
+                                       AiaDataStreamIndex_t index,
+                                       AiaDataStreamMetadataEntry_t* entry );
+
 /**
  * This function creates an @c AiaDataStreamWriter_t capable of streaming to
  * this buffer. Only one @c AiaDataStreamWriter_t is allowed at a time. This
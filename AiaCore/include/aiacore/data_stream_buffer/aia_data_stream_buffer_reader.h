@@ -110,6 +110,46 @@ typedef enum AiaDataStreamReaderError
     AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID = -3
 } AiaDataStreamReaderError_t;
 
+/** The maximum number of spans returned by @c AiaDataStreamReader_Peek(). */
+#define AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS 2
+
+/**
+ * A contiguous region of words within the storage of an @c
+ * AiaDataStreamBuffer_t, as returned by @c AiaDataStreamReader_Peek().
+ */
+typedef struct AiaDataStreamReaderSpan
+{
+    /** Pointer to the first word of the span, or @c NULL if empty. */
+    const void* data;
+
+    /** The number of @c wordSize words in the span. */
+    size_t nWords;
+} AiaDataStreamReaderSpan_t;
+
+/**
+ * Callback used to hand data read by @c AiaDataStreamReader_ReadFanOut() to a
+ * consumer.
+ *
+ * @param data Pointer to the first word of the data. This points directly into
+ * the storage of the @c AiaDataStreamBuffer_t and is only valid for the
+ * duration of the call.
+ * @param nWords The number of @c wordSize words in @c data.
+ * @param userData User data associated with this callback.
+ */
+typedef void ( *AiaDataStreamReaderConsume_t )( const void* data,
+                                                size_t nWords,
+                                                void* userData );
+
+/** A consumer of data read by @c AiaDataStreamReader_ReadFanOut(). */
+typedef struct AiaDataStreamReaderConsumer
+{
+    /** Callback to hand the data to. */
+    AiaDataStreamReaderConsume_t consume;
+
+    /** User data to be passed along with @c consume. */
+    void* userData;
+} AiaDataStreamReaderConsumer_t;
+
 /**
  * Uninitializes and deallocates an @c AiaDataStreamReader_t previously created
  * by a call to
@@ -145,6 +185,97 @@ void AiaDataStreamReader_Destroy( AiaDataStreamReader_t* reader );
 ssize_t AiaDataStreamReader_Read( AiaDataStreamReader_t* reader, void* buf,
                                   size_t nWords );
 
+/**
+ * This function waits until @c nWords words are available to be read, or the
+ * stream closes, or @c timeoutMs elapses, and then behaves as @c
+ * AiaDataStreamReader_Read(). Waiting readers are woken by the writer, so
+ * consumers such as keyword spotters do not need to poll. Readers which never
+ * wait cost writers a single atomic load per write.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @param buf A buffer to copy the consumed data to, which must be large enough
+ * to hold @c nWords words.
+ * @param nWords The number of @c wordSize words to wait for and copy. Waits
+ * end once the whole buffer is available if this exceeds its size.
+ * @param timeoutMs The maximum time to wait.
+ * @return As for @c AiaDataStreamReader_Read(). Fewer than @c nWords words may
+ * be copied if the wait timed out, or @c
+ * AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK returned if none are
+ * available.
+ *
+ * @note Only one thread may wait on a given @c AiaDataStreamReader_t at a time.
+ */
+ssize_t AiaDataStreamReader_ReadWait( AiaDataStreamReader_t* reader, void* buf,
+                                      size_t nWords,
+                                      AiaDurationMs_t timeoutMs );
+
+/**
+ * This function consumes data from the stream and hands it to several
+ * consumers in one pass. Each contiguous span of data is passed to every
+ * consumer in turn, in place and without copying, so that it is still in cache
+ * for the later consumers. The @c AiaDataStreamReader_t position, and the
+ * writer barrier, are only updated once for the whole batch. This lets
+ * consumers which always read the same data share one @c AiaDataStreamReader_t
+ * instead of each reading through its own. This function is thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @param consumers Array of consumers to hand the data to.
+ * @param numConsumers The number of consumers in @c consumers.
+ * @param nWords The maximum number of @c wordSize words to consume.
+ * @return The number of @c wordSize words consumed, or the same values as @c
+ * AiaDataStreamReader_Read() otherwise.
+ *
+ * @note As with @c AiaDataStreamReader_Peek(), a non-blocking writer may
+ * overwrite data while it is being consumed. This is reported with a @c
+ * AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN result, after the consumers have
+ * been called.
+ */
+ssize_t AiaDataStreamReader_ReadFanOut(
+    AiaDataStreamReader_t* reader,
+    const AiaDataStreamReaderConsumer_t* consumers, size_t numConsumers,
+    size_t nWords );
+
+/**
+ * This function exposes data from the stream without copying or consuming it.
+ * Up to @c nWords words are described by @c spans, which point directly into
+ * the underlying @c AiaDataStreamBuffer_t storage. The first span always starts
+ * at the current reader position; the second span is only non-empty when the
+ * data wraps around the end of the buffer. The data remains unconsumed until a
+ * subsequent call to @c AiaDataStreamReader_Commit(). This function is
+ * thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @param spans Array which will be populated with the spans of peeked data.
+ * @param nWords The maximum number of @c wordSize words to peek.
+ * @return The total number of @c wordSize words described by @c spans if data
+ * is available, or the same values as @c AiaDataStreamReader_Read() otherwise.
+ *
+ * @note A non-blocking writer may overwrite peeked data at any time. Callers
+ * must treat a @c AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN result from @c
+ * AiaDataStreamReader_Commit() as an indication that the peeked data was
+ * invalidated while in use.
+ */
+ssize_t AiaDataStreamReader_Peek(
+    AiaDataStreamReader_t* reader,
+    AiaDataStreamReaderSpan_t spans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ],
+    size_t nWords );
+
+/**
+ * This function consumes data previously exposed by @c
+ * AiaDataStreamReader_Peek(), advancing the @c AiaDataStreamReader_t position.
+ * Spans from the previous peek must not be used after this call. This function
+ * is thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @param nWords The number of @c wordSize words to consume. This must not
+ * exceed the number of words returned by the previous peek.
+ * @return @c nWords on success, @c AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN
+ * if the consumed data was overwritten, or @c
+ * AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID if @c nWords is invalid.
+ */
+ssize_t AiaDataStreamReader_Commit( AiaDataStreamReader_t* reader,
+                                    size_t nWords );
+
 /**
  * This function moves the @c AiaDataStreamReader_t to the specified location in
  * the stream.  If successful, subsequent calls to
@@ -185,6 +316,48 @@ AiaDataStreamIndex_t AiaDataStreamReader_Tell(
     const AiaDataStreamReader_t* reader,
     AiaDataStreamReaderReference_t reference );
 
+/**
+ * This function reports the oldest position in the stream which is still held
+ * in the buffer, and so can be reached with @c AiaDataStreamReader_Seek(). This
+ * is constant time and does not move the @c AiaDataStreamReader_t. This
+ * function is thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @return The absolute index of the oldest word in the buffer.
+ *
+ * @note A nonblockable writer may overwrite this position at any time, in which
+ * case a subsequent seek to it will fail, unless a reader is pinned with @c
+ * AiaDataStreamReader_Pin().
+ */
+AiaDataStreamIndex_t AiaDataStreamReader_GetOldestIndex(
+    const AiaDataStreamReader_t* reader );
+
+/**
+ * This function pins the @c AiaDataStreamReader_t, so that writers of every
+ * policy, including @c AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, leave the
+ * words from its cursor on intact until it reads them or is unpinned. Writes
+ * which would overwrite them are shortened, or fail with @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK if no words fit. This lets a
+ * reader seek back into data such as wake word preroll and stream it without
+ * being lapped. Only one reader of a stream may be pinned at a time, and it
+ * should be unpinned promptly, since a stalled pinned reader stalls the writer.
+ * This function must not be called concurrently with other calls on the same
+ * reader.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @return @c true if the reader was pinned, or @c false if another reader is
+ * pinned or the data at the reader's cursor has already been overwritten.
+ */
+bool AiaDataStreamReader_Pin( AiaDataStreamReader_t* reader );
+
+/**
+ * This function releases a pin taken by @c AiaDataStreamReader_Pin(). It does
+ * nothing if the reader is not pinned.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ */
+void AiaDataStreamReader_Unpin( AiaDataStreamReader_t* reader );
+
 /**
  * This function sets the point at which the @c AiaDataStreamReader_t's stream
  * will close. To schedule the stream to close once all the data which is
@@ -205,6 +378,48 @@ void AiaDataStreamReader_Close( AiaDataStreamReader_t* reader,
                                 AiaDataStreamIndex_t offset,
                                 AiaDataStreamReaderReference_t reference );
 
+/**
+ * Function pointer used to notify a reader that data it requested to be
+ * notified about via @c AiaDataStreamReader_NotifyWhenAvailable() has been
+ * written. This will be invoked from the execution context of the writer, so
+ * implementations are expected to be non-blocking and must not call back into
+ * the @c AiaDataStreamReader_t or the writer.
+ *
+ * @param userData Context passed to @c
+ * AiaDataStreamReader_NotifyWhenAvailable().
+ */
+typedef void ( *AiaDataStreamReaderNotifyCallback_t )( void* userData );
+
+/**
+ * This function requests a one-shot notification once at least @c nWords words
+ * are available to be read by the @c AiaDataStreamReader_t. This allows readers
+ * to wait for data without polling. Only one notification may be armed per @c
+ * AiaDataStreamBuffer_t at a time, and arming a new one replaces any previously
+ * armed notification. This function is thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ * @param nWords The number of words that must be available before @c callback
+ * is invoked.
+ * @param callback The callback to invoke from the writer's execution context.
+ * @param userData Context to be passed to @c callback.
+ * @return @c true if the notification was armed, or @c false if @c nWords words
+ * are already available to be read (or on failure), in which case @c callback
+ * will not be invoked.
+ */
+bool AiaDataStreamReader_NotifyWhenAvailable(
+    AiaDataStreamReader_t* reader, size_t nWords,
+    AiaDataStreamReaderNotifyCallback_t callback, void* userData );
+
+/**
+ * This function disarms a notification previously armed by the @c
+ * AiaDataStreamReader_t using @c AiaDataStreamReader_NotifyWhenAvailable().
+ * Once this function returns, the callback is guaranteed not to be running and
+ * will not be invoked. This function is thread-safe.
+ *
+ * @param reader The @c AiaDataStreamReader_t to act on.
+ */
+void AiaDataStreamReader_CancelNotification( AiaDataStreamReader_t* reader );
+
 /**
  * This function returns the id assigned to this @c AiaDataStreamReader_t.
  *
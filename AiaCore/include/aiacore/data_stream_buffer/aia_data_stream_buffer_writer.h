@@ -80,6 +80,22 @@ typedef enum AiaDataStreamWriterError
     AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID = -2,
 } AiaDataStreamWriterError_t;
 
+/** The maximum number of spans returned by @c AiaDataStreamWriter_Reserve(). */
+#define AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS 2
+
+/**
+ * A contiguous writable region of words within the storage of an @c
+ * AiaDataStreamBuffer_t, as returned by @c AiaDataStreamWriter_Reserve().
+ */
+typedef struct AiaDataStreamWriterSpan
+{
+    /** Pointer to the first word of the span, or @c NULL if empty. */
+    void* data;
+
+    /** The number of @c wordSize words in the span. */
+    size_t nWords;
+} AiaDataStreamWriterSpan_t;
+
 /**
  * Uninitializes and deallocates an @c AiaDataStreamWriter_t previously created
  * by a call to
@@ -105,6 +121,62 @@ void AiaDataStreamWriter_Destroy( AiaDataStreamWriter_t* writer );
 ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
                                    const void* buf, size_t nWords );
 
+/**
+ * This function reserves space at the end of the stream so that producers can
+ * fill it in place rather than copying from a scratch buffer with @c
+ * AiaDataStreamWriter_Write(). Up to @c nWords words are described by @c spans,
+ * which point directly into the underlying @c AiaDataStreamBuffer_t storage.
+ * The second span is only non-empty when the reservation wraps around the end
+ * of the buffer. The number of words reserved is bounded by the writer's
+ * policy exactly as @c AiaDataStreamWriter_Write() would be, and by the size of
+ * the buffer. Reserved data becomes visible to readers after a call to @c
+ * AiaDataStreamWriter_Publish(). This function is thread-safe.
+ *
+ * @param writer The @c AiaDataStreamWriter_t to act on.
+ * @param spans Array which will be populated with the reserved spans.
+ * @param nWords The maximum number of @c wordSize words to reserve.
+ * @return The total number of @c wordSize words described by @c spans, or @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_ERROR_CLOSED if the stream has closed, or a
+ * negative @c Error code if no space could be reserved.
+ *
+ * @note Only a single reservation may be outstanding at a time, and @c
+ * AiaDataStreamWriter_Write() may not be called while one is.
+ */
+ssize_t AiaDataStreamWriter_Reserve(
+    AiaDataStreamWriter_t* writer,
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ],
+    size_t nWords );
+
+/**
+ * This function publishes data written into space previously reserved by @c
+ * AiaDataStreamWriter_Reserve(), making it available to readers. Any reserved
+ * words beyond @c nWords are released. This function is thread-safe.
+ *
+ * @param writer The @c AiaDataStreamWriter_t to act on.
+ * @param nWords The number of @c wordSize words to publish. This must not
+ * exceed the number of words reserved.
+ * @return @c nWords on success or @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID otherwise.
+ */
+ssize_t AiaDataStreamWriter_Publish( AiaDataStreamWriter_t* writer,
+                                     size_t nWords );
+
+/**
+ * This function records an entry in the metadata ring of the stream, see @c
+ * AiaDataStreamBufferOptions_t, describing the words written from the current
+ * position onwards. Entries are recorded without taking any locks. Once the
+ * ring is full, each entry overwrites the oldest one. This function must be
+ * called from the thread which writes to the stream.
+ *
+ * @param writer The @c AiaDataStreamWriter_t to act on.
+ * @param timestamp The timestamp to record, in units chosen by the writer.
+ * @param tag An application-defined value to record.
+ * @return @c true if the entry was recorded, or @c false if the writer is
+ * closed or the stream has no metadata ring.
+ */
+bool AiaDataStreamWriter_Mark( AiaDataStreamWriter_t* writer,
+                               uint64_t timestamp, uint32_t tag );
+
 /**
  * This function reports the current position of the @c AiaDataStreamWriter_t in
  * the stream. This function is thread-safe.
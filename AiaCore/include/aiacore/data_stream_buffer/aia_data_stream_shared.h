@@ -0,0 +1,193 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_data_stream_shared.h
+ * @brief Streams whose data is written by another process through a named
+ * shared memory segment. Only available on Linux.
+ */
+
+#ifndef AIA_DATA_STREAM_SHARED_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+#define AIA_DATA_STREAM_SHARED_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include "aia_data_stream_buffer.h"
+#include "aia_data_stream_buffer_writer.h"
+
+#include <stddef.h>
+
+/**
+ * The producing end of a shared stream, e.g. in an audio HAL process. It
+ * creates a named POSIX shared memory segment holding the stream's words and
+ * cursors, and writes to it like an @c AiaDataStreamWriter_t with the @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE policy: it never waits for the
+ * consuming processes, which detect being overrun. Captured audio can be
+ * written in place with @c AiaDataStreamSharedWriter_Reserve().
+ *
+ * The cursors are lock-free atomics, which work across processes, and
+ * consumers waiting in @c AiaDataStreamShared_Wait() are woken with a futex in
+ * the segment, so neither side takes a lock of the other or needs a file
+ * descriptor passed to it. Methods of this object should be called from a
+ * single thread.
+ */
+typedef struct AiaDataStreamSharedWriter AiaDataStreamSharedWriter_t;
+
+/**
+ * Creates the shared memory segment @c name and a writer for it. A segment
+ * left behind by a writer which did not exit cleanly is replaced. The returned
+ * pointer should be destroyed using @c AiaDataStreamSharedWriter_Destroy().
+ *
+ * @param name The name of the segment, starting with @c '/', as for @c
+ * shm_open().
+ * @param wordSize The size (in bytes) of words in the stream.
+ * @param dataSize The number of words the stream holds.
+ * @return The newly created @c AiaDataStreamSharedWriter_t if successful, or
+ * @c NULL otherwise.
+ */
+AiaDataStreamSharedWriter_t* AiaDataStreamSharedWriter_Create(
+    const char* name, size_t wordSize, size_t dataSize );
+
+/**
+ * Closes the stream, so that consumers read @c
+ * AIA_DATA_STREAM_BUFFER_READER_ERROR_CLOSED once they have read everything
+ * written, removes the segment's name and unmaps it. Consumers keep their
+ * mapping until they close it.
+ *
+ * @param writer The @c AiaDataStreamSharedWriter_t to destroy.
+ */
+void AiaDataStreamSharedWriter_Destroy( AiaDataStreamSharedWriter_t* writer );
+
+/**
+ * Copies words into the stream and publishes them. Only the first @c
+ * dataSize words are written if @c nWords is larger.
+ *
+ * @param writer The @c AiaDataStreamSharedWriter_t to act on.
+ * @param buf A buffer to copy the words from.
+ * @param nWords The number of words to write.
+ * @return The number of words written, or @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID on bad arguments or while a
+ * reservation is outstanding.
+ */
+ssize_t AiaDataStreamSharedWriter_Write( AiaDataStreamSharedWriter_t* writer,
+                                         const void* buf, size_t nWords );
+
+/**
+ * Reserves the next words of the stream to be written in place, as @c
+ * AiaDataStreamWriter_Reserve() does, e.g. as the destination of an ALSA
+ * read. The words are published with @c AiaDataStreamSharedWriter_Publish().
+ *
+ * @param writer The @c AiaDataStreamSharedWriter_t to act on.
+ * @param[out] spans Receives the reserved words, as one or two spans.
+ * @param nWords The number of words to reserve, capped at @c dataSize.
+ * @return The number of words reserved, or @c
+ * AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID.
+ */
+ssize_t AiaDataStreamSharedWriter_Reserve(
+    AiaDataStreamSharedWriter_t* writer,
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ],
+    size_t nWords );
+
+/**
+ * Publishes the first @c nWords words of the outstanding reservation and
+ * releases the rest of it.
+ *
+ * @param writer The @c AiaDataStreamSharedWriter_t to act on.
+ * @param nWords The number of words to publish.
+ * @return @c nWords, or @c AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID if it
+ * exceeds the reservation.
+ */
+ssize_t AiaDataStreamSharedWriter_Publish( AiaDataStreamSharedWriter_t* writer,
+                                           size_t nWords );
+
+/**
+ * The consuming end of a shared stream, e.g. in the process hosting the @c
+ * AiaClient_t. It maps the segment of an @c AiaDataStreamSharedWriter_t and
+ * presents it as a local @c AiaDataStreamBuffer_t whose data is the segment
+ * itself, so readers such as the microphone manager or a keyword spotter read
+ * the words where the other process wrote them. Any number of processes may
+ * open the same segment.
+ *
+ * The local buffer learns of new words when @c AiaDataStreamShared_Sync() or
+ * @c AiaDataStreamShared_Wait() is called, typically in a loop on a thread of
+ * the application in place of the one which copied audio from a socket.
+ * Readers then see and are notified of the words as if a local writer had
+ * written them. A reader whose lag approaches @c dataSize can miss being
+ * overrun by the words the other process is writing at that moment, which is
+ * already a reader failing to keep up.
+ */
+typedef struct AiaDataStreamShared AiaDataStreamShared_t;
+
+/**
+ * Opens a segment created by @c AiaDataStreamSharedWriter_Create(). The
+ * returned pointer should be destroyed using @c AiaDataStreamShared_Close().
+ *
+ * @param name The name passed to @c AiaDataStreamSharedWriter_Create().
+ * @param maxReaders The maximum number of readers of the local buffer.
+ * @return The newly opened @c AiaDataStreamShared_t if successful, or @c NULL
+ * otherwise, including if the segment does not exist or is not initialized
+ * yet.
+ */
+AiaDataStreamShared_t* AiaDataStreamShared_Open( const char* name,
+                                                 size_t maxReaders );
+
+/**
+ * Destroys the local buffer and unmaps the segment. All readers of the buffer
+ * must have been destroyed.
+ *
+ * @param shared The @c AiaDataStreamShared_t to close.
+ */
+void AiaDataStreamShared_Close( AiaDataStreamShared_t* shared );
+
+/**
+ * Returns the local buffer, to create readers of. No writer may be created for
+ * it.
+ *
+ * @param shared The @c AiaDataStreamShared_t to act on.
+ * @return The buffer, which is valid until @c AiaDataStreamShared_Close().
+ */
+AiaDataStreamBuffer_t* AiaDataStreamShared_GetBuffer(
+    AiaDataStreamShared_t* shared );
+
+/**
+ * Publishes the words the other process has written since the last call to
+ * the local buffer, and closes the local buffer once the other process has
+ * closed the stream. This does not block.
+ *
+ * @param shared The @c AiaDataStreamShared_t to act on.
+ * @return The number of words published.
+ */
+size_t AiaDataStreamShared_Sync( AiaDataStreamShared_t* shared );
+
+/**
+ * Waits until the other process writes words which have not been published
+ * yet, or closes the stream, then calls @c AiaDataStreamShared_Sync().
+ *
+ * @param shared The @c AiaDataStreamShared_t to act on.
+ * @param timeoutMs The longest time to wait.
+ * @return The number of words published, which is zero on timeout.
+ */
+size_t AiaDataStreamShared_Wait( AiaDataStreamShared_t* shared,
+                                 AiaDurationMs_t timeoutMs );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ifndef AIA_DATA_STREAM_SHARED_H_ */
@@ -21,40 +21,141 @@
 #include <aia_config.h>
 
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+
+/**
+ * Rounds @c size up to a whole number of @c AIA_CACHE_LINE_SIZE lines.
+ */
+#define AIA_DATA_STREAM_BUFFER_CACHE_LINES( size )                  \
+    ( ( ( ( size ) + AIA_CACHE_LINE_SIZE - 1 ) / AIA_CACHE_LINE_SIZE ) * \
+      AIA_CACHE_LINE_SIZE )
+
+/** State owned by a single reader of an @c AiaDataStreamBuffer_t. */
+struct AiaDataStreamBufferReaderState
+{
+    /** Indicates whether the reader is enabled. */
+    AiaAtomicBool_t isEnabled;
+
+    /** The reader's cursor. */
+    AiaDataStreamAtomicIndex_t cursor;
+
+    /** The reader's closing index. */
+    AiaDataStreamAtomicIndex_t closeIndex;
+
+    /**
+     * The index @c AiaDataStreamReader_ReadWait() is waiting for the writer to
+     * reach, or @c AIA_DATA_STREAM_INDEX_MAX if the reader is not waiting. This
+     * is only changed with @c notifyMutex held.
+     */
+    AiaDataStreamAtomicIndex_t waitIndex;
+
+    /** Posted once the writer reaches @c waitIndex. */
+    AiaSemaphore_t* waitSemaphore;
+};
+
+/**
+ * Per-reader state padded out to whole cache lines so that readers advancing
+ * their cursors do not false-share with each other.
+ */
+typedef union AiaDataStreamBufferReaderSlot
+{
+    /** The reader's state. */
+    struct AiaDataStreamBufferReaderState state;
+
+    /** Padding to the next cache line boundary. */
+    uint8_t padding[ AIA_DATA_STREAM_BUFFER_CACHE_LINES(
+        sizeof( struct AiaDataStreamBufferReaderState ) ) ];
+} AiaDataStreamBufferReaderSlot_t;
+
+/** Value of @c wordSizeShift for word sizes which are not a power of two. */
+#define AIA_DATA_STREAM_BUFFER_NO_SHIFT UINT8_MAX
 
 /**
  * Underying struct that contains all data required to present the @c
  * AiaDataStreamBuffer_t abstraction.
+ *
+ * Fields are grouped by the thread that writes them: read-mostly configuration
+ * and mutexes first, then the writer's cursors, then state updated by readers,
+ * with a full @c AIA_CACHE_LINE_SIZE of padding between the groups. Any field
+ * in one group is therefore at least one line away from any field in another,
+ * regardless of the alignment of the allocation. The per-reader slots follow
+ * the struct in the same allocation, so a buffer occupies
+ * @c sizeof( struct AiaDataStreamBuffer ) plus @c maxReaders times @c
+ * AIA_CACHE_LINE_SIZE bytes (about 430 bytes for one reader on a 64-bit POSIX
+ * target with 64 byte lines), excluding the caller-provided data buffer.
  */
 struct AiaDataStreamBuffer
 {
+    /** @name Read-mostly fields. */
+    /** @{ */
+
     /** The buffer used to store the stream's data. */
     uint8_t* data;
 
-    /** Size in words of the buffer. */
+    /** Size in words of the buffer. This and @c data are only changed by @c
+     * AiaDataStreamBuffer_Resize(). */
     const size_t dataSize;
 
-    /** Pointer to an array of booleans indicating reader enabled status. */
-    AiaAtomicBool_t* readerEnabledArray;
-
-    /** Pointer to an array of reader cursors. */
-    AiaDataStreamAtomicIndex_t* readerCursorArray;
-
-    /** Pointer to an array of closing indices for each reader. */
-    AiaDataStreamAtomicIndex_t* readerCloseIndexArray;
+    /** Pointer to an array of @c maxReaders reader slots. */
+    AiaDataStreamBufferReaderSlot_t* readerSlots;
 
     /** Word size in bytes to use for all buffer operations. */
     const AiaDataStreamBufferWordSize_t wordSize;
 
+    /**
+     * @c log2( wordSize ) if @c wordSize is a power of two, so that word counts
+     * can be converted to bytes with a shift, or @c
+     * AIA_DATA_STREAM_BUFFER_NO_SHIFT otherwise.
+     */
+    const uint8_t wordSizeShift;
+
+    /**
+     * @c dataSize - 1 if @c dataSize is a power of two, so that indices can be
+     * wrapped with a mask, or zero otherwise.
+     */
+    const size_t dataSizeMask;
+
     /** Maximum number of readers to support. */
     const AiaDataStreamBufferReaderId_t maxReaders;
 
     /**
-     * Mutex used to temporarily hold off readers from seeking backwards while
-     * @c oldestUnconsumedCursor is being updated. This is necessary to prevent
-     * a race condition where a reader seeks at the same time that @c
-     * oldestUnconsumedCursor is being updated which could result in reading
-     * from an older index than @c oldestUnconsumedCursor.
+     * Cache maintenance for buffers in external memory, as described by @c
+     * AiaDataStreamBufferOptions_t. These are @c NULL for other buffers.
+     */
+    const AiaDataStreamBufferCacheMaintenance_t cleanRange;
+
+    /** See @c cleanRange. */
+    const AiaDataStreamBufferCacheMaintenance_t invalidateRange;
+
+    /** Context associated with @c cleanRange and @c invalidateRange. */
+    void* const cacheMaintenanceUserData;
+
+    /** The metadata ring, or @c NULL if the buffer has none. */
+    AiaDataStreamMetadataEntry_t* const metadata;
+
+    /** The number of entries @c metadata holds. */
+    const size_t metadataCapacity;
+
+    /**
+     * Indicates that this buffer was created by @c
+     * AiaDataStreamBuffer_CreateSingleReader(), in which case @c
+     * oldestUnconsumedCursor simply tracks the only reader's cursor.
+     */
+    const bool isSingleReader;
+
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+    /**
+     * The size in bytes of each of the two mappings of @c data for a buffer
+     * created by @c AiaDataStreamBuffer_CreateMirrored(), or zero for other
+     * buffers.
+     */
+    const size_t mirroredSize;
+#endif
+
+    /**
+     * Mutex used to serialize readers seeking backwards with each other and
+     * with writers which do not overwrite readers. Reads and forward seeks do
+     * not take it; see @c backwardSeekSequence.
      */
     AiaMutex_t backwardSeekMutex;
 
@@ -67,6 +168,26 @@ struct AiaDataStreamBuffer
      */
     AiaMutex_t writerEnableMutex;
 
+    /**
+     * Mutex used to protect creation of readers to prevent races between
+     * overlapping calls to @c AiaDataStreamBuffer_CreateReader().
+     */
+    AiaMutex_t readerEnableMutex;
+
+    /**
+     * Mutex used to serialize arming, cancelling and delivering the data
+     * available notification requested by a reader.
+     */
+    AiaMutex_t notifyMutex;
+
+    /** @} */
+
+    /** Keeps the writer's cursors off the lines above. */
+    uint8_t writerPadding[ AIA_CACHE_LINE_SIZE ];
+
+    /** @name Fields written by the writer. */
+    /** @{ */
+
     /** The next location to write to. */
     AiaDataStreamAtomicIndex_t writeStartCursor;
 
@@ -76,6 +197,21 @@ struct AiaDataStreamBuffer
      */
     AiaDataStreamAtomicIndex_t writeEndCursor;
 
+    /**
+     * The number of metadata entries ever recorded. The entry with sequence
+     * number @c n lives at @c metadata[ n % metadataCapacity ], and is only
+     * valid while @c metadataCount is less than @c n + @c metadataCapacity.
+     */
+    AiaDataStreamAtomicIndex_t metadataCount;
+
+    /** @} */
+
+    /** Keeps the readers' fields off the writer's line. */
+    uint8_t readerPadding[ AIA_CACHE_LINE_SIZE ];
+
+    /** @name Fields written by readers. */
+    /** @{ */
+
     /**
      * Cntains the location of oldest word in the buffer which has not been
      * consumed by a read operation. This field is used as a barrier by writers
@@ -84,15 +220,63 @@ struct AiaDataStreamBuffer
     AiaDataStreamAtomicIndex_t oldestUnconsumedCursor;
 
     /**
-     * Mutex used to protect creation of readers to prevent races between
-     * overlapping calls to @c AiaDataStreamBuffer_CreateReader().
+     * Incremented with @c backwardSeekMutex held before and after each
+     * backward seek, so that it is odd while one is in progress. Forward
+     * updates of @c oldestUnconsumedCursor scan the readers without the mutex
+     * and only publish their result if this did not change during the scan.
+     * This should only be accessed using atomic operations.
      */
-    AiaMutex_t readerEnableMutex;
+    uint32_t backwardSeekSequence;
+
+    /**
+     * The number of readers waiting in @c AiaDataStreamReader_ReadWait(), so
+     * that writers only scan @c readerSlots for them when there are any. This
+     * is only changed with @c notifyMutex held, and should only be accessed
+     * using atomic operations.
+     */
+    uint32_t numWaitingReaders;
+
+    /**
+     * The write index which will trigger @c notifyCallback, or @c
+     * AIA_DATA_STREAM_INDEX_MAX when no notification is armed. This is atomic
+     * so that writers can skip taking @c notifyMutex when nothing is armed.
+     */
+    AiaDataStreamAtomicIndex_t notifyIndex;
+
+    /**
+     * The cursor of the reader pinned by @c AiaDataStreamReader_Pin(), or @c
+     * AIA_DATA_STREAM_INDEX_MAX when no reader is pinned. Writers of every
+     * policy, including @c AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, leave
+     * the words from here on intact. This is only changed by the pinned reader,
+     * or with @c backwardSeekMutex held when pinning, and should only be
+     * accessed using atomic operations.
+     */
+    AiaDataStreamAtomicIndex_t pinnedCursor;
+
+    /** @} */
+
+    /** @name Variables written by readers and synchronized by notifyMutex. */
+    /** @{ */
+
+    /** The id of the reader which armed the notification. */
+    AiaDataStreamBufferReaderId_t notifyReaderId;
+
+    /** Callback to invoke once @c notifyIndex has been written. */
+    AiaDataStreamReaderNotifyCallback_t notifyCallback;
+
+    /** Context associated with @c notifyCallback. */
+    void* notifyUserData;
+
+    /** @} */
 };
 
 /**
- * This function acquires @c m_backwardSeekMutex and calls
- * @_AiaDataStreamBuffer_updateOldestUnconsumedCursorLocked().
+ * This function advances @c oldestUnconsumedCursor after a read or forward
+ * seek. It scans @c readerSlots without taking @c backwardSeekMutex, and only
+ * falls back to @c _AiaDataStreamBuffer_UpdateOldestUnconsumedCursorLocked()
+ * if a backward seek overlapped the scan. For a buffer created with @c
+ * AiaDataStreamBuffer_CreateSingleReader() whose reader is enabled, @c
+ * oldestUnconsumedCursor is advanced to the reader's cursor without a scan.
  *
  * @param dataStream The @c AiaDataStreamBuffer to act on.
  */
@@ -100,10 +284,10 @@ void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor(
     struct AiaDataStreamBuffer* dataStream );
 
 /**
- * This function scans through @c readerCursorArray to determine the oldest
+ * This function scans through @c readerSlots to determine the oldest
  * reader and records it as @c oldestUnconsumedCursor. This function should be
- * called whenever a read cursor is moved. This function must be called while @c
- * backwardSeekMutex is held to prevent races between updating the oldest
+ * called whenever a read cursor is moved. This function must be called while
+ * @c backwardSeekMutex is held to prevent races between updating the oldest
  * cursor an an active reader seeking backwards.
  *
  * @param dataStream The @c AiaDataStreamBuffer to act on.
@@ -111,6 +295,25 @@ void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor(
 void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursorLocked(
     struct AiaDataStreamBuffer* dataStream );
 
+/**
+ * Marks the start of a backward seek by making @c backwardSeekSequence odd.
+ * This must be called while @c backwardSeekMutex is held, and paired with @c
+ * _AiaDataStreamBuffer_EndBackwardSeekLocked().
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ */
+void _AiaDataStreamBuffer_BeginBackwardSeekLocked(
+    struct AiaDataStreamBuffer* dataStream );
+
+/**
+ * Marks the end of a backward seek by making @c backwardSeekSequence even
+ * again.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ */
+void _AiaDataStreamBuffer_EndBackwardSeekLocked(
+    struct AiaDataStreamBuffer* dataStream );
+
 /**
  * This function enables the specified reader with the given @c id. @c
  * readerEnableMutex must be held when calling this function.
@@ -131,9 +334,33 @@ void _AiaDataStreamBuffer_EnableReaderLocked(
 void _AiaDataStreamBuffer_DisableReaderLocked(
     struct AiaDataStreamBuffer* dataStream, AiaDataStreamBufferReaderId_t id );
 
+/**
+ * This function invokes the armed data available notification, if any, once
+ * the writer has advanced past its @c notifyIndex, and wakes readers waiting
+ * for the writer to get that far. This function should be called by writers
+ * whenever @c writeStartCursor is advanced.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ */
+void _AiaDataStreamBuffer_NotifyReader(
+    struct AiaDataStreamBuffer* dataStream );
+
+/**
+ * This function wakes readers waiting in @c AiaDataStreamReader_ReadWait().
+ * This is called by @c _AiaDataStreamBuffer_NotifyReader() while @c
+ * numWaitingReaders is non-zero, and by writers when they close.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ * @param wakeAll Whether to wake all waiting readers, rather than only those
+ * whose @c waitIndex the writer has reached.
+ */
+void _AiaDataStreamBuffer_WakeWaitingReaders(
+    struct AiaDataStreamBuffer* dataStream, bool wakeAll );
+
 /**
  * This function returns a count of the number of words after @c after before
- * the circular data will wrap.
+ * the circular data will wrap. Data in a mirrored buffer never wraps within
+ * the size of the buffer, so the size of the buffer is returned for those.
  *
  * @param dataStream The @c AiaDataStreamBuffer to act on.
  * @c param after The @c AiaDataStreamIndex_t to count from.
@@ -143,6 +370,27 @@ void _AiaDataStreamBuffer_DisableReaderLocked(
 AiaDataStreamIndex_t _AiaDataStreamBuffer_WordsUntilWrap(
     const struct AiaDataStreamBuffer* dataStream, AiaDataStreamIndex_t after );
 
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+/**
+ * This function maps memory backed by an anonymous file twice, back to back,
+ * so that writes to either mapping appear in both.
+ *
+ * @param[in,out] size The minimum size of each mapping in bytes, rounded up to
+ * a whole number of pages and of @c wordSize words on return.
+ * @param wordSize The size (in bytes) of words in the stream.
+ * @return The start of the first mapping, or @c NULL on failure.
+ */
+uint8_t* _AiaDataStreamBuffer_MapMirrored( size_t* size, size_t wordSize );
+
+/**
+ * This function unmaps memory mapped by @c _AiaDataStreamBuffer_MapMirrored().
+ *
+ * @param data The start of the first mapping.
+ * @param size The size of each mapping in bytes.
+ */
+void _AiaDataStreamBuffer_UnmapMirrored( uint8_t* data, size_t size );
+#endif
+
 /**
  * This function provides access to the underlying raw buffer.
  *
@@ -157,4 +405,30 @@ AiaDataStreamIndex_t _AiaDataStreamBuffer_WordsUntilWrap(
 uint8_t* _AiaDataStreamBuffer_GetData( struct AiaDataStreamBuffer* dataStream,
                                        AiaDataStreamIndex_t at );
 
+/**
+ * This function converts a count of words to a count of bytes, using a shift
+ * for the common power-of-two word sizes.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ * @param nWords The number of words.
+ * @return The number of bytes in @c nWords words.
+ */
+size_t _AiaDataStreamBuffer_WordsToBytes(
+    const struct AiaDataStreamBuffer* dataStream, size_t nWords );
+
+/**
+ * This function applies a cache maintenance callback to words in the buffer,
+ * in two calls if the words wrap around the end of the buffer.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer to act on.
+ * @param maintain The callback to apply, or @c NULL to do nothing.
+ * @param at The index of the first word.
+ * @param nWords The number of words, which must not exceed the size of the
+ * buffer.
+ */
+void _AiaDataStreamBuffer_MaintainCache(
+    struct AiaDataStreamBuffer* dataStream,
+    AiaDataStreamBufferCacheMaintenance_t maintain, AiaDataStreamIndex_t at,
+    size_t nWords );
+
 #endif /* ifndef PRIVATE_AIA_DATA_STREAM_BUFFER_H_ */
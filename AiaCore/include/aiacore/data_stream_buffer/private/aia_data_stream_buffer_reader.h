@@ -47,6 +47,19 @@ struct AiaDataStreamReader
      * Pointer to the close index of this reader stored within @c dataStream.
      */
     AiaDataStreamAtomicIndex_t* readerCloseIndex;
+
+    /**
+     * Posted by the writer to wake @c AiaDataStreamReader_ReadWait(). This is
+     * created by the first call to it.
+     */
+    AiaSemaphore_t waitSemaphore;
+
+    /** Whether @c waitSemaphore has been created. */
+    bool isWaitSemaphoreCreated;
+
+    /** Whether this reader's cursor is published as @c
+     * dataStream->pinnedCursor. */
+    bool isPinned;
 };
 
 /**
@@ -41,6 +41,13 @@ struct AiaDataStreamWriter
      * @c writerEnableMutex.
      */
     bool closed;
+
+    /**
+     * The number of words reserved by @c AiaDataStreamWriter_Reserve() which
+     * have not yet been published, or zero if there is no outstanding
+     * reservation.
+     */
+    size_t reservedWords;
 };
 
 /**
@@ -52,6 +52,26 @@ struct AiaJsonMessage
      * JSON object.
      */
     const char* payload;
+
+    /** The length of @c name. */
+    size_t nameLength;
+
+    /** The length of @c messageId. */
+    size_t messageIdLength;
+
+    /** The length of @c payload, or zero if there is none. */
+    size_t payloadLength;
+
+    /** Whether @c name, @c messageId and @c payload share a separate allocation
+     * starting at @c name, rather than being stored inline after this struct
+     * by @c AiaJsonMessage_Create(). */
+    bool ownsStrings;
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    /** The message as built by @c AiaJsonMessage_Serialize(), or @c NULL if it
+     * has not been serialized. */
+    char* serialized;
+#endif
 };
 
 /**
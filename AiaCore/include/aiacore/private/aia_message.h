@@ -26,6 +26,10 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_message.h>
+
+#include AiaListDouble( HEADER )
+
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -37,8 +41,23 @@
  */
 struct AiaMessage
 {
+    /**
+     * Intrusive link used by the @c AiaRegulatorBuffer_t to queue this message
+     * without allocating a separate node.  This must remain the first member so
+     * that a link can be cast back to its message.
+     */
+    AiaListDouble( Link_t ) link;
+
     /** Size (in bytes) this message will occupy when assembled. */
     size_t size;
+
+    /** Set with @c AiaMessage_SetSupersedeKey(). */
+    AiaMessageSupersedeKey_t supersedeKey;
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    /** When this message was queued by the @c AiaRegulatorBuffer_t. */
+    AiaTimepointMs_t writeTimeMs;
+#endif
 };
 
 /**
@@ -48,11 +48,14 @@ typedef struct AiaDispatcher AiaDispatcher_t;
  * @param capabilitiesSender @c AiaCapabilitiesSender_t used by this dispatcher.
  * @param regulator @c AiaRegulator_t used by this dispatcher.
  * @param secretManager @c AiaSecretManager_t used by this dispatcher.
+ * @param exceptionLimiter Used to report malformed messages. This must outlive
+ * the dispatcher.
  * @return the new @c AiaDispatcher_t if successful, else @c NULL.
  */
 AiaDispatcher_t* AiaDispatcher_Create(
     AiaTaskPool_t aiaTaskPool, AiaCapabilitiesSender_t* capabilitiesSender,
-    AiaRegulator_t* regulator, AiaSecretManager_t* secretManager );
+    AiaRegulator_t* regulator, AiaSecretManager_t* secretManager,
+    AiaExceptionLimiter_t* exceptionLimiter );
 
 /**
  * Releases a @c AiaDispatcher_t previously allocated by @c
@@ -83,6 +86,150 @@ void AiaDispatcher_AddSpeakerManager( AiaDispatcher_t* dispatcher,
                                       AiaSpeakerManager_t* speakerManager );
 #endif
 
+/**
+ * Switches the @c AiaDispatcher_t between decrypting sequenced messages into a
+ * separately allocated buffer (the default) and decrypting them in place. In
+ * place, the plaintext is written over the common header and ciphertext of the
+ * message buffer passed to @c messageReceivedCallback() (or the sequencer's
+ * copy of it, if it arrived out of order), and no allocation is made per
+ * message. Payloads passed to directive handlers, the capabilities sender and
+ * the speaker manager are then borrowed views into that buffer which are only
+ * valid for the duration of the call.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param decryptInPlace @c true to decrypt in place, or @c false to decrypt
+ * into a separate buffer.
+ * @note Only enable this if the payload buffers delivered to @c
+ * messageReceivedCallback() are writable and not otherwise used after the
+ * callback returns.
+ */
+void AiaDispatcher_SetDecryptInPlace( AiaDispatcher_t* dispatcher,
+                                      bool decryptInPlace );
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+/**
+ * Switches the @c AiaDispatcher_t between running the directives of each
+ * directive topic message one after another on the directive sequencer's
+ * thread (the default) and queueing them to a worker per component, i.e. per
+ * @c userData passed to @c AiaDispatcher_AddHandler(). Each worker runs the
+ * directives of its component in the order they were received, while different
+ * components run concurrently, so that e.g. alert storage does not hold up
+ * speaker directives. The batch handler is called once every directive of a
+ * message has been run. Directives of the secret manager are always run on the
+ * sequencer's thread, since later messages may need the rotated secret to be
+ * decrypted.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param parallel @c true to queue directives to workers, or @c false to run
+ * them on the sequencer's thread. Directives still queued are run before this
+ * returns.
+ * @return @c true if successful, else @c false.
+ * @note Add every directive handler before enabling this; directives of
+ * components added afterwards run on the sequencer's thread.
+ */
+bool AiaDispatcher_SetParallelDirectives( AiaDispatcher_t* dispatcher,
+                                          bool parallel );
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/**
+ * Switches the @c AiaDispatcher_t between decrypting directive and speaker
+ * topic messages only once they are sequenced (the default) and also
+ * decrypting messages which arrive ahead of sequence on a worker while the
+ * sequencer waits for the ones before them. The plaintext is kept in place of
+ * the buffered message, so that when a gap fills the run of messages after it
+ * only costs their handling. Messages which need a secret other than the one
+ * in use, e.g. after a pending @c RotateSecret, or which are sequenced before
+ * the worker reaches them are decrypted once sequenced as before, as is every
+ * message whose decryption fails, so failures are reported as before.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param speculative @c true to decrypt buffered messages ahead, or @c false
+ * to stop. Messages already decrypted ahead are still handled.
+ * @return @c true if successful, else @c false.
+ * @note This must not be called concurrently with itself or while the
+ * dispatcher is being destroyed.
+ */
+bool AiaDispatcher_SetSpeculativeDecryption( AiaDispatcher_t* dispatcher,
+                                             bool speculative );
+#endif
+
+/**
+ * Releases the reordering storage of the sequencers of the @c AiaDispatcher_t
+ * which are not holding any messages. See @c AiaSequencer_TrimMemory(). This
+ * may be called from any thread.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @return The number of bytes released.
+ */
+size_t AiaDispatcher_TrimMemory( AiaDispatcher_t* dispatcher );
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges messages held by the sequencers of the @c AiaDispatcher_t for
+ * reordering to a budget. See @c AiaSequencer_SetMemoryBudget().
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param memoryBudget The budget to charge, or @c NULL to stop charging.
+ * @return @c true if successful, else @c false.
+ * @note This must be called before any messages are received.
+ */
+bool AiaDispatcher_SetMemoryBudget( AiaDispatcher_t* dispatcher,
+                                    AiaMemoryBudget_t* memoryBudget );
+#endif
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+/**
+ * Takes a snapshot of how long the handler of each directive took to run, in
+ * milliseconds. This may be called from any thread.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param[out] handlingTimesMs The histogram of each directive, indexed by @c
+ * AiaDirective_t.
+ */
+void AiaDispatcher_GetDirectiveHandlingTimes(
+    AiaDispatcher_t* dispatcher,
+    AiaHistogram_t handlingTimesMs[ AIA_NUM_DIRECTIVES ] );
+#endif
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+/**
+ * Sets an observer passed the plaintext of every message the @c
+ * AiaDispatcher_t handles from the service, once it has been sequenced and
+ * decrypted and before it is handled, to record sessions with. While an
+ * observer is set, speaker topic messages are decrypted into a separate
+ * buffer rather than straight into the speaker buffer.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param observer The observer, or @c NULL to stop observing.
+ * @param userData Context passed to @c observer.
+ * @note Only call this while no messages are being received. The observer is
+ * called on the thread handling each topic, so it must be thread-safe.
+ */
+void AiaDispatcher_SetPlaintextObserver( AiaDispatcher_t* dispatcher,
+                                         AiaSessionTraceObserver_t observer,
+                                         void* userData );
+
+/**
+ * Handles the plaintext of a message as though it had just been received,
+ * sequenced and decrypted, to replay recorded sessions with. Messages must be
+ * passed in the order they were observed, since they are not sequenced.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param topic The topic of the message: @c
+ * AIA_TOPIC_CONNECTION_FROM_SERVICE, @c AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
+ * @c AIA_TOPIC_DIRECTIVE or @c AIA_TOPIC_SPEAKER.
+ * @param sequenceNumber The sequence number of the message.
+ * @param plaintext The plaintext of the message.
+ * @param size The size of @c plaintext.
+ * @return @c true if the message was passed to its handlers, else @c false.
+ */
+bool AiaDispatcher_DispatchPlaintext( AiaDispatcher_t* dispatcher,
+                                      AiaTopic_t topic,
+                                      AiaSequenceNumber_t sequenceNumber,
+                                      const void* plaintext, size_t size );
+#endif
+
 /**
  * Adds a directive handler to the @c AiaDispatcher_t instance.
  *
@@ -96,6 +243,50 @@ bool AiaDispatcher_AddHandler( AiaDispatcher_t* dispatcher,
                                AiaDirectiveHandler_t handler,
                                AiaDirective_t directive, void* userData );
 
+/**
+ * Adds a handler to the @c AiaDispatcher_t instance which is called once all of
+ * the directives in a directive topic message have been passed to their
+ * directive handlers. This lets directive handlers batch work across the
+ * directives of a single message. Only one such handler may be added; adding
+ * another replaces it.
+ *
+ * @param dispatcher The @c AiaDispatcher_t instance to act on.
+ * @param handler Pointer to the batch handler being added.
+ * @param userData User data associated with @c handler.
+ * @return @c true if the @c handler was succesfully added, else @c false.
+ */
+bool AiaDispatcher_AddBatchHandler( AiaDispatcher_t* dispatcher,
+                                    AiaDirectiveBatchHandler_t handler,
+                                    void* userData );
+
+/**
+ * Gets the handler for messages received on a single inbound topic. Handlers
+ * are meant to be subscribed to that topic alone with the @c AiaDispatcher_t as
+ * their context, e.g. through @c AiaConnectionManager_SetTopicHandler(), which
+ * avoids parsing the topic of every message in @c messageReceivedCallback().
+ *
+ * @param topic The topic to get the handler for.
+ * @return The handler for @c topic, or @c NULL if the dispatcher does not
+ * handle messages on @c topic.
+ */
+AiaMqttTopicHandler_t AiaDispatcher_GetTopicHandler( AiaTopic_t topic );
+
+/**
+ * Gets the handler for batches of messages received on a single inbound topic,
+ * to be used like the handler from @c AiaDispatcher_GetTopicHandler() by ports
+ * which receive several messages at once. A batch is handled in one pass: the
+ * topic is locked once, the messages are written to its sequencer in sequence
+ * number order, so that ones received out of order need not be buffered, and
+ * on the speaker topic the speaker buffer state is evaluated once at the end.
+ *
+ * @param topic The topic to get the handler for.
+ * @return The batch handler for @c topic, or @c NULL if messages on @c topic
+ * should be handed to the handler from @c AiaDispatcher_GetTopicHandler() one
+ * at a time.
+ */
+AiaMqttBatchTopicHandler_t AiaDispatcher_GetTopicBatchHandler(
+    AiaTopic_t topic );
+
 /**
  * Callback function for messages received from the subscription.
  *
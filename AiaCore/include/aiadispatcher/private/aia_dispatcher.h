@@ -29,6 +29,10 @@
 #include <aiaalertmanager/aia_alert_manager.h>
 #include <aiaclockmanager/aia_clock_manager.h>
 #include <aiaconnectionmanager/aia_connection_manager.h>
+#include <aiacore/aia_exception_limiter.h>
+#include <aiacore/aia_histogram.h>
+#include <aiacore/aia_scratch_arena.h>
+#include <aiacore/aia_session_trace.h>
 #include <aiaexceptionmanager/aia_exception_manager.h>
 #include <aiamicrophonemanager/aia_microphone_manager.h>
 #include <aiaregulator/aia_regulator.h>
@@ -57,6 +61,26 @@ typedef void ( *AiaDirectiveHandler_t )( void* component, const void* payload,
                                          AiaSequenceNumber_t sequenceNumber,
                                          size_t index );
 
+/**
+ * Generic function pointer for handlers notified once every directive of a
+ * directive topic message has been passed to its directive handler.
+ *
+ * @param component The manager instance this function will work on.
+ * @param sequenceNumber Sequence number of the message.
+ */
+typedef void ( *AiaDirectiveBatchHandler_t )(
+    void* component, AiaSequenceNumber_t sequenceNumber );
+
+/** A directive handler and the user data to pass along with it. */
+typedef struct AiaDispatcherDirectiveHandler
+{
+    /** The handler to call, or @c NULL if none has been added. */
+    AiaDirectiveHandler_t handler;
+
+    /** The user data to pass to @c handler. */
+    void* userData;
+} AiaDispatcherDirectiveHandler_t;
+
 /** Private data for the @c AiaDispatcher_t type. */
 struct AiaDispatcher
 {
@@ -74,86 +98,92 @@ struct AiaDispatcher
 
     /** @} */
 
-    /** Used to send ExceptionEncountered events */
+    /** Used to send rate limited ExceptionEncountered events. This is shared
+     * with the rest of the client and not owned. */
     /** @{ */
 
-    AiaRegulator_t* regulator;
+    AiaExceptionLimiter_t* exceptionLimiter;
 
     /** @} */
 
-    /** Mutex used to guard against asynchronous calls in threaded
-     * environments. */
-    AiaMutex_t mutex;
-
-    /** @name Variables synchronized by mutex. */
+    /** Mutexes used to guard each topic's sequencer against asynchronous calls
+     * in threaded environments. Sequencers synchronously run decryption and
+     * handlers, so each topic has its own mutex to keep slow handling on one
+     * topic (e.g. alert storage on the directive topic) from stalling the
+     * others (e.g. speaker audio). */
     /** @{ */
 
-    /** Sequencers used in topic subscription callbacks */
-    AiaSequencer_t* capabilitiesAcknowledgeSequencer;
-    AiaSequencer_t* directiveSequencer;
+    AiaMutex_t capabilitiesAcknowledgeMutex;
+    AiaMutex_t directiveMutex;
 #ifdef AIA_ENABLE_SPEAKER
-    AiaSequencer_t* speakerSequencer;
+    AiaMutex_t speakerMutex;
 #endif
 
     /** @} */
 
-    /* Pointers to handlers for different directives */
+    /** @name Sequencers used in topic subscription callbacks, each synchronized
+     * by the mutex of the same topic. */
     /** @{ */
 
+    AiaSequencer_t* capabilitiesAcknowledgeSequencer;
+    AiaSequencer_t* directiveSequencer;
 #ifdef AIA_ENABLE_SPEAKER
-    AiaDirectiveHandler_t openSpeakerHandler;
-    AiaDirectiveHandler_t closeSpeakerHandler;
-    AiaDirectiveHandler_t setVolumeHandler;
-#endif
-#ifdef AIA_ENABLE_MICROPHONE
-    AiaDirectiveHandler_t openMicrophoneHandler;
-    AiaDirectiveHandler_t closeMicrophoneHandler;
-#endif
-#ifdef AIA_ENABLE_ALERTS
-    AiaDirectiveHandler_t setAlertVolumeHandler;
-    AiaDirectiveHandler_t setAlertHandler;
-    AiaDirectiveHandler_t deleteAlertHandler;
+    AiaSequencer_t* speakerSequencer;
 #endif
 
-    AiaDirectiveHandler_t setAttentionStateHandler;
-    AiaDirectiveHandler_t rotateSecretHandler;
+    /** @} */
 
-#ifdef AIA_ENABLE_CLOCK
-    AiaDirectiveHandler_t setClockHandler;
-#endif
+    /** Whether sequenced messages are decrypted within their own buffers. */
+    AiaAtomicBool_t decryptInPlace;
 
-    AiaDirectiveHandler_t exceptionHandler;
+    /** Scratch memory for handling one directive topic message, reset once
+     * the message has been handled. Only used on the directive topic, whose
+     * messages are handled one at a time. */
+    AiaScratchArena_t* directiveArena;
 
-    /** @} */
+    /** Handlers registered for each directive, indexed by @c AiaDirective_t.
+     */
+    AiaDispatcherDirectiveHandler_t directiveHandlers[ AIA_NUM_DIRECTIVES ];
 
-    /* User data for directive handlers */
-    /** @{ */
+    /** Handler called at the end of each directive topic message, or @c NULL
+     * if none has been added. */
+    AiaDirectiveBatchHandler_t directiveBatchHandler;
 
-#ifdef AIA_ENABLE_SPEAKER
-    AiaSpeakerManager_t* openSpeakerData;
-    AiaSpeakerManager_t* closeSpeakerData;
-    AiaSpeakerManager_t* setVolumeData;
-#endif
-#ifdef AIA_ENABLE_MICROPHONE
-    AiaMicrophoneManager_t* openMicrophoneData;
-    AiaMicrophoneManager_t* closeMicrophoneData;
-#endif
-#ifdef AIA_ENABLE_ALERTS
-    AiaAlertManager_t* setAlertVolumeData;
-    AiaAlertManager_t* setAlertData;
-    AiaAlertManager_t* deleteAlertData;
+    /** The user data to pass to @c directiveBatchHandler. */
+    void* directiveBatchHandlerUserData;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long each directive handler took to run, in milliseconds, indexed
+     * by @c AiaDirective_t. */
+    AiaHistogram_t directiveHandlingTimesMs[ AIA_NUM_DIRECTIVES ];
 #endif
 
-    AiaUXManager_t* setAttentionStateData;
-    AiaSecretManager_t* rotateSecretData;
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    /** Workers which each run the directives of one component in the order
+     * they were received, concurrently with the other workers, or @c NULL
+     * while directives are run on the directive sequencer's thread. Guarded by
+     * @c directiveMutex. */
+    struct AiaDispatcherDirectiveWorker* directiveWorkers;
 
-#ifdef AIA_ENABLE_CLOCK
-    AiaClockManager_t* setClockData;
+    /** The number of entries in @c directiveWorkers. */
+    size_t numDirectiveWorkers;
 #endif
 
-    AiaExceptionManager_t* exceptionData;
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    /** Worker which decrypts messages buffered ahead of sequence by the
+     * directive and speaker sequencers, or @c NULL while messages are only
+     * decrypted once sequenced. */
+    struct AiaDispatcherSpeculation* speculation;
+#endif
 
-    /** @} */
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    /** Observer passed the plaintext of every message from the service, or @c
+     * NULL if none is set. */
+    AiaSessionTraceObserver_t plaintextObserver;
+
+    /** The user data to pass to @c plaintextObserver. */
+    void* plaintextUserData;
+#endif
 };
 
 #endif /* ifndef AIA_PRIVATE_DISPATCHER_H_ */
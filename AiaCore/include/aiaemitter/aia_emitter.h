@@ -25,6 +25,7 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_histogram.h>
 #include <aiacore/aia_message.h>
 #include <aiacore/aia_message_constants.h>
 #include <aiacore/aia_topic.h>
@@ -77,6 +78,80 @@ bool AiaEmitter_EmitMessageChunk( AiaEmitter_t* emitter,
  */
 void AiaEmitter_Destroy( AiaEmitter_t* emitter );
 
+/**
+ * Enables reuse of a single preallocated payload buffer for every MQTT message
+ * assembled by @c emitter, instead of allocating and freeing a buffer for each
+ * message published.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param maxMessageSize The maximum message size of the @c AiaRegulator_t
+ * feeding this emitter, used to size the buffer.  The buffer will still grow
+ * if a larger MQTT message is assembled.
+ * @return @c true if the buffer was allocated successfully, else @c false.
+ * @note This must not be called while a message is being assembled.  This has
+ *     no effect once @c AiaEmitter_EnableAsyncPublish() has been called, as
+ *     the in-flight window always reuses its buffers.
+ */
+bool AiaEmitter_EnablePayloadBufferReuse( AiaEmitter_t* emitter,
+                                          size_t maxMessageSize );
+
+/**
+ * Enables asynchronous publishing.  Once enabled, each MQTT message assembled
+ * by @c emitter is submitted for encryption with @c
+ * AiaSecretManager_SubmitEncrypt() and then handed off to a worker job which
+ * publishes it, so that @c AiaEmitter_EmitMessageChunk() waits on neither the
+ * crypto port nor the MQTT connection.  At most @c maxInFlight messages may
+ * be handed off and not yet published; starting a new message waits for one
+ * of them to complete.  Each
+ * of the @c maxInFlight entries retains the buffer its last message was
+ * assembled in for reuse, including any buffer allocated by @c
+ * AiaEmitter_EnablePayloadBufferReuse().
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param maxInFlight The maximum number of messages handed off and not yet
+ * published.
+ * @return @c true if asynchronous publishing was enabled, else @c false.
+ * @note This must not be called while a message is being assembled, and may
+ *     only be called once.  Sequence numbers are assigned when messages are
+ *     handed off, so a message which then fails to publish leaves a gap.
+ */
+bool AiaEmitter_EnableAsyncPublish( AiaEmitter_t* emitter,
+                                    size_t maxInFlight );
+
+/**
+ * Releases the buffers retained for assembling MQTT messages, i.e. the buffer
+ * of @c AiaEmitter_EnablePayloadBufferReuse() or those of the entries of the
+ * in-flight window which are not in use. They are allocated again when the next
+ * message is assembled.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @return The number of bytes released.
+ * @note This must not be called concurrently with @c
+ *     AiaEmitter_EmitMessageChunk(), e.g. call it through @c
+ *     AiaRegulator_TrimMemory() of the regulator feeding @c emitter.
+ */
+size_t AiaEmitter_TrimMemory( AiaEmitter_t* emitter );
+
+/**
+ * Waits until every message handed off by @c emitter has been published (or
+ * failed to).  Returns immediately if asynchronous publishing is not enabled.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @return @c true if all messages have completed, else @c false.
+ * @note This must not be called while a message is being assembled.
+ */
+bool AiaEmitter_FlushPublishes( AiaEmitter_t* emitter );
+
+/**
+ * Sets the quality of service used to publish subsequent MQTT messages.
+ * Messages are published with @c AIA_MQTT_QOS0 by default.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param qos @c AIA_MQTT_QOS0 or @c AIA_MQTT_QOS1.
+ * @return @c true if @c qos was applied, else @c false.
+ */
+bool AiaEmitter_SetQos( AiaEmitter_t* emitter, AiaMqttQos_t qos );
+
 /**
  * Returns the sequence number which will be used for the next MQTT message
  * published on this emitter's topic.
@@ -91,4 +166,67 @@ void AiaEmitter_Destroy( AiaEmitter_t* emitter );
 bool AiaEmitter_GetNextSequenceNumber(
     AiaEmitter_t* emitter, AiaSequenceNumber_t* nextSequenceNumber );
 
+/**
+ * Reserves the next sequence number on this emitter's topic. The emitter
+ * reserves the sequence number of each MQTT message as the message is
+ * published, so messages can be in flight concurrently without sharing a
+ * number.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param[out] sequenceNumber If successful, this will be set to the reserved
+ * sequence number.
+ * @return @c true if a sequence number was reserved or @c false otherwise.
+ * @note This method is safe to call without external synchronization.
+ */
+bool AiaEmitter_ReserveSequenceNumber( AiaEmitter_t* emitter,
+                                       AiaSequenceNumber_t* sequenceNumber );
+
+/**
+ * Releases a sequence number reserved by @c AiaEmitter_ReserveSequenceNumber()
+ * whose message was not published. The reservation is rolled back if no later
+ * sequence number has been reserved since. Otherwise the service will observe
+ * a gap in the sequence.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param sequenceNumber The reserved sequence number.
+ * @return @c true if the reservation was rolled back or @c false otherwise.
+ * @note This method is safe to call without external synchronization.
+ */
+bool AiaEmitter_ReleaseSequenceNumber( AiaEmitter_t* emitter,
+                                       AiaSequenceNumber_t sequenceNumber );
+
+/** Counters describing the activity of an @c AiaEmitter_t. */
+typedef struct AiaEmitterMetrics
+{
+    /** The number of MQTT messages published. */
+    uint32_t messagesPublished;
+
+    /** The total size (in bytes) of the MQTT messages published. */
+    uint32_t bytesPublished;
+
+    /** The number of chunks which failed to be assembled into an MQTT message
+     * or published. */
+    uint32_t failures;
+
+    /** The low 32 bits of @c AiaClock( GetTimeMs )() when the last MQTT message
+     * was published, or 0 if none was. */
+    uint32_t lastPublishTimeMs;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long each MQTT message took to encrypt and publish, in
+     * milliseconds, including any wait for the in-flight window's worker. */
+    AiaHistogram_t publishTimeMs;
+#endif
+} AiaEmitterMetrics_t;
+
+/**
+ * Takes a snapshot of the counters of @c emitter. Counters wrap on overflow.
+ *
+ * @param emitter The @c AiaEmitter_t instance to act on.
+ * @param[out] metrics The counters of @c emitter.
+ * @note This method is safe to call without external synchronization.
+ */
+void AiaEmitter_GetMetrics( AiaEmitter_t* emitter,
+                            AiaEmitterMetrics_t* metrics );
+
 #endif /* ifndef AIA_EMITTER_H_ */
@@ -27,9 +27,9 @@
 
 #include <aia_application_config.h>
 
+#include <aiacore/aia_exception_limiter.h>
 #include <aiacore/aia_message_constants.h>
 #include <aiaexceptionmanager/aia_exception_code.h>
-#include <aiaregulator/aia_regulator.h>
 
 typedef struct AiaExceptionManager AiaExceptionManager_t;
 
@@ -38,14 +38,15 @@ typedef struct AiaExceptionManager AiaExceptionManager_t;
  * AiaExceptionManager_t created by this function should later be released by a
  * call to @c AiaExceptionManager_Destroy().
  *
- * @param eventRegulator Used to publish events.
+ * @param exceptionLimiter Used to publish rate limited events. This must
+ * outlive the exception manager.
  * @param onException An optional callback that is ran when an Exception
  * directive is received.
  * @param onExceptionUserData User data to pass to @c onException.
  * @return the new @c AiaExceptionManager_t if successful, else @c NULL.
  */
 AiaExceptionManager_t* AiaExceptionManager_Create(
-    AiaRegulator_t* eventRegulator,
+    AiaExceptionLimiter_t* exceptionLimiter,
     AiaExceptionManagerOnExceptionCallback_t onException,
     void* onExceptionUserData );
 
@@ -122,6 +122,12 @@ static inline const char* AiaMicrophoneInitiatorType_ToString(
 #define AIA_MICROPHONE_BUFFER_WORD_SIZE \
     ( ( size_t )( AIA_MICROPHONE_BITS_PER_SAMPLE / 8 ) )
 
+/**
+ * The most interleaved channels a microphone buffer may hold. Channels are
+ * mixed down to one before they are published.
+ */
+#define AIA_MICROPHONE_MAX_CHANNELS ( (size_t)8 )
+
 /** Amount of pre-roll to send for wake-word interactions. */
 #define AIA_MICROPHONE_WAKE_WORD_PREROLL ( (AiaDurationMs_t)500 )
 
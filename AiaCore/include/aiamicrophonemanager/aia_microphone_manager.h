@@ -29,7 +29,9 @@
 #include "aia_microphone_state.h"
 
 #include <aiacore/aia_binary_constants.h>
+#include <aiacore/aia_histogram.h>
 #include <aiacore/aia_message_constants.h>
+#include <aiacore/aia_pcm.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
 #include <aiaregulator/aia_regulator.h>
 
@@ -62,8 +64,14 @@ typedef void ( *AiaMicrophoneStateObserver_t )( AiaMicrophoneState_t state,
  * @param microphoneRegulator Used to publish microphone binary messages.
  * @param microphoneBufferReader Reader used to stream microphone data to the
  * Aia cloud on user interactions. Data contained in the underlying buffer
- * must be in 16-bit linear PCM, 16-kHz sample rate, single channel,
- * little-endian byte order format.
+ * must be in 16-bit linear PCM, 16-kHz sample rate, little-endian byte order
+ * format. The buffer holds one channel when its word size is @c
+ * AIA_MICROPHONE_BUFFER_WORD_SIZE, or frames of up to @c
+ * AIA_MICROPHONE_MAX_CHANNELS interleaved channels when its word size is a
+ * multiple of that. Multi-channel frames are mixed down to one channel before
+ * they are published, so that e.g. a wake word engine can read the raw
+ * channels from the same buffer. Stream offsets and sample indices count
+ * frames.
  * @param stateObserver An optional observer that can be used to observe
  * microphone state changes.
  * @Param stateObserverUserData Context to be passed to @c stateObserver.
@@ -123,7 +131,9 @@ bool AiaMicrophoneManager_TapToTalkStart(
 
 /* TODO: ADSER-1628 Add Metadata support */
 /**
- * Begins a wake word initiated Alexa interaction.
+ * Begins a wake word initiated Alexa interaction. Streaming starts @c
+ * AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES before @c beginIndex, and fails
+ * if that preroll is no longer in the microphone buffer.
  *
  * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
  * @param beginIndex The sample index corresponding with the start of the
@@ -145,4 +155,256 @@ bool AiaMicrophoneManager_WakeWordStart(
     AiaDataStreamIndex_t endIndex, AiaMicrophoneProfile_t profile,
     const char* wakeWord );
 
+/** Counters describing the activity of an @c AiaMicrophoneManager_t. */
+typedef struct AiaMicrophoneManagerMetrics
+{
+    /** The number of microphone chunks handed to the microphone regulator. */
+    uint32_t chunksSent;
+
+    /** The number of bytes of audio handed to the microphone regulator. */
+    uint32_t bytesSent;
+
+    /** The number of silent microphone chunks not published because of @c
+     * AiaMicrophoneVad_t::suppressSilence. */
+    uint32_t chunksSuppressed;
+
+    /** The number of times the microphone buffer overran the reader, leaving
+     * a gap in the published audio. */
+    uint32_t gaps;
+
+    /** The number of samples skipped over because of @c gaps. Stream offsets
+     * count these samples even though they are never published. */
+    uint32_t samplesSkipped;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long after the microphone was opened its first chunk was handed to
+     * the microphone regulator, in milliseconds. */
+    AiaHistogram_t openToFirstChunkMs;
+#endif
+} AiaMicrophoneManagerMetrics_t;
+
+/**
+ * Takes a snapshot of the counters of @c microphoneManager. Counters wrap on
+ * overflow.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param[out] metrics The counters of @c microphoneManager.
+ * @note This method does not lock @c microphoneManager and may be called from
+ * any thread.
+ */
+void AiaMicrophoneManager_GetMetrics( AiaMicrophoneManager_t* microphoneManager,
+                                      AiaMicrophoneManagerMetrics_t* metrics );
+
+/**
+ * Pre-processing applied in place to microphone samples after they are read
+ * from @c microphoneBufferReader and before they are published. Samples are
+ * processed as host-endian @c int16_t, which matches the little-endian stream
+ * format on all supported targets.
+ */
+typedef struct AiaMicrophoneProcessing
+{
+    /** Whether to remove any DC offset from the samples. */
+    bool removeDc;
+
+    /**
+     * A fixed gain to apply to the samples. @c AIA_PCM_GAIN_UNITY leaves them
+     * unchanged. Ignored when @c normalizationTargetPeak is non-zero.
+     */
+    AiaPcmGain_t gain;
+
+    /**
+     * If non-zero, the gain is adapted from chunk to chunk so that peaks
+     * approach this value. The gain drops immediately on loud chunks and rises
+     * gradually on quiet ones.
+     */
+    uint16_t normalizationTargetPeak;
+
+    /** The largest gain normalization may apply. */
+    AiaPcmGain_t maxNormalizationGain;
+} AiaMicrophoneProcessing_t;
+
+/**
+ * Configures the pre-processing applied to microphone samples. Takes effect
+ * from the next published chunk. Processing is disabled by default.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param processing The processing to apply, or @c NULL to disable processing.
+ * @return @c true if the configuration was applied or @c false otherwise.
+ */
+bool AiaMicrophoneManager_SetProcessing(
+    AiaMicrophoneManager_t* microphoneManager,
+    const AiaMicrophoneProcessing_t* processing );
+
+/**
+ * Sets how much of the most recent audio is kept when the writer overruns the
+ * microphone reader, e.g. because the device is too busy to publish chunks in
+ * time. By default, publishing skips straight to the writer. Keeping some audio
+ * lets a starved device fall behind by a bounded amount rather than drop all
+ * audio still in the buffer. Either way, stream offsets advance past the
+ * skipped audio and the gap is counted in @c AiaMicrophoneManagerMetrics_t.
+ * If the audio to keep has been overwritten by the time the reader seeks back
+ * to it, publishing skips to the writer.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param retentionMs How much of the most recent audio to keep.
+ * @return @c true if the retention was set or @c false otherwise.
+ */
+bool AiaMicrophoneManager_SetOverrunRetention(
+    AiaMicrophoneManager_t* microphoneManager, AiaDurationMs_t retentionMs );
+
+/**
+ * Reports the energy of the most recently published microphone chunk, after
+ * any processing. This may be used for barge-in decisions or to drive a level
+ * meter.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param[out] energy The energy of the last chunk, or zeros if none has been
+ * published.
+ * @note This method does not lock @c microphoneManager and may be called from
+ * any thread.
+ */
+void AiaMicrophoneManager_GetEnergy( AiaMicrophoneManager_t* microphoneManager,
+                                     AiaPcmEnergy_t* energy );
+
+/**
+ * Called when on-device voice activity detection hears the end of speech.
+ *
+ * @param userData Context associated with this callback.
+ * @note This is called with the @c AiaMicrophoneManager_t locked. Calling back
+ * into it from this callback will result in a deadlock.
+ */
+typedef void ( *AiaMicrophoneEndOfSpeechCallback_t )( void* userData );
+
+/**
+ * Configuration of on-device voice activity detection. Each chunk of samples is
+ * classified as speech or silence from its energy and zero crossing rate after
+ * any @c AiaMicrophoneProcessing_t. Once speech has been heard, silence lasting
+ * @c hangoverMs is taken as the end of speech, which is reported and may close
+ * the microphone ahead of the service's @c CloseMicrophone directive.
+ */
+typedef struct AiaMicrophoneVad
+{
+    /** Chunks with an RMS below this are silence. */
+    uint16_t speechRms;
+
+    /**
+     * Chunks with more zero crossings than this per thousand samples are
+     * silence, whatever their energy, since broadband noise crosses far more
+     * often than voiced speech. Zero disables this check.
+     */
+    uint16_t maxSpeechZeroCrossingsPerMille;
+
+    /** How long silence must last after speech to be the end of speech. */
+    AiaDurationMs_t hangoverMs;
+
+    /** Called once per interaction at the end of speech, or @c NULL. */
+    AiaMicrophoneEndOfSpeechCallback_t onEndOfSpeech;
+
+    /** Context associated with @c onEndOfSpeech. */
+    void* onEndOfSpeechUserData;
+
+    /**
+     * Whether to close the microphone at the end of speech. This only applies
+     * to @c AIA_MICROPHONE_PROFILE_NEAR_FIELD and @c
+     * AIA_MICROPHONE_PROFILE_FAR_FIELD interactions, which rely on the service
+     * to detect the end of speech. Hold to talk interactions are closed by the
+     * user.
+     */
+    bool closeOnEndOfSpeech;
+
+    /**
+     * Whether to drop chunks of silence outside the hangover instead of
+     * publishing them. This only applies to @c
+     * AIA_MICROPHONE_PROFILE_NEAR_FIELD tap to talk interactions. Stream
+     * offsets still count the dropped audio, so that they keep matching sample
+     * indices.
+     */
+    bool suppressSilence;
+} AiaMicrophoneVad_t;
+
+/**
+ * Sets the weight of each channel when mixing a multi-channel microphone buffer
+ * down to one channel. By default, channels are averaged. A single unity weight
+ * publishes one channel only, which suits front ends that write fixed beams to
+ * the buffer and choose the best one. Takes effect from the next chunk that is
+ * published.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param weights The weight of each channel.
+ * @param numWeights The number of weights in @c weights, which must match the
+ * number of channels in the microphone buffer.
+ * @return @c true if the weights were applied or @c false otherwise, including
+ * if the microphone buffer holds a single channel.
+ */
+bool AiaMicrophoneManager_SetChannelWeights(
+    AiaMicrophoneManager_t* microphoneManager, const AiaPcmGain_t* weights,
+    size_t numWeights );
+
+/**
+ * Configures on-device voice activity detection. Takes effect from the next
+ * time the microphone is opened. Detection is disabled by default.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param vad The configuration to use, or @c NULL to disable detection.
+ * @return @c true if the configuration was applied or @c false otherwise,
+ * including if the microphone is open.
+ */
+bool AiaMicrophoneManager_SetVad( AiaMicrophoneManager_t* microphoneManager,
+                                  const AiaMicrophoneVad_t* vad );
+
+/**
+ * Encodes @c frameCount contiguous frames of microphone samples, each of @c
+ * frameSamples samples, into @c frameCount contiguous frames of exactly @c
+ * frameBytes bytes each.
+ *
+ * @param samples The samples to encode.
+ * @param frameCount The number of frames in @c samples.
+ * @param[out] out Buffer to write the encoded frames to.
+ * @param userData Context associated with this callback.
+ * @return @c true if all frames were encoded or @c false otherwise.
+ */
+typedef bool ( *AiaMicrophoneEncodeFrames_t )( const int16_t* samples,
+                                               size_t frameCount, uint8_t* out,
+                                               void* userData );
+
+/**
+ * An encoder applied to microphone samples after any @c
+ * AiaMicrophoneProcessing_t and before they are published. Encoded frames must
+ * have a constant size so that stream offsets, which count published bytes,
+ * remain proportional to sample indices.
+ */
+typedef struct AiaMicrophoneEncoder
+{
+    /** Callback that encodes frames. */
+    AiaMicrophoneEncodeFrames_t encodeFrames;
+
+    /** Context associated with @c encodeFrames. */
+    void* userData;
+
+    /**
+     * The number of samples per frame. This may not exceed @c
+     * AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES.
+     */
+    size_t frameSamples;
+
+    /**
+     * The size in bytes of an encoded frame. This may not exceed the size of
+     * the samples it encodes.
+     */
+    size_t frameBytes;
+} AiaMicrophoneEncoder_t;
+
+/**
+ * Installs an encoder for microphone samples. Samples are published as 16-bit
+ * linear PCM by default. The encoder must produce the format advertised by @c
+ * AIA_MICROPHONE_AUDIO_ENCODER_FORMAT.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param encoder The encoder to use, or @c NULL to publish linear PCM.
+ * @return @c true if the encoder was installed or @c false otherwise,
+ * including if the microphone is open.
+ */
+bool AiaMicrophoneManager_SetEncoder( AiaMicrophoneManager_t* microphoneManager,
+                                      const AiaMicrophoneEncoder_t* encoder );
+
 #endif /* ifndef AIA_MICROPHONE_MANAGER_H_ */
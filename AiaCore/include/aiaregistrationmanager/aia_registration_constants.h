@@ -42,4 +42,11 @@
 #define AIA_REGISTRATION_IOT_ENDPOINT_KEY "endpoint"
 #define AIA_REGISTRATION_IOT_TOPIC_ROOT_KEY "topicRoot"
 
+/**
+ * The generated key lengths are always 32.
+ * @see
+ * https://developer.amazon.com/en-US/docs/alexa/alexa-voice-service/avs-for-aws-iot-registration.html#request
+ */
+#define AIA_REGISTRATION_MANAGER_GENERATED_KEY_LENGTH 32
+
 #endif /* ifndef AIA_REGISTRATION_CONSTANTS_H_ */
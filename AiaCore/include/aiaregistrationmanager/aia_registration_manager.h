@@ -28,6 +28,9 @@ extern "C" {
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_key_pair_cache.h>
+#include <aiacore/aia_lwa_credential_cache.h>
+#include <aiaregistrationmanager/aia_registration_constants.h>
 #include <aiaregistrationmanager/aia_registration_failure_code.h>
 
 /**
@@ -78,6 +81,55 @@ AiaRegistrationManager_t* AiaRegistrationManager_Create(
     AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
     void* onRegisterFailureUserData );
 
+/**
+ * Allocates and initializes a new @c AiaRegistrationManager_t like @c
+ * AiaRegistrationManager_Create(), but takes its key pair from a cache filled
+ * ahead of time instead of generating one, so that registering and
+ * re-registering do not wait for key generation.
+ *
+ * @param onRegisterSuccess A callback that is ran if registration is
+ * successful.
+ * @param onRegisterSuccessUserData User data to pass to @c onRegisterSuccess.
+ * @param onRegisterFailure A callback that is ran if registration fails.
+ * @param onRegisterFailureUserData User data to pass to @c onRegisterFailure
+ * @param keyPairCache The cache to take the key pair from, created for the
+ * secret derivation algorithm used for registration and keys of @c
+ * AIA_REGISTRATION_MANAGER_GENERATED_KEY_LENGTH bytes, or @c NULL to generate
+ * the key pair.
+ * @return the new @c AiaRegistrationManager_t if successful, else @c NULL.
+ */
+AiaRegistrationManager_t* AiaRegistrationManager_CreateWithKeyPairCache(
+    AiaRegistrationManagerOnRegisterSuccessCallback_t onRegisterSuccess,
+    void* onRegisterSuccessUserData,
+    AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
+    void* onRegisterFailureUserData, AiaKeyPairCache_t* keyPairCache );
+
+/**
+ * Allocates and initializes a new @c AiaRegistrationManager_t like @c
+ * AiaRegistrationManager_CreateWithKeyPairCache(), but also takes the LWA
+ * credentials from a cache kept fresh in the background instead of fetching
+ * them from the LWA port on every @c AiaRegistrationManager_Register().
+ *
+ * @param onRegisterSuccess A callback that is ran if registration is
+ * successful.
+ * @param onRegisterSuccessUserData User data to pass to @c onRegisterSuccess.
+ * @param onRegisterFailure A callback that is ran if registration fails.
+ * @param onRegisterFailureUserData User data to pass to @c onRegisterFailure
+ * @param keyPairCache The cache to take the key pair from, as for @c
+ * AiaRegistrationManager_CreateWithKeyPairCache(), or @c NULL to generate the
+ * key pair.
+ * @param lwaCredentialCache The cache to take the LWA credentials from, which
+ * must outlive the registration manager, or @c NULL to fetch them on every
+ * registration.
+ * @return the new @c AiaRegistrationManager_t if successful, else @c NULL.
+ */
+AiaRegistrationManager_t* AiaRegistrationManager_CreateWithCaches(
+    AiaRegistrationManagerOnRegisterSuccessCallback_t onRegisterSuccess,
+    void* onRegisterSuccessUserData,
+    AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
+    void* onRegisterFailureUserData, AiaKeyPairCache_t* keyPairCache,
+    AiaLwaCredentialCache_t* lwaCredentialCache );
+
 /**
  * Sends a registration request for AIA.
  * @note Callbacks in @c registrationManager will only be made if @c true is
@@ -92,6 +144,16 @@ AiaRegistrationManager_t* AiaRegistrationManager_Create(
 bool AiaRegistrationManager_Register(
     AiaRegistrationManager_t* registrationManager );
 
+/**
+ * Checks whether the results of a previous registration, the topic root and
+ * shared secret, are persisted. If so, the client can connect right away
+ * without registering again, and only needs to register again if the service
+ * rejects the connection.
+ *
+ * @return @c true if a previous registration is persisted, @c false otherwise.
+ */
+bool AiaRegistrationManager_IsRegistered();
+
 /**
  * Releases a @c AiaRegistrationManager_t previously allocated by @c
  * AiaRegistrationManager_Create().
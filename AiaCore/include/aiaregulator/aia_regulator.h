@@ -25,7 +25,11 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_histogram.h>
 #include <aiacore/aia_message.h>
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+#include <aiacore/aia_memory_budget.h>
+#endif
 
 /**
  * This class regulates the size of the message being emitted, as well as
@@ -86,6 +90,22 @@ typedef bool ( *AiaRegulatorEmitMessageChunkCallback_t )(
 typedef void ( *AiaRegulatorDestroyChunkCallback_t )(
     AiaRegulatorChunk_t* chunk, void* userData );
 
+/**
+ * This callback function is used to signal backpressure to producers when the
+ * data queued in a regulator crosses its watermarks.
+ *
+ * @note This callback is called with the regulator's lock held. It is expected
+ * to return quickly, and must not call back into the regulator.
+ *
+ * @param isAboveHighWatermark @c true when the queued data has reached the high
+ * watermark, and writes will fail until it drains, or @c false when it has
+ * drained to the low watermark again.
+ * @param userData Optional user data pointer which was provided alongside the
+ * callback.
+ */
+typedef void ( *AiaRegulatorWatermarkCallback_t )( bool isAboveHighWatermark,
+                                                   void* userData );
+
 /** Controls how to balance the tradeoff between latency and message size. */
 typedef enum
 {
@@ -99,6 +119,26 @@ typedef enum
     AIA_REGULATOR_BURST
 } AiaRegulatorEmitMode_t;
 
+/**
+ * Priority classes for chunks written to a regulator. Chunks of a higher
+ * priority are emitted ahead of any queued chunks of a lower priority, and are
+ * aggregated with them as usual. Chunks of the same priority are always
+ * emitted in the order in which they were written.
+ */
+typedef enum
+{
+    /**
+     * Chunks which may be deferred behind any chunks written later.  Only
+     * chunks whose order relative to other traffic does not matter, such as
+     * volume changes, belong here; events that describe the progress of a
+     * stream must stay in the same class as the rest of that stream.
+     */
+    AIA_REGULATOR_PRIORITY_LOW,
+
+    /** Chunks written with @c AiaRegulator_Write(). */
+    AIA_REGULATOR_PRIORITY_NORMAL
+} AiaRegulatorPriority_t;
+
 /**
  * Allocates and initializes a new @c AiaRegulator_t.  An @c
  * AiaRegulator_t created by this function should later be released by a
@@ -110,7 +150,8 @@ typedef enum
  * multiple times to emit all the chunks which have been aggregated.
  * @param emitMessageChunkUserData User data to pass to @c emitMessageChunk.
  * @param minWaitTimeMs Minimum amount of time the regulator will wait before
- *     emitting a message.
+ *     emitting a message.  With @c AiaRegulator_SetMaxBurst(), this is instead
+ *     the average time between messages over a burst.
  * @return The newly-constructed regulator when successful, else @c NULL.
  *
  * @note: the default @c AiaRegulatorEmitMode is @c TRICKLE.
@@ -147,6 +188,165 @@ void AiaRegulator_Destroy( AiaRegulator_t* regulator,
 bool AiaRegulator_Write( AiaRegulator_t* regulator,
                          AiaRegulatorChunk_t* chunk );
 
+/**
+ * Writes a message chunk to the regulator in the given priority class.  Note
+ * that ownership of @c chunk is transferred to @c regulator if this function
+ * call succeeds.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param chunk Message chunk to be written.
+ * @param priority The priority class of @c chunk.
+ * @return @c true if the message chunk was succesfully added, else @c false.
+ *
+ * @note Sequence numbers are assigned to chunks as they are emitted, so
+ * reordering chunks across priority classes does not reorder their sequence
+ * numbers.
+ */
+bool AiaRegulator_WriteWithPriority( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaRegulatorPriority_t priority );
+
+/**
+ * Writes a deferrable message chunk to the regulator.  The chunk is queued at
+ * @c AIA_REGULATOR_PRIORITY_LOW and held for up to @c maxDelayMs, so that it
+ * can go out together with the next chunk which does need to be sent now, or
+ * with any other deferred chunks once the earliest of their deadlines expires.
+ * This lets a device with a power-saving radio wake it fewer times.  Note that
+ * ownership of @c chunk is transferred to @c regulator if this function call
+ * succeeds.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param chunk Message chunk to be written.
+ * @param maxDelayMs The longest time @c chunk may be held before it is emitted,
+ * or @c 0 to emit it as @c AiaRegulator_WriteWithPriority() would.
+ * @return @c true if the message chunk was succesfully added, else @c false.
+ */
+bool AiaRegulator_WriteWithDeadline( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaDurationMs_t maxDelayMs );
+
+/**
+ * Starts emitting any chunks held by @c AiaRegulator_WriteWithDeadline() now,
+ * without waiting for their deadlines.  This may be called when some other
+ * traffic has woken the radio anyway.
+ *
+ * @param regulator The regulator instance to act on.
+ */
+void AiaRegulator_Flush( AiaRegulator_t* regulator );
+
+/**
+ * Writes a message chunk to the regulator, first waiting for the queued data
+ * to drain below the high watermark if necessary.  Note that ownership of @c
+ * chunk is transferred to @c regulator if this function call succeeds.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param chunk Message chunk to be written.
+ * @param timeoutMs The longest time to wait for the queue to drain.
+ * @return @c true if the message chunk was succesfully added, else @c false.
+ */
+bool AiaRegulator_WriteOrWait( AiaRegulator_t* regulator,
+                               AiaRegulatorChunk_t* chunk,
+                               AiaDurationMs_t timeoutMs );
+
+/**
+ * Bounds the data queued in the regulator. Once @c highWatermarkBytes are
+ * queued, writes fail and @c watermarkCallback is called with @c true. Once the
+ * queue drains to @c lowWatermarkBytes, @c watermarkCallback is called with @c
+ * false. Producers can use this to pause instead of having chunks dropped.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param highWatermarkBytes The aggregate size of queued chunks at which writes
+ * fail, or @c 0 to remove the bound and the callback.
+ * @param lowWatermarkBytes The aggregate size of queued chunks at which the
+ * bound is lifted again. This must be less than @c highWatermarkBytes.
+ * @param watermarkCallback Optional callback to signal crossings of the
+ * watermarks.
+ * @param watermarkCallbackUserData User data to pass to @c watermarkCallback.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulator_SetWatermarks(
+    AiaRegulator_t* regulator, size_t highWatermarkBytes,
+    size_t lowWatermarkBytes, AiaRegulatorWatermarkCallback_t watermarkCallback,
+    void* watermarkCallbackUserData );
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges queued data to a budget. Writes which do not fit in the budget fail
+ * as they do above the high watermark, so producers keep their data, but
+ * without a watermark callback since the budget may be freed up elsewhere.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param memoryBudget The budget to charge, or @c NULL to stop charging. Data
+ * already queued is moved to this budget even if it does not fit.
+ */
+void AiaRegulator_SetMemoryBudget( AiaRegulator_t* regulator,
+                                   AiaMemoryBudget_t* memoryBudget );
+#endif
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+/**
+ * Holds the chunks written to the regulator instead of emitting them, e.g.
+ * while the connection they are emitted on is down, so that they are not lost
+ * or retried in the meantime. Writes are still accepted, within the watermarks.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param isPaused @c true to hold chunks, or @c false to start emitting the
+ * held chunks.
+ */
+void AiaRegulator_SetPaused( AiaRegulator_t* regulator, bool isPaused );
+#endif
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+/**
+ * This callback function prepares a chunk for emitting, e.g. by serializing it,
+ * so that less work is left for the regulator's timer thread.
+ *
+ * @note This callback is called on the thread writing @c chunk, before it is
+ * queued and without the regulator's lock held. A chunk which could not be
+ * prepared is still queued, and emitted as usual.
+ *
+ * @param chunk The message chunk being written.
+ * @param userData Optional user data pointer which was provided alongside the
+ * callback.
+ */
+typedef void ( *AiaRegulatorStageChunkCallback_t )( AiaRegulatorChunk_t* chunk,
+                                                    void* userData );
+
+/**
+ * Sets a callback which prepares each chunk written to the regulator on the
+ * writing thread. This must be set before chunks are written.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param stageChunk The callback, or @c NULL for none.
+ * @param stageChunkUserData An optional user data pointer which will be passed
+ * to the @c stageChunk callback.
+ */
+void AiaRegulator_SetStageChunkCallback(
+    AiaRegulator_t* regulator, AiaRegulatorStageChunkCallback_t stageChunk,
+    void* stageChunkUserData );
+#endif
+
+/**
+ * Callback which releases memory held for emitting chunks.
+ *
+ * @param userData User data passed to @c AiaRegulator_TrimMemory().
+ * @return The number of bytes released.
+ */
+typedef size_t ( *AiaRegulatorTrimMemoryCallback_t )( void* userData );
+
+/**
+ * Calls @c trimMemoryCb while no chunk is being emitted, so that the consumer
+ * of @c emitMessageChunk can release buffers it only uses while emitting.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param trimMemoryCb The callback which releases the memory.
+ * @param userData User data to pass to @c trimMemoryCb.
+ * @return The number of bytes released.
+ */
+size_t AiaRegulator_TrimMemory( AiaRegulator_t* regulator,
+                                AiaRegulatorTrimMemoryCallback_t trimMemoryCb,
+                                void* userData );
+
 /**
  * Change the mode to use for emitting data.
  *
@@ -158,4 +358,135 @@ bool AiaRegulator_Write( AiaRegulator_t* regulator,
 void AiaRegulator_SetEmitMode( AiaRegulator_t* regulator,
                                AiaRegulatorEmitMode_t mode );
 
+/**
+ * Lets the regulator emit up to @c maxBurst messages back to back, instead of
+ * always waiting @c minWaitTimeMs between them. The regulator then behaves as
+ * a token bucket: each message takes a token, and one token is returned every
+ * @c minWaitTimeMs, up to @c maxBurst. The sustained rate is unchanged, so
+ * bursts of events after an idle period go out without delay while staying
+ * under the same throttling limit.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param maxBurst The number of messages which may be emitted back to back.
+ * The default of @c 1 always waits @c minWaitTimeMs between messages.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulator_SetMaxBurst( AiaRegulator_t* regulator, size_t maxBurst );
+
+/**
+ * Lets a chunk tagged with @c AiaMessage_SetSupersedeKey() replace a queued,
+ * not yet emitted chunk with the same key, instead of queueing behind it. This
+ * suits events which only report the latest value of some state, e.g. during
+ * bursts of buffer state or volume changes. The replaced chunk is dropped and
+ * the new one is queued as usual, so it keeps its order relative to other
+ * chunks written before it. Sequence numbers are assigned as chunks are
+ * emitted, so no gaps are left.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param destroyChunk Callback used to destroy replaced chunks, or @c NULL to
+ * queue every chunk again.
+ * @param destroyChunkUserData An optional user data pointer which will be
+ * passed to the @c destroyChunk callback.
+ */
+void AiaRegulator_SetSupersedeCallback(
+    AiaRegulator_t* regulator, AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData );
+
+/**
+ * Opts a single supersede key in or out of @c
+ * AiaRegulator_SetSupersedeCallback(), for when every transition of some state
+ * must be sent. All keys are opted in by default.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param key The key, from @c 1 to @c AIA_MESSAGE_MAX_SUPERSEDE_KEY.
+ * @param isEnabled Whether chunks with @c key replace queued ones.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulator_SetSupersedeKeyEnabled( AiaRegulator_t* regulator,
+                                          AiaMessageSupersedeKey_t key,
+                                          bool isEnabled );
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+/**
+ * Drops queued chunks which have waited longer than the maximum age set for
+ * their supersede key with @c AiaRegulator_SetMaxAge(), instead of emitting
+ * them.  Chunks are timestamped as they are written, so after a long
+ * disconnect or a stalled emitter, events describing state which is no longer
+ * current do not delay the ones behind them.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param destroyChunk Callback used to destroy expired chunks, or @c NULL for
+ * chunks to never expire.
+ * @param destroyChunkUserData An optional user data pointer which will be
+ * passed to the @c destroyChunk callback.
+ */
+void AiaRegulator_SetExpiryCallback(
+    AiaRegulator_t* regulator, AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData );
+
+/**
+ * Sets how long chunks tagged with a supersede key may wait to be emitted.
+ * Chunks without a key never expire.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param key The key, from @c 1 to @c AIA_MESSAGE_MAX_SUPERSEDE_KEY.
+ * @param maxAgeMs The maximum age, or @c 0 for chunks with @c key to never
+ * expire, which is the default.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulator_SetMaxAge( AiaRegulator_t* regulator,
+                             AiaMessageSupersedeKey_t key,
+                             AiaDurationMs_t maxAgeMs );
+#endif
+
+/**
+ * Returns the minimum amount of time the regulator waits between emitted
+ * messages. Producers can use this to size their chunks to the regulator's
+ * cadence.
+ *
+ * @param regulator The regulator instance to act on.
+ * @return The @c minWaitTimeMs the regulator was created with, or 0 on failure.
+ */
+AiaDurationMs_t AiaRegulator_GetMinWaitTimeMs(
+    const AiaRegulator_t* regulator );
+
+/**
+ * Returns how many more bytes of message chunks can be written before the data
+ * currently buffered fills a message of @c maxMessageSize. Producers can use
+ * this to size their next chunk so that it is aggregated into the pending
+ * message rather than deferred to the next one.
+ *
+ * @param regulator The regulator instance to act on.
+ * @return The remaining space (in bytes) in the pending message, or 0 if the
+ * buffered data can already fill a message or on failure.
+ */
+size_t AiaRegulator_GetRemainingMessageSpace( AiaRegulator_t* regulator );
+
+/** A snapshot of the queue of an @c AiaRegulator_t. */
+typedef struct AiaRegulatorMetrics
+{
+    /** The number of chunks waiting to be emitted. */
+    size_t queuedChunks;
+
+    /** The aggregate data (payload) size of the chunks waiting to be emitted.
+     */
+    size_t queuedBytes;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long the oldest queued data had waited each time a message was
+     * emitted, in milliseconds. Data left queued by an emit is counted from
+     * that emit. */
+    AiaHistogram_t queueingDelayMs;
+#endif
+} AiaRegulatorMetrics_t;
+
+/**
+ * Takes a snapshot of the queue of @c regulator.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param[out] metrics The state of the queue of @c regulator.
+ */
+void AiaRegulator_GetMetrics( AiaRegulator_t* regulator,
+                              AiaRegulatorMetrics_t* metrics );
+
 #endif /* ifndef AIA_REGULATOR_H_ */
@@ -68,7 +68,10 @@ void AiaRegulatorBuffer_Destroy(
     void* destroyChunkUserData );
 
 /**
- * Add message chunk to the end of the buffer.
+ * Add message chunk to the end of the buffer.  If superseding is enabled with
+ * @c AiaRegulatorBuffer_SetSupersede() and the chunk has a supersede key, a
+ * queued chunk with the same key is first removed and destroyed, so that only
+ * the latest value is sent.
  *
  * @param regulatorBuffer The regulator buffer instance to act on.
  * @param chunk Message chunk to be written.  When this function returns @c
@@ -83,6 +86,83 @@ void AiaRegulatorBuffer_Destroy(
 bool AiaRegulatorBuffer_PushBack( AiaRegulatorBuffer_t* regulatorBuffer,
                                   AiaRegulatorChunk_t* chunk );
 
+/**
+ * Add message chunk to the buffer after all chunks of the same or a higher
+ * priority, and ahead of any chunks of a lower priority. @c
+ * AiaRegulatorBuffer_PushBack() is equivalent to calling this with @c
+ * AIA_REGULATOR_PRIORITY_NORMAL.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param chunk Message chunk to be written, with the same ownership semantics
+ * as @c AiaRegulatorBuffer_PushBack().
+ * @param priority The priority class of @c chunk.
+ * @return @c true if the chunk was accepted, else @c false.
+ */
+bool AiaRegulatorBuffer_PushBackWithPriority(
+    AiaRegulatorBuffer_t* regulatorBuffer, AiaRegulatorChunk_t* chunk,
+    AiaRegulatorPriority_t priority );
+
+/**
+ * Lets chunks with a supersede key (see @c AiaMessage_SetSupersedeKey())
+ * replace queued chunks with the same key.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param destroyChunk Callback used to destroy the chunks which are replaced,
+ * or @c NULL to queue every chunk again.
+ * @param destroyChunkUserData An optional user data pointer which will be
+ * passed to the @c destroyChunk callback.
+ */
+void AiaRegulatorBuffer_SetSupersede(
+    AiaRegulatorBuffer_t* regulatorBuffer,
+    AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData );
+
+/**
+ * Opts a single supersede key in or out of superseding, e.g. when every
+ * transition of some state must be sent.  All keys are opted in by default.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param key The key, from @c 1 to @c AIA_MESSAGE_MAX_SUPERSEDE_KEY.
+ * @param isEnabled Whether chunks with @c key replace queued ones.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+    AiaRegulatorBuffer_t* regulatorBuffer, AiaMessageSupersedeKey_t key,
+    bool isEnabled );
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+/**
+ * Lets queued chunks expire once they are older than the maximum age of their
+ * supersede key, see @c AiaRegulatorBuffer_SetMaxAge().  Chunks are timestamped
+ * as they are pushed, and expired chunks are destroyed instead of being emitted
+ * by @c AiaRegulatorBuffer_RemoveFront().
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param destroyChunk Callback used to destroy expired chunks, or @c NULL for
+ * chunks to never expire.
+ * @param destroyChunkUserData An optional user data pointer which will be
+ * passed to the @c destroyChunk callback.
+ */
+void AiaRegulatorBuffer_SetExpiry(
+    AiaRegulatorBuffer_t* regulatorBuffer,
+    AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData );
+
+/**
+ * Sets how long chunks with a supersede key may stay queued.  Chunks without a
+ * key never expire.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param key The key, from @c 1 to @c AIA_MESSAGE_MAX_SUPERSEDE_KEY.
+ * @param maxAgeMs The maximum age, or @c 0 for chunks with @c key to never
+ * expire, which is the default.
+ * @return @c true if successful, else @c false.
+ */
+bool AiaRegulatorBuffer_SetMaxAge( AiaRegulatorBuffer_t* regulatorBuffer,
+                                   AiaMessageSupersedeKey_t key,
+                                   AiaDurationMs_t maxAgeMs );
+#endif
+
 /**
  * Remove chunks from the front of the buffer such that the message chunks
  * add up to @c maxMessageSize.
@@ -97,8 +177,8 @@ bool AiaRegulatorBuffer_PushBack( AiaRegulatorBuffer_t* regulatorBuffer,
  * @note This function can fail partway through emitting a series of chunks
  * (this can occur if @c emitMessageChunk returns @c false).
  * @note This function may return success without making any calls to @c
- * emitMessageChunk if there are no chunks buffered or if the buffered chunks
- * will not fit in @c maxMessageSize.
+ * emitMessageChunk if there are no chunks buffered, if the buffered chunks
+ * will not fit in @c maxMessageSize, or if every buffered chunk has expired.
  */
 bool AiaRegulatorBuffer_RemoveFront(
     AiaRegulatorBuffer_t* regulatorBuffer,
@@ -140,6 +220,13 @@ size_t AiaRegulatorBuffer_GetMaxMessageSize(
  */
 size_t AiaRegulatorBuffer_GetSize( const AiaRegulatorBuffer_t* reguatorBuffer );
 
+/**
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @return The number of chunks currently queued.
+ */
+size_t AiaRegulatorBuffer_GetNumChunks(
+    const AiaRegulatorBuffer_t* regulatorBuffer );
+
 /**
  * Checks whether the buffer contains enough data to completely fill a message
  * to @c _maxMessageSize.  Specifically, it may not be
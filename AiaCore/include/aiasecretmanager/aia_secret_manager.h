@@ -105,6 +105,24 @@ bool AiaSecretManager_Encrypt( AiaSecretManager_t* secretManager,
                                uint8_t* outputData, uint8_t* iv, size_t ivLen,
                                uint8_t* tag, const size_t tagLen );
 
+/**
+ * Submits a request to encrypt a message using the correct shared secret and
+ * algorithm for the specified topic and sequence number. The request is
+ * counted as an encryption once submitted.
+ *
+ * @param secretManager The @c SecretManager_t to use for encrypting.
+ * @param topic The @c AiaTopic_t that the message will be published on.
+ * @param sequenceNumber The @c AiaSequenceNumber_t assigned to the message.
+ * @param request The request to submit.
+ *
+ * For the return value and completion rules, see @c
+ * AiaCrypto_SubmitEncryptWithContext().
+ */
+bool AiaSecretManager_SubmitEncrypt( AiaSecretManager_t* secretManager,
+                                     AiaTopic_t topic,
+                                     AiaSequenceNumber_t sequenceNumber,
+                                     const AiaCryptoRequest_t* request );
+
 /**
  * Decrypts the given input data using the correct shared secret and algorithm
  * for the specified topic and sequence number.
@@ -123,4 +141,74 @@ bool AiaSecretManager_Decrypt( AiaSecretManager_t* secretManager,
                                const size_t ivLen, const uint8_t* tag,
                                const size_t tagLen );
 
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/**
+ * Decrypts a message received ahead of the ones before it, without affecting
+ * the decryption of those. Unlike @c AiaSecretManager_Decrypt(), this neither
+ * switches the topic to a different secret nor records @c sequenceNumber as
+ * seen, so no secret is discarded as a result. Messages which need a secret
+ * other than the one the topic is using are not decrypted, and failures are
+ * not counted, since the message is expected to be decrypted again in order.
+ *
+ * @param secretManager The @c SecretManager_t to use for decrypting.
+ * @param topic The @c AiaTopic_t that @c inputData was received from.
+ * @param sequenceNumber The @c AiaSequenceNumber_t assigned to @c inputData.
+ *
+ * For remaining parameters and return value, see AiaCrypto_Decrypt().
+ */
+bool AiaSecretManager_DecryptAhead( AiaSecretManager_t* secretManager,
+                                    AiaTopic_t topic,
+                                    AiaSequenceNumber_t sequenceNumber,
+                                    const uint8_t* inputData, size_t inputLen,
+                                    uint8_t* outputData, const uint8_t* iv,
+                                    size_t ivLen, const uint8_t* tag,
+                                    size_t tagLen );
+#endif
+
+/**
+ * Decrypts the concatenation of @c segments using the correct shared secret
+ * and algorithm for the specified topic and sequence number.
+ *
+ * @param secretManager The @c SecretManager_t to use for decrypting.
+ * @param topic The @c AiaTopic_t that the message was received from.
+ * @param sequenceNumber The @c AiaSequenceNumber_t assigned to the message.
+ *
+ * For remaining parameters and return value, see @c
+ * AiaCrypto_DecryptSegmentsWithContext().
+ */
+bool AiaSecretManager_DecryptSegments( AiaSecretManager_t* secretManager,
+                                       AiaTopic_t topic,
+                                       AiaSequenceNumber_t sequenceNumber,
+                                       const AiaCryptoSegment_t* segments,
+                                       size_t numSegments, const uint8_t* iv,
+                                       size_t ivLen, const uint8_t* tag,
+                                       size_t tagLen );
+
+/** Counters describing the activity of an @c AiaSecretManager_t. */
+typedef struct AiaSecretManagerMetrics
+{
+    /** The number of messages encrypted. */
+    uint32_t encryptions;
+
+    /** The number of messages decrypted. */
+    uint32_t decryptions;
+
+    /** The number of encryptions or decryptions which failed. */
+    uint32_t failures;
+
+    /** The number of times a topic switched to a new secret. */
+    uint32_t rekeys;
+} AiaSecretManagerMetrics_t;
+
+/**
+ * Takes a snapshot of the counters of @c secretManager. Counters wrap on
+ * overflow.
+ *
+ * @param secretManager The secret manager instance to act on.
+ * @param[out] metrics The counters of @c secretManager.
+ * @note This method is safe to call without external synchronization.
+ */
+void AiaSecretManager_GetMetrics( AiaSecretManager_t* secretManager,
+                                  AiaSecretManagerMetrics_t* metrics );
+
 #endif /* ifndef AIA_SECRET_MANAGER_H_ */
@@ -32,6 +32,11 @@
 /**
  * This function may be used to notify the @c secretManager of a new sequenced
  * @c RotateSecret directive.
+ * The new secret is usable on inbound topics and its key is expanded for each
+ * encrypted topic before this returns, so that topics switch to it later
+ * without delay. Persisting the secret is written behind on a worker, and the
+ * @c SecretRotated event which moves outbound topics onto the secret is only
+ * published once it is persisted.
  *
  * @param secretManager The @c AiaSecretManager_t to act on.
  * @param payload Pointer to the unencrypted message body (without the common
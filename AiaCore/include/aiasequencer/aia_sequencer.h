@@ -25,7 +25,11 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_histogram.h>
 #include <aiacore/aia_message_constants.h>
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+#include <aiacore/aia_memory_budget.h>
+#endif
 
 #include AiaTaskPool( HEADER )
 
@@ -112,7 +116,9 @@ typedef bool ( *AiaSequencerGetSequencerNumberCallback_t )(
  * @param getSequenceNumberUserData User data to pass to @c getSequenceNumberCb.
  * @param maxSlots The maximum amount of slots to use for buffering when
  * sequencing messages. Note that each slot will be composed of a pointer to a
- * message, a boolean, and a @c AiaListDoubleLink_t.
+ * message, its size and sequence number, a single bit of occupancy, and @c
+ * AIA_SEQUENCER_SLOT_POOL_DATA_SIZE bytes of pooled message storage which is
+ * allocated the first time a message is buffered.
  * @param startingSequenceNumber The first sequence number message to expect.
  * @param sequenceTimeoutMs The maximum amount of time to wait for a sequence
  * number before making a call to @c timeoutExpiredCb. Setting this to zero will
@@ -137,6 +143,8 @@ AiaSequencer_t* AiaSequencer_Create(
  * message matches the expected message, a call to @c messageSequencedCb with @c
  * message will be made prior to returning. Otherwise, it will be buffered
  * internally and emitted later when the next expected message is written to.
+ * Copies of a message which is already buffered are dropped without being
+ * copied again, and counted in @c duplicatesDropped.
  * @param sequencer The @c AiaSequencer_t to act on.
  * @param message The message to sequence. Note that the caller retains
  * ownership of @c message.
@@ -149,6 +157,21 @@ AiaSequencer_t* AiaSequencer_Create(
 bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message,
                          size_t size );
 
+/**
+ * Equivalent to @c AiaSequencer_Write(), except that ownership of @c message is
+ * transferred to the sequencer. Out of order messages are buffered without
+ * being copied, and @c message is freed once it has been emitted or dropped.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param message The message to sequence. This must have been allocated using
+ * @c AiaCalloc() and must not be accessed by the caller after this call.
+ * @param size The size of @c message.
+ * @return @c false on any messages that failed to be buffered or processed
+ * properly and @c true otherwise.
+ */
+bool AiaSequencer_WriteAndAdopt( AiaSequencer_t* sequencer, void* message,
+                                 size_t size );
+
 /**
  * Resets the next expected sequence number to wait on.
  *
@@ -160,6 +183,205 @@ void AiaSequencer_ResetSequenceNumber(
     AiaSequencer_t* sequencer,
     AiaSequenceNumber_t newNextExpectedSequenceNumber );
 
+/**
+ * Gives up on the missing message(s) currently being waited on and emits the
+ * buffered messages following them. This is intended to be used in response
+ * to @c timeoutExpiredCb by users that can tolerate lost messages.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @return @c true if messages were skipped or @c false if no messages are
+ * buffered to skip to.
+ */
+bool AiaSequencer_SkipMissing( AiaSequencer_t* sequencer );
+
+/**
+ * The number of buckets in each histogram of @c AiaSequencerMetrics_t. Bucket
+ * @c i counts values in [2^i, 2^(i+1)) and the last bucket also counts all
+ * larger values.
+ */
+#define AIA_SEQUENCER_HISTOGRAM_BUCKETS 8
+
+/** The unit in milliseconds of @c AiaSequencerMetrics_t::gapFillTimes. */
+#define AIA_SEQUENCER_GAP_FILL_TIME_UNIT_MS 16
+
+/** Counters describing the activity of an @c AiaSequencer_t. */
+typedef struct AiaSequencerMetrics
+{
+    /** The number of out of order messages buffered to await their turn. */
+    uint32_t messagesBuffered;
+
+    /** The number of messages dropped, either because they were older than
+     * the next expected message or because they did not fit in the buffer. */
+    uint32_t messagesDropped;
+
+    /** The number of times a missing message was not received within the
+     * sequence timeout. */
+    uint32_t timeoutsExpired;
+
+    /** The number of messages refused because a copy of them was already
+     * buffered, e.g. when the broker redelivers after a reconnect. */
+    uint32_t duplicatesDropped;
+
+    /** Histogram of how far ahead of the next expected message out of order
+     * messages arrived, in sequence numbers. */
+    uint32_t reorderDistances[ AIA_SEQUENCER_HISTOGRAM_BUCKETS ];
+
+    /**
+     * Histogram of how long missing messages took to arrive once a later
+     * message had been buffered, in units of @c
+     * AIA_SEQUENCER_GAP_FILL_TIME_UNIT_MS. The first bucket also counts gaps
+     * filled in less than one unit.
+     */
+    uint32_t gapFillTimes[ AIA_SEQUENCER_HISTOGRAM_BUCKETS ];
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long missing messages took to arrive once a later message had been
+     * buffered, in milliseconds. */
+    AiaHistogram_t gapFillWaitMs;
+#endif
+
+    /** The current number of slots in the sequencing buffer. */
+    uint32_t slots;
+
+    /** The current sequence timeout in milliseconds. */
+    uint32_t sequenceTimeoutMs;
+} AiaSequencerMetrics_t;
+
+/**
+ * Takes a snapshot of the counters of @c sequencer. Counters are updated with
+ * relaxed atomics, wrap on overflow and may be read from any thread. Histogram
+ * buckets are updated independently of each other.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param[out] metrics The counters of @c sequencer.
+ */
+void AiaSequencer_GetMetrics( AiaSequencer_t* sequencer,
+                              AiaSequencerMetrics_t* metrics );
+
+/** The number of sequenced messages over which auto-tuning shrinks. */
+#define AIA_SEQUENCER_AUTO_TUNING_WINDOW 64
+
+/** Bounds within which an @c AiaSequencer_t tunes itself. */
+typedef struct AiaSequencerAutoTuningConfig
+{
+    /** The fewest slots to shrink the sequencing buffer to. This must be
+     * non-zero. */
+    size_t minSlots;
+
+    /** The most slots to grow the sequencing buffer to. */
+    size_t maxSlots;
+
+    /** The shortest sequence timeout in milliseconds to shrink to. */
+    uint32_t minTimeoutMs;
+
+    /** The longest sequence timeout in milliseconds to grow to. */
+    uint32_t maxTimeoutMs;
+} AiaSequencerAutoTuningConfig_t;
+
+/**
+ * Enables auto-tuning of the sequencing buffer and sequence timeout. Once set,
+ * a message which arrives too far ahead to fit in the buffer grows the buffer
+ * to hold it, and a missing message which arrives after more than half of the
+ * timeout has elapsed grows the timeout to twice its gap fill time. Every @c
+ * AIA_SEQUENCER_AUTO_TUNING_WINDOW sequenced messages, the buffer and timeout
+ * are shrunk by up to half towards twice the largest reorder distance and gap
+ * fill time seen in that window. Both always stay within @c config.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param config The bounds to tune within, or @c NULL to stop tuning and keep
+ * the current buffer size and timeout.
+ * @return @c true if auto-tuning was configured or @c false otherwise.
+ * @note The timeout is not tuned if the sequencer was created with the timeout
+ * disabled.
+ */
+bool AiaSequencer_SetAutoTuning( AiaSequencer_t* sequencer,
+                                 const AiaSequencerAutoTuningConfig_t* config );
+
+/**
+ * Releases the pooled storage messages are copied into for reordering, if no
+ * message is held. It is allocated again the next time a message arrives ahead
+ * of sequence.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @return The number of bytes released.
+ */
+size_t AiaSequencer_TrimMemory( AiaSequencer_t* sequencer );
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges messages held for reordering to a budget. A message which arrives
+ * ahead of sequence while the budget is exhausted is dropped, as if it was
+ * lost, and counted in @c messagesDropped.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on. This must not be holding
+ * any messages.
+ * @param memoryBudget The budget to charge, or @c NULL to stop charging.
+ * @return @c true if the budget was set or @c false otherwise.
+ */
+bool AiaSequencer_SetMemoryBudget( AiaSequencer_t* sequencer,
+                                  AiaMemoryBudget_t* memoryBudget );
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/**
+ * This callback is used to offer a message buffered ahead of sequence for
+ * preparation, e.g. decryption, while earlier messages are waited on. A
+ * prepared form of it may be handed back with @c AiaSequencer_Prepare().
+ *
+ * @param message The message that was buffered. This is only valid for the
+ * duration of the call.
+ * @param size The size of @c message.
+ * @param sequenceNumber The sequence number of @c message.
+ * @param userData Optional user data pointer which was provided alongside the
+ * callback.
+ *
+ * @note This callback will only be made synchronously in response to a call to
+ * @c AiaSequencer_Write() before returning, and is not expected to block.
+ */
+typedef void ( *AiaSequencerPrepareCallback_t )(
+    void* message, size_t size, AiaSequenceNumber_t sequenceNumber,
+    void* userData );
+
+/**
+ * Lets messages buffered ahead of sequence be prepared before they are
+ * sequenced, so that the work of preparing a run of messages is not all done
+ * at once when the gap before them fills.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param prepareCb Callback offered each message as it is buffered, or @c NULL
+ * to stop offering messages.
+ * @param prepareUserData User data to pass to @c prepareCb.
+ * @param preparedSequencedCb Callback to notify users of sequenced messages
+ * which were prepared, in place of @c messageSequencedCb. It is passed the
+ * prepared form and @c messageSequencedUserData, or @c NULL to keep the
+ * current one. Messages prepared already are still passed to it once @c
+ * prepareCb is cleared.
+ * @return @c true if successful or @c false otherwise.
+ */
+bool AiaSequencer_SetPreparation(
+    AiaSequencer_t* sequencer, AiaSequencerPrepareCallback_t prepareCb,
+    void* prepareUserData,
+    AiaSequencerMessageSequencedCallback_t preparedSequencedCb );
+
+/**
+ * Replaces a message buffered ahead of sequence with a prepared form of it.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param sequenceNumber The sequence number of the message.
+ * @param prepared The prepared form of the message. This must have been
+ * allocated using @c AiaCalloc().
+ * @param size The size of @c prepared.
+ * @return @c true if the message was replaced, or @c false if it is no longer
+ * buffered, e.g. because it has been sequenced already.
+ *
+ * @note Ownership of @c prepared is transferred to the sequencer on success
+ * and retained by the caller on failure.
+ */
+bool AiaSequencer_Prepare( AiaSequencer_t* sequencer,
+                           AiaSequenceNumber_t sequenceNumber, void* prepared,
+                           size_t size );
+#endif
+
 /**
  * Uninitializes and deallocates an @c AiaSequencer_t previously created by
  * a call to
@@ -72,9 +72,58 @@ struct AiaSequencer
      */
     AiaTaskPool_t taskPool;
 
+    /** Storage for @c missingSequenceNumberJob, owned by this sequencer so
+     * that sequencers do not share one job. */
+    AiaTaskPoolJobStorage_t missingSequenceNumberJobStorage;
+
+    /** Job which calls @c timeoutExpiredCb when a missing message has not
+     * arrived in time, or @c NULL if it has never been scheduled. */
+    AiaTaskPoolJob_t missingSequenceNumberJob;
+
     /** Boolean which is used to track the state of @c
      * missingSequenceNumberTimer. */
     AiaAtomicBool_t waitingForMessage;
+
+    /** Whether a later message has been buffered while waiting for @c
+     * nextExpectedSequenceNumber. */
+    bool isGapOpen;
+
+    /** The time at which the current gap opened. */
+    AiaTimepointMs_t gapStartMs;
+
+    /** Whether @c autoTuning applies. */
+    bool isAutoTuning;
+
+    /** Bounds for auto-tuning. */
+    AiaSequencerAutoTuningConfig_t autoTuning;
+
+    /** Whether auto-tuning applies to @c sequenceTimeoutMs. */
+    bool isTimeoutAutoTuned;
+
+    /** The number of messages sequenced in the current auto-tuning window. */
+    size_t windowMessages;
+
+    /** The largest reorder distance seen in the current auto-tuning window. */
+    uint32_t windowMaxReorderDistance;
+
+    /** The longest gap fill time seen in the current auto-tuning window. */
+    AiaDurationMs_t windowMaxGapFillMs;
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    /** Callback offered messages as they are buffered, or @c NULL. */
+    AiaSequencerPrepareCallback_t prepareCb;
+
+    /** User data to pass to @c prepareCb. */
+    void* prepareUserData;
+
+    /** Callback to notify users of sequenced messages which were prepared, or
+     * @c NULL. */
+    AiaSequencerMessageSequencedCallback_t preparedSequencedCb;
+#endif
+
+    /** Counters reported by @c AiaSequencer_GetMetrics(). These should only be
+     * accessed using atomic operations. */
+    AiaSequencerMetrics_t metrics;
 };
 
 #endif /* ifndef PRIVATE_AIA_SEQUENCER_H_ */
@@ -26,43 +26,76 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
-#include AiaListDouble( HEADER )
+#include <aiacore/aia_message_constants.h>
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+#include <aiacore/aia_memory_budget.h>
+#endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
-/** Linked list node for managing chunks. */
+/** A single slot of the sequencing buffer. */
 typedef struct AiaSequencerSlot
 {
-    /** The actual link in the list. */
-    AiaListDouble( Link_t ) link;
-
     /** The data held in this slot. */
     void* data;
 
     /** The size of the data. */
     size_t size;
 
-    /** Flag to indicate whether a slot is occupied with data. */
-    bool isOccupied;
+    /** The sequence number of the data, recorded when it was buffered. */
+    AiaSequenceNumber_t sequenceNumber;
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    /** Whether @c data was replaced by @c AiaSequencerBuffer_Prepare(). */
+    bool isPrepared;
+#endif
 } AiaSequencerSlot_t;
 
 /**
  * Underlying struct that contains all the data required to present the @c
  * AiaSequencerBuffer_t abstraction.
  *
+ * Slots are stored in a fixed array used as a ring, where logical index @c i
+ * lives at physical index `( head + i ) % capacity`. Occupancy is tracked
+ * separately in a bitmap indexed by physical slot so that adding, checking and
+ * popping slots are all constant-time operations.
+ *
  * @note Functions in this header which act on an @c AiaSequencerBuffer_t are
  * not thread-safe.
  */
 typedef struct AiaSequencerBuffer
 {
-    /** The linked list representing the sequencing buffer. */
-    AiaListDouble_t buffer;
+    /** The ring of @c capacity slots representing the sequencing buffer. */
+    AiaSequencerSlot_t* slots;
+
+    /** Bitmap with one bit per physical slot indicating occupancy. */
+    uint32_t* occupancy;
+
+    /** The physical index of the slot at the front of the buffer. */
+    size_t head;
+
+    /**
+     * Slab of @c capacity regions of @c slotDataSize bytes, one per physical
+     * slot, which copied messages are stored in to avoid allocating per
+     * message. This is allocated the first time a message is buffered, and
+     * released by @c AiaSequencerBuffer_TrimMemory().
+     */
+    uint8_t* pool;
+
+    /** The size of each region of @c pool. */
+    const size_t slotDataSize;
 
     /** The maximum amount of slots in the buffer. */
     const size_t capacity;
 
     /** The current number of slots used for buffering. */
     size_t size;
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /** The budget charged for the data held by slots, or @c NULL. */
+    AiaMemoryBudget_t* memoryBudget;
+#endif
 } AiaSequencerBuffer_t;
 
 /**
@@ -72,9 +105,13 @@ typedef struct AiaSequencerBuffer
  *
  * @param maxSlots The maximum amount of slots to use for buffering when
  * sequencing messages. Note that each slot will be composed of a pointer to a
- * message, a boolean, and a @c AiaListDoubleLink_t.
+ * message, its size and sequence number, and a single bit of occupancy.
+ * @param slotDataSize The size of the pooled storage backing each slot.
+ * Messages up to this size are copied into the pool rather than into a
+ * dedicated heap allocation. Zero disables pooling.
  */
-AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots );
+AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots,
+                                                 size_t slotDataSize );
 
 /**
  * Add the element to the provided index in the buffer.
@@ -82,6 +119,7 @@ AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots );
  * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
  * @param data Data to add. Note that this data is copied into the buffer.
  * @param size Size of data.
+ * @param sequenceNumber The sequence number of the data.
  * @param index The slot into which to store the data.
  * @return @c true if the data was stored successfully or @c false if the index
  * was located outside the buffer start and capacity.
@@ -91,7 +129,29 @@ AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots );
  * @note Ownership of the memory pointed to by data is still held by the caller.
  */
 bool AiaSequencerBuffer_Add( AiaSequencerBuffer_t* sequencerBuffer, void* data,
-                             size_t size, size_t index );
+                             size_t size, AiaSequenceNumber_t sequenceNumber,
+                             size_t index );
+
+/**
+ * Add the element to the provided index in the buffer without copying it.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param data Data to add. This must have been allocated using @c AiaCalloc().
+ * @param size Size of data.
+ * @param sequenceNumber The sequence number of the data.
+ * @param index The slot into which to store the data.
+ * @return @c true if the data was stored successfully or @c false if the index
+ * was located outside the buffer start and capacity.
+ * @note If the given slot index was already occupied, this call will replace
+ * it.
+ *
+ * @note Ownership of the memory pointed to by data is transferred to the
+ * buffer on success and retained by the caller on failure.
+ */
+bool AiaSequencerBuffer_Adopt( AiaSequencerBuffer_t* sequencerBuffer,
+                               void* data, size_t size,
+                               AiaSequenceNumber_t sequenceNumber,
+                               size_t index );
 
 /**
  * Checks if the given index is occupied.
@@ -120,6 +180,66 @@ void* AiaSequencerBuffer_Front( const AiaSequencerBuffer_t* sequencerBuffer,
  */
 void AiaSequencerBuffer_PopFront( AiaSequencerBuffer_t* sequencerBuffer );
 
+/**
+ * Called for each element removed by @c AiaSequencerBuffer_Drain().
+ *
+ * @param data The data of the element. This is only valid for the duration of
+ * the call.
+ * @param size The size of the data.
+ * @param userData Context associated with this callback.
+ */
+typedef void ( *AiaSequencerBufferDrainCallback_t )( void* data, size_t size,
+                                                     void* userData );
+
+/**
+ * Removes the run of elements at the front of the buffer whose sequence numbers
+ * follow on from @c nextSequenceNumber, passing each to @c callback in order.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param [in,out] nextSequenceNumber The sequence number expected at the front
+ * of the buffer. This is incremented before each element is passed to @c
+ * callback, and is re-read afterwards so that @c callback may change it.
+ * @param callback Callback to pass each element to.
+ * @param preparedCallback Callback to pass elements replaced by @c
+ * AiaSequencerBuffer_Prepare() to instead of @c callback, or @c NULL to pass
+ * them to @c callback too.
+ * @param userData Context to pass to @c callback.
+ * @return The number of elements removed.
+ */
+size_t AiaSequencerBuffer_Drain( AiaSequencerBuffer_t* sequencerBuffer,
+                                 AiaSequenceNumber_t* nextSequenceNumber,
+                                 AiaSequencerBufferDrainCallback_t callback,
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+                                 AiaSequencerBufferDrainCallback_t
+                                     preparedCallback,
+#endif
+                                 void* userData );
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/**
+ * Replaces the data of a buffered element with a prepared form of it, e.g. its
+ * plaintext. Prepared elements are passed to the @c preparedCallback of @c
+ * AiaSequencerBuffer_Drain().
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param data The prepared data. This must have been allocated using @c
+ * AiaCalloc().
+ * @param size Size of data.
+ * @param sequenceNumber The sequence number of the element to replace.
+ * @param index The slot of the element to replace.
+ * @return @c true if the data was stored, or @c false if the slot does not
+ * hold an element with @c sequenceNumber, e.g. because it has been drained
+ * already.
+ *
+ * @note Ownership of the memory pointed to by data is transferred to the
+ * buffer on success and retained by the caller on failure.
+ */
+bool AiaSequencerBuffer_Prepare( AiaSequencerBuffer_t* sequencerBuffer,
+                                 void* data, size_t size,
+                                 AiaSequenceNumber_t sequenceNumber,
+                                 size_t index );
+#endif
+
 /**
  * Returns the number of elements currently buffered.
  *
@@ -137,6 +257,42 @@ size_t AiaSequencerBuffer_Size( const AiaSequencerBuffer_t* sequencerBuffer );
 size_t AiaSequencerBuffer_Capacity(
     const AiaSequencerBuffer_t* sequencerBuffer );
 
+/**
+ * Changes the number of slots in the buffer, keeping buffered elements at their
+ * indices.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param newCapacity The new number of slots. This must be non-zero.
+ * @return @c true if the buffer was resized or @c false otherwise, including if
+ * an element is buffered at or beyond @c newCapacity.
+ */
+bool AiaSequencerBuffer_Resize( AiaSequencerBuffer_t* sequencerBuffer,
+                                size_t newCapacity );
+
+/**
+ * Releases @c pool while no element is buffered. It is allocated again the next
+ * time a message is buffered.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @return The number of bytes released, which is zero if elements are buffered
+ * or @c pool is not allocated.
+ */
+size_t AiaSequencerBuffer_TrimMemory( AiaSequencerBuffer_t* sequencerBuffer );
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges the data held by slots to a budget. Adding or adopting data which
+ * does not fit in the budget fails as if the data could not be allocated.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on. This must not
+ * hold any data.
+ * @param memoryBudget The budget to charge, or @c NULL to stop charging.
+ * @return @c true if the budget was set or @c false otherwise.
+ */
+bool AiaSequencerBuffer_SetMemoryBudget( AiaSequencerBuffer_t* sequencerBuffer,
+                                         AiaMemoryBudget_t* memoryBudget );
+#endif
+
 /**
  * Uninitializes and deallocates an @c AiaSequencerBuffer_t previously created
  * by a call to
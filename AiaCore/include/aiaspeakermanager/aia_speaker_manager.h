@@ -22,15 +22,28 @@
 
 #include <aia_application_config.h>
 #include <aiacore/aia_binary_constants.h>
+#include <aiacore/aia_histogram.h>
 #include <aiacore/aia_message_constants.h>
 
 #include <aiaregulator/aia_regulator.h>
 #include <aiasequencer/aia_sequencer.h>
 
-/* TODO: ADSER-1867 Calculate this internally at runtime based on Opus frame
- * size and configured capabilities. */
+/** Period of speaker frame pushes until the first speaker content is received.
+ * After that, frames are pushed once per frame duration, derived from the
+ * frame size and @c AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND. This matches the
+ * 20 ms frames of the default 64 kbps constant bitrate stream. */
 #define AIA_SPEAKER_FRAME_PUSH_CADENCE_MS 20
 
+/** The most speakers which may be added with @c AiaSpeakerManager_AddSink(),
+ * in addition to the one given to @c AiaSpeakerManager_Create(). */
+#define AIA_SPEAKER_MAX_SINKS 4
+
+/** Identifies a speaker added with @c AiaSpeakerManager_AddSink(). */
+typedef uint32_t AiaSpeakerSinkId_t;
+
+/** A @c AiaSpeakerSinkId_t which never identifies a speaker. */
+static const AiaSpeakerSinkId_t AIA_INVALID_SPEAKER_SINK_ID = 0;
+
 /**
  * This type is used to manage the speaker data flowing through the system. It
  * provides an interface for applications to interact with to read and play
@@ -104,7 +117,9 @@ typedef void ( *AiaSpeakerManagerBufferStateObserver_t )(
  * AiaSpeakerManager_Destroy().
  *
  * @param speakerBufferSize The size of the underlying buffer to allocate for
- * holding compressed speaker data.
+ * holding compressed speaker data. When @c AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+ * is defined, the buffer starts smaller and grows up to this size as audio is
+ * buffered.
  * @param overrunWarningThreshold The threshold at which to send an
  * OVERRUN_WARNING.
  * @param underrunWarningTreshold The threshold at which to send an
@@ -128,6 +143,11 @@ typedef void ( *AiaSpeakerManagerBufferStateObserver_t )(
  * notifyObserversCb.
  * @return The newly created @c AiaSpeakerManager_t if successful, or NULL
  * otherwise.
+ *
+ * @note Speaker frames are normally sized from the first speaker content
+ * received. When @c AIA_SPEAKER_FIXED_FRAME_SIZE is defined, every frame must
+ * be that many bytes instead, content with other frame sizes is rejected, and
+ * single frames are staged for the speaker without allocating.
  */
 AiaSpeakerManager_t* AiaSpeakerManager_Create(
     size_t speakerBufferSize, size_t overrunWarningThreshold,
@@ -150,7 +170,10 @@ void AiaSpeakerManager_Destroy( AiaSpeakerManager_t* speakerManager );
 
 /**
  * Provides applications a way to notify of playback stoppage due to local stops
- * like barge-in.
+ * like barge-in. The speaker pipeline is flushed: pending offset actions are
+ * invalidated, pending markers are dropped, the buffered speaker data is
+ * skipped up to the latest data received and the callback set using @c
+ * AiaSpeakerManager_SetFlushSpeakerDataCb() is invoked.
  *
  * @param speakerManager The @c AiaSpeakerManager_t to act on.
  * @note This function assumes that the last frame pushed via @c
@@ -158,6 +181,19 @@ void AiaSpeakerManager_Destroy( AiaSpeakerManager_t* speakerManager );
  */
 void AiaSpeakerManager_StopPlayback( AiaSpeakerManager_t* speakerManager );
 
+#ifdef AIA_ENABLE_WARM_RECONNECT
+/**
+ * Resynchronizes the service with the speaker after a reconnection which kept
+ * the speaker buffer. A @c BufferStateChanged event with the current buffer
+ * state and the last speaker message processed is published, followed by a @c
+ * SpeakerOpened event at the offset being played if the speaker is open, so
+ * that the service resumes streaming after the retained audio.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ */
+void AiaSpeakerManager_OnReconnected( AiaSpeakerManager_t* speakerManager );
+#endif
+
 /**
  * Provides applications a way to indicate that they are ready to receive
  * speaker frames via @c playSpeakerDataCb() again after a failure to accept a
@@ -167,6 +203,329 @@ void AiaSpeakerManager_StopPlayback( AiaSpeakerManager_t* speakerManager );
  */
 void AiaSpeakerManager_OnSpeakerReady( AiaSpeakerManager_t* speakerManager );
 
+/**
+ * Adds a speaker which plays the same stream as @c playSpeakerDataCb, such as
+ * another room of a multi-room system. Every frame read from the speaker
+ * buffer is handed to each speaker in the same push, so speakers with matching
+ * output latency play each offset together. The buffer is read at the pace of
+ * the slowest speaker: while any speaker has rejected a frame, no further
+ * frames are read, so buffer states reflect the slowest speaker. A speaker
+ * which rejected a frame is handed it again, alone, once it is ready.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param playSpeakerDataCb Callback used to push frames to the speaker, one
+ * frame per invocation, even in batched playback mode.
+ * @param playSpeakerDataCbUserData User data to be passed along with @c
+ * playSpeakerDataCb.
+ * @return An id for the speaker, or @c AIA_INVALID_SPEAKER_SINK_ID if @c
+ * AIA_SPEAKER_MAX_SINKS speakers have already been added.
+ * @note Frames synthesized with @c concealSpeakerDataCb are not handed to
+ * added speakers.
+ */
+AiaSpeakerSinkId_t AiaSpeakerManager_AddSink(
+    AiaSpeakerManager_t* speakerManager, AiaPlaySpeakerData_t playSpeakerDataCb,
+    void* playSpeakerDataCbUserData );
+
+/**
+ * Removes a speaker added with @c AiaSpeakerManager_AddSink(). Its callback may
+ * still be invoked by a push already in progress.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param sinkId The speaker to remove.
+ * @return @c true if the speaker was removed or @c false otherwise.
+ */
+bool AiaSpeakerManager_RemoveSink( AiaSpeakerManager_t* speakerManager,
+                                   AiaSpeakerSinkId_t sinkId );
+
+/**
+ * Provides applications a way to indicate that a speaker added with @c
+ * AiaSpeakerManager_AddSink() is ready to receive frames again after it failed
+ * to accept one.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param sinkId The speaker which is ready.
+ */
+void AiaSpeakerManager_OnSinkReady( AiaSpeakerManager_t* speakerManager,
+                                    AiaSpeakerSinkId_t sinkId );
+
+/**
+ * Switches the @c speakerManager into batched playback mode. Instead of pushing
+ * a single frame via @c playSpeakerDataCb() every frame duration, up to @c
+ * maxFramesPerPush contiguous buffered frames will be pushed per invocation of
+ * @c playSpeakerDataBatchCb() and the next push will be deferred by the
+ * playback duration of the frames pushed. Batches never cross the offset of a
+ * pending speaker action (e.g. a volume change or @c CloseSpeaker) so that
+ * actions continue to take effect at their exact offsets.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param playSpeakerDataBatchCb Callback used to push batches of speaker
+ * frames for playback, or @c NULL to revert to single frame pushes via
+ * @c playSpeakerDataCb().
+ * @param playSpeakerDataBatchCbUserData User data to be passed along with @c
+ * playSpeakerDataBatchCb.
+ * @param maxFramesPerPush The maximum number of frames to push per invocation.
+ * This must be non-zero when @c playSpeakerDataBatchCb is not @c NULL.
+ * @param maxBytesPerPush An optional byte budget per invocation, or zero for no
+ * limit beyond @c maxFramesPerPush. At least one frame is always pushed.
+ * @return @c true if batched playback was configured or @c false otherwise.
+ * @note This may not be called while a previously rejected frame is pending
+ * redelivery.
+ */
+bool AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaPlaySpeakerDataBatch_t playSpeakerDataBatchCb,
+    void* playSpeakerDataBatchCbUserData, size_t maxFramesPerPush,
+    size_t maxBytesPerPush );
+
+/**
+ * Enables packet loss concealment for the speaker stream. Once set, speaker
+ * content whose offset skips ahead of the buffered audio by whole frames (e.g.
+ * because a speaker topic message was given up on) is accepted, and @c
+ * concealSpeakerDataCb() is invoked in place of pushing frames for the missing
+ * range when playback reaches it. This keeps the buffer from draining to an
+ * underrun on a dropped message.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param concealSpeakerDataCb Callback used to synthesize audio for lost
+ * frames, or @c NULL to reject gaps in the speaker stream.
+ * @param concealSpeakerDataCbUserData User data to be passed along with @c
+ * concealSpeakerDataCb.
+ */
+void AiaSpeakerManager_SetConcealSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaConcealSpeakerData_t concealSpeakerDataCb,
+    void* concealSpeakerDataCbUserData );
+
+/**
+ * Sets a callback which is invoked as soon as an OpenSpeaker directive is
+ * received, before the first frame is pushed, so that the platform can pre-roll
+ * its decoder. Independently of this callback, if the audio at the
+ * directive's offset is already buffered and the speaker is ready for data, the
+ * first frames are pushed immediately instead of on the next playback tick.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param prefetchSpeakerDataCb Callback to invoke, or @c NULL for none.
+ * @param prefetchSpeakerDataCbUserData User data to be passed along with @c
+ * prefetchSpeakerDataCb.
+ */
+void AiaSpeakerManager_SetPrefetchSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaPrefetchSpeakerData_t prefetchSpeakerDataCb,
+    void* prefetchSpeakerDataCbUserData );
+
+/**
+ * Sets a callback which is invoked when playback is stopped by @c
+ * AiaSpeakerManager_StopPlayback(), so that the platform drops the frames it
+ * has queued rather than playing them out after the barge-in.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param flushSpeakerDataCb Callback to invoke, or @c NULL for none.
+ * @param flushSpeakerDataCbUserData User data to be passed along with @c
+ * flushSpeakerDataCb.
+ */
+void AiaSpeakerManager_SetFlushSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaFlushSpeakerData_t flushSpeakerDataCb,
+    void* flushSpeakerDataCbUserData );
+
+/**
+ * Returns whether gaps in the speaker stream can be concealed.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if a callback was set using @c
+ * AiaSpeakerManager_SetConcealSpeakerDataCb() or @c false otherwise.
+ */
+bool AiaSpeakerManager_CanConcealGaps( AiaSpeakerManager_t* speakerManager );
+
+/** Configuration of the adaptive jitter buffer of an @c AiaSpeakerManager_t. */
+typedef struct AiaSpeakerJitterBufferConfig
+{
+    /** The amount of audio in milliseconds to keep buffered on a link without
+     * jitter. */
+    uint32_t minBufferMs;
+
+    /** The number of multiples of the measured inter-arrival jitter of speaker
+     * messages to keep buffered in addition to @c minBufferMs. */
+    uint32_t jitterMultiplier;
+
+    /** The longest time in milliseconds to hold back playback after an @c
+     * OpenSpeaker while waiting for the buffer to fill. */
+    uint32_t maxPrefillMs;
+} AiaSpeakerJitterBufferConfig_t;
+
+/**
+ * Enables the adaptive jitter buffer. Once set, the inter-arrival jitter of
+ * speaker messages is measured and the thresholds at which @c
+ * AIA_UNDERRUN_WARNING_STATE and @c AIA_OVERRUN_WARNING_STATE are entered
+ * follow it in place of those given to @c AiaSpeakerManager_Create(). Playback
+ * after an @c OpenSpeaker is also held back until the buffer holds the
+ * underrun warning threshold's worth of audio or @c maxPrefillMs has elapsed.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param config The configuration to use, or @c NULL to revert to the fixed
+ * thresholds and start playback immediately.
+ * @return @c true if the configuration was applied or @c false otherwise.
+ * @note The thresholds advertised in capabilities are not updated.
+ */
+bool AiaSpeakerManager_SetAdaptiveJitterBuffer(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerJitterBufferConfig_t* config );
+
+/**
+ * Hysteresis applied to the warning states of the speaker buffer of an @c
+ * AiaSpeakerManager_t. A warning is entered at the thresholds given to @c
+ * AiaSpeakerManager_Create() (or those of the adaptive jitter buffer), but is
+ * only cleared once the buffer has moved past its threshold by the given margin
+ * and the warning has been held for at least @c minDwellMs.
+ */
+typedef struct AiaSpeakerBufferStateHysteresisConfig
+{
+    /** The number of bytes above the underrun warning threshold the buffer must
+     * refill to before @c AIA_UNDERRUN_WARNING_STATE is left. */
+    size_t underrunWarningClearMargin;
+
+    /** The number of bytes below the overrun warning threshold the buffer must
+     * drain to before @c AIA_OVERRUN_WARNING_STATE is left. */
+    size_t overrunWarningClearMargin;
+
+    /** The least time in milliseconds a warning state is held once entered. */
+    uint32_t minDwellMs;
+} AiaSpeakerBufferStateHysteresisConfig_t;
+
+/**
+ * Sets the hysteresis applied to the warning states of the speaker buffer.
+ * Regardless of hysteresis, @c AIA_OVERRUN_WARNING_STATE is only entered as the
+ * buffer fills, and a warning state is only left as the buffer moves away from
+ * it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param config The configuration to use, or @c NULL to clear warnings as soon
+ * as the buffer crosses back over their thresholds.
+ * @return @c true if the configuration was applied or @c false otherwise.
+ */
+bool AiaSpeakerManager_SetBufferStateHysteresis(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerBufferStateHysteresisConfig_t* config );
+
+/**
+ * Appends bytes to the tail of a spill store.
+ *
+ * @param data The bytes to append.
+ * @param size The number of bytes in @c data.
+ * @param userData Context associated with this callback.
+ * @return @c true if all bytes were appended or @c false otherwise.
+ */
+typedef bool ( *AiaSpeakerSpillAppend_t )( const uint8_t* data, size_t size,
+                                           void* userData );
+
+/**
+ * Reads and removes bytes from the head of a spill store.
+ *
+ * @param[out] data Buffer to read the bytes into.
+ * @param size The number of bytes to read.
+ * @param userData Context associated with this callback.
+ * @return @c true if all bytes were read or @c false otherwise.
+ */
+typedef bool ( *AiaSpeakerSpillConsume_t )( uint8_t* data, size_t size,
+                                            void* userData );
+
+/**
+ * Discards all bytes in a spill store.
+ *
+ * @param userData Context associated with this callback.
+ */
+typedef void ( *AiaSpeakerSpillClear_t )( void* userData );
+
+/**
+ * An append-only FIFO of bytes, typically backed by flash or a file, that
+ * speaker topic messages are spilled to when the speaker buffer is full.
+ */
+typedef struct AiaSpeakerSpillStore
+{
+    /** Callback that appends bytes to the store. */
+    AiaSpeakerSpillAppend_t append;
+
+    /** Callback that reads bytes back out of the store in append order. */
+    AiaSpeakerSpillConsume_t consume;
+
+    /** Callback that empties the store. */
+    AiaSpeakerSpillClear_t clear;
+
+    /** Context associated with the callbacks. */
+    void* userData;
+
+    /** The maximum number of bytes to hold in the store at once. */
+    size_t capacity;
+} AiaSpeakerSpillStore_t;
+
+/**
+ * Installs a spill store behind the speaker buffer. While the speaker is open,
+ * speaker topic messages which do not fit in the speaker buffer are appended
+ * to the store instead of triggering an @c AIA_OVERRUN_STATE, and are written
+ * back to the speaker buffer in order as playback frees space. An overrun is
+ * only reported once the store reaches its capacity. This allows long-form
+ * audio to be buffered without a large speaker buffer.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param store The store to use, or @c NULL to report overruns as soon as the
+ * speaker buffer is full.
+ * @return @c true if the store was installed or @c false otherwise, including
+ * if messages are currently spilled to a previously installed store.
+ */
+bool AiaSpeakerManager_SetSpillStore( AiaSpeakerManager_t* speakerManager,
+                                      const AiaSpeakerSpillStore_t* store );
+
+/**
+ * Sets whether speaker topic messages which overrun the speaker buffer are
+ * partially accepted. When enabled, the leading audio of such a message which
+ * fits in the speaker buffer is written, split on a frame boundary, before the
+ * @c AIA_OVERRUN_STATE is reported, and the offset at which it stopped is
+ * recorded. When the service redrives the message, the entries and audio
+ * before that offset are skipped, so only the remainder of the message is
+ * written rather than the message being rejected as non-contiguous.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param enabled Whether to keep the audio of a message which fits when it
+ * overruns the speaker buffer.
+ * @return @c true if the setting was applied or @c false otherwise.
+ */
+bool AiaSpeakerManager_SetPartialOverrunAccept(
+    AiaSpeakerManager_t* speakerManager, bool enabled );
+
+/** The default time in milliseconds the volume must stop changing for before
+ * it is persisted through @c AIA_STORE_VOLUME. */
+#define AIA_SPEAKER_VOLUME_STORE_DELAY_MS 2000
+
+/** Configures how volume changes are reported and persisted. */
+typedef struct AiaSpeakerVolumeCoalescingConfig
+{
+    /** The time in milliseconds local volume changes must stop for before a
+     * single @c VolumeChanged event is sent for the settled volume, or zero to
+     * send an event for every change. */
+    AiaDurationMs_t settleMs;
+
+    /** The time in milliseconds the volume must stop changing for before it is
+     * persisted through @c AIA_STORE_VOLUME. This is ignored if @c
+     * AIA_STORE_VOLUME is not defined. */
+    AiaDurationMs_t storeDelayMs;
+} AiaSpeakerVolumeCoalescingConfig_t;
+
+/**
+ * Sets how volume changes are coalesced. Local changes through @c
+ * AiaSpeakerManager_ChangeVolume() and @c AiaSpeakerManager_AdjustVolume() are
+ * always applied to the speaker immediately, but while they keep arriving,
+ * such as during a slider drag, only the settled volume is reported to the
+ * service. Changes requested by the service are reported immediately.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param config The configuration to use, or @c NULL to report every change
+ * and persist after @c AIA_SPEAKER_VOLUME_STORE_DELAY_MS.
+ * @return @c true if the configuration was applied or @c false otherwise.
+ */
+bool AiaSpeakerManager_SetVolumeCoalescing(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerVolumeCoalescingConfig_t* config );
+
 /**
  * Provides applications a way to request a volume change as a result of a local
  * trigger such as a physical button or GUI affordance that changes the volume
@@ -197,6 +556,45 @@ bool AiaSpeakerManager_ChangeVolume( AiaSpeakerManager_t* speakerManager,
 bool AiaSpeakerManager_AdjustVolume( AiaSpeakerManager_t* speakerManager,
                                      int8_t delta );
 
+/**
+ * Sets the volume to one saved before the client was last destroyed, such as
+ * across deep sleep. Unlike @c AiaSpeakerManager_ChangeVolume(), no @c
+ * VolumeChanged event is sent, as the volume has not changed from the
+ * service's point of view. If the volume differs from the persisted one, it is
+ * persisted again.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param volume The volume to restore. This must be between @c AIA_MIN_VOLUME
+ * and @c AIA_MAX_VOLUME, inclusive.
+ * @return @c true if the volume was restored or @c false otherwise.
+ * @note This will result in a synchronous call to @c setVolumeCb.
+ */
+bool AiaSpeakerManager_RestoreVolume( AiaSpeakerManager_t* speakerManager,
+                                      uint8_t volume );
+
+/**
+ * Returns the current volume, which may not have been persisted yet.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The current volume.
+ */
+uint8_t AiaSpeakerManager_GetVolume( AiaSpeakerManager_t* speakerManager );
+
+/**
+ * Sets how long frames take to be heard once they have been pushed to the
+ * speaker, such as the time spent in the audio device's buffers. When this is
+ * non-zero, markers and offset actions are handled when the audio at their
+ * offset is expected to be heard rather than when it is pushed. This may be
+ * called at any time, including from the @c AiaPlaySpeakerData_t callback, so
+ * that the latency can track a device's buffer occupancy.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param latencyMs The time between a frame being pushed and being heard, or
+ * zero to handle offsets as soon as they are pushed.
+ */
+void AiaSpeakerManager_SetPlayoutLatency( AiaSpeakerManager_t* speakerManager,
+                                          AiaDurationMs_t latencyMs );
+
 /**
  * Returns whether the speaker is currently streaming or about the start
  * streaming.
@@ -207,6 +605,77 @@ bool AiaSpeakerManager_AdjustVolume( AiaSpeakerManager_t* speakerManager,
  */
 bool AiaSpeakerManager_CanSpeakerStream( AiaSpeakerManager_t* speakerManager );
 
+/**
+ * Releases the buffer frames are staged in for the speaker while the speaker is
+ * closed and no frame is waiting to be pushed, and with the @c
+ * AIA_ELASTIC_SPEAKER_BUFFER option, the segments of the speaker buffer which
+ * are not needed for the audio left in it. The frame buffer is allocated again
+ * when the speaker is next opened.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The number of bytes released.
+ */
+size_t AiaSpeakerManager_TrimMemory( AiaSpeakerManager_t* speakerManager );
+
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+/**
+ * Prefaults, and optionally locks into RAM, the speaker buffer and the buffer
+ * frames are staged in for the speaker, allocating the latter if needed. Both
+ * are kept prefaulted when they are reallocated later on, such as when the
+ * speaker buffer grows with the @c AIA_ELASTIC_SPEAKER_BUFFER option.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param lock Whether to also lock the buffers into RAM.
+ * @return @c true if the buffers were prefaulted and, if requested, locked,
+ * else @c false.
+ */
+bool AiaSpeakerManager_PrefaultBuffers( AiaSpeakerManager_t* speakerManager,
+                                        bool lock );
+#endif
+
+/** Counters describing the speaker buffer of an @c AiaSpeakerManager_t. */
+typedef struct AiaSpeakerManagerMetrics
+{
+    /** The number of bytes written to the speaker buffer but not yet pushed
+     * for playback. */
+    size_t bufferedBytes;
+
+    /** The capacity of the speaker buffer in bytes, which is currently
+     * allocated rather than advertised when @c
+     * AIA_ENABLE_ELASTIC_SPEAKER_BUFFER is defined. */
+    size_t bufferSize;
+
+    /** The number of transitions into @c AIA_UNDERRUN_WARNING_STATE. */
+    uint32_t underrunWarnings;
+
+    /** The number of transitions into @c AIA_UNDERRUN_STATE. */
+    uint32_t underruns;
+
+    /** The number of transitions into @c AIA_OVERRUN_WARNING_STATE. */
+    uint32_t overrunWarnings;
+
+    /** The number of transitions into @c AIA_OVERRUN_STATE. */
+    uint32_t overruns;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long after each OpenSpeaker directive its first frame was pushed
+     * for playback, in milliseconds. */
+    AiaHistogram_t openToFirstFrameMs;
+#endif
+} AiaSpeakerManagerMetrics_t;
+
+/**
+ * Takes a snapshot of the speaker buffer of @c speakerManager. Counters wrap on
+ * overflow.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param[out] metrics The counters of @c speakerManager.
+ * @note This method does not lock @c speakerManager and may be called from any
+ * thread.
+ */
+void AiaSpeakerManager_GetMetrics( AiaSpeakerManager_t* speakerManager,
+                                   AiaSpeakerManagerMetrics_t* metrics );
+
 #ifdef AIA_ENABLE_ALERTS
 /**
  * @copydoc AiaOfflineAlertStart_t
@@ -22,6 +22,16 @@
 
 #include <aiaspeakermanager/aia_speaker_manager.h>
 
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+/** The number of bytes by which the speaker buffer grows and shrinks. It
+ * starts with one segment and grows up to the size it was created with. */
+#define AIA_SPEAKER_BUFFER_SEGMENT_SIZE 4096
+
+/** How long the speaker must stay closed before the speaker buffer returns the
+ * segments it no longer needs. */
+#define AIA_SPEAKER_BUFFER_SHRINK_DELAY_MS 5000
+#endif
+
 /**
  * This function may be used to notify the @c speakerManager of a new sequenced
  * speaker topic message.
@@ -37,6 +47,70 @@ void AiaSpeakerManager_OnSpeakerTopicMessageReceived(
     AiaSpeakerManager_t* speakerManager, const uint8_t* message, size_t size,
     AiaSequenceNumber_t sequenceNumber );
 
+/** A region of memory which receives part of a decrypted message. */
+typedef struct AiaSpeakerManagerPlaintextRegion
+{
+    /** The start of the region. */
+    uint8_t* data;
+
+    /** The size of the region. */
+    size_t size;
+} AiaSpeakerManagerPlaintextRegion_t;
+
+/**
+ * Decrypts a speaker topic message into @c regions, which together cover its
+ * unencrypted Binary Stream in order.
+ *
+ * @param regions The regions to decrypt into.
+ * @param numRegions The number of entries in @c regions.
+ * @param userData User data associated with this callback.
+ * @return @c true if the message was decrypted and authenticated, else @c
+ * false.
+ */
+typedef bool ( *AiaSpeakerManagerDecryptCallback_t )(
+    const AiaSpeakerManagerPlaintextRegion_t* regions, size_t numRegions,
+    void* userData );
+
+/**
+ * This function may be used to notify the @c speakerManager of a new sequenced
+ * speaker topic message which has not been decrypted yet. When the message
+ * holds a single content entry which follows on from the audio already
+ * buffered, its audio is decrypted directly into the speaker buffer and only
+ * published once @c decrypt has authenticated it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param size The size of the unencrypted Binary Stream.
+ * @param sequenceNumber The sequence number of the message.
+ * @param decrypt Called at most once, before this returns, to decrypt the
+ * message.
+ * @param userData User data passed to @c decrypt.
+ * @return @c true if the message was handled, or @c false if none of it was
+ * and it should be decrypted and passed to @c
+ * AiaSpeakerManager_OnSpeakerTopicMessageReceived() instead.
+ */
+bool AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+    AiaSpeakerManager_t* speakerManager, size_t size,
+    AiaSequenceNumber_t sequenceNumber,
+    AiaSpeakerManagerDecryptCallback_t decrypt, void* userData );
+
+/**
+ * Begins a batch of speaker topic messages, e.g. several received back to back
+ * after a stall. Until @c AiaSpeakerManager_EndWriteBatch() is called, content
+ * written to the speaker buffer does not update the buffer state, which is
+ * evaluated once for the whole batch instead.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ */
+void AiaSpeakerManager_BeginWriteBatch( AiaSpeakerManager_t* speakerManager );
+
+/**
+ * Ends the batch begun by @c AiaSpeakerManager_BeginWriteBatch(), updating the
+ * buffer state for the content written during it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ */
+void AiaSpeakerManager_EndWriteBatch( AiaSpeakerManager_t* speakerManager );
+
 /**
  * This function may be used to notify the @c speakerManager of sequenced @c
  * OpenSpeaker directive messages.
@@ -89,11 +163,15 @@ void AiaSpeakerManager_OnSetVolumeDirectiveReceived(
     void* speakerManager, const void* payload, size_t size,
     AiaSequenceNumber_t sequenceNumber, size_t index );
 
-/** Opaque handle to an @c AiaActionAtSpeakerOffset_t. */
-typedef void* AiaSpeakerActionHandle_t;
+/**
+ * Opaque handle to an @c AiaActionAtSpeakerOffset_t. Handles remain safe to
+ * pass to @c AiaSpeakerManager_CancelAction() after the action has been
+ * invoked or canceled.
+ */
+typedef uint32_t AiaSpeakerActionHandle_t;
 
 /** An invalid @c AiaSpeakerActionHandle_t. */
-static const AiaSpeakerActionHandle_t AIA_INVALID_ACTION_ID = NULL;
+static const AiaSpeakerActionHandle_t AIA_INVALID_ACTION_ID = 0;
 
 /**
  * Function to invoke when an offset is reached.
@@ -118,8 +196,8 @@ typedef void ( *AiaActionAtSpeakerOffset_t )( bool actionValid,
  * @param offset The offset at which to invoke @c action.
  * @param action The action to invoke.
  * @param userData Context to associate with @c action.
- * @return An handle associated with this action or @c NULL on
- * failure.
+ * @return An handle associated with this action or @c AIA_INVALID_ACTION_ID
+ * on failure.
  */
 AiaSpeakerActionHandle_t AiaSpeakerManager_InvokeActionAtOffset(
     AiaSpeakerManager_t* speakerManager, AiaBinaryAudioStreamOffset_t offset,
@@ -127,7 +205,8 @@ AiaSpeakerActionHandle_t AiaSpeakerManager_InvokeActionAtOffset(
 
 /**
  * This function may be used to cancel an action previously submitted for
- * invocation with @c AiaSpeakerManager_InvokeActionAtOffset.
+ * invocation with @c AiaSpeakerManager_InvokeActionAtOffset. Canceling an
+ * action which has already been invoked or canceled has no effect.
  *
  * @param speakerManager The @c AiaSpeakerManager_t to act on.
  * @param handle The handle of the action to cancel.
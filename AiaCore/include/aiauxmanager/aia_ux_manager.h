@@ -82,6 +82,19 @@ AiaUXState_t AiaUXManager_GetUXState( AiaUXManager_t* uxManager );
 void AiaUXManager_UpdateServerAttentionState(
     AiaUXManager_t* uxManager, AiaServerAttentionState_t newAttentionState );
 
+/**
+ * Selects how @c stateObserver is notified. It is only notified when the UX
+ * state actually changes. By default it is called synchronously from the
+ * context that caused the change, which may be holding the locks of other
+ * components. When asynchronous, it is instead called from a separate job, and
+ * changes made while a notification is pending are coalesced so that only the
+ * latest UX state is delivered.
+ *
+ * @param uxManager The @c AiaUXManager_t to act on.
+ * @param isAsync Whether to notify @c stateObserver asynchronously.
+ */
+void AiaUXManager_SetAsyncObserver( AiaUXManager_t* uxManager, bool isAsync );
+
 /**
  * Uninitializes and deallocates an @c AiaUXManager_t previously created
  * by a call to @c AiaUXManager_Create().
@@ -29,14 +29,51 @@
 #include <aiacore/aia_exception_encountered_utils.h>
 #include <aiacore/aia_json_message.h>
 #include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_startup_trace.h>
 #include <aiacore/aia_topic.h>
 #include <aiacore/aia_volume_constants.h>
 #include <aiaspeakermanager/private/aia_speaker_manager.h>
 
+#include AiaListDouble( HEADER )
 #include AiaTimer( HEADER )
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+/** The size of an alert token rendered in @c AiaAlertManager_t::renderedTokens,
+ * including its quotes and trailing separator. */
+#define AIA_ALERT_RENDERED_TOKEN_CHARS ( AIA_ALERT_TOKEN_CHARS + 3 )
+
+/** An alert held by @c AiaAlertManager_t. */
+typedef struct AiaAlertEntry
+{
+    /** The alert itself. */
+    AiaAlertSlot_t slot;
+
+    /** Position of this alert in @c AiaAlertManager_t::alertHeap, or the
+     * index of the next free entry of @c AiaAlertManager_t::alertEntries
+     * while this entry is free. */
+    size_t heapIndex;
+} AiaAlertEntry_t;
+
+/** An acknowledgement of an alert directive, deferred until the end of the
+ * directive message it arrived in. */
+typedef struct AiaAlertAck
+{
+    /** The actual link in the list. */
+    AiaListDouble( Link_t ) link;
+
+    /** Whether this acknowledges a @c SetAlert or a @c DeleteAlert directive.
+     */
+    bool isSetAlert;
+
+    /** The token of the alert. */
+    char alertToken[ AIA_ALERT_TOKEN_CHARS ];
+
+    /** The length of @c alertToken. */
+    size_t alertTokenLen;
+} AiaAlertAck_t;
 
 /**
  * Underlying struct that contains all the data required to present the @c
@@ -54,8 +91,43 @@ struct AiaAlertManager
     /** The offline alert volume. */
     uint8_t offlineAlertVolume;
 
-    /** The linked list representing all alerts. */
-    AiaListDouble_t allAlerts;
+    /** Storage of all alerts, with space for @c alertCapacity alerts. */
+    AiaAlertEntry_t* alertEntries;
+
+    /** Index of the first free entry of @c alertEntries, or @c SIZE_MAX if
+     * they are all in use. */
+    size_t freeAlertEntry;
+
+    /** Binary min-heap of all alerts, keyed on their scheduled time. */
+    AiaAlertEntry_t** alertHeap;
+
+    /** Number of alerts in @c alertHeap. */
+    size_t numAlerts;
+
+    /** Number of alerts @c alertHeap has space for, a power of two. */
+    size_t alertCapacity;
+
+    /** The token of each alert in @c alertHeap, in heap order, as a quoted
+     * string padded with whitespace to @c AIA_ALERT_RENDERED_TOKEN_CHARS
+     * including a trailing comma. This has space for @c alertCapacity alerts.
+     */
+    char* renderedTokens;
+
+    /** Open-addressed hash index of all alerts by token, with @c 2 *
+     * alertCapacity buckets. */
+    AiaAlertEntry_t** alertIndex;
+
+    /** Whether alert directives are persisted and acknowledged once per
+     * directive message. */
+    bool deferPersistence;
+
+    /** Whether an alert transaction is open for the directive message being
+     * handled. */
+    bool transactionOpen;
+
+    /** Acknowledgements of type @c AiaAlertAck_t waiting for the alert
+     * transaction to be committed. */
+    AiaListDouble_t pendingAcks;
 
     /** Used to keep track of the number of UX state
      * changes by the @c offlineAlertPlayOrStatusCheckTimer */
@@ -120,18 +192,38 @@ struct AiaAlertManager
     /** User data to pass to @c disconnectCb. */
     void* const disconnectCbUserData;
 
-    /** Used for two different purposes at every @c
-     * AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS seconds:
-     * - Check if we should start playing the offline alerts.
-     * - Otherwise, check if the state of the speaker buffer (if @c
+    /** One-shot deadline timer, armed for the next alert and then only when
+     * the speaker buffer or UX state changes while an alert is due. When it
+     * fires it:
+     * - Checks if we should start playing the offline alerts.
+     * - Otherwise, checks the state of the speaker buffer (if @c
      * AIA_ENABLE_SPEAKER is defined) and the UX state to decide if the device
      * should disconnect and start playing offline alerts.
      */
     AiaTimer_t offlineAlertPlayOrStatusCheckTimer;
 
+    /** Whether @c offlineAlertPlayOrStatusCheckTimer is armed. */
+    bool statusCheckArmed;
+
+    /** Whether the next alert is due and has not been played offline yet, so
+     * that speaker buffer and UX state changes need to be checked. */
+    bool alertDue;
+
+    /** Loads the alerts from persistent storage shortly after creation, unless
+     * something needed them first. */
+    AiaTimer_t loadAlertsWorker;
+
+    /** Whether the alerts have been loaded from persistent storage. */
+    bool alertsLoaded;
+
     /** Used to publish outbound messages. Methods of this object are
      * thread-safe. */
     AiaRegulator_t* const eventRegulator;
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /** The budget charged for alerts, or @c NULL. */
+    AiaMemoryBudget_t* memoryBudget;
+#endif
 };
 
 /**
@@ -237,29 +329,539 @@ static AiaJsonMessage_t* generateAlertVolumeChangedEvent(
     const uint8_t alertVolume );
 
 /**
- * Comparator used for @c AiaListDouble( InsertSorted ).
+ * Computes the bucket of an alert token in @c alertManager->alertIndex.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param alertToken The alert token, of @c AIA_ALERT_TOKEN_CHARS characters.
+ * @return The first bucket to probe for @c alertToken.
+ */
+static size_t AiaAlertManager_GetTokenBucket( AiaAlertManager_t* alertManager,
+                                              const char* alertToken )
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    for( size_t i = 0; i < AIA_ALERT_TOKEN_CHARS; ++i )
+    {
+        hash ^= (uint8_t)alertToken[ i ];
+        hash *= 16777619u;
+    }
+    return hash & ( 2 * alertManager->alertCapacity - 1 );
+}
+
+/**
+ * Inserts an alert into @c alertManager->alertIndex, which must have a free
+ * bucket for it.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param alert The alert to insert.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_IndexAlertLocked( AiaAlertManager_t* alertManager,
+                                              AiaAlertEntry_t* alert )
+{
+    size_t mask = 2 * alertManager->alertCapacity - 1;
+    size_t bucket =
+        AiaAlertManager_GetTokenBucket( alertManager, alert->slot.alertToken );
+    while( alertManager->alertIndex[ bucket ] )
+    {
+        bucket = ( bucket + 1 ) & mask;
+    }
+    alertManager->alertIndex[ bucket ] = alert;
+}
+
+/**
+ * Grows @c alertManager->alertEntries, @c alertManager->alertHeap and @c
+ * alertManager->alertIndex to hold at least @c numAlerts alerts.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param numAlerts The number of alerts to make space for.
+ * @return @c true on success or @c false otherwise.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static bool AiaAlertManager_ReserveAlertsLocked(
+    AiaAlertManager_t* alertManager, size_t numAlerts )
+{
+    if( numAlerts <= alertManager->alertCapacity )
+    {
+        return true;
+    }
+
+    /* Capacities are kept to powers of two so buckets can be masked. */
+    size_t alertCapacity =
+        alertManager->alertCapacity ? alertManager->alertCapacity : 1;
+    while( alertCapacity < numAlerts )
+    {
+        alertCapacity *= 2;
+    }
+    AiaAlertEntry_t* alertEntries =
+        AiaCalloc( alertCapacity, sizeof( AiaAlertEntry_t ) );
+    if( !alertEntries )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     alertCapacity * sizeof( AiaAlertEntry_t ) );
+        return false;
+    }
+    AiaAlertEntry_t** alertHeap =
+        AiaCalloc( alertCapacity, sizeof( AiaAlertEntry_t* ) );
+    if( !alertHeap )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     alertCapacity * sizeof( AiaAlertEntry_t* ) );
+        AiaFree( alertEntries );
+        return false;
+    }
+    AiaAlertEntry_t** alertIndex =
+        AiaCalloc( 2 * alertCapacity, sizeof( AiaAlertEntry_t* ) );
+    if( !alertIndex )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     2 * alertCapacity * sizeof( AiaAlertEntry_t* ) );
+        AiaFree( alertHeap );
+        AiaFree( alertEntries );
+        return false;
+    }
+    char* renderedTokens =
+        AiaCalloc( alertCapacity, AIA_ALERT_RENDERED_TOKEN_CHARS );
+    if( !renderedTokens )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     alertCapacity * AIA_ALERT_RENDERED_TOKEN_CHARS );
+        AiaFree( alertIndex );
+        AiaFree( alertHeap );
+        AiaFree( alertEntries );
+        return false;
+    }
+
+    /* Alerts keep their entry index, and the new entries are chained in
+     * front of the free ones. */
+    if( alertManager->alertCapacity )
+    {
+        memcpy( alertEntries, alertManager->alertEntries,
+                alertManager->alertCapacity * sizeof( AiaAlertEntry_t ) );
+    }
+    for( size_t i = 0; i < alertManager->numAlerts; ++i )
+    {
+        alertHeap[ i ] = alertEntries + ( alertManager->alertHeap[ i ] -
+                                          alertManager->alertEntries );
+    }
+    if( alertManager->numAlerts )
+    {
+        memcpy( renderedTokens, alertManager->renderedTokens,
+                alertManager->numAlerts * AIA_ALERT_RENDERED_TOKEN_CHARS );
+    }
+    for( size_t i = alertManager->alertCapacity; i < alertCapacity; ++i )
+    {
+        alertEntries[ i ].heapIndex =
+            i + 1 < alertCapacity ? i + 1 : alertManager->freeAlertEntry;
+    }
+    AiaFree( alertManager->alertEntries );
+    AiaFree( alertManager->alertHeap );
+    AiaFree( alertManager->alertIndex );
+    AiaFree( alertManager->renderedTokens );
+    alertManager->alertEntries = alertEntries;
+    alertManager->freeAlertEntry = alertManager->alertCapacity;
+    alertManager->alertHeap = alertHeap;
+    alertManager->alertIndex = alertIndex;
+    alertManager->renderedTokens = renderedTokens;
+    alertManager->alertCapacity = alertCapacity;
+    for( size_t i = 0; i < alertManager->numAlerts; ++i )
+    {
+        AiaAlertManager_IndexAlertLocked( alertManager, alertHeap[ i ] );
+    }
+    return true;
+}
+
+/**
+ * Finds the bucket of an alert in @c alertManager->alertIndex.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param alertToken The token of the alert to find, not null-terminated.
+ * @param alertTokenLen The length of @c alertToken. Only the first @c
+ * AIA_ALERT_TOKEN_CHARS characters, up to a null-terminator, are significant.
+ * @return The bucket holding the alert, or @c SIZE_MAX if there is no such
+ * alert.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static size_t AiaAlertManager_FindAlertLocked( AiaAlertManager_t* alertManager,
+                                               const char* alertToken,
+                                               size_t alertTokenLen )
+{
+    if( !alertManager->numAlerts )
+    {
+        return SIZE_MAX;
+    }
+
+    /* Alert tokens are stored null-padded. */
+    char key[ AIA_ALERT_TOKEN_CHARS ] = { 0 };
+    strncpy( key, alertToken, AiaMin( alertTokenLen, AIA_ALERT_TOKEN_CHARS ) );
+
+    size_t mask = 2 * alertManager->alertCapacity - 1;
+    size_t bucket = AiaAlertManager_GetTokenBucket( alertManager, key );
+    for( ; alertManager->alertIndex[ bucket ]; bucket = ( bucket + 1 ) & mask )
+    {
+        if( !memcmp( alertManager->alertIndex[ bucket ]->slot.alertToken, key,
+                     AIA_ALERT_TOKEN_CHARS ) )
+        {
+            return bucket;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * Moves an alert within @c alertManager->alertHeap, and renders its token at
+ * the same position of @c alertManager->renderedTokens.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param alert The alert to move.
+ * @param heapIndex The position to move @c alert to.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_PlaceAlertLocked( AiaAlertManager_t* alertManager,
+                                              AiaAlertEntry_t* alert,
+                                              size_t heapIndex )
+{
+    alertManager->alertHeap[ heapIndex ] = alert;
+    alert->heapIndex = heapIndex;
+
+    char* rendered = alertManager->renderedTokens +
+                     heapIndex * AIA_ALERT_RENDERED_TOKEN_CHARS;
+    size_t tokenLen = strnlen( alert->slot.alertToken, AIA_ALERT_TOKEN_CHARS );
+    memset( rendered, ' ', AIA_ALERT_RENDERED_TOKEN_CHARS );
+    rendered[ 0 ] = '"';
+    memcpy( rendered + 1, alert->slot.alertToken, tokenLen );
+    rendered[ tokenLen + 1 ] = '"';
+    rendered[ AIA_ALERT_RENDERED_TOKEN_CHARS - 1 ] = ',';
+}
+
+/**
+ * Restores the heap order of @c alertManager->alertHeap after the alert at @c
+ * heapIndex was placed there.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param heapIndex The position of the alert which may be out of order.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_SiftAlertLocked( AiaAlertManager_t* alertManager,
+                                             size_t heapIndex )
+{
+    AiaAlertEntry_t** heap = alertManager->alertHeap;
+    AiaAlertEntry_t* alert = heap[ heapIndex ];
+
+    /* Sift up. */
+    while( heapIndex > 0 )
+    {
+        size_t parent = ( heapIndex - 1 ) / 2;
+        if( heap[ parent ]->slot.scheduledTime <= alert->slot.scheduledTime )
+        {
+            break;
+        }
+        AiaAlertManager_PlaceAlertLocked( alertManager, heap[ parent ],
+                                          heapIndex );
+        heapIndex = parent;
+    }
+
+    /* Sift down. */
+    for( ;; )
+    {
+        size_t child = 2 * heapIndex + 1;
+        if( child >= alertManager->numAlerts )
+        {
+            break;
+        }
+        if( child + 1 < alertManager->numAlerts &&
+            heap[ child + 1 ]->slot.scheduledTime <
+                heap[ child ]->slot.scheduledTime )
+        {
+            ++child;
+        }
+        if( alert->slot.scheduledTime <= heap[ child ]->slot.scheduledTime )
+        {
+            break;
+        }
+        AiaAlertManager_PlaceAlertLocked( alertManager, heap[ child ],
+                                          heapIndex );
+        heapIndex = child;
+    }
+
+    AiaAlertManager_PlaceAlertLocked( alertManager, alert, heapIndex );
+}
+
+/**
+ * Orders alerts of @c AiaAlertManager_t::alertHeap by their scheduled time, for
+ * use with @c qsort().
+ *
+ * @param first Pointer to the first @c AiaAlertEntry_t* to compare.
+ * @param second Pointer to the second @c AiaAlertEntry_t* to compare.
+ * @return A negative, zero or positive value if @c first is scheduled before,
+ * at the same time as or after @c second.
+ */
+static int AiaAlertManager_CompareAlerts( const void* first,
+                                          const void* second )
+{
+    AiaTimepointSeconds_t firstTime =
+        ( *(AiaAlertEntry_t* const*)first )->slot.scheduledTime;
+    AiaTimepointSeconds_t secondTime =
+        ( *(AiaAlertEntry_t* const*)second )->slot.scheduledTime;
+    return ( firstTime > secondTime ) - ( firstTime < secondTime );
+}
+
+/**
+ * Takes a free entry of @c alertManager->alertEntries, which must have one.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param slot The alert to copy into the entry.
+ * @return The entry, which is not in the heap or the index yet.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static AiaAlertEntry_t* AiaAlertManager_TakeEntryLocked(
+    AiaAlertManager_t* alertManager, const AiaAlertSlot_t* slot )
+{
+    AiaAlertEntry_t* alert =
+        &alertManager->alertEntries[ alertManager->freeAlertEntry ];
+    alertManager->freeAlertEntry = alert->heapIndex;
+    alert->slot = *slot;
+    return alert;
+}
+
+/**
+ * Adds an alert to @c alertManager. Any existing alert with the same token
+ * must already have been removed.
  *
- * @param link1 First element to compare. A null value will result in undefined
- * behavior.
- * @param link2 Second element to compare. A null value will result in undefined
- * behavior.
- * @return Returns a negative value if its first argument is less than its
- * second argument; returns zero if its first argument is equal to its second
- * argument; returns a positive value if its first argument is greater than its
- * second argument.
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param slot The alert to add, which is copied.
+ * @param mustKeep Whether to keep the alert even if it does not fit in the
+ * memory budget, e.g. because it was already acknowledged to the service.
+ * @return @c true on success or @c false otherwise.
+ * @note This method must be called while @c alertManager->mutex is locked.
  */
-static int32_t AiaAlertScheduledTimeComparator(
-    const AiaListDouble( Link_t ) * const link1,
-    const AiaListDouble( Link_t ) * const link2 )
+static bool AiaAlertManager_InsertAlertLocked( AiaAlertManager_t* alertManager,
+                                               const AiaAlertSlot_t* slot,
+                                               bool mustKeep )
 {
-    return ( (AiaAlertSlot_t*)link1 )->scheduledTime -
-           ( (AiaAlertSlot_t*)link2 )->scheduledTime;
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( alertManager->memoryBudget )
+    {
+        if( mustKeep )
+        {
+            AiaMemoryBudget_ForceCharge( alertManager->memoryBudget,
+                                         sizeof( AiaAlertEntry_t ) );
+        }
+        else if( !AiaMemoryBudget_Charge( alertManager->memoryBudget,
+                                          sizeof( AiaAlertEntry_t ) ) )
+        {
+            AiaLogWarn( "Refusing alert over budget, numAlerts=%zu",
+                        alertManager->numAlerts );
+            return false;
+        }
+    }
+#else
+    (void)mustKeep;
+#endif
+    if( !AiaAlertManager_ReserveAlertsLocked( alertManager,
+                                              alertManager->numAlerts + 1 ) )
+    {
+        AiaLogError( "AiaAlertManager_ReserveAlertsLocked failed" );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        if( alertManager->memoryBudget )
+        {
+            AiaMemoryBudget_Release( alertManager->memoryBudget,
+                                     sizeof( AiaAlertEntry_t ) );
+        }
+#endif
+        return false;
+    }
+    AiaAlertEntry_t* alert =
+        AiaAlertManager_TakeEntryLocked( alertManager, slot );
+    AiaAlertManager_IndexAlertLocked( alertManager, alert );
+    AiaAlertManager_PlaceAlertLocked( alertManager, alert,
+                                      alertManager->numAlerts++ );
+    AiaAlertManager_SiftAlertLocked( alertManager, alert->heapIndex );
+    return true;
 }
 
 /**
- * This is a recurring function that occurs at @c
- * AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS intervals after the projected start
- * time of an offline alert and it checks for two things:
+ * Removes an alert of @c alertManager, if it has one with the given token, and
+ * frees its entry.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param alertToken The token of the alert to remove, not null-terminated.
+ * @param alertTokenLen The length of @c alertToken.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_RemoveAlertLocked( AiaAlertManager_t* alertManager,
+                                               const char* alertToken,
+                                               size_t alertTokenLen )
+{
+    size_t bucket = AiaAlertManager_FindAlertLocked( alertManager, alertToken,
+                                                     alertTokenLen );
+    if( bucket == SIZE_MAX )
+    {
+        return;
+    }
+    AiaAlertEntry_t* alert = alertManager->alertIndex[ bucket ];
+
+    /* Shift back the rest of the probe sequence to close the gap. */
+    size_t mask = 2 * alertManager->alertCapacity - 1;
+    size_t next = bucket;
+    for( ;; )
+    {
+        next = ( next + 1 ) & mask;
+        AiaAlertEntry_t* other = alertManager->alertIndex[ next ];
+        if( !other )
+        {
+            break;
+        }
+        size_t home = AiaAlertManager_GetTokenBucket( alertManager,
+                                                      other->slot.alertToken );
+        if( ( ( next - home ) & mask ) >= ( ( next - bucket ) & mask ) )
+        {
+            alertManager->alertIndex[ bucket ] = other;
+            bucket = next;
+        }
+    }
+    alertManager->alertIndex[ bucket ] = NULL;
+
+    /* Fill the hole in the heap with its last alert. */
+    AiaAlertEntry_t* last =
+        alertManager->alertHeap[ --alertManager->numAlerts ];
+    if( last != alert )
+    {
+        AiaAlertManager_PlaceAlertLocked( alertManager, last,
+                                          alert->heapIndex );
+        AiaAlertManager_SiftAlertLocked( alertManager, last->heapIndex );
+    }
+    alertManager->alertHeap[ alertManager->numAlerts ] = NULL;
+    alert->heapIndex = alertManager->freeAlertEntry;
+    alertManager->freeAlertEntry = alert - alertManager->alertEntries;
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( alertManager->memoryBudget )
+    {
+        AiaMemoryBudget_Release( alertManager->memoryBudget,
+                                 sizeof( AiaAlertEntry_t ) );
+    }
+#endif
+}
+
+/**
+ * Gets the alert of @c alertManager which is scheduled the soonest.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @return The next alert, or @c NULL if there are no alerts.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static AiaAlertSlot_t* AiaAlertManager_PeekNextAlertLocked(
+    AiaAlertManager_t* alertManager )
+{
+    return alertManager->numAlerts ? &alertManager->alertHeap[ 0 ]->slot
+                                   : NULL;
+}
+
+/**
+ * Opens an alert transaction for the directive message being handled, if
+ * persistence is deferred and one is not open already.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_BeginTransactionLocked(
+    AiaAlertManager_t* alertManager )
+{
+    if( alertManager->deferPersistence && !alertManager->transactionOpen )
+    {
+        alertManager->transactionOpen = AiaBeginAlertTransaction();
+        if( !alertManager->transactionOpen )
+        {
+            AiaLogWarn( "AiaBeginAlertTransaction failed" );
+        }
+    }
+}
+
+/**
+ * Defers the acknowledgement of a successful alert directive until the open
+ * alert transaction is committed.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param isSetAlert Whether the directive was a @c SetAlert or a @c
+ * DeleteAlert.
+ * @param alertToken The token of the alert.
+ * @param alertTokenLen The length of @c alertToken.
+ * @return @c true if the acknowledgement was deferred, or @c false if it
+ * should be sent right away.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static bool AiaAlertManager_DeferAckLocked( AiaAlertManager_t* alertManager,
+                                            bool isSetAlert,
+                                            const char* alertToken,
+                                            size_t alertTokenLen )
+{
+    if( !alertManager->transactionOpen )
+    {
+        return false;
+    }
+    AiaAlertAck_t* ack = AiaCalloc( 1, sizeof( AiaAlertAck_t ) );
+    if( !ack )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", sizeof( AiaAlertAck_t ) );
+        return false;
+    }
+    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
+    ack->link = defaultLink;
+    ack->isSetAlert = isSetAlert;
+    ack->alertTokenLen = AiaMin( alertTokenLen, AIA_ALERT_TOKEN_CHARS );
+    memcpy( ack->alertToken, alertToken, ack->alertTokenLen );
+    AiaListDouble( InsertTail )( &alertManager->pendingAcks, &ack->link );
+    return true;
+}
+
+/**
+ * Loads all alerts from persistent storage into @c alertManager.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @return @c true on success or @c false otherwise.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static bool AiaAlertManager_LoadAlertsLocked( AiaAlertManager_t* alertManager );
+
+/**
+ * Loads all alerts from persistent storage into @c alertManager and arms the
+ * offline alert timers, unless this has already been done. Loading is kept off
+ * @c AiaAlertManager_Create() to shorten startup, so everything which reads or
+ * changes the alerts calls this first.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @return @c true if the alerts are loaded or @c false otherwise.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static bool AiaAlertManager_EnsureAlertsLoadedLocked(
+    AiaAlertManager_t* alertManager );
+
+/**
+ * Routine run by @c loadAlertsWorker to load the alerts after creation.
+ *
+ * @param context The @c AiaAlertManager_t to act on.
+ */
+static void AiaAlertManager_LoadAlertsRoutine( void* context );
+
+/**
+ * Removes every alert which expired more than @c
+ * AIA_ALERT_EXPIRATION_DURATION ago, from memory and from persistent storage.
+ * The deletions are grouped in one alert transaction, so the alerts blob is
+ * written once however many alerts expired.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param now The current NTP epoch time in seconds.
+ * @return @c true on success or @c false otherwise, in which case the alerts
+ * in memory are those left in persistent storage.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static bool AiaAlertManager_PurgeExpiredAlertsLocked(
+    AiaAlertManager_t* alertManager, AiaTimepointSeconds_t now );
+
+/**
+ * This runs at the projected start time of an offline alert, and after that
+ * @c AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS after speaker buffer or UX state
+ * changes until the alert is played or removed. It checks for two things:
  * - Whether we should be playing an offline alert. If so, start the offline
  * alert playback routine.
  * - Otherwise, check the speaker buffer state (if @c AIA_ENABLE_SPEAKER is
@@ -296,6 +898,17 @@ static bool AiaAlertManager_CheckSpeakerBufferAndUXStateLocked(
 static bool AiaAlertManager_UpdateOfflineAlertTimersLocked(
     AiaAlertManager_t* alertManager, AiaTimepointSeconds_t currentTime );
 
+/**
+ * Arms @c offlineAlertPlayOrStatusCheckTimer to fire once after @c delayMs,
+ * unless it is already armed.
+ *
+ * @param alertManager The @c AiaAlertManager_t to act on.
+ * @param delayMs The time until the timer fires.
+ * @note This method must be called while @c alertManager->mutex is locked.
+ */
+static void AiaAlertManager_ArmStatusCheckLocked(
+    AiaAlertManager_t* alertManager, AiaDurationMs_t delayMs );
+
 AiaAlertManager_t* AiaAlertManager_Create(
     AiaRegulator_t* eventRegulator
 #ifdef AIA_ENABLE_SPEAKER
@@ -351,6 +964,8 @@ AiaAlertManager_t* AiaAlertManager_Create(
                      sizeof( AiaAlertManager_t ) );
         return NULL;
     }
+    AiaListDouble( Create )( &alertManager->pendingAcks );
+    alertManager->freeAlertEntry = SIZE_MAX;
 
     if( !AiaMutex( Create )( &alertManager->mutex, false ) )
     {
@@ -359,7 +974,13 @@ AiaAlertManager_t* AiaAlertManager_Create(
         return NULL;
     }
 
-    AiaListDouble( Create )( &alertManager->allAlerts );
+    if( !AiaAlertManager_ReserveAlertsLocked(
+            alertManager, (size_t)AIA_ALERTS_MAX_ALERT_COUNT ) )
+    {
+        AiaLogError( "AiaAlertManager_ReserveAlertsLocked failed" );
+        AiaAlertManager_Destroy( alertManager );
+        return NULL;
+    }
 
     *(AiaRegulator_t**)&alertManager->eventRegulator = eventRegulator;
 #ifdef AIA_ENABLE_SPEAKER
@@ -387,96 +1008,278 @@ AiaAlertManager_t* AiaAlertManager_Create(
     alertManager->currentUXState = AIA_UX_IDLE;
     alertManager->lastUXState = AIA_UX_IDLE;
 
+    if( !AiaTimer( Create )( &alertManager->offlineAlertPlayOrStatusCheckTimer,
+                             AiaAlertManager_PlayOfflineAlertOrCheckStatus,
+                             alertManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaAlertManager_Destroy( alertManager );
+        return NULL;
+    }
+
+    /* Offline alerts must be armed even if no alert directive or query ever
+     * comes, so the alerts are still loaded in the background right away. */
+    if( !AiaTimer( Create )( &alertManager->loadAlertsWorker,
+                             AiaAlertManager_LoadAlertsRoutine, alertManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaAlertManager_Destroy( alertManager );
+        return NULL;
+    }
+    if( !AiaTimer( Arm )( &alertManager->loadAlertsWorker, 0, 0 ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed" );
+        AiaAlertManager_Destroy( alertManager );
+        return NULL;
+    }
+
+    return alertManager;
+}
+
+static bool AiaAlertManager_EnsureAlertsLoadedLocked(
+    AiaAlertManager_t* alertManager )
+{
+    if( alertManager->alertsLoaded )
+    {
+        return true;
+    }
+
+    if( !AiaAlertManager_LoadAlertsLocked( alertManager ) )
+    {
+        AiaLogError( "AiaAlertManager_LoadAlertsLocked failed" );
+        return false;
+    }
+    alertManager->alertsLoaded = true;
+
+    if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
+            alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
+    {
+        AiaLogError( "AiaAlertManager_UpdateOfflineAlertTimersLocked failed" );
+    }
+    return true;
+}
+
+static void AiaAlertManager_LoadAlertsRoutine( void* context )
+{
+    AiaAlertManager_t* alertManager = (AiaAlertManager_t*)context;
+    AiaAssert( alertManager );
+    if( !alertManager )
+    {
+        AiaLogError( "Null alertManager" );
+        return;
+    }
+
+    AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "AiaAlertManager_EnsureAlertsLoadedLocked failed" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return;
+    }
+
+    /* Alerts which expired while the device was off are purged here rather
+     * than on the first connect, which needs the alert tokens. */
+    if( !AiaAlertManager_PurgeExpiredAlertsLocked(
+            alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
+    {
+        AiaLogError( "AiaAlertManager_PurgeExpiredAlertsLocked failed" );
+    }
+    AiaMutex( Unlock )( &alertManager->mutex );
+}
+
+/**
+ * @param slot The alert to check.
+ * @param now The current NTP epoch time in seconds.
+ * @return @c true if @c slot expired more than @c
+ * AIA_ALERT_EXPIRATION_DURATION ago, or @c false otherwise.
+ */
+static bool AiaAlertManager_IsAlertExpired( const AiaAlertSlot_t* slot,
+                                            AiaTimepointSeconds_t now )
+{
+    return now >= slot->scheduledTime &&
+           now - slot->scheduledTime > AIA_ALERT_EXPIRATION_DURATION;
+}
+
+static bool AiaAlertManager_PurgeExpiredAlertsLocked(
+    AiaAlertManager_t* alertManager, AiaTimepointSeconds_t now )
+{
+    /* Alerts are kept in a min-heap by scheduled time, so the expired ones are
+     * always at the top. */
+    AiaAlertSlot_t* slot = AiaAlertManager_PeekNextAlertLocked( alertManager );
+    if( !slot || !AiaAlertManager_IsAlertExpired( slot, now ) )
+    {
+        return true;
+    }
+
+    /* Transactions do not nest, so join the one of a directive message being
+     * handled if there is one. */
+    bool ownTransaction = !alertManager->transactionOpen;
+    if( ownTransaction && !AiaBeginAlertTransaction() )
+    {
+        AiaLogWarn( "AiaBeginAlertTransaction failed" );
+        ownTransaction = false;
+    }
+
+    size_t numPurged = 0;
+    bool deleted = true;
+    while( ( slot = AiaAlertManager_PeekNextAlertLocked( alertManager ) ) &&
+           AiaAlertManager_IsAlertExpired( slot, now ) )
+    {
+        AiaLogDebug( "Alert %s expired", slot->alertToken );
+        if( !AiaDeleteAlert( slot->alertToken, AIA_ALERT_TOKEN_CHARS ) )
+        {
+            AiaLogError( "AiaDeleteAlert failed" );
+            AiaJsonMessage_t* deleteAlertFailedEvent =
+                generateDeleteAlertFailedEvent( slot->alertToken,
+                                                AIA_ALERT_TOKEN_CHARS );
+            if( !deleteAlertFailedEvent )
+            {
+                AiaLogError( "generateDeleteAlertFailedEvent failed" );
+            }
+            else if( !AiaRegulator_Write(
+                         alertManager->eventRegulator,
+                         AiaJsonMessage_ToMessage( deleteAlertFailedEvent ) ) )
+            {
+                AiaLogError( "AiaRegulator_Write failed" );
+                AiaJsonMessage_Destroy( deleteAlertFailedEvent );
+            }
+            deleted = false;
+            break;
+        }
+
+        /* The token is copied since removing the alert frees it. */
+        char alertToken[ AIA_ALERT_TOKEN_CHARS ];
+        memcpy( alertToken, slot->alertToken, AIA_ALERT_TOKEN_CHARS );
+        AiaAlertManager_RemoveAlertLocked( alertManager, alertToken,
+                                           AIA_ALERT_TOKEN_CHARS );
+        ++numPurged;
+    }
+
+    if( ownTransaction && !AiaCommitAlertTransaction() )
+    {
+        AiaLogError( "AiaCommitAlertTransaction failed" );
+
+        /* Roll the in-memory alerts back to what was persisted. */
+        while( alertManager->numAlerts )
+        {
+            AiaAlertManager_RemoveAlertLocked(
+                alertManager, alertManager->alertHeap[ 0 ]->slot.alertToken,
+                AIA_ALERT_TOKEN_CHARS );
+        }
+        if( !AiaAlertManager_LoadAlertsLocked( alertManager ) )
+        {
+            AiaLogError( "AiaAlertManager_LoadAlertsLocked failed" );
+        }
+        deleted = false;
+    }
+    AiaLogDebug( "Purged expired alerts, count=%zu", numPurged );
+
+    if( !AiaAlertManager_UpdateOfflineAlertTimersLocked( alertManager, now ) )
+    {
+        AiaLogError( "AiaAlertManager_UpdateOfflineAlertTimersLocked failed" );
+    }
+    return deleted;
+}
+
+static bool AiaAlertManager_LoadAlertsLocked( AiaAlertManager_t* alertManager )
+{
     /* Load alerts from persistent storage */
     size_t allAlertsBytes = AiaGetAlertsSize();
     uint8_t* allAlertsBuffer = AiaCalloc( 1, allAlertsBytes );
     if( !allAlertsBuffer )
     {
         AiaLogError( "AiaCalloc failed, bytes=%zu.", allAlertsBytes );
-        AiaAlertManager_Destroy( alertManager );
-        return NULL;
+        return false;
     }
 
-    if( !AiaLoadAlerts( allAlertsBuffer, allAlertsBytes ) )
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_LOAD_ALERTS );
+    bool isLoaded = AiaLoadAlerts( allAlertsBuffer, allAlertsBytes );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_LOAD_ALERTS );
+    if( !isLoaded )
     {
         AiaLogError( "AiaLoadBlob failed" );
         AiaFree( allAlertsBuffer );
-        AiaAlertManager_Destroy( alertManager );
-        return NULL;
+        return false;
     }
 
-    /* Insert the loaded alerts to the alerts list */
-    size_t bytePosition = 0;
-    while( bytePosition < allAlertsBytes )
+    /* Make space for every stored alert up front, so that they are all
+     * loaded into the same block of entries. */
+    size_t numStoredAlerts = allAlertsBytes / AIA_SIZE_OF_ALERT_IN_BYTES;
+    if( !AiaAlertManager_ReserveAlertsLocked(
+            alertManager, alertManager->numAlerts + numStoredAlerts ) )
     {
-        if( !allAlertsBuffer[ bytePosition ] )
-        {
-            break;
-        }
-        char readAlertToken[ AIA_ALERT_TOKEN_CHARS ];
-        AiaTimepointSeconds_t readScheduledTime = 0;
-        AiaDurationMs_t readDuration = 0;
+        AiaLogError( "AiaAlertManager_ReserveAlertsLocked failed" );
+        AiaFree( allAlertsBuffer );
+        return false;
+    }
+
+    /* Append the loaded alerts to the heap, which is only ordered once they
+     * are all in. */
+    size_t numLoaded = 0;
+    bool isParsed = true;
+    for( size_t bytePosition = 0;
+         bytePosition + AIA_SIZE_OF_ALERT_IN_BYTES <= allAlertsBytes &&
+         allAlertsBuffer[ bytePosition ];
+         bytePosition += AIA_SIZE_OF_ALERT_IN_BYTES )
+    {
+        AiaAlertSlot_t slot;
+        memset( &slot, 0, sizeof( slot ) );
         AiaAlertStorageType_t readAlertType = 0;
-        if( !AiaLoadAlert( readAlertToken, AIA_ALERT_TOKEN_CHARS,
-                           &readScheduledTime, &readDuration, &readAlertType,
+        if( !AiaLoadAlert( slot.alertToken, AIA_ALERT_TOKEN_CHARS,
+                           &slot.scheduledTime, &slot.duration, &readAlertType,
                            &allAlertsBuffer[ bytePosition ] ) )
         {
             AiaLogError( "AiaLoadAlert failed" );
-            AiaFree( allAlertsBuffer );
-            AiaAlertManager_Destroy( alertManager );
-            return NULL;
+            isParsed = false;
+            break;
         }
+        slot.alertType = (AiaAlertType_t)readAlertType;
 
-        bytePosition += AIA_SIZE_OF_ALERT_IN_BYTES;
-
-        /* Add the read token to the alerts list */
         AiaLogDebug( "Adding the alert token: %.*s, scheduled time: %" PRIu64
                      " duration: %" PRIu32 " alert type: %s",
-                     AIA_ALERT_TOKEN_CHARS, readAlertToken, readScheduledTime,
-                     readDuration,
-                     AiaAlertType_ToString( (AiaAlertType_t)readAlertType ) );
-
-        AiaAlertSlot_t* alertSlot = AiaCalloc( 1, sizeof( AiaAlertSlot_t ) );
-        if( !alertSlot )
-        {
-            AiaLogError( "AiaCalloc failed, bytes=%zu",
-                         sizeof( AiaAlertSlot_t ) );
-            AiaFree( allAlertsBuffer );
-            AiaAlertManager_Destroy( alertManager );
-            return NULL;
-        }
-        AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-        alertSlot->link = defaultLink;
-        memcpy( alertSlot->alertToken, readAlertToken, AIA_ALERT_TOKEN_CHARS );
-        alertSlot->scheduledTime = readScheduledTime;
-        alertSlot->duration = readDuration;
-        alertSlot->alertType = (AiaAlertType_t)readAlertType;
-        AiaListDouble( InsertSorted )( &alertManager->allAlerts,
-                                       &alertSlot->link,
-                                       AiaAlertScheduledTimeComparator );
+                     AIA_ALERT_TOKEN_CHARS, slot.alertToken,
+                     slot.scheduledTime, slot.duration,
+                     AiaAlertType_ToString( slot.alertType ) );
+
+        /* A stored alert replaces any alert in memory with the same token. */
+        size_t bucket = AiaAlertManager_FindAlertLocked(
+            alertManager, slot.alertToken, AIA_ALERT_TOKEN_CHARS );
+        if( bucket != SIZE_MAX )
+        {
+            alertManager->alertIndex[ bucket ]->slot = slot;
+            continue;
+        }
+        AiaAlertEntry_t* alert =
+            AiaAlertManager_TakeEntryLocked( alertManager, &slot );
+        AiaAlertManager_IndexAlertLocked( alertManager, alert );
+        alertManager->alertHeap[ alertManager->numAlerts++ ] = alert;
+        ++numLoaded;
     }
 
-    /* Free the @c allAlertsBuffer as we don't need it anymore. */
-    AiaFree( allAlertsBuffer );
-
-    if( !AiaTimer( Create )( &alertManager->offlineAlertPlayOrStatusCheckTimer,
-                             AiaAlertManager_PlayOfflineAlertOrCheckStatus,
-                             alertManager ) )
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /* Stored alerts were already acknowledged to the service. */
+    if( alertManager->memoryBudget )
     {
-        AiaLogError( "AiaTimer( Create ) failed" );
-        AiaAlertManager_Destroy( alertManager );
-        return NULL;
+        AiaMemoryBudget_ForceCharge( alertManager->memoryBudget,
+                                     numLoaded * sizeof( AiaAlertEntry_t ) );
     }
+#else
+    (void)numLoaded;
+#endif
 
-    AiaTimepointSeconds_t now = AiaClock_GetTimeSinceNTPEpoch();
-    if( !AiaAlertManager_UpdateAlertManagerTime( alertManager, now ) )
+    /* A sorted array is a valid heap. */
+    qsort( alertManager->alertHeap, alertManager->numAlerts,
+           sizeof( AiaAlertEntry_t* ), AiaAlertManager_CompareAlerts );
+    for( size_t i = 0; i < alertManager->numAlerts; ++i )
     {
-        AiaLogError( "AiaAlertManager_UpdateAlertManagerTime failed" );
-        AiaAlertManager_Destroy( alertManager );
-        return NULL;
+        AiaAlertManager_PlaceAlertLocked( alertManager,
+                                          alertManager->alertHeap[ i ], i );
     }
 
-    return alertManager;
+    /* Free the @c allAlertsBuffer as we don't need it anymore. */
+    AiaFree( allAlertsBuffer );
+
+    return isParsed;
 }
 
 void AiaAlertManager_OnSetAlertVolumeDirectiveReceived(
@@ -526,6 +1329,14 @@ void AiaAlertManager_OnSetAlertDirectiveReceived(
     }
 
     AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "Alerts not loaded, sequenceNumber=%" PRIu32
+                     ", index=%zu",
+                     sequenceNumber, index );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return;
+    }
     AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         alertManager, payload, size, sequenceNumber, index );
     AiaMutex( Unlock )( &alertManager->mutex );
@@ -552,28 +1363,19 @@ void AiaAlertManager_OnDeleteAlertDirectiveReceived(
     }
 
     AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "Alerts not loaded, sequenceNumber=%" PRIu32
+                     ", index=%zu",
+                     sequenceNumber, index );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return;
+    }
     AiaAlertManager_OnDeleteAlertDirectiveReceivedLocked(
         alertManager, payload, size, sequenceNumber, index );
     AiaMutex( Unlock )( &alertManager->mutex );
 }
 
-/**
- * Matcher used for @c AiaListDouble( RemoveAllMatches ).
- *
- * @param link Element to check for match.
- * @param matchArgs Pointer to the arguments to use while checking for a match.
- * @return Returns @c true if the alert tokens of the given link and match
- * arguments match, @c false otherwise.
- */
-static bool AiaAlertTokenMatcher( const AiaListDouble( Link_t ) * link,
-                                  void* matchArgs )
-{
-    const char* inputToken = (const char*)matchArgs;
-
-    return ( strncmp( ( (AiaAlertSlot_t*)link )->alertToken, inputToken,
-                      AIA_ALERT_TOKEN_CHARS ) == 0 );
-}
-
 static void AiaAlertManager_OnSetAlertVolumeDirectiveReceivedLocked(
     AiaAlertManager_t* alertManager, const void* payload, size_t size,
     AiaSequenceNumber_t sequenceNumber, size_t index )
@@ -626,12 +1428,37 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
     AiaAlertManager_t* alertManager, const void* payload, size_t size,
     AiaSequenceNumber_t sequenceNumber, size_t index )
 {
+    /* Index the payload once rather than rescanning it for each field. */
+    AiaJsonObject_t object;
+    if( !AiaJsonObject_Parse( &object, payload, size ) )
+    {
+        AiaLogError( "Malformed JSON" );
+        AiaJsonMessage_t* malformedMessageEvent =
+            generateMalformedMessageExceptionEncounteredEvent(
+                sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
+        if( !malformedMessageEvent )
+        {
+            AiaLogError(
+                "generateMalformedMessageExceptionEncounteredEvent failed" );
+            return;
+        }
+        if( !AiaRegulator_Write(
+                alertManager->eventRegulator,
+                AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+        {
+            AiaLogError( "AiaRegulator_Write failed" );
+            AiaJsonMessage_Destroy( malformedMessageEvent );
+            return;
+        }
+        return;
+    }
+
     const char* alertToken = NULL;
     size_t alertTokenLen = 0;
 
-    if( !AiaFindJsonValue( payload, size, AIA_SET_ALERT_TOKEN_KEY,
-                           sizeof( AIA_SET_ALERT_TOKEN_KEY ) - 1, &alertToken,
-                           &alertTokenLen ) )
+    if( !AiaJsonObject_FindValue( &object, AIA_SET_ALERT_TOKEN_KEY,
+                                  sizeof( AIA_SET_ALERT_TOKEN_KEY ) - 1,
+                                  &alertToken, &alertTokenLen ) )
     {
         AiaLogError( "No " AIA_SET_ALERT_TOKEN_KEY " found" );
         AiaJsonMessage_t* malformedMessageEvent =
@@ -704,8 +1531,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
     strncpy( alertTokenStr, alertToken, alertTokenLen );
 
     AiaJsonLongType scheduledTime = 0;
-    if( !AiaJsonUtils_ExtractLong(
-            payload, size, AIA_SET_ALERT_SCHEDULED_TIME_KEY,
+    if( !AiaJsonObject_ExtractLong(
+            &object, AIA_SET_ALERT_SCHEDULED_TIME_KEY,
             sizeof( AIA_SET_ALERT_SCHEDULED_TIME_KEY ) - 1, &scheduledTime ) )
     {
         AiaLogError( "Failed to get " AIA_SET_ALERT_SCHEDULED_TIME_KEY );
@@ -730,8 +1557,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
     }
 
     AiaJsonLongType duration = 0;
-    if( !AiaJsonUtils_ExtractLong(
-            payload, size, AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY,
+    if( !AiaJsonObject_ExtractLong(
+            &object, AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY,
             sizeof( AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY ) - 1,
             &duration ) )
     {
@@ -759,9 +1586,9 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
 
     const char* alertType = NULL;
     size_t alertTypeLen = 0;
-    if( !AiaFindJsonValue( payload, size, AIA_SET_ALERT_TYPE_KEY,
-                           sizeof( AIA_SET_ALERT_TYPE_KEY ) - 1, &alertType,
-                           &alertTypeLen ) )
+    if( !AiaJsonObject_FindValue( &object, AIA_SET_ALERT_TYPE_KEY,
+                                  sizeof( AIA_SET_ALERT_TYPE_KEY ) - 1,
+                                  &alertType, &alertTypeLen ) )
     {
         AiaLogError( "No " AIA_SET_ALERT_TYPE_KEY " found" );
         AiaJsonMessage_t* malformedMessageEvent =
@@ -807,20 +1634,22 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         return;
     }
 
-    /* Remove all matches of this alert token from the alerts list */
-    AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                       AiaAlertTokenMatcher,
-                                       (void*)alertTokenStr, AiaFree, 0 );
+    /* Remove any existing alert with this alert token */
+    AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                       alertTokenLen );
 
-    /* Add the given token to the alerts list */
+    /* Add the given token to the alerts */
     AiaLogDebug( "Adding the alert token: %.*s, scheduled time: %" PRIu64
                  " duration: %" PRIu32 " alert type: %.*s",
                  alertTokenLen, alertTokenStr, scheduledTime, duration,
                  alertTypeLen, alertType );
-    AiaAlertSlot_t* alertSlot = AiaCalloc( 1, sizeof( AiaAlertSlot_t ) );
-    if( !alertSlot )
+    AiaAlertSlot_t alertSlot;
+    memset( &alertSlot, 0, sizeof( alertSlot ) );
+    if( !AiaAlertType_FromString( alertType, alertTypeLen,
+                                  &alertSlot.alertType ) )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu", sizeof( AiaAlertSlot_t ) );
+        AiaLogError( "Failed to get alert type from %.*s", alertTypeLen,
+                     alertType );
         AiaJsonMessage_t* setAlertFailedEvent =
             generateSetAlertFailedEvent( alertTokenStr, alertTokenLen );
         if( !setAlertFailedEvent )
@@ -832,24 +1661,21 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
                 alertManager->eventRegulator,
                 AiaJsonMessage_ToMessage( setAlertFailedEvent ) ) )
         {
-            AiaLogError( "AiaRegulator_Write failed" );
             AiaJsonMessage_Destroy( setAlertFailedEvent );
         }
         return;
     }
-    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-    alertSlot->link = defaultLink;
-    if( !AiaAlertType_FromString( alertType, alertTypeLen,
-                                  &alertSlot->alertType ) )
+    strncpy( alertSlot.alertToken, alertTokenStr, alertTokenLen );
+    alertSlot.scheduledTime = scheduledTime;
+    alertSlot.duration = duration;
+    if( !AiaAlertManager_InsertAlertLocked( alertManager, &alertSlot, false ) )
     {
-        AiaLogError( "Failed to get alert type from %.*s", alertTypeLen,
-                     alertType );
+        AiaLogError( "AiaAlertManager_InsertAlertLocked failed" );
         AiaJsonMessage_t* setAlertFailedEvent =
             generateSetAlertFailedEvent( alertTokenStr, alertTokenLen );
         if( !setAlertFailedEvent )
         {
             AiaLogError( "generateSetAlertFailedEvent failed" );
-            AiaFree( alertSlot );
             return;
         }
         if( !AiaRegulator_Write(
@@ -857,16 +1683,10 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
                 AiaJsonMessage_ToMessage( setAlertFailedEvent ) ) )
         {
             AiaLogError( "AiaRegulator_Write failed" );
-            AiaFree( alertSlot );
             AiaJsonMessage_Destroy( setAlertFailedEvent );
         }
         return;
     }
-    strncpy( alertSlot->alertToken, alertTokenStr, alertTokenLen );
-    alertSlot->scheduledTime = scheduledTime;
-    alertSlot->duration = duration;
-    AiaListDouble( InsertSorted )( &alertManager->allAlerts, &alertSlot->link,
-                                   AiaAlertScheduledTimeComparator );
 
     if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
             alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
@@ -874,9 +1694,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         AiaLogError( "AiaAlertManager_UpdateOfflineAlertTimersLocked failed" );
 
         /* Remove the in-memory copy of this alert */
-        AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                           AiaAlertTokenMatcher,
-                                           (void*)alertTokenStr, AiaFree, 0 );
+        AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                           alertTokenLen );
 
         AiaJsonMessage_t* setAlertFailedEvent =
             generateSetAlertFailedEvent( alertTokenStr, alertTokenLen );
@@ -896,8 +1715,9 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         return;
     }
 
-    if( !AiaStoreAlert( alertSlot->alertToken, AIA_ALERT_TOKEN_CHARS,
-                        scheduledTime, duration, alertSlot->alertType ) )
+    AiaAlertManager_BeginTransactionLocked( alertManager );
+    if( !AiaStoreAlert( alertSlot.alertToken, AIA_ALERT_TOKEN_CHARS,
+                        scheduledTime, duration, alertSlot.alertType ) )
     {
         AiaLogError( "AiaStoreAlert failed" );
         AiaJsonMessage_t* setAlertFailedEvent =
@@ -907,9 +1727,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
             AiaLogError( "generateSetAlertFailedEvent failed" );
 
             /* Remove the in-memory copy of this alert */
-            AiaListDouble( RemoveAllMatches )(
-                &alertManager->allAlerts, AiaAlertTokenMatcher,
-                (void*)alertTokenStr, AiaFree, 0 );
+            AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                               alertTokenLen );
 
             /* Update the offline alert timer */
             if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
@@ -930,9 +1749,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         }
 
         /* Remove the in-memory copy of this alert */
-        AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                           AiaAlertTokenMatcher,
-                                           (void*)alertTokenStr, AiaFree, 0 );
+        AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                           alertTokenLen );
 
         /* Update the offline alert timer */
         if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
@@ -945,6 +1763,12 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         return;
     }
 
+    if( AiaAlertManager_DeferAckLocked( alertManager, true, alertTokenStr,
+                                        alertTokenLen ) )
+    {
+        return;
+    }
+
     AiaJsonMessage_t* setAlertSucceededEvent =
         generateSetAlertSucceededEvent( alertTokenStr, alertTokenLen );
     if( !setAlertSucceededEvent )
@@ -952,9 +1776,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         AiaLogError( "generateSetAlertSucceededEvent failed" );
 
         /* Remove the in-memory copy of this alert */
-        AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                           AiaAlertTokenMatcher,
-                                           (void*)alertTokenStr, AiaFree, 0 );
+        AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                           alertTokenLen );
 
         /* Update the offline alert timer */
         if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
@@ -980,9 +1803,8 @@ static void AiaAlertManager_OnSetAlertDirectiveReceivedLocked(
         AiaJsonMessage_Destroy( setAlertSucceededEvent );
 
         /* Remove the in-memory copy of this alert */
-        AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                           AiaAlertTokenMatcher,
-                                           (void*)alertTokenStr, AiaFree, 0 );
+        AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                           alertTokenLen );
 
         /* Update the offline alert timer */
         if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
@@ -1083,6 +1905,7 @@ static void AiaAlertManager_OnDeleteAlertDirectiveReceivedLocked(
     AiaLogDebug( "Deleting alert token %.*s", alertTokenLen, alertTokenStr );
 
     /* Remove the alert from persistent storage */
+    AiaAlertManager_BeginTransactionLocked( alertManager );
     if( !AiaDeleteAlert( alertTokenStr, AIA_ALERT_TOKEN_CHARS ) )
     {
         AiaLogError( "AiaDeleteAlert failed" );
@@ -1103,10 +1926,9 @@ static void AiaAlertManager_OnDeleteAlertDirectiveReceivedLocked(
         return;
     }
 
-    /* Remove all matches of this alert token from the alerts list */
-    AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                       AiaAlertTokenMatcher,
-                                       (void*)alertTokenStr, AiaFree, 0 );
+    /* Remove the in-memory copy of this alert */
+    AiaAlertManager_RemoveAlertLocked( alertManager, alertTokenStr,
+                                       alertTokenLen );
 
     if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
             alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
@@ -1115,6 +1937,12 @@ static void AiaAlertManager_OnDeleteAlertDirectiveReceivedLocked(
         return;
     }
 
+    if( AiaAlertManager_DeferAckLocked( alertManager, false, alertTokenStr,
+                                        alertTokenLen ) )
+    {
+        return;
+    }
+
     AiaJsonMessage_t* deleteAlertSucceededEvent =
         generateDeleteAlertSucceededEvent( alertTokenStr, alertTokenLen );
     if( !deleteAlertSucceededEvent )
@@ -1131,6 +1959,124 @@ static void AiaAlertManager_OnDeleteAlertDirectiveReceivedLocked(
     }
 }
 
+void AiaAlertManager_OnDirectiveBatchHandled(
+    void* manager, AiaSequenceNumber_t sequenceNumber )
+{
+    AiaAlertManager_t* alertManager = (AiaAlertManager_t*)manager;
+    AiaAssert( alertManager );
+    if( !alertManager )
+    {
+        AiaLogError( "Null alertManager" );
+        return;
+    }
+
+    AiaMutex( Lock )( &alertManager->mutex );
+    if( !alertManager->transactionOpen )
+    {
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return;
+    }
+    alertManager->transactionOpen = false;
+
+    bool committed = AiaCommitAlertTransaction();
+    if( !committed )
+    {
+        AiaLogError(
+            "AiaCommitAlertTransaction failed, sequenceNumber=%" PRIu32,
+            sequenceNumber );
+
+        /* Roll the in-memory alerts back to what was persisted. */
+        while( alertManager->numAlerts )
+        {
+            AiaAlertManager_RemoveAlertLocked(
+                alertManager, alertManager->alertHeap[ 0 ]->slot.alertToken,
+                AIA_ALERT_TOKEN_CHARS );
+        }
+        if( !AiaAlertManager_LoadAlertsLocked( alertManager ) )
+        {
+            AiaLogError( "AiaAlertManager_LoadAlertsLocked failed" );
+        }
+        if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
+                alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
+        {
+            AiaLogError(
+                "AiaAlertManager_UpdateOfflineAlertTimersLocked failed" );
+        }
+    }
+
+    AiaListDouble( Link_t )* link = NULL;
+    while( ( link = AiaListDouble( RemoveHead )(
+                 &alertManager->pendingAcks ) ) != NULL )
+    {
+        AiaAlertAck_t* ack = (AiaAlertAck_t*)link;
+        AiaJsonMessage_t* ackEvent = NULL;
+        if( ack->isSetAlert )
+        {
+            ackEvent = committed ? generateSetAlertSucceededEvent(
+                                       ack->alertToken, ack->alertTokenLen )
+                                 : generateSetAlertFailedEvent(
+                                       ack->alertToken, ack->alertTokenLen );
+        }
+        else
+        {
+            ackEvent = committed ? generateDeleteAlertSucceededEvent(
+                                       ack->alertToken, ack->alertTokenLen )
+                                 : generateDeleteAlertFailedEvent(
+                                       ack->alertToken, ack->alertTokenLen );
+        }
+        AiaFree( ack );
+        if( !ackEvent )
+        {
+            AiaLogError( "Failed to generate alert acknowledgement" );
+            continue;
+        }
+        if( !AiaRegulator_Write( alertManager->eventRegulator,
+                                 AiaJsonMessage_ToMessage( ackEvent ) ) )
+        {
+            AiaLogError( "AiaRegulator_Write failed" );
+            AiaJsonMessage_Destroy( ackEvent );
+        }
+    }
+    AiaMutex( Unlock )( &alertManager->mutex );
+}
+
+void AiaAlertManager_SetDeferredPersistence( AiaAlertManager_t* alertManager,
+                                             bool deferPersistence )
+{
+    if( !alertManager )
+    {
+        AiaLogError( "Null alertManager" );
+        return;
+    }
+    AiaMutex( Lock )( &alertManager->mutex );
+    alertManager->deferPersistence = deferPersistence;
+    AiaMutex( Unlock )( &alertManager->mutex );
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+void AiaAlertManager_SetMemoryBudget( AiaAlertManager_t* alertManager,
+                                      AiaMemoryBudget_t* memoryBudget )
+{
+    if( !alertManager )
+    {
+        AiaLogError( "Null alertManager" );
+        return;
+    }
+    AiaMutex( Lock )( &alertManager->mutex );
+    size_t alertBytes = alertManager->numAlerts * sizeof( AiaAlertEntry_t );
+    if( alertManager->memoryBudget )
+    {
+        AiaMemoryBudget_Release( alertManager->memoryBudget, alertBytes );
+    }
+    alertManager->memoryBudget = memoryBudget;
+    if( memoryBudget )
+    {
+        AiaMemoryBudget_ForceCharge( memoryBudget, alertBytes );
+    }
+    AiaMutex( Unlock )( &alertManager->mutex );
+}
+#endif
+
 size_t AiaAlertManager_GetTokens( AiaAlertManager_t* alertManager,
                                   uint8_t** alertTokens )
 {
@@ -1146,10 +2092,22 @@ size_t AiaAlertManager_GetTokens( AiaAlertManager_t* alertManager,
     }
 
     AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "AiaAlertManager_EnsureAlertsLoadedLocked failed" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return 0;
+    }
 
-    size_t numAlertTokens = AiaListDouble( Count )( &alertManager->allAlerts );
-    size_t tokenArrayBytes = 0;
+    if( !AiaAlertManager_PurgeExpiredAlertsLocked(
+            alertManager, AiaClock_GetTimeSinceNTPEpoch() ) )
+    {
+        AiaLogError( "AiaAlertManager_PurgeExpiredAlertsLocked failed" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return 0;
+    }
 
+    size_t numAlertTokens = alertManager->numAlerts;
     if( numAlertTokens == 0 )
     {
         *alertTokens = NULL;
@@ -1158,16 +2116,10 @@ size_t AiaAlertManager_GetTokens( AiaAlertManager_t* alertManager,
         return 0;
     }
 
-    /* Account for the comma separator between alert tokens and the quotes
-     * around token names */
-    size_t tokenLengthWithNoSeparator = AIA_ALERT_TOKEN_CHARS + 2;
-    size_t tokenLengthWithSeparator = tokenLengthWithNoSeparator + 1;
-
-    /* All except the last one will have a separator afterwards */
-    tokenArrayBytes = ( ( numAlertTokens - 1 ) * tokenLengthWithSeparator );
-    tokenArrayBytes += tokenLengthWithNoSeparator;
-
-    /* Account for the null terminator added by snprintf at the end */
+    /* Every alert left is current, so the pre-rendered tokens can be used as
+     * is, minus the separator after the last token. */
+    size_t tokenArrayBytes =
+        numAlertTokens * AIA_ALERT_RENDERED_TOKEN_CHARS - 1;
     *alertTokens = AiaCalloc( sizeof( uint8_t ), tokenArrayBytes + 1 );
     if( !*alertTokens )
     {
@@ -1175,79 +2127,8 @@ size_t AiaAlertManager_GetTokens( AiaAlertManager_t* alertManager,
         AiaMutex( Unlock )( &alertManager->mutex );
         return 0;
     }
-
-    size_t arrayPosition = 0;
-    AiaListDouble( Link_t )* link = NULL;
-    AiaListDouble( ForEach )( &alertManager->allAlerts, link )
-    {
-        AiaAlertSlot_t* slot = (AiaAlertSlot_t*)link;
-        /* Skip this alert if it expired for more than the threshold */
-        AiaTimepointSeconds_t now = AiaClock_GetTimeSinceNTPEpoch();
-        if( now >= slot->scheduledTime )
-        {
-            AiaDurationSeconds_t timeSinceAlertCreation =
-                now - slot->scheduledTime;
-            if( timeSinceAlertCreation > AIA_ALERT_EXPIRATION_DURATION )
-            {
-                AiaLogDebug( "Alert %s expired", slot->alertToken );
-
-                /* Remove the alert from persistent storage */
-                if( !AiaDeleteAlert( slot->alertToken, AIA_ALERT_TOKEN_CHARS ) )
-                {
-                    AiaLogError( "AiaDeleteAlert failed" );
-                    AiaJsonMessage_t* deleteAlertFailedEvent =
-                        generateDeleteAlertFailedEvent( slot->alertToken,
-                                                        AIA_ALERT_TOKEN_CHARS );
-                    if( !deleteAlertFailedEvent )
-                    {
-                        AiaLogError( "generateDeleteAlertFailedEvent failed" );
-                        AiaFree( *alertTokens );
-                        AiaMutex( Unlock )( &alertManager->mutex );
-                        return 0;
-                    }
-                    if( !AiaRegulator_Write( alertManager->eventRegulator,
-                                             AiaJsonMessage_ToMessage(
-                                                 deleteAlertFailedEvent ) ) )
-                    {
-                        AiaLogError( "AiaRegulator_Write failed" );
-                        AiaJsonMessage_Destroy( deleteAlertFailedEvent );
-                    }
-
-                    AiaFree( *alertTokens );
-                    AiaMutex( Unlock )( &alertManager->mutex );
-                    return 0;
-                }
-
-                continue;
-            }
-        }
-        /* First entry */
-        int result = 0;
-        if( arrayPosition == 0 )
-        {
-            result = snprintf( (char*)*alertTokens + arrayPosition,
-                               tokenLengthWithNoSeparator + 1, "\"%s\"",
-                               slot->alertToken );
-        }
-        else
-        {
-            result = snprintf( (char*)*alertTokens + arrayPosition,
-                               tokenLengthWithSeparator + 1, ",\"%s\"",
-                               slot->alertToken );
-        }
-
-        if( result <= 0 )
-        {
-            AiaLogError( "snprintf failed: %d", result );
-            AiaFree( *alertTokens );
-            AiaMutex( Unlock )( &alertManager->mutex );
-            return 0;
-        }
-        arrayPosition += result;
-    }
-
+    memcpy( *alertTokens, alertManager->renderedTokens, tokenArrayBytes );
     AiaMutex( Unlock )( &alertManager->mutex );
-
     return tokenArrayBytes;
 }
 
@@ -1259,11 +2140,29 @@ void AiaAlertManager_Destroy( AiaAlertManager_t* alertManager )
         return;
     }
 
+    AiaTimer( Destroy )( &alertManager->loadAlertsWorker );
     AiaTimer( Destroy )( &alertManager->offlineAlertPlayOrStatusCheckTimer );
 
     AiaMutex( Lock )( &alertManager->mutex );
 
-    AiaListDouble( RemoveAll )( &alertManager->allAlerts, AiaFree, 0 );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( alertManager->memoryBudget )
+    {
+        AiaMemoryBudget_Release(
+            alertManager->memoryBudget,
+            alertManager->numAlerts * sizeof( AiaAlertEntry_t ) );
+    }
+#endif
+    AiaFree( alertManager->alertEntries );
+    AiaFree( alertManager->alertHeap );
+    AiaFree( alertManager->alertIndex );
+    AiaFree( alertManager->renderedTokens );
+
+    if( alertManager->transactionOpen && !AiaCommitAlertTransaction() )
+    {
+        AiaLogWarn( "AiaCommitAlertTransaction failed" );
+    }
+    AiaListDouble( RemoveAll )( &alertManager->pendingAcks, AiaFree, 0 );
 
     AiaMutex( Unlock )( &alertManager->mutex );
     AiaMutex( Destroy )( &alertManager->mutex );
@@ -1410,6 +2309,12 @@ static AiaJsonMessage_t* generateAlertVolumeChangedEvent(
     }
     AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
         AIA_EVENTS_ALERT_VOLUME_CHANGED, NULL, payloadBuffer );
+    if( jsonMessage )
+    {
+        AiaMessage_SetSupersedeKey(
+            AiaJsonMessage_ToMessage( jsonMessage ),
+            AIA_EVENTS_ALERT_VOLUME_CHANGED_SUPERSEDE_KEY );
+    }
     return jsonMessage;
 }
 
@@ -1423,6 +2328,12 @@ bool AiaAlertManager_UpdateAlertManagerTime( AiaAlertManager_t* alertManager,
     }
 
     AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "AiaAlertManager_EnsureAlertsLoadedLocked failed" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return false;
+    }
     if( !AiaAlertManager_UpdateOfflineAlertTimersLocked( alertManager,
                                                          currentTime ) )
     {
@@ -1452,6 +2363,11 @@ void AiaAlertManager_UpdateSpeakerBufferState(
     {
         alertManager->numUnderruns++;
     }
+    if( alertManager->alertDue )
+    {
+        AiaAlertManager_ArmStatusCheckLocked(
+            alertManager, AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS );
+    }
     AiaMutex( Unlock )( &alertManager->mutex );
 }
 #endif
@@ -1468,14 +2384,21 @@ void AiaAlertManager_UpdateUXState( AiaAlertManager_t* alertManager,
     alertManager->lastUXState = alertManager->currentUXState;
     alertManager->currentUXState = uxState;
     alertManager->numStateChanges++;
+    if( alertManager->alertDue )
+    {
+        AiaAlertManager_ArmStatusCheckLocked(
+            alertManager, AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS );
+    }
     AiaMutex( Unlock )( &alertManager->mutex );
 }
 
 static bool AiaAlertManager_UpdateOfflineAlertTimersLocked(
     AiaAlertManager_t* alertManager, AiaTimepointSeconds_t currentTime )
 {
-    /* Cancel the existing periodic offline alert related timers */
+    /* Cancel the existing offline alert related timers */
     AiaTimer( Destroy )( &alertManager->offlineAlertPlayOrStatusCheckTimer );
+    alertManager->statusCheckArmed = false;
+    alertManager->alertDue = false;
     if( !AiaTimer( Create )( &alertManager->offlineAlertPlayOrStatusCheckTimer,
                              AiaAlertManager_PlayOfflineAlertOrCheckStatus,
                              alertManager ) )
@@ -1485,11 +2408,9 @@ static bool AiaAlertManager_UpdateOfflineAlertTimersLocked(
     }
 
     /* Set the offline alert related timers if we have any alerts */
-    if( AiaListDouble( Count )( &alertManager->allAlerts ) > 0 )
+    AiaAlertSlot_t* slot = AiaAlertManager_PeekNextAlertLocked( alertManager );
+    if( slot )
     {
-        AiaListDouble( Link_t )* link =
-            AiaListDouble( PeekHead )( &alertManager->allAlerts );
-        AiaAlertSlot_t* slot = (AiaAlertSlot_t*)link;
         AiaDurationMs_t durationUntilNextOfflineAlert = 0;
         AiaTimepointSeconds_t offlineAlertTime = slot->scheduledTime;
 
@@ -1506,14 +2427,14 @@ static bool AiaAlertManager_UpdateOfflineAlertTimersLocked(
             "%" PRIu32 " milliseconds.",
             durationUntilNextOfflineAlert );
         if( !AiaTimer( Arm )( &alertManager->offlineAlertPlayOrStatusCheckTimer,
-                              durationUntilNextOfflineAlert,
-                              AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS ) )
+                              durationUntilNextOfflineAlert, 0 ) )
         {
             AiaLogError( "AiaTimer( Arm ) failed" );
             AiaTimer( Destroy )(
                 &alertManager->offlineAlertPlayOrStatusCheckTimer );
             return false;
         }
+        alertManager->statusCheckArmed = true;
 #ifdef AIA_ENABLE_SPEAKER
         alertManager->numUnderruns = 0;
         alertManager->lastBufferState = alertManager->currentBufferState;
@@ -1526,6 +2447,22 @@ static bool AiaAlertManager_UpdateOfflineAlertTimersLocked(
     return true;
 }
 
+static void AiaAlertManager_ArmStatusCheckLocked(
+    AiaAlertManager_t* alertManager, AiaDurationMs_t delayMs )
+{
+    if( alertManager->statusCheckArmed )
+    {
+        return;
+    }
+    if( !AiaTimer( Arm )( &alertManager->offlineAlertPlayOrStatusCheckTimer,
+                          delayMs, 0 ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed" );
+        return;
+    }
+    alertManager->statusCheckArmed = true;
+}
+
 static void AiaAlertManager_PlayOfflineAlertOrCheckStatus( void* context )
 {
     AiaAlertManager_t* alertManager = (AiaAlertManager_t*)context;
@@ -1537,10 +2474,22 @@ static void AiaAlertManager_PlayOfflineAlertOrCheckStatus( void* context )
         return;
     }
 
+    AiaMutex( Lock )( &alertManager->mutex );
+    alertManager->statusCheckArmed = false;
+
+    /* Get the information about the first available alert if we have any */
+    AiaAlertSlot_t* slot = AiaAlertManager_PeekNextAlertLocked( alertManager );
+    if( !slot )
+    {
+        AiaLogDebug( "There are no alerts" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return;
+    }
+    alertManager->alertDue = true;
+
     /* Check if the speaker is open and the UX state is speaking,
      * thinking or alerting */
 #ifdef AIA_ENABLE_SPEAKER
-    AiaMutex( Lock )( &alertManager->mutex );
     AiaUXState_t currentUXState =
         alertManager->uxStateCheckCb( alertManager->uxStateCheckCbUserData );
     if( !alertManager->speakerCheckCb( alertManager->speakerCheckCbUserData ) ||
@@ -1548,28 +2497,27 @@ static void AiaAlertManager_PlayOfflineAlertOrCheckStatus( void* context )
           currentUXState != AIA_UX_THINKING &&
           currentUXState != AIA_UX_ALERTING ) )
     {
-        /* Get the information about the first available alert if we have any */
-        if( !AiaListDouble( Count )( &alertManager->allAlerts ) )
-        {
-            AiaLogDebug( "There are no alerts" );
-            AiaMutex( Unlock )( &alertManager->mutex );
-            return;
-        }
-
-        AiaListDouble( Link_t )* link =
-            AiaListDouble( PeekHead )( &alertManager->allAlerts );
-        AiaAlertSlot_t* slot = (AiaAlertSlot_t*)link;
-
+        /* The alert is copied since it may be removed once unlocked. Nothing
+         * more needs checking until the alerts change. */
+        AiaAlertSlot_t offlineAlert = *slot;
+        alertManager->alertDue = false;
         AiaMutex( Unlock )( &alertManager->mutex );
 
         /* TODO: ADSER-1963 Create a RequestTimeSynchronization function */
         AiaLogDebug( "Playing the offline alert" );
 
         if( !alertManager->startOfflineAlertCb(
-                slot, alertManager->startOfflineAlertCbUserData,
+                &offlineAlert, alertManager->startOfflineAlertCbUserData,
                 alertManager->offlineAlertVolume ) )
         {
             AiaLogDebug( "Failed to play offline alert data" );
+
+            /* Try again later. */
+            AiaMutex( Lock )( &alertManager->mutex );
+            alertManager->alertDue = true;
+            AiaAlertManager_ArmStatusCheckLocked(
+                alertManager, AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS );
+            AiaMutex( Unlock )( &alertManager->mutex );
             return;
         }
         if( currentUXState != AIA_UX_ALERTING )
@@ -1578,29 +2526,42 @@ static void AiaAlertManager_PlayOfflineAlertOrCheckStatus( void* context )
                 alertManager->uxStateUpdateCbUserData,
                 AIA_ATTENTION_STATE_ALERTING );
         }
+        return;
+    }
+
+    AiaLogDebug(
+        "Not playing the offline alert, check if we should be "
+        "disconnecting from the service" );
+    bool shouldDisconnect =
+        AiaAlertManager_CheckSpeakerBufferAndUXStateLocked( alertManager );
+
+    /* A stuck underrun or alert only shows as the absence of changes over a
+     * whole check period, and a disconnect should be followed by offline
+     * playback, so keep checking in those cases. Otherwise, the next speaker
+     * buffer or UX state change arms the check. */
+    if( shouldDisconnect ||
+        alertManager->currentBufferState == AIA_UNDERRUN_STATE ||
+        currentUXState == AIA_UX_ALERTING )
+    {
+        AiaAlertManager_ArmStatusCheckLocked(
+            alertManager, AIA_OFFLINE_ALERT_STATUS_CHECK_CADENCE_MS );
     }
-    else
+    AiaMutex( Unlock )( &alertManager->mutex );
+    if( shouldDisconnect )
     {
+        /* Call the disconnect callback */
         AiaLogDebug(
-            "Not playing the offline alert, check if we should be "
-            "disconnecting from the service" );
-        bool shouldDisconnect =
-            AiaAlertManager_CheckSpeakerBufferAndUXStateLocked( alertManager );
-        AiaMutex( Unlock )( &alertManager->mutex );
-        if( shouldDisconnect )
-        {
-            /* Call the disconnect callback */
-            AiaLogDebug(
-                "Disconnecting from service due to being in underrun state "
-                "longer than the threshold!" );
-            if( !alertManager->disconnectCb(
-                    alertManager->disconnectCbUserData,
-                    AIA_CONNECTION_ON_DISCONNECTED_GOING_OFFLINE, NULL ) )
-            {
-                AiaLogError( "Failed to disconnect" );
-            }
+            "Disconnecting from service due to being in underrun state "
+            "longer than the threshold!" );
+        if( !alertManager->disconnectCb(
+                alertManager->disconnectCbUserData,
+                AIA_CONNECTION_ON_DISCONNECTED_GOING_OFFLINE, NULL ) )
+        {
+            AiaLogError( "Failed to disconnect" );
         }
     }
+#else
+    AiaMutex( Unlock )( &alertManager->mutex );
 #endif
 }
 
@@ -1643,11 +2604,16 @@ bool AiaAlertManager_DeleteAlert( AiaAlertManager_t* alertManager,
         return false;
     }
     AiaMutex( Lock )( &alertManager->mutex );
+    if( !AiaAlertManager_EnsureAlertsLoadedLocked( alertManager ) )
+    {
+        AiaLogError( "AiaAlertManager_EnsureAlertsLoadedLocked failed" );
+        AiaMutex( Unlock )( &alertManager->mutex );
+        return false;
+    }
 
     /* Remove the in-memory copy of this alert */
-    AiaListDouble( RemoveAllMatches )( &alertManager->allAlerts,
-                                       AiaAlertTokenMatcher, (void*)alertToken,
-                                       AiaFree, 0 );
+    AiaAlertManager_RemoveAlertLocked( alertManager, alertToken,
+                                       AIA_ALERT_TOKEN_CHARS );
 
     /* Update the offline alert timer */
     if( !AiaAlertManager_UpdateOfflineAlertTimersLocked(
@@ -32,14 +32,80 @@
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_utils.h>
 
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaTimer( HEADER )
+
 #include <inttypes.h>
 
+/**
+ * Round trips longer than this are not used to estimate the one-way delay of a
+ * @c SetClock directive, since the directive is then unlikely to be the reply
+ * to the last @c SynchronizeClock event.
+ */
+#define AIA_CLOCK_MANAGER_MAX_ROUND_TRIP_MS 10000
+
+/**
+ * The minimum local time between two synchronizations for them to be used to
+ * measure drift. Over shorter spans, delay jitter dominates the measurement.
+ */
+#define AIA_CLOCK_MANAGER_MIN_DRIFT_BASELINE_MS 600000
+
+/**
+ * Drift measurements larger than this, in parts per million, are assumed to be
+ * caused by a step of the server clock rather than by the local oscillator.
+ */
+#define AIA_CLOCK_MANAGER_MAX_DRIFT_PPM 1000
+
+/** The number of parts per million in one. */
+#define AIA_CLOCK_MANAGER_PPM 1000000
+
+/** The number of milliseconds the drift model adds up to before it is applied
+ * to the device clock, which has a resolution of one second. */
+#define AIA_CLOCK_MANAGER_SLEW_STEP_MS 1000
+
 /**
  * Underlying struct that contains all the data required to present the @c
  * AiaClockManager_t abstraction.
  */
 struct AiaClockManager
 {
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Whether a @c SynchronizeClock event is awaiting its @c SetClock. */
+    bool requestPending;
+
+    /** The local time at which the pending @c SynchronizeClock was sent. */
+    AiaTimepointMs_t requestLocalMs;
+
+    /** Whether a @c SetClock directive has been received. */
+    bool synchronized;
+
+    /** The local time of the last @c SetClock directive. */
+    AiaTimepointMs_t anchorLocalMs;
+
+    /** The estimated milliseconds since the NTP epoch at @c anchorLocalMs. */
+    AiaTimepointMs_t anchorNtpMs;
+
+    /** The local time of the synchronization that drift is measured from. */
+    AiaTimepointMs_t baselineLocalMs;
+
+    /** The estimated milliseconds since the NTP epoch at @c baselineLocalMs. */
+    AiaTimepointMs_t baselineNtpMs;
+
+    /** The rate at which the server clock gains on the local clock, in parts
+     * per million. */
+    int32_t driftPpm;
+
+    /** @} */
+
+    /** Periodically applies @c driftPpm to the device clock. */
+    AiaTimer_t slewTimer;
+
     /** Used to publish messages on the event topic. */
     AiaRegulator_t* const eventRegulator;
 
@@ -50,6 +116,104 @@ struct AiaClockManager
     void* const notifyObserverCbUserData;
 };
 
+/**
+ * Estimates the current time using the last synchronization and the drift
+ * measured so far.
+ *
+ * @param clockManager The @c AiaClockManager_t to act on.
+ * @param nowLocalMs The current local time.
+ * @return The estimated milliseconds since the NTP epoch.
+ * @note This must be called while holding @c clockManager->mutex.
+ */
+static AiaTimepointMs_t AiaClockManager_EstimateNtpMsLocked(
+    AiaClockManager_t* clockManager, AiaTimepointMs_t nowLocalMs );
+
+/**
+ * Updates the drift model with a new synchronization.
+ *
+ * @param clockManager The @c AiaClockManager_t to act on.
+ * @param nowLocalMs The local time of the synchronization.
+ * @param ntpMs The estimated milliseconds since the NTP epoch at @c
+ * nowLocalMs.
+ * @note This must be called while holding @c clockManager->mutex.
+ */
+static void AiaClockManager_UpdateDriftLocked( AiaClockManager_t* clockManager,
+                                               AiaTimepointMs_t nowLocalMs,
+                                               AiaTimepointMs_t ntpMs );
+
+/**
+ * Routine run by @c slewTimer which moves the device clock to the estimate of
+ * the drift model.
+ *
+ * @param userData The @c AiaClockManager_t to act on.
+ */
+static void AiaClockManager_SlewRoutine( void* userData );
+
+static AiaTimepointMs_t AiaClockManager_EstimateNtpMsLocked(
+    AiaClockManager_t* clockManager, AiaTimepointMs_t nowLocalMs )
+{
+    int64_t elapsedMs = (int64_t)( nowLocalMs - clockManager->anchorLocalMs );
+    return clockManager->anchorNtpMs + elapsedMs +
+           elapsedMs * clockManager->driftPpm / AIA_CLOCK_MANAGER_PPM;
+}
+
+static void AiaClockManager_UpdateDriftLocked( AiaClockManager_t* clockManager,
+                                               AiaTimepointMs_t nowLocalMs,
+                                               AiaTimepointMs_t ntpMs )
+{
+    if( !clockManager->synchronized )
+    {
+        clockManager->baselineLocalMs = nowLocalMs;
+        clockManager->baselineNtpMs = ntpMs;
+        return;
+    }
+
+    int64_t localElapsedMs =
+        (int64_t)( nowLocalMs - clockManager->baselineLocalMs );
+    if( localElapsedMs < AIA_CLOCK_MANAGER_MIN_DRIFT_BASELINE_MS )
+    {
+        return;
+    }
+    int64_t ntpElapsedMs = (int64_t)( ntpMs - clockManager->baselineNtpMs );
+    int64_t driftPpm = ( ntpElapsedMs - localElapsedMs ) *
+                       AIA_CLOCK_MANAGER_PPM / localElapsedMs;
+    clockManager->baselineLocalMs = nowLocalMs;
+    clockManager->baselineNtpMs = ntpMs;
+    if( driftPpm > AIA_CLOCK_MANAGER_MAX_DRIFT_PPM ||
+        driftPpm < -AIA_CLOCK_MANAGER_MAX_DRIFT_PPM )
+    {
+        AiaLogWarn( "Server clock stepped, discarding drift, driftPpm=%" PRId64,
+                    driftPpm );
+        clockManager->driftPpm = 0;
+        return;
+    }
+
+    /* Average with the previous measurement to smooth out delay jitter. */
+    clockManager->driftPpm =
+        clockManager->driftPpm
+            ? (int32_t)( ( clockManager->driftPpm + driftPpm ) / 2 )
+            : (int32_t)driftPpm;
+    AiaLogInfo( "Clock drift measured, driftPpm=%" PRId32,
+                clockManager->driftPpm );
+}
+
+static void AiaClockManager_SlewRoutine( void* userData )
+{
+    AiaClockManager_t* clockManager = (AiaClockManager_t*)userData;
+    AiaAssert( clockManager );
+    if( !clockManager )
+    {
+        AiaLogError( "Null clockManager." );
+        return;
+    }
+
+    AiaMutex( Lock )( &clockManager->mutex );
+    AiaTimepointMs_t ntpMs = AiaClockManager_EstimateNtpMsLocked(
+        clockManager, AiaClock( GetTimeMs )() );
+    AiaMutex( Unlock )( &clockManager->mutex );
+    AiaClock_SetTimeSinceNTPEpoch( ntpMs / AIA_MS_PER_SECOND );
+}
+
 AiaClockManager_t* AiaClockManager_Create(
     AiaRegulator_t* eventRegulator,
     AiaClockSynchronizedCallback_t notifyObserverCb,
@@ -73,6 +237,20 @@ AiaClockManager_t* AiaClockManager_Create(
                      sizeof( AiaClockManager_t ) );
         return NULL;
     }
+    if( !AiaMutex( Create )( &clockManager->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( clockManager );
+        return NULL;
+    }
+    if( !AiaTimer( Create )( &clockManager->slewTimer,
+                             AiaClockManager_SlewRoutine, clockManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &clockManager->mutex );
+        AiaFree( clockManager );
+        return NULL;
+    }
 
     *(AiaRegulator_t**)&clockManager->eventRegulator = eventRegulator;
     *(AiaClockSynchronizedCallback_t*)&clockManager->notifyObserverCb =
@@ -89,6 +267,8 @@ void AiaClockManager_Destroy( AiaClockManager_t* clockManager )
         AiaLogDebug( "Null clockManager." );
         return;
     }
+    AiaTimer( Destroy )( &clockManager->slewTimer );
+    AiaMutex( Destroy )( &clockManager->mutex );
     AiaFree( clockManager );
 }
 
@@ -108,6 +288,13 @@ bool AiaClockManager_SynchronizeClock( AiaClockManager_t* clockManager )
         AiaLogError( "AiaJsonMessage_Create failed" );
         return false;
     }
+
+    /* Time the round trip from here so that the delay of the reply can be
+     * estimated. */
+    AiaMutex( Lock )( &clockManager->mutex );
+    clockManager->requestPending = true;
+    clockManager->requestLocalMs = AiaClock( GetTimeMs )();
+    AiaMutex( Unlock )( &clockManager->mutex );
     if( !AiaRegulator_Write(
             clockManager->eventRegulator,
             AiaJsonMessage_ToMessage( synchronizeClockEvent ) ) )
@@ -163,12 +350,48 @@ void AiaClockManager_OnSetClockDirectiveReceived(
 
     AiaLogInfo( "SetClock received, seconds since NTP epoch=%" PRIu64,
                 currentTimeInSeconds );
-    AiaClock_SetTimeSinceNTPEpoch( currentTimeInSeconds );
+
+    /* The service sends whole seconds, so assume the middle of the second on
+     * average, and add half the round trip if this replies to our request. */
+    AiaTimepointMs_t nowLocalMs = AiaClock( GetTimeMs )();
+    AiaTimepointMs_t ntpMs =
+        currentTimeInSeconds * AIA_MS_PER_SECOND + AIA_MS_PER_SECOND / 2;
+    AiaMutex( Lock )( &clockManager->mutex );
+    AiaTimepointMs_t roundTripMs = nowLocalMs - clockManager->requestLocalMs;
+    if( clockManager->requestPending &&
+        roundTripMs <= AIA_CLOCK_MANAGER_MAX_ROUND_TRIP_MS )
+    {
+        ntpMs += roundTripMs / 2;
+    }
+    clockManager->requestPending = false;
+    AiaClockManager_UpdateDriftLocked( clockManager, nowLocalMs, ntpMs );
+    clockManager->synchronized = true;
+    clockManager->anchorLocalMs = nowLocalMs;
+    clockManager->anchorNtpMs = ntpMs;
+    int32_t driftPpm = clockManager->driftPpm;
+    AiaMutex( Unlock )( &clockManager->mutex );
+
+    AiaTimepointSeconds_t secondsSinceNTPEpoch = ntpMs / AIA_MS_PER_SECOND;
+    AiaClock_SetTimeSinceNTPEpoch( secondsSinceNTPEpoch );
+
+    /* Step the device clock by a second each time the drift adds up to one,
+     * so that it stays accurate without further SynchronizeClock events. */
+    if( driftPpm )
+    {
+        uint32_t absDriftPpm = driftPpm < 0 ? -driftPpm : driftPpm;
+        uint32_t slewPeriodMs = (uint64_t)AIA_CLOCK_MANAGER_SLEW_STEP_MS *
+                                AIA_CLOCK_MANAGER_PPM / absDriftPpm;
+        if( !AiaTimer( Arm )( &clockManager->slewTimer, slewPeriodMs,
+                              slewPeriodMs ) )
+        {
+            AiaLogError( "AiaTimer( Arm ) failed" );
+        }
+    }
 
     /* Notify the observers */
     if( clockManager->notifyObserverCb )
     {
         clockManager->notifyObserverCb( clockManager->notifyObserverCbUserData,
-                                        currentTimeInSeconds );
+                                        secondsSinceNTPEpoch );
     }
 }
@@ -24,12 +24,13 @@
 
 #include <aiaconnectionmanager/aia_connection_manager.h>
 #include <aiacore/aia_backoff.h>
-#include <aiacore/aia_json_message.h>
+#include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_topic.h>
 
 #include <errno.h>
 #include <inttypes.h>
+#include <stdarg.h>
 #include <stdio.h>
 
 /** Private data for the @c AiaConnectionManager_t type. */
@@ -63,6 +64,23 @@ struct AiaConnectionManager
     /** User data to pass to @c onMqttMessageReceived */
     void* onMqttMessageReceivedUserData;
 
+    /** Handlers set by @c AiaConnectionManager_SetTopicHandler(), indexed by
+     * topic. Topics without one are handled by @c onMqttMessageReceived. */
+    AiaMqttTopicHandler_t topicHandlers[ AIA_NUM_TOPICS ];
+
+    /** User data to pass to @c topicHandlers, indexed by topic. */
+    void* topicHandlersUserData[ AIA_NUM_TOPICS ];
+
+#ifdef AIA_ENABLE_MQTT_MUX
+    /** The mux set by @c AiaConnectionManager_SetMqttMux(), or @c NULL if the
+     * connection is not shared. */
+    AiaMqttMux_t* mqttMux;
+
+    /** The length of the device topic root which prefixes each of @c
+     * topicsToSubscribe. */
+    size_t deviceTopicRootLength;
+#endif
+
     /** Taskpool used to schedule jobs for waiting for acknowledgement and
      * backoffs */
     AiaTaskPool_t taskPool;
@@ -70,13 +88,25 @@ struct AiaConnectionManager
     /** Indicates whether the client is connected. */
     AiaAtomicBool_t isConnected;
 
-    /** An atomic number representing the number of times client has attempted
-     * to connect without getting an acknowledgement. */
-    uint32_t retryNum;
+    /** An atomic number holding the backoff, in milliseconds, scheduled after
+     * the last unacknowledged Connect attempt, or @c 0 if there was none. */
+    uint32_t previousBackoff;
+
+    /** An atomic number holding the minimum time, in milliseconds, the service
+     * asked the client to wait before its next Connect attempt. */
+    uint32_t retryAfter;
+
+    /** Counters reported by @c AiaConnectionManager_GetMetrics(). These should
+     * only be accessed using atomic operations. */
+    AiaConnectionManagerMetrics_t metrics;
 
     /** The full topic paths to subscribe to. */
     char** topicsToSubscribe;
 
+    /** An atomic bitmask with bit @c i set while @c topicsToSubscribe[ i ] is
+     * subscribed to on @c mqttConnection. */
+    uint32_t subscribedTopics;
+
     /** The full topic path to send connection messages to. */
     char* connectionTopic;
 };
@@ -92,30 +122,51 @@ extern inline bool AiaMqttUnsubscribe( AiaMqttConnectionPointer_t connection,
                                        void* userData );
 
 /** Pre-defined IoT topics */
-#define AIA_TOPIC_STRING( TOPIC ) AIA_TOPIC_##TOPIC##_STRING
-
-static const char* g_topicsToSubscribe[] = {
-    AIA_TOPIC_STRING( DIRECTIVE ), AIA_TOPIC_STRING( SPEAKER ),
-    AIA_TOPIC_STRING( CAPABILITIES_ACKNOWLEDGE ),
-    AIA_TOPIC_STRING( CONNECTION_FROM_SERVICE )
+static const AiaTopic_t g_topicsToSubscribe[] = {
+    AIA_TOPIC_DIRECTIVE, AIA_TOPIC_SPEAKER, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
+    AIA_TOPIC_CONNECTION_FROM_SERVICE
 };
 
 /* clang-format off */
-#define CONNECTION_MANAGER_CONNECT_PAYLOAD_FORMAT                                \
+#define CONNECTION_MANAGER_MESSAGE_HEADER( NAME )                                \
     "{"                                                                          \
-        "\"" AIA_CONNECTION_CONNECT_AWS_ACCOUNT_ID_KEY "\":\"%s\""               \
-        ",\"" AIA_CONNECTION_CONNECT_CLIENT_ID_KEY "\":\"%s\""                   \
+        "\"" AIA_JSON_CONSTANTS_HEADER_KEY "\":"                                 \
+        "{"                                                                      \
+            "\"" AIA_JSON_CONSTANTS_NAME_KEY "\":\"" NAME "\""                   \
+            ",\"" AIA_JSON_CONSTANTS_MESSAGE_ID_KEY "\":\"%s\""                  \
+        "}"                                                                      \
+        ",\"" AIA_JSON_CONSTANTS_PAYLOAD_KEY "\":"
+
+#define CONNECTION_MANAGER_CONNECT_MESSAGE_FORMAT                                \
+    CONNECTION_MANAGER_MESSAGE_HEADER( AIA_CONNECTION_CONNECT_NAME )             \
+        "{"                                                                      \
+            "\"" AIA_CONNECTION_CONNECT_AWS_ACCOUNT_ID_KEY "\":\"%s\""           \
+            ",\"" AIA_CONNECTION_CONNECT_CLIENT_ID_KEY "\":\"%s\""               \
+        "}"                                                                      \
     "}"
 
-#define CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_START                       \
-    "{"                                                                          \
-        "\"" AIA_CONNECTION_DISCONNECT_CODE_KEY "\":\"%s\""
-#define CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_DESCRIPTION                 \
-        ",\"" AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY "\":\"%s\""
-#define CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_END                         \
+#define CONNECTION_MANAGER_DISCONNECT_MESSAGE_FORMAT                             \
+    CONNECTION_MANAGER_MESSAGE_HEADER( AIA_CONNECTION_DISCONNECT_NAME )          \
+        "{"                                                                      \
+            "\"" AIA_CONNECTION_DISCONNECT_CODE_KEY "\":\"%s\""                  \
+        "}"                                                                      \
+    "}"
+
+#define CONNECTION_MANAGER_DISCONNECT_DESCRIPTION_MESSAGE_FORMAT                 \
+    CONNECTION_MANAGER_MESSAGE_HEADER( AIA_CONNECTION_DISCONNECT_NAME )          \
+        "{"                                                                      \
+            "\"" AIA_CONNECTION_DISCONNECT_CODE_KEY "\":\"%s\""                  \
+            ",\"" AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY "\":\"%s\""          \
+        "}"                                                                      \
     "}"
 /* clang-format on */
 
+/**
+ * Size of the message IDs generated for connection messages, including the
+ * null-term.  This matches the IDs generated by @c AiaJsonMessage_Create().
+ */
+#define CONNECTION_MANAGER_MESSAGE_ID_SIZE 9
+
 static AiaTaskPoolJobStorage_t aiaConnectionManagerAcknowledgeJobStorage =
     AiaTaskPool( JOB_STORAGE_INITIALIZER );
 static AiaTaskPoolJob_t aiaConnectionManagerAcknowledgeJob =
@@ -128,6 +179,16 @@ static AiaTaskPoolJob_t aiaConnectionManagerBackoffJob =
 
 #define CONNECTION_ACKNOWLEDGE_WAIT_MILLISECONDS 10000
 #define CONNECTION_MAX_BACKOFF_MILLISECONDS 3600000
+#define CONNECTION_BASE_BACKOFF_MILLISECONDS 1000
+
+/** Upper bound of the per-device delay added to a service-directed wait. */
+#define CONNECTION_MAX_DEVICE_SPREAD_MILLISECONDS 10000
+
+/** Time to wait before reconnecting after the service goes offline. */
+#define CONNECTION_GOING_OFFLINE_RETRY_AFTER_MILLISECONDS 30000
+
+/** Time to wait before reconnecting after the service fails a Connect. */
+#define CONNECTION_UNKNOWN_FAILURE_RETRY_AFTER_MILLISECONDS 5000
 
 /**
  * Converts a char array representing a Disconnect message code to its
@@ -166,142 +227,128 @@ static AiaConnectionOnDisconnectCode_t CharArrayToOnDisconnectedCode(
 }
 
 /**
- * Builds the JSON text payload for a Connect message.
- * If @c NULL is passed for @c payloadBuffer, this function will calculate
- * the length of the generated JSON payload (including the trailing @c
- * '\0').
+ * Formats a connection message on the stack and publishes it to the
+ * connection/fromclient topic.  Connection messages have a fixed layout, so
+ * they are formatted in a single pass straight into the publish buffer rather
+ * than being assembled through a heap-allocated @c AiaJsonMessage_t. This keeps
+ * the cost of a handshake independent of the state of the heap.
  *
- * @param[out] payloadBuffer A user-provided buffer large enough to hold the
- * payload text.
- * @param payloadBufferSize The size (in bytes) of @c payloadBuffer.
- * @param awsAccountId The AWS Account Id for the payload.
- * @param iotClientId The IoT Client Id for the payload.
- * @return The size (in bytes) of the generated text or zero if there was an
- * error.
+ * @param mqttConnection Pointer to the active MQTT connection.
+ * @param connectionTopic The connection topic to send the message to.
+ * @param format One of the @c CONNECTION_MANAGER_*_MESSAGE_FORMAT strings.
+ * @param ... The values to format, starting with the message ID.
+ * @return @c true if connection message is successfully published, @c false
+ * otherwise.
  */
-static size_t BuildAiaConnectMessagePayload( char* payloadBuffer,
-                                             size_t payloadBufferSize,
-                                             const char* awsAccountId,
-                                             const char* iotClientId )
+static bool SendConnectionMessage( AiaMqttConnectionPointer_t mqttConnection,
+                                   const char* connectionTopic,
+                                   const char* format, ... )
 {
-    if( !awsAccountId )
-    {
-        AiaLogError( "Null awsAccountId." );
-        return 0;
-    }
-    if( !iotClientId )
+    va_list args;
+    va_start( args, format );
+    va_list sizeArgs;
+    va_copy( sizeArgs, args );
+    int result = vsnprintf( NULL, 0, format, sizeArgs );
+    va_end( sizeArgs );
+    if( result <= 0 )
     {
-        AiaLogError( "Null iotClientId." );
-        return 0;
+        AiaLogError( "vsnprintf failed: %d", result );
+        va_end( args );
+        return false;
     }
 
-    int result = 0;
-    result = snprintf( payloadBuffer, payloadBufferSize,
-                       CONNECTION_MANAGER_CONNECT_PAYLOAD_FORMAT, awsAccountId,
-                       iotClientId );
-
-    if( result <= 0 )
+    size_t messageLength = (size_t)result;
+    char messageBuffer[ messageLength + 1 ];
+    result = vsnprintf( messageBuffer, sizeof( messageBuffer ), format, args );
+    va_end( args );
+    if( result < 0 || (size_t)result != messageLength )
     {
-        AiaLogError( "snprintf failed: %d", result );
-        return 0;
+        AiaLogError( "vsnprintf failed: %d", result );
+        return false;
     }
-    if( payloadBuffer )
+
+    /* The trailing '\0' is not part of the message. */
+    if( !AiaMqttPublish( mqttConnection, IOT_MQTT_QOS_0, connectionTopic, 0,
+                         messageBuffer, messageLength ) )
     {
-        AiaLogInfo( "Connect payload built: %s", payloadBuffer );
+        AiaLogError( "Failed to publish message. Message: %s", messageBuffer );
+        return false;
     }
-    return (size_t)result + 1;
+
+    AiaLogDebug( "Message sent. Message: %s", messageBuffer );
+    return true;
 }
 
 /**
- * Builds the JSON text payload for a Disconnect message.
- * If @c NULL is passed for @c payloadBuffer, this function will calculate
- * the length of the generated JSON payload (including the trailing @c
- * '\0').
+ * Indexes the payload of a message received on the connection/fromservice
+ * topic.  The members of the message are indexed once, and its payload member,
+ * if there is one, is indexed in place, so that each of the payload's fields
+ * can be looked up without rescanning the message or allocating.
  *
- * @param[out] payloadBuffer A user-provided buffer large enough to hold the
- * payload text.
- * @param payloadBufferSize The size (in bytes) of @c payloadBuffer.
- * @param code The Disconnect code for the payload.
- * @param description The optional description in the payload. If no
- * description pass NULL instead.
+ * @param[out] payloadObject The table to fill with the payload's members.
+ * @param message The received message, or a bare payload object.
+ * @param size The length of @c message.
+ * @return @c true if the payload was indexed, else @c false.
  */
-static size_t BuildAiaDisconnectMessagePayload( char* payloadBuffer,
-                                                size_t payloadBufferSize,
-                                                const char* code,
-                                                const char* description )
+static bool ParseConnectionPayload( AiaJsonObject_t* payloadObject,
+                                    const char* message, size_t size )
 {
-    if( !code )
+    if( !AiaJsonObject_Parse( payloadObject, message, size ) )
     {
-        AiaLogError( "Null code." );
-        return 0;
-    }
-
-    int result = 0;
-    if( description )
-    {
-        result = snprintf(
-            payloadBuffer, payloadBufferSize,
-            CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_START
-                CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_DESCRIPTION
-                    CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_END,
-            code, description );
-    }
-    else
-    {
-        result = snprintf( payloadBuffer, payloadBufferSize,
-                           CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_START
-                               CONNECTION_MANAGER_DISCONNECT_PAYLOAD_FORMAT_END,
-                           code );
+        AiaLogError( "Malformed JSON" );
+        return false;
     }
 
-    if( result <= 0 )
+    const char* payload;
+    size_t payloadLength;
+    if( !AiaJsonObject_FindValue( payloadObject, AIA_JSON_CONSTANTS_PAYLOAD_KEY,
+                                  sizeof( AIA_JSON_CONSTANTS_PAYLOAD_KEY ) - 1,
+                                  &payload, &payloadLength ) )
     {
-        AiaLogError( "snprintf failed: %d", result );
-        return 0;
+        /* Already a bare payload. */
+        return true;
     }
-    if( payloadBuffer )
+    if( !AiaJsonObject_Parse( payloadObject, payload, payloadLength ) )
     {
-        AiaLogInfo( "Disconnect payload built: %s", payloadBuffer );
+        AiaLogError( "Malformed JSON payload" );
+        return false;
     }
-    return (size_t)result + 1;
+    return true;
 }
 
 /**
- * Sends a Connection message to the connection/fromclient topic
+ * Unsubscribes from the pre-defined topics which are subscribed to.
  *
- * @param jsonMessage The message to send.
- * @param mqttConnection Pointer to the active MQTT connection.
- * @param connectionTopic The connection topic to send the message to.
- * @return @c true if connection message is successfully published, @c false
- * otherwise.
+ * @param connectionManager The connection manager to act on.
+ * @return @c true if successful, else @c false.
  */
-static bool SendConnectionMessage( AiaJsonMessage_t* jsonMessage,
-                                   AiaMqttConnectionPointer_t mqttConnection,
-                                   const char* connectionTopic )
+static bool UnsubscribeTopics( AiaConnectionManager_t* connectionManager )
 {
-    size_t messageBufferSize =
-        AiaMessage_GetSize( AiaJsonMessage_ToConstMessage( jsonMessage ) );
-    char messageBuffer[ messageBufferSize ];
-
-    if( AiaJsonMessage_BuildMessage( jsonMessage, messageBuffer,
-                                     messageBufferSize ) )
+    for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
     {
-        if( !AiaMqttPublish( mqttConnection, IOT_MQTT_QOS_0, connectionTopic, 0,
-                             messageBuffer, sizeof( messageBuffer ) ) )
+        uint32_t subscribedTopics =
+            AiaAtomic_Load_u32( &connectionManager->subscribedTopics );
+        if( !( subscribedTopics & ( (uint32_t)1 << i ) ) )
+        {
+            continue;
+        }
+        if( !AiaMqttUnsubscribe(
+                connectionManager->mqttConnection, IOT_MQTT_QOS_0,
+                connectionManager->topicsToSubscribe[ i ], NULL, NULL ) )
         {
-            AiaLogError( "Failed to publish message. Message: %s",
-                         messageBuffer );
+            AiaLogError( "Unsubscription request from the \"%s\" topic failed.",
+                         connectionManager->topicsToSubscribe[ i ] );
             return false;
         }
-
-        AiaLogDebug( "Message sent. Message: %s", messageBuffer );
-        return true;
-    }
-    else
-    {
-        AiaLogError( "AiaJsonMessage_BuildMessage failed." );
-        return false;
+        else
+        {
+            AiaLogInfo( "Successfully unsubscribed from the \"%s\" topic.",
+                        connectionManager->topicsToSubscribe[ i ] );
+            AiaAtomic_Store_u32( &connectionManager->subscribedTopics,
+                                 subscribedTopics & ~( (uint32_t)1 << i ) );
+        }
     }
+    return true;
 }
 
 /**
@@ -320,9 +367,84 @@ static void ConnectionBackoffTimeoutRoutine( AiaTaskPool_t taskPool,
         (AiaConnectionManager_t*)context;
     AiaAssert( connectionManager );
 
+    AiaAtomic_Add_u32( &connectionManager->metrics.reconnectAttempts, 1 );
     AiaConnectionManager_Connect( connectionManager );
 }
 
+/**
+ * Schedules aiaConnectionManagerBackoffJob to send a new Connect message.
+ *
+ * @param connectionManager The connection manager to connect.
+ * @param backoff The time in milliseconds to wait before connecting.
+ * @return @c true if the job was scheduled, else @c false.
+ */
+static bool ScheduleConnectBackoff( AiaConnectionManager_t* connectionManager,
+                                    AiaDurationMs_t backoff )
+{
+    AiaTaskPoolError_t taskPoolError = AiaTaskPool( CreateJob )(
+        ConnectionBackoffTimeoutRoutine, connectionManager,
+        &aiaConnectionManagerBackoffJobStorage,
+        &aiaConnectionManagerBackoffJob );
+    AiaAssert( AiaTaskPoolSucceeded( taskPoolError ) );
+
+    taskPoolError = AiaTaskPool( ScheduleDeferred )(
+        connectionManager->taskPool, aiaConnectionManagerBackoffJob, backoff );
+
+    if( AiaTaskPoolSucceeded( taskPoolError ) )
+    {
+        AiaLogInfo( "Connect backoff job scheduled in %" PRIu32 " ms.",
+                    backoff );
+        return true;
+    }
+    else
+    {
+        AiaLogError( "Failed to schedule connect backoff job, error %s.",
+                     AiaTaskPool( strerror )( taskPoolError ) );
+        return false;
+    }
+}
+
+/**
+ * Clears the wait requested by the service and returns it, followed by this
+ * device's share of the spread. The spread keeps devices that were told to
+ * wait at the same time from reconnecting at the same time.
+ *
+ * @param connectionManager The connection manager to take the wait from.
+ * @return The time in milliseconds to wait before the next Connect attempt,
+ * or @c 0 if the service asked for no wait.
+ */
+static AiaDurationMs_t TakeRetryAfter(
+    AiaConnectionManager_t* connectionManager )
+{
+    uint32_t retryAfter;
+    do
+    {
+        retryAfter = AiaAtomic_Load_u32( &connectionManager->retryAfter );
+    } while( !AiaAtomic_CompareAndSwap_u32( &connectionManager->retryAfter,
+                                            0, retryAfter ) );
+    if( !retryAfter )
+    {
+        return 0;
+    }
+
+    size_t iotClientIdLen;
+    if( !AiaGetIotClientId( NULL, &iotClientIdLen ) )
+    {
+        AiaLogWarn( "AiaGetIotClientId failed, skipping device spread." );
+        return retryAfter;
+    }
+    char iotClientId[ iotClientIdLen ];
+    if( !AiaGetIotClientId( iotClientId, &iotClientIdLen ) )
+    {
+        AiaLogWarn( "AiaGetIotClientId failed, skipping device spread." );
+        return retryAfter;
+    }
+    return retryAfter +
+           AiaBackoff_GetSpreadMilliseconds(
+               iotClientId, iotClientIdLen,
+               CONNECTION_MAX_DEVICE_SPREAD_MILLISECONDS );
+}
+
 /**
  * Callback routine of aiaConnectionManagerAcknowledgeJob for the global @c
  * AiaTaskPool_t.
@@ -350,31 +472,20 @@ static void ConnectionAckTimeoutRoutine( AiaTaskPool_t taskPool,
     }
 
     /* Calculate backoff time before sending another Connect message */
-    uint32_t backoff = AiaBackoff_GetBackoffTimeMilliseconds(
-        AiaAtomic_Load_u32( &connectionManager->retryNum ),
+    AiaDurationMs_t backoff = AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+        AiaAtomic_Load_u32( &connectionManager->previousBackoff ),
+        CONNECTION_BASE_BACKOFF_MILLISECONDS,
         CONNECTION_MAX_BACKOFF_MILLISECONDS );
+    AiaAtomic_Store_u32( &connectionManager->previousBackoff, backoff );
 
-    /* Create and schedule job to send a new Connect message after the calculate
-     * backoff. */
-    AiaTaskPoolError_t taskPoolError = AiaTaskPool( CreateJob )(
-        ConnectionBackoffTimeoutRoutine, connectionManager,
-        &aiaConnectionManagerBackoffJobStorage,
-        &aiaConnectionManagerBackoffJob );
-    AiaAssert( AiaTaskPoolSucceeded( taskPoolError ) );
-
-    taskPoolError = AiaTaskPool( ScheduleDeferred )(
-        connectionManager->taskPool, aiaConnectionManagerBackoffJob, backoff );
-
-    if( AiaTaskPoolSucceeded( taskPoolError ) )
+    /* Never retry sooner than the service asked for. */
+    AiaDurationMs_t retryAfter = TakeRetryAfter( connectionManager );
+    if( retryAfter > backoff )
     {
-        AiaLogInfo( "Connect backoff job scheduled in %" PRIu32 " ms.",
-                    backoff );
-    }
-    else
-    {
-        AiaLogError( "Failed to schedule connect backoff job, error %s.",
-                     AiaTaskPool( strerror )( taskPoolError ) );
+        backoff = retryAfter;
     }
+
+    ScheduleConnectBackoff( connectionManager, backoff );
 }
 
 AiaConnectionManager_t* AiaConnectionManager_Create(
@@ -478,7 +589,7 @@ AiaConnectionManager_t* AiaConnectionManager_Create(
 
     for( size_t i = 0; i < numTopicsToSubscribe; ++i )
     {
-        size_t topicLength = strlen( g_topicsToSubscribe[ i ] );
+        size_t topicLength = AiaTopic_GetLength( g_topicsToSubscribe[ i ] );
         size_t fullTopicPathSize = deviceTopicRootSize + topicLength + 1;
         connectionManager->topicsToSubscribe[ i ] =
             AiaCalloc( 1, fullTopicPathSize );
@@ -498,7 +609,7 @@ AiaConnectionManager_t* AiaConnectionManager_Create(
                  deviceTopicRootSize );
         strncpy(
             connectionManager->topicsToSubscribe[ i ] + deviceTopicRootSize,
-            g_topicsToSubscribe[ i ], topicLength );
+            AiaTopic_ToString( g_topicsToSubscribe[ i ] ), topicLength );
         memcpy( connectionManager->topicsToSubscribe[ i ] +
                     deviceTopicRootSize + topicLength,
                 "\0", 1 );
@@ -518,11 +629,108 @@ AiaConnectionManager_t* AiaConnectionManager_Create(
     connectionManager->onMqttMessageReceivedUserData =
         onMqttMessageReceivedUserData;
     connectionManager->taskPool = taskPool;
-    AiaAtomic_Store_u32( &connectionManager->retryNum, 0 );
+#ifdef AIA_ENABLE_MQTT_MUX
+    connectionManager->deviceTopicRootLength = deviceTopicRootSize;
+#endif
+    AiaAtomic_Store_u32( &connectionManager->previousBackoff, 0 );
+    AiaAtomic_Store_u32( &connectionManager->retryAfter, 0 );
 
     return connectionManager;
 }
 
+bool AiaConnectionManager_SetTopicHandler(
+    AiaConnectionManager_t* connectionManager, AiaTopic_t topic,
+    AiaMqttTopicHandler_t handler, void* userData )
+{
+    if( !connectionManager )
+    {
+        AiaLogError( "Null connectionManager." );
+        return false;
+    }
+    for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
+    {
+        if( g_topicsToSubscribe[ i ] == topic )
+        {
+            connectionManager->topicHandlers[ topic ] = handler;
+            connectionManager->topicHandlersUserData[ topic ] = userData;
+            return true;
+        }
+    }
+    AiaLogError( "Topic %s is not subscribed to.", AiaTopic_ToString( topic ) );
+    return false;
+}
+
+#ifdef AIA_ENABLE_MQTT_MUX
+/**
+ * Passes a message routed by @c mqttMux on to the handler of its topic. This is
+ * the @c AiaMqttTopicHandler_t of the device topic root's route.
+ *
+ * @param userData The @c AiaConnectionManager_t the message is for.
+ * @param callbackParam The received message.
+ */
+static void OnMuxMessageReceived( void* userData,
+                                  AiaMqttCallbackParam_t* callbackParam )
+{
+    AiaConnectionManager_t* connectionManager =
+        (AiaConnectionManager_t*)userData;
+    AiaAssert( connectionManager );
+    const char* topic = callbackParam->u.message.info.pTopicName;
+    size_t topicLength = callbackParam->u.message.info.topicNameLength;
+
+    AiaMqttTopicHandler_t handler = connectionManager->onMqttMessageReceived;
+    void* handlerUserData = connectionManager->onMqttMessageReceivedUserData;
+    for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
+    {
+        const char* subscribedTopic = connectionManager->topicsToSubscribe[ i ];
+        if( strncmp( subscribedTopic, topic, topicLength ) ||
+            subscribedTopic[ topicLength ] != '\0' )
+        {
+            continue;
+        }
+        AiaTopic_t subscribed = g_topicsToSubscribe[ i ];
+        if( connectionManager->topicHandlers[ subscribed ] )
+        {
+            handler = connectionManager->topicHandlers[ subscribed ];
+            handlerUserData =
+                connectionManager->topicHandlersUserData[ subscribed ];
+        }
+        break;
+    }
+    handler( handlerUserData, callbackParam );
+}
+
+bool AiaConnectionManager_SetMqttMux( AiaConnectionManager_t* connectionManager,
+                                      AiaMqttMux_t* mqttMux )
+{
+    if( !connectionManager )
+    {
+        AiaLogError( "Null connectionManager." );
+        return false;
+    }
+    if( !mqttMux )
+    {
+        AiaLogError( "Null mqttMux." );
+        return false;
+    }
+    if( connectionManager->mqttMux )
+    {
+        AiaLogError( "mqttMux already set." );
+        return false;
+    }
+
+    if( !AiaMqttMux_AddRoute(
+            mqttMux, connectionManager->topicsToSubscribe[ 0 ],
+            connectionManager->deviceTopicRootLength, OnMuxMessageReceived,
+            connectionManager ) )
+    {
+        AiaLogError( "AiaMqttMux_AddRoute failed." );
+        return false;
+    }
+    connectionManager->mqttMux = mqttMux;
+    return true;
+}
+#endif
+
 bool AiaConnectionManager_Connect( AiaConnectionManager_t* connectionManager )
 {
     if( !connectionManager )
@@ -536,14 +744,45 @@ bool AiaConnectionManager_Connect( AiaConnectionManager_t* connectionManager )
         return false;
     }
 
-    /* Subscribe to the pre-defined topics before trying to connect */
+    /* Honor a wait requested by the service before reconnecting. */
+    AiaDurationMs_t retryAfter = TakeRetryAfter( connectionManager );
+    if( retryAfter )
+    {
+        return ScheduleConnectBackoff( connectionManager, retryAfter );
+    }
+
+    /* Subscribe to the pre-defined topics before trying to connect, skipping
+     * those which are still subscribed to from an earlier attempt. */
     for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
     {
-        if( !AiaMqttSubscribe(
-                connectionManager->mqttConnection, IOT_MQTT_QOS_0,
-                connectionManager->topicsToSubscribe[ i ],
-                connectionManager->onMqttMessageReceived,
-                connectionManager->onMqttMessageReceivedUserData ) )
+        uint32_t subscribedTopics =
+            AiaAtomic_Load_u32( &connectionManager->subscribedTopics );
+        if( subscribedTopics & ( (uint32_t)1 << i ) )
+        {
+            continue;
+        }
+        AiaTopic_t topic = g_topicsToSubscribe[ i ];
+        AiaMqttTopicHandler_t handler =
+            connectionManager->onMqttMessageReceived;
+        void* userData = connectionManager->onMqttMessageReceivedUserData;
+        if( connectionManager->topicHandlers[ topic ] )
+        {
+            handler = connectionManager->topicHandlers[ topic ];
+            userData = connectionManager->topicHandlersUserData[ topic ];
+        }
+#ifdef AIA_ENABLE_MQTT_MUX
+        /* Messages on a shared connection are routed by the mux, and then by
+         * OnMuxMessageReceived(). */
+        if( connectionManager->mqttMux )
+        {
+            handler = AiaMqttMux_MessageReceived;
+            userData = connectionManager->mqttMux;
+        }
+#endif
+        if( !AiaMqttSubscribe( connectionManager->mqttConnection,
+                               IOT_MQTT_QOS_0,
+                               connectionManager->topicsToSubscribe[ i ],
+                               handler, userData ) )
         {
             AiaLogError( "Subscription request to the \"%s\" topic failed.",
                          connectionManager->topicsToSubscribe[ i ] );
@@ -553,11 +792,13 @@ bool AiaConnectionManager_Connect( AiaConnectionManager_t* connectionManager )
         {
             AiaLogDebug( "Successfully subscribed to the \"%s\" topic.",
                          connectionManager->topicsToSubscribe[ i ] );
+            AiaAtomic_Store_u32( &connectionManager->subscribedTopics,
+                                 subscribedTopics | ( (uint32_t)1 << i ) );
+            AiaAtomic_Add_u32( &connectionManager->metrics.subscribeRequests,
+                               1 );
         }
     }
 
-    AiaAtomic_Add_u32( &connectionManager->retryNum, 1 );
-
     size_t iotClientIdLen;
     if( !AiaGetIotClientId( NULL, &iotClientIdLen ) )
     {
@@ -588,35 +829,22 @@ bool AiaConnectionManager_Connect( AiaConnectionManager_t* connectionManager )
         return false;
     }
 
-    size_t payloadBufferSize =
-        BuildAiaConnectMessagePayload( NULL, 0, awsAccountId, iotClientId );
-    if( !payloadBufferSize )
+    char messageId[ CONNECTION_MANAGER_MESSAGE_ID_SIZE ];
+    if( !AiaGenerateMessageId( messageId, sizeof( messageId ) ) )
     {
-        AiaLogError( "BuildAiaConnectMessagePayload get buffer size failed." );
+        AiaLogError( "Failed to generate message ID." );
         return false;
     }
 
-    char payloadBuffer[ payloadBufferSize ];
-    if( !BuildAiaConnectMessagePayload( payloadBuffer, payloadBufferSize,
-                                        awsAccountId, iotClientId ) )
-    {
-        AiaLogError( "BuildAiaConnectMessagePayload failed." );
-        return false;
-    }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_CONNECTION_CONNECT_NAME, NULL, payloadBuffer );
-
-    if( !SendConnectionMessage( jsonMessage, connectionManager->mqttConnection,
-                                connectionManager->connectionTopic ) )
+    if( !SendConnectionMessage( connectionManager->mqttConnection,
+                                connectionManager->connectionTopic,
+                                CONNECTION_MANAGER_CONNECT_MESSAGE_FORMAT,
+                                messageId, awsAccountId, iotClientId ) )
     {
         AiaLogError( "SendConnectionMessage failed" );
-        AiaJsonMessage_Destroy( jsonMessage );
         return false;
     }
 
-    AiaJsonMessage_Destroy( jsonMessage );
-
     /* Create and schedule job to check if Connect request has been acknowledged
      * within CONNECTION_ACKNOWLEDGE_WAIT_MILLISECONDS. */
     AiaTaskPoolError_t taskPoolError = AiaTaskPool( CreateJob )(
@@ -651,56 +879,55 @@ bool AiaConnectionManager_Disconnect( AiaConnectionManager_t* connectionManager,
         AiaLogError( "Null connectionManager." );
         return false;
     }
+    if( !code )
+    {
+        AiaLogError( "Null code." );
+        return false;
+    }
     if( !AiaAtomicBool_Load( &connectionManager->isConnected ) )
     {
         AiaLogInfo( "Already disconnected" );
         return false;
     }
 
+#ifndef AIA_ENABLE_PERSISTENT_MQTT_SUBSCRIPTIONS
     /* Unsubscribe from the pre-defined IoT topics before invoking the callback
      */
-    for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
+    if( !UnsubscribeTopics( connectionManager ) )
     {
-        if( !AiaMqttUnsubscribe(
-                connectionManager->mqttConnection, IOT_MQTT_QOS_0,
-                connectionManager->topicsToSubscribe[ i ], NULL, NULL ) )
-        {
-            AiaLogError( "Unsubscription request from the \"%s\" topic failed.",
-                         connectionManager->topicsToSubscribe[ i ] );
-            return false;
-        }
-        else
-        {
-            AiaLogInfo( "Successfully unsubscribed from the \"%s\" topic.",
-                        connectionManager->topicsToSubscribe[ i ] );
-        }
+        return false;
     }
+#endif
 
-    size_t payloadBufferSize =
-        BuildAiaDisconnectMessagePayload( NULL, 0, code, description );
-    if( !payloadBufferSize )
+    char messageId[ CONNECTION_MANAGER_MESSAGE_ID_SIZE ];
+    if( !AiaGenerateMessageId( messageId, sizeof( messageId ) ) )
     {
-        AiaLogError( "BuildAiaDisconnectMessagePayload failed." );
+        AiaLogError( "Failed to generate message ID." );
         return false;
     }
 
-    char payloadBuffer[ payloadBufferSize ];
-    BuildAiaDisconnectMessagePayload( payloadBuffer, payloadBufferSize, code,
-                                      description );
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_CONNECTION_DISCONNECT_NAME, NULL, payloadBuffer );
-
-    if( !SendConnectionMessage( jsonMessage, connectionManager->mqttConnection,
-                                connectionManager->connectionTopic ) )
+    bool sent;
+    if( description )
+    {
+        sent = SendConnectionMessage(
+            connectionManager->mqttConnection,
+            connectionManager->connectionTopic,
+            CONNECTION_MANAGER_DISCONNECT_DESCRIPTION_MESSAGE_FORMAT, messageId,
+            code, description );
+    }
+    else
+    {
+        sent = SendConnectionMessage(
+            connectionManager->mqttConnection,
+            connectionManager->connectionTopic,
+            CONNECTION_MANAGER_DISCONNECT_MESSAGE_FORMAT, messageId, code );
+    }
+    if( !sent )
     {
         AiaLogError( "SendConnectionMessage failed." );
-        AiaJsonMessage_Destroy( jsonMessage );
         return false;
     }
 
-    AiaJsonMessage_Destroy( jsonMessage );
-
     AiaConnectionOnDisconnectCode_t onDisconnectCode =
         CharArrayToOnDisconnectedCode( code, strlen( code ) );
     AiaAtomicBool_Clear( &connectionManager->isConnected );
@@ -725,11 +952,17 @@ void AiaConnectionManager_OnConnectionAcknowledgementReceived(
         return;
     }
 
+    AiaJsonObject_t payloadObject;
+    if( !ParseConnectionPayload( &payloadObject, payload, size ) )
+    {
+        return;
+    }
+
     const char* code;
     size_t codeLen;
-    if( !AiaFindJsonValue( payload, size, AIA_CONNECTION_ACK_CODE_KEY,
-                           strlen( AIA_CONNECTION_ACK_CODE_KEY ), &code,
-                           &codeLen ) )
+    if( !AiaJsonObject_FindValue(
+            &payloadObject, AIA_CONNECTION_ACK_CODE_KEY,
+            sizeof( AIA_CONNECTION_ACK_CODE_KEY ) - 1, &code, &codeLen ) )
     {
         AiaLogError( "No code json key found" );
         return;
@@ -742,9 +975,10 @@ void AiaConnectionManager_OnConnectionAcknowledgementReceived(
 
     const char* description;
     size_t descriptionLen = 0;
-    if( !AiaFindJsonValue( payload, size, AIA_CONNECTION_ACK_DESCRIPTION_KEY,
-                           strlen( AIA_CONNECTION_ACK_DESCRIPTION_KEY ),
-                           &description, &descriptionLen ) )
+    if( !AiaJsonObject_FindValue(
+            &payloadObject, AIA_CONNECTION_ACK_DESCRIPTION_KEY,
+            sizeof( AIA_CONNECTION_ACK_DESCRIPTION_KEY ) - 1, &description,
+            &descriptionLen ) )
     {
         AiaLogDebug( "No optional description key found" );
     }
@@ -759,7 +993,7 @@ void AiaConnectionManager_OnConnectionAcknowledgementReceived(
         AiaLogDebug( "Connected to Service. code: %.*s, description: %.*s",
                      codeLen, code, descriptionLen, description );
         AiaAtomicBool_Set( &connectionManager->isConnected );
-        AiaAtomic_Store_u32( &connectionManager->retryNum, 0 );
+        AiaAtomic_Store_u32( &connectionManager->previousBackoff, 0 );
 
         AiaTaskPoolError_t error = AiaTaskPool( TryCancel )(
             connectionManager->taskPool, aiaConnectionManagerAcknowledgeJob,
@@ -798,6 +1032,9 @@ void AiaConnectionManager_OnConnectionAcknowledgementReceived(
         {
             onConnectionRejectionCode =
                 AIA_CONNECTION_ON_CONNECTION_REJECTION_UNKNOWN_FAILURE;
+            AiaAtomic_Store_u32(
+                &connectionManager->retryAfter,
+                CONNECTION_UNKNOWN_FAILURE_RETRY_AFTER_MILLISECONDS );
         }
         else if( !strncmp( code, AIA_CONNECTION_ACK_API_VERSION_DEPRECATED,
                            codeLen ) )
@@ -843,11 +1080,18 @@ void AiaConnectionManager_OnConnectionDisconnectReceived(
         return;
     }
 
+    AiaJsonObject_t payloadObject;
+    if( !ParseConnectionPayload( &payloadObject, payload, size ) )
+    {
+        return;
+    }
+
     const char* code;
     size_t codeLen;
-    if( !AiaFindJsonValue( payload, size, AIA_CONNECTION_DISCONNECT_CODE_KEY,
-                           strlen( AIA_CONNECTION_DISCONNECT_CODE_KEY ), &code,
-                           &codeLen ) )
+    if( !AiaJsonObject_FindValue(
+            &payloadObject, AIA_CONNECTION_DISCONNECT_CODE_KEY,
+            sizeof( AIA_CONNECTION_DISCONNECT_CODE_KEY ) - 1, &code,
+            &codeLen ) )
     {
         AiaLogError( "No code json key found" );
         return;
@@ -860,10 +1104,10 @@ void AiaConnectionManager_OnConnectionDisconnectReceived(
 
     const char* description;
     size_t descriptionLen = 0;
-    if( !AiaFindJsonValue( payload, size,
-                           AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY,
-                           strlen( AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY ),
-                           &description, &descriptionLen ) )
+    if( !AiaJsonObject_FindValue(
+            &payloadObject, AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY,
+            sizeof( AIA_CONNECTION_DISCONNECT_DESCRIPTION_KEY ) - 1,
+            &description, &descriptionLen ) )
     {
         AiaLogInfo( "No optional description key found" );
     }
@@ -878,11 +1122,38 @@ void AiaConnectionManager_OnConnectionDisconnectReceived(
 
     AiaConnectionOnDisconnectCode_t onDisconnectCode =
         CharArrayToOnDisconnectedCode( code, codeLen );
+    if( onDisconnectCode == AIA_CONNECTION_ON_DISCONNECTED_GOING_OFFLINE )
+    {
+        AiaAtomic_Store_u32(
+            &connectionManager->retryAfter,
+            CONNECTION_GOING_OFFLINE_RETRY_AFTER_MILLISECONDS );
+    }
     AiaAtomicBool_Clear( &connectionManager->isConnected );
     connectionManager->onDisconnected(
         connectionManager->onDisconnectedUserData, onDisconnectCode );
 }
 
+void AiaConnectionManager_GetMetrics( AiaConnectionManager_t* connectionManager,
+                                      AiaConnectionManagerMetrics_t* metrics )
+{
+    AiaAssert( connectionManager );
+    if( !connectionManager )
+    {
+        AiaLogError( "Null connectionManager." );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics." );
+        return;
+    }
+    metrics->reconnectAttempts =
+        AiaAtomic_Load_u32( &connectionManager->metrics.reconnectAttempts );
+    metrics->subscribeRequests =
+        AiaAtomic_Load_u32( &connectionManager->metrics.subscribeRequests );
+}
+
 void AiaConnectionManager_Destroy( AiaConnectionManager_t* connectionManager )
 {
     if( !connectionManager )
@@ -914,6 +1185,24 @@ void AiaConnectionManager_Destroy( AiaConnectionManager_t* connectionManager )
         }
     }
 
+#ifdef AIA_ENABLE_PERSISTENT_MQTT_SUBSCRIPTIONS
+    /* The subscriptions outlive each connection, so they are only released
+     * here, before the handlers they call are destroyed. */
+    UnsubscribeTopics( connectionManager );
+#endif
+
+#ifdef AIA_ENABLE_MQTT_MUX
+    /* This waits for messages already being passed on to the handlers, which
+     * may be destroyed once this returns. */
+    if( connectionManager->mqttMux &&
+        !AiaMqttMux_RemoveRoute( connectionManager->mqttMux,
+                                 connectionManager->topicsToSubscribe[ 0 ],
+                                 connectionManager->deviceTopicRootLength ) )
+    {
+        AiaLogWarn( "AiaMqttMux_RemoveRoute failed." );
+    }
+#endif
+
     for( size_t i = 0; i < AiaArrayLength( g_topicsToSubscribe ); ++i )
     {
         AiaFree( connectionManager->topicsToSubscribe[ i ] );
@@ -0,0 +1,629 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_audio_features.c
+ * @brief Implements functions for the AiaAudioFeatures_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_audio_features.h>
+
+#include <float.h>
+#include <inttypes.h>
+#include <string.h>
+
+/** Pi, so that the tables can be computed without the math library. */
+#define AIA_AUDIO_FEATURES_PI 3.14159265358979323846
+
+/** The natural logarithm of 2. */
+#define AIA_AUDIO_FEATURES_LN2 0.69314718055994530942f
+
+/** The smallest mel energy, so that the logarithm of silence is finite. */
+#define AIA_AUDIO_FEATURES_ENERGY_FLOOR FLT_EPSILON
+
+/** The scale of the mel scale, in mels. */
+#define AIA_AUDIO_FEATURES_MEL_SCALE 1127.0f
+
+/** The frequency above which the mel scale is logarithmic, in Hz. */
+#define AIA_AUDIO_FEATURES_MEL_BREAK 700.0f
+
+/**
+ * Computes the sine of @c x. This is only used to compute the tables, so it
+ * favors not depending on the math library over speed.
+ *
+ * @param x The angle in radians.
+ * @return The sine of @c x.
+ */
+static double AiaAudioFeatures_Sine( double x )
+{
+    /* The Taylor series converges quickly once reduced to [-pi, pi]. */
+    double turns = x / ( 2.0 * AIA_AUDIO_FEATURES_PI );
+    x -= (double)(int64_t)( turns + ( turns < 0.0 ? -0.5 : 0.5 ) ) * 2.0 *
+         AIA_AUDIO_FEATURES_PI;
+    double term = x;
+    double sum = x;
+    for( int i = 1; i < 12; ++i )
+    {
+        term *= -x * x / ( ( 2.0 * i ) * ( 2.0 * i + 1.0 ) );
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Computes the cosine of @c x as the sine a quarter turn ahead.
+ *
+ * @param x The angle in radians.
+ * @return The cosine of @c x.
+ */
+static double AiaAudioFeatures_Cosine( double x )
+{
+    return AiaAudioFeatures_Sine( x + AIA_AUDIO_FEATURES_PI / 2.0 );
+}
+
+/**
+ * Computes the square root of @c x with Newton's method. This is only used to
+ * compute the tables.
+ *
+ * @param x A positive number no larger than a few hundred.
+ * @return The square root of @c x.
+ */
+static double AiaAudioFeatures_SquareRoot( double x )
+{
+    /* Starting above the root, the iterations decrease monotonically. */
+    double root = x > 1.0 ? x : 1.0;
+    for( int i = 0; i < 32; ++i )
+    {
+        root = 0.5 * ( root + x / root );
+    }
+    return root;
+}
+
+/**
+ * Computes the natural logarithm of @c x to within about 1e-6, without
+ * branches so that loops calling it can be vectorized.
+ *
+ * @param x A positive, normal number.
+ * @return The natural logarithm of @c x.
+ */
+static inline float AiaAudioFeatures_Log( float x )
+{
+    /* x = m * 2^e with m in [1, 2), and ln(m) = 2 * atanh((m - 1) / (m + 1)),
+     * whose series converges quickly as its argument is below 1/3. */
+    union
+    {
+        float f;
+        uint32_t u;
+    } bits = { x };
+    float exponent = (float)( (int32_t)( bits.u >> 23 ) - 127 );
+    bits.u = ( bits.u & 0x007FFFFF ) | 0x3F800000;
+    float t = ( bits.f - 1.0f ) / ( bits.f + 1.0f );
+    float t2 = t * t;
+    float series =
+        t * ( 2.0f +
+              t2 * ( 2.0f / 3.0f +
+                     t2 * ( 2.0f / 5.0f +
+                            t2 * ( 2.0f / 7.0f + t2 * ( 2.0f / 9.0f ) ) ) ) );
+    return exponent * AIA_AUDIO_FEATURES_LN2 + series;
+}
+
+/**
+ * Converts a frequency to the mel scale.
+ *
+ * @param frequency The frequency in Hz.
+ * @return The frequency in mels.
+ */
+static float AiaAudioFeatures_Mel( float frequency )
+{
+    return AIA_AUDIO_FEATURES_MEL_SCALE *
+           AiaAudioFeatures_Log( 1.0f +
+                                 frequency / AIA_AUDIO_FEATURES_MEL_BREAK );
+}
+
+/**
+ * Computes the periodic Hann window of @c features.
+ *
+ * @param features The front end to act on.
+ */
+static void AiaAudioFeatures_DesignWindow( AiaAudioFeatures_t* features )
+{
+    size_t frameLength = features->config.frameLength;
+    for( size_t i = 0; i < frameLength; ++i )
+    {
+        features->window[ i ] = (float)(
+            0.5 - 0.5 * AiaAudioFeatures_Cosine( 2.0 * AIA_AUDIO_FEATURES_PI *
+                                                 i / frameLength ) );
+    }
+}
+
+/**
+ * Computes the tables of the real FFT of @c features, which is computed as a
+ * complex FFT of half the size whose inputs are pairs of real samples.
+ *
+ * @param features The front end to act on.
+ */
+static void AiaAudioFeatures_DesignFft( AiaAudioFeatures_t* features )
+{
+    size_t fftSize = features->config.fftSize;
+    size_t half = fftSize / 2;
+    size_t numBits = 0;
+    while( ( (size_t)1 << numBits ) < half )
+    {
+        ++numBits;
+    }
+    for( size_t n = 0; n < half; ++n )
+    {
+        size_t reversed = 0;
+        for( size_t bit = 0; bit < numBits; ++bit )
+        {
+            reversed |= ( ( n >> bit ) & 1 ) << ( numBits - 1 - bit );
+        }
+        features->bitReversed[ n ] = (uint16_t)reversed;
+    }
+
+    /* The stage whose butterflies are span apart uses e^(-i pi j / span). */
+    for( size_t span = 1; span < half; span *= 2 )
+    {
+        for( size_t j = 0; j < span; ++j )
+        {
+            double angle = -AIA_AUDIO_FEATURES_PI * j / span;
+            features->twiddleReal[ span - 1 + j ] =
+                (float)AiaAudioFeatures_Cosine( angle );
+            features->twiddleImag[ span - 1 + j ] =
+                (float)AiaAudioFeatures_Sine( angle );
+        }
+    }
+
+    for( size_t k = 0; k <= half; ++k )
+    {
+        double angle = -2.0 * AIA_AUDIO_FEATURES_PI * k / fftSize;
+        features->splitReal[ k ] = (float)AiaAudioFeatures_Cosine( angle );
+        features->splitImag[ k ] = (float)AiaAudioFeatures_Sine( angle );
+    }
+}
+
+/**
+ * Computes the triangular mel filter bank of @c features. The bands are evenly
+ * spaced on the mel scale, and each spans from the center of the band below it
+ * to the center of the band above it.
+ *
+ * @param features The front end to act on.
+ * @return @c true if every band contains an FFT bin, else @c false.
+ */
+static bool AiaAudioFeatures_DesignFilterBank( AiaAudioFeatures_t* features )
+{
+    const AiaAudioFeaturesConfig_t* config = &features->config;
+    size_t numBins = config->fftSize / 2 + 1;
+
+    /* The power spectrum is not in use yet, so it holds the mel of each bin. */
+    float* binMels = features->power;
+    for( size_t bin = 0; bin < numBins; ++bin )
+    {
+        binMels[ bin ] = AiaAudioFeatures_Mel( (float)bin * config->sampleRate /
+                                               config->fftSize );
+    }
+
+    float melLow = AiaAudioFeatures_Mel( (float)config->lowFrequency );
+    float melHigh = AiaAudioFeatures_Mel( (float)config->highFrequency );
+    float melDelta = ( melHigh - melLow ) / ( config->numMelBands + 1 );
+    size_t offset = 0;
+    for( size_t band = 0; band < config->numMelBands; ++band )
+    {
+        /* Edges are computed the same way for every band, so that no bin can
+         * be in more than two bands. */
+        float left = melLow + band * melDelta;
+        float center = melLow + ( band + 1 ) * melDelta;
+        float right = melLow + ( band + 2 ) * melDelta;
+        size_t numBandBins = 0;
+        for( size_t bin = 0; bin < numBins; ++bin )
+        {
+            float mel = binMels[ bin ];
+            if( mel <= left || mel >= right )
+            {
+                continue;
+            }
+            if( !numBandBins )
+            {
+                features->melFirstBin[ band ] = (uint16_t)bin;
+            }
+            features->melWeights[ offset + numBandBins++ ] =
+                mel <= center ? ( mel - left ) / melDelta
+                              : ( right - mel ) / melDelta;
+        }
+        if( !numBandBins )
+        {
+            AiaLogError( "No FFT bins in mel band, band=%zu.", band );
+            return false;
+        }
+        features->melNumBins[ band ] = (uint16_t)numBandBins;
+        features->melOffset[ band ] = (uint16_t)offset;
+        offset += numBandBins;
+    }
+    return true;
+}
+
+/**
+ * Computes the orthonormal DCT-II of @c features.
+ *
+ * @param features The front end to act on.
+ */
+static void AiaAudioFeatures_DesignDct( AiaAudioFeatures_t* features )
+{
+    size_t numBands = features->config.numMelBands;
+    for( size_t c = 0; c < features->config.numCoefficients; ++c )
+    {
+        double scale =
+            AiaAudioFeatures_SquareRoot( ( c ? 2.0 : 1.0 ) / numBands );
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            features->dct[ c ][ band ] =
+                (float)( scale * AiaAudioFeatures_Cosine(
+                                     AIA_AUDIO_FEATURES_PI * c *
+                                     ( band + 0.5 ) / numBands ) );
+        }
+    }
+}
+
+/**
+ * Removes the DC offset of a frame, applies pre-emphasis and the window, and
+ * zero-pads it to the FFT size in @c features->frame.
+ *
+ * @param features The front end to act on.
+ * @param samples The samples of the frame.
+ */
+static void AiaAudioFeatures_Preprocess( AiaAudioFeatures_t* features,
+                                         const int16_t* restrict samples )
+{
+    size_t frameLength = features->config.frameLength;
+    float preEmphasis = features->config.preEmphasis;
+    const float* restrict window = features->window;
+    float* restrict frame = features->frame;
+
+    /* Frames are at most 512 samples, so the sum fits in 32 bits. */
+    int32_t sum = 0;
+    for( size_t i = 0; i < frameLength; ++i )
+    {
+        sum += samples[ i ];
+    }
+
+    /* Pre-emphasis scales the offset, which is removed from the result. */
+    float offset = ( 1.0f - preEmphasis ) * sum / frameLength;
+    frame[ 0 ] =
+        ( samples[ 0 ] - preEmphasis * samples[ 0 ] - offset ) * window[ 0 ];
+    for( size_t i = 1; i < frameLength; ++i )
+    {
+        float emphasized = samples[ i ] - preEmphasis * samples[ i - 1 ];
+        frame[ i ] = ( emphasized - offset ) * window[ i ];
+    }
+    memset( frame + frameLength, 0,
+            ( features->config.fftSize - frameLength ) * sizeof( float ) );
+}
+
+/**
+ * Computes the power spectrum of @c features->frame in @c features->power.
+ *
+ * @param features The front end to act on.
+ */
+static void AiaAudioFeatures_Transform( AiaAudioFeatures_t* features )
+{
+    size_t half = features->config.fftSize / 2;
+    const float* restrict frame = features->frame;
+    float* restrict real = features->real;
+    float* restrict imag = features->imag;
+
+    /* Even samples are the real parts and odd samples the imaginary parts. */
+    for( size_t n = 0; n < half; ++n )
+    {
+        size_t m = features->bitReversed[ n ];
+        real[ n ] = frame[ 2 * m ];
+        imag[ n ] = frame[ 2 * m + 1 ];
+    }
+
+    for( size_t span = 1; span < half; span *= 2 )
+    {
+        const float* restrict twiddleReal = features->twiddleReal + span - 1;
+        const float* restrict twiddleImag = features->twiddleImag + span - 1;
+        for( size_t start = 0; start < half; start += 2 * span )
+        {
+            float* restrict topReal = real + start;
+            float* restrict topImag = imag + start;
+            float* restrict bottomReal = real + start + span;
+            float* restrict bottomImag = imag + start + span;
+            for( size_t j = 0; j < span; ++j )
+            {
+                float tr = bottomReal[ j ] * twiddleReal[ j ] -
+                           bottomImag[ j ] * twiddleImag[ j ];
+                float ti = bottomReal[ j ] * twiddleImag[ j ] +
+                           bottomImag[ j ] * twiddleReal[ j ];
+                bottomReal[ j ] = topReal[ j ] - tr;
+                bottomImag[ j ] = topImag[ j ] - ti;
+                topReal[ j ] += tr;
+                topImag[ j ] += ti;
+            }
+        }
+    }
+
+    /* Split the transform of the pairs into the transforms of the even and odd
+     * samples, and combine those into the real FFT. Bins 0 and half only
+     * depend on the first output. */
+    float* restrict power = features->power;
+    const float* restrict splitReal = features->splitReal;
+    const float* restrict splitImag = features->splitImag;
+    power[ 0 ] = ( real[ 0 ] + imag[ 0 ] ) * ( real[ 0 ] + imag[ 0 ] );
+    power[ half ] = ( real[ 0 ] - imag[ 0 ] ) * ( real[ 0 ] - imag[ 0 ] );
+    for( size_t k = 1; k < half; ++k )
+    {
+        float evenReal = 0.5f * ( real[ k ] + real[ half - k ] );
+        float evenImag = 0.5f * ( imag[ k ] - imag[ half - k ] );
+        float oddReal = 0.5f * ( imag[ k ] + imag[ half - k ] );
+        float oddImag = 0.5f * ( real[ half - k ] - real[ k ] );
+        float xr = evenReal + splitReal[ k ] * oddReal -
+                   splitImag[ k ] * oddImag;
+        float xi = evenImag + splitReal[ k ] * oddImag +
+                   splitImag[ k ] * oddReal;
+        power[ k ] = xr * xr + xi * xi;
+    }
+}
+
+/**
+ * Computes the log-mel energies of @c features->power in @c features->logMel.
+ *
+ * @param features The front end to act on.
+ */
+static void AiaAudioFeatures_ApplyFilterBank( AiaAudioFeatures_t* features )
+{
+    size_t numBands = features->config.numMelBands;
+    float* restrict logMel = features->logMel;
+    for( size_t band = 0; band < numBands; ++band )
+    {
+        const float* restrict weights =
+            features->melWeights + features->melOffset[ band ];
+        const float* restrict bins =
+            features->power + features->melFirstBin[ band ];
+        float energy = 0.0f;
+        for( size_t i = 0; i < features->melNumBins[ band ]; ++i )
+        {
+            energy += weights[ i ] * bins[ i ];
+        }
+        logMel[ band ] = energy;
+    }
+    for( size_t band = 0; band < numBands; ++band )
+    {
+        float energy = logMel[ band ];
+        logMel[ band ] = AiaAudioFeatures_Log(
+            energy > AIA_AUDIO_FEATURES_ENERGY_FLOOR
+                ? energy
+                : AIA_AUDIO_FEATURES_ENERGY_FLOOR );
+    }
+}
+
+void AiaAudioFeatures_GetDefaultConfig( AiaAudioFeaturesConfig_t* config )
+{
+    AiaAssert( config );
+    if( !config )
+    {
+        AiaLogError( "Null config." );
+        return;
+    }
+    config->sampleRate = 16000;
+    config->frameLength = 400;
+    config->hopLength = 160;
+    config->fftSize = 512;
+    config->numMelBands = 40;
+    config->lowFrequency = 20;
+    config->highFrequency = 0;
+    config->numCoefficients = 0;
+    config->preEmphasis = 0.97f;
+}
+
+bool AiaAudioFeatures_Init( AiaAudioFeatures_t* features,
+                            const AiaAudioFeaturesConfig_t* config )
+{
+    AiaAssert( features );
+    if( !features )
+    {
+        AiaLogError( "Null features." );
+        return false;
+    }
+    if( !config )
+    {
+        AiaLogError( "Null config." );
+        return false;
+    }
+    size_t fftSize = config->fftSize;
+    if( fftSize < 4 || fftSize > AIA_AUDIO_FEATURES_MAX_FFT_SIZE ||
+        ( fftSize & ( fftSize - 1 ) ) )
+    {
+        AiaLogError( "Invalid fftSize, fftSize=%zu", fftSize );
+        return false;
+    }
+    if( !config->frameLength || config->frameLength > fftSize ||
+        !config->hopLength || config->hopLength > config->frameLength )
+    {
+        AiaLogError( "Invalid frame, frameLength=%zu, hopLength=%zu",
+                     config->frameLength, config->hopLength );
+        return false;
+    }
+    uint32_t nyquist = config->sampleRate / 2;
+    uint32_t highFrequency =
+        config->highFrequency ? config->highFrequency : nyquist;
+    if( config->lowFrequency >= highFrequency || highFrequency > nyquist )
+    {
+        AiaLogError( "Invalid frequencies, sampleRate=%" PRIu32
+                     ", lowFrequency=%" PRIu32 ", highFrequency=%" PRIu32,
+                     config->sampleRate, config->lowFrequency,
+                     config->highFrequency );
+        return false;
+    }
+    if( !config->numMelBands ||
+        config->numMelBands > AIA_AUDIO_FEATURES_MAX_MEL_BANDS ||
+        config->numCoefficients > config->numMelBands ||
+        config->numCoefficients > AIA_AUDIO_FEATURES_MAX_COEFFICIENTS )
+    {
+        AiaLogError( "Invalid outputs, numMelBands=%zu, numCoefficients=%zu",
+                     config->numMelBands, config->numCoefficients );
+        return false;
+    }
+    if( !( config->preEmphasis >= 0.0f && config->preEmphasis < 1.0f ) )
+    {
+        AiaLogError( "Invalid preEmphasis, preEmphasis=%f",
+                     (double)config->preEmphasis );
+        return false;
+    }
+
+    features->config = *config;
+    features->config.highFrequency = highFrequency;
+    features->numOutputs = config->numCoefficients ? config->numCoefficients
+                                                   : config->numMelBands;
+    AiaAudioFeatures_DesignWindow( features );
+    AiaAudioFeatures_DesignFft( features );
+    if( !AiaAudioFeatures_DesignFilterBank( features ) )
+    {
+        AiaLogError( "AiaAudioFeatures_DesignFilterBank failed." );
+        return false;
+    }
+    AiaAudioFeatures_DesignDct( features );
+    AiaAudioFeatures_Reset( features );
+    return true;
+}
+
+void AiaAudioFeatures_Reset( AiaAudioFeatures_t* features )
+{
+    AiaAssert( features );
+    if( !features )
+    {
+        AiaLogError( "Null features." );
+        return;
+    }
+    features->numSamples = 0;
+}
+
+size_t AiaAudioFeatures_GetFrameSize( const AiaAudioFeatures_t* features )
+{
+    AiaAssert( features );
+    if( !features )
+    {
+        AiaLogError( "Null features." );
+        return 0;
+    }
+    return features->numOutputs * sizeof( float );
+}
+
+bool AiaAudioFeatures_Compute( AiaAudioFeatures_t* features,
+                               const int16_t* samples, float* output )
+{
+    AiaAssert( features );
+    if( !features )
+    {
+        AiaLogError( "Null features." );
+        return false;
+    }
+    if( !samples || !output )
+    {
+        AiaLogError( "Null buffer." );
+        return false;
+    }
+
+    AiaAudioFeatures_Preprocess( features, samples );
+    AiaAudioFeatures_Transform( features );
+    AiaAudioFeatures_ApplyFilterBank( features );
+
+    size_t numBands = features->config.numMelBands;
+    size_t numCoefficients = features->config.numCoefficients;
+    if( !numCoefficients )
+    {
+        memcpy( output, features->logMel, numBands * sizeof( float ) );
+        return true;
+    }
+    for( size_t c = 0; c < numCoefficients; ++c )
+    {
+        const float* restrict row = features->dct[ c ];
+        const float* restrict logMel = features->logMel;
+        float sum = 0.0f;
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            sum += row[ band ] * logMel[ band ];
+        }
+        output[ c ] = sum;
+    }
+    return true;
+}
+
+ssize_t AiaAudioFeatures_Process( AiaAudioFeatures_t* features,
+                                  AiaDataStreamReader_t* pcmReader,
+                                  AiaDataStreamWriter_t* featureWriter )
+{
+    AiaAssert( features );
+    if( !features )
+    {
+        AiaLogError( "Null features." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( !pcmReader || !featureWriter )
+    {
+        AiaLogError( "Null stream." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( AiaDataStreamReader_GetWordSize( pcmReader ) != sizeof( int16_t ) ||
+        AiaDataStreamWriter_GetWordSize( featureWriter ) !=
+            AiaAudioFeatures_GetFrameSize( features ) )
+    {
+        AiaLogError( "Invalid word sizes, pcm=%zu, features=%zu",
+                     AiaDataStreamReader_GetWordSize( pcmReader ),
+                     AiaDataStreamWriter_GetWordSize( featureWriter ) );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+
+    size_t frameLength = features->config.frameLength;
+    size_t hopLength = features->config.hopLength;
+    float output[ AIA_AUDIO_FEATURES_MAX_MEL_BANDS ];
+    ssize_t numFrames = 0;
+    ssize_t amountRead;
+    while( ( amountRead = AiaDataStreamReader_Read(
+                 pcmReader, features->samples + features->numSamples,
+                 frameLength - features->numSamples ) ) > 0 )
+    {
+        features->numSamples += amountRead;
+        if( features->numSamples < frameLength )
+        {
+            continue;
+        }
+        AiaAudioFeatures_Compute( features, features->samples, output );
+        ++numFrames;
+        ssize_t amountWritten =
+            AiaDataStreamWriter_Write( featureWriter, output, 1 );
+        if( amountWritten <= 0 )
+        {
+            AiaLogWarn( "Dropped a frame of features, error=%s",
+                        AiaDataStreamWriter_ErrorToString( amountWritten ) );
+        }
+
+        /* Keep the samples the next frame overlaps with this one. */
+        memmove( features->samples, features->samples + hopLength,
+                 ( frameLength - hopLength ) * sizeof( int16_t ) );
+        features->numSamples = frameLength - hopLength;
+    }
+    if( AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN == amountRead )
+    {
+        AiaLogWarn( "PCM overrun, discarding %zu samples.",
+                    features->numSamples );
+        features->numSamples = 0;
+    }
+    return numFrames ? numFrames : amountRead;
+}
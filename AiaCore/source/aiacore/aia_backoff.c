@@ -54,3 +54,58 @@ AiaDurationMs_t AiaBackoff_GetBackoffTimeMilliseconds(
 
     return jitterBackoff;
 }
+
+AiaDurationMs_t AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+    AiaDurationMs_t previousBackoff, AiaDurationMs_t baseBackoff,
+    AiaDurationMs_t maxBackoff )
+{
+    if( baseBackoff == 0 || maxBackoff == 0 )
+    {
+        return 0;
+    }
+    if( baseBackoff >= maxBackoff )
+    {
+        return maxBackoff;
+    }
+
+    /* The first retry is drawn as if the previous backoff was the base one,
+     * so that clients which failed together do not all retry after exactly
+     * @c baseBackoff.  Widen before multiplying so that large previous
+     * backoffs do not wrap. */
+    uint64_t upper =
+        (uint64_t)( previousBackoff ? previousBackoff : baseBackoff ) * 3;
+    if( upper > maxBackoff )
+    {
+        upper = maxBackoff;
+    }
+    if( upper <= baseBackoff )
+    {
+        return baseBackoff;
+    }
+
+    AiaDurationMs_t jitter;
+    AiaRandom_Rand( (unsigned char *)&jitter, sizeof( jitter ) );
+    jitter %= (AiaDurationMs_t)( upper - baseBackoff + 1 );
+
+    return baseBackoff + jitter;
+}
+
+AiaDurationMs_t AiaBackoff_GetSpreadMilliseconds( const char *seed,
+                                                  size_t seedLen,
+                                                  AiaDurationMs_t maxSpread )
+{
+    if( !seed || maxSpread == 0 )
+    {
+        return 0;
+    }
+
+    /* 32-bit FNV-1a, which is cheap and spreads short identifiers well. */
+    uint32_t hash = 2166136261u;
+    for( size_t i = 0; i < seedLen; ++i )
+    {
+        hash ^= (unsigned char)seed[ i ];
+        hash *= 16777619u;
+    }
+
+    return hash % maxSpread;
+}
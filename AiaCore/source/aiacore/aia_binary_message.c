@@ -23,9 +23,13 @@
 #include <aia_config.h>
 
 #include <aiacore/aia_binary_message.h>
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_message.h>
 #include <aiacore/private/aia_message.h>
 
+#include AiaListDouble( HEADER )
+#include AiaMutex( HEADER )
+
 #include <inttypes.h>
 
 /* Anchor the inlines from aia_binary_message.h */
@@ -60,6 +64,51 @@ struct AiaBinaryMessage
 
     /** The "data" of the binary message. */
     void* data;
+
+    /** The pool this message belongs to, or @c NULL if it was allocated from
+     * the heap. */
+    AiaBinaryMessagePool_t* pool;
+
+    /** The capacity of @c data if it directly follows this message in the same
+     * allocation, or zero if @c data was allocated separately. */
+    size_t inlineCapacity;
+};
+
+/** Fixed-capacity pool of binary messages and their data buffers. */
+struct AiaBinaryMessagePool
+{
+    /** Mutex used to guard against asynchronous calls in threaded
+     * environments. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Messages which are not in use, linked through their @c message.link.
+     * The link is otherwise only used to queue the message once it has been
+     * handed out, so the two uses never overlap. */
+    AiaListDouble_t freeMessages;
+
+    /** The number of messages which have been acquired and not yet returned. */
+    size_t numAcquired;
+
+    /** Set once @c AiaBinaryMessagePool_Destroy() has been called. */
+    bool isDestroyed;
+
+    /** @} */
+
+    /** The number of messages in @c messages. */
+    const size_t numMessages;
+
+    /** The size of each data buffer in @c dataBuffers. */
+    const size_t dataBufferSize;
+
+    /** Storage for the messages. The data buffers follow in the same
+     * allocation. */
+    struct AiaBinaryMessage* const messages;
+
+    /** Storage for the data buffers, @c dataBufferSize bytes per message. */
+    uint8_t* const dataBuffers;
 };
 
 /**
@@ -90,6 +139,43 @@ static bool AiaBinaryMessage_Initialize( struct AiaBinaryMessage* binaryMessage,
 static void AiaBinaryMessage_Uninitialize(
     struct AiaBinaryMessage* binaryMessage );
 
+/**
+ * Looks up the message which carries a data buffer allocated with @c
+ * AiaBinaryMessage_AllocateInline().
+ *
+ * @param data The data buffer.
+ * @return The message which carries @c data.
+ */
+static struct AiaBinaryMessage* AiaBinaryMessage_FromInlineData( void* data );
+
+/**
+ * Looks up the pooled message which carries a given data buffer.
+ *
+ * @param pool The pool to search.
+ * @param data A data buffer from @c pool.
+ * @return The message which carries @c data, or @c NULL if @c data does not
+ * belong to @c pool.
+ */
+static struct AiaBinaryMessage* AiaBinaryMessagePool_FindMessage(
+    AiaBinaryMessagePool_t* pool, const void* data );
+
+/**
+ * Returns a message to its pool, deallocating the pool if it has been destroyed
+ * and this was the last outstanding message.
+ *
+ * @param pool The pool to return @c binaryMessage to.
+ * @param binaryMessage The message to return.
+ */
+static void AiaBinaryMessagePool_Return(
+    AiaBinaryMessagePool_t* pool, struct AiaBinaryMessage* binaryMessage );
+
+/**
+ * Deallocates a pool and all of its storage.
+ *
+ * @param pool The pool to deallocate.
+ */
+static void AiaBinaryMessagePool_Free( AiaBinaryMessagePool_t* pool );
+
 AiaBinaryMessage_t* AiaBinaryMessage_Create( AiaBinaryMessageLength_t length,
                                              AiaBinaryMessageType_t type,
                                              AiaBinaryMessageCount_t count,
@@ -169,10 +255,285 @@ void AiaBinaryMessage_Destroy( AiaBinaryMessage_t* binaryMessage )
         return;
     }
     AiaBinaryMessage_Uninitialize( binaryMessage );
-    AiaFree( binaryMessage->data );
+    if( binaryMessage->pool )
+    {
+        AiaBinaryMessagePool_Return( binaryMessage->pool, binaryMessage );
+        return;
+    }
+    if( !binaryMessage->inlineCapacity )
+    {
+        AiaFree( binaryMessage->data );
+    }
     AiaFree( binaryMessage );
 }
 
+void* AiaBinaryMessage_AllocateInline( size_t capacity )
+{
+    if( !capacity )
+    {
+        AiaLogError( "Invalid capacity, capacity=%zu", capacity );
+        return NULL;
+    }
+    size_t bytes = sizeof( struct AiaBinaryMessage ) + capacity;
+    struct AiaBinaryMessage* binaryMessage =
+        (struct AiaBinaryMessage*)AiaCalloc( 1, bytes );
+    if( !binaryMessage )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", bytes );
+        return NULL;
+    }
+    binaryMessage->inlineCapacity = capacity;
+    binaryMessage->data = binaryMessage + 1;
+    return binaryMessage->data;
+}
+
+void AiaBinaryMessage_FreeInline( void* data )
+{
+    if( !data )
+    {
+        AiaLogDebug( "Null data." );
+        return;
+    }
+    AiaFree( AiaBinaryMessage_FromInlineData( data ) );
+}
+
+AiaBinaryMessage_t* AiaBinaryMessage_CreateInline(
+    AiaBinaryMessageLength_t length, AiaBinaryMessageType_t type,
+    AiaBinaryMessageCount_t count, void* data )
+{
+    if( !data )
+    {
+        AiaLogError( "Null data." );
+        return NULL;
+    }
+    struct AiaBinaryMessage* binaryMessage =
+        AiaBinaryMessage_FromInlineData( data );
+    if( length > binaryMessage->inlineCapacity )
+    {
+        AiaLogError( "length exceeds capacity, length=%" PRIu32
+                     ", capacity=%zu",
+                     length, binaryMessage->inlineCapacity );
+        return NULL;
+    }
+    if( !AiaBinaryMessage_Initialize( binaryMessage, length, type, count,
+                                      data ) )
+    {
+        AiaLogError( "_AiaBinaryMessage_Initialize failed." );
+        return NULL;
+    }
+    return binaryMessage;
+}
+
+static struct AiaBinaryMessage* AiaBinaryMessage_FromInlineData( void* data )
+{
+    return (struct AiaBinaryMessage*)data - 1;
+}
+
+AiaBinaryMessagePool_t* AiaBinaryMessagePool_Create( size_t numMessages,
+                                                     size_t dataBufferSize )
+{
+    if( !numMessages )
+    {
+        AiaLogError( "Invalid numMessages, numMessages=%zu", numMessages );
+        return NULL;
+    }
+    if( !dataBufferSize )
+    {
+        AiaLogError( "Invalid dataBufferSize, dataBufferSize=%zu",
+                     dataBufferSize );
+        return NULL;
+    }
+
+    size_t bytesPerMessage = sizeof( struct AiaBinaryMessage ) + dataBufferSize;
+    struct AiaBinaryMessage* messages =
+        (struct AiaBinaryMessage*)AiaCalloc( numMessages, bytesPerMessage );
+    if( !messages )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     numMessages * bytesPerMessage );
+        return NULL;
+    }
+
+    AiaBinaryMessagePool_t* pool = (AiaBinaryMessagePool_t*)AiaCalloc(
+        1, sizeof( AiaBinaryMessagePool_t ) );
+    if( !pool )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaBinaryMessagePool_t ) );
+        AiaFree( messages );
+        return NULL;
+    }
+
+    if( !AiaMutex( Create )( &pool->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( pool );
+        AiaFree( messages );
+        return NULL;
+    }
+
+    *(size_t*)&pool->numMessages = numMessages;
+    *(size_t*)&pool->dataBufferSize = dataBufferSize;
+    *(struct AiaBinaryMessage**)&pool->messages = messages;
+    *(uint8_t**)&pool->dataBuffers = (uint8_t*)( messages + numMessages );
+
+    AiaListDouble( Create )( &pool->freeMessages );
+    for( size_t i = 0; i < numMessages; ++i )
+    {
+        messages[ i ].pool = pool;
+        messages[ i ].data = pool->dataBuffers + ( i * dataBufferSize );
+        AiaListDouble( InsertTail )( &pool->freeMessages,
+                                     &messages[ i ].message.link );
+    }
+
+    return pool;
+}
+
+void AiaBinaryMessagePool_Destroy( AiaBinaryMessagePool_t* pool )
+{
+    if( !pool )
+    {
+        AiaLogDebug( "Null pool." );
+        return;
+    }
+
+    AiaMutex( Lock )( &pool->mutex );
+    pool->isDestroyed = true;
+    bool canFree = !pool->numAcquired;
+    if( !canFree )
+    {
+        AiaLogDebug( "Deferring pool deallocation, numAcquired=%zu",
+                     pool->numAcquired );
+    }
+    AiaMutex( Unlock )( &pool->mutex );
+
+    if( canFree )
+    {
+        AiaBinaryMessagePool_Free( pool );
+    }
+}
+
+void* AiaBinaryMessagePool_AcquireData( AiaBinaryMessagePool_t* pool )
+{
+    AiaAssert( pool );
+    if( !pool )
+    {
+        AiaLogError( "Null pool" );
+        return NULL;
+    }
+
+    AiaMutex( Lock )( &pool->mutex );
+    AiaListDouble( Link_t )* link =
+        AiaListDouble( RemoveHead )( &pool->freeMessages );
+    if( link )
+    {
+        ++pool->numAcquired;
+    }
+    AiaMutex( Unlock )( &pool->mutex );
+
+    if( !link )
+    {
+        return NULL;
+    }
+    /* The link is the first member of the message, which is in turn the first
+     * member of the binary message. */
+    return ( (struct AiaBinaryMessage*)link )->data;
+}
+
+void AiaBinaryMessagePool_ReleaseData( AiaBinaryMessagePool_t* pool,
+                                       void* data )
+{
+    AiaAssert( pool );
+    if( !pool )
+    {
+        AiaLogError( "Null pool" );
+        return;
+    }
+    struct AiaBinaryMessage* binaryMessage =
+        AiaBinaryMessagePool_FindMessage( pool, data );
+    if( !binaryMessage )
+    {
+        AiaLogError( "data does not belong to pool" );
+        return;
+    }
+    AiaBinaryMessagePool_Return( pool, binaryMessage );
+}
+
+AiaBinaryMessage_t* AiaBinaryMessagePool_CreateMessage(
+    AiaBinaryMessagePool_t* pool, AiaBinaryMessageLength_t length,
+    AiaBinaryMessageType_t type, AiaBinaryMessageCount_t count, void* data )
+{
+    AiaAssert( pool );
+    if( !pool )
+    {
+        AiaLogError( "Null pool" );
+        return NULL;
+    }
+    struct AiaBinaryMessage* binaryMessage =
+        AiaBinaryMessagePool_FindMessage( pool, data );
+    if( !binaryMessage )
+    {
+        AiaLogError( "data does not belong to pool" );
+        return NULL;
+    }
+    if( length > pool->dataBufferSize )
+    {
+        AiaLogError( "length exceeds dataBufferSize, length=%" PRIu32
+                     ", dataBufferSize=%zu",
+                     length, pool->dataBufferSize );
+        return NULL;
+    }
+    if( !AiaBinaryMessage_Initialize( binaryMessage, length, type, count,
+                                      data ) )
+    {
+        AiaLogError( "_AiaBinaryMessage_Initialize failed." );
+        return NULL;
+    }
+    return binaryMessage;
+}
+
+static struct AiaBinaryMessage* AiaBinaryMessagePool_FindMessage(
+    AiaBinaryMessagePool_t* pool, const void* data )
+{
+    const uint8_t* dataBuffer = (const uint8_t*)data;
+    if( !dataBuffer || dataBuffer < pool->dataBuffers )
+    {
+        return NULL;
+    }
+    size_t offset = dataBuffer - pool->dataBuffers;
+    size_t index = offset / pool->dataBufferSize;
+    if( index >= pool->numMessages ||
+        offset != index * pool->dataBufferSize )
+    {
+        return NULL;
+    }
+    return &pool->messages[ index ];
+}
+
+static void AiaBinaryMessagePool_Return(
+    AiaBinaryMessagePool_t* pool, struct AiaBinaryMessage* binaryMessage )
+{
+    AiaMutex( Lock )( &pool->mutex );
+    AiaListDouble( InsertHead )( &pool->freeMessages,
+                                 &binaryMessage->message.link );
+    AiaAssert( pool->numAcquired );
+    --pool->numAcquired;
+    bool canFree = pool->isDestroyed && !pool->numAcquired;
+    AiaMutex( Unlock )( &pool->mutex );
+
+    if( canFree )
+    {
+        AiaBinaryMessagePool_Free( pool );
+    }
+}
+
+static void AiaBinaryMessagePool_Free( AiaBinaryMessagePool_t* pool )
+{
+    AiaMutex( Destroy )( &pool->mutex );
+    AiaFree( pool->messages );
+    AiaFree( pool );
+}
+
 AiaBinaryMessageLength_t AiaBinaryMessage_GetLength(
     const AiaBinaryMessage_t* binaryMessage )
 {
@@ -244,29 +605,81 @@ bool AiaBinaryMessage_BuildMessage( const AiaBinaryMessage_t* binaryMessage,
         return false;
     }
     size_t bytePosition = 0;
-    for( size_t i = 0; i < sizeof( binaryMessage->length ); ++i )
+    AiaEndian_StoreLe32( messageBuffer + bytePosition, binaryMessage->length );
+    bytePosition += sizeof( binaryMessage->length );
+    messageBuffer[ bytePosition ] = binaryMessage->type;
+    bytePosition += sizeof( binaryMessage->type );
+    messageBuffer[ bytePosition ] = binaryMessage->count;
+    bytePosition += sizeof( binaryMessage->count );
+    memset( messageBuffer + bytePosition, 0,
+            AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES );
+    bytePosition += AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES;
+
+    memcpy( messageBuffer + bytePosition, binaryMessage->data,
+            binaryMessage->length );
+    return true;
+}
+
+void AiaBinaryStreamIterator_Init( AiaBinaryStreamIterator_t* iterator,
+                                   const uint8_t* stream, size_t size )
+{
+    AiaAssert( iterator );
+    if( !iterator )
     {
-        messageBuffer[ bytePosition ] = ( binaryMessage->length >> ( i * 8 ) );
-        ++bytePosition;
+        AiaLogError( "Null iterator." );
+        return;
     }
-    for( size_t i = 0; i < sizeof( binaryMessage->type ); ++i )
+    iterator->next = stream;
+    iterator->end = stream ? stream + size : NULL;
+}
+
+bool AiaBinaryStreamIterator_HasNext(
+    const AiaBinaryStreamIterator_t* iterator )
+{
+    AiaAssert( iterator );
+    if( !iterator )
     {
-        messageBuffer[ bytePosition ] = ( binaryMessage->type >> ( i * 8 ) );
-        ++bytePosition;
+        AiaLogError( "Null iterator." );
+        return false;
     }
-    for( size_t i = 0; i < sizeof( binaryMessage->count ); ++i )
+    return iterator->next != iterator->end;
+}
+
+bool AiaBinaryStreamIterator_Next( AiaBinaryStreamIterator_t* iterator,
+                                   AiaBinaryStreamEntry_t* entry )
+{
+    AiaAssert( iterator );
+    if( !iterator )
     {
-        messageBuffer[ bytePosition ] = ( binaryMessage->count >> ( i * 8 ) );
-        ++bytePosition;
+        AiaLogError( "Null iterator." );
+        return false;
     }
-
-    for( size_t i = 0; i < AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES; ++i )
+    if( !entry )
     {
-        messageBuffer[ bytePosition ] = 0;
-        ++bytePosition;
+        AiaLogError( "Null entry." );
+        return false;
     }
-
-    memcpy( messageBuffer + bytePosition, binaryMessage->data,
-            binaryMessage->length );
+    size_t remaining = iterator->end - iterator->next;
+    if( remaining < AIA_SIZE_OF_BINARY_STREAM_HEADER )
+    {
+        AiaLogError( "Stream too small to hold header, remaining=%zu",
+                     remaining );
+        return false;
+    }
+    const uint8_t* header = iterator->next;
+    AiaBinaryMessageLength_t length = AiaEndian_LoadLe32( header );
+    if( length > remaining - AIA_SIZE_OF_BINARY_STREAM_HEADER )
+    {
+        AiaLogError( "Invalid binary stream length, length=%" PRIu32
+                     ", remaining=%zu",
+                     length, remaining );
+        return false;
+    }
+    entry->length = length;
+    entry->type = header[ sizeof( AiaBinaryMessageLength_t ) ];
+    entry->count = header[ sizeof( AiaBinaryMessageLength_t ) +
+                           sizeof( AiaBinaryMessageType_t ) ];
+    entry->data = header + AIA_SIZE_OF_BINARY_STREAM_HEADER;
+    iterator->next = entry->data + length;
     return true;
 }
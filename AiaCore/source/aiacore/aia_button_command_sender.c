@@ -27,6 +27,9 @@
 #include <aiacore/aia_events.h>
 #include <aiacore/aia_json_message.h>
 
+#include AiaMutex( HEADER )
+#include AiaTimer( HEADER )
+
 #include <stdio.h>
 
 /**
@@ -43,6 +46,30 @@ struct AiaButtonCommandSender
 
     /** User data associated with @c stopPlayback. */
     void* const stopPlaybackUserData;
+
+    /** Mutex used to guard against asynchronous calls in threaded
+     * environments. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** How long presses are coalesced for, or zero to send every press. */
+    AiaDurationMs_t coalescingWindowMs;
+
+    /** Whether a burst of presses is waiting for @c coalescingTimer. */
+    bool hasPendingButton;
+
+    /** The last button pressed during the current burst. */
+    AiaButtonCommand_t pendingButton;
+
+    /** Whether local playback has been stopped during the current burst. */
+    bool hasStoppedPlayback;
+
+    /** @} */
+
+    /** Timer used to send the coalesced press at the end of a burst. */
+    AiaTimer_t coalescingTimer;
 };
 
 /**
@@ -55,6 +82,24 @@ struct AiaButtonCommandSender
 static AiaJsonMessage_t* generateButtonCommandIssuedEvent(
     AiaButtonCommand_t button );
 
+/**
+ * Generates a @c ButtonCommandIssued event and writes it to the event
+ * regulator.
+ *
+ * @param buttonCommandSender The @c AiaButtonCommandSender_t to act on.
+ * @param button The button pressed.
+ * @return @c true if the event was written or @c false otherwise.
+ */
+static bool AiaButtonCommandSender_SendEvent(
+    AiaButtonCommandSender_t* buttonCommandSender, AiaButtonCommand_t button );
+
+/**
+ * Timer callback which sends the last button pressed during a burst.
+ *
+ * @param context The @c AiaButtonCommandSender_t to act on.
+ */
+static void AiaButtonCommandSender_OnCoalescingWindowEnded( void* context );
+
 AiaButtonCommandSender_t* AiaButtonCommandSender_Create(
     AiaRegulator_t* eventRegulator, AiaStopPlayback_t stopPlayback,
     void* stopPlaybackUserData )
@@ -79,6 +124,23 @@ AiaButtonCommandSender_t* AiaButtonCommandSender_Create(
     *(AiaStopPlayback_t*)&buttonCommandSender->stopPlayback = stopPlayback;
     *(void**)&buttonCommandSender->stopPlaybackUserData = stopPlaybackUserData;
 
+    if( !AiaMutex( Create )( &buttonCommandSender->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( buttonCommandSender );
+        return NULL;
+    }
+
+    if( !AiaTimer( Create )( &buttonCommandSender->coalescingTimer,
+                             AiaButtonCommandSender_OnCoalescingWindowEnded,
+                             buttonCommandSender ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &buttonCommandSender->mutex );
+        AiaFree( buttonCommandSender );
+        return NULL;
+    }
+
     return buttonCommandSender;
 }
 
@@ -90,9 +152,33 @@ void AiaButtonCommandSender_Destroy(
         AiaLogDebug( "Null buttonCommandSender." );
         return;
     }
+    AiaTimer( Destroy )( &buttonCommandSender->coalescingTimer );
+    if( buttonCommandSender->hasPendingButton )
+    {
+        AiaLogDebug( "Dropping coalesced press, button=%s.",
+                     AiaButtonCommand_ToString(
+                         buttonCommandSender->pendingButton ) );
+    }
+    AiaMutex( Destroy )( &buttonCommandSender->mutex );
     AiaFree( buttonCommandSender );
 }
 
+bool AiaButtonCommandSender_SetCoalescingWindow(
+    AiaButtonCommandSender_t* buttonCommandSender, AiaDurationMs_t windowMs )
+{
+    AiaAssert( buttonCommandSender );
+    if( !buttonCommandSender )
+    {
+        AiaLogError( "Null buttonCommandSender." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &buttonCommandSender->mutex );
+    buttonCommandSender->coalescingWindowMs = windowMs;
+    AiaMutex( Unlock )( &buttonCommandSender->mutex );
+    return true;
+}
+
 bool AiaButtonCommandSender_OnButtonPressed(
     AiaButtonCommandSender_t* buttonCommandSender, AiaButtonCommand_t button )
 {
@@ -103,42 +189,113 @@ bool AiaButtonCommandSender_OnButtonPressed(
         return false;
     }
 
-    AiaJsonMessage_t* buttonCommandIssuedEvent = NULL;
+    bool isStop = false;
     switch( button )
     {
         case AIA_BUTTON_STOP:
             /* Fall-through */
         case AIA_BUTTON_PAUSE:
-            if( buttonCommandSender->stopPlayback )
-            {
-                buttonCommandSender->stopPlayback(
-                    buttonCommandSender->stopPlaybackUserData );
-            }
-            /* Fall-through */
+            isStop = true;
+            break;
         case AIA_BUTTON_PLAY:
             /* Fall-through */
         case AIA_BUTTON_NEXT:
             /* Fall-through */
         case AIA_BUTTON_PREVIOUS:
-            buttonCommandIssuedEvent =
-                generateButtonCommandIssuedEvent( button );
-            if( !buttonCommandIssuedEvent )
-            {
-                AiaLogError( "generateButtonCommandIssuedEvent failed" );
-                return false;
-            }
-            if( !AiaRegulator_Write(
-                    buttonCommandSender->eventRegulator,
-                    AiaJsonMessage_ToMessage( buttonCommandIssuedEvent ) ) )
-            {
-                AiaLogError( "AiaRegulator_Write failed" );
-                AiaJsonMessage_Destroy( buttonCommandIssuedEvent );
-                return false;
-            }
+            break;
+        default:
+            return true;
+    }
+
+    AiaMutex( Lock )( &buttonCommandSender->mutex );
+    if( !buttonCommandSender->coalescingWindowMs )
+    {
+        AiaMutex( Unlock )( &buttonCommandSender->mutex );
+        if( isStop && buttonCommandSender->stopPlayback )
+        {
+            buttonCommandSender->stopPlayback(
+                buttonCommandSender->stopPlaybackUserData );
+        }
+        return AiaButtonCommandSender_SendEvent( buttonCommandSender, button );
+    }
+
+    /* Playback is stopped on the first stop of a burst so that it still stops
+     * immediately, but only once. */
+    bool shouldStopPlayback =
+        isStop && !buttonCommandSender->hasStoppedPlayback;
+    buttonCommandSender->hasStoppedPlayback |= isStop;
+    bool startsBurst = !buttonCommandSender->hasPendingButton;
+    buttonCommandSender->hasPendingButton = true;
+    buttonCommandSender->pendingButton = button;
+    bool sendNow = false;
+    if( startsBurst &&
+        !AiaTimer( Arm )( &buttonCommandSender->coalescingTimer,
+                          buttonCommandSender->coalescingWindowMs, 0 ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed, sending press immediately." );
+        buttonCommandSender->hasPendingButton = false;
+        buttonCommandSender->hasStoppedPlayback = false;
+        sendNow = true;
+    }
+    AiaMutex( Unlock )( &buttonCommandSender->mutex );
+
+    if( shouldStopPlayback && buttonCommandSender->stopPlayback )
+    {
+        buttonCommandSender->stopPlayback(
+            buttonCommandSender->stopPlaybackUserData );
+    }
+    if( sendNow )
+    {
+        return AiaButtonCommandSender_SendEvent( buttonCommandSender, button );
+    }
+    return true;
+}
+
+static bool AiaButtonCommandSender_SendEvent(
+    AiaButtonCommandSender_t* buttonCommandSender, AiaButtonCommand_t button )
+{
+    AiaJsonMessage_t* buttonCommandIssuedEvent =
+        generateButtonCommandIssuedEvent( button );
+    if( !buttonCommandIssuedEvent )
+    {
+        AiaLogError( "generateButtonCommandIssuedEvent failed" );
+        return false;
+    }
+    if( !AiaRegulator_Write(
+            buttonCommandSender->eventRegulator,
+            AiaJsonMessage_ToMessage( buttonCommandIssuedEvent ) ) )
+    {
+        AiaLogError( "AiaRegulator_Write failed" );
+        AiaJsonMessage_Destroy( buttonCommandIssuedEvent );
+        return false;
     }
     return true;
 }
 
+static void AiaButtonCommandSender_OnCoalescingWindowEnded( void* context )
+{
+    AiaButtonCommandSender_t* buttonCommandSender =
+        (AiaButtonCommandSender_t*)context;
+    AiaAssert( buttonCommandSender );
+
+    AiaMutex( Lock )( &buttonCommandSender->mutex );
+    if( !buttonCommandSender->hasPendingButton )
+    {
+        AiaMutex( Unlock )( &buttonCommandSender->mutex );
+        return;
+    }
+    AiaButtonCommand_t button = buttonCommandSender->pendingButton;
+    buttonCommandSender->hasPendingButton = false;
+    buttonCommandSender->hasStoppedPlayback = false;
+    AiaMutex( Unlock )( &buttonCommandSender->mutex );
+
+    if( !AiaButtonCommandSender_SendEvent( buttonCommandSender, button ) )
+    {
+        AiaLogError( "Failed to send coalesced press, button=%s.",
+                     AiaButtonCommand_ToString( button ) );
+    }
+}
+
 static AiaJsonMessage_t* generateButtonCommandIssuedEvent(
     AiaButtonCommand_t button )
 {
@@ -24,6 +24,9 @@
 
 #include <aiacore/aia_crypto_mbedtls.h>
 #include <aiacore/aia_encryption_algorithm.h>
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+#include <aiacore/aia_gcm_accel.h>
+#endif
 #include <aiacore/aia_message_constants.h>
 #include <aiacore/aia_utils.h>
 
@@ -34,11 +37,20 @@
 #include <mbedtls/error.h>
 #include <mbedtls/gcm.h>
 #include <mbedtls/hkdf.h>
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+#include <mbedtls/platform_util.h>
+#endif
+
+#include AiaTimer( HEADER )
 
 /* Length of the shared secret after shared secret computation */
 #define AIA_CRYPTO_MBEDTLS_SHARED_SECRET_BUFFER_LENGTH 32
 /* The longest error message has 40 characters (including \0) */
 #define AIA_CRYPTO_MBEDTLS_ERROR_BUFFER_LENGTH 40
+/* Block size of the AES cipher underlying gcm, which is also its tag size */
+#define AIA_CRYPTO_MBEDTLS_GCM_BLOCK_SIZE 16
+/* Length of the random field of IVs generated for a context */
+#define AIA_CRYPTO_MBEDTLS_IV_PREFIX_LENGTH 8
 
 /* Personalization data for seeding the RNG */
 static const char *AIA_CRYPTO_PERS_DATA = "AIA_CRYPTO_PERS_DATA";
@@ -54,10 +66,61 @@ static mbedtls_entropy_context g_entropyContext;
 static mbedtls_ctr_drbg_context g_ctrdrbgContext;
 /** @} */
 
+/** Serializes seeding of @c g_ctrdrbgContext. */
+static AiaMutex_t g_seedMutex;
+
+/** Whether @c g_ctrdrbgContext has been seeded. This should only be accessed
+ * using atomic operations. */
+static AiaAtomicBool_t g_isSeeded;
+
+#ifdef AIA_ENABLE_ASYNC_CRYPTO_SEED
+/** Seeds @c g_ctrdrbgContext in the background after @c
+ * AiaCryptoMbedtls_Init(). */
+static AiaTimer_t g_seedWorker;
+#endif
+
 /**
- * mbed TLS gcm context for implementation of encryption/decryption functions.
+ * A gcm key and operation. The key is expanded for mbed TLS or, when the build
+ * and the CPU allow it, for the kernels of @c aia_gcm_accel.h. Only the @c
+ * AiaCryptoMbedtls_Gcm*() functions below should access it.
  */
-static mbedtls_gcm_context g_gcmContext;
+typedef struct AiaCryptoMbedtlsGcm
+{
+    /** mbed TLS gcm context, used unless @c isAccelerated is set. */
+    mbedtls_gcm_context mbedtlsContext;
+
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    /** Accelerated gcm context, used if @c isAccelerated is set. */
+    AiaGcmAccel_t accelContext;
+
+    /** Whether the key was expanded into @c accelContext. */
+    bool isAccelerated;
+#endif
+} AiaCryptoMbedtlsGcm_t;
+
+/**
+ * gcm context for implementation of encryption/decryption functions.
+ */
+static AiaCryptoMbedtlsGcm_t g_gcmContext;
+
+/** Private data for the @c AiaCryptoMbedtlsContext_t type. */
+struct AiaCryptoMbedtlsContext
+{
+    /** gcm context holding the pre-expanded key for this context. */
+    AiaCryptoMbedtlsGcm_t gcmContext;
+
+    /** Random field of the IVs generated for this context, drawn whenever the
+     * key is set. */
+    uint8_t ivPrefix[ AIA_CRYPTO_MBEDTLS_IV_PREFIX_LENGTH ];
+
+    /** Invocation field of the next IV generated for this context. */
+    uint32_t ivCounter;
+
+    /** Whether @c ivPrefix has been drawn since the key was last set. It is
+     * drawn on the first encryption so that setting a key, and decrypting,
+     * does not wait on the random number generator. */
+    bool hasIvPrefix;
+};
 
 /**
  * Logs a mbedTLS error
@@ -74,6 +137,224 @@ static void AiaCryptoMbedtls_LogMbedtlsError( const char *errorMessage,
     AiaLogError( "%s. Error: %s", errorMessage, errorBuffer );
 }
 
+/**
+ * Compares two tags in constant time, as @c mbedtls_gcm_auth_decrypt() does.
+ *
+ * @return @c true if the first @c tagLen bytes of the tags differ.
+ */
+static bool AiaCryptoMbedtls_TagsDiffer( const uint8_t *tag,
+                                         const uint8_t *expectedTag,
+                                         size_t tagLen )
+{
+    uint8_t difference = 0;
+    for( size_t i = 0; i < tagLen; ++i )
+    {
+        difference |= expectedTag[ i ] ^ tag[ i ];
+    }
+    return difference;
+}
+
+/**
+ * The functions below wrap the mbed TLS gcm functions of the same names,
+ * dispatching to the accelerated kernels for keys set while they are
+ * supported, and return mbed TLS error codes either way.
+ */
+/** @{ */
+static void AiaCryptoMbedtls_GcmInit( AiaCryptoMbedtlsGcm_t *gcm )
+{
+    mbedtls_gcm_init( &( gcm->mbedtlsContext ) );
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    gcm->isAccelerated = false;
+#endif
+}
+
+static void AiaCryptoMbedtls_GcmFree( AiaCryptoMbedtlsGcm_t *gcm )
+{
+    mbedtls_gcm_free( &( gcm->mbedtlsContext ) );
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    mbedtls_platform_zeroize( &( gcm->accelContext ),
+                              sizeof( gcm->accelContext ) );
+    gcm->isAccelerated = false;
+#endif
+}
+
+static int AiaCryptoMbedtls_GcmSetKey( AiaCryptoMbedtlsGcm_t *gcm,
+                                       mbedtls_cipher_id_t cipher,
+                                       const uint8_t *key, size_t keyBits )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    gcm->isAccelerated =
+        MBEDTLS_CIPHER_ID_AES == cipher && AiaGcmAccel_IsSupported();
+    if( gcm->isAccelerated )
+    {
+        return AiaGcmAccel_SetKey( &( gcm->accelContext ), key, keyBits )
+                   ? 0
+                   : MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+#endif
+    return mbedtls_gcm_setkey( &( gcm->mbedtlsContext ), cipher, key,
+                               keyBits );
+}
+
+static int AiaCryptoMbedtls_GcmStarts( AiaCryptoMbedtlsGcm_t *gcm, int mode,
+                                       const uint8_t *iv, size_t ivLen )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    if( gcm->isAccelerated )
+    {
+        return AiaGcmAccel_Starts( &( gcm->accelContext ),
+                                   MBEDTLS_GCM_DECRYPT == mode, iv, ivLen )
+                   ? 0
+                   : MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+#endif
+    return mbedtls_gcm_starts( &( gcm->mbedtlsContext ), mode, iv, ivLen, NULL,
+                               0 );
+}
+
+static int AiaCryptoMbedtls_GcmUpdate( AiaCryptoMbedtlsGcm_t *gcm,
+                                       size_t length, const uint8_t *input,
+                                       uint8_t *output )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    if( gcm->isAccelerated )
+    {
+        return AiaGcmAccel_Update( &( gcm->accelContext ), length, input,
+                                   output )
+                   ? 0
+                   : MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+#endif
+    return mbedtls_gcm_update( &( gcm->mbedtlsContext ), length, input,
+                               output );
+}
+
+static int AiaCryptoMbedtls_GcmFinish( AiaCryptoMbedtlsGcm_t *gcm,
+                                       uint8_t *tag, size_t tagLen )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    if( gcm->isAccelerated )
+    {
+        return AiaGcmAccel_Finish( &( gcm->accelContext ), tag, tagLen )
+                   ? 0
+                   : MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+#endif
+    return mbedtls_gcm_finish( &( gcm->mbedtlsContext ), tag, tagLen );
+}
+
+static int AiaCryptoMbedtls_GcmCryptAndTag(
+    AiaCryptoMbedtlsGcm_t *gcm, int mode, size_t length, const uint8_t *iv,
+    size_t ivLen, const uint8_t *input, uint8_t *output, size_t tagLen,
+    uint8_t *tag )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    if( gcm->isAccelerated )
+    {
+        int mbedgcmError = AiaCryptoMbedtls_GcmStarts( gcm, mode, iv, ivLen );
+        if( !mbedgcmError )
+        {
+            mbedgcmError =
+                AiaCryptoMbedtls_GcmUpdate( gcm, length, input, output );
+        }
+        if( !mbedgcmError )
+        {
+            mbedgcmError = AiaCryptoMbedtls_GcmFinish( gcm, tag, tagLen );
+        }
+        return mbedgcmError;
+    }
+#endif
+    return mbedtls_gcm_crypt_and_tag( &( gcm->mbedtlsContext ), mode, length,
+                                      iv, ivLen, NULL, 0, input, output,
+                                      tagLen, tag );
+}
+
+static int AiaCryptoMbedtls_GcmAuthDecrypt(
+    AiaCryptoMbedtlsGcm_t *gcm, size_t length, const uint8_t *iv,
+    size_t ivLen, const uint8_t *tag, size_t tagLen, const uint8_t *input,
+    uint8_t *output )
+{
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    if( gcm->isAccelerated )
+    {
+        uint8_t expectedTag[ AIA_CRYPTO_MBEDTLS_GCM_BLOCK_SIZE ];
+        if( tagLen > sizeof( expectedTag ) )
+        {
+            return MBEDTLS_ERR_GCM_BAD_INPUT;
+        }
+        int mbedgcmError = AiaCryptoMbedtls_GcmCryptAndTag(
+            gcm, MBEDTLS_GCM_DECRYPT, length, iv, ivLen, input, output, tagLen,
+            expectedTag );
+        if( mbedgcmError )
+        {
+            return mbedgcmError;
+        }
+        if( AiaCryptoMbedtls_TagsDiffer( tag, expectedTag, tagLen ) )
+        {
+            memset( output, 0, length );
+            return MBEDTLS_ERR_GCM_AUTH_FAILED;
+        }
+        return 0;
+    }
+#endif
+    return mbedtls_gcm_auth_decrypt( &( gcm->mbedtlsContext ), length, iv,
+                                     ivLen, NULL, 0, tag, tagLen, input,
+                                     output );
+}
+/** @} */
+
+/**
+ * Seeds @c g_ctrdrbgContext from the entropy source unless it has been seeded
+ * already. Slow entropy sources make this the slowest part of initialization.
+ *
+ * @return @c true if @c g_ctrdrbgContext is seeded, else @c false.
+ */
+static bool AiaCryptoMbedtls_Seed()
+{
+    if( AiaAtomicBool_Load( &g_isSeeded ) )
+    {
+        return true;
+    }
+
+    /* Callers arriving while the seed worker is seeding wait for it here. */
+    AiaMutex( Lock )( &g_seedMutex );
+    if( !AiaAtomicBool_Load( &g_isSeeded ) )
+    {
+        int mbedgcmError = mbedtls_ctr_drbg_seed(
+            &( g_ctrdrbgContext ), mbedtls_entropy_func, &( g_entropyContext ),
+            (const unsigned char *)AIA_CRYPTO_PERS_DATA,
+            sizeof( AIA_CRYPTO_PERS_DATA ) - 1 );
+        if( mbedgcmError != 0 )
+        {
+            AiaCryptoMbedtls_LogMbedtlsError( "Failed to seed RNG",
+                                              mbedgcmError );
+        }
+        else
+        {
+            AiaAtomicBool_Set( &g_isSeeded );
+        }
+    }
+    AiaMutex( Unlock )( &g_seedMutex );
+    return AiaAtomicBool_Load( &g_isSeeded );
+}
+
+#ifdef AIA_ENABLE_ASYNC_CRYPTO_SEED
+/**
+ * A function scheduled by @c AiaCryptoMbedtls_Init() to seed @c
+ * g_ctrdrbgContext without holding up initialization.
+ *
+ * @param context Unused.
+ */
+static void AiaCryptoMbedtls_SeedRoutine( void *context )
+{
+    (void)context;
+    if( !AiaCryptoMbedtls_Seed() )
+    {
+        AiaLogWarn( "Seeding failed, it will be retried on first use" );
+    }
+}
+#endif
+
 static const char *AiaCryptoMbedtls_GenerateKeyPairInternal(
     AiaSecretDerivationAlgorithm_t secretDerivationAlgorithm,
     uint8_t *privateKey, size_t privateKeyLen, uint8_t *publicKey,
@@ -253,8 +534,6 @@ static const char *AiaCryptoMbedtls_CalculateSharedSecretInternal(
 
 bool AiaCryptoMbedtls_Init()
 {
-    int mbedgcmError = 0;
-
     if( !AiaMutex( Create )( &gcmMutex, false ) )
     {
         AiaLogError( "AiaMutex( Create ) failed." );
@@ -262,31 +541,68 @@ bool AiaCryptoMbedtls_Init()
     }
 
     /* Initialize context for encryption/decryption functions. */
-    mbedtls_gcm_init( &( g_gcmContext ) );
+    AiaCryptoMbedtls_GcmInit( &( g_gcmContext ) );
+#ifdef AIA_ENABLE_ACCELERATED_GCM
+    AiaLogInfo( "Using %s AES-GCM.",
+                AiaGcmAccel_IsSupported() ? "accelerated" : "mbed TLS" );
+#endif
 
     /* Create entropy and ctr_drbg contexts */
     mbedtls_entropy_init( &( g_entropyContext ) );
     mbedtls_ctr_drbg_init( &( g_ctrdrbgContext ) );
 
-    mbedgcmError = mbedtls_ctr_drbg_seed(
-        &( g_ctrdrbgContext ), mbedtls_entropy_func, &( g_entropyContext ),
-        (const unsigned char *)AIA_CRYPTO_PERS_DATA,
-        sizeof( AIA_CRYPTO_PERS_DATA ) - 1 );
-    if( mbedgcmError != 0 )
+    if( !AiaMutex( Create )( &g_seedMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaMutex( Destroy )( &gcmMutex );
+        return false;
+    }
+    AiaAtomicBool_Clear( &g_isSeeded );
+
+#ifdef AIA_ENABLE_ASYNC_CRYPTO_SEED
+    /* Seeding is left to the seed worker, and anything needing random numbers
+     * before it is done waits for it. Should the worker not run, the first
+     * such caller seeds instead. */
+    if( !AiaTimer( Create )( &g_seedWorker, AiaCryptoMbedtls_SeedRoutine,
+                             NULL ) )
     {
-        AiaCryptoMbedtls_LogMbedtlsError( "Failed to seed RNG", mbedgcmError );
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &g_seedMutex );
         AiaMutex( Destroy )( &gcmMutex );
         return false;
     }
+    if( !AiaTimer( Arm )( &g_seedWorker, 0, 0 ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed, seeding on first use" );
+    }
+#else
+    if( !AiaCryptoMbedtls_Seed() )
+    {
+        AiaMutex( Destroy )( &g_seedMutex );
+        AiaMutex( Destroy )( &gcmMutex );
+        return false;
+    }
+#endif
 
     return true;
 }
 
-bool AiaCryptoMbedtls_SetKey( const uint8_t *encryptKey, size_t encryptKeySize,
-                              const AiaEncryptionAlgorithm_t encryptAlgorithm )
+/**
+ * Validates an encryption key and determines the parameters needed to expand
+ * it into a gcm context.
+ *
+ * @param encryptKey The encryption key to use.
+ * @param encryptKeySize The size of @c encryptKey (in bytes).
+ * @param encryptAlgorithm The encryption algorithm to use.
+ * @param[out] cipher The cipher to use for @c encryptAlgorithm.
+ * @param[out] sizeInBits The size of @c encryptKey (in bits).
+ * @return @c true if the key is valid, else @c false.
+ */
+static bool AiaCryptoMbedtls_ValidateKey(
+    const uint8_t *encryptKey, size_t encryptKeySize,
+    const AiaEncryptionAlgorithm_t encryptAlgorithm,
+    mbedtls_cipher_id_t *cipher, size_t *sizeInBits )
 {
-    int mbedgcmError = 0;
-
     if( !encryptKey )
     {
         AiaLogError( "Null encryptKey." );
@@ -299,8 +615,8 @@ bool AiaCryptoMbedtls_SetKey( const uint8_t *encryptKey, size_t encryptKeySize,
         return false;
     }
 
-    size_t sizeInBits = AiaEncryptionAlgorithm_GetKeySize( encryptAlgorithm );
-    size_t expectedBytes = AiaBytesToHoldBits( sizeInBits );
+    *sizeInBits = AiaEncryptionAlgorithm_GetKeySize( encryptAlgorithm );
+    size_t expectedBytes = AiaBytesToHoldBits( *sizeInBits );
     if( encryptKeySize != expectedBytes )
     {
         AiaLogError( "Wrong encryptKeySize (%zu, expected %zu).",
@@ -310,44 +626,39 @@ bool AiaCryptoMbedtls_SetKey( const uint8_t *encryptKey, size_t encryptKeySize,
 
     /* Check that this is a supported algorithm. We support AES_GCM_128 and
      * AES_GCM_256. */
-    mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_NONE;
+    *cipher = MBEDTLS_CIPHER_ID_NONE;
     switch( encryptAlgorithm )
     {
         case AIA_AES_GCM:
-            cipher = MBEDTLS_CIPHER_ID_AES;
+            *cipher = MBEDTLS_CIPHER_ID_AES;
             break;
     }
-    if( MBEDTLS_CIPHER_ID_NONE == cipher )
+    if( MBEDTLS_CIPHER_ID_NONE == *cipher )
     {
         AiaLogError( "Unsupported encryptionAlgorithm %s",
                      AiaEncryptionAlgorithm_ToString( encryptAlgorithm ) );
         return false;
     }
 
-    /* Set the key */
-    AiaMutex( Lock )( &gcmMutex );
-
-    mbedgcmError =
-        mbedtls_gcm_setkey( &( g_gcmContext ), cipher, encryptKey, sizeInBits );
-
-    AiaMutex( Unlock )( &gcmMutex );
-
-    if( mbedgcmError != 0 )
-    {
-        AiaCryptoMbedtls_LogMbedtlsError( "Failed to set gcm key",
-                                          mbedgcmError );
-        return false;
-    }
-
     return true;
 }
 
-bool AiaCryptoMbedtls_Encrypt( const uint8_t *inputData, const size_t inputLen,
-                               uint8_t *outputData, uint8_t *iv, size_t ivLen,
-                               uint8_t *tag, const size_t tagLen )
+/**
+ * Validates the buffers passed to an encryption or decryption call.
+ *
+ * @param inputData The buffer that holds the data to encrypt/decrypt.
+ * @param inputLen The size of @c inputData in bytes.
+ * @param outputData The buffer that will hold the output data.
+ * @param iv The initialization vector buffer.
+ * @param tag The tag buffer.
+ * @return @c true if the buffers are valid, else @c false.
+ */
+static bool AiaCryptoMbedtls_ValidateBuffers( const uint8_t *inputData,
+                                              const size_t inputLen,
+                                              const uint8_t *outputData,
+                                              const uint8_t *iv,
+                                              const uint8_t *tag )
 {
-    int mbedgcmError = 0;
-
     /* Either inputLen should be 0 or input should be non-null */
     if( inputLen != 0 && !inputData )
     {
@@ -376,21 +687,134 @@ bool AiaCryptoMbedtls_Encrypt( const uint8_t *inputData, const size_t inputLen,
         return false;
     }
 
-    /* Create the IV */
-    mbedgcmError = mbedtls_ctr_drbg_random( &( g_ctrdrbgContext ), iv,
-                                            ivLen * sizeof( iv[ 0 ] ) );
+    return true;
+}
+
+/**
+ * Generates a random initialization vector for encryption.
+ *
+ * @param[out] iv The buffer to write the initialization vector into.
+ * @param ivLen The length of @c iv.
+ * @return @c true if the initialization vector was generated, else @c false.
+ */
+static bool AiaCryptoMbedtls_GenerateIv( uint8_t *iv, size_t ivLen )
+{
+    if( !AiaCryptoMbedtls_Seed() )
+    {
+        return false;
+    }
+    int mbedgcmError = mbedtls_ctr_drbg_random( &( g_ctrdrbgContext ), iv,
+                                                ivLen * sizeof( iv[ 0 ] ) );
     if( mbedgcmError != 0 )
     {
         AiaCryptoMbedtls_LogMbedtlsError( "Failed to create IV", mbedgcmError );
         return false;
     }
 
+    return true;
+}
+
+/**
+ * Generates an initialization vector for encryption with @c context.  IVs of
+ * the standard 96-bit length use the deterministic construction from NIST SP
+ * 800-38D: a random field drawn when the key is set followed by a counter, so
+ * that no random numbers need to be drawn per message.  Other lengths fall back
+ * to @c AiaCryptoMbedtls_GenerateIv().
+ *
+ * @param context The context to generate an initialization vector for.
+ * @param[out] iv The buffer to write the initialization vector into.
+ * @param ivLen The length of @c iv.
+ * @return @c true if the initialization vector was generated, else @c false.
+ */
+static bool AiaCryptoMbedtls_GenerateContextIv(
+    AiaCryptoMbedtlsContext_t *context, uint8_t *iv, size_t ivLen )
+{
+    if( ivLen != sizeof( context->ivPrefix ) + sizeof( context->ivCounter ) )
+    {
+        return AiaCryptoMbedtls_GenerateIv( iv, ivLen );
+    }
+
+    /* Draw the random field for a newly set key, or move to a fresh one
+     * rather than let the counter wrap. */
+    if( !context->hasIvPrefix || UINT32_MAX == context->ivCounter )
+    {
+        if( !AiaCryptoMbedtls_GenerateIv( context->ivPrefix,
+                                          sizeof( context->ivPrefix ) ) )
+        {
+            return false;
+        }
+        context->ivCounter = 0;
+        context->hasIvPrefix = true;
+    }
+
+    memcpy( iv, context->ivPrefix, sizeof( context->ivPrefix ) );
+    iv += sizeof( context->ivPrefix );
+    for( size_t i = 0; i < sizeof( context->ivCounter ); ++i )
+    {
+        iv[ i ] = context->ivCounter >>
+                  ( ( sizeof( context->ivCounter ) - 1 - i ) * 8 );
+    }
+    ++context->ivCounter;
+
+    return true;
+}
+
+bool AiaCryptoMbedtls_SetKey( const uint8_t *encryptKey, size_t encryptKeySize,
+                              const AiaEncryptionAlgorithm_t encryptAlgorithm )
+{
+    int mbedgcmError = 0;
+    mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_NONE;
+    size_t sizeInBits = 0;
+
+    if( !AiaCryptoMbedtls_ValidateKey( encryptKey, encryptKeySize,
+                                       encryptAlgorithm, &cipher,
+                                       &sizeInBits ) )
+    {
+        return false;
+    }
+
+    /* Set the key */
+    AiaMutex( Lock )( &gcmMutex );
+
+    mbedgcmError = AiaCryptoMbedtls_GcmSetKey( &( g_gcmContext ), cipher,
+                                               encryptKey, sizeInBits );
+
+    AiaMutex( Unlock )( &gcmMutex );
+
+    if( mbedgcmError != 0 )
+    {
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to set gcm key",
+                                          mbedgcmError );
+        return false;
+    }
+
+    return true;
+}
+
+bool AiaCryptoMbedtls_Encrypt( const uint8_t *inputData, const size_t inputLen,
+                               uint8_t *outputData, uint8_t *iv, size_t ivLen,
+                               uint8_t *tag, const size_t tagLen )
+{
+    int mbedgcmError = 0;
+
+    if( !AiaCryptoMbedtls_ValidateBuffers( inputData, inputLen, outputData, iv,
+                                           tag ) )
+    {
+        return false;
+    }
+
+    /* Create the IV */
+    if( !AiaCryptoMbedtls_GenerateIv( iv, ivLen ) )
+    {
+        return false;
+    }
+
     /* Perform the encryption */
     AiaMutex( Lock )( &gcmMutex );
 
-    mbedgcmError = mbedtls_gcm_crypt_and_tag(
-        &( g_gcmContext ), MBEDTLS_GCM_ENCRYPT, inputLen, iv, ivLen, NULL, 0,
-        inputData, outputData, tagLen, tag );
+    mbedgcmError = AiaCryptoMbedtls_GcmCryptAndTag(
+        &( g_gcmContext ), MBEDTLS_GCM_ENCRYPT, inputLen, iv, ivLen, inputData,
+        outputData, tagLen, tag );
 
     AiaMutex( Unlock )( &gcmMutex );
 
@@ -411,43 +835,146 @@ bool AiaCryptoMbedtls_Decrypt( const uint8_t *inputData, const size_t inputLen,
 {
     int mbedgcmError = 0;
 
-    /* Either inputLen should be 0 or input should be non-null */
-    if( inputLen != 0 && !inputData )
+    if( !AiaCryptoMbedtls_ValidateBuffers( inputData, inputLen, outputData, iv,
+                                           tag ) )
     {
-        AiaLogError( "Invalid input data for encryption." );
         return false;
     }
 
-    /* Either inputLen should be 0 or output should be non-null */
-    if( inputLen != 0 && !outputData )
+    /* Perform the decryption */
+    AiaMutex( Lock )( &gcmMutex );
+
+    mbedgcmError = AiaCryptoMbedtls_GcmAuthDecrypt( &( g_gcmContext ),
+                                                    inputLen, iv, ivLen, tag,
+                                                    tagLen, inputData,
+                                                    outputData );
+
+    AiaMutex( Unlock )( &gcmMutex );
+
+    if( mbedgcmError != 0 )
     {
-        AiaLogError( "Invalid output data for encryption." );
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to decrypt data",
+                                          mbedgcmError );
         return false;
     }
 
-    /* Check that IV is not null */
-    if( !iv )
+    return true;
+}
+
+AiaCryptoMbedtlsContext_t *AiaCryptoMbedtls_CreateContext()
+{
+    AiaCryptoMbedtlsContext_t *context = (AiaCryptoMbedtlsContext_t *)AiaCalloc(
+        1, sizeof( AiaCryptoMbedtlsContext_t ) );
+    if( !context )
     {
-        AiaLogError( "Null IV." );
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaCryptoMbedtlsContext_t ) );
+        return NULL;
+    }
+
+    AiaCryptoMbedtls_GcmInit( &( context->gcmContext ) );
+    return context;
+}
+
+bool AiaCryptoMbedtls_SetContextKey(
+    AiaCryptoMbedtlsContext_t *context, const uint8_t *encryptKey,
+    size_t encryptKeySize, const AiaEncryptionAlgorithm_t encryptAlgorithm )
+{
+    int mbedgcmError = 0;
+    mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_NONE;
+    size_t sizeInBits = 0;
+
+    if( !context )
+    {
+        AiaLogError( "Null context." );
         return false;
     }
 
-    /* Check the tag is not null */
-    if( !tag )
+    if( !AiaCryptoMbedtls_ValidateKey( encryptKey, encryptKeySize,
+                                       encryptAlgorithm, &cipher,
+                                       &sizeInBits ) )
     {
-        AiaLogError( "Null tag." );
         return false;
     }
 
-    /* Perform the decryption */
-    AiaMutex( Lock )( &gcmMutex );
+    mbedgcmError = AiaCryptoMbedtls_GcmSetKey( &( context->gcmContext ),
+                                               cipher, encryptKey, sizeInBits );
+    if( mbedgcmError != 0 )
+    {
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to set gcm key",
+                                          mbedgcmError );
+        return false;
+    }
 
-    mbedgcmError =
-        mbedtls_gcm_auth_decrypt( &( g_gcmContext ), inputLen, iv, ivLen, NULL,
-                                  0, tag, tagLen, inputData, outputData );
+    /* A fresh random field keeps IVs unique if the same key is set again, or
+     * set on another context. It is drawn on the next encryption. */
+    context->hasIvPrefix = false;
 
-    AiaMutex( Unlock )( &gcmMutex );
+    return true;
+}
+
+bool AiaCryptoMbedtls_EncryptWithContext( AiaCryptoMbedtlsContext_t *context,
+                                          const uint8_t *inputData,
+                                          const size_t inputLen,
+                                          uint8_t *outputData, uint8_t *iv,
+                                          size_t ivLen, uint8_t *tag,
+                                          const size_t tagLen )
+{
+    int mbedgcmError = 0;
+
+    if( !context )
+    {
+        AiaLogError( "Null context." );
+        return false;
+    }
+
+    if( !AiaCryptoMbedtls_ValidateBuffers( inputData, inputLen, outputData, iv,
+                                           tag ) )
+    {
+        return false;
+    }
+
+    /* Create the IV */
+    if( !AiaCryptoMbedtls_GenerateContextIv( context, iv, ivLen ) )
+    {
+        return false;
+    }
 
+    mbedgcmError = AiaCryptoMbedtls_GcmCryptAndTag(
+        &( context->gcmContext ), MBEDTLS_GCM_ENCRYPT, inputLen, iv, ivLen,
+        inputData, outputData, tagLen, tag );
+    if( mbedgcmError != 0 )
+    {
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to encrypt data",
+                                          mbedgcmError );
+        return false;
+    }
+
+    return true;
+}
+
+bool AiaCryptoMbedtls_DecryptWithContext(
+    AiaCryptoMbedtlsContext_t *context, const uint8_t *inputData,
+    const size_t inputLen, uint8_t *outputData, const uint8_t *iv,
+    const size_t ivLen, const uint8_t *tag, const size_t tagLen )
+{
+    int mbedgcmError = 0;
+
+    if( !context )
+    {
+        AiaLogError( "Null context." );
+        return false;
+    }
+
+    if( !AiaCryptoMbedtls_ValidateBuffers( inputData, inputLen, outputData, iv,
+                                           tag ) )
+    {
+        return false;
+    }
+
+    mbedgcmError = AiaCryptoMbedtls_GcmAuthDecrypt(
+        &( context->gcmContext ), inputLen, iv, ivLen, tag, tagLen, inputData,
+        outputData );
     if( mbedgcmError != 0 )
     {
         AiaCryptoMbedtls_LogMbedtlsError( "Failed to decrypt data",
@@ -458,6 +985,233 @@ bool AiaCryptoMbedtls_Decrypt( const uint8_t *inputData, const size_t inputLen,
     return true;
 }
 
+/**
+ * Encrypts or decrypts the concatenation of @c segments with a gcm operation
+ * already started on @c gcmContext. Every call to @c
+ * AiaCryptoMbedtls_GcmUpdate() but the last must be a multiple of the block
+ * size, so the bytes of a block which straddles segments are gathered into a
+ * staging block and the result scattered back.
+ *
+ * @param gcmContext The started gcm context.
+ * @param segments The regions of the message to process.
+ * @param numSegments The number of entries in @c segments.
+ * @return 0 on success, or an mbed TLS error code.
+ */
+static int AiaCryptoMbedtls_UpdateSegments(
+    AiaCryptoMbedtlsGcm_t *gcmContext,
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments )
+{
+    uint8_t block[ AIA_CRYPTO_MBEDTLS_GCM_BLOCK_SIZE ];
+    uint8_t *blockOutput[ AIA_CRYPTO_MBEDTLS_GCM_BLOCK_SIZE ];
+    size_t blockLength = 0;
+    int mbedgcmError = 0;
+
+    for( size_t i = 0; i < numSegments; ++i )
+    {
+        const uint8_t *input = segments[ i ].input;
+        uint8_t *output = segments[ i ].output;
+        size_t length = segments[ i ].length;
+        while( length )
+        {
+            /* Process whole blocks in place when nothing is staged. */
+            size_t bulk = length - length % sizeof( block );
+            if( !blockLength && bulk )
+            {
+                mbedgcmError = AiaCryptoMbedtls_GcmUpdate( gcmContext, bulk,
+                                                           input, output );
+                if( mbedgcmError )
+                {
+                    return mbedgcmError;
+                }
+                input += bulk;
+                output += bulk;
+                length -= bulk;
+                continue;
+            }
+
+            block[ blockLength ] = *input++;
+            blockOutput[ blockLength++ ] = output++;
+            --length;
+            if( sizeof( block ) == blockLength )
+            {
+                mbedgcmError = AiaCryptoMbedtls_GcmUpdate(
+                    gcmContext, blockLength, block, block );
+                if( mbedgcmError )
+                {
+                    return mbedgcmError;
+                }
+                for( size_t j = 0; j < blockLength; ++j )
+                {
+                    *blockOutput[ j ] = block[ j ];
+                }
+                blockLength = 0;
+            }
+        }
+    }
+
+    if( blockLength )
+    {
+        mbedgcmError = AiaCryptoMbedtls_GcmUpdate( gcmContext, blockLength,
+                                                   block, block );
+        if( mbedgcmError )
+        {
+            return mbedgcmError;
+        }
+        for( size_t j = 0; j < blockLength; ++j )
+        {
+            *blockOutput[ j ] = block[ j ];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Validates the segments passed to a scatter/gather encryption or decryption
+ * call.
+ *
+ * @param segments The regions of the message.
+ * @param numSegments The number of entries in @c segments.
+ * @param iv The initialization vector buffer.
+ * @param tag The tag buffer.
+ * @return @c true if the buffers are valid, else @c false.
+ */
+static bool AiaCryptoMbedtls_ValidateSegments(
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments,
+    const uint8_t *iv, const uint8_t *tag )
+{
+    if( numSegments && !segments )
+    {
+        AiaLogError( "Null segments." );
+        return false;
+    }
+    for( size_t i = 0; i < numSegments; ++i )
+    {
+        if( !AiaCryptoMbedtls_ValidateBuffers(
+                segments[ i ].input, segments[ i ].length,
+                segments[ i ].output, iv, tag ) )
+        {
+            AiaLogError( "Invalid segment %zu.", i );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AiaCryptoMbedtls_EncryptSegmentsWithContext(
+    AiaCryptoMbedtlsContext_t *context,
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments, uint8_t *iv,
+    size_t ivLen, uint8_t *tag, size_t tagLen )
+{
+    if( !context )
+    {
+        AiaLogError( "Null context." );
+        return false;
+    }
+
+    if( !AiaCryptoMbedtls_ValidateSegments( segments, numSegments, iv, tag ) )
+    {
+        return false;
+    }
+
+    /* Create the IV */
+    if( !AiaCryptoMbedtls_GenerateContextIv( context, iv, ivLen ) )
+    {
+        return false;
+    }
+
+    int mbedgcmError = AiaCryptoMbedtls_GcmStarts(
+        &( context->gcmContext ), MBEDTLS_GCM_ENCRYPT, iv, ivLen );
+    if( !mbedgcmError )
+    {
+        mbedgcmError = AiaCryptoMbedtls_UpdateSegments(
+            &( context->gcmContext ), segments, numSegments );
+    }
+    if( !mbedgcmError )
+    {
+        mbedgcmError = AiaCryptoMbedtls_GcmFinish( &( context->gcmContext ),
+                                                   tag, tagLen );
+    }
+    if( mbedgcmError != 0 )
+    {
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to encrypt data",
+                                          mbedgcmError );
+        return false;
+    }
+
+    return true;
+}
+
+bool AiaCryptoMbedtls_DecryptSegmentsWithContext(
+    AiaCryptoMbedtlsContext_t *context,
+    const AiaCryptoMbedtlsSegment_t *segments, size_t numSegments,
+    const uint8_t *iv, size_t ivLen, const uint8_t *tag, size_t tagLen )
+{
+    if( !context )
+    {
+        AiaLogError( "Null context." );
+        return false;
+    }
+
+    if( !AiaCryptoMbedtls_ValidateSegments( segments, numSegments, iv, tag ) )
+    {
+        return false;
+    }
+
+    uint8_t expectedTag[ AIA_CRYPTO_MBEDTLS_GCM_BLOCK_SIZE ];
+    if( !tagLen || tagLen > sizeof( expectedTag ) )
+    {
+        AiaLogError( "Invalid tagLen (%zu).", tagLen );
+        return false;
+    }
+
+    int mbedgcmError = AiaCryptoMbedtls_GcmStarts(
+        &( context->gcmContext ), MBEDTLS_GCM_DECRYPT, iv, ivLen );
+    if( !mbedgcmError )
+    {
+        mbedgcmError = AiaCryptoMbedtls_UpdateSegments(
+            &( context->gcmContext ), segments, numSegments );
+    }
+    if( !mbedgcmError )
+    {
+        mbedgcmError = AiaCryptoMbedtls_GcmFinish( &( context->gcmContext ),
+                                                   expectedTag, tagLen );
+    }
+    if( mbedgcmError != 0 )
+    {
+        AiaCryptoMbedtls_LogMbedtlsError( "Failed to decrypt data",
+                                          mbedgcmError );
+        return false;
+    }
+
+    if( AiaCryptoMbedtls_TagsDiffer( tag, expectedTag, tagLen ) )
+    {
+        for( size_t i = 0; i < numSegments; ++i )
+        {
+            if( segments[ i ].length )
+            {
+                memset( segments[ i ].output, 0, segments[ i ].length );
+            }
+        }
+        AiaLogError( "Failed to decrypt data. Error: tag mismatch" );
+        return false;
+    }
+
+    return true;
+}
+
+void AiaCryptoMbedtls_DestroyContext( AiaCryptoMbedtlsContext_t *context )
+{
+    if( !context )
+    {
+        AiaLogDebug( "Null context." );
+        return;
+    }
+
+    AiaCryptoMbedtls_GcmFree( &( context->gcmContext ) );
+    AiaFree( context );
+}
+
 /**
  * Key pair generation referencing example provided by mbedTLS
  * @see
@@ -479,6 +1233,12 @@ bool AiaCryptoMbedtls_GenerateKeyPair(
         return false;
     }
 
+    if( !AiaCryptoMbedtls_Seed() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Seed failed." );
+        return false;
+    }
+
     mbedtls_ecdh_context ecdhContext;
     mbedtls_ecdh_init( &( ecdhContext ) );
 
@@ -517,6 +1277,12 @@ bool AiaCryptoMbedtls_CalculateSharedSecret(
         return false;
     }
 
+    if( !AiaCryptoMbedtls_Seed() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Seed failed." );
+        return false;
+    }
+
     mbedtls_ecdh_context ecdhContext;
     mbedtls_ecdh_init( &( ecdhContext ) );
 
@@ -538,9 +1304,14 @@ void AiaCryptoMbedtls_Cleanup()
 {
     /* Free the contexts for gcm. */
     AiaMutex( Lock )( &gcmMutex );
-    mbedtls_gcm_free( &( g_gcmContext ) );
+    AiaCryptoMbedtls_GcmFree( &( g_gcmContext ) );
     AiaMutex( Unlock )( &gcmMutex );
 
+#ifdef AIA_ENABLE_ASYNC_CRYPTO_SEED
+    AiaTimer( Destroy )( &g_seedWorker );
+#endif
+    AiaMutex( Destroy )( &g_seedMutex );
+
     /* Free the RNG contexts */
     mbedtls_entropy_free( &( g_entropyContext ) );
     mbedtls_ctr_drbg_free( &( g_ctrdrbgContext ) );
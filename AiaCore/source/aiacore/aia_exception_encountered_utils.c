@@ -69,6 +69,45 @@ AiaJsonMessage_t* generateMalformedMessageExceptionEncounteredEvent(
     return jsonMessage;
 }
 
+AiaJsonMessage_t* generateCoalescedMalformedMessageExceptionEncounteredEvent(
+    AiaSequenceNumber_t firstSequenceNumber, AiaSequenceNumber_t sequenceNumber,
+    size_t index, AiaTopic_t topic, size_t count )
+{
+    static const char* formatPayload =
+        /* clang-format off */
+        "{"
+            "\"" AIA_EXCEPTION_ENCOUNTERED_ERROR_KEY "\": {"
+                "\"" AIA_EXCEPTION_ENCOUNTERED_ERROR_CODE_KEY "\":\"" AIA_EXCEPTION_ENCOUNTERED_MALFORMED_MESSAGE_CODE "\","
+                "\"" AIA_EXCEPTION_ENCOUNTERED_ERROR_DESCRIPTION_KEY "\":\"" "%zu malformed messages, sequence numbers %"PRIu32" to %"PRIu32 "\""
+            "},"
+            "\"" AIA_EXCEPTION_ENCOUNTERED_MESSAGE_KEY "\": {"
+                "\"" AIA_EXCEPTION_ENCOUNTERED_MESSAGE_TOPIC_KEY "\":\"" "%s" "\","
+                "\"" AIA_EXCEPTION_ENCOUNTERED_MESSAGE_SEQUENCE_NUMBER_KEY "\": %"PRIu32","
+                "\"" AIA_EXCEPTION_ENCOUNTERED_MESSAGE_INDEX_KEY "\": %zu"
+            "}"
+        "}";
+    /* clang-format on */
+    int numCharsRequired = snprintf(
+        NULL, 0, formatPayload, count, firstSequenceNumber, sequenceNumber,
+        AiaTopic_ToString( topic ), sequenceNumber, index );
+    if( numCharsRequired < 0 )
+    {
+        AiaLogError( "snprintf failed" );
+        return NULL;
+    }
+    char fullPayloadBuffer[ numCharsRequired + 1 ];
+    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload, count,
+                  firstSequenceNumber, sequenceNumber,
+                  AiaTopic_ToString( topic ), sequenceNumber, index ) < 0 )
+    {
+        AiaLogError( "snprintf failed" );
+        return NULL;
+    }
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
+        AIA_EVENTS_EXCEPTION_ENCOUNTERED, NULL, fullPayloadBuffer );
+    return jsonMessage;
+}
+
 AiaJsonMessage_t* generateInternalErrorExceptionEncounteredEvent()
 {
     char* payload =
@@ -0,0 +1,366 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_exception_limiter.c
+ * @brief Implements functions for the AiaExceptionLimiter_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_exception_encountered_utils.h>
+#include <aiacore/aia_exception_limiter.h>
+#include <aiacore/aia_overload_governor.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaTimer( HEADER )
+
+#include <inttypes.h>
+
+/** A run of reports on one topic which have not been sent yet. */
+typedef struct AiaExceptionLimiterRun
+{
+    /** The number of reports in the run, or zero if there is no run. */
+    size_t count;
+
+    /** The sequence number of the first report in the run. */
+    AiaSequenceNumber_t firstSequenceNumber;
+
+    /** The sequence number of the last report in the run. */
+    AiaSequenceNumber_t lastSequenceNumber;
+
+    /** The index of the last report in the run. */
+    size_t lastIndex;
+} AiaExceptionLimiterRun_t;
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaExceptionLimiter_t abstraction.
+ */
+struct AiaExceptionLimiter
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** The number of events that may be sent right now. */
+    size_t tokens;
+
+    /** The time up to which tokens have been returned to the bucket. */
+    AiaTimepointMs_t lastRefillMs;
+
+    /** Reports coalesced while the bucket was empty, indexed by topic. */
+    AiaExceptionLimiterRun_t runs[ AIA_NUM_TOPICS ];
+
+    /** Whether @c flushTimer is armed. */
+    bool isFlushPending;
+
+    /** @} */
+
+    /** Sends coalesced runs which no later report has carried once tokens
+     * are returned to the bucket. */
+    AiaTimer_t flushTimer;
+
+    /** Used to publish events. */
+    AiaRegulator_t* const eventRegulator;
+
+    /** The size of the bucket. */
+    const size_t burst;
+
+    /** The time it takes to return one token to the bucket. */
+    const AiaDurationMs_t refillIntervalMs;
+};
+
+/**
+ * Returns the tokens earned since the last refill to the bucket.
+ *
+ * @param limiter The @c AiaExceptionLimiter_t to act on.
+ * @note This must be called while holding @c limiter->mutex.
+ */
+static void AiaExceptionLimiter_RefillLocked( AiaExceptionLimiter_t* limiter )
+{
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+    size_t missing = limiter->burst - limiter->tokens;
+    AiaTimepointMs_t refills =
+        ( now - limiter->lastRefillMs ) / limiter->refillIntervalMs;
+    if( refills >= missing )
+    {
+        /* A full bucket does not bank time towards later tokens. */
+        limiter->tokens = limiter->burst;
+        limiter->lastRefillMs = now;
+        return;
+    }
+    limiter->tokens += refills;
+    limiter->lastRefillMs += refills * limiter->refillIntervalMs;
+}
+
+/**
+ * Arms @c limiter->flushTimer to go off when the next token is returned to the
+ * bucket, or after one refill interval if there are tokens left, which happens
+ * while events are being shed. Nothing is done if the timer is armed already.
+ *
+ * @param limiter The @c AiaExceptionLimiter_t to act on.
+ * @note This must be called while holding @c limiter->mutex.
+ */
+static void AiaExceptionLimiter_ArmFlushLocked( AiaExceptionLimiter_t* limiter )
+{
+    if( limiter->isFlushPending )
+    {
+        return;
+    }
+    AiaDurationMs_t delayMs = limiter->refillIntervalMs;
+    if( !limiter->tokens )
+    {
+        AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+        AiaTimepointMs_t dueMs =
+            limiter->lastRefillMs + limiter->refillIntervalMs;
+        delayMs = dueMs > now ? dueMs - now : 0;
+    }
+    if( !AiaTimer( Arm )( &limiter->flushTimer, delayMs, 0 ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
+        return;
+    }
+    limiter->isFlushPending = true;
+}
+
+/**
+ * Generates and writes the event for a run of reports.
+ *
+ * @param limiter The @c AiaExceptionLimiter_t to act on.
+ * @param run The run to send, ending with the report being sent now.
+ * @param topic The topic of the run.
+ * @return @c true if the event was written, or @c false otherwise.
+ */
+static bool AiaExceptionLimiter_SendRun( AiaExceptionLimiter_t* limiter,
+                                         const AiaExceptionLimiterRun_t* run,
+                                         AiaTopic_t topic )
+{
+    AiaJsonMessage_t* malformedMessageEvent =
+        run->count > 1
+            ? generateCoalescedMalformedMessageExceptionEncounteredEvent(
+                  run->firstSequenceNumber, run->lastSequenceNumber,
+                  run->lastIndex, topic, run->count )
+            : generateMalformedMessageExceptionEncounteredEvent(
+                  run->lastSequenceNumber, run->lastIndex, topic );
+    if( !malformedMessageEvent )
+    {
+        AiaLogError(
+            "generateMalformedMessageExceptionEncounteredEvent failed" );
+        return false;
+    }
+    if( !AiaRegulator_Write(
+            limiter->eventRegulator,
+            AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+    {
+        AiaLogError( "AiaRegulator_Write failed" );
+        AiaJsonMessage_Destroy( malformedMessageEvent );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Sends the coalesced runs that the bucket has tokens for, and arms the timer
+ * again if any are left.
+ *
+ * @param context The @c AiaExceptionLimiter_t to act on.
+ */
+static void AiaExceptionLimiter_FlushRoutine( void* context )
+{
+    AiaExceptionLimiter_t* limiter = (AiaExceptionLimiter_t*)context;
+    AiaAssert( limiter );
+    if( !limiter )
+    {
+        AiaLogError( "Null limiter." );
+        return;
+    }
+
+    AiaExceptionLimiterRun_t runs[ AIA_NUM_TOPICS ] = { { 0 } };
+    AiaMutex( Lock )( &limiter->mutex );
+    limiter->isFlushPending = false;
+    AiaExceptionLimiter_RefillLocked( limiter );
+    bool isShed = false;
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    isShed =
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_NON_CRITICAL_EVENTS );
+#endif
+    bool isRunLeft = false;
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( !limiter->runs[ i ].count )
+        {
+            continue;
+        }
+        if( isShed || !limiter->tokens )
+        {
+            isRunLeft = true;
+            continue;
+        }
+        --limiter->tokens;
+        runs[ i ] = limiter->runs[ i ];
+        limiter->runs[ i ].count = 0;
+    }
+    if( isRunLeft )
+    {
+        AiaExceptionLimiter_ArmFlushLocked( limiter );
+    }
+    AiaMutex( Unlock )( &limiter->mutex );
+
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( runs[ i ].count &&
+            !AiaExceptionLimiter_SendRun( limiter, &runs[ i ],
+                                          (AiaTopic_t)i ) )
+        {
+            AiaLogError( "AiaExceptionLimiter_SendRun failed, topic=%s",
+                         AiaTopic_ToString( (AiaTopic_t)i ) );
+        }
+    }
+}
+
+AiaExceptionLimiter_t* AiaExceptionLimiter_Create(
+    AiaRegulator_t* eventRegulator, size_t burst,
+    AiaDurationMs_t refillIntervalMs )
+{
+    if( !eventRegulator )
+    {
+        AiaLogError( "Null eventRegulator." );
+        return NULL;
+    }
+    if( !burst || !refillIntervalMs )
+    {
+        AiaLogError( "Invalid bucket, burst=%zu, refillIntervalMs=%" PRIu32,
+                     burst, refillIntervalMs );
+        return NULL;
+    }
+
+    AiaExceptionLimiter_t* limiter =
+        AiaCalloc( 1, sizeof( AiaExceptionLimiter_t ) );
+    if( !limiter )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaExceptionLimiter_t ) );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &limiter->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( limiter );
+        return NULL;
+    }
+    if( !AiaTimer( Create )( &limiter->flushTimer,
+                             AiaExceptionLimiter_FlushRoutine, limiter ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &limiter->mutex );
+        AiaFree( limiter );
+        return NULL;
+    }
+
+    *(AiaRegulator_t**)&limiter->eventRegulator = eventRegulator;
+    *(size_t*)&limiter->burst = burst;
+    *(AiaDurationMs_t*)&limiter->refillIntervalMs = refillIntervalMs;
+    limiter->tokens = burst;
+    limiter->lastRefillMs = AiaClock( GetTimeMs )();
+    return limiter;
+}
+
+void AiaExceptionLimiter_Destroy( AiaExceptionLimiter_t* limiter )
+{
+    if( !limiter )
+    {
+        AiaLogDebug( "Null limiter." );
+        return;
+    }
+    /* The flush routine locks @c mutex, so it must not be held while waiting
+     * for it to finish. */
+    AiaTimer( Destroy )( &limiter->flushTimer );
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( limiter->runs[ i ].count )
+        {
+            AiaLogWarn( "Dropping %zu coalesced reports on %s.",
+                        limiter->runs[ i ].count,
+                        AiaTopic_ToString( (AiaTopic_t)i ) );
+        }
+    }
+    AiaMutex( Destroy )( &limiter->mutex );
+    AiaFree( limiter );
+}
+
+bool AiaExceptionLimiter_ReportMalformedMessage(
+    AiaExceptionLimiter_t* limiter, AiaSequenceNumber_t sequenceNumber,
+    size_t index, AiaTopic_t topic )
+{
+    if( !limiter )
+    {
+        AiaLogError( "Null limiter." );
+        return false;
+    }
+    if( (int)topic < 0 || topic >= AIA_NUM_TOPICS )
+    {
+        AiaLogError( "Invalid topic, topic=%d", topic );
+        return false;
+    }
+
+    AiaMutex( Lock )( &limiter->mutex );
+    AiaExceptionLimiter_RefillLocked( limiter );
+    AiaExceptionLimiterRun_t* run = &limiter->runs[ topic ];
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    /* While overloaded, reports are only coalesced, to be carried by the next
+     * event sent once load subsides. */
+    if( !limiter->tokens ||
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_NON_CRITICAL_EVENTS ) )
+#else
+    if( !limiter->tokens )
+#endif
+    {
+        if( !run->count )
+        {
+            run->firstSequenceNumber = sequenceNumber;
+        }
+        run->lastSequenceNumber = sequenceNumber;
+        run->lastIndex = index;
+        ++run->count;
+        AiaExceptionLimiter_ArmFlushLocked( limiter );
+        AiaMutex( Unlock )( &limiter->mutex );
+        AiaLogDebug( "Coalesced malformed message report, topic=%s, "
+                     "sequenceNumber=%" PRIu32 ", index=%zu",
+                     AiaTopic_ToString( topic ), sequenceNumber, index );
+        return true;
+    }
+    --limiter->tokens;
+
+    /* Fold the reports coalesced since the last event on this topic into this
+     * one. */
+    AiaExceptionLimiterRun_t toSend = *run;
+    if( !toSend.count )
+    {
+        toSend.firstSequenceNumber = sequenceNumber;
+    }
+    toSend.lastSequenceNumber = sequenceNumber;
+    toSend.lastIndex = index;
+    ++toSend.count;
+    run->count = 0;
+    AiaMutex( Unlock )( &limiter->mutex );
+
+    return AiaExceptionLimiter_SendRun( limiter, &toSend, topic );
+}
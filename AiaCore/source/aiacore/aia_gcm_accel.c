@@ -0,0 +1,553 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_gcm_accel.c
+ * @brief Implements functions for the AiaGcmAccel_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_gcm_accel.h>
+
+#include <string.h>
+
+/* Each architecture provides a block type and the primitives below it, which
+ * the mode itself is written in terms of. Both architectures are
+ * little-endian, which the key expansion relies on. */
+#if( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define AIA_GCM_ACCEL_HAS_KERNELS
+
+/* The instructions are enabled per function rather than for the whole build,
+ * so that nothing else is compiled to need them. */
+#define AIA_GCM_ACCEL_TARGET __attribute__( ( target( "aes,pclmul,ssse3" ) ) )
+
+typedef __m128i AiaGcmAccelBlock_t;
+
+bool AiaGcmAccel_IsSupported()
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+    {
+        return false;
+    }
+    return ( ecx & bit_AES ) && ( ecx & bit_PCLMUL ) && ( ecx & bit_SSSE3 );
+}
+
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Load( const uint8_t* bytes )
+{
+    return _mm_loadu_si128( (const __m128i*)bytes );
+}
+
+static inline AIA_GCM_ACCEL_TARGET void AiaGcmAccel_Store(
+    uint8_t* bytes, AiaGcmAccelBlock_t block )
+{
+    _mm_storeu_si128( (__m128i*)bytes, block );
+}
+
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Xor( AiaGcmAccelBlock_t a, AiaGcmAccelBlock_t b )
+{
+    return _mm_xor_si128( a, b );
+}
+
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Reverse( AiaGcmAccelBlock_t block )
+{
+    return _mm_shuffle_epi8(
+        block, _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                             15 ) );
+}
+
+/** Applies the AES S-box to each byte of @c word. */
+static inline AIA_GCM_ACCEL_TARGET uint32_t AiaGcmAccel_SubWord( uint32_t word )
+{
+    /* With four identical columns, ShiftRows leaves the state unchanged. */
+    return (uint32_t)_mm_cvtsi128_si32( _mm_aesenclast_si128(
+        _mm_set1_epi32( (int)word ), _mm_setzero_si128() ) );
+}
+
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Encrypt( const AiaGcmAccel_t* gcm, AiaGcmAccelBlock_t block )
+{
+    block = _mm_xor_si128( block, AiaGcmAccel_Load( gcm->roundKeys[ 0 ] ) );
+    for( size_t round = 1; round < gcm->numRounds; ++round )
+    {
+        block = _mm_aesenc_si128( block,
+                                  AiaGcmAccel_Load( gcm->roundKeys[ round ] ) );
+    }
+    return _mm_aesenclast_si128(
+        block, AiaGcmAccel_Load( gcm->roundKeys[ gcm->numRounds ] ) );
+}
+
+/**
+ * Multiplies two byte-reversed elements of GF(2^128), following the Intel
+ * Carry-Less Multiplication Instruction white paper.
+ */
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Multiply( AiaGcmAccelBlock_t a, AiaGcmAccelBlock_t b )
+{
+    /* 256-bit carry-less product, in low:high. */
+    __m128i low = _mm_clmulepi64_si128( a, b, 0x00 );
+    __m128i middle = _mm_xor_si128( _mm_clmulepi64_si128( a, b, 0x10 ),
+                                    _mm_clmulepi64_si128( a, b, 0x01 ) );
+    __m128i high = _mm_clmulepi64_si128( a, b, 0x11 );
+    low = _mm_xor_si128( low, _mm_slli_si128( middle, 8 ) );
+    high = _mm_xor_si128( high, _mm_srli_si128( middle, 8 ) );
+
+    /* Shift the product left by one bit to undo the bit reflection. */
+    __m128i lowCarry = _mm_srli_epi32( low, 31 );
+    __m128i highCarry = _mm_srli_epi32( high, 31 );
+    low = _mm_slli_epi32( low, 1 );
+    high = _mm_slli_epi32( high, 1 );
+    high = _mm_or_si128( high, _mm_srli_si128( lowCarry, 12 ) );
+    high = _mm_or_si128( high, _mm_slli_si128( highCarry, 4 ) );
+    low = _mm_or_si128( low, _mm_slli_si128( lowCarry, 4 ) );
+
+    /* Reduce modulo x^128 + x^7 + x^2 + x + 1. */
+    __m128i fold = _mm_xor_si128(
+        _mm_xor_si128( _mm_slli_epi32( low, 31 ), _mm_slli_epi32( low, 30 ) ),
+        _mm_slli_epi32( low, 25 ) );
+    __m128i foldCarry = _mm_srli_si128( fold, 4 );
+    low = _mm_xor_si128( low, _mm_slli_si128( fold, 12 ) );
+    __m128i reduced = _mm_xor_si128(
+        _mm_xor_si128( _mm_srli_epi32( low, 1 ), _mm_srli_epi32( low, 2 ) ),
+        _mm_xor_si128( _mm_srli_epi32( low, 7 ), foldCarry ) );
+    return _mm_xor_si128( high, _mm_xor_si128( low, reduced ) );
+}
+
+#elif defined( __aarch64__ ) && \
+    ( defined( __ARM_FEATURE_CRYPTO ) || defined( __ARM_FEATURE_AES ) )
+
+#include <arm_neon.h>
+#if defined( __linux__ )
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#define AIA_GCM_ACCEL_HAS_KERNELS
+
+/* The instructions are enabled for this file only by the build, as compilers
+ * disagree on how to enable them per function. */
+#define AIA_GCM_ACCEL_TARGET
+
+typedef uint8x16_t AiaGcmAccelBlock_t;
+
+bool AiaGcmAccel_IsSupported()
+{
+#if defined( __linux__ )
+    unsigned long hwcaps = getauxval( AT_HWCAP );
+    return ( hwcaps & HWCAP_AES ) && ( hwcaps & HWCAP_PMULL );
+#elif defined( __APPLE__ )
+    /* Every Apple AArch64 CPU implements them. */
+    return true;
+#else
+    return false;
+#endif
+}
+
+static inline AiaGcmAccelBlock_t AiaGcmAccel_Load( const uint8_t* bytes )
+{
+    return vld1q_u8( bytes );
+}
+
+static inline void AiaGcmAccel_Store( uint8_t* bytes,
+                                      AiaGcmAccelBlock_t block )
+{
+    vst1q_u8( bytes, block );
+}
+
+static inline AiaGcmAccelBlock_t AiaGcmAccel_Xor( AiaGcmAccelBlock_t a,
+                                                  AiaGcmAccelBlock_t b )
+{
+    return veorq_u8( a, b );
+}
+
+static inline AiaGcmAccelBlock_t AiaGcmAccel_Reverse(
+    AiaGcmAccelBlock_t block )
+{
+    block = vrev64q_u8( block );
+    return vextq_u8( block, block, 8 );
+}
+
+/** Applies the AES S-box to each byte of @c word. */
+static inline uint32_t AiaGcmAccel_SubWord( uint32_t word )
+{
+    /* With four identical columns, ShiftRows leaves the state unchanged. */
+    return vgetq_lane_u32(
+        vreinterpretq_u32_u8( vaeseq_u8(
+            vreinterpretq_u8_u32( vdupq_n_u32( word ) ), vdupq_n_u8( 0 ) ) ),
+        0 );
+}
+
+static inline AiaGcmAccelBlock_t AiaGcmAccel_Encrypt(
+    const AiaGcmAccel_t* gcm, AiaGcmAccelBlock_t block )
+{
+    /* AESE adds the round key before substituting, rather than after mixing
+     * as AESENC does, so the rounds are shifted by one key. */
+    for( size_t round = 0; round + 1 < gcm->numRounds; ++round )
+    {
+        block = vaesmcq_u8(
+            vaeseq_u8( block, AiaGcmAccel_Load( gcm->roundKeys[ round ] ) ) );
+    }
+    block = vaeseq_u8(
+        block, AiaGcmAccel_Load( gcm->roundKeys[ gcm->numRounds - 1 ] ) );
+    return veorq_u8( block,
+                     AiaGcmAccel_Load( gcm->roundKeys[ gcm->numRounds ] ) );
+}
+
+/** Carry-less multiplies the given 64-bit lanes of @c a and @c b. */
+static inline uint8x16_t AiaGcmAccel_MultiplyLanes( uint8x16_t a, int aLane,
+                                                    uint8x16_t b, int bLane )
+{
+    poly64x2_t a64 = vreinterpretq_p64_u8( a );
+    poly64x2_t b64 = vreinterpretq_p64_u8( b );
+    return vreinterpretq_u8_p128(
+        vmull_p64( aLane ? vgetq_lane_p64( a64, 1 ) : vgetq_lane_p64( a64, 0 ),
+                   bLane ? vgetq_lane_p64( b64, 1 )
+                         : vgetq_lane_p64( b64, 0 ) ) );
+}
+
+/** Shifts @c block left, towards its last byte, by @c n bytes. */
+#define AIA_GCM_ACCEL_SHIFT_LEFT_BYTES( block, n ) \
+    vextq_u8( vdupq_n_u8( 0 ), ( block ), 16 - ( n ) )
+
+/** Shifts @c block right, towards its first byte, by @c n bytes. */
+#define AIA_GCM_ACCEL_SHIFT_RIGHT_BYTES( block, n ) \
+    vextq_u8( ( block ), vdupq_n_u8( 0 ), ( n ) )
+
+/** Shifts each 32-bit lane of @c block left by @c n bits. */
+#define AIA_GCM_ACCEL_SHIFT_LEFT_LANES( block, n ) \
+    vreinterpretq_u8_u32( vshlq_n_u32( vreinterpretq_u32_u8( block ), n ) )
+
+/** Shifts each 32-bit lane of @c block right by @c n bits. */
+#define AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( block, n ) \
+    vreinterpretq_u8_u32( vshrq_n_u32( vreinterpretq_u32_u8( block ), n ) )
+
+/**
+ * Multiplies two byte-reversed elements of GF(2^128). This is the same
+ * algorithm as the x86 kernel, with PMULL in place of PCLMULQDQ.
+ */
+static inline AiaGcmAccelBlock_t AiaGcmAccel_Multiply( AiaGcmAccelBlock_t a,
+                                                       AiaGcmAccelBlock_t b )
+{
+    /* 256-bit carry-less product, in low:high. */
+    uint8x16_t low = AiaGcmAccel_MultiplyLanes( a, 0, b, 0 );
+    uint8x16_t middle = veorq_u8( AiaGcmAccel_MultiplyLanes( a, 0, b, 1 ),
+                                  AiaGcmAccel_MultiplyLanes( a, 1, b, 0 ) );
+    uint8x16_t high = AiaGcmAccel_MultiplyLanes( a, 1, b, 1 );
+    low = veorq_u8( low, AIA_GCM_ACCEL_SHIFT_LEFT_BYTES( middle, 8 ) );
+    high = veorq_u8( high, AIA_GCM_ACCEL_SHIFT_RIGHT_BYTES( middle, 8 ) );
+
+    /* Shift the product left by one bit to undo the bit reflection. */
+    uint8x16_t lowCarry = AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( low, 31 );
+    uint8x16_t highCarry = AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( high, 31 );
+    low = AIA_GCM_ACCEL_SHIFT_LEFT_LANES( low, 1 );
+    high = AIA_GCM_ACCEL_SHIFT_LEFT_LANES( high, 1 );
+    high = vorrq_u8( high, AIA_GCM_ACCEL_SHIFT_RIGHT_BYTES( lowCarry, 12 ) );
+    high = vorrq_u8( high, AIA_GCM_ACCEL_SHIFT_LEFT_BYTES( highCarry, 4 ) );
+    low = vorrq_u8( low, AIA_GCM_ACCEL_SHIFT_LEFT_BYTES( lowCarry, 4 ) );
+
+    /* Reduce modulo x^128 + x^7 + x^2 + x + 1. */
+    uint8x16_t fold =
+        veorq_u8( veorq_u8( AIA_GCM_ACCEL_SHIFT_LEFT_LANES( low, 31 ),
+                            AIA_GCM_ACCEL_SHIFT_LEFT_LANES( low, 30 ) ),
+                  AIA_GCM_ACCEL_SHIFT_LEFT_LANES( low, 25 ) );
+    uint8x16_t foldCarry = AIA_GCM_ACCEL_SHIFT_RIGHT_BYTES( fold, 4 );
+    low = veorq_u8( low, AIA_GCM_ACCEL_SHIFT_LEFT_BYTES( fold, 12 ) );
+    uint8x16_t reduced =
+        veorq_u8( veorq_u8( AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( low, 1 ),
+                            AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( low, 2 ) ),
+                  veorq_u8( AIA_GCM_ACCEL_SHIFT_RIGHT_LANES( low, 7 ),
+                            foldCarry ) );
+    return veorq_u8( high, veorq_u8( low, reduced ) );
+}
+
+#endif
+
+#ifdef AIA_GCM_ACCEL_HAS_KERNELS
+
+/** The longest message gcm allows, in bytes. */
+#define AIA_GCM_ACCEL_MAX_LENGTH ( ( (uint64_t)1 << 36 ) - 32 )
+
+/** Increments the last 32 bits of a big-endian counter block. */
+static void AiaGcmAccel_IncrementCounter( uint8_t* counter )
+{
+    for( size_t i = AIA_GCM_ACCEL_BLOCK_SIZE; i > AIA_GCM_ACCEL_BLOCK_SIZE - 4;
+         --i )
+    {
+        if( ++counter[ i - 1 ] )
+        {
+            break;
+        }
+    }
+}
+
+/** Writes @c value as big-endian into the 8 bytes at @c bytes. */
+static void AiaGcmAccel_StoreLength( uint8_t* bytes, uint64_t value )
+{
+    for( size_t i = 0; i < 8; ++i )
+    {
+        bytes[ i ] = (uint8_t)( value >> ( ( 7 - i ) * 8 ) );
+    }
+}
+
+/** Folds a (zero-padded) block of data into a byte-reversed GHASH value. */
+static inline AIA_GCM_ACCEL_TARGET AiaGcmAccelBlock_t
+AiaGcmAccel_Hash( const AiaGcmAccel_t* gcm, AiaGcmAccelBlock_t hash,
+                  AiaGcmAccelBlock_t data )
+{
+    return AiaGcmAccel_Multiply(
+        AiaGcmAccel_Xor( hash, AiaGcmAccel_Reverse( data ) ),
+        AiaGcmAccel_Load( gcm->hashKey ) );
+}
+
+AIA_GCM_ACCEL_TARGET bool AiaGcmAccel_SetKey( AiaGcmAccel_t* gcm,
+                                              const uint8_t* key,
+                                              size_t keyBits )
+{
+    if( !gcm || !key )
+    {
+        AiaLogError( "Null %s.", gcm ? "key" : "gcm" );
+        return false;
+    }
+    if( keyBits != 128 && keyBits != 192 && keyBits != 256 )
+    {
+        AiaLogError( "Invalid keyBits (%zu).", keyBits );
+        return false;
+    }
+
+    /* FIPS-197 key expansion, on words holding the key bytes in order. */
+    uint32_t words[ AIA_GCM_ACCEL_MAX_ROUND_KEYS * 4 ];
+    size_t keyWords = keyBits / 32;
+    size_t numRounds = keyWords + 6;
+    memcpy( words, key, keyBits / 8 );
+    uint32_t roundConstant = 1;
+    for( size_t i = keyWords; i < ( numRounds + 1 ) * 4; ++i )
+    {
+        uint32_t word = words[ i - 1 ];
+        if( 0 == i % keyWords )
+        {
+            word = AiaGcmAccel_SubWord( ( word >> 8 ) | ( word << 24 ) ) ^
+                   roundConstant;
+            roundConstant = ( roundConstant << 1 ) ^
+                            ( ( roundConstant >> 7 ) * 0x11b );
+        }
+        else if( keyWords > 6 && 4 == i % keyWords )
+        {
+            word = AiaGcmAccel_SubWord( word );
+        }
+        words[ i ] = words[ i - keyWords ] ^ word;
+    }
+    memcpy( gcm->roundKeys, words, ( numRounds + 1 ) * 4 * sizeof( *words ) );
+    gcm->numRounds = numRounds;
+    memset( words, 0, sizeof( words ) );
+
+    /* H is the encryption of the zero block. */
+    uint8_t zero[ AIA_GCM_ACCEL_BLOCK_SIZE ] = { 0 };
+    AiaGcmAccel_Store( gcm->hashKey,
+                       AiaGcmAccel_Reverse( AiaGcmAccel_Encrypt(
+                           gcm, AiaGcmAccel_Load( zero ) ) ) );
+    return true;
+}
+
+AIA_GCM_ACCEL_TARGET bool AiaGcmAccel_Starts( AiaGcmAccel_t* gcm,
+                                              bool isDecrypting,
+                                              const uint8_t* iv, size_t ivLen )
+{
+    if( !gcm || !iv || !ivLen )
+    {
+        AiaLogError( "Invalid arguments." );
+        return false;
+    }
+
+    uint8_t block[ AIA_GCM_ACCEL_BLOCK_SIZE ] = { 0 };
+    if( 12 == ivLen )
+    {
+        /* J0 = IV || 0^31 || 1 */
+        memcpy( block, iv, ivLen );
+        block[ AIA_GCM_ACCEL_BLOCK_SIZE - 1 ] = 1;
+        memcpy( gcm->counter, block, sizeof( block ) );
+    }
+    else
+    {
+        /* J0 = GHASH( IV || 0^s || 0^64 || [len( IV )]64 ) */
+        AiaGcmAccelBlock_t hash = AiaGcmAccel_Load( block );
+        for( size_t offset = 0; offset < ivLen; offset += sizeof( block ) )
+        {
+            size_t length = ivLen - offset < sizeof( block ) ? ivLen - offset
+                                                              : sizeof( block );
+            memset( block, 0, sizeof( block ) );
+            memcpy( block, iv + offset, length );
+            hash = AiaGcmAccel_Hash( gcm, hash, AiaGcmAccel_Load( block ) );
+        }
+        memset( block, 0, sizeof( block ) );
+        AiaGcmAccel_StoreLength( block + 8, (uint64_t)ivLen * 8 );
+        hash = AiaGcmAccel_Hash( gcm, hash, AiaGcmAccel_Load( block ) );
+        AiaGcmAccel_Store( gcm->counter, AiaGcmAccel_Reverse( hash ) );
+    }
+
+    AiaGcmAccel_Store(
+        gcm->encryptedJ0,
+        AiaGcmAccel_Encrypt( gcm, AiaGcmAccel_Load( gcm->counter ) ) );
+    AiaGcmAccel_IncrementCounter( gcm->counter );
+    memset( gcm->hash, 0, sizeof( gcm->hash ) );
+    gcm->length = 0;
+    gcm->isDecrypting = isDecrypting;
+    return true;
+}
+
+AIA_GCM_ACCEL_TARGET bool AiaGcmAccel_Update( AiaGcmAccel_t* gcm,
+                                              size_t length,
+                                              const uint8_t* input,
+                                              uint8_t* output )
+{
+    if( !gcm || ( length && ( !input || !output ) ) )
+    {
+        AiaLogError( "Invalid arguments." );
+        return false;
+    }
+    if( gcm->length % AIA_GCM_ACCEL_BLOCK_SIZE )
+    {
+        AiaLogError( "Update after a partial block." );
+        return false;
+    }
+    if( length > AIA_GCM_ACCEL_MAX_LENGTH - gcm->length )
+    {
+        AiaLogError( "Message too long." );
+        return false;
+    }
+    gcm->length += length;
+
+    AiaGcmAccelBlock_t hash = AiaGcmAccel_Load( gcm->hash );
+    while( length >= AIA_GCM_ACCEL_BLOCK_SIZE )
+    {
+        AiaGcmAccelBlock_t keyStream =
+            AiaGcmAccel_Encrypt( gcm, AiaGcmAccel_Load( gcm->counter ) );
+        AiaGcmAccel_IncrementCounter( gcm->counter );
+
+        /* Read the input before writing, as they may be the same. */
+        AiaGcmAccelBlock_t in = AiaGcmAccel_Load( input );
+        AiaGcmAccelBlock_t out = AiaGcmAccel_Xor( in, keyStream );
+        AiaGcmAccel_Store( output, out );
+        hash = AiaGcmAccel_Hash( gcm, hash, gcm->isDecrypting ? in : out );
+
+        input += AIA_GCM_ACCEL_BLOCK_SIZE;
+        output += AIA_GCM_ACCEL_BLOCK_SIZE;
+        length -= AIA_GCM_ACCEL_BLOCK_SIZE;
+    }
+    if( length )
+    {
+        uint8_t block[ AIA_GCM_ACCEL_BLOCK_SIZE ] = { 0 };
+        uint8_t keyStream[ AIA_GCM_ACCEL_BLOCK_SIZE ];
+        AiaGcmAccel_Store(
+            keyStream,
+            AiaGcmAccel_Encrypt( gcm, AiaGcmAccel_Load( gcm->counter ) ) );
+        AiaGcmAccel_IncrementCounter( gcm->counter );
+        for( size_t i = 0; i < length; ++i )
+        {
+            uint8_t in = input[ i ];
+            output[ i ] = in ^ keyStream[ i ];
+            block[ i ] = gcm->isDecrypting ? in : output[ i ];
+        }
+        hash = AiaGcmAccel_Hash( gcm, hash, AiaGcmAccel_Load( block ) );
+        memset( keyStream, 0, sizeof( keyStream ) );
+    }
+    AiaGcmAccel_Store( gcm->hash, hash );
+    return true;
+}
+
+AIA_GCM_ACCEL_TARGET bool AiaGcmAccel_Finish( AiaGcmAccel_t* gcm, uint8_t* tag,
+                                              size_t tagLen )
+{
+    if( !gcm || !tag )
+    {
+        AiaLogError( "Null %s.", gcm ? "tag" : "gcm" );
+        return false;
+    }
+    if( tagLen < 4 || tagLen > AIA_GCM_ACCEL_BLOCK_SIZE )
+    {
+        AiaLogError( "Invalid tagLen (%zu).", tagLen );
+        return false;
+    }
+
+    /* S = GHASH( C || 0^v || [len( A )]64 || [len( C )]64 ), with no A. */
+    uint8_t block[ AIA_GCM_ACCEL_BLOCK_SIZE ] = { 0 };
+    AiaGcmAccel_StoreLength( block + 8, gcm->length * 8 );
+    AiaGcmAccelBlock_t hash = AiaGcmAccel_Hash(
+        gcm, AiaGcmAccel_Load( gcm->hash ), AiaGcmAccel_Load( block ) );
+    AiaGcmAccel_Store(
+        block, AiaGcmAccel_Xor( AiaGcmAccel_Reverse( hash ),
+                                AiaGcmAccel_Load( gcm->encryptedJ0 ) ) );
+    memcpy( tag, block, tagLen );
+    return true;
+}
+
+#else
+
+bool AiaGcmAccel_IsSupported()
+{
+    return false;
+}
+
+bool AiaGcmAccel_SetKey( AiaGcmAccel_t* gcm, const uint8_t* key,
+                         size_t keyBits )
+{
+    (void)gcm;
+    (void)key;
+    (void)keyBits;
+    AiaLogError( "No AES-GCM kernels for this architecture." );
+    return false;
+}
+
+bool AiaGcmAccel_Starts( AiaGcmAccel_t* gcm, bool isDecrypting,
+                         const uint8_t* iv, size_t ivLen )
+{
+    (void)gcm;
+    (void)isDecrypting;
+    (void)iv;
+    (void)ivLen;
+    AiaLogError( "No AES-GCM kernels for this architecture." );
+    return false;
+}
+
+bool AiaGcmAccel_Update( AiaGcmAccel_t* gcm, size_t length,
+                         const uint8_t* input, uint8_t* output )
+{
+    (void)gcm;
+    (void)length;
+    (void)input;
+    (void)output;
+    AiaLogError( "No AES-GCM kernels for this architecture." );
+    return false;
+}
+
+bool AiaGcmAccel_Finish( AiaGcmAccel_t* gcm, uint8_t* tag, size_t tagLen )
+{
+    (void)gcm;
+    (void)tag;
+    (void)tagLen;
+    AiaLogError( "No AES-GCM kernels for this architecture." );
+    return false;
+}
+
+#endif
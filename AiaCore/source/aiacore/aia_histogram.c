@@ -0,0 +1,255 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_histogram.c
+ * @brief Implements functions for the AiaHistogram_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_histogram.h>
+#include <aiacore/aia_overload_governor.h>
+
+#include <string.h>
+
+/** The number of buckets each power of two is split into. */
+#define AIA_HISTOGRAM_SUB_BUCKETS ( 1u << AIA_HISTOGRAM_SUB_BUCKET_BITS )
+
+/**
+ * @param value A value to record.
+ * @return The index of the bucket @c value is counted in.
+ */
+static size_t AiaHistogram_GetIndex( uint32_t value )
+{
+    if( value < AIA_HISTOGRAM_SUB_BUCKETS )
+    {
+        return value;
+    }
+    size_t magnitude = 0;
+    while( value >> ( magnitude + 1 ) )
+    {
+        ++magnitude;
+    }
+    if( magnitude >= AIA_HISTOGRAM_MAX_VALUE_BITS )
+    {
+        return AIA_HISTOGRAM_BUCKETS - 1;
+    }
+    size_t shift = magnitude - AIA_HISTOGRAM_SUB_BUCKET_BITS;
+    return ( shift + 1 ) * AIA_HISTOGRAM_SUB_BUCKETS +
+           ( ( value >> shift ) - AIA_HISTOGRAM_SUB_BUCKETS );
+}
+
+/**
+ * @param index The index of a bucket.
+ * @return The largest value counted in the bucket at @c index.
+ */
+static uint32_t AiaHistogram_GetHighestValue( size_t index )
+{
+    if( index < AIA_HISTOGRAM_SUB_BUCKETS )
+    {
+        return (uint32_t)index;
+    }
+    if( index == AIA_HISTOGRAM_BUCKETS - 1 )
+    {
+        return UINT32_MAX;
+    }
+    size_t shift = index / AIA_HISTOGRAM_SUB_BUCKETS - 1;
+    uint32_t lowest =
+        ( AIA_HISTOGRAM_SUB_BUCKETS + index % AIA_HISTOGRAM_SUB_BUCKETS )
+        << shift;
+    return lowest + ( ( 1u << shift ) - 1 );
+}
+
+/**
+ * Encodes a number as an unsigned LEB128 varint.
+ *
+ * @param value The number to encode.
+ * @param[out] buffer The buffer to encode into, or @c NULL to only count.
+ * @param bufferSize The size of @c buffer.
+ * @param[in,out] offset The offset in @c buffer to encode at, advanced past
+ * the encoding.
+ * @return @c false if the encoding did not fit in @c buffer, else @c true.
+ */
+static bool AiaHistogram_PutVarint( uint32_t value, uint8_t* buffer,
+                                    size_t bufferSize, size_t* offset )
+{
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if( value )
+        {
+            byte |= 0x80;
+        }
+        if( buffer )
+        {
+            if( *offset >= bufferSize )
+            {
+                return false;
+            }
+            buffer[ *offset ] = byte;
+        }
+        ++*offset;
+    } while( value );
+    return true;
+}
+
+void AiaHistogram_Record( AiaHistogram_t* histogram, uint32_t value )
+{
+    AiaAssert( histogram );
+    if( !histogram )
+    {
+        AiaLogError( "Null histogram." );
+        return;
+    }
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    if( AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_TELEMETRY ) )
+    {
+        return;
+    }
+#endif
+    AiaAtomic_Add_u32( &histogram->counts[ AiaHistogram_GetIndex( value ) ],
+                       1 );
+    uint32_t max = AiaAtomic_Load_u32( &histogram->max );
+    while( value > max &&
+           !AiaAtomic_CompareAndSwap_u32( &histogram->max, value, max ) )
+    {
+        max = AiaAtomic_Load_u32( &histogram->max );
+    }
+}
+
+void AiaHistogram_Snapshot( const AiaHistogram_t* histogram,
+                            AiaHistogram_t* snapshot )
+{
+    AiaAssert( histogram );
+    AiaAssert( snapshot );
+    if( !histogram || !snapshot )
+    {
+        AiaLogError( "Null histogram or snapshot." );
+        return;
+    }
+    for( size_t i = 0; i < AIA_HISTOGRAM_BUCKETS; ++i )
+    {
+        snapshot->counts[ i ] =
+            AiaAtomic_Load_u32( (uint32_t*)&histogram->counts[ i ] );
+    }
+    snapshot->max = AiaAtomic_Load_u32( (uint32_t*)&histogram->max );
+}
+
+void AiaHistogram_Reset( AiaHistogram_t* histogram )
+{
+    AiaAssert( histogram );
+    if( !histogram )
+    {
+        AiaLogError( "Null histogram." );
+        return;
+    }
+    for( size_t i = 0; i < AIA_HISTOGRAM_BUCKETS; ++i )
+    {
+        AiaAtomic_Store_u32( &histogram->counts[ i ], 0 );
+    }
+    AiaAtomic_Store_u32( &histogram->max, 0 );
+}
+
+uint32_t AiaHistogram_GetCount( const AiaHistogram_t* histogram )
+{
+    AiaAssert( histogram );
+    if( !histogram )
+    {
+        AiaLogError( "Null histogram." );
+        return 0;
+    }
+    uint32_t count = 0;
+    for( size_t i = 0; i < AIA_HISTOGRAM_BUCKETS; ++i )
+    {
+        count += histogram->counts[ i ];
+    }
+    return count;
+}
+
+uint32_t AiaHistogram_GetValueAtPercentile( const AiaHistogram_t* histogram,
+                                            double percentile )
+{
+    uint32_t count = AiaHistogram_GetCount( histogram );
+    if( !count )
+    {
+        return 0;
+    }
+    if( percentile < 0 )
+    {
+        percentile = 0;
+    }
+    else if( percentile > 100 )
+    {
+        percentile = 100;
+    }
+
+    /* The rank of the value at the percentile, counting from one. */
+    uint32_t rank = (uint32_t)( percentile / 100 * count + 0.5 );
+    if( !rank )
+    {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for( size_t i = 0; i < AIA_HISTOGRAM_BUCKETS; ++i )
+    {
+        seen += histogram->counts[ i ];
+        if( seen >= rank )
+        {
+            uint32_t value = AiaHistogram_GetHighestValue( i );
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+size_t AiaHistogram_Serialize( const AiaHistogram_t* histogram,
+                               uint8_t* buffer, size_t bufferSize )
+{
+    AiaAssert( histogram );
+    if( !histogram )
+    {
+        AiaLogError( "Null histogram." );
+        return 0;
+    }
+    size_t offset = 0;
+    if( !AiaHistogram_PutVarint( histogram->max, buffer, bufferSize,
+                                 &offset ) )
+    {
+        AiaLogError( "Buffer too small, bufferSize=%zu.", bufferSize );
+        return 0;
+    }
+    size_t previousIndex = 0;
+    for( size_t i = 0; i < AIA_HISTOGRAM_BUCKETS; ++i )
+    {
+        if( !histogram->counts[ i ] )
+        {
+            continue;
+        }
+        if( !AiaHistogram_PutVarint( (uint32_t)( i - previousIndex ), buffer,
+                                     bufferSize, &offset ) ||
+            !AiaHistogram_PutVarint( histogram->counts[ i ], buffer,
+                                     bufferSize, &offset ) )
+        {
+            AiaLogError( "Buffer too small, bufferSize=%zu.", bufferSize );
+            return 0;
+        }
+        previousIndex = i;
+    }
+    return offset;
+}
@@ -27,8 +27,6 @@
 #include <aiacore/aia_utils.h>
 #include <aiacore/private/aia_json_message.h>
 
-#include <errno.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -43,19 +41,25 @@ extern inline const AiaJsonMessage_t *ConstAiaJsonMessage_FromMessage(
     const AiaMessage_t *message );
 
 /* clang-format off */
-#define JSON_MESSAGE_FORMAT_HEADER                                \
+#define JSON_MESSAGE_NAME_PREFIX                                  \
     "{"                                                           \
         "\"" AIA_JSON_CONSTANTS_HEADER_KEY "\":"                  \
         "{"                                                       \
-            "\"" AIA_JSON_CONSTANTS_NAME_KEY "\":\"%s\","         \
-            "\"" AIA_JSON_CONSTANTS_MESSAGE_ID_KEY "\":\"%s\""    \
+            "\"" AIA_JSON_CONSTANTS_NAME_KEY "\":\""
+#define JSON_MESSAGE_MESSAGE_ID_PREFIX                            \
+            "\",\"" AIA_JSON_CONSTANTS_MESSAGE_ID_KEY "\":\""
+#define JSON_MESSAGE_HEADER_END                                   \
+            "\""                                                  \
         "}"
-#define JSON_MESSAGE_FORMAT_PAYLOAD                               \
-        ",\"" AIA_JSON_CONSTANTS_PAYLOAD_KEY "\":%s"
+#define JSON_MESSAGE_PAYLOAD_PREFIX                               \
+        ",\"" AIA_JSON_CONSTANTS_PAYLOAD_KEY "\":"
 #define JSON_MESSAGE_END                                          \
     "}"
 /* clang-format on */
 
+/** Length of a string literal, excluding the trailing @c '\0'. */
+#define JSON_MESSAGE_LITERAL_LENGTH( literal ) ( sizeof( literal ) - 1 )
+
 /**
  * Size of message ID to use in JSON messages.  Needs to be large enough to
  * hold the ID and a null-term.
@@ -63,99 +67,143 @@ extern inline const AiaJsonMessage_t *ConstAiaJsonMessage_FromMessage(
 static const size_t AIA_JSON_MESSAGE_ID_SIZE = 9;
 
 /**
- * Generates the JSON text for a message with the specified @c name, @c
- * messageId and @c payload.  If @c NULL is passed for @c messageBuffer, this
- * function will still calculate the length of the generated JSON string
- * (including the trailing @c '\0').
+ * Calculates the length of the JSON text for a message, without formatting it.
  *
- * @param messageBuffer A user-provided buffer of at least @c
- * AiaMessage_GetSize() bytes to write the message into.
- * @param messageBufferSize The size (in bytes) of @c messageBuffer.
- * @param name The "name" value of the JSON header subsection.
- * @param messageId The "messageId" value of the JSON header subsection.  If @c
- * NULL, a random message ID will be automatically generated.
- * @param payload The value of the "payload" subsection of the JSON message.  In
- * the case that no "payload" is given in the message, a NULL should be passed
- * in.
- * @return The size (in bytes) of the generated JSON text (excluding the
- * trailing @c '\0'), or zero if there was an error.
+ * @param nameLength The length of the "name" value of the JSON header.
+ * @param messageIdLength The length of the "messageId" value of the JSON
+ * header.
+ * @param payload The value of the "payload" subsection, or @c NULL if there is
+ * none.
+ * @param payloadLength The length of @c payload.
+ * @return The size (in bytes) of the JSON text, excluding a trailing @c '\0'.
  */
-static size_t _BuildAiaJsonMessage( char *messageBuffer,
-                                    size_t messageBufferSize, const char *name,
-                                    const char *messageId, const char *payload )
+static size_t _AiaJsonMessage_GetJsonSize( size_t nameLength,
+                                           size_t messageIdLength,
+                                           const char *payload,
+                                           size_t payloadLength )
 {
-    if( !name )
-    {
-        AiaLogError( "Null name." );
-        return 0;
-    }
-    size_t messageIdBufferSize = AIA_JSON_MESSAGE_ID_SIZE;
-    char messageIdBuffer[ messageIdBufferSize ];
-    if( !messageId )
-    {
-        if( !AiaGenerateMessageId( messageIdBuffer, messageIdBufferSize ) )
-        {
-            AiaLogError( "Failed to generate message ID." );
-            return 0;
-        }
-        messageId = messageIdBuffer;
-    }
-
-    /* Build all of the message except for the end.  Note that snprintf will
-     * null-terminate the result, which we will then overrite when we add
-     * the end string. */
-    int result;
+    size_t size =
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_NAME_PREFIX ) + nameLength +
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_MESSAGE_ID_PREFIX ) +
+        messageIdLength +
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_HEADER_END ) +
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_END );
     if( payload )
     {
-        result =
-            snprintf( messageBuffer, messageBufferSize,
-                      JSON_MESSAGE_FORMAT_HEADER JSON_MESSAGE_FORMAT_PAYLOAD,
-                      name, messageId, payload );
-    }
-    else
-    {
-        result = snprintf( messageBuffer, messageBufferSize,
-                           JSON_MESSAGE_FORMAT_HEADER, name, messageId );
+        size += JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_PAYLOAD_PREFIX ) +
+                payloadLength;
     }
+    return size;
+}
 
-    if( result <= 0 )
-    {
-        AiaLogError( "snprintf failed: %d (errno=%d).", result, errno );
-        return 0;
-    }
+/**
+ * Copies @c length bytes of JSON text to @c cursor.
+ *
+ * @param cursor Where to write the text.
+ * @param text The text to write.
+ * @param length The number of bytes of @c text to write.
+ * @return A pointer just past the written text.
+ */
+static char *_AiaJsonMessage_Append( char *cursor, const char *text,
+                                     size_t length )
+{
+    memcpy( cursor, text, length );
+    return cursor + length;
+}
 
-    /* If we're just measuring, add the size of the end and return. */
-    size_t endSize = sizeof( JSON_MESSAGE_END ) - 1;
-    if( 0 == messageBufferSize )
+/**
+ * Copies the @c name, @c messageId and @c payload strings into @c strings and
+ * initializes @c jsonMessage to refer to them.
+ *
+ * @param jsonMessage The message to initialize.
+ * @param strings A buffer of at least @c name, @c messageId and @c payload's
+ * combined lengths plus a null-term for each.
+ * @param name The "name" value of the JSON header subsection.
+ * @param messageId The "messageId" value of the JSON header subsection.
+ * @param payload The value of the "payload" subsection, or @c NULL if there is
+ * none.
+ * @return @c true if @c jsonMessage was initialized, else @c false.
+ */
+static bool _AiaJsonMessage_InitializeStrings( AiaJsonMessage_t *jsonMessage,
+                                               char *strings, const char *name,
+                                               const char *messageId,
+                                               const char *payload )
+{
+    jsonMessage->nameLength = strlen( name );
+    jsonMessage->messageIdLength = strlen( messageId );
+    jsonMessage->payloadLength = payload ? strlen( payload ) : 0;
+
+    size_t messageSize = _AiaJsonMessage_GetJsonSize(
+        jsonMessage->nameLength, jsonMessage->messageIdLength, payload,
+        jsonMessage->payloadLength );
+    if( !_AiaMessage_Initialize( &jsonMessage->message, messageSize ) )
     {
-        return result + endSize;
+        AiaLogError( "_AiaMessage_Initialize failed." );
+        return false;
     }
 
-    /* Otherwise, make sure we have enough space to add the ending. */
-    size_t remainder = messageBufferSize - result;
-    if( remainder < endSize )
+    jsonMessage->name = strings;
+    memcpy( strings, name, jsonMessage->nameLength + 1 );
+    strings += jsonMessage->nameLength + 1;
+    jsonMessage->messageId = strings;
+    memcpy( strings, messageId, jsonMessage->messageIdLength + 1 );
+    strings += jsonMessage->messageIdLength + 1;
+    if( payload )
     {
-        AiaLogError(
-            "Insufficient space (%zu bytes) to add ending (%zu bytes).",
-            remainder, endSize );
-        return 0;
+        jsonMessage->payload = strings;
+        memcpy( strings, payload, jsonMessage->payloadLength + 1 );
     }
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    jsonMessage->serialized = NULL;
+#endif
 
-    /* If there is enough space, include a null-term. */
-    size_t nullSize = remainder > endSize;
-
-    /* Append the ending string. */
-    strncpy( messageBuffer + result, JSON_MESSAGE_END, endSize + nullSize );
+    return true;
+}
 
-    /* Return value should be the size without counting the null-term. */
-    return result + endSize;
+/**
+ * Calculates the size of the buffer needed by @c
+ * _AiaJsonMessage_InitializeStrings().
+ *
+ * @param name The "name" value of the JSON header subsection.
+ * @param messageId The "messageId" value of the JSON header subsection.
+ * @param payload The value of the "payload" subsection, or @c NULL if there is
+ * none.
+ * @return The size (in bytes) of the buffer.
+ */
+static size_t _AiaJsonMessage_GetStringsSize( const char *name,
+                                              const char *messageId,
+                                              const char *payload )
+{
+    return strlen( name ) + 1 + strlen( messageId ) + 1 +
+           ( payload ? strlen( payload ) + 1 : 0 );
 }
 
 AiaJsonMessage_t *AiaJsonMessage_Create( const char *name,
                                          const char *messageId,
                                          const char *payload )
 {
-    size_t jsonMessageSize = sizeof( struct AiaJsonMessage );
+    if( !name )
+    {
+        AiaLogError( "Null name." );
+        return NULL;
+    }
+    size_t messageIdBufferSize = AIA_JSON_MESSAGE_ID_SIZE;
+    char messageIdBuffer[ messageIdBufferSize ];
+    if( !messageId )
+    {
+        if( !AiaGenerateMessageId( messageIdBuffer, messageIdBufferSize ) )
+        {
+            AiaLogError( "Failed to generate message ID." );
+            return NULL;
+        }
+        messageId = messageIdBuffer;
+    }
+
+    /* The strings are stored inline after the struct, so that a message only
+     * costs a single allocation. */
+    size_t jsonMessageSize =
+        sizeof( struct AiaJsonMessage ) +
+        _AiaJsonMessage_GetStringsSize( name, messageId, payload );
     AiaJsonMessage_t *jsonMessage =
         (AiaJsonMessage_t *)AiaCalloc( 1, jsonMessageSize );
     if( !jsonMessage )
@@ -163,9 +211,11 @@ AiaJsonMessage_t *AiaJsonMessage_Create( const char *name,
         AiaLogError( "AiaCalloc failed (%zu bytes).", jsonMessageSize );
         return NULL;
     }
-    if( !_AiaJsonMessage_Initialize( jsonMessage, name, messageId, payload ) )
+    if( !_AiaJsonMessage_InitializeStrings( jsonMessage,
+                                            (char *)( jsonMessage + 1 ), name,
+                                            messageId, payload ) )
     {
-        AiaLogError( "_AiaJsonMessage_Initialize failed." );
+        AiaLogError( "_AiaJsonMessage_InitializeStrings failed." );
         AiaFree( jsonMessage );
         return NULL;
     }
@@ -199,43 +249,22 @@ bool _AiaJsonMessage_Initialize( AiaJsonMessage_t *jsonMessage,
         messageId = messageIdBuffer;
     }
 
-    size_t messageSize =
-        _BuildAiaJsonMessage( NULL, 0, name, messageId, payload );
-    if( !messageSize )
-    {
-        AiaLogError( "_BuildAiaJsonMessage failed." );
-        return false;
-    }
-    if( !_AiaMessage_Initialize( &jsonMessage->message, messageSize ) )
-    {
-        AiaLogError( "_AiaMessage_Initialize failed." );
-        return false;
-    }
-    size_t nameSize = strlen( name ) + 1;
-    size_t messageIdSize = strlen( messageId ) + 1;
-    size_t payloadSize = payload ? strlen( payload ) + 1 : 0;
-
-    size_t stringsSize = nameSize + messageIdSize + payloadSize;
+    size_t stringsSize =
+        _AiaJsonMessage_GetStringsSize( name, messageId, payload );
     char *strings = (char *)AiaCalloc( 1, stringsSize );
     if( !strings )
     {
         AiaLogError( "AiaCalloc failed (%zu bytes).", stringsSize );
         return false;
     }
-
-    jsonMessage->name = strings;
-    jsonMessage->messageId = jsonMessage->name + nameSize;
-    if( payload )
+    if( !_AiaJsonMessage_InitializeStrings( jsonMessage, strings, name,
+                                            messageId, payload ) )
     {
-        jsonMessage->payload = jsonMessage->messageId + messageIdSize;
-    }
-
-    strncpy( (char *)jsonMessage->name, name, nameSize );
-    strncpy( (char *)jsonMessage->messageId, messageId, messageIdSize );
-    if( payload )
-    {
-        strncpy( (char *)jsonMessage->payload, payload, payloadSize );
+        AiaLogError( "_AiaJsonMessage_InitializeStrings failed." );
+        AiaFree( strings );
+        return false;
     }
+    jsonMessage->ownsStrings = true;
 
     return true;
 }
@@ -244,11 +273,16 @@ void _AiaJsonMessage_Uninitialize( AiaJsonMessage_t *jsonMessage )
 {
     if( jsonMessage )
     {
-        if( jsonMessage->name )
+        if( jsonMessage->ownsStrings )
         {
             AiaFree( (void *)jsonMessage->name );
-            jsonMessage->name = NULL;
+            jsonMessage->ownsStrings = false;
         }
+        jsonMessage->name = NULL;
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+        AiaFree( jsonMessage->serialized );
+        jsonMessage->serialized = NULL;
+#endif
         _AiaMessage_Uninitialize( &jsonMessage->message );
     }
 }
@@ -303,17 +337,83 @@ bool AiaJsonMessage_BuildMessage( const AiaJsonMessage_t *jsonMessage,
             messageBufferSize, jsonMessage->message.size );
         return false;
     }
-    size_t size = _BuildAiaJsonMessage(
-        messageBuffer, messageBufferSize, jsonMessage->name,
-        jsonMessage->messageId, jsonMessage->payload );
-    if( size != jsonMessage->message.size )
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    if( jsonMessage->serialized )
+    {
+        memcpy( messageBuffer, jsonMessage->serialized,
+                jsonMessage->message.size );
+        if( messageBufferSize > jsonMessage->message.size )
+        {
+            messageBuffer[ jsonMessage->message.size ] = '\0';
+        }
+        return true;
+    }
+#endif
+
+    /* Serialize in a single pass; the size was already calculated at
+     * creation. */
+    char *cursor = messageBuffer;
+    cursor = _AiaJsonMessage_Append(
+        cursor, JSON_MESSAGE_NAME_PREFIX,
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_NAME_PREFIX ) );
+    cursor = _AiaJsonMessage_Append( cursor, jsonMessage->name,
+                                     jsonMessage->nameLength );
+    cursor = _AiaJsonMessage_Append(
+        cursor, JSON_MESSAGE_MESSAGE_ID_PREFIX,
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_MESSAGE_ID_PREFIX ) );
+    cursor = _AiaJsonMessage_Append( cursor, jsonMessage->messageId,
+                                     jsonMessage->messageIdLength );
+    cursor = _AiaJsonMessage_Append(
+        cursor, JSON_MESSAGE_HEADER_END,
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_HEADER_END ) );
+    if( jsonMessage->payload )
+    {
+        cursor = _AiaJsonMessage_Append(
+            cursor, JSON_MESSAGE_PAYLOAD_PREFIX,
+            JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_PAYLOAD_PREFIX ) );
+        cursor = _AiaJsonMessage_Append( cursor, jsonMessage->payload,
+                                         jsonMessage->payloadLength );
+    }
+    cursor = _AiaJsonMessage_Append(
+        cursor, JSON_MESSAGE_END,
+        JSON_MESSAGE_LITERAL_LENGTH( JSON_MESSAGE_END ) );
+
+    /* If there is enough space, include a null-term. */
+    if( messageBufferSize > jsonMessage->message.size )
+    {
+        *cursor = '\0';
+    }
+    return true;
+}
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+bool AiaJsonMessage_Serialize( AiaJsonMessage_t *jsonMessage )
+{
+    if( !jsonMessage )
+    {
+        AiaLogError( "Null jsonMessage." );
+        return false;
+    }
+    if( jsonMessage->serialized )
     {
-        AiaLogError(
-            "_BuildAiaJsonMessage returned incorrect size (expected %zu, "
-            "actual "
-            "%zu).",
-            jsonMessage->message.size, size );
+        return true;
+    }
+
+    size_t size = jsonMessage->message.size;
+    char *serialized = (char *)AiaCalloc( 1, size );
+    if( !serialized )
+    {
+        AiaLogError( "AiaCalloc failed (%zu bytes).", size );
+        return false;
+    }
+    if( !AiaJsonMessage_BuildMessage( jsonMessage, serialized, size ) )
+    {
+        AiaLogError( "AiaJsonMessage_BuildMessage failed." );
+        AiaFree( serialized );
         return false;
     }
+    jsonMessage->serialized = serialized;
     return true;
 }
+#endif
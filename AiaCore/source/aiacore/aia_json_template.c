@@ -0,0 +1,117 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_json_template.c
+ * @brief Implements functions for the AiaJsonTemplate_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_json_template.h>
+
+#include <string.h>
+
+/** Maximum number of decimal digits in a @c uint64_t. */
+#define AIA_JSON_TEMPLATE_MAX_FIELD_LENGTH 20
+
+/**
+ * Formats an unsigned value in decimal.
+ *
+ * @param value The value to format.
+ * @param[out] digits A buffer of @c AIA_JSON_TEMPLATE_MAX_FIELD_LENGTH bytes.
+ * The digits are written right-aligned, without a '\0'-terminator.
+ * @return The number of digits written to the end of @c digits.
+ */
+static size_t AiaJsonTemplate_FormatField( uint64_t value, char* digits )
+{
+    size_t length = 0;
+    do
+    {
+        digits[ AIA_JSON_TEMPLATE_MAX_FIELD_LENGTH - 1 - length ] =
+            (char)( '0' + value % 10 );
+        value /= 10;
+        ++length;
+    } while( value );
+    return length;
+}
+
+size_t AiaJsonTemplate_Render( const AiaJsonTemplate_t* jsonTemplate,
+                               const uint64_t* fields, char* buffer,
+                               size_t bufferSize )
+{
+    AiaAssert( jsonTemplate );
+    if( !jsonTemplate )
+    {
+        AiaLogError( "Null jsonTemplate." );
+        return 0;
+    }
+    if( !fields && jsonTemplate->numFields )
+    {
+        AiaLogError( "Null fields." );
+        return 0;
+    }
+    if( !buffer )
+    {
+        AiaLogError( "Null buffer." );
+        return 0;
+    }
+
+    char digits[ AIA_JSON_TEMPLATE_MAX_FIELD_LENGTH ];
+    size_t length = 0;
+    for( size_t i = 0; i <= jsonTemplate->numFields; ++i )
+    {
+        const AiaJsonTemplateSegment_t* segment = &jsonTemplate->segments[ i ];
+        if( bufferSize - length <= segment->length )
+        {
+            AiaLogError( "Insufficient buffer, bufferSize=%zu", bufferSize );
+            return 0;
+        }
+        memcpy( buffer + length, segment->text, segment->length );
+        length += segment->length;
+
+        if( i == jsonTemplate->numFields )
+        {
+            break;
+        }
+        size_t numDigits = AiaJsonTemplate_FormatField( fields[ i ], digits );
+        if( bufferSize - length <= numDigits )
+        {
+            AiaLogError( "Insufficient buffer, bufferSize=%zu", bufferSize );
+            return 0;
+        }
+        memcpy( buffer + length,
+                digits + AIA_JSON_TEMPLATE_MAX_FIELD_LENGTH - numDigits,
+                numDigits );
+        length += numDigits;
+    }
+    buffer[ length ] = '\0';
+    return length;
+}
+
+AiaJsonMessage_t* AiaJsonTemplate_CreateMessage(
+    const AiaJsonTemplate_t* jsonTemplate, const uint64_t* fields )
+{
+    char payload[ AIA_JSON_TEMPLATE_MAX_PAYLOAD_LENGTH ];
+    if( !AiaJsonTemplate_Render( jsonTemplate, fields, payload,
+                                 sizeof( payload ) ) )
+    {
+        AiaLogError( "AiaJsonTemplate_Render failed." );
+        return NULL;
+    }
+    return AiaJsonMessage_Create( jsonTemplate->name, NULL, payload );
+}
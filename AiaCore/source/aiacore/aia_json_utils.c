@@ -24,7 +24,350 @@
 
 #include <aiacore/aia_json_utils.h>
 
-#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+
+/** The number of bytes classified at once, one per bit of a mask. */
+#define AIA_JSON_UTILS_BLOCK_SIZE 64
+
+/** A word of the document, whose bytes are compared at once. */
+typedef uint64_t AiaJsonUtilsWord_t;
+
+/** Repeats @c byte in every byte of a word. */
+#define AIA_JSON_UTILS_REPEAT( byte ) \
+    ( ~(AiaJsonUtilsWord_t)0 / 0xFF * (uint8_t)( byte ) )
+
+/** The odd bits of a mask. */
+#define AIA_JSON_UTILS_ODD_BITS ( ~(uint64_t)0 / 3 << 1 )
+
+/**
+ * Finds the structural characters of a document outside of its strings, a
+ * block at a time, in the style of the first stage of simdjson. Each block is
+ * classified into bitmaps with 16-byte vector comparisons where the compiler
+ * supports vector extensions, or with comparisons on 64-bit words otherwise,
+ * so that strings are skipped without looking at their characters one by one.
+ */
+typedef struct AiaJsonUtilsScanner
+{
+    /** The document being scanned. */
+    const char* jsonDocument;
+
+    /** The length of @c jsonDocument. */
+    size_t length;
+
+    /** The offset of the current block. */
+    size_t blockOffset;
+
+    /** The structural characters of the current block not yet returned. */
+    uint64_t structurals;
+
+    /** All ones if the current block ends inside a string, or zero. */
+    uint64_t inString;
+
+    /** @c 1 if the first byte of the next block is escaped, or @c 0. */
+    uint64_t escaped;
+} AiaJsonUtilsScanner_t;
+
+/**
+ * Loads a word so that the first byte in memory is the least significant,
+ * regardless of the byte order of the target.
+ *
+ * @param bytes The bytes to load.
+ * @return The loaded word.
+ */
+static inline AiaJsonUtilsWord_t AiaJsonUtils_LoadWord( const uint8_t* bytes )
+{
+    AiaJsonUtilsWord_t word = 0;
+    for( size_t i = 0; i < sizeof( word ); ++i )
+    {
+        word |= (AiaJsonUtilsWord_t)bytes[ i ] << ( 8 * i );
+    }
+    return word;
+}
+
+/**
+ * Flags the bytes of @c word which equal @c byte.
+ *
+ * @param word A word of the document.
+ * @param byte The byte to look for.
+ * @return A word with the high bit of each matching byte set.
+ */
+static inline AiaJsonUtilsWord_t AiaJsonUtils_MatchByte(
+    AiaJsonUtilsWord_t word, uint8_t byte )
+{
+    AiaJsonUtilsWord_t x = word ^ AIA_JSON_UTILS_REPEAT( byte );
+    AiaJsonUtilsWord_t low = AIA_JSON_UTILS_REPEAT( 0x7F );
+    return ~( ( ( x & low ) + low ) | x | low );
+}
+
+/**
+ * Gathers the flags of @c AiaJsonUtils_MatchByte() into one bit per byte.
+ *
+ * @param matches The result of @c AiaJsonUtils_MatchByte().
+ * @return A mask with bit @c i set if byte @c i of the word was flagged.
+ */
+static inline uint64_t AiaJsonUtils_PackMatches( AiaJsonUtilsWord_t matches )
+{
+    return ( matches >> 7 ) * 0x0102040810204080ULL >> 56;
+}
+
+/**
+ * @param mask A non-zero mask.
+ * @return The index of the lowest set bit of @c mask.
+ */
+static inline size_t AiaJsonUtils_CountTrailingZeros( uint64_t mask )
+{
+#if defined( __GNUC__ )
+    return (size_t)__builtin_ctzll( mask );
+#else
+    size_t count = 0;
+    for( ; !( mask & 1 ); mask >>= 1 )
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+#if defined( __GNUC__ ) && defined( __BYTE_ORDER__ ) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+/** The number of bytes compared at once. */
+#define AIA_JSON_UTILS_CHUNK_SIZE 16
+
+/**
+ * Bytes compared at once. GCC and Clang map operations on this type to the
+ * vector registers of the target, e.g. NEON or SSE2.
+ */
+typedef uint8_t AiaJsonUtilsChunk_t
+    __attribute__( ( vector_size( AIA_JSON_UTILS_CHUNK_SIZE ) ) );
+
+/**
+ * Gathers the results of comparisons on a chunk into one bit per byte.
+ *
+ * @param matches A chunk with all bits of each matching byte set.
+ * @return A mask with bit @c i set if byte @c i of the chunk matched.
+ */
+static inline uint64_t AiaJsonUtils_PackChunk( AiaJsonUtilsChunk_t matches )
+{
+    AiaJsonUtilsWord_t
+        words[ sizeof( matches ) / sizeof( AiaJsonUtilsWord_t ) ];
+    matches &= 0x80;
+    memcpy( words, &matches, sizeof( words ) );
+    return AiaJsonUtils_PackMatches( words[ 0 ] ) |
+           AiaJsonUtils_PackMatches( words[ 1 ] ) << 8;
+}
+
+/**
+ * Classifies @c AIA_JSON_UTILS_CHUNK_SIZE bytes of a block.
+ *
+ * @param bytes The bytes to classify.
+ * @param index The index of @c bytes within the block.
+ * @param[in,out] quotes The quotes of the block.
+ * @param[in,out] backslashes The backslashes of the block.
+ * @param[in,out] others The other structural characters of the block.
+ */
+static inline void AiaJsonUtils_ClassifyChunk( const uint8_t* bytes,
+                                               size_t index, uint64_t* quotes,
+                                               uint64_t* backslashes,
+                                               uint64_t* others )
+{
+    AiaJsonUtilsChunk_t chunk;
+    memcpy( &chunk, bytes, sizeof( chunk ) );
+    /* '[' and '{', and ']' and '}', differ only in bit 5, so setting it
+     * matches both brackets and braces with one comparison each. */
+    AiaJsonUtilsChunk_t folded = chunk | 0x20;
+    *quotes |= AiaJsonUtils_PackChunk( (AiaJsonUtilsChunk_t)( chunk == '\"' ) )
+               << index;
+    *backslashes |=
+        AiaJsonUtils_PackChunk( (AiaJsonUtilsChunk_t)( chunk == '\\' ) )
+        << index;
+    *others |= AiaJsonUtils_PackChunk(
+                   (AiaJsonUtilsChunk_t)( ( chunk == ',' ) | ( chunk == ':' ) |
+                                          ( folded == '{' ) |
+                                          ( folded == '}' ) ) )
+               << index;
+}
+
+#else
+
+/** The number of bytes compared at once. */
+#define AIA_JSON_UTILS_CHUNK_SIZE sizeof( AiaJsonUtilsWord_t )
+
+/**
+ * Classifies @c AIA_JSON_UTILS_CHUNK_SIZE bytes of a block.
+ *
+ * @param bytes The bytes to classify.
+ * @param index The index of @c bytes within the block.
+ * @param[in,out] quotes The quotes of the block.
+ * @param[in,out] backslashes The backslashes of the block.
+ * @param[in,out] others The other structural characters of the block.
+ */
+static inline void AiaJsonUtils_ClassifyChunk( const uint8_t* bytes,
+                                               size_t index, uint64_t* quotes,
+                                               uint64_t* backslashes,
+                                               uint64_t* others )
+{
+    AiaJsonUtilsWord_t word = AiaJsonUtils_LoadWord( bytes );
+    /* '[' and '{', and ']' and '}', differ only in bit 5, so setting it
+     * matches both brackets and braces with one comparison each. */
+    AiaJsonUtilsWord_t folded = word | AIA_JSON_UTILS_REPEAT( 0x20 );
+    *quotes |=
+        AiaJsonUtils_PackMatches( AiaJsonUtils_MatchByte( word, '\"' ) )
+        << index;
+    *backslashes |=
+        AiaJsonUtils_PackMatches( AiaJsonUtils_MatchByte( word, '\\' ) )
+        << index;
+    *others |= AiaJsonUtils_PackMatches(
+                   AiaJsonUtils_MatchByte( word, ',' ) |
+                   AiaJsonUtils_MatchByte( word, ':' ) |
+                   AiaJsonUtils_MatchByte( folded, '{' ) |
+                   AiaJsonUtils_MatchByte( folded, '}' ) )
+               << index;
+}
+
+#endif
+
+/**
+ * Classifies the block of @c scanner at @c blockOffset.
+ *
+ * @param scanner The scanner to act on.
+ */
+static void AiaJsonUtils_ClassifyBlock( AiaJsonUtilsScanner_t* scanner )
+{
+    /* The end of the document is padded with zeros, which are not
+     * structural. */
+    uint8_t padded[ AIA_JSON_UTILS_BLOCK_SIZE ];
+    const uint8_t* block =
+        (const uint8_t*)scanner->jsonDocument + scanner->blockOffset;
+    size_t remaining = scanner->length - scanner->blockOffset;
+    if( remaining < AIA_JSON_UTILS_BLOCK_SIZE )
+    {
+        memcpy( padded, block, remaining );
+        memset( padded + remaining, 0, sizeof( padded ) - remaining );
+        block = padded;
+    }
+
+    uint64_t quotes = 0;
+    uint64_t backslashes = 0;
+    uint64_t others = 0;
+    for( size_t i = 0; i < AIA_JSON_UTILS_BLOCK_SIZE;
+         i += AIA_JSON_UTILS_CHUNK_SIZE )
+    {
+        AiaJsonUtils_ClassifyChunk( block + i, i, &quotes, &backslashes,
+                                    &others );
+    }
+
+    /* A character is escaped if it follows an odd run of backslashes. Runs
+     * starting on even bits end on odd bits after an odd length, and the
+     * subtraction carries each run to the bit after its end. */
+    uint64_t escaped = scanner->escaped;
+    if( backslashes )
+    {
+        uint64_t starts = backslashes & ~scanner->escaped;
+        uint64_t ends =
+            ( ( starts << 1 | AIA_JSON_UTILS_ODD_BITS ) - starts ) ^
+            AIA_JSON_UTILS_ODD_BITS;
+        escaped = ends ^ ( backslashes | scanner->escaped );
+        scanner->escaped = ( ends & backslashes ) >> 63;
+    }
+    else
+    {
+        scanner->escaped = 0;
+    }
+    quotes &= ~escaped;
+
+    /* Each bit of the prefix XOR of the quotes is set from an opening quote up
+     * to its closing quote. */
+    uint64_t inString = quotes;
+    for( size_t shift = 1; shift < AIA_JSON_UTILS_BLOCK_SIZE; shift *= 2 )
+    {
+        inString ^= inString << shift;
+    }
+    inString ^= scanner->inString;
+    scanner->inString = 0 - ( inString >> 63 );
+
+    scanner->structurals = quotes | ( others & ~inString );
+}
+
+/**
+ * Starts scanning a document.
+ *
+ * @param[out] scanner The scanner to initialize.
+ * @param jsonDocument The document to scan.
+ * @param length The length of @c jsonDocument.
+ * @param offset The offset to start at, which must be outside of any string.
+ */
+static void AiaJsonUtils_InitializeScanner( AiaJsonUtilsScanner_t* scanner,
+                                            const char* jsonDocument,
+                                            size_t length, size_t offset )
+{
+    scanner->jsonDocument = jsonDocument;
+    scanner->length = length;
+    scanner->blockOffset = offset < length ? offset : length;
+    scanner->structurals = 0;
+    scanner->inString = 0;
+    scanner->escaped = 0;
+    if( offset < length )
+    {
+        AiaJsonUtils_ClassifyBlock( scanner );
+    }
+}
+
+/**
+ * Finds the next structural character. These are the opening and closing
+ * quotes of strings, and the ',', ':', '[', ']', '{' and '}' outside of them,
+ * so the character after an opening quote is always its closing quote.
+ *
+ * @param scanner The scanner to act on.
+ * @return The offset of the next structural character, or the length of the
+ *     document if there are none left.
+ */
+static size_t AiaJsonUtils_NextStructural( AiaJsonUtilsScanner_t* scanner )
+{
+    while( !scanner->structurals )
+    {
+        if( scanner->length - scanner->blockOffset <=
+            AIA_JSON_UTILS_BLOCK_SIZE )
+        {
+            return scanner->length;
+        }
+        scanner->blockOffset += AIA_JSON_UTILS_BLOCK_SIZE;
+        AiaJsonUtils_ClassifyBlock( scanner );
+    }
+    size_t offset = scanner->blockOffset +
+                    AiaJsonUtils_CountTrailingZeros( scanner->structurals );
+    scanner->structurals &= scanner->structurals - 1;
+    return offset;
+}
+
+/**
+ * @param byte A byte of the document.
+ * @return @c true if @c byte is whitespace as defined by JSON.
+ */
+static inline bool AiaJsonUtils_IsWhitespace( char byte )
+{
+    return ' ' == byte || '\n' == byte || '\r' == byte || '\t' == byte;
+}
+
+/**
+ * Scans past whitespace.
+ *
+ * @param jsonDocument The document being scanned.
+ * @param length The length of @c jsonDocument.
+ * @param offset The offset to start at.
+ * @return The offset of the next non-whitespace character, or @c length.
+ */
+static size_t AiaJsonUtils_SkipWhitespace( const char* jsonDocument,
+                                           size_t length, size_t offset )
+{
+    while( offset < length &&
+           AiaJsonUtils_IsWhitespace( jsonDocument[ offset ] ) )
+    {
+        ++offset;
+    }
+    return offset;
+}
 
 bool AiaJsonUtils_UnquoteString( const char** jsonString,
                                  size_t* jsonStringLength )
@@ -110,82 +453,163 @@ bool AiaJsonUtils_GetArrayElement( const char* jsonArray,
         return false;
     }
 
-    const char* currentByte = jsonArray;
+    AiaJsonArrayIterator_t iterator;
+    if( !AiaJsonArrayIterator_Initialize( &iterator, jsonArray,
+                                          jsonArrayLength ) )
+    {
+        return false;
+    }
+
+    /* Walk forward to the requested element. */
+    do
+    {
+        if( !AiaJsonArrayIterator_Next( &iterator, jsonValue,
+                                        jsonValueLength ) )
+        {
+            AiaLogDebug( "Index not found in array." );
+            return false;
+        }
+    } while( index-- );
+
+    return true;
+}
+
+bool AiaJsonArrayIterator_Initialize( AiaJsonArrayIterator_t* iterator,
+                                      const char* jsonArray,
+                                      size_t jsonArrayLength )
+{
+    if( !iterator )
+    {
+        AiaLogError( "Null iterator." );
+        return false;
+    }
+
+    if( !jsonArray )
+    {
+        AiaLogError( "Null jsonArray." );
+        return false;
+    }
+
+    if( !jsonArrayLength )
+    {
+        AiaLogError( "Empty jsonArray." );
+        return false;
+    }
 
     /* Make sure it starts with an array bracket. */
-    if( *currentByte != '[' )
+    if( '[' != *jsonArray )
+    {
+        return false;
+    }
+
+    iterator->jsonArray = jsonArray;
+    iterator->jsonArrayLength = jsonArrayLength;
+    iterator->offset = 1;
+    iterator->complete = false;
+    return true;
+}
+
+bool AiaJsonArrayIterator_Next( AiaJsonArrayIterator_t* iterator,
+                                const char** jsonValue,
+                                size_t* jsonValueLength )
+{
+    if( !iterator )
     {
+        AiaLogError( "Null iterator." );
+        return false;
+    }
+
+    if( !jsonValue )
+    {
+        AiaLogError( "Null jsonValue." );
         return false;
     }
 
-    /* Work through the array one character at a time. */
+    if( !jsonValueLength )
+    {
+        AiaLogError( "Null jsonValueLength." );
+        return false;
+    }
+
+    if( iterator->complete )
+    {
+        return false;
+    }
+
+    const char* jsonArray = iterator->jsonArray;
+    size_t length = iterator->jsonArrayLength;
+    size_t offset = iterator->offset;
+    bool isFirstElement = ( 1 == offset );
+
+    /* Skip over leading whitespace. */
+    offset = AiaJsonUtils_SkipWhitespace( jsonArray, length, offset );
+
+    /* Work through the structural characters of the element. */
+    AiaJsonUtilsScanner_t scanner;
+    AiaJsonUtils_InitializeScanner( &scanner, jsonArray, length, offset );
+    size_t start = offset;
     size_t depth = 0;
-    *jsonValue = NULL;
-    while( ( size_t )( ++currentByte - jsonArray ) < jsonArrayLength )
+    while( ( offset = AiaJsonUtils_NextStructural( &scanner ) ) < length )
     {
-        /* Skip over leading whitespace. */
-        if( isspace( (int)( *currentByte ) ) )
-        {
-            continue;
-        }
+        char currentByte = jsonArray[ offset ];
 
-        /* Note the start of the desired value if we've found it. */
-        if( 0 == depth && 0 == index && !*jsonValue )
+        /* Commas, braces and brackets inside strings are not structural, so
+         * the next structural character closes the string. */
+        if( '\"' == currentByte )
         {
-            *jsonValue = currentByte;
+            AiaJsonUtils_NextStructural( &scanner );
+            continue;
         }
 
-        /* TODO: Add support for treating quoted strings as atomic elements so
-         * that we don't interpret commas, braces and brackets inside strings.
-         * (ADSER-1651) */
-
         /* A comma or close-bracket at the top level ends an array entry. */
-        if( 0 == depth && ( ',' == *currentByte || ']' == *currentByte ) )
+        if( 0 == depth && ( ',' == currentByte || ']' == currentByte ) )
         {
-            /* If this was the index we were looking for, we've found the end.
-             */
-            if( 0 == index )
+            /* A close-bracket with nothing before it is an empty array. */
+            if( ']' == currentByte && start == offset && isFirstElement )
             {
-                /* Sanity check - we should already have noted the start. */
-                if( !*jsonValue )
-                {
-                    AiaLogError(
-                        "Value pointer still null when at end of value." );
-                    return false;
-                }
-
-                /* Strip any trailing whitespace. */
-                while( currentByte - *jsonValue > 1 &&
-                       isspace( (int)( *( currentByte - 1 ) ) ) )
-                {
-                    --currentByte;
-                }
+                iterator->offset = offset + 1;
+                iterator->complete = true;
+                return false;
+            }
 
-                *jsonValueLength = currentByte - *jsonValue;
-                return true;
+            /* Strip any trailing whitespace. */
+            size_t end = offset;
+            while( end > start &&
+                   AiaJsonUtils_IsWhitespace( jsonArray[ end - 1 ] ) )
+            {
+                --end;
             }
 
-            /* Otherwise, this comma moves us to the next array entry. */
-            --index;
-            continue;
+            *jsonValue = jsonArray + start;
+            *jsonValueLength = end - start;
+            iterator->offset = offset + 1;
+            iterator->complete = ( ']' == currentByte );
+            return true;
         }
 
         /* Open-brackets/braces increase our depth. */
-        if( '[' == *currentByte || '{' == *currentByte )
+        if( '[' == currentByte || '{' == currentByte )
         {
             ++depth;
             continue;
         }
 
         /* Close-brackets/braces decrease our depth. */
-        if( ']' == *currentByte || '}' == *currentByte )
+        if( ']' == currentByte || '}' == currentByte )
         {
+            if( !depth )
+            {
+                AiaLogError( "Unbalanced '%c' in array.", currentByte );
+                iterator->offset = length;
+                return false;
+            }
             --depth;
             continue;
         }
     }
 
-    AiaLogDebug( "Index not found in array." );
+    AiaLogDebug( "Unterminated array." );
+    iterator->offset = length;
     return false;
 }
 
@@ -221,3 +645,190 @@ bool AiaJsonUtils_ExtractLong( const char* jsonDocument,
 
     return AiaExtractLongFromJsonValue( valueStr, valueLen, longValue );
 }
+
+bool AiaJsonObject_Parse( AiaJsonObject_t* object, const char* jsonDocument,
+                          size_t jsonDocumentLength )
+{
+    if( !object )
+    {
+        AiaLogError( "Null object." );
+        return false;
+    }
+    if( !jsonDocument )
+    {
+        AiaLogError( "Null jsonDocument." );
+        return false;
+    }
+    object->numMembers = 0;
+
+    size_t length = jsonDocumentLength;
+    size_t offset = AiaJsonUtils_SkipWhitespace( jsonDocument, length, 0 );
+    if( offset >= length || '{' != jsonDocument[ offset ] )
+    {
+        AiaLogError( "Not a JSON object." );
+        return false;
+    }
+    offset = AiaJsonUtils_SkipWhitespace( jsonDocument, length, offset + 1 );
+    if( offset < length && '}' == jsonDocument[ offset ] )
+    {
+        return true;
+    }
+
+    /* Only whitespace is skipped without the scanner, so the next structural
+     * character is always the one at @c offset. */
+    AiaJsonUtilsScanner_t scanner;
+    AiaJsonUtils_InitializeScanner( &scanner, jsonDocument, length, offset );
+    while( offset < length )
+    {
+        /* Key. */
+        if( '\"' != jsonDocument[ offset ] )
+        {
+            AiaLogError( "Expected a key at offset %zu.", offset );
+            return false;
+        }
+        AiaJsonUtils_NextStructural( &scanner );
+        size_t keyEnd = AiaJsonUtils_NextStructural( &scanner ) + 1;
+        if( keyEnd >= length )
+        {
+            break;
+        }
+        if( AIA_JSON_OBJECT_MAX_MEMBERS == object->numMembers )
+        {
+            AiaLogError( "Too many members, max=%d.",
+                         AIA_JSON_OBJECT_MAX_MEMBERS );
+            return false;
+        }
+        AiaJsonMember_t* member = &object->members[ object->numMembers ];
+        member->key = jsonDocument + offset + 1;
+        member->keyLength = keyEnd - offset - 2;
+
+        offset = AiaJsonUtils_SkipWhitespace( jsonDocument, length, keyEnd );
+        if( offset >= length || ':' != jsonDocument[ offset ] )
+        {
+            AiaLogError( "Expected ':' at offset %zu.", offset );
+            return false;
+        }
+        AiaJsonUtils_NextStructural( &scanner );
+        offset =
+            AiaJsonUtils_SkipWhitespace( jsonDocument, length, offset + 1 );
+
+        /* Value, which ends at a top-level ',' or '}'. */
+        size_t valueStart = offset;
+        size_t depth = 0;
+        while( ( offset = AiaJsonUtils_NextStructural( &scanner ) ) < length )
+        {
+            char currentByte = jsonDocument[ offset ];
+            if( '\"' == currentByte )
+            {
+                AiaJsonUtils_NextStructural( &scanner );
+            }
+            else if( '[' == currentByte || '{' == currentByte )
+            {
+                ++depth;
+            }
+            else if( ']' == currentByte || '}' == currentByte )
+            {
+                if( !depth )
+                {
+                    break;
+                }
+                --depth;
+            }
+            else if( ',' == currentByte && !depth )
+            {
+                break;
+            }
+        }
+        if( offset >= length )
+        {
+            break;
+        }
+        size_t valueEnd = offset;
+        while( valueEnd > valueStart &&
+               AiaJsonUtils_IsWhitespace( jsonDocument[ valueEnd - 1 ] ) )
+        {
+            --valueEnd;
+        }
+        if( valueEnd == valueStart || ']' == jsonDocument[ offset ] )
+        {
+            AiaLogError( "Malformed value at offset %zu.", valueStart );
+            return false;
+        }
+        member->value = jsonDocument + valueStart;
+        member->valueLength = valueEnd - valueStart;
+        ++object->numMembers;
+
+        if( '}' == jsonDocument[ offset ] )
+        {
+            return true;
+        }
+        offset =
+            AiaJsonUtils_SkipWhitespace( jsonDocument, length, offset + 1 );
+    }
+
+    AiaLogError( "Unterminated JSON object." );
+    return false;
+}
+
+bool AiaJsonObject_FindValue( const AiaJsonObject_t* object,
+                              const char* jsonKey, size_t jsonKeyLength,
+                              const char** jsonValue, size_t* jsonValueLength )
+{
+    if( !object )
+    {
+        AiaLogError( "Null object." );
+        return false;
+    }
+    if( !jsonKey )
+    {
+        AiaLogError( "Null jsonKey." );
+        return false;
+    }
+    if( !jsonValue )
+    {
+        AiaLogError( "Null jsonValue." );
+        return false;
+    }
+    if( !jsonValueLength )
+    {
+        AiaLogError( "Null jsonValueLength." );
+        return false;
+    }
+
+    /* The table is small and bounded, so a linear search over keys is cheaper
+     * than hashing them. */
+    for( size_t i = 0; i < object->numMembers; ++i )
+    {
+        const AiaJsonMember_t* member = &object->members[ i ];
+        if( member->keyLength == jsonKeyLength &&
+            !strncmp( member->key, jsonKey, jsonKeyLength ) )
+        {
+            *jsonValue = member->value;
+            *jsonValueLength = member->valueLength;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AiaJsonObject_ExtractLong( const AiaJsonObject_t* object,
+                                const char* jsonKey, size_t jsonKeyLength,
+                                AiaJsonLongType* longValue )
+{
+    if( !longValue )
+    {
+        AiaLogError( "Null longValue" );
+        return false;
+    }
+
+    const char* valueStr = NULL;
+    size_t valueLen = 0;
+    if( !AiaJsonObject_FindValue( object, jsonKey, jsonKeyLength, &valueStr,
+                                  &valueLen ) )
+    {
+        AiaLogError( "Key not found, key=%.*s", jsonKeyLength, jsonKey );
+        return false;
+    }
+
+    return AiaExtractLongFromJsonValue( valueStr, valueLen, longValue );
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_key_pair_cache.c
+ * @brief Implements functions for the AiaKeyPairCache_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_key_pair_cache.h>
+
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+#include AiaTaskPool( HEADER )
+
+#include <string.h>
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaKeyPairCache_t abstraction.
+ */
+struct AiaKeyPairCache
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Whether @c keys holds a key pair which has not been taken yet. */
+    bool isCached;
+
+    /** Whether @c job is scheduled or running. */
+    bool isGenerating;
+
+    /** Whether @c AiaKeyPairCache_Destroy() is waiting for @c job. */
+    bool isDestroying;
+
+    /** @} */
+
+    /** Posted by @c job when it finishes while @c isDestroying is set. */
+    AiaSemaphore_t jobFinished;
+
+    /** The task pool key pairs are generated on. */
+    const AiaTaskPool_t taskPool;
+
+    /** The secret derivation algorithm key pairs are generated for. */
+    const AiaSecretDerivationAlgorithm_t algorithm;
+
+    /** The length of the private keys. */
+    const size_t privateKeyLen;
+
+    /** The length of the public keys. */
+    const size_t publicKeyLen;
+
+    /** How long to wait before generating the next key pair. */
+    const AiaDurationMs_t delayMs;
+
+    /** The job which generates the next key pair. */
+    AiaTaskPoolJob_t job;
+
+    /** Storage for @c job. */
+    AiaTaskPoolJobStorage_t jobStorage;
+
+    /** The cached private key, followed by the cached public key. */
+    uint8_t keys[];
+};
+
+/**
+ * Overwrites key material with zeros in a way that is not optimized away.
+ *
+ * @param key The key to wipe.
+ * @param keyLen The length of @c key.
+ */
+static void AiaKeyPairCache_Wipe( uint8_t* key, size_t keyLen )
+{
+    volatile uint8_t* volatileKey = key;
+    while( keyLen-- )
+    {
+        *volatileKey++ = 0;
+    }
+}
+
+/**
+ * Generates a key pair for @c cache.
+ *
+ * @param cache The @c AiaKeyPairCache_t to generate a key pair for.
+ * @param[out] privateKey The buffer to write the private key into.
+ * @param[out] publicKey The buffer to write the public key into.
+ * @return @c true if the key pair was generated, else @c false.
+ */
+static bool AiaKeyPairCache_Generate( const AiaKeyPairCache_t* cache,
+                                      uint8_t* privateKey, uint8_t* publicKey )
+{
+    if( !AiaCrypto_GenerateKeyPair( cache->algorithm, privateKey,
+                                    cache->privateKeyLen, publicKey,
+                                    cache->publicKeyLen ) )
+    {
+        AiaLogError( "AiaCrypto_GenerateKeyPair failed." );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Generates the next key pair of a cache on its task pool.
+ *
+ * @param taskPool The task pool running this job.
+ * @param job This job.
+ * @param context The @c AiaKeyPairCache_t to generate a key pair for.
+ */
+static void AiaKeyPairCache_GenerateRoutine( AiaTaskPool_t taskPool,
+                                             AiaTaskPoolJob_t job,
+                                             void* context )
+{
+    (void)taskPool;
+    (void)job;
+    AiaKeyPairCache_t* cache = (AiaKeyPairCache_t*)context;
+    AiaAssert( cache );
+    if( !cache )
+    {
+        AiaLogError( "Null cache." );
+        return;
+    }
+
+    /* Nothing else writes the keys while this job is scheduled or running, so
+     * they are generated in place without holding the mutex. */
+    bool isGenerated = AiaKeyPairCache_Generate(
+        cache, cache->keys, cache->keys + cache->privateKeyLen );
+
+    AiaMutex( Lock )( &cache->mutex );
+    cache->isCached = isGenerated;
+    cache->isGenerating = false;
+    if( cache->isDestroying )
+    {
+        AiaSemaphore( Post )( &cache->jobFinished );
+    }
+    AiaMutex( Unlock )( &cache->mutex );
+}
+
+/**
+ * Schedules the generation of the next key pair unless one is already cached
+ * or being generated.
+ *
+ * @param cache The @c AiaKeyPairCache_t to act on.
+ * @note This must be called while holding @c cache->mutex.
+ */
+static void AiaKeyPairCache_ScheduleLocked( AiaKeyPairCache_t* cache )
+{
+    if( cache->isCached || cache->isGenerating )
+    {
+        return;
+    }
+
+    AiaTaskPoolError_t error = AiaTaskPool( CreateJob )(
+        AiaKeyPairCache_GenerateRoutine, cache, &cache->jobStorage,
+        &cache->job );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateJob ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        return;
+    }
+    error = AiaTaskPool( ScheduleDeferred )( cache->taskPool, cache->job,
+                                             cache->delayMs );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( ScheduleDeferred ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        return;
+    }
+    cache->isGenerating = true;
+}
+
+AiaKeyPairCache_t* AiaKeyPairCache_Create(
+    AiaTaskPool_t taskPool, AiaSecretDerivationAlgorithm_t algorithm,
+    size_t privateKeyLen, size_t publicKeyLen, AiaDurationMs_t delayMs )
+{
+    if( !taskPool )
+    {
+        AiaLogError( "Null taskPool." );
+        return NULL;
+    }
+    if( !privateKeyLen || !publicKeyLen )
+    {
+        AiaLogError( "Invalid key lengths, privateKeyLen=%zu, publicKeyLen=%zu",
+                     privateKeyLen, publicKeyLen );
+        return NULL;
+    }
+
+    size_t cacheSize =
+        sizeof( AiaKeyPairCache_t ) + privateKeyLen + publicKeyLen;
+    AiaKeyPairCache_t* cache = (AiaKeyPairCache_t*)AiaCalloc( 1, cacheSize );
+    if( !cache )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", cacheSize );
+        return NULL;
+    }
+
+    if( !AiaMutex( Create )( &cache->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( cache );
+        return NULL;
+    }
+    if( !AiaSemaphore( Create )( &cache->jobFinished, 0, 1 ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &cache->mutex );
+        AiaFree( cache );
+        return NULL;
+    }
+
+    *(AiaTaskPool_t*)&cache->taskPool = taskPool;
+    *(AiaSecretDerivationAlgorithm_t*)&cache->algorithm = algorithm;
+    *(size_t*)&cache->privateKeyLen = privateKeyLen;
+    *(size_t*)&cache->publicKeyLen = publicKeyLen;
+    *(AiaDurationMs_t*)&cache->delayMs = delayMs;
+
+    /* A failure to schedule is not fatal, since pairs can still be generated
+     * when they are taken. */
+    AiaMutex( Lock )( &cache->mutex );
+    AiaKeyPairCache_ScheduleLocked( cache );
+    AiaMutex( Unlock )( &cache->mutex );
+
+    return cache;
+}
+
+void AiaKeyPairCache_Destroy( AiaKeyPairCache_t* cache )
+{
+    if( !cache )
+    {
+        AiaLogDebug( "Null cache." );
+        return;
+    }
+
+    AiaMutex( Lock )( &cache->mutex );
+    bool isWaiting = false;
+    if( cache->isGenerating )
+    {
+        /* This fails if the job is already running, in which case it is
+         * waited for. */
+        AiaTaskPoolError_t error =
+            AiaTaskPool( TryCancel )( cache->taskPool, cache->job, NULL );
+        if( AiaTaskPoolSucceeded( error ) )
+        {
+            cache->isGenerating = false;
+        }
+        else
+        {
+            cache->isDestroying = true;
+            isWaiting = true;
+        }
+    }
+    AiaMutex( Unlock )( &cache->mutex );
+
+    if( isWaiting )
+    {
+        AiaSemaphore( Wait )( &cache->jobFinished );
+        /* The job posts while holding the mutex, so wait for it to let go. */
+        AiaMutex( Lock )( &cache->mutex );
+        AiaMutex( Unlock )( &cache->mutex );
+    }
+
+    AiaKeyPairCache_Wipe( cache->keys,
+                          cache->privateKeyLen + cache->publicKeyLen );
+    AiaSemaphore( Destroy )( &cache->jobFinished );
+    AiaMutex( Destroy )( &cache->mutex );
+    AiaFree( cache );
+}
+
+bool AiaKeyPairCache_Take( AiaKeyPairCache_t* cache, uint8_t* privateKey,
+                           size_t privateKeyLen, uint8_t* publicKey,
+                           size_t publicKeyLen )
+{
+    if( !cache )
+    {
+        AiaLogError( "Null cache." );
+        return false;
+    }
+    if( !privateKey || !publicKey )
+    {
+        AiaLogError( "Null key buffer." );
+        return false;
+    }
+    if( privateKeyLen != cache->privateKeyLen ||
+        publicKeyLen != cache->publicKeyLen )
+    {
+        AiaLogError( "Invalid key lengths, privateKeyLen=%zu, publicKeyLen=%zu",
+                     privateKeyLen, publicKeyLen );
+        return false;
+    }
+
+    AiaMutex( Lock )( &cache->mutex );
+    bool isCached = cache->isCached;
+    if( isCached )
+    {
+        memcpy( privateKey, cache->keys, privateKeyLen );
+        memcpy( publicKey, cache->keys + privateKeyLen, publicKeyLen );
+        AiaKeyPairCache_Wipe( cache->keys, privateKeyLen + publicKeyLen );
+        cache->isCached = false;
+    }
+    AiaKeyPairCache_ScheduleLocked( cache );
+    AiaMutex( Unlock )( &cache->mutex );
+
+    if( isCached )
+    {
+        return true;
+    }
+    AiaLogDebug( "No key pair cached, generating one now." );
+    return AiaKeyPairCache_Generate( cache, privateKey, publicKey );
+}
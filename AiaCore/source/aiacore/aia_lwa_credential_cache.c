@@ -0,0 +1,414 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_lwa_credential_cache.c
+ * @brief Implements functions for the AiaLwaCredentialCache_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_lwa_credential_cache.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+#include AiaTaskPool( HEADER )
+
+#include <inttypes.h>
+#include <string.h>
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaLwaCredentialCache_t abstraction.
+ */
+struct AiaLwaCredentialCache
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** The cached credentials, or @c NULL until they are first fetched. */
+    AiaLwaCredentials_t* credentials;
+
+    /** When @c credentials were fetched. */
+    AiaTimepointMs_t fetchedAtMs;
+
+    /** Whether @c job is scheduled or running. */
+    bool isRefreshing;
+
+    /** Whether @c AiaLwaCredentialCache_Destroy() is waiting for @c job. */
+    bool isDestroying;
+
+    /** @} */
+
+    /** Posted by @c job when it finishes while @c isDestroying is set. */
+    AiaSemaphore_t jobFinished;
+
+    /** The task pool credentials are fetched on. */
+    const AiaTaskPool_t taskPool;
+
+    /** The time between two background fetches. */
+    const AiaDurationMs_t refreshIntervalMs;
+
+    /** How long fetched credentials may be used for. */
+    const AiaDurationMs_t maxAgeMs;
+
+    /** The job which refreshes the credentials. */
+    AiaTaskPoolJob_t job;
+
+    /** Storage for @c job. */
+    AiaTaskPoolJobStorage_t jobStorage;
+};
+
+/**
+ * Allocates credentials with room for strings of the given sizes after them.
+ *
+ * @param refreshTokenLen The size of the refresh token, including its @c '\0'.
+ * @param lwaClientIdLen The size of the LWA Client Id, including its @c '\0'.
+ * @return The credentials, with their strings zeroed, or @c NULL on failure.
+ */
+static AiaLwaCredentials_t* AiaLwaCredentials_Allocate( size_t refreshTokenLen,
+                                                        size_t lwaClientIdLen )
+{
+    size_t credentialsSize =
+        sizeof( AiaLwaCredentials_t ) + refreshTokenLen + lwaClientIdLen;
+    AiaLwaCredentials_t* credentials =
+        (AiaLwaCredentials_t*)AiaCalloc( 1, credentialsSize );
+    if( !credentials )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", credentialsSize );
+        return NULL;
+    }
+    credentials->refreshToken = (const char*)( credentials + 1 );
+    credentials->refreshTokenLen = refreshTokenLen;
+    credentials->lwaClientId = credentials->refreshToken + refreshTokenLen;
+    credentials->lwaClientIdLen = lwaClientIdLen;
+    return credentials;
+}
+
+/**
+ * Copies credentials.
+ *
+ * @param credentials The credentials to copy.
+ * @return The copy, or @c NULL on failure.
+ */
+static AiaLwaCredentials_t* AiaLwaCredentials_Copy(
+    const AiaLwaCredentials_t* credentials )
+{
+    AiaLwaCredentials_t* copy = AiaLwaCredentials_Allocate(
+        credentials->refreshTokenLen, credentials->lwaClientIdLen );
+    if( copy )
+    {
+        memcpy( (char*)copy->refreshToken, credentials->refreshToken,
+                credentials->refreshTokenLen + credentials->lwaClientIdLen );
+    }
+    return copy;
+}
+
+AiaLwaCredentials_t* AiaLwaCredentials_Load()
+{
+    size_t refreshTokenLen;
+    if( !AiaGetRefreshToken( NULL, &refreshTokenLen ) )
+    {
+        AiaLogError( "AiaGetRefreshToken failed to get the length." );
+        return NULL;
+    }
+    size_t lwaClientIdLen;
+    if( !AiaGetLwaClientId( NULL, &lwaClientIdLen ) )
+    {
+        AiaLogError( "AiaGetLwaClientId failed to get the length." );
+        return NULL;
+    }
+
+    AiaLwaCredentials_t* credentials =
+        AiaLwaCredentials_Allocate( refreshTokenLen, lwaClientIdLen );
+    if( !credentials )
+    {
+        return NULL;
+    }
+    if( !AiaGetRefreshToken( (char*)credentials->refreshToken,
+                             &refreshTokenLen ) )
+    {
+        AiaLogError( "AiaGetRefreshToken failed." );
+        AiaLwaCredentials_Destroy( credentials );
+        return NULL;
+    }
+    if( !AiaGetLwaClientId( (char*)credentials->lwaClientId,
+                            &lwaClientIdLen ) )
+    {
+        AiaLogError( "AiaGetLwaClientId failed." );
+        AiaLwaCredentials_Destroy( credentials );
+        return NULL;
+    }
+    return credentials;
+}
+
+void AiaLwaCredentials_Destroy( AiaLwaCredentials_t* credentials )
+{
+    if( !credentials )
+    {
+        AiaLogDebug( "Null credentials." );
+        return;
+    }
+
+    /* Overwrite the strings in a way that is not optimized away. */
+    volatile char* secret = (volatile char*)credentials->refreshToken;
+    size_t secretLen =
+        credentials->refreshTokenLen + credentials->lwaClientIdLen;
+    while( secretLen-- )
+    {
+        *secret++ = 0;
+    }
+    AiaFree( credentials );
+}
+
+/**
+ * Schedules the next refresh of the credentials unless one is already
+ * scheduled or running.
+ *
+ * @param cache The @c AiaLwaCredentialCache_t to act on.
+ * @param delayMs How long to wait before refreshing.
+ * @note This must be called while holding @c cache->mutex.
+ */
+static void AiaLwaCredentialCache_ScheduleLocked(
+    AiaLwaCredentialCache_t* cache, AiaDurationMs_t delayMs );
+
+/**
+ * Refreshes the credentials of a cache on its task pool, then schedules the
+ * next refresh.
+ *
+ * @param taskPool The task pool running this job.
+ * @param job This job.
+ * @param context The @c AiaLwaCredentialCache_t to refresh.
+ */
+static void AiaLwaCredentialCache_RefreshRoutine( AiaTaskPool_t taskPool,
+                                                  AiaTaskPoolJob_t job,
+                                                  void* context )
+{
+    (void)taskPool;
+    (void)job;
+    AiaLwaCredentialCache_t* cache = (AiaLwaCredentialCache_t*)context;
+    AiaAssert( cache );
+    if( !cache )
+    {
+        AiaLogError( "Null cache." );
+        return;
+    }
+
+    AiaLwaCredentials_t* credentials = AiaLwaCredentials_Load();
+    AiaTimepointMs_t nowMs = AiaClock( GetTimeMs )();
+
+    AiaMutex( Lock )( &cache->mutex );
+    AiaLwaCredentials_t* staleCredentials = NULL;
+    if( credentials )
+    {
+        staleCredentials = cache->credentials;
+        cache->credentials = credentials;
+        cache->fetchedAtMs = nowMs;
+    }
+    else
+    {
+        AiaLogWarn( "Failed to refresh the LWA credentials." );
+    }
+    cache->isRefreshing = false;
+    if( cache->isDestroying )
+    {
+        AiaSemaphore( Post )( &cache->jobFinished );
+    }
+    else
+    {
+        AiaLwaCredentialCache_ScheduleLocked( cache,
+                                              cache->refreshIntervalMs );
+    }
+    AiaMutex( Unlock )( &cache->mutex );
+
+    if( staleCredentials )
+    {
+        AiaLwaCredentials_Destroy( staleCredentials );
+    }
+}
+
+static void AiaLwaCredentialCache_ScheduleLocked(
+    AiaLwaCredentialCache_t* cache, AiaDurationMs_t delayMs )
+{
+    if( cache->isRefreshing )
+    {
+        return;
+    }
+
+    AiaTaskPoolError_t error = AiaTaskPool( CreateJob )(
+        AiaLwaCredentialCache_RefreshRoutine, cache, &cache->jobStorage,
+        &cache->job );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateJob ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        return;
+    }
+    error =
+        AiaTaskPool( ScheduleDeferred )( cache->taskPool, cache->job, delayMs );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( ScheduleDeferred ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        return;
+    }
+    cache->isRefreshing = true;
+}
+
+AiaLwaCredentialCache_t* AiaLwaCredentialCache_Create(
+    AiaTaskPool_t taskPool, AiaDurationMs_t refreshIntervalMs,
+    AiaDurationMs_t maxAgeMs )
+{
+    if( !taskPool )
+    {
+        AiaLogError( "Null taskPool." );
+        return NULL;
+    }
+    if( !refreshIntervalMs || maxAgeMs < refreshIntervalMs )
+    {
+        AiaLogError( "Invalid durations, refreshIntervalMs=%" PRIu32
+                     ", maxAgeMs=%" PRIu32,
+                     refreshIntervalMs, maxAgeMs );
+        return NULL;
+    }
+
+    AiaLwaCredentialCache_t* cache = (AiaLwaCredentialCache_t*)AiaCalloc(
+        1, sizeof( AiaLwaCredentialCache_t ) );
+    if( !cache )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaLwaCredentialCache_t ) );
+        return NULL;
+    }
+
+    if( !AiaMutex( Create )( &cache->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( cache );
+        return NULL;
+    }
+    if( !AiaSemaphore( Create )( &cache->jobFinished, 0, 1 ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &cache->mutex );
+        AiaFree( cache );
+        return NULL;
+    }
+
+    *(AiaTaskPool_t*)&cache->taskPool = taskPool;
+    *(AiaDurationMs_t*)&cache->refreshIntervalMs = refreshIntervalMs;
+    *(AiaDurationMs_t*)&cache->maxAgeMs = maxAgeMs;
+
+    /* A failure to schedule is not fatal, since credentials can still be
+     * fetched when they are needed. */
+    AiaMutex( Lock )( &cache->mutex );
+    AiaLwaCredentialCache_ScheduleLocked( cache, 0 );
+    AiaMutex( Unlock )( &cache->mutex );
+
+    return cache;
+}
+
+void AiaLwaCredentialCache_Destroy( AiaLwaCredentialCache_t* cache )
+{
+    if( !cache )
+    {
+        AiaLogDebug( "Null cache." );
+        return;
+    }
+
+    AiaMutex( Lock )( &cache->mutex );
+    bool isWaiting = false;
+    if( cache->isRefreshing )
+    {
+        /* This fails if the job is already running, in which case it is
+         * waited for. */
+        AiaTaskPoolError_t error =
+            AiaTaskPool( TryCancel )( cache->taskPool, cache->job, NULL );
+        if( AiaTaskPoolSucceeded( error ) )
+        {
+            cache->isRefreshing = false;
+        }
+        else
+        {
+            cache->isDestroying = true;
+            isWaiting = true;
+        }
+    }
+    AiaMutex( Unlock )( &cache->mutex );
+
+    if( isWaiting )
+    {
+        AiaSemaphore( Wait )( &cache->jobFinished );
+        /* The job posts while holding the mutex, so wait for it to let go. */
+        AiaMutex( Lock )( &cache->mutex );
+        AiaMutex( Unlock )( &cache->mutex );
+    }
+
+    if( cache->credentials )
+    {
+        AiaLwaCredentials_Destroy( cache->credentials );
+    }
+    AiaSemaphore( Destroy )( &cache->jobFinished );
+    AiaMutex( Destroy )( &cache->mutex );
+    AiaFree( cache );
+}
+
+AiaLwaCredentials_t* AiaLwaCredentialCache_Get(
+    AiaLwaCredentialCache_t* cache )
+{
+    if( !cache )
+    {
+        AiaLogError( "Null cache." );
+        return NULL;
+    }
+
+    AiaMutex( Lock )( &cache->mutex );
+    bool isFresh =
+        cache->credentials &&
+        AiaClock( GetTimeMs )() - cache->fetchedAtMs < cache->maxAgeMs;
+    AiaLwaCredentials_t* copy =
+        isFresh ? AiaLwaCredentials_Copy( cache->credentials ) : NULL;
+    AiaMutex( Unlock )( &cache->mutex );
+    if( isFresh )
+    {
+        return copy;
+    }
+
+    AiaLogDebug( "No fresh LWA credentials cached, fetching them now." );
+    AiaLwaCredentials_t* credentials = AiaLwaCredentials_Load();
+    if( !credentials )
+    {
+        return NULL;
+    }
+    copy = AiaLwaCredentials_Copy( credentials );
+
+    AiaMutex( Lock )( &cache->mutex );
+    AiaLwaCredentials_t* staleCredentials = cache->credentials;
+    cache->credentials = credentials;
+    cache->fetchedAtMs = AiaClock( GetTimeMs )();
+    AiaMutex( Unlock )( &cache->mutex );
+
+    if( staleCredentials )
+    {
+        AiaLwaCredentials_Destroy( staleCredentials );
+    }
+    return copy;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_budget.c
+ * @brief Implements functions for the AiaMemoryBudget_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_memory_budget.h>
+
+#include <inttypes.h>
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaMemoryBudget_t abstraction. Its counters should only be accessed using
+ * atomic operations.
+ */
+struct AiaMemoryBudget
+{
+    /** Counters reported by @c AiaMemoryBudget_GetMetrics(). */
+    AiaMemoryBudgetMetrics_t metrics;
+};
+
+/**
+ * Raises the peak usage of a budget to a new level if it is higher.
+ *
+ * @param budget The @c AiaMemoryBudget_t to act on.
+ * @param usedBytes The usage just reached.
+ */
+static void AiaMemoryBudget_UpdatePeak( AiaMemoryBudget_t* budget,
+                                        uint32_t usedBytes )
+{
+    uint32_t peakBytes = AiaAtomic_Load_u32( &budget->metrics.peakBytes );
+    while( usedBytes > peakBytes &&
+           !AiaAtomic_CompareAndSwap_u32( &budget->metrics.peakBytes,
+                                          usedBytes, peakBytes ) )
+    {
+        peakBytes = AiaAtomic_Load_u32( &budget->metrics.peakBytes );
+    }
+}
+
+AiaMemoryBudget_t* AiaMemoryBudget_Create( size_t limitBytes )
+{
+    if( !limitBytes || limitBytes > UINT32_MAX )
+    {
+        AiaLogError( "Invalid limit, limitBytes=%zu.", limitBytes );
+        return NULL;
+    }
+    AiaMemoryBudget_t* budget = AiaCalloc( 1, sizeof( AiaMemoryBudget_t ) );
+    if( !budget )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaMemoryBudget_t ) );
+        return NULL;
+    }
+    budget->metrics.limitBytes = (uint32_t)limitBytes;
+    return budget;
+}
+
+void AiaMemoryBudget_Destroy( AiaMemoryBudget_t* budget )
+{
+    if( !budget )
+    {
+        AiaLogDebug( "Null budget." );
+        return;
+    }
+    if( budget->metrics.usedBytes )
+    {
+        AiaLogWarn( "Destroying a budget still charged, usedBytes=%" PRIu32,
+                    budget->metrics.usedBytes );
+    }
+    AiaFree( budget );
+}
+
+bool AiaMemoryBudget_Charge( AiaMemoryBudget_t* budget, size_t bytes )
+{
+    AiaAssert( budget );
+    if( !budget )
+    {
+        AiaLogError( "Null budget." );
+        return false;
+    }
+    uint32_t usedBytes;
+    do
+    {
+        usedBytes = AiaAtomic_Load_u32( &budget->metrics.usedBytes );
+        if( bytes > budget->metrics.limitBytes ||
+            usedBytes > budget->metrics.limitBytes - bytes )
+        {
+            AiaAtomic_Add_u32( &budget->metrics.refusals, 1 );
+            AiaLogWarn( "Memory budget exceeded, bytes=%zu, usedBytes=%" PRIu32
+                        ", limitBytes=%" PRIu32,
+                        bytes, usedBytes, budget->metrics.limitBytes );
+            return false;
+        }
+    } while( !AiaAtomic_CompareAndSwap_u32( &budget->metrics.usedBytes,
+                                            usedBytes + (uint32_t)bytes,
+                                            usedBytes ) );
+    AiaMemoryBudget_UpdatePeak( budget, usedBytes + (uint32_t)bytes );
+    return true;
+}
+
+void AiaMemoryBudget_ForceCharge( AiaMemoryBudget_t* budget, size_t bytes )
+{
+    AiaAssert( budget );
+    if( !budget )
+    {
+        AiaLogError( "Null budget." );
+        return;
+    }
+    uint32_t usedBytes =
+        AiaAtomic_Add_u32( &budget->metrics.usedBytes, (uint32_t)bytes ) +
+        (uint32_t)bytes;
+    AiaMemoryBudget_UpdatePeak( budget, usedBytes );
+}
+
+void AiaMemoryBudget_Release( AiaMemoryBudget_t* budget, size_t bytes )
+{
+    AiaAssert( budget );
+    if( !budget )
+    {
+        AiaLogError( "Null budget." );
+        return;
+    }
+    uint32_t usedBytes =
+        AiaAtomic_Add_u32( &budget->metrics.usedBytes, -(uint32_t)bytes );
+    AiaAssert( usedBytes >= bytes );
+    (void)usedBytes;
+}
+
+void AiaMemoryBudget_GetMetrics( AiaMemoryBudget_t* budget,
+                                 AiaMemoryBudgetMetrics_t* metrics )
+{
+    AiaAssert( budget );
+    AiaAssert( metrics );
+    if( !budget || !metrics )
+    {
+        AiaLogError( "Null budget or metrics." );
+        return;
+    }
+    metrics->limitBytes = budget->metrics.limitBytes;
+    metrics->usedBytes = AiaAtomic_Load_u32( &budget->metrics.usedBytes );
+    metrics->peakBytes = AiaAtomic_Load_u32( &budget->metrics.peakBytes );
+    metrics->refusals = AiaAtomic_Load_u32( &budget->metrics.refusals );
+}
@@ -29,7 +29,10 @@ bool _AiaMessage_Initialize( AiaMessage_t* message, size_t size )
         AiaLogError( "Null message." );
         return false;
     }
+    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
+    message->link = defaultLink;
     message->size = size;
+    message->supersedeKey = 0;
     return true;
 }
 
@@ -44,3 +47,27 @@ size_t AiaMessage_GetSize( const AiaMessage_t* message )
     AiaAssert( message );
     return message ? message->size : 0;
 }
+
+bool AiaMessage_SetSupersedeKey( AiaMessage_t* message,
+                                 AiaMessageSupersedeKey_t key )
+{
+    if( !message )
+    {
+        AiaLogError( "Null message." );
+        return false;
+    }
+    if( key > AIA_MESSAGE_MAX_SUPERSEDE_KEY )
+    {
+        AiaLogError( "Invalid key, key=%u.", (unsigned)key );
+        return false;
+    }
+    message->supersedeKey = key;
+    return true;
+}
+
+AiaMessageSupersedeKey_t AiaMessage_GetSupersedeKey(
+    const AiaMessage_t* message )
+{
+    AiaAssert( message );
+    return message ? message->supersedeKey : 0;
+}
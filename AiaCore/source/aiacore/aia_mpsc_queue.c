@@ -0,0 +1,178 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mpsc_queue.c
+ * @brief Implements functions for the AiaMpscQueue_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_mpsc_queue.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Private data for the @c AiaMpscQueue_t type. */
+struct AiaMpscQueue
+{
+    /** The position the next element will be pushed at. This should only be
+     * accessed using atomic operations. */
+    uint32_t tail;
+
+    /** Keeps @c tail, which every producer writes, off the consumer's line. */
+    uint8_t tailPadding[ AIA_CACHE_LINE_SIZE ];
+
+    /** The position the next element will be popped from. This is only
+     * accessed by the consumer. */
+    uint32_t head;
+
+    /** The number of slots, a power of two. */
+    uint32_t capacity;
+
+    /** The size of each element. */
+    size_t elementSize;
+
+    /**
+     * The sequence number of each slot, which is the position it can next be
+     * pushed at, or that position plus one once an element has been pushed
+     * there and can be popped. These should only be accessed using atomic
+     * operations.
+     */
+    uint32_t* sequences;
+
+    /** @c capacity elements of @c elementSize bytes. */
+    uint8_t* elements;
+};
+
+AiaMpscQueue_t* AiaMpscQueue_Create( size_t capacity, size_t elementSize )
+{
+    if( !capacity || capacity & ( capacity - 1 ) )
+    {
+        AiaLogError( "Capacity is not a power of two, capacity=%zu.",
+                     capacity );
+        return NULL;
+    }
+    if( capacity > UINT32_MAX / 2 )
+    {
+        AiaLogError( "Capacity too large, capacity=%zu, max=%zu.", capacity,
+                     (size_t)UINT32_MAX / 2 );
+        return NULL;
+    }
+    if( !elementSize || elementSize > SIZE_MAX / capacity )
+    {
+        AiaLogError( "Invalid element size, elementSize=%zu.", elementSize );
+        return NULL;
+    }
+
+    AiaMpscQueue_t* queue = AiaCalloc( 1, sizeof( AiaMpscQueue_t ) );
+    if( !queue )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", sizeof( AiaMpscQueue_t ) );
+        return NULL;
+    }
+    queue->sequences = AiaCalloc( capacity, sizeof( uint32_t ) );
+    queue->elements = AiaCalloc( capacity, elementSize );
+    if( !queue->sequences || !queue->elements )
+    {
+        AiaLogError( "AiaCalloc failed, capacity=%zu.", capacity );
+        AiaMpscQueue_Destroy( queue );
+        return NULL;
+    }
+    for( uint32_t i = 0; i < capacity; ++i )
+    {
+        queue->sequences[ i ] = i;
+    }
+    queue->capacity = (uint32_t)capacity;
+    queue->elementSize = elementSize;
+    return queue;
+}
+
+void AiaMpscQueue_Destroy( AiaMpscQueue_t* queue )
+{
+    if( !queue )
+    {
+        AiaLogDebug( "Null queue." );
+        return;
+    }
+    AiaFree( queue->elements );
+    AiaFree( queue->sequences );
+    AiaFree( queue );
+}
+
+bool AiaMpscQueue_Push( AiaMpscQueue_t* queue, const void* element )
+{
+    AiaAssert( queue );
+    if( !queue || !element )
+    {
+        AiaLogError( "Null queue or element." );
+        return false;
+    }
+
+    uint32_t mask = queue->capacity - 1;
+    uint32_t position = AiaAtomic_Load_u32( &queue->tail );
+    while( true )
+    {
+        uint32_t sequence =
+            AiaAtomic_Load_u32( &queue->sequences[ position & mask ] );
+        int32_t lag = (int32_t)( sequence - position );
+        if( !lag )
+        {
+            /* The slot is free; claim it unless another producer did first. */
+            if( AiaAtomic_CompareAndSwap_u32( &queue->tail, position + 1,
+                                              position ) )
+            {
+                break;
+            }
+        }
+        else if( lag < 0 )
+        {
+            /* The slot still holds the element pushed a lap ago. */
+            return false;
+        }
+        position = AiaAtomic_Load_u32( &queue->tail );
+    }
+
+    memcpy( queue->elements + ( position & mask ) * queue->elementSize,
+            element, queue->elementSize );
+    AiaAtomic_Store_u32( &queue->sequences[ position & mask ], position + 1 );
+    return true;
+}
+
+bool AiaMpscQueue_Pop( AiaMpscQueue_t* queue, void* element )
+{
+    AiaAssert( queue );
+    if( !queue || !element )
+    {
+        AiaLogError( "Null queue or element." );
+        return false;
+    }
+
+    uint32_t mask = queue->capacity - 1;
+    uint32_t position = queue->head;
+    uint32_t* sequence = &queue->sequences[ position & mask ];
+    if( AiaAtomic_Load_u32( sequence ) != position + 1 )
+    {
+        return false;
+    }
+
+    memcpy( element, queue->elements + ( position & mask ) * queue->elementSize,
+            queue->elementSize );
+    AiaAtomic_Store_u32( sequence, position + queue->capacity );
+    queue->head = position + 1;
+    return true;
+}
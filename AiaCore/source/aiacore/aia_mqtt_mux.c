@@ -0,0 +1,331 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mqtt_mux.c
+ * @brief Implements functions for the AiaMqttMux_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_mqtt_mux.h>
+
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+
+#include <string.h>
+
+/** A device topic root and the handler its messages are routed to. */
+typedef struct AiaMqttMuxRoute
+{
+    /** The next route in the same bucket. */
+    struct AiaMqttMuxRoute* next;
+
+    /** The handler to pass messages on to. */
+    AiaMqttTopicHandler_t handler;
+
+    /** Context to pass to @c handler. */
+    void* userData;
+
+    /** The number of calls to @c handler in progress. This is synchronized by
+     * the mux's @c mutex. */
+    size_t numCalls;
+
+    /** Whether @c AiaMqttMux_RemoveRoute() is waiting for @c numCalls to
+     * reach zero. This is synchronized by the mux's @c mutex. */
+    bool isDraining;
+
+    /** Posted by the last call in progress once @c isDraining is set. */
+    AiaSemaphore_t drained;
+
+    /** The length of @c topicRoot. */
+    size_t topicRootLength;
+
+    /** The device topic root, which is not null-terminated. */
+    char topicRoot[];
+} AiaMqttMuxRoute_t;
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaMqttMux_t abstraction.
+ */
+struct AiaMqttMux
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Chains of routes, indexed by the hash of their topic root. */
+    AiaMqttMuxRoute_t** buckets;
+
+    /** @} */
+
+    /** The number of entries in @c buckets. */
+    size_t numBuckets;
+};
+
+/**
+ * Hashes a device topic root.
+ *
+ * @param topicRoot The device topic root.
+ * @param topicRootLength The length of @c topicRoot.
+ * @return The hash of @c topicRoot.
+ */
+static uint32_t AiaMqttMux_Hash( const char* topicRoot, size_t topicRootLength )
+{
+    /* 32-bit FNV-1a, which is cheap and spreads short identifiers well. */
+    uint32_t hash = 2166136261u;
+    for( size_t i = 0; i < topicRootLength; ++i )
+    {
+        hash ^= (unsigned char)topicRoot[ i ];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Finds the link pointing to the route for a device topic root.
+ *
+ * @param mux The @c AiaMqttMux_t to act on.
+ * @param topicRoot The device topic root to look for.
+ * @param topicRootLength The length of @c topicRoot.
+ * @return The link pointing to the route, which points to @c NULL if there is
+ * none.
+ * @note This must be called while holding @c mux->mutex.
+ */
+static AiaMqttMuxRoute_t** AiaMqttMux_FindLocked( AiaMqttMux_t* mux,
+                                                  const char* topicRoot,
+                                                  size_t topicRootLength )
+{
+    AiaMqttMuxRoute_t** link =
+        &mux->buckets[ AiaMqttMux_Hash( topicRoot, topicRootLength ) %
+                       mux->numBuckets ];
+    while( *link && ( ( *link )->topicRootLength != topicRootLength ||
+                      memcmp( ( *link )->topicRoot, topicRoot,
+                              topicRootLength ) ) )
+    {
+        link = &( *link )->next;
+    }
+    return link;
+}
+
+AiaMqttMux_t* AiaMqttMux_Create( size_t numBuckets )
+{
+    if( !numBuckets )
+    {
+        AiaLogError( "Invalid numBuckets, numBuckets=%zu", numBuckets );
+        return NULL;
+    }
+
+    AiaMqttMux_t* mux = AiaCalloc( 1, sizeof( AiaMqttMux_t ) );
+    if( !mux )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", sizeof( AiaMqttMux_t ) );
+        return NULL;
+    }
+    mux->buckets = AiaCalloc( numBuckets, sizeof( AiaMqttMuxRoute_t* ) );
+    if( !mux->buckets )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     numBuckets * sizeof( AiaMqttMuxRoute_t* ) );
+        AiaFree( mux );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &mux->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( mux->buckets );
+        AiaFree( mux );
+        return NULL;
+    }
+    mux->numBuckets = numBuckets;
+    return mux;
+}
+
+void AiaMqttMux_Destroy( AiaMqttMux_t* mux )
+{
+    if( !mux )
+    {
+        AiaLogDebug( "Null mux." );
+        return;
+    }
+    for( size_t i = 0; i < mux->numBuckets; ++i )
+    {
+        AiaMqttMuxRoute_t* route = mux->buckets[ i ];
+        while( route )
+        {
+            AiaMqttMuxRoute_t* next = route->next;
+            AiaSemaphore( Destroy )( &route->drained );
+            AiaFree( route );
+            route = next;
+        }
+    }
+    AiaMutex( Destroy )( &mux->mutex );
+    AiaFree( mux->buckets );
+    AiaFree( mux );
+}
+
+bool AiaMqttMux_AddRoute( AiaMqttMux_t* mux, const char* topicRoot,
+                          size_t topicRootLength, AiaMqttTopicHandler_t handler,
+                          void* userData )
+{
+    if( !mux )
+    {
+        AiaLogError( "Null mux." );
+        return false;
+    }
+    if( !topicRoot || !handler )
+    {
+        AiaLogError( "Null topicRoot or handler." );
+        return false;
+    }
+    if( !topicRootLength || topicRoot[ topicRootLength - 1 ] != '/' )
+    {
+        AiaLogError( "Invalid topic root %.*s", (int)topicRootLength,
+                     topicRoot );
+        return false;
+    }
+
+    size_t routeSize = sizeof( AiaMqttMuxRoute_t ) + topicRootLength;
+    AiaMqttMuxRoute_t* route = AiaCalloc( 1, routeSize );
+    if( !route )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", routeSize );
+        return false;
+    }
+    if( !AiaSemaphore( Create )( &route->drained, 0, 1 ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaFree( route );
+        return false;
+    }
+    route->handler = handler;
+    route->userData = userData;
+    route->topicRootLength = topicRootLength;
+    memcpy( route->topicRoot, topicRoot, topicRootLength );
+
+    AiaMutex( Lock )( &mux->mutex );
+    AiaMqttMuxRoute_t** link =
+        AiaMqttMux_FindLocked( mux, topicRoot, topicRootLength );
+    if( *link )
+    {
+        AiaMutex( Unlock )( &mux->mutex );
+        AiaLogError( "Topic root already routed, %.*s",
+                     (int)topicRootLength, topicRoot );
+        AiaSemaphore( Destroy )( &route->drained );
+        AiaFree( route );
+        return false;
+    }
+    *link = route;
+    AiaMutex( Unlock )( &mux->mutex );
+    return true;
+}
+
+bool AiaMqttMux_RemoveRoute( AiaMqttMux_t* mux, const char* topicRoot,
+                             size_t topicRootLength )
+{
+    if( !mux )
+    {
+        AiaLogError( "Null mux." );
+        return false;
+    }
+    if( !topicRoot )
+    {
+        AiaLogError( "Null topicRoot." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &mux->mutex );
+    AiaMqttMuxRoute_t** link =
+        AiaMqttMux_FindLocked( mux, topicRoot, topicRootLength );
+    AiaMqttMuxRoute_t* route = *link;
+    if( !route )
+    {
+        AiaMutex( Unlock )( &mux->mutex );
+        AiaLogError( "Topic root not routed, %.*s", (int)topicRootLength,
+                     topicRoot );
+        return false;
+    }
+    *link = route->next;
+
+    /* Wait for calls to the handler which are already in progress, so that
+     * its context can be released once this returns. */
+    bool isDraining = route->numCalls > 0;
+    route->isDraining = isDraining;
+    AiaMutex( Unlock )( &mux->mutex );
+    if( isDraining )
+    {
+        AiaSemaphore( Wait )( &route->drained );
+    }
+    AiaSemaphore( Destroy )( &route->drained );
+    AiaFree( route );
+    return true;
+}
+
+void AiaMqttMux_MessageReceived( void* userData,
+                                 AiaMqttCallbackParam_t* callbackParam )
+{
+    AiaMqttMux_t* mux = (AiaMqttMux_t*)userData;
+    if( !mux )
+    {
+        AiaLogError( "Null mux." );
+        return;
+    }
+    if( !callbackParam )
+    {
+        AiaLogError( "Null callbackParam." );
+        return;
+    }
+
+    const char* topic = callbackParam->u.message.info.pTopicName;
+    size_t topicLength = callbackParam->u.message.info.topicNameLength;
+
+    /* Device topic roots end with '/', so only prefixes ending there need to
+     * be looked up, longest first. */
+    AiaMqttMuxRoute_t* route = NULL;
+    AiaMutex( Lock )( &mux->mutex );
+    for( size_t i = topicLength; i > 0 && !route; --i )
+    {
+        if( topic[ i - 1 ] == '/' )
+        {
+            route = *AiaMqttMux_FindLocked( mux, topic, i );
+        }
+    }
+    if( !route )
+    {
+        AiaMutex( Unlock )( &mux->mutex );
+        AiaLogWarn( "No route for topic %.*s", (int)topicLength, topic );
+        return;
+    }
+    ++route->numCalls;
+    AiaMqttTopicHandler_t handler = route->handler;
+    void* handlerUserData = route->userData;
+    AiaMutex( Unlock )( &mux->mutex );
+
+    /* The handler runs unlocked so that messages for different routes are
+     * handled concurrently and handlers may call back into the mux. */
+    handler( handlerUserData, callbackParam );
+
+    AiaMutex( Lock )( &mux->mutex );
+    if( !--route->numCalls && route->isDraining )
+    {
+        AiaSemaphore( Post )( &route->drained );
+    }
+    AiaMutex( Unlock )( &mux->mutex );
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_overload_governor.c
+ * @brief Implements the overload governor.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_overload_governor.h>
+
+#include AiaClock( HEADER )
+
+#include <inttypes.h>
+
+/** The current shed level. Only written by the thread judging a window. */
+static uint32_t g_level;
+
+/** The number of windows in a row without pressure. Only accessed by the
+ * thread judging a window. */
+static uint32_t g_calmWindows;
+
+/** The low 32 bits of the time the current window started. */
+static uint32_t g_windowStartMs;
+
+/** Task runs reported in the current window. */
+static uint32_t g_taskRuns;
+
+/** Late task runs reported in the current window. */
+static uint32_t g_lateTaskRuns;
+
+/** The longest queueing delay reported in the current window. */
+static uint32_t g_maxQueueAgeMs;
+
+/**
+ * Atomically resets a counter to zero.
+ *
+ * @param counter The counter to take.
+ * @return The value of @c counter before it was reset.
+ */
+static uint32_t takeCounter( uint32_t* counter )
+{
+    uint32_t value;
+    do
+    {
+        value = AiaAtomic_Load_u32( counter );
+    } while( !AiaAtomic_CompareAndSwap_u32( counter, 0, value ) );
+    return value;
+}
+
+/**
+ * Changes the shed level.
+ *
+ * @param level The new level.
+ */
+static void setLevel( uint32_t level )
+{
+    uint32_t previousLevel = AiaAtomic_Load_u32( &g_level );
+    if( level == previousLevel )
+    {
+        return;
+    }
+    AiaAtomic_Store_u32( &g_level, level );
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    AiaAtomic_Store_u32( &g_aiaLogDebugShed,
+                         level >= AIA_OVERLOAD_WORK_DEBUG_LOGS );
+#endif
+    if( level > previousLevel )
+    {
+        AiaLogWarn( "Overloaded, shedding work, level=%" PRIu32, level );
+    }
+    else
+    {
+        AiaLogInfo( "Load subsided, restoring work, level=%" PRIu32, level );
+    }
+}
+
+/**
+ * Ends the current window if it is over.
+ */
+static void checkWindow()
+{
+    uint32_t now = (uint32_t)AiaClock( GetTimeMs )();
+    uint32_t windowStartMs = AiaAtomic_Load_u32( &g_windowStartMs );
+    if( now - windowStartMs < AIA_OVERLOAD_WINDOW_MS )
+    {
+        return;
+    }
+
+    /* Only the thread which starts the next window judges this one. */
+    if( AiaAtomic_CompareAndSwap_u32( &g_windowStartMs, now, windowStartMs ) )
+    {
+        AiaOverloadGovernor_EndWindow();
+    }
+}
+
+void AiaOverloadGovernor_ReportTaskRun( AiaOverloadTask_t task, bool isLate )
+{
+    (void)task;
+    AiaAtomic_Add_u32( &g_taskRuns, 1 );
+    if( isLate )
+    {
+        AiaAtomic_Add_u32( &g_lateTaskRuns, 1 );
+    }
+    checkWindow();
+}
+
+void AiaOverloadGovernor_ReportQueueAge( uint32_t ageMs )
+{
+    uint32_t maxQueueAgeMs = AiaAtomic_Load_u32( &g_maxQueueAgeMs );
+    while( ageMs > maxQueueAgeMs &&
+           !AiaAtomic_CompareAndSwap_u32( &g_maxQueueAgeMs, ageMs,
+                                          maxQueueAgeMs ) )
+    {
+        maxQueueAgeMs = AiaAtomic_Load_u32( &g_maxQueueAgeMs );
+    }
+    checkWindow();
+}
+
+void AiaOverloadGovernor_EndWindow()
+{
+    uint32_t taskRuns = takeCounter( &g_taskRuns );
+    uint32_t lateTaskRuns = takeCounter( &g_lateTaskRuns );
+    uint32_t maxQueueAgeMs = takeCounter( &g_maxQueueAgeMs );
+
+    uint32_t level = AiaAtomic_Load_u32( &g_level );
+    if( ( taskRuns &&
+          (uint64_t)lateTaskRuns * 100 >=
+              (uint64_t)taskRuns * AIA_OVERLOAD_MISS_PERCENT ) ||
+        maxQueueAgeMs >= AIA_OVERLOAD_MAX_QUEUE_AGE_MS )
+    {
+        g_calmWindows = 0;
+        if( level < AIA_OVERLOAD_MAX_LEVEL )
+        {
+            setLevel( level + 1 );
+        }
+        return;
+    }
+
+    /* Only windows with no late runs at all count towards restoring work, so
+     * that the level does not flap around the threshold. */
+    if( lateTaskRuns || maxQueueAgeMs >= AIA_OVERLOAD_MAX_QUEUE_AGE_MS / 2 )
+    {
+        g_calmWindows = 0;
+        return;
+    }
+    if( level && ++g_calmWindows >= AIA_OVERLOAD_CALM_WINDOWS )
+    {
+        g_calmWindows = 0;
+        setLevel( level - 1 );
+    }
+}
+
+uint32_t AiaOverloadGovernor_GetLevel()
+{
+    return AiaAtomic_Load_u32( &g_level );
+}
+
+bool AiaOverloadGovernor_IsShed( AiaOverloadWork_t work )
+{
+    return AiaAtomic_Load_u32( &g_level ) >= (uint32_t)work;
+}
+
+void AiaOverloadGovernor_Reset()
+{
+    takeCounter( &g_taskRuns );
+    takeCounter( &g_lateTaskRuns );
+    takeCounter( &g_maxQueueAgeMs );
+    g_calmWindows = 0;
+    AiaAtomic_Store_u32( &g_windowStartMs,
+                         (uint32_t)AiaClock( GetTimeMs )() );
+    setLevel( 0 );
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm.c
+ * @brief Implements functions in aia_pcm.h
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_pcm.h>
+
+/** Scale between 16-bit samples and floating point samples. */
+#define AIA_PCM_FLOAT_SCALE 32768.0f
+
+/**
+ * The weight of each new block mean in the DC offset estimate, as a power of
+ * two. Larger values track slower.
+ */
+#define AIA_PCM_DC_TRACKING_SHIFT 3
+
+/**
+ * Computes the integer square root of @c value, rounded down.
+ *
+ * @param value The value to take the square root of.
+ * @return The square root of @c value.
+ */
+static uint32_t AiaPcm_SquareRoot( uint64_t value )
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while( bit > value )
+    {
+        bit >>= 2;
+    }
+    while( bit )
+    {
+        if( value >= root + bit )
+        {
+            value -= root + bit;
+            root = ( root >> 1 ) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void AiaPcm_RemoveDc( AiaPcmDcFilter_t* filter, int16_t* restrict samples,
+                      size_t numSamples )
+{
+    AiaAssert( filter );
+    if( !filter )
+    {
+        AiaLogError( "Null filter." );
+        return;
+    }
+    if( !samples || !numSamples )
+    {
+        return;
+    }
+
+    int64_t sum = 0;
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        sum += samples[ i ];
+    }
+    int32_t blockMean = (int32_t)( ( sum * 256 ) / (int64_t)numSamples );
+    filter->offset +=
+        ( blockMean - filter->offset ) / ( 1 << AIA_PCM_DC_TRACKING_SHIFT );
+
+    int32_t offset = filter->offset / 256;
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        int32_t sample = (int32_t)samples[ i ] - offset;
+        sample = sample > INT16_MAX ? INT16_MAX : sample;
+        sample = sample < INT16_MIN ? INT16_MIN : sample;
+        samples[ i ] = (int16_t)sample;
+    }
+}
+
+void AiaPcm_ApplyGain( int16_t* restrict samples, size_t numSamples,
+                       AiaPcmGain_t gain )
+{
+    if( !samples || AIA_PCM_GAIN_UNITY == gain )
+    {
+        return;
+    }
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        int32_t sample =
+            ( (int32_t)samples[ i ] * gain ) / AIA_PCM_GAIN_UNITY;
+        sample = sample > INT16_MAX ? INT16_MAX : sample;
+        sample = sample < INT16_MIN ? INT16_MIN : sample;
+        samples[ i ] = (int16_t)sample;
+    }
+}
+
+void AiaPcm_MeasureEnergy( const int16_t* restrict samples, size_t numSamples,
+                           AiaPcmEnergy_t* energy )
+{
+    AiaAssert( energy );
+    if( !energy )
+    {
+        AiaLogError( "Null energy." );
+        return;
+    }
+    energy->peak = 0;
+    energy->rms = 0;
+    if( !samples || !numSamples )
+    {
+        return;
+    }
+
+    int32_t peak = 0;
+    uint64_t sumOfSquares = 0;
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        int32_t sample = samples[ i ];
+        int32_t magnitude = sample < 0 ? -sample : sample;
+        peak = magnitude > peak ? magnitude : peak;
+        sumOfSquares += (uint32_t)( sample * sample );
+    }
+    energy->peak = (uint32_t)peak;
+    energy->rms = AiaPcm_SquareRoot( sumOfSquares / numSamples );
+}
+
+size_t AiaPcm_CountZeroCrossings( const int16_t* restrict samples,
+                                  size_t numSamples )
+{
+    if( !samples || numSamples < 2 )
+    {
+        return 0;
+    }
+
+    size_t crossings = 0;
+    for( size_t i = 1; i < numSamples; ++i )
+    {
+        /* The sign bit of the exclusive or is set when the signs differ. */
+        crossings += (uint16_t)( samples[ i - 1 ] ^ samples[ i ] ) >> 15;
+    }
+    return crossings;
+}
+
+void AiaPcm_Downmix( const int16_t* restrict frames, size_t numChannels,
+                     const AiaPcmGain_t* restrict weights,
+                     int16_t* restrict out, size_t numFrames )
+{
+    if( !frames || !weights || !out || !numChannels )
+    {
+        AiaLogError( "Invalid arguments." );
+        return;
+    }
+    for( size_t i = 0; i < numFrames; ++i )
+    {
+        const int16_t* frame = frames + i * numChannels;
+        /* A single weighted sample fills 32 bits, so the sum needs 64. */
+        int64_t sum = 0;
+        for( size_t channel = 0; channel < numChannels; ++channel )
+        {
+            sum += (int32_t)frame[ channel ] * weights[ channel ];
+        }
+        int64_t sample = sum / AIA_PCM_GAIN_UNITY;
+        sample = sample > INT16_MAX ? INT16_MAX : sample;
+        sample = sample < INT16_MIN ? INT16_MIN : sample;
+        out[ i ] = (int16_t)sample;
+    }
+}
+
+AiaPcmGain_t AiaPcm_GetNormalizationGain( uint32_t peak, uint16_t targetPeak,
+                                          AiaPcmGain_t maxGain )
+{
+    if( !peak )
+    {
+        return maxGain;
+    }
+    uint32_t gain = ( (uint32_t)targetPeak * AIA_PCM_GAIN_UNITY ) / peak;
+    return gain > maxGain ? maxGain : (AiaPcmGain_t)gain;
+}
+
+void AiaPcm_Int16ToFloat( const int16_t* restrict samples, float* restrict out,
+                          size_t numSamples )
+{
+    if( !samples || !out )
+    {
+        AiaLogError( "Null buffer." );
+        return;
+    }
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        out[ i ] = (float)samples[ i ] * ( 1.0f / AIA_PCM_FLOAT_SCALE );
+    }
+}
+
+void AiaPcm_FloatToInt16( const float* restrict samples, int16_t* restrict out,
+                          size_t numSamples )
+{
+    if( !samples || !out )
+    {
+        AiaLogError( "Null buffer." );
+        return;
+    }
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        float sample = samples[ i ] * AIA_PCM_FLOAT_SCALE;
+        sample += sample < 0.0f ? -0.5f : 0.5f;
+        /* Written so that NaN saturates rather than reaching the conversion. */
+        sample = sample < (float)INT16_MAX ? sample : (float)INT16_MAX;
+        sample = sample > (float)INT16_MIN ? sample : (float)INT16_MIN;
+        out[ i ] = (int16_t)sample;
+    }
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm_resampler.c
+ * @brief Implements functions for the AiaPcmResampler_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_pcm_resampler.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+/** The number of input frames carried between calls. */
+#define AIA_PCM_RESAMPLER_HISTORY_FRAMES ( AIA_PCM_RESAMPLER_TAPS - 1 )
+
+/** The number of fractional bits in the filter coefficients. */
+#define AIA_PCM_RESAMPLER_COEFFICIENT_BITS 14
+
+/** The passband of the filter, as a fraction of the lower Nyquist frequency. */
+#define AIA_PCM_RESAMPLER_BANDWIDTH 0.9
+
+/** Pi, so that the filter can be designed without the math library. */
+#define AIA_PCM_RESAMPLER_PI 3.14159265358979323846
+
+/**
+ * Computes the sine of @c x. This is only used to design the filter, so it
+ * favors not depending on the math library over speed.
+ *
+ * @param x The angle in radians.
+ * @return The sine of @c x.
+ */
+static double AiaPcmResampler_Sine( double x )
+{
+    /* The Taylor series converges quickly once reduced to [-pi, pi]. */
+    double turns = x / ( 2.0 * AIA_PCM_RESAMPLER_PI );
+    x -= (double)(int64_t)( turns + ( turns < 0.0 ? -0.5 : 0.5 ) ) * 2.0 *
+         AIA_PCM_RESAMPLER_PI;
+    double term = x;
+    double sum = x;
+    for( int i = 1; i < 12; ++i )
+    {
+        term *= -x * x / ( ( 2.0 * i ) * ( 2.0 * i + 1.0 ) );
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Computes the greatest common divisor of @c a and @c b.
+ *
+ * @param a A positive integer.
+ * @param b A positive integer.
+ * @return The greatest common divisor of @c a and @c b.
+ */
+static uint32_t AiaPcmResampler_GreatestCommonDivisor( uint32_t a, uint32_t b )
+{
+    while( b )
+    {
+        uint32_t remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+/**
+ * Designs the Blackman-windowed sinc filter of @c resampler, split into its
+ * phases and quantized so that each phase has a gain of exactly @c 1 at DC.
+ *
+ * @param resampler The resampler to act on.
+ */
+static void AiaPcmResampler_DesignFilter( AiaPcmResampler_t* resampler )
+{
+    uint32_t up = resampler->upFactor;
+    uint32_t slower =
+        up > resampler->downFactor ? up : resampler->downFactor;
+    size_t length = (size_t)up * AIA_PCM_RESAMPLER_TAPS;
+    double center = ( length - 1 ) / 2.0;
+    double cutoff = AIA_PCM_RESAMPLER_BANDWIDTH / slower;
+    double scale = (double)( 1 << AIA_PCM_RESAMPLER_COEFFICIENT_BITS );
+
+    for( uint32_t phase = 0; phase < up; ++phase )
+    {
+        int32_t sum = 0;
+        size_t largest = 0;
+        for( size_t tap = 0; tap < AIA_PCM_RESAMPLER_TAPS; ++tap )
+        {
+            /* The oldest frame is filtered by the last coefficient. */
+            size_t n = phase + ( AIA_PCM_RESAMPLER_TAPS - 1 - tap ) * up;
+            double x = AIA_PCM_RESAMPLER_PI * cutoff * ( n - center );
+            double sinc = x == 0.0 ? 1.0 : AiaPcmResampler_Sine( x ) / x;
+            /* Cosines are computed as sines a quarter turn ahead. */
+            double angle = 2.0 * AIA_PCM_RESAMPLER_PI * n / ( length - 1 );
+            double quarterTurn = AIA_PCM_RESAMPLER_PI / 2.0;
+            double window =
+                0.42 - 0.5 * AiaPcmResampler_Sine( angle + quarterTurn ) +
+                0.08 * AiaPcmResampler_Sine( 2.0 * angle + quarterTurn );
+            double value = up * cutoff * sinc * window * scale;
+            int16_t coefficient =
+                (int16_t)( value + ( value < 0.0 ? -0.5 : 0.5 ) );
+            resampler->coefficients[ phase ][ tap ] = coefficient;
+            sum += coefficient;
+            if( coefficient > resampler->coefficients[ phase ][ largest ] )
+            {
+                largest = tap;
+            }
+        }
+        resampler->coefficients[ phase ][ largest ] +=
+            ( 1 << AIA_PCM_RESAMPLER_COEFFICIENT_BITS ) - sum;
+    }
+}
+
+/**
+ * Filters one channel of one output frame.
+ *
+ * @param frames The oldest of the @c AIA_PCM_RESAMPLER_TAPS frames to filter,
+ * offset to the channel to filter.
+ * @param numChannels The number of interleaved channels in @c frames.
+ * @param coefficients The filter phase to apply.
+ * @return The filtered sample.
+ */
+static int16_t AiaPcmResampler_Filter( const int16_t* restrict frames,
+                                       size_t numChannels,
+                                       const int16_t* restrict coefficients )
+{
+    /* The magnitudes of each phase's coefficients sum to less than 2, so the
+     * sum fits in 32 bits. */
+    int32_t sum = 0;
+    for( size_t tap = 0; tap < AIA_PCM_RESAMPLER_TAPS; ++tap )
+    {
+        sum += (int32_t)frames[ tap * numChannels ] * coefficients[ tap ];
+    }
+    sum /= 1 << AIA_PCM_RESAMPLER_COEFFICIENT_BITS;
+    sum = sum > INT16_MAX ? INT16_MAX : sum;
+    sum = sum < INT16_MIN ? INT16_MIN : sum;
+    return (int16_t)sum;
+}
+
+bool AiaPcmResampler_Init( AiaPcmResampler_t* resampler, uint32_t inputRate,
+                           uint32_t outputRate, size_t numChannels )
+{
+    AiaAssert( resampler );
+    if( !resampler )
+    {
+        AiaLogError( "Null resampler." );
+        return false;
+    }
+    if( !inputRate || !outputRate )
+    {
+        AiaLogError( "Invalid rates, inputRate=%" PRIu32
+                     ", outputRate=%" PRIu32,
+                     inputRate, outputRate );
+        return false;
+    }
+    if( !numChannels || numChannels > AIA_PCM_RESAMPLER_MAX_CHANNELS )
+    {
+        AiaLogError( "Invalid numChannels, numChannels=%zu", numChannels );
+        return false;
+    }
+
+    uint32_t divisor =
+        AiaPcmResampler_GreatestCommonDivisor( inputRate, outputRate );
+    if( outputRate / divisor > AIA_PCM_RESAMPLER_MAX_PHASES )
+    {
+        AiaLogError( "Unsupported ratio, inputRate=%" PRIu32
+                     ", outputRate=%" PRIu32,
+                     inputRate, outputRate );
+        return false;
+    }
+
+    resampler->numChannels = numChannels;
+    resampler->upFactor = outputRate / divisor;
+    resampler->downFactor = inputRate / divisor;
+    AiaPcmResampler_DesignFilter( resampler );
+    AiaPcmResampler_Reset( resampler );
+    return true;
+}
+
+void AiaPcmResampler_Reset( AiaPcmResampler_t* resampler )
+{
+    AiaAssert( resampler );
+    if( !resampler )
+    {
+        AiaLogError( "Null resampler." );
+        return;
+    }
+    resampler->phase = 0;
+    resampler->position = 0;
+    memset( resampler->history, 0, sizeof( resampler->history ) );
+}
+
+size_t AiaPcmResampler_GetMaxOutputFrames( const AiaPcmResampler_t* resampler,
+                                           size_t numInputFrames )
+{
+    AiaAssert( resampler );
+    if( !resampler )
+    {
+        AiaLogError( "Null resampler." );
+        return 0;
+    }
+    return numInputFrames * resampler->upFactor / resampler->downFactor + 1;
+}
+
+size_t AiaPcmResampler_Process( AiaPcmResampler_t* resampler,
+                                const int16_t* input, size_t numInputFrames,
+                                int16_t* output, size_t outputCapacity )
+{
+    AiaAssert( resampler );
+    if( !resampler )
+    {
+        AiaLogError( "Null resampler." );
+        return 0;
+    }
+    if( !input || !output )
+    {
+        AiaLogError( "Null buffer." );
+        return 0;
+    }
+    if( outputCapacity <
+        AiaPcmResampler_GetMaxOutputFrames( resampler, numInputFrames ) )
+    {
+        AiaLogError( "Output too small, outputCapacity=%zu", outputCapacity );
+        return 0;
+    }
+
+    size_t numChannels = resampler->numChannels;
+    size_t frameBytes = numChannels * sizeof( int16_t );
+    int16_t* history = resampler->history;
+
+    /* Frames older than the input are read from the history, which is extended
+     * with the start of the input to cover frames which straddle the two. */
+    size_t numEdgeFrames = numInputFrames < AIA_PCM_RESAMPLER_HISTORY_FRAMES
+                               ? numInputFrames
+                               : AIA_PCM_RESAMPLER_HISTORY_FRAMES;
+    memcpy( history + AIA_PCM_RESAMPLER_HISTORY_FRAMES * numChannels, input,
+            numEdgeFrames * frameBytes );
+
+    size_t numOutputFrames = 0;
+    while( resampler->position < numInputFrames )
+    {
+        size_t position = resampler->position;
+        const int16_t* frames =
+            position < AIA_PCM_RESAMPLER_HISTORY_FRAMES
+                ? history + position * numChannels
+                : input + ( position - AIA_PCM_RESAMPLER_HISTORY_FRAMES ) *
+                              numChannels;
+        const int16_t* coefficients =
+            resampler->coefficients[ resampler->phase ];
+        for( size_t channel = 0; channel < numChannels; ++channel )
+        {
+            output[ numOutputFrames * numChannels + channel ] =
+                AiaPcmResampler_Filter( frames + channel, numChannels,
+                                        coefficients );
+        }
+        ++numOutputFrames;
+
+        resampler->phase += resampler->downFactor;
+        resampler->position += resampler->phase / resampler->upFactor;
+        resampler->phase %= resampler->upFactor;
+    }
+    resampler->position -= numInputFrames;
+
+    /* Keep the newest frames, which may still be partly in the history. */
+    if( numInputFrames >= AIA_PCM_RESAMPLER_HISTORY_FRAMES )
+    {
+        memcpy( history,
+                input + ( numInputFrames - AIA_PCM_RESAMPLER_HISTORY_FRAMES ) *
+                            numChannels,
+                AIA_PCM_RESAMPLER_HISTORY_FRAMES * frameBytes );
+    }
+    else
+    {
+        memmove( history, history + numInputFrames * numChannels,
+                 AIA_PCM_RESAMPLER_HISTORY_FRAMES * frameBytes );
+    }
+    return numOutputFrames;
+}
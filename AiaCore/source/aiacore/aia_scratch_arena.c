@@ -0,0 +1,168 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_scratch_arena.c
+ * @brief Implements functions for the AiaScratchArena_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_scratch_arena.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Types whose alignment every allocation from the arena satisfies. */
+typedef union AiaScratchArenaAlignment
+{
+    long double alignLongDouble;
+    uint64_t alignUint64;
+    void* alignPointer;
+} AiaScratchArenaAlignment_t;
+
+/** The alignment of every allocation from the arena. */
+#define AIA_SCRATCH_ARENA_ALIGNMENT sizeof( AiaScratchArenaAlignment_t )
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaScratchArena_t abstraction.
+ */
+struct AiaScratchArena
+{
+    /** The memory handed out by the arena. */
+    uint8_t* const buffer;
+
+    /** The size of @c buffer. */
+    const size_t capacity;
+
+    /** The number of bytes of @c buffer handed out since the last reset. */
+    size_t used;
+
+    /** The largest value of @c used since the arena was created. */
+    size_t highWaterMark;
+};
+
+AiaScratchArena_t* AiaScratchArena_Create( size_t capacity )
+{
+    if( !capacity )
+    {
+        AiaLogError( "Zero capacity" );
+        return NULL;
+    }
+
+    AiaScratchArena_t* arena =
+        (AiaScratchArena_t*)AiaCalloc( 1, sizeof( AiaScratchArena_t ) );
+    if( !arena )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaScratchArena_t ) );
+        return NULL;
+    }
+
+    /* Heap allocations are aligned for any type, so the buffer is too. */
+    *(uint8_t**)&arena->buffer = AiaCalloc( 1, capacity );
+    if( !arena->buffer )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", capacity );
+        AiaFree( arena );
+        return NULL;
+    }
+    *(size_t*)&arena->capacity = capacity;
+
+    return arena;
+}
+
+void AiaScratchArena_Destroy( AiaScratchArena_t* arena )
+{
+    if( !arena )
+    {
+        AiaLogDebug( "Null arena." );
+        return;
+    }
+    AiaFree( arena->buffer );
+    AiaFree( arena );
+}
+
+void* AiaScratchArena_Calloc( AiaScratchArena_t* arena, size_t count,
+                              size_t size )
+{
+    if( !arena )
+    {
+        return AiaCalloc( count, size );
+    }
+    if( size && count > SIZE_MAX / size )
+    {
+        AiaLogError( "Allocation too large, count=%zu, size=%zu", count,
+                     size );
+        return NULL;
+    }
+
+    size_t bytes = count * size;
+    size_t offset = ( arena->used + AIA_SCRATCH_ARENA_ALIGNMENT - 1 ) /
+                    AIA_SCRATCH_ARENA_ALIGNMENT * AIA_SCRATCH_ARENA_ALIGNMENT;
+    if( !bytes )
+    {
+        return AiaCalloc( count, size );
+    }
+    if( offset > arena->capacity || bytes > arena->capacity - offset )
+    {
+        AiaLogDebug( "Arena full, falling back to the heap, bytes=%zu", bytes );
+        return AiaCalloc( count, size );
+    }
+
+    arena->used = offset + bytes;
+    if( arena->used > arena->highWaterMark )
+    {
+        arena->highWaterMark = arena->used;
+    }
+
+    /* Memory is zeroed here rather than on reset, so that only what was used
+     * is touched. */
+    memset( arena->buffer + offset, 0, bytes );
+    return arena->buffer + offset;
+}
+
+void AiaScratchArena_Free( AiaScratchArena_t* arena, void* memory )
+{
+    if( arena && (uint8_t*)memory >= arena->buffer &&
+        (uint8_t*)memory < arena->buffer + arena->capacity )
+    {
+        return;
+    }
+    AiaFree( memory );
+}
+
+void AiaScratchArena_Reset( AiaScratchArena_t* arena )
+{
+    if( !arena )
+    {
+        AiaLogError( "Null arena." );
+        return;
+    }
+    arena->used = 0;
+}
+
+size_t AiaScratchArena_GetHighWaterMark( const AiaScratchArena_t* arena )
+{
+    if( !arena )
+    {
+        AiaLogError( "Null arena." );
+        return 0;
+    }
+    return arena->highWaterMark;
+}
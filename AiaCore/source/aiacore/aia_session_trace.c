@@ -0,0 +1,204 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_session_trace.c
+ * @brief Implements functions for reading and writing session traces.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_session_trace.h>
+
+#include <string.h>
+
+/** The bytes every trace starts with. */
+static const uint8_t AIA_SESSION_TRACE_MAGIC[] = { 'A', 'I', 'A', 'S' };
+
+/** The version of the format written, bumped whenever it changes. */
+static const uint8_t AIA_SESSION_TRACE_VERSION = 1;
+
+/**
+ * Appends a LEB128 varint to a buffer.
+ *
+ * @param value The value to write.
+ * @param[out] buffer The buffer to write to.
+ * @param size The size of @c buffer.
+ * @param[in,out] position The offset to write at, advanced past the value.
+ * @return @c true if the value fit, else @c false.
+ */
+static bool AiaSessionTrace_WriteVarint( uint64_t value, uint8_t* buffer,
+                                         size_t size, size_t* position )
+{
+    do
+    {
+        if( *position >= size )
+        {
+            return false;
+        }
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        buffer[ ( *position )++ ] = value ? byte | 0x80 : byte;
+    } while( value );
+    return true;
+}
+
+/**
+ * Reads a LEB128 varint from a buffer.
+ *
+ * @param buffer The buffer to read from.
+ * @param size The size of @c buffer.
+ * @param[in,out] position The offset to read at, advanced past the value.
+ * @param max The largest value accepted.
+ * @param[out] value The value read.
+ * @return @c true if a value no larger than @c max was read, else @c false.
+ */
+static bool AiaSessionTrace_ReadVarint( const uint8_t* buffer, size_t size,
+                                        size_t* position, uint64_t max,
+                                        uint64_t* value )
+{
+    *value = 0;
+    for( unsigned shift = 0; shift < 64; shift += 7 )
+    {
+        if( *position >= size )
+        {
+            return false;
+        }
+        uint8_t byte = buffer[ ( *position )++ ];
+        uint64_t bits = byte & 0x7f;
+        if( bits > max >> shift )
+        {
+            return false;
+        }
+        *value |= bits << shift;
+        if( !( byte & 0x80 ) )
+        {
+            return *value <= max;
+        }
+    }
+    return false;
+}
+
+size_t AiaSessionTrace_WriteHeader( uint8_t* buffer, size_t size )
+{
+    if( !buffer || size < AIA_SESSION_TRACE_HEADER_SIZE )
+    {
+        AiaLogError( "Buffer too small for the trace header, size=%zu.",
+                     size );
+        return 0;
+    }
+    memcpy( buffer, AIA_SESSION_TRACE_MAGIC,
+            sizeof( AIA_SESSION_TRACE_MAGIC ) );
+    buffer[ sizeof( AIA_SESSION_TRACE_MAGIC ) ] = AIA_SESSION_TRACE_VERSION;
+    return AIA_SESSION_TRACE_HEADER_SIZE;
+}
+
+size_t AiaSessionTrace_ReadHeader( const uint8_t* buffer, size_t size )
+{
+    if( !buffer || size < AIA_SESSION_TRACE_HEADER_SIZE )
+    {
+        AiaLogError( "Truncated trace header, size=%zu.", size );
+        return 0;
+    }
+    if( memcmp( buffer, AIA_SESSION_TRACE_MAGIC,
+                sizeof( AIA_SESSION_TRACE_MAGIC ) ) )
+    {
+        AiaLogError( "Not a session trace." );
+        return 0;
+    }
+    uint8_t version = buffer[ sizeof( AIA_SESSION_TRACE_MAGIC ) ];
+    if( version != AIA_SESSION_TRACE_VERSION )
+    {
+        AiaLogError( "Unsupported trace version, version=%u.", version );
+        return 0;
+    }
+    return AIA_SESSION_TRACE_HEADER_SIZE;
+}
+
+size_t AiaSessionTrace_WriteRecordHeader(
+    const AiaSessionTraceRecord_t* record, uint8_t* buffer, size_t size )
+{
+    if( !record || !buffer )
+    {
+        AiaLogError( "Null record or buffer." );
+        return 0;
+    }
+    if( (unsigned)record->topic >= AIA_NUM_TOPICS )
+    {
+        AiaLogError( "Invalid topic, topic=%d.", record->topic );
+        return 0;
+    }
+
+    size_t position = 0;
+    if( !AiaSessionTrace_WriteVarint( record->delayMs, buffer, size,
+                                      &position ) ||
+        position >= size )
+    {
+        return 0;
+    }
+    buffer[ position++ ] = (uint8_t)record->topic;
+    if( !AiaSessionTrace_WriteVarint( record->sequenceNumber, buffer, size,
+                                      &position ) ||
+        !AiaSessionTrace_WriteVarint( record->payloadSize, buffer, size,
+                                      &position ) )
+    {
+        return 0;
+    }
+    return position;
+}
+
+size_t AiaSessionTrace_ReadRecord( const uint8_t* buffer, size_t size,
+                                   AiaSessionTraceRecord_t* record )
+{
+    if( !buffer || !record )
+    {
+        AiaLogError( "Null buffer or record." );
+        return 0;
+    }
+
+    size_t position = 0;
+    uint64_t delayMs, sequenceNumber, payloadSize;
+    if( !AiaSessionTrace_ReadVarint( buffer, size, &position, UINT32_MAX,
+                                     &delayMs ) ||
+        position >= size )
+    {
+        AiaLogError( "Truncated record." );
+        return 0;
+    }
+    uint8_t topic = buffer[ position++ ];
+    if( topic >= AIA_NUM_TOPICS )
+    {
+        AiaLogError( "Invalid topic, topic=%u.", topic );
+        return 0;
+    }
+    if( !AiaSessionTrace_ReadVarint( buffer, size, &position, UINT32_MAX,
+                                     &sequenceNumber ) ||
+        !AiaSessionTrace_ReadVarint( buffer, size, &position, SIZE_MAX,
+                                     &payloadSize ) ||
+        payloadSize > size - position )
+    {
+        AiaLogError( "Truncated record." );
+        return 0;
+    }
+
+    record->delayMs = (AiaDurationMs_t)delayMs;
+    record->topic = (AiaTopic_t)topic;
+    record->sequenceNumber = (AiaSequenceNumber_t)sequenceNumber;
+    record->payload = buffer + position;
+    record->payloadSize = (size_t)payloadSize;
+    return position + (size_t)payloadSize;
+}
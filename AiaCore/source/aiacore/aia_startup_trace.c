@@ -0,0 +1,92 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_startup_trace.c
+ * @brief Implements functions in aia_startup_trace.h
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_startup_trace.h>
+
+/** The observer of startup phases, if any. */
+static AiaStartupTraceObserver_t g_observer;
+
+/** User data for @c g_observer. */
+static void* g_observerUserData;
+
+void AiaStartupTrace_SetObserver( AiaStartupTraceObserver_t observer,
+                                  void* userData )
+{
+    g_observerUserData = userData;
+    g_observer = observer;
+}
+
+void AiaStartupTrace_Begin( AiaStartupPhase_t phase )
+{
+    if( g_observer )
+    {
+        g_observer( phase, false, g_observerUserData );
+    }
+}
+
+void AiaStartupTrace_End( AiaStartupPhase_t phase )
+{
+    if( g_observer )
+    {
+        g_observer( phase, true, g_observerUserData );
+    }
+}
+
+const char* AiaStartupPhase_ToString( AiaStartupPhase_t phase )
+{
+    switch( phase )
+    {
+        case AIA_STARTUP_PHASE_SECRET_MANAGER:
+            return "SECRET_MANAGER";
+        case AIA_STARTUP_PHASE_LOAD_SECRET:
+            return "LOAD_SECRET";
+        case AIA_STARTUP_PHASE_EVENT_PUBLISHING:
+            return "EVENT_PUBLISHING";
+        case AIA_STARTUP_PHASE_CAPABILITIES_SENDER:
+            return "CAPABILITIES_SENDER";
+        case AIA_STARTUP_PHASE_DISPATCHER:
+            return "DISPATCHER";
+        case AIA_STARTUP_PHASE_CONNECTION_MANAGER:
+            return "CONNECTION_MANAGER";
+        case AIA_STARTUP_PHASE_EXCEPTION_MANAGER:
+            return "EXCEPTION_MANAGER";
+        case AIA_STARTUP_PHASE_SPEAKER_MANAGER:
+            return "SPEAKER_MANAGER";
+        case AIA_STARTUP_PHASE_UX_MANAGER:
+            return "UX_MANAGER";
+        case AIA_STARTUP_PHASE_MICROPHONE_MANAGER:
+            return "MICROPHONE_MANAGER";
+        case AIA_STARTUP_PHASE_ALERT_MANAGER:
+            return "ALERT_MANAGER";
+        case AIA_STARTUP_PHASE_LOAD_ALERTS:
+            return "LOAD_ALERTS";
+        case AIA_STARTUP_PHASE_CLOCK_MANAGER:
+            return "CLOCK_MANAGER";
+        case AIA_NUM_STARTUP_PHASES:
+            break;
+    }
+    AiaLogError( "Unknown startup phase %d.", phase );
+    AiaAssert( false );
+    return "";
+}
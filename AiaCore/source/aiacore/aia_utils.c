@@ -24,6 +24,22 @@
 
 #include <aiacore/aia_utils.h>
 
+/**
+ * Characters used to encode message IDs, six bits per character. None of them
+ * need escaping in JSON strings.
+ */
+static const char MESSAGE_ID_ALPHABET[ 64 ] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/** Random value which offsets every message ID, seeded on first use. */
+static uint64_t g_messageIdPrefix;
+
+/** Whether @c g_messageIdPrefix has been seeded. */
+static AiaAtomicBool_t g_messageIdPrefixSeeded;
+
+/** Incremented for every message ID generated. */
+static uint32_t g_messageIdCounter;
+
 bool AiaGenerateMessageId( char* buffer, size_t bufferLength )
 {
     if( !buffer )
@@ -37,32 +53,29 @@ bool AiaGenerateMessageId( char* buffer, size_t bufferLength )
         return false;
     }
 
-    /* Generate the random binary values. */
-    if( !AiaRandom_Rand( (unsigned char*)buffer, bufferLength - 1 ) )
+    /* Only the prefix comes from the DRBG, so that the high rate of outbound
+     * events does not contend on it.  Racing first callers may each seed the
+     * prefix, which only risks a collision between their IDs by chance. */
+    if( !AiaAtomicBool_Load( &g_messageIdPrefixSeeded ) )
     {
-        AiaLogError( "Failed to generate %zu random message ID bytes.",
-                     bufferLength );
-        return false;
+        uint64_t prefix = 0;
+        if( !AiaRandom_Rand( (unsigned char*)&prefix, sizeof( prefix ) ) )
+        {
+            AiaLogError( "Failed to seed the message ID prefix." );
+            return false;
+        }
+        g_messageIdPrefix = prefix;
+        AiaAtomicBool_Set( &g_messageIdPrefixSeeded );
     }
 
-    /* Convert to printable ascii. */
-    static const char firstPrintableAsciiChar = 32;
-    const char numPrintableAsciiChars = 127 - firstPrintableAsciiChar;
+    /* Adding the counter to the prefix keeps IDs unique until the counter
+     * wraps, as long as the ID holds at least 32 bits. */
+    uint64_t value =
+        g_messageIdPrefix + AiaAtomic_Add_u32( &g_messageIdCounter, 1 );
     for( size_t i = 0; i < bufferLength - 1; ++i )
     {
-        buffer[ i ] = firstPrintableAsciiChar +
-                      (unsigned char)buffer[ i ] % numPrintableAsciiChars;
-
-        /* Skip over a couple of problematic characters for JSON strings since
-         * there is no other sanitation in the SDK.  Also skipping spaces for
-         * readability. */
-        switch( buffer[ i ] )
-        {
-            case '\\':
-            case '"':
-            case ' ':
-                ++buffer[ i ];
-        }
+        buffer[ i ] = MESSAGE_ID_ALPHABET[ value & 0x3F ];
+        value = ( value >> 6 ) | ( value << 58 );
     }
 
     /* Null-terminate. */
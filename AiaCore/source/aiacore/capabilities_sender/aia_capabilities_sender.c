@@ -38,6 +38,9 @@
 #include <stdio.h>
 #include <string.h>
 
+/** Key under which the last accepted capabilities payload is persisted. */
+#define AIA_ACCEPTED_CAPABILITIES_KEY "AiaAcceptedCapabilitiesKey"
+
 /**
  * Underlying struct that contains all the data required to present the @c
  * AiaCapabilitiesSender_t abstraction.
@@ -64,6 +67,10 @@ struct AiaCapabilitiesSender
 
     /** Used to publish messages on the capabilities topic. */
     AiaRegulator_t* const capabilitiesRegulator;
+
+    /** The capabilities payload. This does not change once created, so it is
+     * rendered once at creation. */
+    char* const capabilitiesPayload;
 };
 
 static const char* AIA_CAPABILITIES_PAYLOAD_FORMAT =
@@ -102,6 +109,14 @@ static const char* AIA_CAPABILITIES_PAYLOAD_FORMAT =
     		"\""AIA_CAPABILITIES_CONFIGURATIONS_KEY"\":{" 
     			"\""AIA_CAPABILITIES_MICROPHONE_AUDIO_ENCODER"\":{"
     				"\""AIA_CAPABILITIES_MICROPHONE_AUDIO_FORMAT"\": \""AIA_MICROPHONE_AUDIO_ENCODER_FORMAT"\""
+    				#ifdef AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE
+    				","
+    				"\""AIA_CAPABILITIES_MICROPHONE_AUDIO_BITRATE"\": {"
+    					"\""AIA_CAPABILITIES_MICROPHONE_AUDIO_TYPE"\": \""AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE"\","
+    					"\""AIA_CAPABILITIES_MICROPHONE_AUDIO_BITS_PER_SECOND"\":%"PRIu64""
+    				"},"
+    				"\""AIA_CAPABILITIES_MICROPHONE_NUM_CHANNELS"\":%"PRIu64""
+    				#endif
     			"}"
     		"}"
     	"},"
@@ -142,15 +157,25 @@ static const char* AIA_CAPABILITIES_PAYLOAD_FORMAT =
 /* clang-format on */
 
 #ifdef AIA_ENABLE_SPEAKER
-#define AIA_CAPABILITIES_SPEAKER_ARGS                               \
-    AIA_AUDIO_BUFFER_SIZE, AIA_AUDIO_BUFFER_OVERRUN_WARN_THRESHOLD, \
-        AIA_AUDIO_BUFFER_UNDERRUN_WARN_THRESHOLD,                   \
-        AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND,                  \
+#define AIA_CAPABILITIES_SPEAKER_ARGS                      \
+    (uint64_t)speakerBuffer->size,                         \
+        (uint64_t)speakerBuffer->overrunWarningThreshold,  \
+        (uint64_t)speakerBuffer->underrunWarningThreshold, \
+        AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND,         \
         AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS,
 #else
 #define AIA_CAPABILITIES_SPEAKER_ARGS
 #endif
 
+#if defined( AIA_ENABLE_MICROPHONE ) && \
+    defined( AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE )
+#define AIA_CAPABILITIES_MICROPHONE_ARGS          \
+    AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND, \
+        AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS,
+#else
+#define AIA_CAPABILITIES_MICROPHONE_ARGS
+#endif
+
 #ifdef AIA_ENABLE_ALERTS
 #define AIA_CAPABILITIES_ALERTS_ARGS AIA_ALERTS_MAX_ALERT_COUNT,
 #else
@@ -159,22 +184,65 @@ static const char* AIA_CAPABILITIES_PAYLOAD_FORMAT =
 
 #define AIA_CAPABILITIES_SYSTEM_ARGS AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE
 
-#define AIA_CAPABILITIES_ARGS                                  \
-    AIA_CAPABILITIES_SPEAKER_ARGS AIA_CAPABILITIES_ALERTS_ARGS \
-        AIA_CAPABILITIES_SYSTEM_ARGS
+#define AIA_CAPABILITIES_ARGS                                      \
+    AIA_CAPABILITIES_SPEAKER_ARGS AIA_CAPABILITIES_MICROPHONE_ARGS \
+        AIA_CAPABILITIES_ALERTS_ARGS AIA_CAPABILITIES_SYSTEM_ARGS
 
 /**
- * Helper function used to generate an @c AiaJsonMessage_t that contains the @c
- * Capabilities Publish message using macros defined in @c
- * aia_capabilities_config.h
+ * Helper function used to render the payload of the @c Capabilities Publish
+ * message using macros defined in @c aia_capabilities_config.h. The returned
+ * string should be released using @c AiaFree().
  *
- * @return The generated message or @c NULL on failure.
+ * @param speakerBuffer The speaker buffer to advertise, or @c NULL for the
+ * default.
+ * @return The rendered payload or @c NULL on failure.
  */
-static AiaJsonMessage_t* generateCapabilitiesMessage();
+static char* generateCapabilitiesPayload(
+    const AiaSpeakerBufferCapabilities_t* speakerBuffer );
+
+/**
+ * Helper function used to persist whether @c capabilitiesPayload was accepted,
+ * so that it need not be published again after a restart.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @param accepted Whether the payload was accepted.
+ * @note This method must be called while @c capabilitiesSender->mutex is
+ * locked.
+ */
+static void storeAcceptedPayloadLocked(
+    AiaCapabilitiesSender_t* capabilitiesSender, bool accepted );
+
+/**
+ * Helper function used to check whether the persisted accepted payload is @c
+ * capabilitiesPayload.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @return @c true if the payload matches or @c false otherwise.
+ */
+static bool isStoredPayloadAccepted(
+    const AiaCapabilitiesSender_t* capabilitiesSender );
+
+/**
+ * Helper function used to compute a digest of @c capabilitiesPayload.
+ *
+ * @param capabilitiesSender The @c AiaCapabilitiesSender_t to act on.
+ * @return The digest.
+ */
+static uint32_t getPayloadDigest(
+    const AiaCapabilitiesSender_t* capabilitiesSender );
 
 AiaCapabilitiesSender_t* AiaCapabilitiesSender_Create(
     AiaRegulator_t* capabilitiesRegulator,
     AiaCapabilitiesObserver_t stateObserver, void* stateObserverUserData )
+{
+    return AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+        capabilitiesRegulator, stateObserver, stateObserverUserData, NULL );
+}
+
+AiaCapabilitiesSender_t* AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+    AiaRegulator_t* capabilitiesRegulator,
+    AiaCapabilitiesObserver_t stateObserver, void* stateObserverUserData,
+    const AiaSpeakerBufferCapabilities_t* speakerBuffer )
 {
     if( !capabilitiesRegulator )
     {
@@ -188,6 +256,20 @@ AiaCapabilitiesSender_t* AiaCapabilitiesSender_Create(
         return NULL;
     }
 
+    if( speakerBuffer &&
+        ( !speakerBuffer->size ||
+          speakerBuffer->overrunWarningThreshold > speakerBuffer->size ||
+          speakerBuffer->underrunWarningThreshold >
+              speakerBuffer->overrunWarningThreshold ) )
+    {
+        AiaLogError(
+            "Invalid speakerBuffer, size=%zu, overrunWarningThreshold=%zu, "
+            "underrunWarningThreshold=%zu",
+            speakerBuffer->size, speakerBuffer->overrunWarningThreshold,
+            speakerBuffer->underrunWarningThreshold );
+        return NULL;
+    }
+
     AiaCapabilitiesSender_t* capabilitiesSender =
         (AiaCapabilitiesSender_t*)AiaCalloc(
             1, sizeof( AiaCapabilitiesSender_t ) );
@@ -198,9 +280,19 @@ AiaCapabilitiesSender_t* AiaCapabilitiesSender_Create(
         return NULL;
     }
 
+    *(char**)&capabilitiesSender->capabilitiesPayload =
+        generateCapabilitiesPayload( speakerBuffer );
+    if( !capabilitiesSender->capabilitiesPayload )
+    {
+        AiaLogError( "generateCapabilitiesPayload failed" );
+        AiaFree( capabilitiesSender );
+        return NULL;
+    }
+
     if( !AiaMutex( Create )( &capabilitiesSender->mutex, false ) )
     {
         AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( capabilitiesSender->capabilitiesPayload );
         AiaFree( capabilitiesSender );
         return NULL;
     }
@@ -226,6 +318,7 @@ void AiaCapabilitiesSender_Destroy(
         return;
     }
     AiaMutex( Destroy )( &capabilitiesSender->mutex );
+    AiaFree( capabilitiesSender->capabilitiesPayload );
     AiaFree( capabilitiesSender );
 }
 
@@ -255,10 +348,11 @@ bool AiaCapabilitiesSender_PublishCapabilities(
         return false;
     }
     AiaJsonMessage_t* capabilitiesPublishMessage =
-        generateCapabilitiesMessage();
+        AiaJsonMessage_Create( AIA_CAPABILITIES_PUBLISH, NULL,
+                               capabilitiesSender->capabilitiesPayload );
     if( !capabilitiesPublishMessage )
     {
-        AiaLogError( "generateCapabilitiesMessage failed" );
+        AiaLogError( "AiaJsonMessage_Create failed" );
         AiaMutex( Unlock )( &capabilitiesSender->mutex );
         return false;
     }
@@ -339,6 +433,7 @@ void AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
     {
         AiaLogDebug( "Capabilities accepted" );
         capabilitiesSender->state = AIA_CAPABILITIES_STATE_ACCEPTED;
+        storeAcceptedPayloadLocked( capabilitiesSender, true );
         capabilitiesSender->stateObserver(
             capabilitiesSender->state, NULL, 0,
             capabilitiesSender->stateObserverUserData );
@@ -349,6 +444,7 @@ void AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
     {
         AiaLogDebug( "Capabilities rejected" );
         capabilitiesSender->state = AIA_CAPABILITIES_STATE_REJECTED;
+        storeAcceptedPayloadLocked( capabilitiesSender, false );
 
         const char* description = NULL;
         size_t descriptionLen = 0;
@@ -381,8 +477,151 @@ void AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
     AiaMutex( Unlock )( &capabilitiesSender->mutex );
 }
 
-static AiaJsonMessage_t* generateCapabilitiesMessage()
+bool AiaCapabilitiesSender_IsAccepted(
+    AiaCapabilitiesSender_t* capabilitiesSender )
+{
+    AiaAssert( capabilitiesSender );
+    if( !capabilitiesSender )
+    {
+        AiaLogError( "Null capabilitiesSender." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &capabilitiesSender->mutex );
+    if( capabilitiesSender->state == AIA_CAPABILITIES_STATE_NONE &&
+        isStoredPayloadAccepted( capabilitiesSender ) )
+    {
+        AiaLogDebug( "Capabilities accepted before restart" );
+        capabilitiesSender->state = AIA_CAPABILITIES_STATE_ACCEPTED;
+        capabilitiesSender->stateObserver(
+            capabilitiesSender->state, NULL, 0,
+            capabilitiesSender->stateObserverUserData );
+    }
+    bool isAccepted =
+        capabilitiesSender->state == AIA_CAPABILITIES_STATE_ACCEPTED;
+    AiaMutex( Unlock )( &capabilitiesSender->mutex );
+    return isAccepted;
+}
+
+bool AiaCapabilitiesSender_GetAcceptedDigest(
+    AiaCapabilitiesSender_t* capabilitiesSender, uint32_t* digest )
 {
+    AiaAssert( capabilitiesSender );
+    if( !capabilitiesSender )
+    {
+        AiaLogError( "Null capabilitiesSender." );
+        return false;
+    }
+    if( !digest )
+    {
+        AiaLogError( "Null digest." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &capabilitiesSender->mutex );
+    bool isAccepted =
+        capabilitiesSender->state == AIA_CAPABILITIES_STATE_ACCEPTED;
+    AiaMutex( Unlock )( &capabilitiesSender->mutex );
+    if( isAccepted )
+    {
+        *digest = getPayloadDigest( capabilitiesSender );
+    }
+    return isAccepted;
+}
+
+bool AiaCapabilitiesSender_RestoreAccepted(
+    AiaCapabilitiesSender_t* capabilitiesSender, uint32_t digest )
+{
+    AiaAssert( capabilitiesSender );
+    if( !capabilitiesSender )
+    {
+        AiaLogError( "Null capabilitiesSender." );
+        return false;
+    }
+    if( digest != getPayloadDigest( capabilitiesSender ) )
+    {
+        AiaLogInfo( "Capabilities changed since they were accepted" );
+        return false;
+    }
+
+    AiaMutex( Lock )( &capabilitiesSender->mutex );
+    if( capabilitiesSender->state == AIA_CAPABILITIES_STATE_NONE )
+    {
+        AiaLogDebug( "Capabilities accepted before sleep" );
+        capabilitiesSender->state = AIA_CAPABILITIES_STATE_ACCEPTED;
+        capabilitiesSender->stateObserver(
+            capabilitiesSender->state, NULL, 0,
+            capabilitiesSender->stateObserverUserData );
+    }
+    bool isAccepted =
+        capabilitiesSender->state == AIA_CAPABILITIES_STATE_ACCEPTED;
+    AiaMutex( Unlock )( &capabilitiesSender->mutex );
+    return isAccepted;
+}
+
+static void storeAcceptedPayloadLocked(
+    AiaCapabilitiesSender_t* capabilitiesSender, bool accepted )
+{
+    /* A lone terminator never matches a rendered payload. */
+    const char* payload = accepted ? capabilitiesSender->capabilitiesPayload
+                                   : "";
+    if( !AiaStoreBlob( AIA_ACCEPTED_CAPABILITIES_KEY, (const uint8_t*)payload,
+                       strlen( payload ) + 1 ) )
+    {
+        AiaLogWarn( "AiaStoreBlob failed" );
+    }
+}
+
+static bool isStoredPayloadAccepted(
+    const AiaCapabilitiesSender_t* capabilitiesSender )
+{
+    size_t size = strlen( capabilitiesSender->capabilitiesPayload ) + 1;
+    if( !AiaBlobExists( AIA_ACCEPTED_CAPABILITIES_KEY ) ||
+        AiaGetBlobSize( AIA_ACCEPTED_CAPABILITIES_KEY ) != size )
+    {
+        return false;
+    }
+    uint8_t* storedPayload = AiaCalloc( 1, size );
+    if( !storedPayload )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", size );
+        return false;
+    }
+    bool isMatch =
+        AiaLoadBlob( AIA_ACCEPTED_CAPABILITIES_KEY, storedPayload, size ) &&
+        !memcmp( storedPayload, capabilitiesSender->capabilitiesPayload, size );
+    AiaFree( storedPayload );
+    return isMatch;
+}
+
+static uint32_t getPayloadDigest(
+    const AiaCapabilitiesSender_t* capabilitiesSender )
+{
+    /* 32-bit FNV-1a; this only needs to tell configurations apart. */
+    uint32_t hash = 2166136261u;
+    for( const char* c = capabilitiesSender->capabilitiesPayload; *c; ++c )
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static char* generateCapabilitiesPayload(
+    const AiaSpeakerBufferCapabilities_t* speakerBuffer )
+{
+#ifdef AIA_ENABLE_SPEAKER
+    AiaSpeakerBufferCapabilities_t defaultSpeakerBuffer = {
+        AIA_AUDIO_BUFFER_SIZE, AIA_AUDIO_BUFFER_OVERRUN_WARN_THRESHOLD,
+        AIA_AUDIO_BUFFER_UNDERRUN_WARN_THRESHOLD
+    };
+    if( !speakerBuffer )
+    {
+        speakerBuffer = &defaultSpeakerBuffer;
+    }
+#else
+    (void)speakerBuffer;
+#endif
     int numCharsRequired = snprintf( NULL, 0, AIA_CAPABILITIES_PAYLOAD_FORMAT,
                                      AIA_CAPABILITIES_ARGS );
     if( numCharsRequired < 0 )
@@ -403,8 +642,5 @@ static AiaJsonMessage_t* generateCapabilitiesMessage()
         AiaFree( fullPayloadBuffer );
         return NULL;
     }
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_CAPABILITIES_PUBLISH, NULL, fullPayloadBuffer );
-    AiaFree( fullPayloadBuffer );
-    return jsonMessage;
+    return fullPayloadBuffer;
 }
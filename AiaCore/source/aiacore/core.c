@@ -18,6 +18,7 @@
 #include <aia_config.h>
 
 #include <aiacore/aia_directive.h>
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_topic.h>
 
 #include <aiaalertmanager/aia_alert_manager.h>
@@ -43,6 +44,14 @@ extern inline bool AiaDirective_FromString( const char* directiveString,
                                             size_t directiveStringLength,
                                             AiaDirective_t* directive );
 
+/* Anchor the inline functions from aia_endian.h */
+extern inline uint16_t AiaEndian_LoadLe16( const uint8_t* bytes );
+extern inline uint32_t AiaEndian_LoadLe32( const uint8_t* bytes );
+extern inline uint64_t AiaEndian_LoadLe64( const uint8_t* bytes );
+extern inline void AiaEndian_StoreLe16( uint8_t* bytes, uint16_t value );
+extern inline void AiaEndian_StoreLe32( uint8_t* bytes, uint32_t value );
+extern inline void AiaEndian_StoreLe64( uint8_t* bytes, uint64_t value );
+
 /* Anchor the inline functions from aia_topic.h */
 extern inline AiaTopicType_t AiaTopic_GetType( AiaTopic_t topic );
 extern inline bool AiaTopic_IsEncrypted( AiaTopic_t topic );
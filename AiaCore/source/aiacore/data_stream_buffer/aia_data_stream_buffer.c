@@ -17,6 +17,7 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_utils.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
@@ -25,8 +26,10 @@
 #include <aiacore/data_stream_buffer/private/aia_data_stream_buffer_writer.h>
 
 #include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
 
 #include <inttypes.h>
+#include <string.h>
 
 /**
  * This function rounds @c size up to a multiple of @c align.
@@ -47,6 +50,105 @@ static size_t _AiaDataStreamBuffer_AlignSizeTo( size_t size, size_t align )
     }
 }
 
+/**
+ * This function scans through @c readerSlots to find the oldest index which
+ * writers must not overwrite.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer_t to act on.
+ * @return The oldest reader's cursor, or the write cursor if no reader is
+ * enabled.
+ */
+static AiaDataStreamIndex_t _AiaDataStreamBuffer_FindOldestUnconsumed(
+    AiaDataStreamBuffer_t* dataStream )
+{
+    /*
+    The only barrier to a blocking writer overrunning a reader is
+    oldestUnconsumedCursor, so we have to be careful not to ever move it ahead
+    of any readers.  The loop below searches through the readers to find the
+    oldest point, without moving oldestUnconsumedCursor.  Note that readers can
+    continue to read while we are looping; it means oldest may not be completely
+    accurate, but it will always be older than the readers because they are
+    reading away from it.  Backwards seeks would break the invariant, so callers
+    either hold backwardSeekMutex or discard the result if backwardSeekSequence
+    changed.  Also note that all read cursors may be in the future, so we start
+    with an unlimited barrier and work back from there.
+    */
+    AiaDataStreamIndex_t oldest = AIA_DATA_STREAM_INDEX_MAX;
+    AiaDataStreamBufferReaderId_t maxReaders = dataStream->maxReaders;
+    for( AiaDataStreamBufferReaderId_t id = 0; id < maxReaders; ++id )
+    {
+        /*
+        Note that this code is calling AiaDataStreamBuffer_IsReaderEnabled()
+        without holding readerEnableMutex.  On the surface, this appears to be a
+        race condition because a reader may be disabled and/or re-enabled before
+        the subsequent code reads the cursor, but it turns out to be safe
+        because:
+        - if a reader is enabled, its cursor is valid
+        - if a reader becomes disabled, its cursor moves to writeCursor (which
+        will never be the oldest)
+        - if a reader becomes re-enabled, its cursor defaults to writeCursor
+        (which will never be the oldest)
+        - if a reader is created that wants to be at an older index, it gets
+        there by doing a backward seek (which either holds off or invalidates
+        this scan)
+        */
+        if( AiaDataStreamBuffer_IsReaderEnabled( dataStream, id ) &&
+            AiaDataStreamAtomicIndex_Load(
+                &dataStream->readerSlots[ id ].state.cursor ) < oldest )
+        {
+            oldest = dataStream->readerSlots[ id ].state.cursor;
+        }
+    }
+
+    /*
+    If no barrier was found, stop overwriting at the write cursor so that we
+    retain data until a reader comes along to read it.
+    */
+    if( AIA_DATA_STREAM_INDEX_MAX == oldest )
+    {
+        oldest = AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor );
+    }
+    return oldest;
+}
+
+/**
+ * This function moves @c oldestUnconsumedCursor forward to @c oldest, unless
+ * it is already at or beyond it. Updates may race, so this never moves the
+ * barrier backwards.
+ *
+ * @param dataStream The @c AiaDataStreamBuffer_t to act on.
+ * @param oldest The new barrier.
+ * @param sequence The value of @c backwardSeekSequence when @c oldest was
+ * found, or @c NULL if @c backwardSeekMutex is held.
+ * @return @c false if a backward seek started before the barrier was moved, in
+ * which case @c oldest may be stale and was not published, or @c true
+ * otherwise.
+ */
+static bool _AiaDataStreamBuffer_AdvanceOldestUnconsumed(
+    AiaDataStreamBuffer_t* dataStream, AiaDataStreamIndex_t oldest,
+    const uint32_t* sequence )
+{
+    AiaDataStreamIndex_t current =
+        AiaDataStreamAtomicIndex_Load( &dataStream->oldestUnconsumedCursor );
+    while( oldest > current )
+    {
+        if( sequence &&
+            AiaAtomic_Load_u32( &dataStream->backwardSeekSequence ) !=
+                *sequence )
+        {
+            return false;
+        }
+        if( AiaDataStreamAtomicIndex_CompareAndSwap(
+                &dataStream->oldestUnconsumedCursor, oldest, current ) )
+        {
+            break;
+        }
+        current = AiaDataStreamAtomicIndex_Load(
+            &dataStream->oldestUnconsumedCursor );
+    }
+    return true;
+}
+
 /**
  * Allocates and initializes a @c AiaDataStreamReader_t object from the heap.
  * The returned pointer should be destroyed using @c
@@ -128,10 +230,23 @@ static AiaDataStreamReader_t* _AiaDataStreamBuffer_CreateReaderLocked(
     return reader;
 }
 
-AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
-                                                   size_t bufferSize,
-                                                   size_t wordSize,
-                                                   size_t maxReaders )
+/**
+ * Allocates and initializes a @c AiaDataStreamBuffer_t object from the heap.
+ *
+ * @param buffer The raw buffer to stream data into and from.
+ * @param bufferSize The size of @c buffer in bytes.
+ * @param wordSize The size (in bytes) of words in the stream.
+ * @param maxReaders The maximum number of readers to allow.
+ * @param isSingleReader Whether to use the single reader fast path. @c
+ * maxReaders must be @c 1 when this is @c true.
+ * @param options Options for placing the data, or @c NULL for defaults.
+ *
+ * @return The newly created @c AiaDataStreamBuffer_t if successful, or NULL
+ * otherwise.
+ */
+static AiaDataStreamBuffer_t* _AiaDataStreamBuffer_Create(
+    void* buffer, size_t bufferSize, size_t wordSize, size_t maxReaders,
+    bool isSingleReader, const AiaDataStreamBufferOptions_t* options )
 {
     if( !buffer || bufferSize < wordSize )
     {
@@ -154,15 +269,46 @@ AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
         return NULL;
     }
 
+    size_t dataAlignment =
+        options && options->dataAlignment ? options->dataAlignment : 1;
+    if( dataAlignment & ( dataAlignment - 1 ) )
+    {
+        AiaLogError( "invalid data alignment, dataAlignment=%zu",
+                     dataAlignment );
+        return NULL;
+    }
+    size_t padding =
+        ( dataAlignment - (uintptr_t)buffer % dataAlignment ) % dataAlignment;
+    if( padding > bufferSize || bufferSize - padding < wordSize )
+    {
+        AiaLogError( "buffer too small after alignment, padding=%zu.",
+                     padding );
+        return NULL;
+    }
+    if( options && ( !options->metadata != !options->metadataCapacity ||
+                     1 == options->metadataCapacity ||
+                     options->metadataCapacity > AIA_DATA_STREAM_INDEX_MAX ) )
+    {
+        AiaLogError( "Null or invalid metadata, metadataCapacity=%zu.",
+                     options->metadataCapacity );
+        return NULL;
+    }
+    size_t dataSize = ( bufferSize - padding ) / wordSize;
+    if( options && options->powerOfTwoCapacity )
+    {
+        size_t words = 1;
+        while( words <= dataSize / 2 )
+        {
+            words *= 2;
+        }
+        dataSize = words;
+    }
+
     size_t dataStreamSize = sizeof( AiaDataStreamBuffer_t );
-    size_t readerEnabledArraySize = sizeof( AiaAtomicBool_t ) * maxReaders;
-    size_t readerCursorArraySize =
-        sizeof( AiaDataStreamAtomicIndex_t ) * maxReaders;
-    size_t readerCloseArraySize =
-        sizeof( AiaDataStreamAtomicIndex_t ) * maxReaders;
-
-    size_t totalSize = dataStreamSize + readerEnabledArraySize +
-                       readerCursorArraySize + readerCloseArraySize;
+    size_t readerSlotsSize =
+        sizeof( AiaDataStreamBufferReaderSlot_t ) * maxReaders;
+
+    size_t totalSize = dataStreamSize + readerSlotsSize;
     uint8_t* memory = AiaCalloc( 1, totalSize );
     if( !memory )
     {
@@ -172,20 +318,43 @@ AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
 
     AiaDataStreamBuffer_t* dataStream = (AiaDataStreamBuffer_t*)( memory );
 
-    dataStream->readerEnabledArray =
-        (AiaAtomicBool_t*)( memory + dataStreamSize );
-    dataStream->readerCursorArray =
-        (AiaDataStreamAtomicIndex_t*)( memory + dataStreamSize +
-                                       readerEnabledArraySize );
-    dataStream->readerCloseIndexArray =
-        (AiaDataStreamAtomicIndex_t*)( memory + dataStreamSize +
-                                       readerEnabledArraySize +
-                                       readerCursorArraySize );
-    dataStream->data = buffer;
-    *(size_t*)&dataStream->dataSize = bufferSize / wordSize;
+    dataStream->readerSlots =
+        (AiaDataStreamBufferReaderSlot_t*)( memory + dataStreamSize );
+    dataStream->data = (uint8_t*)buffer + padding;
+    *(size_t*)&dataStream->dataSize = dataSize;
+    if( options && options->isExternalMemory )
+    {
+        *(AiaDataStreamBufferCacheMaintenance_t*)&dataStream->cleanRange =
+            options->cleanRange;
+        *(AiaDataStreamBufferCacheMaintenance_t*)&dataStream
+             ->invalidateRange = options->invalidateRange;
+        *(void**)&dataStream->cacheMaintenanceUserData =
+            options->cacheMaintenanceUserData;
+    }
+    if( options && options->metadata )
+    {
+        *(AiaDataStreamMetadataEntry_t**)&dataStream->metadata =
+            options->metadata;
+        *(size_t*)&dataStream->metadataCapacity = options->metadataCapacity;
+    }
 
     *(AiaDataStreamBufferWordSize_t*)&dataStream->wordSize = wordSize;
+    *(uint8_t*)&dataStream->wordSizeShift = AIA_DATA_STREAM_BUFFER_NO_SHIFT;
+    if( 0 == ( wordSize & ( wordSize - 1 ) ) )
+    {
+        uint8_t shift = 0;
+        while( ( (size_t)1 << shift ) < wordSize )
+        {
+            ++shift;
+        }
+        *(uint8_t*)&dataStream->wordSizeShift = shift;
+    }
+    if( 0 == ( dataStream->dataSize & ( dataStream->dataSize - 1 ) ) )
+    {
+        *(size_t*)&dataStream->dataSizeMask = dataStream->dataSize - 1;
+    }
     *(AiaDataStreamBufferReaderId_t*)&dataStream->maxReaders = maxReaders;
+    *(bool*)&dataStream->isSingleReader = isSingleReader;
     if( !AiaMutex( Create )( &dataStream->backwardSeekMutex, false ) )
     {
         AiaLogError( "AiaMutex(Create) failed." );
@@ -205,7 +374,10 @@ AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
 
     AiaDataStreamAtomicIndex_Store( &dataStream->writeStartCursor, 0 );
     AiaDataStreamAtomicIndex_Store( &dataStream->writeEndCursor, 0 );
+    AiaDataStreamAtomicIndex_Store( &dataStream->metadataCount, 0 );
     AiaDataStreamAtomicIndex_Store( &dataStream->oldestUnconsumedCursor, 0 );
+    AiaAtomic_Store_u32( &dataStream->backwardSeekSequence, 0 );
+    AiaAtomic_Store_u32( &dataStream->numWaitingReaders, 0 );
 
     if( !AiaMutex( Create )( &dataStream->readerEnableMutex, false ) )
     {
@@ -216,18 +388,125 @@ AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
         return NULL;
     }
 
+    if( !AiaMutex( Create )( &dataStream->notifyMutex, false ) )
+    {
+        AiaLogError( "AiaMutex(Create) failed." );
+        AiaMutex( Destroy )( &dataStream->readerEnableMutex );
+        AiaMutex( Destroy )( &dataStream->writerEnableMutex );
+        AiaMutex( Destroy )( &dataStream->backwardSeekMutex );
+        AiaFree( memory );
+        return NULL;
+    }
+    AiaDataStreamAtomicIndex_Store( &dataStream->notifyIndex,
+                                    AIA_DATA_STREAM_INDEX_MAX );
+    AiaDataStreamAtomicIndex_Store( &dataStream->pinnedCursor,
+                                    AIA_DATA_STREAM_INDEX_MAX );
+
     /* Reader arrays initialization. */
     AiaDataStreamBufferReaderId_t id;
     for( id = 0; id < dataStream->maxReaders; ++id )
     {
-        AiaAtomicBool_Clear( &dataStream->readerEnabledArray[ id ] );
-        AiaDataStreamAtomicIndex_Store( &dataStream->readerCursorArray[ id ],
-                                        0 );
+        AiaAtomicBool_Clear(
+            &dataStream->readerSlots[ id ].state.isEnabled );
+        AiaDataStreamAtomicIndex_Store(
+            &dataStream->readerSlots[ id ].state.cursor, 0 );
         AiaDataStreamAtomicIndex_Store(
-            &dataStream->readerCloseIndexArray[ id ], 0 );
+            &dataStream->readerSlots[ id ].state.closeIndex, 0 );
+        AiaDataStreamAtomicIndex_Store(
+            &dataStream->readerSlots[ id ].state.waitIndex,
+            AIA_DATA_STREAM_INDEX_MAX );
+    }
+    return dataStream;
+}
+
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_Create( void* buffer,
+                                                   size_t bufferSize,
+                                                   size_t wordSize,
+                                                   size_t maxReaders )
+{
+    return _AiaDataStreamBuffer_Create( buffer, bufferSize, wordSize,
+                                        maxReaders, false, NULL );
+}
+
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateWithOptions(
+    void* buffer, size_t bufferSize, size_t wordSize, size_t maxReaders,
+    const AiaDataStreamBufferOptions_t* options )
+{
+    return _AiaDataStreamBuffer_Create( buffer, bufferSize, wordSize,
+                                        maxReaders, false, options );
+}
+
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateSingleReader(
+    void* buffer, size_t bufferSize, size_t wordSize )
+{
+    return _AiaDataStreamBuffer_Create( buffer, bufferSize, wordSize, 1, true,
+                                        NULL );
+}
+
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+AiaDataStreamBuffer_t* AiaDataStreamBuffer_CreateMirrored(
+    size_t bufferSize, size_t wordSize, size_t maxReaders,
+    const AiaDataStreamBufferOptions_t* options )
+{
+    if( 0 == bufferSize || 0 == wordSize )
+    {
+        AiaLogError( "Invalid size, bufferSize=%zu, wordSize=%zu.", bufferSize,
+                     wordSize );
+        return NULL;
+    }
+    if( options && options->isExternalMemory )
+    {
+        AiaLogError( "Mirrored buffers cannot be in external memory." );
+        return NULL;
     }
+    if( options && options->powerOfTwoCapacity )
+    {
+        if( wordSize & ( wordSize - 1 ) )
+        {
+            AiaLogError( "Word size not a power of two, wordSize=%zu.",
+                         wordSize );
+            return NULL;
+        }
+        /* Rounded up to whole pages, a power-of-two number of bytes is still a
+         * power-of-two number of words. */
+        size_t size = wordSize;
+        while( size < bufferSize )
+        {
+            size *= 2;
+        }
+        bufferSize = size;
+    }
+
+    size_t mirroredSize = bufferSize;
+    uint8_t* data = _AiaDataStreamBuffer_MapMirrored( &mirroredSize, wordSize );
+    if( !data )
+    {
+        AiaLogError( "_AiaDataStreamBuffer_MapMirrored failed." );
+        return NULL;
+    }
+    AiaDataStreamBuffer_t* dataStream = _AiaDataStreamBuffer_Create(
+        data, mirroredSize, wordSize, maxReaders, false, options );
+    if( !dataStream )
+    {
+        _AiaDataStreamBuffer_UnmapMirrored( data, mirroredSize );
+        return NULL;
+    }
+
+    /* The mirror only continues the ring if the data fills the mapping. */
+    if( dataStream->data != data ||
+        _AiaDataStreamBuffer_WordsToBytes( dataStream, dataStream->dataSize ) !=
+            mirroredSize )
+    {
+        AiaLogError( "Data does not fill the mapping, bytes=%zu.",
+                     mirroredSize );
+        AiaDataStreamBuffer_Destroy( dataStream );
+        _AiaDataStreamBuffer_UnmapMirrored( data, mirroredSize );
+        return NULL;
+    }
+    *(size_t*)&dataStream->mirroredSize = mirroredSize;
     return dataStream;
 }
+#endif
 
 void AiaDataStreamBuffer_Destroy( AiaDataStreamBuffer_t* dataStream )
 {
@@ -237,9 +516,17 @@ void AiaDataStreamBuffer_Destroy( AiaDataStreamBuffer_t* dataStream )
         AiaLogError( "Invalid dataStream." );
         return;
     }
+    AiaMutex( Destroy )( &dataStream->notifyMutex );
     AiaMutex( Destroy )( &dataStream->readerEnableMutex );
     AiaMutex( Destroy )( &dataStream->writerEnableMutex );
     AiaMutex( Destroy )( &dataStream->backwardSeekMutex );
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+    if( dataStream->mirroredSize )
+    {
+        _AiaDataStreamBuffer_UnmapMirrored( dataStream->data,
+                                            dataStream->mirroredSize );
+    }
+#endif
     AiaFree( dataStream );
 }
 
@@ -279,6 +566,158 @@ size_t AiaDataStreamBuffer_GetWordSize(
     return dataStream->wordSize;
 }
 
+bool AiaDataStreamBuffer_Resize( AiaDataStreamBuffer_t* dataStream,
+                                 void* buffer, size_t bufferSize )
+{
+    AiaAssert( dataStream );
+    if( !dataStream )
+    {
+        AiaLogError( "Invalid dataStream." );
+        return false;
+    }
+    if( !buffer || bufferSize < dataStream->wordSize )
+    {
+        AiaLogError( "Null or invalid buffer." );
+        return false;
+    }
+    if( dataStream->cleanRange || dataStream->invalidateRange )
+    {
+        AiaLogError( "Buffers in external memory cannot be resized." );
+        return false;
+    }
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+    if( dataStream->mirroredSize )
+    {
+        AiaLogError( "Mirrored buffers cannot be resized." );
+        return false;
+    }
+#endif
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor );
+    if( AiaDataStreamAtomicIndex_Load( &dataStream->writeEndCursor ) !=
+        writeStart )
+    {
+        AiaLogError( "Reservation outstanding." );
+        return false;
+    }
+
+    size_t dataSize = bufferSize / dataStream->wordSize;
+    AiaDataStreamIndex_t oldest =
+        _AiaDataStreamBuffer_FindOldestUnconsumed( dataStream );
+    AiaDataStreamIndex_t pinned =
+        AiaDataStreamAtomicIndex_Load( &dataStream->pinnedCursor );
+    if( pinned < oldest )
+    {
+        oldest = pinned;
+    }
+    if( dataSize < dataStream->dataSize && oldest < writeStart &&
+        writeStart - oldest > dataSize )
+    {
+        AiaLogError( "Unconsumed data does not fit, dataSize=%zu.", dataSize );
+        return false;
+    }
+
+    /* Copy the most recent words in runs which do not wrap in either buffer. */
+    size_t nWords = AiaMin( AiaMin( dataSize, dataStream->dataSize ),
+                            (size_t)writeStart );
+    AiaDataStreamIndex_t index = writeStart - nWords;
+    while( nWords )
+    {
+        size_t from = index % dataStream->dataSize;
+        size_t to = index % dataSize;
+        size_t run = AiaMin( AiaMin( nWords, dataStream->dataSize - from ),
+                             dataSize - to );
+        memcpy( (uint8_t*)buffer +
+                    _AiaDataStreamBuffer_WordsToBytes( dataStream, to ),
+                dataStream->data +
+                    _AiaDataStreamBuffer_WordsToBytes( dataStream, from ),
+                _AiaDataStreamBuffer_WordsToBytes( dataStream, run ) );
+        index += run;
+        nWords -= run;
+    }
+
+    dataStream->data = buffer;
+    *(size_t*)&dataStream->dataSize = dataSize;
+    *(size_t*)&dataStream->dataSizeMask =
+        0 == ( dataSize & ( dataSize - 1 ) ) ? dataSize - 1 : 0;
+    return true;
+}
+
+bool AiaDataStreamBuffer_FindMetadata( AiaDataStreamBuffer_t* dataStream,
+                                       AiaDataStreamIndex_t index,
+                                       AiaDataStreamMetadataEntry_t* entry )
+{
+    AiaAssert( dataStream );
+    if( !dataStream )
+    {
+        AiaLogError( "Invalid dataStream." );
+        return false;
+    }
+    if( !entry )
+    {
+        AiaLogError( "Null entry." );
+        return false;
+    }
+    if( !dataStream->metadata )
+    {
+        AiaLogError( "No metadata ring." );
+        return false;
+    }
+
+    AiaDataStreamIndex_t capacity = dataStream->metadataCapacity;
+    while( true )
+    {
+        /*
+        The writer starts overwriting the oldest entry as soon as it records
+        the entry with sequence number count, so only the capacity - 1 entries
+        before that one are stable. Entries are not read atomically: the search
+        runs optimistically, and is repeated if the writer reached any entry it
+        examined by the time it finished.
+        */
+        AiaDataStreamIndex_t count =
+            AiaDataStreamAtomicIndex_Load( &dataStream->metadataCount );
+        AiaDataStreamIndex_t first =
+            count >= capacity ? count - capacity + 1 : 0;
+        AiaDataStreamIndex_t low = first;
+        AiaDataStreamIndex_t high = count;
+        AiaDataStreamIndex_t oldestExamined = count;
+
+        /* Find the first entry recorded after index. */
+        while( low < high )
+        {
+            AiaDataStreamIndex_t mid = low + ( high - low ) / 2;
+            if( mid < oldestExamined )
+            {
+                oldestExamined = mid;
+            }
+            if( dataStream->metadata[ mid % capacity ].index <= index )
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        bool found = low > first;
+        if( found )
+        {
+            *entry = dataStream->metadata[ ( low - 1 ) % capacity ];
+            if( low - 1 < oldestExamined )
+            {
+                oldestExamined = low - 1;
+            }
+        }
+
+        if( AiaDataStreamAtomicIndex_Load( &dataStream->metadataCount ) -
+                oldestExamined <
+            capacity )
+        {
+            return found;
+        }
+    }
+}
+
 AiaDataStreamWriter_t* AiaDataStreamBuffer_CreateWriter(
     AiaDataStreamBuffer_t* dataStream, AiaDataStreamWriterPolicy_t policy,
     bool forceReplacement )
@@ -358,7 +797,7 @@ bool AiaDataStreamBuffer_IsReaderEnabled(
         AiaLogError( "Invalid dataStream." );
         return false;
     }
-    return AiaAtomicBool_Load( &dataStream->readerEnabledArray[ id ] );
+    return AiaAtomicBool_Load( &dataStream->readerSlots[ id ].state.isEnabled );
 }
 
 void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor(
@@ -370,6 +809,44 @@ void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor(
         AiaLogError( "Invalid dataStream." );
         return;
     }
+
+    /*
+    With a single reader, the reader's own cursor is the oldest one.  Every
+    caller of this function runs on the reader's thread (or before the reader is
+    handed out), and backward seeks take the Locked path, so the only updates
+    which can reach here move the cursor forward.  Publishing it atomically is
+    therefore enough to keep the writer from overrunning the reader.  A disabled
+    reader falls through to the scan so that the barrier follows the writer as
+    usual.
+    */
+    if( dataStream->isSingleReader &&
+        AiaDataStreamBuffer_IsReaderEnabled( dataStream, 0 ) )
+    {
+        _AiaDataStreamBuffer_AdvanceOldestUnconsumed(
+            dataStream,
+            AiaDataStreamAtomicIndex_Load(
+                &dataStream->readerSlots[ 0 ].state.cursor ),
+            NULL );
+        return;
+    }
+
+    /*
+    With several readers, scan them without backwardSeekMutex so that readers do
+    not serialize against each other.  This is a sequence lock: if a backward
+    seek was in progress or started before the result was published, the scan
+    may have seen the seeking reader's old cursor, so the result is discarded
+    and the scan is redone under the mutex.
+    */
+    uint32_t sequence =
+        AiaAtomic_Load_u32( &dataStream->backwardSeekSequence );
+    if( !( sequence & 1 ) &&
+        _AiaDataStreamBuffer_AdvanceOldestUnconsumed(
+            dataStream, _AiaDataStreamBuffer_FindOldestUnconsumed( dataStream ),
+            &sequence ) )
+    {
+        return;
+    }
+
     AiaMutex( Lock )( &dataStream->backwardSeekMutex );
     _AiaDataStreamBuffer_UpdateOldestUnconsumedCursorLocked( dataStream );
     AiaMutex( Unlock )( &dataStream->backwardSeekMutex );
@@ -385,69 +862,29 @@ void _AiaDataStreamBuffer_UpdateOldestUnconsumedCursorLocked(
         return;
     }
 
-    /*
-    The only barrier to a blocking writer overrunning a reader is
-    oldestUnconsumedCursor, so we have to be careful not to ever move it ahead
-    of any readers.  The loop below searches through the readers to find the
-    oldest point, without moving oldestUnconsumedCursor.  Note that readers can
-    continue to read while we are looping; it means oldest may not be completely
-    accurate, but it will always be older than the readers because they are
-    reading away from it.  Also note that backwards seeks (which would break the
-    invariant) are prevented with a mutex which is held while this function is
-    called.  Also note that all read cursors may be in the future, so we start
-    with an unlimited barrier and work back from there.
-    */
-    AiaDataStreamIndex_t oldest = AIA_DATA_STREAM_INDEX_MAX;
-    AiaDataStreamBufferReaderId_t maxReaders = dataStream->maxReaders;
-    for( AiaDataStreamBufferReaderId_t id = 0; id < maxReaders; ++id )
-    {
-        /*
-        Note that this code is calling AiaDataStreamBuffer_IsReaderEnabled()
-        without holding readerEnableMutex.  On the surface, this appears to be a
-        race condition because a reader may be disabled and/or re-enabled before
-        the subsequent code reads the cursor, but it turns out to be safe
-        because:
-        - if a reader is enabled, its cursor is valid
-        - if a reader becomes disabled, its cursor moves to writeCursor (which
-        will never be the oldest)
-        - if a reader becomes re-enabled, its cursor defaults to writeCursor
-        (which will never be the oldest)
-        - if a reader is created that wants to be at an older index, it gets
-        there by doing a backward seek (which is locked when this function is
-        called)
-        */
-        if( AiaDataStreamBuffer_IsReaderEnabled( dataStream, id ) &&
-            AiaDataStreamAtomicIndex_Load(
-                &dataStream->readerCursorArray[ id ] ) < oldest )
-        {
-            oldest = dataStream->readerCursorArray[ id ];
-        }
-    }
-
-    /*
-    If no barrier was found, stop overwriting at the write cursor so that we
-    retain data until a reader comes along to read it.
-    */
-    if( AIA_DATA_STREAM_INDEX_MAX == oldest )
-    {
-        oldest = AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor );
-    }
-
     /*
     Now that we've measured the oldest cursor, we can safely update
     oldestUnconsumedCursor with no risk of an overrun of any readers.
 
-    To clarify the logic here, the code above reviewed all of the enabled
-    readers to see where the oldest cursor is at.  This value is captured in the
-    'oldest' variable.  Now we want to move up our writer barrier
-    ('oldestUnconsumedCursor') if it is older than it needs to be.
+    To clarify the logic here, the scan reviews all of the enabled readers to
+    see where the oldest cursor is at.  Now we want to move up our writer
+    barrier ('oldestUnconsumedCursor') if it is older than it needs to be.
     */
-    if( oldest >
-        AiaDataStreamAtomicIndex_Load( &dataStream->oldestUnconsumedCursor ) )
-    {
-        AiaDataStreamAtomicIndex_Store( &dataStream->oldestUnconsumedCursor,
-                                        oldest );
-    }
+    _AiaDataStreamBuffer_AdvanceOldestUnconsumed(
+        dataStream, _AiaDataStreamBuffer_FindOldestUnconsumed( dataStream ),
+        NULL );
+}
+
+void _AiaDataStreamBuffer_BeginBackwardSeekLocked(
+    AiaDataStreamBuffer_t* dataStream )
+{
+    AiaAtomic_Add_u32( &dataStream->backwardSeekSequence, 1 );
+}
+
+void _AiaDataStreamBuffer_EndBackwardSeekLocked(
+    AiaDataStreamBuffer_t* dataStream )
+{
+    AiaAtomic_Add_u32( &dataStream->backwardSeekSequence, 1 );
 }
 
 void _AiaDataStreamBuffer_EnableReaderLocked( AiaDataStreamBuffer_t* dataStream,
@@ -459,7 +896,7 @@ void _AiaDataStreamBuffer_EnableReaderLocked( AiaDataStreamBuffer_t* dataStream,
         AiaLogError( "Invalid dataStream." );
         return;
     }
-    AiaAtomicBool_Set( &dataStream->readerEnabledArray[ id ] );
+    AiaAtomicBool_Set( &dataStream->readerSlots[ id ].state.isEnabled );
 }
 
 void _AiaDataStreamBuffer_DisableReaderLocked(
@@ -471,7 +908,7 @@ void _AiaDataStreamBuffer_DisableReaderLocked(
         AiaLogError( "Invalid dataStream." );
         return;
     }
-    AiaAtomicBool_Clear( &dataStream->readerEnabledArray[ id ] );
+    AiaAtomicBool_Clear( &dataStream->readerSlots[ id ].state.isEnabled );
 }
 
 AiaDataStreamIndex_t _AiaDataStreamBuffer_WordsUntilWrap(
@@ -483,11 +920,77 @@ AiaDataStreamIndex_t _AiaDataStreamBuffer_WordsUntilWrap(
         AiaLogError( "Invalid dataStream." );
         return 0;
     }
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+    /* The second mapping continues the data past the end of the first. */
+    if( dataStream->mirroredSize )
+    {
+        return dataStream->dataSize;
+    }
+#endif
+    if( dataStream->dataSizeMask )
+    {
+        AiaDataStreamIndex_t offset = after & dataStream->dataSizeMask;
+        return offset ? dataStream->dataSize - offset : 0;
+    }
     return _AiaDataStreamBuffer_AlignSizeTo(
                after, AiaDataStreamBuffer_GetDataSize( dataStream ) ) -
            after;
 }
 
+void _AiaDataStreamBuffer_NotifyReader( AiaDataStreamBuffer_t* dataStream )
+{
+    if( AiaAtomic_Load_u32( &dataStream->numWaitingReaders ) )
+    {
+        _AiaDataStreamBuffer_WakeWaitingReaders( dataStream, false );
+    }
+
+    if( AIA_DATA_STREAM_INDEX_MAX ==
+        AiaDataStreamAtomicIndex_Load( &dataStream->notifyIndex ) )
+    {
+        return;
+    }
+
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    AiaDataStreamIndex_t notifyIndex =
+        AiaDataStreamAtomicIndex_Load( &dataStream->notifyIndex );
+    if( AIA_DATA_STREAM_INDEX_MAX != notifyIndex &&
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor ) >=
+            notifyIndex )
+    {
+        AiaDataStreamAtomicIndex_Store( &dataStream->notifyIndex,
+                                        AIA_DATA_STREAM_INDEX_MAX );
+        /* The callback is invoked with notifyMutex held so that
+         * AiaDataStreamReader_CancelNotification() can guarantee it is not
+         * running once it returns. */
+        dataStream->notifyCallback( dataStream->notifyUserData );
+    }
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+}
+
+void _AiaDataStreamBuffer_WakeWaitingReaders(
+    AiaDataStreamBuffer_t* dataStream, bool wakeAll )
+{
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor );
+    for( AiaDataStreamBufferReaderId_t id = 0; id < dataStream->maxReaders;
+         ++id )
+    {
+        struct AiaDataStreamBufferReaderState* state =
+            &dataStream->readerSlots[ id ].state;
+        AiaDataStreamIndex_t waitIndex =
+            AiaDataStreamAtomicIndex_Load( &state->waitIndex );
+        if( AIA_DATA_STREAM_INDEX_MAX != waitIndex &&
+            ( wakeAll || writeStart >= waitIndex ) )
+        {
+            AiaDataStreamAtomicIndex_Store( &state->waitIndex,
+                                            AIA_DATA_STREAM_INDEX_MAX );
+            AiaSemaphore( Post )( state->waitSemaphore );
+        }
+    }
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+}
+
 uint8_t* _AiaDataStreamBuffer_GetData( AiaDataStreamBuffer_t* dataStream,
                                        AiaDataStreamIndex_t at )
 {
@@ -497,7 +1000,45 @@ uint8_t* _AiaDataStreamBuffer_GetData( AiaDataStreamBuffer_t* dataStream,
         AiaLogError( "Invalid dataStream." );
         return NULL;
     }
+    size_t offset = dataStream->dataSizeMask
+                        ? at & dataStream->dataSizeMask
+                        : at % AiaDataStreamBuffer_GetDataSize( dataStream );
     return dataStream->data +
-           ( at % AiaDataStreamBuffer_GetDataSize( dataStream ) ) *
-               AiaDataStreamBuffer_GetWordSize( dataStream );
+           _AiaDataStreamBuffer_WordsToBytes( dataStream, offset );
+}
+
+size_t _AiaDataStreamBuffer_WordsToBytes(
+    const AiaDataStreamBuffer_t* dataStream, size_t nWords )
+{
+    if( AIA_DATA_STREAM_BUFFER_NO_SHIFT != dataStream->wordSizeShift )
+    {
+        return nWords << dataStream->wordSizeShift;
+    }
+    return nWords * dataStream->wordSize;
+}
+
+void _AiaDataStreamBuffer_MaintainCache(
+    AiaDataStreamBuffer_t* dataStream,
+    AiaDataStreamBufferCacheMaintenance_t maintain, AiaDataStreamIndex_t at,
+    size_t nWords )
+{
+    if( !maintain || !nWords )
+    {
+        return;
+    }
+    size_t beforeWrap = _AiaDataStreamBuffer_WordsUntilWrap( dataStream, at );
+    if( 0 == beforeWrap || beforeWrap > nWords )
+    {
+        beforeWrap = nWords;
+    }
+    maintain( _AiaDataStreamBuffer_GetData( dataStream, at ),
+              _AiaDataStreamBuffer_WordsToBytes( dataStream, beforeWrap ),
+              dataStream->cacheMaintenanceUserData );
+    size_t afterWrap = nWords - beforeWrap;
+    if( afterWrap > 0 )
+    {
+        maintain( _AiaDataStreamBuffer_GetData( dataStream, at + beforeWrap ),
+                  _AiaDataStreamBuffer_WordsToBytes( dataStream, afterWrap ),
+                  dataStream->cacheMaintenanceUserData );
+    }
 }
@@ -23,6 +23,7 @@
 #include <aiacore/data_stream_buffer/private/aia_data_stream_buffer_reader.h>
 
 #include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
 
 #include <inttypes.h>
 #include <string.h>
@@ -52,8 +53,9 @@ AiaDataStreamReader_t* _AiaDataStreamReader_Create(
     *(AiaDataStreamReaderPolicy_t*)&reader->policy = policy;
     reader->dataStream = stream;
     *(AiaDataStreamBufferReaderId_t*)&reader->id = id;
-    reader->readerCursor = &stream->readerCursorArray[ reader->id ];
-    reader->readerCloseIndex = &stream->readerCloseIndexArray[ reader->id ];
+    reader->readerCursor = &stream->readerSlots[ reader->id ].state.cursor;
+    reader->readerCloseIndex =
+        &stream->readerSlots[ reader->id ].state.closeIndex;
 
     /*
      * Note - _AiaDataStreamBuffer_CreateReaderLocked() holds readerEnableMutex
@@ -93,12 +95,17 @@ void AiaDataStreamReader_Destroy( AiaDataStreamReader_t* reader )
      * _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor() comments for further
      * explanation.
      */
+    AiaDataStreamReader_Unpin( reader );
     AiaDataStreamReader_Seek(
         reader, 0, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER );
     AiaMutex( Lock )( &reader->dataStream->readerEnableMutex );
     _AiaDataStreamBuffer_DisableReaderLocked( reader->dataStream, reader->id );
     _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor( reader->dataStream );
     AiaMutex( Unlock )( &reader->dataStream->readerEnableMutex );
+    if( reader->isWaitSemaphoreCreated )
+    {
+        AiaSemaphore( Destroy )( &reader->waitSemaphore );
+    }
     AiaFree( reader );
 }
 
@@ -117,6 +124,171 @@ ssize_t AiaDataStreamReader_Read( AiaDataStreamReader_t* reader, void* buf,
         return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
     }
 
+    AiaDataStreamReaderSpan_t spans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ];
+    ssize_t wordsPeeked = AiaDataStreamReader_Peek( reader, spans, nWords );
+    if( wordsPeeked <= 0 )
+    {
+        return wordsPeeked;
+    }
+
+    size_t beforeWrapBytes = _AiaDataStreamBuffer_WordsToBytes(
+        reader->dataStream, spans[ 0 ].nWords );
+    uint8_t* buf8 = (uint8_t*)buf;
+    memcpy( buf8, spans[ 0 ].data, beforeWrapBytes );
+    if( spans[ 1 ].nWords > 0 )
+    {
+        memcpy( buf8 + beforeWrapBytes, spans[ 1 ].data,
+                _AiaDataStreamBuffer_WordsToBytes( reader->dataStream,
+                                                   spans[ 1 ].nWords ) );
+    }
+
+    return AiaDataStreamReader_Commit( reader, wordsPeeked );
+}
+
+ssize_t AiaDataStreamReader_ReadWait( AiaDataStreamReader_t* reader, void* buf,
+                                      size_t nWords,
+                                      AiaDurationMs_t timeoutMs )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( !buf )
+    {
+        AiaLogError( "Null buf." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( !reader->isWaitSemaphoreCreated )
+    {
+        if( !AiaSemaphore( Create )( &reader->waitSemaphore, 0, 1 ) )
+        {
+            AiaLogError( "AiaSemaphore( Create ) failed." );
+            return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+        }
+        reader->isWaitSemaphoreCreated = true;
+    }
+
+    AiaDataStreamBuffer_t* dataStream = reader->dataStream;
+    struct AiaDataStreamBufferReaderState* state =
+        &dataStream->readerSlots[ reader->id ].state;
+    if( nWords > dataStream->dataSize )
+    {
+        nWords = dataStream->dataSize;
+    }
+    AiaDataStreamIndex_t waitIndex =
+        AiaDataStreamAtomicIndex_Load( reader->readerCursor ) + nWords;
+    AiaDataStreamIndex_t closeIndex =
+        AiaDataStreamAtomicIndex_Load( reader->readerCloseIndex );
+    if( waitIndex > closeIndex )
+    {
+        waitIndex = closeIndex;
+    }
+
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    state->waitSemaphore = &reader->waitSemaphore;
+    AiaDataStreamAtomicIndex_Store( &state->waitIndex, waitIndex );
+    AiaAtomic_Store_u32(
+        &dataStream->numWaitingReaders,
+        AiaAtomic_Load_u32( &dataStream->numWaitingReaders ) + 1 );
+
+    /* Check the writer only after publishing waitIndex. A writer which
+     * advances in between will either be seen here or see numWaitingReaders.
+     * Writers which have closed will not advance any further. */
+    bool isWaiting =
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor ) <
+            waitIndex &&
+        !( AiaDataStreamAtomicIndex_Load( &dataStream->writeEndCursor ) > 0 &&
+           !AiaAtomicBool_Load( &dataStream->isWriterEnabled ) );
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+
+    if( isWaiting )
+    {
+        AiaSemaphore( TimedWait )( &reader->waitSemaphore, timeoutMs );
+    }
+
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    AiaDataStreamAtomicIndex_Store( &state->waitIndex,
+                                    AIA_DATA_STREAM_INDEX_MAX );
+    AiaAtomic_Store_u32(
+        &dataStream->numWaitingReaders,
+        AiaAtomic_Load_u32( &dataStream->numWaitingReaders ) - 1 );
+    /* Consume a wake up which raced with the timeout. */
+    AiaSemaphore( TryWait )( &reader->waitSemaphore );
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+
+    return AiaDataStreamReader_Read( reader, buf, nWords );
+}
+
+ssize_t AiaDataStreamReader_ReadFanOut(
+    AiaDataStreamReader_t* reader,
+    const AiaDataStreamReaderConsumer_t* consumers, size_t numConsumers,
+    size_t nWords )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( !consumers || 0 == numConsumers )
+    {
+        AiaLogError( "No consumers." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    for( size_t i = 0; i < numConsumers; ++i )
+    {
+        if( !consumers[ i ].consume )
+        {
+            AiaLogError( "Null consume, index=%zu.", i );
+            return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+        }
+    }
+
+    AiaDataStreamReaderSpan_t spans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ];
+    ssize_t wordsPeeked = AiaDataStreamReader_Peek( reader, spans, nWords );
+    if( wordsPeeked <= 0 )
+    {
+        return wordsPeeked;
+    }
+
+    /* Walk the consumers inside the span loop so that each span is only pulled
+     * into cache once. */
+    for( size_t span = 0; span < AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS;
+         ++span )
+    {
+        if( 0 == spans[ span ].nWords )
+        {
+            continue;
+        }
+        for( size_t i = 0; i < numConsumers; ++i )
+        {
+            consumers[ i ].consume( spans[ span ].data, spans[ span ].nWords,
+                                    consumers[ i ].userData );
+        }
+    }
+
+    return AiaDataStreamReader_Commit( reader, wordsPeeked );
+}
+
+ssize_t AiaDataStreamReader_Peek(
+    AiaDataStreamReader_t* reader,
+    AiaDataStreamReaderSpan_t spans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ],
+    size_t nWords )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+    if( !spans )
+    {
+        AiaLogError( "Null spans." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+
     if( 0 == nWords )
     {
         AiaLogError( "Invalid nWords: nWords=%zu.", nWords );
@@ -169,32 +341,61 @@ ssize_t AiaDataStreamReader_Read( AiaDataStreamReader_t* reader, void* buf,
 
     size_t beforeWrap =
         _AiaDataStreamBuffer_WordsUntilWrap( reader->dataStream, readerCursor );
-    if( beforeWrap > nWords )
+    /* A cursor sitting exactly on a wrap boundary has the whole buffer ahead of
+     * it, so the first span is never left empty. */
+    if( 0 == beforeWrap || beforeWrap > nWords )
     {
         beforeWrap = nWords;
     }
     size_t afterWrap = nWords - beforeWrap;
-    size_t wordSize = AiaDataStreamReader_GetWordSize( reader );
 
-    uint8_t* buf8 = (uint8_t*)buf;
-    memcpy( buf8,
-            _AiaDataStreamBuffer_GetData(
-                reader->dataStream,
-                AiaDataStreamAtomicIndex_Load( reader->readerCursor ) ),
-            beforeWrap * wordSize );
-    if( afterWrap > 0 )
+    spans[ 0 ].data =
+        _AiaDataStreamBuffer_GetData( reader->dataStream, readerCursor );
+    spans[ 0 ].nWords = beforeWrap;
+    spans[ 1 ].data = afterWrap > 0 ? _AiaDataStreamBuffer_GetData(
+                                          reader->dataStream,
+                                          readerCursor + beforeWrap )
+                                    : NULL;
+    spans[ 1 ].nWords = afterWrap;
+
+    return nWords;
+}
+
+ssize_t AiaDataStreamReader_Commit( AiaDataStreamReader_t* reader,
+                                    size_t nWords )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
+    }
+
+    AiaDataStreamAtomicIndex_t readerCursor =
+        AiaDataStreamAtomicIndex_Load( reader->readerCursor );
+    if( 0 == nWords ||
+        nWords > AiaDataStreamReader_Tell(
+                     reader,
+                     AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) ||
+        readerCursor + nWords >
+            AiaDataStreamAtomicIndex_Load( reader->readerCloseIndex ) )
     {
-        memcpy( buf8 + ( beforeWrap * wordSize ),
-                _AiaDataStreamBuffer_GetData( reader->dataStream,
-                                              readerCursor + beforeWrap ),
-                afterWrap * wordSize );
+        AiaLogError( "Invalid nWords: nWords=%zu.", nWords );
+        return AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID;
     }
 
     AiaDataStreamAtomicIndex_Add( reader->readerCursor, nWords );
+    if( reader->isPinned )
+    {
+        AiaDataStreamAtomicIndex_Store( &reader->dataStream->pinnedCursor,
+                                        readerCursor + nWords );
+    }
 
+    /* Check from where the committed words start, as any of them may have
+     * been overwritten while they were read in place. */
     bool overrun = ( ( AiaDataStreamAtomicIndex_Load(
                            &reader->dataStream->writeEndCursor ) -
-                       AiaDataStreamAtomicIndex_Load( reader->readerCursor ) ) >
+                       readerCursor ) >
                      AiaDataStreamBuffer_GetDataSize( reader->dataStream ) );
 
     /* Move the unconsumed cursor before returning. */
@@ -262,12 +463,23 @@ bool AiaDataStreamReader_Seek( AiaDataStreamReader_t* reader,
 
     /*
      * Per documentation of _AiaDataStreamBuffer_UpdateOldestUnconsumedCursor(),
-     * don't try to seek backwards while oldestConsumedCursor is being updated.
+     * don't try to seek backwards while oldestConsumedCursor is being updated
+     * under the mutex, and invalidate updates which are scanning without it.
+     * Forward seeks take neither step.
      */
     bool backward = absolute < readerIndex;
     if( backward )
     {
         AiaMutex( Lock )( &reader->dataStream->backwardSeekMutex );
+        _AiaDataStreamBuffer_BeginBackwardSeekLocked( reader->dataStream );
+
+        /* A pinned reader publishes its pin before the check below, for the
+         * same reason as AiaDataStreamReader_Pin(). */
+        if( reader->isPinned )
+        {
+            AiaDataStreamAtomicIndex_Store( &reader->dataStream->pinnedCursor,
+                                            absolute );
+        }
     }
 
     /*
@@ -286,17 +498,29 @@ bool AiaDataStreamReader_Seek( AiaDataStreamReader_t* reader,
         AiaLogError( "Seek overwritten data." );
         if( backward )
         {
+            if( reader->isPinned )
+            {
+                AiaDataStreamAtomicIndex_Store(
+                    &reader->dataStream->pinnedCursor, readerIndex );
+            }
+            _AiaDataStreamBuffer_EndBackwardSeekLocked( reader->dataStream );
             AiaMutex( Unlock )( &reader->dataStream->backwardSeekMutex );
         }
         return false;
     }
 
     AiaDataStreamAtomicIndex_Store( reader->readerCursor, absolute );
+    if( reader->isPinned && !backward )
+    {
+        AiaDataStreamAtomicIndex_Store( &reader->dataStream->pinnedCursor,
+                                        absolute );
+    }
 
     if( backward )
     {
         _AiaDataStreamBuffer_UpdateOldestUnconsumedCursorLocked(
             reader->dataStream );
+        _AiaDataStreamBuffer_EndBackwardSeekLocked( reader->dataStream );
         AiaMutex( Unlock )( &reader->dataStream->backwardSeekMutex );
     }
     else
@@ -339,6 +563,144 @@ AiaDataStreamIndex_t AiaDataStreamReader_Tell(
     return AIA_DATA_STREAM_INDEX_MAX;
 }
 
+bool AiaDataStreamReader_NotifyWhenAvailable(
+    AiaDataStreamReader_t* reader, size_t nWords,
+    AiaDataStreamReaderNotifyCallback_t callback, void* userData )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return false;
+    }
+    if( !callback )
+    {
+        AiaLogError( "Null callback." );
+        return false;
+    }
+
+    AiaDataStreamBuffer_t* dataStream = reader->dataStream;
+    AiaDataStreamIndex_t notifyIndex =
+        AiaDataStreamAtomicIndex_Load( reader->readerCursor ) + nWords;
+
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    dataStream->notifyReaderId = reader->id;
+    dataStream->notifyCallback = callback;
+    dataStream->notifyUserData = userData;
+    AiaDataStreamAtomicIndex_Store( &dataStream->notifyIndex, notifyIndex );
+
+    /* Check the writer only after publishing notifyIndex. A writer which
+     * advances in between will either be seen here or see notifyIndex. */
+    bool armed =
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeStartCursor ) <
+        notifyIndex;
+    if( !armed )
+    {
+        AiaDataStreamAtomicIndex_Store( &dataStream->notifyIndex,
+                                        AIA_DATA_STREAM_INDEX_MAX );
+    }
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+    return armed;
+}
+
+void AiaDataStreamReader_CancelNotification( AiaDataStreamReader_t* reader )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return;
+    }
+
+    AiaDataStreamBuffer_t* dataStream = reader->dataStream;
+    AiaMutex( Lock )( &dataStream->notifyMutex );
+    if( dataStream->notifyReaderId == reader->id )
+    {
+        AiaDataStreamAtomicIndex_Store( &dataStream->notifyIndex,
+                                        AIA_DATA_STREAM_INDEX_MAX );
+    }
+    AiaMutex( Unlock )( &dataStream->notifyMutex );
+}
+
+AiaDataStreamIndex_t AiaDataStreamReader_GetOldestIndex(
+    const AiaDataStreamReader_t* reader )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return 0;
+    }
+
+    /* Mirrors the overwritten data check in AiaDataStreamReader_Seek(). */
+    AiaDataStreamIndex_t writeEnd =
+        AiaDataStreamAtomicIndex_Load( &reader->dataStream->writeEndCursor );
+    size_t dataSize = AiaDataStreamBuffer_GetDataSize( reader->dataStream );
+    return writeEnd > dataSize ? writeEnd - dataSize : 0;
+}
+
+bool AiaDataStreamReader_Pin( AiaDataStreamReader_t* reader )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return false;
+    }
+    if( reader->isPinned )
+    {
+        return true;
+    }
+
+    AiaDataStreamBuffer_t* dataStream = reader->dataStream;
+    AiaMutex( Lock )( &dataStream->backwardSeekMutex );
+    if( AIA_DATA_STREAM_INDEX_MAX !=
+        AiaDataStreamAtomicIndex_Load( &dataStream->pinnedCursor ) )
+    {
+        AiaMutex( Unlock )( &dataStream->backwardSeekMutex );
+        AiaLogError( "Another reader is pinned." );
+        return false;
+    }
+
+    /* Check the writer only after publishing the pin. A writer which claims
+     * space in between will either be seen here or see the pin. */
+    AiaDataStreamIndex_t readerCursor =
+        AiaDataStreamAtomicIndex_Load( reader->readerCursor );
+    AiaDataStreamAtomicIndex_Store( &dataStream->pinnedCursor, readerCursor );
+    AiaDataStreamIndex_t writeEnd =
+        AiaDataStreamAtomicIndex_Load( &dataStream->writeEndCursor );
+    size_t dataSize = AiaDataStreamBuffer_GetDataSize( dataStream );
+    if( writeEnd >= readerCursor && writeEnd - readerCursor > dataSize )
+    {
+        AiaDataStreamAtomicIndex_Store( &dataStream->pinnedCursor,
+                                        AIA_DATA_STREAM_INDEX_MAX );
+        AiaMutex( Unlock )( &dataStream->backwardSeekMutex );
+        AiaLogError( "Pin overwritten data." );
+        return false;
+    }
+    reader->isPinned = true;
+    AiaMutex( Unlock )( &dataStream->backwardSeekMutex );
+    return true;
+}
+
+void AiaDataStreamReader_Unpin( AiaDataStreamReader_t* reader )
+{
+    AiaAssert( reader );
+    if( !reader )
+    {
+        AiaLogError( "Invalid reader." );
+        return;
+    }
+    if( !reader->isPinned )
+    {
+        return;
+    }
+
+    reader->isPinned = false;
+    AiaDataStreamAtomicIndex_Store( &reader->dataStream->pinnedCursor,
+                                    AIA_DATA_STREAM_INDEX_MAX );
+}
+
 void AiaDataStreamReader_Close( AiaDataStreamReader_t* reader,
                                 AiaDataStreamIndex_t offset,
                                 AiaDataStreamReaderReference_t reference )
@@ -72,49 +72,61 @@ void AiaDataStreamWriter_Destroy( AiaDataStreamWriter_t* writer )
     AiaFree( writer );
 }
 
-ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
-                                   const void* buf, size_t nWords )
+/**
+ * This function limits a write so that it leaves the data of the reader pinned
+ * by @c AiaDataStreamReader_Pin(), if any, intact.
+ *
+ * @param writer The @c AiaDataStreamWriter_t to act on.
+ * @param writeStart The start of the write.
+ * @param writeEnd The requested end of the write.
+ * @return @c writeEnd, or the furthest end no earlier than @c writeStart which
+ * does not overwrite the pinned reader.
+ */
+static AiaDataStreamIndex_t _AiaDataStreamWriter_LimitToPin(
+    AiaDataStreamWriter_t* writer, AiaDataStreamIndex_t writeStart,
+    AiaDataStreamIndex_t writeEnd )
 {
-    AiaAssert( writer );
-    if( !writer )
-    {
-        AiaLogError( "Invalid writer." );
-        return 0;
-    }
-    if( !buf )
-    {
-        AiaLogError( "Null buf." );
-        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
-    }
-    if( 0 == nWords )
+    AiaDataStreamIndex_t pinned =
+        AiaDataStreamAtomicIndex_Load( &writer->stream->pinnedCursor );
+    if( AIA_DATA_STREAM_INDEX_MAX == pinned )
     {
-        AiaLogError( "Invalid nWords: nWords=%zu.", nWords );
-        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+        return writeEnd;
     }
-
-    if( !AiaAtomicBool_Load( &writer->stream->isWriterEnabled ) )
+    AiaDataStreamIndex_t limit =
+        pinned + AiaDataStreamBuffer_GetDataSize( writer->stream );
+    if( writeEnd <= limit )
     {
-        AiaLogError( "Writer disabled." );
-        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_CLOSED;
+        return writeEnd;
     }
+    return limit > writeStart ? limit : writeStart;
+}
 
-    size_t wordsToCopy = nWords;
-    const uint8_t* buf8 = (const uint8_t*)buf;
+/**
+ * Applies the writer's policy to a request to write @c nWords words at the
+ * current write position and, if successful, advances @c writeEndCursor to
+ * claim the resulting region of the buffer.
+ *
+ * @param writer The @c AiaDataStreamWriter_t to act on.
+ * @param nWords The number of words requested. This will be updated to the
+ * number of words granted by the policy.
+ * @return The new value of @c writeEndCursor, or @c AIA_DATA_STREAM_INDEX_MAX
+ * if the policy does not allow any words to be written.
+ */
+static AiaDataStreamIndex_t _AiaDataStreamWriter_Claim(
+    AiaDataStreamWriter_t* writer, size_t* nWords )
+{
     AiaDataStreamIndex_t writeStart =
         AiaDataStreamAtomicIndex_Load( &writer->stream->writeStartCursor );
-    AiaDataStreamIndex_t writeEnd = writeStart + nWords;
+    AiaDataStreamIndex_t writeEnd = writeStart + *nWords;
     bool backwardSeekMutexAcquired = false;
 
     switch( writer->policy )
     {
         case AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE:
-            if( nWords > AiaDataStreamBuffer_GetDataSize( writer->stream ) )
+            if( *nWords > AiaDataStreamBuffer_GetDataSize( writer->stream ) )
             {
-                wordsToCopy = nWords =
-                    AiaDataStreamBuffer_GetDataSize( writer->stream );
-                writeEnd = AiaDataStreamAtomicIndex_Load(
-                               &writer->stream->writeStartCursor ) +
-                           nWords;
+                *nWords = AiaDataStreamBuffer_GetDataSize( writer->stream );
+                writeEnd = writeStart + *nWords;
             }
             break;
         case AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING:
@@ -127,11 +139,8 @@ ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
                                    &writer->stream->oldestUnconsumedCursor ) ) >
                   AiaDataStreamBuffer_GetDataSize( writer->stream ) ) )
             {
-                if( backwardSeekMutexAcquired )
-                {
-                    AiaMutex( Unlock )( &writer->stream->backwardSeekMutex );
-                }
-                return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK;
+                AiaMutex( Unlock )( &writer->stream->backwardSeekMutex );
+                return AIA_DATA_STREAM_INDEX_MAX;
             }
             break;
         case AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKING:
@@ -158,19 +167,90 @@ ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
                 }
             }
 
-            if( spaceAvailable < nWords )
+            if( spaceAvailable < *nWords )
             {
-                wordsToCopy = nWords = spaceAvailable;
-                writeEnd = writeStart + nWords;
+                *nWords = spaceAvailable;
+                writeEnd = writeStart + *nWords;
             }
             break;
     }
 
-    AiaDataStreamAtomicIndex_Store( &writer->stream->writeEndCursor, writeEnd );
+    /* The pin is checked again after publishing writeEndCursor, since @c
+     * AiaDataStreamReader_Pin() publishes the pin before checking
+     * writeEndCursor. Either it sees this write and fails, or the check here
+     * sees the pin. */
+    AiaDataStreamIndex_t limit =
+        _AiaDataStreamWriter_LimitToPin( writer, writeStart, writeEnd );
+    AiaDataStreamAtomicIndex_Store( &writer->stream->writeEndCursor, limit );
+    AiaDataStreamIndex_t recheckedLimit =
+        _AiaDataStreamWriter_LimitToPin( writer, writeStart, limit );
+    if( recheckedLimit != limit )
+    {
+        limit = recheckedLimit;
+        AiaDataStreamAtomicIndex_Store( &writer->stream->writeEndCursor,
+                                        limit );
+    }
+    if( limit != writeEnd )
+    {
+        if( AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING == writer->policy ||
+            limit == writeStart )
+        {
+            AiaDataStreamAtomicIndex_Store( &writer->stream->writeEndCursor,
+                                            writeStart );
+            limit = AIA_DATA_STREAM_INDEX_MAX;
+        }
+        else
+        {
+            *nWords = limit - writeStart;
+        }
+    }
     if( backwardSeekMutexAcquired )
     {
         AiaMutex( Unlock )( &writer->stream->backwardSeekMutex );
     }
+    return limit;
+}
+
+ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
+                                   const void* buf, size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return 0;
+    }
+    if( !buf )
+    {
+        AiaLogError( "Null buf." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( 0 == nWords )
+    {
+        AiaLogError( "Invalid nWords: nWords=%zu.", nWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( writer->reservedWords )
+    {
+        AiaLogError( "Write while reservation outstanding." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    if( !AiaAtomicBool_Load( &writer->stream->isWriterEnabled ) )
+    {
+        AiaLogError( "Writer disabled." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_CLOSED;
+    }
+
+    const uint8_t* buf8 = (const uint8_t*)buf;
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &writer->stream->writeStartCursor );
+    AiaDataStreamIndex_t writeEnd = _AiaDataStreamWriter_Claim( writer, &nWords );
+    if( AIA_DATA_STREAM_INDEX_MAX == writeEnd )
+    {
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK;
+    }
+    size_t wordsToCopy = nWords;
 
     if( AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING == writer->policy )
     {
@@ -180,8 +260,8 @@ ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
         if( wordsToCopy > AiaDataStreamBuffer_GetDataSize( writer->stream ) )
         {
             wordsToCopy = AiaDataStreamBuffer_GetDataSize( writer->stream );
-            buf8 += ( nWords - wordsToCopy ) *
-                    AiaDataStreamWriter_GetWordSize( writer );
+            buf8 += _AiaDataStreamBuffer_WordsToBytes( writer->stream,
+                                                       nWords - wordsToCopy );
         }
     }
 
@@ -193,22 +273,174 @@ ssize_t AiaDataStreamWriter_Write( AiaDataStreamWriter_t* writer,
     }
     size_t afterWrap = wordsToCopy - beforeWrap;
 
+    size_t beforeWrapBytes =
+        _AiaDataStreamBuffer_WordsToBytes( writer->stream, beforeWrap );
     memcpy( _AiaDataStreamBuffer_GetData( writer->stream, writeStart ), buf8,
-            beforeWrap * AiaDataStreamWriter_GetWordSize( writer ) );
+            beforeWrapBytes );
     if( afterWrap > 0 )
     {
         memcpy( _AiaDataStreamBuffer_GetData( writer->stream,
                                               writeStart + beforeWrap ),
-                buf8 + beforeWrap * AiaDataStreamWriter_GetWordSize( writer ),
-                afterWrap * AiaDataStreamWriter_GetWordSize( writer ) );
+                buf8 + beforeWrapBytes,
+                _AiaDataStreamBuffer_WordsToBytes( writer->stream,
+                                                   afterWrap ) );
     }
+    _AiaDataStreamBuffer_MaintainCache( writer->stream,
+                                        writer->stream->cleanRange, writeStart,
+                                        wordsToCopy );
 
     AiaDataStreamAtomicIndex_Store( &writer->stream->writeStartCursor,
                                     writeEnd );
+    _AiaDataStreamBuffer_NotifyReader( writer->stream );
 
     return nWords;
 }
 
+ssize_t AiaDataStreamWriter_Reserve(
+    AiaDataStreamWriter_t* writer,
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ],
+    size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( !spans )
+    {
+        AiaLogError( "Null spans." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( 0 == nWords )
+    {
+        AiaLogError( "Invalid nWords: nWords=%zu.", nWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( writer->reservedWords )
+    {
+        AiaLogError( "Reservation already outstanding, reservedWords=%zu.",
+                     writer->reservedWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    if( !AiaAtomicBool_Load( &writer->stream->isWriterEnabled ) )
+    {
+        AiaLogError( "Writer disabled." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_CLOSED;
+    }
+
+    /* Unlike @c AiaDataStreamWriter_Write(), there is no leading data to
+     * discard, so a reservation can never exceed the size of the buffer. */
+    if( nWords > AiaDataStreamBuffer_GetDataSize( writer->stream ) )
+    {
+        nWords = AiaDataStreamBuffer_GetDataSize( writer->stream );
+    }
+
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &writer->stream->writeStartCursor );
+    if( AIA_DATA_STREAM_INDEX_MAX ==
+        _AiaDataStreamWriter_Claim( writer, &nWords ) )
+    {
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK;
+    }
+    if( 0 == nWords )
+    {
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK;
+    }
+
+    size_t beforeWrap =
+        _AiaDataStreamBuffer_WordsUntilWrap( writer->stream, writeStart );
+    /* A cursor sitting exactly on a wrap boundary has the whole buffer ahead of
+     * it, so the first span is never left empty. */
+    if( 0 == beforeWrap || beforeWrap > nWords )
+    {
+        beforeWrap = nWords;
+    }
+    size_t afterWrap = nWords - beforeWrap;
+
+    spans[ 0 ].data =
+        _AiaDataStreamBuffer_GetData( writer->stream, writeStart );
+    spans[ 0 ].nWords = beforeWrap;
+    spans[ 1 ].data = afterWrap > 0
+                          ? _AiaDataStreamBuffer_GetData(
+                                writer->stream, writeStart + beforeWrap )
+                          : NULL;
+    spans[ 1 ].nWords = afterWrap;
+
+    writer->reservedWords = nWords;
+    return nWords;
+}
+
+ssize_t AiaDataStreamWriter_Publish( AiaDataStreamWriter_t* writer,
+                                     size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( nWords > writer->reservedWords )
+    {
+        AiaLogError( "Invalid nWords: nWords=%zu, reservedWords=%zu.", nWords,
+                     writer->reservedWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &writer->stream->writeStartCursor );
+    AiaDataStreamIndex_t writeEnd = writeStart + nWords;
+    _AiaDataStreamBuffer_MaintainCache(
+        writer->stream, writer->stream->invalidateRange, writeStart, nWords );
+    if( nWords < writer->reservedWords )
+    {
+        /* Release the unused tail of the reservation. */
+        AiaDataStreamAtomicIndex_Store( &writer->stream->writeEndCursor,
+                                        writeEnd );
+    }
+    AiaDataStreamAtomicIndex_Store( &writer->stream->writeStartCursor,
+                                    writeEnd );
+    writer->reservedWords = 0;
+    _AiaDataStreamBuffer_NotifyReader( writer->stream );
+
+    return nWords;
+}
+
+bool AiaDataStreamWriter_Mark( AiaDataStreamWriter_t* writer,
+                               uint64_t timestamp, uint32_t tag )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return false;
+    }
+    AiaDataStreamBuffer_t* stream = writer->stream;
+    if( !stream->metadata )
+    {
+        AiaLogError( "No metadata ring." );
+        return false;
+    }
+    if( !AiaAtomicBool_Load( &stream->isWriterEnabled ) )
+    {
+        AiaLogError( "Writer disabled." );
+        return false;
+    }
+
+    /* Only the writer updates metadataCount, so it is read once and published
+     * after the entry is complete. */
+    AiaDataStreamIndex_t count =
+        AiaDataStreamAtomicIndex_Load( &stream->metadataCount );
+    AiaDataStreamMetadataEntry_t* entry =
+        &stream->metadata[ count % stream->metadataCapacity ];
+    entry->timestamp = timestamp;
+    entry->index = AiaDataStreamAtomicIndex_Load( &stream->writeStartCursor );
+    entry->tag = tag;
+    AiaDataStreamAtomicIndex_Store( &stream->metadataCount, count + 1 );
+    return true;
+}
+
 AiaDataStreamIndex_t AiaDataStreamWriter_Tell(
     const AiaDataStreamWriter_t* writer )
 {
@@ -241,6 +473,12 @@ void AiaDataStreamWriter_Close( AiaDataStreamWriter_t* writer )
     }
     writer->closed = true;
     AiaMutex( Unlock )( &writer->stream->writerEnableMutex );
+
+    /* Readers waiting for more data will find the stream closed instead. */
+    if( AiaAtomic_Load_u32( &writer->stream->numWaitingReaders ) )
+    {
+        _AiaDataStreamBuffer_WakeWaitingReaders( writer->stream, true );
+    }
 }
 
 size_t AiaDataStreamWriter_GetWordSize( const AiaDataStreamWriter_t* writer )
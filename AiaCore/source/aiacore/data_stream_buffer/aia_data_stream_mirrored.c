@@ -0,0 +1,91 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/data_stream_buffer/private/aia_data_stream_buffer.h>
+
+#include <errno.h>
+#include <linux/memfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+uint8_t* _AiaDataStreamBuffer_MapMirrored( size_t* size, size_t wordSize )
+{
+    if( !size || 0 == *size || 0 == wordSize )
+    {
+        AiaLogError( "Invalid size." );
+        return NULL;
+    }
+
+    /* Both mappings must start on a page, and the ring must end where the
+     * second mapping starts. */
+    size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+    size_t unit = pageSize;
+    while( unit % wordSize )
+    {
+        unit += pageSize;
+    }
+    size_t mappingSize = ( ( *size + unit - 1 ) / unit ) * unit;
+
+    int fd = syscall( SYS_memfd_create, "aia_data_stream", MFD_CLOEXEC );
+    if( fd < 0 )
+    {
+        AiaLogError( "memfd_create failed, errno=%d.", errno );
+        return NULL;
+    }
+    if( ftruncate( fd, mappingSize ) )
+    {
+        AiaLogError( "ftruncate failed, errno=%d.", errno );
+        close( fd );
+        return NULL;
+    }
+
+    /* Reserve the address space for both mappings first, so that nothing else
+     * can be mapped between them. */
+    uint8_t* data = mmap( NULL, 2 * mappingSize, PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( MAP_FAILED == data )
+    {
+        AiaLogError( "mmap failed, errno=%d.", errno );
+        close( fd );
+        return NULL;
+    }
+    for( size_t offset = 0; offset < 2 * mappingSize; offset += mappingSize )
+    {
+        if( MAP_FAILED == mmap( data + offset, mappingSize,
+                                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                                fd, 0 ) )
+        {
+            AiaLogError( "mmap failed, errno=%d.", errno );
+            munmap( data, 2 * mappingSize );
+            close( fd );
+            return NULL;
+        }
+    }
+
+    /* The mappings keep the file alive. */
+    close( fd );
+    *size = mappingSize;
+    return data;
+}
+
+void _AiaDataStreamBuffer_UnmapMirrored( uint8_t* data, size_t size )
+{
+    munmap( data, 2 * size );
+}
@@ -0,0 +1,548 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_utils.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_shared.h>
+#include <aiacore/data_stream_buffer/private/aia_data_stream_buffer.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Identifies an initialized segment ("AIAS"). */
+#define AIA_DATA_STREAM_SHARED_MAGIC 0x41494153
+
+/** Changed whenever the layout of the segment changes. */
+#define AIA_DATA_STREAM_SHARED_VERSION 1
+
+/**
+ * The start of a shared segment, followed by the words of the stream at @c
+ * AIA_DATA_STREAM_SHARED_DATA_OFFSET. Fields after the configuration are only
+ * accessed with atomic operations, and grouped by the process writing them as
+ * in @c struct AiaDataStreamBuffer.
+ */
+typedef struct AiaDataStreamSharedHeader
+{
+    /** Set to @c AIA_DATA_STREAM_SHARED_MAGIC once the rest is initialized. */
+    uint32_t magic;
+
+    /** @c AIA_DATA_STREAM_SHARED_VERSION of the writer. */
+    uint32_t version;
+
+    /** Word size in bytes. */
+    uint32_t wordSize;
+
+    /** Size in words of the data. */
+    uint32_t dataSize;
+
+    /** Keeps the writer's fields off the configuration's line. */
+    uint8_t writerPadding[ AIA_CACHE_LINE_SIZE ];
+
+    /** The next index to write to. */
+    AiaDataStreamAtomicIndex_t writeStartCursor;
+
+    /** The end of the region being written, as in @c AiaDataStreamBuffer. */
+    AiaDataStreamAtomicIndex_t writeEndCursor;
+
+    /** Cleared when the writer closes the stream. */
+    AiaAtomicBool_t isWriterEnabled;
+
+    /**
+     * Incremented after each publish and when the stream closes. This is the
+     * futex word consumers wait on.
+     */
+    uint32_t sequence;
+
+    /** Keeps the consumers' fields off the writer's line. */
+    uint8_t readerPadding[ AIA_CACHE_LINE_SIZE ];
+
+    /** The number of consumers in @c AiaDataStreamShared_Wait(). */
+    uint32_t numWaiters;
+} AiaDataStreamSharedHeader_t;
+
+/** Offset of the words of the stream from the start of a segment. */
+#define AIA_DATA_STREAM_SHARED_DATA_OFFSET \
+    AIA_DATA_STREAM_BUFFER_CACHE_LINES( sizeof( AiaDataStreamSharedHeader_t ) )
+
+struct AiaDataStreamSharedWriter
+{
+    /** The mapped segment. */
+    AiaDataStreamSharedHeader_t* header;
+
+    /** The size of the mapping. */
+    size_t segmentSize;
+
+    /** The words reserved by @c AiaDataStreamSharedWriter_Reserve(). */
+    size_t reservedWords;
+
+    /** The name of the segment, unlinked on destruction. */
+    char name[];
+};
+
+struct AiaDataStreamShared
+{
+    /** The mapped segment. */
+    AiaDataStreamSharedHeader_t* header;
+
+    /** The size of the mapping. */
+    size_t segmentSize;
+
+    /** The local view of the segment. */
+    AiaDataStreamBuffer_t* buffer;
+
+    /** Holds the writer slot of @c buffer; used to close it. */
+    AiaDataStreamWriter_t* writer;
+};
+
+/**
+ * Wakes consumers waiting for the writer after it published words or closed.
+ *
+ * @param header The segment to act on.
+ */
+static void _AiaDataStreamShared_WakeWaiters(
+    AiaDataStreamSharedHeader_t* header )
+{
+    AiaAtomic_Add_u32( &header->sequence, 1 );
+    if( AiaAtomic_Load_u32( &header->numWaiters ) )
+    {
+        syscall( SYS_futex, &header->sequence, FUTEX_WAKE, INT_MAX, NULL, NULL,
+                 0 );
+    }
+}
+
+/**
+ * Returns the address of the word at @c index in a segment, wrapping as @c
+ * _AiaDataStreamBuffer_GetData() does so both ends agree on where words are.
+ *
+ * @param header The segment to act on.
+ * @param index The index of the word.
+ * @return A pointer to the word.
+ */
+static uint8_t* _AiaDataStreamShared_GetData(
+    AiaDataStreamSharedHeader_t* header, AiaDataStreamIndex_t index )
+{
+    return (uint8_t*)header + AIA_DATA_STREAM_SHARED_DATA_OFFSET +
+           (size_t)( index % header->dataSize ) * header->wordSize;
+}
+
+AiaDataStreamSharedWriter_t* AiaDataStreamSharedWriter_Create(
+    const char* name, size_t wordSize, size_t dataSize )
+{
+    if( !name || '/' != name[ 0 ] )
+    {
+        AiaLogError( "Invalid name." );
+        return NULL;
+    }
+    if( 0 == wordSize || wordSize > AiaDataStreamBufferWordSize_MAX ||
+        0 == dataSize || dataSize > AIA_DATA_STREAM_INDEX_MAX / 2 )
+    {
+        AiaLogError( "Invalid size, wordSize=%zu, dataSize=%zu.", wordSize,
+                     dataSize );
+        return NULL;
+    }
+
+    size_t nameSize = strlen( name ) + 1;
+    AiaDataStreamSharedWriter_t* writer =
+        AiaCalloc( 1, sizeof( AiaDataStreamSharedWriter_t ) + nameSize );
+    if( !writer )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaDataStreamSharedWriter_t ) + nameSize );
+        return NULL;
+    }
+    memcpy( writer->name, name, nameSize );
+    writer->segmentSize =
+        AIA_DATA_STREAM_SHARED_DATA_OFFSET + dataSize * wordSize;
+
+    /* Consumers of a previous segment keep it until they close it. */
+    shm_unlink( name );
+    int fd = shm_open( name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR );
+    if( fd < 0 )
+    {
+        AiaLogError( "shm_open failed, name=%s, errno=%d.", name, errno );
+        AiaFree( writer );
+        return NULL;
+    }
+    if( ftruncate( fd, (off_t)writer->segmentSize ) )
+    {
+        AiaLogError( "ftruncate failed, errno=%d.", errno );
+        close( fd );
+        shm_unlink( name );
+        AiaFree( writer );
+        return NULL;
+    }
+    void* segment = mmap( NULL, writer->segmentSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0 );
+    close( fd );
+    if( MAP_FAILED == segment )
+    {
+        AiaLogError( "mmap failed, errno=%d.", errno );
+        shm_unlink( name );
+        AiaFree( writer );
+        return NULL;
+    }
+
+    /* The segment starts zeroed. */
+    writer->header = segment;
+    writer->header->version = AIA_DATA_STREAM_SHARED_VERSION;
+    writer->header->wordSize = wordSize;
+    writer->header->dataSize = dataSize;
+    AiaAtomicBool_Set( &writer->header->isWriterEnabled );
+    AiaAtomic_Store_u32( &writer->header->magic,
+                         AIA_DATA_STREAM_SHARED_MAGIC );
+    return writer;
+}
+
+void AiaDataStreamSharedWriter_Destroy( AiaDataStreamSharedWriter_t* writer )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return;
+    }
+    AiaAtomicBool_Clear( &writer->header->isWriterEnabled );
+    _AiaDataStreamShared_WakeWaiters( writer->header );
+    munmap( writer->header, writer->segmentSize );
+    shm_unlink( writer->name );
+    AiaFree( writer );
+}
+
+ssize_t AiaDataStreamSharedWriter_Write( AiaDataStreamSharedWriter_t* writer,
+                                         const void* buf, size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( !buf )
+    {
+        AiaLogError( "Null buf." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t reserved =
+        AiaDataStreamSharedWriter_Reserve( writer, spans, nWords );
+    if( reserved <= 0 )
+    {
+        return reserved;
+    }
+    size_t wordSize = writer->header->wordSize;
+    memcpy( spans[ 0 ].data, buf, spans[ 0 ].nWords * wordSize );
+    if( spans[ 1 ].nWords )
+    {
+        memcpy( spans[ 1 ].data,
+                (const uint8_t*)buf + spans[ 0 ].nWords * wordSize,
+                spans[ 1 ].nWords * wordSize );
+    }
+    return AiaDataStreamSharedWriter_Publish( writer, reserved );
+}
+
+ssize_t AiaDataStreamSharedWriter_Reserve(
+    AiaDataStreamSharedWriter_t* writer,
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ],
+    size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( !spans || 0 == nWords )
+    {
+        AiaLogError( "Null spans or no words, nWords=%zu.", nWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( writer->reservedWords )
+    {
+        AiaLogError( "Reservation already outstanding, reservedWords=%zu.",
+                     writer->reservedWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    AiaDataStreamSharedHeader_t* header = writer->header;
+    if( nWords > header->dataSize )
+    {
+        nWords = header->dataSize;
+    }
+
+    /* Claim the words before touching them, so that consumers can tell the
+     * words they are reading are being overwritten. */
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &header->writeStartCursor );
+    AiaDataStreamAtomicIndex_Store( &header->writeEndCursor,
+                                    writeStart + nWords );
+
+    size_t beforeWrap = header->dataSize - writeStart % header->dataSize;
+    if( beforeWrap > nWords )
+    {
+        beforeWrap = nWords;
+    }
+    spans[ 0 ].data = _AiaDataStreamShared_GetData( header, writeStart );
+    spans[ 0 ].nWords = beforeWrap;
+    spans[ 1 ].data =
+        beforeWrap < nWords
+            ? _AiaDataStreamShared_GetData( header, writeStart + beforeWrap )
+            : NULL;
+    spans[ 1 ].nWords = nWords - beforeWrap;
+
+    writer->reservedWords = nWords;
+    return nWords;
+}
+
+ssize_t AiaDataStreamSharedWriter_Publish( AiaDataStreamSharedWriter_t* writer,
+                                           size_t nWords )
+{
+    AiaAssert( writer );
+    if( !writer )
+    {
+        AiaLogError( "Invalid writer." );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+    if( nWords > writer->reservedWords )
+    {
+        AiaLogError( "Invalid nWords: nWords=%zu, reservedWords=%zu.", nWords,
+                     writer->reservedWords );
+        return AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID;
+    }
+
+    AiaDataStreamSharedHeader_t* header = writer->header;
+    AiaDataStreamIndex_t writeEnd =
+        AiaDataStreamAtomicIndex_Load( &header->writeStartCursor ) + nWords;
+    if( nWords < writer->reservedWords )
+    {
+        /* Release the unused tail of the reservation. */
+        AiaDataStreamAtomicIndex_Store( &header->writeEndCursor, writeEnd );
+    }
+    AiaDataStreamAtomicIndex_Store( &header->writeStartCursor, writeEnd );
+    writer->reservedWords = 0;
+    _AiaDataStreamShared_WakeWaiters( header );
+    return nWords;
+}
+
+AiaDataStreamShared_t* AiaDataStreamShared_Open( const char* name,
+                                                 size_t maxReaders )
+{
+    if( !name )
+    {
+        AiaLogError( "Null name." );
+        return NULL;
+    }
+    int fd = shm_open( name, O_RDWR, 0 );
+    if( fd < 0 )
+    {
+        AiaLogError( "shm_open failed, name=%s, errno=%d.", name, errno );
+        return NULL;
+    }
+    struct stat status;
+    if( fstat( fd, &status ) ||
+        (size_t)status.st_size < AIA_DATA_STREAM_SHARED_DATA_OFFSET )
+    {
+        AiaLogError( "Segment missing or too small, errno=%d.", errno );
+        close( fd );
+        return NULL;
+    }
+    size_t segmentSize = status.st_size;
+    AiaDataStreamSharedHeader_t* header = mmap(
+        NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( MAP_FAILED == header )
+    {
+        AiaLogError( "mmap failed, errno=%d.", errno );
+        return NULL;
+    }
+    if( AIA_DATA_STREAM_SHARED_MAGIC !=
+            AiaAtomic_Load_u32( &header->magic ) ||
+        AIA_DATA_STREAM_SHARED_VERSION != header->version )
+    {
+        AiaLogError( "Segment not initialized or incompatible." );
+        munmap( header, segmentSize );
+        return NULL;
+    }
+
+    /* The geometry comes from another process, so a stale or corrupt segment
+     * must fail here rather than be divided by or mapped past its end. */
+    size_t wordSize = header->wordSize;
+    size_t dataSize = header->dataSize;
+    if( !wordSize || !dataSize ||
+        dataSize >
+            ( segmentSize - AIA_DATA_STREAM_SHARED_DATA_OFFSET ) / wordSize )
+    {
+        AiaLogError( "Invalid segment geometry, wordSize=%zu, dataSize=%zu, "
+                     "segmentSize=%zu.",
+                     wordSize, dataSize, segmentSize );
+        munmap( header, segmentSize );
+        return NULL;
+    }
+
+    AiaDataStreamShared_t* shared =
+        AiaCalloc( 1, sizeof( AiaDataStreamShared_t ) );
+    if( !shared )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaDataStreamShared_t ) );
+        munmap( header, segmentSize );
+        return NULL;
+    }
+    shared->header = header;
+    shared->segmentSize = segmentSize;
+    shared->buffer = AiaDataStreamBuffer_Create(
+        (uint8_t*)header + AIA_DATA_STREAM_SHARED_DATA_OFFSET,
+        dataSize * wordSize, wordSize, maxReaders );
+    if( !shared->buffer )
+    {
+        AiaLogError( "AiaDataStreamBuffer_Create failed." );
+        munmap( header, segmentSize );
+        AiaFree( shared );
+        return NULL;
+    }
+    shared->writer = AiaDataStreamBuffer_CreateWriter(
+        shared->buffer, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    if( !shared->writer )
+    {
+        AiaLogError( "AiaDataStreamBuffer_CreateWriter failed." );
+        AiaDataStreamBuffer_Destroy( shared->buffer );
+        munmap( header, segmentSize );
+        AiaFree( shared );
+        return NULL;
+    }
+
+    /* Words written before opening are published by the first sync, as they
+     * would have been by a local writer. Start where the stream starts. */
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &header->writeStartCursor );
+    AiaDataStreamIndex_t start =
+        writeStart > dataSize ? writeStart - dataSize : 0;
+    AiaDataStreamAtomicIndex_Store( &shared->buffer->writeEndCursor, start );
+    AiaDataStreamAtomicIndex_Store( &shared->buffer->writeStartCursor, start );
+    AiaDataStreamAtomicIndex_Store( &shared->buffer->oldestUnconsumedCursor,
+                                    start );
+    return shared;
+}
+
+void AiaDataStreamShared_Close( AiaDataStreamShared_t* shared )
+{
+    AiaAssert( shared );
+    if( !shared )
+    {
+        AiaLogError( "Invalid shared." );
+        return;
+    }
+    AiaDataStreamWriter_Destroy( shared->writer );
+    AiaDataStreamBuffer_Destroy( shared->buffer );
+    munmap( shared->header, shared->segmentSize );
+    AiaFree( shared );
+}
+
+AiaDataStreamBuffer_t* AiaDataStreamShared_GetBuffer(
+    AiaDataStreamShared_t* shared )
+{
+    AiaAssert( shared );
+    if( !shared )
+    {
+        AiaLogError( "Invalid shared." );
+        return NULL;
+    }
+    return shared->buffer;
+}
+
+size_t AiaDataStreamShared_Sync( AiaDataStreamShared_t* shared )
+{
+    AiaAssert( shared );
+    if( !shared )
+    {
+        AiaLogError( "Invalid shared." );
+        return 0;
+    }
+    AiaDataStreamSharedHeader_t* header = shared->header;
+    AiaDataStreamBuffer_t* buffer = shared->buffer;
+
+    /* The writer advances its end before its start, so loading them in the
+     * other order never sees the start ahead of the end. */
+    bool isWriterEnabled = AiaAtomicBool_Load( &header->isWriterEnabled );
+    AiaDataStreamIndex_t writeStart =
+        AiaDataStreamAtomicIndex_Load( &header->writeStartCursor );
+    AiaDataStreamIndex_t writeEnd =
+        AiaDataStreamAtomicIndex_Load( &header->writeEndCursor );
+    AiaDataStreamIndex_t published =
+        AiaDataStreamAtomicIndex_Load( &buffer->writeStartCursor );
+
+    size_t nWords = 0;
+    if( writeStart > published )
+    {
+        /* Readers check the end for overruns, so it goes first here too. */
+        AiaDataStreamAtomicIndex_Store( &buffer->writeEndCursor, writeEnd );
+        AiaDataStreamAtomicIndex_Store( &buffer->writeStartCursor, writeStart );
+        _AiaDataStreamBuffer_NotifyReader( buffer );
+        nWords = writeStart - published;
+    }
+    if( !isWriterEnabled &&
+        AiaAtomicBool_Load( &buffer->isWriterEnabled ) )
+    {
+        AiaDataStreamWriter_Close( shared->writer );
+    }
+    return nWords;
+}
+
+size_t AiaDataStreamShared_Wait( AiaDataStreamShared_t* shared,
+                                 AiaDurationMs_t timeoutMs )
+{
+    AiaAssert( shared );
+    if( !shared )
+    {
+        AiaLogError( "Invalid shared." );
+        return 0;
+    }
+    AiaDataStreamSharedHeader_t* header = shared->header;
+
+    /* The writer changes its cursor or state before bumping sequence and then
+     * checks numWaiters, so either the check below sees the change, or the
+     * futex sees sequence change, or the writer wakes it. */
+    AiaAtomic_Add_u32( &header->numWaiters, 1 );
+    uint32_t sequence = AiaAtomic_Load_u32( &header->sequence );
+    bool isWaiting =
+        AiaDataStreamAtomicIndex_Load( &header->writeStartCursor ) ==
+            AiaDataStreamAtomicIndex_Load(
+                &shared->buffer->writeStartCursor ) &&
+        AiaAtomicBool_Load( &header->isWriterEnabled );
+    if( isWaiting )
+    {
+        struct timespec timeout;
+        timeout.tv_sec = timeoutMs / AIA_MS_PER_SECOND;
+        timeout.tv_nsec = ( timeoutMs % AIA_MS_PER_SECOND ) * 1000000L;
+        syscall( SYS_futex, &header->sequence, FUTEX_WAIT, sequence, &timeout,
+                 NULL, 0 );
+    }
+    AiaAtomic_Add_u32( &header->numWaiters, UINT32_MAX );
+
+    return AiaDataStreamShared_Sync( shared );
+}
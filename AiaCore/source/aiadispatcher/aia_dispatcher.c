@@ -20,7 +20,7 @@
 #include <aiaconnectionmanager/aia_connection_constants.h>
 #include <aiaconnectionmanager/aia_connection_manager.h>
 #include <aiacore/aia_directive.h>
-#include <aiacore/aia_exception_encountered_utils.h>
+#include <aiacore/aia_exception_limiter.h>
 #include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_message.h>
 #include <aiacore/aia_json_utils.h>
@@ -28,6 +28,15 @@
 #include <aiacore/aia_utils.h>
 #include <aiadispatcher/aia_dispatcher.h>
 
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+#include AiaClock( HEADER )
+#endif
+#if defined( AIA_ENABLE_PARALLEL_DIRECTIVES ) || \
+    defined( AIA_ENABLE_SPECULATIVE_DECRYPTION )
+#include AiaListDouble( HEADER )
+#include AiaTimer( HEADER )
+#endif
+
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
@@ -35,6 +44,23 @@
 /** The maximum amount of time to wait for a sequence number. */
 static const AiaDurationMs_t AIA_SEQUENCER_TIMEOUT = 10000;
 
+/**
+ * The size of the scratch arena used while handling a directive topic message.
+ * This covers the decrypted copy of typical messages; larger ones fall back to
+ * the heap.
+ */
+static const size_t AIA_DIRECTIVE_SCRATCH_ARENA_SIZE = 8192;
+
+/**
+ * The largest number of messages of a received batch which are sorted and
+ * written to a sequencer under one acquisition of the topic's mutex. Larger
+ * batches are handled in chunks of this size.
+ */
+#define AIA_DISPATCHER_RECEIVE_BATCH_SIZE 32
+
+/** The directives of one directive topic message which are still running. */
+typedef struct AiaDispatcherDirectiveBatch AiaDispatcherDirectiveBatch_t;
+
 /**
  * Sequencer number retrieval callback for sequenced messages.
  *
@@ -83,6 +109,27 @@ static bool getSequenceNumberCallback( AiaSequenceNumber_t* sequenceNumber,
     return true;
 }
 
+#if defined( AIA_ENABLE_TRACE ) && defined( AIA_ENABLE_SPEAKER )
+/**
+ * Reads the plaintext sequence number of a message for tagging trace events.
+ *
+ * @param message Input buffer holding the common header.
+ * @param size Size of the @c message buffer.
+ * @return The sequence number, or @c AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN.
+ */
+static uint32_t peekSequenceNumber( const void* message, size_t size )
+{
+    AiaSequenceNumber_t sequenceNumber = 0;
+    if( !message ||
+        !getSequenceNumberCallback( &sequenceNumber, (void*)message, size,
+                                    NULL ) )
+    {
+        return AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN;
+    }
+    return sequenceNumber;
+}
+#endif
+
 /**
  * Parses the common header and decrypt the data after the header in a given
  * message.
@@ -182,6 +229,377 @@ static bool parseHeaderAndDecryptMessage(
     return true;
 }
 
+/**
+ * Runs a directive handler, timing it if latency histograms are enabled.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param directive The directive.
+ * @param handler The handler to run.
+ * @param component The component to pass to @c handler.
+ * @param payload Payload for the directive handler.
+ * @param payloadLength Length of @c payload.
+ * @param sequenceNumber Sequence number of the message.
+ * @param index Index of the directive in the message.
+ */
+static void runDirectiveHandler( AiaDispatcher_t* aiaDispatcher,
+                                 AiaDirective_t directive,
+                                 AiaDirectiveHandler_t handler,
+                                 void* component, void* payload,
+                                 size_t payloadLength,
+                                 AiaSequenceNumber_t sequenceNumber,
+                                 size_t index )
+{
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    handler( component, payload, payloadLength, sequenceNumber, index );
+    AiaHistogram_Record(
+        &aiaDispatcher->directiveHandlingTimesMs[ directive ],
+        (uint32_t)( AiaClock( GetTimeMs )() - startMs ) );
+#else
+    (void)aiaDispatcher;
+    (void)directive;
+    handler( component, payload, payloadLength, sequenceNumber, index );
+#endif
+}
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+struct AiaDispatcherDirectiveBatch
+{
+    /** The dispatcher which received the message. */
+    AiaDispatcher_t* dispatcher;
+
+    /** The sequence number of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The number of queued directives, plus one while the message is still
+     * being parsed. This should only be accessed using atomic operations. */
+    uint32_t remaining;
+};
+
+/** A directive waiting to be run by an @c AiaDispatcherDirectiveWorker_t. */
+typedef struct AiaDispatcherQueuedDirective
+{
+    /** The node in @c AiaDispatcherDirectiveWorker_t::directives. */
+    AiaListDouble( Link_t ) link;
+
+    /** The handler to run the directive with. */
+    AiaDirectiveHandler_t handler;
+
+    /** The directive. */
+    AiaDirective_t directive;
+
+    /** The message the directive is part of. */
+    AiaDispatcherDirectiveBatch_t* batch;
+
+    /** Whether the directive has a payload. */
+    bool hasPayload;
+
+    /** The length of the payload, which follows this struct. */
+    size_t payloadLength;
+
+    /** The sequence number of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The index of the directive in the message. */
+    size_t index;
+} AiaDispatcherQueuedDirective_t;
+
+/** Runs the directives of one component in the order they were received. */
+typedef struct AiaDispatcherDirectiveWorker
+{
+    /** The component passed to the handlers of the directives. */
+    void* component;
+
+    /** Guards @c directives and @c isScheduled. */
+    AiaMutex_t mutex;
+
+    /** @c AiaDispatcherQueuedDirective_t waiting to be run, oldest first. */
+    AiaListDouble_t directives;
+
+    /** Whether @c timer has been armed and not yet emptied @c directives. */
+    bool isScheduled;
+
+    /** Runs the queued directives. */
+    AiaTimer_t timer;
+} AiaDispatcherDirectiveWorker_t;
+
+/**
+ * Starts a batch for the directives of one directive topic message.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param sequenceNumber Sequence number of the message.
+ * @return The batch, or @c NULL if the directives are to be run on the
+ * calling thread.
+ * @note Must be called with @c directiveMutex held.
+ */
+static AiaDispatcherDirectiveBatch_t* beginDirectiveBatch(
+    AiaDispatcher_t* aiaDispatcher, AiaSequenceNumber_t sequenceNumber )
+{
+    if( !aiaDispatcher->directiveWorkers )
+    {
+        return NULL;
+    }
+    AiaDispatcherDirectiveBatch_t* batch =
+        AiaCalloc( 1, sizeof( AiaDispatcherDirectiveBatch_t ) );
+    if( !batch )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     sizeof( AiaDispatcherDirectiveBatch_t ) );
+        return NULL;
+    }
+    batch->dispatcher = aiaDispatcher;
+    batch->sequenceNumber = sequenceNumber;
+    batch->remaining = 1;
+    return batch;
+}
+
+/**
+ * Releases one reference to a batch, calling the batch handler once the last
+ * one is released.
+ *
+ * @param batch The batch to release.
+ * @param callBatchHandler Whether to call the batch handler if this is the last
+ * reference.
+ */
+static void releaseDirectiveBatch( AiaDispatcherDirectiveBatch_t* batch,
+                                   bool callBatchHandler )
+{
+    if( AiaAtomic_Add_u32( &batch->remaining, UINT32_MAX ) != 1 )
+    {
+        return;
+    }
+    AiaDispatcher_t* aiaDispatcher = batch->dispatcher;
+    if( callBatchHandler && aiaDispatcher->directiveBatchHandler )
+    {
+        aiaDispatcher->directiveBatchHandler(
+            aiaDispatcher->directiveBatchHandlerUserData,
+            batch->sequenceNumber );
+    }
+    AiaFree( batch );
+}
+
+/**
+ * Finds the worker which runs the directives of a component.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param component The component to find the worker of.
+ * @return The worker, or @c NULL if @c component has none.
+ * @note Must be called with @c directiveMutex held.
+ */
+static AiaDispatcherDirectiveWorker_t* findDirectiveWorker(
+    AiaDispatcher_t* aiaDispatcher, void* component )
+{
+    for( size_t i = 0; i < aiaDispatcher->numDirectiveWorkers; ++i )
+    {
+        if( aiaDispatcher->directiveWorkers[ i ].component == component )
+        {
+            return &aiaDispatcher->directiveWorkers[ i ];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Copies a directive onto the queue of a worker and schedules the worker.
+ *
+ * @param worker The worker to run the directive.
+ * @param handler The handler to run the directive with.
+ * @param parsedDirective The directive.
+ * @param payload Payload for the directive handler, which may be @c NULL.
+ * @param payloadLength Length of @c payload.
+ * @param sequenceNumber Sequence number of the message.
+ * @param index Index of the directive in the message.
+ * @param batch The batch of the message.
+ * @return @c true if the directive was queued, else @c false.
+ */
+static bool queueDirective( AiaDispatcherDirectiveWorker_t* worker,
+                            AiaDirectiveHandler_t handler,
+                            AiaDirective_t parsedDirective,
+                            const char* payload, size_t payloadLength,
+                            AiaSequenceNumber_t sequenceNumber, size_t index,
+                            AiaDispatcherDirectiveBatch_t* batch )
+{
+    /* The payload is borrowed from the message, so it is copied along. */
+    size_t bytes = sizeof( AiaDispatcherQueuedDirective_t ) + payloadLength + 1;
+    AiaDispatcherQueuedDirective_t* directive = AiaCalloc( 1, bytes );
+    if( !directive )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu", bytes );
+        return false;
+    }
+    AiaListDouble( Link_t ) link = AiaListDouble( LINK_INITIALIZER );
+    directive->link = link;
+    directive->handler = handler;
+    directive->directive = parsedDirective;
+    directive->batch = batch;
+    directive->hasPayload = payload != NULL;
+    directive->payloadLength = payloadLength;
+    directive->sequenceNumber = sequenceNumber;
+    directive->index = index;
+    if( payload && payloadLength )
+    {
+        memcpy( directive + 1, payload, payloadLength );
+    }
+    AiaAtomic_Add_u32( &batch->remaining, 1 );
+
+    AiaMutex( Lock )( &worker->mutex );
+    AiaListDouble( InsertTail )( &worker->directives, &directive->link );
+    if( !worker->isScheduled )
+    {
+        worker->isScheduled = true;
+        if( !AiaTimer( Arm )( &worker->timer, 0, 0 ) )
+        {
+            /* The directive stays queued for the next one to run. */
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+            worker->isScheduled = false;
+        }
+    }
+    AiaMutex( Unlock )( &worker->mutex );
+    return true;
+}
+
+/**
+ * Runs a queued directive and releases it.
+ *
+ * @param directive The directive to run.
+ * @param component The component to pass to the handler.
+ */
+static void runQueuedDirective( AiaDispatcherQueuedDirective_t* directive,
+                                void* component )
+{
+    runDirectiveHandler(
+        directive->batch->dispatcher, directive->directive, directive->handler,
+        component, directive->hasPayload ? (void*)( directive + 1 ) : NULL,
+        directive->payloadLength, directive->sequenceNumber, directive->index );
+    releaseDirectiveBatch( directive->batch, true );
+    AiaFree( directive );
+}
+
+/**
+ * Called by @c AiaDispatcherDirectiveWorker_t::timer to run the directives
+ * queued to a worker, until there are none left.
+ *
+ * @param context The @c AiaDispatcherDirectiveWorker_t to act on.
+ */
+static void directiveWorkerRoutine( void* context )
+{
+    AiaDispatcherDirectiveWorker_t* worker =
+        (AiaDispatcherDirectiveWorker_t*)context;
+    while( true )
+    {
+        AiaMutex( Lock )( &worker->mutex );
+        AiaListDouble( Link_t )* link =
+            AiaListDouble( RemoveHead )( &worker->directives );
+        if( !link )
+        {
+            worker->isScheduled = false;
+            AiaMutex( Unlock )( &worker->mutex );
+            return;
+        }
+        AiaMutex( Unlock )( &worker->mutex );
+
+        /* Directives are run without holding the mutex, so that more can be
+         * queued meanwhile. */
+        runQueuedDirective( (AiaDispatcherQueuedDirective_t*)link,
+                            worker->component );
+    }
+}
+
+/**
+ * Stops and releases the workers of a dispatcher.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param runQueued Whether to run the directives still queued to the workers
+ * on the calling thread, or to discard them.
+ * @note Must be called with @c directiveMutex held.
+ */
+static void destroyDirectiveWorkers( AiaDispatcher_t* aiaDispatcher,
+                                     bool runQueued )
+{
+    for( size_t i = 0; i < aiaDispatcher->numDirectiveWorkers; ++i )
+    {
+        AiaDispatcherDirectiveWorker_t* worker =
+            &aiaDispatcher->directiveWorkers[ i ];
+
+        /* Waits for a running worker to empty its queue. */
+        AiaTimer( Destroy )( &worker->timer );
+        AiaListDouble( Link_t )* link;
+        while( ( link = AiaListDouble( RemoveHead )( &worker->directives ) ) )
+        {
+            AiaDispatcherQueuedDirective_t* directive =
+                (AiaDispatcherQueuedDirective_t*)link;
+            if( runQueued )
+            {
+                runQueuedDirective( directive, worker->component );
+            }
+            else
+            {
+                releaseDirectiveBatch( directive->batch, false );
+                AiaFree( directive );
+            }
+        }
+        AiaMutex( Destroy )( &worker->mutex );
+    }
+    AiaFree( aiaDispatcher->directiveWorkers );
+    aiaDispatcher->directiveWorkers = NULL;
+    aiaDispatcher->numDirectiveWorkers = 0;
+}
+
+/**
+ * Creates a worker for each component with directive handlers, other than the
+ * secret manager.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @return @c true if successful, else @c false.
+ * @note Must be called with @c directiveMutex held.
+ */
+static bool createDirectiveWorkers( AiaDispatcher_t* aiaDispatcher )
+{
+    aiaDispatcher->directiveWorkers = AiaCalloc(
+        AIA_NUM_DIRECTIVES, sizeof( AiaDispatcherDirectiveWorker_t ) );
+    if( !aiaDispatcher->directiveWorkers )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     AIA_NUM_DIRECTIVES *
+                         sizeof( AiaDispatcherDirectiveWorker_t ) );
+        return false;
+    }
+
+    for( size_t i = 0; i < AIA_NUM_DIRECTIVES; ++i )
+    {
+        void* component = aiaDispatcher->directiveHandlers[ i ].userData;
+        if( !aiaDispatcher->directiveHandlers[ i ].handler ||
+            component == (void*)aiaDispatcher->secretManager ||
+            findDirectiveWorker( aiaDispatcher, component ) )
+        {
+            continue;
+        }
+
+        AiaDispatcherDirectiveWorker_t* worker =
+            &aiaDispatcher->directiveWorkers[ aiaDispatcher
+                                                  ->numDirectiveWorkers ];
+        worker->component = component;
+        AiaListDouble( Create )( &worker->directives );
+        if( !AiaMutex( Create )( &worker->mutex, false ) )
+        {
+            AiaLogError( "AiaMutex( Create ) failed." );
+            destroyDirectiveWorkers( aiaDispatcher, false );
+            return false;
+        }
+        if( !AiaTimer( Create )( &worker->timer, directiveWorkerRoutine,
+                                 worker ) )
+        {
+            AiaLogError( "AiaTimer( Create ) failed." );
+            AiaMutex( Destroy )( &worker->mutex );
+            destroyDirectiveWorkers( aiaDispatcher, false );
+            return false;
+        }
+        ++aiaDispatcher->numDirectiveWorkers;
+    }
+    return true;
+}
+#endif
+
 /**
  * Calls the appropriate handler for a given directive received on the directive
  * topic.
@@ -193,13 +611,14 @@ static bool parseHeaderAndDecryptMessage(
  * @param payloadLength Lenght of @c payload not including the null terminator.
  * @param sequenceNumber Sequence number of the message to handle.
  * @param index Index of the message in an array of directives.
+ * @param batch The batch to queue the directive in, or @c NULL to run it on the
+ * calling thread.
  */
-static void dispatchDirectiveTopicMessage( AiaDispatcher_t* aiaDispatcher,
-                                           const char* name, size_t nameLength,
-                                           const char* payload,
-                                           size_t payloadLength,
-                                           AiaSequenceNumber_t sequenceNumber,
-                                           size_t index )
+static void dispatchDirectiveTopicMessage(
+    AiaDispatcher_t* aiaDispatcher, const char* name, size_t nameLength,
+    const char* payload, size_t payloadLength,
+    AiaSequenceNumber_t sequenceNumber, size_t index,
+    AiaDispatcherDirectiveBatch_t* batch )
 {
     /* Call the appropriate handler */
     /* TODO: ADSER-1734 Send ExceptionEncountered event for missing directive
@@ -210,159 +629,62 @@ static void dispatchDirectiveTopicMessage( AiaDispatcher_t* aiaDispatcher,
         AiaLogError( "Failed to parse directive from %.*s", nameLength, name );
         return;
     }
-    switch( parsedDirective )
+
+    const AiaDispatcherDirectiveHandler_t* directiveHandler =
+        &aiaDispatcher->directiveHandlers[ parsedDirective ];
+    if( !directiveHandler->handler )
     {
-        case AIA_DIRECTIVE_ROTATE_SECRET:
-            if( !aiaDispatcher->rotateSecretHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->rotateSecretHandler( aiaDispatcher->rotateSecretData,
-                                                (void*)payload, payloadLength,
-                                                sequenceNumber, index );
-            return;
-#ifdef AIA_ENABLE_CLOCK
-        case AIA_DIRECTIVE_SET_CLOCK:
-            if( !aiaDispatcher->setClockHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->setClockHandler( aiaDispatcher->setClockData,
-                                            (void*)payload, payloadLength,
-                                            sequenceNumber, index );
-            return;
-#endif
-        case AIA_DIRECTIVE_EXCEPTION:
-            if( !aiaDispatcher->exceptionHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->exceptionHandler( aiaDispatcher->exceptionData,
-                                             (void*)payload, payloadLength,
-                                             sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_SET_ATTENTION_STATE:
-            if( !aiaDispatcher->setAttentionStateHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->setAttentionStateHandler(
-                aiaDispatcher->setAttentionStateData, (void*)payload,
-                payloadLength, sequenceNumber, index );
-            return;
-#ifdef AIA_ENABLE_ALERTS
-        case AIA_DIRECTIVE_SET_ALERT_VOLUME:
-            if( !aiaDispatcher->setAlertVolumeHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->setAlertVolumeHandler(
-                aiaDispatcher->setAlertVolumeData, (void*)payload,
-                payloadLength, sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_SET_ALERT:
-            if( !aiaDispatcher->setAlertHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->setAlertHandler( aiaDispatcher->setAlertData,
-                                            (void*)payload, payloadLength,
-                                            sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_DELETE_ALERT:
-            if( !aiaDispatcher->deleteAlertHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->deleteAlertHandler( aiaDispatcher->deleteAlertData,
-                                               (void*)payload, payloadLength,
-                                               sequenceNumber, index );
-            return;
-#endif
-#ifdef AIA_ENABLE_SPEAKER
-        case AIA_DIRECTIVE_OPEN_SPEAKER:
-            if( !aiaDispatcher->openSpeakerHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->openSpeakerHandler( aiaDispatcher->openSpeakerData,
-                                               (void*)payload, payloadLength,
-                                               sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_CLOSE_SPEAKER:
-            if( !aiaDispatcher->closeSpeakerHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->closeSpeakerHandler( aiaDispatcher->closeSpeakerData,
-                                                (void*)payload, payloadLength,
-                                                sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_SET_VOLUME:
-            if( !aiaDispatcher->setVolumeHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->setVolumeHandler( aiaDispatcher->setVolumeData,
-                                             (void*)payload, payloadLength,
-                                             sequenceNumber, index );
-            return;
-#endif
-#ifdef AIA_ENABLE_MICROPHONE
-        case AIA_DIRECTIVE_OPEN_MICROPHONE:
-            if( !aiaDispatcher->openMicrophoneHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->openMicrophoneHandler(
-                aiaDispatcher->openMicrophoneData, (void*)payload,
-                payloadLength, sequenceNumber, index );
-            return;
-        case AIA_DIRECTIVE_CLOSE_MICROPHONE:
-            if( !aiaDispatcher->closeMicrophoneHandler )
-            {
-                AiaLogError( "Handler for directive %s not set yet",
-                             AiaDirective_ToString( parsedDirective ) );
-                return;
-            }
-            aiaDispatcher->closeMicrophoneHandler(
-                aiaDispatcher->closeMicrophoneData, (void*)payload,
-                payloadLength, sequenceNumber, index );
+        AiaLogError( "Handler for directive %s not set yet",
+                     AiaDirective_ToString( parsedDirective ) );
+        return;
+    }
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    if( batch )
+    {
+        AiaDispatcherDirectiveWorker_t* worker =
+            findDirectiveWorker( aiaDispatcher, directiveHandler->userData );
+        if( worker && queueDirective( worker, directiveHandler->handler,
+                                      parsedDirective, payload, payloadLength,
+                                      sequenceNumber, index, batch ) )
+        {
             return;
+        }
+    }
+#else
+    (void)batch;
 #endif
+    runDirectiveHandler( aiaDispatcher, parsedDirective,
+                         directiveHandler->handler, directiveHandler->userData,
+                         (void*)payload, payloadLength, sequenceNumber, index );
+}
+
+/**
+ * Calls the batch handler, if any, once the directives of a message received on
+ * the directive topic have been dispatched.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param sequenceNumber Sequence number of the message.
+ * @param batch The batch the directives were queued in, or @c NULL if they have
+ * all been run. The batch handler is then called once the last of them has
+ * run.
+ */
+static void finishDirectiveTopicMessage( AiaDispatcher_t* aiaDispatcher,
+                                         AiaSequenceNumber_t sequenceNumber,
+                                         AiaDispatcherDirectiveBatch_t* batch )
+{
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    if( batch )
+    {
+        releaseDirectiveBatch( batch, true );
+        return;
     }
-    AiaLogError( "Unknown directive name: %d", parsedDirective );
-    AiaJsonMessage_t* malformedMessageEvent =
-        generateMalformedMessageExceptionEncounteredEvent(
-            sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
-    if( !AiaRegulator_Write(
-            aiaDispatcher->regulator,
-            AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+#else
+    (void)batch;
+#endif
+    if( aiaDispatcher->directiveBatchHandler )
     {
-        AiaLogError( "Failed to write to regulator." );
-        AiaJsonMessage_Destroy( malformedMessageEvent );
+        aiaDispatcher->directiveBatchHandler(
+            aiaDispatcher->directiveBatchHandlerUserData, sequenceNumber );
     }
 }
 
@@ -415,6 +737,25 @@ static bool checkSequenceNumber( AiaDispatcher_t* aiaDispatcher,
     return true;
 }
 
+/**
+ * Releases a payload returned by @c validateAndDecryptMessage().
+ *
+ * @param dispatcher The @c AiaDispatcher_t the payload was decrypted by.
+ * @param decryptedPayload The decrypted payload to release.
+ * @param message The message @c decryptedPayload was decrypted from.
+ */
+static void releaseDecryptedPayload( AiaDispatcher_t* dispatcher,
+                                     uint8_t* decryptedPayload, void* message )
+{
+    /* Payloads decrypted in place are borrowed from the message. */
+    if( decryptedPayload != (uint8_t*)message )
+    {
+        /* Heap allocations are told apart from the arena's, so this is safe
+         * for payloads of every topic. */
+        AiaScratchArena_Free( dispatcher->directiveArena, decryptedPayload );
+    }
+}
+
 /**
  * Validates that the input message received on the given @c topic is large
  * enough, parses the common header, decrypts the encrypted payload and
@@ -432,8 +773,9 @@ static bool checkSequenceNumber( AiaDispatcher_t* aiaDispatcher,
  * @param[out] decryptedSequenceNumber Pointer to the decrypted sequence number
  * in @c message.
  *
- * @note It is the responsibility of the caller to call @c AiaFree() on @c
- * decryptedPayload if this function returns @c true.
+ * @note It is the responsibility of the caller to call @c
+ * releaseDecryptedPayload() on @c decryptedPayload if this function returns @c
+ * true.  The decrypted payload is null-terminated.
  *
  * @return @c true if @c message is validated successfully, else @c false.
  */
@@ -450,14 +792,10 @@ static bool validateAndDecryptMessage(
             "Received message is smaller than the encrypted sequence offset: "
             "%zu",
             size );
-        AiaJsonMessage_t* malformedMessageEvent =
-            generateMalformedMessageExceptionEncounteredEvent( 0, 0, topic );
-        if( !AiaRegulator_Write(
-                dispatcher->regulator,
-                AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0, topic ) )
         {
-            AiaLogError( "Failed to write to regulator." );
-            AiaJsonMessage_Destroy( malformedMessageEvent );
+            AiaLogError( "Failed to report malformed message." );
         }
         return false;
     }
@@ -467,12 +805,27 @@ static bool validateAndDecryptMessage(
         (uint8_t*)message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
     *encryptedSize = size - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
 
-    *decryptedPayload =
-        AiaCalloc( *encryptedSize, sizeof( encryptedPayload[ 0 ] ) );
-    if( !*decryptedPayload )
+    /* In place, the plaintext is written to the start of the message so that
+     * it trails the ciphertext by the size of the common header, which is
+     * copied out before decryption starts.  Either way, the plaintext is
+     * followed by at least one byte which is used as a null-terminator. */
+    if( AiaAtomicBool_Load( &dispatcher->decryptInPlace ) )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu", *encryptedSize );
-        return false;
+        *decryptedPayload = (uint8_t*)message;
+    }
+    else
+    {
+        /* Only the directive topic's sequencer thread uses the arena. */
+        AiaScratchArena_t* arena = topic == AIA_TOPIC_DIRECTIVE
+                                       ? dispatcher->directiveArena
+                                       : NULL;
+        *decryptedPayload = AiaScratchArena_Calloc(
+            arena, *encryptedSize + 1, sizeof( encryptedPayload[ 0 ] ) );
+        if( !*decryptedPayload )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu", *encryptedSize + 1 );
+            return false;
+        }
     }
 
     if( !parseHeaderAndDecryptMessage( dispatcher, (uint8_t*)message, size,
@@ -480,7 +833,7 @@ static bool validateAndDecryptMessage(
                                        decryptedPayload, sequenceNumber ) )
     {
         AiaLogError( "Failed to decrypt sequenced data" );
-        AiaFree( *decryptedPayload );
+        releaseDecryptedPayload( dispatcher, *decryptedPayload, message );
         if( !AiaConnectionManager_Disconnect(
                 dispatcher->connectionManager,
                 AIA_CONNECTION_DISCONNECT_ENCRYPTION_ERROR,
@@ -499,16 +852,17 @@ static bool validateAndDecryptMessage(
                                     NULL ) )
     {
         AiaLogError( "Failed to get the sequence number." );
-        AiaFree( *decryptedPayload );
+        releaseDecryptedPayload( dispatcher, *decryptedPayload, message );
         return false;
     }
     if( !checkSequenceNumber( dispatcher, *sequenceNumber,
                               *decryptedSequenceNumber ) )
     {
         AiaLogError( "Sequence number checking failed." );
-        AiaFree( *decryptedPayload );
+        releaseDecryptedPayload( dispatcher, *decryptedPayload, message );
         return false;
     }
+    ( *decryptedPayload )[ *encryptedSize ] = '\0';
 
     return true;
 }
@@ -585,62 +939,61 @@ static bool parseMessageFields( const char* messageToParse, const char** name,
 }
 
 /**
- * Sequencer callback for sequenced messages on the directive topic.
+ * Passes the plaintext of a message to the plaintext observer, if one is set.
  *
- * @param message Input buffer holding common header and encrypted data.
- * @param size Size of the @c message buffer.
- * @param userData User data associated with this callback.
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param topic The topic of the message.
+ * @param sequenceNumber The sequence number of the message, or zero for
+ * unsequenced topics.
+ * @param plaintext The plaintext of the message.
+ * @param size The size of @c plaintext.
  */
-static void directiveMessageSequencedCallback( void* message, size_t size,
-                                               void* userData )
+static void observePlaintext( AiaDispatcher_t* aiaDispatcher, AiaTopic_t topic,
+                              AiaSequenceNumber_t sequenceNumber,
+                              const void* plaintext, size_t size )
 {
-    if( !message )
-    {
-        AiaLogError( "Null message." );
-        return;
-    }
-    if( !userData )
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    if( aiaDispatcher->plaintextObserver )
     {
-        AiaLogError( "Null userData." );
-        return;
+        aiaDispatcher->plaintextObserver( topic, sequenceNumber, plaintext,
+                                          size,
+                                          aiaDispatcher->plaintextUserData );
     }
+#else
+    (void)aiaDispatcher;
+    (void)topic;
+    (void)sequenceNumber;
+    (void)plaintext;
+    (void)size;
+#endif
+}
 
-    AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
-
-    const char *name = NULL, *messageId = NULL, *payload = NULL,
-               *textToParse = NULL;
+/**
+ * Parses the plaintext of a directive topic message and passes each of its
+ * directives to their handlers.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param textToParse The null-terminated plaintext of the message.
+ * @param textLength The length of @c textToParse.
+ * @param sequenceNumber The sequence number of the message.
+ * @note Must be called with @c directiveMutex held.
+ */
+static void handleDirectiveTopicPlaintext( AiaDispatcher_t* aiaDispatcher,
+                                           const char* textToParse,
+                                           size_t textLength,
+                                           AiaSequenceNumber_t sequenceNumber )
+{
+    const char *name = NULL, *messageId = NULL, *payload = NULL;
     size_t nameLength = 0, messageIdLength = 0, payloadLength = 0;
 
-    AiaLogDebug( "Message on directive topic sequenced" );
-
-    /* Validate the payload */
-    size_t encryptedSize = 0;
-    uint8_t* decryptedPayload = NULL;
-    AiaSequenceNumber_t sequenceNumber = 0, decryptedSequenceNumber = 0;
-
-    if( !validateAndDecryptMessage( aiaDispatcher, AIA_TOPIC_DIRECTIVE, message,
-                                    size, &decryptedPayload, &encryptedSize,
-                                    &sequenceNumber,
-                                    &decryptedSequenceNumber ) )
-    {
-        AiaLogError( "Failed to validate the payload" );
-        return;
-    }
-
-    /* Assign parsed text to the decrypted-sequenced payload */
-    size_t bytePosition = sizeof( AiaSequenceNumber_t );
-    textToParse = (char*)decryptedPayload + bytePosition;
-
-    /* TODO: ADSER-1986 Selectively choose which directives are sensitive. */
-    AiaLogSensitive( "Parsing %.*s", encryptedSize - bytePosition,
-                     textToParse );
+    /* TODO: ADSER-1986 Selectively choose which directives are sensitive. */
+    AiaLogSensitive( "Parsing %.*s", textLength, textToParse );
 
     /* Get the topic array name */
     const char* arrayName = AiaTopic_GetJsonArrayName( AIA_TOPIC_DIRECTIVE );
     if( !arrayName )
     {
         AiaLogError( "Failed to get array name for the directive topic" );
-        AiaFree( decryptedPayload );
         return;
     }
 
@@ -650,32 +1003,45 @@ static void directiveMessageSequencedCallback( void* message, size_t size,
     /* Extract the array. */
     const char* array;
     size_t arrayLength;
-    if( !AiaFindJsonValue( textToParse, encryptedSize - bytePosition, arrayName,
+    if( !AiaFindJsonValue( textToParse, textLength, arrayName,
                            arrayNameLength, &array, &arrayLength ) )
     {
         AiaLogError( "Could not find \"%.*s\" array in message.",
                      arrayNameLength, arrayName );
-        AiaJsonMessage_t* malformedMessageEvent =
-            generateMalformedMessageExceptionEncounteredEvent(
-                sequenceNumber, 0, AIA_TOPIC_DIRECTIVE );
-        if( !AiaRegulator_Write(
-                aiaDispatcher->regulator,
-                AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                aiaDispatcher->exceptionLimiter, sequenceNumber, 0,
+                AIA_TOPIC_DIRECTIVE ) )
         {
-            AiaLogError( "Failed to write to regulator." );
-            AiaJsonMessage_Destroy( malformedMessageEvent );
+            AiaLogError( "Failed to report malformed message." );
         }
-        AiaFree( decryptedPayload );
         return;
     }
 
+    AiaJsonArrayIterator_t iterator;
     const char* arrayElement;
     size_t arrayElementLength;
     size_t index = 0;
-    /* TODO: ADSER-1654 Rework AiaJsonUtils_GetArrayElement() so that it can be
-     * used iteratively */
-    while( AiaJsonUtils_GetArrayElement( array, arrayLength, index,
-                                         &arrayElement, &arrayElementLength ) )
+    if( !AiaJsonArrayIterator_Initialize( &iterator, array, arrayLength ) )
+    {
+        AiaLogError( "Invalid \"%.*s\" array in message.", arrayNameLength,
+                     arrayName );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                aiaDispatcher->exceptionLimiter, sequenceNumber, 0,
+                AIA_TOPIC_DIRECTIVE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        return;
+    }
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    AiaDispatcherDirectiveBatch_t* batch =
+        beginDirectiveBatch( aiaDispatcher, sequenceNumber );
+#else
+    AiaDispatcherDirectiveBatch_t* batch = NULL;
+#endif
+    while( AiaJsonArrayIterator_Next( &iterator, &arrayElement,
+                                      &arrayElementLength ) )
     {
         /* Parse individual message fields */
         if( !parseMessageFields( arrayElement, &name, &messageId, &payload,
@@ -683,17 +1049,14 @@ static void directiveMessageSequencedCallback( void* message, size_t size,
                                  &payloadLength ) )
         {
             AiaLogError( "Failed to parse message fields." );
-            AiaJsonMessage_t* malformedMessageEvent =
-                generateMalformedMessageExceptionEncounteredEvent(
-                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
-            if( !AiaRegulator_Write(
-                    aiaDispatcher->regulator,
-                    AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+            if( !AiaExceptionLimiter_ReportMalformedMessage(
+                    aiaDispatcher->exceptionLimiter, sequenceNumber, index,
+                    AIA_TOPIC_DIRECTIVE ) )
             {
-                AiaLogError( "Failed to write to regulator." );
-                AiaJsonMessage_Destroy( malformedMessageEvent );
+                AiaLogError( "Failed to report malformed message." );
             }
-            AiaFree( decryptedPayload );
+            finishDirectiveTopicMessage( aiaDispatcher, sequenceNumber,
+                                         batch );
             return;
         }
 
@@ -703,17 +1066,14 @@ static void directiveMessageSequencedCallback( void* message, size_t size,
             AiaLogError(
                 "Failed to unquote the directive name, messageId: %.*s",
                 messageIdLength, messageId );
-            AiaJsonMessage_t* malformedMessageEvent =
-                generateMalformedMessageExceptionEncounteredEvent(
-                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
-            if( !AiaRegulator_Write(
-                    aiaDispatcher->regulator,
-                    AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+            if( !AiaExceptionLimiter_ReportMalformedMessage(
+                    aiaDispatcher->exceptionLimiter, sequenceNumber, index,
+                    AIA_TOPIC_DIRECTIVE ) )
             {
-                AiaLogError( "Failed to write to regulator." );
-                AiaJsonMessage_Destroy( malformedMessageEvent );
+                AiaLogError( "Failed to report malformed message." );
             }
-            AiaFree( decryptedPayload );
+            finishDirectiveTopicMessage( aiaDispatcher, sequenceNumber,
+                                         batch );
             return;
         }
 
@@ -723,25 +1083,36 @@ static void directiveMessageSequencedCallback( void* message, size_t size,
                          messageId, payloadLength, payload );
 
         dispatchDirectiveTopicMessage( aiaDispatcher, name, nameLength, payload,
-                                       payloadLength, decryptedSequenceNumber,
-                                       index );
+                                       payloadLength, sequenceNumber, index,
+                                       batch );
 
         index++;
     }
 
-    AiaFree( decryptedPayload );
+    if( !iterator.complete )
+    {
+        AiaLogError( "Malformed \"%.*s\" array element, index=%zu.",
+                     arrayNameLength, arrayName, index );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                aiaDispatcher->exceptionLimiter, sequenceNumber, index,
+                AIA_TOPIC_DIRECTIVE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+    }
+
+    finishDirectiveTopicMessage( aiaDispatcher, sequenceNumber, batch );
 }
 
 /**
- * Sequencer callback for sequenced messages on the capabilities acknowledge
- * topic.
+ * Sequencer callback for sequenced messages on the directive topic.
  *
  * @param message Input buffer holding common header and encrypted data.
  * @param size Size of the @c message buffer.
  * @param userData User data associated with this callback.
  */
-static void capabilitiesMessageSequencedCallback( void* message, size_t size,
-                                                  void* userData )
+static void directiveMessageSequencedCallback( void* message, size_t size,
+                                               void* userData )
 {
     if( !message )
     {
@@ -756,20 +1127,20 @@ static void capabilitiesMessageSequencedCallback( void* message, size_t size,
 
     AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
 
-    const char *name = NULL, *messageId = NULL, *payload = NULL,
-               *textToParse = NULL;
-    size_t nameLength = 0, messageIdLength = 0, payloadLength = 0;
+    AiaLogDebug( "Message on directive topic sequenced" );
 
-    AiaLogDebug( "Message on capabilities acknowledge sequenced" );
+    /* Nothing allocated while handling the previous message outlives it. */
+    AiaScratchArena_Reset( aiaDispatcher->directiveArena );
 
     /* Validate the payload */
     size_t encryptedSize = 0;
     uint8_t* decryptedPayload = NULL;
     AiaSequenceNumber_t sequenceNumber = 0, decryptedSequenceNumber = 0;
-    if( !validateAndDecryptMessage(
-            aiaDispatcher, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE, message, size,
-            &decryptedPayload, &encryptedSize, &sequenceNumber,
-            &decryptedSequenceNumber ) )
+
+    if( !validateAndDecryptMessage( aiaDispatcher, AIA_TOPIC_DIRECTIVE, message,
+                                    size, &decryptedPayload, &encryptedSize,
+                                    &sequenceNumber,
+                                    &decryptedSequenceNumber ) )
     {
         AiaLogError( "Failed to validate the payload" );
         return;
@@ -777,26 +1148,93 @@ static void capabilitiesMessageSequencedCallback( void* message, size_t size,
 
     /* Assign parsed text to the decrypted-sequenced payload */
     size_t bytePosition = sizeof( AiaSequenceNumber_t );
-    textToParse = (char*)decryptedPayload + bytePosition;
+    const char* textToParse = (char*)decryptedPayload + bytePosition;
+
+    observePlaintext( aiaDispatcher, AIA_TOPIC_DIRECTIVE,
+                      decryptedSequenceNumber, textToParse,
+                      encryptedSize - bytePosition );
+    handleDirectiveTopicPlaintext( aiaDispatcher, textToParse,
+                                   encryptedSize - bytePosition,
+                                   decryptedSequenceNumber );
+    releaseDecryptedPayload( aiaDispatcher, decryptedPayload, message );
+}
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/**
+ * Sequencer callback for sequenced messages on the directive topic which were
+ * decrypted while they were buffered.
+ *
+ * @param plaintext The decrypted payload, starting with the decrypted sequence
+ * number and followed by a null-terminator.
+ * @param size Size of @c plaintext, not including the null-terminator.
+ * @param userData User data associated with this callback.
+ */
+static void directivePreparedSequencedCallback( void* plaintext, size_t size,
+                                                void* userData )
+{
+    if( !plaintext )
+    {
+        AiaLogError( "Null plaintext." );
+        return;
+    }
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return;
+    }
+
+    AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
+
+    AiaLogDebug( "Decrypted message on directive topic sequenced" );
+
+    /* Nothing allocated while handling the previous message outlives it. */
+    AiaScratchArena_Reset( aiaDispatcher->directiveArena );
+
+    AiaSequenceNumber_t sequenceNumber = 0;
+    if( !getSequenceNumberCallback( &sequenceNumber, plaintext, size, NULL ) )
+    {
+        AiaLogError( "Failed to get the sequence number." );
+        return;
+    }
+    size_t bytePosition = sizeof( AiaSequenceNumber_t );
+    const char* textToParse = (char*)plaintext + bytePosition;
+
+    observePlaintext( aiaDispatcher, AIA_TOPIC_DIRECTIVE, sequenceNumber,
+                      textToParse, size - bytePosition );
+    handleDirectiveTopicPlaintext( aiaDispatcher, textToParse,
+                                   size - bytePosition, sequenceNumber );
+}
+#endif
+
+/**
+ * Parses the plaintext of a capabilities acknowledge topic message and passes
+ * it to the capabilities sender.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param textToParse The null-terminated plaintext of the message.
+ * @param textLength The length of @c textToParse.
+ * @param sequenceNumber The sequence number of the message.
+ */
+static void handleCapabilitiesAcknowledgePlaintext(
+    AiaDispatcher_t* aiaDispatcher, const char* textToParse, size_t textLength,
+    AiaSequenceNumber_t sequenceNumber )
+{
+    const char *name = NULL, *messageId = NULL, *payload = NULL;
+    size_t nameLength = 0, messageIdLength = 0, payloadLength = 0;
 
-    AiaLogDebug( "Parsing %.*s", encryptedSize - bytePosition, textToParse );
+    AiaLogDebug( "Parsing %.*s", textLength, textToParse );
 
     /* Parse individual message fields */
     if( !parseMessageFields( textToParse, &name, &messageId, &payload,
                              &nameLength, &messageIdLength, &payloadLength ) )
     {
         AiaLogError( "Failed to parse message fields." );
-        AiaJsonMessage_t* malformedMessageEvent =
-            generateMalformedMessageExceptionEncounteredEvent(
-                sequenceNumber, 0, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE );
-        if( !AiaRegulator_Write(
-                aiaDispatcher->regulator,
-                AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                aiaDispatcher->exceptionLimiter, sequenceNumber, 0,
+                AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE ) )
         {
-            AiaLogError( "Failed to write to regulator." );
-            AiaJsonMessage_Destroy( malformedMessageEvent );
+            AiaLogError( "Failed to report malformed message." );
         }
-        AiaFree( decryptedPayload );
         return;
     }
 
@@ -806,11 +1244,171 @@ static void capabilitiesMessageSequencedCallback( void* message, size_t size,
 
     AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
         aiaDispatcher->capabilitiesSender, payload, payloadLength );
+}
+
+/**
+ * Sequencer callback for sequenced messages on the capabilities acknowledge
+ * topic.
+ *
+ * @param message Input buffer holding common header and encrypted data.
+ * @param size Size of the @c message buffer.
+ * @param userData User data associated with this callback.
+ */
+static void capabilitiesMessageSequencedCallback( void* message, size_t size,
+                                                  void* userData )
+{
+    if( !message )
+    {
+        AiaLogError( "Null message." );
+        return;
+    }
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return;
+    }
+
+    AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
+
+    AiaLogDebug( "Message on capabilities acknowledge sequenced" );
 
-    AiaFree( decryptedPayload );
+    /* Validate the payload */
+    size_t encryptedSize = 0;
+    uint8_t* decryptedPayload = NULL;
+    AiaSequenceNumber_t sequenceNumber = 0, decryptedSequenceNumber = 0;
+    if( !validateAndDecryptMessage(
+            aiaDispatcher, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE, message, size,
+            &decryptedPayload, &encryptedSize, &sequenceNumber,
+            &decryptedSequenceNumber ) )
+    {
+        AiaLogError( "Failed to validate the payload" );
+        return;
+    }
+
+    /* Assign parsed text to the decrypted-sequenced payload */
+    size_t bytePosition = sizeof( AiaSequenceNumber_t );
+    const char* textToParse = (char*)decryptedPayload + bytePosition;
+
+    observePlaintext( aiaDispatcher, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
+                      decryptedSequenceNumber, textToParse,
+                      encryptedSize - bytePosition );
+    handleCapabilitiesAcknowledgePlaintext( aiaDispatcher, textToParse,
+                                            encryptedSize - bytePosition,
+                                            decryptedSequenceNumber );
+    releaseDecryptedPayload( aiaDispatcher, decryptedPayload, message );
 }
 
 #ifdef AIA_ENABLE_SPEAKER
+/** A speaker topic message being decrypted by @c decryptSpeakerMessage(). */
+typedef struct AiaDispatcherSpeakerMessage
+{
+    /** The dispatcher which received the message. */
+    AiaDispatcher_t* dispatcher;
+
+    /** The message, starting with the common header. */
+    const uint8_t* message;
+
+    /** The unencrypted sequence number of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+} AiaDispatcherSpeakerMessage_t;
+
+/**
+ * Decrypts a speaker topic message directly into the regions provided by the
+ * speaker manager. The encrypted sequence number is decrypted aside and checked
+ * against the unencrypted one.
+ *
+ * @param regions The regions which receive the unencrypted Binary Stream.
+ * @param numRegions The number of entries in @c regions.
+ * @param userData The @c AiaDispatcherSpeakerMessage_t to decrypt.
+ * @return @c true if the message was decrypted and its sequence numbers match,
+ * else @c false.
+ */
+static bool decryptSpeakerMessage(
+    const AiaSpeakerManagerPlaintextRegion_t* regions, size_t numRegions,
+    void* userData )
+{
+    AiaDispatcherSpeakerMessage_t* speakerMessage =
+        (AiaDispatcherSpeakerMessage_t*)userData;
+    const uint8_t* iv = speakerMessage->message + sizeof( AiaSequenceNumber_t );
+    const uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    const uint8_t* encryptedData =
+        speakerMessage->message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+
+    uint8_t decryptedSequenceNumber[ sizeof( AiaSequenceNumber_t ) ];
+    AiaCryptoSegment_t segments[ numRegions + 1 ];
+    segments[ 0 ].input = encryptedData;
+    segments[ 0 ].output = decryptedSequenceNumber;
+    segments[ 0 ].length = sizeof( decryptedSequenceNumber );
+    encryptedData += sizeof( decryptedSequenceNumber );
+    for( size_t i = 0; i < numRegions; ++i )
+    {
+        segments[ i + 1 ].input = encryptedData;
+        segments[ i + 1 ].output = regions[ i ].data;
+        segments[ i + 1 ].length = regions[ i ].size;
+        encryptedData += regions[ i ].size;
+    }
+
+    AiaTrace_Begin( AIA_TRACE_SPEAKER_DECRYPT, speakerMessage->sequenceNumber,
+                    AIA_TRACE_OFFSET_UNKNOWN );
+    bool decrypted = AiaSecretManager_DecryptSegments(
+        speakerMessage->dispatcher->secretManager, AIA_TOPIC_SPEAKER,
+        speakerMessage->sequenceNumber, segments, numRegions + 1, iv,
+        AIA_COMMON_HEADER_IV_SIZE, mac, AIA_COMMON_HEADER_MAC_SIZE );
+    AiaTrace_End( AIA_TRACE_SPEAKER_DECRYPT, speakerMessage->sequenceNumber,
+                  AIA_TRACE_OFFSET_UNKNOWN );
+    if( !decrypted )
+    {
+        return false;
+    }
+
+    AiaSequenceNumber_t sequenceNumber = 0;
+    return getSequenceNumberCallback( &sequenceNumber, decryptedSequenceNumber,
+                                      sizeof( decryptedSequenceNumber ),
+                                      NULL ) &&
+           sequenceNumber == speakerMessage->sequenceNumber;
+}
+
+/**
+ * Hands a sequenced speaker topic message to the speaker manager before it is
+ * decrypted, so that its audio can be decrypted straight into the speaker
+ * buffer rather than through an intermediate payload.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param message Input buffer holding common header and encrypted data.
+ * @param size Size of the @c message buffer.
+ * @return @c true if the speaker manager handled the message, or @c false if it
+ * must be decrypted with @c validateAndDecryptMessage() instead. Failures to
+ * decrypt are left to that path to report.
+ */
+static bool writeSpeakerMessageDirectly( AiaDispatcher_t* aiaDispatcher,
+                                         void* message, size_t size )
+{
+    if( !aiaDispatcher->speakerManager || size <= AIA_SIZE_OF_COMMON_HEADER )
+    {
+        return false;
+    }
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    /* Audio written straight into the speaker buffer may wrap around it, so
+     * it is only observable as one plaintext when decrypted aside. */
+    if( aiaDispatcher->plaintextObserver )
+    {
+        return false;
+    }
+#endif
+
+    AiaDispatcherSpeakerMessage_t speakerMessage;
+    speakerMessage.dispatcher = aiaDispatcher;
+    speakerMessage.message = (const uint8_t*)message;
+    if( !getSequenceNumberCallback( &speakerMessage.sequenceNumber, message,
+                                    size, NULL ) )
+    {
+        return false;
+    }
+    return AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+        aiaDispatcher->speakerManager, size - AIA_SIZE_OF_COMMON_HEADER,
+        speakerMessage.sequenceNumber, decryptSpeakerMessage, &speakerMessage );
+}
+
 /**
  * Sequencer callback for sequenced messages on the speaker topic.
  *
@@ -835,39 +1433,69 @@ static void speakerMessageSequencedCallback( void* message, size_t size,
     AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
 
     AiaLogDebug( "Message on speaker topic sequenced" );
+    AiaTrace_End( AIA_TRACE_SPEAKER_SEQUENCE,
+                  peekSequenceNumber( message, size ),
+                  AIA_TRACE_OFFSET_UNKNOWN );
+
+    if( writeSpeakerMessageDirectly( aiaDispatcher, message, size ) )
+    {
+        return;
+    }
 
     /* Validate the payload */
     size_t encryptedSize = 0;
     uint8_t* decryptedPayload = NULL;
     AiaSequenceNumber_t sequenceNumber = 0, decryptedSequenceNumber = 0;
+    AiaTrace_Begin( AIA_TRACE_SPEAKER_DECRYPT,
+                    peekSequenceNumber( message, size ),
+                    AIA_TRACE_OFFSET_UNKNOWN );
     if( !validateAndDecryptMessage(
             aiaDispatcher, AIA_TOPIC_SPEAKER, message, size, &decryptedPayload,
             &encryptedSize, &sequenceNumber, &decryptedSequenceNumber ) )
     {
         AiaLogError( "Failed to validate the payload" );
+        AiaTrace_End( AIA_TRACE_SPEAKER_DECRYPT,
+                      peekSequenceNumber( message, size ),
+                      AIA_TRACE_OFFSET_UNKNOWN );
         return;
     }
+    AiaTrace_End( AIA_TRACE_SPEAKER_DECRYPT, sequenceNumber,
+                  AIA_TRACE_OFFSET_UNKNOWN );
 
     /* Advance bytePosition to point at the offset of data in decrypted payload
      */
     size_t bytePosition = sizeof( AiaSequenceNumber_t );
 
+    observePlaintext( aiaDispatcher, AIA_TOPIC_SPEAKER, decryptedSequenceNumber,
+                      decryptedPayload + bytePosition,
+                      encryptedSize - bytePosition );
+
     /* Call the appropriate handler */
     AiaSpeakerManager_OnSpeakerTopicMessageReceived(
         aiaDispatcher->speakerManager, decryptedPayload + bytePosition,
         encryptedSize - bytePosition, decryptedSequenceNumber );
 
-    AiaFree( decryptedPayload );
+    releaseDecryptedPayload( aiaDispatcher, decryptedPayload, message );
 }
-#endif
 
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
 /**
- * Sequencer timeout callback for messages written to the sequencer.
+ * Sequencer callback for sequenced messages on the speaker topic which were
+ * decrypted while they were buffered.
  *
+ * @param plaintext The decrypted payload, starting with the decrypted sequence
+ * number.
+ * @param size Size of @c plaintext.
  * @param userData User data associated with this callback.
  */
-static void sequencerTimedoutCallback( void* userData )
+static void speakerPreparedSequencedCallback( void* plaintext, size_t size,
+                                              void* userData )
 {
+    if( !plaintext )
+    {
+        AiaLogError( "Null plaintext." );
+        return;
+    }
     if( !userData )
     {
         AiaLogError( "Null userData." );
@@ -876,15 +1504,868 @@ static void sequencerTimedoutCallback( void* userData )
 
     AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
 
-    AiaLogDebug( "Timed out waiting to sequence message" );
+    AiaLogDebug( "Decrypted message on speaker topic sequenced" );
 
-    if( !AiaConnectionManager_Disconnect(
-            aiaDispatcher->connectionManager,
-            AIA_CONNECTION_DISCONNECT_UNEXPECTED_SEQUENCE_NUMBER,
-            "Timed out waiting to sequence message" ) )
+    AiaSequenceNumber_t sequenceNumber = 0;
+    if( !getSequenceNumberCallback( &sequenceNumber, plaintext, size, NULL ) )
     {
-        AiaLogError( "Failed to disconnect." );
+        AiaLogError( "Failed to get the sequence number." );
+        return;
+    }
+    AiaTrace_End( AIA_TRACE_SPEAKER_SEQUENCE, sequenceNumber,
+                  AIA_TRACE_OFFSET_UNKNOWN );
+    size_t bytePosition = sizeof( AiaSequenceNumber_t );
+
+    observePlaintext( aiaDispatcher, AIA_TOPIC_SPEAKER, sequenceNumber,
+                      (uint8_t*)plaintext + bytePosition,
+                      size - bytePosition );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        aiaDispatcher->speakerManager, (uint8_t*)plaintext + bytePosition,
+        size - bytePosition, sequenceNumber );
+}
+#endif
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/** A copy of a message buffered ahead of sequence, waiting to be decrypted. */
+typedef struct AiaDispatcherSpeculativeMessage
+{
+    /** The node in @c AiaDispatcherSpeculation_t::messages. */
+    AiaListDouble( Link_t ) link;
+
+    /** The topic the message was received on. */
+    AiaTopic_t topic;
+
+    /** The unencrypted sequence number of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The size of the message, which follows this struct. */
+    size_t size;
+} AiaDispatcherSpeculativeMessage_t;
+
+/** Decrypts messages buffered by the sequencers ahead of sequence. */
+typedef struct AiaDispatcherSpeculation
+{
+    /** The dispatcher whose sequencers buffer the messages. */
+    AiaDispatcher_t* dispatcher;
+
+    /** Guards @c messages and @c isScheduled. */
+    AiaMutex_t mutex;
+
+    /** @c AiaDispatcherSpeculativeMessage_t waiting to be decrypted, oldest
+     * first. */
+    AiaListDouble_t messages;
+
+    /** Whether @c timer has been armed and not yet emptied @c messages. */
+    bool isScheduled;
+
+    /** Decrypts the queued messages. */
+    AiaTimer_t timer;
+} AiaDispatcherSpeculation_t;
+
+/**
+ * Copies a message buffered ahead of sequence onto the queue of messages to
+ * decrypt and schedules the worker.
+ *
+ * @param speculation The @c AiaDispatcherSpeculation_t to act on.
+ * @param topic The topic the message was received on.
+ * @param message The message, starting with the common header.
+ * @param size Size of @c message.
+ * @param sequenceNumber The unencrypted sequence number of the message.
+ */
+static void queueSpeculativeMessage( AiaDispatcherSpeculation_t* speculation,
+                                     AiaTopic_t topic, const void* message,
+                                     size_t size,
+                                     AiaSequenceNumber_t sequenceNumber )
+{
+    /* Messages too small to hold a common header are left to fail in order. */
+    if( size < AIA_SIZE_OF_COMMON_HEADER )
+    {
+        return;
+    }
+    size_t bytes = sizeof( AiaDispatcherSpeculativeMessage_t ) + size;
+    AiaDispatcherSpeculativeMessage_t* speculativeMessage =
+        AiaCalloc( 1, bytes );
+    if( !speculativeMessage )
+    {
+        /* The message is decrypted once sequenced instead. */
+        AiaLogWarn( "AiaCalloc failed, bytes=%zu", bytes );
+        return;
+    }
+    AiaListDouble( Link_t ) link = AiaListDouble( LINK_INITIALIZER );
+    speculativeMessage->link = link;
+    speculativeMessage->topic = topic;
+    speculativeMessage->sequenceNumber = sequenceNumber;
+    speculativeMessage->size = size;
+    memcpy( speculativeMessage + 1, message, size );
+
+    AiaMutex( Lock )( &speculation->mutex );
+    AiaListDouble( InsertTail )( &speculation->messages,
+                                 &speculativeMessage->link );
+    if( !speculation->isScheduled )
+    {
+        speculation->isScheduled = true;
+        if( !AiaTimer( Arm )( &speculation->timer, 0, 0 ) )
+        {
+            /* The message stays queued for the next one to decrypt. */
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+            speculation->isScheduled = false;
+        }
+    }
+    AiaMutex( Unlock )( &speculation->mutex );
+}
+
+/**
+ * Sequencer callback for messages buffered ahead of sequence on the directive
+ * topic.
+ *
+ * @param message The message, starting with the common header.
+ * @param size Size of @c message.
+ * @param sequenceNumber The unencrypted sequence number of the message.
+ * @param userData The @c AiaDispatcherSpeculation_t to queue the message to.
+ */
+static void prepareDirectiveMessage( void* message, size_t size,
+                                     AiaSequenceNumber_t sequenceNumber,
+                                     void* userData )
+{
+    queueSpeculativeMessage( (AiaDispatcherSpeculation_t*)userData,
+                             AIA_TOPIC_DIRECTIVE, message, size,
+                             sequenceNumber );
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/**
+ * Sequencer callback for messages buffered ahead of sequence on the speaker
+ * topic.
+ *
+ * @param message The message, starting with the common header.
+ * @param size Size of @c message.
+ * @param sequenceNumber The unencrypted sequence number of the message.
+ * @param userData The @c AiaDispatcherSpeculation_t to queue the message to.
+ */
+static void prepareSpeakerMessage( void* message, size_t size,
+                                   AiaSequenceNumber_t sequenceNumber,
+                                   void* userData )
+{
+    queueSpeculativeMessage( (AiaDispatcherSpeculation_t*)userData,
+                             AIA_TOPIC_SPEAKER, message, size,
+                             sequenceNumber );
+}
+#endif
+
+/**
+ * Decrypts a queued message and, if it is still buffered, hands its plaintext
+ * to the sequencer of its topic. Messages which cannot be decrypted ahead are
+ * dropped silently, since they are decrypted and any failure is reported once
+ * they are sequenced.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param speculativeMessage The message to decrypt.
+ */
+static void decryptSpeculativeMessage(
+    AiaDispatcher_t* aiaDispatcher,
+    const AiaDispatcherSpeculativeMessage_t* speculativeMessage )
+{
+    const uint8_t* message = (const uint8_t*)( speculativeMessage + 1 );
+    const uint8_t* iv = message + sizeof( AiaSequenceNumber_t );
+    const uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    size_t encryptedSize =
+        speculativeMessage->size - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+
+    /* The plaintext is null-terminated, as decrypted payloads are. */
+    uint8_t* plaintext = AiaCalloc( encryptedSize + 1, sizeof( uint8_t ) );
+    if( !plaintext )
+    {
+        AiaLogWarn( "AiaCalloc failed, bytes=%zu", encryptedSize + 1 );
+        return;
+    }
+    AiaSequenceNumber_t decryptedSequenceNumber = 0;
+    if( !AiaSecretManager_DecryptAhead(
+            aiaDispatcher->secretManager, speculativeMessage->topic,
+            speculativeMessage->sequenceNumber,
+            message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+            encryptedSize, plaintext, iv, AIA_COMMON_HEADER_IV_SIZE, mac,
+            AIA_COMMON_HEADER_MAC_SIZE ) ||
+        !getSequenceNumberCallback( &decryptedSequenceNumber, plaintext,
+                                    encryptedSize, NULL ) ||
+        decryptedSequenceNumber != speculativeMessage->sequenceNumber )
+    {
+        AiaLogDebug( "Not decrypted ahead, sequenceNumber=%" PRIu32,
+                     speculativeMessage->sequenceNumber );
+        AiaFree( plaintext );
+        return;
+    }
+
+    AiaMutex_t* mutex = &aiaDispatcher->directiveMutex;
+    AiaSequencer_t* sequencer = aiaDispatcher->directiveSequencer;
+#ifdef AIA_ENABLE_SPEAKER
+    if( speculativeMessage->topic == AIA_TOPIC_SPEAKER )
+    {
+        mutex = &aiaDispatcher->speakerMutex;
+        sequencer = aiaDispatcher->speakerSequencer;
+    }
+#endif
+    AiaMutex( Lock )( mutex );
+    bool prepared =
+        AiaSequencer_Prepare( sequencer, speculativeMessage->sequenceNumber,
+                              plaintext, encryptedSize );
+    AiaMutex( Unlock )( mutex );
+    if( !prepared )
+    {
+        AiaFree( plaintext );
+    }
+}
+
+/**
+ * Called by @c AiaDispatcherSpeculation_t::timer to decrypt the queued
+ * messages, until there are none left.
+ *
+ * @param context The @c AiaDispatcherSpeculation_t to act on.
+ */
+static void speculationRoutine( void* context )
+{
+    AiaDispatcherSpeculation_t* speculation =
+        (AiaDispatcherSpeculation_t*)context;
+    while( true )
+    {
+        AiaMutex( Lock )( &speculation->mutex );
+        AiaListDouble( Link_t )* link =
+            AiaListDouble( RemoveHead )( &speculation->messages );
+        if( !link )
+        {
+            speculation->isScheduled = false;
+            AiaMutex( Unlock )( &speculation->mutex );
+            return;
+        }
+        AiaMutex( Unlock )( &speculation->mutex );
+
+        decryptSpeculativeMessage( speculation->dispatcher,
+                                   (AiaDispatcherSpeculativeMessage_t*)link );
+        AiaFree( link );
+    }
+}
+
+/**
+ * Sets the preparation callbacks of the sequencers which decrypt ahead.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @param speculation The @c AiaDispatcherSpeculation_t to queue buffered
+ * messages to, or @c NULL to stop queueing them.
+ */
+static void setSequencerPreparation( AiaDispatcher_t* aiaDispatcher,
+                                     AiaDispatcherSpeculation_t* speculation )
+{
+    AiaMutex( Lock )( &aiaDispatcher->directiveMutex );
+    AiaSequencer_SetPreparation(
+        aiaDispatcher->directiveSequencer,
+        speculation ? prepareDirectiveMessage : NULL, speculation,
+        directivePreparedSequencedCallback );
+    AiaMutex( Unlock )( &aiaDispatcher->directiveMutex );
+#ifdef AIA_ENABLE_SPEAKER
+    AiaMutex( Lock )( &aiaDispatcher->speakerMutex );
+    AiaSequencer_SetPreparation( aiaDispatcher->speakerSequencer,
+                                 speculation ? prepareSpeakerMessage : NULL,
+                                 speculation,
+                                 speakerPreparedSequencedCallback );
+    AiaMutex( Unlock )( &aiaDispatcher->speakerMutex );
+#endif
+}
+
+/**
+ * Stops and releases the speculative decryption worker of a dispatcher,
+ * discarding the messages still queued to it.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @note Must be called without holding any topic mutex, which the worker may
+ * be waiting on.
+ */
+static void destroySpeculation( AiaDispatcher_t* aiaDispatcher )
+{
+    AiaDispatcherSpeculation_t* speculation = aiaDispatcher->speculation;
+    setSequencerPreparation( aiaDispatcher, NULL );
+
+    /* Waits for a running worker to empty its queue. */
+    AiaTimer( Destroy )( &speculation->timer );
+    AiaListDouble( Link_t )* link;
+    while( ( link = AiaListDouble( RemoveHead )( &speculation->messages ) ) )
+    {
+        AiaFree( link );
+    }
+    AiaMutex( Destroy )( &speculation->mutex );
+    AiaFree( speculation );
+    aiaDispatcher->speculation = NULL;
+}
+
+/**
+ * Creates the speculative decryption worker of a dispatcher and has the
+ * directive and speaker sequencers queue buffered messages to it.
+ *
+ * @param aiaDispatcher @c AiaDispatcher_t instance to act on.
+ * @return @c true if successful, else @c false.
+ */
+static bool createSpeculation( AiaDispatcher_t* aiaDispatcher )
+{
+    AiaDispatcherSpeculation_t* speculation =
+        AiaCalloc( 1, sizeof( AiaDispatcherSpeculation_t ) );
+    if( !speculation )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     sizeof( AiaDispatcherSpeculation_t ) );
+        return false;
+    }
+    speculation->dispatcher = aiaDispatcher;
+    AiaListDouble( Create )( &speculation->messages );
+    if( !AiaMutex( Create )( &speculation->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( speculation );
+        return false;
+    }
+    if( !AiaTimer( Create )( &speculation->timer, speculationRoutine,
+                             speculation ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &speculation->mutex );
+        AiaFree( speculation );
+        return false;
+    }
+    aiaDispatcher->speculation = speculation;
+    setSequencerPreparation( aiaDispatcher, speculation );
+    return true;
+}
+#endif
+
+/**
+ * Sequencer timeout callback for messages written to the sequencer.
+ *
+ * @param userData User data associated with this callback.
+ */
+static void sequencerTimedoutCallback( void* userData )
+{
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return;
+    }
+
+    AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
+
+    AiaLogDebug( "Timed out waiting to sequence message" );
+
+    if( !AiaConnectionManager_Disconnect(
+            aiaDispatcher->connectionManager,
+            AIA_CONNECTION_DISCONNECT_UNEXPECTED_SEQUENCE_NUMBER,
+            "Timed out waiting to sequence message" ) )
+    {
+        AiaLogError( "Failed to disconnect." );
+    }
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/**
+ * Sequencer timeout callback for messages written to the speaker sequencer. If
+ * the speaker manager can conceal lost speaker frames, the missing messages are
+ * skipped. Otherwise, this falls back to @c sequencerTimedoutCallback().
+ *
+ * @param userData User data associated with this callback.
+ */
+static void speakerSequencerTimedoutCallback( void* userData )
+{
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return;
+    }
+
+    AiaDispatcher_t* aiaDispatcher = (AiaDispatcher_t*)userData;
+    if( aiaDispatcher->speakerManager &&
+        AiaSpeakerManager_CanConcealGaps( aiaDispatcher->speakerManager ) )
+    {
+        AiaMutex( Lock )( &aiaDispatcher->speakerMutex );
+        bool skipped =
+            AiaSequencer_SkipMissing( aiaDispatcher->speakerSequencer );
+        AiaMutex( Unlock )( &aiaDispatcher->speakerMutex );
+        if( skipped )
+        {
+            return;
+        }
+    }
+    sequencerTimedoutCallback( userData );
+}
+#endif
+
+/**
+ * Handles a message received on the directive topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the message is for.
+ * @param callbackParam The received message.
+ */
+static void directiveMessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam )
+{
+    if( !callbackArg )
+    {
+        AiaLogError( "Null callback argument" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug( "Calling the directive sequencer" );
+    AiaMutex( Lock )( &dispatcher->directiveMutex );
+    if( !AiaSequencer_Write( dispatcher->directiveSequencer,
+                             (void*)callbackParam->u.message.info.pPayload,
+                             callbackParam->u.message.info.payloadLength ) )
+    {
+        AiaLogError(
+            "Failed to write incoming data to the directive sequencer" );
+        AiaMutex( Unlock )( &dispatcher->directiveMutex );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0, AIA_TOPIC_DIRECTIVE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        return;
+    }
+    AiaMutex( Unlock )( &dispatcher->directiveMutex );
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/**
+ * Handles a message received on the speaker topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the message is for.
+ * @param callbackParam The received message.
+ */
+static void speakerMessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam )
+{
+    if( !callbackArg )
+    {
+        AiaLogError( "Null callback argument" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaTrace_Begin(
+        AIA_TRACE_SPEAKER_RECEIVE,
+        peekSequenceNumber( callbackParam->u.message.info.pPayload,
+                            callbackParam->u.message.info.payloadLength ),
+        AIA_TRACE_OFFSET_UNKNOWN );
+    AiaTrace_Begin(
+        AIA_TRACE_SPEAKER_SEQUENCE,
+        peekSequenceNumber( callbackParam->u.message.info.pPayload,
+                            callbackParam->u.message.info.payloadLength ),
+        AIA_TRACE_OFFSET_UNKNOWN );
+    AiaLogDebug( "Calling the speaker sequencer" );
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+    AiaMutex( Lock )( &dispatcher->speakerMutex );
+    if( !AiaSequencer_Write( dispatcher->speakerSequencer,
+                             (void*)callbackParam->u.message.info.pPayload,
+                             callbackParam->u.message.info.payloadLength ) )
+    {
+        AiaLogError( "Failed to write incoming data to the speaker sequencer" );
+        AiaMutex( Unlock )( &dispatcher->speakerMutex );
+        AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0, AIA_TOPIC_SPEAKER ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        AiaTrace_End(
+            AIA_TRACE_SPEAKER_RECEIVE,
+            peekSequenceNumber( callbackParam->u.message.info.pPayload,
+                                callbackParam->u.message.info.payloadLength ),
+            AIA_TRACE_OFFSET_UNKNOWN );
+        return;
+    }
+    AiaMutex( Unlock )( &dispatcher->speakerMutex );
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+    AiaTrace_End(
+        AIA_TRACE_SPEAKER_RECEIVE,
+        peekSequenceNumber( callbackParam->u.message.info.pPayload,
+                            callbackParam->u.message.info.payloadLength ),
+        AIA_TRACE_OFFSET_UNKNOWN );
+}
+#endif
+
+/**
+ * Handles a message received on the capabilities acknowledge topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the message is for.
+ * @param callbackParam The received message.
+ */
+static void capabilitiesAcknowledgeMessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam )
+{
+    if( !callbackArg )
+    {
+        AiaLogError( "Null callback argument" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug( "Calling the capabilities acknowledge sequencer" );
+    AiaMutex( Lock )( &dispatcher->capabilitiesAcknowledgeMutex );
+    if( !AiaSequencer_Write(
+            dispatcher->capabilitiesAcknowledgeSequencer,
+            (void*)callbackParam->u.message.info.pPayload,
+            callbackParam->u.message.info.payloadLength ) )
+    {
+        /* TODO: ADSER-1687 Return Errors on Connection Messages not
+         * Handled by Aia Instances */
+        AiaLogError(
+            "Failed to write incoming data to the capabilities acknowledge "
+            "sequencer" );
+        AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0,
+                AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        return;
+    }
+    AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+}
+
+/**
+ * Handles a message on the connection from service topic, which is not
+ * encrypted.
+ *
+ * @param dispatcher The @c AiaDispatcher_t the message is for.
+ * @param message The message.
+ * @param size The size of @c message.
+ */
+static void handleConnectionFromServiceMessage( AiaDispatcher_t* dispatcher,
+                                                const char* message,
+                                                size_t size )
+{
+    const char* name;
+    size_t nameLength = 0;
+    if( !AiaFindJsonValue( message, size, AIA_JSON_CONSTANTS_NAME_KEY,
+                           sizeof( AIA_JSON_CONSTANTS_NAME_KEY ) - 1, &name,
+                           &nameLength ) )
+    {
+        /* TODO: ADSER-1687 Return Errors on Connection Messages not
+         * Handled by Aia Instances */
+        AiaLogError( "Failed to parse the %s key in the header",
+                     AIA_JSON_CONSTANTS_NAME_KEY );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0,
+                AIA_TOPIC_CONNECTION_FROM_SERVICE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        return;
+    }
+    else if( !AiaJsonUtils_UnquoteString( &name, &nameLength ) )
+    {
+        /* TODO: ADSER-1687 Return Errors on Connection Messages not
+         * Handled by Aia Instances */
+        AiaLogError( "Malformed JSON" );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0,
+                AIA_TOPIC_CONNECTION_FROM_SERVICE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+        return;
+    }
+
+    if( !strncmp( name, AIA_CONNECTION_ACK_NAME, nameLength ) )
+    {
+        AiaConnectionManager_OnConnectionAcknowledgementReceived(
+            dispatcher->connectionManager, message, size );
+    }
+    else if( !strncmp( name, AIA_CONNECTION_DISCONNECT_NAME, nameLength ) )
+    {
+        AiaConnectionManager_OnConnectionDisconnectReceived(
+            dispatcher->connectionManager, message, size );
+    }
+    else
+    {
+        /* TODO: ADSER-1687 Return Errors on Connection Messages not
+         * Handled by Aia Instances */
+        AiaLogError( "No service connection message handler for name: %s",
+                     name );
+        if( !AiaExceptionLimiter_ReportMalformedMessage(
+                dispatcher->exceptionLimiter, 0, 0, AIA_TOPIC_DIRECTIVE ) )
+        {
+            AiaLogError( "Failed to report malformed message." );
+        }
+    }
+}
+
+/**
+ * Handles a message received on the connection from service topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the message is for.
+ * @param callbackParam The received message.
+ */
+static void connectionFromServiceMessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam )
+{
+    if( !callbackArg )
+    {
+        AiaLogError( "Null callback argument" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug( "Calling the service connection message handler" );
+
+    observePlaintext( dispatcher, AIA_TOPIC_CONNECTION_FROM_SERVICE, 0,
+                      callbackParam->u.message.info.pPayload,
+                      callbackParam->u.message.info.payloadLength );
+    handleConnectionFromServiceMessage(
+        dispatcher, (const char*)callbackParam->u.message.info.pPayload,
+        callbackParam->u.message.info.payloadLength );
+}
+
+/** A message of a received batch, along with its plaintext sequence number. */
+typedef struct AiaDispatcherReceivedMessage
+{
+    /** The sequence number in the common header of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The received message. */
+    AiaMqttCallbackParam_t* callbackParam;
+} AiaDispatcherReceivedMessage_t;
+
+/**
+ * Writes a batch of messages received on a sequenced topic to the topic's
+ * sequencer in sequence number order, locking the topic once per @c
+ * AIA_DISPATCHER_RECEIVE_BATCH_SIZE messages.
+ *
+ * @param dispatcher The @c AiaDispatcher_t the messages are for.
+ * @param topic The topic the messages were received on.
+ * @param mutex The mutex guarding @c sequencer.
+ * @param sequencer The sequencer of @c topic.
+ * @param callbackParams The received messages.
+ * @param numMessages The number of messages in @c callbackParams.
+ */
+static void writeReceivedBatch( AiaDispatcher_t* dispatcher, AiaTopic_t topic,
+                                AiaMutex_t* mutex, AiaSequencer_t* sequencer,
+                                AiaMqttCallbackParam_t* const* callbackParams,
+                                size_t numMessages )
+{
+    while( numMessages )
+    {
+        AiaDispatcherReceivedMessage_t
+            messages[ AIA_DISPATCHER_RECEIVE_BATCH_SIZE ];
+        size_t numSorted =
+            AiaMin( numMessages, AIA_DISPATCHER_RECEIVE_BATCH_SIZE );
+
+        /* Batches are small and mostly in order already, which insertion sort
+         * handles in a single pass. Messages too short to hold a sequence
+         * number sort first, and are rejected by the sequencer. */
+        for( size_t i = 0; i < numSorted; ++i )
+        {
+            AiaDispatcherReceivedMessage_t message = { 0, callbackParams[ i ] };
+            getSequenceNumberCallback(
+                &message.sequenceNumber,
+                (void*)message.callbackParam->u.message.info.pPayload,
+                message.callbackParam->u.message.info.payloadLength, NULL );
+            size_t j = i;
+            while( j > 0 &&
+                   messages[ j - 1 ].sequenceNumber > message.sequenceNumber )
+            {
+                messages[ j ] = messages[ j - 1 ];
+                --j;
+            }
+            messages[ j ] = message;
+        }
+
+        size_t numFailed = 0;
+        AiaMutex( Lock )( mutex );
+        for( size_t i = 0; i < numSorted; ++i )
+        {
+            const AiaMqttCallbackParam_t* callbackParam =
+                messages[ i ].callbackParam;
+            if( AIA_TOPIC_SPEAKER == topic )
+            {
+                AiaTrace_Begin( AIA_TRACE_SPEAKER_RECEIVE,
+                                messages[ i ].sequenceNumber,
+                                AIA_TRACE_OFFSET_UNKNOWN );
+                AiaTrace_Begin( AIA_TRACE_SPEAKER_SEQUENCE,
+                                messages[ i ].sequenceNumber,
+                                AIA_TRACE_OFFSET_UNKNOWN );
+            }
+            if( !AiaSequencer_Write(
+                    sequencer, (void*)callbackParam->u.message.info.pPayload,
+                    callbackParam->u.message.info.payloadLength ) )
+            {
+                AiaLogError(
+                    "Failed to write incoming data to the %s sequencer",
+                    AiaTopic_ToString( topic ) );
+                ++numFailed;
+            }
+            if( AIA_TOPIC_SPEAKER == topic )
+            {
+                AiaTrace_End( AIA_TRACE_SPEAKER_RECEIVE,
+                              messages[ i ].sequenceNumber,
+                              AIA_TRACE_OFFSET_UNKNOWN );
+            }
+        }
+        AiaMutex( Unlock )( mutex );
+
+        for( ; numFailed; --numFailed )
+        {
+            if( !AiaExceptionLimiter_ReportMalformedMessage(
+                    dispatcher->exceptionLimiter, 0, 0, topic ) )
+            {
+                AiaLogError( "Failed to report malformed message." );
+            }
+        }
+        callbackParams += numSorted;
+        numMessages -= numSorted;
+    }
+}
+
+/**
+ * Handles a batch of messages received on the directive topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the messages are for.
+ * @param callbackParams The received messages.
+ * @param numMessages The number of messages in @c callbackParams.
+ */
+static void directiveBatchReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* const* callbackParams,
+    size_t numMessages )
+{
+    if( !callbackArg || !callbackParams )
+    {
+        AiaLogError( "Null callback argument or messages" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug( "Calling the directive sequencer, numMessages=%zu",
+                 numMessages );
+    writeReceivedBatch( dispatcher, AIA_TOPIC_DIRECTIVE,
+                        &dispatcher->directiveMutex,
+                        dispatcher->directiveSequencer, callbackParams,
+                        numMessages );
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/**
+ * Handles a batch of messages received on the speaker topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the messages are for.
+ * @param callbackParams The received messages.
+ * @param numMessages The number of messages in @c callbackParams.
+ */
+static void speakerBatchReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* const* callbackParams,
+    size_t numMessages )
+{
+    if( !callbackArg || !callbackParams )
+    {
+        AiaLogError( "Null callback argument or messages" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug( "Calling the speaker sequencer, numMessages=%zu",
+                 numMessages );
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+    if( dispatcher->speakerManager )
+    {
+        AiaSpeakerManager_BeginWriteBatch( dispatcher->speakerManager );
+    }
+    writeReceivedBatch( dispatcher, AIA_TOPIC_SPEAKER,
+                        &dispatcher->speakerMutex, dispatcher->speakerSequencer,
+                        callbackParams, numMessages );
+    if( dispatcher->speakerManager )
+    {
+        AiaSpeakerManager_EndWriteBatch( dispatcher->speakerManager );
+    }
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+}
+#endif
+
+/**
+ * Handles a batch of messages received on the capabilities acknowledge topic.
+ *
+ * @param callbackArg The @c AiaDispatcher_t the messages are for.
+ * @param callbackParams The received messages.
+ * @param numMessages The number of messages in @c callbackParams.
+ */
+static void capabilitiesAcknowledgeBatchReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* const* callbackParams,
+    size_t numMessages )
+{
+    if( !callbackArg || !callbackParams )
+    {
+        AiaLogError( "Null callback argument or messages" );
+        return;
+    }
+
+    AiaDispatcher_t* dispatcher = (AiaDispatcher_t*)callbackArg;
+    AiaLogDebug(
+        "Calling the capabilities acknowledge sequencer, numMessages=%zu",
+        numMessages );
+    writeReceivedBatch( dispatcher, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
+                        &dispatcher->capabilitiesAcknowledgeMutex,
+                        dispatcher->capabilitiesAcknowledgeSequencer,
+                        callbackParams, numMessages );
+}
+
+AiaMqttTopicHandler_t AiaDispatcher_GetTopicHandler( AiaTopic_t topic )
+{
+    switch( topic )
+    {
+        case AIA_TOPIC_CONNECTION_FROM_CLIENT:
+        case AIA_TOPIC_CAPABILITIES_PUBLISH:
+        case AIA_TOPIC_EVENT:
+        case AIA_TOPIC_MICROPHONE:
+            return NULL;
+        case AIA_TOPIC_DIRECTIVE:
+            return directiveMessageReceivedCallback;
+        case AIA_TOPIC_SPEAKER:
+#ifdef AIA_ENABLE_SPEAKER
+            return speakerMessageReceivedCallback;
+#else
+            return NULL;
+#endif
+        case AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE:
+            return capabilitiesAcknowledgeMessageReceivedCallback;
+        case AIA_TOPIC_CONNECTION_FROM_SERVICE:
+            return connectionFromServiceMessageReceivedCallback;
+        case AIA_NUM_TOPICS:
+            break;
+    }
+    AiaLogError( "Unknown topic %d.", topic );
+    return NULL;
+}
+
+AiaMqttBatchTopicHandler_t AiaDispatcher_GetTopicBatchHandler(
+    AiaTopic_t topic )
+{
+    switch( topic )
+    {
+        case AIA_TOPIC_CONNECTION_FROM_CLIENT:
+        case AIA_TOPIC_CAPABILITIES_PUBLISH:
+        case AIA_TOPIC_EVENT:
+        case AIA_TOPIC_MICROPHONE:
+        case AIA_TOPIC_CONNECTION_FROM_SERVICE:
+            return NULL;
+        case AIA_TOPIC_DIRECTIVE:
+            return directiveBatchReceivedCallback;
+        case AIA_TOPIC_SPEAKER:
+#ifdef AIA_ENABLE_SPEAKER
+            return speakerBatchReceivedCallback;
+#else
+            return NULL;
+#endif
+        case AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE:
+            return capabilitiesAcknowledgeBatchReceivedCallback;
+        case AIA_NUM_TOPICS:
+            break;
     }
+    AiaLogError( "Unknown topic %d.", topic );
+    return NULL;
 }
 
 void messageReceivedCallback( void* callbackArg,
@@ -924,186 +2405,19 @@ void messageReceivedCallback( void* callbackArg,
         return;
     }
 
-    /* Forward the incoming message to the correct handler or sequencer based on
-     * the topic */
-    switch( parsedTopic )
+    /* Forward the incoming message to the correct handler based on the topic */
+    AiaMqttTopicHandler_t handler =
+        AiaDispatcher_GetTopicHandler( parsedTopic );
+    if( handler )
     {
-        case AIA_TOPIC_CONNECTION_FROM_CLIENT:
-        case AIA_TOPIC_CAPABILITIES_PUBLISH:
-        case AIA_TOPIC_EVENT:
-        case AIA_TOPIC_MICROPHONE:
-            return;
-        case AIA_TOPIC_DIRECTIVE:
-            AiaLogDebug( "Calling the directive sequencer" );
-            AiaMutex( Lock )( &dispatcher->mutex );
-            if( !AiaSequencer_Write(
-                    dispatcher->directiveSequencer,
-                    (void*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength ) )
-            {
-                AiaLogError(
-                    "Failed to write incoming data to the directive "
-                    "sequencer" );
-                AiaMutex( Unlock )( &dispatcher->mutex );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_DIRECTIVE );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-                return;
-            }
-            AiaMutex( Unlock )( &dispatcher->mutex );
-            return;
-        case AIA_TOPIC_SPEAKER:
-#ifdef AIA_ENABLE_SPEAKER
-            AiaLogDebug( "Calling the speaker sequencer" );
-            AiaMutex( Lock )( &dispatcher->mutex );
-            if( !AiaSequencer_Write(
-                    dispatcher->speakerSequencer,
-                    (void*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength ) )
-            {
-                AiaLogError(
-                    "Failed to write incoming data to the speaker sequencer" );
-                AiaMutex( Unlock )( &dispatcher->mutex );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_SPEAKER );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-                return;
-            }
-#endif
-            AiaMutex( Unlock )( &dispatcher->mutex );
-            return;
-        case AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE:
-            AiaLogDebug( "Calling the capabilities acknowledge sequencer" );
-            AiaMutex( Lock )( &dispatcher->mutex );
-            if( !AiaSequencer_Write(
-                    dispatcher->capabilitiesAcknowledgeSequencer,
-                    (void*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength ) )
-            {
-                /* TODO: ADSER-1687 Return Errors on Connection Messages not
-                 * Handled by Aia Instances */
-                AiaLogError(
-                    "Failed to write incoming data to the capabilities "
-                    "acknowledge "
-                    "sequencer" );
-                AiaMutex( Unlock )( &dispatcher->mutex );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-                return;
-            }
-            AiaMutex( Unlock )( &dispatcher->mutex );
-            return;
-        case AIA_TOPIC_CONNECTION_FROM_SERVICE:
-            AiaLogDebug( "Calling the service connection message handler" );
-
-            const char* name;
-            size_t nameLength = 0;
-            if( !AiaFindJsonValue(
-                    (char*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength,
-                    AIA_JSON_CONSTANTS_NAME_KEY,
-                    sizeof( AIA_JSON_CONSTANTS_NAME_KEY ) - 1, &name,
-                    &nameLength ) )
-            {
-                /* TODO: ADSER-1687 Return Errors on Connection Messages not
-                 * Handled by Aia Instances */
-                AiaLogError( "Failed to parse the %s key in the header",
-                             AIA_JSON_CONSTANTS_NAME_KEY );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_CONNECTION_FROM_SERVICE );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-                return;
-            }
-            else if( !AiaJsonUtils_UnquoteString( &name, &nameLength ) )
-            {
-                /* TODO: ADSER-1687 Return Errors on Connection Messages not
-                 * Handled by Aia Instances */
-                AiaLogError( "Malformed JSON" );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_CONNECTION_FROM_SERVICE );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-                return;
-            }
-
-            if( !strncmp( name, AIA_CONNECTION_ACK_NAME, nameLength ) )
-            {
-                AiaConnectionManager_OnConnectionAcknowledgementReceived(
-                    dispatcher->connectionManager,
-                    (char*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength );
-            }
-            else if( !strncmp( name, AIA_CONNECTION_DISCONNECT_NAME,
-                               nameLength ) )
-            {
-                AiaConnectionManager_OnConnectionDisconnectReceived(
-                    dispatcher->connectionManager,
-                    (char*)callbackParam->u.message.info.pPayload,
-                    callbackParam->u.message.info.payloadLength );
-            }
-            else
-            {
-                /* TODO: ADSER-1687 Return Errors on Connection Messages not
-                 * Handled by Aia Instances */
-                AiaLogError(
-                    "No service connection message handler for name: %s",
-                    name );
-                AiaJsonMessage_t* malformedMessageEvent =
-                    generateMalformedMessageExceptionEncounteredEvent(
-                        0, 0, AIA_TOPIC_DIRECTIVE );
-                if( !AiaRegulator_Write(
-                        dispatcher->regulator,
-                        AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-                {
-                    AiaLogError( "Failed to write to regulator." );
-                    AiaJsonMessage_Destroy( malformedMessageEvent );
-                }
-            }
-            return;
-        case AIA_NUM_TOPICS:
-            break;
+        handler( dispatcher, callbackParam );
     }
-    AiaLogError( "Received message on an unknown topic %d.", parsedTopic );
 }
 
 AiaDispatcher_t* AiaDispatcher_Create(
     AiaTaskPool_t aiaTaskPool, AiaCapabilitiesSender_t* capabilitiesSender,
-    AiaRegulator_t* regulator, AiaSecretManager_t* secretManager )
+    AiaRegulator_t* regulator, AiaSecretManager_t* secretManager,
+    AiaExceptionLimiter_t* exceptionLimiter )
 {
     if( !aiaTaskPool )
     {
@@ -1125,6 +2439,11 @@ AiaDispatcher_t* AiaDispatcher_Create(
         AiaLogError( "Null secretManager." );
         return NULL;
     }
+    if( !exceptionLimiter )
+    {
+        AiaLogError( "Null exceptionLimiter." );
+        return NULL;
+    }
 
     size_t deviceTopicRootSize = AiaGetDeviceTopicRootString( NULL, 0 );
     if( !deviceTopicRootSize )
@@ -1144,25 +2463,52 @@ AiaDispatcher_t* AiaDispatcher_Create(
 
     dispatcher->deviceTopicRoot = (char*)( dispatcher + 1 );
 
-    if( !AiaMutex( Create )( &dispatcher->mutex, false ) )
+    if( !AiaMutex( Create )( &dispatcher->capabilitiesAcknowledgeMutex,
+                             false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( dispatcher );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &dispatcher->directiveMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaMutex( Destroy )( &dispatcher->capabilitiesAcknowledgeMutex );
+        AiaFree( dispatcher );
+        return NULL;
+    }
+#ifdef AIA_ENABLE_SPEAKER
+    if( !AiaMutex( Create )( &dispatcher->speakerMutex, false ) )
     {
         AiaLogError( "AiaMutex( Create ) failed." );
+        AiaMutex( Destroy )( &dispatcher->directiveMutex );
+        AiaMutex( Destroy )( &dispatcher->capabilitiesAcknowledgeMutex );
         AiaFree( dispatcher );
         return NULL;
     }
+#endif
+
+    dispatcher->directiveArena =
+        AiaScratchArena_Create( AIA_DIRECTIVE_SCRATCH_ARENA_SIZE );
+    if( !dispatcher->directiveArena )
+    {
+        AiaLogError( "AiaScratchArena_Create failed" );
+        AiaDispatcher_Destroy( dispatcher );
+        return NULL;
+    }
 
     *(AiaCapabilitiesSender_t**)&dispatcher->capabilitiesSender =
         capabilitiesSender;
-    *(AiaRegulator_t**)&dispatcher->regulator = regulator;
     *(AiaSecretManager_t**)&dispatcher->secretManager = secretManager;
 
+    dispatcher->exceptionLimiter = exceptionLimiter;
+
     deviceTopicRootSize = AiaGetDeviceTopicRootString(
         dispatcher->deviceTopicRoot, deviceTopicRootSize );
     if( !deviceTopicRootSize )
     {
         AiaLogError( "AiaGetDeviceTopicRootString failed" );
-        AiaMutex( Destroy )( &dispatcher->mutex );
-        AiaFree( dispatcher );
+        AiaDispatcher_Destroy( dispatcher );
         return NULL;
     }
     dispatcher->deviceTopicRootSize = deviceTopicRootSize;
@@ -1194,9 +2540,9 @@ AiaDispatcher_t* AiaDispatcher_Create(
 
 #ifdef AIA_ENABLE_SPEAKER
     dispatcher->speakerSequencer = AiaSequencer_Create(
-        speakerMessageSequencedCallback, dispatcher, sequencerTimedoutCallback,
-        dispatcher, getSequenceNumberCallback, NULL, AIA_SEQUENCER_SLOTS, 0,
-        AIA_SEQUENCER_TIMEOUT, aiaTaskPool );
+        speakerMessageSequencedCallback, dispatcher,
+        speakerSequencerTimedoutCallback, dispatcher, getSequenceNumberCallback,
+        NULL, AIA_SEQUENCER_SLOTS, 0, AIA_SEQUENCER_TIMEOUT, aiaTaskPool );
     if( !dispatcher->speakerSequencer )
     {
         AiaLogError( "AiaSequencer_Create failed to create speakerSequencer" );
@@ -1205,6 +2551,32 @@ AiaDispatcher_t* AiaDispatcher_Create(
     }
 #endif
 
+#ifdef AIA_ENABLE_SEQUENCER_AUTO_TUNING
+    AiaSequencerAutoTuningConfig_t autoTuning;
+    autoTuning.minSlots = AIA_SEQUENCER_MIN_SLOTS;
+    autoTuning.maxSlots = AIA_SEQUENCER_MAX_SLOTS;
+    autoTuning.minTimeoutMs = AIA_SEQUENCER_MIN_TIMEOUT_MS;
+    autoTuning.maxTimeoutMs = AIA_SEQUENCER_MAX_TIMEOUT_MS;
+    if( !AiaSequencer_SetAutoTuning( dispatcher->directiveSequencer,
+                                     &autoTuning ) ||
+        !AiaSequencer_SetAutoTuning(
+            dispatcher->capabilitiesAcknowledgeSequencer, &autoTuning ) )
+    {
+        AiaLogError( "AiaSequencer_SetAutoTuning failed" );
+        AiaDispatcher_Destroy( dispatcher );
+        return NULL;
+    }
+#ifdef AIA_ENABLE_SPEAKER
+    if( !AiaSequencer_SetAutoTuning( dispatcher->speakerSequencer,
+                                     &autoTuning ) )
+    {
+        AiaLogError( "AiaSequencer_SetAutoTuning failed" );
+        AiaDispatcher_Destroy( dispatcher );
+        return NULL;
+    }
+#endif
+#endif
+
     return dispatcher;
 }
 
@@ -1228,77 +2600,40 @@ bool AiaDispatcher_AddHandler( AiaDispatcher_t* dispatcher,
         return false;
     }
 
-    switch( directive )
+    if( (int)directive < 0 || (int)directive >= (int)AIA_NUM_DIRECTIVES )
     {
-#ifdef AIA_ENABLE_SPEAKER
-        case AIA_DIRECTIVE_OPEN_SPEAKER:
-            *(AiaDirectiveHandler_t*)&( dispatcher->openSpeakerHandler ) =
-                handler;
-            dispatcher->openSpeakerData = (AiaSpeakerManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_CLOSE_SPEAKER:
-            *(AiaDirectiveHandler_t*)&( dispatcher->closeSpeakerHandler ) =
-                handler;
-            dispatcher->closeSpeakerData = (AiaSpeakerManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_SET_VOLUME:
-            *(AiaDirectiveHandler_t*)&( dispatcher->setVolumeHandler ) =
-                handler;
-            dispatcher->setVolumeData = (AiaSpeakerManager_t*)userData;
-            return true;
-#endif
-#ifdef AIA_ENABLE_MICROPHONE
-        case AIA_DIRECTIVE_OPEN_MICROPHONE:
-            *(AiaDirectiveHandler_t*)&( dispatcher->openMicrophoneHandler ) =
-                handler;
-            dispatcher->openMicrophoneData = (AiaMicrophoneManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_CLOSE_MICROPHONE:
-            *(AiaDirectiveHandler_t*)&( dispatcher->closeMicrophoneHandler ) =
-                handler;
-            dispatcher->closeMicrophoneData = (AiaMicrophoneManager_t*)userData;
-            return true;
-#endif
-        case AIA_DIRECTIVE_SET_ATTENTION_STATE:
-            *(AiaDirectiveHandler_t*)&( dispatcher->setAttentionStateHandler ) =
-                handler;
-            dispatcher->setAttentionStateData = (AiaUXManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_ROTATE_SECRET:
-            *(AiaDirectiveHandler_t*)&( dispatcher->rotateSecretHandler ) =
-                handler;
-            dispatcher->rotateSecretData = (AiaSecretManager_t*)userData;
-            return true;
-#ifdef AIA_ENABLE_ALERTS
-        case AIA_DIRECTIVE_SET_ALERT_VOLUME:
-            *(AiaDirectiveHandler_t*)&( dispatcher->setAlertVolumeHandler ) =
-                handler;
-            dispatcher->setAlertVolumeData = (AiaAlertManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_SET_ALERT:
-            *(AiaDirectiveHandler_t*)&( dispatcher->setAlertHandler ) = handler;
-            dispatcher->setAlertData = (AiaAlertManager_t*)userData;
-            return true;
-        case AIA_DIRECTIVE_DELETE_ALERT:
-            *(AiaDirectiveHandler_t*)&( dispatcher->deleteAlertHandler ) =
-                handler;
-            dispatcher->deleteAlertData = (AiaAlertManager_t*)userData;
-            return true;
-#endif
-#ifdef AIA_ENABLE_CLOCK
-        case AIA_DIRECTIVE_SET_CLOCK:
-            *(AiaDirectiveHandler_t*)&( dispatcher->setClockHandler ) = handler;
-            dispatcher->setClockData = (AiaClockManager_t*)userData;
-            return true;
-#endif
-        case AIA_DIRECTIVE_EXCEPTION:
-            *(AiaDirectiveHandler_t*)&( dispatcher->exceptionHandler ) =
-                handler;
-            dispatcher->exceptionData = (AiaExceptionManager_t*)userData;
-            return true;
+        AiaLogError( "Unknown directive name: %d", directive );
+        return false;
     }
-    AiaLogError( "Unknown directive name: %d", directive );
-    return false;
+
+    dispatcher->directiveHandlers[ directive ].handler = handler;
+    dispatcher->directiveHandlers[ directive ].userData = userData;
+    return true;
+}
+
+bool AiaDispatcher_AddBatchHandler( AiaDispatcher_t* dispatcher,
+                                    AiaDirectiveBatchHandler_t handler,
+                                    void* userData )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return false;
+    }
+    if( !handler )
+    {
+        AiaLogError( "Null handler." );
+        return false;
+    }
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return false;
+    }
+
+    dispatcher->directiveBatchHandler = handler;
+    dispatcher->directiveBatchHandlerUserData = userData;
+    return true;
 }
 
 void AiaDispatcher_AddConnectionManager(
@@ -1326,6 +2661,261 @@ void AiaDispatcher_AddSpeakerManager( AiaDispatcher_t* dispatcher,
 }
 #endif
 
+void AiaDispatcher_SetDecryptInPlace( AiaDispatcher_t* dispatcher,
+                                      bool decryptInPlace )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return;
+    }
+    if( decryptInPlace )
+    {
+        AiaAtomicBool_Set( &dispatcher->decryptInPlace );
+    }
+    else
+    {
+        AiaAtomicBool_Clear( &dispatcher->decryptInPlace );
+    }
+}
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+void AiaDispatcher_GetDirectiveHandlingTimes(
+    AiaDispatcher_t* dispatcher,
+    AiaHistogram_t handlingTimesMs[ AIA_NUM_DIRECTIVES ] )
+{
+    AiaAssert( dispatcher );
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return;
+    }
+    AiaAssert( handlingTimesMs );
+    if( !handlingTimesMs )
+    {
+        AiaLogError( "Null handlingTimesMs." );
+        return;
+    }
+    for( size_t i = 0; i < AIA_NUM_DIRECTIVES; ++i )
+    {
+        AiaHistogram_Snapshot( &dispatcher->directiveHandlingTimesMs[ i ],
+                               &handlingTimesMs[ i ] );
+    }
+}
+#endif
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+bool AiaDispatcher_SetParallelDirectives( AiaDispatcher_t* dispatcher,
+                                          bool parallel )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return false;
+    }
+    AiaMutex( Lock )( &dispatcher->directiveMutex );
+    bool result = true;
+    if( parallel && !dispatcher->directiveWorkers )
+    {
+        result = createDirectiveWorkers( dispatcher );
+    }
+    else if( !parallel && dispatcher->directiveWorkers )
+    {
+        destroyDirectiveWorkers( dispatcher, true );
+    }
+    AiaMutex( Unlock )( &dispatcher->directiveMutex );
+    return result;
+}
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+bool AiaDispatcher_SetSpeculativeDecryption( AiaDispatcher_t* dispatcher,
+                                             bool speculative )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return false;
+    }
+    if( speculative && !dispatcher->speculation )
+    {
+        return createSpeculation( dispatcher );
+    }
+    if( !speculative && dispatcher->speculation )
+    {
+        destroySpeculation( dispatcher );
+    }
+    return true;
+}
+#endif
+
+size_t AiaDispatcher_TrimMemory( AiaDispatcher_t* dispatcher )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return 0;
+    }
+    AiaMutex( Lock )( &dispatcher->directiveMutex );
+    size_t released = AiaSequencer_TrimMemory( dispatcher->directiveSequencer );
+    AiaMutex( Unlock )( &dispatcher->directiveMutex );
+    AiaMutex( Lock )( &dispatcher->capabilitiesAcknowledgeMutex );
+    released += AiaSequencer_TrimMemory(
+        dispatcher->capabilitiesAcknowledgeSequencer );
+    AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+#ifdef AIA_ENABLE_SPEAKER
+    AiaMutex( Lock )( &dispatcher->speakerMutex );
+    released += AiaSequencer_TrimMemory( dispatcher->speakerSequencer );
+    AiaMutex( Unlock )( &dispatcher->speakerMutex );
+#endif
+    return released;
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+bool AiaDispatcher_SetMemoryBudget( AiaDispatcher_t* dispatcher,
+                                    AiaMemoryBudget_t* memoryBudget )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return false;
+    }
+    AiaMutex( Lock )( &dispatcher->directiveMutex );
+    bool result = AiaSequencer_SetMemoryBudget( dispatcher->directiveSequencer,
+                                                memoryBudget );
+    AiaMutex( Unlock )( &dispatcher->directiveMutex );
+    AiaMutex( Lock )( &dispatcher->capabilitiesAcknowledgeMutex );
+    result = AiaSequencer_SetMemoryBudget(
+                 dispatcher->capabilitiesAcknowledgeSequencer,
+                 memoryBudget ) &&
+             result;
+    AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+#ifdef AIA_ENABLE_SPEAKER
+    AiaMutex( Lock )( &dispatcher->speakerMutex );
+    result = AiaSequencer_SetMemoryBudget( dispatcher->speakerSequencer,
+                                           memoryBudget ) &&
+             result;
+    AiaMutex( Unlock )( &dispatcher->speakerMutex );
+#endif
+    return result;
+}
+#endif
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+void AiaDispatcher_SetPlaintextObserver( AiaDispatcher_t* dispatcher,
+                                         AiaSessionTraceObserver_t observer,
+                                         void* userData )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return;
+    }
+    dispatcher->plaintextObserver = observer;
+    dispatcher->plaintextUserData = userData;
+}
+
+/**
+ * Copies a replayed plaintext into a null-terminated buffer, as decrypted
+ * payloads are.
+ *
+ * @param arena The @c AiaScratchArena_t to allocate from, or @c NULL to
+ * allocate from the heap.
+ * @param plaintext The plaintext to copy.
+ * @param size The size of @c plaintext.
+ * @return The copy, to be released with @c AiaScratchArena_Free(), or @c NULL
+ * on failure.
+ */
+static char* copyPlaintext( AiaScratchArena_t* arena, const void* plaintext,
+                            size_t size )
+{
+    char* copy = AiaScratchArena_Calloc( arena, size + 1, 1 );
+    if( !copy )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu", size + 1 );
+        return NULL;
+    }
+    if( size )
+    {
+        memcpy( copy, plaintext, size );
+    }
+    return copy;
+}
+
+bool AiaDispatcher_DispatchPlaintext( AiaDispatcher_t* dispatcher,
+                                      AiaTopic_t topic,
+                                      AiaSequenceNumber_t sequenceNumber,
+                                      const void* plaintext, size_t size )
+{
+    if( !dispatcher )
+    {
+        AiaLogError( "Null dispatcher." );
+        return false;
+    }
+    if( !plaintext && size )
+    {
+        AiaLogError( "Null plaintext." );
+        return false;
+    }
+
+    char* copy = NULL;
+    switch( topic )
+    {
+        case AIA_TOPIC_CONNECTION_FROM_SERVICE:
+            copy = copyPlaintext( NULL, plaintext, size );
+            if( !copy )
+            {
+                return false;
+            }
+            handleConnectionFromServiceMessage( dispatcher, copy, size );
+            AiaScratchArena_Free( NULL, copy );
+            return true;
+        case AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE:
+            copy = copyPlaintext( NULL, plaintext, size );
+            if( !copy )
+            {
+                return false;
+            }
+            AiaMutex( Lock )( &dispatcher->capabilitiesAcknowledgeMutex );
+            handleCapabilitiesAcknowledgePlaintext( dispatcher, copy, size,
+                                                    sequenceNumber );
+            AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+            AiaScratchArena_Free( NULL, copy );
+            return true;
+        case AIA_TOPIC_DIRECTIVE:
+            AiaMutex( Lock )( &dispatcher->directiveMutex );
+            AiaScratchArena_Reset( dispatcher->directiveArena );
+            copy = copyPlaintext( dispatcher->directiveArena, plaintext, size );
+            if( copy )
+            {
+                handleDirectiveTopicPlaintext( dispatcher, copy, size,
+                                               sequenceNumber );
+                AiaScratchArena_Free( dispatcher->directiveArena, copy );
+            }
+            AiaMutex( Unlock )( &dispatcher->directiveMutex );
+            return copy != NULL;
+#ifdef AIA_ENABLE_SPEAKER
+        case AIA_TOPIC_SPEAKER:
+            if( !dispatcher->speakerManager )
+            {
+                AiaLogError( "Null speakerManager." );
+                return false;
+            }
+            AiaMutex( Lock )( &dispatcher->speakerMutex );
+            AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+                dispatcher->speakerManager, plaintext, size, sequenceNumber );
+            AiaMutex( Unlock )( &dispatcher->speakerMutex );
+            return true;
+#endif
+        default:
+            break;
+    }
+    AiaLogError( "Cannot dispatch messages on the %s topic.",
+                 AiaTopic_ToString( topic ) );
+    return false;
+}
+#endif
+
 void AiaDispatcher_Destroy( AiaDispatcher_t* dispatcher )
 {
     if( !dispatcher )
@@ -1334,13 +2924,33 @@ void AiaDispatcher_Destroy( AiaDispatcher_t* dispatcher )
         return;
     }
 
-    AiaMutex( Lock )( &dispatcher->mutex );
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    if( dispatcher->speculation )
+    {
+        destroySpeculation( dispatcher );
+    }
+#endif
+
+    AiaMutex( Lock )( &dispatcher->capabilitiesAcknowledgeMutex );
     AiaSequencer_Destroy( dispatcher->capabilitiesAcknowledgeSequencer );
+    AiaMutex( Unlock )( &dispatcher->capabilitiesAcknowledgeMutex );
+    AiaMutex( Destroy )( &dispatcher->capabilitiesAcknowledgeMutex );
+
+    AiaMutex( Lock )( &dispatcher->directiveMutex );
     AiaSequencer_Destroy( dispatcher->directiveSequencer );
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    destroyDirectiveWorkers( dispatcher, false );
+#endif
+    AiaMutex( Unlock )( &dispatcher->directiveMutex );
+    AiaMutex( Destroy )( &dispatcher->directiveMutex );
+
 #ifdef AIA_ENABLE_SPEAKER
+    AiaMutex( Lock )( &dispatcher->speakerMutex );
     AiaSequencer_Destroy( dispatcher->speakerSequencer );
+    AiaMutex( Unlock )( &dispatcher->speakerMutex );
+    AiaMutex( Destroy )( &dispatcher->speakerMutex );
 #endif
-    AiaMutex( Unlock )( &dispatcher->mutex );
-    AiaMutex( Destroy )( &dispatcher->mutex );
+
+    AiaScratchArena_Destroy( dispatcher->directiveArena );
     AiaFree( dispatcher );
 }
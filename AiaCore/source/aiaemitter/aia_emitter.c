@@ -23,16 +23,60 @@
 #include <aia_config.h>
 
 #include <aiacore/aia_binary_message.h>
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_json_message.h>
 #include <aiacore/aia_message_constants.h>
 #include <aiacore/aia_topic.h>
 #include <aiaemitter/aia_emitter.h>
 
+#include AiaClock( HEADER )
+#include AiaListDouble( HEADER )
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+#include AiaTimer( HEADER )
+
+#include <inttypes.h>
+
 #define JSON_ARRAY_MESSAGE_PREFIX1 "{\""
 #define JSON_ARRAY_MESSAGE_PREFIX2 "\":["
 #define JSON_ARRAY_MESSAGE_SEPARATOR ","
 #define JSON_ARRAY_MESSAGE_SUFFIX "]}"
 
+/** An MQTT message handed off for asynchronous publishing. */
+typedef struct AiaEmitterPublish
+{
+    /** The actual link in the list. */
+    AiaListDouble( Link_t ) link;
+
+    /** The buffer the message is assembled in, after @c publishHeadroom
+     * bytes.  This is retained and reused for later messages once the message
+     * has been published. */
+    uint8_t* payload;
+
+    /** The size of the buffer @c payload points to, including the headroom. */
+    size_t payloadCapacity;
+
+    /** The size of the message held in @c payload. */
+    size_t payloadSize;
+
+    /** The quality of service to publish the message with. */
+    AiaMqttQos_t qos;
+
+    /** The sequence number of the message, used for tracing. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** The microphone offset the message's audio ends at, used for tracing. */
+    AiaBinaryAudioStreamOffset_t offset;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** When the message was submitted for encryption. */
+    AiaTimepointMs_t submitTimeMs;
+#endif
+
+    /** The emitter this entry belongs to. */
+    struct AiaEmitter* emitter;
+} AiaEmitterPublish_t;
+
 /** Private data for the @c AiaEmitter_t type. */
 struct AiaEmitter
 {
@@ -45,11 +89,16 @@ struct AiaEmitter
     /** Topic to publish MQTT message to. */
     const AiaTopic_t topic;
 
-    /** Device IoT topic root for publishing message to. */
-    char* deviceTopicRoot;
+    /** Full IoT topic (the device topic root followed by @c topic) to publish
+     * messages to. */
+    char* fullTopic;
+
+    /** The length of @c fullTopic. */
+    size_t fullTopicLength;
 
-    /** The size of @c deviceTopicRoot. */
-    size_t deviceTopicRootSize;
+    /** The bytes reserved in front of each MQTT message for the port to frame
+     * the MQTT packet in. */
+    size_t publishHeadroom;
 
     /** Pointer to the start of the buffer holding the current MQTT message
      * being assembled. */
@@ -62,9 +111,70 @@ struct AiaEmitter
     /** Total size of the buffer @c mqttPayloadStart points to. */
     size_t mqttPayloadSize;
 
-    /** Sequence number to use for next MQTT message emitted. Note that this
-     * should only be updated using atomic operations. */
+    /** An optional buffer which is reused for every MQTT message assembled,
+     * after @c publishHeadroom bytes, enabled by @c
+     * AiaEmitter_EnablePayloadBufferReuse(). */
+    uint8_t* payloadBuffer;
+
+    /** The size of @c payloadBuffer, including the headroom. */
+    size_t payloadBufferSize;
+
+    /** Whether @c payloadBuffer is used, allocating it if it has been released
+     * by @c AiaEmitter_TrimMemory(). */
+    bool isPayloadBufferReused;
+
+    /** Pointer to the last binary stream entry appended to the current MQTT
+     * message if it holds microphone content which contiguous microphone
+     * content may be coalesced into, else @c NULL. */
+    uint8_t* coalescingEntryStart;
+
+    /** The microphone offset immediately following the audio held in @c
+     * coalescingEntryStart. */
+    AiaBinaryAudioStreamOffset_t coalescingEntryNextOffset;
+
+    /** The next sequence number to be reserved. Note that this should only
+     * be updated using atomic operations. */
     AiaSequenceNumber_t nextSequenceNumber;
+
+    /** Counters reported by @c AiaEmitter_GetMetrics(). These should only be
+     * accessed using atomic operations. */
+    AiaEmitterMetrics_t metrics;
+
+    /** The quality of service to publish messages with. */
+    AiaMqttQos_t qos;
+
+    /** The in-flight window enabled by @c AiaEmitter_EnableAsyncPublish(), or
+     * @c NULL if messages are published synchronously. */
+    AiaEmitterPublish_t* publishes;
+
+    /** The number of entries in @c publishes. */
+    size_t maxInFlight;
+
+    /** The entry of @c publishes holding the MQTT message being assembled, or
+     * @c NULL if none is. */
+    AiaEmitterPublish_t* currentPublish;
+
+    /** Entries of @c publishes which are free to assemble a message in. */
+    AiaListDouble_t freePublishes;
+
+    /** Entries of @c publishes waiting to be published by @c publishWorker. */
+    AiaListDouble_t pendingPublishes;
+
+    /** Protects @c freePublishes and @c pendingPublishes. */
+    AiaMutex_t publishesMutex;
+
+    /** Counts the entries in @c freePublishes. */
+    AiaSemaphore_t freePublishesCount;
+
+    /** Job which publishes the entries in @c pendingPublishes. */
+    AiaTimer_t publishWorker;
+
+    /** Serializes runs of @c publishWorker. */
+    AiaMutex_t publishWorkerMutex;
+
+    /** Whether @c publishWorker has been armed and not yet started draining
+     * @c pendingPublishes. */
+    AiaAtomicBool_t isPublishPending;
 };
 
 /**
@@ -160,6 +270,146 @@ static bool AiaEmitter_AppendUint32ToMqttPayload( AiaEmitter_t* emitter,
     return true;
 }
 
+/**
+ * Returns an entry of the in-flight window to @c freePublishes.
+ *
+ * @param emitter The emitter to use.
+ * @param publish The entry to return.
+ */
+static void AiaEmitter_FreePublish( AiaEmitter_t* emitter,
+                                    AiaEmitterPublish_t* publish )
+{
+    AiaMutex( Lock )( &emitter->publishesMutex );
+    AiaListDouble( InsertTail )( &emitter->freePublishes, &publish->link );
+    AiaMutex( Unlock )( &emitter->publishesMutex );
+    AiaSemaphore( Post )( &emitter->freePublishesCount );
+}
+
+/**
+ * Acquires a buffer to assemble a new MQTT message in.  If asynchronous
+ * publishing is enabled, this is the buffer of a free entry of the in-flight
+ * window (grown if needed), waiting for one to be published if none is free.
+ * Else if payload buffer reuse is enabled, this is @c payloadBuffer (grown if
+ * needed), else a fresh buffer is allocated.  Each is preceded by @c
+ * publishHeadroom reserved bytes.
+ *
+ * @param emitter The emitter to use.
+ * @param mqttPayloadSize The size of the MQTT message to assemble.
+ * @return A buffer of at least @c mqttPayloadSize bytes, or @c NULL on failure.
+ */
+static uint8_t* AiaEmitter_AcquireMqttPayload( AiaEmitter_t* emitter,
+                                               size_t mqttPayloadSize )
+{
+    size_t headroom = emitter->publishHeadroom;
+    size_t bufferSize = headroom + mqttPayloadSize;
+    if( emitter->publishes )
+    {
+        AiaSemaphore( Wait )( &emitter->freePublishesCount );
+        AiaMutex( Lock )( &emitter->publishesMutex );
+        AiaEmitterPublish_t* publish = (AiaEmitterPublish_t*)AiaListDouble(
+            RemoveHead )( &emitter->freePublishes );
+        AiaMutex( Unlock )( &emitter->publishesMutex );
+        AiaAssert( publish );
+        if( bufferSize > publish->payloadCapacity )
+        {
+            uint8_t* payload = AiaCalloc( bufferSize, 1 );
+            if( !payload )
+            {
+                AiaEmitter_FreePublish( emitter, publish );
+                return NULL;
+            }
+            AiaFree( publish->payload );
+            publish->payload = payload;
+            publish->payloadCapacity = bufferSize;
+        }
+        emitter->currentPublish = publish;
+        return publish->payload + headroom;
+    }
+    if( !emitter->isPayloadBufferReused )
+    {
+        uint8_t* buffer = AiaCalloc( bufferSize, 1 );
+        return buffer ? buffer + headroom : NULL;
+    }
+    if( bufferSize > emitter->payloadBufferSize )
+    {
+        AiaLogDebug( "Growing payload buffer (size=%zu, needed=%zu).",
+                     emitter->payloadBufferSize, bufferSize );
+        uint8_t* payloadBuffer = AiaCalloc( bufferSize, 1 );
+        if( !payloadBuffer )
+        {
+            return NULL;
+        }
+        AiaFree( emitter->payloadBuffer );
+        emitter->payloadBuffer = payloadBuffer;
+        emitter->payloadBufferSize = bufferSize;
+    }
+    return emitter->payloadBuffer + headroom;
+}
+
+/**
+ * Releases the MQTT message being assembled and gets ready to start a new
+ * message.
+ *
+ * @param emitter The emitter to use.
+ */
+static void AiaEmitter_ReleaseMqttPayload( AiaEmitter_t* emitter )
+{
+    if( emitter->currentPublish )
+    {
+        AiaEmitter_FreePublish( emitter, emitter->currentPublish );
+        emitter->currentPublish = NULL;
+    }
+    else if( emitter->mqttPayloadStart && !emitter->isPayloadBufferReused )
+    {
+        AiaFree( emitter->mqttPayloadStart - emitter->publishHeadroom );
+    }
+    emitter->mqttPayloadStart = NULL;
+    emitter->mqttPayloadEnd = NULL;
+    emitter->mqttPayloadSize = 0;
+}
+
+/**
+ * Writes the common header of a new MQTT message, leaving space for the
+ * sequence numbers, which are written when the message is published, and the
+ * IV and MAC, which are written in place when the message is encrypted.
+ *
+ * @param emitter The emitter to use.
+ * @return @c true if the header was written, else @c false.
+ */
+static bool AiaEmitter_ReserveCommonHeader( AiaEmitter_t* emitter )
+{
+    emitter->mqttPayloadEnd = emitter->mqttPayloadStart;
+    if( !AiaEmitter_AppendUint32ToMqttPayload( emitter, 0 ) )
+    {
+        AiaLogError( "Failed to append sequence number to message." );
+        return false;
+    }
+    emitter->mqttPayloadEnd =
+        emitter->mqttPayloadStart + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    if( !AiaEmitter_AppendUint32ToMqttPayload( emitter, 0 ) )
+    {
+        AiaLogError( "Failed to append encrypted sequence number to message." );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Writes a sequence number into both sequence number fields of the common
+ * header of an MQTT message. The encrypted field is written in plaintext and
+ * encrypted in place along with the rest of the message.
+ *
+ * @param payload The MQTT message.
+ * @param sequenceNumber The sequence number to write.
+ */
+static void AiaEmitter_StampSequenceNumber( uint8_t* payload,
+                                            AiaSequenceNumber_t sequenceNumber )
+{
+    AiaEndian_StoreLe32( payload, sequenceNumber );
+    AiaEndian_StoreLe32( payload + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+                         sequenceNumber );
+}
+
 /**
  * Sets up the emitter to start a new JSON MQTT message.
  *
@@ -200,7 +450,8 @@ static bool AiaEmitter_InitializeJsonMqttMessage(
 
     /* Allocate space for the entire MQTT payload up-front and we'll accumulate
      * into it. */
-    emitter->mqttPayloadStart = AiaCalloc( mqttPayloadSize, 1 );
+    emitter->mqttPayloadStart =
+        AiaEmitter_AcquireMqttPayload( emitter, mqttPayloadSize );
     if( !emitter->mqttPayloadStart )
     {
         AiaLogError( "Failed to allocate memory for MQTT message (size=%zu).",
@@ -211,10 +462,11 @@ static bool AiaEmitter_InitializeJsonMqttMessage(
     /* Record new mqttPayload size info. */
     emitter->mqttPayloadSize = mqttPayloadSize;
 
-    /* Move the end cursor to skip over the common header (we'll initialize this
-     * after we've collected the entire payload). */
-    emitter->mqttPayloadEnd =
-        emitter->mqttPayloadStart + AIA_SIZE_OF_COMMON_HEADER;
+    if( !AiaEmitter_ReserveCommonHeader( emitter ) )
+    {
+        AiaEmitter_ReleaseMqttPayload( emitter );
+        return false;
+    }
 
     /* If we're building a JSON array, add the enclosing object and array
      * name. */
@@ -225,14 +477,14 @@ static bool AiaEmitter_InitializeJsonMqttMessage(
                 sizeof( JSON_ARRAY_MESSAGE_PREFIX1 ) - 1 ) )
         {
             AiaLogError( "Failed to append prefix1 to message." );
-            AiaFree( emitter->mqttPayloadStart );
+            AiaEmitter_ReleaseMqttPayload( emitter );
             return false;
         }
         if( !AiaEmitter_AppendBytesToMqttPayload( emitter, jsonArrayName,
                                                   jsonArrayNameLength ) )
         {
             AiaLogError( "Failed to append array name to message." );
-            AiaFree( emitter->mqttPayloadStart );
+            AiaEmitter_ReleaseMqttPayload( emitter );
             return false;
         }
         if( !AiaEmitter_AppendBytesToMqttPayload(
@@ -240,7 +492,7 @@ static bool AiaEmitter_InitializeJsonMqttMessage(
                 sizeof( JSON_ARRAY_MESSAGE_PREFIX2 ) - 1 ) )
         {
             AiaLogError( "Failed to append prefix2 to message." );
-            AiaFree( emitter->mqttPayloadStart );
+            AiaEmitter_ReleaseMqttPayload( emitter );
             return false;
         }
     }
@@ -267,7 +519,8 @@ static bool AiaEmitter_InitializeBinaryMqttMessage(
 
     /* Allocate space for the entire MQTT payload up-front and we'll accumulate
      * into it. */
-    emitter->mqttPayloadStart = AiaCalloc( mqttPayloadSize, 1 );
+    emitter->mqttPayloadStart =
+        AiaEmitter_AcquireMqttPayload( emitter, mqttPayloadSize );
     if( !emitter->mqttPayloadStart )
     {
         AiaLogError(
@@ -279,10 +532,12 @@ static bool AiaEmitter_InitializeBinaryMqttMessage(
     /* Record new mqttPayload size info. */
     emitter->mqttPayloadSize = mqttPayloadSize;
 
-    /* Move the end cursor to skip over the common header (we'll initialize this
-     * after we've collected the entire payload). */
-    emitter->mqttPayloadEnd =
-        emitter->mqttPayloadStart + AIA_SIZE_OF_COMMON_HEADER;
+    if( !AiaEmitter_ReserveCommonHeader( emitter ) )
+    {
+        AiaEmitter_ReleaseMqttPayload( emitter );
+        return false;
+    }
+    emitter->coalescingEntryStart = NULL;
 
     return true;
 }
@@ -367,6 +622,95 @@ static bool AiaEmitter_AppendJsonMqttMessageChunk(
     return true;
 }
 
+/**
+ * Reads the offset of a binary microphone content message which may be
+ * coalesced with adjacent microphone content.
+ *
+ * @param emitter The emitter to use.
+ * @param binaryStreamMessage The binary message to inspect.
+ * @param[out] offset The microphone offset of the audio in @c
+ * binaryStreamMessage.
+ * @return @c true if @c binaryStreamMessage is microphone content carrying
+ * audio, else @c false.
+ */
+static bool AiaEmitter_GetMicrophoneContentOffset(
+    const AiaEmitter_t* emitter, const AiaBinaryMessage_t* binaryStreamMessage,
+    AiaBinaryAudioStreamOffset_t* offset )
+{
+    if( AIA_TOPIC_MICROPHONE != emitter->topic ||
+        AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE !=
+            AiaBinaryMessage_GetType( binaryStreamMessage ) ||
+        AiaBinaryMessage_GetLength( binaryStreamMessage ) <=
+            sizeof( AiaBinaryAudioStreamOffset_t ) )
+    {
+        return false;
+    }
+    const uint8_t* data =
+        (const uint8_t*)AiaBinaryMessage_GetData( binaryStreamMessage );
+    *offset = 0;
+    for( size_t i = 0; i < sizeof( AiaBinaryAudioStreamOffset_t ); ++i )
+    {
+        *offset |= (AiaBinaryAudioStreamOffset_t)data[ i ] << ( i * 8 );
+    }
+    return true;
+}
+
+/**
+ * Attempts to coalesce a binary microphone content chunk into the previous
+ * binary stream entry of the MQTT message being assembled.  This is possible
+ * when the previous entry also holds microphone content and the audio in the
+ * chunk immediately follows it, in which case only the audio is appended and
+ * the previous entry's length is extended, saving a binary stream header and
+ * offset.
+ *
+ * @param emitter The emitter to use.
+ * @param binaryStreamMessage The binary message to coalesce.
+ * @return @c true if the chunk was coalesced, else @c false.
+ */
+static bool AiaEmitter_CoalesceMicrophoneContent(
+    AiaEmitter_t* emitter, const AiaBinaryMessage_t* binaryStreamMessage )
+{
+    AiaBinaryAudioStreamOffset_t offset = 0;
+    if( !emitter->coalescingEntryStart ||
+        !AiaEmitter_GetMicrophoneContentOffset( emitter, binaryStreamMessage,
+                                                &offset ) ||
+        offset != emitter->coalescingEntryNextOffset )
+    {
+        return false;
+    }
+
+    AiaBinaryMessageLength_t entryLength = 0;
+    for( size_t i = 0; i < sizeof( entryLength ); ++i )
+    {
+        AiaBinaryMessageLength_t byte = emitter->coalescingEntryStart[ i ];
+        entryLength |= byte << ( i * 8 );
+    }
+    AiaBinaryMessageLength_t audioSize =
+        AiaBinaryMessage_GetLength( binaryStreamMessage ) -
+        sizeof( AiaBinaryAudioStreamOffset_t );
+    if( entryLength > (AiaBinaryMessageLength_t)~0 - audioSize )
+    {
+        return false;
+    }
+
+    const uint8_t* audio =
+        (const uint8_t*)AiaBinaryMessage_GetData( binaryStreamMessage ) +
+        sizeof( AiaBinaryAudioStreamOffset_t );
+    if( !AiaEmitter_AppendBytesToMqttPayload( emitter, audio, audioSize ) )
+    {
+        AiaLogError( "Failed to append coalesced microphone content." );
+        return false;
+    }
+    entryLength += audioSize;
+    for( size_t i = 0; i < sizeof( entryLength ); ++i )
+    {
+        emitter->coalescingEntryStart[ i ] = entryLength >> ( i * 8 );
+    }
+    emitter->coalescingEntryNextOffset += audioSize;
+
+    return true;
+}
+
 /**
  * Appends a binary chunk to an ongoing MQTT message being assembled.
  *
@@ -389,7 +733,14 @@ static bool AiaEmitter_AppendBinaryMqttMessageChunk(
         return false;
     }
 
+    /* Contiguous microphone content only needs a single header. */
+    if( AiaEmitter_CoalesceMicrophoneContent( emitter, binaryStreamMessage ) )
+    {
+        return true;
+    }
+
     /* Build the message directly into our MQTT payload array. */
+    uint8_t* entryStart = emitter->mqttPayloadEnd;
     if( !AiaBinaryMessage_BuildMessage(
             binaryStreamMessage, emitter->mqttPayloadEnd,
             AiaEmitter_MqttPayloadSpaceRemaining( emitter ) ) )
@@ -399,6 +750,21 @@ static bool AiaEmitter_AppendBinaryMqttMessageChunk(
     }
     emitter->mqttPayloadEnd += AiaMessage_GetSize( chunkForMessage );
 
+    /* Track whether the next chunk may be coalesced into this one. */
+    AiaBinaryAudioStreamOffset_t offset = 0;
+    if( AiaEmitter_GetMicrophoneContentOffset( emitter, binaryStreamMessage,
+                                               &offset ) )
+    {
+        emitter->coalescingEntryStart = entryStart;
+        emitter->coalescingEntryNextOffset =
+            offset + AiaBinaryMessage_GetLength( binaryStreamMessage ) -
+            sizeof( AiaBinaryAudioStreamOffset_t );
+    }
+    else
+    {
+        emitter->coalescingEntryStart = NULL;
+    }
+
     return true;
 }
 
@@ -428,8 +794,31 @@ static bool AiaEmitter_AppendMqttMessageChunk(
                 AiaJsonMessage_FromMessage( chunkForMessage ) );
             return true;
         case AIA_TOPIC_TYPE_BINARY:
-            if( !AiaEmitter_AppendBinaryMqttMessageChunk( emitter,
-                                                          chunkForMessage ) )
+        {
+#ifdef AIA_ENABLE_TRACE
+            AiaBinaryAudioStreamOffset_t traceOffset = 0;
+            bool isMicrophoneContent = AiaEmitter_GetMicrophoneContentOffset(
+                emitter, AiaBinaryMessage_FromMessage( chunkForMessage ),
+                &traceOffset );
+            if( isMicrophoneContent )
+            {
+                AiaTrace_End( AIA_TRACE_MICROPHONE_REGULATE,
+                              AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN, traceOffset );
+                AiaTrace_Begin( AIA_TRACE_MICROPHONE_EMIT,
+                                AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                                traceOffset );
+            }
+#endif
+            bool appended = AiaEmitter_AppendBinaryMqttMessageChunk(
+                emitter, chunkForMessage );
+#ifdef AIA_ENABLE_TRACE
+            if( isMicrophoneContent )
+            {
+                AiaTrace_End( AIA_TRACE_MICROPHONE_EMIT,
+                              AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN, traceOffset );
+            }
+#endif
+            if( !appended )
             {
                 AiaLogError( "Failed to append chunk for topic %s",
                              AiaTopic_ToString( emitter->topic ) );
@@ -438,6 +827,7 @@ static bool AiaEmitter_AppendMqttMessageChunk(
             AiaBinaryMessage_Destroy(
                 AiaBinaryMessage_FromMessage( chunkForMessage ) );
             return true;
+        }
     }
 
     AiaLogError( "Unknown topic %s.", AiaTopic_ToString( emitter->topic ) );
@@ -483,7 +873,12 @@ static bool AiaEmitter_TerminateMqttMessage( AiaEmitter_t* emitter )
             successful = AiaEmitter_TerminateJsonMqttMessage( emitter );
             break;
         case AIA_TOPIC_TYPE_BINARY:
-            /* No termination needed for binary messages. */
+            /* No termination needed for binary messages, but coalesced
+             * microphone content leaves unused space at the end of the
+             * payload. */
+            emitter->mqttPayloadSize =
+                emitter->mqttPayloadEnd - emitter->mqttPayloadStart;
+            emitter->coalescingEntryStart = NULL;
             successful = true;
             break;
     }
@@ -503,88 +898,269 @@ static bool AiaEmitter_TerminateMqttMessage( AiaEmitter_t* emitter )
         return false;
     }
 
-    AiaSequenceNumber_t nextSequenceNumber =
-        AiaAtomic_Load_u32( &emitter->nextSequenceNumber );
+    return true;
+}
 
-    /* Write the encrypted sequence number field. */
-    emitter->mqttPayloadEnd =
-        emitter->mqttPayloadStart + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
-    if( !AiaEmitter_AppendUint32ToMqttPayload( emitter, nextSequenceNumber ) )
+/**
+ * Publishes an MQTT message and updates the metrics of @c emitter.
+ *
+ * @param emitter The emitter to use.
+ * @param qos The quality of service to publish the message with.
+ * @param payload The message to publish, preceded by @c publishHeadroom
+ *     bytes which may be overwritten.
+ * @param payloadSize The size of @c payload.
+ * @param sequenceNumber The sequence number of the message, used for tracing.
+ * @param offset The microphone offset the message's audio ends at, used for
+ *     tracing.
+ * @return @c true if publishing was successful, else @c false.
+ */
+static bool AiaEmitter_Publish( AiaEmitter_t* emitter, AiaMqttQos_t qos,
+                                uint8_t* payload, size_t payloadSize,
+                                AiaSequenceNumber_t sequenceNumber,
+                                AiaBinaryAudioStreamOffset_t offset )
+{
+#ifdef AIA_ENABLE_TRACE
+    /* Microphone messages are tagged with the offset their audio ends at. */
+    bool isMicrophone = AIA_TOPIC_MICROPHONE == emitter->topic;
+    if( isMicrophone )
     {
-        AiaLogError( "Failed to append encrypted sequence number to message." );
-        return false;
+        AiaTrace_Begin( AIA_TRACE_MICROPHONE_PUBLISH, sequenceNumber, offset );
     }
-
-    /* Encrypt the message. */
-    size_t ivSize = AIA_COMMON_HEADER_IV_SIZE;
-    size_t macSize = AIA_COMMON_HEADER_MAC_SIZE;
-    uint8_t iv[ ivSize ];
-    uint8_t mac[ macSize ];
-    uint8_t* encryptedPayload =
-        emitter->mqttPayloadStart + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
-    size_t encryptedSize =
-        emitter->mqttPayloadSize - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
-    if( !AiaSecretManager_Encrypt( emitter->secretManager, emitter->topic,
-                                   nextSequenceNumber, encryptedPayload,
-                                   encryptedSize, encryptedPayload, iv,
-                                   sizeof( iv ), mac, sizeof( mac ) ) )
+#else
+    (void)sequenceNumber;
+    (void)offset;
+#endif
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+    bool published = AiaMqttPublishWithHeadroom(
+        emitter->mqttConnection, qos, emitter->fullTopic,
+        emitter->fullTopicLength, payload, payloadSize );
+#else
+    bool published =
+        AiaMqttPublish( emitter->mqttConnection, qos, emitter->fullTopic,
+                        emitter->fullTopicLength, payload, payloadSize );
+#endif
+#ifdef AIA_ENABLE_TRACE
+    if( isMicrophone )
     {
-        AiaLogError( "Encryption failed." );
+        AiaTrace_End( AIA_TRACE_MICROPHONE_PUBLISH, sequenceNumber, offset );
+    }
+#endif
+    if( !published )
+    {
+        AiaLogError( "Failed to publish mqtt message on topic %s.",
+                     AiaTopic_ToString( emitter->topic ) );
         return false;
     }
+    AiaAtomic_Add_u32( &emitter->metrics.messagesPublished, 1 );
+    AiaAtomic_Add_u32( &emitter->metrics.bytesPublished,
+                       (uint32_t)payloadSize );
+    AiaAtomic_Store_u32( &emitter->metrics.lastPublishTimeMs,
+                         (uint32_t)AiaClock( GetTimeMs )() );
+    return true;
+}
 
-    /* Fill out the common header. */
-    emitter->mqttPayloadEnd = emitter->mqttPayloadStart;
-    if( !AiaEmitter_AppendUint32ToMqttPayload( emitter, nextSequenceNumber ) )
+/**
+ * Publishes the messages handed off to the in-flight window of an @c
+ * AiaEmitter_t, returning each entry to the window once it completes.
+ *
+ * @param context The @c AiaEmitter_t to act on.
+ */
+static void AiaEmitter_PublishRoutine( void* context )
+{
+    AiaEmitter_t* emitter = (AiaEmitter_t*)context;
+    AiaAssert( emitter );
+    if( !emitter )
     {
-        AiaLogError( "Failed to append sequence number to message." );
-        return false;
+        AiaLogError( "Null emitter." );
+        return;
     }
-    if( !AiaEmitter_AppendBytesToMqttPayload( emitter, iv,
-                                              AiaArrayLength( iv ) ) )
+
+    AiaMutex( Lock )( &emitter->publishWorkerMutex );
+    AiaAtomicBool_Clear( &emitter->isPublishPending );
+    while( true )
     {
-        AiaLogError( "Failed to append IV to message." );
-        return false;
+        AiaMutex( Lock )( &emitter->publishesMutex );
+        AiaEmitterPublish_t* publish = (AiaEmitterPublish_t*)AiaListDouble(
+            RemoveHead )( &emitter->pendingPublishes );
+        AiaMutex( Unlock )( &emitter->publishesMutex );
+        if( !publish )
+        {
+            break;
+        }
+        if( !AiaEmitter_Publish(
+                emitter, publish->qos,
+                publish->payload + emitter->publishHeadroom,
+                publish->payloadSize, publish->sequenceNumber,
+                publish->offset ) )
+        {
+            AiaEmitter_ReleaseSequenceNumber( emitter,
+                                              publish->sequenceNumber );
+            AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
+        }
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+        else
+        {
+            AiaHistogram_Record(
+                &emitter->metrics.publishTimeMs,
+                (uint32_t)( AiaClock( GetTimeMs )() - publish->submitTimeMs ) );
+        }
+#endif
+        AiaEmitter_FreePublish( emitter, publish );
     }
-    if( !AiaEmitter_AppendBytesToMqttPayload( emitter, mac,
-                                              AiaArrayLength( mac ) ) )
+    AiaMutex( Unlock )( &emitter->publishWorkerMutex );
+}
+
+/**
+ * Queues an entry of the in-flight window for @c publishWorker.
+ *
+ * @param emitter The emitter to use.
+ * @param publish The entry to queue.
+ */
+static void AiaEmitter_QueuePublish( AiaEmitter_t* emitter,
+                                     AiaEmitterPublish_t* publish )
+{
+    AiaMutex( Lock )( &emitter->publishesMutex );
+    AiaListDouble( InsertTail )( &emitter->pendingPublishes, &publish->link );
+    AiaMutex( Unlock )( &emitter->publishesMutex );
+
+    if( !AiaAtomicBool_Load( &emitter->isPublishPending ) )
     {
-        AiaLogError( "Failed to append MAC to message." );
-        return false;
+        AiaAtomicBool_Set( &emitter->isPublishPending );
+        if( !AiaTimer( Arm )( &emitter->publishWorker, 0, 0 ) )
+        {
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+            AiaAtomicBool_Clear( &emitter->isPublishPending );
+        }
     }
+}
 
-    return true;
+/**
+ * Completes the encryption of an entry of the in-flight window by queuing it
+ * for @c publishWorker.
+ *
+ * @param success Whether the encryption succeeded.
+ * @param userData The @c AiaEmitterPublish_t that was encrypted.
+ */
+static void AiaEmitter_OnPublishEncrypted( bool success, void* userData )
+{
+    AiaEmitterPublish_t* publish = (AiaEmitterPublish_t*)userData;
+    AiaAssert( publish );
+    if( !publish )
+    {
+        AiaLogError( "Null publish." );
+        return;
+    }
+    AiaEmitter_t* emitter = publish->emitter;
+    if( !success )
+    {
+        AiaLogError( "Encryption failed." );
+        AiaEmitter_ReleaseSequenceNumber( emitter, publish->sequenceNumber );
+        AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
+        AiaEmitter_FreePublish( emitter, publish );
+        return;
+    }
+    AiaEmitter_QueuePublish( emitter, publish );
 }
 
 /**
- * Publishes an MQTT message that has been finalized by @c emitter.
+ * Encrypts and publishes an MQTT message that has been finalized by @c
+ * emitter.  If asynchronous publishing is enabled, the message is instead
+ * submitted for encryption and then handed off to @c publishWorker.
  *
  * @param emitter The emitter to use.
- * @return @c true if publishing was successful, else @c false.
+ * @return @c true if publishing (or handing off) was successful, else @c
+ *     false.
  */
 static bool AiaEmitter_PublishMqttMessage( AiaEmitter_t* emitter )
 {
-    size_t topicLength = AiaTopic_GetLength( emitter->topic );
-    char topic[ emitter->deviceTopicRootSize + topicLength ];
-    strncpy( topic, emitter->deviceTopicRoot, emitter->deviceTopicRootSize );
-    strncpy( topic + emitter->deviceTopicRootSize,
-             AiaTopic_ToString( emitter->topic ), topicLength );
-    if( !AiaMqttPublish( emitter->mqttConnection, AIA_MQTT_QOS0, topic,
-                         emitter->deviceTopicRootSize + topicLength,
-                         emitter->mqttPayloadStart, emitter->mqttPayloadSize ) )
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+#endif
+    AiaSequenceNumber_t sequenceNumber;
+    AiaEmitter_ReserveSequenceNumber( emitter, &sequenceNumber );
+    AiaEmitter_StampSequenceNumber( emitter->mqttPayloadStart, sequenceNumber );
+    AiaEmitterPublish_t* publish = emitter->currentPublish;
+    if( publish )
     {
-        AiaLogError( "Failed to publish mqtt message on topic %s.",
-                     AiaTopic_ToString( emitter->topic ) );
+        uint8_t* payload = emitter->mqttPayloadStart;
+        size_t payloadSize = emitter->mqttPayloadSize;
+        publish->payloadSize = payloadSize;
+        publish->qos = emitter->qos;
+        publish->sequenceNumber = sequenceNumber;
+        publish->offset = emitter->coalescingEntryNextOffset;
+        publish->emitter = emitter;
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+        publish->submitTimeMs = startMs;
+#endif
+
+        /* Ownership of the entry passes to the encryption. */
+        emitter->currentPublish = NULL;
+        emitter->mqttPayloadStart = NULL;
+        emitter->mqttPayloadEnd = NULL;
+        emitter->mqttPayloadSize = 0;
+
+        uint8_t* encryptedPayload =
+            payload + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+        AiaCryptoSegment_t segment;
+        segment.input = encryptedPayload;
+        segment.output = encryptedPayload;
+        segment.length =
+            payloadSize - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+        AiaCryptoRequest_t request;
+        request.segments = &segment;
+        request.numSegments = 1;
+        request.iv = payload + sizeof( AiaSequenceNumber_t );
+        request.ivLen = AIA_COMMON_HEADER_IV_SIZE;
+        request.tag = request.iv + AIA_COMMON_HEADER_IV_SIZE;
+        request.tagLen = AIA_COMMON_HEADER_MAC_SIZE;
+        request.onComplete = AiaEmitter_OnPublishEncrypted;
+        request.userData = publish;
+        if( !AiaSecretManager_SubmitEncrypt( emitter->secretManager,
+                                             emitter->topic, sequenceNumber,
+                                             &request ) )
+        {
+            AiaLogError( "AiaSecretManager_SubmitEncrypt failed." );
+            AiaEmitter_ReleaseSequenceNumber( emitter, sequenceNumber );
+            AiaEmitter_FreePublish( emitter, publish );
+            return false;
+        }
+        return true;
+    }
+
+    /* Encrypt the message in place, writing the IV and MAC straight into the
+     * common header. */
+    uint8_t* iv = emitter->mqttPayloadStart + sizeof( AiaSequenceNumber_t );
+    uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    uint8_t* encryptedPayload =
+        emitter->mqttPayloadStart + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    size_t encryptedSize =
+        emitter->mqttPayloadSize - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    if( !AiaSecretManager_Encrypt(
+            emitter->secretManager, emitter->topic, sequenceNumber,
+            encryptedPayload, encryptedSize, encryptedPayload, iv,
+            AIA_COMMON_HEADER_IV_SIZE, mac, AIA_COMMON_HEADER_MAC_SIZE ) )
+    {
+        AiaLogError( "Encryption failed." );
+        AiaEmitter_ReleaseSequenceNumber( emitter, sequenceNumber );
         return false;
     }
-    AiaAtomic_Add_u32( &emitter->nextSequenceNumber, 1 );
+
+    if( !AiaEmitter_Publish( emitter, emitter->qos, emitter->mqttPayloadStart,
+                             emitter->mqttPayloadSize, sequenceNumber,
+                             emitter->coalescingEntryNextOffset ) )
+    {
+        AiaEmitter_ReleaseSequenceNumber( emitter, sequenceNumber );
+        return false;
+    }
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Record( &emitter->metrics.publishTimeMs,
+                         (uint32_t)( AiaClock( GetTimeMs )() - startMs ) );
+#endif
 
     /* If we published successfully, clean up and get ready to start a new
      * message. */
-    AiaFree( emitter->mqttPayloadStart );
-    emitter->mqttPayloadStart = NULL;
-    emitter->mqttPayloadEnd = NULL;
-    emitter->mqttPayloadSize = 0;
+    AiaEmitter_ReleaseMqttPayload( emitter );
 
     return true;
 }
@@ -615,6 +1191,7 @@ bool AiaEmitter_EmitMessageChunk( AiaEmitter_t* emitter,
         {
             AiaLogError( "Failed to initialize MQTT message for topic %s.",
                          AiaTopic_ToString( emitter->topic ) );
+            AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
             return false;
         }
     }
@@ -625,6 +1202,7 @@ bool AiaEmitter_EmitMessageChunk( AiaEmitter_t* emitter,
     {
         AiaLogError( "Failed to append chunk to MQTT message for topic %s.",
                      AiaTopic_ToString( emitter->topic ) );
+        AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
         return false;
     }
 
@@ -635,12 +1213,14 @@ bool AiaEmitter_EmitMessageChunk( AiaEmitter_t* emitter,
         {
             AiaLogError( "Failed to terminate MQTT message for topic %s.",
                          AiaTopic_ToString( emitter->topic ) );
+            AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
             return false;
         }
         if( !AiaEmitter_PublishMqttMessage( emitter ) )
         {
             AiaLogError( "Failed to publish MQTT message for topic %s.",
                          AiaTopic_ToString( emitter->topic ) );
+            AiaAtomic_Add_u32( &emitter->metrics.failures, 1 );
             return false;
         }
     }
@@ -671,17 +1251,20 @@ AiaEmitter_t* AiaEmitter_Create( AiaMqttConnectionPointer_t mqttConnection,
         return NULL;
     }
 
+    /* Build the full topic once up-front so that it doesn't need to be
+     * reassembled for every publish. */
+    size_t topicLength = AiaTopic_GetLength( topic );
     AiaEmitter_t* emitter = (AiaEmitter_t*)AiaCalloc(
-        1, sizeof( AiaEmitter_t ) + deviceTopicRootSize );
+        1, sizeof( AiaEmitter_t ) + deviceTopicRootSize + topicLength );
     if( !emitter )
     {
         AiaLogError( "AiaCalloc failed." );
         return NULL;
     }
 
-    emitter->deviceTopicRoot = (char*)( emitter + 1 );
+    emitter->fullTopic = (char*)( emitter + 1 );
 
-    deviceTopicRootSize = AiaGetDeviceTopicRootString( emitter->deviceTopicRoot,
+    deviceTopicRootSize = AiaGetDeviceTopicRootString( emitter->fullTopic,
                                                        deviceTopicRootSize );
     if( !deviceTopicRootSize )
     {
@@ -689,11 +1272,18 @@ AiaEmitter_t* AiaEmitter_Create( AiaMqttConnectionPointer_t mqttConnection,
         AiaFree( emitter );
         return NULL;
     }
-    emitter->deviceTopicRootSize = deviceTopicRootSize;
+    memcpy( emitter->fullTopic + deviceTopicRootSize,
+            AiaTopic_ToString( topic ), topicLength );
+    emitter->fullTopicLength = deviceTopicRootSize + topicLength;
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+    emitter->publishHeadroom =
+        AIA_MQTT_PUBLISH_HEADROOM( emitter->fullTopicLength );
+#endif
 
     *(AiaMqttConnectionPointer_t*)&emitter->mqttConnection = mqttConnection;
     *(AiaSecretManager_t**)&emitter->secretManager = secretManager;
     *(AiaTopic_t*)&emitter->topic = topic;
+    emitter->qos = AIA_MQTT_QOS0;
 
     return emitter;
 }
@@ -706,13 +1296,251 @@ void AiaEmitter_Destroy( AiaEmitter_t* emitter )
         return;
     }
 
-    if( emitter->mqttPayloadStart )
+    AiaEmitter_ReleaseMqttPayload( emitter );
+    if( emitter->publishes )
     {
-        AiaFree( emitter->mqttPayloadStart );
+        AiaTimer( Destroy )( &emitter->publishWorker );
+        size_t dropped = AiaListDouble( Count )( &emitter->pendingPublishes );
+        if( dropped )
+        {
+            AiaLogWarn( "Dropping %zu unpublished messages on topic %s.",
+                        dropped, AiaTopic_ToString( emitter->topic ) );
+        }
+        AiaMutex( Destroy )( &emitter->publishWorkerMutex );
+        AiaSemaphore( Destroy )( &emitter->freePublishesCount );
+        AiaMutex( Destroy )( &emitter->publishesMutex );
+        for( size_t i = 0; i < emitter->maxInFlight; ++i )
+        {
+            AiaFree( emitter->publishes[ i ].payload );
+        }
+        AiaFree( emitter->publishes );
     }
+    AiaFree( emitter->payloadBuffer );
     AiaFree( emitter );
 }
 
+bool AiaEmitter_EnablePayloadBufferReuse( AiaEmitter_t* emitter,
+                                          size_t maxMessageSize )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( !maxMessageSize )
+    {
+        AiaLogError( "Zero maxMessageSize." );
+        return false;
+    }
+    if( emitter->mqttPayloadStart )
+    {
+        AiaLogError( "Cannot enable payload buffer reuse mid-message." );
+        return false;
+    }
+    if( emitter->publishes )
+    {
+        AiaLogDebug( "Buffers are already reused by the in-flight window." );
+        return true;
+    }
+
+    /* Size the buffer for a full message, including any JSON array syntax
+     * around it. */
+    size_t payloadBufferSize =
+        emitter->publishHeadroom + AIA_SIZE_OF_COMMON_HEADER + maxMessageSize;
+    if( AIA_TOPIC_TYPE_JSON == AiaTopic_GetType( emitter->topic ) &&
+        AiaTopic_GetJsonArrayName( emitter->topic ) )
+    {
+        payloadBufferSize += sizeof( JSON_ARRAY_MESSAGE_PREFIX1 ) - 1 +
+                             AiaTopic_GetJsonArrayNameLength( emitter->topic ) +
+                             sizeof( JSON_ARRAY_MESSAGE_PREFIX2 ) - 1 +
+                             sizeof( JSON_ARRAY_MESSAGE_SUFFIX ) - 1;
+    }
+    if( payloadBufferSize <= emitter->payloadBufferSize )
+    {
+        emitter->isPayloadBufferReused = true;
+        return true;
+    }
+
+    uint8_t* payloadBuffer = AiaCalloc( payloadBufferSize, 1 );
+    if( !payloadBuffer )
+    {
+        AiaLogError( "AiaCalloc failed (size=%zu).", payloadBufferSize );
+        return false;
+    }
+    AiaFree( emitter->payloadBuffer );
+    emitter->payloadBuffer = payloadBuffer;
+    emitter->payloadBufferSize = payloadBufferSize;
+    emitter->isPayloadBufferReused = true;
+
+    return true;
+}
+
+bool AiaEmitter_EnableAsyncPublish( AiaEmitter_t* emitter, size_t maxInFlight )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( !maxInFlight )
+    {
+        AiaLogError( "Zero maxInFlight." );
+        return false;
+    }
+    if( emitter->mqttPayloadStart )
+    {
+        AiaLogError( "Cannot enable asynchronous publishing mid-message." );
+        return false;
+    }
+    if( emitter->publishes )
+    {
+        AiaLogError( "Asynchronous publishing is already enabled." );
+        return false;
+    }
+
+    AiaEmitterPublish_t* publishes =
+        AiaCalloc( maxInFlight, sizeof( AiaEmitterPublish_t ) );
+    if( !publishes )
+    {
+        AiaLogError( "AiaCalloc failed (count=%zu).", maxInFlight );
+        return false;
+    }
+    if( !AiaMutex( Create )( &emitter->publishesMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( publishes );
+        return false;
+    }
+    if( !AiaSemaphore( Create )( &emitter->freePublishesCount, maxInFlight,
+                                 maxInFlight ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &emitter->publishesMutex );
+        AiaFree( publishes );
+        return false;
+    }
+    if( !AiaMutex( Create )( &emitter->publishWorkerMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaSemaphore( Destroy )( &emitter->freePublishesCount );
+        AiaMutex( Destroy )( &emitter->publishesMutex );
+        AiaFree( publishes );
+        return false;
+    }
+    if( !AiaTimer( Create )( &emitter->publishWorker,
+                             AiaEmitter_PublishRoutine, emitter ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &emitter->publishWorkerMutex );
+        AiaSemaphore( Destroy )( &emitter->freePublishesCount );
+        AiaMutex( Destroy )( &emitter->publishesMutex );
+        AiaFree( publishes );
+        return false;
+    }
+
+    AiaListDouble( Create )( &emitter->freePublishes );
+    AiaListDouble( Create )( &emitter->pendingPublishes );
+    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
+    for( size_t i = 0; i < maxInFlight; ++i )
+    {
+        publishes[ i ].link = defaultLink;
+        AiaListDouble( InsertTail )( &emitter->freePublishes,
+                                     &publishes[ i ].link );
+    }
+
+    /* Any reused buffer becomes the first entry's buffer. */
+    publishes[ 0 ].payload = emitter->payloadBuffer;
+    publishes[ 0 ].payloadCapacity = emitter->payloadBufferSize;
+    emitter->payloadBuffer = NULL;
+    emitter->payloadBufferSize = 0;
+
+    AiaAtomicBool_Clear( &emitter->isPublishPending );
+    emitter->maxInFlight = maxInFlight;
+    emitter->publishes = publishes;
+
+    return true;
+}
+
+size_t AiaEmitter_TrimMemory( AiaEmitter_t* emitter )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return 0;
+    }
+
+    size_t released = 0;
+    if( emitter->publishes )
+    {
+        /* Entries being assembled or published are not in the free list. */
+        AiaMutex( Lock )( &emitter->publishesMutex );
+        AiaListDouble( Link_t )* link = NULL;
+        AiaListDouble( ForEach )( &emitter->freePublishes, link )
+        {
+            AiaEmitterPublish_t* publish = (AiaEmitterPublish_t*)link;
+            released += publish->payloadCapacity;
+            AiaFree( publish->payload );
+            publish->payload = NULL;
+            publish->payloadCapacity = 0;
+        }
+        AiaMutex( Unlock )( &emitter->publishesMutex );
+    }
+    else if( emitter->payloadBuffer && !emitter->mqttPayloadStart )
+    {
+        released = emitter->payloadBufferSize;
+        AiaFree( emitter->payloadBuffer );
+        emitter->payloadBuffer = NULL;
+        emitter->payloadBufferSize = 0;
+    }
+    return released;
+}
+
+bool AiaEmitter_FlushPublishes( AiaEmitter_t* emitter )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( !emitter->publishes )
+    {
+        return true;
+    }
+    if( emitter->mqttPayloadStart )
+    {
+        AiaLogError( "Cannot flush publishes mid-message." );
+        return false;
+    }
+
+    /* Every entry is free once all handed off messages have completed. */
+    for( size_t i = 0; i < emitter->maxInFlight; ++i )
+    {
+        AiaSemaphore( Wait )( &emitter->freePublishesCount );
+    }
+    for( size_t i = 0; i < emitter->maxInFlight; ++i )
+    {
+        AiaSemaphore( Post )( &emitter->freePublishesCount );
+    }
+
+    return true;
+}
+
+bool AiaEmitter_SetQos( AiaEmitter_t* emitter, AiaMqttQos_t qos )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( AIA_MQTT_QOS0 != qos && AIA_MQTT_QOS1 != qos )
+    {
+        AiaLogError( "Unsupported qos (%d).", qos );
+        return false;
+    }
+    emitter->qos = qos;
+    return true;
+}
+
 bool AiaEmitter_GetNextSequenceNumber( AiaEmitter_t* emitter,
                                        AiaSequenceNumber_t* nextSequenceNumber )
 {
@@ -729,3 +1557,64 @@ bool AiaEmitter_GetNextSequenceNumber( AiaEmitter_t* emitter,
     *nextSequenceNumber = AiaAtomic_Load_u32( &emitter->nextSequenceNumber );
     return true;
 }
+
+bool AiaEmitter_ReserveSequenceNumber( AiaEmitter_t* emitter,
+                                       AiaSequenceNumber_t* sequenceNumber )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( !sequenceNumber )
+    {
+        AiaLogError( "Null sequenceNumber." );
+        return false;
+    }
+    *sequenceNumber = AiaAtomic_Add_u32( &emitter->nextSequenceNumber, 1 );
+    return true;
+}
+
+bool AiaEmitter_ReleaseSequenceNumber( AiaEmitter_t* emitter,
+                                       AiaSequenceNumber_t sequenceNumber )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return false;
+    }
+    if( !AiaAtomic_CompareAndSwap_u32( &emitter->nextSequenceNumber,
+                                       sequenceNumber, sequenceNumber + 1 ) )
+    {
+        AiaLogWarn( "Sequence number %" PRIu32 " on topic %s is skipped.",
+                    sequenceNumber, AiaTopic_ToString( emitter->topic ) );
+        return false;
+    }
+    return true;
+}
+
+void AiaEmitter_GetMetrics( AiaEmitter_t* emitter,
+                            AiaEmitterMetrics_t* metrics )
+{
+    if( !emitter )
+    {
+        AiaLogError( "Null emitter." );
+        return;
+    }
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics." );
+        return;
+    }
+    metrics->messagesPublished =
+        AiaAtomic_Load_u32( &emitter->metrics.messagesPublished );
+    metrics->bytesPublished =
+        AiaAtomic_Load_u32( &emitter->metrics.bytesPublished );
+    metrics->failures = AiaAtomic_Load_u32( &emitter->metrics.failures );
+    metrics->lastPublishTimeMs =
+        AiaAtomic_Load_u32( &emitter->metrics.lastPublishTimeMs );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Snapshot( &emitter->metrics.publishTimeMs,
+                           &metrics->publishTimeMs );
+#endif
+}
@@ -25,7 +25,7 @@
 #include <aiaexceptionmanager/aia_exception_constants.h>
 #include <aiaexceptionmanager/aia_exception_manager.h>
 
-#include <aiacore/aia_exception_encountered_utils.h>
+#include <aiacore/aia_exception_limiter.h>
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_topic.h>
 
@@ -34,8 +34,9 @@
 /** Private data for the @c AiaExceptionManager_t type. */
 struct AiaExceptionManager
 {
-    /** Used to publish messages on the event topic. */
-    AiaRegulator_t* const eventRegulator;
+    /** Used to publish rate limited @c MalformedMessage events. This is shared
+     * with the rest of the client and not owned. */
+    AiaExceptionLimiter_t* const exceptionLimiter;
 
     /** Optional callback function to run when Exception directive is received
      */
@@ -48,40 +49,30 @@ struct AiaExceptionManager
 /**
  * An internal function to send a @c MalformedMessage event to the service.
  *
- * @param eventRegulator The eventRegulator used to send outbound messages.
+ * @param exceptionLimiter The limiter used to send outbound messages.
  * @param sequenceNumber The sequence number of the malformed message.
  * @param index The index of the message that was malformed.
  * @param topic The topic that the malformed message was received on.
  */
-static void sendMalformedMessageEvent( AiaRegulator_t* eventRegulator,
+static void sendMalformedMessageEvent( AiaExceptionLimiter_t* exceptionLimiter,
                                        AiaSequenceNumber_t sequenceNumber,
                                        size_t index, AiaTopic_t topic )
 {
-    AiaJsonMessage_t* malformedMessageEvent =
-        generateMalformedMessageExceptionEncounteredEvent( sequenceNumber,
-                                                           index, topic );
-    if( !malformedMessageEvent )
+    if( !AiaExceptionLimiter_ReportMalformedMessage(
+            exceptionLimiter, sequenceNumber, index, topic ) )
     {
-        AiaLogError(
-            "generateMalformedMessageExceptionEncounteredEvent failed" );
-    }
-    else if( !AiaRegulator_Write(
-                 eventRegulator,
-                 AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-    {
-        AiaLogError( "AiaRegulator_Write failed" );
-        AiaJsonMessage_Destroy( malformedMessageEvent );
+        AiaLogError( "AiaExceptionLimiter_ReportMalformedMessage failed" );
     }
 }
 
 AiaExceptionManager_t* AiaExceptionManager_Create(
-    AiaRegulator_t* eventRegulator,
+    AiaExceptionLimiter_t* exceptionLimiter,
     AiaExceptionManagerOnExceptionCallback_t onException,
     void* onExceptionUserData )
 {
-    if( !eventRegulator )
+    if( !exceptionLimiter )
     {
-        AiaLogError( "NULL eventRegulator" );
+        AiaLogError( "NULL exceptionLimiter" );
         return NULL;
     }
 
@@ -94,7 +85,8 @@ AiaExceptionManager_t* AiaExceptionManager_Create(
         return NULL;
     }
 
-    *(AiaRegulator_t**)&exceptionManager->eventRegulator = eventRegulator;
+    *(AiaExceptionLimiter_t**)&exceptionManager->exceptionLimiter =
+        exceptionLimiter;
     *(AiaExceptionManagerOnExceptionCallback_t*)&exceptionManager->onException =
         onException;
     *(void**)&exceptionManager->onExceptionUserData = onExceptionUserData;
@@ -131,14 +123,14 @@ void AiaExceptionManager_OnExceptionReceived(
     {
         AiaLogError( "Failed to parse the %s key in the payload",
                      AIA_EXCEPTION_CODE_KEY );
-        sendMalformedMessageEvent( exceptionManager->eventRegulator,
+        sendMalformedMessageEvent( exceptionManager->exceptionLimiter,
                                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
         return;
     }
     if( !AiaJsonUtils_UnquoteString( &codeStr, &codeLen ) )
     {
         AiaLogError( "Malformed JSON" );
-        sendMalformedMessageEvent( exceptionManager->eventRegulator,
+        sendMalformedMessageEvent( exceptionManager->exceptionLimiter,
                                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
         return;
     }
@@ -147,7 +139,7 @@ void AiaExceptionManager_OnExceptionReceived(
     if( !AiaExceptionCode_FromString( codeStr, codeLen, &code ) )
     {
         AiaLogError( "Invalid code, code=%.*s", codeLen, codeStr );
-        sendMalformedMessageEvent( exceptionManager->eventRegulator,
+        sendMalformedMessageEvent( exceptionManager->exceptionLimiter,
                                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
         return;
     }
@@ -166,7 +158,7 @@ void AiaExceptionManager_OnExceptionReceived(
     else if( !AiaJsonUtils_UnquoteString( &description, &descriptionLen ) )
     {
         AiaLogError( "Malformed JSON" );
-        sendMalformedMessageEvent( exceptionManager->eventRegulator,
+        sendMalformedMessageEvent( exceptionManager->exceptionLimiter,
                                    sequenceNumber, index, AIA_TOPIC_DIRECTIVE );
     }
     else
@@ -27,10 +27,12 @@
 
 #include <aiacore/aia_binary_constants.h>
 #include <aiacore/aia_binary_message.h>
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_events.h>
 #include <aiacore/aia_exception_encountered_utils.h>
 #include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_overload_governor.h>
 #include <aiacore/aia_topic.h>
 
 #include AiaClock( HEADER )
@@ -38,8 +40,75 @@
 #include AiaTimer( HEADER )
 
 #include <inttypes.h>
+#include <stdarg.h>
 #include <stdio.h>
 
+/** The initiator sent for hold to talk interactions. */
+#define HOLD_TO_TALK_INITIATOR \
+    "{\"" AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY "\":\"PRESS_AND_HOLD\"}"
+
+/** The initiator sent for tap to talk interactions. */
+#define TAP_TO_TALK_INITIATOR \
+    "{\"" AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY "\":\"TAP\"}"
+
+/**
+ * The width of an offset field in a preformatted @c MicrophoneOpened payload,
+ * which is enough for any @c AiaBinaryAudioStreamOffset_t.
+ */
+#define MICROPHONE_OPENED_OFFSET_FIELD_WIDTH 20
+
+/**
+ * Room for a @c MicrophoneOpened payload with any initiator generated by this
+ * device. Initiators echoed back from @c OpenMicrophone directives need their
+ * own length on top of this.
+ */
+#define MICROPHONE_OPENED_PAYLOAD_SIZE 320
+
+/**
+ * A @c MicrophoneOpened payload formatted ahead of time. Offsets, which depend
+ * on the position of the stream, are left as blank fixed width fields so that
+ * they can be patched in once @c mutex is held without formatting the whole
+ * payload again.
+ */
+typedef struct AiaMicrophoneOpenedPayload
+{
+    /** The null-terminated payload. */
+    char* buffer;
+
+    /** The size of @c buffer. */
+    size_t size;
+
+    /** The length of the payload. */
+    size_t length;
+
+    /** The position of the stream offset field in @c buffer. */
+    size_t offsetField;
+
+    /** The position of the wake word begin offset field, or zero if there is
+     * no wake word. */
+    size_t beginOffsetField;
+
+    /** The position of the wake word end offset field, or zero if there is no
+     * wake word. */
+    size_t endOffsetField;
+
+    /** The number of preroll samples streamed ahead of the wake word. */
+    size_t prerollSamples;
+
+    /** The number of samples in the wake word. */
+    size_t wakeWordSamples;
+} AiaMicrophoneOpenedPayload_t;
+
+/** The chunk which @c AiaMicrophoneManager_CaptureSpan() captures into. */
+typedef struct AiaMicrophoneCapture
+{
+    /** The @c AiaMicrophoneManager_t capturing the chunk. */
+    const AiaMicrophoneManager_t* microphoneManager;
+
+    /** Where the next captured sample goes. */
+    int16_t* samples;
+} AiaMicrophoneCapture_t;
+
 /** An internal struct used to hold the current microphone state and pending
  * actions. */
 typedef struct AiaCurrentMicrophoneState
@@ -51,6 +120,40 @@ typedef struct AiaCurrentMicrophoneState
      * handled. */
     bool pendingOpenMicrophone;
 
+    /** Indicates the last offset sent to the server so that contiguous offsets
+     * may be sent on subsequent microphone packets. */
+    AiaBinaryAudioStreamOffset_t lastOffsetSent;
+
+    /** The number of samples to read for the next microphone chunk. This starts
+     * at the microphone regulator's cadence when the microphone is opened so
+     * that the first audio is published quickly, and doubles with every chunk
+     * published up to @c AIA_MICROPHONE_CHUNK_SIZE_SAMPLES. */
+    size_t chunkSizeSamples;
+
+    /** Whether voice activity detection has heard speech since the microphone
+     * was opened. */
+    bool vadHeardSpeech;
+
+    /** Whether voice activity detection has reported the end of speech since
+     * the microphone was opened. */
+    bool vadHeardEndOfSpeech;
+
+    /** The number of samples of silence since speech was last heard. */
+    size_t vadSilentSamples;
+
+    /** The end of the wake word being streamed, up to which @c
+     * microphoneBufferReader stays pinned so that the writer cannot overwrite
+     * the preroll and wake word before they are published. */
+    AiaDataStreamIndex_t wakeWordEndIndex;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** Whether no chunk has been published since the microphone was opened. */
+    bool isAwaitingFirstChunk;
+
+    /** When the microphone was opened. */
+    AiaTimepointMs_t openedTimestampMs;
+#endif
+
     /** The timeout in milliseconds for the last OpenMicrophone directive to
      * handle. */
     AiaTimepointMs_t openMicrophoneExpirationTime;
@@ -69,70 +172,203 @@ typedef struct AiaCurrentMicrophoneState
      * OpenMicrophone directives. */
     AiaMicrophoneProfile_t lastProfile;
 
-    /** Indicates the last offset sent to the server so that contiguous offsets
-     * may be sent on subsequent microphone packets. */
-    AiaBinaryAudioStreamOffset_t lastOffsetSent;
-
 } AiaCurrentMicrophoneState_t;
 
+/**
+ * Fields are grouped by how often they are read. Those read every time @c
+ * microphonePublishTimer publishes a chunk come first, starting with the ones
+ * read when there is nothing to publish, and the fields only used to handle
+ * directives and report state changes follow. On 64-bit Linux, a run with
+ * nothing to publish reads the first two cache lines, and the fields read
+ * while streaming take about 360 of this struct's 460 bytes. Fields are
+ * synchronized by @c mutex unless documented otherwise.
+ */
 struct AiaMicrophoneManager
 {
+    /** @name Fields read while streaming. */
+    /** @{ */
+
     /** Mutex used to guard against asynchronous calls in threaded
      * environments. */
     AiaMutex_t mutex;
 
-    /** @name Variables synchronized by mutex. */
-    /** @{ */
-
     /** An object representing the current state of the microphone. */
     AiaCurrentMicrophoneState_t currentMicrophoneState;
 
-    /** Callback to notify of state changes. */
-    const AiaMicrophoneStateObserver_t stateObserver;
-
-    /** Context associated with @c stateObserver. */
-    void* const stateObserverUserData;
-
-    /** @} */
+    /** Whether @c microphoneRegulator is above its high watermark, in which
+     * case streaming pauses and unread audio is left in the microphone buffer.
+     * This should only be accessed using atomic operations. */
+    uint32_t isUplinkBackedUp;
 
     /** Used to read microphone data. */
     AiaDataStreamReader_t* const microphoneBufferReader;
 
-    /** Used to publish outbound events. */
-    AiaRegulator_t* const eventRegulator;
+    /** The number of interleaved channels in each frame of @c
+     * microphoneBufferReader. */
+    const size_t numChannels;
+
+    /** The weight of each channel when mixing down frames read from @c
+     * microphoneBufferReader. This is @c NULL for single channel readers. */
+    AiaPcmGain_t* const channelWeights;
+
+    /** Preallocated buffers and messages used to publish microphone chunks. */
+    AiaBinaryMessagePool_t* const chunkPool;
 
     /** Used to publish outbound microphone binary messages. */
     AiaRegulator_t* const microphoneRegulator;
 
     /** Timer which publishes microphone chunks. */
-    /* Note: This will run every 50ms and collect @c
-     * AIA_MICROPHONE_CHUNK_SIZE_BYTES to publish to the @c regulator. This adds
-     * the overhead of a second 50ms timer in addition to the @c regulator's
-     * 50ms timer. There is not much benefit to aggregating quicker than this
-     * since we'll still be bounded by the 50ms publish rate in the Aia API
-     * specification. */
+    /* Note: This is a one-shot timer which is re-armed after every chunk. When
+     * the reader is at least a chunk behind the writer (e.g. draining wake word
+     * preroll), it is armed for @c MICROPHONE_PUBLISH_RATE so that backlogs are
+     * published at a fixed cadence. Otherwise it is armed immediately, either
+     * by the writer once @c AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES have been
+     * written or by the task itself if they already have, so that the task does
+     * not wake up when there is nothing to publish and live audio does not wait
+     * for the next tick. */
     AiaTimer_t microphonePublishTimer;
 
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    /** When @c microphonePublishTimer was armed to run, or zero if it was left
+     * to the writer. Runs more than @c MICROPHONE_PUBLISH_RATE after this are
+     * reported as late. */
+    AiaTimepointMs_t publishDueMs;
+#endif
+
+    /** The peak of the last published chunk in the upper 16 bits and its RMS in
+     * the lower 16 bits, so that both are read together. This should only be
+     * accessed using atomic operations. */
+    uint32_t lastEnergy;
+
+    /** Counters reported by @c AiaMicrophoneManager_GetMetrics(). These should
+     * only be accessed using atomic operations. */
+    AiaMicrophoneManagerMetrics_t metrics;
+
+    /** Whether @c processing is enabled. */
+    bool isProcessingEnabled;
+
+    /** Pre-processing applied to published samples. */
+    AiaMicrophoneProcessing_t processing;
+
+    /** DC removal state, reset whenever the microphone is opened. */
+    AiaPcmDcFilter_t dcFilter;
+
+    /** The current normalization gain, reset whenever the microphone is
+     * opened. */
+    AiaPcmGain_t normalizationGain;
+
+    /** Whether @c encoder is enabled. */
+    bool isEncoderEnabled;
+
+    /** Encoder applied to published samples. */
+    AiaMicrophoneEncoder_t encoder;
+
+    /** Samples of the chunk being encoded, holding up to @c
+     * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES. This is allocated when an encoder is
+     * first installed. */
+    int16_t* encoderSamples;
+
+    /** Whether @c vad is enabled. */
+    bool isVadEnabled;
+
+    /** Voice activity detection applied to published samples. */
+    AiaMicrophoneVad_t vad;
+
+    /** @} */
+
+    /** @name Fields read while handling directives. */
+    /** @{ */
+
+    /** The number of the most recent samples kept when the reader is overrun,
+     * see @c AiaMicrophoneManager_SetOverrunRetention(). */
+    size_t overrunRetentionSamples;
+
+    /** Callback to notify of state changes. */
+    const AiaMicrophoneStateObserver_t stateObserver;
+
+    /** Context associated with @c stateObserver. */
+    void* const stateObserverUserData;
+
+    /** Used to publish outbound events. */
+    AiaRegulator_t* const eventRegulator;
+
     /** Timer to handle @c OpenMicrophone directives. */
     AiaTimer_t openMicrophoneTimer;
+
+    /** @} */
 };
 
 /**
- * A helper method that builds an @c OpenMicrophone Event, sends it, and kicks
- * off the streaming of microphone data.
+ * Appends formatted text to a @c MicrophoneOpened payload.
  *
- * @param The @c AiaMicrophoneManager_t to act on.
+ * @param payload The payload to append to.
+ * @param format The format string.
+ * @return @c true if the text fit in the payload's buffer or @c false
+ * otherwise.
+ */
+static bool AiaMicrophoneOpenedPayload_Append(
+    AiaMicrophoneOpenedPayload_t* payload, const char* format, ... );
+
+/**
+ * Appends a blank offset field to a @c MicrophoneOpened payload.
+ *
+ * @param payload The payload to append to.
+ * @param[out] field The position of the field in the payload's buffer.
+ * @return @c true if the field fit in the payload's buffer or @c false
+ * otherwise.
+ */
+static bool AiaMicrophoneOpenedPayload_AppendField(
+    AiaMicrophoneOpenedPayload_t* payload, size_t* field );
+
+/**
+ * Writes an offset into a field of a @c MicrophoneOpened payload. The offset is
+ * right aligned and padded with leading whitespace, which JSON ignores.
+ *
+ * @param payload The payload to patch.
+ * @param field The position of the field in the payload's buffer.
+ * @param offset The offset to write.
+ */
+static void AiaMicrophoneOpenedPayload_PatchField(
+    AiaMicrophoneOpenedPayload_t* payload, size_t field,
+    AiaBinaryAudioStreamOffset_t offset );
+
+/**
+ * Formats a @c MicrophoneOpened payload, leaving its offsets to be patched in
+ * by @c AiaMicrophoneManager_OpenMicrophoneLocked(). This does not require @c
+ * mutex to be held.
+ *
+ * @param[out] payload The payload to initialize.
+ * @param buffer The buffer to format the payload into.
+ * @param size The size of @c buffer.
  * @param profile The ASR profile associated with the interaction.
+ * @param initiator The initiator object to send, which need not be
+ * null-terminated, or @c NULL to send no initiator. This is ignored if @c
+ * wakeWord is not @c NULL.
+ * @param initiatorLength The length of @c initiator.
+ * @param wakeWord The detected wake word for a wake word initiator, or @c NULL.
+ * @return @c true if the payload fit in @c buffer or @c false otherwise.
+ */
+static bool AiaMicrophoneManager_FormatOpenedPayload(
+    AiaMicrophoneOpenedPayload_t* payload, char* buffer, size_t size,
+    AiaMicrophoneProfile_t profile, const char* initiator,
+    size_t initiatorLength, const char* wakeWord );
+
+/**
+ * A helper method that completes a preformatted @c MicrophoneOpened event,
+ * sends it, and kicks off the streaming of microphone data.
+ *
+ * @param The @c AiaMicrophoneManager_t to act on.
  * @param startSample The sample index at which to begin streaming. For wake
- * word interactions, this must include 500 milliseconds of preroll.
- * @param initiator A C-string containing the initiator object to send in the @c
- * MicrophoneOpened event.
+ * word interactions, this includes @c payload->prerollSamples of preroll.
+ * @param payload The payload formatted by @c
+ * AiaMicrophoneManager_FormatOpenedPayload(), whose offsets are patched in
+ * place.
  * @return @c true If the event began successfully or @c false otherwise.
  * @note This method must only be called when @c mutex is locked.
  */
 static bool AiaMicrophoneManager_OpenMicrophoneLocked(
-    AiaMicrophoneManager_t* microphoneManager, AiaMicrophoneProfile_t profile,
-    AiaDataStreamIndex_t startSample, const char* initiator );
+    AiaMicrophoneManager_t* microphoneManager, AiaDataStreamIndex_t startSample,
+    AiaMicrophoneOpenedPayload_t* payload );
 
 /**
  * Called by a @c AiaMicrophoneManager_t's @c openMicrophoneTimer when an @c
@@ -147,9 +383,8 @@ static void AiaMicrophoneManager_OpenMicrophoneTimedOutTask( void* userData );
 
 /**
  * Called by a @c AiaMicrophoneManager_t's @c microphonePublishTimer to stream
- * microphone data to the Aia Service. This task runs at a @c
- * MICROPHONE_PUBLISH_RATE cadence and attempts to stream @c
- * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES samples.
+ * microphone data to the Aia Service. This task attempts to stream up to @c
+ * chunkSizeSamples samples and then schedules its next run.
  *
  * @param userData Pointer to the @c AiaMicrophoneManager_t to act on.
  */
@@ -164,6 +399,166 @@ static void AiaMicrophoneManager_MicrophoneStreamingTask( void* userData );
 static void AiaMicrophoneManager_MicrophoneStreamingTaskLocked(
     AiaMicrophoneManager_t* microphoneManager );
 
+/**
+ * Reads and publishes a single chunk of microphone data.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @return @c false if the microphone buffer can no longer be read from, or @c
+ * true otherwise.
+ * @note This method must only be called when @c mutex is locked.
+ */
+static bool AiaMicrophoneManager_PublishChunkLocked(
+    AiaMicrophoneManager_t* microphoneManager );
+
+/**
+ * Returns the number of samples the microphone regulator emits per @c
+ * minWaitTimeMs, which is the smallest chunk worth publishing since smaller
+ * chunks would only be aggregated by the emitter.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @return The regulator's cadence in samples, between one and @c
+ * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES.
+ */
+static size_t AiaMicrophoneManager_GetCadenceSamples(
+    AiaMicrophoneManager_t* microphoneManager );
+
+/**
+ * Returns the number of samples to read for the next microphone chunk. This is
+ * @c chunkSizeSamples, reduced to fit the space remaining in the MQTT message
+ * the microphone regulator is currently aggregating, as long as that does not
+ * drop below the regulator's cadence.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @return The number of samples to read.
+ * @note This method must only be called when @c mutex is locked.
+ */
+static size_t AiaMicrophoneManager_GetChunkSizeSamplesLocked(
+    AiaMicrophoneManager_t* microphoneManager );
+
+/**
+ * Schedules the next run of the streaming task. If fewer than @c
+ * AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES are buffered, the writer will
+ * schedule it as soon as enough samples have been written. If a backlog of at
+ * least @c AIA_MICROPHONE_CHUNK_SIZE_SAMPLES is buffered, the task is scheduled
+ * after @c MICROPHONE_PUBLISH_RATE. Otherwise, it is scheduled immediately.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @note This method must only be called when @c mutex is locked.
+ */
+static void AiaMicrophoneManager_ScheduleStreamingLocked(
+    AiaMicrophoneManager_t* microphoneManager );
+
+/**
+ * Called from the microphone buffer writer's execution context once @c
+ * AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES are available to be streamed.
+ *
+ * @param userData Pointer to the @c AiaMicrophoneManager_t to act on.
+ * @note This does not lock @c mutex, since the streaming task arms the
+ * notification with @c mutex held. @c microphonePublishTimer remains valid
+ * because the notification is always cancelled before the timer is destroyed.
+ */
+static void AiaMicrophoneManager_OnMicrophoneDataAvailable( void* userData );
+
+/**
+ * Called by @c microphoneRegulator when its queued data crosses a watermark.
+ *
+ * @param isAboveHighWatermark Whether the queued data has reached the high
+ * watermark.
+ * @param userData Pointer to the @c AiaMicrophoneManager_t to act on.
+ * @note This does not lock @c mutex, since it is called with the regulator's
+ * lock held from within @c AiaRegulator_Write() calls made under @c mutex.
+ */
+static void AiaMicrophoneManager_OnUplinkWatermark( bool isAboveHighWatermark,
+                                                    void* userData );
+
+/**
+ * Releases a microphone chunk buffer which was not handed off in a binary
+ * message.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param buf The buffer to release.
+ * @param isPooled Whether @c buf was acquired from @c chunkPool or allocated
+ * from the heap.
+ */
+static void AiaMicrophoneManager_ReleaseChunkBuffer(
+    AiaMicrophoneManager_t* microphoneManager, uint8_t* buf, bool isPooled );
+
+/**
+ * Applies @c processing to a chunk of samples and records its energy.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param[in,out] samples The samples of the chunk.
+ * @param numSamples The number of samples in @c samples.
+ * @note This method must only be called when @c mutex is locked.
+ */
+static void AiaMicrophoneManager_ProcessChunkLocked(
+    AiaMicrophoneManager_t* microphoneManager, int16_t* samples,
+    size_t numSamples );
+
+/**
+ * Copies a span of frames read from @c microphoneBufferReader into a chunk,
+ * mixing multi-channel frames down as it goes. This is the consumer passed to
+ * @c AiaDataStreamReader_ReadFanOut(), so frames go straight from the buffer
+ * storage into the chunk.
+ *
+ * @param data The frames to capture.
+ * @param nWords The number of frames in @c data.
+ * @param userData The @c AiaMicrophoneCapture_t to capture into.
+ */
+static void AiaMicrophoneManager_CaptureSpan( const void* data, size_t nWords,
+                                              void* userData );
+
+/**
+ * Returns the number of bytes of the microphone stream that @c numSamples
+ * samples are published as, taking @c encoder into account.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param numSamples A number of samples. When @c encoder is enabled, any
+ * partial frame is not counted.
+ * @return The number of bytes @c numSamples are published as.
+ * @note This method must only be called when @c mutex is locked.
+ */
+static AiaBinaryAudioStreamOffset_t AiaMicrophoneManager_SamplesToBytesLocked(
+    AiaMicrophoneManager_t* microphoneManager, size_t numSamples );
+
+/**
+ * Classifies a chunk of processed samples as speech or silence and advances
+ * the end of speech hangover.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param samples The processed samples of the chunk.
+ * @param numSamples The number of samples in @c samples.
+ * @return @c true if the chunk should be suppressed rather than published.
+ * @note This method must be called while @c microphoneManager->mutex is
+ * locked.
+ */
+static bool AiaMicrophoneManager_DetectVoiceActivityLocked(
+    AiaMicrophoneManager_t* microphoneManager, const int16_t* samples,
+    size_t numSamples );
+
+/**
+ * Moves @c microphoneBufferReader past samples the writer has overwritten,
+ * keeping up to @c overrunRetentionSamples of the most recent ones, and
+ * advances @c lastOffsetSent by the samples skipped so that stream offsets keep
+ * matching sample indices across the gap.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @note This method must be called while @c microphoneManager->mutex is
+ * locked.
+ */
+static void AiaMicrophoneManager_RecoverFromOverrunLocked(
+    AiaMicrophoneManager_t* microphoneManager );
+
+/**
+ * Closes the microphone, sending a @c MicrophoneClosed event.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @note This method must be called while @c microphoneManager->mutex is
+ * locked.
+ */
+static void AiaMicrophoneManager_CloseMicrophoneLocked(
+    AiaMicrophoneManager_t* microphoneManager );
+
 /**
  * Helper function that generates a @c MicrophoneClosed event.
  *
@@ -211,12 +606,13 @@ AiaMicrophoneManager_t* AiaMicrophoneManager_Create(
         return NULL;
     }
 
-    if( AiaDataStreamReader_GetWordSize( microphoneBufferReader ) !=
-        AIA_MICROPHONE_BUFFER_WORD_SIZE )
+    size_t wordSize = AiaDataStreamReader_GetWordSize( microphoneBufferReader );
+    size_t numChannels = wordSize / AIA_MICROPHONE_BUFFER_WORD_SIZE;
+    if( !numChannels || wordSize % AIA_MICROPHONE_BUFFER_WORD_SIZE ||
+        numChannels > AIA_MICROPHONE_MAX_CHANNELS )
     {
-        AiaLogError( "Invalid word size, wordSize=%zu, expected=%zu",
-                     AiaDataStreamReader_GetWordSize( microphoneBufferReader ),
-                     AIA_MICROPHONE_BUFFER_WORD_SIZE );
+        AiaLogError( "Invalid word size, wordSize=%zu, sampleSize=%zu",
+                     wordSize, AIA_MICROPHONE_BUFFER_WORD_SIZE );
         return NULL;
     }
 
@@ -230,11 +626,45 @@ AiaMicrophoneManager_t* AiaMicrophoneManager_Create(
         return NULL;
     }
 
+    *(size_t*)&microphoneManager->numChannels = numChannels;
+    if( numChannels > 1 )
+    {
+        size_t bytes = numChannels * sizeof( AiaPcmGain_t );
+        AiaPcmGain_t* weights = (AiaPcmGain_t*)AiaCalloc( 1, bytes );
+        if( !weights )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu.", bytes );
+            AiaFree( microphoneManager );
+            return NULL;
+        }
+        for( size_t i = 0; i < numChannels; ++i )
+        {
+            weights[ i ] = AIA_PCM_GAIN_UNITY / numChannels;
+        }
+        *(AiaPcmGain_t**)&microphoneManager->channelWeights = weights;
+    }
+
+    *(AiaBinaryMessagePool_t**)&microphoneManager->chunkPool =
+        AiaBinaryMessagePool_Create(
+            AIA_MICROPHONE_CHUNK_POOL_SIZE,
+            ( AIA_MICROPHONE_CHUNK_SIZE_SAMPLES *
+              AIA_MICROPHONE_BUFFER_WORD_SIZE ) +
+                sizeof( AiaBinaryAudioStreamOffset_t ) );
+    if( !microphoneManager->chunkPool )
+    {
+        AiaLogError( "AiaBinaryMessagePool_Create failed" );
+        AiaFree( microphoneManager->channelWeights );
+        AiaFree( microphoneManager );
+        return NULL;
+    }
+
     if( !AiaTimer( Create )( &microphoneManager->openMicrophoneTimer,
                              AiaMicrophoneManager_OpenMicrophoneTimedOutTask,
                              microphoneManager ) )
     {
         AiaLogError( "Failed to create OpenMicrophone timer" );
+        AiaBinaryMessagePool_Destroy( microphoneManager->chunkPool );
+        AiaFree( microphoneManager->channelWeights );
         AiaFree( microphoneManager );
         return NULL;
     }
@@ -258,6 +688,22 @@ AiaMicrophoneManager_t* AiaMicrophoneManager_Create(
     {
         AiaLogError( "AiaMutex( Create ) failed." );
         AiaTimer( Destroy )( &microphoneManager->openMicrophoneTimer );
+        AiaBinaryMessagePool_Destroy( microphoneManager->chunkPool );
+        AiaFree( microphoneManager->channelWeights );
+        AiaFree( microphoneManager );
+        return NULL;
+    }
+
+    if( !AiaRegulator_SetWatermarks(
+            microphoneRegulator, AIA_MICROPHONE_UPLINK_HIGH_WATERMARK_BYTES,
+            AIA_MICROPHONE_UPLINK_LOW_WATERMARK_BYTES,
+            AiaMicrophoneManager_OnUplinkWatermark, microphoneManager ) )
+    {
+        AiaLogError( "AiaRegulator_SetWatermarks failed." );
+        AiaMutex( Destroy )( &microphoneManager->mutex );
+        AiaTimer( Destroy )( &microphoneManager->openMicrophoneTimer );
+        AiaBinaryMessagePool_Destroy( microphoneManager->chunkPool );
+        AiaFree( microphoneManager->channelWeights );
         AiaFree( microphoneManager );
         return NULL;
     }
@@ -273,10 +719,16 @@ void AiaMicrophonerManager_Destroy( AiaMicrophoneManager_t* microphoneManager )
         return;
     }
 
+    AiaRegulator_SetWatermarks( microphoneManager->microphoneRegulator, 0, 0,
+                                NULL, NULL );
+
     AiaMutex( Lock )( &microphoneManager->mutex );
     if( microphoneManager->currentMicrophoneState.isMicrophoneOpen )
     {
+        AiaDataStreamReader_CancelNotification(
+            microphoneManager->microphoneBufferReader );
         AiaTimer( Destroy )( &microphoneManager->microphonePublishTimer );
+        AiaDataStreamReader_Unpin( microphoneManager->microphoneBufferReader );
     }
 
     AiaTimer( Destroy )( &microphoneManager->openMicrophoneTimer );
@@ -291,6 +743,13 @@ void AiaMicrophonerManager_Destroy( AiaMicrophoneManager_t* microphoneManager )
     AiaMutex( Unlock )( &microphoneManager->mutex );
 
     AiaMutex( Destroy )( &microphoneManager->mutex );
+
+    AiaFree( microphoneManager->encoderSamples );
+
+    /* Chunks still queued in the microphone regulator keep the pool alive
+     * until they are destroyed. */
+    AiaBinaryMessagePool_Destroy( microphoneManager->chunkPool );
+    AiaFree( microphoneManager->channelWeights );
     AiaFree( microphoneManager );
 }
 
@@ -330,10 +789,13 @@ static void AiaMicrophoneManager_OnOpenMicrophoneDirectiveReceivedLocked(
         return;
     }
 
+    /* Index the payload once rather than rescanning it for each field. */
+    AiaJsonObject_t object;
     const char* timeoutInMilliseconds;
     size_t timeoutInMillisecondsLen;
-    if( !AiaFindJsonValue(
-            payload, size, AIA_OPEN_MICROPHONE_TIMEOUT_IN_MILLISECONDS_KEY,
+    if( !AiaJsonObject_Parse( &object, payload, size ) ||
+        !AiaJsonObject_FindValue(
+            &object, AIA_OPEN_MICROPHONE_TIMEOUT_IN_MILLISECONDS_KEY,
             sizeof( AIA_OPEN_MICROPHONE_TIMEOUT_IN_MILLISECONDS_KEY ) - 1,
             &timeoutInMilliseconds, &timeoutInMillisecondsLen ) )
     {
@@ -388,9 +850,10 @@ static void AiaMicrophoneManager_OnOpenMicrophoneDirectiveReceivedLocked(
 
     const char* initiator = NULL;
     size_t initiatorLen = 0;
-    if( !AiaFindJsonValue( payload, size, AIA_OPEN_MICROPHONE_INITIATOR_KEY,
-                           sizeof( AIA_OPEN_MICROPHONE_INITIATOR_KEY ) - 1,
-                           &initiator, &initiatorLen ) )
+    if( !AiaJsonObject_FindValue(
+            &object, AIA_OPEN_MICROPHONE_INITIATOR_KEY,
+            sizeof( AIA_OPEN_MICROPHONE_INITIATOR_KEY ) - 1, &initiator,
+            &initiatorLen ) )
     {
         initiator = NULL;
         initiatorLen = 0;
@@ -444,16 +907,24 @@ static void AiaMicrophoneManager_OnOpenMicrophoneDirectiveReceivedLocked(
                 AiaCriticalFailure();
                 return;
             }
-            char initiatorCStr[ initiatorLen + 1 ];
-            memcpy( initiatorCStr, initiator, initiatorLen );
-            initiatorCStr[ initiatorLen ] = '\0';
+            char payloadBuffer[ MICROPHONE_OPENED_PAYLOAD_SIZE +
+                                initiatorLen ];
+            AiaMicrophoneOpenedPayload_t openedPayload;
+            if( !AiaMicrophoneManager_FormatOpenedPayload(
+                    &openedPayload, payloadBuffer, sizeof( payloadBuffer ),
+                    microphoneManager->currentMicrophoneState.lastProfile,
+                    initiator, initiatorLen, NULL ) )
+            {
+                AiaLogError(
+                    "AiaMicrophoneManager_FormatOpenedPayload failed" );
+                return;
+            }
             if( !AiaMicrophoneManager_OpenMicrophoneLocked(
                     microphoneManager,
-                    microphoneManager->currentMicrophoneState.lastProfile,
                     AiaDataStreamReader_Tell(
                         microphoneManager->microphoneBufferReader,
                         AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ),
-                    initiator ? initiatorCStr : initiator ) )
+                    &openedPayload ) )
             {
                 AiaLogError(
                     "AiaMicrophoneManager_OpenMicrophoneLocked failed" );
@@ -494,34 +965,41 @@ void AiaMicrophoneManager_CloseMicrophone(
     }
 
     AiaMutex( Lock )( &microphoneManager->mutex );
+    AiaMicrophoneManager_CloseMicrophoneLocked( microphoneManager );
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+}
+
+static void AiaMicrophoneManager_CloseMicrophoneLocked(
+    AiaMicrophoneManager_t* microphoneManager )
+{
     if( !microphoneManager->currentMicrophoneState.isMicrophoneOpen )
     {
         AiaLogWarn( "Microphone not open" );
+        return;
     }
-    else
+
+    AiaBinaryAudioStreamOffset_t currentOffset =
+        microphoneManager->currentMicrophoneState.lastOffsetSent;
+    AiaJsonMessage_t* microphoneClosedEvent =
+        generateMicrophoneClosedEvent( currentOffset );
+    if( !AiaRegulator_Write(
+            microphoneManager->eventRegulator,
+            AiaJsonMessage_ToMessage( microphoneClosedEvent ) ) )
     {
-        AiaBinaryAudioStreamOffset_t currentOffset =
-            microphoneManager->currentMicrophoneState.lastOffsetSent;
-        AiaJsonMessage_t* microphoneClosedEvent =
-            generateMicrophoneClosedEvent( currentOffset );
-        if( !AiaRegulator_Write(
-                microphoneManager->eventRegulator,
-                AiaJsonMessage_ToMessage( microphoneClosedEvent ) ) )
-        {
-            AiaLogError( "AiaRegulator_Write failed" );
-            AiaJsonMessage_Destroy( microphoneClosedEvent );
-        }
-        AiaTimer( Destroy )( &microphoneManager->microphonePublishTimer );
-        microphoneManager->currentMicrophoneState.isMicrophoneOpen = false;
-        if( microphoneManager->stateObserver )
-        {
-            microphoneManager->stateObserver(
-                AIA_MICROPHONE_STATE_CLOSED,
-                microphoneManager->stateObserverUserData );
-        }
+        AiaLogError( "AiaRegulator_Write failed" );
+        AiaJsonMessage_Destroy( microphoneClosedEvent );
+    }
+    AiaDataStreamReader_CancelNotification(
+        microphoneManager->microphoneBufferReader );
+    AiaTimer( Destroy )( &microphoneManager->microphonePublishTimer );
+    AiaDataStreamReader_Unpin( microphoneManager->microphoneBufferReader );
+    microphoneManager->currentMicrophoneState.isMicrophoneOpen = false;
+    if( microphoneManager->stateObserver )
+    {
+        microphoneManager->stateObserver(
+            AIA_MICROPHONE_STATE_CLOSED,
+            microphoneManager->stateObserverUserData );
     }
-
-    AiaMutex( Unlock )( &microphoneManager->mutex );
 }
 
 bool AiaMicrophoneManager_TapToTalkStart(
@@ -535,36 +1013,20 @@ bool AiaMicrophoneManager_TapToTalkStart(
         return false;
     }
 
-    AiaMutex( Lock )( &microphoneManager->mutex );
-
-    static const char* TAP_TO_TALK_INITATOR_FORMAT =
-        /* clang-format off */
-    "{"
-        "\""AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY"\":\"%s\""
-    "}";
-    /* clang-format on */
-
-    int numCharsRequired = snprintf( NULL, 0, TAP_TO_TALK_INITATOR_FORMAT,
-                                     AiaMicrophoneInitiatorType_ToString(
-                                         AIA_MICROPHONE_INITIATOR_TYPE_TAP ) );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed" );
-        return false;
-    }
-
-    char initiatorPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( initiatorPayloadBuffer, numCharsRequired + 1,
-                  TAP_TO_TALK_INITATOR_FORMAT,
-                  AiaMicrophoneInitiatorType_ToString(
-                      AIA_MICROPHONE_INITIATOR_TYPE_TAP ) ) < 0 )
+    char payloadBuffer[ MICROPHONE_OPENED_PAYLOAD_SIZE ];
+    AiaMicrophoneOpenedPayload_t payload;
+    if( !AiaMicrophoneManager_FormatOpenedPayload(
+            &payload, payloadBuffer, sizeof( payloadBuffer ), profile,
+            TAP_TO_TALK_INITIATOR, sizeof( TAP_TO_TALK_INITIATOR ) - 1,
+            NULL ) )
     {
-        AiaLogError( "snprintf failed" );
+        AiaLogError( "AiaMicrophoneManager_FormatOpenedPayload failed" );
         return false;
     }
 
-    if( !AiaMicrophoneManager_OpenMicrophoneLocked(
-            microphoneManager, profile, index, initiatorPayloadBuffer ) )
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    if( !AiaMicrophoneManager_OpenMicrophoneLocked( microphoneManager, index,
+                                                    &payload ) )
     {
         AiaLogError( "Failed to open microphone" );
         AiaMutex( Unlock )( &microphoneManager->mutex );
@@ -588,16 +1050,37 @@ bool AiaMicrophoneManager_HoldToTalkStart(
         return false;
     }
 
+    char payloadBuffer[ MICROPHONE_OPENED_PAYLOAD_SIZE ];
+    AiaMicrophoneOpenedPayload_t payload;
+    if( !AiaMicrophoneManager_FormatOpenedPayload(
+            &payload, payloadBuffer, sizeof( payloadBuffer ),
+            AIA_MICROPHONE_PROFILE_CLOSE_TALK, HOLD_TO_TALK_INITIATOR,
+            sizeof( HOLD_TO_TALK_INITIATOR ) - 1, NULL ) )
+    {
+        AiaLogError( "AiaMicrophoneManager_FormatOpenedPayload failed" );
+        return false;
+    }
+
     AiaMutex( Lock )( &microphoneManager->mutex );
 
     if( microphoneManager->currentMicrophoneState.pendingOpenMicrophone &&
         AiaClock( GetTimeMs )() < microphoneManager->currentMicrophoneState
                                       .openMicrophoneExpirationTime )
     {
-        if( !AiaMicrophoneManager_OpenMicrophoneLocked(
-                microphoneManager, AIA_MICROPHONE_PROFILE_CLOSE_TALK, index,
-                microphoneManager->currentMicrophoneState
-                    .openMicrophoneInitiator ) )
+        /* The initiator echoed back from the directive is only known now. */
+        const char* initiator =
+            microphoneManager->currentMicrophoneState.openMicrophoneInitiator;
+        size_t initiatorLength = initiator ? strlen( initiator ) : 0;
+        char echoedPayloadBuffer[ MICROPHONE_OPENED_PAYLOAD_SIZE +
+                                  initiatorLength ];
+        AiaMicrophoneOpenedPayload_t echoedPayload;
+        if( !AiaMicrophoneManager_FormatOpenedPayload(
+                &echoedPayload, echoedPayloadBuffer,
+                sizeof( echoedPayloadBuffer ),
+                AIA_MICROPHONE_PROFILE_CLOSE_TALK, initiator, initiatorLength,
+                NULL ) ||
+            !AiaMicrophoneManager_OpenMicrophoneLocked(
+                microphoneManager, index, &echoedPayload ) )
         {
             AiaLogError( "Failed to open microphone" );
             AiaMutex( Unlock )( &microphoneManager->mutex );
@@ -614,42 +1097,14 @@ bool AiaMicrophoneManager_HoldToTalkStart(
     }
     else
     {
-        static const char* HOLD_TO_TALK_INITATOR_FORMAT =
-            /* clang-format off */
-        "{"
-            "\""AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY"\":\"%s\""
-        "}";
-        /* clang-format on */
-
-        int numCharsRequired =
-            snprintf( NULL, 0, HOLD_TO_TALK_INITATOR_FORMAT,
-                      AiaMicrophoneInitiatorType_ToString(
-                          AIA_MICROPHONE_INITIATOR_TYPE_HOLD ) );
-        if( numCharsRequired < 0 )
+        if( !AiaMicrophoneManager_OpenMicrophoneLocked( microphoneManager,
+                                                        index, &payload ) )
         {
-            AiaLogError( "snprintf failed" );
+            AiaLogError( "Failed to open microphone" );
+            AiaMutex( Unlock )( &microphoneManager->mutex );
             return false;
         }
-
-        char initiatorPayloadBuffer[ numCharsRequired + 1 ];
-        if( snprintf( initiatorPayloadBuffer, numCharsRequired + 1,
-                      HOLD_TO_TALK_INITATOR_FORMAT,
-                      AiaMicrophoneInitiatorType_ToString(
-                          AIA_MICROPHONE_INITIATOR_TYPE_HOLD ) ) < 0 )
-        {
-            AiaLogError( "snprintf failed" );
-            return false;
-        }
-
-        if( !AiaMicrophoneManager_OpenMicrophoneLocked(
-                microphoneManager, AIA_MICROPHONE_PROFILE_CLOSE_TALK, index,
-                initiatorPayloadBuffer ) )
-        {
-            AiaLogError( "Failed to open microphone" );
-            AiaMutex( Unlock )( &microphoneManager->mutex );
-            return false;
-        }
-    }
+    }
 
     microphoneManager->currentMicrophoneState.lastProfile =
         AIA_MICROPHONE_PROFILE_CLOSE_TALK;
@@ -684,72 +1139,43 @@ bool AiaMicrophoneManager_WakeWordStart(
         return false;
     }
 
-    static const char* WAKE_WORD_INITATOR_FORMAT =
-        /* clang-format off */
-    "{"
-        "\""AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY"\":\"%s\","
-        "\"" AIA_OPEN_MICROPHONE_INITIATOR_PAYLOAD_KEY "\": {"
-            "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_KEY "\": \"%s\","
-            "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_KEY "\": {" 
-                "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_BEGIN_OFFSET_KEY "\": %"PRIu64","
-                "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_END_OFFSET_KEY "\": %"PRIu64""
-            "}"
-        "}"
-
-    "}";
-    /* clang-format on */
-
-    AiaMutex( Lock )( &microphoneManager->mutex );
-
-    AiaBinaryAudioStreamOffset_t wwStreamBeginOffset =
-        microphoneManager->currentMicrophoneState.lastOffsetSent +
-        ( AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES *
-          AIA_MICROPHONE_BUFFER_WORD_SIZE );
-    AiaBinaryAudioStreamOffset_t wwStreamEndOffset =
-        wwStreamBeginOffset +
-        ( ( endIndex - beginIndex ) * AIA_MICROPHONE_BUFFER_WORD_SIZE );
-    int numCharsRequired =
-        snprintf( NULL, 0, WAKE_WORD_INITATOR_FORMAT,
-                  AiaMicrophoneInitiatorType_ToString(
-                      AIA_MICROPHONE_INITIATOR_TYPE_WAKEWORD ),
-                  wakeWord, wwStreamBeginOffset, wwStreamEndOffset );
-    if( numCharsRequired < 0 )
+    char payloadBuffer[ MICROPHONE_OPENED_PAYLOAD_SIZE ];
+    AiaMicrophoneOpenedPayload_t payload;
+    if( !AiaMicrophoneManager_FormatOpenedPayload(
+            &payload, payloadBuffer, sizeof( payloadBuffer ), profile, NULL, 0,
+            wakeWord ) )
     {
-        AiaLogError( "snprintf failed" );
-        AiaMutex( Unlock )( &microphoneManager->mutex );
+        AiaLogError( "AiaMicrophoneManager_FormatOpenedPayload failed" );
         return false;
     }
+    payload.wakeWordSamples = endIndex - beginIndex;
 
-    char initiatorPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( initiatorPayloadBuffer, numCharsRequired + 1,
-                  WAKE_WORD_INITATOR_FORMAT,
-                  AiaMicrophoneInitiatorType_ToString(
-                      AIA_MICROPHONE_INITIATOR_TYPE_WAKEWORD ),
-                  wakeWord, wwStreamBeginOffset, wwStreamEndOffset ) < 0 )
-    {
-        AiaLogError( "snprintf failed" );
-        AiaMutex( Unlock )( &microphoneManager->mutex );
-        return false;
-    }
+    AiaMutex( Lock )( &microphoneManager->mutex );
 
-    if( microphoneManager->currentMicrophoneState.isMicrophoneOpen )
+    if( beginIndex < AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES )
     {
-        AiaLogWarn( "Microphone already open" );
+        AiaLogError( "Not enough samples for preroll" );
         AiaMutex( Unlock )( &microphoneManager->mutex );
         return false;
     }
+    payload.prerollSamples = AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES;
 
-    if( beginIndex < AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES )
+    /* A nonblockable writer may have lapped the preroll, which the seek would
+     * only report as a generic failure. */
+    AiaDataStreamIndex_t oldestIndex = AiaDataStreamReader_GetOldestIndex(
+        microphoneManager->microphoneBufferReader );
+    if( beginIndex - payload.prerollSamples < oldestIndex )
     {
-        AiaLogError( "Not enough samples for preroll" );
+        AiaLogError( "Preroll overwritten, beginIndex=%" PRIu64
+                     ", oldestIndex=%" PRIu64,
+                     (uint64_t)beginIndex, (uint64_t)oldestIndex );
         AiaMutex( Unlock )( &microphoneManager->mutex );
         return false;
     }
-    AiaDataStreamIndex_t begin =
-        beginIndex - AIA_MICROPHONE_WAKE_WORD_PREROLL_IN_SAMPLES;
 
     if( !AiaMicrophoneManager_OpenMicrophoneLocked(
-            microphoneManager, profile, begin, initiatorPayloadBuffer ) )
+            microphoneManager, beginIndex - payload.prerollSamples,
+            &payload ) )
     {
         AiaLogError( "Failed to open microphone" );
         AiaMutex( Unlock )( &microphoneManager->mutex );
@@ -763,9 +1189,112 @@ bool AiaMicrophoneManager_WakeWordStart(
     return true;
 }
 
+static bool AiaMicrophoneOpenedPayload_Append(
+    AiaMicrophoneOpenedPayload_t* payload, const char* format, ... )
+{
+    va_list args;
+    va_start( args, format );
+    int length = vsnprintf( payload->buffer + payload->length,
+                            payload->size - payload->length, format, args );
+    va_end( args );
+    if( length < 0 || (size_t)length >= payload->size - payload->length )
+    {
+        return false;
+    }
+    payload->length += length;
+    return true;
+}
+
+static bool AiaMicrophoneOpenedPayload_AppendField(
+    AiaMicrophoneOpenedPayload_t* payload, size_t* field )
+{
+    *field = payload->length;
+    return AiaMicrophoneOpenedPayload_Append(
+        payload, "%*s", MICROPHONE_OPENED_OFFSET_FIELD_WIDTH, "" );
+}
+
+static void AiaMicrophoneOpenedPayload_PatchField(
+    AiaMicrophoneOpenedPayload_t* payload, size_t field,
+    AiaBinaryAudioStreamOffset_t offset )
+{
+    char* start = payload->buffer + field;
+    char* digit = start + MICROPHONE_OPENED_OFFSET_FIELD_WIDTH;
+    do
+    {
+        *--digit = '0' + offset % 10;
+        offset /= 10;
+    } while( offset );
+    while( digit > start )
+    {
+        *--digit = ' ';
+    }
+}
+
+static bool AiaMicrophoneManager_FormatOpenedPayload(
+    AiaMicrophoneOpenedPayload_t* payload, char* buffer, size_t size,
+    AiaMicrophoneProfile_t profile, const char* initiator,
+    size_t initiatorLength, const char* wakeWord )
+{
+    payload->buffer = buffer;
+    payload->size = size;
+    payload->length = 0;
+    payload->beginOffsetField = 0;
+    payload->endOffsetField = 0;
+    payload->prerollSamples = 0;
+    payload->wakeWordSamples = 0;
+
+    /* clang-format off */
+    if( !AiaMicrophoneOpenedPayload_Append( payload,
+            "{"
+                "\"" AIA_MICROPHONE_OPENED_PROFILE_KEY "\":\"%s\","
+                "\"" AIA_MICROPHONE_OPENED_OFFSET_KEY "\":",
+            AiaMicrophoneProfile_ToString( profile ) ) ||
+        !AiaMicrophoneOpenedPayload_AppendField( payload,
+                                                 &payload->offsetField ) )
+    {
+        return false;
+    }
+
+    if( wakeWord )
+    {
+        if( !AiaMicrophoneOpenedPayload_Append( payload,
+                ",\"" AIA_OPEN_MICROPHONE_INITIATOR_KEY "\": {"
+                    "\"" AIA_OPEN_MICROPHONE_INITIATOR_TYPE_KEY "\":\"%s\","
+                    "\"" AIA_OPEN_MICROPHONE_INITIATOR_PAYLOAD_KEY "\": {"
+                        "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_KEY "\": \"%s\","
+                        "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_KEY "\": {"
+                            "\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_BEGIN_OFFSET_KEY "\":",
+                AiaMicrophoneInitiatorType_ToString(
+                    AIA_MICROPHONE_INITIATOR_TYPE_WAKEWORD ),
+                wakeWord ) ||
+            !AiaMicrophoneOpenedPayload_AppendField(
+                payload, &payload->beginOffsetField ) ||
+            !AiaMicrophoneOpenedPayload_Append( payload,
+                ",\"" AIA_MICROPHONE_OPENED_INITIATOR_PAYLOAD_WAKE_WORD_INDICES_END_OFFSET_KEY "\":" ) ||
+            !AiaMicrophoneOpenedPayload_AppendField(
+                payload, &payload->endOffsetField ) ||
+            !AiaMicrophoneOpenedPayload_Append( payload, "}}}" ) )
+        {
+            return false;
+        }
+    }
+    else if( initiator )
+    {
+        if( !AiaMicrophoneOpenedPayload_Append( payload,
+                ",\"" AIA_OPEN_MICROPHONE_INITIATOR_KEY "\": %.*s",
+                (int)initiatorLength, initiator ) )
+        {
+            return false;
+        }
+    }
+    /* clang-format on */
+
+    return AiaMicrophoneOpenedPayload_Append( payload, "}" );
+}
+
 static bool AiaMicrophoneManager_OpenMicrophoneLocked(
-    AiaMicrophoneManager_t* microphoneManager, AiaMicrophoneProfile_t profile,
-    AiaDataStreamIndex_t startSample, const char* initiator )
+    AiaMicrophoneManager_t* microphoneManager, AiaDataStreamIndex_t startSample,
+    AiaMicrophoneOpenedPayload_t* payload )
 {
     if( microphoneManager->currentMicrophoneState.isMicrophoneOpen )
     {
@@ -781,25 +1310,52 @@ static bool AiaMicrophoneManager_OpenMicrophoneLocked(
         return false;
     }
 
+    /* A nonblockable writer would otherwise be free to overwrite the preroll
+     * and wake word while they wait to be published. */
+    microphoneManager->currentMicrophoneState.wakeWordEndIndex =
+        startSample + payload->prerollSamples + payload->wakeWordSamples;
+    if( payload->prerollSamples &&
+        !AiaDataStreamReader_Pin( microphoneManager->microphoneBufferReader ) )
+    {
+        AiaLogError( "Failed to pin preroll, index=%" PRIu64, startSample );
+        return false;
+    }
+
     if( !AiaTimer( Create )( &microphoneManager->microphonePublishTimer,
                              AiaMicrophoneManager_MicrophoneStreamingTask,
                              microphoneManager ) )
     {
         AiaLogError( "Failed to create microphone timer" );
+        AiaDataStreamReader_Unpin( microphoneManager->microphoneBufferReader );
         AiaCriticalFailure();
         return false;
     }
 
-    if( !AiaTimer( Arm )( &microphoneManager->microphonePublishTimer, 0,
-                          MICROPHONE_PUBLISH_RATE ) )
+    if( !AiaTimer( Arm )( &microphoneManager->microphonePublishTimer, 0, 0 ) )
     {
         AiaLogError( "Failed to arm microphone timer" );
         AiaTimer( Destroy )( &microphoneManager->microphonePublishTimer );
+        AiaDataStreamReader_Unpin( microphoneManager->microphoneBufferReader );
         AiaCriticalFailure();
         return false;
     }
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    microphoneManager->publishDueMs = AiaClock( GetTimeMs )();
+#endif
 
     microphoneManager->currentMicrophoneState.isMicrophoneOpen = true;
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    microphoneManager->currentMicrophoneState.isAwaitingFirstChunk = true;
+    microphoneManager->currentMicrophoneState.openedTimestampMs =
+        AiaClock( GetTimeMs )();
+#endif
+    microphoneManager->currentMicrophoneState.chunkSizeSamples =
+        AiaMicrophoneManager_GetCadenceSamples( microphoneManager );
+    microphoneManager->currentMicrophoneState.vadHeardSpeech = false;
+    microphoneManager->currentMicrophoneState.vadHeardEndOfSpeech = false;
+    microphoneManager->currentMicrophoneState.vadSilentSamples = 0;
+    microphoneManager->dcFilter.offset = 0;
+    microphoneManager->normalizationGain = AIA_PCM_GAIN_UNITY;
 
     if( microphoneManager->stateObserver )
     {
@@ -808,54 +1364,25 @@ static bool AiaMicrophoneManager_OpenMicrophoneLocked(
             microphoneManager->stateObserverUserData );
     }
 
-    static const char* formatPayloadWithoutInitiator =
-        /* clang-format off */
-    "{"
-        "\""AIA_MICROPHONE_OPENED_PROFILE_KEY"\":\"%s\","
-        "\""AIA_MICROPHONE_OPENED_OFFSET_KEY"\":%"PRIu64""  
-    "}";
-    /* clang-format on */
-
-    static const char* formatPayloadWithInitiator =
-        /* clang-format off */
-    "{"
-        "\""AIA_MICROPHONE_OPENED_PROFILE_KEY"\":\"%s\","
-        "\""AIA_MICROPHONE_OPENED_OFFSET_KEY"\":%"PRIu64"," 
-        "\""AIA_OPEN_MICROPHONE_INITIATOR_KEY"\": %s"
-    "}";
-    /* clang-format on */
-
-    const char* formatPayload;
-    if( !initiator )
-    {
-        formatPayload = formatPayloadWithoutInitiator;
-    }
-    else
-    {
-        formatPayload = formatPayloadWithInitiator;
-    }
-
-    int numCharsRequired = snprintf(
-        NULL, 0, formatPayload, AiaMicrophoneProfile_ToString( profile ),
-        microphoneManager->currentMicrophoneState.lastOffsetSent, initiator );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed" );
-        return false;
-    }
-
-    char payloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( payloadBuffer, numCharsRequired + 1, formatPayload,
-                  AiaMicrophoneProfile_ToString( profile ),
-                  microphoneManager->currentMicrophoneState.lastOffsetSent,
-                  initiator ) < 0 )
+    AiaBinaryAudioStreamOffset_t offset =
+        microphoneManager->currentMicrophoneState.lastOffsetSent;
+    AiaMicrophoneOpenedPayload_PatchField( payload, payload->offsetField,
+                                           offset );
+    if( payload->beginOffsetField )
     {
-        AiaLogError( "snprintf failed" );
-        return false;
+        AiaBinaryAudioStreamOffset_t beginOffset =
+            offset + AiaMicrophoneManager_SamplesToBytesLocked(
+                         microphoneManager, payload->prerollSamples );
+        AiaMicrophoneOpenedPayload_PatchField(
+            payload, payload->beginOffsetField, beginOffset );
+        AiaMicrophoneOpenedPayload_PatchField(
+            payload, payload->endOffsetField,
+            beginOffset + AiaMicrophoneManager_SamplesToBytesLocked(
+                              microphoneManager, payload->wakeWordSamples ) );
     }
 
     AiaJsonMessage_t* microphoneOpenedEvent = AiaJsonMessage_Create(
-        AIA_EVENTS_MICROPHONE_OPENED, NULL, payloadBuffer );
+        AIA_EVENTS_MICROPHONE_OPENED, NULL, payload->buffer );
     if( !microphoneOpenedEvent )
     {
         AiaLogError( "Failed to create microphoneOpenedEvent" );
@@ -932,102 +1459,830 @@ static void AiaMicrophoneManager_MicrophoneStreamingTask( void* userData )
         return;
     }
 
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_MICROPHONE_STREAMING );
     AiaMutex( Lock )( &microphoneManager->mutex );
     AiaMicrophoneManager_MicrophoneStreamingTaskLocked( microphoneManager );
     AiaMutex( Unlock )( &microphoneManager->mutex );
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_MICROPHONE_STREAMING );
 }
 
 static void AiaMicrophoneManager_MicrophoneStreamingTaskLocked(
     AiaMicrophoneManager_t* microphoneManager )
+{
+    if( !microphoneManager->currentMicrophoneState.isMicrophoneOpen )
+    {
+        /* This run was scheduled before the microphone was closed. */
+        return;
+    }
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    if( microphoneManager->publishDueMs )
+    {
+        AiaOverloadGovernor_ReportTaskRun(
+            AIA_OVERLOAD_TASK_MICROPHONE_STREAMING,
+            AiaClock( GetTimeMs )() > microphoneManager->publishDueMs +
+                                          MICROPHONE_PUBLISH_RATE );
+        microphoneManager->publishDueMs = 0;
+    }
+#endif
+    if( AiaAtomic_Load_u32( &microphoneManager->isUplinkBackedUp ) )
+    {
+        /* Leave the audio in the microphone buffer and check again on the next
+         * tick, rather than publishing chunks that would be refused. */
+        if( !AiaTimer( Arm )( &microphoneManager->microphonePublishTimer,
+                              MICROPHONE_PUBLISH_RATE, 0 ) )
+        {
+            AiaLogError( "Failed to arm microphone timer" );
+        }
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+        microphoneManager->publishDueMs =
+            AiaClock( GetTimeMs )() + MICROPHONE_PUBLISH_RATE;
+#endif
+        return;
+    }
+    if( !AiaMicrophoneManager_PublishChunkLocked( microphoneManager ) )
+    {
+        return;
+    }
+    const AiaCurrentMicrophoneState_t* state =
+        &microphoneManager->currentMicrophoneState;
+    if( state->vadHeardEndOfSpeech &&
+        microphoneManager->vad.closeOnEndOfSpeech &&
+        ( state->lastProfile == AIA_MICROPHONE_PROFILE_NEAR_FIELD ||
+          state->lastProfile == AIA_MICROPHONE_PROFILE_FAR_FIELD ) )
+    {
+        AiaLogDebug( "Closing the microphone at the end of speech" );
+        AiaMicrophoneManager_CloseMicrophoneLocked( microphoneManager );
+        return;
+    }
+    AiaMicrophoneManager_ScheduleStreamingLocked( microphoneManager );
+}
+
+static bool AiaMicrophoneManager_PublishChunkLocked(
+    AiaMicrophoneManager_t* microphoneManager )
 {
     size_t numBytesRequiredForDataAndOffset =
         ( AIA_MICROPHONE_CHUNK_SIZE_SAMPLES *
           AIA_MICROPHONE_BUFFER_WORD_SIZE ) +
         sizeof( AiaBinaryAudioStreamOffset_t );
 
-    uint8_t* buf =
-        AiaCalloc( numBytesRequiredForDataAndOffset, sizeof( uint8_t ) );
+    bool isPooled = true;
+    uint8_t* buf = (uint8_t*)AiaBinaryMessagePool_AcquireData(
+        microphoneManager->chunkPool );
     if( !buf )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu.",
-                     numBytesRequiredForDataAndOffset );
-        return;
-    }
-
-    size_t bytePosition = 0;
-    for( size_t i = 0;
-         i < sizeof( microphoneManager->currentMicrophoneState.lastOffsetSent );
-         ++i )
-    {
-        buf[ bytePosition ] =
-            ( microphoneManager->currentMicrophoneState.lastOffsetSent >>
-              ( i * 8 ) );
-        ++bytePosition;
+        AiaLogDebug( "Chunk pool exhausted, allocating from the heap" );
+        isPooled = false;
+        buf = (uint8_t*)AiaBinaryMessage_AllocateInline(
+            numBytesRequiredForDataAndOffset );
+        if( !buf )
+        {
+            AiaLogError( "AiaBinaryMessage_AllocateInline failed, bytes=%zu.",
+                         numBytesRequiredForDataAndOffset );
+            return true;
+        }
     }
 
-    ssize_t amountRead = AiaDataStreamReader_Read(
-        microphoneManager->microphoneBufferReader, buf + bytePosition,
-        AIA_MICROPHONE_CHUNK_SIZE_SAMPLES );
+    AiaEndian_StoreLe64(
+        buf, microphoneManager->currentMicrophoneState.lastOffsetSent );
+    size_t bytePosition = sizeof( AiaBinaryAudioStreamOffset_t );
+
+    /* Pooled buffers are sized for @c AIA_MICROPHONE_CHUNK_SIZE_SAMPLES, which
+     * the chunk size never exceeds. Samples follow the 8-byte offset, so they
+     * are suitably aligned. Samples to be encoded are read aside instead so
+     * that the encoded frames can be written to @c buf. */
+    size_t chunkSizeSamples =
+        AiaMicrophoneManager_GetChunkSizeSamplesLocked( microphoneManager );
+    int16_t* samples = microphoneManager->isEncoderEnabled
+                           ? microphoneManager->encoderSamples
+                           : (int16_t*)( buf + bytePosition );
+    AiaTrace_Begin( AIA_TRACE_MICROPHONE_CAPTURE,
+                    AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                    microphoneManager->currentMicrophoneState.lastOffsetSent );
+    AiaMicrophoneCapture_t capture = { microphoneManager, samples };
+    const AiaDataStreamReaderConsumer_t consumer = {
+        AiaMicrophoneManager_CaptureSpan, &capture
+    };
+    ssize_t amountRead = AiaDataStreamReader_ReadFanOut(
+        microphoneManager->microphoneBufferReader, &consumer, 1,
+        chunkSizeSamples );
+    AiaTrace_End( AIA_TRACE_MICROPHONE_CAPTURE,
+                  AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                  microphoneManager->currentMicrophoneState.lastOffsetSent );
     if( amountRead <= 0 )
     {
-        AiaLogDebug( "AiaDataStreamReader_Read failed, status=%s",
+        AiaLogDebug( "AiaDataStreamReader_ReadFanOut failed, status=%s",
                      AiaDataStreamReader_ErrorToString( amountRead ) );
         switch( amountRead )
         {
             case AIA_DATA_STREAM_BUFFER_READER_ERROR_CLOSED:
             case AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID:
-                AiaLogError( "AiaDataStreamReader_Read failed, status=%s",
-                             AiaDataStreamReader_ErrorToString( amountRead ) );
-                AiaFree( buf );
+                AiaLogError(
+                    "AiaDataStreamReader_ReadFanOut failed, status=%s",
+                    AiaDataStreamReader_ErrorToString( amountRead ) );
+                AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager,
+                                                         buf, isPooled );
                 AiaCriticalFailure();
-                return;
+                return false;
             case AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN:
-                AiaFree( buf );
-                AiaLogError(
-                    "numWordsBehind=%zu",
-                    AiaDataStreamReader_Tell(
-                        microphoneManager->microphoneBufferReader,
-                        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) );
-                if( !AiaDataStreamReader_Seek(
-                        microphoneManager->microphoneBufferReader, 0,
-                        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) )
-                {
-                    AiaLogError( "Failed to seek to before writer" );
-                }
-                return;
+                AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager,
+                                                         buf, isPooled );
+                AiaMicrophoneManager_RecoverFromOverrunLocked(
+                    microphoneManager );
+                return true;
             case AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK:
-                AiaFree( buf );
-                return;
+                AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager,
+                                                         buf, isPooled );
+                return true;
         }
     }
-    else if( (size_t)amountRead < AIA_MICROPHONE_CHUNK_SIZE_SAMPLES )
+    else if( (size_t)amountRead < chunkSizeSamples )
     {
         AiaLogDebug(
             "Read less samples than expected, expected=%zu, amountRead=%zu",
-            AIA_MICROPHONE_CHUNK_SIZE_SAMPLES, amountRead );
+            chunkSizeSamples, amountRead );
+    }
+
+    if( microphoneManager->isEncoderEnabled )
+    {
+        /* Partial frames are left in the buffer to be encoded with the rest of
+         * their samples in the next chunk. */
+        size_t partialFrameSamples =
+            amountRead % microphoneManager->encoder.frameSamples;
+        if( partialFrameSamples &&
+            !AiaDataStreamReader_Seek(
+                microphoneManager->microphoneBufferReader, partialFrameSamples,
+                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_READER ) )
+        {
+            AiaLogError( "Failed to seek back, samples=%zu",
+                         partialFrameSamples );
+        }
+        amountRead -= partialFrameSamples;
+        if( !amountRead )
+        {
+            AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager, buf,
+                                                     isPooled );
+            return true;
+        }
+    }
+
+    AiaMicrophoneManager_ProcessChunkLocked( microphoneManager, samples,
+                                             amountRead );
+    if( AiaMicrophoneManager_DetectVoiceActivityLocked( microphoneManager,
+                                                        samples, amountRead ) )
+    {
+        /* The offset still advances so that the service sees the gap. */
+        AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager, buf,
+                                                 isPooled );
+        microphoneManager->currentMicrophoneState.lastOffsetSent +=
+            AiaMicrophoneManager_SamplesToBytesLocked( microphoneManager,
+                                                       amountRead );
+        AiaAtomic_Add_u32( &microphoneManager->metrics.chunksSuppressed, 1 );
+        return true;
     }
 
+    if( microphoneManager->isEncoderEnabled &&
+        !microphoneManager->encoder.encodeFrames(
+            samples, amountRead / microphoneManager->encoder.frameSamples,
+            buf + bytePosition, microphoneManager->encoder.userData ) )
+    {
+        AiaLogError( "Failed to encode microphone chunk, samples=%zu",
+                     amountRead );
+        AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager, buf,
+                                                 isPooled );
+        return true;
+    }
+    AiaBinaryAudioStreamOffset_t chunkBytes =
+        AiaMicrophoneManager_SamplesToBytesLocked( microphoneManager,
+                                                   amountRead );
+
     /* Cleanup of @c buf is left to @c AiaBinaryMessage_Destroy(), which is done
-     * downstream of the Regulator . */
-    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_Create(
-        sizeof( AiaBinaryAudioStreamOffset_t ) +
-            ( amountRead * AIA_MICROPHONE_BUFFER_WORD_SIZE ),
-        AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE, 0, buf );
+     * downstream of the Regulator. Pooled chunks are returned to @c chunkPool
+     * rather than freed. */
+    AiaBinaryMessageLength_t length =
+        sizeof( AiaBinaryAudioStreamOffset_t ) + chunkBytes;
+    AiaBinaryMessage_t* binaryMessage =
+        isPooled ? AiaBinaryMessagePool_CreateMessage(
+                       microphoneManager->chunkPool, length,
+                       AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE, 0, buf )
+                 : AiaBinaryMessage_CreateInline(
+                       length, AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE, 0,
+                       buf );
     if( !binaryMessage )
     {
-        AiaLogError( "AiaBinaryMessage_Create failed" );
-        AiaFree( buf );
-        return;
+        AiaLogError( "Failed to create microphone binary message" );
+        AiaMicrophoneManager_ReleaseChunkBuffer( microphoneManager, buf,
+                                                 isPooled );
+        return true;
     }
+    /* Ended by the emitter once the chunk leaves the regulator. */
+    AiaTrace_Begin( AIA_TRACE_MICROPHONE_REGULATE,
+                    AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                    microphoneManager->currentMicrophoneState.lastOffsetSent );
     if( !AiaRegulator_Write( microphoneManager->microphoneRegulator,
                              AiaBinaryMessage_ToMessage( binaryMessage ) ) )
     {
         AiaLogError( "AiaRegulator_Write failed" );
         AiaBinaryMessage_Destroy( binaryMessage );
-        return;
+        AiaTrace_End( AIA_TRACE_MICROPHONE_REGULATE,
+                      AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                      microphoneManager->currentMicrophoneState.lastOffsetSent );
+        /* Put the samples back so that they are published once the regulator
+         * has room, instead of leaving a gap in the stream. */
+        if( !AiaDataStreamReader_Seek(
+                microphoneManager->microphoneBufferReader, amountRead,
+                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_READER ) )
+        {
+            AiaLogError( "Failed to seek back, samples=%zu", amountRead );
+        }
+        return true;
     }
+    microphoneManager->currentMicrophoneState.lastOffsetSent += chunkBytes;
+    AiaAtomic_Add_u32( &microphoneManager->metrics.chunksSent, 1 );
+    if( AiaDataStreamReader_Tell(
+            microphoneManager->microphoneBufferReader,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) >=
+        microphoneManager->currentMicrophoneState.wakeWordEndIndex )
+    {
+        AiaDataStreamReader_Unpin( microphoneManager->microphoneBufferReader );
+    }
+    AiaAtomic_Add_u32( &microphoneManager->metrics.bytesSent, chunkBytes );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    if( microphoneManager->currentMicrophoneState.isAwaitingFirstChunk )
+    {
+        microphoneManager->currentMicrophoneState.isAwaitingFirstChunk = false;
+        AiaHistogram_Record(
+            &microphoneManager->metrics.openToFirstChunkMs,
+            (uint32_t)( AiaClock( GetTimeMs )() -
+                        microphoneManager->currentMicrophoneState
+                            .openedTimestampMs ) );
+    }
+#endif
+
+    /* Grow towards full chunks now that the first audio is on its way. */
+    size_t* nextChunkSizeSamples =
+        &microphoneManager->currentMicrophoneState.chunkSizeSamples;
+    *nextChunkSizeSamples *= 2;
+    if( *nextChunkSizeSamples > AIA_MICROPHONE_CHUNK_SIZE_SAMPLES )
+    {
+        *nextChunkSizeSamples = AIA_MICROPHONE_CHUNK_SIZE_SAMPLES;
+    }
+    return true;
+}
+
+/**
+ * Rounds a number of samples to skip up to whole encoder frames, if an encoder
+ * is enabled, so that the encoded stream offset stays exact.
+ *
+ * @param microphoneManager The @c AiaMicrophoneManager_t to act on.
+ * @param numSamples The number of samples to skip.
+ * @return @c numSamples rounded up to whole frames.
+ * @note This method must be called while @c microphoneManager->mutex is
+ * locked.
+ */
+static size_t AiaMicrophoneManager_RoundUpToFramesLocked(
+    AiaMicrophoneManager_t* microphoneManager, size_t numSamples )
+{
+    if( !microphoneManager->isEncoderEnabled )
+    {
+        return numSamples;
+    }
+    size_t frameSamples = microphoneManager->encoder.frameSamples;
+    return ( numSamples + frameSamples - 1 ) / frameSamples * frameSamples;
+}
+
+static void AiaMicrophoneManager_RecoverFromOverrunLocked(
+    AiaMicrophoneManager_t* microphoneManager )
+{
+    AiaDataStreamReader_t* reader = microphoneManager->microphoneBufferReader;
+    size_t samplesBehind = AiaDataStreamReader_Tell(
+        reader, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER );
+    size_t samplesKept = microphoneManager->overrunRetentionSamples;
+    if( samplesKept > samplesBehind )
+    {
+        samplesKept = samplesBehind;
+    }
+
+    /* Seek forward by the samples skipped rather than relative to the writer,
+     * which keeps moving, so that the count added to the offset is exact.
+     * Rounding to whole frames may leave the reader slightly past the writer,
+     * in which case it waits for the rest of the frame. */
+    size_t samplesSkipped = 0;
+    if( samplesKept )
+    {
+        samplesSkipped = AiaMicrophoneManager_RoundUpToFramesLocked(
+            microphoneManager, samplesBehind - samplesKept );
+        if( !AiaDataStreamReader_Seek(
+                reader, samplesSkipped,
+                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_AFTER_READER ) )
+        {
+            /* The samples to keep were overwritten as well, or do not fit in
+             * the buffer. */
+            samplesKept = 0;
+        }
+    }
+    if( !samplesKept )
+    {
+        samplesSkipped = AiaMicrophoneManager_RoundUpToFramesLocked(
+            microphoneManager,
+            AiaDataStreamReader_Tell(
+                reader,
+                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) );
+        if( !AiaDataStreamReader_Seek(
+                reader, samplesSkipped,
+                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_AFTER_READER ) )
+        {
+            AiaLogError( "Failed to skip overrun samples, samples=%zu",
+                         samplesSkipped );
+            return;
+        }
+    }
+    AiaLogWarn( "Microphone overrun, skipped=%zu, kept=%zu", samplesSkipped,
+                samplesKept );
+
+    /* The skipped samples still count towards the offset, so that the service
+     * sees the gap and later wake word indices line up with the buffer. */
     microphoneManager->currentMicrophoneState.lastOffsetSent +=
-        ( amountRead * AIA_MICROPHONE_BUFFER_WORD_SIZE );
+        AiaMicrophoneManager_SamplesToBytesLocked( microphoneManager,
+                                                   samplesSkipped );
+    AiaAtomic_Add_u32( &microphoneManager->metrics.gaps, 1 );
+    AiaAtomic_Add_u32( &microphoneManager->metrics.samplesSkipped,
+                       samplesSkipped );
+}
+
+void AiaMicrophoneManager_GetMetrics( AiaMicrophoneManager_t* microphoneManager,
+                                      AiaMicrophoneManagerMetrics_t* metrics )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics." );
+        return;
+    }
+    metrics->chunksSent =
+        AiaAtomic_Load_u32( &microphoneManager->metrics.chunksSent );
+    metrics->bytesSent =
+        AiaAtomic_Load_u32( &microphoneManager->metrics.bytesSent );
+    metrics->chunksSuppressed =
+        AiaAtomic_Load_u32( &microphoneManager->metrics.chunksSuppressed );
+    metrics->gaps = AiaAtomic_Load_u32( &microphoneManager->metrics.gaps );
+    metrics->samplesSkipped =
+        AiaAtomic_Load_u32( &microphoneManager->metrics.samplesSkipped );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Snapshot( &microphoneManager->metrics.openToFirstChunkMs,
+                           &metrics->openToFirstChunkMs );
+#endif
+}
+
+bool AiaMicrophoneManager_SetProcessing(
+    AiaMicrophoneManager_t* microphoneManager,
+    const AiaMicrophoneProcessing_t* processing )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return false;
+    }
+    if( processing && processing->normalizationTargetPeak > INT16_MAX )
+    {
+        AiaLogError( "Invalid normalizationTargetPeak, peak=%" PRIu16,
+                     processing->normalizationTargetPeak );
+        return false;
+    }
+
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    microphoneManager->isProcessingEnabled = processing != NULL;
+    if( processing )
+    {
+        microphoneManager->processing = *processing;
+    }
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+    return true;
+}
+
+bool AiaMicrophoneManager_SetChannelWeights(
+    AiaMicrophoneManager_t* microphoneManager, const AiaPcmGain_t* weights,
+    size_t numWeights )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return false;
+    }
+    if( !weights )
+    {
+        AiaLogError( "Null weights." );
+        return false;
+    }
+    if( !microphoneManager->channelWeights ||
+        numWeights != microphoneManager->numChannels )
+    {
+        AiaLogError( "Invalid numWeights, numWeights=%zu, numChannels=%zu",
+                     numWeights, microphoneManager->numChannels );
+        return false;
+    }
+
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    for( size_t i = 0; i < numWeights; ++i )
+    {
+        microphoneManager->channelWeights[ i ] = weights[ i ];
+    }
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+    return true;
+}
+
+bool AiaMicrophoneManager_SetVad( AiaMicrophoneManager_t* microphoneManager,
+                                  const AiaMicrophoneVad_t* vad )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    if( microphoneManager->currentMicrophoneState.isMicrophoneOpen )
+    {
+        AiaLogError( "Cannot change voice activity detection while open" );
+        AiaMutex( Unlock )( &microphoneManager->mutex );
+        return false;
+    }
+    microphoneManager->isVadEnabled = vad != NULL;
+    if( vad )
+    {
+        microphoneManager->vad = *vad;
+    }
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+    return true;
+}
+
+bool AiaMicrophoneManager_SetOverrunRetention(
+    AiaMicrophoneManager_t* microphoneManager, AiaDurationMs_t retentionMs )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    microphoneManager->overrunRetentionSamples =
+        retentionMs * AIA_MICROPHONE_SAMPLE_RATE_HZ / AIA_MS_PER_SECOND;
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+    return true;
+}
+
+void AiaMicrophoneManager_GetEnergy( AiaMicrophoneManager_t* microphoneManager,
+                                     AiaPcmEnergy_t* energy )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return;
+    }
+    AiaAssert( energy );
+    if( !energy )
+    {
+        AiaLogError( "Null energy." );
+        return;
+    }
+    uint32_t lastEnergy = AiaAtomic_Load_u32( &microphoneManager->lastEnergy );
+    energy->peak = lastEnergy >> 16;
+    energy->rms = lastEnergy & UINT16_MAX;
+}
+
+bool AiaMicrophoneManager_SetEncoder( AiaMicrophoneManager_t* microphoneManager,
+                                      const AiaMicrophoneEncoder_t* encoder )
+{
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager." );
+        return false;
+    }
+    if( encoder )
+    {
+        if( !encoder->encodeFrames )
+        {
+            AiaLogError( "Null encodeFrames." );
+            return false;
+        }
+        if( !encoder->frameSamples ||
+            encoder->frameSamples > AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES ||
+            encoder->frameSamples > AIA_MICROPHONE_CHUNK_SIZE_SAMPLES )
+        {
+            AiaLogError( "Invalid frameSamples, frameSamples=%zu",
+                         encoder->frameSamples );
+            return false;
+        }
+        if( !encoder->frameBytes ||
+            encoder->frameBytes >
+                encoder->frameSamples * AIA_MICROPHONE_BUFFER_WORD_SIZE )
+        {
+            AiaLogError( "Invalid frameBytes, frameBytes=%zu",
+                         encoder->frameBytes );
+            return false;
+        }
+    }
+
+    AiaMutex( Lock )( &microphoneManager->mutex );
+    if( microphoneManager->currentMicrophoneState.isMicrophoneOpen )
+    {
+        AiaLogError( "Cannot change encoder while microphone is open" );
+        AiaMutex( Unlock )( &microphoneManager->mutex );
+        return false;
+    }
+    if( encoder && !microphoneManager->encoderSamples )
+    {
+        microphoneManager->encoderSamples =
+            AiaCalloc( AIA_MICROPHONE_CHUNK_SIZE_SAMPLES, sizeof( int16_t ) );
+        if( !microphoneManager->encoderSamples )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                         AIA_MICROPHONE_CHUNK_SIZE_SAMPLES *
+                             sizeof( int16_t ) );
+            AiaMutex( Unlock )( &microphoneManager->mutex );
+            return false;
+        }
+    }
+    microphoneManager->isEncoderEnabled = encoder != NULL;
+    if( encoder )
+    {
+        microphoneManager->encoder = *encoder;
+    }
+    AiaMutex( Unlock )( &microphoneManager->mutex );
+    return true;
+}
+
+static AiaBinaryAudioStreamOffset_t AiaMicrophoneManager_SamplesToBytesLocked(
+    AiaMicrophoneManager_t* microphoneManager, size_t numSamples )
+{
+    if( !microphoneManager->isEncoderEnabled )
+    {
+        return numSamples * AIA_MICROPHONE_BUFFER_WORD_SIZE;
+    }
+    return (AiaBinaryAudioStreamOffset_t)numSamples /
+           microphoneManager->encoder.frameSamples *
+           microphoneManager->encoder.frameBytes;
+}
+
+static void AiaMicrophoneManager_ProcessChunkLocked(
+    AiaMicrophoneManager_t* microphoneManager, int16_t* samples,
+    size_t numSamples )
+{
+    const AiaMicrophoneProcessing_t* processing =
+        &microphoneManager->processing;
+    AiaPcmEnergy_t energy;
+    if( microphoneManager->isProcessingEnabled )
+    {
+        if( processing->removeDc )
+        {
+            AiaPcm_RemoveDc( &microphoneManager->dcFilter, samples,
+                             numSamples );
+        }
+        if( processing->normalizationTargetPeak )
+        {
+            AiaPcm_MeasureEnergy( samples, numSamples, &energy );
+            AiaPcmGain_t targetGain = AiaPcm_GetNormalizationGain(
+                energy.peak, processing->normalizationTargetPeak,
+                processing->maxNormalizationGain );
+            AiaPcmGain_t* gain = &microphoneManager->normalizationGain;
+            if( targetGain < *gain )
+            {
+                *gain = targetGain;
+            }
+            else
+            {
+                *gain += ( targetGain - *gain ) / 8;
+            }
+            AiaPcm_ApplyGain( samples, numSamples, *gain );
+        }
+        else
+        {
+            AiaPcm_ApplyGain( samples, numSamples, processing->gain );
+        }
+    }
+
+    AiaPcm_MeasureEnergy( samples, numSamples, &energy );
+    /* Both values are at most 32768, so each fits in 16 bits. */
+    AiaAtomic_Store_u32( &microphoneManager->lastEnergy,
+                         ( energy.peak << 16 ) | energy.rms );
+}
+
+static void AiaMicrophoneManager_CaptureSpan( const void* data, size_t nWords,
+                                              void* userData )
+{
+    AiaMicrophoneCapture_t* capture = (AiaMicrophoneCapture_t*)userData;
+    const AiaMicrophoneManager_t* microphoneManager =
+        capture->microphoneManager;
+    if( microphoneManager->channelWeights )
+    {
+        AiaPcm_Downmix( (const int16_t*)data, microphoneManager->numChannels,
+                        microphoneManager->channelWeights, capture->samples,
+                        nWords );
+    }
+    else
+    {
+        memcpy( capture->samples, data,
+                nWords * AIA_MICROPHONE_BUFFER_WORD_SIZE );
+    }
+    capture->samples += nWords;
+}
+
+static bool AiaMicrophoneManager_DetectVoiceActivityLocked(
+    AiaMicrophoneManager_t* microphoneManager, const int16_t* samples,
+    size_t numSamples )
+{
+    if( !microphoneManager->isVadEnabled || !numSamples )
+    {
+        return false;
+    }
+    const AiaMicrophoneVad_t* vad = &microphoneManager->vad;
+    AiaCurrentMicrophoneState_t* state =
+        &microphoneManager->currentMicrophoneState;
+
+    /* The energy of the chunk was just measured after processing. */
+    uint32_t rms =
+        AiaAtomic_Load_u32( &microphoneManager->lastEnergy ) & UINT16_MAX;
+    bool isSpeech = rms >= vad->speechRms;
+    if( isSpeech && vad->maxSpeechZeroCrossingsPerMille )
+    {
+        size_t crossings = AiaPcm_CountZeroCrossings( samples, numSamples );
+        isSpeech = crossings * 1000 <=
+                   numSamples * vad->maxSpeechZeroCrossingsPerMille;
+    }
+
+    size_t hangoverSamples =
+        vad->hangoverMs * AIA_MICROPHONE_SAMPLE_RATE_HZ / AIA_MS_PER_SECOND;
+    if( isSpeech )
+    {
+        state->vadHeardSpeech = true;
+        state->vadSilentSamples = 0;
+        return false;
+    }
+    if( state->vadSilentSamples < hangoverSamples )
+    {
+        state->vadSilentSamples += numSamples;
+    }
+    bool isPastHangover = state->vadSilentSamples >= hangoverSamples;
+    if( state->vadHeardSpeech && isPastHangover && !state->vadHeardEndOfSpeech )
+    {
+        AiaLogDebug( "End of speech detected" );
+        state->vadHeardEndOfSpeech = true;
+        if( vad->onEndOfSpeech )
+        {
+            vad->onEndOfSpeech( vad->onEndOfSpeechUserData );
+        }
+    }
+
+    /* Silence inside the hangover, such as pauses between words, is always
+     * published. Silence before the first speech counts as past it. */
+    return vad->suppressSilence &&
+           ( isPastHangover || !state->vadHeardSpeech ) &&
+           state->lastProfile == AIA_MICROPHONE_PROFILE_NEAR_FIELD &&
+           state->lastMicrophoneInitiatorType ==
+               AIA_MICROPHONE_INITIATOR_TYPE_TAP;
+}
+
+static size_t AiaMicrophoneManager_GetCadenceSamples(
+    AiaMicrophoneManager_t* microphoneManager )
+{
+    AiaDurationMs_t minWaitTimeMs = AiaRegulator_GetMinWaitTimeMs(
+        microphoneManager->microphoneRegulator );
+    size_t cadenceSamples =
+        minWaitTimeMs * AIA_MICROPHONE_SAMPLE_RATE_HZ / AIA_MS_PER_SECOND;
+    if( !cadenceSamples || cadenceSamples > AIA_MICROPHONE_CHUNK_SIZE_SAMPLES )
+    {
+        return AIA_MICROPHONE_CHUNK_SIZE_SAMPLES;
+    }
+    return cadenceSamples;
+}
+
+static size_t AiaMicrophoneManager_GetChunkSizeSamplesLocked(
+    AiaMicrophoneManager_t* microphoneManager )
+{
+    size_t chunkSizeSamples =
+        microphoneManager->currentMicrophoneState.chunkSizeSamples;
+
+    /* Prefer topping off the message being aggregated over spilling a chunk
+     * into the next one, since every message costs a publish. */
+    const size_t chunkOverhead = AIA_SIZE_OF_BINARY_STREAM_HEADER +
+                                 sizeof( AiaBinaryAudioStreamOffset_t );
+    size_t remainingSpace = AiaRegulator_GetRemainingMessageSpace(
+        microphoneManager->microphoneRegulator );
+    if( remainingSpace > chunkOverhead )
+    {
+        size_t fitSamples =
+            microphoneManager->isEncoderEnabled
+                ? ( remainingSpace - chunkOverhead ) /
+                      microphoneManager->encoder.frameBytes *
+                      microphoneManager->encoder.frameSamples
+                : ( remainingSpace - chunkOverhead ) /
+                      AIA_MICROPHONE_BUFFER_WORD_SIZE;
+        if( fitSamples < chunkSizeSamples &&
+            fitSamples >=
+                AiaMicrophoneManager_GetCadenceSamples( microphoneManager ) )
+        {
+            chunkSizeSamples = fitSamples;
+        }
+    }
+    if( microphoneManager->isEncoderEnabled )
+    {
+        /* Only whole frames are encoded. */
+        size_t frameSamples = microphoneManager->encoder.frameSamples;
+        chunkSizeSamples = chunkSizeSamples < frameSamples
+                               ? frameSamples
+                               : chunkSizeSamples / frameSamples * frameSamples;
+    }
+    return chunkSizeSamples;
+}
+
+static void AiaMicrophoneManager_ScheduleStreamingLocked(
+    AiaMicrophoneManager_t* microphoneManager )
+{
+    if( AiaDataStreamReader_NotifyWhenAvailable(
+            microphoneManager->microphoneBufferReader,
+            AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES,
+            AiaMicrophoneManager_OnMicrophoneDataAvailable,
+            microphoneManager ) )
+    {
+        return;
+    }
+
+    /* Backlogs of at least a full chunk are drained at the publish rate, while
+     * anything smaller is live audio that raced with arming the notification
+     * and is published immediately. */
+    AiaDurationMs_t delay =
+        AiaDataStreamReader_Tell(
+            microphoneManager->microphoneBufferReader,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) >=
+                AIA_MICROPHONE_CHUNK_SIZE_SAMPLES
+            ? MICROPHONE_PUBLISH_RATE
+            : 0;
+    if( !AiaTimer( Arm )( &microphoneManager->microphonePublishTimer, delay,
+                          0 ) )
+    {
+        AiaLogError( "Failed to arm microphone timer" );
+    }
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    microphoneManager->publishDueMs = AiaClock( GetTimeMs )() + delay;
+#endif
+}
+
+static void AiaMicrophoneManager_OnUplinkWatermark( bool isAboveHighWatermark,
+                                                    void* userData )
+{
+    AiaMicrophoneManager_t* microphoneManager =
+        (AiaMicrophoneManager_t*)userData;
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager" );
+        return;
+    }
+    AiaLogDebug( "Microphone uplink %s.",
+                 isAboveHighWatermark ? "backed up" : "drained" );
+    AiaAtomic_Store_u32( &microphoneManager->isUplinkBackedUp,
+                         isAboveHighWatermark );
+}
+
+static void AiaMicrophoneManager_OnMicrophoneDataAvailable( void* userData )
+{
+    AiaMicrophoneManager_t* microphoneManager =
+        (AiaMicrophoneManager_t*)userData;
+    AiaAssert( microphoneManager );
+    if( !microphoneManager )
+    {
+        AiaLogError( "Null microphoneManager" );
+        return;
+    }
+    if( !AiaTimer( Arm )( &microphoneManager->microphonePublishTimer, 0, 0 ) )
+    {
+        AiaLogError( "Failed to arm microphone timer" );
+    }
+}
+
+static void AiaMicrophoneManager_ReleaseChunkBuffer(
+    AiaMicrophoneManager_t* microphoneManager, uint8_t* buf, bool isPooled )
+{
+    if( isPooled )
+    {
+        AiaBinaryMessagePool_ReleaseData( microphoneManager->chunkPool, buf );
+    }
+    else
+    {
+        AiaBinaryMessage_FreeInline( buf );
+    }
 }
 
 static AiaJsonMessage_t* generateMicrophoneClosedEvent(
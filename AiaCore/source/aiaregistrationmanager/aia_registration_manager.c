@@ -24,20 +24,13 @@
 
 #include <aiacore/aia_crypto_mbedtls.h>
 #include <aiacore/aia_encryption_algorithm.h>
-#include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_topic.h>
 #include <aiacore/aia_utils.h>
 #include <aiaregistrationmanager/aia_registration_constants.h>
 #include <aiaregistrationmanager/aia_registration_manager.h>
 
 #include <stdio.h>
-
-/**
- * The generated key lengths are always 32.
- * @see
- * https://developer.amazon.com/en-US/docs/alexa/alexa-voice-service/avs-for-aws-iot-registration.html#request
- */
-#define AIA_REGISTRATION_MANAGER_GENERATED_KEY_LENGTH 32
+#include <string.h>
 
 #define REGISTRATION_REQUEST_CONTENT "Content-Type: application/json"
 
@@ -60,6 +53,78 @@
     "}"
 /* clang-format on */
 
+/** The longest key in a registration response that may be matched. */
+#define AIA_REGISTRATION_MANAGER_MAX_RESPONSE_KEY_LENGTH 16
+
+/** The longest value in a registration response that is kept. */
+#define AIA_REGISTRATION_MANAGER_MAX_RESPONSE_VALUE_LENGTH 256
+
+/** The string values picked out of a registration response. */
+typedef enum AiaRegistrationResponseField
+{
+    AIA_REGISTRATION_RESPONSE_PUBLIC_KEY,
+    AIA_REGISTRATION_RESPONSE_TOPIC_ROOT,
+    AIA_REGISTRATION_RESPONSE_CODE,
+    AIA_REGISTRATION_RESPONSE_DESCRIPTION,
+    AIA_NUM_REGISTRATION_RESPONSE_FIELDS
+} AiaRegistrationResponseField_t;
+
+/** The keys of @c AiaRegistrationResponseField_t values. */
+static const char* const g_registrationResponseKeys[] = {
+    AIA_REGISTRATION_ENCRYPTION_PUBLIC_KEY_KEY,
+    AIA_REGISTRATION_IOT_TOPIC_ROOT_KEY, AIA_REGISTRATION_CODE_KEY,
+    AIA_REGISTRATION_DESCRIPTION_KEY
+};
+
+/** A string value picked out of a registration response. */
+typedef struct AiaRegistrationResponseValue
+{
+    /** The value without its quotes, which is not null-terminated. */
+    char value[ AIA_REGISTRATION_MANAGER_MAX_RESPONSE_VALUE_LENGTH ];
+
+    /** The length of @c value. */
+    size_t length;
+
+    /** Whether the key was found. */
+    bool found;
+
+    /** Whether the value was longer than @c value. */
+    bool truncated;
+} AiaRegistrationResponseValue_t;
+
+/**
+ * Push parser which picks the values of @c g_registrationResponseKeys out of
+ * a registration response as its body is received, without buffering the
+ * body. Only the first occurrence of each key is kept.
+ */
+typedef struct AiaRegistrationResponseParser
+{
+    /** The key of the current or last string, which is not null-terminated. */
+    char key[ AIA_REGISTRATION_MANAGER_MAX_RESPONSE_KEY_LENGTH ];
+
+    /** The length of @c key, which may exceed the size of @c key. */
+    size_t keyLength;
+
+    /** Whether the parser is inside a string. */
+    bool inString;
+
+    /** Whether the last character of the current string was an escape. */
+    bool escaped;
+
+    /** Whether the current string is a value rather than a key. */
+    bool inValue;
+
+    /** The last character outside of strings that was not whitespace. */
+    char lastToken;
+
+    /** The value the current string is captured to, if any. */
+    AiaRegistrationResponseValue_t* capture;
+
+    /** The values picked out so far, indexed by field. */
+    AiaRegistrationResponseValue_t
+        values[ AIA_NUM_REGISTRATION_RESPONSE_FIELDS ];
+} AiaRegistrationResponseParser_t;
+
 /** Private data for the @c AiaRegistrationManager_t */
 struct AiaRegistrationManager
 {
@@ -81,10 +146,133 @@ struct AiaRegistrationManager
     /** The client generated public key used for shared secret calculation */
     uint8_t publicKey[ AIA_REGISTRATION_MANAGER_GENERATED_KEY_LENGTH ];
 
+    /** The cache LWA credentials are taken from, if any. */
+    AiaLwaCredentialCache_t* const lwaCredentialCache;
+
     /** Indicates a registration is in progress. */
     bool isRegistrationInProgress;
+
+    /** Parses the response to the registration in progress. */
+    AiaRegistrationResponseParser_t responseParser;
 };
 
+/**
+ * Feeds the next chunk of a registration response to a parser.
+ *
+ * @param parser The @c AiaRegistrationResponseParser_t to act on.
+ * @param chunk The next bytes of the response body.
+ * @param chunkLen The length of @c chunk.
+ */
+static void AiaRegistrationResponseParser_Push(
+    AiaRegistrationResponseParser_t* parser, const char* chunk,
+    size_t chunkLen );
+
+/**
+ * Returns a value picked out of a registration response, logging if it is
+ * missing or was truncated.
+ *
+ * @param parser The @c AiaRegistrationResponseParser_t to act on.
+ * @param field The field to return.
+ * @return The value, or @c NULL if it is not usable.
+ */
+static const AiaRegistrationResponseValue_t*
+    AiaRegistrationResponseParser_GetValue(
+        const AiaRegistrationResponseParser_t* parser,
+        AiaRegistrationResponseField_t field );
+
+static void AiaRegistrationResponseParser_Push(
+    AiaRegistrationResponseParser_t* parser, const char* chunk,
+    size_t chunkLen )
+{
+    for( size_t i = 0; i < chunkLen; ++i )
+    {
+        char c = chunk[ i ];
+        if( !parser->inString )
+        {
+            if( c == '"' )
+            {
+                parser->inString = true;
+                parser->inValue = parser->lastToken == ':';
+                parser->capture = NULL;
+                if( !parser->inValue )
+                {
+                    parser->keyLength = 0;
+                    continue;
+                }
+                for( size_t field = 0;
+                     field < AIA_NUM_REGISTRATION_RESPONSE_FIELDS; ++field )
+                {
+                    const char* key = g_registrationResponseKeys[ field ];
+                    AiaRegistrationResponseValue_t* value =
+                        &parser->values[ field ];
+                    if( !value->found &&
+                        parser->keyLength == strlen( key ) &&
+                        !strncmp( parser->key, key, parser->keyLength ) )
+                    {
+                        value->found = true;
+                        parser->capture = value;
+                        break;
+                    }
+                }
+            }
+            else if( c != ' ' && c != '\t' && c != '\r' && c != '\n' )
+            {
+                parser->lastToken = c;
+            }
+            continue;
+        }
+
+        if( c == '"' && !parser->escaped )
+        {
+            parser->inString = false;
+            parser->lastToken = c;
+            continue;
+        }
+        parser->escaped = !parser->escaped && c == '\\';
+        if( !parser->inValue )
+        {
+            if( parser->keyLength < sizeof( parser->key ) )
+            {
+                parser->key[ parser->keyLength ] = c;
+            }
+            ++parser->keyLength;
+        }
+        else if( parser->capture )
+        {
+            AiaRegistrationResponseValue_t* value = parser->capture;
+            if( value->length < sizeof( value->value ) )
+            {
+                value->value[ value->length++ ] = c;
+            }
+            else
+            {
+                value->truncated = true;
+            }
+        }
+    }
+}
+
+static const AiaRegistrationResponseValue_t*
+    AiaRegistrationResponseParser_GetValue(
+        const AiaRegistrationResponseParser_t* parser,
+        AiaRegistrationResponseField_t field )
+{
+    const AiaRegistrationResponseValue_t* value = &parser->values[ field ];
+    if( !value->found )
+    {
+        AiaLogError( "Failed to parse the %s key in the response body",
+                     g_registrationResponseKeys[ field ] );
+        return NULL;
+    }
+    if( value->truncated )
+    {
+        AiaLogError( "Value of the %s key in the response body too long",
+                     g_registrationResponseKeys[ field ] );
+        return NULL;
+    }
+    return value;
+}
+
 /**
  * Builds the Registration request body.
  * If @c NULL is passed for @c payloadBuffer, this function will calculate
@@ -130,8 +318,8 @@ static size_t BuildRegistrationRequestBody(
 }
 
 /**
- * Parses a success response body, calculates shared secret, and stores topic
- * root and shared secret
+ * Handles a parsed success response body, calculates shared secret, and stores
+ * topic root and shared secret
  * @note When storing topic root and shared secret, if one is stored
  * successfully and the other fails then there will be an inconsistent set of
  * registration values.
@@ -139,49 +327,27 @@ static size_t BuildRegistrationRequestBody(
  * @param clientPrivateKey The client private key paired with the client public
  * key sent in the registration request.
  * @param clientPrivateKeyLen The length of @c clientPrivateKey.
- * @param body The response body.
- * @param bodyLen The length of @c body.
+ * @param parser The parser the response body was fed to.
  *
  * @return @c true if shared secret and topic root are stored in persistent
  * storage, @c false otherwise.
  */
 static bool HandleRegistrationSuccessResponseBody(
     const uint8_t* clientPrivateKey, const size_t clientPrivateKeyLen,
-    const char* body, const size_t bodyLen )
+    const AiaRegistrationResponseParser_t* parser )
 {
-    const char* serviceBase64PublicKey;
-    size_t serviceBase64PublicKeyLength;
-    if( !AiaFindJsonValue(
-            body, bodyLen, AIA_REGISTRATION_ENCRYPTION_PUBLIC_KEY_KEY,
-            sizeof( AIA_REGISTRATION_ENCRYPTION_PUBLIC_KEY_KEY ) - 1,
-            &serviceBase64PublicKey, &serviceBase64PublicKeyLength ) )
-    {
-        AiaLogError( "Failed to parse the %s key in the reponse body",
-                     AIA_REGISTRATION_ENCRYPTION_PUBLIC_KEY_KEY );
-        return false;
-    }
-    if( !AiaJsonUtils_UnquoteString( &serviceBase64PublicKey,
-                                     &serviceBase64PublicKeyLength ) )
-    {
-        AiaLogError( "Malformed JSON" );
-        return false;
-    }
-
-    const char* topicRoot;
-    size_t topicRootLength;
-    if( !AiaFindJsonValue( body, bodyLen, AIA_REGISTRATION_IOT_TOPIC_ROOT_KEY,
-                           sizeof( AIA_REGISTRATION_IOT_TOPIC_ROOT_KEY ) - 1,
-                           &topicRoot, &topicRootLength ) )
+    const AiaRegistrationResponseValue_t* publicKey =
+        AiaRegistrationResponseParser_GetValue(
+            parser, AIA_REGISTRATION_RESPONSE_PUBLIC_KEY );
+    const AiaRegistrationResponseValue_t* topicRoot =
+        AiaRegistrationResponseParser_GetValue(
+            parser, AIA_REGISTRATION_RESPONSE_TOPIC_ROOT );
+    if( !publicKey || !topicRoot )
     {
-        AiaLogError( "Failed to parse the %s key in the response body",
-                     AIA_REGISTRATION_IOT_TOPIC_ROOT_KEY );
-        return false;
-    }
-    if( !AiaJsonUtils_UnquoteString( &topicRoot, &topicRootLength ) )
-    {
-        AiaLogError( "Malformed JSON" );
         return false;
     }
+    const char* serviceBase64PublicKey = publicKey->value;
+    size_t serviceBase64PublicKeyLength = publicKey->length;
 
     size_t servicePublicKeyLen = Aia_Base64GetDecodeSize(
         (uint8_t*)serviceBase64PublicKey, serviceBase64PublicKeyLength );
@@ -215,7 +381,8 @@ static bool HandleRegistrationSuccessResponseBody(
         return false;
     }
 
-    if( !AiaStoreTopicRoot( (const uint8_t*)topicRoot, topicRootLength ) )
+    if( !AiaStoreTopicRoot( (const uint8_t*)topicRoot->value,
+                            topicRoot->length ) )
     {
         AiaLogError( "Failed to store topic root" );
         return false;
@@ -230,52 +397,40 @@ static bool HandleRegistrationSuccessResponseBody(
 }
 
 /**
- * Parses a failure response body
+ * Handles a parsed failure response body
  *
- * @param body The response body.
- * @param bodyLen The length of @c body.
+ * @param parser The parser the response body was fed to.
+ * @param[out] failureCode The failure code of the response.
  *
  * @return @c true if parsing is successful, @c false otherwise.
  */
 static bool HandleRegistrationFailedResponseBody(
-    const char* body, const size_t bodyLen,
+    const AiaRegistrationResponseParser_t* parser,
     AiaRegistrationFailureCode_t* failureCode )
 {
-    const char* code;
-    size_t codeLen;
-    if( !AiaFindJsonValue( body, bodyLen, AIA_REGISTRATION_CODE_KEY,
-                           sizeof( AIA_REGISTRATION_CODE_KEY ) - 1, &code,
-                           &codeLen ) )
-    {
-        AiaLogError( "Failed to parse the %s key in the reponse body",
-                     AIA_REGISTRATION_CODE_KEY );
-        *failureCode = AIA_REGISTRATION_FAILURE_RESPONSE_ERROR;
-        return false;
-    }
-    if( !AiaJsonUtils_UnquoteString( &code, &codeLen ) )
+    const AiaRegistrationResponseValue_t* codeValue =
+        AiaRegistrationResponseParser_GetValue(
+            parser, AIA_REGISTRATION_RESPONSE_CODE );
+    if( !codeValue )
     {
-        AiaLogError( "Malformed JSON" );
         *failureCode = AIA_REGISTRATION_FAILURE_RESPONSE_ERROR;
         return false;
     }
+    const char* code = codeValue->value;
+    size_t codeLen = codeValue->length;
 
-    const char* description;
-    size_t descriptionLen;
-    if( !AiaFindJsonValue( body, bodyLen, AIA_REGISTRATION_DESCRIPTION_KEY,
-                           sizeof( AIA_REGISTRATION_DESCRIPTION_KEY ) - 1,
-                           &description, &descriptionLen ) )
+    /* The description is only logged, so a truncated one will do. */
+    const AiaRegistrationResponseValue_t* descriptionValue =
+        &parser->values[ AIA_REGISTRATION_RESPONSE_DESCRIPTION ];
+    if( !descriptionValue->found )
     {
         AiaLogError( "Failed to parse the %s key in the response body",
                      AIA_REGISTRATION_DESCRIPTION_KEY );
         *failureCode = AIA_REGISTRATION_FAILURE_RESPONSE_ERROR;
         return false;
     }
-    if( !AiaJsonUtils_UnquoteString( &description, &descriptionLen ) )
-    {
-        AiaLogError( "Malformed JSON" );
-        *failureCode = AIA_REGISTRATION_FAILURE_RESPONSE_ERROR;
-        return false;
-    }
+    const char* description = descriptionValue->value;
+    size_t descriptionLen = descriptionValue->length;
 
     AiaLogInfo(
         "Registration Failure Response received. code=%.*s, description=%.*s",
@@ -289,6 +444,33 @@ static bool HandleRegistrationFailedResponseBody(
     return true;
 }
 
+/**
+ * Callback called as the body of the response to the registration request is
+ * received.
+ *
+ * @param status The response code received.
+ * @param chunk The next bytes of the body of the response.
+ * @param chunkLen The length of @c chunk.
+ * @param userData The user data for the callback.
+ */
+static void OnRegistrationResponseChunkReceived( size_t status,
+                                                 const char* chunk,
+                                                 size_t chunkLen,
+                                                 void* userData )
+{
+    (void)status;
+    AiaAssert( userData );
+    if( !userData )
+    {
+        AiaLogError( "Null userData." );
+        return;
+    }
+    AiaRegistrationManager_t* registrationManager =
+        (AiaRegistrationManager_t*)userData;
+    AiaRegistrationResponseParser_Push( &registrationManager->responseParser,
+                                        chunk, chunkLen );
+}
+
 /**
  * Callback called when a response is received for the registration request.
  *
@@ -318,8 +500,8 @@ static void OnRegistrationResponseReceived( AiaHttpsResponse_t* httpsResponse,
     {
         if( !HandleRegistrationSuccessResponseBody(
                 registrationManager->privateKey,
-                sizeof( registrationManager->privateKey ), httpsResponse->body,
-                httpsResponse->bodyLen ) )
+                sizeof( registrationManager->privateKey ),
+                &registrationManager->responseParser ) )
         {
             AiaLogError( "HandleRegistrationSuccessResponseBody failed." );
             registrationManager->isRegistrationInProgress = false;
@@ -337,7 +519,7 @@ static void OnRegistrationResponseReceived( AiaHttpsResponse_t* httpsResponse,
     {
         AiaRegistrationFailureCode_t failureCode;
         if( !HandleRegistrationFailedResponseBody(
-                httpsResponse->body, httpsResponse->bodyLen, &failureCode ) )
+                &registrationManager->responseParser, &failureCode ) )
         {
             AiaLogError( "HandleRegistrationFailedResponseBody failed." );
         }
@@ -375,6 +557,29 @@ AiaRegistrationManager_t* AiaRegistrationManager_Create(
     void* onRegisterSuccessUserData,
     AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
     void* onRegisterFailureUserData )
+{
+    return AiaRegistrationManager_CreateWithKeyPairCache(
+        onRegisterSuccess, onRegisterSuccessUserData, onRegisterFailure,
+        onRegisterFailureUserData, NULL );
+}
+
+AiaRegistrationManager_t* AiaRegistrationManager_CreateWithKeyPairCache(
+    AiaRegistrationManagerOnRegisterSuccessCallback_t onRegisterSuccess,
+    void* onRegisterSuccessUserData,
+    AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
+    void* onRegisterFailureUserData, AiaKeyPairCache_t* keyPairCache )
+{
+    return AiaRegistrationManager_CreateWithCaches(
+        onRegisterSuccess, onRegisterSuccessUserData, onRegisterFailure,
+        onRegisterFailureUserData, keyPairCache, NULL );
+}
+
+AiaRegistrationManager_t* AiaRegistrationManager_CreateWithCaches(
+    AiaRegistrationManagerOnRegisterSuccessCallback_t onRegisterSuccess,
+    void* onRegisterSuccessUserData,
+    AiaRegistrationManagerOnRegisterFailureCallback_t onRegisterFailure,
+    void* onRegisterFailureUserData, AiaKeyPairCache_t* keyPairCache,
+    AiaLwaCredentialCache_t* lwaCredentialCache )
 {
     if( !onRegisterSuccess )
     {
@@ -404,12 +609,22 @@ AiaRegistrationManager_t* AiaRegistrationManager_Create(
          ->onRegisterFailure = onRegisterFailure;
     *(void**)&registrationManager->onRegisterFailureUserData =
         onRegisterFailureUserData;
+    *(AiaLwaCredentialCache_t**)&registrationManager->lwaCredentialCache =
+        lwaCredentialCache;
 
-    if( !AiaCrypto_GenerateKeyPair( SECRET_DERIVATION_ALGORITHM,
+    bool isKeyPairReady =
+        keyPairCache
+            ? AiaKeyPairCache_Take( keyPairCache,
                                     registrationManager->privateKey,
                                     sizeof( registrationManager->privateKey ),
                                     registrationManager->publicKey,
-                                    sizeof( registrationManager->publicKey ) ) )
+                                    sizeof( registrationManager->publicKey ) )
+            : AiaCrypto_GenerateKeyPair(
+                  SECRET_DERIVATION_ALGORITHM, registrationManager->privateKey,
+                  sizeof( registrationManager->privateKey ),
+                  registrationManager->publicKey,
+                  sizeof( registrationManager->publicKey ) );
+    if( !isKeyPairReady )
     {
         AiaLogError( "Failed to generate key pair." );
         AiaRegistrationManager_Destroy( registrationManager );
@@ -456,42 +671,15 @@ bool AiaRegistrationManager_Register(
         return false;
     }
 
-    size_t refreshTokenLen;
-    if( !AiaGetRefreshToken( NULL, &refreshTokenLen ) )
+    AiaLwaCredentialCache_t* lwaCredentialCache =
+        registrationManager->lwaCredentialCache;
+    AiaLwaCredentials_t* lwaCredentials =
+        lwaCredentialCache ? AiaLwaCredentialCache_Get( lwaCredentialCache )
+                           : AiaLwaCredentials_Load();
+    if( !lwaCredentials )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaLogError(
-            "AiaGetRefreshToken Failed. Failed to get LWA refresh token "
-            "length." );
-        return false;
-    }
-    char* refreshToken = (char*)AiaCalloc( 1, refreshTokenLen );
-    if( !AiaGetRefreshToken( refreshToken, &refreshTokenLen ) )
-    {
-        registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
-        AiaLogError(
-            "AiaGetRefreshToken Failed. Failed to retrieve LWA refresh "
-            "token." );
-        return false;
-    }
-
-    size_t lwaClientIdLen;
-    if( !AiaGetLwaClientId( NULL, &lwaClientIdLen ) )
-    {
-        registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
-        AiaLogError(
-            "AiaGetLwaClientId Failed. Failed to get LWA Client Id length." );
-        return false;
-    }
-    char lwaClientId[ lwaClientIdLen ];
-    if( !AiaGetLwaClientId( lwaClientId, &lwaClientIdLen ) )
-    {
-        registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
-        AiaLogError(
-            "AiaGetLwaClientId Failed. Failed to retrieve LWA Client Id." );
+        AiaLogError( "Failed to get LWA credentials." );
         return false;
     }
 
@@ -499,7 +687,7 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetIotClientId( NULL, &iotClientIdLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetIotClientId Failed. Failed to get IoT Client Id length." );
         return false;
@@ -508,7 +696,7 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetIotClientId( iotClientId, &iotClientIdLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetIotClientId Failed. Failed to retrieve IoT Client Id." );
         return false;
@@ -518,7 +706,7 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetAwsAccountId( NULL, &awsAccountIdLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetAwsAccountId Failed. Failed to get AWS Account Id length." );
         return false;
@@ -527,7 +715,7 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetAwsAccountId( awsAccountId, &awsAccountIdLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetAwsAccountId Failed. Failed to retrieve AWS Account Id." );
         return false;
@@ -537,7 +725,7 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetIotEndpoint( NULL, &iotEndpointLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetIotEndpoint Failed. Failed to get IoT endpoint length." );
         return false;
@@ -546,28 +734,29 @@ bool AiaRegistrationManager_Register(
     if( !AiaGetIotEndpoint( iotEndpoint, &iotEndpointLen ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError(
             "AiaGetIotEndpoint Failed. Failed to retrieve IoT endpoint." );
         return false;
     }
 
     size_t requestBodyBufferSize = BuildRegistrationRequestBody(
-        NULL, 0, refreshToken, lwaClientId, SECRET_DERIVATION_ALGORITHM,
-        (char*)base64PublicKey, awsAccountId, iotClientId, iotEndpoint );
+        NULL, 0, lwaCredentials->refreshToken, lwaCredentials->lwaClientId,
+        SECRET_DERIVATION_ALGORITHM, (char*)base64PublicKey, awsAccountId,
+        iotClientId, iotEndpoint );
     if( !requestBodyBufferSize )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
+        AiaLwaCredentials_Destroy( lwaCredentials );
         AiaLogError( "BuildRegistrationRequestBody failed." );
         return false;
     }
 
     char requestBodyBuffer[ requestBodyBufferSize ];
     BuildRegistrationRequestBody(
-        requestBodyBuffer, requestBodyBufferSize, refreshToken, lwaClientId,
-        SECRET_DERIVATION_ALGORITHM, (char*)base64PublicKey, awsAccountId,
-        iotClientId, iotEndpoint );
+        requestBodyBuffer, requestBodyBufferSize, lwaCredentials->refreshToken,
+        lwaCredentials->lwaClientId, SECRET_DERIVATION_ALGORITHM,
+        (char*)base64PublicKey, awsAccountId, iotClientId, iotEndpoint );
 
     const char* headers[] = { REGISTRATION_REQUEST_CONTENT };
 
@@ -578,17 +767,48 @@ bool AiaRegistrationManager_Register(
     httpsRequest.url = AIA_REGISTRATION_ENDPOINT;
     httpsRequest.body = requestBodyBuffer;
 
-    if( !AiaSendHttpsRequest( &httpsRequest, OnRegistrationResponseReceived,
-                              registrationManager, OnRegistrationRequestFailure,
-                              registrationManager ) )
+    memset( &registrationManager->responseParser, 0,
+            sizeof( registrationManager->responseParser ) );
+    if( !AiaSendHttpsStreamingRequest(
+            &httpsRequest, OnRegistrationResponseChunkReceived,
+            OnRegistrationResponseReceived, registrationManager,
+            OnRegistrationRequestFailure, registrationManager ) )
     {
         registrationManager->isRegistrationInProgress = false;
-        AiaFree( refreshToken );
-        AiaLogError( "AiaSendHttpsRequest failed." );
+        AiaLwaCredentials_Destroy( lwaCredentials );
+        AiaLogError( "AiaSendHttpsStreamingRequest failed." );
         return false;
     }
 
-    AiaFree( refreshToken );
+    AiaLwaCredentials_Destroy( lwaCredentials );
+    return true;
+}
+
+bool AiaRegistrationManager_IsRegistered()
+{
+    size_t topicRootSize = AiaGetTopicRootSize();
+    if( !topicRootSize )
+    {
+        AiaLogDebug( "No persisted topic root" );
+        return false;
+    }
+    uint8_t topicRoot[ topicRootSize ];
+    if( !AiaLoadTopicRoot( topicRoot, topicRootSize ) )
+    {
+        AiaLogDebug( "AiaLoadTopicRoot failed" );
+        return false;
+    }
+
+    size_t sharedSecretSizeInBits =
+        AiaSecretDerivationAlgorithm_GetKeySize( SECRET_DERIVATION_ALGORITHM );
+    size_t sharedSecretSizeInBytes =
+        AiaBytesToHoldBits( sharedSecretSizeInBits );
+    uint8_t sharedSecret[ sharedSecretSizeInBytes ];
+    if( !AiaLoadSecret( sharedSecret, sharedSecretSizeInBytes ) )
+    {
+        AiaLogDebug( "AiaLoadSecret failed" );
+        return false;
+    }
     return true;
 }
 
@@ -24,8 +24,9 @@
 
 #include AiaClock( HEADER )
 #include AiaMutex( HEADER )
-#include AiaTimer( HEADER )
+#include AiaRealtimeTimer( HEADER )
 
+#include <aiacore/aia_overload_governor.h>
 #include <aiaregulator/aia_regulator.h>
 #include <aiaregulator/private/aia_regulator_buffer.h>
 
@@ -43,6 +44,15 @@ struct AiaRegulator
     /** User data for @c emitMessageChunk callback. */
     void* const emitMessageChunkUserData;
 
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    /** Optional callback preparing written chunks. This is set before chunks
+     * are written, so it is read without holding @c mutex. */
+    AiaRegulatorStageChunkCallback_t stageChunk;
+
+    /** User data for @c stageChunk callback. */
+    void* stageChunkUserData;
+#endif
+
     /** Mutex for synchronizing access to variables in the group below. */
     AiaMutex_t mutex;
 
@@ -58,58 +68,130 @@ struct AiaRegulator
     /** Timestamp tracking when the last message was emitted. */
     AiaTimepointMs_t lastEmitTimestampMs;
 
+    /**
+     * The number of messages which may be emitted back to back, i.e. the size
+     * of the token bucket.  One token is returned every @c minWaitTimeMs.
+     */
+    size_t maxBurst;
+
+    /** The number of messages which may be emitted right now. */
+    size_t tokens;
+
+    /** The time up to which tokens have been returned to the bucket. */
+    AiaTimepointMs_t lastRefillMs;
+
     /** Timestamp tracking when the oldest buffered data was written. */
     AiaTimepointMs_t firstWriteTimestampMs;
 
+#if defined( AIA_ENABLE_LATENCY_HISTOGRAMS ) || \
+    defined( AIA_ENABLE_OVERLOAD_GOVERNOR )
+    /** When the data at the front of the buffer was written, or when the last
+     * emit left it at the front. */
+    AiaTimepointMs_t frontTimestampMs;
+#endif
+
+    /** Whether @c timer is currently armed to emit the buffered data. */
+    bool emitScheduled;
+
+    /**
+     * Whether @c timer is only armed for the deadline of a deferred chunk, and
+     * may be brought forward by a write which needs to go out sooner.
+     */
+    bool isEmitDeferred;
+
+    /** When the earliest held deferred chunk must be emitted by. */
+    AiaTimepointMs_t deferredDeadlineMs;
+
+    /** Queued size at which writes fail, or zero if unbounded. */
+    size_t highWatermarkBytes;
+
+    /** Queued size at which writes are accepted again. */
+    size_t lowWatermarkBytes;
+
+    /** Optional callback for crossings of the watermarks. */
+    AiaRegulatorWatermarkCallback_t watermarkCallback;
+
+    /** User data for @c watermarkCallback. */
+    void* watermarkCallbackUserData;
+
+    /** Whether the queued data last crossed @c highWatermarkBytes. */
+    bool isAboveHighWatermark;
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    /** Whether chunks are held rather than emitted. */
+    bool isPaused;
+#endif
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /** The budget charged for queued data, or @c NULL. */
+    AiaMemoryBudget_t* memoryBudget;
+#endif
+
     /** @} */
 
     /** Timer which emits the buffer. */
-    AiaTimer_t timer;
+    AiaRealtimeTimer_t timer;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** Reported by @c AiaRegulator_GetMetrics(). */
+    AiaHistogram_t queueingDelayMs;
+#endif
 };
 
 /**
- * Called by @c regulator->timer to emit messages.
+ * Returns the tokens earned since the last refill to the bucket.
  *
- * @param regulator Pointer to the regulator instance to act on.
+ * @param regulator The regulator instance to act on.
+ * @param now The current time.
  *
  * @note Caller must be holding @c regulator->mutex while calling this function.
  */
-static void AiaRegulator_EmitMessageLocked( AiaRegulator_t* regulator )
+static void AiaRegulator_RefillLocked( AiaRegulator_t* regulator,
+                                       AiaTimepointMs_t now )
 {
-    if( AiaClock( GetTimeMs )() - regulator->lastEmitTimestampMs <
-        regulator->minWaitTimeMs )
-    {
-        /* Check to ensure we wait the minimum amount of time between emissions.
-         * This acts as a guard to protect from underlying timer bugs. */
-        return;
-    }
-    if( AiaRegulatorBuffer_IsEmpty( regulator->buffer ) )
-    {
-        return;
-    }
-
-    if( !AiaRegulatorBuffer_RemoveFront( regulator->buffer,
-                                         regulator->emitMessageChunk,
-                                         regulator->emitMessageChunkUserData ) )
+    size_t missing = regulator->maxBurst - regulator->tokens;
+    if( !regulator->minWaitTimeMs || !missing ||
+        ( now - regulator->lastRefillMs ) / regulator->minWaitTimeMs >=
+            missing )
     {
-        AiaLogError( "Failed to remove a message from the buffer." );
+        /* A full bucket does not bank time towards later tokens. */
+        regulator->tokens = regulator->maxBurst;
+        regulator->lastRefillMs = now;
         return;
     }
-
-    regulator->lastEmitTimestampMs = AiaClock( GetTimeMs )();
+    AiaTimepointMs_t refills =
+        ( now - regulator->lastRefillMs ) / regulator->minWaitTimeMs;
+    regulator->tokens += refills;
+    regulator->lastRefillMs += refills * regulator->minWaitTimeMs;
 }
 
 /**
- * Called by @c regulator->timer to emit messages.
+ * Signals a crossing of the watermarks, if the queued data has crossed one.
  *
- * @param userData Pointer to the regulator instance to act on.
+ * @param regulator The regulator instance to act on.
+ *
+ * @note Caller must be holding @c regulator->mutex while calling this function.
  */
-static void AiaRegulator_EmitMessage( void* userData )
+static void AiaRegulator_CheckWatermarksLocked( AiaRegulator_t* regulator )
 {
-    AiaRegulator_t* regulator = (AiaRegulator_t*)userData;
-    AiaMutex( Lock )( &regulator->mutex );
-    AiaRegulator_EmitMessageLocked( regulator );
-    AiaMutex( Unlock )( &regulator->mutex );
+    if( !regulator->highWatermarkBytes )
+    {
+        return;
+    }
+    size_t size = AiaRegulatorBuffer_GetSize( regulator->buffer );
+    bool isAboveHighWatermark = regulator->isAboveHighWatermark
+                                    ? size > regulator->lowWatermarkBytes
+                                    : size >= regulator->highWatermarkBytes;
+    if( isAboveHighWatermark == regulator->isAboveHighWatermark )
+    {
+        return;
+    }
+    regulator->isAboveHighWatermark = isAboveHighWatermark;
+    if( regulator->watermarkCallback )
+    {
+        regulator->watermarkCallback( isAboveHighWatermark,
+                                      regulator->watermarkCallbackUserData );
+    }
 }
 
 /**
@@ -131,11 +213,13 @@ static bool AiaRegulator_StartEmittingLocked( AiaRegulator_t* regulator )
     /* Assume we don't need to wait to emit, and then refine below. */
     AiaDurationMs_t delay = 0;
 
-    /* If it hasn't been long enough since the last emit, we need to wait at
-     * *least* that long. */
-    if( timeSinceEmitMs < regulator->minWaitTimeMs )
+    /* If the bucket is out of tokens, we need to wait at *least* until the
+     * next one is returned.  With the default single token, this is the
+     * minimum wait since the last emit. */
+    AiaRegulator_RefillLocked( regulator, now );
+    if( !regulator->tokens )
     {
-        delay = regulator->minWaitTimeMs - timeSinceEmitMs;
+        delay = regulator->lastRefillMs + regulator->minWaitTimeMs - now;
     }
 
     /* If we're in burst mode and we can't fill a message yet and it hasn't been
@@ -145,33 +229,168 @@ static bool AiaRegulator_StartEmittingLocked( AiaRegulator_t* regulator )
         !AiaRegulatorBuffer_CanFillMessage( regulator->buffer ) &&
         timeSinceWriteMs < regulator->minWaitTimeMs &&
         timeSinceWriteMs < timeSinceEmitMs;
-    if( extendDelay )
+    if( extendDelay && regulator->minWaitTimeMs - timeSinceWriteMs > delay )
     {
         delay = regulator->minWaitTimeMs - timeSinceWriteMs;
     }
 
-    if( !AiaTimer( Arm )( &regulator->timer, delay, regulator->minWaitTimeMs ) )
+    if( !AiaRealtimeTimer( Arm )( &regulator->timer, delay, 0 ) )
     {
         AiaLogError( "Failed to start timer." );
         return false;
     }
+    regulator->emitScheduled = true;
+    regulator->isEmitDeferred = false;
 
     return true;
 }
 
 /**
- * Causes the regulator to (re)start emitting messages, and continue until the
- * buffer empties.
+ * Arms @c regulator->timer for the deadline of a deferred chunk, unless an emit
+ * is already scheduled to happen by then.
  *
  * @param regulator The regulator instance to act on.
- * @return @c true if emitting started successfully, else @c false.
+ * @param maxDelayMs The longest time the deferred chunk may be held.
+ * @return @c true if the chunk will be emitted by its deadline, else @c false.
+ *
+ * @note Caller must be holding @c regulator->mutex while calling this function.
+ */
+static bool AiaRegulator_DeferEmittingLocked( AiaRegulator_t* regulator,
+                                              AiaDurationMs_t maxDelayMs )
+{
+    AiaTimepointMs_t deadlineMs = AiaClock( GetTimeMs )() + maxDelayMs;
+    if( regulator->emitScheduled &&
+        ( !regulator->isEmitDeferred ||
+          regulator->deferredDeadlineMs <= deadlineMs ) )
+    {
+        return true;
+    }
+
+    if( !AiaRealtimeTimer( Arm )( &regulator->timer, maxDelayMs, 0 ) )
+    {
+        AiaLogError( "Failed to start timer." );
+        return false;
+    }
+    regulator->emitScheduled = true;
+    regulator->isEmitDeferred = true;
+    regulator->deferredDeadlineMs = deadlineMs;
+
+    return true;
+}
+
+/**
+ * Called by @c regulator->timer to emit messages.
+ *
+ * @param regulator Pointer to the regulator instance to act on.
+ *
+ * @note Caller must be holding @c regulator->mutex while calling this function.
  */
-static bool AiaRegulator_StartEmitting( AiaRegulator_t* regulator )
+static void AiaRegulator_EmitMessageLocked( AiaRegulator_t* regulator )
 {
+    /* The timer is armed as a one-shot, so it is no longer scheduled.  Once
+     * emitting starts, it carries on until any deferred chunks are out too. */
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    /* Deferred chunks are held on purpose, so their wait is not load. */
+    bool wasEmitDeferred = regulator->isEmitDeferred;
+#endif
+    regulator->emitScheduled = false;
+    regulator->isEmitDeferred = false;
+
+    if( AiaRegulatorBuffer_IsEmpty( regulator->buffer ) )
+    {
+        return;
+    }
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    /* Emitting starts again when the regulator is resumed. */
+    if( regulator->isPaused )
+    {
+        return;
+    }
+#endif
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+    AiaRegulator_RefillLocked( regulator, now );
+    if( regulator->tokens )
+    {
+        /* Only emit once a token is available.  This acts as a guard to protect
+         * from underlying timer bugs. */
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        size_t queuedBytes = AiaRegulatorBuffer_GetSize( regulator->buffer );
+#endif
+        bool removed = AiaRegulatorBuffer_RemoveFront(
+            regulator->buffer, regulator->emitMessageChunk,
+            regulator->emitMessageChunkUserData );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        /* Some chunks may have been emitted even if removal failed. */
+        if( regulator->memoryBudget )
+        {
+            AiaMemoryBudget_Release(
+                regulator->memoryBudget,
+                queuedBytes - AiaRegulatorBuffer_GetSize( regulator->buffer ) );
+        }
+#endif
+        if( removed )
+        {
+            regulator->lastEmitTimestampMs = AiaClock( GetTimeMs )();
+            AiaRegulator_CheckWatermarksLocked( regulator );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+            AiaHistogram_Record(
+                &regulator->queueingDelayMs,
+                (uint32_t)( now - regulator->frontTimestampMs ) );
+#endif
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+            if( !wasEmitDeferred )
+            {
+                AiaOverloadGovernor_ReportQueueAge(
+                    (uint32_t)( now - regulator->frontTimestampMs ) );
+            }
+#endif
+#if defined( AIA_ENABLE_LATENCY_HISTOGRAMS ) || \
+    defined( AIA_ENABLE_OVERLOAD_GOVERNOR )
+            regulator->frontTimestampMs = regulator->lastEmitTimestampMs;
+#endif
+
+            /* Tokens are only returned while the bucket is not full, so start
+             * counting from this emit if it was. */
+            if( regulator->tokens-- == regulator->maxBurst )
+            {
+                regulator->lastRefillMs = regulator->lastEmitTimestampMs;
+            }
+        }
+        else
+        {
+            /* Retry after the minimum wait rather than immediately. */
+            AiaLogError( "Failed to remove a message from the buffer." );
+            if( !AiaRealtimeTimer( Arm )( &regulator->timer,
+                                          regulator->minWaitTimeMs, 0 ) )
+            {
+                AiaLogError( "Failed to start timer." );
+                return;
+            }
+            regulator->emitScheduled = true;
+            return;
+        }
+    }
+
+    /* Keep emitting until the buffer empties. */
+    if( !AiaRegulatorBuffer_IsEmpty( regulator->buffer ) )
+    {
+        AiaRegulator_StartEmittingLocked( regulator );
+    }
+}
+
+/**
+ * Called by @c regulator->timer to emit messages.
+ *
+ * @param userData Pointer to the regulator instance to act on.
+ */
+static void AiaRegulator_EmitMessage( void* userData )
+{
+    AiaRegulator_t* regulator = (AiaRegulator_t*)userData;
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_REGULATOR_EMIT );
     AiaMutex( Lock )( &regulator->mutex );
-    bool result = AiaRegulator_StartEmittingLocked( regulator );
+    AiaRegulator_EmitMessageLocked( regulator );
     AiaMutex( Unlock )( &regulator->mutex );
-    return result;
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_REGULATOR_EMIT );
 }
 
 /**
@@ -179,29 +398,101 @@ static bool AiaRegulator_StartEmitting( AiaRegulator_t* regulator )
  *
  * @param regulator The regulator instance to act on.
  * @param chunk Message chunk to be written.
+ * @param priority The priority class of @c chunk.
+ * @param maxDelayMs The longest time @c chunk may be held before it is emitted,
+ * or @c 0 if it should not be held.
  * @return @c true if the message chunk was succesfully added, else @c false.
  *
  * @note Caller must be holding @c regulator->mutex while calling this function.
  */
 static bool AiaRegulator_WriteLocked( AiaRegulator_t* regulator,
-                                      AiaRegulatorChunk_t* chunk )
+                                      AiaRegulatorChunk_t* chunk,
+                                      AiaRegulatorPriority_t priority,
+                                      AiaDurationMs_t maxDelayMs )
 {
     /* Update the write timestamp if this is the first write to an empty buffer.
      */
     if( AiaRegulatorBuffer_IsEmpty( regulator->buffer ) )
     {
         regulator->firstWriteTimestampMs = AiaClock( GetTimeMs )();
+#if defined( AIA_ENABLE_LATENCY_HISTOGRAMS ) || \
+    defined( AIA_ENABLE_OVERLOAD_GOVERNOR )
+        regulator->frontTimestampMs = regulator->firstWriteTimestampMs;
+#endif
+    }
+    bool couldFillMessage =
+        AiaRegulatorBuffer_CanFillMessage( regulator->buffer );
+
+    /* Refuse chunks while the queue is full, so that producers which watch
+     * the watermarks can hold on to their data and retry. */
+    if( regulator->highWatermarkBytes &&
+        AiaRegulatorBuffer_GetSize( regulator->buffer ) >=
+            regulator->highWatermarkBytes )
+    {
+        AiaLogDebug( "Queue full, size=%zu.",
+                     AiaRegulatorBuffer_GetSize( regulator->buffer ) );
+        return false;
+    }
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /* Refuse chunks over budget in the same way as over the high watermark. */
+    size_t chunkSize = AiaMessage_GetSize( chunk );
+    if( regulator->memoryBudget &&
+        !AiaMemoryBudget_Charge( regulator->memoryBudget, chunkSize ) )
+    {
+        AiaLogWarn( "Queue over budget, size=%zu.",
+                    AiaRegulatorBuffer_GetSize( regulator->buffer ) );
+        return false;
     }
+#endif
 
     /* Queue the chunks. */
-    /* TODO: failure may mean we're full and need to retry (ADSER-1496). */
-    if( !AiaRegulatorBuffer_PushBack( regulator->buffer, chunk ) )
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    size_t queuedBytes = AiaRegulatorBuffer_GetSize( regulator->buffer );
+#endif
+    if( !AiaRegulatorBuffer_PushBackWithPriority( regulator->buffer, chunk,
+                                                  priority ) )
     {
         AiaLogError( "Failed to push chunk onto queue." );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        if( regulator->memoryBudget )
+        {
+            AiaMemoryBudget_Release( regulator->memoryBudget, chunkSize );
+        }
+#endif
         return false;
     }
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /* Return the charge for any chunk this one superseded. */
+    size_t supersededBytes = queuedBytes + chunkSize -
+                             AiaRegulatorBuffer_GetSize( regulator->buffer );
+    if( regulator->memoryBudget && supersededBytes )
+    {
+        AiaMemoryBudget_Release( regulator->memoryBudget, supersededBytes );
+    }
+#endif
+    AiaRegulator_CheckWatermarksLocked( regulator );
+
+    /* Only (re)schedule the emitter if it is idle, or if this write filled a
+     * message which a burst mode emit may otherwise still be waiting on.  An
+     * already scheduled emit will pick up the new chunk on its own. */
+    bool filledMessage = AIA_REGULATOR_BURST == regulator->emitMode &&
+                         !couldFillMessage &&
+                         AiaRegulatorBuffer_CanFillMessage( regulator->buffer );
+    if( maxDelayMs && !filledMessage )
+    {
+        return AiaRegulator_DeferEmittingLocked( regulator, maxDelayMs );
+    }
 
-    return true;
+    /* A write which can not wait brings forward an emit that was only
+     * scheduled for the deadline of a deferred chunk. */
+    if( regulator->emitScheduled && !regulator->isEmitDeferred &&
+        !filledMessage )
+    {
+        return true;
+    }
+
+    return AiaRegulator_StartEmittingLocked( regulator );
 }
 
 AiaRegulator_t* AiaRegulator_Create(
@@ -240,8 +531,11 @@ AiaRegulator_t* AiaRegulator_Create(
         return NULL;
     }
     regulator->emitMode = AIA_REGULATOR_TRICKLE;
-    if( !AiaTimer( Create )( &regulator->timer, AiaRegulator_EmitMessage,
-                             regulator ) )
+    regulator->maxBurst = 1;
+    regulator->tokens = 1;
+    regulator->lastRefillMs = AiaClock( GetTimeMs )();
+    if( !AiaRealtimeTimer( Create )( &regulator->timer,
+                                     AiaRegulator_EmitMessage, regulator ) )
     {
         AiaLogError( "AiaRegulatorBuffer_Create failed (maxMessageSize=%zu).",
                      maxMessageSize );
@@ -259,7 +553,7 @@ AiaRegulator_t* AiaRegulator_Create(
     {
         AiaLogError( "AiaRegulatorBuffer_Create failed (maxMessageSize=%zu).",
                      maxMessageSize );
-        AiaTimer( Destroy )( &regulator->timer );
+        AiaRealtimeTimer( Destroy )( &regulator->timer );
         AiaMutex( Destroy )( &regulator->mutex );
         AiaFree( regulator );
         return NULL;
@@ -278,14 +572,80 @@ void AiaRegulator_Destroy( AiaRegulator_t* regulator,
         return;
     }
 
-    AiaTimer( Destroy )( &regulator->timer );
+    AiaRealtimeTimer( Destroy )( &regulator->timer );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( regulator->memoryBudget )
+    {
+        AiaMemoryBudget_Release(
+            regulator->memoryBudget,
+            AiaRegulatorBuffer_GetSize( regulator->buffer ) );
+    }
+#endif
     AiaRegulatorBuffer_Destroy( regulator->buffer, destroyChunk,
                                 destroyChunkUserData );
     AiaMutex( Destroy )( &regulator->mutex );
     AiaFree( regulator );
 }
 
+/**
+ * Prepares a chunk being written with @c regulator->stageChunk, if set.
+ *
+ * @param regulator The regulator instance to act on.
+ * @param chunk The chunk being written.
+ */
+static void AiaRegulator_StageChunk( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk )
+{
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    if( regulator->stageChunk )
+    {
+        regulator->stageChunk( chunk, regulator->stageChunkUserData );
+    }
+#else
+    (void)regulator;
+    (void)chunk;
+#endif
+}
+
 bool AiaRegulator_Write( AiaRegulator_t* regulator, AiaRegulatorChunk_t* chunk )
+{
+    return AiaRegulator_WriteWithPriority( regulator, chunk,
+                                           AIA_REGULATOR_PRIORITY_NORMAL );
+}
+
+bool AiaRegulator_WriteWithPriority( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaRegulatorPriority_t priority )
+{
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    if( !chunk )
+    {
+        AiaLogError( "Null chunk." );
+        return false;
+    }
+    if( AIA_REGULATOR_PRIORITY_LOW != priority &&
+        AIA_REGULATOR_PRIORITY_NORMAL != priority )
+    {
+        AiaLogError( "Invalid priority, priority=%d.", priority );
+        return false;
+    }
+    AiaRegulator_StageChunk( regulator, chunk );
+
+    /* Write the chunks to m_buffer, which will schedule the next emit
+     * appropriately. */
+    AiaMutex( Lock )( &regulator->mutex );
+    bool result = AiaRegulator_WriteLocked( regulator, chunk, priority, 0 );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return result;
+}
+
+bool AiaRegulator_WriteWithDeadline( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaDurationMs_t maxDelayMs )
 {
     if( !regulator )
     {
@@ -297,19 +657,179 @@ bool AiaRegulator_Write( AiaRegulator_t* regulator, AiaRegulatorChunk_t* chunk )
         AiaLogError( "Null chunk." );
         return false;
     }
+    AiaRegulator_StageChunk( regulator, chunk );
 
-    /* Write the chunks to m_buffer. */
     AiaMutex( Lock )( &regulator->mutex );
-    bool result = AiaRegulator_WriteLocked( regulator, chunk );
+    bool result = AiaRegulator_WriteLocked(
+        regulator, chunk, AIA_REGULATOR_PRIORITY_LOW, maxDelayMs );
     AiaMutex( Unlock )( &regulator->mutex );
-    if( !result )
+    return result;
+}
+
+void AiaRegulator_Flush( AiaRegulator_t* regulator )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    if( !AiaRegulatorBuffer_IsEmpty( regulator->buffer ) &&
+        ( !regulator->emitScheduled || regulator->isEmitDeferred ) )
+    {
+        AiaRegulator_StartEmittingLocked( regulator );
+    }
+    AiaMutex( Unlock )( &regulator->mutex );
+}
+
+bool AiaRegulator_WriteOrWait( AiaRegulator_t* regulator,
+                               AiaRegulatorChunk_t* chunk,
+                               AiaDurationMs_t timeoutMs )
+{
+    if( !regulator )
     {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    if( !chunk )
+    {
+        AiaLogError( "Null chunk." );
         return false;
     }
+    AiaRegulator_StageChunk( regulator, chunk );
 
-    /* Restart the timer, which will schedule the next emit appropriately. */
-    /* TODO: this is horribly inefficient; rework (ADSER-1497) */
-    return AiaRegulator_StartEmitting( regulator );
+    /* Space is only freed by emits, which happen at most every minWaitTimeMs
+     * outside of bursts, so polling at that cadence adds little latency. */
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    while( true )
+    {
+        AiaMutex( Lock )( &regulator->mutex );
+        bool isFull = regulator->highWatermarkBytes &&
+                      AiaRegulatorBuffer_GetSize( regulator->buffer ) >=
+                          regulator->highWatermarkBytes;
+        if( !isFull )
+        {
+            bool result = AiaRegulator_WriteLocked(
+                regulator, chunk, AIA_REGULATOR_PRIORITY_NORMAL, 0 );
+            AiaMutex( Unlock )( &regulator->mutex );
+            return result;
+        }
+        AiaMutex( Unlock )( &regulator->mutex );
+
+        AiaDurationMs_t elapsedMs = AiaClock( GetTimeMs )() - startMs;
+        if( elapsedMs >= timeoutMs )
+        {
+            AiaLogError( "Timed out waiting for the queue to drain." );
+            return false;
+        }
+        AiaDurationMs_t sleepMs = regulator->minWaitTimeMs;
+        if( !sleepMs )
+        {
+            sleepMs = 1;
+        }
+        if( sleepMs > timeoutMs - elapsedMs )
+        {
+            sleepMs = timeoutMs - elapsedMs;
+        }
+        AiaClock( SleepMs )( sleepMs );
+    }
+}
+
+bool AiaRegulator_SetWatermarks(
+    AiaRegulator_t* regulator, size_t highWatermarkBytes,
+    size_t lowWatermarkBytes, AiaRegulatorWatermarkCallback_t watermarkCallback,
+    void* watermarkCallbackUserData )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    if( highWatermarkBytes && lowWatermarkBytes >= highWatermarkBytes )
+    {
+        AiaLogError( "Invalid watermarks, high=%zu, low=%zu.",
+                     highWatermarkBytes, lowWatermarkBytes );
+        return false;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    regulator->highWatermarkBytes = highWatermarkBytes;
+    regulator->lowWatermarkBytes = lowWatermarkBytes;
+    regulator->watermarkCallback =
+        highWatermarkBytes ? watermarkCallback : NULL;
+    regulator->watermarkCallbackUserData = watermarkCallbackUserData;
+    regulator->isAboveHighWatermark = false;
+    AiaRegulator_CheckWatermarksLocked( regulator );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return true;
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+void AiaRegulator_SetMemoryBudget( AiaRegulator_t* regulator,
+                                   AiaMemoryBudget_t* memoryBudget )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    size_t queuedBytes = AiaRegulatorBuffer_GetSize( regulator->buffer );
+    if( regulator->memoryBudget )
+    {
+        AiaMemoryBudget_Release( regulator->memoryBudget, queuedBytes );
+    }
+    regulator->memoryBudget = memoryBudget;
+    if( memoryBudget )
+    {
+        AiaMemoryBudget_ForceCharge( memoryBudget, queuedBytes );
+    }
+    AiaMutex( Unlock )( &regulator->mutex );
+}
+#endif
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+void AiaRegulator_SetPaused( AiaRegulator_t* regulator, bool isPaused )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    regulator->isPaused = isPaused;
+    if( !isPaused && !AiaRegulatorBuffer_IsEmpty( regulator->buffer ) &&
+        ( !regulator->emitScheduled || regulator->isEmitDeferred ) )
+    {
+        AiaRegulator_StartEmittingLocked( regulator );
+    }
+    AiaMutex( Unlock )( &regulator->mutex );
+}
+#endif
+
+size_t AiaRegulator_TrimMemory( AiaRegulator_t* regulator,
+                                AiaRegulatorTrimMemoryCallback_t trimMemoryCb,
+                                void* userData )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return 0;
+    }
+    if( !trimMemoryCb )
+    {
+        AiaLogError( "Null trimMemoryCb." );
+        return 0;
+    }
+    /* Chunks are only emitted with the mutex held. */
+    AiaMutex( Lock )( &regulator->mutex );
+    size_t released = trimMemoryCb( userData );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return released;
 }
 
 void AiaRegulator_SetEmitMode( AiaRegulator_t* regulator,
@@ -329,3 +849,169 @@ void AiaRegulator_SetEmitMode( AiaRegulator_t* regulator,
     regulator->emitMode = mode;
     AiaMutex( Unlock )( &regulator->mutex );
 }
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+void AiaRegulator_SetStageChunkCallback(
+    AiaRegulator_t* regulator, AiaRegulatorStageChunkCallback_t stageChunk,
+    void* stageChunkUserData )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    regulator->stageChunk = stageChunk;
+    regulator->stageChunkUserData = stageChunkUserData;
+}
+#endif
+
+void AiaRegulator_SetSupersedeCallback(
+    AiaRegulator_t* regulator, AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    AiaRegulatorBuffer_SetSupersede( regulator->buffer, destroyChunk,
+                                     destroyChunkUserData );
+    AiaMutex( Unlock )( &regulator->mutex );
+}
+
+bool AiaRegulator_SetSupersedeKeyEnabled( AiaRegulator_t* regulator,
+                                          AiaMessageSupersedeKey_t key,
+                                          bool isEnabled )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    bool result = AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+        regulator->buffer, key, isEnabled );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return result;
+}
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+void AiaRegulator_SetExpiryCallback(
+    AiaRegulator_t* regulator, AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    AiaRegulatorBuffer_SetExpiry( regulator->buffer, destroyChunk,
+                                  destroyChunkUserData );
+    AiaMutex( Unlock )( &regulator->mutex );
+}
+
+bool AiaRegulator_SetMaxAge( AiaRegulator_t* regulator,
+                             AiaMessageSupersedeKey_t key,
+                             AiaDurationMs_t maxAgeMs )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    bool result =
+        AiaRegulatorBuffer_SetMaxAge( regulator->buffer, key, maxAgeMs );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return result;
+}
+#endif
+
+bool AiaRegulator_SetMaxBurst( AiaRegulator_t* regulator, size_t maxBurst )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return false;
+    }
+    if( !maxBurst )
+    {
+        AiaLogError( "Invalid maxBurst, maxBurst=%zu.", maxBurst );
+        return false;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    AiaRegulator_RefillLocked( regulator, AiaClock( GetTimeMs )() );
+    regulator->maxBurst = maxBurst;
+    if( regulator->tokens > maxBurst )
+    {
+        regulator->tokens = maxBurst;
+    }
+    /* A larger bucket may allow an emit which is waiting on a token to go out
+     * now.  Emits held for deferred chunks keep waiting for their deadline. */
+    if( regulator->emitScheduled && !regulator->isEmitDeferred )
+    {
+        AiaRegulator_StartEmittingLocked( regulator );
+    }
+    AiaMutex( Unlock )( &regulator->mutex );
+    return true;
+}
+
+AiaDurationMs_t AiaRegulator_GetMinWaitTimeMs( const AiaRegulator_t* regulator )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return 0;
+    }
+    return regulator->minWaitTimeMs;
+}
+
+size_t AiaRegulator_GetRemainingMessageSpace( AiaRegulator_t* regulator )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return 0;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    size_t maxMessageSize =
+        AiaRegulatorBuffer_GetMaxMessageSize( regulator->buffer );
+    size_t bufferedSize = AiaRegulatorBuffer_GetSize( regulator->buffer );
+    AiaMutex( Unlock )( &regulator->mutex );
+    return bufferedSize < maxMessageSize ? maxMessageSize - bufferedSize : 0;
+}
+
+void AiaRegulator_GetMetrics( AiaRegulator_t* regulator,
+                              AiaRegulatorMetrics_t* metrics )
+{
+    AiaAssert( regulator );
+    if( !regulator )
+    {
+        AiaLogError( "Null regulator." );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics." );
+        return;
+    }
+    AiaMutex( Lock )( &regulator->mutex );
+    metrics->queuedChunks = AiaRegulatorBuffer_GetNumChunks( regulator->buffer );
+    metrics->queuedBytes = AiaRegulatorBuffer_GetSize( regulator->buffer );
+    AiaMutex( Unlock )( &regulator->mutex );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Snapshot( &regulator->queueingDelayMs,
+                           &metrics->queueingDelayMs );
+#endif
+}
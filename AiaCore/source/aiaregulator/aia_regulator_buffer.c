@@ -22,9 +22,14 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include AiaClock( HEADER )
+
 #include <aiacore/aia_utils.h>
+#include <aiacore/private/aia_message.h>
 #include <aiaregulator/private/aia_regulator_buffer.h>
 
+#include <inttypes.h>
+
 #define AiaChunks( MEMBER ) AiaListDouble( MEMBER )
 #include AiaChunks( HEADER )
 
@@ -51,19 +56,224 @@ struct AiaRegulatorBuffer
      *     @li @c getSize() reports it for logging and testing purposes.
      */
     size_t bufferSize;
+
+    /** Number of chunks currently queued. */
+    size_t numChunks;
+
+    /**
+     * Number of chunks at the front of @c buffer which will be emitted by the
+     * next call to @c AiaRegulatorBuffer_RemoveFront().  This is the longest run
+     * of chunks from the front whose aggregate size fits in @c maxMessageSize.
+     */
+    size_t frontChunks;
+
+    /** Aggregate size of the first @c frontChunks chunks. */
+    size_t frontSize;
+
+    /**
+     * Number of @c AIA_REGULATOR_PRIORITY_NORMAL chunks queued.  These are
+     * always at the front of @c buffer, ahead of any lower priority chunks.
+     */
+    size_t normalChunks;
+
+    /** The last of the @c normalChunks chunks, or @c NULL if there are none. */
+    AiaChunks( Link_t )* lastNormalLink;
+
+    /** Destroys superseded chunks, or @c NULL if chunks are never superseded.
+     */
+    AiaRegulatorDestroyChunkCallback_t destroySupersededChunk;
+
+    /** User data for @c destroySupersededChunk. */
+    void* destroySupersededChunkUserData;
+
+    /** Bit @c n is set if chunks with supersede key @c n do not replace queued
+     * ones. */
+    uint32_t disabledSupersedeKeys;
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    /** Destroys expired chunks, or @c NULL if chunks never expire. */
+    AiaRegulatorDestroyChunkCallback_t destroyExpiredChunk;
+
+    /** User data for @c destroyExpiredChunk. */
+    void* destroyExpiredChunkUserData;
+
+    /** How long chunks with each supersede key may stay queued, or @c 0 if
+     * they never expire. */
+    AiaDurationMs_t maxAgeMs[ AIA_MESSAGE_MAX_SUPERSEDE_KEY + 1 ];
+
+    /** Bit @c n is set if @c maxAgeMs[ n ] is not @c 0. */
+    uint32_t expiringKeys;
+#endif
 };
 
-/** Linked list node for managing chunks. */
-/* TODO: This could be combined with the AiaMessage type by embedding the
- * AiaChunks(Link_t) in it. */
-typedef struct AiaRegulatorBufferNode
+/**
+ * Extends the front message run of @c regulatorBuffer with any queued chunks
+ * which now fit in @c maxMessageSize.  Each chunk is only ever added to the run
+ * once, so this is amortized O(1) per chunk.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ */
+static void AiaRegulatorBuffer_FillFront( AiaRegulatorBuffer_t* regulatorBuffer )
+{
+    if( regulatorBuffer->frontChunks == regulatorBuffer->numChunks )
+    {
+        return;
+    }
+    AiaChunks( Link_t )* link = NULL;
+    size_t index = 0;
+    AiaChunks( ForEach )( &regulatorBuffer->buffer, link )
+    {
+        /* Skip over the chunks which are already in the run. */
+        if( index++ < regulatorBuffer->frontChunks )
+        {
+            continue;
+        }
+        size_t chunkSize = AiaMessage_GetSize( (AiaRegulatorChunk_t*)link );
+        if( regulatorBuffer->frontSize + chunkSize >
+            regulatorBuffer->maxMessageSize )
+        {
+            break;
+        }
+        regulatorBuffer->frontSize += chunkSize;
+        ++regulatorBuffer->frontChunks;
+    }
+}
+
+/**
+ * Unlinks a queued chunk from anywhere in @c regulatorBuffer and updates the
+ * bookkeeping, without destroying it.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param link The link of the chunk to unlink.
+ * @param previousLink The link before @c link, or @c NULL if it is the first.
+ * @param index The position of @c link in the buffer.
+ */
+static void AiaRegulatorBuffer_Unlink( AiaRegulatorBuffer_t* regulatorBuffer,
+                                       AiaChunks( Link_t )* link,
+                                       AiaChunks( Link_t )* previousLink,
+                                       size_t index )
+{
+    AiaChunks( Remove )( link );
+    regulatorBuffer->bufferSize -=
+        AiaMessage_GetSize( (AiaRegulatorChunk_t*)link );
+    --regulatorBuffer->numChunks;
+    if( index < regulatorBuffer->normalChunks )
+    {
+        if( 0 == --regulatorBuffer->normalChunks )
+        {
+            regulatorBuffer->lastNormalLink = NULL;
+        }
+        else if( regulatorBuffer->lastNormalLink == link )
+        {
+            regulatorBuffer->lastNormalLink = previousLink;
+        }
+    }
+    if( index < regulatorBuffer->frontChunks )
+    {
+        /* Rebuild the front message without the removed chunk. */
+        regulatorBuffer->frontChunks = 0;
+        regulatorBuffer->frontSize = 0;
+        AiaRegulatorBuffer_FillFront( regulatorBuffer );
+    }
+}
+
+/**
+ * Removes and destroys the queued chunk which @c chunk supersedes, if any.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ * @param chunk The chunk about to be pushed.
+ */
+static void AiaRegulatorBuffer_RemoveSuperseded(
+    AiaRegulatorBuffer_t* regulatorBuffer, const AiaRegulatorChunk_t* chunk )
+{
+    AiaMessageSupersedeKey_t key = AiaMessage_GetSupersedeKey( chunk );
+    if( !key || !regulatorBuffer->destroySupersededChunk ||
+        regulatorBuffer->disabledSupersedeKeys & ( (uint32_t)1 << key ) )
+    {
+        return;
+    }
+
+    /* Only the oldest queued chunk with the key is replaced, as there is at
+     * most one unless the key was disabled for a while. */
+    AiaChunks( Link_t )* link = NULL;
+    AiaChunks( Link_t )* previousLink = NULL;
+    size_t index = 0;
+    AiaChunks( ForEach )( &regulatorBuffer->buffer, link )
+    {
+        if( AiaMessage_GetSupersedeKey( (AiaRegulatorChunk_t*)link ) == key )
+        {
+            break;
+        }
+        previousLink = link;
+        ++index;
+    }
+    if( index == regulatorBuffer->numChunks )
+    {
+        return;
+    }
+
+    AiaRegulatorChunk_t* superseded = (AiaRegulatorChunk_t*)link;
+    AiaRegulatorBuffer_Unlink( regulatorBuffer, link, previousLink, index );
+    AiaLogDebug( "Superseded chunk, key=%u, size=%zu.", (unsigned)key,
+                 AiaMessage_GetSize( superseded ) );
+    regulatorBuffer->destroySupersededChunk(
+        superseded, regulatorBuffer->destroySupersededChunkUserData );
+}
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+/**
+ * Removes and destroys every queued chunk which has been queued for longer than
+ * the maximum age of its supersede key.
+ *
+ * @param regulatorBuffer The regulator buffer instance to act on.
+ */
+static void AiaRegulatorBuffer_RemoveExpired(
+    AiaRegulatorBuffer_t* regulatorBuffer )
 {
-    /** The actual link in the list. */
-    AiaChunks( Link_t ) link;
+    if( !regulatorBuffer->expiringKeys ||
+        !regulatorBuffer->destroyExpiredChunk )
+    {
+        return;
+    }
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
 
-    /** The @c AiaMessage we're holding in the node. */
-    AiaRegulatorChunk_t* chunk;
-} AiaRegulatorBufferNode_t;
+    /* Chunks are unlinked one at a time, so start over after each one.  Few
+     * chunks ever expire, so this is typically a single pass. */
+    bool removed = true;
+    while( removed )
+    {
+        removed = false;
+        AiaChunks( Link_t )* link = NULL;
+        AiaChunks( Link_t )* previousLink = NULL;
+        size_t index = 0;
+        AiaChunks( ForEach )( &regulatorBuffer->buffer, link )
+        {
+            AiaRegulatorChunk_t* chunk = (AiaRegulatorChunk_t*)link;
+            AiaMessageSupersedeKey_t key = AiaMessage_GetSupersedeKey( chunk );
+            if( regulatorBuffer->expiringKeys & ( (uint32_t)1 << key ) &&
+                now - chunk->writeTimeMs > regulatorBuffer->maxAgeMs[ key ] )
+            {
+                removed = true;
+                break;
+            }
+            previousLink = link;
+            ++index;
+        }
+        if( !removed )
+        {
+            break;
+        }
+
+        AiaRegulatorChunk_t* expired = (AiaRegulatorChunk_t*)link;
+        AiaRegulatorBuffer_Unlink( regulatorBuffer, link, previousLink, index );
+        AiaLogDebug( "Expired chunk, key=%u, age=%" PRIu64 ".",
+                     (unsigned)AiaMessage_GetSupersedeKey( expired ),
+                     (uint64_t)( now - expired->writeTimeMs ) );
+        regulatorBuffer->destroyExpiredChunk(
+            expired, regulatorBuffer->destroyExpiredChunkUserData );
+    }
+}
+#endif
 
 AiaRegulatorBuffer_t* AiaRegulatorBuffer_Create( const size_t maxMessageSize )
 {
@@ -98,6 +308,14 @@ void AiaRegulatorBuffer_Destroy(
 
 bool AiaRegulatorBuffer_PushBack( AiaRegulatorBuffer_t* regulatorBuffer,
                                   AiaRegulatorChunk_t* chunk )
+{
+    return AiaRegulatorBuffer_PushBackWithPriority(
+        regulatorBuffer, chunk, AIA_REGULATOR_PRIORITY_NORMAL );
+}
+
+bool AiaRegulatorBuffer_PushBackWithPriority(
+    AiaRegulatorBuffer_t* regulatorBuffer, AiaRegulatorChunk_t* chunk,
+    AiaRegulatorPriority_t priority )
 {
     if( !regulatorBuffer )
     {
@@ -116,34 +334,142 @@ bool AiaRegulatorBuffer_PushBack( AiaRegulatorBuffer_t* regulatorBuffer,
                      regulatorBuffer->maxMessageSize, chunkSize );
         return false;
     }
+    AiaRegulatorBuffer_RemoveSuperseded( regulatorBuffer, chunk );
     regulatorBuffer->bufferSize += chunkSize;
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    chunk->writeTimeMs = AiaClock( GetTimeMs )();
+#endif
 
-    /* Allocate a new list node to hold this chunk. */
-    AiaRegulatorBufferNode_t* node =
-        AiaCalloc( 1, sizeof( AiaRegulatorBufferNode_t ) );
-    if( !node )
+    AiaChunks( Link_t ) defaultLink = AiaChunks( LINK_INITIALIZER );
+    chunk->link = defaultLink;
+    bool isNormal = AIA_REGULATOR_PRIORITY_NORMAL == priority;
+    if( isNormal &&
+        regulatorBuffer->normalChunks < regulatorBuffer->numChunks )
     {
-        AiaLogError( "AiaCalloc failed." );
+        /* Jump ahead of the queued lower priority chunks, then rebuild the
+         * front message since this chunk may land inside it. */
+        if( regulatorBuffer->lastNormalLink )
+        {
+            AiaChunks( InsertAfter )( regulatorBuffer->lastNormalLink,
+                                      &chunk->link );
+        }
+        else
+        {
+            AiaChunks( InsertHead )( &regulatorBuffer->buffer, &chunk->link );
+        }
+        ++regulatorBuffer->numChunks;
+        ++regulatorBuffer->normalChunks;
+        regulatorBuffer->lastNormalLink = &chunk->link;
+        regulatorBuffer->frontChunks = 0;
+        regulatorBuffer->frontSize = 0;
+        AiaRegulatorBuffer_FillFront( regulatorBuffer );
+        return true;
+    }
+    if( isNormal )
+    {
+        ++regulatorBuffer->normalChunks;
+        regulatorBuffer->lastNormalLink = &chunk->link;
+    }
+
+    /* Add it to the list, extending the front message if it is still open. */
+    AiaChunks( InsertTail )( &regulatorBuffer->buffer, &chunk->link );
+    if( regulatorBuffer->frontChunks == regulatorBuffer->numChunks++ &&
+        regulatorBuffer->frontSize + chunkSize <=
+            regulatorBuffer->maxMessageSize )
+    {
+        regulatorBuffer->frontSize += chunkSize;
+        ++regulatorBuffer->frontChunks;
+    }
+
+    return true;
+}
+
+void AiaRegulatorBuffer_SetSupersede(
+    AiaRegulatorBuffer_t* regulatorBuffer,
+    AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData )
+{
+    if( !regulatorBuffer )
+    {
+        AiaLogError( "Null regulatorBuffer." );
+        return;
+    }
+    regulatorBuffer->destroySupersededChunk = destroyChunk;
+    regulatorBuffer->destroySupersededChunkUserData = destroyChunkUserData;
+}
+
+bool AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+    AiaRegulatorBuffer_t* regulatorBuffer, AiaMessageSupersedeKey_t key,
+    bool isEnabled )
+{
+    if( !regulatorBuffer )
+    {
+        AiaLogError( "Null regulatorBuffer." );
         return false;
     }
-    AiaChunks( Link_t ) defaultLink = AiaChunks( LINK_INITIALIZER );
-    node->link = defaultLink;
-    node->chunk = chunk;
+    if( !key || key > AIA_MESSAGE_MAX_SUPERSEDE_KEY )
+    {
+        AiaLogError( "Invalid key, key=%u.", (unsigned)key );
+        return false;
+    }
+    if( isEnabled )
+    {
+        regulatorBuffer->disabledSupersedeKeys &= ~( (uint32_t)1 << key );
+    }
+    else
+    {
+        regulatorBuffer->disabledSupersedeKeys |= (uint32_t)1 << key;
+    }
+    return true;
+}
 
-    /* Add it to the list. */
-    AiaChunks( InsertTail )( &regulatorBuffer->buffer, &node->link );
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+void AiaRegulatorBuffer_SetExpiry(
+    AiaRegulatorBuffer_t* regulatorBuffer,
+    AiaRegulatorDestroyChunkCallback_t destroyChunk,
+    void* destroyChunkUserData )
+{
+    if( !regulatorBuffer )
+    {
+        AiaLogError( "Null regulatorBuffer." );
+        return;
+    }
+    regulatorBuffer->destroyExpiredChunk = destroyChunk;
+    regulatorBuffer->destroyExpiredChunkUserData = destroyChunkUserData;
+}
 
+bool AiaRegulatorBuffer_SetMaxAge( AiaRegulatorBuffer_t* regulatorBuffer,
+                                   AiaMessageSupersedeKey_t key,
+                                   AiaDurationMs_t maxAgeMs )
+{
+    if( !regulatorBuffer )
+    {
+        AiaLogError( "Null regulatorBuffer." );
+        return false;
+    }
+    if( !key || key > AIA_MESSAGE_MAX_SUPERSEDE_KEY )
+    {
+        AiaLogError( "Invalid key, key=%u.", (unsigned)key );
+        return false;
+    }
+    regulatorBuffer->maxAgeMs[ key ] = maxAgeMs;
+    if( maxAgeMs )
+    {
+        regulatorBuffer->expiringKeys |= (uint32_t)1 << key;
+    }
+    else
+    {
+        regulatorBuffer->expiringKeys &= ~( (uint32_t)1 << key );
+    }
     return true;
 }
+#endif
 
 bool AiaRegulatorBuffer_RemoveFront(
     AiaRegulatorBuffer_t* regulatorBuffer,
     AiaRegulatorEmitMessageChunkCallback_t emitMessageChunk,
     void* emitMessageChunkUserData )
 {
-    /* TODO: Add support for automatically aggregating microphone messages so
-     * that we don't have to put a header on each microphone chunk (ADSER-1632).
-     */
     if( !regulatorBuffer )
     {
         AiaLogError( "Null regulatorBuffer." );
@@ -154,6 +480,9 @@ bool AiaRegulatorBuffer_RemoveFront(
         AiaLogError( "Null emitMessageChunk." );
         return false;
     }
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    AiaRegulatorBuffer_RemoveExpired( regulatorBuffer );
+#endif
     if( AiaChunks( IsEmpty )( &regulatorBuffer->buffer ) )
     {
         /* Not considering it an error to attempt to read from an empty buffer;
@@ -161,29 +490,12 @@ bool AiaRegulatorBuffer_RemoveFront(
         return true;
     }
 
-    /* Measure how many chunks there are and how large the cumulative chunks
-     * will be. */
-    AiaChunks( Link_t )* link = NULL;
-    size_t cumulativeSize = 0;
-    size_t maxMessageSize = regulatorBuffer->maxMessageSize;
-    size_t numChunks = 0;
-    AiaChunks( ForEach )( &regulatorBuffer->buffer, link )
+    /* Emit the chunks in the front message. */
+    bool result = true;
+    while( regulatorBuffer->frontChunks > 0 )
     {
-        AiaRegulatorBufferNode_t* node = (AiaRegulatorBufferNode_t*)link;
-        AiaRegulatorChunk_t* chunk = node->chunk;
-        size_t chunkSize = AiaMessage_GetSize( chunk );
-        if( cumulativeSize + chunkSize > maxMessageSize )
-        {
-            break;
-        }
-        cumulativeSize += chunkSize;
-        ++numChunks;
-    }
-
-    /* Emit the chunks */
-    while( cumulativeSize > 0 )
-    {
-        link = AiaChunks( PeekHead )( &regulatorBuffer->buffer );
+        AiaChunks( Link_t )* link =
+            AiaChunks( RemoveHead )( &regulatorBuffer->buffer );
 
         /* Sanity check: buffer should be unchanged, so we should have a link.
          */
@@ -194,47 +506,51 @@ bool AiaRegulatorBuffer_RemoveFront(
             return false;
         }
 
-        AiaRegulatorBufferNode_t* node = (AiaRegulatorBufferNode_t*)link;
-        AiaRegulatorChunk_t* chunk = node->chunk;
+        AiaRegulatorChunk_t* chunk = (AiaRegulatorChunk_t*)link;
         size_t chunkSize = AiaMessage_GetSize( chunk );
 
         /* Sanity check: buffer should be unchanged, so sizes should add up the
          * same. */
-        AiaAssert( cumulativeSize >= chunkSize );
-        if( cumulativeSize < chunkSize )
+        AiaAssert( regulatorBuffer->frontSize >= chunkSize );
+        if( regulatorBuffer->frontSize < chunkSize )
         {
             AiaLogError( "Chunk size inconsistency detected." );
+            AiaChunks( InsertHead )( &regulatorBuffer->buffer, link );
             return false;
         }
 
-        /* Sanity check: should still have chunks remaining. */
-        AiaAssert( numChunks > 0 );
-        if( numChunks == 0 )
-        {
-            AiaLogError( "Chunk count inconsistency detected." );
-            return false;
-        }
-
-        /* Emit the chunk (which transfers ownership if successful). */
-        size_t remaining = cumulativeSize - chunkSize;
-        if( !emitMessageChunk( chunk, remaining, --numChunks,
+        /* Emit the chunk (which transfers ownership if successful).  The chunk
+         * is unlinked first since the callback may destroy it. */
+        size_t remaining = regulatorBuffer->frontSize - chunkSize;
+        size_t remainingChunks = regulatorBuffer->frontChunks - 1;
+        if( !emitMessageChunk( chunk, remaining, remainingChunks,
                                emitMessageChunkUserData ) )
         {
             AiaLogError(
                 "Failed to emit message chunk (size=%zu, remaining=%zu, "
                 "numChunks=%zu).",
-                chunkSize, remaining, numChunks + 1 );
-            return false;
+                chunkSize, remaining, remainingChunks + 1 );
+            AiaChunks( InsertHead )( &regulatorBuffer->buffer, link );
+            result = false;
+            break;
         }
 
-        /* Bookkeeping and cleanup now that we've successfully emitted. */
-        cumulativeSize = remaining;
+        /* Bookkeeping now that we've successfully emitted. */
+        regulatorBuffer->frontSize = remaining;
+        regulatorBuffer->frontChunks = remainingChunks;
         regulatorBuffer->bufferSize -= chunkSize;
-        AiaChunks( Remove )( link );
-        AiaFree( node );
+        --regulatorBuffer->numChunks;
+        if( regulatorBuffer->normalChunks > 0 &&
+            0 == --regulatorBuffer->normalChunks )
+        {
+            regulatorBuffer->lastNormalLink = NULL;
+        }
     }
 
-    return true;
+    /* Start building the next front message. */
+    AiaRegulatorBuffer_FillFront( regulatorBuffer );
+
+    return result;
 }
 
 bool AiaRegulatorBuffer_IsEmpty( const AiaRegulatorBuffer_t* regulatorBuffer )
@@ -251,8 +567,8 @@ void AiaRegulatorBuffer_Clear( AiaRegulatorBuffer_t* regulatorBuffer,
     {
         /* If we're not destroying the chunks, we simply clear the buffer list
          * and trust that the caller has some other way of managing the memory
-         * of the nodes. */
-        AiaChunks( RemoveAll )( &regulatorBuffer->buffer, AiaFree, 0 );
+         * of the chunks. */
+        AiaChunks( RemoveAll )( &regulatorBuffer->buffer, NULL, 0 );
     }
     else
     {
@@ -261,16 +577,18 @@ void AiaRegulatorBuffer_Clear( AiaRegulatorBuffer_t* regulatorBuffer,
         while( ( link = AiaChunks( RemoveHead )( &regulatorBuffer->buffer ) ) !=
                NULL )
         {
-            AiaRegulatorBufferNode_t* node = (AiaRegulatorBufferNode_t*)link;
-            AiaRegulatorChunk_t* chunk = node->chunk;
-            destroyChunk( chunk, destroyChunkUserData );
-            AiaFree( node );
+            destroyChunk( (AiaRegulatorChunk_t*)link, destroyChunkUserData );
         }
     }
 
     /* Should be empty now. */
     AiaAssert( AiaChunks( IsEmpty )( &regulatorBuffer->buffer ) );
     regulatorBuffer->bufferSize = 0;
+    regulatorBuffer->numChunks = 0;
+    regulatorBuffer->frontChunks = 0;
+    regulatorBuffer->frontSize = 0;
+    regulatorBuffer->normalChunks = 0;
+    regulatorBuffer->lastNormalLink = NULL;
 }
 
 size_t AiaRegulatorBuffer_GetMaxMessageSize(
@@ -286,6 +604,13 @@ size_t AiaRegulatorBuffer_GetSize( const AiaRegulatorBuffer_t* regulatorBuffer )
     return regulatorBuffer ? regulatorBuffer->bufferSize : 0;
 }
 
+size_t AiaRegulatorBuffer_GetNumChunks(
+    const AiaRegulatorBuffer_t* regulatorBuffer )
+{
+    AiaAssert( regulatorBuffer );
+    return regulatorBuffer ? regulatorBuffer->numChunks : 0;
+}
+
 bool AiaRegulatorBuffer_CanFillMessage(
     const AiaRegulatorBuffer_t* regulatorBuffer )
 {
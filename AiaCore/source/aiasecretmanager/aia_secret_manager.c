@@ -32,12 +32,14 @@
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_message_constants.h>
 #include <aiacore/aia_secret_derivation_algorithm.h>
+#include <aiacore/aia_startup_trace.h>
 #include <aiacore/aia_topic.h>
 
 #include <aiaregulator/aia_regulator.h>
 
 #include AiaListDouble( HEADER )
 #include AiaMutex( HEADER )
+#include AiaTimer( HEADER )
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -45,8 +47,9 @@
 /** Information about a secret. */
 typedef struct AiaSecretInfo
 {
-    /** The actual link in the list. */
-    AiaListDouble( Link_t ) link;
+    /** Identifies this secret for the lifetime of its @c AiaSecretManager_t.
+     * Unlike the address of this object, identifiers are never reused. */
+    const uint32_t id;
 
     /** The secret. */
     const uint8_t* secret;
@@ -55,6 +58,69 @@ typedef struct AiaSecretInfo
     const AiaSequenceNumber_t startingSequenceNumbers[ AIA_NUM_TOPICS ];
 } AiaSecretInfo_t;
 
+/** Encryption state for a single encrypted topic. */
+typedef struct AiaSecretManagerTopicContext
+{
+    /** Mutex used to serialize key changes and encryption/decryption for this
+     * topic. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Crypto context holding the expanded key for @c secretId. */
+    AiaCryptoContext_t* cryptoContext;
+
+    /** The identifier of the secret currently set on @c cryptoContext. */
+    uint32_t secretId;
+
+    /** Whether a key is currently set on @c cryptoContext. */
+    bool hasSecret;
+
+    /** Spare crypto context which replaces @c cryptoContext when @c
+     * pendingSecretId takes effect, so that switching to a rotated secret does
+     * not expand its key on the encryption/decryption path. */
+    AiaCryptoContext_t* pendingCryptoContext;
+
+    /** The identifier of the secret set on @c pendingCryptoContext. */
+    uint32_t pendingSecretId;
+
+    /** Whether a key is currently set on @c pendingCryptoContext. */
+    bool hasPendingSecret;
+
+    /** @} */
+} AiaSecretManagerTopicContext_t;
+
+/** A rotated secret waiting to be persisted by @c persistWorker. */
+typedef struct AiaSecretManagerPendingStore
+{
+    /** Link in @c pendingStores. */
+    AiaListDouble( Link_t ) link;
+
+    /** The identifier of the secret. */
+    uint32_t secretId;
+
+    /** The secret. */
+    uint8_t* secret;
+
+    /** The size of @c secret (in bytes). */
+    size_t secretSize;
+} AiaSecretManagerPendingStore_t;
+
+/** Secret lookup state for a single topic. */
+typedef struct AiaSecretManagerTopicCursor
+{
+    /** Index of the secret most recently used for this topic. */
+    size_t index;
+
+    /** One past the highest sequence number seen for this topic. Sequence
+     * numbers below this will not be encrypted/decrypted again. */
+    AiaSequenceNumber_t nextSequenceNumber;
+
+    /** Whether any sequence number has been seen for this topic. */
+    bool isActive;
+} AiaSecretManagerTopicCursor_t;
+
 /** Private data for the @c AiaSecretManager_t type. */
 struct AiaSecretManager
 {
@@ -77,19 +143,54 @@ struct AiaSecretManager
     /** @name Variables synchronized by mutex. */
     /** @{ */
 
-    /** Collection of all secrets associated with the current session. */
-    AiaListDouble_t secrets;
+    /** Secrets associated with the current session which may still be used,
+     * ordered by the sequence numbers at which they take effect. */
+    AiaSecretInfo_t** secrets;
+
+    /** Number of secrets in @c secrets. */
+    size_t numSecrets;
+
+    /** Number of secrets @c secrets has space for. */
+    size_t secretsCapacity;
+
+    /** Identifier to assign to the next secret added to @c secrets. */
+    uint32_t nextSecretId;
 
-    /** The current secret being used for encryption/decryption. */
-    AiaSecretInfo_t* currentSecret;
+    /** Per-topic secret lookup state. */
+    AiaSecretManagerTopicCursor_t topicCursors[ AIA_NUM_TOPICS ];
+
+    /** Rotated secrets waiting to be persisted, oldest first. */
+    AiaListDouble_t pendingStores;
 
     /** @} */
+
+    /** Writes rotated secrets to persistent storage behind the directive
+     * handler, so that slow storage does not hold up the directive sequencer.
+     */
+    AiaTimer_t persistWorker;
+
+    /** Serializes runs of @c persistWorker, as storage implementations are not
+     * required to be thread-safe. */
+    AiaMutex_t persistWorkerMutex;
+
+    /** Per-topic encryption state. Only populated for encrypted topics so that
+     * topics may be encrypted/decrypted in parallel without re-keying a shared
+     * context. */
+    AiaSecretManagerTopicContext_t topicContexts[ AIA_NUM_TOPICS ];
+
+    /** Counters reported by @c AiaSecretManager_GetMetrics(). These should only
+     * be accessed using atomic operations. */
+    AiaSecretManagerMetrics_t metrics;
 };
 
 /** Padding from the current next sequence number at which to apply the next
  * secret. This is chosen arbitrarily. */
 static const AiaSequenceNumber_t AIA_SECRET_ROTATION_PADDING = 5;
 
+/** Starting sequence number of an outbound topic for a secret which has not
+ * been persisted yet, and so is not used on that topic. */
+static const AiaSequenceNumber_t AIA_SECRET_UNSCHEDULED = UINT32_MAX;
+
 /**
  * Generates a @c SecretRotated event for publishing to the @c Regulator.
  *
@@ -101,17 +202,156 @@ static AiaJsonMessage_t* generateSecretRotatedEvent(
     const AiaSecretInfo_t* secretInfo );
 
 /**
- * Sets the key for encryption based on topic and sequence number information.
+ * Locks the encryption state for @c topic and ensures that its key is set based
+ * on the sequence number information.
  *
  * @param secretManager The secret manager instance to act on. If this is @c
  * NULL, behavior is undefined.
  * @param topic The topic to encrypt/decrypt.
  * @param sequenceNumber The sequence number for @c topic to encrypt/decrypt.
+ * @return The locked topic context to encrypt/decrypt with, or @c NULL on
+ * failures. Callers are responsible for unlocking the returned context's @c
+ * mutex.
+ */
+static AiaSecretManagerTopicContext_t* AiaSecretManager_AcquireTopicContext(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber );
+
+/**
+ * Initializes the encryption state for @c topic and sets its key to @c secret.
+ *
+ * @param topicContext The topic context to initialize. If this is @c NULL,
+ * behavior is undefined.
+ * @param secret The secret to set the key to. If this is @c NULL, behavior is
+ * undefined.
+ * @return @c true if the context was initialized successfully or @c false
+ * otherwise.
+ */
+static bool AiaSecretManager_InitializeTopicContext(
+    AiaSecretManagerTopicContext_t* topicContext,
+    const AiaSecretInfo_t* secret );
+
+/**
+ * Sets the key for @c topicContext to @c secret.
+ *
+ * @param topicContext The topic context to act on. If this is @c NULL,
+ * behavior is undefined.
+ * @param secret The secret to set the key to. If this is @c NULL, behavior is
+ * undefined.
  * @return @c true if the key could be set successfully or @c false otherwise.
+ * @note This must be called with the @c topicContext mutex held, as well as the
+ * @c AiaSecretManager_t mutex when @c secret may be discarded concurrently.
  */
-static bool AiaSecretManager_SetKey( AiaSecretManager_t* secretManager,
-                                     AiaTopic_t topic,
-                                     AiaSequenceNumber_t sequenceNumber );
+static bool AiaSecretManager_SetTopicKeyLocked(
+    AiaSecretManagerTopicContext_t* topicContext,
+    const AiaSecretInfo_t* secret );
+
+/**
+ * Sets a newly rotated secret on the spare crypto context of each encrypted
+ * topic, so that topics can later switch to it without expanding its key.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param secretId The identifier of the secret.
+ * @param secret The secret.
+ * @param secretSize The size of @c secret (in bytes).
+ * @note This must be called without any mutex held.
+ */
+static void AiaSecretManager_PrepareTopicKeys(
+    AiaSecretManager_t* secretManager, uint32_t secretId, const uint8_t* secret,
+    size_t secretSize );
+
+/**
+ * Ensures that @c secrets has space for at least one more secret.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @return @c true if space is available or @c false otherwise.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static bool AiaSecretManager_ReserveSecretLocked(
+    AiaSecretManager_t* secretManager );
+
+/**
+ * Appends @c secretInfo to @c secrets and discards any secrets which are made
+ * stale by it. Space must have been reserved using @c
+ * AiaSecretManager_ReserveSecretLocked().
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param secretInfo The secret to take ownership of. Its starting sequence
+ * numbers must not precede those of any secret already added.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static void AiaSecretManager_AddSecretLocked( AiaSecretManager_t* secretManager,
+                                              AiaSecretInfo_t* secretInfo );
+
+/**
+ * Finds the secret to use for @c sequenceNumber of @c topic. The topic's
+ * cursor is checked first, followed by its successor, before falling back to a
+ * binary search.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param topic The topic to encrypt/decrypt.
+ * @param sequenceNumber The sequence number for @c topic to encrypt/decrypt.
+ * @return The index of the secret to use within @c secrets.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static size_t AiaSecretManager_FindSecretLocked(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber );
+
+/**
+ * Moves the cursor of @c topic to the secret at @c index and discards any
+ * secrets that are no longer needed as a result.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param topic The topic that was encrypted/decrypted.
+ * @param sequenceNumber The sequence number for @c topic that was
+ * encrypted/decrypted.
+ * @param index The index of the secret used for @c sequenceNumber.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static void AiaSecretManager_UpdateCursorLocked(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber, size_t index );
+
+/**
+ * Removes the secret at @c index from @c secrets, keeping topic cursors within
+ * bounds.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param index The index of the secret to remove.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static void AiaSecretManager_RemoveSecretLocked(
+    AiaSecretManager_t* secretManager, size_t index );
+
+/**
+ * Routine of @c persistWorker. Persists each pending rotated secret, then
+ * schedules it on the outbound topics and publishes a @c SecretRotated event
+ * for it.
+ *
+ * @param context The @c AiaSecretManager_t to act on.
+ */
+static void AiaSecretManager_PersistRoutine( void* context );
+
+/**
+ * Discards all secrets that can no longer be used by any topic. A secret is
+ * stale once, for every encrypted topic, either the sequence numbers seen for
+ * that topic have reached the secret's successor or the secret and its
+ * successor take effect at the same sequence number. The newest secret is
+ * never discarded.
+ *
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static void AiaSecretManager_DiscardStaleSecretsLocked(
+    AiaSecretManager_t* secretManager );
 
 /**
  * Generates a block of memory that with sufficient space for both all the
@@ -121,9 +361,8 @@ static bool AiaSecretManager_SetKey( AiaSecretManager_t* secretManager,
  * AiaSecretInfo_t will point to.
  * @return The newly allocated @c AiaSecretInfo_t or @c NULL on failures.  Note
  * that the @c secret member of the newly generated @c AiaSecretInfo_t will
- * point to a block of memory of @c secretSize. Note that the @c link member of
- * this will contain a AiaListDouble( LINK_INITIALIZER ). Callers are
- * responsible for freeing this block using @c AiaFree.
+ * point to a block of memory of @c secretSize. Callers are responsible for
+ * freeing this block using @c AiaFree.
  */
 static AiaSecretInfo_t* AiaSecretManager_GenerateSecretInfo(
     size_t secretSize );
@@ -149,20 +388,16 @@ AiaSecretManager_t* AiaSecretManager_Create(
     size_t encryptionAlgorithmKeyBytes =
         AiaBytesToHoldBits( encryptionAlgorithmKeySize );
     uint8_t initialSharedSecret[ encryptionAlgorithmKeyBytes ];
-    if( !AiaLoadSecret( initialSharedSecret, encryptionAlgorithmKeyBytes ) )
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_LOAD_SECRET );
+    bool isSecretLoaded =
+        AiaLoadSecret( initialSharedSecret, encryptionAlgorithmKeyBytes );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_LOAD_SECRET );
+    if( !isSecretLoaded )
     {
         AiaLogError( "AiaLoadSecret failed" );
         return NULL;
     }
 
-    if( !AiaCrypto_SetKey( initialSharedSecret, encryptionAlgorithmKeyBytes,
-                           AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
-                               SECRET_DERIVATION_ALGORITHM ) ) )
-    {
-        AiaLogError( "Failed to set key." );
-        return NULL;
-    }
-
     AiaSecretManager_t* secretManager =
         (AiaSecretManager_t*)AiaCalloc( 1, sizeof( AiaSecretManager_t ) );
     if( !secretManager )
@@ -184,7 +419,31 @@ AiaSecretManager_t* AiaSecretManager_Create(
         return NULL;
     }
 
-    AiaListDouble( Create )( &secretManager->secrets );
+    if( !AiaMutex( Create )( &secretManager->persistWorkerMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaMutex( Destroy )( &secretManager->mutex );
+        AiaFree( secretManager );
+        return NULL;
+    }
+
+    AiaListDouble( Create )( &secretManager->pendingStores );
+    if( !AiaTimer( Create )( &secretManager->persistWorker,
+                             AiaSecretManager_PersistRoutine, secretManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed." );
+        AiaMutex( Destroy )( &secretManager->persistWorkerMutex );
+        AiaMutex( Destroy )( &secretManager->mutex );
+        AiaFree( secretManager );
+        return NULL;
+    }
+
+    if( !AiaSecretManager_ReserveSecretLocked( secretManager ) )
+    {
+        AiaLogError( "AiaSecretManager_ReserveSecretLocked failed" );
+        AiaSecretManager_Destroy( secretManager );
+        return NULL;
+    }
     AiaSecretInfo_t* secretInfo =
         AiaSecretManager_GenerateSecretInfo( encryptionAlgorithmKeyBytes );
     if( !secretInfo )
@@ -196,10 +455,20 @@ AiaSecretManager_t* AiaSecretManager_Create(
     memcpy( (uint8_t*)secretInfo->secret, initialSharedSecret,
             encryptionAlgorithmKeyBytes );
 
-    /* Assume RotateSecret will come with sequence numbers strictly greater than
-     * current sequence numbers. */
-    AiaListDouble( InsertTail )( &secretManager->secrets, &secretInfo->link );
-    secretManager->currentSecret = secretInfo;
+    AiaSecretManager_AddSecretLocked( secretManager, secretInfo );
+
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( AiaTopic_IsEncrypted( i ) &&
+            !AiaSecretManager_InitializeTopicContext(
+                &secretManager->topicContexts[ i ], secretInfo ) )
+        {
+            AiaLogError( "Failed to set key, topic=%s",
+                         AiaTopic_ToString( i ) );
+            AiaSecretManager_Destroy( secretManager );
+            return NULL;
+        }
+    }
 
     return secretManager;
 }
@@ -212,9 +481,43 @@ void AiaSecretManager_Destroy( AiaSecretManager_t* secretManager )
         return;
     }
 
+    AiaTimer( Destroy )( &secretManager->persistWorker );
+    AiaMutex( Destroy )( &secretManager->persistWorkerMutex );
+
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        AiaSecretManagerTopicContext_t* topicContext =
+            &secretManager->topicContexts[ i ];
+        if( topicContext->cryptoContext )
+        {
+            AiaCrypto_DestroyContext( topicContext->cryptoContext );
+            if( topicContext->pendingCryptoContext )
+            {
+                AiaCrypto_DestroyContext( topicContext->pendingCryptoContext );
+            }
+            AiaMutex( Destroy )( &topicContext->mutex );
+        }
+    }
+
     AiaMutex( Lock )( &secretManager->mutex );
 
-    AiaListDouble( RemoveAll )( &secretManager->secrets, AiaFree, 0 );
+    size_t dropped = AiaListDouble( Count )( &secretManager->pendingStores );
+    if( dropped )
+    {
+        AiaLogWarn( "Dropping %zu unpersisted secrets.", dropped );
+    }
+    AiaSecretManagerPendingStore_t* pendingStore = NULL;
+    while( ( pendingStore = (AiaSecretManagerPendingStore_t*)AiaListDouble(
+                 RemoveHead )( &secretManager->pendingStores ) ) )
+    {
+        AiaFree( pendingStore );
+    }
+
+    for( size_t i = 0; i < secretManager->numSecrets; ++i )
+    {
+        AiaFree( secretManager->secrets[ i ] );
+    }
+    AiaFree( secretManager->secrets );
 
     AiaMutex( Unlock )( &secretManager->mutex );
 
@@ -231,14 +534,51 @@ bool AiaSecretManager_Encrypt( AiaSecretManager_t* secretManager,
 {
     AiaAssert( secretManager );
 
-    if( !AiaSecretManager_SetKey( secretManager, topic, sequenceNumber ) )
+    AiaSecretManagerTopicContext_t* topicContext =
+        AiaSecretManager_AcquireTopicContext( secretManager, topic,
+                                              sequenceNumber );
+    if( !topicContext )
     {
-        AiaLogError( "AiaSecretManager_SetKey failed" );
+        AiaLogError( "AiaSecretManager_AcquireTopicContext failed" );
+        AiaAtomic_Add_u32( &secretManager->metrics.failures, 1 );
         return false;
     }
 
-    return AiaCrypto_Encrypt( inputData, inputLen, outputData, iv, ivLen, tag,
-                              tagLen );
+    bool success = AiaCrypto_EncryptWithContext( topicContext->cryptoContext,
+                                                 inputData, inputLen,
+                                                 outputData, iv, ivLen, tag,
+                                                 tagLen );
+    AiaMutex( Unlock )( &topicContext->mutex );
+    AiaAtomic_Add_u32( success ? &secretManager->metrics.encryptions
+                               : &secretManager->metrics.failures,
+                       1 );
+    return success;
+}
+
+bool AiaSecretManager_SubmitEncrypt( AiaSecretManager_t* secretManager,
+                                     AiaTopic_t topic,
+                                     AiaSequenceNumber_t sequenceNumber,
+                                     const AiaCryptoRequest_t* request )
+{
+    AiaAssert( secretManager );
+
+    AiaSecretManagerTopicContext_t* topicContext =
+        AiaSecretManager_AcquireTopicContext( secretManager, topic,
+                                              sequenceNumber );
+    if( !topicContext )
+    {
+        AiaLogError( "AiaSecretManager_AcquireTopicContext failed" );
+        AiaAtomic_Add_u32( &secretManager->metrics.failures, 1 );
+        return false;
+    }
+
+    bool submitted = AiaCrypto_SubmitEncryptWithContext(
+        topicContext->cryptoContext, request );
+    AiaMutex( Unlock )( &topicContext->mutex );
+    AiaAtomic_Add_u32( submitted ? &secretManager->metrics.encryptions
+                                 : &secretManager->metrics.failures,
+                       1 );
+    return submitted;
 }
 
 bool AiaSecretManager_Decrypt( AiaSecretManager_t* secretManager,
@@ -251,14 +591,105 @@ bool AiaSecretManager_Decrypt( AiaSecretManager_t* secretManager,
 {
     AiaAssert( secretManager );
 
-    if( !AiaSecretManager_SetKey( secretManager, topic, sequenceNumber ) )
+    AiaSecretManagerTopicContext_t* topicContext =
+        AiaSecretManager_AcquireTopicContext( secretManager, topic,
+                                              sequenceNumber );
+    if( !topicContext )
+    {
+        AiaLogError( "AiaSecretManager_AcquireTopicContext failed" );
+        AiaAtomic_Add_u32( &secretManager->metrics.failures, 1 );
+        return false;
+    }
+
+    bool success = AiaCrypto_DecryptWithContext( topicContext->cryptoContext,
+                                                 inputData, inputLen,
+                                                 outputData, iv, ivLen, tag,
+                                                 tagLen );
+    AiaMutex( Unlock )( &topicContext->mutex );
+    AiaAtomic_Add_u32( success ? &secretManager->metrics.decryptions
+                               : &secretManager->metrics.failures,
+                       1 );
+    return success;
+}
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+bool AiaSecretManager_DecryptAhead( AiaSecretManager_t* secretManager,
+                                    AiaTopic_t topic,
+                                    AiaSequenceNumber_t sequenceNumber,
+                                    const uint8_t* inputData, size_t inputLen,
+                                    uint8_t* outputData, const uint8_t* iv,
+                                    size_t ivLen, const uint8_t* tag,
+                                    size_t tagLen )
+{
+    AiaAssert( secretManager );
+    if( !AiaTopic_IsEncrypted( topic ) )
+    {
+        AiaLogError( "Topic not encrypted, topic=%s",
+                     AiaTopic_ToString( topic ) );
+        return false;
+    }
+
+    AiaSecretManagerTopicContext_t* topicContext =
+        &secretManager->topicContexts[ topic ];
+    AiaMutex( Lock )( &topicContext->mutex );
+
+    AiaMutex( Lock )( &secretManager->mutex );
+    size_t index =
+        AiaSecretManager_FindSecretLocked( secretManager, topic, sequenceNumber );
+    bool isCurrentSecret =
+        topicContext->hasSecret &&
+        secretManager->secrets[ index ]->id == topicContext->secretId;
+    AiaMutex( Unlock )( &secretManager->mutex );
+    if( !isCurrentSecret )
+    {
+        AiaMutex( Unlock )( &topicContext->mutex );
+        AiaLogDebug( "Not decrypting ahead of a secret change, topic=%s, "
+                     "sequenceNumber=%" PRIu32,
+                     AiaTopic_ToString( topic ), sequenceNumber );
+        return false;
+    }
+
+    bool success = AiaCrypto_DecryptWithContext( topicContext->cryptoContext,
+                                                 inputData, inputLen,
+                                                 outputData, iv, ivLen, tag,
+                                                 tagLen );
+    AiaMutex( Unlock )( &topicContext->mutex );
+    if( success )
+    {
+        AiaAtomic_Add_u32( &secretManager->metrics.decryptions, 1 );
+    }
+    return success;
+}
+#endif
+
+bool AiaSecretManager_DecryptSegments( AiaSecretManager_t* secretManager,
+                                       AiaTopic_t topic,
+                                       AiaSequenceNumber_t sequenceNumber,
+                                       const AiaCryptoSegment_t* segments,
+                                       size_t numSegments, const uint8_t* iv,
+                                       size_t ivLen, const uint8_t* tag,
+                                       size_t tagLen )
+{
+    AiaAssert( secretManager );
+
+    AiaSecretManagerTopicContext_t* topicContext =
+        AiaSecretManager_AcquireTopicContext( secretManager, topic,
+                                              sequenceNumber );
+    if( !topicContext )
     {
-        AiaLogError( "AiaSecretManager_SetKey failed" );
+        AiaLogError( "AiaSecretManager_AcquireTopicContext failed" );
+        AiaAtomic_Add_u32( &secretManager->metrics.failures, 1 );
         return false;
     }
 
-    return AiaCrypto_Decrypt( inputData, inputLen, outputData, iv, ivLen, tag,
-                              tagLen );
+    bool success = AiaCrypto_DecryptSegmentsWithContext(
+        topicContext->cryptoContext, segments, numSegments, iv, ivLen, tag,
+        tagLen );
+    AiaMutex( Unlock )( &topicContext->mutex );
+    AiaAtomic_Add_u32( success ? &secretManager->metrics.decryptions
+                               : &secretManager->metrics.failures,
+                       1 );
+    return success;
 }
 
 void AiaSecretManager_OnRotateSecretDirectiveReceived(
@@ -442,38 +873,23 @@ void AiaSecretManager_OnRotateSecretDirectiveReceived(
          ->startingSequenceNumbers[ AIA_TOPIC_DIRECTIVE ] =
         directiveSequenceNumber;
 
+    /* Outbound topics only move on to the secret once it has been persisted
+     * and announced. */
     for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
     {
         if( AiaTopic_IsEncrypted( i ) && AiaTopic_IsOutbound( i ) )
         {
-            AiaSequenceNumber_t nextSequenceNumber;
-            if( !secretManager->getNextSequenceNumber(
-                    i, &nextSequenceNumber,
-                    secretManager->getNextSequenceNumberUserData ) )
-            {
-                AiaLogError( "getNextSequenceNumber failed" );
-                AiaFree( secretInfo );
-                AiaJsonMessage_t* internalExceptionEvent =
-                    generateInternalErrorExceptionEncounteredEvent();
-                if( !secretManager->emitEvent(
-                        AiaJsonMessage_ToMessage( internalExceptionEvent ),
-                        secretManager->emitEventUserData ) )
-                {
-                    AiaLogError( "secretManager->emitEvent failed" );
-                    AiaJsonMessage_Destroy( internalExceptionEvent );
-                }
-                return;
-            }
             *(AiaSequenceNumber_t*)&secretInfo->startingSequenceNumbers[ i ] =
-                nextSequenceNumber + AIA_SECRET_ROTATION_PADDING;
+                AIA_SECRET_UNSCHEDULED;
         }
     }
 
-    AiaMutex( Lock )( &secretManager->mutex );
-
-    if( !AiaStoreSecret( (uint8_t*)secretInfo->secret, decodeSize ) )
+    AiaSecretManagerPendingStore_t* pendingStore =
+        AiaCalloc( 1, sizeof( AiaSecretManagerPendingStore_t ) + decodeSize );
+    if( !pendingStore )
     {
-        AiaLogError( "AiaStoreSecret failed" );
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     sizeof( AiaSecretManagerPendingStore_t ) + decodeSize );
         AiaFree( secretInfo );
         AiaJsonMessage_t* internalExceptionEvent =
             generateInternalErrorExceptionEncounteredEvent();
@@ -484,19 +900,19 @@ void AiaSecretManager_OnRotateSecretDirectiveReceived(
             AiaLogError( "secretManager->emitEvent failed" );
             AiaJsonMessage_Destroy( internalExceptionEvent );
         }
-        AiaMutex( Unlock )( &secretManager->mutex );
         return;
     }
+    pendingStore->secret = (uint8_t*)( pendingStore + 1 );
+    pendingStore->secretSize = decodeSize;
+    memcpy( pendingStore->secret, secretInfo->secret, decodeSize );
 
-    AiaJsonMessage_t* secretRotatedEvent =
-        generateSecretRotatedEvent( secretInfo );
-    if( !secretManager->emitEvent(
-            AiaJsonMessage_ToMessage( secretRotatedEvent ),
-            secretManager->emitEventUserData ) )
+    AiaMutex( Lock )( &secretManager->mutex );
+
+    if( !AiaSecretManager_ReserveSecretLocked( secretManager ) )
     {
-        AiaLogError( "secretManager->emitEvent failed" );
+        AiaLogError( "AiaSecretManager_ReserveSecretLocked failed" );
+        AiaFree( pendingStore );
         AiaFree( secretInfo );
-        AiaJsonMessage_Destroy( secretRotatedEvent );
         AiaJsonMessage_t* internalExceptionEvent =
             generateInternalErrorExceptionEncounteredEvent();
         if( !secretManager->emitEvent(
@@ -506,26 +922,57 @@ void AiaSecretManager_OnRotateSecretDirectiveReceived(
             AiaLogError( "secretManager->emitEvent failed" );
             AiaJsonMessage_Destroy( internalExceptionEvent );
         }
-
-        /* TODO: ADSER-1799 There is a theoretical race here if the device
-         * crashes or reboots before the next line of code can execute. The
-         * "correct" way to solve would be to keep multiple secrets persisted
-         * and having some way of validating the correct one upon a restart. */
-
-        if( !AiaStoreSecret( ( secretManager->currentSecret->secret ),
-                             decodeSize ) )
-        {
-            AiaLogError( "Failed to revert secret" );
-        }
         AiaMutex( Unlock )( &secretManager->mutex );
         return;
     }
 
-    /* Assume RotateSecret will come with sequence numbers strictly greater than
+    /* The secret is usable on inbound topics right away, since the service
+     * starts using it at the sequence numbers in the directive. Assume
+     * RotateSecret will come with sequence numbers strictly greater than
      * current sequence numbers. */
-    AiaListDouble( InsertTail )( &secretManager->secrets, &secretInfo->link );
+    AiaSecretManager_AddSecretLocked( secretManager, secretInfo );
+    pendingStore->secretId = secretInfo->id;
+    AiaListDouble( InsertTail )( &secretManager->pendingStores,
+                                 &pendingStore->link );
+
+    /* The secret may be discarded once the mutex is released, so keep a copy
+     * to prepare the topic keys with. */
+    uint32_t secretId = secretInfo->id;
+    uint8_t secret[ decodeSize ];
+    memcpy( secret, secretInfo->secret, decodeSize );
 
     AiaMutex( Unlock )( &secretManager->mutex );
+
+    if( !AiaTimer( Arm )( &secretManager->persistWorker, 0, 0 ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed" );
+    }
+
+    AiaSecretManager_PrepareTopicKeys( secretManager, secretId, secret,
+                                       decodeSize );
+}
+
+void AiaSecretManager_GetMetrics( AiaSecretManager_t* secretManager,
+                                  AiaSecretManagerMetrics_t* metrics )
+{
+    AiaAssert( secretManager );
+    if( !secretManager )
+    {
+        AiaLogError( "Null secretManager" );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics" );
+        return;
+    }
+    metrics->encryptions =
+        AiaAtomic_Load_u32( &secretManager->metrics.encryptions );
+    metrics->decryptions =
+        AiaAtomic_Load_u32( &secretManager->metrics.decryptions );
+    metrics->failures = AiaAtomic_Load_u32( &secretManager->metrics.failures );
+    metrics->rekeys = AiaAtomic_Load_u32( &secretManager->metrics.rekeys );
 }
 
 static AiaJsonMessage_t* generateSecretRotatedEvent(
@@ -565,63 +1012,543 @@ static AiaJsonMessage_t* generateSecretRotatedEvent(
     return jsonMessage;
 }
 
-static bool AiaSecretManager_SetKey( AiaSecretManager_t* secretManager,
-                                     AiaTopic_t topic,
-                                     AiaSequenceNumber_t sequenceNumber )
+static AiaSecretManagerTopicContext_t* AiaSecretManager_AcquireTopicContext(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber )
 {
     if( !AiaTopic_IsEncrypted( topic ) )
     {
         AiaLogError( "Topic not encrypted, topic=%s",
                      AiaTopic_ToString( topic ) );
-        return false;
+        return NULL;
     }
 
+    AiaSecretManagerTopicContext_t* topicContext =
+        &secretManager->topicContexts[ topic ];
+    AiaMutex( Lock )( &topicContext->mutex );
+
     AiaMutex( Lock )( &secretManager->mutex );
 
-    /* A linear scan of all secrets. This is inefficient and can be improved by
-     * going backwards/forwards from the current secret instead. */
-    AiaSecretInfo_t* secretToUse =
-        (AiaSecretInfo_t*)AiaListDouble( PeekHead )( &secretManager->secrets );
-    AiaListDouble( Link_t )* link = NULL;
-    AiaListDouble( ForEach )( &secretManager->secrets, link )
+    size_t index =
+        AiaSecretManager_FindSecretLocked( secretManager, topic, sequenceNumber );
+    const AiaSecretInfo_t* secretToUse = secretManager->secrets[ index ];
+
+    /* The key must be set before updating the cursor, which may discard
+     * secretToUse if this is the last sequence number it applies to. */
+    if( !topicContext->hasSecret || secretToUse->id != topicContext->secretId )
     {
-        AiaSecretInfo_t* nextSecret = (AiaSecretInfo_t*)link;
-        /* Iterate until we find the final secret with a starting sequence
-         * number greater than the current sequence number. */
-        if( sequenceNumber >= nextSecret->startingSequenceNumbers[ topic ] )
+        if( topicContext->hasPendingSecret &&
+            secretToUse->id == topicContext->pendingSecretId )
         {
-            secretToUse = nextSecret;
+            AiaLogDebug( "Switching to prepared secret, topic=%s",
+                         AiaTopic_ToString( topic ) );
+            AiaCryptoContext_t* previousContext = topicContext->cryptoContext;
+            topicContext->cryptoContext = topicContext->pendingCryptoContext;
+            topicContext->pendingCryptoContext = previousContext;
+            topicContext->secretId = topicContext->pendingSecretId;
+            topicContext->hasSecret = true;
+            topicContext->hasPendingSecret = false;
         }
-        else
+        else if( !AiaSecretManager_SetTopicKeyLocked( topicContext,
+                                                      secretToUse ) )
         {
-            break;
+            AiaLogError( "AiaSecretManager_SetTopicKeyLocked failed" );
+            AiaMutex( Unlock )( &secretManager->mutex );
+            AiaMutex( Unlock )( &topicContext->mutex );
+            return NULL;
         }
+        AiaAtomic_Add_u32( &secretManager->metrics.rekeys, 1 );
     }
 
-    /* TODO: ADSER-1792 Discard secrets are they become stale or no longer used.
-     */
-    if( secretToUse != secretManager->currentSecret )
-    {
-        AiaLogDebug( "Changing secret encryption key" );
-        if( !AiaCrypto_SetKey(
-                secretToUse->secret,
-                AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
-                    AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
-                        SECRET_DERIVATION_ALGORITHM ) ) ),
+    AiaSecretManager_UpdateCursorLocked( secretManager, topic, sequenceNumber,
+                                         index );
+
+    AiaMutex( Unlock )( &secretManager->mutex );
+
+    return topicContext;
+}
+
+static bool AiaSecretManager_InitializeTopicContext(
+    AiaSecretManagerTopicContext_t* topicContext,
+    const AiaSecretInfo_t* secret )
+{
+    if( !AiaMutex( Create )( &topicContext->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        return false;
+    }
+
+    AiaCryptoContext_t* cryptoContext = AiaCrypto_CreateContext();
+    if( !cryptoContext )
+    {
+        AiaLogError( "AiaCrypto_CreateContext failed." );
+        AiaMutex( Destroy )( &topicContext->mutex );
+        return false;
+    }
+    topicContext->cryptoContext = cryptoContext;
+
+    if( !AiaSecretManager_SetTopicKeyLocked( topicContext, secret ) )
+    {
+        AiaLogError( "AiaSecretManager_SetTopicKeyLocked failed." );
+        AiaCrypto_DestroyContext( topicContext->cryptoContext );
+        topicContext->cryptoContext = NULL;
+        AiaMutex( Destroy )( &topicContext->mutex );
+        return false;
+    }
+
+    return true;
+}
+
+static bool AiaSecretManager_SetTopicKeyLocked(
+    AiaSecretManagerTopicContext_t* topicContext,
+    const AiaSecretInfo_t* secret )
+{
+    if( !AiaCrypto_SetContextKey(
+            topicContext->cryptoContext, secret->secret,
+            AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
                 AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
-                    SECRET_DERIVATION_ALGORITHM ) ) )
+                    SECRET_DERIVATION_ALGORITHM ) ) ),
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) ) )
+    {
+        AiaLogError( "AiaCrypto_SetContextKey failed" );
+        topicContext->hasSecret = false;
+        return false;
+    }
+    topicContext->secretId = secret->id;
+    topicContext->hasSecret = true;
+    return true;
+}
+
+static bool AiaSecretManager_ReserveSecretLocked(
+    AiaSecretManager_t* secretManager )
+{
+    if( secretManager->numSecrets < secretManager->secretsCapacity )
+    {
+        return true;
+    }
+
+    size_t newCapacity =
+        secretManager->secretsCapacity ? secretManager->secretsCapacity * 2 : 2;
+    AiaSecretInfo_t** newSecrets =
+        AiaCalloc( newCapacity, sizeof( AiaSecretInfo_t* ) );
+    if( !newSecrets )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     newCapacity * sizeof( AiaSecretInfo_t* ) );
+        return false;
+    }
+    if( secretManager->numSecrets )
+    {
+        memcpy( newSecrets, secretManager->secrets,
+                secretManager->numSecrets * sizeof( AiaSecretInfo_t* ) );
+    }
+    AiaFree( secretManager->secrets );
+    secretManager->secrets = newSecrets;
+    secretManager->secretsCapacity = newCapacity;
+    return true;
+}
+
+static void AiaSecretManager_AddSecretLocked( AiaSecretManager_t* secretManager,
+                                              AiaSecretInfo_t* secretInfo )
+{
+    AiaAssert( secretManager->numSecrets < secretManager->secretsCapacity );
+    *(uint32_t*)&secretInfo->id = secretManager->nextSecretId++;
+    secretManager->secrets[ secretManager->numSecrets++ ] = secretInfo;
+    AiaSecretManager_DiscardStaleSecretsLocked( secretManager );
+}
+
+static size_t AiaSecretManager_FindSecretLocked(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber )
+{
+    AiaSecretInfo_t** secrets = secretManager->secrets;
+    size_t numSecrets = secretManager->numSecrets;
+
+    /* Sequence numbers usually stay on the current secret or move on to the
+     * next one, so try those before searching. */
+    size_t cursor = secretManager->topicCursors[ topic ].index;
+    for( size_t index = cursor; index < numSecrets && index <= cursor + 1;
+         ++index )
+    {
+        bool isAfterStart =
+            index == 0 ||
+            sequenceNumber >= secrets[ index ]->startingSequenceNumbers[ topic ];
+        bool isBeforeNext =
+            index + 1 == numSecrets ||
+            sequenceNumber <
+                secrets[ index + 1 ]->startingSequenceNumbers[ topic ];
+        if( isAfterStart && isBeforeNext )
         {
-            AiaLogError( "AiaCrypto_SetKey failed" );
-            AiaMutex( Unlock )( &secretManager->mutex );
-            return false;
+            return index;
+        }
+    }
+
+    /* Find the final secret with a starting sequence number not greater than
+     * the current sequence number, defaulting to the oldest secret. */
+    size_t low = 1;
+    size_t high = numSecrets;
+    while( low < high )
+    {
+        size_t middle = low + ( high - low ) / 2;
+        if( sequenceNumber >=
+            secrets[ middle ]->startingSequenceNumbers[ topic ] )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low - 1;
+}
+
+static void AiaSecretManager_UpdateCursorLocked(
+    AiaSecretManager_t* secretManager, AiaTopic_t topic,
+    AiaSequenceNumber_t sequenceNumber, size_t index )
+{
+    AiaSecretManagerTopicCursor_t* cursor =
+        &secretManager->topicCursors[ topic ];
+    bool isIndexChanged = !cursor->isActive || cursor->index != index;
+    cursor->index = index;
+    if( !cursor->isActive || sequenceNumber >= cursor->nextSequenceNumber )
+    {
+        cursor->nextSequenceNumber = sequenceNumber + 1;
+    }
+    cursor->isActive = true;
+
+    /* Secrets can only become stale when a topic moves on to a newer one. */
+    if( isIndexChanged )
+    {
+        AiaSecretManager_DiscardStaleSecretsLocked( secretManager );
+    }
+}
+
+/**
+ * @param topic The topic to check.
+ * @return @c true if @c topic is encrypted and may be used in this build, or
+ * @c false otherwise.
+ */
+static bool AiaSecretManager_IsTopicInUse( AiaTopic_t topic )
+{
+#ifndef AIA_ENABLE_MICROPHONE
+    if( topic == AIA_TOPIC_MICROPHONE )
+    {
+        return false;
+    }
+#endif
+#ifndef AIA_ENABLE_SPEAKER
+    if( topic == AIA_TOPIC_SPEAKER )
+    {
+        return false;
+    }
+#endif
+    return AiaTopic_IsEncrypted( topic );
+}
+
+static void AiaSecretManager_PrepareTopicKeys(
+    AiaSecretManager_t* secretManager, uint32_t secretId, const uint8_t* secret,
+    size_t secretSize )
+{
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( !AiaSecretManager_IsTopicInUse( i ) )
+        {
+            continue;
+        }
+        AiaSecretManagerTopicContext_t* topicContext =
+            &secretManager->topicContexts[ i ];
+
+        /* Take the spare context so that its key can be expanded without
+         * holding up encryption/decryption on this topic. */
+        AiaMutex( Lock )( &topicContext->mutex );
+        AiaCryptoContext_t* pendingContext =
+            topicContext->pendingCryptoContext;
+        topicContext->pendingCryptoContext = NULL;
+        topicContext->hasPendingSecret = false;
+        AiaMutex( Unlock )( &topicContext->mutex );
+
+        if( !pendingContext )
+        {
+            pendingContext = AiaCrypto_CreateContext();
+            if( !pendingContext )
+            {
+                AiaLogError( "AiaCrypto_CreateContext failed, topic=%s",
+                             AiaTopic_ToString( i ) );
+                continue;
+            }
+        }
+
+        bool isKeySet = AiaCrypto_SetContextKey(
+            pendingContext, secret, secretSize,
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) );
+        if( !isKeySet )
+        {
+            /* Topics fall back to setting the key when they switch. */
+            AiaLogError( "AiaCrypto_SetContextKey failed, topic=%s",
+                         AiaTopic_ToString( i ) );
+        }
+
+        AiaMutex( Lock )( &topicContext->mutex );
+        if( topicContext->pendingCryptoContext )
+        {
+            /* Another rotation prepared a newer secret in the meantime. */
+            AiaMutex( Unlock )( &topicContext->mutex );
+            AiaCrypto_DestroyContext( pendingContext );
+            continue;
+        }
+        topicContext->pendingCryptoContext = pendingContext;
+        topicContext->pendingSecretId = secretId;
+        topicContext->hasPendingSecret = isKeySet;
+        AiaMutex( Unlock )( &topicContext->mutex );
+    }
+}
+
+/**
+ * @param secretManager The secret manager instance to act on. If this is @c
+ * NULL, behavior is undefined.
+ * @param index The index of the secret to check. This must not be the newest
+ * secret.
+ * @return @c true if the secret at @c index can no longer be used by any topic
+ * or @c false otherwise.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static bool AiaSecretManager_IsSecretStaleLocked(
+    AiaSecretManager_t* secretManager, size_t index )
+{
+    const AiaSecretInfo_t* secret = secretManager->secrets[ index ];
+    const AiaSecretInfo_t* nextSecret = secretManager->secrets[ index + 1 ];
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( !AiaSecretManager_IsTopicInUse( i ) )
+        {
+            continue;
+        }
+        const AiaSecretManagerTopicCursor_t* cursor =
+            &secretManager->topicCursors[ i ];
+        AiaSequenceNumber_t lowestUsableSequenceNumber =
+            cursor->isActive ? cursor->nextSequenceNumber : 0;
+        if( nextSecret->startingSequenceNumbers[ i ] <=
+            lowestUsableSequenceNumber )
+        {
+            continue;
         }
-        secretManager->currentSecret = secretToUse;
+        /* The oldest secret also covers all sequence numbers before its own
+         * starting sequence number. */
+        if( index > 0 && nextSecret->startingSequenceNumbers[ i ] <=
+                             secret->startingSequenceNumbers[ i ] )
+        {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Abandons a rotated secret which could not be persisted or announced. The
+ * previous secret stays in effect on every topic.
+ *
+ * @param secretManager The secret manager instance to act on.
+ * @param secretId The identifier of the secret to abandon.
+ * @note This must be called with the @c secretManager mutex held.
+ */
+static void AiaSecretManager_AbandonSecretLocked(
+    AiaSecretManager_t* secretManager, uint32_t secretId )
+{
+    /* The oldest secret is never a rotated one which is still pending. */
+    for( size_t index = 1; index < secretManager->numSecrets; ++index )
+    {
+        if( secretManager->secrets[ index ]->id == secretId )
+        {
+            AiaLogWarn( "Abandoning secret, id=%" PRIu32, secretId );
+            AiaFree( secretManager->secrets[ index ] );
+            AiaSecretManager_RemoveSecretLocked( secretManager, index );
+            return;
+        }
+    }
+}
+
+/**
+ * Persists a rotated secret, schedules it on the outbound topics and publishes
+ * a @c SecretRotated event for it.
+ *
+ * @param secretManager The secret manager instance to act on.
+ * @param pendingStore The secret to persist.
+ * @return @c true if the secret was persisted and announced or @c false
+ * otherwise.
+ */
+static bool AiaSecretManager_PersistSecret(
+    AiaSecretManager_t* secretManager,
+    const AiaSecretManagerPendingStore_t* pendingStore )
+{
+    AiaSequenceNumber_t startingSequenceNumbers[ AIA_NUM_TOPICS ] = { 0 };
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( AiaTopic_IsEncrypted( i ) && AiaTopic_IsOutbound( i ) )
+        {
+            AiaSequenceNumber_t nextSequenceNumber;
+            if( !secretManager->getNextSequenceNumber(
+                    i, &nextSequenceNumber,
+                    secretManager->getNextSequenceNumberUserData ) )
+            {
+                AiaLogError( "getNextSequenceNumber failed" );
+                return false;
+            }
+            startingSequenceNumbers[ i ] =
+                nextSequenceNumber + AIA_SECRET_ROTATION_PADDING;
+        }
+    }
+
+    if( !AiaStoreSecret( pendingStore->secret, pendingStore->secretSize ) )
+    {
+        AiaLogError( "AiaStoreSecret failed" );
+        return false;
+    }
+
+    AiaMutex( Lock )( &secretManager->mutex );
+
+    size_t index = 0;
+    while( index < secretManager->numSecrets &&
+           secretManager->secrets[ index ]->id != pendingStore->secretId )
+    {
+        ++index;
+    }
+    if( index == secretManager->numSecrets || index == 0 )
+    {
+        AiaLogError( "Rotated secret not found, id=%" PRIu32,
+                     pendingStore->secretId );
+        AiaMutex( Unlock )( &secretManager->mutex );
+        return false;
+    }
+    AiaSecretInfo_t* secretInfo = secretManager->secrets[ index ];
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( AiaTopic_IsEncrypted( i ) && AiaTopic_IsOutbound( i ) )
+        {
+            *(AiaSequenceNumber_t*)&secretInfo->startingSequenceNumbers[ i ] =
+                startingSequenceNumbers[ i ];
+        }
+    }
+
+    AiaJsonMessage_t* secretRotatedEvent =
+        generateSecretRotatedEvent( secretInfo );
+    if( !secretManager->emitEvent(
+            AiaJsonMessage_ToMessage( secretRotatedEvent ),
+            secretManager->emitEventUserData ) )
+    {
+        AiaLogError( "secretManager->emitEvent failed" );
+        AiaJsonMessage_Destroy( secretRotatedEvent );
+
+        /* TODO: ADSER-1799 There is a theoretical race here if the device
+         * crashes or reboots before the next line of code can execute. The
+         * "correct" way to solve would be to keep multiple secrets persisted
+         * and having some way of validating the correct one upon a restart. */
+
+        const AiaSecretInfo_t* previousSecret =
+            secretManager->secrets[ index - 1 ];
+        if( !AiaStoreSecret( previousSecret->secret,
+                             pendingStore->secretSize ) )
+        {
+            AiaLogError( "Failed to revert secret" );
+        }
+        AiaMutex( Unlock )( &secretManager->mutex );
+        return false;
     }
 
     AiaMutex( Unlock )( &secretManager->mutex );
     return true;
 }
 
+static void AiaSecretManager_PersistRoutine( void* context )
+{
+    AiaSecretManager_t* secretManager = (AiaSecretManager_t*)context;
+    AiaAssert( secretManager );
+    if( !secretManager )
+    {
+        AiaLogError( "Null secretManager" );
+        return;
+    }
+
+    AiaMutex( Lock )( &secretManager->persistWorkerMutex );
+    while( true )
+    {
+        AiaMutex( Lock )( &secretManager->mutex );
+        AiaSecretManagerPendingStore_t* pendingStore =
+            (AiaSecretManagerPendingStore_t*)AiaListDouble( RemoveHead )(
+                &secretManager->pendingStores );
+        AiaMutex( Unlock )( &secretManager->mutex );
+        if( !pendingStore )
+        {
+            break;
+        }
+
+        if( !AiaSecretManager_PersistSecret( secretManager, pendingStore ) )
+        {
+            AiaLogError( "AiaSecretManager_PersistSecret failed" );
+            AiaMutex( Lock )( &secretManager->mutex );
+            AiaSecretManager_AbandonSecretLocked( secretManager,
+                                                  pendingStore->secretId );
+            AiaMutex( Unlock )( &secretManager->mutex );
+            AiaJsonMessage_t* internalExceptionEvent =
+                generateInternalErrorExceptionEncounteredEvent();
+            if( !secretManager->emitEvent(
+                    AiaJsonMessage_ToMessage( internalExceptionEvent ),
+                    secretManager->emitEventUserData ) )
+            {
+                AiaLogError( "secretManager->emitEvent failed" );
+                AiaJsonMessage_Destroy( internalExceptionEvent );
+            }
+        }
+        AiaFree( pendingStore );
+    }
+    AiaMutex( Unlock )( &secretManager->persistWorkerMutex );
+}
+
+static void AiaSecretManager_RemoveSecretLocked(
+    AiaSecretManager_t* secretManager, size_t index )
+{
+    memmove( &secretManager->secrets[ index ],
+             &secretManager->secrets[ index + 1 ],
+             ( secretManager->numSecrets - index - 1 ) *
+                 sizeof( AiaSecretInfo_t* ) );
+    --secretManager->numSecrets;
+
+    /* Cursors past the removed secret follow their secrets down, and cursors on
+     * it move on to its successor, which now sits at the same index. */
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        AiaSecretManagerTopicCursor_t* cursor =
+            &secretManager->topicCursors[ i ];
+        if( cursor->index > index ||
+            cursor->index == secretManager->numSecrets )
+        {
+            --cursor->index;
+        }
+    }
+}
+
+static void AiaSecretManager_DiscardStaleSecretsLocked(
+    AiaSecretManager_t* secretManager )
+{
+    size_t index = 0;
+    while( index + 1 < secretManager->numSecrets )
+    {
+        if( !AiaSecretManager_IsSecretStaleLocked( secretManager, index ) )
+        {
+            ++index;
+            continue;
+        }
+
+        AiaLogDebug( "Discarding stale secret, id=%" PRIu32,
+                     secretManager->secrets[ index ]->id );
+        AiaFree( secretManager->secrets[ index ] );
+        AiaSecretManager_RemoveSecretLocked( secretManager, index );
+    }
+}
+
 static AiaSecretInfo_t* AiaSecretManager_GenerateSecretInfo( size_t secretSize )
 {
     AiaSecretInfo_t* secretInfo =
@@ -634,7 +1561,5 @@ static AiaSecretInfo_t* AiaSecretManager_GenerateSecretInfo( size_t secretSize )
     }
 
     secretInfo->secret = (uint8_t*)( secretInfo + 1 );
-    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-    secretInfo->link = defaultLink;
     return secretInfo;
 }
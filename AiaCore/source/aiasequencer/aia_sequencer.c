@@ -22,6 +22,7 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_utils.h>
 #include <aiasequencer/aia_sequencer.h>
 #include <aiasequencer/private/aia_sequencer.h>
 
@@ -30,11 +31,6 @@
 
 #include <inttypes.h>
 
-static AiaTaskPoolJobStorage_t aiaSequencerMissingSequenceNumberJobStorage =
-    AiaTaskPool( JOB_STORAGE_INITIALIZER );
-static AiaTaskPoolJob_t aiaSequencerMissingSequenceNumberJob =
-    AiaTaskPool( JOB_INITIALIZER );
-
 static void aiaSequencerMissingSequenceNumberTimeoutRoutine(
     AiaTaskPool_t taskPool, AiaTaskPoolJob_t job, void* context )
 {
@@ -49,10 +45,219 @@ static void aiaSequencerMissingSequenceNumberTimeoutRoutine(
     }
     if( AiaAtomicBool_Load( &sequencer->waitingForMessage ) )
     {
+        AiaAtomic_Add_u32( &sequencer->metrics.timeoutsExpired, 1 );
         sequencer->timeoutExpiredCb( sequencer->timeoutExpiredUserData );
     }
 }
 
+/**
+ * Stops the missing sequence timer, cancelling its job if it is still pending
+ * so that it can be scheduled again.
+ *
+ * @param sequencer The sequencer to stop the timer of.
+ */
+static void AiaSequencer_StopMissingSequenceNumberTimer(
+    AiaSequencer_t* sequencer )
+{
+    AiaAtomicBool_Clear( &sequencer->waitingForMessage );
+    if( sequencer->missingSequenceNumberJob )
+    {
+        /* This fails harmlessly if the job has already run. */
+        AiaTaskPoolError_t error = AiaTaskPool( TryCancel )(
+            sequencer->taskPool, sequencer->missingSequenceNumberJob, NULL );
+        if( !AiaTaskPoolSucceeded( error ) )
+        {
+            AiaLogDebug( "AiaTaskPool( TryCancel ) failed, error=%s",
+                         AiaTaskPool( strerror )( error ) );
+        }
+    }
+}
+
+/**
+ * (Re)starts the missing sequence timer so that it expires @c
+ * sequenceTimeoutMs from now, cancelling a pending expiry first.
+ *
+ * @param sequencer The sequencer to start the timer of.
+ * @return @c true if the timer was started or @c false otherwise.
+ */
+static bool AiaSequencer_StartMissingSequenceNumberTimer(
+    AiaSequencer_t* sequencer )
+{
+    AiaSequencer_StopMissingSequenceNumberTimer( sequencer );
+    AiaAtomicBool_Set( &sequencer->waitingForMessage );
+
+    AiaTaskPoolError_t error = AiaTaskPool( CreateJob )(
+        aiaSequencerMissingSequenceNumberTimeoutRoutine, sequencer,
+        &sequencer->missingSequenceNumberJobStorage,
+        &sequencer->missingSequenceNumberJob );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "Failed to start timer, error=%d", error );
+        AiaAtomicBool_Clear( &sequencer->waitingForMessage );
+        return false;
+    }
+
+    error = AiaTaskPool( ScheduleDeferred )(
+        sequencer->taskPool, sequencer->missingSequenceNumberJob,
+        sequencer->sequenceTimeoutMs );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "Failed to start timer, error=%d", error );
+        AiaAtomicBool_Clear( &sequencer->waitingForMessage );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Counts @c value in the histogram bucket it falls into.
+ *
+ * @param histogram A histogram of @c AIA_SEQUENCER_HISTOGRAM_BUCKETS buckets.
+ * @param value The value to count.
+ */
+static void AiaSequencer_RecordHistogram( uint32_t* histogram, uint32_t value )
+{
+    size_t bucket = 0;
+    while( value > 1 && bucket < AIA_SEQUENCER_HISTOGRAM_BUCKETS - 1 )
+    {
+        value >>= 1;
+        ++bucket;
+    }
+    AiaAtomic_Add_u32( &histogram[ bucket ], 1 );
+}
+
+/**
+ * Resizes the sequencing buffer.
+ *
+ * @param sequencer The sequencer to act on.
+ * @param slots The new number of slots.
+ * @return @c true if the buffer was resized or @c false otherwise.
+ */
+static bool AiaSequencer_SetSlots( AiaSequencer_t* sequencer, size_t slots )
+{
+    if( !AiaSequencerBuffer_Resize( sequencer->buffer, slots ) )
+    {
+        return false;
+    }
+    AiaAtomic_Store_u32( &sequencer->metrics.slots, (uint32_t)slots );
+    AiaLogInfo( "Sequencer slots changed, slots=%zu", slots );
+    return true;
+}
+
+/**
+ * Changes the sequence timeout. This takes effect the next time the missing
+ * sequence timer is started.
+ *
+ * @param sequencer The sequencer to act on.
+ * @param timeoutMs The new timeout.
+ */
+static void AiaSequencer_SetTimeout( AiaSequencer_t* sequencer,
+                                     AiaDurationMs_t timeoutMs )
+{
+    sequencer->sequenceTimeoutMs = timeoutMs;
+    AiaAtomic_Store_u32( &sequencer->metrics.sequenceTimeoutMs, timeoutMs );
+    AiaLogInfo( "Sequencer timeout changed, timeoutMs=%" PRIu32, timeoutMs );
+}
+
+/**
+ * Records the time taken to fill the gap being waited on, if any, and grows the
+ * timeout if the gap came close to timing out.
+ *
+ * @param sequencer The sequencer to act on.
+ */
+static void AiaSequencer_CloseGap( AiaSequencer_t* sequencer )
+{
+    if( !sequencer->isGapOpen )
+    {
+        return;
+    }
+    sequencer->isGapOpen = false;
+    AiaDurationMs_t fillMs =
+        (AiaDurationMs_t)( AiaClock( GetTimeMs )() - sequencer->gapStartMs );
+    AiaSequencer_RecordHistogram(
+        sequencer->metrics.gapFillTimes,
+        fillMs / AIA_SEQUENCER_GAP_FILL_TIME_UNIT_MS );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Record( &sequencer->metrics.gapFillWaitMs, fillMs );
+#endif
+    if( fillMs > sequencer->windowMaxGapFillMs )
+    {
+        sequencer->windowMaxGapFillMs = fillMs;
+    }
+
+    if( sequencer->isAutoTuning && sequencer->isTimeoutAutoTuned &&
+        fillMs > sequencer->sequenceTimeoutMs / 2 )
+    {
+        uint64_t timeoutMs =
+            AiaMin( (uint64_t)fillMs * 2, sequencer->autoTuning.maxTimeoutMs );
+        if( timeoutMs > sequencer->sequenceTimeoutMs )
+        {
+            AiaSequencer_SetTimeout( sequencer, (AiaDurationMs_t)timeoutMs );
+        }
+    }
+}
+
+/**
+ * Counts sequenced messages towards the current auto-tuning window and, at the
+ * end of the window, shrinks the buffer and timeout towards what the window
+ * needed.
+ *
+ * @param sequencer The sequencer to act on.
+ * @param numMessages The number of messages sequenced.
+ */
+static void AiaSequencer_OnMessagesSequenced( AiaSequencer_t* sequencer,
+                                              size_t numMessages )
+{
+    if( !sequencer->isAutoTuning )
+    {
+        return;
+    }
+    sequencer->windowMessages += numMessages;
+    if( sequencer->windowMessages < AIA_SEQUENCER_AUTO_TUNING_WINDOW )
+    {
+        return;
+    }
+
+    /* Shrink by at most half per window so that a single clean window does
+     * not undo what a lossy stretch needed. */
+    size_t slots = AiaSequencerBuffer_Capacity( sequencer->buffer );
+    size_t targetSlots = (size_t)sequencer->windowMaxReorderDistance * 2;
+    if( targetSlots < sequencer->autoTuning.minSlots )
+    {
+        targetSlots = sequencer->autoTuning.minSlots;
+    }
+    if( targetSlots < slots )
+    {
+        if( targetSlots < slots / 2 )
+        {
+            targetSlots = slots / 2;
+        }
+        AiaSequencer_SetSlots( sequencer, targetSlots );
+    }
+
+    if( sequencer->isTimeoutAutoTuned )
+    {
+        uint64_t targetTimeoutMs = (uint64_t)sequencer->windowMaxGapFillMs * 2;
+        if( targetTimeoutMs < sequencer->autoTuning.minTimeoutMs )
+        {
+            targetTimeoutMs = sequencer->autoTuning.minTimeoutMs;
+        }
+        if( targetTimeoutMs < sequencer->sequenceTimeoutMs )
+        {
+            if( targetTimeoutMs < sequencer->sequenceTimeoutMs / 2 )
+            {
+                targetTimeoutMs = sequencer->sequenceTimeoutMs / 2;
+            }
+            AiaSequencer_SetTimeout( sequencer,
+                                     (AiaDurationMs_t)targetTimeoutMs );
+        }
+    }
+
+    sequencer->windowMessages = 0;
+    sequencer->windowMaxReorderDistance = 0;
+    sequencer->windowMaxGapFillMs = 0;
+}
+
 /**
  * Emits and removes as many messages as possible from the front of the buffer
  * using the @c messageSequencedCb() function.
@@ -67,88 +272,45 @@ static size_t AiaSequencer_EmitBuffer( AiaSequencer_t* sequencer )
         AiaLogError( "Null sequencer" );
         return 0;
     }
-    size_t numMessagesEmitted = 0;
-    while( AiaSequencerBuffer_Size( sequencer->buffer ) > 0 )
+    /* Note: ADSER-1585 Calls to @c AiaSequencer_ResetSequenceNumber() can
+     * occur on the same thread of execution as calls to @c
+     * messageSequencedCb(). The drain increments the next expected sequence
+     * number prior to each call so that any attempts to reset it don't get
+     * invalidated by an increment afterwards. Sequence numbers were recorded
+     * when messages were buffered, so the run is emitted without re-parsing
+     * them. */
+    size_t numMessagesEmitted = AiaSequencerBuffer_Drain(
+        sequencer->buffer, &sequencer->nextExpectedSequenceNumber,
+        sequencer->messageSequencedCb,
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+        sequencer->preparedSequencedCb,
+#endif
+        sequencer->messageSequencedUserData );
+    if( AiaSequencerBuffer_Size( sequencer->buffer ) > 0 &&
+        !AiaSequencerBuffer_IsOccupied( sequencer->buffer, 0 ) )
     {
-        if( AiaSequencerBuffer_IsOccupied( sequencer->buffer, 0 ) )
-        {
-            size_t messageSize = 0;
-            AiaSequenceNumber_t nextSequenceNumber;
-            void* buf_font =
-                AiaSequencerBuffer_Front( sequencer->buffer, &messageSize );
-
-            if( !sequencer->getSequenceNumberCb(
-                    &nextSequenceNumber, buf_font, messageSize,
-                    sequencer->getSequenceNumberUserData ) )
-            {
-                AiaLogWarn( "Failed to get the sequence number." );
-                continue;
-            }
-
-            if( nextSequenceNumber == sequencer->nextExpectedSequenceNumber )
-            {
-                /* Note: ADSER-1585 Calls to @c
-                 * AiaSequencer_ResetSequenceNumber() can occur on the same
-                 * thread of execution as calls to @c messageSequencedCb().
-                 * As such, it makes sense to increment prior to calling
-                 * messageSequencedCb() to ensure any attempts to reset
-                 * the the next expected sequence number don't get
-                 * invalidated by an increment afterwards. */
-                ++sequencer->nextExpectedSequenceNumber;
-                sequencer->messageSequencedCb(
-                    AiaSequencerBuffer_Front( sequencer->buffer, &messageSize ),
-                    messageSize, sequencer->messageSequencedUserData );
-                AiaSequencerBuffer_PopFront( sequencer->buffer );
-                ++numMessagesEmitted;
-            }
-            else
-            {
-                /* We reached a nonempty buffer slot that's not the sequence
-                number we are looking for next. */
-                break;
-            }
-        }
-        else
-        {
-            /* We reached an empty buffer slot, this is the sequence number we
-            want to get next. */
-            AiaSequencerBuffer_PopFront( sequencer->buffer );
-            break;
-        }
+        /* We reached an empty buffer slot, this is the sequence number we
+        want to get next. */
+        AiaSequencerBuffer_PopFront( sequencer->buffer );
     }
 
-    /* If anything was emitted, stop the missing sequence timer. */
-    if( numMessagesEmitted )
+    if( AiaSequencerBuffer_Size( sequencer->buffer ) > 0 )
     {
-        AiaAtomicBool_Clear( &sequencer->waitingForMessage );
+        sequencer->isGapOpen = true;
+        sequencer->gapStartMs = AiaClock( GetTimeMs )();
     }
 
-    /* If anything remains buffered and could not be emitted, start the missing
-    sequence timer. */
+    /* The message we were waiting on has arrived. If anything remains buffered
+    and could not be emitted, restart the missing sequence timer for the next
+    gap, otherwise stop it. */
     if( sequencer->sequenceTimeoutMs &&
         AiaSequencerBuffer_Size( sequencer->buffer ) > 0 )
     {
-        AiaAtomicBool_Set( &sequencer->waitingForMessage );
-        AiaTaskPoolError_t error = AiaTaskPool( CreateJob )(
-            aiaSequencerMissingSequenceNumberTimeoutRoutine, sequencer,
-            &aiaSequencerMissingSequenceNumberJobStorage,
-            &aiaSequencerMissingSequenceNumberJob );
-        if( !AiaTaskPoolSucceeded( error ) )
-        {
-            AiaLogError( "Failed to start timer, error=%d", error );
-            AiaAtomicBool_Clear( &sequencer->waitingForMessage );
-            return numMessagesEmitted;
-        }
-
-        error = AiaTaskPool( ScheduleDeferred )(
-            sequencer->taskPool, aiaSequencerMissingSequenceNumberJob,
-            sequencer->sequenceTimeoutMs );
-        if( !AiaTaskPoolSucceeded( error ) )
-        {
-            AiaLogError( "Failed to start timer, error=%d", error );
-            AiaAtomicBool_Clear( &sequencer->waitingForMessage );
-            return numMessagesEmitted;
-        }
+        AiaSequencer_StartMissingSequenceNumberTimer( sequencer );
+    }
+    else
+    {
+        AiaSequencer_StopMissingSequenceNumberTimer( sequencer );
     }
 
     return numMessagesEmitted;
@@ -188,7 +350,8 @@ AiaSequencer_t* AiaSequencer_Create(
         return NULL;
     }
 
-    sequencer->buffer = AiaSequencerBuffer_Create( maxSlots );
+    sequencer->buffer =
+        AiaSequencerBuffer_Create( maxSlots, AIA_SEQUENCER_SLOT_POOL_DATA_SIZE );
     if( !sequencer->buffer )
     {
         AiaLogError( "Failed to initialize sequencing buffer." );
@@ -205,25 +368,29 @@ AiaSequencer_t* AiaSequencer_Create(
     sequencer->getSequenceNumberUserData = getSequenceNumberUserData;
     sequencer->sequenceTimeoutMs = sequenceTimeoutMs;
     sequencer->taskPool = taskPool;
+    AiaAtomic_Store_u32( &sequencer->metrics.slots, (uint32_t)maxSlots );
+    AiaAtomic_Store_u32( &sequencer->metrics.sequenceTimeoutMs,
+                         sequenceTimeoutMs );
 
     AiaAtomicBool_Clear( &sequencer->waitingForMessage );
     return sequencer;
 }
 
-bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
+/**
+ * Sequences @c message, either emitting it immediately or buffering it.
+ *
+ * @param sequencer The @c AiaSequencer_t to act on.
+ * @param message The message to sequence.
+ * @param size The size of @c message.
+ * @param[out] adopted If not @c NULL, @c message will be buffered without
+ * copying it and this will be set to whether the buffer took ownership of it.
+ * Otherwise, @c message is copied when buffered.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaSequencer_WriteInternal( AiaSequencer_t* sequencer,
+                                        void* message, size_t size,
+                                        bool* adopted )
 {
-    AiaAssert( sequencer );
-    if( !sequencer )
-    {
-        AiaLogError( "Null sequencer" );
-        return false;
-    }
-    if( !message )
-    {
-        AiaLogError( "Null message" );
-        return false;
-    }
-
     AiaSequenceNumber_t incomingSequenceNumber;
     if( !sequencer->getSequenceNumberCb(
             &incomingSequenceNumber, message, size,
@@ -246,6 +413,7 @@ bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
          * the the next expected sequence number don't get
          * invalidated by an increment afterwards. */
         ++sequencer->nextExpectedSequenceNumber;
+        AiaSequencer_CloseGap( sequencer );
 
         /* Try to emit the message. */
         sequencer->messageSequencedCb( message, size,
@@ -254,6 +422,7 @@ bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
         next expected sequence numbers. */
         size_t numMessagesEmitted = AiaSequencer_EmitBuffer( sequencer );
         AiaLogDebug( "Emitted %zu additional messages", numMessagesEmitted );
+        AiaSequencer_OnMessagesSequenced( sequencer, numMessagesEmitted + 1 );
         return true;
     }
 
@@ -315,58 +484,148 @@ bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
     if( isOldMessage )
     {
         AiaLogDebug( "Old message" );
+        AiaAtomic_Add_u32( &sequencer->metrics.messagesDropped, 1 );
+        return true;
+    }
+
+    /* The occupancy of the buffer is a window of the sequence numbers already
+    held ahead of the next expected one, so redelivered copies are refused
+    here before anything is copied or allocated. */
+    if( messageDistance - 1 <
+            AiaSequencerBuffer_Capacity( sequencer->buffer ) &&
+        AiaSequencerBuffer_IsOccupied( sequencer->buffer,
+                                       messageDistance - 1 ) )
+    {
+        AiaLogDebug( "Duplicate message, sequenceNumber=%" PRIu32,
+                     incomingSequenceNumber );
+        AiaAtomic_Add_u32( &sequencer->metrics.duplicatesDropped, 1 );
         return true;
     }
 
     /* If we got here, we're now officially waiting on a missing sequence
     number. */
     if( sequencer->sequenceTimeoutMs &&
-        !AiaAtomicBool_Load( &sequencer->waitingForMessage ) )
+        !AiaAtomicBool_Load( &sequencer->waitingForMessage ) &&
+        !AiaSequencer_StartMissingSequenceNumberTimer( sequencer ) )
     {
-        AiaAtomicBool_Set( &sequencer->waitingForMessage );
-
-        AiaTaskPoolError_t error = AiaTaskPool( CreateJob )(
-            aiaSequencerMissingSequenceNumberTimeoutRoutine, sequencer,
-            &aiaSequencerMissingSequenceNumberJobStorage,
-            &aiaSequencerMissingSequenceNumberJob );
-        if( !AiaTaskPoolSucceeded( error ) )
-        {
-            AiaLogError( "Failed to start timer, error=%d", error );
-            AiaAtomicBool_Clear( &sequencer->waitingForMessage );
-            return false;
-        }
-
-        error = AiaTaskPool( ScheduleDeferred )(
-            sequencer->taskPool, aiaSequencerMissingSequenceNumberJob,
-            sequencer->sequenceTimeoutMs );
-        if( !AiaTaskPoolSucceeded( error ) )
-        {
-            AiaLogError( "Failed to start timer, error=%d", error );
-            AiaAtomicBool_Clear( &sequencer->waitingForMessage );
-            return false;
-        }
+        return false;
     }
 
     AiaLogInfo( "Message sequence number distance from expected=%" PRIu32,
                 messageDistance );
+    AiaSequencer_RecordHistogram( sequencer->metrics.reorderDistances,
+                                  messageDistance );
+    if( messageDistance > sequencer->windowMaxReorderDistance )
+    {
+        sequencer->windowMaxReorderDistance = messageDistance;
+    }
+    if( !sequencer->isGapOpen )
+    {
+        sequencer->isGapOpen = true;
+        sequencer->gapStartMs = AiaClock( GetTimeMs )();
+    }
 
     /* Future message, attempt to fit it in the buffer.
     Offset the buffer to start at 0. */
     size_t bufferIndex = messageDistance - 1;
 
-    if( !AiaSequencerBuffer_Add( sequencer->buffer, message, size,
-                                 bufferIndex ) )
+    /* Grow rather than drop a message which is within bounds. */
+    size_t slots = AiaSequencerBuffer_Capacity( sequencer->buffer );
+    if( sequencer->isAutoTuning && bufferIndex >= slots &&
+        messageDistance <= sequencer->autoTuning.maxSlots )
+    {
+        size_t targetSlots = slots * 2;
+        if( targetSlots < messageDistance )
+        {
+            targetSlots = messageDistance;
+        }
+        if( targetSlots > sequencer->autoTuning.maxSlots )
+        {
+            targetSlots = sequencer->autoTuning.maxSlots;
+        }
+        AiaSequencer_SetSlots( sequencer, targetSlots );
+    }
+
+    bool buffered = false;
+    if( adopted )
+    {
+        buffered = AiaSequencerBuffer_Adopt( sequencer->buffer, message, size,
+                                             incomingSequenceNumber,
+                                             bufferIndex );
+        *adopted = buffered;
+    }
+    else
+    {
+        buffered = AiaSequencerBuffer_Add( sequencer->buffer, message, size,
+                                           incomingSequenceNumber,
+                                           bufferIndex );
+    }
+    if( !buffered )
     {
         /* Quitely drop and hope it comes again. Otherwise, timeout will kick in
          * down the road. */
         /* TODO: ADSER-1843 Add different types of enums to more finely
          * granularly notify the caller of the specific error. */
         AiaLogError( "AiaSequencerBuffer_Add failed" );
+        AiaAtomic_Add_u32( &sequencer->metrics.messagesDropped, 1 );
         return false;
     }
+    AiaAtomic_Add_u32( &sequencer->metrics.messagesBuffered, 1 );
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    if( sequencer->prepareCb )
+    {
+        sequencer->prepareCb( message, size, incomingSequenceNumber,
+                              sequencer->prepareUserData );
+    }
+#endif
     return true;
 }
 
+bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+    if( !message )
+    {
+        AiaLogError( "Null message" );
+        return false;
+    }
+
+    return AiaSequencer_WriteInternal( sequencer, message, size, NULL );
+}
+
+bool AiaSequencer_WriteAndAdopt( AiaSequencer_t* sequencer, void* message,
+                                 size_t size )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        AiaFree( message );
+        return false;
+    }
+    if( !message )
+    {
+        AiaLogError( "Null message" );
+        return false;
+    }
+
+    /* Messages which are emitted immediately, dropped as old or fail to be
+     * buffered are not retained by the buffer, so they are freed here. */
+    bool adopted = false;
+    bool success =
+        AiaSequencer_WriteInternal( sequencer, message, size, &adopted );
+    if( !adopted )
+    {
+        AiaFree( message );
+    }
+    return success;
+}
+
 void AiaSequencer_ResetSequenceNumber(
     AiaSequencer_t* sequencer,
     AiaSequenceNumber_t newNextExpectedSequenceNumber )
@@ -386,6 +645,221 @@ void AiaSequencer_ResetSequenceNumber(
     sequencer->nextExpectedSequenceNumber = newNextExpectedSequenceNumber;
 }
 
+bool AiaSequencer_SkipMissing( AiaSequencer_t* sequencer )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+    if( !AiaSequencerBuffer_Size( sequencer->buffer ) )
+    {
+        AiaLogDebug( "No buffered messages to skip to" );
+        return false;
+    }
+
+    /* Slot zero holds the message following the next expected one, so skipping
+     * a sequence number lines the front of the buffer up with it. The gap was
+     * given up on rather than filled, so it is not recorded. */
+    sequencer->isGapOpen = false;
+    ++sequencer->nextExpectedSequenceNumber;
+    while( !AiaSequencerBuffer_IsOccupied( sequencer->buffer, 0 ) )
+    {
+        AiaSequencerBuffer_PopFront( sequencer->buffer );
+        ++sequencer->nextExpectedSequenceNumber;
+    }
+    AiaLogWarn( "Skipped missing messages, nextExpectedSequenceNumber=%" PRIu32,
+                sequencer->nextExpectedSequenceNumber );
+
+    size_t numMessagesEmitted = AiaSequencer_EmitBuffer( sequencer );
+    AiaLogDebug( "Emitted %zu messages", numMessagesEmitted );
+    AiaSequencer_OnMessagesSequenced( sequencer, numMessagesEmitted );
+    return true;
+}
+
+void AiaSequencer_GetMetrics( AiaSequencer_t* sequencer,
+                              AiaSequencerMetrics_t* metrics )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics" );
+        return;
+    }
+    metrics->messagesBuffered =
+        AiaAtomic_Load_u32( &sequencer->metrics.messagesBuffered );
+    metrics->messagesDropped =
+        AiaAtomic_Load_u32( &sequencer->metrics.messagesDropped );
+    metrics->timeoutsExpired =
+        AiaAtomic_Load_u32( &sequencer->metrics.timeoutsExpired );
+    metrics->duplicatesDropped =
+        AiaAtomic_Load_u32( &sequencer->metrics.duplicatesDropped );
+    for( size_t i = 0; i < AIA_SEQUENCER_HISTOGRAM_BUCKETS; ++i )
+    {
+        metrics->reorderDistances[ i ] =
+            AiaAtomic_Load_u32( &sequencer->metrics.reorderDistances[ i ] );
+        metrics->gapFillTimes[ i ] =
+            AiaAtomic_Load_u32( &sequencer->metrics.gapFillTimes[ i ] );
+    }
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Snapshot( &sequencer->metrics.gapFillWaitMs,
+                           &metrics->gapFillWaitMs );
+#endif
+    metrics->slots = AiaAtomic_Load_u32( &sequencer->metrics.slots );
+    metrics->sequenceTimeoutMs =
+        AiaAtomic_Load_u32( &sequencer->metrics.sequenceTimeoutMs );
+}
+
+bool AiaSequencer_SetAutoTuning( AiaSequencer_t* sequencer,
+                                 const AiaSequencerAutoTuningConfig_t* config )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+    if( !config )
+    {
+        sequencer->isAutoTuning = false;
+        return true;
+    }
+    if( !config->minSlots || config->minSlots > config->maxSlots ||
+        config->minTimeoutMs > config->maxTimeoutMs )
+    {
+        AiaLogError( "Invalid bounds, minSlots=%zu, maxSlots=%zu, "
+                     "minTimeoutMs=%" PRIu32 ", maxTimeoutMs=%" PRIu32,
+                     config->minSlots, config->maxSlots, config->minTimeoutMs,
+                     config->maxTimeoutMs );
+        return false;
+    }
+    bool isTimeoutAutoTuned = sequencer->sequenceTimeoutMs != 0;
+    if( isTimeoutAutoTuned && !config->minTimeoutMs )
+    {
+        AiaLogError( "Timeout may not be tuned to zero" );
+        return false;
+    }
+
+    size_t slots = AiaSequencerBuffer_Capacity( sequencer->buffer );
+    if( slots < config->minSlots &&
+        !AiaSequencer_SetSlots( sequencer, config->minSlots ) )
+    {
+        AiaLogError( "Failed to grow to minSlots=%zu", config->minSlots );
+        return false;
+    }
+    if( slots > config->maxSlots &&
+        !AiaSequencer_SetSlots( sequencer, config->maxSlots ) )
+    {
+        AiaLogError( "Failed to shrink to maxSlots=%zu", config->maxSlots );
+        return false;
+    }
+    if( isTimeoutAutoTuned )
+    {
+        if( sequencer->sequenceTimeoutMs < config->minTimeoutMs )
+        {
+            AiaSequencer_SetTimeout( sequencer, config->minTimeoutMs );
+        }
+        else if( sequencer->sequenceTimeoutMs > config->maxTimeoutMs )
+        {
+            AiaSequencer_SetTimeout( sequencer, config->maxTimeoutMs );
+        }
+    }
+
+    sequencer->autoTuning = *config;
+    sequencer->isAutoTuning = true;
+    sequencer->isTimeoutAutoTuned = isTimeoutAutoTuned;
+    sequencer->windowMessages = 0;
+    sequencer->windowMaxReorderDistance = 0;
+    sequencer->windowMaxGapFillMs = 0;
+    return true;
+}
+
+size_t AiaSequencer_TrimMemory( AiaSequencer_t* sequencer )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return 0;
+    }
+    return AiaSequencerBuffer_TrimMemory( sequencer->buffer );
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+bool AiaSequencer_SetMemoryBudget( AiaSequencer_t* sequencer,
+                                  AiaMemoryBudget_t* memoryBudget )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+    return AiaSequencerBuffer_SetMemoryBudget( sequencer->buffer,
+                                               memoryBudget );
+}
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+bool AiaSequencer_SetPreparation(
+    AiaSequencer_t* sequencer, AiaSequencerPrepareCallback_t prepareCb,
+    void* prepareUserData,
+    AiaSequencerMessageSequencedCallback_t preparedSequencedCb )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+    if( prepareCb && !preparedSequencedCb )
+    {
+        AiaLogError( "Null preparedSequencedCb" );
+        return false;
+    }
+    sequencer->prepareCb = prepareCb;
+    sequencer->prepareUserData = prepareUserData;
+    if( preparedSequencedCb )
+    {
+        sequencer->preparedSequencedCb = preparedSequencedCb;
+    }
+    return true;
+}
+
+bool AiaSequencer_Prepare( AiaSequencer_t* sequencer,
+                           AiaSequenceNumber_t sequenceNumber, void* prepared,
+                           size_t size )
+{
+    AiaAssert( sequencer );
+    if( !sequencer )
+    {
+        AiaLogError( "Null sequencer" );
+        return false;
+    }
+
+    /* While messages are buffered, slot zero holds the one following the next
+     * expected sequence number. Wrapping arithmetic turns old sequence numbers
+     * into indices beyond the buffer. */
+    uint32_t messageDistance =
+        sequenceNumber - sequencer->nextExpectedSequenceNumber;
+    if( !messageDistance )
+    {
+        AiaLogDebug( "Message no longer buffered, sequenceNumber=%" PRIu32,
+                     sequenceNumber );
+        return false;
+    }
+    return AiaSequencerBuffer_Prepare( sequencer->buffer, prepared, size,
+                                       sequenceNumber, messageDistance - 1 );
+}
+#endif
+
 void AiaSequencer_Destroy( AiaSequencer_t* sequencer )
 {
     if( !sequencer )
@@ -394,10 +868,10 @@ void AiaSequencer_Destroy( AiaSequencer_t* sequencer )
         return;
     }
 
-    if( aiaSequencerMissingSequenceNumberJob )
+    if( sequencer->missingSequenceNumberJob )
     {
         AiaTaskPoolError_t error = AiaTaskPool( TryCancel )(
-            sequencer->taskPool, aiaSequencerMissingSequenceNumberJob, NULL );
+            sequencer->taskPool, sequencer->missingSequenceNumberJob, NULL );
         if( !AiaTaskPoolSucceeded( error ) )
         {
             AiaLogWarn( "AiaTaskPool( TryCancel ) failed, error=%s",
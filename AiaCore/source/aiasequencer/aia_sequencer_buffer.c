@@ -22,9 +22,169 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_utils.h>
 #include <aiasequencer/private/aia_sequencer_buffer.h>
 
-AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots )
+/** Number of slots tracked by each word of the occupancy bitmap. */
+#define AIA_SEQUENCER_BUFFER_BITS_PER_WORD ( sizeof( uint32_t ) * 8 )
+
+/**
+ * Maps a logical, head-relative, index to a physical slot index.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param index The head-relative index of the slot.
+ * @return The physical index of the slot.
+ */
+static size_t AiaSequencerBuffer_PhysicalIndex(
+    const AiaSequencerBuffer_t* sequencerBuffer, size_t index )
+{
+    size_t physicalIndex = sequencerBuffer->head + index;
+    if( physicalIndex >= sequencerBuffer->capacity )
+    {
+        physicalIndex -= sequencerBuffer->capacity;
+    }
+    return physicalIndex;
+}
+
+static bool AiaSequencerBuffer_TestBit(
+    const AiaSequencerBuffer_t* sequencerBuffer, size_t physicalIndex )
+{
+    return sequencerBuffer
+               ->occupancy[ physicalIndex /
+                            AIA_SEQUENCER_BUFFER_BITS_PER_WORD ] &
+           ( (uint32_t)1 << ( physicalIndex %
+                              AIA_SEQUENCER_BUFFER_BITS_PER_WORD ) );
+}
+
+static void AiaSequencerBuffer_SetBit( AiaSequencerBuffer_t* sequencerBuffer,
+                                       size_t physicalIndex )
+{
+    sequencerBuffer
+        ->occupancy[ physicalIndex / AIA_SEQUENCER_BUFFER_BITS_PER_WORD ] |=
+        ( (uint32_t)1 << ( physicalIndex % AIA_SEQUENCER_BUFFER_BITS_PER_WORD ) );
+}
+
+static void AiaSequencerBuffer_ClearBit( AiaSequencerBuffer_t* sequencerBuffer,
+                                         size_t physicalIndex )
+{
+    sequencerBuffer
+        ->occupancy[ physicalIndex / AIA_SEQUENCER_BUFFER_BITS_PER_WORD ] &=
+        ~( (uint32_t)1
+           << ( physicalIndex % AIA_SEQUENCER_BUFFER_BITS_PER_WORD ) );
+}
+
+/**
+ * Checks whether @c data is stored in the pool.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param data The data held by a slot.
+ * @return @c true if @c data lies within @c pool or @c false otherwise.
+ */
+static bool AiaSequencerBuffer_IsPooled(
+    const AiaSequencerBuffer_t* sequencerBuffer, const void* data )
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    return sequencerBuffer->pool && bytes >= sequencerBuffer->pool &&
+           bytes < sequencerBuffer->pool + sequencerBuffer->capacity *
+                                               sequencerBuffer->slotDataSize;
+}
+
+/**
+ * Releases the data held by a slot, returning it to the pool if it is pooled.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param slot The slot to release the data of.
+ */
+static void AiaSequencerBuffer_ReleaseSlotData(
+    AiaSequencerBuffer_t* sequencerBuffer, AiaSequencerSlot_t* slot )
+{
+    if( !AiaSequencerBuffer_IsPooled( sequencerBuffer, slot->data ) )
+    {
+        AiaFree( slot->data );
+    }
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( sequencerBuffer->memoryBudget && slot->data )
+    {
+        AiaMemoryBudget_Release( sequencerBuffer->memoryBudget, slot->size );
+    }
+#endif
+    slot->data = NULL;
+    slot->size = 0;
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    slot->isPrepared = false;
+#endif
+}
+
+/**
+ * Stores @c data into the slot at @c index, releasing any data previously held
+ * there.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param data Data to store. Ownership is transferred to the buffer.
+ * @param size Size of data.
+ * @param sequenceNumber The sequence number of the data.
+ * @param physicalIndex The physical index of the slot.
+ * @param index The head-relative index of the slot, used for logging.
+ */
+static void AiaSequencerBuffer_Store( AiaSequencerBuffer_t* sequencerBuffer,
+                                      void* data, size_t size,
+                                      AiaSequenceNumber_t sequenceNumber,
+                                      size_t physicalIndex, size_t index )
+{
+    AiaSequencerSlot_t* slot = &sequencerBuffer->slots[ physicalIndex ];
+    bool duplicate = false;
+    if( AiaSequencerBuffer_TestBit( sequencerBuffer, physicalIndex ) )
+    {
+        AiaLogWarn( "SequencerBuffer slot already occupied, index=%zu", index );
+        duplicate = true;
+    }
+    if( slot->data != data )
+    {
+        AiaSequencerBuffer_ReleaseSlotData( sequencerBuffer, slot );
+    }
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    else if( sequencerBuffer->memoryBudget && slot->data )
+    {
+        /* The data was charged again by the caller. */
+        AiaMemoryBudget_Release( sequencerBuffer->memoryBudget, slot->size );
+    }
+#endif
+    slot->data = data;
+    slot->size = size;
+    slot->sequenceNumber = sequenceNumber;
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    slot->isPrepared = false;
+#endif
+    AiaSequencerBuffer_SetBit( sequencerBuffer, physicalIndex );
+    if( !duplicate )
+    {
+        ++sequencerBuffer->size;
+    }
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+/**
+ * Charges data about to be stored to the budget, if there is one.
+ *
+ * @param sequencerBuffer The @c AiaSequencerBuffer_t to act on.
+ * @param size Size of the data.
+ * @return @c true if the data may be stored or @c false otherwise.
+ */
+static bool AiaSequencerBuffer_Charge( AiaSequencerBuffer_t* sequencerBuffer,
+                                       size_t size )
+{
+    if( sequencerBuffer->memoryBudget &&
+        !AiaMemoryBudget_Charge( sequencerBuffer->memoryBudget, size ) )
+    {
+        AiaLogWarn( "Not buffering over budget, size=%zu.", size );
+        return false;
+    }
+    return true;
+}
+#endif
+
+AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots,
+                                                 size_t slotDataSize )
 {
     AiaSequencerBuffer_t* sequencerBuffer =
         (AiaSequencerBuffer_t*)AiaCalloc( 1, sizeof( AiaSequencerBuffer_t ) );
@@ -36,41 +196,43 @@ AiaSequencerBuffer_t* AiaSequencerBuffer_Create( size_t maxSlots )
     }
 
     *(size_t*)&sequencerBuffer->capacity = maxSlots;
-    AiaListDouble( Create )( &sequencerBuffer->buffer );
+    *(size_t*)&sequencerBuffer->slotDataSize = slotDataSize;
 
-    /* TODO: ADSER-1512 This is inefficient. We are allocating all nodes up
-     * front rather than dynamically expanding and contracting our sequencing
-     * buffer based on need. It would be more efficient to dynamically allocate
-     * sequencer buffers slots on demand.*/
-    for( size_t i = 0; i < maxSlots; ++i )
+    /* TODO: ADSER-1512 All slots are still allocated up front rather than
+     * dynamically expanding and contracting our sequencing buffer based on
+     * need. */
+    if( maxSlots )
     {
-        AiaSequencerSlot_t* slot = AiaCalloc( 1, sizeof( AiaSequencerSlot_t ) );
-        if( !slot )
+        sequencerBuffer->slots =
+            AiaCalloc( maxSlots, sizeof( AiaSequencerSlot_t ) );
+        if( !sequencerBuffer->slots )
         {
             AiaLogError( "AiaCalloc failed, bytes=%zu.",
-                         sizeof( AiaSequencerSlot_t ) );
-            AiaListDouble( Link_t )* link = NULL;
-            while( ( link = AiaListDouble( RemoveHead )(
-                         &sequencerBuffer->buffer ) ) )
-            {
-                AiaSequencerSlot_t* slot = (AiaSequencerSlot_t*)link;
-                AiaFree( slot );
-            }
+                         maxSlots * sizeof( AiaSequencerSlot_t ) );
+            AiaFree( sequencerBuffer );
+            return NULL;
+        }
+        size_t numOccupancyWords =
+            ( maxSlots + AIA_SEQUENCER_BUFFER_BITS_PER_WORD - 1 ) /
+            AIA_SEQUENCER_BUFFER_BITS_PER_WORD;
+        sequencerBuffer->occupancy =
+            AiaCalloc( numOccupancyWords, sizeof( uint32_t ) );
+        if( !sequencerBuffer->occupancy )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                         numOccupancyWords * sizeof( uint32_t ) );
+            AiaFree( sequencerBuffer->slots );
             AiaFree( sequencerBuffer );
             return NULL;
         }
-        AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-        slot->link = defaultLink;
-
-        /* Add it to the list. */
-        AiaListDouble( InsertTail )( &sequencerBuffer->buffer, &slot->link );
     }
 
     return sequencerBuffer;
 }
 
 bool AiaSequencerBuffer_Add( AiaSequencerBuffer_t* sequencerBuffer, void* data,
-                             size_t size, size_t index )
+                             size_t size, AiaSequenceNumber_t sequenceNumber,
+                             size_t index )
 {
     AiaAssert( sequencerBuffer );
     if( !sequencerBuffer )
@@ -87,44 +249,66 @@ bool AiaSequencerBuffer_Add( AiaSequencerBuffer_t* sequencerBuffer, void* data,
         return false;
     }
 
-    AiaListDouble( Link_t )* link = NULL;
-    size_t i = 0;
-    AiaListDouble( ForEach )( &sequencerBuffer->buffer, link )
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( !AiaSequencerBuffer_Charge( sequencerBuffer, size ) )
     {
-        if( i == index )
+        return false;
+    }
+#endif
+
+    size_t physicalIndex =
+        AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, index );
+    if( size <= sequencerBuffer->slotDataSize )
+    {
+        if( !sequencerBuffer->pool )
         {
-            AiaSequencerSlot_t* slot = (AiaSequencerSlot_t*)link;
-            bool duplicate = false;
-            if( slot->isOccupied )
-            {
-                AiaLogWarn( "SequencerBuffer slot already occupied, index=%zu",
-                            index );
-                duplicate = true;
-            }
-            AiaFree( slot->data );
-            slot->data = AiaCalloc( 1, size );
-            if( !slot->data )
+            size_t poolSize =
+                sequencerBuffer->capacity * sequencerBuffer->slotDataSize;
+            sequencerBuffer->pool = AiaCalloc( poolSize, sizeof( uint8_t ) );
+            if( !sequencerBuffer->pool )
             {
-                AiaLogError( "AiaCalloc failed, bytes=%zu.", size );
+                AiaLogError( "AiaCalloc failed, bytes=%zu.", poolSize );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+                if( sequencerBuffer->memoryBudget )
+                {
+                    AiaMemoryBudget_Release( sequencerBuffer->memoryBudget,
+                                             size );
+                }
+#endif
                 return false;
             }
-            memcpy( slot->data, data, size );
-            slot->size = size;
-            slot->isOccupied = true;
-            if( !duplicate )
-            {
-                ++sequencerBuffer->size;
-            }
-            return true;
         }
-        ++i;
+        uint8_t* slotData =
+            sequencerBuffer->pool +
+            physicalIndex * sequencerBuffer->slotDataSize;
+        memcpy( slotData, data, size );
+        AiaSequencerBuffer_Store( sequencerBuffer, slotData, size,
+                                  sequenceNumber, physicalIndex, index );
+        return true;
     }
 
-    return false;
+    void* slotData = AiaCalloc( 1, size );
+    if( !slotData )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", size );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        if( sequencerBuffer->memoryBudget )
+        {
+            AiaMemoryBudget_Release( sequencerBuffer->memoryBudget, size );
+        }
+#endif
+        return false;
+    }
+    memcpy( slotData, data, size );
+    AiaSequencerBuffer_Store( sequencerBuffer, slotData, size, sequenceNumber,
+                              physicalIndex, index );
+    return true;
 }
 
-bool AiaSequencerBuffer_IsOccupied( const AiaSequencerBuffer_t* sequencerBuffer,
-                                    size_t index )
+bool AiaSequencerBuffer_Adopt( AiaSequencerBuffer_t* sequencerBuffer,
+                               void* data, size_t size,
+                               AiaSequenceNumber_t sequenceNumber,
+                               size_t index )
 {
     AiaAssert( sequencerBuffer );
     if( !sequencerBuffer )
@@ -141,19 +325,40 @@ bool AiaSequencerBuffer_IsOccupied( const AiaSequencerBuffer_t* sequencerBuffer,
         return false;
     }
 
-    AiaListDouble( Link_t )* link = NULL;
-    size_t i = 0;
-    AiaListDouble( ForEach )( &sequencerBuffer->buffer, link )
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( !AiaSequencerBuffer_Charge( sequencerBuffer, size ) )
     {
-        if( i == index )
-        {
-            AiaSequencerSlot_t* slot = (AiaSequencerSlot_t*)link;
-            return slot->isOccupied;
-        }
-        ++i;
+        return false;
+    }
+#endif
+
+    AiaSequencerBuffer_Store(
+        sequencerBuffer, data, size, sequenceNumber,
+        AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, index ), index );
+    return true;
+}
+
+bool AiaSequencerBuffer_IsOccupied( const AiaSequencerBuffer_t* sequencerBuffer,
+                                    size_t index )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return false;
+    }
+
+    if( index >= sequencerBuffer->capacity )
+    {
+        AiaLogError(
+            "Provided index greater than capacity, index=%zu, capacity=%zu.",
+            index, sequencerBuffer->capacity );
+        return false;
     }
 
-    return false;
+    return AiaSequencerBuffer_TestBit(
+        sequencerBuffer,
+        AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, index ) );
 }
 
 void* AiaSequencerBuffer_Front( const AiaSequencerBuffer_t* sequencerBuffer,
@@ -171,16 +376,14 @@ void* AiaSequencerBuffer_Front( const AiaSequencerBuffer_t* sequencerBuffer,
         return NULL;
     }
 
-    AiaListDouble( Link_t )* link =
-        AiaListDouble( PeekHead )( &sequencerBuffer->buffer );
-    AiaAssert( link );
-    if( !link )
+    AiaAssert( sequencerBuffer->capacity );
+    if( !sequencerBuffer->capacity )
     {
         AiaLogError( "Buffer inconsistency detected." );
         return NULL;
     }
 
-    AiaSequencerSlot_t* slot = (AiaSequencerSlot_t*)link;
+    AiaSequencerSlot_t* slot = &sequencerBuffer->slots[ sequencerBuffer->head ];
     *size = slot->size;
     return slot->data;
 }
@@ -193,32 +396,67 @@ void AiaSequencerBuffer_PopFront( AiaSequencerBuffer_t* sequencerBuffer )
         AiaLogError( "Null sequencerBuffer." );
         return;
     }
+    if( !sequencerBuffer->capacity )
+    {
+        return;
+    }
 
-    if( AiaSequencerBuffer_IsOccupied( sequencerBuffer, 0 ) )
+    AiaSequencerSlot_t* slot = &sequencerBuffer->slots[ sequencerBuffer->head ];
+    if( AiaSequencerBuffer_TestBit( sequencerBuffer, sequencerBuffer->head ) )
     {
+        AiaSequencerBuffer_ClearBit( sequencerBuffer, sequencerBuffer->head );
         --sequencerBuffer->size;
     }
-    AiaListDouble( Link_t )* link =
-        AiaListDouble( RemoveHead )( &sequencerBuffer->buffer );
-    if( link )
+    AiaSequencerBuffer_ReleaseSlotData( sequencerBuffer, slot );
+    sequencerBuffer->head =
+        AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, 1 );
+}
+
+size_t AiaSequencerBuffer_Drain( AiaSequencerBuffer_t* sequencerBuffer,
+                                 AiaSequenceNumber_t* nextSequenceNumber,
+                                 AiaSequencerBufferDrainCallback_t callback,
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+                                 AiaSequencerBufferDrainCallback_t
+                                     preparedCallback,
+#endif
+                                 void* userData )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return 0;
+    }
+    if( !nextSequenceNumber || !callback )
+    {
+        AiaLogError( "Null nextSequenceNumber or callback." );
+        return 0;
+    }
+
+    size_t numDrained = 0;
+    while( sequencerBuffer->size &&
+           AiaSequencerBuffer_TestBit( sequencerBuffer,
+                                       sequencerBuffer->head ) )
     {
-        AiaSequencerSlot_t* removedSlot = (AiaSequencerSlot_t*)link;
-        AiaFree( removedSlot->data );
-        AiaSequencerSlot_t* slot = AiaCalloc( 1, sizeof( AiaSequencerSlot_t ) );
-        if( !slot )
+        AiaSequencerSlot_t* slot =
+            &sequencerBuffer->slots[ sequencerBuffer->head ];
+        if( slot->sequenceNumber != *nextSequenceNumber )
         {
-            /* TODO: Send an INTERNAL_ERROR ExceptionEncountered event and tear
-             * down Aia connection. */
-            AiaLogError( "AiaCalloc failed, bytes=%zu.",
-                         sizeof( AiaSequencerSlot_t ) );
-            return;
+            break;
         }
-        AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-        slot->link = defaultLink;
-
-        /* Add it to the list. */
-        AiaListDouble( InsertTail )( &sequencerBuffer->buffer, &slot->link );
+        ++*nextSequenceNumber;
+        AiaSequencerBufferDrainCallback_t slotCallback = callback;
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+        if( slot->isPrepared && preparedCallback )
+        {
+            slotCallback = preparedCallback;
+        }
+#endif
+        slotCallback( slot->data, slot->size, userData );
+        AiaSequencerBuffer_PopFront( sequencerBuffer );
+        ++numDrained;
     }
+    return numDrained;
 }
 
 size_t AiaSequencerBuffer_Size( const AiaSequencerBuffer_t* sequencerBuffer )
@@ -244,6 +482,178 @@ size_t AiaSequencerBuffer_Capacity(
     return sequencerBuffer->capacity;
 }
 
+bool AiaSequencerBuffer_Resize( AiaSequencerBuffer_t* sequencerBuffer,
+                                size_t newCapacity )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return false;
+    }
+    if( !newCapacity )
+    {
+        AiaLogError( "Invalid capacity, newCapacity=%zu.", newCapacity );
+        return false;
+    }
+    for( size_t i = newCapacity; i < sequencerBuffer->capacity; ++i )
+    {
+        if( AiaSequencerBuffer_IsOccupied( sequencerBuffer, i ) )
+        {
+            AiaLogDebug( "Slot in use beyond new capacity, index=%zu.", i );
+            return false;
+        }
+    }
+
+    AiaSequencerSlot_t* slots =
+        AiaCalloc( newCapacity, sizeof( AiaSequencerSlot_t ) );
+    size_t numOccupancyWords =
+        ( newCapacity + AIA_SEQUENCER_BUFFER_BITS_PER_WORD - 1 ) /
+        AIA_SEQUENCER_BUFFER_BITS_PER_WORD;
+    uint32_t* occupancy = AiaCalloc( numOccupancyWords, sizeof( uint32_t ) );
+    size_t poolSize = newCapacity * sequencerBuffer->slotDataSize;
+    uint8_t* pool = NULL;
+    if( sequencerBuffer->pool )
+    {
+        pool = AiaCalloc( poolSize, sizeof( uint8_t ) );
+    }
+    if( !slots || !occupancy || ( sequencerBuffer->pool && !pool ) )
+    {
+        AiaLogError( "AiaCalloc failed, newCapacity=%zu.", newCapacity );
+        AiaFree( pool );
+        AiaFree( occupancy );
+        AiaFree( slots );
+        return false;
+    }
+
+    /* Elements are moved to the same logical index, with the ring restarting
+     * at physical index zero. */
+    size_t numToMove = AiaMin( newCapacity, sequencerBuffer->capacity );
+    for( size_t i = 0; i < numToMove; ++i )
+    {
+        size_t physicalIndex =
+            AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, i );
+        if( !AiaSequencerBuffer_TestBit( sequencerBuffer, physicalIndex ) )
+        {
+            continue;
+        }
+        AiaSequencerSlot_t* slot = &sequencerBuffer->slots[ physicalIndex ];
+        if( AiaSequencerBuffer_IsPooled( sequencerBuffer, slot->data ) )
+        {
+            uint8_t* slotData = pool + i * sequencerBuffer->slotDataSize;
+            memcpy( slotData, slot->data, slot->size );
+            slots[ i ].data = slotData;
+        }
+        else
+        {
+            slots[ i ].data = slot->data;
+        }
+        slots[ i ].size = slot->size;
+        slots[ i ].sequenceNumber = slot->sequenceNumber;
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+        slots[ i ].isPrepared = slot->isPrepared;
+#endif
+        occupancy[ i / AIA_SEQUENCER_BUFFER_BITS_PER_WORD ] |=
+            ( (uint32_t)1 << ( i % AIA_SEQUENCER_BUFFER_BITS_PER_WORD ) );
+    }
+
+    AiaFree( sequencerBuffer->pool );
+    AiaFree( sequencerBuffer->occupancy );
+    AiaFree( sequencerBuffer->slots );
+    sequencerBuffer->slots = slots;
+    sequencerBuffer->occupancy = occupancy;
+    sequencerBuffer->pool = pool;
+    sequencerBuffer->head = 0;
+    *(size_t*)&sequencerBuffer->capacity = newCapacity;
+    return true;
+}
+
+size_t AiaSequencerBuffer_TrimMemory( AiaSequencerBuffer_t* sequencerBuffer )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return 0;
+    }
+    if( !sequencerBuffer->pool || sequencerBuffer->size )
+    {
+        return 0;
+    }
+    AiaFree( sequencerBuffer->pool );
+    sequencerBuffer->pool = NULL;
+    return sequencerBuffer->capacity * sequencerBuffer->slotDataSize;
+}
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+bool AiaSequencerBuffer_Prepare( AiaSequencerBuffer_t* sequencerBuffer,
+                                 void* data, size_t size,
+                                 AiaSequenceNumber_t sequenceNumber,
+                                 size_t index )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return false;
+    }
+    if( !data )
+    {
+        AiaLogError( "Null data." );
+        return false;
+    }
+    if( index >= sequencerBuffer->capacity )
+    {
+        AiaLogDebug( "Index no longer buffered, index=%zu, capacity=%zu.",
+                     index, sequencerBuffer->capacity );
+        return false;
+    }
+
+    size_t physicalIndex =
+        AiaSequencerBuffer_PhysicalIndex( sequencerBuffer, index );
+    AiaSequencerSlot_t* slot = &sequencerBuffer->slots[ physicalIndex ];
+    if( !AiaSequencerBuffer_TestBit( sequencerBuffer, physicalIndex ) ||
+        slot->sequenceNumber != sequenceNumber )
+    {
+        AiaLogDebug( "Element no longer buffered, index=%zu.", index );
+        return false;
+    }
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    if( !AiaSequencerBuffer_Charge( sequencerBuffer, size ) )
+    {
+        return false;
+    }
+#endif
+
+    AiaSequencerBuffer_ReleaseSlotData( sequencerBuffer, slot );
+    slot->data = data;
+    slot->size = size;
+    slot->isPrepared = true;
+    return true;
+}
+#endif
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+bool AiaSequencerBuffer_SetMemoryBudget( AiaSequencerBuffer_t* sequencerBuffer,
+                                         AiaMemoryBudget_t* memoryBudget )
+{
+    AiaAssert( sequencerBuffer );
+    if( !sequencerBuffer )
+    {
+        AiaLogError( "Null sequencerBuffer." );
+        return false;
+    }
+    if( sequencerBuffer->size )
+    {
+        AiaLogError( "Buffer in use, size=%zu.", sequencerBuffer->size );
+        return false;
+    }
+    sequencerBuffer->memoryBudget = memoryBudget;
+    return true;
+}
+#endif
+
 void AiaSequencerBuffer_Destroy( AiaSequencerBuffer_t* sequencerBuffer )
 {
     AiaAssert( sequencerBuffer );
@@ -253,13 +663,13 @@ void AiaSequencerBuffer_Destroy( AiaSequencerBuffer_t* sequencerBuffer )
         return;
     }
 
-    AiaListDouble( Link_t )* link = NULL;
-    while( ( link = AiaListDouble( RemoveHead )( &sequencerBuffer->buffer ) ) )
+    for( size_t i = 0; i < sequencerBuffer->capacity; ++i )
     {
-        AiaSequencerSlot_t* slot = (AiaSequencerSlot_t*)link;
-        AiaFree( slot->data );
-        AiaFree( slot );
+        AiaSequencerBuffer_ReleaseSlotData( sequencerBuffer,
+                                            &sequencerBuffer->slots[ i ] );
     }
-
+    AiaFree( sequencerBuffer->pool );
+    AiaFree( sequencerBuffer->occupancy );
+    AiaFree( sequencerBuffer->slots );
     AiaFree( sequencerBuffer );
 }
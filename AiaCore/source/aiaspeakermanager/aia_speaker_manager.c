@@ -26,29 +26,95 @@
 #include <aiaspeakermanager/private/aia_speaker_manager.h>
 
 #include <aiacore/aia_binary_constants.h>
+#include <aiacore/aia_binary_message.h>
+#include <aiacore/aia_container.h>
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_events.h>
 #include <aiacore/aia_exception_encountered_utils.h>
 #include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_message.h>
+#include <aiacore/aia_json_template.h>
 #include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_overload_governor.h>
 #include <aiacore/aia_topic.h>
+#include <aiacore/aia_utils.h>
 #include <aiacore/aia_volume_constants.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
 
+#include AiaClock( HEADER )
 #include AiaListDouble( HEADER )
 #include AiaMutex( HEADER )
+#include AiaRealtimeTimer( HEADER )
 #include AiaTimer( HEADER )
 
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
+/**
+ * The weight of each new inter-arrival deviation in the jitter estimate, as a
+ * power of two.
+ */
+#define AIA_SPEAKER_JITTER_SHIFT 4
+
+/** The number of offset action slots allocated when the first action is
+ * scheduled. The pool doubles in size whenever it runs out of slots. */
+#define AIA_SPEAKER_ACTION_POOL_INITIAL_CAPACITY 8
+
+/** The largest number of offset actions that may be scheduled at once. Slot
+ * indices are stored in the low 16 bits of an @c AiaSpeakerActionHandle_t. */
+#define AIA_SPEAKER_ACTION_POOL_MAX_CAPACITY UINT16_MAX
+
+/** The number of reached offsets that may be queued for @c dispatchWorker.
+ * This must be a power of two. */
+#define AIA_SPEAKER_REACHED_OFFSETS_CAPACITY 8
+
+/** The most frame periods that a late run of @c speakerWorker makes up for by
+ * pushing extra frames. Periods missed beyond this are dropped rather than
+ * pushed to the speaker in one burst. */
+#define AIA_SPEAKER_MAX_CATCH_UP_FRAMES 5
+
+/** The number of entries of a speaker topic message staged while it is
+ * validated. Entries beyond these are staged in further batches when the
+ * message is written. */
+#define AIA_SPEAKER_MAX_STAGED_ENTRIES 16
+
+/** The most markers which may be waiting for their offset to be played. */
+#define AIA_SPEAKER_MAX_PENDING_MARKERS 64
+
+/** The most gaps which may be waiting to be concealed. */
+#define AIA_SPEAKER_MAX_GAPS 16
+
+/** The most reached markers sent by @c dispatchWorker each time it takes the
+ * speaker manager's lock. */
+#define AIA_SPEAKER_MARKER_DISPATCH_BATCH 8
+
+/** The longest time a VolumeChanged event may be held back to go out with
+ * other traffic. Buffer state events are not held, since they must not go out
+ * after the speaker state they lead up to. */
+#define AIA_SPEAKER_DEFERRED_EVENT_MAX_DELAY_MS ( (AiaDurationMs_t)2000 )
+
+/** The size of the header and offset which lead a Binary Stream holding a
+ * single content entry. */
+#define AIA_SPEAKER_CONTENT_PREFIX_SIZE                                      \
+    ( sizeof( AiaBinaryMessageLength_t ) + sizeof( AiaBinaryMessageType_t ) + \
+      sizeof( AiaBinaryMessageCount_t ) +                                      \
+      AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES +                                  \
+      sizeof( AiaBinaryAudioStreamOffset_t ) )
+
+/** The direction in which the amount of buffered speaker data is moving. */
+typedef enum AiaSpeakerBufferDirection
+{
+    /** Audio was just written to the buffer. */
+    AIA_SPEAKER_BUFFER_FILLING,
+
+    /** Audio was just read from the buffer. */
+    AIA_SPEAKER_BUFFER_DRAINING,
+} AiaSpeakerBufferDirection_t;
+
 /** An internal type used to hold information relevant to a marker. */
 typedef struct AiaSpeakerMarkerSlot
 {
-    /** The actual link in the list. */
-    AiaListDouble( Link_t ) link;
-
     /** Offset associated with the marker. */
     AiaBinaryAudioStreamOffset_t offset;
 
@@ -56,24 +122,173 @@ typedef struct AiaSpeakerMarkerSlot
     AiaSpeakerBinaryMarker_t marker;
 } AiaSpeakerMarkerSlot_t;
 
+AIA_DEFINE_RING( AiaSpeakerMarkerRing, AiaSpeakerMarkerSlot_t )
+
 /** Internal type used to hold information about triggers to invoke when an
- * offset is reached. */
+ * offset is reached. Slots are pooled and referenced by index. */
 typedef struct AiaSpeakerOffsetActionSlot
 {
-    /** The actual link in the list. */
-    AiaListDouble( Link_t ) link;
-
     /** Offset associated with the action. */
     AiaBinaryAudioStreamOffset_t offset;
 
-    /** The action to invoke. */
+    /** The order in which the action was scheduled. Actions at the same
+     * offset are invoked in this order. */
+    uint64_t sequence;
+
+    /** The action to invoke, or @c NULL if this slot is free. */
     AiaActionAtSpeakerOffset_t action;
 
     /** User data associated with the action. */
     void* userData;
 
+    /** The position of this slot in the action heap while it is in use, or
+     * the index of the next free slot while it is free. */
+    size_t position;
+
+    /** Incremented each time this slot is freed so that handles to previous
+     * uses of the slot are rejected. */
+    uint16_t generation;
+
 } AiaSpeakerOffsetActionSlot_t;
 
+/** Used to hold information about a range of the speaker buffer holding
+ * placeholders for speaker frames that were never received. */
+typedef struct AiaSpeakerGapSlot
+{
+    /** Offset at which the gap starts. */
+    AiaBinaryAudioStreamOffset_t offset;
+
+    /** Length of the gap in bytes. This is a multiple of the frame size. */
+    size_t length;
+
+} AiaSpeakerGapSlot_t;
+
+AIA_DEFINE_RING( AiaSpeakerGapRing, AiaSpeakerGapSlot_t )
+
+/** A speaker topic message held in the spill store. */
+typedef struct AiaSpeakerSpilledMessageSlot
+{
+    /** The actual link in the list. */
+    AiaListDouble( Link_t ) link;
+
+    /** Sequence number of the message. */
+    AiaSequenceNumber_t sequenceNumber;
+
+    /** Size of the message in the spill store. */
+    size_t size;
+
+    /** The number of audio bytes the message will write to the speaker
+     * buffer. */
+    size_t totalAudioLength;
+
+} AiaSpeakerSpilledMessageSlot_t;
+
+/** Descriptors of the entries of a speaker topic message, which point into the
+ * message itself. */
+typedef struct AiaSpeakerStagedMessage
+{
+    /** The next batch of entries to write. */
+    AiaBinaryStreamEntry_t entries[ AIA_SPEAKER_MAX_STAGED_ENTRIES ];
+
+    /** The number of entries in @c entries. */
+    size_t numEntries;
+
+    /** Positioned at the first entry following @c entries. */
+    AiaBinaryStreamIterator_t rest;
+
+    /** The total length of the audio bytes in the message. */
+    size_t totalAudioLength;
+} AiaSpeakerStagedMessage_t;
+
+/** A speaker added with @c AiaSpeakerManager_AddSink(). */
+typedef struct AiaSpeakerSink
+{
+    /** Callback used to push frames to the speaker, or @c NULL if this slot is
+     * free. */
+    AiaPlaySpeakerData_t playSpeakerDataCb;
+
+    /** User data to pass to @c playSpeakerDataCb. */
+    void* playSpeakerDataCbUserData;
+
+    /** Incremented whenever the slot is added or removed, so that the outcome
+     * of a push delivered across a removal does not apply to a new speaker. */
+    uint32_t generation;
+
+    /** Whether the speaker is ready for frames to be pushed, as for @c
+     * isSpeakerReadyForData. */
+    bool isReadyForData;
+
+    /** Incremented by @c AiaSpeakerManager_OnSinkReady(). */
+    uint32_t readyCount;
+
+    /** The number of bytes of @c bufferedSpeakerFrame the speaker has
+     * accepted. */
+    size_t deliveredSize;
+} AiaSpeakerSink_t;
+
+/** The state of a @c AiaSpeakerSink_t when a push was claimed. */
+typedef struct AiaSpeakerPushSink
+{
+    /** @c playSpeakerDataCb and its user data, or @c NULL if the slot was
+     * free. */
+    AiaPlaySpeakerData_t playSpeakerDataCb;
+    void* playSpeakerDataCbUserData;
+
+    /** @c generation and @c readyCount of the slot. */
+    uint32_t generation;
+    uint32_t readyCount;
+
+    /** The number of bytes of the push accepted, which is updated as they are
+     * handed over. */
+    size_t deliveredSize;
+} AiaSpeakerPushSink_t;
+
+/** Frames claimed for the speaker while @c mutex is locked, to be handed to
+ * the platform once it has been released. */
+typedef struct AiaSpeakerPush
+{
+    /** Whether the frames are synthesized via @c concealSpeakerDataCb rather
+     * than played from @c data. */
+    bool isConcealment;
+
+    /** The frames to play or, when concealing, the first frame after the gap
+     * if it has been read. This points into @c bufferedSpeakerFrame. */
+    const uint8_t* data;
+
+    /** The number of bytes at @c data. */
+    size_t size;
+
+    /** The number of frames played or concealed. */
+    size_t frameCount;
+
+    /** @c playSpeakerDataBatchCb and its user data when the push was
+     * claimed. */
+    AiaPlaySpeakerDataBatch_t playSpeakerDataBatchCb;
+    void* playSpeakerDataBatchCbUserData;
+
+    /** @c concealSpeakerDataCb and its user data when the push was claimed. */
+    AiaConcealSpeakerData_t concealSpeakerDataCb;
+    void* concealSpeakerDataCbUserData;
+
+    /** @c pushGeneration when the push was claimed. */
+    uint32_t generation;
+
+    /** @c speakerReadyCount when the push was claimed. */
+    uint32_t readyCount;
+
+    /** Whether @c playSpeakerDataCb has accepted @c data, which is updated as
+     * it is handed over. */
+    bool isPrimaryDelivered;
+
+    /** The speakers added with @c AiaSpeakerManager_AddSink(). */
+    AiaSpeakerPushSink_t sinks[ AIA_SPEAKER_MAX_SINKS ];
+
+#ifdef AIA_ENABLE_TRACE
+    /** The offset of the first frame played. */
+    AiaBinaryAudioStreamOffset_t traceOffset;
+#endif
+} AiaSpeakerPush_t;
+
 /* TODO: ADSER-1925 Make this an extension of @c AiaSpeakerOffsetActionSlot_t
  * rather than maintain separately. */
 /** Used to hold information about action callbacks related to a volume change
@@ -108,6 +323,9 @@ typedef struct AiaCurrentSpeakerState
     /** The current buffer state. */
     AiaSpeakerManagerBufferState_t currentBufferState;
 
+    /** The time at which @c currentBufferState was entered. */
+    AiaTimepointMs_t bufferStateEnteredMs;
+
     /** Used to indicate whether the speaker is ready for frames to be pushed -
      * default is @c true and is reset to this value whenever the speaker is
      * closed. This takes on an @c false value when @c AiaPlaySpeakerData_t()
@@ -115,14 +333,23 @@ typedef struct AiaCurrentSpeakerState
      * is called. */
     bool isSpeakerReadyForData;
 
-    /** Used to buffer a frame when the speaker fails to accept a frame for
-     * playback. */
+    /** Used to stage the frames being pushed to the speaker and to buffer
+     * them when the speaker fails to accept them for playback. This holds
+     * @c framesPerPush frames, and may be released while the speaker is
+     * closed. */
     uint8_t* bufferedSpeakerFrame;
 
+    /** The number of valid bytes in @c bufferedSpeakerFrame. */
+    size_t bufferedSpeakerFrameSize;
+
     /** Used to indicate that @c bufferedSpeakerFrame must be pushed to the
      * speaker before any other frames. */
     bool isBufferedSpeakerFramePending;
 
+    /** Whether @c playSpeakerDataCb has accepted @c bufferedSpeakerFrame, so
+     * that it is not pushed again while added speakers catch up. */
+    bool isBufferedSpeakerFrameDelivered;
+
     /** The current volume. */
     uint8_t currentVolume;
 
@@ -144,59 +371,194 @@ typedef struct AiaCurrentSpeakerState
 } AiaCurrentSpeakerState_t;
 
 /**
- * Underlying struct that contains all the data required to present the @c
- * AiaSpeakerManager_t abstraction.
+ * Speaker manager state which is not read while pushing frames to the speaker:
+ * configuration, volume and offline alert handling, event generation and
+ * metrics. This is allocated apart from @c AiaSpeakerManager_t so that it does
+ * not share cache lines with the fields read every frame period. Fields are
+ * synchronized by the owning speaker manager's @c mutex unless documented
+ * otherwise.
  */
-struct AiaSpeakerManager
+typedef struct AiaSpeakerManagerCold
 {
-    /** Underlying memory of @c speakerBuffer. */
-    void* speakerBufferMemory;
+    /* TODO: ADSER-1585 Investigate ways of making this call thread-safe
+     * independent of an external component's implementation details. */
+    /** Used to reset the next expected sequence number on overruns. Methods of
+     * the sequencer are not thread-safe. However, the only call made to the
+     * sequencer ( @cAiaSequencer_ResetSequenceNumber() ) is made on the same
+     * thread as the thread that messages flow from the @c AiaSequencer to the
+     * @c AiaSpeakerManager. */
+    AiaSequencer_t* const sequencer;
 
-    /** The underlying speaker buffer used to buffer compressed audio data. This
-     * is created during initialization and destroyed during cleanup so no
-     * thread-safety is needed. Furthermore, all of this object's methods are
-     * thread-safe. */
-    AiaDataStreamBuffer_t* const speakerBuffer;
+    /** Callback implemented by the speaker to change volume. */
+    const AiaSetVolume_t setVolumeCb;
 
-    /** A stream writer used to write audio frames to @c speakerBuffer. Methods
-     * of this object are thread-safe. */
-    AiaDataStreamWriter_t* const speakerBufferWriter;
+    /** User data to pass to @c setVolumeCb. */
+    void* const setVolumeCbUserData;
 
-    /** A stream reader used to pull frames out of the buffer to push to the
-     * speaker for playback. Methods of this object are thread-safe. */
-    AiaDataStreamReader_t* const speakerBufferReader;
+    /** Callback to use while synthesizing the offline alert tone. */
+    const AiaOfflineAlertPlayback_t playOfflineAlertCb;
 
-    /** Threshold at which to send an OVERRUN_WARNING. This is only ever written
-     * to during initialization and then subsequently read from. Thread-safety
-     * is not needed. */
-    const size_t overrunWarningThreshold;
+    /** User data to pass to @c playOfflineAlertCb. */
+    void* const playOfflineAlertCbUserData;
 
-    /** Threshold at which to send an UNDERRUN_WARNING. This is only ever
-     * written to during initialization and then subsequently read from.
-     * Thread-safety is not needed. */
-    const size_t underrunWarningThreshold;
+    /** Callback to use while stopping the playback of offline alert tone. */
+    const AiaOfflineAlertStop_t stopOfflineAlertCb;
+
+    /** User data to pass to @c stopOfflineAlertCb. */
+    void* const stopOfflineAlertCbUserData;
+
+    /** Used to notify observers about speaker buffer state changes */
+    const AiaSpeakerManagerBufferStateObserver_t notifyObserversCb;
+
+    /** User data associated with @c notifyObserversCb */
+    void* const notifyObserversCbUserData;
+
+    /** Optional callback used to let the platform pre-roll playback when an
+     * OpenSpeaker directive is received. */
+    AiaPrefetchSpeakerData_t prefetchSpeakerDataCb;
+
+    /** User data to pass to @c prefetchSpeakerDataCb. */
+    void* prefetchSpeakerDataCbUserData;
+
+    /** Optional callback used to have the platform drop queued frames when
+     * playback is stopped locally. */
+    AiaFlushSpeakerData_t flushSpeakerDataCb;
+
+    /** User data to pass to @c flushSpeakerDataCb. */
+    void* flushSpeakerDataCbUserData;
+
+    /** Storage of @c accumulatedMarkers. */
+    AiaSpeakerMarkerSlot_t markerStorage[ AIA_SPEAKER_MAX_PENDING_MARKERS ];
+
+    /** Storage of @c gaps. */
+    AiaSpeakerGapSlot_t gapStorage[ AIA_SPEAKER_MAX_GAPS ];
+
+    /** Whether @c spillStore is installed. */
+    bool hasSpillStore;
+
+    /** Store that speaker topic messages are spilled to while the speaker
+     * buffer is full. */
+    AiaSpeakerSpillStore_t spillStore;
+
+    /** Collection of volume actions. */
+    AiaListDouble_t volumeActions;
+
+    /** How volume changes are reported and persisted. */
+    AiaSpeakerVolumeCoalescingConfig_t volumeCoalescing;
+
+    /** Whether a @c VolumeChanged event for a local change is waiting for @c
+     * volumeWorker. */
+    bool isVolumeChangedPending;
+
+    /** When the pending @c VolumeChanged event is due. */
+    AiaTimepointMs_t volumeChangedDueMs;
+
+#ifdef AIA_STORE_VOLUME
+    /** Whether the current volume is waiting for @c volumeWorker to persist
+     * it. */
+    bool isVolumeStorePending;
+
+    /** When the current volume is due to be persisted. */
+    AiaTimepointMs_t volumeStoreDueMs;
+#endif
+
+    /** Used to send coalesced @c VolumeChanged events and to persist the
+     * volume once it has settled. */
+    AiaTimer_t volumeWorker;
+
+    /** Used to invoke actions and send marker events for offsets reached by
+     * @c speakerWorker, so that this work does not delay frame pushes. */
+    AiaTimer_t dispatchWorker;
+
+    /** Serializes runs of @c dispatchWorker. This is never held by @c
+     * speakerWorker. */
+    AiaMutex_t dispatchMutex;
+
+    /** Posts the offset being heard when the next action or marker pushed to
+     * the speaker is due to be heard, while @c playoutLatencyMs is non-zero. */
+    AiaTimer_t playoutWorker;
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    /** Returns unused segments of the speaker buffer once the speaker has
+     * stayed closed for @c AIA_SPEAKER_BUFFER_SHRINK_DELAY_MS. */
+    AiaTimer_t shrinkWorker;
+#endif
+
+    /** The number of transitions into each buffer state, reported by @c
+     * AiaSpeakerManager_GetMetrics(). These should only be accessed using
+     * atomic operations. */
+    uint32_t bufferStateTransitions[ AIA_OVERRUN_STATE + 1 ];
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** Reported by @c AiaSpeakerManager_GetMetrics(). */
+    AiaHistogram_t openToFirstFrameMs;
+#endif
+} AiaSpeakerManagerCold_t;
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaSpeakerManager_t abstraction.
+ *
+ * Fields are grouped by how often they are read. Those read on every run of @c
+ * speakerWorker come first, starting with the ones an idle run reads, so that
+ * a run touches as few cache lines as possible. Fields read while handling
+ * speaker messages follow, and the rest live in the separately allocated @c
+ * cold. On 64-bit Linux, an idle run reads the first two cache lines, the
+ * fields read by a run which pushes frames span about 750 bytes, and this
+ * struct and @c cold take about 850 bytes and 1.7 KiB respectively. Fields are
+ * synchronized by @c mutex unless documented otherwise.
+ */
+struct AiaSpeakerManager
+{
+    /** @name Fields read on every run of @c speakerWorker. */
+    /** @{ */
 
     /** Mutex used to guard against asynchronous calls in threaded
      * environments. */
     AiaMutex_t mutex;
 
-    /** @name Variables synchronized by mutex. */
-    /** @{ */
+    /** Set while @c speakerWorker hands claimed frames to the speaker with @c
+     * mutex released. Runs of @c speakerWorker which find this set do nothing,
+     * so that frames are never pushed out of order. */
+    bool isPushInFlight;
+
+    /** Incremented whenever the speaker is closed, so that the outcome of a
+     * push delivered across a close does not leak into the next stream. */
+    uint32_t pushGeneration;
 
-    /** The linked list representing accumulated markers. */
-    AiaListDouble_t accumulatedMarkers;
+    /** Incremented by @c AiaSpeakerManager_OnSpeakerReady(), so that a push
+     * rejected just before the speaker became ready again is retried. */
+    uint32_t speakerReadyCount;
+
+    /** When the frame period after the last pushed frames starts, or zero if
+     * nothing was pushed on the last run of @c speakerWorker. Used to catch up
+     * after late runs. */
+    AiaTimepointMs_t nextPushDueMs;
 
     /** An object representing the current state of the speaker. */
     AiaCurrentSpeakerState_t currentSpeakerState;
 
-    /** The last sequence number speaker message successfully processed. */
-    AiaSequenceNumber_t lastSpeakerSequenceNumberProcessed;
+    /** A stream reader used to pull frames out of the buffer to push to the
+     * speaker for playback. Methods of this object are thread-safe. */
+    AiaDataStreamReader_t* const speakerBufferReader;
+
+    /** A stream writer used to write audio frames to @c speakerBuffer. Methods
+     * of this object are thread-safe. */
+    AiaDataStreamWriter_t* const speakerBufferWriter;
 
+    /** The underlying speaker buffer used to buffer compressed audio data. This
+     * is created during initialization and destroyed during cleanup so no
+     * thread-safety is needed. Furthermore, all of this object's methods are
+     * thread-safe. */
+    AiaDataStreamBuffer_t* const speakerBuffer;
+
+#ifndef AIA_SPEAKER_FIXED_FRAME_SIZE
     /* TODO: ADSER-1529 Implement support for VBR */
     /** The speaker frame size. This is determined using the first speaker topic
      * content message received. Note that this assumes a static constant bit
-     * rate. VBR is not currently supported. */
+     * rate. VBR is not currently supported. Read it with @c getFrameSize(). */
     size_t frameSize;
+#endif
 
     /** Callback implemented by the speaker to receive speaker frames for
      * playback. */
@@ -205,85 +567,362 @@ struct AiaSpeakerManager
     /** User data to pass to @c playSpeakerDataCb. */
     void* const playSpeakerDataCbUserData;
 
-    /** Sequence number of the last message that caused an overrun. Subsequent
-     * messages will not be handled until this sequence number is re-sent. A
-     * value of zero indicates that no waiting is required. */
-    AiaSequenceNumber_t overrunSpeakerSequenceNumber;
+    /** Optional callback used in place of @c playSpeakerDataCb to push
+     * multiple frames per invocation. Synchronized by @c mutex. */
+    AiaPlaySpeakerDataBatch_t playSpeakerDataBatchCb;
 
-    /* TODO: ADSER-1585 Investigate ways of making this call thread-safe
-     * independent of an external component's implementation details. */
-    /** Used to reset the next expected sequence number on overruns. Methods of
-     * the sequencer are not thread-safe. However, the only call made to the
-     * sequencer ( @cAiaSequencer_ResetSequenceNumber() ) is made on the same
-     * thread as the thread that messages flow from the @c AiaSequencer to the
-     * @c AiaSpeakerManager. */
-    AiaSequencer_t* const sequencer;
+    /** User data to pass to @c playSpeakerDataBatchCb. */
+    void* playSpeakerDataBatchCbUserData;
 
-    /** Callback implemented by the speaker to change volume. */
-    const AiaSetVolume_t setVolumeCb;
+    /** Maximum number of frames to push per @c playSpeakerDataBatchCb
+     * invocation. Synchronized by @c mutex. */
+    size_t maxFramesPerPush;
 
-    /** User data to pass to @c setVolumeCb. */
-    void* const setVolumeCbUserData;
+    /** Maximum number of bytes to push per @c playSpeakerDataBatchCb
+     * invocation, or zero for no limit. Synchronized by @c mutex. */
+    size_t maxBytesPerPush;
 
-    /** Callback to use while synthesizing the offline alert tone. */
-    const AiaOfflineAlertPlayback_t playOfflineAlertCb;
+    /** Time in milliseconds between frames being pushed and being heard, as
+     * last set by @c AiaSpeakerManager_SetPlayoutLatency(). This should only
+     * be accessed using atomic operations. */
+    uint32_t playoutLatencyMs;
 
-    /** User data to pass to @c playOfflineAlertCb. */
-    void* const playOfflineAlertCbUserData;
+    /** The read offset of the speaker buffer after the last push, and when it
+     * was pushed. Used to work out the offset being heard. These are
+     * synchronized by @c mutex. */
+    AiaDataStreamIndex_t lastPushOffset;
+    AiaTimepointMs_t lastPushMs;
 
-    /** Callback to use while stopping the playback of offline alert tone. */
-    const AiaOfflineAlertStop_t stopOfflineAlertCb;
+    /** Markers waiting for their offset to be played, in offset order. */
+    AiaSpeakerMarkerRing_t accumulatedMarkers;
 
-    /** User data to pass to @c stopOfflineAlertCb. */
-    void* const stopOfflineAlertCbUserData;
+    /** Gaps waiting to be concealed, sorted by offset. */
+    AiaSpeakerGapRing_t gaps;
 
-    /** Used to notify observers about speaker buffer state changes */
-    const AiaSpeakerManagerBufferStateObserver_t notifyObserversCb;
+    /** Pool of actions to invoke when an offset is reached. @c actionHeap is
+     * allocated in the same block, directly after the slots. */
+    AiaSpeakerOffsetActionSlot_t* actionSlots;
 
-    /** User data associated with @c notifyObserversCb */
-    void* const notifyObserversCbUserData;
+    /** Binary min-heap of indices into @c actionSlots, ordered by offset and
+     * then by sequence. */
+    uint16_t* actionHeap;
 
-    /** Sorted collection of actions to invoke when an offset is reached. */
-    AiaListDouble_t offsetActions;
+    /** The number of slots in @c actionSlots. */
+    size_t actionCapacity;
 
-    /** Collection of volume actions. */
-    AiaListDouble_t volumeActions;
+    /** The number of scheduled actions in @c actionHeap. */
+    size_t numActions;
 
-    /** @} */
+    /** The index of the first free slot in @c actionSlots, or @c
+     * actionCapacity if all slots are in use. */
+    size_t freeActionSlot;
+
+    /** The sequence to assign to the next scheduled action. */
+    uint64_t nextActionSequence;
+
+    /** Collection of @c AiaSpeakerSpilledMessageSlot_t in the order they were
+     * appended to @c spillStore. */
+    AiaListDouble_t spilledMessages;
+
+    /** The total size of the messages in @c spilledMessages. */
+    size_t spilledBytes;
+
+    /** Threshold at which to send an OVERRUN_WARNING when the adaptive jitter
+     * buffer is disabled. This is only ever written to during initialization
+     * and then subsequently read from. Thread-safety is not needed. */
+    const size_t overrunWarningThreshold;
+
+    /** Threshold at which to send an UNDERRUN_WARNING when the adaptive jitter
+     * buffer is disabled. This is only ever written to during initialization
+     * and then subsequently read from. Thread-safety is not needed. */
+    const size_t underrunWarningThreshold;
+
+    /** Whether the adaptive jitter buffer is enabled. */
+    bool isJitterBufferEnabled;
+
+    /** Threshold at which to send an UNDERRUN_WARNING when the adaptive jitter
+     * buffer is enabled. This is also the amount of audio to buffer before
+     * opening the speaker. */
+    size_t adaptiveUnderrunWarningThreshold;
+
+    /** Threshold at which to send an OVERRUN_WARNING when the adaptive jitter
+     * buffer is enabled. */
+    size_t adaptiveOverrunWarningThreshold;
+
+    /** Configuration of the adaptive jitter buffer. */
+    AiaSpeakerJitterBufferConfig_t jitterBufferConfig;
+
+    /** Hysteresis applied to the warning states of the buffer. */
+    AiaSpeakerBufferStateHysteresisConfig_t bufferStateHysteresis;
+
+    /** The time at which the latest OpenSpeaker was received. */
+    AiaTimepointMs_t openSpeakerTimestampMs;
+
+    /** Free-running count of offsets written to @c reachedOffsets. This should
+     * only be accessed using atomic operations. */
+    uint32_t reachedOffsetsWriteIndex;
+
+    /** Free-running count of offsets read from @c reachedOffsets. This should
+     * only be accessed using atomic operations. */
+    uint32_t reachedOffsetsReadIndex;
+
+    /** Whether @c dispatchWorker has been armed and has not yet started
+     * draining @c reachedOffsets. */
+    AiaAtomicBool_t isDispatchPending;
+
+    /** Offsets reached by @c speakerWorker and not yet handled by @c
+     * dispatchWorker. Written only with @c mutex locked and read only with @c
+     * dispatchMutex locked. */
+    AiaDataStreamIndex_t reachedOffsets[ AIA_SPEAKER_REACHED_OFFSETS_CAPACITY ];
+
+    /** Speakers added with @c AiaSpeakerManager_AddSink(), indexed by their id
+     * minus one. Synchronized by @c mutex. */
+    AiaSpeakerSink_t sinks[ AIA_SPEAKER_MAX_SINKS ];
 
     /** Used to schedule jobs for checking the speaker buffer and
      * pushing frames for playback to the speaker as needed. */
-    AiaTimer_t speakerWorker;
+    AiaRealtimeTimer_t speakerWorker;
 
     /** Used to publish outbound messages. Methods of this object are
      * thread-safe. */
     AiaRegulator_t* const regulator;
-};
 
-/** Locked variant of @c AiaSpeakerManager_ChangeVolume. See @c
- * AiaSpeakerManager_ChangeVolume documentation. */
-static bool AiaSpeakerManager_ChangeVolumeLocked(
-    AiaSpeakerManager_t* speakerManager, uint8_t newVolume );
+    /** @} */
+
+    /** @name Fields read while handling speaker messages. */
+    /** @{ */
+
+    /** The last sequence number speaker message successfully processed. */
+    AiaSequenceNumber_t lastSpeakerSequenceNumberProcessed;
+
+    /** Whether a batch begun by @c AiaSpeakerManager_BeginWriteBatch() is
+     * open, in which case the buffer state is only evaluated once it ends. */
+    bool isWriteBatchOpen;
+
+    /** Whether content was written since the open batch began. */
+    bool isWriteBatchWritten;
+
+    /** Optional callback used to synthesize audio for lost speaker frames. Gaps
+     * in the speaker stream are only accepted when this is set. */
+    AiaConcealSpeakerData_t concealSpeakerDataCb;
+
+    /** User data to pass to @c concealSpeakerDataCb. */
+    void* concealSpeakerDataCbUserData;
+
+    /** Whether @c lastTransitMs was measured on a previous speaker message
+     * since the latest OpenSpeaker. */
+    bool hasLastTransit;
+
+    /** The arrival time less the playback time of the end of the last speaker
+     * message. Only differences between values are meaningful. */
+    int64_t lastTransitMs;
+
+    /** Smoothed inter-arrival jitter of speaker messages, in sixteenths of a
+     * millisecond. */
+    uint32_t jitterSixteenthsMs;
+
+    /** Sequence number of the last message that caused an overrun. Subsequent
+     * messages will not be handled until this sequence number is re-sent. A
+     * value of zero indicates that no waiting is required. */
+    AiaSequenceNumber_t overrunSpeakerSequenceNumber;
+
+    /** Whether the leading audio of a message that overruns the speaker buffer
+     * is written before the overrun is reported. */
+    bool isPartialOverrunAcceptEnabled;
+
+    /** Whether part of the message @c overrunSpeakerSequenceNumber has already
+     * been written, in which case it is skipped when the message is redriven.
+     */
+    bool hasOverrunPrefix;
+
+    /** The number of leading entries of the overrun message which were
+     * written in full. */
+    size_t overrunPrefixEntries;
+
+    /** The number of audio bytes of the overrun message which were written. */
+    size_t overrunPrefixAudioLength;
+
+    /** The offset of the speaker buffer writer once the leading audio of the
+     * overrun message had been written. */
+    AiaBinaryAudioStreamOffset_t overrunResumeOffset;
+
+    /** Underlying memory of @c speakerBuffer. When @c
+     * AIA_ENABLE_ELASTIC_SPEAKER_BUFFER is defined, this is replaced with @c
+     * mutex locked as the buffer grows and shrinks. */
+    void* speakerBufferMemory;
+
+    /** The size of the speaker buffer advertised to the service, which is
+     * also the largest @c speakerBuffer may grow to. This is only ever written
+     * to during initialization. Thread-safety is not needed. */
+    const size_t speakerBufferSize;
+
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    /** Storage used as @c currentSpeakerState.bufferedSpeakerFrame while one
+     * frame is pushed at a time, so that it is never allocated. */
+    uint8_t fixedSpeakerFrame[ AIA_SPEAKER_FIXED_FRAME_SIZE ];
+#endif
+
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    /** Whether @c speakerBufferMemory and @c bufferedSpeakerFrame are kept
+     * prefaulted, and whether they are also locked into RAM. Synchronized by
+     * @c mutex. */
+    bool isMemoryPrefaulted;
+    bool isMemoryLocked;
+
+    /** The size of @c bufferedSpeakerFrame in bytes. Synchronized by @c
+     * mutex. */
+    size_t bufferedSpeakerFrameCapacity;
+#endif
+
+    /** @} */
+
+    /** State which is not read while pushing frames. This is allocated during
+     * initialization and freed during cleanup. */
+    AiaSpeakerManagerCold_t* const cold;
+};
 
 /**
- * This is a recurring function that occurs at AIA_SPEAKER_FRAME_PUSH_CADENCE_MS
- * that checks the speaker state and pushes frames to the application for
- * playback as needed.
+ * Returns the speaker frame size. With @c AIA_SPEAKER_FIXED_FRAME_SIZE, this is
+ * a constant, so that frame arithmetic is folded by the compiler.
  *
- * @param context User data associated with this routine.
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The speaker frame size, or zero until the first content is received.
  */
-static void AiaSpeakerManager_PlaySpeakerDataRoutine( void* context );
+static inline size_t getFrameSize( const AiaSpeakerManager_t* speakerManager )
+{
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    (void)speakerManager;
+    return AIA_SPEAKER_FIXED_FRAME_SIZE;
+#else
+    return speakerManager->frameSize;
+#endif
+}
 
 /**
- * An internal helper function used to read and push speaker frames to the
- * speaker.
+ * Returns how long each speaker frame plays for, derived from the frame size
+ * and the constant bitrate in the same way as @c AiaOpusDecoder_DecodeFrame().
+ * This is the period of @c speakerWorker.
  *
  * @param speakerManager The @c AiaSpeakerManager_t to act on.
- * @note This method must be called while @c speakerManager->mutex is locked.
+ * @return The frame duration, rounded down to a whole millisecond but at least
+ * one, or @c AIA_SPEAKER_FRAME_PUSH_CADENCE_MS until the frame size is known.
  */
-static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
+static inline AiaDurationMs_t getFrameDurationMs(
+    const AiaSpeakerManager_t* speakerManager )
+{
+    size_t frameSize = getFrameSize( speakerManager );
+    if( !frameSize )
+    {
+        return AIA_SPEAKER_FRAME_PUSH_CADENCE_MS;
+    }
+    AiaDurationMs_t durationMs =
+        frameSize * 8 * AIA_MS_PER_SECOND /
+        (size_t)AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND;
+    return durationMs ? durationMs : 1;
+}
+
+/**
+ * Locked variant of @c AiaSpeakerManager_ChangeVolume. See @c
+ * AiaSpeakerManager_ChangeVolume documentation.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param newVolume The new absolute volume.
+ * @param isLocal Whether the change was requested locally, in which case its
+ * @c VolumeChanged event may be coalesced.
+ * @return @c true if everything went as expected or @c false otherwise.
+ */
+static bool AiaSpeakerManager_ChangeVolumeLocked(
+    AiaSpeakerManager_t* speakerManager, uint8_t newVolume, bool isLocal );
+
+/**
+ * An internal helper function used to send a @c VolumeChanged event for the
+ * current volume, at the current offset if the speaker is open.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if the event was sent or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool AiaSpeakerManager_SendVolumeChangedLocked(
+    AiaSpeakerManager_t* speakerManager );
+
+/**
+ * An internal helper function used to arm @c volumeWorker for the earliest
+ * pending volume deadline, if there is one.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param now The current time.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void AiaSpeakerManager_ArmVolumeWorkerLocked(
+    AiaSpeakerManager_t* speakerManager, AiaTimepointMs_t now );
+
+/**
+ * A function scheduled by @c AiaSpeakerManager_ArmVolumeWorkerLocked() that
+ * sends the settled volume and persists it once their deadlines pass.
+ *
+ * @param context User data associated with this routine.
+ */
+static void AiaSpeakerManager_VolumeRoutine( void* context );
+
+/**
+ * This is a recurring function that occurs every frame period (see @c
+ * getFrameDurationMs()) that checks the speaker state and pushes frames to the
+ * application for playback as needed.
+ *
+ * @param context User data associated with this routine.
+ */
+static void AiaSpeakerManager_PlaySpeakerDataRoutine( void* context );
+
+/**
+ * A function scheduled on demand by @c AiaSpeakerManager_PlaySpeakerDataRoutine
+ * that invokes actions and sends marker events for reached offsets.
+ *
+ * @param context User data associated with this routine.
+ */
+static void AiaSpeakerManager_DispatchRoutine( void* context );
+
+/**
+ * A function scheduled by @c armPlayoutWorkerLocked() to post the offset being
+ * heard once an action or marker pushed to the speaker is due to be heard.
+ *
+ * @param context User data associated with this routine.
+ */
+static void AiaSpeakerManager_PlayoutRoutine( void* context );
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+/**
+ * A function scheduled by @c scheduleSpeakerBufferShrinkLocked() that returns
+ * the unused segments of the speaker buffer if the speaker is still closed.
+ *
+ * @param context User data associated with this routine.
+ */
+static void AiaSpeakerManager_ShrinkRoutine( void* context );
+#endif
+
+/**
+ * An internal helper function used to read and push speaker frames to the
+ * speaker.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The number of frames the speaker accepted.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ * It releases the mutex while the frames are handed to the speaker.
+ */
+static size_t AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
     AiaSpeakerManager_t* speakerManager );
 
+/**
+ * An internal helper function used to read the next speaker frames and claim
+ * them for pushing to the speaker.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param[out] push The frames claimed.
+ * @return @c true if frames were claimed or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool AiaSpeakerManager_ClaimSpeakerPushLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSpeakerPush_t* push );
+
 /**
  * An internal helper function used to check if the speaker is open or
  * streaming.
@@ -319,22 +958,53 @@ static void AiaSpeakerManager_StopOfflineAlertLocked(
 #endif
 
 /**
- * An internal helper function used to parse content type messages on the
- * speaker topic. This must return whether parsing of the entire binary message
- * should continue or not.
+ * An internal helper function used to write a run of content type entries on
+ * the speaker topic to the speaker buffer. The audio of the run is written
+ * with a single write to the buffer. This must return whether parsing of the
+ * entire binary message should continue or not.
  *
  * @param speakerManager The @c AiaSpeakerManager_t to act on.
- * @param data Pointer to the data section of the Aia Binary Stream.
- * @param length The length of @c data.
- * @param count The number of binary stream data chunks in this message.
+ * @param entries The content entries, whose offsets are contiguous.
+ * @param numEntries The number of entries in @c entries.
  * @param sequenceNumber The sequence number associated with this message.
- * @return @c true if the message was handled or @c false if a failure occurred.
+ * @return @c true if the run was handled or @c false if a failure occurred.
  * An @c MALFORMED_MESSAGE @c ExceptionEncountered event should be sent in this
  * case.
  */
-static bool handleSpeakerTopicContentTypeEntryLocked(
-    AiaSpeakerManager_t* speakerManager, const uint8_t* data, size_t length,
-    AiaBinaryMessageCount_t count, AiaSequenceNumber_t sequenceNumber );
+static bool handleSpeakerTopicContentRunLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, AiaSequenceNumber_t sequenceNumber );
+
+/**
+ * Counts the leading content entries which can be written to the speaker buffer
+ * as one run, i.e. whose offsets follow on from each other and whose audio
+ * fits in the speaker buffer.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param entries The entries, the first of which is a content entry.
+ * @param numEntries The number of entries in @c entries.
+ * @return The number of entries in the run, which is at least one.
+ */
+static size_t getSpeakerContentRunLengthLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries );
+
+/**
+ * Copies the audio of a run of content entries to the speaker buffer. A run of
+ * several entries is gathered into a single reservation of the buffer.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param entries The content entries of the run.
+ * @param numEntries The number of entries in @c entries.
+ * @param skipBytes The number of leading audio bytes of the run to leave out.
+ * @param numAudioBytes The total length of the audio of the run to write,
+ * excluding @c skipBytes.
+ * @return The number of bytes written, or an @c AiaDataStreamWriterError_t if
+ * nothing was written.
+ */
+static ssize_t writeSpeakerContentRunLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, size_t skipBytes, size_t numAudioBytes );
 
 /**
  * An internal helper function used to parse marker type messages on the speaker
@@ -366,6 +1036,139 @@ static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
     AiaSpeakerManager_t* speakerManager, const uint8_t* message, size_t size,
     AiaSequenceNumber_t sequenceNumber );
 
+/**
+ * Internal helper method to handle speaker topic messages which have not been
+ * decrypted yet.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param size The size of the unencrypted Binary Stream.
+ * @param sequenceNumber The sequence number of the message.
+ * @param decrypt Used to decrypt the message.
+ * @param userData User data passed to @c decrypt.
+ * @return @c true if the message was handled or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceivedLocked(
+    AiaSpeakerManager_t* speakerManager, size_t size,
+    AiaSequenceNumber_t sequenceNumber,
+    AiaSpeakerManagerDecryptCallback_t decrypt, void* userData );
+
+/**
+ * Records that audio of a message has been written to the speaker buffer, and
+ * updates the buffer state unless a write batch is open.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param sequenceNumber The sequence number of the message.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void onSpeakerContentWrittenLocked( AiaSpeakerManager_t* speakerManager,
+                                           AiaSequenceNumber_t sequenceNumber );
+
+/**
+ * Updates the buffer state after audio has been written to the speaker buffer,
+ * sending an overrun warning if the buffer just filled up past its threshold.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param sequenceNumber The sequence number of the last message written.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void updateBufferStateAfterWriteLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSequenceNumber_t sequenceNumber );
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+/**
+ * Grows the speaker buffer by whole segments, up to @c speakerBufferSize, so
+ * that @c length bytes can be written without overwriting audio that has not
+ * been read. If memory runs out, the buffer keeps its current size.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param length The number of bytes about to be written.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void growSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager,
+                                     size_t length );
+
+/**
+ * Returns segments of the speaker buffer while the speaker is closed and the
+ * audio left fills less than a quarter of it, keeping room for twice that
+ * audio so that the buffer does not have to grow again straight away. The
+ * speaker buffer is copied to its new allocation, so this is never done while
+ * frames are being pushed.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void shrinkSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager );
+
+/**
+ * Arms @c shrinkWorker to shrink the speaker buffer once the speaker has
+ * stayed closed for @c AIA_SPEAKER_BUFFER_SHRINK_DELAY_MS, so that closing and
+ * reopening the speaker between responses does not reallocate it each time.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void scheduleSpeakerBufferShrinkLocked(
+    AiaSpeakerManager_t* speakerManager );
+#endif
+
+/**
+ * Writes the entries of a validated speaker topic message into the speaker
+ * buffer, staging any entries left in @c staged->rest in batches.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param staged The staged message. This is consumed by the call.
+ * @param sequenceNumber The sequence number of the message.
+ * @return @c true if all entries were written or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool writeSpeakerTopicMessageLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSpeakerStagedMessage_t* staged,
+    AiaSequenceNumber_t sequenceNumber );
+
+/**
+ * Writes a batch of staged speaker topic entries into the speaker buffer.
+ * Consecutive content entries are coalesced into runs.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param entries The entries to write.
+ * @param numEntries The number of entries in @c entries.
+ * @param sequenceNumber The sequence number of the message.
+ * @param[in,out] index The index within the message of the first entry of @c
+ * entries. This is advanced past the entries written.
+ * @return @c true if all entries were written or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool writeSpeakerTopicEntriesLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, AiaSequenceNumber_t sequenceNumber, size_t* index );
+
+/**
+ * Writes spilled speaker topic messages back to the speaker buffer, in order,
+ * for as long as they fit. If the speaker is not open, all of them are written
+ * since old buffer contents may be overwritten.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void refillSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager );
+
+/**
+ * Writes the leading entries of a speaker topic message which fit in the free
+ * space of the speaker buffer, splitting the content entry which does not fit
+ * on a frame boundary, and records where the message must be resumed from
+ * when it is redriven.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param message Pointer to the validated Binary Stream.
+ * @param size The size of the message.
+ * @param sequenceNumber The sequence number of the message.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void acceptSpeakerTopicMessagePrefixLocked(
+    AiaSpeakerManager_t* speakerManager, const uint8_t* message, size_t size,
+    AiaSequenceNumber_t sequenceNumber );
+
 /**
  * Internal helper method to invalidate any actions due to local playback
  * stoppage.
@@ -375,6 +1178,16 @@ static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
 static void AiaSpeakerManager_InvalidateActionsLocked(
     AiaSpeakerManager_t* speakerManager );
 
+/**
+ * Internal helper method to flush the speaker pipeline on local playback
+ * stoppage, dropping everything that was due to be played after it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void AiaSpeakerManager_FlushLocked(
+    AiaSpeakerManager_t* speakerManager );
+
 /**
  * Internal helper method to update the speaker buffer state and notify the
  * observers.
@@ -416,6 +1229,118 @@ const char* AiaSpeakerManagerBufferState_ToString(
     return "";
 }
 
+/**
+ * Defines the payload segments of a @c BufferStateChanged event, whose only
+ * field is the sequence number.
+ *
+ * @param state The buffer state, as a string literal.
+ */
+/* clang-format off */
+#define BUFFER_STATE_CHANGED_SEGMENTS( state )                                \
+    {                                                                         \
+        AIA_JSON_TEMPLATE_SEGMENT(                                            \
+            "{"                                                               \
+                "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_KEY"\":{"                \
+                    "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_TOPIC_KEY"\":"       \
+                        "\""AIA_TOPIC_SPEAKER_STRING"\","                     \
+                    "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_SEQUENCE_NUMBER_KEY  \
+                        "\":" ),                                              \
+        AIA_JSON_TEMPLATE_SEGMENT(                                            \
+                "},"                                                          \
+                "\""AIA_BUFFER_STATE_CHANGED_STATE_KEY"\":\"" state "\""      \
+            "}" )                                                             \
+    }
+/* clang-format on */
+
+/** @c BufferStateChanged payload segments for each buffer state. */
+static const AiaJsonTemplateSegment_t BUFFER_STATE_UNDERRUN_SEGMENTS[] =
+    BUFFER_STATE_CHANGED_SEGMENTS( "UNDERRUN" );
+static const AiaJsonTemplateSegment_t
+    BUFFER_STATE_UNDERRUN_WARNING_SEGMENTS[] =
+        BUFFER_STATE_CHANGED_SEGMENTS( "UNDERRUN_WARNING" );
+static const AiaJsonTemplateSegment_t BUFFER_STATE_NONE_SEGMENTS[] =
+    BUFFER_STATE_CHANGED_SEGMENTS( "NONE" );
+static const AiaJsonTemplateSegment_t BUFFER_STATE_OVERRUN_WARNING_SEGMENTS[] =
+    BUFFER_STATE_CHANGED_SEGMENTS( "OVERRUN_WARNING" );
+static const AiaJsonTemplateSegment_t BUFFER_STATE_OVERRUN_SEGMENTS[] =
+    BUFFER_STATE_CHANGED_SEGMENTS( "OVERRUN" );
+
+/** @c BufferStateChanged event templates, indexed by buffer state. */
+static const AiaJsonTemplate_t BUFFER_STATE_CHANGED_TEMPLATES[] = {
+    [AIA_UNDERRUN_STATE] = { AIA_EVENTS_BUFFER_STATE_CHANGED,
+                             BUFFER_STATE_UNDERRUN_SEGMENTS, 1 },
+    [AIA_UNDERRUN_WARNING_STATE] = { AIA_EVENTS_BUFFER_STATE_CHANGED,
+                                     BUFFER_STATE_UNDERRUN_WARNING_SEGMENTS,
+                                     1 },
+    [AIA_NONE_STATE] = { AIA_EVENTS_BUFFER_STATE_CHANGED,
+                         BUFFER_STATE_NONE_SEGMENTS, 1 },
+    [AIA_OVERRUN_WARNING_STATE] = { AIA_EVENTS_BUFFER_STATE_CHANGED,
+                                    BUFFER_STATE_OVERRUN_WARNING_SEGMENTS, 1 },
+    [AIA_OVERRUN_STATE] = { AIA_EVENTS_BUFFER_STATE_CHANGED,
+                            BUFFER_STATE_OVERRUN_SEGMENTS, 1 }
+};
+
+/** @c SpeakerOpened payload segments, whose only field is the offset. */
+static const AiaJsonTemplateSegment_t SPEAKER_OPENED_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT( "{\"" AIA_SPEAKER_OPENED_OFFSET_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** @c SpeakerOpened event template. */
+static const AiaJsonTemplate_t SPEAKER_OPENED_TEMPLATE = {
+    AIA_EVENTS_SPEAKER_OPENED, SPEAKER_OPENED_SEGMENTS, 1
+};
+
+/** @c SpeakerClosed payload segments, whose only field is the offset. */
+static const AiaJsonTemplateSegment_t SPEAKER_CLOSED_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT( "{\"" AIA_SPEAKER_CLOSED_OFFSET_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** @c SpeakerClosed event template. */
+static const AiaJsonTemplate_t SPEAKER_CLOSED_TEMPLATE = {
+    AIA_EVENTS_SPEAKER_CLOSED, SPEAKER_CLOSED_SEGMENTS, 1
+};
+
+/** @c SpeakerMarkerEncountered payload segments, whose only field is the
+ * marker. */
+static const AiaJsonTemplateSegment_t SPEAKER_MARKER_ENCOUNTERED_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT(
+        "{\"" AIA_SPEAKER_MARKER_ENCOUNTERED_MARKER_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** @c SpeakerMarkerEncountered event template. */
+static const AiaJsonTemplate_t SPEAKER_MARKER_ENCOUNTERED_TEMPLATE = {
+    AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED, SPEAKER_MARKER_ENCOUNTERED_SEGMENTS,
+    1
+};
+
+/** @c VolumeChanged payload segments without an offset, whose only field is
+ * the volume. */
+static const AiaJsonTemplateSegment_t VOLUME_CHANGED_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT( "{\"" AIA_VOLUME_CHANGED_VOLUME_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** @c VolumeChanged event template without an offset. */
+static const AiaJsonTemplate_t VOLUME_CHANGED_TEMPLATE = {
+    AIA_EVENTS_VOLUME_CHANGED, VOLUME_CHANGED_SEGMENTS, 1
+};
+
+/** @c VolumeChanged payload segments with an offset, whose fields are the
+ * volume and the offset. */
+static const AiaJsonTemplateSegment_t VOLUME_CHANGED_WITH_OFFSET_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT( "{\"" AIA_VOLUME_CHANGED_VOLUME_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( ",\"" AIA_VOLUME_CHANGED_OFFSET_KEY "\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** @c VolumeChanged event template with an offset. */
+static const AiaJsonTemplate_t VOLUME_CHANGED_WITH_OFFSET_TEMPLATE = {
+    AIA_EVENTS_VOLUME_CHANGED, VOLUME_CHANGED_WITH_OFFSET_SEGMENTS, 2
+};
+
 /**
  * Generates a @c BufferStateChanged event for publishing to the @c Regulator.
  *
@@ -426,41 +1351,21 @@ const char* AiaSpeakerManagerBufferState_ToString(
 static AiaJsonMessage_t* generateBufferStateChangedEvent(
     AiaSequenceNumber_t sequenceNumber, AiaSpeakerManagerBufferState_t state )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_KEY"\":{"
-                "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_TOPIC_KEY"\":\""AIA_TOPIC_SPEAKER_STRING"\","
-                "\""AIA_BUFFER_STATE_CHANGED_MESSAGE_SEQUENCE_NUMBER_KEY"\": %"PRIu32
-            "},"
-            "\""AIA_BUFFER_STATE_CHANGED_STATE_KEY"\":\"%s\""
-        "}";
-    /* clang-format on */
-
-    const char* bufferState = AiaSpeakerManagerBufferState_ToString( state );
-    if( !bufferState )
+    if( state < AIA_UNDERRUN_STATE || state > AIA_OVERRUN_STATE )
     {
         AiaLogError( "Invalid bufferState, state=%d", state );
         return NULL;
     }
-    int numCharsRequired =
-        snprintf( NULL, 0, formatPayload, sequenceNumber, bufferState );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
-    }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  sequenceNumber, bufferState ) < 0 )
+    const uint64_t fields[] = { sequenceNumber };
+    AiaJsonMessage_t* event = AiaJsonTemplate_CreateMessage(
+        &BUFFER_STATE_CHANGED_TEMPLATES[ state ], fields );
+    if( event )
     {
-        AiaLogError( "snprintf failed" );
-        return NULL;
+        AiaMessage_SetSupersedeKey(
+            AiaJsonMessage_ToMessage( event ),
+            AIA_EVENTS_BUFFER_STATE_CHANGED_SUPERSEDE_KEY );
     }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_BUFFER_STATE_CHANGED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+    return event;
 }
 
 /**
@@ -472,29 +1377,8 @@ static AiaJsonMessage_t* generateBufferStateChangedEvent(
 static AiaJsonMessage_t* generateSpeakerOpenedEvent(
     AiaBinaryAudioStreamOffset_t offset )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_SPEAKER_OPENED_OFFSET_KEY"\":%"PRIu64
-        "}";
-    /* clang-format on */
-    int numCharsRequired = snprintf( NULL, 0, formatPayload, offset );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
-    }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  offset ) < 0 )
-    {
-        AiaLogError( "snprintf failed" );
-        return NULL;
-    }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_SPEAKER_OPENED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+    const uint64_t fields[] = { offset };
+    return AiaJsonTemplate_CreateMessage( &SPEAKER_OPENED_TEMPLATE, fields );
 }
 
 /**
@@ -506,29 +1390,8 @@ static AiaJsonMessage_t* generateSpeakerOpenedEvent(
 static AiaJsonMessage_t* generateSpeakerClosedEvent(
     AiaBinaryAudioStreamOffset_t offset )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_SPEAKER_CLOSED_OFFSET_KEY"\":%"PRIu64
-        "}";
-    /* clang-format on */
-    int numCharsRequired = snprintf( NULL, 0, formatPayload, offset );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
-    }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  offset ) < 0 )
-    {
-        AiaLogError( "snprintf failed" );
-        return NULL;
-    }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_SPEAKER_CLOSED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+    const uint64_t fields[] = { offset };
+    return AiaJsonTemplate_CreateMessage( &SPEAKER_CLOSED_TEMPLATE, fields );
 }
 
 /**
@@ -541,258 +1404,1395 @@ static AiaJsonMessage_t* generateSpeakerClosedEvent(
 static AiaJsonMessage_t* generateSpeakerMarkerEncounteredEvent(
     AiaSpeakerBinaryMarker_t marker )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_SPEAKER_MARKER_ENCOUNTERED_MARKER_KEY"\":%"PRIu32
-        "}";
-    /* clang-format on */
-    int numCharsRequired = snprintf( NULL, 0, formatPayload, marker );
-    if( numCharsRequired < 0 )
+    const uint64_t fields[] = { marker };
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    AiaJsonMessage_t* event = AiaJsonTemplate_CreateMessage(
+        &SPEAKER_MARKER_ENCOUNTERED_TEMPLATE, fields );
+    if( event )
     {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
+        AiaMessage_SetSupersedeKey(
+            AiaJsonMessage_ToMessage( event ),
+            AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED_SUPERSEDE_KEY );
     }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  marker ) < 0 )
+    return event;
+#else
+    return AiaJsonTemplate_CreateMessage( &SPEAKER_MARKER_ENCOUNTERED_TEMPLATE,
+                                          fields );
+#endif
+}
+
+/**
+ * Generates a @c VolumeChanged event without an offset for publishing to the @c
+ * Regulator.
+ *
+ * @param volume The new volume, between @c AIA_MIN_VOLUME and @c
+ * AIA_MAX_VOLUME, inclusive.
+ * @return The generated @c AiaJsonMessage_t or @c NULL on failures.
+ */
+static AiaJsonMessage_t* generateVolumeChangedEventWithoutOffset(
+    AiaJsonLongType volume )
+{
+    const uint64_t fields[] = { volume };
+    AiaJsonMessage_t* event =
+        AiaJsonTemplate_CreateMessage( &VOLUME_CHANGED_TEMPLATE, fields );
+    if( event )
     {
-        AiaLogError( "snprintf failed" );
-        return NULL;
+        AiaMessage_SetSupersedeKey( AiaJsonMessage_ToMessage( event ),
+                                    AIA_EVENTS_VOLUME_CHANGED_SUPERSEDE_KEY );
     }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+    return event;
 }
 
 /**
- * Generates a @c VolumeChanged event without an offset for publishing to the @c
+ * Generates a @c VolumeChanged event with an offset for publishing to the @c
  * Regulator.
  *
  * @param volume The new volume, between @c AIA_MIN_VOLUME and @c
  * AIA_MAX_VOLUME, inclusive.
+ * @param offset The byte offset in the speaker topic's audio stream at which
+ * the volume was changed.
  * @return The generated @c AiaJsonMessage_t or @c NULL on failures.
  */
-static AiaJsonMessage_t* generateVolumeChangedEventWithoutOffset(
-    AiaJsonLongType volume )
+static AiaJsonMessage_t* generateVolumeChangedEventWithOffset(
+    AiaJsonLongType volume, AiaBinaryAudioStreamOffset_t offset )
+{
+    const uint64_t fields[] = { volume, offset };
+    AiaJsonMessage_t* event = AiaJsonTemplate_CreateMessage(
+        &VOLUME_CHANGED_WITH_OFFSET_TEMPLATE, fields );
+    if( event )
+    {
+        AiaMessage_SetSupersedeKey( AiaJsonMessage_ToMessage( event ),
+                                    AIA_EVENTS_VOLUME_CHANGED_SUPERSEDE_KEY );
+    }
+    return event;
+}
+
+/**
+ * Closes the speaker immediately at the current offset.  This may be used by an
+ * an action corresponding to a @c CloseSpeaker directive when its offset is
+ * reached, or during a barge-in when we need to close immediately.
+ *
+ * @param manager The @c AiaSpeakerManager_t to act on.
+ */
+static void AiaSpeakerManager_CloseSpeakerLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    if( !speakerManager->currentSpeakerState.isSpeakerOpen )
+    {
+        AiaLogDebug( "Speaker not open." );
+        return;
+    }
+
+    speakerManager->currentSpeakerState.isSpeakerOpen = false;
+    speakerManager->currentSpeakerState.isSpeakerReadyForData = true;
+    speakerManager->currentSpeakerState.isBufferedSpeakerFramePending = false;
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
+    {
+        speakerManager->sinks[ i ].isReadyForData = true;
+    }
+    ++speakerManager->pushGeneration;
+    speakerManager->currentSpeakerState.currentBufferState = AIA_NONE_STATE;
+    AiaDataStreamWriter_SetPolicy( speakerManager->speakerBufferWriter,
+                                   AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE );
+    AiaBinaryAudioStreamOffset_t currentOffset = AiaDataStreamReader_Tell(
+        speakerManager->speakerBufferReader,
+        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
+    AiaJsonMessage_t* speakerClosedEvent =
+        generateSpeakerClosedEvent( currentOffset );
+    if( !AiaRegulator_Write( speakerManager->regulator,
+                             AiaJsonMessage_ToMessage( speakerClosedEvent ) ) )
+    {
+        AiaLogError( "AiaRegulator_Write failed" );
+        AiaJsonMessage_Destroy( speakerClosedEvent );
+    }
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    scheduleSpeakerBufferShrinkLocked( speakerManager );
+#endif
+    AiaLogDebug( "Playback stopped at offset=%" PRIu64, currentOffset );
+}
+
+/**
+ * Helper function used as the @c AiaActionAtSpeakerOffset_t callback to pass in
+ * when closing the speaker at a future offset.
+ *
+ * @param actionValid @c true if the speaker was closed or @c false if the
+ * future offset was invalidated.
+ * @param manager The @c AiaSpeakerManager_t to act on.
+ */
+static void AiaSpeakerManager_CloseSpeakerActionLocked( bool actionValid,
+                                                        void* manager )
+{
+    if( !actionValid )
+    {
+        return;
+    }
+    AiaSpeakerManager_CloseSpeakerLocked( manager );
+}
+
+/**
+ * Helper function used as the @c AiaActionAtSpeakerOffset_t callback to pass in
+ * when changing volume at a future offset.
+ *
+ * @param actionValid @c true if the volume was changed or @c false if the
+ * future offset was invalidated.
+ * @param volumeSlot The @c AiaSpeakerManagerVolumeDataForAction_t to act on.
+ */
+static void AiaSpeakerManager_SetVolumeActionLocked( bool actionValid,
+                                                     void* volumeSlot )
+{
+    AiaSpeakerManagerVolumeDataForAction_t* slot =
+        (AiaSpeakerManagerVolumeDataForAction_t*)volumeSlot;
+    AiaAssert( slot );
+    if( !slot )
+    {
+        AiaLogError( "Null volumeSlot" );
+        return;
+    }
+    if( actionValid )
+    {
+        AiaSpeakerManager_ChangeVolumeLocked( slot->speakerManager,
+                                              slot->volume, false );
+    }
+
+    AiaListDouble( Remove )( &slot->link );
+    AiaFree( slot );
+}
+
+/**
+ * Helper function used to update internal buffer state based on the amount of
+ * space in the audio buffer upon successful reads or writes out of the
+ * underlying audio buffer. Note that overruns and underruns should be handled
+ * separately as a part of the failure case when successful reads/writes are not
+ * able to be performed.
+ *
+ * An OVERRUN_WARNING is only entered as the buffer fills, and warnings are
+ * only cleared as the buffer moves away from them and as allowed by @c
+ * bufferStateHysteresis, so that small messages straddling a threshold do not
+ * toggle the state back and forth. UNDERRUN_WARNING events are only sent as the
+ * buffer drains, by the playback routine.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param direction Whether audio was just written to or read from the buffer.
+ * @note Must be called with @c mutex locked.
+ */
+static void updateBufferStateLocked( AiaSpeakerManager_t* speakerManager,
+                                     AiaSpeakerBufferDirection_t direction )
+{
+    size_t amountOfDataInBuffer =
+        ( AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) -
+          AiaDataStreamReader_Tell(
+              speakerManager->speakerBufferReader,
+              AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    size_t underrunWarningThreshold = speakerManager->underrunWarningThreshold;
+    size_t overrunWarningThreshold = speakerManager->overrunWarningThreshold;
+    if( speakerManager->isJitterBufferEnabled )
+    {
+        underrunWarningThreshold =
+            speakerManager->adaptiveUnderrunWarningThreshold;
+        overrunWarningThreshold =
+            speakerManager->adaptiveOverrunWarningThreshold;
+    }
+
+    AiaSpeakerManagerBufferState_t newBufferState;
+    if( amountOfDataInBuffer < underrunWarningThreshold )
+    {
+        newBufferState = AIA_UNDERRUN_WARNING_STATE;
+    }
+    else if( amountOfDataInBuffer < overrunWarningThreshold )
+    {
+        newBufferState = AIA_NONE_STATE;
+    }
+    else if( amountOfDataInBuffer <=
+             AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) )
+    {
+        newBufferState = AIA_OVERRUN_WARNING_STATE;
+    }
+    else
+    {
+        return;
+    }
+
+    AiaSpeakerManagerBufferState_t currentBufferState =
+        speakerManager->currentSpeakerState.currentBufferState;
+    if( newBufferState == AIA_OVERRUN_WARNING_STATE &&
+        currentBufferState < AIA_OVERRUN_WARNING_STATE &&
+        direction != AIA_SPEAKER_BUFFER_FILLING )
+    {
+        return;
+    }
+
+    const AiaSpeakerBufferStateHysteresisConfig_t* hysteresis =
+        &speakerManager->bufferStateHysteresis;
+    if( newBufferState == AIA_NONE_STATE &&
+        ( currentBufferState == AIA_UNDERRUN_WARNING_STATE ||
+          currentBufferState == AIA_OVERRUN_WARNING_STATE ) )
+    {
+        /* A warning is only cleared by the buffer moving away from it. */
+        if( direction != ( currentBufferState == AIA_UNDERRUN_WARNING_STATE
+                               ? AIA_SPEAKER_BUFFER_FILLING
+                               : AIA_SPEAKER_BUFFER_DRAINING ) )
+        {
+            return;
+        }
+        if( AiaClock( GetTimeMs )() -
+                speakerManager->currentSpeakerState.bufferStateEnteredMs <
+            hysteresis->minDwellMs )
+        {
+            return;
+        }
+        if( currentBufferState == AIA_UNDERRUN_WARNING_STATE &&
+            amountOfDataInBuffer - underrunWarningThreshold <
+                hysteresis->underrunWarningClearMargin )
+        {
+            return;
+        }
+        if( currentBufferState == AIA_OVERRUN_WARNING_STATE &&
+            overrunWarningThreshold - amountOfDataInBuffer <=
+                hysteresis->overrunWarningClearMargin )
+        {
+            return;
+        }
+    }
+    AiaSpeakerManager_SetBufferStateLocked( speakerManager, newBufferState );
+}
+
+/**
+ * Converts a playback duration to a number of bytes of speaker data. Each frame
+ * plays for @c getFrameDurationMs().
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param durationMs The duration to convert.
+ * @return The number of bytes, or zero if the frame size is not yet known.
+ * @note Must be called with @c mutex locked.
+ */
+static size_t msToBytesLocked( AiaSpeakerManager_t* speakerManager,
+                               uint64_t durationMs )
+{
+    return durationMs * getFrameSize( speakerManager ) /
+           getFrameDurationMs( speakerManager );
+}
+
+/**
+ * Recalculates the adaptive warning thresholds from the current jitter
+ * estimate. The underrun warning threshold covers @c minBufferMs plus @c
+ * jitterMultiplier times the jitter, capped at half of the fixed overrun
+ * warning threshold. The overrun warning threshold leaves the same jitter
+ * allowance free at the top of the buffer for bursts, but never drops below
+ * twice the underrun warning threshold.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note Must be called with @c mutex locked.
+ */
+static void updateJitterBufferThresholdsLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    size_t bufferSize = speakerManager->speakerBufferSize;
+    size_t jitterBytes = msToBytesLocked(
+        speakerManager,
+        ( (uint64_t)speakerManager->jitterBufferConfig.jitterMultiplier *
+          speakerManager->jitterSixteenthsMs ) >>
+            AIA_SPEAKER_JITTER_SHIFT );
+
+    size_t underrunWarningThreshold =
+        msToBytesLocked( speakerManager,
+                         speakerManager->jitterBufferConfig.minBufferMs ) +
+        jitterBytes;
+    if( underrunWarningThreshold > speakerManager->overrunWarningThreshold / 2 )
+    {
+        underrunWarningThreshold = speakerManager->overrunWarningThreshold / 2;
+    }
+
+    size_t overrunWarningThreshold = speakerManager->overrunWarningThreshold;
+    if( jitterBytes < bufferSize &&
+        bufferSize - jitterBytes < overrunWarningThreshold )
+    {
+        overrunWarningThreshold = bufferSize - jitterBytes;
+    }
+    if( overrunWarningThreshold < 2 * underrunWarningThreshold )
+    {
+        overrunWarningThreshold = 2 * underrunWarningThreshold;
+    }
+
+    speakerManager->adaptiveUnderrunWarningThreshold = underrunWarningThreshold;
+    speakerManager->adaptiveOverrunWarningThreshold = overrunWarningThreshold;
+}
+
+/**
+ * Updates the inter-arrival jitter estimate after a speaker message has been
+ * written to the buffer, as described in RFC 3550 section 6.4.1, and moves the
+ * adaptive warning thresholds to follow it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note Must be called with @c mutex locked.
+ */
+static void updateJitterLocked( AiaSpeakerManager_t* speakerManager )
+{
+    if( !speakerManager->isJitterBufferEnabled ||
+        !getFrameSize( speakerManager ) )
+    {
+        return;
+    }
+
+    int64_t playbackTimeMs =
+        (int64_t)( AiaDataStreamWriter_Tell(
+                       speakerManager->speakerBufferWriter ) *
+                   getFrameDurationMs( speakerManager ) /
+                   getFrameSize( speakerManager ) );
+    int64_t transitMs = (int64_t)AiaClock( GetTimeMs )() - playbackTimeMs;
+    if( speakerManager->hasLastTransit )
+    {
+        int64_t deviationMs = transitMs - speakerManager->lastTransitMs;
+        deviationMs = deviationMs < 0 ? -deviationMs : deviationMs;
+
+        /* Deviations larger than the buffer can absorb carry no more
+         * information and would take long to decay. */
+        int64_t maxDeviationMs =
+            (int64_t)( speakerManager->speakerBufferSize *
+                       getFrameDurationMs( speakerManager ) /
+                       getFrameSize( speakerManager ) );
+        deviationMs = deviationMs > maxDeviationMs ? maxDeviationMs
+                                                   : deviationMs;
+
+        speakerManager->jitterSixteenthsMs +=
+            (uint32_t)deviationMs -
+            ( speakerManager->jitterSixteenthsMs >> AIA_SPEAKER_JITTER_SHIFT );
+    }
+    speakerManager->lastTransitMs = transitMs;
+    speakerManager->hasLastTransit = true;
+
+    updateJitterBufferThresholdsLocked( speakerManager );
+}
+
+/**
+ * Checks whether enough audio has been buffered past a pending OpenSpeaker to
+ * open the speaker when the adaptive jitter buffer is enabled.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param currentWritePosition The current position of the speaker buffer
+ * writer.
+ * @return @c true if the speaker may be opened or @c false otherwise.
+ * @note Must be called with @c mutex locked.
+ */
+static bool isPrefilledLocked(
+    AiaSpeakerManager_t* speakerManager,
+    AiaBinaryAudioStreamOffset_t currentWritePosition )
+{
+    AiaBinaryAudioStreamOffset_t speakerOpenOffset =
+        speakerManager->currentSpeakerState.speakerOpenOffset;
+    size_t amountBuffered = 0;
+    if( currentWritePosition > speakerOpenOffset )
+    {
+        amountBuffered = currentWritePosition - speakerOpenOffset;
+    }
+    if( amountBuffered &&
+        amountBuffered >= speakerManager->adaptiveUnderrunWarningThreshold )
+    {
+        return true;
+    }
+    if( AiaClock( GetTimeMs )() - speakerManager->openSpeakerTimestampMs >=
+        speakerManager->jitterBufferConfig.maxPrefillMs )
+    {
+        AiaLogDebug( "Prefill timed out, amountBuffered=%zu", amountBuffered );
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Checks whether the audio at @c speakerOpenOffset is already in the speaker
+ * buffer, so that the speaker can be opened without waiting for more data.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if the speaker can be opened immediately or @c false
+ * otherwise.
+ * @note Must be called with @c mutex locked.
+ */
+static bool isOpenOffsetBufferedLocked( AiaSpeakerManager_t* speakerManager )
+{
+    AiaBinaryAudioStreamOffset_t currentWritePosition =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+    AiaBinaryAudioStreamOffset_t speakerOpenOffset =
+        speakerManager->currentSpeakerState.speakerOpenOffset;
+    if( currentWritePosition <= speakerOpenOffset ||
+        currentWritePosition - speakerOpenOffset >
+            AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) )
+    {
+        return false;
+    }
+    return !speakerManager->isJitterBufferEnabled ||
+           isPrefilledLocked( speakerManager, currentWritePosition );
+}
+
+/**
+ * Checks whether the action in slot @c first is due before the action in slot
+ * @c second.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param first Index of the first slot to compare.
+ * @param second Index of the second slot to compare.
+ * @return @c true if @c first is due before @c second or @c false otherwise.
+ * @note Must be called with @c mutex locked.
+ */
+static bool isActionBeforeLocked( AiaSpeakerManager_t* speakerManager,
+                                  uint16_t first, uint16_t second )
+{
+    const AiaSpeakerOffsetActionSlot_t* firstSlot =
+        &speakerManager->actionSlots[ first ];
+    const AiaSpeakerOffsetActionSlot_t* secondSlot =
+        &speakerManager->actionSlots[ second ];
+    if( firstSlot->offset != secondSlot->offset )
+    {
+        return firstSlot->offset < secondSlot->offset;
+    }
+    return firstSlot->sequence < secondSlot->sequence;
+}
+
+/**
+ * Places the slot index @c slotIndex at @c position in the action heap.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param position The position in the heap.
+ * @param slotIndex The slot index to place.
+ * @note Must be called with @c mutex locked.
+ */
+static void setActionHeapEntryLocked( AiaSpeakerManager_t* speakerManager,
+                                      size_t position, uint16_t slotIndex )
+{
+    speakerManager->actionHeap[ position ] = slotIndex;
+    speakerManager->actionSlots[ slotIndex ].position = position;
+}
+
+/**
+ * Moves the action at @c position towards the root of the action heap until
+ * its parent is due before it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param position The position in the heap of the action to move.
+ * @note Must be called with @c mutex locked.
+ */
+static void siftActionUpLocked( AiaSpeakerManager_t* speakerManager,
+                                size_t position )
+{
+    uint16_t slotIndex = speakerManager->actionHeap[ position ];
+    while( position > 0 )
+    {
+        size_t parent = ( position - 1 ) / 2;
+        uint16_t parentSlotIndex = speakerManager->actionHeap[ parent ];
+        if( !isActionBeforeLocked( speakerManager, slotIndex,
+                                   parentSlotIndex ) )
+        {
+            break;
+        }
+        setActionHeapEntryLocked( speakerManager, position, parentSlotIndex );
+        position = parent;
+    }
+    setActionHeapEntryLocked( speakerManager, position, slotIndex );
+}
+
+/**
+ * Moves the action at @c position away from the root of the action heap until
+ * it is due before both of its children.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param position The position in the heap of the action to move.
+ * @note Must be called with @c mutex locked.
+ */
+static void siftActionDownLocked( AiaSpeakerManager_t* speakerManager,
+                                  size_t position )
+{
+    uint16_t slotIndex = speakerManager->actionHeap[ position ];
+    for( ;; )
+    {
+        size_t child = 2 * position + 1;
+        if( child >= speakerManager->numActions )
+        {
+            break;
+        }
+        if( child + 1 < speakerManager->numActions &&
+            isActionBeforeLocked( speakerManager,
+                                  speakerManager->actionHeap[ child + 1 ],
+                                  speakerManager->actionHeap[ child ] ) )
+        {
+            ++child;
+        }
+        uint16_t childSlotIndex = speakerManager->actionHeap[ child ];
+        if( !isActionBeforeLocked( speakerManager, childSlotIndex,
+                                   slotIndex ) )
+        {
+            break;
+        }
+        setActionHeapEntryLocked( speakerManager, position, childSlotIndex );
+        position = child;
+    }
+    setActionHeapEntryLocked( speakerManager, position, slotIndex );
+}
+
+/**
+ * Returns the action which is due first.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The action which is due first, or @c NULL if there are none.
+ * @note Must be called with @c mutex locked.
+ */
+static AiaSpeakerOffsetActionSlot_t* peekActionLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    if( !speakerManager->numActions )
+    {
+        return NULL;
+    }
+    return &speakerManager->actionSlots[ speakerManager->actionHeap[ 0 ] ];
+}
+
+/**
+ * Removes the action at @c position from the action heap and returns its slot
+ * to the pool. The action is not invoked.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param position The position in the heap of the action to remove.
+ * @note Must be called with @c mutex locked.
+ */
+static void removeActionLocked( AiaSpeakerManager_t* speakerManager,
+                                size_t position )
+{
+    uint16_t slotIndex = speakerManager->actionHeap[ position ];
+    --speakerManager->numActions;
+    if( position < speakerManager->numActions )
+    {
+        setActionHeapEntryLocked(
+            speakerManager, position,
+            speakerManager->actionHeap[ speakerManager->numActions ] );
+        siftActionDownLocked( speakerManager, position );
+        siftActionUpLocked( speakerManager, position );
+    }
+
+    AiaSpeakerOffsetActionSlot_t* slot =
+        &speakerManager->actionSlots[ slotIndex ];
+    slot->action = NULL;
+    slot->userData = NULL;
+    ++slot->generation;
+    slot->position = speakerManager->freeActionSlot;
+    speakerManager->freeActionSlot = slotIndex;
+}
+
+/**
+ * Doubles the number of slots in the action pool. Must only be called when
+ * there are no free slots.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if the pool was grown or @c false otherwise.
+ * @note Must be called with @c mutex locked.
+ */
+static bool growActionPoolLocked( AiaSpeakerManager_t* speakerManager )
+{
+    size_t capacity = speakerManager->actionCapacity;
+    if( capacity >= AIA_SPEAKER_ACTION_POOL_MAX_CAPACITY )
+    {
+        AiaLogError( "Too many actions, capacity=%zu", capacity );
+        return false;
+    }
+    size_t newCapacity =
+        capacity ? 2 * capacity : AIA_SPEAKER_ACTION_POOL_INITIAL_CAPACITY;
+    if( newCapacity > AIA_SPEAKER_ACTION_POOL_MAX_CAPACITY )
+    {
+        newCapacity = AIA_SPEAKER_ACTION_POOL_MAX_CAPACITY;
+    }
+
+    size_t bytes = newCapacity * ( sizeof( AiaSpeakerOffsetActionSlot_t ) +
+                                   sizeof( uint16_t ) );
+    AiaSpeakerOffsetActionSlot_t* slots = AiaCalloc( 1, bytes );
+    if( !slots )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu", bytes );
+        return false;
+    }
+    uint16_t* heap = (uint16_t*)( slots + newCapacity );
+    if( capacity )
+    {
+        memcpy( slots, speakerManager->actionSlots,
+                capacity * sizeof( AiaSpeakerOffsetActionSlot_t ) );
+        memcpy( heap, speakerManager->actionHeap,
+                speakerManager->numActions * sizeof( uint16_t ) );
+    }
+    for( size_t i = capacity; i < newCapacity; ++i )
+    {
+        slots[ i ].position = i + 1;
+    }
+
+    AiaFree( speakerManager->actionSlots );
+    speakerManager->actionSlots = slots;
+    speakerManager->actionHeap = heap;
+    speakerManager->actionCapacity = newCapacity;
+    speakerManager->freeActionSlot = capacity;
+    return true;
+}
+
+/**
+ * Queues @c offset for @c dispatchWorker if an action or marker has been
+ * reached by it, and schedules @c dispatchWorker if it is not already pending.
+ * If the queue is full the offset is dropped, since it will be posted again on
+ * the next push.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param offset The current read offset of the speaker buffer.
+ * @note Must be called with @c mutex locked.
+ */
+static void postReachedOffsetLocked( AiaSpeakerManager_t* speakerManager,
+                                     AiaDataStreamIndex_t offset )
+{
+    AiaSpeakerOffsetActionSlot_t* nextAction =
+        peekActionLocked( speakerManager );
+    AiaSpeakerMarkerSlot_t* nextMarker =
+        AiaSpeakerMarkerRing_Front( &speakerManager->accumulatedMarkers );
+    if( ( !nextAction || nextAction->offset > offset ) &&
+        ( !nextMarker || nextMarker->offset >= offset ) )
+    {
+        return;
+    }
+
+    uint32_t writeIndex =
+        AiaAtomic_Load_u32( &speakerManager->reachedOffsetsWriteIndex );
+    uint32_t readIndex =
+        AiaAtomic_Load_u32( &speakerManager->reachedOffsetsReadIndex );
+    uint32_t mask = AIA_SPEAKER_REACHED_OFFSETS_CAPACITY - 1;
+    if( writeIndex != readIndex &&
+        speakerManager->reachedOffsets[ ( writeIndex - 1 ) & mask ] >=
+            offset )
+    {
+        /* Already queued. */
+    }
+    else if( writeIndex - readIndex < AIA_SPEAKER_REACHED_OFFSETS_CAPACITY )
+    {
+        speakerManager->reachedOffsets[ writeIndex & mask ] = offset;
+        AiaAtomic_Store_u32( &speakerManager->reachedOffsetsWriteIndex,
+                             writeIndex + 1 );
+    }
+
+    if( !AiaAtomicBool_Load( &speakerManager->isDispatchPending ) )
+    {
+        AiaAtomicBool_Set( &speakerManager->isDispatchPending );
+        if( !AiaTimer( Arm )( &speakerManager->cold->dispatchWorker, 0, 0 ) )
+        {
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+            AiaAtomicBool_Clear( &speakerManager->isDispatchPending );
+        }
+    }
+}
+
+/**
+ * Works out the offset of the audio being heard. Without a playout latency
+ * this is the read offset of the speaker buffer. Otherwise it trails the
+ * offset pushed last by the part of the latency which has not yet elapsed.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param now The current time.
+ * @return The offset being heard.
+ * @note Must be called with @c mutex locked.
+ */
+static AiaDataStreamIndex_t getPlayoutOffsetLocked(
+    AiaSpeakerManager_t* speakerManager, AiaTimepointMs_t now )
+{
+    uint32_t latencyMs =
+        AiaAtomic_Load_u32( &speakerManager->playoutLatencyMs );
+    if( !latencyMs || !getFrameSize( speakerManager ) )
+    {
+        return AiaDataStreamReader_Tell(
+            speakerManager->speakerBufferReader,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
+    }
+    AiaDurationMs_t elapsedMs = now - speakerManager->lastPushMs;
+    if( elapsedMs >= latencyMs )
+    {
+        return speakerManager->lastPushOffset;
+    }
+    AiaDataStreamIndex_t unheard = (AiaDataStreamIndex_t)( latencyMs -
+                                                           elapsedMs ) *
+                                   getFrameSize( speakerManager ) /
+                                   getFrameDurationMs( speakerManager );
+    return speakerManager->lastPushOffset > unheard
+               ? speakerManager->lastPushOffset - unheard
+               : 0;
+}
+
+/**
+ * Arms @c playoutWorker for when the next action or marker which has been
+ * pushed to the speaker will be heard. Actions and markers not yet pushed are
+ * left to a later push.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param now The current time.
+ * @note Must be called with @c mutex locked.
+ */
+static void armPlayoutWorkerLocked( AiaSpeakerManager_t* speakerManager,
+                                    AiaTimepointMs_t now )
+{
+    uint32_t latencyMs =
+        AiaAtomic_Load_u32( &speakerManager->playoutLatencyMs );
+    if( !latencyMs || !getFrameSize( speakerManager ) )
+    {
+        return;
+    }
+    AiaDataStreamIndex_t playoutOffset =
+        getPlayoutOffsetLocked( speakerManager, now );
+
+    /* Actions are reached at their offset, markers once it has passed. */
+    AiaDataStreamIndex_t target = speakerManager->lastPushOffset + 1;
+    AiaSpeakerOffsetActionSlot_t* nextAction =
+        peekActionLocked( speakerManager );
+    if( nextAction && nextAction->offset > playoutOffset )
+    {
+        target = nextAction->offset;
+    }
+    AiaSpeakerMarkerSlot_t* nextMarker =
+        AiaSpeakerMarkerRing_Front( &speakerManager->accumulatedMarkers );
+    if( nextMarker )
+    {
+        AiaDataStreamIndex_t markerTarget = nextMarker->offset + 1;
+        if( markerTarget > playoutOffset && markerTarget < target )
+        {
+            target = markerTarget;
+        }
+    }
+    if( target > speakerManager->lastPushOffset )
+    {
+        return;
+    }
+
+    /* Audio pushed ahead of the target is heard after it. */
+    AiaDurationMs_t aheadMs = ( speakerManager->lastPushOffset - target ) *
+                              getFrameDurationMs( speakerManager ) /
+                              getFrameSize( speakerManager );
+    AiaTimepointMs_t dueMs = speakerManager->lastPushMs + latencyMs;
+    dueMs = dueMs > aheadMs ? dueMs - aheadMs : 0;
+    if( !AiaTimer( Arm )( &speakerManager->cold->playoutWorker,
+                          dueMs > now ? dueMs - now : 0, 0 ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
+    }
+}
+
+static void AiaSpeakerManager_PlayoutRoutine( void* context )
+{
+    AiaSpeakerManager_t* speakerManager = (AiaSpeakerManager_t*)context;
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager" );
+        AiaCriticalFailure();
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+    postReachedOffsetLocked( speakerManager,
+                             getPlayoutOffsetLocked( speakerManager, now ) );
+    armPlayoutWorkerLocked( speakerManager, now );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+/**
+ * Calculates the number of frames to push per invocation of the speaker data
+ * callback.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The number of frames to push per invocation. This is always at least
+ * one.
+ * @note This method must be called while @c speakerManager->mutex is locked and
+ * only after @c frameSize has been determined.
+ */
+static size_t getFramesPerPushLocked( AiaSpeakerManager_t* speakerManager )
+{
+    if( !speakerManager->playSpeakerDataBatchCb )
+    {
+        return 1;
+    }
+    size_t framesPerPush = speakerManager->maxFramesPerPush;
+    if( speakerManager->maxBytesPerPush &&
+        speakerManager->maxBytesPerPush / getFrameSize( speakerManager ) <
+            framesPerPush )
+    {
+        framesPerPush =
+            speakerManager->maxBytesPerPush / getFrameSize( speakerManager );
+    }
+    return framesPerPush ? framesPerPush : 1;
+}
+
+/**
+ * Checks whether @c bufferedSpeakerFrame was allocated from the heap, as
+ * opposed to not allocated or using @c fixedSpeakerFrame.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if @c bufferedSpeakerFrame must be freed, else @c false.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool isBufferedSpeakerFrameAllocatedLocked(
+    const AiaSpeakerManager_t* speakerManager )
+{
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    if( speakerManager->currentSpeakerState.bufferedSpeakerFrame ==
+        speakerManager->fixedSpeakerFrame )
+    {
+        return false;
+    }
+#endif
+    return speakerManager->currentSpeakerState.bufferedSpeakerFrame != NULL;
+}
+
+/**
+ * (Re)allocates @c bufferedSpeakerFrame to hold the number of frames pushed per
+ * invocation of the speaker data callback.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true on success or @c false otherwise, in which case the previous
+ * allocation is kept.
+ * @note This method must be called while @c speakerManager->mutex is locked and
+ * only after @c frameSize has been determined.
+ */
+static bool allocateBufferedSpeakerFrameLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    size_t bytes = getFrameSize( speakerManager ) *
+                   getFramesPerPushLocked( speakerManager );
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    /* A single frame is staged without allocating. */
+    uint8_t* bufferedSpeakerFrame =
+        bytes == AIA_SPEAKER_FIXED_FRAME_SIZE
+            ? speakerManager->fixedSpeakerFrame
+            : AiaCalloc( bytes, sizeof( uint8_t ) );
+#else
+    uint8_t* bufferedSpeakerFrame = AiaCalloc( bytes, sizeof( uint8_t ) );
+#endif
+    if( !bufferedSpeakerFrame )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", bytes );
+        return false;
+    }
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    if( speakerManager->isMemoryPrefaulted )
+    {
+        if( speakerManager->currentSpeakerState.bufferedSpeakerFrame )
+        {
+            AiaMemory_Unprefault(
+                speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+                speakerManager->bufferedSpeakerFrameCapacity );
+        }
+        AiaMemory_Prefault( bufferedSpeakerFrame, bytes,
+                            speakerManager->isMemoryLocked );
+    }
+    speakerManager->bufferedSpeakerFrameCapacity = bytes;
+#endif
+    if( isBufferedSpeakerFrameAllocatedLocked( speakerManager ) )
+    {
+        AiaFree( speakerManager->currentSpeakerState.bufferedSpeakerFrame );
+    }
+    speakerManager->currentSpeakerState.bufferedSpeakerFrame =
+        bufferedSpeakerFrame;
+    return true;
+}
+
+/**
+ * Calculates how many bytes to read from the speaker buffer for the next push.
+ * This is a single frame unless batched playback is enabled, in which case it
+ * covers as many whole frames as are buffered, bounded by @c
+ * getFramesPerPushLocked() and the offset of the next pending offset action.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param currentOffset The current read offset of the speaker buffer.
+ * @return The number of bytes to read.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static size_t getReadSizeLocked( AiaSpeakerManager_t* speakerManager,
+                                 AiaBinaryAudioStreamOffset_t currentOffset )
+{
+    size_t numFrames = getFramesPerPushLocked( speakerManager );
+    if( numFrames == 1 )
+    {
+        return getFrameSize( speakerManager );
+    }
+
+    size_t framesBuffered =
+        AiaDataStreamReader_Tell(
+            speakerManager->speakerBufferReader,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) /
+        getFrameSize( speakerManager );
+    if( framesBuffered < numFrames )
+    {
+        numFrames = framesBuffered;
+    }
+
+    /* Actions which have been reached are invoked by @c dispatchWorker, so
+     * push a single frame until it has caught up. With a playout latency,
+     * pushed actions are left to @c playoutWorker instead. */
+    AiaSpeakerOffsetActionSlot_t* nextAction =
+        peekActionLocked( speakerManager );
+    if( nextAction && nextAction->offset <= currentOffset &&
+        !AiaAtomic_Load_u32( &speakerManager->playoutLatencyMs ) )
+    {
+        numFrames = 1;
+    }
+    else if( nextAction )
+    {
+        size_t framesUntilAction = ( nextAction->offset - currentOffset ) /
+                                   getFrameSize( speakerManager );
+        if( framesUntilAction < numFrames )
+        {
+            numFrames = framesUntilAction;
+        }
+    }
+
+    /* Gaps which have been reached were concealed prior to this call. */
+    AiaSpeakerGapSlot_t* nextGap =
+        AiaSpeakerGapRing_Front( &speakerManager->gaps );
+    if( nextGap )
+    {
+        size_t framesUntilGap = ( nextGap->offset - currentOffset ) /
+                                getFrameSize( speakerManager );
+        if( framesUntilGap < numFrames )
+        {
+            numFrames = framesUntilGap;
+        }
+    }
+
+    return ( numFrames ? numFrames : 1 ) * getFrameSize( speakerManager );
+}
+
+/**
+ * Fills the speaker buffer with placeholders for frames that were lost between
+ * @c localOffset and @c offset and records the gap so that audio is
+ * synthesized for it via @c concealSpeakerDataCb during playback.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param localOffset The current write offset of the speaker buffer.
+ * @param offset The offset of the next speaker content received.
+ * @return @c true if the gap was filled or @c false if it cannot be concealed.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool fillSpeakerGapLocked( AiaSpeakerManager_t* speakerManager,
+                                  AiaBinaryAudioStreamOffset_t localOffset,
+                                  AiaBinaryAudioStreamOffset_t offset )
+{
+    if( !speakerManager->concealSpeakerDataCb ||
+        !getFrameSize( speakerManager ) || offset < localOffset )
+    {
+        return false;
+    }
+    size_t length = offset - localOffset;
+    if( length % getFrameSize( speakerManager ) ||
+        length > speakerManager->speakerBufferSize )
+    {
+        AiaLogError( "Unable to conceal gap, length=%zu, frameSize=%zu",
+                     length, getFrameSize( speakerManager ) );
+        return false;
+    }
+
+    if( AiaSpeakerGapRing_IsFull( &speakerManager->gaps ) )
+    {
+        AiaLogError( "Too many gaps to conceal, gaps=%zu.",
+                     AiaSpeakerGapRing_Size( &speakerManager->gaps ) );
+        return false;
+    }
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    growSpeakerBufferLocked( speakerManager, length );
+#endif
+    /* The placeholders keep offsets aligned with the service's, so the whole
+     * gap is reserved up front rather than leaving part of it written. */
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t amountReserved = AiaDataStreamWriter_Reserve(
+        speakerManager->speakerBufferWriter, spans, length );
+    if( amountReserved <= 0 )
+    {
+        AiaLogError( "AiaDataStreamWriter_Reserve failed, status=%s",
+                     AiaDataStreamWriter_ErrorToString( amountReserved ) );
+        return false;
+    }
+    if( (size_t)amountReserved < length )
+    {
+        AiaLogError( "Not enough space to conceal gap, length=%zu, space=%zd",
+                     length, amountReserved );
+        AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, 0 );
+        return false;
+    }
+    for( size_t i = 0; i < AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS; ++i )
+    {
+        if( spans[ i ].nWords )
+        {
+            memset( spans[ i ].data, 0, spans[ i ].nWords );
+        }
+    }
+    AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, length );
+
+    AiaSpeakerGapSlot_t* gap =
+        AiaSpeakerGapRing_PushBack( &speakerManager->gaps );
+    gap->offset = localOffset;
+    gap->length = length;
+    AiaLogWarn( "Concealing speaker gap, offset=%" PRIu64 ", length=%zu",
+                gap->offset, gap->length );
+    return true;
+}
+
+/**
+ * Marks @c bufferedSpeakerFrame, which has just been filled, as not yet
+ * accepted by any speaker.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static void resetSpeakerDeliveriesLocked( AiaSpeakerManager_t* speakerManager )
+{
+    speakerManager->currentSpeakerState.isBufferedSpeakerFrameDelivered = false;
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
+    {
+        speakerManager->sinks[ i ].deliveredSize = 0;
+    }
+}
+
+/**
+ * Checks whether every speaker added with @c AiaSpeakerManager_AddSink() is
+ * ready for frames to be pushed.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return @c true if they are all ready or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool areSinksReadyLocked( AiaSpeakerManager_t* speakerManager )
+{
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
+    {
+        if( speakerManager->sinks[ i ].playSpeakerDataCb &&
+            !speakerManager->sinks[ i ].isReadyForData )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Claims frames to be synthesized via @c concealSpeakerDataCb if the read
+ * offset of the speaker buffer is within a gap, skipping the placeholders read.
+ * If the end of the gap is reached, the first frame after it is read into @c
+ * bufferedSpeakerFrame and marked as pending so that it is pushed on the next
+ * iteration.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param[in,out] currentOffset The current read offset of the speaker buffer.
+ * This is advanced past the concealed frames.
+ * @param[out] push The frames claimed for concealment, if any.
+ * @return The number of bytes concealed, or zero if the read offset is not
+ * within a gap.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static size_t concealSpeakerGapLocked( AiaSpeakerManager_t* speakerManager,
+                                       AiaDataStreamIndex_t* currentOffset,
+                                       AiaSpeakerPush_t* push )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_VOLUME_CHANGED_VOLUME_KEY"\":%"PRIu64
-        "}";
-    /* clang-format on */
-    int numCharsRequired = snprintf( NULL, 0, formatPayload, volume );
-    if( numCharsRequired < 0 )
+    AiaSpeakerGapSlot_t* gap = NULL;
+    while( ( gap = AiaSpeakerGapRing_Front( &speakerManager->gaps ) ) )
     {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
+        if( gap->offset + gap->length > *currentOffset )
+        {
+            break;
+        }
+        /* The gap has already been read past, e.g. by seeking. */
+        AiaSpeakerGapRing_PopFront( &speakerManager->gaps );
     }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  volume ) < 0 )
+    if( !gap || gap->offset > *currentOffset )
     {
-        AiaLogError( "snprintf failed" );
-        return NULL;
+        return 0;
     }
 
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_VOLUME_CHANGED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+    size_t frameCount = ( gap->offset + gap->length - *currentOffset ) /
+                        getFrameSize( speakerManager );
+    size_t framesPerPush = getFramesPerPushLocked( speakerManager );
+    if( frameCount > framesPerPush )
+    {
+        frameCount = framesPerPush;
+    }
+    size_t amountConcealed = frameCount * getFrameSize( speakerManager );
+    if( !AiaDataStreamReader_Seek(
+            speakerManager->speakerBufferReader, amountConcealed,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_AFTER_READER ) )
+    {
+        AiaLogError( "Failed to seek past gap, amountConcealed=%zu",
+                     amountConcealed );
+        return 0;
+    }
+    *currentOffset += amountConcealed;
+
+    push->isConcealment = true;
+    push->data = NULL;
+    push->size = 0;
+    push->frameCount = frameCount;
+    push->concealSpeakerDataCb = speakerManager->concealSpeakerDataCb;
+    push->concealSpeakerDataCbUserData =
+        speakerManager->concealSpeakerDataCbUserData;
+    if( *currentOffset == gap->offset + gap->length )
+    {
+        AiaSpeakerGapRing_PopFront( &speakerManager->gaps );
+        ssize_t amountRead = AiaDataStreamReader_Read(
+            speakerManager->speakerBufferReader,
+            speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+            getFrameSize( speakerManager ) );
+        if( amountRead == (ssize_t)getFrameSize( speakerManager ) )
+        {
+            push->data =
+                speakerManager->currentSpeakerState.bufferedSpeakerFrame;
+            push->size = amountRead;
+            speakerManager->currentSpeakerState.bufferedSpeakerFrameSize =
+                amountRead;
+            speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
+                true;
+            resetSpeakerDeliveriesLocked( speakerManager );
+        }
+    }
+    return amountConcealed;
 }
 
-/* TODO: ADSER-1742 Consolidate the above and below function using variadic
- * arguments. */
-
 /**
- * Generates a @c VolumeChanged event with an offset for publishing to the @c
- * Regulator.
+ * Claims the contents of @c bufferedSpeakerFrame for pushing to the speaker.
  *
- * @param volume The new volume, between @c AIA_MIN_VOLUME and @c
- * AIA_MAX_VOLUME, inclusive.
- * @param offset The byte offset in the speaker topic's audio stream at which
- * the volume was changed.
- * @return The generated @c AiaJsonMessage_t or @c NULL on failures.
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param[out] push The frames claimed.
+ * @note This method must be called while @c speakerManager->mutex is locked.
  */
-static AiaJsonMessage_t* generateVolumeChangedEventWithOffset(
-    AiaJsonLongType volume, AiaBinaryAudioStreamOffset_t offset )
+static void claimBufferedSpeakerFrameLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSpeakerPush_t* push )
 {
-    static const char* formatPayload =
-        /* clang-format off */
-        "{"
-            "\""AIA_VOLUME_CHANGED_VOLUME_KEY"\":%"PRIu64","
-            "\""AIA_VOLUME_CHANGED_OFFSET_KEY"\":%"PRIu64
-        "}";
-    /* clang-format on */
-    int numCharsRequired = snprintf( NULL, 0, formatPayload, volume, offset );
-    if( numCharsRequired < 0 )
-    {
-        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
-        return NULL;
-    }
-    char fullPayloadBuffer[ numCharsRequired + 1 ];
-    if( snprintf( fullPayloadBuffer, numCharsRequired + 1, formatPayload,
-                  volume, offset ) < 0 )
+    push->isConcealment = false;
+    push->data = speakerManager->currentSpeakerState.bufferedSpeakerFrame;
+    push->size = speakerManager->currentSpeakerState.bufferedSpeakerFrameSize;
+    push->frameCount = ( push->size + getFrameSize( speakerManager ) - 1 ) /
+                       getFrameSize( speakerManager );
+    push->playSpeakerDataBatchCb = speakerManager->playSpeakerDataBatchCb;
+    push->playSpeakerDataBatchCbUserData =
+        speakerManager->playSpeakerDataBatchCbUserData;
+    push->isPrimaryDelivered =
+        speakerManager->currentSpeakerState.isBufferedSpeakerFrameDelivered;
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
     {
-        AiaLogError( "snprintf failed" );
-        return NULL;
+        const AiaSpeakerSink_t* sink = &speakerManager->sinks[ i ];
+        push->sinks[ i ].playSpeakerDataCb = sink->playSpeakerDataCb;
+        push->sinks[ i ].playSpeakerDataCbUserData =
+            sink->playSpeakerDataCbUserData;
+        push->sinks[ i ].generation = sink->generation;
+        push->sinks[ i ].readyCount = sink->readyCount;
+        push->sinks[ i ].deliveredSize = sink->deliveredSize;
     }
-
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
-        AIA_EVENTS_VOLUME_CHANGED, NULL, fullPayloadBuffer );
-    return jsonMessage;
+#ifdef AIA_ENABLE_TRACE
+    push->traceOffset = AiaDataStreamReader_Tell(
+                            speakerManager->speakerBufferReader,
+                            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) -
+                        push->size;
+#endif
 }
 
 /**
- * Closes the speaker immediately at the current offset.  This may be used by an
- * an action corresponding to a @c CloseSpeaker directive when its offset is
- * reached, or during a barge-in when we need to close immediately.
+ * Hands claimed frames to the speaker.
  *
- * @param manager The @c AiaSpeakerManager_t to act on.
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param push The frames to hand over.
+ * @return @c true if the speaker accepted the data or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is not
+ * locked, so that decoding and playback in the platform callbacks do not hold
+ * up inbound speaker messages.
  */
-static void AiaSpeakerManager_CloseSpeakerLocked(
-    AiaSpeakerManager_t* speakerManager )
+static bool deliverSpeakerPush( AiaSpeakerManager_t* speakerManager,
+                                AiaSpeakerPush_t* push )
 {
-    if( !speakerManager->currentSpeakerState.isSpeakerOpen )
+    if( push->isConcealment )
     {
-        AiaLogDebug( "Speaker not open." );
-        return;
+        return push->concealSpeakerDataCb(
+            getFrameSize( speakerManager ), push->frameCount, push->data,
+            push->concealSpeakerDataCbUserData );
     }
 
-    speakerManager->currentSpeakerState.isSpeakerOpen = false;
-    speakerManager->currentSpeakerState.isSpeakerReadyForData = true;
-    speakerManager->currentSpeakerState.isBufferedSpeakerFramePending = false;
-    speakerManager->currentSpeakerState.currentBufferState = AIA_NONE_STATE;
-    AiaDataStreamWriter_SetPolicy( speakerManager->speakerBufferWriter,
-                                   AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE );
-    AiaBinaryAudioStreamOffset_t currentOffset = AiaDataStreamReader_Tell(
-        speakerManager->speakerBufferReader,
-        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
-    AiaJsonMessage_t* speakerClosedEvent =
-        generateSpeakerClosedEvent( currentOffset );
-    if( !AiaRegulator_Write( speakerManager->regulator,
-                             AiaJsonMessage_ToMessage( speakerClosedEvent ) ) )
+    AiaTrace_Begin( AIA_TRACE_SPEAKER_PLAY, AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                    push->traceOffset );
+    if( push->isPrimaryDelivered )
     {
-        AiaLogError( "AiaRegulator_Write failed" );
-        AiaJsonMessage_Destroy( speakerClosedEvent );
+        /* Already accepted while an added speaker rejected it. */
     }
-    AiaLogDebug( "Playback stopped at offset=%" PRIu64, currentOffset );
+    else if( !push->playSpeakerDataBatchCb )
+    {
+        push->isPrimaryDelivered = speakerManager->playSpeakerDataCb(
+            push->data, push->size, speakerManager->playSpeakerDataCbUserData );
+    }
+    else
+    {
+        push->isPrimaryDelivered = push->playSpeakerDataBatchCb(
+            push->data, push->size, push->frameCount,
+            push->playSpeakerDataBatchCbUserData );
+    }
+    bool accepted = push->isPrimaryDelivered;
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
+    {
+        AiaSpeakerPushSink_t* sink = &push->sinks[ i ];
+        if( !sink->playSpeakerDataCb )
+        {
+            continue;
+        }
+        while( sink->deliveredSize < push->size )
+        {
+            size_t size = AiaMin( getFrameSize( speakerManager ),
+                                  push->size - sink->deliveredSize );
+            if( !sink->playSpeakerDataCb( push->data + sink->deliveredSize,
+                                          size,
+                                          sink->playSpeakerDataCbUserData ) )
+            {
+                accepted = false;
+                break;
+            }
+            sink->deliveredSize += size;
+        }
+    }
+    AiaTrace_End( AIA_TRACE_SPEAKER_PLAY, AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN,
+                  push->traceOffset );
+    return accepted;
 }
 
 /**
- * Helper function used as the @c AiaActionAtSpeakerOffset_t callback to pass in
- * when closing the speaker at a future offset.
+ * Records how much of a push each speaker accepted, and marks speakers which
+ * rejected it as not ready unless they became ready again meanwhile.
  *
- * @param actionValid @c true if the speaker was closed or @c false if the
- * future offset was invalidated.
- * @param manager The @c AiaSpeakerManager_t to act on.
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param push The frames handed over.
+ * @return @c true if every speaker still added has accepted all of @c
+ * bufferedSpeakerFrame, or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
  */
-static void AiaSpeakerManager_CloseSpeakerActionLocked( bool actionValid,
-                                                        void* manager )
+static bool completeSinkDeliveriesLocked( AiaSpeakerManager_t* speakerManager,
+                                          const AiaSpeakerPush_t* push )
 {
-    if( !actionValid )
+    speakerManager->currentSpeakerState.isBufferedSpeakerFrameDelivered =
+        push->isPrimaryDelivered;
+    bool isDelivered = true;
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
     {
-        return;
+        AiaSpeakerSink_t* sink = &speakerManager->sinks[ i ];
+        if( !sink->playSpeakerDataCb )
+        {
+            continue;
+        }
+        const AiaSpeakerPushSink_t* pushSink = &push->sinks[ i ];
+        if( pushSink->playSpeakerDataCb &&
+            pushSink->generation == sink->generation )
+        {
+            sink->deliveredSize = pushSink->deliveredSize;
+            if( pushSink->deliveredSize < push->size &&
+                pushSink->readyCount == sink->readyCount )
+            {
+                sink->isReadyForData = false;
+            }
+        }
+        if( sink->deliveredSize <
+            speakerManager->currentSpeakerState.bufferedSpeakerFrameSize )
+        {
+            isDelivered = false;
+        }
     }
-    AiaSpeakerManager_CloseSpeakerLocked( manager );
+    return isDelivered;
 }
 
 /**
- * Helper function used as the @c AiaActionAtSpeakerOffset_t callback to pass in
- * when changing volume at a future offset.
+ * Updates the buffered-frame retry state once claimed frames have been handed
+ * to the speaker. If the speaker rejected played frames, they stay in @c
+ * bufferedSpeakerFrame to be pushed again once the speaker is ready. If more
+ * than one frame was pushed, the next iteration of @c speakerWorker is
+ * deferred by their playback duration.
  *
- * @param actionValid @c true if the volume was changed or @c false if the
- * future offset was invalidated.
- * @param volumeSlot The @c AiaSpeakerManagerVolumeDataForAction_t to act on.
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param push The frames handed over.
+ * @param accepted Whether the speaker accepted them.
+ * @return The number of frames the speaker accepted.
+ * @note This method must be called while @c speakerManager->mutex is locked.
  */
-static void AiaSpeakerManager_SetVolumeActionLocked( bool actionValid,
-                                                     void* volumeSlot )
+static size_t completeSpeakerPushLocked( AiaSpeakerManager_t* speakerManager,
+                                         const AiaSpeakerPush_t* push,
+                                         bool accepted )
 {
-    AiaSpeakerManagerVolumeDataForAction_t* slot =
-        (AiaSpeakerManagerVolumeDataForAction_t*)volumeSlot;
-    AiaAssert( slot );
-    if( !slot )
+    if( push->generation != speakerManager->pushGeneration )
     {
-        AiaLogError( "Null volumeSlot" );
-        return;
+        /* The speaker was closed while the frames were handed over. */
+        return 0;
     }
-    if( actionValid )
+    if( push->isConcealment )
     {
-        AiaSpeakerManager_ChangeVolumeLocked( slot->speakerManager,
-                                              slot->volume );
+        if( !accepted )
+        {
+            AiaLogWarn( "Failed to conceal frames, frameCount=%zu",
+                        push->frameCount );
+        }
     }
-
-    AiaListDouble( Remove )( &slot->link );
-    AiaFree( slot );
-}
-
-/**
- * Helper function used to update internal buffer state based on the amount of
- * space in the audio buffer upon successful reads or writes out of the
- * underlying audio buffer. Note that overruns and underruns should be handled
- * separately as a part of the failure case when successful reads/writes are not
- * able to be performed.
- *
- * @param speakerManager The @c AiaSpeakerManager_t to act on.
- * @note Must be called with @c mutex locked.
- */
-static void updateBufferStateLocked( AiaSpeakerManager_t* speakerManager )
-{
-    size_t amountOfDataInBuffer =
-        ( AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) -
-          AiaDataStreamReader_Tell(
-              speakerManager->speakerBufferReader,
-              AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
-    if( amountOfDataInBuffer < speakerManager->underrunWarningThreshold )
+    else if( !completeSinkDeliveriesLocked( speakerManager, push ) ||
+             !accepted )
     {
-        AiaSpeakerManager_SetBufferStateLocked( speakerManager,
-                                                AIA_UNDERRUN_WARNING_STATE );
+        speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
+            true;
+        if( !push->isPrimaryDelivered &&
+            push->readyCount == speakerManager->speakerReadyCount )
+        {
+            speakerManager->currentSpeakerState.isSpeakerReadyForData = false;
+        }
+        return 0;
     }
-    else if( amountOfDataInBuffer < speakerManager->overrunWarningThreshold )
+    else
     {
-        AiaSpeakerManager_SetBufferStateLocked( speakerManager,
-                                                AIA_NONE_STATE );
+        speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
+            false;
     }
-    else if( amountOfDataInBuffer <=
-             AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) )
+
+    if( push->frameCount > 1 &&
+        !AiaRealtimeTimer( Arm )(
+            &speakerManager->speakerWorker,
+            push->frameCount * getFrameDurationMs( speakerManager ),
+            getFrameDurationMs( speakerManager ) ) )
     {
-        AiaSpeakerManager_SetBufferStateLocked( speakerManager,
-                                                AIA_OVERRUN_WARNING_STATE );
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
     }
+    return push->frameCount;
 }
 
-static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
+static size_t AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
     AiaSpeakerManager_t* speakerManager )
+{
+    AiaSpeakerPush_t push;
+    if( !AiaSpeakerManager_ClaimSpeakerPushLocked( speakerManager, &push ) )
+    {
+        return 0;
+    }
+    push.generation = speakerManager->pushGeneration;
+    push.readyCount = speakerManager->speakerReadyCount;
+
+    speakerManager->isPushInFlight = true;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    bool accepted = deliverSpeakerPush( speakerManager, &push );
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->isPushInFlight = false;
+
+    return completeSpeakerPushLocked( speakerManager, &push, accepted );
+}
+
+static bool AiaSpeakerManager_ClaimSpeakerPushLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSpeakerPush_t* push )
 {
     AiaDataStreamIndex_t currentOffset = AiaDataStreamReader_Tell(
         speakerManager->speakerBufferReader,
         AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
 
-    AiaListDouble( Link_t )* actionLink = NULL;
-    while(
-        ( actionLink =
-              AiaListDouble( PeekHead )( &speakerManager->offsetActions ) ) &&
-        ( (AiaSpeakerOffsetActionSlot_t*)actionLink )->offset <= currentOffset )
-    {
-        AiaSpeakerOffsetActionSlot_t* actionInfo =
-            ( (AiaSpeakerOffsetActionSlot_t*)actionLink );
-        AiaLogInfo( "Action reached, offset=%" PRIu64, actionInfo->offset );
-        actionInfo->action( true, actionInfo->userData );
-        AiaListDouble( Remove )( actionLink );
-        AiaFree( actionInfo );
-    }
-    actionLink = NULL;
+    postReachedOffsetLocked( speakerManager,
+                             getPlayoutOffsetLocked( speakerManager, now ) );
 
-    if( !speakerManager->currentSpeakerState.isSpeakerReadyForData )
+    if( !speakerManager->currentSpeakerState.isSpeakerReadyForData ||
+        !areSinksReadyLocked( speakerManager ) )
     {
-        return;
+        return false;
     }
     if( !speakerManager->currentSpeakerState.isSpeakerOpen &&
         !speakerManager->currentSpeakerState.pendingOpenSpeaker )
     {
         /* No-op */
-        return;
+        return false;
     }
     else if( !speakerManager->currentSpeakerState.isSpeakerOpen &&
              speakerManager->currentSpeakerState.pendingOpenSpeaker )
@@ -813,7 +2813,12 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
                 "Seeking to overrun offset, offset=%" PRIu64,
                 speakerManager->currentSpeakerState.speakerOpenOffset );
             /* TODO: ADSER-1532 Close the AIS connection */
-            return;
+            return false;
+        }
+        if( speakerManager->isJitterBufferEnabled &&
+            !isPrefilledLocked( speakerManager, currentWritePosition ) )
+        {
+            return false;
         }
         if( !AiaDataStreamReader_Seek(
                 speakerManager->speakerBufferReader,
@@ -826,7 +2831,7 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
             AiaLogError(
                 "Failed to seek to offset, offset=%" PRIu64,
                 speakerManager->currentSpeakerState.speakerOpenOffset );
-            return;
+            return false;
         }
 
         currentOffset = AiaDataStreamReader_Tell(
@@ -837,15 +2842,30 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
             AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING );
     }
 
+    /* The staging buffer may have been released by
+     * AiaSpeakerManager_TrimMemory() while the speaker was closed. */
+    if( getFrameSize( speakerManager ) &&
+        !speakerManager->currentSpeakerState.bufferedSpeakerFrame &&
+        !allocateBufferedSpeakerFrameLocked( speakerManager ) )
+    {
+        return false;
+    }
+
+    /* Number of bytes claimed for the speaker during this iteration. */
+    size_t amountPushed = 0;
     if( !speakerManager->currentSpeakerState.isBufferedSpeakerFramePending )
     {
-        /* NOTE: Frame sizes are pretty small (~160 bytes) so there is minimal
-         * risk of blowing out the stack here. However, if this grows in the
-         * future, we should consider alternative places to store the frame. */
-        uint8_t speakerFrame[ speakerManager->frameSize ];
-        ssize_t amountRead =
-            AiaDataStreamReader_Read( speakerManager->speakerBufferReader,
-                                      speakerFrame, speakerManager->frameSize );
+        /* Audio is synthesized in place of lost frames rather than read. */
+        amountPushed =
+            concealSpeakerGapLocked( speakerManager, &currentOffset, push );
+    }
+    if( !amountPushed &&
+        !speakerManager->currentSpeakerState.isBufferedSpeakerFramePending )
+    {
+        ssize_t amountRead = AiaDataStreamReader_Read(
+            speakerManager->speakerBufferReader,
+            speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+            getReadSizeLocked( speakerManager, currentOffset ) );
         currentOffset = AiaDataStreamReader_Tell(
             speakerManager->speakerBufferReader,
             AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
@@ -859,7 +2879,7 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
         {
             /* TODO: ADSER-1532 Close connection and tear down once connection
              * component is finished. */
-            return;
+            return false;
         }
         else if( amountRead == AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN )
         {
@@ -867,7 +2887,7 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
             /* The OVERRUN buffer state changed event is sent on writing inbound
              * messages to the buffer. This should not happen since we set the
              * write policy to ALL_OR_NOTHING above. */
-            return;
+            return false;
         }
         else if( amountRead == AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK )
         {
@@ -894,26 +2914,19 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
                 AiaSpeakerManager_SetBufferStateLocked( speakerManager,
                                                         AIA_UNDERRUN_STATE );
             }
-            return;
+            return false;
         }
         else
         {
             AiaSpeakerManagerBufferState_t previousBufferState =
                 speakerManager->currentSpeakerState.currentBufferState;
-            updateBufferStateLocked( speakerManager );
+            updateBufferStateLocked( speakerManager,
+                                     AIA_SPEAKER_BUFFER_DRAINING );
             if( speakerManager->currentSpeakerState.isSpeakerOpen &&
                 speakerManager->currentSpeakerState.currentBufferState ==
                     AIA_UNDERRUN_WARNING_STATE &&
                 previousBufferState > AIA_UNDERRUN_WARNING_STATE )
             {
-                /* TODO: ADSER-1587 We should only send this when draining the
-                 * buffer rather than as we're filling it as well. */
-                /* TODO: ADSER-1588 Add more fine grained tuning to ensure we
-                 * send this when we've definitely dropped below the threshold -
-                 * this could result in repeated sending of this event in the
-                 * case of extremely small messages continuously straddling the
-                 * threshold.
-                 */
                 AiaJsonMessage_t* underrunWarningEvent =
                     generateBufferStateChangedEvent(
                         speakerManager->lastSpeakerSequenceNumberProcessed,
@@ -928,42 +2941,31 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
             }
         }
 
-        if( !speakerManager->playSpeakerDataCb(
-                speakerFrame, amountRead,
-                speakerManager->playSpeakerDataCbUserData ) )
-        {
-            memcpy( speakerManager->currentSpeakerState.bufferedSpeakerFrame,
-                    speakerFrame, speakerManager->frameSize );
-            speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
-                true;
-            speakerManager->currentSpeakerState.isSpeakerReadyForData = false;
-        }
+        speakerManager->currentSpeakerState.bufferedSpeakerFrameSize =
+            amountRead;
+        resetSpeakerDeliveriesLocked( speakerManager );
+        amountPushed = amountRead;
+        claimBufferedSpeakerFrameLocked( speakerManager, push );
     }
-    else
+    else if( !amountPushed )
     {
-        if( !speakerManager->playSpeakerDataCb(
-                speakerManager->currentSpeakerState.bufferedSpeakerFrame,
-                speakerManager->frameSize,
-                speakerManager->playSpeakerDataCbUserData ) )
-        {
-            speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
-                true;
-            speakerManager->currentSpeakerState.isSpeakerReadyForData = false;
-        }
-        else
-        {
-            speakerManager->currentSpeakerState.isBufferedSpeakerFramePending =
-                false;
-        }
+        amountPushed =
+            speakerManager->currentSpeakerState.bufferedSpeakerFrameSize;
+        claimBufferedSpeakerFrameLocked( speakerManager, push );
     }
 
     speakerManager->currentSpeakerState.isSpeakerOpen = true;
     if( speakerManager->currentSpeakerState.pendingOpenSpeaker )
     {
         AiaBinaryAudioStreamOffset_t speakerOpenedOffset =
-            currentOffset - speakerManager->frameSize;
+            currentOffset - amountPushed;
         AiaLogDebug( "Speaker opened, offset=%" PRIu64, speakerOpenedOffset );
         speakerManager->currentSpeakerState.pendingOpenSpeaker = false;
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+        AiaHistogram_Record(
+            &speakerManager->cold->openToFirstFrameMs,
+            (uint32_t)( now - speakerManager->openSpeakerTimestampMs ) );
+#endif
         AiaJsonMessage_t* speakerOpenedEvent =
             generateSpeakerOpenedEvent( speakerOpenedOffset );
         if( !AiaRegulator_Write(
@@ -975,28 +2977,12 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
         }
     }
 
-    AiaListDouble( Link_t )* link = NULL;
-
-    while( ( link = AiaListDouble( PeekHead )(
-                 &speakerManager->accumulatedMarkers ) ) &&
-           ( (AiaSpeakerMarkerSlot_t*)link )->offset < currentOffset )
-    {
-        AiaLogDebug( "Marker reached, marker=%" PRIu32,
-                     ( (AiaSpeakerMarkerSlot_t*)link )->marker );
-        AiaJsonMessage_t* speakerMarkerEncounteredEvent =
-            generateSpeakerMarkerEncounteredEvent(
-                ( (AiaSpeakerMarkerSlot_t*)link )->marker );
-        if( !AiaRegulator_Write(
-                speakerManager->regulator,
-                AiaJsonMessage_ToMessage( speakerMarkerEncounteredEvent ) ) )
-        {
-            AiaLogError( "AiaRegulator_Write failed" );
-            AiaJsonMessage_Destroy( speakerMarkerEncounteredEvent );
-        }
-        AiaListDouble( RemoveHead )( &speakerManager->accumulatedMarkers );
-        AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-        AiaFree( slot );
-    }
+    speakerManager->lastPushOffset = currentOffset;
+    speakerManager->lastPushMs = now;
+    postReachedOffsetLocked( speakerManager,
+                             getPlayoutOffsetLocked( speakerManager, now ) );
+    armPlayoutWorkerLocked( speakerManager, now );
+    return true;
 }
 
 static void AiaSpeakerManager_PlaySpeakerDataRoutine( void* context )
@@ -1010,19 +2996,27 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutine( void* context )
         return;
     }
     AiaMutex( Lock )( &speakerManager->mutex );
+    if( speakerManager->isPushInFlight )
+    {
+        /* An overlapping run is handing frames to the speaker and will carry
+         * on from where they end. */
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return;
+    }
 #ifdef AIA_ENABLE_ALERTS
     if( speakerManager->currentSpeakerState.shouldStartOfflineAlertPlayback &&
         !AiaSpeakerManager_CanSpeakerStreamLocked( speakerManager ) )
     {
         if( !AiaSpeakerManager_ChangeVolumeLocked(
                 speakerManager,
-                speakerManager->currentSpeakerState.offlineAlertVolume ) )
+                speakerManager->currentSpeakerState.offlineAlertVolume,
+                false ) )
         {
             AiaLogWarn( "Failed to set volume for offline alert playback" );
         }
-        if( !speakerManager->playOfflineAlertCb(
+        if( !speakerManager->cold->playOfflineAlertCb(
                 speakerManager->currentSpeakerState.alertToPlay,
-                speakerManager->playOfflineAlertCbUserData ) )
+                speakerManager->cold->playOfflineAlertCbUserData ) )
         {
             AiaLogDebug( "Failed to play offline alert data" );
         }
@@ -1035,24 +3029,165 @@ static void AiaSpeakerManager_PlaySpeakerDataRoutine( void* context )
         AiaMutex( Unlock )( &speakerManager->mutex );
         return;
     }
-#endif
-#ifdef AIA_ENABLE_ALERTS
-    /* Stop offline alert playback if it has already been started */
-    if( !speakerManager->currentSpeakerState.shouldStartOfflineAlertPlayback &&
-        AiaSpeakerManager_CanSpeakerStreamLocked( speakerManager ) )
+#endif
+#ifdef AIA_ENABLE_ALERTS
+    /* Stop offline alert playback if it has already been started */
+    if( !speakerManager->currentSpeakerState.shouldStartOfflineAlertPlayback &&
+        AiaSpeakerManager_CanSpeakerStreamLocked( speakerManager ) )
+    {
+        if( !speakerManager->cold->stopOfflineAlertCb(
+                speakerManager->cold->stopOfflineAlertCbUserData ) )
+        {
+            AiaLogDebug( "Failed to stop offline alert" );
+            AiaMutex( Unlock )( &speakerManager->mutex );
+            return;
+        }
+        AiaSpeakerManager_StopOfflineAlertLocked( speakerManager );
+    }
+#endif
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+    size_t framesPushed =
+        AiaSpeakerManager_PlaySpeakerDataRoutineLocked( speakerManager );
+    if( !framesPushed )
+    {
+        speakerManager->nextPushDueMs = 0;
+    }
+    else
+    {
+        AiaDurationMs_t frameDurationMs = getFrameDurationMs( speakerManager );
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+        /* Runs a whole frame period behind missed their deadline. */
+        AiaOverloadGovernor_ReportTaskRun(
+            AIA_OVERLOAD_TASK_SPEAKER_PUSH,
+            speakerManager->nextPushDueMs &&
+                now >= speakerManager->nextPushDueMs + frameDurationMs );
+#endif
+        if( !speakerManager->nextPushDueMs )
+        {
+            speakerManager->nextPushDueMs = now;
+        }
+        speakerManager->nextPushDueMs += framesPushed * frameDurationMs;
+
+        /* If this run was late by whole frame periods, push the frames those
+         * periods were due so that playback does not fall behind real time. */
+        size_t catchUpFrames = 0;
+        while( speakerManager->nextPushDueMs <= now &&
+               catchUpFrames < AIA_SPEAKER_MAX_CATCH_UP_FRAMES &&
+               ( framesPushed = AiaSpeakerManager_PlaySpeakerDataRoutineLocked(
+                     speakerManager ) ) )
+        {
+            catchUpFrames += framesPushed;
+            speakerManager->nextPushDueMs += framesPushed * frameDurationMs;
+        }
+        if( catchUpFrames )
+        {
+            AiaLogDebug( "Caught up on late frames, count=%zu", catchUpFrames );
+        }
+        if( speakerManager->nextPushDueMs <= now )
+        {
+            /* Too far behind, or out of data; start counting afresh. */
+            speakerManager->nextPushDueMs = now + frameDurationMs;
+        }
+    }
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    refillSpeakerBufferLocked( speakerManager );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+/**
+ * Sends a @c SpeakerMarkerEncountered event for each marker before @c offset,
+ * taking the speaker manager's lock for one batch of markers at a time.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param offset The offset which has been reached.
+ * @note This method must be called while @c dispatchMutex is locked.
+ */
+static void sendReachedMarkers( AiaSpeakerManager_t* speakerManager,
+                                AiaDataStreamIndex_t offset )
+{
+    AiaSpeakerMarkerSlot_t reached[ AIA_SPEAKER_MARKER_DISPATCH_BATCH ];
+    size_t numReached = 0;
+    do
+    {
+        numReached = 0;
+        AiaMutex( Lock )( &speakerManager->mutex );
+        AiaSpeakerMarkerSlot_t* slot = NULL;
+        while( numReached < AIA_SPEAKER_MARKER_DISPATCH_BATCH &&
+               ( slot = AiaSpeakerMarkerRing_Front(
+                     &speakerManager->accumulatedMarkers ) ) &&
+               slot->offset < offset )
+        {
+            reached[ numReached++ ] = *slot;
+            AiaSpeakerMarkerRing_PopFront(
+                &speakerManager->accumulatedMarkers );
+        }
+        AiaMutex( Unlock )( &speakerManager->mutex );
+
+        for( size_t i = 0; i < numReached; ++i )
+        {
+            slot = &reached[ i ];
+            AiaLogDebug( "Marker reached, marker=%" PRIu32, slot->marker );
+            AiaTrace_Begin( AIA_TRACE_SPEAKER_MARKER,
+                            AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN, slot->offset );
+            AiaJsonMessage_t* speakerMarkerEncounteredEvent =
+                generateSpeakerMarkerEncounteredEvent( slot->marker );
+            if( !AiaRegulator_Write( speakerManager->regulator,
+                                     AiaJsonMessage_ToMessage(
+                                         speakerMarkerEncounteredEvent ) ) )
+            {
+                AiaLogError( "AiaRegulator_Write failed" );
+                AiaJsonMessage_Destroy( speakerMarkerEncounteredEvent );
+            }
+            AiaTrace_End( AIA_TRACE_SPEAKER_MARKER,
+                          AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN, slot->offset );
+        }
+    } while( numReached == AIA_SPEAKER_MARKER_DISPATCH_BATCH );
+}
+
+static void AiaSpeakerManager_DispatchRoutine( void* context )
+{
+    AiaSpeakerManager_t* speakerManager = (AiaSpeakerManager_t*)context;
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager" );
+        AiaCriticalFailure();
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->cold->dispatchMutex );
+    /* Cleared before draining so that offsets posted from here on schedule
+     * another run. */
+    AiaAtomicBool_Clear( &speakerManager->isDispatchPending );
+
+    uint32_t mask = AIA_SPEAKER_REACHED_OFFSETS_CAPACITY - 1;
+    uint32_t readIndex =
+        AiaAtomic_Load_u32( &speakerManager->reachedOffsetsReadIndex );
+    while( readIndex !=
+           AiaAtomic_Load_u32( &speakerManager->reachedOffsetsWriteIndex ) )
     {
-        if( !speakerManager->stopOfflineAlertCb(
-                speakerManager->stopOfflineAlertCbUserData ) )
+        AiaDataStreamIndex_t offset =
+            speakerManager->reachedOffsets[ readIndex & mask ];
+        AiaAtomic_Store_u32( &speakerManager->reachedOffsetsReadIndex,
+                             ++readIndex );
+
+        /* Actions are documented to run with the speaker manager locked. */
+        AiaMutex( Lock )( &speakerManager->mutex );
+        AiaSpeakerOffsetActionSlot_t* actionInfo = NULL;
+        while( ( actionInfo = peekActionLocked( speakerManager ) ) &&
+               actionInfo->offset <= offset )
         {
-            AiaLogDebug( "Failed to stop offline alert" );
-            AiaMutex( Unlock )( &speakerManager->mutex );
-            return;
+            AiaLogInfo( "Action reached, offset=%" PRIu64,
+                        actionInfo->offset );
+            AiaActionAtSpeakerOffset_t action = actionInfo->action;
+            void* userData = actionInfo->userData;
+            removeActionLocked( speakerManager, 0 );
+            action( true, userData );
         }
-        AiaSpeakerManager_StopOfflineAlertLocked( speakerManager );
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        sendReachedMarkers( speakerManager, offset );
     }
-#endif
-    AiaSpeakerManager_PlaySpeakerDataRoutineLocked( speakerManager );
-    AiaMutex( Unlock )( &speakerManager->mutex );
+    AiaMutex( Unlock )( &speakerManager->cold->dispatchMutex );
 }
 
 AiaSpeakerManager_t* AiaSpeakerManager_Create(
@@ -1109,30 +3244,48 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
         return NULL;
     }
 
+    *(AiaSpeakerManagerCold_t**)&speakerManager->cold =
+        AiaCalloc( 1, sizeof( AiaSpeakerManagerCold_t ) );
+    if( !speakerManager->cold )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaSpeakerManagerCold_t ) );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
     if( !AiaMutex( Create )( &speakerManager->mutex, false ) )
     {
         AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
 
+    *(size_t*)&speakerManager->speakerBufferSize = speakerBufferSize;
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    speakerBufferSize =
+        AiaMin( speakerBufferSize, (size_t)AIA_SPEAKER_BUFFER_SEGMENT_SIZE );
+#endif
     speakerManager->speakerBufferMemory = AiaCalloc( 1, speakerBufferSize );
     if( !speakerManager->speakerBufferMemory )
     {
         AiaLogError( "AiaCalloc failed, bytes=%zu.", speakerBufferSize );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
 
     *(AiaDataStreamBuffer_t**)&speakerManager->speakerBuffer =
-        AiaDataStreamBuffer_Create( speakerManager->speakerBufferMemory,
-                                    speakerBufferSize, 1, 1 );
+        AiaDataStreamBuffer_CreateSingleReader(
+            speakerManager->speakerBufferMemory, speakerBufferSize, 1 );
     if( !speakerManager->speakerBuffer )
     {
-        AiaLogError( "AiaDataStreamBuffer_Create failed." );
+        AiaLogError( "AiaDataStreamBuffer_CreateSingleReader failed." );
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
@@ -1147,6 +3300,7 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
@@ -1162,13 +3316,19 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
 
-    AiaListDouble( Create )( &speakerManager->accumulatedMarkers );
-    AiaListDouble( Create )( &speakerManager->offsetActions );
-    AiaListDouble( Create )( &speakerManager->volumeActions );
+    AiaSpeakerMarkerRing_Init( &speakerManager->accumulatedMarkers,
+                               speakerManager->cold->markerStorage,
+                               AIA_SPEAKER_MAX_PENDING_MARKERS );
+    AiaListDouble( Create )( &speakerManager->cold->volumeActions );
+    AiaSpeakerGapRing_Init( &speakerManager->gaps,
+                            speakerManager->cold->gapStorage,
+                            AIA_SPEAKER_MAX_GAPS );
+    AiaListDouble( Create )( &speakerManager->spilledMessages );
 
     *(size_t*)&( speakerManager->overrunWarningThreshold ) =
         overrunWarningThreshold;
@@ -1178,21 +3338,23 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
         playSpeakerDataCb;
     *(void**)&speakerManager->playSpeakerDataCbUserData =
         playSpeakerDataCbUserData;
-    *(AiaSequencer_t**)&speakerManager->sequencer = sequencer;
+    *(AiaSequencer_t**)&speakerManager->cold->sequencer = sequencer;
     *(AiaRegulator_t**)&speakerManager->regulator = regulator;
-    *(AiaSetVolume_t*)&( speakerManager->setVolumeCb ) = setVolumeCb;
-    *(void**)&speakerManager->setVolumeCbUserData = setVolumeCbUserData;
-    *(AiaOfflineAlertPlayback_t*)&( speakerManager->playOfflineAlertCb ) =
+    *(AiaSetVolume_t*)&( speakerManager->cold->setVolumeCb ) = setVolumeCb;
+    *(void**)&speakerManager->cold->setVolumeCbUserData = setVolumeCbUserData;
+    speakerManager->cold->volumeCoalescing.storeDelayMs =
+        AIA_SPEAKER_VOLUME_STORE_DELAY_MS;
+    *(AiaOfflineAlertPlayback_t*)&( speakerManager->cold->playOfflineAlertCb ) =
         playOfflineAlertCb;
-    *(void**)&speakerManager->playOfflineAlertCbUserData =
+    *(void**)&speakerManager->cold->playOfflineAlertCbUserData =
         playOfflineAlertCbUserData;
-    *(AiaOfflineAlertStop_t*)&( speakerManager->stopOfflineAlertCb ) =
+    *(AiaOfflineAlertStop_t*)&( speakerManager->cold->stopOfflineAlertCb ) =
         stopOfflineAlertCb;
-    *(void**)&speakerManager->stopOfflineAlertCbUserData =
+    *(void**)&speakerManager->cold->stopOfflineAlertCbUserData =
         stopOfflineAlertCbUserData;
     *(AiaSpeakerManagerBufferStateObserver_t*)&(
-        speakerManager->notifyObserversCb ) = notifyObserversCb;
-    *(void**)&speakerManager->notifyObserversCbUserData =
+        speakerManager->cold->notifyObserversCb ) = notifyObserversCb;
+    *(void**)&speakerManager->cold->notifyObserversCbUserData =
         notifyObserversCbUserData;
 
     speakerManager->currentSpeakerState.currentBufferState = AIA_NONE_STATE;
@@ -1206,15 +3368,9 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
                      sizeof( AiaSpeakerManagerVolumeDataForAction_t ) );
         AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
-        AiaListDouble( Link_t )* link = NULL;
-        while( ( link = AiaListDouble( RemoveHead )(
-                     &speakerManager->accumulatedMarkers ) ) )
-        {
-            AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-            AiaFree( slot );
-        }
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
@@ -1234,72 +3390,158 @@ AiaSpeakerManager_t* AiaSpeakerManager_Create(
     {
         AiaLogError( "AiaSpeakerManager_InvokeActionAtOffset failed" );
         AiaFree( volumeSlot );
-        AiaListDouble( RemoveAll )( &speakerManager->offsetActions, AiaFree,
-                                    0 );
-        AiaListDouble( RemoveAll )( &speakerManager->volumeActions, AiaFree,
-                                    0 );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
         AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
-        AiaListDouble( Link_t )* link = NULL;
-        while( ( link = AiaListDouble( RemoveHead )(
-                     &speakerManager->accumulatedMarkers ) ) )
-        {
-            AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-            AiaFree( slot );
-        }
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
-    AiaListDouble( InsertTail )( &speakerManager->volumeActions,
+    AiaListDouble( InsertTail )( &speakerManager->cold->volumeActions,
                                  &volumeSlot->link );
 
-    if( !AiaTimer( Create )( &speakerManager->speakerWorker,
-                             AiaSpeakerManager_PlaySpeakerDataRoutine,
+    if( !AiaRealtimeTimer( Create )( &speakerManager->speakerWorker,
+                                     AiaSpeakerManager_PlaySpeakerDataRoutine,
+                                     speakerManager ) )
+    {
+        AiaLogError( "AiaRealtimeTimer( Create ) failed" );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
+        AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
+        AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
+        AiaFree( speakerManager->speakerBufferMemory );
+        AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
+    if( !AiaMutex( Create )( &speakerManager->cold->dispatchMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
+        AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
+        AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
+        AiaFree( speakerManager->speakerBufferMemory );
+        AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
+    if( !AiaTimer( Create )( &speakerManager->cold->dispatchWorker,
+                             AiaSpeakerManager_DispatchRoutine,
                              speakerManager ) )
     {
         AiaLogError( "AiaTimer( Create ) failed" );
-        AiaListDouble( RemoveAll )( &speakerManager->offsetActions, AiaFree,
-                                    0 );
-        AiaListDouble( RemoveAll )( &speakerManager->volumeActions, AiaFree,
-                                    0 );
+        AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
+        AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
+        AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
+        AiaFree( speakerManager->speakerBufferMemory );
+        AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
+    if( !AiaTimer( Create )( &speakerManager->cold->volumeWorker,
+                             AiaSpeakerManager_VolumeRoutine,
+                             speakerManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaTimer( Destroy )( &speakerManager->cold->dispatchWorker );
+        AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
+        AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
+        AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
+        AiaFree( speakerManager->speakerBufferMemory );
+        AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
+    if( !AiaTimer( Create )( &speakerManager->cold->playoutWorker,
+                             AiaSpeakerManager_PlayoutRoutine,
+                             speakerManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaTimer( Destroy )( &speakerManager->cold->volumeWorker );
+        AiaTimer( Destroy )( &speakerManager->cold->dispatchWorker );
+        AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
+        AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
+        AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
+        AiaFree( speakerManager->speakerBufferMemory );
+        AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
+        AiaFree( speakerManager );
+        return NULL;
+    }
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    if( !AiaTimer( Create )( &speakerManager->cold->shrinkWorker,
+                             AiaSpeakerManager_ShrinkRoutine,
+                             speakerManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaTimer( Destroy )( &speakerManager->cold->playoutWorker );
+        AiaTimer( Destroy )( &speakerManager->cold->volumeWorker );
+        AiaTimer( Destroy )( &speakerManager->cold->dispatchWorker );
+        AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
         AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
-        AiaListDouble( Link_t )* link = NULL;
-        while( ( link = AiaListDouble( RemoveHead )(
-                     &speakerManager->accumulatedMarkers ) ) )
-        {
-            AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-            AiaFree( slot );
-        }
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
+#endif
 
-    if( !AiaTimer( Arm )( &speakerManager->speakerWorker,
-                          AIA_SPEAKER_FRAME_PUSH_CADENCE_MS,
-                          AIA_SPEAKER_FRAME_PUSH_CADENCE_MS ) )
+    if( !AiaRealtimeTimer( Arm )( &speakerManager->speakerWorker,
+                                  getFrameDurationMs( speakerManager ),
+                                  getFrameDurationMs( speakerManager ) ) )
     {
         AiaLogError( "AiaTimer( Arm ) failed" );
-        AiaTimer( Destroy )( &speakerManager->speakerWorker );
-        AiaListDouble( RemoveAll )( &speakerManager->offsetActions, AiaFree,
-                                    0 );
-        AiaListDouble( RemoveAll )( &speakerManager->volumeActions, AiaFree,
-                                    0 );
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+        AiaTimer( Destroy )( &speakerManager->cold->shrinkWorker );
+#endif
+        AiaTimer( Destroy )( &speakerManager->cold->playoutWorker );
+        AiaTimer( Destroy )( &speakerManager->cold->volumeWorker );
+        AiaTimer( Destroy )( &speakerManager->cold->dispatchWorker );
+        AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+        AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+        AiaFree( speakerManager->actionSlots );
+        AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions,
+                                    AiaFree, 0 );
         AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
         AiaDataStreamBuffer_Destroy( speakerManager->speakerBuffer );
-        AiaListDouble( Link_t )* link = NULL;
-        while( ( link = AiaListDouble( RemoveHead )(
-                     &speakerManager->accumulatedMarkers ) ) )
-        {
-            AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-            AiaFree( slot );
-        }
         AiaFree( speakerManager->speakerBufferMemory );
         AiaMutex( Destroy )( &speakerManager->mutex );
+        AiaFree( speakerManager->cold );
         AiaFree( speakerManager );
         return NULL;
     }
@@ -1315,9 +3557,32 @@ void AiaSpeakerManager_Destroy( AiaSpeakerManager_t* speakerManager )
         return;
     }
 
+    /* The speaker, playout, shrink, dispatch and volume routines lock @c
+     * mutex, so it must not be held while waiting for them to finish. */
+    AiaRealtimeTimer( Destroy )( &speakerManager->speakerWorker );
+    AiaTimer( Destroy )( &speakerManager->cold->playoutWorker );
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    AiaTimer( Destroy )( &speakerManager->cold->shrinkWorker );
+#endif
+    AiaTimer( Destroy )( &speakerManager->cold->dispatchWorker );
+    AiaMutex( Destroy )( &speakerManager->cold->dispatchMutex );
+    AiaTimer( Destroy )( &speakerManager->cold->volumeWorker );
+
     AiaMutex( Lock )( &speakerManager->mutex );
 
-    AiaTimer( Destroy )( &speakerManager->speakerWorker );
+    if( speakerManager->cold->isVolumeChangedPending )
+    {
+        AiaLogDebug( "Dropping coalesced VolumeChanged event, volume=%" PRIu8,
+                     speakerManager->currentSpeakerState.currentVolume );
+    }
+#ifdef AIA_STORE_VOLUME
+    /* The settled volume is persisted now rather than lost. */
+    if( speakerManager->cold->isVolumeStorePending &&
+        !AIA_STORE_VOLUME( speakerManager->currentSpeakerState.currentVolume ) )
+    {
+        AiaLogError( "AIA_STORE_VOLUME failed" );
+    }
+#endif
 
 #ifdef AIA_ENABLE_ALERTS
     if( speakerManager->currentSpeakerState.alertToPlay )
@@ -1327,21 +3592,34 @@ void AiaSpeakerManager_Destroy( AiaSpeakerManager_t* speakerManager )
     }
 #endif
 
-    if( speakerManager->frameSize )
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    if( speakerManager->isMemoryPrefaulted )
+    {
+        if( speakerManager->currentSpeakerState.bufferedSpeakerFrame )
+        {
+            AiaMemory_Unprefault(
+                speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+                speakerManager->bufferedSpeakerFrameCapacity );
+        }
+        AiaMemory_Unprefault(
+            speakerManager->speakerBufferMemory,
+            AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) );
+    }
+#endif
+    if( isBufferedSpeakerFrameAllocatedLocked( speakerManager ) )
     {
         AiaFree( speakerManager->currentSpeakerState.bufferedSpeakerFrame );
     }
-    AiaListDouble( Link_t )* link = NULL;
-    while( ( link = AiaListDouble( RemoveHead )(
-                 &speakerManager->accumulatedMarkers ) ) )
+    AiaFree( speakerManager->actionSlots );
+    AiaListDouble( RemoveAll )( &speakerManager->cold->volumeActions, AiaFree,
+                                0 );
+    if( !AiaListDouble( IsEmpty )( &speakerManager->spilledMessages ) )
     {
-        AiaSpeakerMarkerSlot_t* slot = (AiaSpeakerMarkerSlot_t*)link;
-        AiaFree( slot );
+        speakerManager->cold->spillStore.clear(
+            speakerManager->cold->spillStore.userData );
+        AiaListDouble( RemoveAll )( &speakerManager->spilledMessages, AiaFree,
+                                    0 );
     }
-    link = NULL;
-
-    AiaListDouble( RemoveAll )( &speakerManager->offsetActions, AiaFree, 0 );
-    AiaListDouble( RemoveAll )( &speakerManager->volumeActions, AiaFree, 0 );
 
     AiaDataStreamWriter_Destroy( speakerManager->speakerBufferWriter );
     AiaDataStreamReader_Destroy( speakerManager->speakerBufferReader );
@@ -1349,40 +3627,47 @@ void AiaSpeakerManager_Destroy( AiaSpeakerManager_t* speakerManager )
     AiaFree( speakerManager->speakerBufferMemory );
     AiaMutex( Unlock )( &speakerManager->mutex );
     AiaMutex( Destroy )( &speakerManager->mutex );
+    AiaFree( speakerManager->cold );
     AiaFree( speakerManager );
 }
 
 /**
- * Helper function to validate a speaker topic message and retrieve its total
- * audio length in bytes.
+ * Helper function to validate a speaker topic message in a single pass, staging
+ * descriptors of its first entries and totalling its audio length in bytes.
  *
  * @param speakerManager The @c AiaSpeakerManager_t to act on.
  * @param sequenceNumber The sequence number of the message.
  * @param message Pointer to the unencrypted message body (without the common
- * header) i.e. the unencrypted Binary Stream. This must remain valid for the
- * duration of this call.
+ * header) i.e. the unencrypted Binary Stream. This must remain valid for as
+ * long as @c staged is used.
  * @param size The size of the message.
- * @param[out] totalAudioLength The total length of the audio bytes found in the
- * message.
+ * @param[out] staged The staged message.
  * @return @c true if the message was parsed successfully or @c false otherwise.
  * @note This method must be called while @c speakerManager->mutex is locked.
  */
-static bool
-AiaSpeakerManager_ValidateSpeakerTopicMessageAndGetTotalAudioLengthLocked(
+static bool AiaSpeakerManager_StageSpeakerTopicMessageLocked(
     AiaSpeakerManager_t* speakerManager, AiaSequenceNumber_t sequenceNumber,
-    const uint8_t* message, size_t size, size_t* totalAudioLength )
+    const uint8_t* message, size_t size, AiaSpeakerStagedMessage_t* staged )
 {
     size_t index = 0;
-    size_t totalLength = 0;
-    uint32_t bytePosition = 0;
-    while( bytePosition < size )
+    staged->numEntries = 0;
+    staged->totalAudioLength = 0;
+    AiaBinaryStreamIterator_t iterator;
+    AiaBinaryStreamIterator_Init( &iterator, message, size );
+    while( AiaBinaryStreamIterator_HasNext( &iterator ) )
     {
-        if( bytePosition + AIA_SIZE_OF_BINARY_STREAM_HEADER > size )
+        if( index == AIA_SPEAKER_MAX_STAGED_ENTRIES )
         {
-            AiaLogError(
-                "Message too small to extract binary stream header, "
-                "sequenceNumber=%" PRIu32,
-                sequenceNumber );
+            staged->rest = iterator;
+        }
+        AiaBinaryStreamEntry_t entry;
+        if( !AiaBinaryStreamIterator_Next( &iterator, &entry ) ||
+            ( entry.type == AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE &&
+              entry.length < sizeof( AiaBinaryAudioStreamOffset_t ) ) )
+        {
+            AiaLogError( "Malformed binary stream entry, "
+                         "sequenceNumber=%" PRIu32 ", index=%zu",
+                         sequenceNumber, index );
             AiaJsonMessage_t* malformedMessageEvent =
                 generateMalformedMessageExceptionEncounteredEvent(
                     sequenceNumber, index, AIA_TOPIC_SPEAKER );
@@ -1396,71 +3681,300 @@ AiaSpeakerManager_ValidateSpeakerTopicMessageAndGetTotalAudioLengthLocked(
             return false;
         }
 
-        /* TODO: ADSER-1945 Consolidate endian-specific funtionality into a
-         * utility function. */
-        AiaBinaryMessageLength_t length = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageLength_t );
-             ++i, ++bytePosition )
+        AiaLogDebug( "Parsed speaker topic message, length=%" PRIu32
+                     ", type=%" PRIu8 ", count=%" PRIu8,
+                     entry.length, entry.type, entry.count );
+
+        switch( entry.type )
         {
-            length |= message[ bytePosition ] << ( i * 8 );
+            case AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE:
+                staged->totalAudioLength +=
+                    ( entry.length - sizeof( AiaBinaryAudioStreamOffset_t ) );
+                break;
+            case AIA_BINARY_STREAM_SPEAKER_MARKER_TYPE:
+                break;
+            default:
+                AiaLogError( "Unknown binary stream type, type=%" PRIu8,
+                             entry.type );
+                return false;
         }
-
-        AiaBinaryMessageType_t type = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageType_t );
-             ++i, ++bytePosition )
+        if( index < AIA_SPEAKER_MAX_STAGED_ENTRIES )
         {
-            type |= message[ bytePosition ] << ( i * 8 );
+            staged->entries[ staged->numEntries++ ] = entry;
         }
+        ++index;
+    }
+    if( index <= AIA_SPEAKER_MAX_STAGED_ENTRIES )
+    {
+        staged->rest = iterator;
+    }
+    return true;
+}
+
+/**
+ * Returns the number of bytes that can be written to the speaker buffer without
+ * overwriting audio that has not been read.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The free space in the speaker buffer.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static size_t getSpeakerBufferSpaceLocked( AiaSpeakerManager_t* speakerManager )
+{
+    return speakerManager->speakerBufferSize -
+           ( ( AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) -
+               AiaDataStreamReader_Tell(
+                   speakerManager->speakerBufferReader,
+                   AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) ) );
+}
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+/**
+ * Returns the number of bytes written to the speaker buffer but not yet read.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @return The amount of audio buffered.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static size_t getSpeakerBufferedBytesLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    AiaDataStreamIndex_t writePosition =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+    AiaDataStreamIndex_t readPosition = AiaDataStreamReader_Tell(
+        speakerManager->speakerBufferReader,
+        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
+    return writePosition > readPosition ? writePosition - readPosition : 0;
+}
+
+/**
+ * Moves the speaker buffer to a new allocation of @c capacity bytes.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param capacity The new size of the speaker buffer in bytes.
+ * @return @c true if the buffer was resized or @c false otherwise.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool resizeSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager,
+                                       size_t capacity )
+{
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    size_t previousCapacity =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+#endif
+    void* memory = AiaCalloc( 1, capacity );
+    if( !memory )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", capacity );
+        return false;
+    }
+    if( !AiaDataStreamBuffer_Resize( speakerManager->speakerBuffer, memory,
+                                     capacity ) )
+    {
+        AiaLogError( "AiaDataStreamBuffer_Resize failed, capacity=%zu.",
+                     capacity );
+        AiaFree( memory );
+        return false;
+    }
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    if( speakerManager->isMemoryPrefaulted )
+    {
+        AiaMemory_Unprefault( speakerManager->speakerBufferMemory,
+                              previousCapacity );
+        AiaMemory_Prefault( memory, capacity, speakerManager->isMemoryLocked );
+    }
+#endif
+    AiaFree( speakerManager->speakerBufferMemory );
+    speakerManager->speakerBufferMemory = memory;
+    AiaLogDebug( "Speaker buffer resized, capacity=%zu.", capacity );
+    return true;
+}
+
+static void growSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager,
+                                     size_t length )
+{
+    size_t capacity =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+    size_t needed = getSpeakerBufferedBytesLocked( speakerManager ) + length;
+    if( needed <= capacity || capacity >= speakerManager->speakerBufferSize )
+    {
+        return;
+    }
+    size_t segments = ( needed + AIA_SPEAKER_BUFFER_SEGMENT_SIZE - 1 ) /
+                      AIA_SPEAKER_BUFFER_SEGMENT_SIZE;
+    resizeSpeakerBufferLocked(
+        speakerManager,
+        AiaMin( segments * AIA_SPEAKER_BUFFER_SEGMENT_SIZE,
+                speakerManager->speakerBufferSize ) );
+}
+
+static void shrinkSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager )
+{
+    if( speakerManager->currentSpeakerState.isSpeakerOpen ||
+        speakerManager->currentSpeakerState.pendingOpenSpeaker )
+    {
+        return;
+    }
+    size_t capacity =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+    size_t buffered = getSpeakerBufferedBytesLocked( speakerManager );
+    if( buffered >= capacity / 4 )
+    {
+        return;
+    }
+    size_t segments = ( 2 * buffered + AIA_SPEAKER_BUFFER_SEGMENT_SIZE - 1 ) /
+                      AIA_SPEAKER_BUFFER_SEGMENT_SIZE;
+    if( !segments )
+    {
+        segments = 1;
+    }
+    size_t target = AiaMin( segments * AIA_SPEAKER_BUFFER_SEGMENT_SIZE,
+                            speakerManager->speakerBufferSize );
+    if( target < capacity )
+    {
+        resizeSpeakerBufferLocked( speakerManager, target );
+    }
+}
+
+static void scheduleSpeakerBufferShrinkLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    if( AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) <=
+        AIA_SPEAKER_BUFFER_SEGMENT_SIZE )
+    {
+        return;
+    }
+    if( !AiaTimer( Arm )( &speakerManager->cold->shrinkWorker,
+                          AIA_SPEAKER_BUFFER_SHRINK_DELAY_MS, 0 ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
+    }
+}
+
+static void AiaSpeakerManager_ShrinkRoutine( void* context )
+{
+    AiaSpeakerManager_t* speakerManager = (AiaSpeakerManager_t*)context;
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    shrinkSpeakerBufferLocked( speakerManager );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+#endif
+
+/**
+ * Appends a speaker topic message to @c spillStore so that it is written to the
+ * speaker buffer once playback has made room for it.
+ *
+ * @param speakerManager The @c AiaSpeakerManager_t to act on.
+ * @param message Pointer to the validated Binary Stream.
+ * @param size The size of the message.
+ * @param sequenceNumber The sequence number of the message.
+ * @param totalAudioLength The total length of the audio bytes in the message.
+ * @return @c true if the message was spilled or @c false if it must be
+ * dropped.
+ * @note This method must be called while @c speakerManager->mutex is locked.
+ */
+static bool spillSpeakerTopicMessageLocked(
+    AiaSpeakerManager_t* speakerManager, const uint8_t* message, size_t size,
+    AiaSequenceNumber_t sequenceNumber, size_t totalAudioLength )
+{
+    if( !speakerManager->cold->hasSpillStore ||
+        size > speakerManager->cold->spillStore.capacity -
+                   speakerManager->spilledBytes )
+    {
+        return false;
+    }
+    /* A message larger than the speaker buffer could never be refilled. */
+    if( totalAudioLength >
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) )
+    {
+        return false;
+    }
+
+    AiaSpeakerSpilledMessageSlot_t* slot =
+        AiaCalloc( 1, sizeof( AiaSpeakerSpilledMessageSlot_t ) );
+    if( !slot )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaSpeakerSpilledMessageSlot_t ) );
+        return false;
+    }
+    if( !speakerManager->cold->spillStore.append(
+            message, size, speakerManager->cold->spillStore.userData ) )
+    {
+        AiaLogError( "Failed to spill message, sequenceNumber=%" PRIu32,
+                     sequenceNumber );
+        AiaFree( slot );
+        return false;
+    }
+    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
+    slot->link = defaultLink;
+    slot->sequenceNumber = sequenceNumber;
+    slot->size = size;
+    slot->totalAudioLength = totalAudioLength;
+    AiaListDouble( InsertTail )( &speakerManager->spilledMessages,
+                                 &slot->link );
+    speakerManager->spilledBytes += size;
+    AiaLogDebug( "Spilled message, sequenceNumber=%" PRIu32
+                 ", spilledBytes=%zu",
+                 sequenceNumber, speakerManager->spilledBytes );
+    return true;
+}
 
-        AiaBinaryMessageCount_t count = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageCount_t );
-             ++i, ++bytePosition )
+static void refillSpeakerBufferLocked( AiaSpeakerManager_t* speakerManager )
+{
+    AiaListDouble( Link_t )* link = NULL;
+    while( ( link = AiaListDouble( PeekHead )(
+                 &speakerManager->spilledMessages ) ) )
+    {
+        AiaSpeakerSpilledMessageSlot_t* slot =
+            (AiaSpeakerSpilledMessageSlot_t*)link;
+        if( speakerManager->currentSpeakerState.isSpeakerOpen &&
+            slot->totalAudioLength >
+                getSpeakerBufferSpaceLocked( speakerManager ) )
+        {
+            return;
+        }
+        uint8_t* message = AiaCalloc( slot->size, sizeof( uint8_t ) );
+        if( !message )
         {
-            count |= message[ bytePosition ] << ( i * 8 );
+            AiaLogError( "AiaCalloc failed, bytes=%zu.", slot->size );
+            return;
         }
-
-        AiaLogDebug( "Parsed speaker topic message, length=%" PRIu32
-                     ", type=%" PRIu8 ", count=%" PRIu8,
-                     length, type, count );
-
-        bytePosition += AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES;
-
-        if( message + bytePosition + length > message + size )
+        AiaListDouble( RemoveHead )( &speakerManager->spilledMessages );
+        speakerManager->spilledBytes -= slot->size;
+        if( speakerManager->cold->spillStore.consume(
+                message, slot->size,
+                speakerManager->cold->spillStore.userData ) )
         {
-            AiaLogError( "Invalid binary stream length, length=%" PRIu32
-                         ", message size=%zu.",
-                         length, size );
-            AiaJsonMessage_t* malformedMessageEvent =
-                generateMalformedMessageExceptionEncounteredEvent(
-                    sequenceNumber, index, AIA_TOPIC_SPEAKER );
-            if( !AiaRegulator_Write(
-                    speakerManager->regulator,
-                    AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
-            {
-                AiaLogError( "AiaRegulator_Write failed" );
-                AiaJsonMessage_Destroy( malformedMessageEvent );
-            }
-            return false;
+            /* Spilled messages were validated when they were received, so
+             * they are staged as they are written. */
+            AiaSpeakerStagedMessage_t staged;
+            staged.numEntries = 0;
+            AiaBinaryStreamIterator_Init( &staged.rest, message, slot->size );
+            writeSpeakerTopicMessageLocked( speakerManager, &staged,
+                                            slot->sequenceNumber );
         }
-
-        switch( type )
+        else
         {
-            case AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE:
-                bytePosition += length;
-                totalLength +=
-                    ( length - sizeof( AiaBinaryAudioStreamOffset_t ) );
-                ++index;
-                continue;
-            case AIA_BINARY_STREAM_SPEAKER_MARKER_TYPE:
-                bytePosition += length;
-                ++index;
-                continue;
+            /* The remaining messages no longer line up with the store. The
+             * next message written will be treated as non-contiguous. */
+            AiaLogError( "Failed to refill message, sequenceNumber=%" PRIu32,
+                         slot->sequenceNumber );
+            speakerManager->cold->spillStore.clear(
+                speakerManager->cold->spillStore.userData );
+            AiaListDouble( RemoveAll )( &speakerManager->spilledMessages,
+                                        AiaFree, 0 );
+            speakerManager->spilledBytes = 0;
         }
-        AiaLogError( "Unknown binary stream type, type=%" PRIu8, type );
-        return false;
+        AiaFree( message );
+        AiaFree( slot );
     }
-    *totalAudioLength = totalLength;
-    return true;
 }
 
 static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
@@ -1488,27 +4002,39 @@ static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
         }
     }
 
-    size_t totalAudioLength = 0;
-    if( !AiaSpeakerManager_ValidateSpeakerTopicMessageAndGetTotalAudioLengthLocked(
-            speakerManager, sequenceNumber, message, size, &totalAudioLength ) )
+    AiaSpeakerStagedMessage_t staged;
+    if( !AiaSpeakerManager_StageSpeakerTopicMessageLocked(
+            speakerManager, sequenceNumber, message, size, &staged ) )
     {
         AiaLogError(
-            "AiaSpeakerManager_"
-            "ValidateSpeakerTopicMessageAndGetTotalAudioLengthLocked failed" );
+            "AiaSpeakerManager_StageSpeakerTopicMessageLocked failed" );
         return;
     }
-    size_t spaceInBuffer =
-        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ) -
-        ( ( AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) -
-            AiaDataStreamReader_Tell(
-                speakerManager->speakerBufferReader,
-                AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) ) );
+    size_t totalAudioLength = staged.totalAudioLength;
+    if( speakerManager->hasOverrunPrefix )
+    {
+        totalAudioLength -= speakerManager->overrunPrefixAudioLength;
+    }
+    /* Spilled messages come first, and none are left if the speaker is not
+     * open. */
+    refillSpeakerBufferLocked( speakerManager );
+    size_t spaceInBuffer = getSpeakerBufferSpaceLocked( speakerManager );
+    bool mustSpill =
+        totalAudioLength > spaceInBuffer ||
+        !AiaListDouble( IsEmpty )( &speakerManager->spilledMessages );
 
     /* Only send an overrun and don't consume this data if the speaker is open.
      */
-    if( totalAudioLength > spaceInBuffer &&
-        speakerManager->currentSpeakerState.isSpeakerOpen )
+    if( mustSpill && speakerManager->currentSpeakerState.isSpeakerOpen )
     {
+        /* A message which was partly kept must be resumed right away. */
+        if( !speakerManager->hasOverrunPrefix &&
+            spillSpeakerTopicMessageLocked( speakerManager, message, size,
+                                            sequenceNumber,
+                                            totalAudioLength ) )
+        {
+            return;
+        }
         AiaLogInfo(
             "Not enough space in buffer to consume audio, "
             "totalAudioLength=%zu, spaceInBuffer=%zu",
@@ -1519,6 +4045,12 @@ static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
             /* If we're already in an overrun state, no need to send
              * another event Service will redrive this packets. This
              * only needs to be sent once. */
+            if( speakerManager->isPartialOverrunAcceptEnabled &&
+                AiaListDouble( IsEmpty )( &speakerManager->spilledMessages ) )
+            {
+                acceptSpeakerTopicMessagePrefixLocked( speakerManager, message,
+                                                       size, sequenceNumber );
+            }
             AiaJsonMessage_t* overrunEvent = generateBufferStateChangedEvent(
                 sequenceNumber, AIA_OVERRUN_STATE );
             if( !AiaRegulator_Write(
@@ -1538,88 +4070,225 @@ static void AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
              * flow. Since the sequencer is not thread-safe, sequencer
              * users are responsible for ensuring no other calls to it
              * are made while a message is being written to it already. */
-            AiaSequencer_ResetSequenceNumber( speakerManager->sequencer,
+            AiaSequencer_ResetSequenceNumber( speakerManager->cold->sequencer,
                                               sequenceNumber );
         }
+        else
+        {
+            speakerManager->hasOverrunPrefix = false;
+        }
         return;
     }
 
     /* Else, write message contents into the buffer and allow old buffer
      * contents to be overwritten. */
+    if( writeSpeakerTopicMessageLocked( speakerManager, &staged,
+                                        sequenceNumber ) )
+    {
+        updateJitterLocked( speakerManager );
+    }
+    speakerManager->hasOverrunPrefix = false;
+}
+
+static void acceptSpeakerTopicMessagePrefixLocked(
+    AiaSpeakerManager_t* speakerManager, const uint8_t* message, size_t size,
+    AiaSequenceNumber_t sequenceNumber )
+{
+    static const size_t OFFSET_SIZE = sizeof( AiaBinaryAudioStreamOffset_t );
+    AiaBinaryAudioStreamOffset_t limit =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) +
+        getSpeakerBufferSpaceLocked( speakerManager );
+    size_t prefixEntries =
+        speakerManager->hasOverrunPrefix ? speakerManager->overrunPrefixEntries
+                                         : 0;
+    size_t audioLength = speakerManager->hasOverrunPrefix
+                             ? speakerManager->overrunPrefixAudioLength
+                             : 0;
 
     size_t index = 0;
-    uint32_t bytePosition = 0;
-    while( bytePosition < size )
+    bool isSplit = false;
+    AiaBinaryStreamIterator_t iterator;
+    AiaBinaryStreamIterator_Init( &iterator, message, size );
+    AiaBinaryStreamEntry_t entry;
+    while( !isSplit && AiaBinaryStreamIterator_HasNext( &iterator ) &&
+           AiaBinaryStreamIterator_Next( &iterator, &entry ) )
     {
-        AiaBinaryMessageLength_t length = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageLength_t );
-             ++i, ++bytePosition )
+        AiaBinaryAudioStreamOffset_t localOffset =
+            AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+        AiaBinaryAudioStreamOffset_t offset = 0;
+        AiaBinaryAudioStreamOffset_t end = 0;
+        bool isNewContent =
+            entry.type == AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE &&
+            entry.length >= OFFSET_SIZE && index >= prefixEntries;
+        if( isNewContent )
+        {
+            size_t frameSize =
+                ( entry.length - OFFSET_SIZE ) / ( entry.count + 1 );
+            offset = AiaEndian_LoadLe64( entry.data );
+            end = offset + entry.length - OFFSET_SIZE;
+            if( end > limit )
+            {
+                /* Keep the frames of the entry which fit. */
+                if( !frameSize || offset >= limit )
+                {
+                    break;
+                }
+                size_t keptFrames = ( limit - offset ) / frameSize;
+                end = offset + keptFrames * frameSize;
+                if( !keptFrames || end <= localOffset )
+                {
+                    break;
+                }
+                entry.length = (AiaBinaryMessageLength_t)(
+                    OFFSET_SIZE + keptFrames * frameSize );
+                entry.count = (AiaBinaryMessageCount_t)( keptFrames - 1 );
+                isSplit = true;
+            }
+        }
+        if( !writeSpeakerTopicEntriesLocked( speakerManager, &entry, 1,
+                                             sequenceNumber, &index ) )
         {
-            length |= message[ bytePosition ] << ( i * 8 );
+            break;
         }
-
-        AiaBinaryMessageType_t type = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageType_t );
-             ++i, ++bytePosition )
+        if( isNewContent )
         {
-            type |= message[ bytePosition ] << ( i * 8 );
+            audioLength +=
+                end - ( offset > localOffset ? offset : localOffset );
         }
-
-        AiaBinaryMessageCount_t count = 0;
-        for( size_t i = 0; i < sizeof( AiaBinaryMessageCount_t );
-             ++i, ++bytePosition )
+        if( !isSplit )
         {
-            count |= message[ bytePosition ] << ( i * 8 );
+            prefixEntries = index;
         }
+    }
+
+    speakerManager->hasOverrunPrefix = prefixEntries || audioLength;
+    speakerManager->overrunPrefixEntries = prefixEntries;
+    speakerManager->overrunPrefixAudioLength = audioLength;
+    speakerManager->overrunResumeOffset =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+    AiaLogInfo( "Kept leading audio of overrun message, sequenceNumber=%" PRIu32
+                ", entries=%zu, audioLength=%zu",
+                sequenceNumber, prefixEntries, audioLength );
+}
 
-        bytePosition += AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES;
+static bool writeSpeakerTopicMessageLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSpeakerStagedMessage_t* staged,
+    AiaSequenceNumber_t sequenceNumber )
+{
+    size_t index = 0;
+    while( writeSpeakerTopicEntriesLocked( speakerManager, staged->entries,
+                                           staged->numEntries, sequenceNumber,
+                                           &index ) )
+    {
+        staged->numEntries = 0;
+        while( staged->numEntries < AIA_SPEAKER_MAX_STAGED_ENTRIES &&
+               AiaBinaryStreamIterator_HasNext( &staged->rest ) )
+        {
+            if( !AiaBinaryStreamIterator_Next(
+                    &staged->rest, &staged->entries[ staged->numEntries ] ) )
+            {
+                AiaLogError( "AiaBinaryStreamIterator_Next failed" );
+                return false;
+            }
+            ++staged->numEntries;
+        }
+        if( !staged->numEntries )
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-        switch( type )
+static bool writeSpeakerTopicEntriesLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, AiaSequenceNumber_t sequenceNumber, size_t* index )
+{
+    size_t i = 0;
+    while( i < numEntries )
+    {
+        /* Entries of a redriven message which were kept when it overran are
+         * not handled again. */
+        if( speakerManager->hasOverrunPrefix &&
+            *index < speakerManager->overrunPrefixEntries )
+        {
+            ++i;
+            ++*index;
+            continue;
+        }
+        size_t runEntries = 1;
+        bool handled = false;
+        switch( entries[ i ].type )
         {
             case AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE:
-                if( !handleSpeakerTopicContentTypeEntryLocked(
-                        speakerManager, message + bytePosition, length, count,
-                        sequenceNumber ) )
-                {
-                    AiaJsonMessage_t* malformedMessageEvent =
-                        generateMalformedMessageExceptionEncounteredEvent(
-                            sequenceNumber, index, AIA_TOPIC_SPEAKER );
-                    if( !AiaRegulator_Write( speakerManager->regulator,
-                                             AiaJsonMessage_ToMessage(
-                                                 malformedMessageEvent ) ) )
-                    {
-                        AiaLogError( "AiaRegulator_Write failed" );
-                        AiaJsonMessage_Destroy( malformedMessageEvent );
-                    }
-                    return;
-                }
-                bytePosition += length;
-                ++index;
-                continue;
+                runEntries = getSpeakerContentRunLengthLocked(
+                    speakerManager, entries + i, numEntries - i );
+                handled = handleSpeakerTopicContentRunLocked(
+                    speakerManager, entries + i, runEntries, sequenceNumber );
+                break;
             case AIA_BINARY_STREAM_SPEAKER_MARKER_TYPE:
-                if( !handleSpeakerTopicMarkerTypeEntryLocked(
-                        speakerManager, message + bytePosition, length,
-                        count ) )
-                {
-                    AiaJsonMessage_t* malformedMessageEvent =
-                        generateMalformedMessageExceptionEncounteredEvent(
-                            sequenceNumber, index, AIA_TOPIC_SPEAKER );
-                    if( !AiaRegulator_Write( speakerManager->regulator,
-                                             AiaJsonMessage_ToMessage(
-                                                 malformedMessageEvent ) ) )
-                    {
-                        AiaLogError( "AiaRegulator_Write failed" );
-                        AiaJsonMessage_Destroy( malformedMessageEvent );
-                    }
-                    return;
-                }
-                bytePosition += length;
-                ++index;
-                continue;
+                handled = handleSpeakerTopicMarkerTypeEntryLocked(
+                    speakerManager, entries[ i ].data, entries[ i ].length,
+                    entries[ i ].count );
+                break;
+            default:
+                AiaLogError( "Unknown binary stream type, type=%" PRIu8,
+                             entries[ i ].type );
+                return false;
         }
-        AiaLogError( "Unknown binary stream type, type=%" PRIu8, type );
-        return;
+        if( !handled )
+        {
+            AiaJsonMessage_t* malformedMessageEvent =
+                generateMalformedMessageExceptionEncounteredEvent(
+                    sequenceNumber, *index, AIA_TOPIC_SPEAKER );
+            if( !AiaRegulator_Write(
+                    speakerManager->regulator,
+                    AiaJsonMessage_ToMessage( malformedMessageEvent ) ) )
+            {
+                AiaLogError( "AiaRegulator_Write failed" );
+                AiaJsonMessage_Destroy( malformedMessageEvent );
+            }
+            return false;
+        }
+        i += runEntries;
+        *index += runEntries;
+    }
+    return true;
+}
+
+static size_t getSpeakerContentRunLengthLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries )
+{
+    static const size_t OFFSET_SIZE = sizeof( AiaBinaryAudioStreamOffset_t );
+    if( entries[ 0 ].length < OFFSET_SIZE )
+    {
+        return 1;
+    }
+    size_t bufferSize = speakerManager->speakerBufferSize;
+    size_t runBytes = entries[ 0 ].length - OFFSET_SIZE;
+    size_t runEntries = 1;
+    while( runEntries < numEntries )
+    {
+        const AiaBinaryStreamEntry_t* previous = &entries[ runEntries - 1 ];
+        const AiaBinaryStreamEntry_t* next = &entries[ runEntries ];
+        if( next->type != AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE ||
+            next->length < OFFSET_SIZE )
+        {
+            break;
+        }
+        size_t nextBytes = next->length - OFFSET_SIZE;
+        if( AiaEndian_LoadLe64( next->data ) !=
+                AiaEndian_LoadLe64( previous->data ) + previous->length -
+                    OFFSET_SIZE ||
+            runBytes + nextBytes > bufferSize )
+        {
+            break;
+        }
+        runBytes += nextBytes;
+        ++runEntries;
     }
+    return runEntries;
 }
 
 void AiaSpeakerManager_OnSpeakerTopicMessageReceived(
@@ -1656,90 +4325,330 @@ void AiaSpeakerManager_OnSpeakerTopicMessageReceived(
     AiaMutex( Unlock )( &speakerManager->mutex );
 }
 
-bool handleSpeakerTopicContentTypeEntryLocked(
-    AiaSpeakerManager_t* speakerManager, const uint8_t* data, size_t length,
-    AiaBinaryMessageCount_t count, AiaSequenceNumber_t sequenceNumber )
+bool AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+    AiaSpeakerManager_t* speakerManager, size_t size,
+    AiaSequenceNumber_t sequenceNumber,
+    AiaSpeakerManagerDecryptCallback_t decrypt, void* userData )
 {
+    AiaAssert( speakerManager );
     if( !speakerManager )
     {
         AiaLogError( "Null speakerManager." );
         AiaCriticalFailure();
         return false;
     }
-    if( !data )
+    if( !decrypt )
     {
-        AiaLogError( "Null data." );
+        AiaLogError( "Null decrypt." );
         return false;
     }
 
-    uint32_t bytePosition = 0;
+    AiaMutex( Lock )( &speakerManager->mutex );
+    bool handled =
+        AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceivedLocked(
+            speakerManager, size, sequenceNumber, decrypt, userData );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return handled;
+}
 
-    AiaBinaryAudioStreamOffset_t offset = 0;
-    for( size_t i = 0; i < sizeof( AiaBinaryAudioStreamOffset_t );
-         ++i, ++bytePosition )
+static bool AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceivedLocked(
+    AiaSpeakerManager_t* speakerManager, size_t size,
+    AiaSequenceNumber_t sequenceNumber,
+    AiaSpeakerManagerDecryptCallback_t decrypt, void* userData )
+{
+    /* Only a message made of a single content entry has a layout known before
+     * it is decrypted. Its frame size must also be known already, and the
+     * message must be written right away rather than spilled or overrun. */
+    if( size <= AIA_SPEAKER_CONTENT_PREFIX_SIZE ||
+        !getFrameSize( speakerManager ) ||
+        speakerManager->overrunSpeakerSequenceNumber )
     {
-        offset |= data[ bytePosition ] << ( i * 8 );
+        return false;
     }
-    AiaLogDebug( "Parsed speaker audio content entry offset, offset=%" PRIu64,
-                 offset );
-
-    AiaBinaryAudioStreamOffset_t localOffset =
-        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
-
-    if( offset != localOffset )
+    size_t numAudioBytes = size - AIA_SPEAKER_CONTENT_PREFIX_SIZE;
+    if( numAudioBytes % getFrameSize( speakerManager ) )
+    {
+        return false;
+    }
+    refillSpeakerBufferLocked( speakerManager );
+    if( !AiaListDouble( IsEmpty )( &speakerManager->spilledMessages ) ||
+        ( speakerManager->currentSpeakerState.isSpeakerOpen &&
+          numAudioBytes > getSpeakerBufferSpaceLocked( speakerManager ) ) )
     {
-        AiaLogError( "Received non-contiguous offset, offset received=%" PRIu64
-                     ", offset "
-                     "expected=%" PRIu64,
-                     offset, localOffset );
         return false;
     }
 
-    /* Count is zero-indexed. */
-    size_t numFrames = count + 1;
-    size_t frameSize = ( length - bytePosition ) / numFrames;
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    growSpeakerBufferLocked( speakerManager, numAudioBytes );
+#endif
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t amountReserved = AiaDataStreamWriter_Reserve(
+        speakerManager->speakerBufferWriter, spans, numAudioBytes );
+    if( amountReserved <= 0 )
+    {
+        return false;
+    }
+    if( (size_t)amountReserved < numAudioBytes )
+    {
+        AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, 0 );
+        return false;
+    }
 
-    if( frameSize * numFrames !=
-        length - sizeof( AiaBinaryAudioStreamOffset_t ) )
+    /* The prefix is decrypted aside while the audio lands in the buffer. */
+    uint8_t prefix[ AIA_SPEAKER_CONTENT_PREFIX_SIZE ];
+    AiaSpeakerManagerPlaintextRegion_t
+        regions[ 1 + AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    regions[ 0 ].data = prefix;
+    regions[ 0 ].size = sizeof( prefix );
+    size_t numRegions = 1;
+    for( size_t i = 0; i < AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS; ++i )
+    {
+        if( spans[ i ].nWords )
+        {
+            regions[ numRegions ].data = spans[ i ].data;
+            regions[ numRegions ].size = spans[ i ].nWords;
+            ++numRegions;
+        }
+    }
+    if( !decrypt( regions, numRegions, userData ) )
     {
-        AiaLogError( "Invalid frame size, frameSize=%zu, numFrames=%zu",
-                     frameSize, numFrames );
+        AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, 0 );
         return false;
     }
 
-    if( !speakerManager->frameSize )
+    size_t position = 0;
+    AiaBinaryMessageLength_t length = AiaEndian_LoadLe32( prefix );
+    position += sizeof( AiaBinaryMessageLength_t );
+    AiaBinaryMessageType_t type = prefix[ position ];
+    position += sizeof( AiaBinaryMessageType_t );
+    AiaBinaryMessageCount_t count = prefix[ position ];
+    position += sizeof( AiaBinaryMessageCount_t ) +
+                AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES;
+    AiaBinaryAudioStreamOffset_t offset =
+        AiaEndian_LoadLe64( prefix + position );
+
+    if( type != AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE ||
+        length != size - AIA_SIZE_OF_BINARY_STREAM_HEADER ||
+        ( count + 1 ) * getFrameSize( speakerManager ) != numAudioBytes ||
+        offset !=
+            AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) )
     {
-        AiaLogDebug( "Initial occurrence parsing frame size, frame size=%zu",
-                     frameSize );
-        speakerManager->frameSize = frameSize;
-        speakerManager->currentSpeakerState.bufferedSpeakerFrame =
-            AiaCalloc( speakerManager->frameSize, sizeof( uint8_t ) );
-        if( !speakerManager->currentSpeakerState.bufferedSpeakerFrame )
+        /* Gather the plaintext back together so that it takes the regular
+         * path, which validates it and handles gaps. */
+        uint8_t* message = AiaCalloc( size, sizeof( uint8_t ) );
+        if( !message )
         {
-            AiaLogError( "AiaCalloc failed, bytes=%zu.",
-                         speakerManager->frameSize );
-            AiaCriticalFailure();
+            AiaLogError( "AiaCalloc failed, bytes=%zu.", size );
+            AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter,
+                                         0 );
             return false;
         }
+        position = 0;
+        for( size_t i = 0; i < numRegions; ++i )
+        {
+            memcpy( message + position, regions[ i ].data, regions[ i ].size );
+            position += regions[ i ].size;
+        }
+        AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, 0 );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceivedLocked(
+            speakerManager, message, size, sequenceNumber );
+        AiaFree( message );
+        return true;
     }
-    else
+
+    AiaTrace_Begin( AIA_TRACE_SPEAKER_BUFFER_WRITE, sequenceNumber, offset );
+    AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter,
+                                 numAudioBytes );
+    AiaTrace_End( AIA_TRACE_SPEAKER_BUFFER_WRITE, sequenceNumber, offset );
+    onSpeakerContentWrittenLocked( speakerManager, sequenceNumber );
+    updateJitterLocked( speakerManager );
+    return true;
+}
+
+static ssize_t writeSpeakerContentRunLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, size_t skipBytes, size_t numAudioBytes )
+{
+    static const size_t OFFSET_SIZE = sizeof( AiaBinaryAudioStreamOffset_t );
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    growSpeakerBufferLocked( speakerManager, numAudioBytes );
+#endif
+    if( numEntries == 1 )
+    {
+        return AiaDataStreamWriter_Write(
+            speakerManager->speakerBufferWriter,
+            entries[ 0 ].data + OFFSET_SIZE + skipBytes, numAudioBytes );
+    }
+
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t amountReserved = AiaDataStreamWriter_Reserve(
+        speakerManager->speakerBufferWriter, spans, numAudioBytes );
+    if( amountReserved <= 0 )
+    {
+        return amountReserved;
+    }
+    if( (size_t)amountReserved < numAudioBytes )
+    {
+        AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter, 0 );
+        return amountReserved;
+    }
+
+    /* Gather the audio of the entries directly into the reserved spans. */
+    size_t span = 0;
+    size_t spanPosition = 0;
+    for( size_t i = 0; i < numEntries; ++i )
     {
-        if( speakerManager->frameSize != frameSize )
+        const uint8_t* audio = entries[ i ].data + OFFSET_SIZE;
+        size_t remaining = entries[ i ].length - OFFSET_SIZE;
+        size_t skipped = AiaMin( skipBytes, remaining );
+        audio += skipped;
+        remaining -= skipped;
+        skipBytes -= skipped;
+        while( remaining )
         {
-            AiaLogError(
-                "Different frame size received than previous frame size. VBR "
-                "is currently not supported. Frame size=%zu, previous frame "
-                "size=%zu",
-                frameSize, speakerManager->frameSize );
+            size_t toCopy =
+                AiaMin( remaining, spans[ span ].nWords - spanPosition );
+            memcpy( (uint8_t*)spans[ span ].data + spanPosition, audio,
+                    toCopy );
+            audio += toCopy;
+            remaining -= toCopy;
+            spanPosition += toCopy;
+            if( spanPosition == spans[ span ].nWords )
+            {
+                ++span;
+                spanPosition = 0;
+            }
+        }
+    }
+    return AiaDataStreamWriter_Publish( speakerManager->speakerBufferWriter,
+                                        numAudioBytes );
+}
+
+bool handleSpeakerTopicContentRunLocked(
+    AiaSpeakerManager_t* speakerManager, const AiaBinaryStreamEntry_t* entries,
+    size_t numEntries, AiaSequenceNumber_t sequenceNumber )
+{
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        AiaCriticalFailure();
+        return false;
+    }
+    if( !entries || !numEntries )
+    {
+        AiaLogError( "No entries." );
+        return false;
+    }
+
+    size_t numAudioBytes = 0;
+    for( size_t i = 0; i < numEntries; ++i )
+    {
+        size_t length = entries[ i ].length;
+        if( length < sizeof( AiaBinaryAudioStreamOffset_t ) )
+        {
+            AiaLogError( "Content entry too small to hold offset, length=%zu",
+                         length );
             return false;
         }
+
+        /* Count is zero-indexed. */
+        size_t numFrames = entries[ i ].count + 1;
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+        if( numFrames * AIA_SPEAKER_FIXED_FRAME_SIZE !=
+            length - sizeof( AiaBinaryAudioStreamOffset_t ) )
+        {
+            AiaLogError( "Frame size not %zu, length=%zu, numFrames=%zu",
+                         (size_t)AIA_SPEAKER_FIXED_FRAME_SIZE, length,
+                         numFrames );
+            return false;
+        }
+#else
+        size_t frameSize =
+            ( length - sizeof( AiaBinaryAudioStreamOffset_t ) ) / numFrames;
+
+        if( frameSize * numFrames !=
+            length - sizeof( AiaBinaryAudioStreamOffset_t ) )
+        {
+            AiaLogError( "Invalid frame size, frameSize=%zu, numFrames=%zu",
+                         frameSize, numFrames );
+            return false;
+        }
+
+        if( !getFrameSize( speakerManager ) )
+        {
+            AiaLogDebug(
+                "Initial occurrence parsing frame size, frame size=%zu",
+                frameSize );
+            speakerManager->frameSize = frameSize;
+            if( !allocateBufferedSpeakerFrameLocked( speakerManager ) )
+            {
+                speakerManager->frameSize = 0;
+                AiaCriticalFailure();
+                return false;
+            }
+
+            /* Wake once per frame rather than at the default cadence. */
+            AiaDurationMs_t frameDurationMs =
+                getFrameDurationMs( speakerManager );
+            if( frameDurationMs != AIA_SPEAKER_FRAME_PUSH_CADENCE_MS &&
+                !AiaRealtimeTimer( Arm )( &speakerManager->speakerWorker,
+                                          frameDurationMs, frameDurationMs ) )
+            {
+                AiaLogWarn( "AiaTimer( Arm ) failed" );
+            }
+        }
+        else
+        {
+            if( getFrameSize( speakerManager ) != frameSize )
+            {
+                AiaLogError(
+                    "Different frame size received than previous frame size. "
+                    "VBR is currently not supported. Frame size=%zu, previous "
+                    "frame size=%zu",
+                    frameSize, getFrameSize( speakerManager ) );
+                return false;
+            }
+        }
+#endif
+        numAudioBytes += length - sizeof( AiaBinaryAudioStreamOffset_t );
     }
 
-    const uint8_t* audio = data + bytePosition;
-    size_t numAudioBytes = length - bytePosition;
+    /* Offsets within the run follow on from the first. */
+    AiaBinaryAudioStreamOffset_t offset =
+        AiaEndian_LoadLe64( entries[ 0 ].data );
+    AiaLogDebug( "Parsed speaker audio content run, offset=%" PRIu64
+                 ", numEntries=%zu",
+                 offset, numEntries );
+
+    AiaBinaryAudioStreamOffset_t localOffset =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+
+    /* Audio of a redriven message which was kept when it overran is not
+     * written again. */
+    size_t skipBytes = 0;
+    if( speakerManager->hasOverrunPrefix && offset < localOffset &&
+        localOffset == speakerManager->overrunResumeOffset &&
+        localOffset - offset < numAudioBytes )
+    {
+        skipBytes = (size_t)( localOffset - offset );
+        numAudioBytes -= skipBytes;
+        AiaLogDebug( "Skipping audio kept on overrun, skipBytes=%zu",
+                     skipBytes );
+    }
+    else if( offset != localOffset &&
+             !fillSpeakerGapLocked( speakerManager, localOffset, offset ) )
+    {
+        AiaLogError( "Received non-contiguous offset, offset received=%" PRIu64
+                     ", offset "
+                     "expected=%" PRIu64,
+                     offset, localOffset );
+        return false;
+    }
 
-    ssize_t amountWritten = AiaDataStreamWriter_Write(
-        speakerManager->speakerBufferWriter, audio, numAudioBytes );
+    AiaTrace_Begin( AIA_TRACE_SPEAKER_BUFFER_WRITE, sequenceNumber, offset );
+    ssize_t amountWritten = writeSpeakerContentRunLocked(
+        speakerManager, entries, numEntries, skipBytes, numAudioBytes );
+    AiaTrace_End( AIA_TRACE_SPEAKER_BUFFER_WRITE, sequenceNumber, offset );
     if( amountWritten <= 0 )
     {
         AiaLogError( "AiaDataStreamWriter_Write failed, status=%s",
@@ -1754,41 +4663,91 @@ bool handleSpeakerTopicContentTypeEntryLocked(
     }
     else if( (size_t)amountWritten < numAudioBytes )
     {
-        /* This shouldn't ever happen since the writer is either ALL_OR_NOTHING
-         * or NONBLOCKABLE. */
-        AiaLogError(
-            "Unexpected amount written, amountWritten=%zd, numAudioBytes=%zu",
-            amountWritten, numAudioBytes );
-        return false;
+        /* This shouldn't ever happen since the writer is either ALL_OR_NOTHING
+         * or NONBLOCKABLE. */
+        AiaLogError(
+            "Unexpected amount written, amountWritten=%zd, numAudioBytes=%zu",
+            amountWritten, numAudioBytes );
+        return false;
+    }
+    else
+    {
+        /* We were able to write the entire run to the audio buffer. */
+        onSpeakerContentWrittenLocked( speakerManager, sequenceNumber );
+    }
+
+    return true;
+}
+
+static void updateBufferStateAfterWriteLocked(
+    AiaSpeakerManager_t* speakerManager, AiaSequenceNumber_t sequenceNumber )
+{
+    AiaSpeakerManagerBufferState_t previousBufferState =
+        speakerManager->currentSpeakerState.currentBufferState;
+    updateBufferStateLocked( speakerManager, AIA_SPEAKER_BUFFER_FILLING );
+    if( speakerManager->currentSpeakerState.isSpeakerOpen &&
+        speakerManager->currentSpeakerState.currentBufferState ==
+            AIA_OVERRUN_WARNING_STATE &&
+        previousBufferState < AIA_OVERRUN_WARNING_STATE )
+    {
+        AiaJsonMessage_t* overrunWarningEvent = generateBufferStateChangedEvent(
+            sequenceNumber, AIA_OVERRUN_WARNING_STATE );
+        if( !AiaRegulator_Write(
+                speakerManager->regulator,
+                AiaJsonMessage_ToMessage( overrunWarningEvent ) ) )
+        {
+            AiaLogError( "AiaRegulator_Write failed" );
+            AiaJsonMessage_Destroy( overrunWarningEvent );
+        }
+    }
+}
+
+static void onSpeakerContentWrittenLocked( AiaSpeakerManager_t* speakerManager,
+                                           AiaSequenceNumber_t sequenceNumber )
+{
+    if( speakerManager->isWriteBatchOpen )
+    {
+        speakerManager->isWriteBatchWritten = true;
+    }
+    else
+    {
+        updateBufferStateAfterWriteLocked( speakerManager, sequenceNumber );
+    }
+    speakerManager->lastSpeakerSequenceNumberProcessed = sequenceNumber;
+}
+
+void AiaSpeakerManager_BeginWriteBatch( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->isWriteBatchOpen = true;
+    speakerManager->isWriteBatchWritten = false;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+void AiaSpeakerManager_EndWriteBatch( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
     }
-    else
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->isWriteBatchOpen = false;
+    if( speakerManager->isWriteBatchWritten )
     {
-        /* We were able to write the entire speaker entry to the audio buffer.
-         */
-        AiaSpeakerManagerBufferState_t previousBufferState =
-            speakerManager->currentSpeakerState.currentBufferState;
-        updateBufferStateLocked( speakerManager );
-        if( speakerManager->currentSpeakerState.isSpeakerOpen &&
-            speakerManager->currentSpeakerState.currentBufferState ==
-                AIA_OVERRUN_WARNING_STATE &&
-            previousBufferState < AIA_OVERRUN_WARNING_STATE )
-        {
-            AiaJsonMessage_t* overrunWarningEvent =
-                generateBufferStateChangedEvent( sequenceNumber,
-                                                 AIA_OVERRUN_WARNING_STATE );
-            if( !AiaRegulator_Write(
-                    speakerManager->regulator,
-                    AiaJsonMessage_ToMessage( overrunWarningEvent ) ) )
-            {
-                AiaLogError( "AiaRegulator_Write failed" );
-                AiaJsonMessage_Destroy( overrunWarningEvent );
-            }
-        }
-
-        speakerManager->lastSpeakerSequenceNumberProcessed = sequenceNumber;
+        speakerManager->isWriteBatchWritten = false;
+        updateBufferStateAfterWriteLocked(
+            speakerManager,
+            speakerManager->lastSpeakerSequenceNumberProcessed );
     }
-
-    return true;
+    AiaMutex( Unlock )( &speakerManager->mutex );
 }
 
 bool handleSpeakerTopicMarkerTypeEntryLocked(
@@ -1819,18 +4778,16 @@ bool handleSpeakerTopicMarkerTypeEntryLocked(
 
     while( numMarkers-- )
     {
-        AiaSpeakerBinaryMarker_t marker = 0;
-        for( size_t i = 0; i < sizeof( AiaSpeakerBinaryMarker_t );
-             ++i, ++bytePosition )
-        {
-            marker |= data[ bytePosition ] << ( i * 8 );
-        }
-        AiaSpeakerMarkerSlot_t* markerSlot =
-            AiaCalloc( 1, sizeof( AiaSpeakerMarkerSlot_t ) );
+        AiaSpeakerBinaryMarker_t marker =
+            AiaEndian_LoadLe32( data + bytePosition );
+        bytePosition += sizeof( AiaSpeakerBinaryMarker_t );
+        AiaSpeakerMarkerSlot_t* markerSlot = AiaSpeakerMarkerRing_PushBack(
+            &speakerManager->accumulatedMarkers );
         if( !markerSlot )
         {
-            AiaLogError( "AiaCalloc failed, bytes=%zu.",
-                         sizeof( AiaSpeakerMarkerSlot_t ) );
+            AiaLogError( "Too many pending markers, markers=%zu.",
+                         AiaSpeakerMarkerRing_Size(
+                             &speakerManager->accumulatedMarkers ) );
             AiaJsonMessage_t* internalErrorEvent =
                 generateInternalErrorExceptionEncounteredEvent();
             if( !AiaRegulator_Write(
@@ -1840,22 +4797,11 @@ bool handleSpeakerTopicMarkerTypeEntryLocked(
                 AiaLogError( "AiaRegulator_Write failed" );
                 AiaJsonMessage_Destroy( internalErrorEvent );
             }
-            AiaCriticalFailure();
             return false;
         }
-        else
-        {
-            AiaListDouble( Link_t ) defaultLink =
-                AiaListDouble( LINK_INITIALIZER );
-            markerSlot->link = defaultLink;
-            markerSlot->offset =
-                AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
-            markerSlot->marker = marker;
-
-            /* Add it to the list. */
-            AiaListDouble( InsertTail )( &speakerManager->accumulatedMarkers,
-                                         &markerSlot->link );
-        }
+        markerSlot->offset =
+            AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter );
+        markerSlot->marker = marker;
     }
 
     return true;
@@ -1932,6 +4878,27 @@ void AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
     AiaMutex( Lock )( &speakerManager->mutex );
     speakerManager->currentSpeakerState.pendingOpenSpeaker = true;
     speakerManager->currentSpeakerState.speakerOpenOffset = openSpeakerOffset;
+    speakerManager->openSpeakerTimestampMs = AiaClock( GetTimeMs )();
+    /* Audio for a new response may follow an idle period which is not
+     * jitter. */
+    speakerManager->hasLastTransit = false;
+    if( speakerManager->cold->prefetchSpeakerDataCb )
+    {
+        speakerManager->cold->prefetchSpeakerDataCb(
+            openSpeakerOffset,
+            speakerManager->cold->prefetchSpeakerDataCbUserData );
+    }
+
+    /* If the audio is already buffered, open the speaker now rather than on
+     * the next tick of speakerWorker. */
+    if( speakerManager->currentSpeakerState.isSpeakerReadyForData &&
+        !speakerManager->currentSpeakerState.isSpeakerOpen &&
+        isOpenOffsetBufferedLocked( speakerManager ) &&
+        !AiaRealtimeTimer( Arm )( &speakerManager->speakerWorker, 0,
+                                  getFrameDurationMs( speakerManager ) ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
+    }
     AiaMutex( Unlock )( &speakerManager->mutex );
 }
 
@@ -1985,49 +4952,398 @@ void AiaSpeakerManager_OnCloseSpeakerDirectiveReceived(
             AiaSpeakerManager_CloseSpeakerActionLocked,
             speakerManager ) == AIA_INVALID_ACTION_ID )
     {
-        AiaLogError( "AiaSpeakerManager_InvokeActionAtOffset failed" );
-        AiaJsonMessage_t* internalErrorEvent =
-            generateInternalErrorExceptionEncounteredEvent();
-        if( !AiaRegulator_Write(
-                speakerManager->regulator,
-                AiaJsonMessage_ToMessage( internalErrorEvent ) ) )
-        {
-            AiaLogError( "AiaRegulator_Write failed" );
-            AiaJsonMessage_Destroy( internalErrorEvent );
-        }
+        AiaLogError( "AiaSpeakerManager_InvokeActionAtOffset failed" );
+        AiaJsonMessage_t* internalErrorEvent =
+            generateInternalErrorExceptionEncounteredEvent();
+        if( !AiaRegulator_Write(
+                speakerManager->regulator,
+                AiaJsonMessage_ToMessage( internalErrorEvent ) ) )
+        {
+            AiaLogError( "AiaRegulator_Write failed" );
+            AiaJsonMessage_Destroy( internalErrorEvent );
+        }
+    }
+}
+
+void AiaSpeakerManager_StopPlayback( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        AiaCriticalFailure();
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+
+    AiaSpeakerManager_InvalidateActionsLocked( speakerManager );
+
+    AiaSpeakerManager_CloseSpeakerLocked( speakerManager );
+
+    AiaSpeakerManager_FlushLocked( speakerManager );
+
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+void AiaSpeakerManager_OnReconnected( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+
+    AiaJsonMessage_t* bufferStateEvent = generateBufferStateChangedEvent(
+        speakerManager->lastSpeakerSequenceNumberProcessed,
+        speakerManager->currentSpeakerState.currentBufferState );
+    if( !AiaRegulator_Write( speakerManager->regulator,
+                             AiaJsonMessage_ToMessage( bufferStateEvent ) ) )
+    {
+        AiaLogError( "AiaRegulator_Write failed" );
+        AiaJsonMessage_Destroy( bufferStateEvent );
+    }
+
+    /* A pending OpenSpeaker sends its own SpeakerOpened once playback
+     * starts. */
+    if( speakerManager->currentSpeakerState.isSpeakerOpen )
+    {
+        AiaBinaryAudioStreamOffset_t offset = getPlayoutOffsetLocked(
+            speakerManager, AiaClock( GetTimeMs )() );
+        AiaLogDebug( "Speaker reopened, offset=%" PRIu64, offset );
+        AiaJsonMessage_t* speakerOpenedEvent =
+            generateSpeakerOpenedEvent( offset );
+        if( !AiaRegulator_Write(
+                speakerManager->regulator,
+                AiaJsonMessage_ToMessage( speakerOpenedEvent ) ) )
+        {
+            AiaLogError( "AiaRegulator_Write failed" );
+            AiaJsonMessage_Destroy( speakerOpenedEvent );
+        }
+    }
+
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+#endif
+
+void AiaSpeakerManager_OnSpeakerReady( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        AiaCriticalFailure();
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->currentSpeakerState.isSpeakerReadyForData = true;
+    ++speakerManager->speakerReadyCount;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+AiaSpeakerSinkId_t AiaSpeakerManager_AddSink(
+    AiaSpeakerManager_t* speakerManager, AiaPlaySpeakerData_t playSpeakerDataCb,
+    void* playSpeakerDataCbUserData )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return AIA_INVALID_SPEAKER_SINK_ID;
+    }
+    if( !playSpeakerDataCb )
+    {
+        AiaLogError( "Null playSpeakerDataCb." );
+        return AIA_INVALID_SPEAKER_SINK_ID;
+    }
+
+    AiaMutex( Lock )( &speakerManager->mutex );
+    for( size_t i = 0; i < AIA_SPEAKER_MAX_SINKS; ++i )
+    {
+        AiaSpeakerSink_t* sink = &speakerManager->sinks[ i ];
+        if( sink->playSpeakerDataCb )
+        {
+            continue;
+        }
+        sink->playSpeakerDataCb = playSpeakerDataCb;
+        sink->playSpeakerDataCbUserData = playSpeakerDataCbUserData;
+        ++sink->generation;
+        sink->isReadyForData = true;
+        /* Start with the frames after any being pushed now. */
+        sink->deliveredSize =
+            speakerManager->currentSpeakerState.bufferedSpeakerFrameSize;
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return (AiaSpeakerSinkId_t)( i + 1 );
+    }
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    AiaLogError( "Too many speakers, max=%d", AIA_SPEAKER_MAX_SINKS );
+    return AIA_INVALID_SPEAKER_SINK_ID;
+}
+
+bool AiaSpeakerManager_RemoveSink( AiaSpeakerManager_t* speakerManager,
+                                   AiaSpeakerSinkId_t sinkId )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    if( sinkId == AIA_INVALID_SPEAKER_SINK_ID ||
+        sinkId > AIA_SPEAKER_MAX_SINKS )
+    {
+        AiaLogError( "Invalid sinkId, sinkId=%" PRIu32, sinkId );
+        return false;
+    }
+
+    AiaMutex( Lock )( &speakerManager->mutex );
+    AiaSpeakerSink_t* sink = &speakerManager->sinks[ sinkId - 1 ];
+    if( !sink->playSpeakerDataCb )
+    {
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        AiaLogError( "Speaker not added, sinkId=%" PRIu32, sinkId );
+        return false;
+    }
+    sink->playSpeakerDataCb = NULL;
+    sink->playSpeakerDataCbUserData = NULL;
+    ++sink->generation;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
+}
+
+void AiaSpeakerManager_OnSinkReady( AiaSpeakerManager_t* speakerManager,
+                                    AiaSpeakerSinkId_t sinkId )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    if( sinkId == AIA_INVALID_SPEAKER_SINK_ID ||
+        sinkId > AIA_SPEAKER_MAX_SINKS )
+    {
+        AiaLogError( "Invalid sinkId, sinkId=%" PRIu32, sinkId );
+        return;
+    }
+
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->sinks[ sinkId - 1 ].isReadyForData = true;
+    ++speakerManager->sinks[ sinkId - 1 ].readyCount;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+bool AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaPlaySpeakerDataBatch_t playSpeakerDataBatchCb,
+    void* playSpeakerDataBatchCbUserData, size_t maxFramesPerPush,
+    size_t maxBytesPerPush )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    if( playSpeakerDataBatchCb && !maxFramesPerPush )
+    {
+        AiaLogError( "Invalid maxFramesPerPush, maxFramesPerPush=%zu",
+                     maxFramesPerPush );
+        return false;
+    }
+
+    AiaMutex( Lock )( &speakerManager->mutex );
+    if( speakerManager->currentSpeakerState.isBufferedSpeakerFramePending ||
+        speakerManager->isPushInFlight )
+    {
+        AiaLogError( "Cannot change push mode while a frame is pending" );
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return false;
+    }
+
+    AiaPlaySpeakerDataBatch_t previousBatchCb =
+        speakerManager->playSpeakerDataBatchCb;
+    size_t previousMaxFramesPerPush = speakerManager->maxFramesPerPush;
+    size_t previousMaxBytesPerPush = speakerManager->maxBytesPerPush;
+    speakerManager->playSpeakerDataBatchCb = playSpeakerDataBatchCb;
+    speakerManager->maxFramesPerPush = maxFramesPerPush;
+    speakerManager->maxBytesPerPush = maxBytesPerPush;
+    if( getFrameSize( speakerManager ) &&
+        !allocateBufferedSpeakerFrameLocked( speakerManager ) )
+    {
+        speakerManager->playSpeakerDataBatchCb = previousBatchCb;
+        speakerManager->maxFramesPerPush = previousMaxFramesPerPush;
+        speakerManager->maxBytesPerPush = previousMaxBytesPerPush;
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return false;
+    }
+    speakerManager->playSpeakerDataBatchCbUserData =
+        playSpeakerDataBatchCbUserData;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
+}
+
+void AiaSpeakerManager_SetConcealSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaConcealSpeakerData_t concealSpeakerDataCb,
+    void* concealSpeakerDataCbUserData )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->concealSpeakerDataCb = concealSpeakerDataCb;
+    speakerManager->concealSpeakerDataCbUserData =
+        concealSpeakerDataCbUserData;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+void AiaSpeakerManager_SetPrefetchSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaPrefetchSpeakerData_t prefetchSpeakerDataCb,
+    void* prefetchSpeakerDataCbUserData )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->cold->prefetchSpeakerDataCb = prefetchSpeakerDataCb;
+    speakerManager->cold->prefetchSpeakerDataCbUserData =
+        prefetchSpeakerDataCbUserData;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+void AiaSpeakerManager_SetFlushSpeakerDataCb(
+    AiaSpeakerManager_t* speakerManager,
+    AiaFlushSpeakerData_t flushSpeakerDataCb,
+    void* flushSpeakerDataCbUserData )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->cold->flushSpeakerDataCb = flushSpeakerDataCb;
+    speakerManager->cold->flushSpeakerDataCbUserData =
+        flushSpeakerDataCbUserData;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+}
+
+bool AiaSpeakerManager_CanConcealGaps( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    bool canConcealGaps = speakerManager->concealSpeakerDataCb != NULL;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return canConcealGaps;
+}
+
+bool AiaSpeakerManager_SetSpillStore( AiaSpeakerManager_t* speakerManager,
+                                      const AiaSpeakerSpillStore_t* store )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    if( store && ( !store->append || !store->consume || !store->clear ) )
+    {
+        AiaLogError( "Invalid spill store." );
+        return false;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    if( !AiaListDouble( IsEmpty )( &speakerManager->spilledMessages ) )
+    {
+        AiaLogError( "Messages are spilled, spilledBytes=%zu.",
+                     speakerManager->spilledBytes );
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return false;
+    }
+    speakerManager->cold->hasSpillStore = store != NULL;
+    if( store )
+    {
+        speakerManager->cold->spillStore = *store;
     }
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
 }
 
-void AiaSpeakerManager_StopPlayback( AiaSpeakerManager_t* speakerManager )
+bool AiaSpeakerManager_SetPartialOverrunAccept(
+    AiaSpeakerManager_t* speakerManager, bool enabled )
 {
     AiaAssert( speakerManager );
     if( !speakerManager )
     {
         AiaLogError( "Null speakerManager." );
-        AiaCriticalFailure();
-        return;
+        return false;
     }
     AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->isPartialOverrunAcceptEnabled = enabled;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
+}
 
-    AiaSpeakerManager_InvalidateActionsLocked( speakerManager );
-
-    AiaSpeakerManager_CloseSpeakerLocked( speakerManager );
-
+bool AiaSpeakerManager_SetAdaptiveJitterBuffer(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerJitterBufferConfig_t* config )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    speakerManager->isJitterBufferEnabled = config != NULL;
+    if( config )
+    {
+        speakerManager->jitterBufferConfig = *config;
+        speakerManager->hasLastTransit = false;
+        speakerManager->jitterSixteenthsMs = 0;
+        updateJitterBufferThresholdsLocked( speakerManager );
+    }
     AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
 }
 
-void AiaSpeakerManager_OnSpeakerReady( AiaSpeakerManager_t* speakerManager )
+bool AiaSpeakerManager_SetBufferStateHysteresis(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerBufferStateHysteresisConfig_t* config )
 {
     AiaAssert( speakerManager );
     if( !speakerManager )
     {
         AiaLogError( "Null speakerManager." );
-        AiaCriticalFailure();
-        return;
+        return false;
     }
     AiaMutex( Lock )( &speakerManager->mutex );
-    speakerManager->currentSpeakerState.isSpeakerReadyForData = true;
+    if( config )
+    {
+        speakerManager->bufferStateHysteresis = *config;
+    }
+    else
+    {
+        memset( &speakerManager->bufferStateHysteresis, 0,
+                sizeof( speakerManager->bufferStateHysteresis ) );
+    }
     AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
 }
 
 void AiaSpeakerManager_OnSetVolumeDirectiveReceived(
@@ -2059,11 +5375,14 @@ void AiaSpeakerManager_OnSetVolumeDirectiveReceived(
         return;
     }
 
+    /* Index the payload once rather than rescanning it for each field. */
+    AiaJsonObject_t object;
     const char* volumeStr = NULL;
     size_t volumeLen = 0;
-    if( !AiaFindJsonValue( payload, size, AIA_SET_VOLUME_VOLUME_KEY,
-                           sizeof( AIA_SET_VOLUME_VOLUME_KEY ) - 1, &volumeStr,
-                           &volumeLen ) )
+    if( !AiaJsonObject_Parse( &object, payload, size ) ||
+        !AiaJsonObject_FindValue( &object, AIA_SET_VOLUME_VOLUME_KEY,
+                                  sizeof( AIA_SET_VOLUME_VOLUME_KEY ) - 1,
+                                  &volumeStr, &volumeLen ) )
     {
         AiaLogError( "No volume found" );
         AiaJsonMessage_t* malformedMessageEvent =
@@ -2100,9 +5419,9 @@ void AiaSpeakerManager_OnSetVolumeDirectiveReceived(
     const char* offset = NULL;
     size_t offsetLen = 0;
     /* Treat offset as optional. */
-    if( !AiaFindJsonValue( payload, size, AIA_SET_VOLUME_OFFSET_KEY,
-                           sizeof( AIA_SET_VOLUME_OFFSET_KEY ) - 1, &offset,
-                           &offsetLen ) )
+    if( !AiaJsonObject_FindValue( &object, AIA_SET_VOLUME_OFFSET_KEY,
+                                  sizeof( AIA_SET_VOLUME_OFFSET_KEY ) - 1,
+                                  &offset, &offsetLen ) )
     {
         AiaLogDebug( "No offset found" );
         volumeOffset = AiaDataStreamReader_Tell(
@@ -2170,19 +5489,19 @@ void AiaSpeakerManager_OnSetVolumeDirectiveReceived(
     }
 
     AiaMutex( Lock )( &speakerManager->mutex );
-    AiaListDouble( InsertTail )( &speakerManager->volumeActions,
+    AiaListDouble( InsertTail )( &speakerManager->cold->volumeActions,
                                  &volumeSlot->link );
     AiaMutex( Unlock )( &speakerManager->mutex );
 }
 
 static bool AiaSpeakerManager_ChangeVolumeLocked(
-    AiaSpeakerManager_t* speakerManager, uint8_t newVolume )
+    AiaSpeakerManager_t* speakerManager, uint8_t newVolume, bool isLocal )
 {
     AiaLogDebug( "Volume change from %" PRIu8 " to %" PRIu8,
                  speakerManager->currentSpeakerState.currentVolume, newVolume );
 
-    speakerManager->setVolumeCb( newVolume,
-                                 speakerManager->setVolumeCbUserData );
+    speakerManager->cold->setVolumeCb( newVolume,
+                                 speakerManager->cold->setVolumeCbUserData );
 
     if( newVolume == speakerManager->currentSpeakerState.currentVolume )
     {
@@ -2198,13 +5517,38 @@ static bool AiaSpeakerManager_ChangeVolumeLocked(
         return true;
     }
 
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+#ifdef AIA_STORE_VOLUME
+    speakerManager->cold->isVolumeStorePending = true;
+    speakerManager->cold->volumeStoreDueMs =
+        now + speakerManager->cold->volumeCoalescing.storeDelayMs;
+#endif
+    if( isLocal && speakerManager->cold->volumeCoalescing.settleMs )
+    {
+        speakerManager->cold->isVolumeChangedPending = true;
+        speakerManager->cold->volumeChangedDueMs =
+            now + speakerManager->cold->volumeCoalescing.settleMs;
+        AiaSpeakerManager_ArmVolumeWorkerLocked( speakerManager, now );
+        return true;
+    }
+
+    /* This event carries the current volume, so any pending one is moot. */
+    speakerManager->cold->isVolumeChangedPending = false;
+    AiaSpeakerManager_ArmVolumeWorkerLocked( speakerManager, now );
+    return AiaSpeakerManager_SendVolumeChangedLocked( speakerManager );
+}
+
+static bool AiaSpeakerManager_SendVolumeChangedLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    uint8_t volume = speakerManager->currentSpeakerState.currentVolume;
     AiaJsonMessage_t* volumeChangedEvent = NULL;
     if( speakerManager->currentSpeakerState.isSpeakerOpen )
     {
         volumeChangedEvent = generateVolumeChangedEventWithOffset(
-            newVolume, AiaDataStreamReader_Tell(
-                           speakerManager->speakerBufferReader,
-                           AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+            volume, AiaDataStreamReader_Tell(
+                        speakerManager->speakerBufferReader,
+                        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
         if( !volumeChangedEvent )
         {
             AiaLogError( "generateVolumeChangedEventWithOffset failed" );
@@ -2213,8 +5557,7 @@ static bool AiaSpeakerManager_ChangeVolumeLocked(
     }
     else
     {
-        volumeChangedEvent =
-            generateVolumeChangedEventWithoutOffset( newVolume );
+        volumeChangedEvent = generateVolumeChangedEventWithoutOffset( volume );
         if( !volumeChangedEvent )
         {
             AiaLogError( "generateVolumeChangedEventWithoutOffset failed" );
@@ -2222,10 +5565,12 @@ static bool AiaSpeakerManager_ChangeVolumeLocked(
         }
     }
 
-    if( !AiaRegulator_Write( speakerManager->regulator,
-                             AiaJsonMessage_ToMessage( volumeChangedEvent ) ) )
+    if( !AiaRegulator_WriteWithDeadline(
+            speakerManager->regulator,
+            AiaJsonMessage_ToMessage( volumeChangedEvent ),
+            AIA_SPEAKER_DEFERRED_EVENT_MAX_DELAY_MS ) )
     {
-        AiaLogError( "AiaRegulator_Write failed" );
+        AiaLogError( "AiaRegulator_WriteWithDeadline failed" );
         AiaJsonMessage_Destroy( volumeChangedEvent );
         return false;
     }
@@ -2233,6 +5578,99 @@ static bool AiaSpeakerManager_ChangeVolumeLocked(
     return true;
 }
 
+static void AiaSpeakerManager_ArmVolumeWorkerLocked(
+    AiaSpeakerManager_t* speakerManager, AiaTimepointMs_t now )
+{
+    bool isPending = speakerManager->cold->isVolumeChangedPending;
+    AiaTimepointMs_t dueMs = speakerManager->cold->volumeChangedDueMs;
+#ifdef AIA_STORE_VOLUME
+    if( speakerManager->cold->isVolumeStorePending &&
+        ( !isPending || speakerManager->cold->volumeStoreDueMs < dueMs ) )
+    {
+        isPending = true;
+        dueMs = speakerManager->cold->volumeStoreDueMs;
+    }
+#endif
+    if( !isPending )
+    {
+        return;
+    }
+    if( !AiaTimer( Arm )( &speakerManager->cold->volumeWorker,
+                          dueMs > now ? dueMs - now : 0, 0 ) )
+    {
+        AiaLogWarn( "AiaTimer( Arm ) failed" );
+    }
+}
+
+static void AiaSpeakerManager_VolumeRoutine( void* context )
+{
+    AiaSpeakerManager_t* speakerManager = (AiaSpeakerManager_t*)context;
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager" );
+        AiaCriticalFailure();
+        return;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+    if( speakerManager->cold->isVolumeChangedPending &&
+        now >= speakerManager->cold->volumeChangedDueMs )
+    {
+        speakerManager->cold->isVolumeChangedPending = false;
+        if( !AiaSpeakerManager_SendVolumeChangedLocked( speakerManager ) )
+        {
+            AiaLogError( "AiaSpeakerManager_SendVolumeChangedLocked failed" );
+        }
+    }
+#ifdef AIA_STORE_VOLUME
+    bool shouldStore = false;
+    uint8_t volume = speakerManager->currentSpeakerState.currentVolume;
+    if( speakerManager->cold->isVolumeStorePending &&
+        now >= speakerManager->cold->volumeStoreDueMs )
+    {
+        speakerManager->cold->isVolumeStorePending = false;
+        shouldStore = true;
+    }
+#endif
+    AiaSpeakerManager_ArmVolumeWorkerLocked( speakerManager, now );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+
+#ifdef AIA_STORE_VOLUME
+    /* Persistent storage may be slow, so it is written without blocking
+     * playback. */
+    if( shouldStore && !AIA_STORE_VOLUME( volume ) )
+    {
+        AiaLogError( "AIA_STORE_VOLUME failed, volume=%" PRIu8, volume );
+    }
+#endif
+}
+
+bool AiaSpeakerManager_SetVolumeCoalescing(
+    AiaSpeakerManager_t* speakerManager,
+    const AiaSpeakerVolumeCoalescingConfig_t* config )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    if( config )
+    {
+        speakerManager->cold->volumeCoalescing = *config;
+    }
+    else
+    {
+        speakerManager->cold->volumeCoalescing.settleMs = 0;
+        speakerManager->cold->volumeCoalescing.storeDelayMs =
+            AIA_SPEAKER_VOLUME_STORE_DELAY_MS;
+    }
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
+}
+
 bool AiaSpeakerManager_ChangeVolume( AiaSpeakerManager_t* speakerManager,
                                      uint8_t newVolume )
 {
@@ -2251,7 +5689,8 @@ bool AiaSpeakerManager_ChangeVolume( AiaSpeakerManager_t* speakerManager,
 
     AiaMutex( Lock )( &speakerManager->mutex );
 
-    if( !AiaSpeakerManager_ChangeVolumeLocked( speakerManager, newVolume ) )
+    if( !AiaSpeakerManager_ChangeVolumeLocked( speakerManager, newVolume,
+                                               true ) )
     {
         AiaLogError( "AiaSpeakerManager_ChangeVolumeLocked failed" );
         AiaMutex( Unlock )( &speakerManager->mutex );
@@ -2289,7 +5728,7 @@ bool AiaSpeakerManager_AdjustVolume( AiaSpeakerManager_t* speakerManager,
     newCurrentVolume += delta;
 
     if( !AiaSpeakerManager_ChangeVolumeLocked( speakerManager,
-                                               newCurrentVolume ) )
+                                               newCurrentVolume, true ) )
     {
         AiaLogError( "AiaSpeakerManager_ChangeVolumeLocked failed" );
         AiaMutex( Unlock )( &speakerManager->mutex );
@@ -2299,6 +5738,86 @@ bool AiaSpeakerManager_AdjustVolume( AiaSpeakerManager_t* speakerManager,
     return true;
 }
 
+bool AiaSpeakerManager_RestoreVolume( AiaSpeakerManager_t* speakerManager,
+                                      uint8_t volume )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    if( volume < AIA_MIN_VOLUME || volume > AIA_MAX_VOLUME )
+    {
+        AiaLogError( "Volume given out of range, given=%" PRIu8, volume );
+        return false;
+    }
+
+    AiaMutex( Lock )( &speakerManager->mutex );
+    uint8_t previousVolume = speakerManager->currentSpeakerState.currentVolume;
+    if( speakerManager->currentSpeakerState.initialVolume )
+    {
+        /* The volume loaded on creation has not been applied yet. Applying the
+         * restored volume in its place turns that action into a no-op. */
+        AiaSpeakerManagerVolumeDataForAction_t* initialSlot =
+            (AiaSpeakerManagerVolumeDataForAction_t*)AiaListDouble( PeekHead )(
+                &speakerManager->cold->volumeActions );
+        AiaAssert( initialSlot );
+        if( initialSlot )
+        {
+            previousVolume = initialSlot->volume;
+            initialSlot->volume = volume;
+        }
+        speakerManager->currentSpeakerState.initialVolume = false;
+    }
+    AiaLogDebug( "Restoring volume, volume=%" PRIu8, volume );
+    speakerManager->cold->setVolumeCb(
+        volume, speakerManager->cold->setVolumeCbUserData );
+    speakerManager->currentSpeakerState.currentVolume = volume;
+#ifdef AIA_STORE_VOLUME
+    if( volume != previousVolume )
+    {
+        AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+        speakerManager->cold->isVolumeStorePending = true;
+        speakerManager->cold->volumeStoreDueMs =
+            now + speakerManager->cold->volumeCoalescing.storeDelayMs;
+        AiaSpeakerManager_ArmVolumeWorkerLocked( speakerManager, now );
+    }
+#else
+    (void)previousVolume;
+#endif
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return true;
+}
+
+uint8_t AiaSpeakerManager_GetVolume( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return AIA_DEFAULT_VOLUME;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    uint8_t volume = speakerManager->currentSpeakerState.currentVolume;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return volume;
+}
+
+void AiaSpeakerManager_SetPlayoutLatency( AiaSpeakerManager_t* speakerManager,
+                                          AiaDurationMs_t latencyMs )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaAtomic_Store_u32( &speakerManager->playoutLatencyMs,
+                         latencyMs > UINT32_MAX ? UINT32_MAX
+                                                : (uint32_t)latencyMs );
+}
+
 bool AiaSpeakerManager_CanSpeakerStream( AiaSpeakerManager_t* speakerManager )
 {
     AiaAssert( speakerManager );
@@ -2323,6 +5842,89 @@ bool AiaSpeakerManager_CanSpeakerStream( AiaSpeakerManager_t* speakerManager )
     return speakerStatus || speakerOpenPending;
 }
 
+size_t AiaSpeakerManager_TrimMemory( AiaSpeakerManager_t* speakerManager )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return 0;
+    }
+    size_t released = 0;
+    AiaMutex( Lock )( &speakerManager->mutex );
+    if( isBufferedSpeakerFrameAllocatedLocked( speakerManager ) &&
+        !speakerManager->currentSpeakerState.isSpeakerOpen &&
+        !speakerManager->currentSpeakerState.pendingOpenSpeaker &&
+        !speakerManager->currentSpeakerState.isBufferedSpeakerFramePending &&
+        !speakerManager->isPushInFlight )
+    {
+        released = getFrameSize( speakerManager ) *
+                   getFramesPerPushLocked( speakerManager );
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+        if( speakerManager->isMemoryPrefaulted )
+        {
+            AiaMemory_Unprefault(
+                speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+                speakerManager->bufferedSpeakerFrameCapacity );
+        }
+#endif
+        AiaFree( speakerManager->currentSpeakerState.bufferedSpeakerFrame );
+        speakerManager->currentSpeakerState.bufferedSpeakerFrame = NULL;
+    }
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    size_t capacity =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+    shrinkSpeakerBufferLocked( speakerManager );
+    released +=
+        capacity -
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+#endif
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return released;
+}
+
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+bool AiaSpeakerManager_PrefaultBuffers( AiaSpeakerManager_t* speakerManager,
+                                        bool lock )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return false;
+    }
+    AiaMutex( Lock )( &speakerManager->mutex );
+    if( speakerManager->isMemoryPrefaulted )
+    {
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        AiaLogError( "Buffers already prefaulted." );
+        return false;
+    }
+    if( getFrameSize( speakerManager ) &&
+        !speakerManager->currentSpeakerState.bufferedSpeakerFrame &&
+        !allocateBufferedSpeakerFrameLocked( speakerManager ) )
+    {
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return false;
+    }
+    bool success = AiaMemory_Prefault(
+        speakerManager->speakerBufferMemory,
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer ),
+        lock );
+    if( speakerManager->currentSpeakerState.bufferedSpeakerFrame )
+    {
+        success = AiaMemory_Prefault(
+                      speakerManager->currentSpeakerState.bufferedSpeakerFrame,
+                      speakerManager->bufferedSpeakerFrameCapacity, lock ) &&
+                  success;
+    }
+    speakerManager->isMemoryPrefaulted = true;
+    speakerManager->isMemoryLocked = lock;
+    AiaMutex( Unlock )( &speakerManager->mutex );
+    return success;
+}
+#endif
+
 static bool AiaSpeakerManager_CanSpeakerStreamLocked(
     AiaSpeakerManager_t* speakerManager )
 {
@@ -2403,26 +6005,6 @@ static void AiaSpeakerManager_StopOfflineAlertLocked(
 }
 #endif
 
-/**
- * Comparator used for @c AiaListDouble( InsertSorted ).
- *
- * @param link1 First element to compare. A null value will result in undefined
- * behavior.
- * @param link2 Second element to compare. A null value will result in undefined
- * behavior.
- * @return Returns a negative value if its first argument is less than its
- * second argument; returns zero if its first argument is equal to its second
- * argument; returns a positive value if its first argument is greater than its
- * second argument.
- */
-static int32_t AiaActionAtSpeakerOffsetComparator(
-    const AiaListDouble( Link_t ) * const link1,
-    const AiaListDouble( Link_t ) * const link2 )
-{
-    return ( (AiaSpeakerOffsetActionSlot_t*)link1 )->offset -
-           ( (AiaSpeakerOffsetActionSlot_t*)link2 )->offset;
-}
-
 AiaSpeakerActionHandle_t AiaSpeakerManager_InvokeActionAtOffset(
     AiaSpeakerManager_t* speakerManager, AiaBinaryAudioStreamOffset_t offset,
     AiaActionAtSpeakerOffset_t action, void* userData )
@@ -2441,27 +6023,34 @@ AiaSpeakerActionHandle_t AiaSpeakerManager_InvokeActionAtOffset(
 
     AiaMutex( Lock )( &speakerManager->mutex );
 
-    AiaSpeakerOffsetActionSlot_t* actionSlot =
-        AiaCalloc( 1, sizeof( AiaSpeakerOffsetActionSlot_t ) );
-    if( !actionSlot )
+    if( speakerManager->freeActionSlot == speakerManager->actionCapacity &&
+        !growActionPoolLocked( speakerManager ) )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu",
-                     sizeof( AiaSpeakerOffsetActionSlot_t ) );
+        AiaLogError( "growActionPoolLocked failed" );
         AiaMutex( Unlock )( &speakerManager->mutex );
         return AIA_INVALID_ACTION_ID;
     }
-    AiaListDouble( Link_t ) defaultLink = AiaListDouble( LINK_INITIALIZER );
-    actionSlot->link = defaultLink;
+    size_t slotIndex = speakerManager->freeActionSlot;
+    AiaSpeakerOffsetActionSlot_t* actionSlot =
+        &speakerManager->actionSlots[ slotIndex ];
+    speakerManager->freeActionSlot = actionSlot->position;
+
     actionSlot->offset = offset;
+    actionSlot->sequence = speakerManager->nextActionSequence++;
     actionSlot->action = action;
     actionSlot->userData = userData;
-    AiaListDouble( InsertSorted )( &speakerManager->offsetActions,
-                                   &actionSlot->link,
-                                   AiaActionAtSpeakerOffsetComparator );
-    AiaLogInfo( "Action with id=%p scheduled at offset=%" PRIu64, actionSlot,
-                actionSlot->offset );
+    actionSlot->position = speakerManager->numActions;
+    speakerManager->actionHeap[ speakerManager->numActions++ ] =
+        (uint16_t)slotIndex;
+    siftActionUpLocked( speakerManager, actionSlot->position );
+
+    AiaSpeakerActionHandle_t handle =
+        ( (AiaSpeakerActionHandle_t)actionSlot->generation << 16 ) |
+        (AiaSpeakerActionHandle_t)( slotIndex + 1 );
+    AiaLogInfo( "Action with id=%" PRIu32 " scheduled at offset=%" PRIu64,
+                handle, offset );
     AiaMutex( Unlock )( &speakerManager->mutex );
-    return actionSlot;
+    return handle;
 }
 
 void AiaSpeakerManager_CancelAction( AiaSpeakerManager_t* speakerManager,
@@ -2473,19 +6062,29 @@ void AiaSpeakerManager_CancelAction( AiaSpeakerManager_t* speakerManager,
         AiaLogError( "Null speakerManager." );
         return;
     }
-    if( !handle || handle == AIA_INVALID_ACTION_ID )
+    if( handle == AIA_INVALID_ACTION_ID )
     {
         AiaLogError( "Invalid handle" );
         return;
     }
 
-    AiaLogInfo( "AiaSpeakerManager_CancelAction, handle=%p", handle );
+    AiaLogInfo( "AiaSpeakerManager_CancelAction, handle=%" PRIu32, handle );
     AiaMutex( Lock )( &speakerManager->mutex );
 
-    AiaSpeakerOffsetActionSlot_t* slot = (AiaSpeakerOffsetActionSlot_t*)handle;
-
-    AiaListDouble( Remove )( &slot->link );
-    AiaFree( slot );
+    /* Wraps to an out of range index if the low bits are zero. */
+    size_t slotIndex = (size_t)( handle & UINT16_MAX ) - 1;
+    uint16_t generation = (uint16_t)( handle >> 16 );
+    if( slotIndex >= speakerManager->actionCapacity ||
+        !speakerManager->actionSlots[ slotIndex ].action ||
+        speakerManager->actionSlots[ slotIndex ].generation != generation )
+    {
+        AiaLogDebug( "Action already invoked or canceled, handle=%" PRIu32,
+                     handle );
+        AiaMutex( Unlock )( &speakerManager->mutex );
+        return;
+    }
+    removeActionLocked( speakerManager,
+                        speakerManager->actionSlots[ slotIndex ].position );
 
     AiaMutex( Unlock )( &speakerManager->mutex );
 }
@@ -2514,18 +6113,113 @@ static void AiaSpeakerManager_InvalidateActionsLocked(
         return;
     }
 
-    AiaListDouble( Link_t )* actionLink = NULL;
-    while( ( actionLink =
-                 AiaListDouble( PeekHead )( &speakerManager->offsetActions ) ) )
+    /* Sort the heap in place, latest action first, by moving each root past
+     * the end of the shrinking heap. */
+    size_t numActions = speakerManager->numActions;
+    while( speakerManager->numActions > 1 )
+    {
+        uint16_t first = speakerManager->actionHeap[ 0 ];
+        --speakerManager->numActions;
+        speakerManager->actionHeap[ 0 ] =
+            speakerManager->actionHeap[ speakerManager->numActions ];
+        siftActionDownLocked( speakerManager, 0 );
+        speakerManager->actionHeap[ speakerManager->numActions ] = first;
+    }
+
+    /* Truncate the heap and chain the slots in offset order through their
+     * positions, so that actions invoked below may schedule or cancel actions
+     * without disturbing the ones still to be invalidated. */
+    speakerManager->numActions = 0;
+    const size_t end = speakerManager->actionCapacity;
+    size_t next = end;
+    for( size_t i = 0; i < numActions; ++i )
+    {
+        AiaSpeakerOffsetActionSlot_t* slot =
+            &speakerManager->actionSlots[ speakerManager->actionHeap[ i ] ];
+        ++slot->generation;
+        slot->position = next;
+        next = speakerManager->actionHeap[ i ];
+    }
+
+    while( next != end )
+    {
+        AiaSpeakerOffsetActionSlot_t* slot =
+            &speakerManager->actionSlots[ next ];
+        AiaLogDebug( "Canceling action, offset=%" PRIu64, slot->offset );
+        AiaActionAtSpeakerOffset_t action = slot->action;
+        void* userData = slot->userData;
+        size_t slotIndex = next;
+        next = slot->position;
+        slot->action = NULL;
+        slot->userData = NULL;
+        slot->position = speakerManager->freeActionSlot;
+        speakerManager->freeActionSlot = slotIndex;
+        action( false, userData );
+    }
+}
+
+static void AiaSpeakerManager_FlushLocked(
+    AiaSpeakerManager_t* speakerManager )
+{
+    AiaSpeakerMarkerRing_Clear( &speakerManager->accumulatedMarkers );
+    AiaSpeakerGapRing_Clear( &speakerManager->gaps );
+    if( !AiaDataStreamReader_Seek(
+            speakerManager->speakerBufferReader, 0,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) )
+    {
+        AiaLogError( "Failed to seek to the writer." );
+    }
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    scheduleSpeakerBufferShrinkLocked( speakerManager );
+#endif
+    if( speakerManager->cold->flushSpeakerDataCb )
+    {
+        speakerManager->cold->flushSpeakerDataCb(
+            speakerManager->cold->flushSpeakerDataCbUserData );
+    }
+}
+
+void AiaSpeakerManager_GetMetrics( AiaSpeakerManager_t* speakerManager,
+                                   AiaSpeakerManagerMetrics_t* metrics )
+{
+    AiaAssert( speakerManager );
+    if( !speakerManager )
+    {
+        AiaLogError( "Null speakerManager." );
+        return;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
     {
-        AiaSpeakerOffsetActionSlot_t* actionInfo =
-            ( (AiaSpeakerOffsetActionSlot_t*)actionLink );
-        AiaLogDebug( "Canceling action, offset=%" PRIu64, actionInfo->offset );
-        actionInfo->action( false, actionInfo->userData );
-        AiaListDouble( Remove )( actionLink );
-        AiaFree( actionInfo );
+        AiaLogError( "Null metrics." );
+        return;
     }
-    actionLink = NULL;
+    metrics->bufferedBytes =
+        AiaDataStreamWriter_Tell( speakerManager->speakerBufferWriter ) -
+        AiaDataStreamReader_Tell(
+            speakerManager->speakerBufferReader,
+            AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE );
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    AiaMutex( Lock )( &speakerManager->mutex );
+    metrics->bufferSize =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+    AiaMutex( Unlock )( &speakerManager->mutex );
+#else
+    metrics->bufferSize =
+        AiaDataStreamBuffer_GetDataSize( speakerManager->speakerBuffer );
+#endif
+    uint32_t* transitions = speakerManager->cold->bufferStateTransitions;
+    metrics->underrunWarnings =
+        AiaAtomic_Load_u32( &transitions[ AIA_UNDERRUN_WARNING_STATE ] );
+    metrics->underruns =
+        AiaAtomic_Load_u32( &transitions[ AIA_UNDERRUN_STATE ] );
+    metrics->overrunWarnings =
+        AiaAtomic_Load_u32( &transitions[ AIA_OVERRUN_WARNING_STATE ] );
+    metrics->overruns = AiaAtomic_Load_u32( &transitions[ AIA_OVERRUN_STATE ] );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaHistogram_Snapshot( &speakerManager->cold->openToFirstFrameMs,
+                           &metrics->openToFirstFrameMs );
+#endif
 }
 
 static void AiaSpeakerManager_SetBufferStateLocked(
@@ -2539,13 +6233,23 @@ static void AiaSpeakerManager_SetBufferStateLocked(
         return;
     }
 
+    if( speakerManager->currentSpeakerState.currentBufferState !=
+        newBufferState )
+    {
+        AiaAtomic_Add_u32(
+            &speakerManager->cold->bufferStateTransitions[ newBufferState ],
+            1 );
+        speakerManager->currentSpeakerState.bufferStateEnteredMs =
+            AiaClock( GetTimeMs )();
+    }
+
     /* Notify the observers if only the speaker buffer state is being changed */
-    if( speakerManager->notifyObserversCb &&
+    if( speakerManager->cold->notifyObserversCb &&
         ( speakerManager->currentSpeakerState.currentBufferState !=
           newBufferState ) )
     {
-        speakerManager->notifyObserversCb(
-            speakerManager->notifyObserversCbUserData, newBufferState );
+        speakerManager->cold->notifyObserversCb(
+            speakerManager->cold->notifyObserversCbUserData, newBufferState );
     }
 
     AiaLogDebug( "Changing speaker manager buffer state from %s to %s",
@@ -26,6 +26,7 @@
 #include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_message.h>
 #include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_overload_governor.h>
 #include <aiacore/aia_topic.h>
 
 #ifdef AIA_ENABLE_SPEAKER
@@ -37,6 +38,12 @@
 
 #include AiaListDouble( HEADER )
 #include AiaMutex( HEADER )
+#include AiaTimer( HEADER )
+
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+/** How long UX state changes are coalesced while the observer is shed. */
+#define AIA_UX_OBSERVER_SHED_DELAY_MS 250
+#endif
 
 #ifdef AIA_ENABLE_SPEAKER
 /** Used to hold information about action callbacks related to an offset. */
@@ -87,6 +94,19 @@ struct AiaUXManager
     /** Context to pass along to @c observer. */
     void* const observerUserData;
 
+    /** The UX state last passed to @c observer. */
+    AiaUXState_t notifiedUXState;
+
+    /** Whether @c observer has been notified of any UX state yet. */
+    bool hasNotifiedUXState;
+
+    /** Whether @c observer is notified from @c observerWorker rather than from
+     * the context in which the UX state changed. */
+    bool isObserverAsync;
+
+    /** Whether @c observerWorker has been armed and has not yet run. */
+    bool isNotificationPending;
+
 #ifdef AIA_ENABLE_SPEAKER
     /** Collection of actions. */
     AiaListDouble_t offsetActions;
@@ -94,6 +114,13 @@ struct AiaUXManager
 
     /** @} */
 
+    /** Used to notify @c observer when @c isObserverAsync is set. */
+    AiaTimer_t observerWorker;
+
+    /** Serializes runs of @c observerWorker, so that notifications are
+     * delivered in order. */
+    AiaMutex_t observerMutex;
+
     /** Used to publish outbound events. */
     AiaRegulator_t* const eventRegulator;
 
@@ -112,6 +139,24 @@ struct AiaUXManager
  */
 static void AiaUXManager_AggregateStatesLocked( AiaUXManager_t* uxManager );
 
+/**
+ * Notifies @c observer of @c currentUXState if it differs from the state last
+ * notified, or schedules @c observerWorker to do so if @c isObserverAsync is
+ * set.
+ *
+ * @param uxManager The @c AiaUXManager_t to act on.
+ * @note @c mutex must be locked before invoking this method.
+ */
+static void AiaUXManager_NotifyObserverLocked( AiaUXManager_t* uxManager );
+
+/**
+ * A function run by @c observerWorker that notifies @c observer of the latest
+ * @c currentUXState outside of @c mutex.
+ *
+ * @param context The @c AiaUXManager_t to act on.
+ */
+static void AiaUXManager_NotifyObserverRoutine( void* context );
+
 /**
  * Converts a char array representing an Attention State string received in a
  * json directive to its corresponding enum value.
@@ -189,6 +234,24 @@ AiaUXManager_t* AiaUXManager_Create( AiaRegulator_t* eventRegulator,
         return NULL;
     }
 
+    if( !AiaMutex( Create )( &uxManager->observerMutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaMutex( Destroy )( &uxManager->mutex );
+        AiaFree( uxManager );
+        return NULL;
+    }
+
+    if( !AiaTimer( Create )( &uxManager->observerWorker,
+                             AiaUXManager_NotifyObserverRoutine, uxManager ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaMutex( Destroy )( &uxManager->observerMutex );
+        AiaMutex( Destroy )( &uxManager->mutex );
+        AiaFree( uxManager );
+        return NULL;
+    }
+
     *(AiaRegulator_t**)&uxManager->eventRegulator = eventRegulator;
     *(AiaUXStateObserverCb_t*)&uxManager->observer = stateObserver;
     *(void**)&uxManager->observerUserData = stateObserverUserData;
@@ -247,6 +310,11 @@ void AiaUXManager_Destroy( AiaUXManager_t* uxManager )
     AiaMutex( Unlock )( &uxManager->mutex );
 #endif
 
+    /* The notification routine locks @c mutex, so it must not be held while
+     * waiting for the routine to finish. */
+    AiaTimer( Destroy )( &uxManager->observerWorker );
+    AiaMutex( Destroy )( &uxManager->observerMutex );
+
     AiaMutex( Destroy )( &uxManager->mutex );
     AiaFree( uxManager );
 }
@@ -446,8 +514,7 @@ void AiaUXManager_AggregateStatesLocked( AiaUXManager_t* uxManager )
     if( uxManager->currentMicrophoneState == AIA_MICROPHONE_STATE_OPEN )
     {
         uxManager->currentUXState = AIA_UX_LISTENING;
-        uxManager->observer( uxManager->currentUXState,
-                             uxManager->observerUserData );
+        AiaUXManager_NotifyObserverLocked( uxManager );
         return;
     }
 #endif
@@ -478,10 +545,94 @@ void AiaUXManager_AggregateStatesLocked( AiaUXManager_t* uxManager )
             break;
     }
 
+    AiaUXManager_NotifyObserverLocked( uxManager );
+}
+
+void AiaUXManager_NotifyObserverLocked( AiaUXManager_t* uxManager )
+{
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    /* While overloaded, changes are coalesced and only the latest state is
+     * delivered, once per AIA_UX_OBSERVER_SHED_DELAY_MS. */
+    if( AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_UX_OBSERVER ) )
+    {
+        if( !uxManager->isNotificationPending )
+        {
+            uxManager->isNotificationPending = true;
+            if( !AiaTimer( Arm )( &uxManager->observerWorker,
+                                  AIA_UX_OBSERVER_SHED_DELAY_MS, 0 ) )
+            {
+                AiaLogError( "AiaTimer( Arm ) failed" );
+                uxManager->isNotificationPending = false;
+            }
+        }
+        return;
+    }
+#endif
+    if( uxManager->isObserverAsync )
+    {
+        if( !uxManager->isNotificationPending )
+        {
+            uxManager->isNotificationPending = true;
+            if( !AiaTimer( Arm )( &uxManager->observerWorker, 0, 0 ) )
+            {
+                AiaLogError( "AiaTimer( Arm ) failed" );
+                uxManager->isNotificationPending = false;
+            }
+        }
+        return;
+    }
+
+    if( uxManager->hasNotifiedUXState &&
+        uxManager->notifiedUXState == uxManager->currentUXState )
+    {
+        return;
+    }
+    uxManager->hasNotifiedUXState = true;
+    uxManager->notifiedUXState = uxManager->currentUXState;
     uxManager->observer( uxManager->currentUXState,
                          uxManager->observerUserData );
 }
 
+void AiaUXManager_NotifyObserverRoutine( void* context )
+{
+    AiaUXManager_t* uxManager = (AiaUXManager_t*)context;
+    AiaAssert( uxManager );
+    if( !uxManager )
+    {
+        AiaLogError( "Null uxManager" );
+        return;
+    }
+
+    AiaMutex( Lock )( &uxManager->observerMutex );
+    AiaMutex( Lock )( &uxManager->mutex );
+    uxManager->isNotificationPending = false;
+    AiaUXState_t state = uxManager->currentUXState;
+    bool hasChanged = !uxManager->hasNotifiedUXState ||
+                      uxManager->notifiedUXState != state;
+    uxManager->hasNotifiedUXState = true;
+    uxManager->notifiedUXState = state;
+    AiaMutex( Unlock )( &uxManager->mutex );
+
+    if( hasChanged )
+    {
+        uxManager->observer( state, uxManager->observerUserData );
+    }
+    AiaMutex( Unlock )( &uxManager->observerMutex );
+}
+
+void AiaUXManager_SetAsyncObserver( AiaUXManager_t* uxManager, bool isAsync )
+{
+    AiaAssert( uxManager );
+    if( !uxManager )
+    {
+        AiaLogError( "Null uxManager" );
+        return;
+    }
+    AiaMutex( Lock )( &uxManager->mutex );
+    uxManager->isObserverAsync = isAsync;
+    AiaMutex( Unlock )( &uxManager->mutex );
+}
+
 #ifdef AIA_ENABLE_SPEAKER
 
 void AiaUXManager_HandleSetAttentionStateAtOffset(
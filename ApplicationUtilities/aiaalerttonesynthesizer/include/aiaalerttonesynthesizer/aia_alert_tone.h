@@ -25,8 +25,14 @@ extern "C" {
 #endif
 #define AIA_ALERT_TONE_H_
 
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_utils.h>
+
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* TODO: ADSER-2383 Support different tones for each alert type during offline
  * alert playback */
@@ -35,7 +41,8 @@ extern "C" {
 /* clang-format off */
 /**
  * The pre-recorded alert tone (in raw PCM format) to play during offline alert
- * playback.
+ * playback. This is a single period of the tone, which loops seamlessly, and
+ * is placed in read-only memory.
  */
 static const int16_t AIA_ALERT_TONE[] = {
     INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN,
@@ -59,6 +66,35 @@ static const int16_t AIA_ALERT_TONE[] = {
 
 #define AIA_ALERT_TONE_FRAME_LENGTH AiaArrayLength( AIA_ALERT_TONE )
 
+/**
+ * Fills a buffer with the looping alert tone, continuing from where the
+ * previous call stopped so that consecutive buffers play back seamlessly. This
+ * only copies from @c AIA_ALERT_TONE, so buffers of any length, such as exactly
+ * one speaker push, can be produced at negligible cost.
+ *
+ * @param[out] samples The buffer to fill.
+ * @param numSamples The number of samples to write to @c samples.
+ * @param[in,out] position The offset into @c AIA_ALERT_TONE to continue from,
+ * which is updated for the next call. This should be zero when playback starts.
+ */
+static inline void AiaAlertTone_Fill( int16_t* samples, size_t numSamples,
+                                      size_t* position )
+{
+    while( numSamples )
+    {
+        size_t count = AIA_ALERT_TONE_FRAME_LENGTH - *position;
+        if( count > numSamples )
+        {
+            count = numSamples;
+        }
+        memcpy( samples, AIA_ALERT_TONE + *position,
+                count * sizeof( *samples ) );
+        samples += count;
+        numSamples -= count;
+        *position = ( *position + count ) % AIA_ALERT_TONE_FRAME_LENGTH;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
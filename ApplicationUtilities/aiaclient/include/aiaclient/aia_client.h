@@ -31,9 +31,19 @@ extern "C" {
 
 #include <aiaconnectionmanager/aia_connection_manager.h>
 #include <aiacore/aia_button_command.h>
+#include <aiacore/aia_directive.h>
+#include <aiacore/aia_histogram.h>
+#include <aiacore/aia_memory_budget.h>
+#include <aiacore/aia_mqtt_mux.h>
+#include <aiacore/aia_overload_governor.h>
+#include <aiacore/aia_session_trace.h>
 #include <aiacore/capabilities_sender/aia_capabilities_sender.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiaemitter/aia_emitter.h>
 #include <aiamicrophonemanager/aia_microphone_manager.h>
+#include <aiaregulator/aia_regulator.h>
+#include <aiasecretmanager/aia_secret_manager.h>
+#include <aiasequencer/aia_sequencer.h>
 #include <aiaspeakermanager/aia_speaker_manager.h>
 #include <aiauxmanager/aia_ux_manager.h>
 
@@ -41,6 +51,16 @@ extern "C" {
  * This type serves as the high level component that applications are expected
  * to interact with for Aia interactions. Methods of this object are
  * thread-safe.
+ *
+ * When built with the @c AIA_CLIENT_COMMAND_QUEUE option, @c
+ * AiaClient_StopSpeaker(), @c AiaClient_OnSpeakerReady(), the volume and
+ * microphone interaction calls, @c AiaClient_SynchronizeState() and @c
+ * AiaClient_OnButtonPressed() take no locks. They copy the call into a
+ * lock-free queue and return, and one job of the client applies queued calls
+ * in order. Application threads then never wait on the locks held by the MQTT
+ * and timer threads, and these calls are safe to make from the client's
+ * callbacks. Their return values only report whether the call was queued;
+ * failures to apply it are logged.
  */
 typedef struct AiaClient AiaClient_t;
 
@@ -69,9 +89,9 @@ typedef struct AiaClient AiaClient_t;
  * @param capabilitiesStateObserverUserData User data associated with the above
  *     callback.
  * @param receiveSpeakerFramesCb Callback to receive speaker from an internal
- *     buffer to the platform for playback every @c
- *     AIA_SPEAKER_FRAME_PUSH_CADENCE_MS. Implementations are expected to be
- *     non-blocking.
+ *     buffer to the platform for playback once per frame
+ *     duration (see @c AIA_SPEAKER_FRAME_PUSH_CADENCE_MS). Implementations are
+ *     expected to be non-blocking.
  * @param receiveSpeakerFramesCbUserData User data to be associated with the
  *     above callback.
  * @param setVolumeCb Callback used to change the client's volume.
@@ -83,6 +103,10 @@ typedef struct AiaClient AiaClient_t;
  * @param stopOfflineAlertCb Callback used to stop an offline alert tone.
  * @param stopOfflineAlertCbUserData User data to be associated with the above
  * callback.
+ * @param speakerBufferCapabilities With @c AIA_ENABLE_RUNTIME_SPEAKER_BUFFER,
+ * the size of the speaker buffer and its warning thresholds, which are also
+ * advertised in the @c Speaker capability. Pass NULL for @c
+ * AIA_AUDIO_BUFFER_SIZE and its thresholds from @c aia_capabilities_config.h.
  * @param uxObserver Callback to observe the current UX state to display to the
  * end user.
  * @param uxObserverUserData User data to be associated with the above
@@ -90,11 +114,23 @@ typedef struct AiaClient AiaClient_t;
  *     Aia cloud on user interactions. Data contained in the underlying
  *     buffer must be in 16-bit linear PCM, 16-kHz sample rate, single channel,
  *     little-endian byte order format.
+ * @param memoryBudget Optional budget charged for the directives buffered for
+ *     reordering, the events queued for publishing and the alerts held by the
+ *     client. This must outlive the client and may be shared with other
+ *     clients. Pass NULL to leave these bounded only by the heap.
+ * @param mqttMux Optional mux through which @c mqttConnection is shared with
+ *     other clients, each with its own device topic root. This must outlive the
+ *     client. Pass NULL when the client has the connection to itself.
  * @param enableLocalStopOnButtonPresses Flag used to enable local stops as an
  * optimization for button presses that stop or pause playback. @see
  * https://developer.amazon.com/en-US/docs/alexa/alexa-voice-service/avs-for-aws-iot-speaker.html#buttoncommandissued.
  * @return The newly created @c AiaClient_t if successful, or NULL
  *     otherwise.
+ * @note With the @c AIA_MEMORY_PREFAULT option, this prefaults the speaker
+ *     buffers, or the whole arena with @c AIA_MEMORY_ARENA, and locks them into
+ *     RAM if @c AIA_MEMORY_PREFAULT_LOCK is set. The microphone buffer behind
+ *     @c microphoneBufferReader is owned by the application, which can pass it
+ *     to @c AiaMemory_Prefault() itself.
  */
 AiaClient_t* AiaClient_Create(
     AiaMqttConnectionPointer_t mqttConnection,
@@ -113,6 +149,10 @@ AiaClient_t* AiaClient_Create(
     void* setVolumeCbUserData, AiaOfflineAlertPlayback_t playOfflineAlertCb,
     void* playOfflineAlertCbUserData, AiaOfflineAlertStop_t stopOfflineAlertCb,
     void* stopOfflineAlertCbUserData
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+    ,
+    const AiaSpeakerBufferCapabilities_t* speakerBufferCapabilities
+#endif
 #endif
     ,
     AiaUXStateObserverCb_t uxObserver, void* uxObserverUserData
@@ -120,6 +160,14 @@ AiaClient_t* AiaClient_Create(
     ,
     AiaDataStreamReader_t* microphoneBufferReader
 #endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    ,
+    AiaMemoryBudget_t* memoryBudget
+#endif
+#ifdef AIA_ENABLE_MQTT_MUX
+    ,
+    AiaMqttMux_t* mqttMux
+#endif
 );
 
 /**
@@ -141,6 +189,203 @@ void AiaClient_Destroy( AiaClient_t* aiaClient );
  */
 bool AiaClient_Connect( AiaClient_t* aiaClient );
 
+/**
+ * Like @c AiaClient_Connect(), but also brings the connection up to date
+ * without waiting on the application. Once connected, capabilities are
+ * published unless the same capabilities were accepted before, and as soon as
+ * they are accepted a @c SynchronizeState event and, if the clock capability is
+ * enabled, a @c SynchronizeClock event are published. @c onConnectionSuccess
+ * and @c capabilitiesStateObserver are still called along the way.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @return @c true if the connection is successful, @c false otherwise
+ * (including if already connected).
+ * @note Failures to publish after connecting are logged.
+ */
+bool AiaClient_ConnectAndBootstrap( AiaClient_t* aiaClient );
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+/**
+ * Lets the client keep its state across a short disconnection, e.g. while the
+ * device roams between access points. From a disconnection on, events are
+ * held instead of published, and the speaker keeps playing the audio it has
+ * buffered. If @c AiaClient_ReconnectWarm() is called within @c windowMs, the
+ * held events are published once connected, followed by the events which
+ * resynchronize the service with the speaker, and sequence numbers carry on
+ * from where they were. Otherwise the client should be destroyed and created
+ * again as after any disconnection. Warm reconnections are disabled by
+ * default.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param windowMs How long after a disconnection the state is kept, or @c 0 to
+ * disable warm reconnections. This should not exceed the time for which the
+ * service keeps the sequence numbers of a disconnected session.
+ * @return @c true if successful, @c false otherwise.
+ */
+bool AiaClient_SetWarmReconnectWindow( AiaClient_t* aiaClient,
+                                       AiaDurationMs_t windowMs );
+
+/**
+ * Like @c AiaClient_Connect(), but keeps the state held since the last
+ * disconnection, see @c AiaClient_SetWarmReconnectWindow(). This may be
+ * called from @c onDisconnected. Disconnections caused by errors, such as @c
+ * AIA_CONNECTION_ON_DISCONNECTED_UNEXPECTED_SEQUENCE_NUMBER, should not be
+ * resumed this way.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @return @c true if the connection request is sent, @c false otherwise
+ * (including if the warm reconnect window has elapsed, in which case the
+ * client should be created again).
+ */
+bool AiaClient_ReconnectWarm( AiaClient_t* aiaClient );
+#endif
+
+/** How much memory @c AiaClient_TrimMemory() releases. */
+typedef enum AiaClientTrimLevel
+{
+    /** Releases the buffers used for speaker and microphone interactions: the
+     * buffers messages are reordered in, the buffer speaker frames are staged
+     * in and the buffers microphone messages are assembled in. */
+    AIA_CLIENT_TRIM_MEMORY_IDLE,
+
+    /** Also releases the buffers events and capabilities are assembled in,
+     * which are allocated again by the next event published. */
+    AIA_CLIENT_TRIM_MEMORY_COMPLETE
+} AiaClientTrimLevel_t;
+
+/**
+ * Releases buffers which the client re-creates when they are next used, e.g.
+ * when the device is idle or the application is short of memory. Buffers in
+ * use are kept, so this is best called while the UX state is @c AIA_UX_IDLE.
+ * The cost of re-creating them is one allocation per buffer, made when the
+ * next message is reordered, the speaker is next opened or the microphone
+ * next streams.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param level How much memory to release.
+ * @return The number of bytes released.
+ * @note The Opus decoder and encoder are owned by the application, which may
+ * release them itself.
+ */
+size_t AiaClient_TrimMemory( AiaClient_t* aiaClient,
+                             AiaClientTrimLevel_t level );
+
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+/**
+ * Sets how long the UX state must stay @c AIA_UX_IDLE before the client calls
+ * @c AiaClient_TrimMemory() with @c AIA_CLIENT_TRIM_MEMORY_IDLE by itself. This
+ * is @c AIA_CLIENT_IDLE_MEMORY_TRIM_DELAY_MS by default.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param delayMs The idle time before memory is trimmed, or @c 0 to disable
+ * trimming memory when idle.
+ * @return @c true if successful, @c false otherwise.
+ */
+bool AiaClient_SetIdleMemoryTrimDelay( AiaClient_t* aiaClient,
+                                       AiaDurationMs_t delayMs );
+#endif
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+/**
+ * Declares that the client has reached steady state, i.e. that it has been
+ * connected and has streamed audio both ways, so its pools and buffers are in
+ * place. From then on, every @c AiaCalloc() made on the SDK's audio hot paths
+ * is recorded, see @c AiaMemoryGuard_GetCallSites(), and asserted on unless
+ * built with @c NDEBUG.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @note The guard is shared by every client in the process.
+ */
+void AiaClient_MarkSteadyState( AiaClient_t* aiaClient );
+#endif
+
+/**
+ * Sets whether a queued event with the given supersede key is replaced by a
+ * newer one with the same key, e.g. @c
+ * AIA_EVENTS_VOLUME_CHANGED_SUPERSEDE_KEY.  This is enabled for every key by
+ * default, except @c AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED_SUPERSEDE_KEY when
+ * built with the @c AIA_EVENT_EXPIRY option; disable it for keys whose every
+ * transition must reach the service.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param key The supersede key to configure.
+ * @param isEnabled @c true to only send the latest queued event of @c key.
+ * @return @c true if successful, @c false otherwise.
+ */
+bool AiaClient_SetEventCoalescing( AiaClient_t* aiaClient,
+                                   AiaMessageSupersedeKey_t key,
+                                   bool isEnabled );
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+/**
+ * Sets how long a queued event with the given supersede key may wait to be
+ * published before it is dropped, e.g. after a long disconnect.  Buffer state,
+ * volume and speaker marker events default to @c
+ * AIA_CLIENT_STALE_EVENT_MAX_AGE_MS, and other events never expire.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param key The supersede key to configure.
+ * @param maxAgeMs The maximum age, or @c 0 for events of @c key to never
+ * expire.
+ * @return @c true if successful, @c false otherwise.
+ */
+bool AiaClient_SetEventMaxAge( AiaClient_t* aiaClient,
+                               AiaMessageSupersedeKey_t key,
+                               AiaDurationMs_t maxAgeMs );
+#endif
+
+/** Version of the @c AiaClientSession_t layout. */
+#define AIA_CLIENT_SESSION_VERSION 1
+
+/**
+ * The state of an @c AiaClient_t worth keeping across deep sleep, so that a
+ * client created on wake can go straight to @c AiaClient_ConnectAndBootstrap()
+ * and resume with a single connect. This is plain data of a fixed size which
+ * may be kept in memory that survives sleep or stored as a single blob.
+ *
+ * Sequence numbers and secrets are not part of a session, as every connection
+ * starts over from sequence number zero with the most recently persisted
+ * secret, which the client loads on creation. Alerts are persisted as they
+ * change and are also loaded on creation.
+ */
+typedef struct AiaClientSession
+{
+    /** Set to @c AIA_CLIENT_SESSION_VERSION. */
+    uint32_t version;
+
+    /** Digest of the capabilities, if @c isCapabilitiesAccepted. */
+    uint32_t capabilitiesDigest;
+
+    /** Whether the capabilities had been accepted. */
+    bool isCapabilitiesAccepted;
+
+    /** The speaker volume, which may not have been persisted yet. */
+    uint8_t volume;
+} AiaClientSession_t;
+
+/**
+ * Saves the state of the client for @c AiaClient_RestoreSession(), typically
+ * just before entering deep sleep.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param[out] session The saved session.
+ * @return @c true if the session was saved or @c false otherwise.
+ */
+bool AiaClient_SaveSession( AiaClient_t* aiaClient,
+                            AiaClientSession_t* session );
+
+/**
+ * Restores a session saved by @c AiaClient_SaveSession() on a newly created
+ * client, before connecting it. Capabilities accepted in the session are not
+ * published again, unless the capabilities have changed since.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param session The saved session.
+ * @return @c true if the session was restored or @c false if it is invalid.
+ */
+bool AiaClient_RestoreSession( AiaClient_t* aiaClient,
+                               const AiaClientSession_t* session );
+
 /**
  * @copydoc AiaDisconnectHandler_t
  */
@@ -184,6 +429,19 @@ void AiaClient_StopSpeaker( AiaClient_t* aiaClient );
  */
 void AiaClient_OnSpeakerReady( AiaClient_t* aiaClient );
 
+/**
+ * Provides applications a way to report how long speaker frames take to be
+ * heard once pushed via @c receiveSpeakerFramesCb, so that speaker markers and
+ * offset actions are handled when their audio is heard.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param latencyMs The time between a frame being pushed and being heard.
+ * @note Unlike other calls, this is never queued, so it may be called from @c
+ * receiveSpeakerFramesCb.
+ */
+void AiaClient_SetSpeakerPlayoutLatency( AiaClient_t* aiaClient,
+                                         AiaDurationMs_t latencyMs );
+
 /**
  * Provides applications a way to request a volume change as a result of a local
  * trigger such as a physical button or GUI affordance that changes the volume
@@ -279,6 +537,39 @@ bool AiaClient_WakeWordStart( AiaClient_t* aiaClient,
                               AiaDataStreamIndex_t endIndex,
                               AiaMicrophoneProfile_t profile,
                               const char* wakeWord );
+
+/**
+ * Configures the pre-processing applied to microphone samples before they are
+ * streamed, saving applications a copy of the audio to do it themselves.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param processing The processing to apply, or @c NULL to disable processing.
+ * @return @c true if the configuration was applied or @c false otherwise.
+ */
+bool AiaClient_SetMicrophoneProcessing(
+    AiaClient_t* aiaClient, const AiaMicrophoneProcessing_t* processing );
+
+/**
+ * Reports the energy of the most recently streamed microphone chunk.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param[out] energy The energy of the last chunk.
+ * @return @c true if @c energy was filled in or @c false otherwise.
+ */
+bool AiaClient_GetMicrophoneEnergy( AiaClient_t* aiaClient,
+                                    AiaPcmEnergy_t* energy );
+
+/**
+ * Installs an encoder for streamed microphone samples, such as the one provided
+ * by aiaopusencoder. This must be done before the first interaction when @c
+ * AIA_MICROPHONE_AUDIO_ENCODER_FORMAT is not linear PCM.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param encoder The encoder to use, or @c NULL to stream linear PCM.
+ * @return @c true if the encoder was installed or @c false otherwise.
+ */
+bool AiaClient_SetMicrophoneEncoder( AiaClient_t* aiaClient,
+                                     const AiaMicrophoneEncoder_t* encoder );
 #endif
 
 /* TODO: ADSER-1691 Handle SynchronizeState publishing internally */
@@ -293,6 +584,16 @@ bool AiaClient_WakeWordStart( AiaClient_t* aiaClient,
  */
 bool AiaClient_SynchronizeState( AiaClient_t* aiaClient );
 
+/**
+ * Selects whether the UX state observer passed to @c AiaClient_Create() is
+ * called asynchronously from a separate job, with pending changes coalesced.
+ * This keeps slow LED or display drivers off the audio and directive paths.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param isAsync Whether to notify the UX state observer asynchronously.
+ */
+void AiaClient_SetAsyncUXStateObserver( AiaClient_t* aiaClient, bool isAsync );
+
 /**
  * Provides applications a way to inform AIA of a user-initiated button press.
  *
@@ -314,6 +615,125 @@ bool AiaClient_OnButtonPressed( AiaClient_t* aiaClient,
 bool AiaClient_SynchronizeClock( AiaClient_t* aiaClient );
 #endif
 
+/**
+ * A snapshot of the counters kept by the components of an @c AiaClient_t.
+ * Counters are cumulative since @c AiaClient_Create() and wrap on overflow, so
+ * rates should be computed from the difference between two snapshots. Builds
+ * with @c AIA_ENABLE_MUTEX_STATS also count the contention of every SDK mutex,
+ * for all clients at once, which is read with @c AiaMutexStats_Get(). Builds
+ * with @c AIA_ENABLE_LATENCY_HISTOGRAMS also keep an @c AiaHistogram_t of each
+ * key latency, which @c AiaHistogram_Serialize() encodes for uplinking.
+ */
+typedef struct AiaClientMetrics
+{
+    /** Sequencing of inbound @c AIA_TOPIC_DIRECTIVE messages. */
+    AiaSequencerMetrics_t directiveSequencer;
+
+#ifdef AIA_ENABLE_SPEAKER
+    /** Sequencing of inbound @c AIA_TOPIC_SPEAKER messages. */
+    AiaSequencerMetrics_t speakerSequencer;
+
+    /** The speaker buffer. */
+    AiaSpeakerManagerMetrics_t speaker;
+#endif
+
+    /** Outbound @c AIA_TOPIC_EVENT messages waiting to be published. */
+    AiaRegulatorMetrics_t eventRegulator;
+
+    /** Publishing of @c AIA_TOPIC_EVENT messages. */
+    AiaEmitterMetrics_t eventEmitter;
+
+#ifdef AIA_ENABLE_MICROPHONE
+    /** Outbound @c AIA_TOPIC_MICROPHONE messages waiting to be published. */
+    AiaRegulatorMetrics_t microphoneRegulator;
+
+    /** Publishing of @c AIA_TOPIC_MICROPHONE messages. */
+    AiaEmitterMetrics_t microphoneEmitter;
+
+    /** Microphone streaming. */
+    AiaMicrophoneManagerMetrics_t microphone;
+#endif
+
+    /** Encryption and decryption of all topics. */
+    AiaSecretManagerMetrics_t crypto;
+
+    /** The Aia connection. */
+    AiaConnectionManagerMetrics_t connection;
+
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    /** How long the handler of each directive took to run, in milliseconds,
+     * indexed by @c AiaDirective_t. */
+    AiaHistogram_t directiveHandlingTimesMs[ AIA_NUM_DIRECTIVES ];
+#endif
+
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    /** The work currently shed by the overload governor, as returned by @c
+     * AiaOverloadGovernor_GetLevel(). */
+    uint32_t overloadLevel;
+#endif
+} AiaClientMetrics_t;
+
+/**
+ * Takes a snapshot of the counters kept by the components of @c aiaClient.
+ * Collecting them is cheap enough to do periodically in production: most are
+ * relaxed atomic loads, and the regulator queues are read under their own
+ * mutexes only.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param[out] metrics The counters of @c aiaClient.
+ * @return @c true if @c metrics was filled in or @c false otherwise.
+ */
+bool AiaClient_GetMetrics( AiaClient_t* aiaClient,
+                           AiaClientMetrics_t* metrics );
+
+/**
+ * Chooses the MQTT keepalive interval to request when (re)connecting the MQTT
+ * connection used by @c aiaClient.  The keepalive of a live connection is
+ * owned by the MQTT library, so applications that tear down the connection
+ * while idle (e.g. before deep sleep or after losing the network) should call
+ * this when reconnecting to avoid PINGREQs they do not need.
+ *
+ * @param aiaClient The @c AiaClient_t to act on, or @c NULL before it exists.
+ * @return @c AIA_MQTT_KEEPALIVE_QUIET_SECONDS if the UX state is @c
+ * AIA_UX_IDLE and nothing was published within the last @c
+ * AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS, or @c AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS
+ * otherwise.
+ */
+uint16_t AiaClient_GetMqttKeepAliveSeconds( AiaClient_t* aiaClient );
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+/**
+ * Sets an observer passed the plaintext of every message @c aiaClient handles
+ * from the service, to record sessions with. Each message is passed once it
+ * has been sequenced and decrypted, and before it is handled. Recordings can
+ * be written with the functions of @c aia_session_trace.h and replayed with
+ * @c AiaClient_ReplayMessage().
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param observer The observer, or @c NULL to stop observing. It is called on
+ * the threads handling each topic, so it must be thread-safe.
+ * @param userData Context passed to @c observer.
+ * @return @c true if the observer was set or @c false otherwise.
+ * @note Call this before @c AiaClient_Connect(). While an observer is set,
+ * speaker audio is decrypted through an intermediate buffer.
+ */
+bool AiaClient_SetPlaintextObserver( AiaClient_t* aiaClient,
+                                     AiaSessionTraceObserver_t observer,
+                                     void* userData );
+
+/**
+ * Hands @c aiaClient a recorded message as though it had just been received
+ * from the service, sequenced and decrypted. Messages must be replayed in the
+ * order they were recorded.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @param record The recorded message.
+ * @return @c true if the message was handled or @c false otherwise.
+ */
+bool AiaClient_ReplayMessage( AiaClient_t* aiaClient,
+                              const AiaSessionTraceRecord_t* record );
+#endif
+
 #ifdef AIA_ENABLE_ALERTS
 /**
  * Provides applications a way to delete an alert from memory and local storage.
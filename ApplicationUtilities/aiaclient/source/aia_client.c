@@ -29,8 +29,11 @@
 #include <aiacore/aia_button_command_sender.h>
 #include <aiacore/aia_directive.h>
 #include <aiacore/aia_events.h>
+#include <aiacore/aia_exception_limiter.h>
 #include <aiacore/aia_json_constants.h>
 #include <aiacore/aia_json_message.h>
+#include <aiacore/aia_startup_trace.h>
+#include <aiacore/aia_volume_constants.h>
 #include <aiacore/capabilities_sender/aia_capabilities_sender.h>
 
 #include <aiaalertmanager/private/aia_alert_manager.h>
@@ -50,8 +53,23 @@
 #include <aiauxmanager/aia_ux_manager.h>
 #include <aiauxmanager/private/aia_ux_manager.h>
 
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+#include <aiacore/aia_mpsc_queue.h>
+#endif
+
+#include AiaClock( HEADER )
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+#include AiaMutex( HEADER )
+#endif
+#if defined( AIA_ENABLE_CLIENT_COMMAND_QUEUE ) || \
+    defined( AIA_ENABLE_IDLE_MEMORY_TRIM )
+#include AiaTimer( HEADER )
+#endif
+
 #include <inttypes.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 /**
  * Glue function which routes messages coming from an @c AiaRegulator_t to the
@@ -103,6 +121,25 @@ static void destroyJsonChunk( AiaRegulatorChunk_t* chunk, void* userData )
     }
 }
 
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+/**
+ * Serializes JSON messages as they are written to an @c AiaRegulator_t, so that
+ * its timer thread only needs to copy them.
+ *
+ * @param chunk The @c AiaJsonMessage_t being written.
+ * @param userData Optional user data pointer which is ignored by this
+ *     implementation.
+ */
+static void stageJsonChunk( AiaRegulatorChunk_t* chunk, void* userData )
+{
+    (void)userData;
+    if( !AiaJsonMessage_Serialize( AiaJsonMessage_FromMessage( chunk ) ) )
+    {
+        AiaLogWarn( "Failed to serialize, message will be built on emit." );
+    }
+}
+#endif
+
 /**
  * Cleanup function for binary messages that an @c AiaRegulator_t needs to
  * dispose of.
@@ -120,6 +157,18 @@ static void destroyBinaryChunk( AiaRegulatorChunk_t* chunk, void* userData )
     }
 }
 
+/**
+ * Glue function which releases the buffers of the @c AiaEmitter_t fed by an
+ * @c AiaRegulator_t.
+ *
+ * @param userData A pointer to the emitter to act on.
+ * @return The number of bytes released.
+ */
+static size_t trimEmitterMemory( void* userData )
+{
+    return AiaEmitter_TrimMemory( (AiaEmitter_t*)userData );
+}
+
 /**
  * @copydoc AiaGetNextSequenceNumber
  */
@@ -136,6 +185,42 @@ static bool AiaClient_EmitEvent( AiaRegulatorChunk_t* chunk, void* userData );
  */
 static void AiaClient_StopPlayback( void* userData );
 
+#ifdef AIA_ENABLE_MICROPHONE
+/**
+ * Routes microphone messages from @c microphoneRegulator to @c
+ * microphoneEmitter, and flushes the events held in @c eventRegulator once a
+ * message is out, since the radio has just been woken to send it.
+ *
+ * @copydoc AiaRegulatorEmitMessageChunkCallback_t
+ */
+static bool AiaClient_EmitMicrophoneMessageChunk(
+    AiaRegulatorChunk_t* chunkForMessage, size_t remainingBytes,
+    size_t remainingChunks, void* userData );
+#endif
+
+/**
+ * @copydoc AiaConnectionManageronConnectionSuccessCallback_t
+ */
+static void AiaClient_OnConnectionSuccess( void* userData );
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+/**
+ * Holds the events queued in @c eventRegulator while disconnected, so that a
+ * warm reconnection can publish them, and notifies the application.
+ *
+ * @copydoc AiaConnectionManagerOnDisconnectedCallback_t
+ */
+static void AiaClient_OnDisconnected( void* userData,
+                                      AiaConnectionOnDisconnectCode_t code );
+#endif
+
+/**
+ * @copydoc AiaCapabilitiesObserver_t
+ */
+static void AiaClient_OnCapabilitiesStateChanged(
+    AiaCapabilitiesSenderState_t state, const char* description,
+    size_t descriptionLen, void* userData );
+
 /**
  * @copydoc AiaClockManagerNotifyObserver_t
  */
@@ -180,6 +265,111 @@ static bool AiaClient_StartOfflineAlertTone( const AiaAlertSlot_t* offlineAlert,
                                              uint8_t offlineAlertVolume );
 #endif
 
+/** The steps of @c AiaClient_ConnectAndBootstrap(). */
+typedef enum AiaClientBootstrapStage
+{
+    /** No bootstrap is in progress. */
+    AIA_CLIENT_BOOTSTRAP_IDLE,
+
+    /** Waiting for the connection to be acknowledged. */
+    AIA_CLIENT_BOOTSTRAP_CONNECTING,
+
+    /** Waiting for capabilities to be accepted. */
+    AIA_CLIENT_BOOTSTRAP_PUBLISHING_CAPABILITIES
+} AiaClientBootstrapStage_t;
+
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+/** The public calls which are queued to be applied by @c commandWorker. */
+typedef enum AiaClientCommandType
+{
+#ifdef AIA_ENABLE_SPEAKER
+    /** @c AiaClient_StopSpeaker() */
+    AIA_CLIENT_COMMAND_STOP_SPEAKER,
+
+    /** @c AiaClient_OnSpeakerReady() */
+    AIA_CLIENT_COMMAND_SPEAKER_READY,
+
+    /** @c AiaClient_ChangeVolume() */
+    AIA_CLIENT_COMMAND_CHANGE_VOLUME,
+
+    /** @c AiaClient_AdjustVolume() */
+    AIA_CLIENT_COMMAND_ADJUST_VOLUME,
+#endif
+#ifdef AIA_ENABLE_MICROPHONE
+    /** @c AiaClient_HoldToTalkStart() */
+    AIA_CLIENT_COMMAND_HOLD_TO_TALK_START,
+
+    /** @c AiaClient_CloseMicrophone() */
+    AIA_CLIENT_COMMAND_CLOSE_MICROPHONE,
+
+    /** @c AiaClient_TapToTalkStart() */
+    AIA_CLIENT_COMMAND_TAP_TO_TALK_START,
+
+    /** @c AiaClient_WakeWordStart() */
+    AIA_CLIENT_COMMAND_WAKE_WORD_START,
+#endif
+    /** @c AiaClient_OnButtonPressed() */
+    AIA_CLIENT_COMMAND_BUTTON_PRESSED,
+
+    /** @c AiaClient_SynchronizeState() */
+    AIA_CLIENT_COMMAND_SYNCHRONIZE_STATE
+} AiaClientCommandType_t;
+
+/** A public call and its arguments, copied into @c commandQueue. */
+typedef struct AiaClientCommand
+{
+    /** The call to apply. */
+    AiaClientCommandType_t type;
+
+    /** The volume of @c AIA_CLIENT_COMMAND_CHANGE_VOLUME. */
+    uint8_t volume;
+
+    /** The delta of @c AIA_CLIENT_COMMAND_ADJUST_VOLUME. */
+    int8_t volumeDelta;
+
+    /** The button of @c AIA_CLIENT_COMMAND_BUTTON_PRESSED. */
+    AiaButtonCommand_t button;
+
+#ifdef AIA_ENABLE_MICROPHONE
+    /** The index microphone commands start streaming from. */
+    AiaDataStreamIndex_t beginIndex;
+
+    /** The end of the wake word of @c AIA_CLIENT_COMMAND_WAKE_WORD_START. */
+    AiaDataStreamIndex_t endIndex;
+
+    /** The profile of tap to talk and wake word interactions. */
+    AiaMicrophoneProfile_t profile;
+#endif
+} AiaClientCommand_t;
+
+/**
+ * Queues a public call to be applied by @c commandWorker, without taking any
+ * lock.
+ *
+ * @param client The @c AiaClient_t to act on.
+ * @param command The call to queue.
+ * @return @c true if the call was queued, or @c false if the queue is full.
+ */
+static bool AiaClient_QueueCommand( AiaClient_t* client,
+                                    const AiaClientCommand_t* command );
+
+/**
+ * Applies the calls queued in an @c AiaClient_t, in the order they were made.
+ *
+ * @param context The @c AiaClient_t to act on.
+ */
+static void AiaClient_CommandRoutine( void* context );
+#endif
+
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+/**
+ * Trims memory if the UX state has stayed idle for @c idleMemoryTrimDelayMs.
+ *
+ * @param context The @c AiaClient_t to act on.
+ */
+static void AiaClient_IdleMemoryTrimRoutine( void* context );
+#endif
+
 /** Holds state information for an @c AiaClient_t instance. */
 struct AiaClient
 {
@@ -207,6 +397,10 @@ struct AiaClient
     /** Manages exceptions */
     AiaExceptionManager_t* exceptionManager;
 
+    /** Rate limits the @c MALFORMED_MESSAGE events of @c dispatcher and @c
+     * exceptionManager. */
+    AiaExceptionLimiter_t* exceptionLimiter;
+
     /** Used to parse and distribute messages on subscribed topics. */
     AiaDispatcher_t* dispatcher;
 
@@ -224,6 +418,42 @@ struct AiaClient
     /** Context to pass along to @c uxStateObserverCb. */
     void* const uxStateObserverCbUserData;
 
+    /** Connection success callback for the application. */
+    AiaConnectionManageronConnectionSuccessCallback_t const
+        onConnectionSuccessCb;
+
+    /** Context to pass along to @c onConnectionSuccessCb. */
+    void* const onConnectionSuccessCbUserData;
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    /** Disconnection callback for the application, passed @c
+     * onConnectionSuccessCbUserData. */
+    AiaConnectionManagerOnDisconnectedCallback_t const onDisconnectedCb;
+
+    /** How long after a disconnection @c AiaClient_ReconnectWarm() may be
+     * called, in milliseconds, or @c 0 if warm reconnections are disabled.
+     * This should only be accessed using atomic operations. */
+    uint32_t warmReconnectWindowMs;
+
+    /** The low 32 bits of the time of the last disconnection, in
+     * milliseconds. This should only be accessed using atomic operations. */
+    uint32_t disconnectedAtMs;
+
+    /** Whether the state kept since the last disconnection must be
+     * resynchronized once connected. */
+    AiaAtomicBool_t isWarmReconnectPending;
+#endif
+
+    /** Capabilities state observer callback for the application. */
+    AiaCapabilitiesObserver_t const capabilitiesStateObserverCb;
+
+    /** Context to pass along to @c capabilitiesStateObserverCb. */
+    void* const capabilitiesStateObserverCbUserData;
+
+    /** The @c AiaClientBootstrapStage_t of @c AiaClient_ConnectAndBootstrap().
+     * This should only be accessed using atomic operations. */
+    uint32_t bootstrapStage;
+
 #ifdef AIA_ENABLE_ALERTS
     /** Manages alert messages flowing on @c AIA_TOPIC_DIRECTIVE. */
     AiaAlertManager_t* alertManager;
@@ -247,6 +477,124 @@ struct AiaClient
     /** Used to synchronize the device's clock with the AIA service. */
     AiaClockManager_t* clockManager;
 #endif
+
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    /** Timer group of the thread which called @c AiaClient_Create(). */
+    const void* previousTimerGroup;
+#endif
+
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    /** Public calls waiting to be applied by @c commandWorker. */
+    AiaMpscQueue_t* commandQueue;
+
+    /** Job which applies the calls in @c commandQueue, the only consumer of
+     * the queue. */
+    AiaTimer_t commandWorker;
+
+    /** Serializes runs of @c commandWorker. */
+    AiaMutex_t commandWorkerMutex;
+
+    /** Whether @c commandWorker has been armed and not yet started draining
+     * @c commandQueue. */
+    AiaAtomicBool_t isCommandPending;
+#endif
+
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+    /** Job which trims memory once the UX state has been idle for @c
+     * idleMemoryTrimDelayMs. */
+    AiaTimer_t idleMemoryTrimTimer;
+
+    /** Whether @c idleMemoryTrimTimer has been created. */
+    bool hasIdleMemoryTrimTimer;
+
+    /** How long the UX state must stay idle before memory is trimmed, in
+     * milliseconds, or @c 0 if it is not trimmed. This should only be accessed
+     * using atomic operations. */
+    uint32_t idleMemoryTrimDelayMs;
+
+    /** The low 32 bits of the time the UX state last became idle, in
+     * milliseconds. This should only be accessed using atomic operations. */
+    uint32_t idleSinceMs;
+#endif
+};
+
+/** A directive handler and the @c AiaClient_t field holding its manager. */
+typedef struct AiaClientDirectiveHandler
+{
+    /** The directive handled by @c handler. */
+    AiaDirective_t directive;
+
+    /** The handler to add to the dispatcher. */
+    AiaDirectiveHandler_t handler;
+
+    /** The offset in @c struct @c AiaClient of the manager to pass to @c
+     * handler. */
+    size_t managerOffset;
+} AiaClientDirectiveHandler_t;
+
+/**
+ * Declares the @c DIRECTIVE_HANDLERS entry for a directive.
+ *
+ * @param DIRECTIVE The @c AiaDirective_t value.
+ * @param HANDLER The handler of @c DIRECTIVE.
+ * @param MANAGER The @c AiaClient_t field passed to @c HANDLER.
+ */
+#define AIA_CLIENT_DIRECTIVE_HANDLER( DIRECTIVE, HANDLER, MANAGER ) \
+    {                                                               \
+        DIRECTIVE, HANDLER, offsetof( struct AiaClient, MANAGER )  \
+    }
+
+/**
+ * The directive handlers added to the dispatcher, resolved at compile time
+ * from the enabled capabilities so that disabled ones take no code or data.
+ */
+static const AiaClientDirectiveHandler_t DIRECTIVE_HANDLERS[] = {
+#ifdef AIA_ENABLE_SPEAKER
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_OPEN_SPEAKER,
+        AiaSpeakerManager_OnOpenSpeakerDirectiveReceived, speakerManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_CLOSE_SPEAKER,
+        AiaSpeakerManager_OnCloseSpeakerDirectiveReceived, speakerManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_SET_VOLUME,
+        AiaSpeakerManager_OnSetVolumeDirectiveReceived, speakerManager ),
+#endif
+#ifdef AIA_ENABLE_ALERTS
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_SET_ALERT_VOLUME,
+        AiaAlertManager_OnSetAlertVolumeDirectiveReceived, alertManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER( AIA_DIRECTIVE_SET_ALERT,
+                                  AiaAlertManager_OnSetAlertDirectiveReceived,
+                                  alertManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_DELETE_ALERT,
+        AiaAlertManager_OnDeleteAlertDirectiveReceived, alertManager ),
+#endif
+#ifdef AIA_ENABLE_MICROPHONE
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_OPEN_MICROPHONE,
+        AiaMicrophoneManager_OnOpenMicrophoneDirectiveReceived,
+        microphoneManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_CLOSE_MICROPHONE,
+        AiaMicrophoneManager_OnCloseMicrophoneDirectiveReceived,
+        microphoneManager ),
+#endif
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_SET_ATTENTION_STATE,
+        AiaUXManager_OnSetAttentionStateDirectiveReceived, uxManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER(
+        AIA_DIRECTIVE_ROTATE_SECRET,
+        AiaSecretManager_OnRotateSecretDirectiveReceived, secretManager ),
+    AIA_CLIENT_DIRECTIVE_HANDLER( AIA_DIRECTIVE_EXCEPTION,
+                                  AiaExceptionManager_OnExceptionReceived,
+                                  exceptionManager ),
+#ifdef AIA_ENABLE_CLOCK
+    AIA_CLIENT_DIRECTIVE_HANDLER( AIA_DIRECTIVE_SET_CLOCK,
+                                  AiaClockManager_OnSetClockDirectiveReceived,
+                                  clockManager ),
+#endif
 };
 
 AiaClient_t* AiaClient_Create(
@@ -266,6 +614,10 @@ AiaClient_t* AiaClient_Create(
     void* setVolumeCbUserData, AiaOfflineAlertPlayback_t playOfflineAlertCb,
     void* playOfflineAlertCbUserData, AiaOfflineAlertStop_t stopOfflineAlertCb,
     void* stopOfflineAlertCbUserData
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+    ,
+    const AiaSpeakerBufferCapabilities_t* speakerBufferCapabilities
+#endif
 #endif
     ,
     AiaUXStateObserverCb_t uxObserver, void* uxObserverUserData
@@ -273,6 +625,14 @@ AiaClient_t* AiaClient_Create(
     ,
     AiaDataStreamReader_t* microphoneBufferReader
 #endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    ,
+    AiaMemoryBudget_t* memoryBudget
+#endif
+#ifdef AIA_ENABLE_MQTT_MUX
+    ,
+    AiaMqttMux_t* mqttMux
+#endif
 )
 {
     if( !mqttConnection )
@@ -288,11 +648,29 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
 
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    /* Timers created below are serviced fairly against other clients'. */
+    client->previousTimerGroup = AiaTimerService_SetCurrentGroup( client );
+#endif
+
     *(AiaUXStateObserverCb_t*)&client->uxStateObserverCb = uxObserver;
     *(void**)&client->uxStateObserverCbUserData = uxObserverUserData;
+    *(AiaConnectionManageronConnectionSuccessCallback_t*)&client
+         ->onConnectionSuccessCb = onConnectionSuccess;
+    *(void**)&client->onConnectionSuccessCbUserData = connectionUserData;
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    *(AiaConnectionManagerOnDisconnectedCallback_t*)&client->onDisconnectedCb =
+        onDisconnected;
+#endif
+    *(AiaCapabilitiesObserver_t*)&client->capabilitiesStateObserverCb =
+        capabilitiesStateObserver;
+    *(void**)&client->capabilitiesStateObserverCbUserData =
+        capabilitiesStateObserverUserData;
 
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_SECRET_MANAGER );
     *(AiaSecretManager_t**)&client->secretManager = AiaSecretManager_Create(
         AiaClient_GetNextSequenceNumber, client, AiaClient_EmitEvent, client );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_SECRET_MANAGER );
     if( !client->secretManager )
     {
         AiaLogError( "AiaSecretManager_Create failed to create secretManager" );
@@ -300,6 +678,7 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
 
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_EVENT_PUBLISHING );
     *(AiaEmitter_t**)&client->eventEmitter = AiaEmitter_Create(
         mqttConnection, client->secretManager, AIA_TOPIC_EVENT );
     if( !client->eventEmitter )
@@ -308,6 +687,23 @@ AiaClient_t* AiaClient_Create(
         AiaClient_Destroy( client );
         return NULL;
     }
+#ifdef AIA_ENABLE_EVENT_QOS1
+    if( !AiaEmitter_SetQos( client->eventEmitter, AIA_MQTT_QOS1 ) )
+    {
+        AiaLogError( "AiaEmitter_SetQos failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+#endif
+#ifdef AIA_ENABLE_ASYNC_PUBLISH
+    if( !AiaEmitter_EnableAsyncPublish( client->eventEmitter,
+                                        AIA_EMITTER_MAX_IN_FLIGHT ) )
+    {
+        AiaLogError( "AiaEmitter_EnableAsyncPublish failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+#endif
 
     *(AiaEmitter_t**)&client->capabilitiesPublishEmitter = AiaEmitter_Create(
         mqttConnection, client->secretManager, AIA_TOPIC_CAPABILITIES_PUBLISH );
@@ -329,6 +725,28 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
     AiaRegulator_SetEmitMode( client->eventRegulator, AIA_REGULATOR_TRICKLE );
+    AiaRegulator_SetMaxBurst( client->eventRegulator, EVENT_PUBLISH_MAX_BURST );
+    AiaRegulator_SetSupersedeCallback( client->eventRegulator, destroyJsonChunk,
+                                       NULL );
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    /* Every marker must be reported, but a stale one is not worth sending. */
+    AiaRegulator_SetSupersedeKeyEnabled(
+        client->eventRegulator,
+        AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED_SUPERSEDE_KEY, false );
+    AiaRegulator_SetExpiryCallback( client->eventRegulator, destroyJsonChunk,
+                                    NULL );
+    for( AiaMessageSupersedeKey_t key =
+             AIA_EVENTS_BUFFER_STATE_CHANGED_SUPERSEDE_KEY;
+         key <= AIA_EVENTS_SPEAKER_MARKER_ENCOUNTERED_SUPERSEDE_KEY; ++key )
+    {
+        AiaRegulator_SetMaxAge( client->eventRegulator, key,
+                                AIA_CLIENT_STALE_EVENT_MAX_AGE_MS );
+    }
+#endif
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    AiaRegulator_SetStageChunkCallback( client->eventRegulator, stageJsonChunk,
+                                        NULL );
+#endif
 
     client->capabiliitiesPublishRegulator = AiaRegulator_Create(
         AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE, emitMessageChunk,
@@ -343,10 +761,25 @@ AiaClient_t* AiaClient_Create(
     }
     AiaRegulator_SetEmitMode( client->capabiliitiesPublishRegulator,
                               AIA_REGULATOR_TRICKLE );
-
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    AiaRegulator_SetStageChunkCallback( client->capabiliitiesPublishRegulator,
+                                        stageJsonChunk, NULL );
+#endif
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_EVENT_PUBLISHING );
+
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_CAPABILITIES_SENDER );
+#if defined( AIA_ENABLE_SPEAKER ) && \
+    defined( AIA_ENABLE_RUNTIME_SPEAKER_BUFFER )
+    client->capabilitiesSender = AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+        client->capabiliitiesPublishRegulator,
+        AiaClient_OnCapabilitiesStateChanged, client,
+        speakerBufferCapabilities );
+#else
     client->capabilitiesSender = AiaCapabilitiesSender_Create(
-        client->capabiliitiesPublishRegulator, capabilitiesStateObserver,
-        capabilitiesStateObserverUserData );
+        client->capabiliitiesPublishRegulator,
+        AiaClient_OnCapabilitiesStateChanged, client );
+#endif
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_CAPABILITIES_SENDER );
     if( !client->capabilitiesSender )
     {
         AiaLogError( "AiaCapabilitiesSender_Create failed" );
@@ -354,9 +787,21 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
 
-    client->dispatcher =
-        AiaDispatcher_Create( aiaTaskPool, client->capabilitiesSender,
-                              client->eventRegulator, client->secretManager );
+    client->exceptionLimiter = AiaExceptionLimiter_Create(
+        client->eventRegulator, AIA_EXCEPTION_EVENT_BURST,
+        AIA_EXCEPTION_EVENT_REFILL_INTERVAL_MS );
+    if( !client->exceptionLimiter )
+    {
+        AiaLogError( "AiaExceptionLimiter_Create failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_DISPATCHER );
+    client->dispatcher = AiaDispatcher_Create(
+        aiaTaskPool, client->capabilitiesSender, client->eventRegulator,
+        client->secretManager, client->exceptionLimiter );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_DISPATCHER );
     if( !client->dispatcher )
     {
         AiaLogError( "AiaDispatcher_Create failed" );
@@ -364,11 +809,20 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
 
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_CONNECTION_MANAGER );
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    client->connectionManager = AiaConnectionManager_Create(
+        AiaClient_OnConnectionSuccess, client, onConnectionRejected,
+        connectionUserData, AiaClient_OnDisconnected, client,
+        messageReceivedCallback, client->dispatcher, mqttConnection,
+        aiaTaskPool );
+#else
     client->connectionManager = AiaConnectionManager_Create(
-        onConnectionSuccess, connectionUserData, onConnectionRejected,
+        AiaClient_OnConnectionSuccess, client, onConnectionRejected,
         connectionUserData, onDisconnected, connectionUserData,
         messageReceivedCallback, client->dispatcher, mqttConnection,
         aiaTaskPool );
+#endif
     if( !client->connectionManager )
     {
         AiaLogError( "AiaConnectionManager_Create failed" );
@@ -376,8 +830,34 @@ AiaClient_t* AiaClient_Create(
         return NULL;
     }
 
+    /* Route each inbound topic straight to its dispatcher handler. */
+    for( AiaTopic_t topic = 0; topic < AIA_NUM_TOPICS; ++topic )
+    {
+        AiaMqttTopicHandler_t handler = AiaDispatcher_GetTopicHandler( topic );
+        if( handler && !AiaConnectionManager_SetTopicHandler(
+                           client->connectionManager, topic, handler,
+                           client->dispatcher ) )
+        {
+            AiaLogError( "AiaConnectionManager_SetTopicHandler failed" );
+            AiaClient_Destroy( client );
+            return NULL;
+        }
+    }
+#ifdef AIA_ENABLE_MQTT_MUX
+    if( mqttMux && !AiaConnectionManager_SetMqttMux( client->connectionManager,
+                                                     mqttMux ) )
+    {
+        AiaLogError( "AiaConnectionManager_SetMqttMux failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+#endif
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_CONNECTION_MANAGER );
+
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_EXCEPTION_MANAGER );
     client->exceptionManager = AiaExceptionManager_Create(
-        client->eventRegulator, onException, onExceptionUserData );
+        client->exceptionLimiter, onException, onExceptionUserData );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_EXCEPTION_MANAGER );
     if( !client->exceptionManager )
     {
         AiaLogError( "AiaExceptionManager_Create failed" );
@@ -389,14 +869,26 @@ AiaClient_t* AiaClient_Create(
     /* TODO: ADSER-1757 Investigate moving speakerMessageSequencedCb within
      * speakerManager */
     const AiaDispatcher_t* dispatcher = client->dispatcher;
-    client->speakerManager = AiaSpeakerManager_Create(
+    AiaSpeakerBufferCapabilities_t speakerBuffer = {
         AIA_AUDIO_BUFFER_SIZE, AIA_AUDIO_BUFFER_OVERRUN_WARN_THRESHOLD,
-        AIA_AUDIO_BUFFER_UNDERRUN_WARN_THRESHOLD, receiveSpeakerFramesCb,
+        AIA_AUDIO_BUFFER_UNDERRUN_WARN_THRESHOLD
+    };
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+    if( speakerBufferCapabilities )
+    {
+        speakerBuffer = *speakerBufferCapabilities;
+    }
+#endif
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_SPEAKER_MANAGER );
+    client->speakerManager = AiaSpeakerManager_Create(
+        speakerBuffer.size, speakerBuffer.overrunWarningThreshold,
+        speakerBuffer.underrunWarningThreshold, receiveSpeakerFramesCb,
         receiveSpeakerFramesCbUserData, dispatcher->speakerSequencer,
         client->eventRegulator, setVolumeCb, setVolumeCbUserData,
         playOfflineAlertCb, playOfflineAlertCbUserData, stopOfflineAlertCb,
         stopOfflineAlertCbUserData, AiaClient_SynchronizeSpeakerBuffer,
         client );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_SPEAKER_MANAGER );
     if( !client->speakerManager )
     {
         AiaLogError( "AiaSpeakerManager_Create failed" );
@@ -406,6 +898,7 @@ AiaClient_t* AiaClient_Create(
 
 #endif
 
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_UX_MANAGER );
     client->uxManager = AiaUXManager_Create( client->eventRegulator,
                                              AiaClient_UXStateObserver, client
 #ifdef AIA_ENABLE_SPEAKER
@@ -413,6 +906,7 @@ AiaClient_t* AiaClient_Create(
                                              client->speakerManager
 #endif
     );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_UX_MANAGER );
     if( !client->uxManager )
     {
         AiaLogError( "AiaUXManager_Create failed" );
@@ -422,6 +916,7 @@ AiaClient_t* AiaClient_Create(
 
 #ifdef AIA_ENABLE_MICROPHONE
 
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_MICROPHONE_MANAGER );
     *(AiaEmitter_t**)&client->microphoneEmitter = AiaEmitter_Create(
         mqttConnection, client->secretManager, AIA_TOPIC_MICROPHONE );
     if( !client->microphoneEmitter )
@@ -430,10 +925,26 @@ AiaClient_t* AiaClient_Create(
         AiaClient_Destroy( client );
         return NULL;
     }
+    if( !AiaEmitter_EnablePayloadBufferReuse(
+            client->microphoneEmitter, AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE ) )
+    {
+        AiaLogError( "AiaEmitter_EnablePayloadBufferReuse failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+#ifdef AIA_ENABLE_ASYNC_PUBLISH
+    if( !AiaEmitter_EnableAsyncPublish( client->microphoneEmitter,
+                                        AIA_EMITTER_MAX_IN_FLIGHT ) )
+    {
+        AiaLogError( "AiaEmitter_EnableAsyncPublish failed" );
+        AiaClient_Destroy( client );
+        return NULL;
+    }
+#endif
 
     client->microphoneRegulator = AiaRegulator_Create(
-        AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE, emitMessageChunk,
-        client->microphoneEmitter, MICROPHONE_PUBLISH_RATE );
+        AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE, AiaClient_EmitMicrophoneMessageChunk,
+        client, MICROPHONE_PUBLISH_RATE );
     if( !client->microphoneRegulator )
     {
         AiaLogError(
@@ -448,6 +959,7 @@ AiaClient_t* AiaClient_Create(
         client->eventRegulator, client->microphoneRegulator,
         microphoneBufferReader, AiaUXManager_OnMicrophoneStateChange,
         client->uxManager );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_MICROPHONE_MANAGER );
     if( !client->microphoneManager )
     {
         AiaLogError( "AiaMicrophoneManager_Create failed" );
@@ -473,6 +985,7 @@ AiaClient_t* AiaClient_Create(
     }
 
 #ifdef AIA_ENABLE_ALERTS
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_ALERT_MANAGER );
     client->alertManager = AiaAlertManager_Create(
         client->eventRegulator
 #ifdef AIA_ENABLE_SPEAKER
@@ -483,6 +996,7 @@ AiaClient_t* AiaClient_Create(
         ,
         AiaClient_UpdateServerAttentionState, client, AiaClient_CheckUXState,
         client, AiaClient_Disconnect, client );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_ALERT_MANAGER );
     if( !client->alertManager )
     {
         AiaLogError( "AiaAlertManager_Create failed" );
@@ -492,8 +1006,10 @@ AiaClient_t* AiaClient_Create(
 #endif
 
 #ifdef AIA_ENABLE_CLOCK
+    AiaStartupTrace_Begin( AIA_STARTUP_PHASE_CLOCK_MANAGER );
     client->clockManager = AiaClockManager_Create(
         client->eventRegulator, AiaClient_SynchronizeTimers, client );
+    AiaStartupTrace_End( AIA_STARTUP_PHASE_CLOCK_MANAGER );
     if( !client->clockManager )
     {
         AiaLogError( "AiaClockManager_Create failed" );
@@ -508,139 +1024,142 @@ AiaClient_t* AiaClient_Create(
 #ifdef AIA_ENABLE_SPEAKER
     AiaDispatcher_AddSpeakerManager( client->dispatcher,
                                      client->speakerManager );
+#endif
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaSpeakerManager_OnOpenSpeakerDirectiveReceived,
-            AIA_DIRECTIVE_OPEN_SPEAKER, client->speakerManager ) )
-    {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_OPEN_SPEAKER ) );
-        AiaClient_Destroy( client );
-        return NULL;
-    }
-
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaSpeakerManager_OnCloseSpeakerDirectiveReceived,
-            AIA_DIRECTIVE_CLOSE_SPEAKER, client->speakerManager ) )
+    for( size_t i = 0; i < AiaArrayLength( DIRECTIVE_HANDLERS ); ++i )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_CLOSE_SPEAKER ) );
-        AiaClient_Destroy( client );
-        return NULL;
+        const AiaClientDirectiveHandler_t* entry = &DIRECTIVE_HANDLERS[ i ];
+        void* manager = *(void**)( (uint8_t*)client + entry->managerOffset );
+        if( !AiaDispatcher_AddHandler( client->dispatcher, entry->handler,
+                                       entry->directive, manager ) )
+        {
+            AiaLogError( "Failed to add handler for %s directive",
+                         AiaDirective_ToString( entry->directive ) );
+            AiaClient_Destroy( client );
+            return NULL;
+        }
     }
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher, AiaSpeakerManager_OnSetVolumeDirectiveReceived,
-            AIA_DIRECTIVE_SET_VOLUME, client->speakerManager ) )
+#ifdef AIA_ENABLE_ALERTS
+    if( !AiaDispatcher_AddBatchHandler( client->dispatcher,
+                                        AiaAlertManager_OnDirectiveBatchHandled,
+                                        client->alertManager ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_SET_VOLUME ) );
+        AiaLogError( "Failed to add directive batch handler" );
         AiaClient_Destroy( client );
         return NULL;
     }
+    AiaAlertManager_SetDeferredPersistence( client->alertManager, true );
 #endif
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    /* Capabilities are left out so that they can always be published, and the
+     * microphone regulator since the microphone manager only reads from the
+     * shared microphone buffer as fast as it drains. */
+    if( memoryBudget )
+    {
+        if( !AiaDispatcher_SetMemoryBudget( client->dispatcher, memoryBudget ) )
+        {
+            AiaLogError( "AiaDispatcher_SetMemoryBudget failed" );
+            AiaClient_Destroy( client );
+            return NULL;
+        }
+        AiaRegulator_SetMemoryBudget( client->eventRegulator, memoryBudget );
 #ifdef AIA_ENABLE_ALERTS
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaAlertManager_OnSetAlertVolumeDirectiveReceived,
-            AIA_DIRECTIVE_SET_ALERT_VOLUME, client->alertManager ) )
-    {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_SET_ALERT_VOLUME ) );
-        AiaClient_Destroy( client );
-        return NULL;
+        AiaAlertManager_SetMemoryBudget( client->alertManager, memoryBudget );
+#endif
     }
+#endif
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher, AiaAlertManager_OnSetAlertDirectiveReceived,
-            AIA_DIRECTIVE_SET_ALERT, client->alertManager ) )
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    if( !AiaDispatcher_SetParallelDirectives( client->dispatcher, true ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_SET_ALERT ) );
+        AiaLogError( "AiaDispatcher_SetParallelDirectives failed" );
         AiaClient_Destroy( client );
         return NULL;
     }
+#endif
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher, AiaAlertManager_OnDeleteAlertDirectiveReceived,
-            AIA_DIRECTIVE_DELETE_ALERT, client->alertManager ) )
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    if( !AiaDispatcher_SetSpeculativeDecryption( client->dispatcher, true ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_DELETE_ALERT ) );
+        AiaLogError( "AiaDispatcher_SetSpeculativeDecryption failed" );
         AiaClient_Destroy( client );
         return NULL;
     }
 #endif
-#ifdef AIA_ENABLE_MICROPHONE
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaMicrophoneManager_OnOpenMicrophoneDirectiveReceived,
-            AIA_DIRECTIVE_OPEN_MICROPHONE, client->microphoneManager ) )
+
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    if( !AiaMutex( Create )( &client->commandWorkerMutex, false ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_OPEN_MICROPHONE ) );
+        AiaLogError( "AiaMutex( Create ) failed" );
         AiaClient_Destroy( client );
         return NULL;
     }
-
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaMicrophoneManager_OnCloseMicrophoneDirectiveReceived,
-            AIA_DIRECTIVE_CLOSE_MICROPHONE, client->microphoneManager ) )
+    if( !AiaTimer( Create )( &client->commandWorker, AiaClient_CommandRoutine,
+                             client ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_CLOSE_MICROPHONE ) );
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaMutex( Destroy )( &client->commandWorkerMutex );
         AiaClient_Destroy( client );
         return NULL;
     }
-#endif
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaUXManager_OnSetAttentionStateDirectiveReceived,
-            AIA_DIRECTIVE_SET_ATTENTION_STATE, client->uxManager ) )
+    client->commandQueue = AiaMpscQueue_Create( AIA_CLIENT_COMMAND_QUEUE_SIZE,
+                                                sizeof( AiaClientCommand_t ) );
+    if( !client->commandQueue )
     {
-        AiaLogError(
-            "Failed to add handler for %s directive",
-            AiaDirective_ToString( AIA_DIRECTIVE_SET_ATTENTION_STATE ) );
+        AiaLogError( "AiaMpscQueue_Create failed" );
+        AiaTimer( Destroy )( &client->commandWorker );
+        AiaMutex( Destroy )( &client->commandWorkerMutex );
         AiaClient_Destroy( client );
         return NULL;
     }
+#endif
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher,
-            AiaSecretManager_OnRotateSecretDirectiveReceived,
-            AIA_DIRECTIVE_ROTATE_SECRET, client->secretManager ) )
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+    if( !AiaTimer( Create )( &client->idleMemoryTrimTimer,
+                             AiaClient_IdleMemoryTrimRoutine, client ) )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_ROTATE_SECRET ) );
+        AiaLogError( "AiaTimer( Create ) failed" );
         AiaClient_Destroy( client );
         return NULL;
     }
+    client->hasIdleMemoryTrimTimer = true;
+    AiaAtomic_Store_u32( &client->idleSinceMs,
+                         (uint32_t)AiaClock( GetTimeMs )() );
+    AiaAtomic_Store_u32( &client->idleMemoryTrimDelayMs,
+                         AIA_CLIENT_IDLE_MEMORY_TRIM_DELAY_MS );
+#endif
 
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher, AiaExceptionManager_OnExceptionReceived,
-            AIA_DIRECTIVE_EXCEPTION, client->exceptionManager ) )
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+    /* Pay the page faults of the audio path now rather than on the first
+     * interaction. Failing to lock memory is not fatal. */
+#ifdef AIA_ENABLE_MEMORY_ARENA
+    bool prefaulted = AiaMemoryArena_Prefault( AIA_MEMORY_PREFAULT_LOCK );
+#else
+    bool prefaulted = true;
+#ifdef AIA_ENABLE_SPEAKER
+    prefaulted = AiaSpeakerManager_PrefaultBuffers( client->speakerManager,
+                                                    AIA_MEMORY_PREFAULT_LOCK );
+#endif
+#endif
+    AiaMemoryPrefaultStats_t prefaultStats;
+    AiaMemory_GetPrefaultStats( &prefaultStats );
+    if( prefaulted )
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_EXCEPTION ) );
-        AiaClient_Destroy( client );
-        return NULL;
+        AiaLogInfo( "Prefaulted memory, prefaulted=%zu, locked=%zu",
+                    prefaultStats.prefaultedBytes, prefaultStats.lockedBytes );
     }
-
-#ifdef AIA_ENABLE_CLOCK
-    if( !AiaDispatcher_AddHandler(
-            client->dispatcher, AiaClockManager_OnSetClockDirectiveReceived,
-            AIA_DIRECTIVE_SET_CLOCK, client->clockManager ) )
+    else
     {
-        AiaLogError( "Failed to add handler for %s directive",
-                     AiaDirective_ToString( AIA_DIRECTIVE_SET_CLOCK ) );
-        AiaClient_Destroy( client );
-        return NULL;
+        AiaLogWarn( "Failed to prefault memory, prefaulted=%zu, locked=%zu",
+                    prefaultStats.prefaultedBytes, prefaultStats.lockedBytes );
     }
 #endif
 
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    AiaTimerService_SetCurrentGroup( client->previousTimerGroup );
+#endif
     return client;
 }
 
@@ -652,6 +1171,51 @@ void AiaClient_Destroy( AiaClient_t* aiaClient )
         return;
     }
 
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    if( aiaClient->commandQueue )
+    {
+        /* Waits for a running commandWorker before the managers go away. */
+        AiaTimer( Destroy )( &aiaClient->commandWorker );
+        AiaClientCommand_t command;
+        size_t dropped = 0;
+        while( AiaMpscQueue_Pop( aiaClient->commandQueue, &command ) )
+        {
+            ++dropped;
+        }
+        if( dropped )
+        {
+            AiaLogWarn( "Dropping %zu unapplied calls.", dropped );
+        }
+        AiaMutex( Destroy )( &aiaClient->commandWorkerMutex );
+        AiaMpscQueue_Destroy( aiaClient->commandQueue );
+    }
+#endif
+
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+    if( aiaClient->hasIdleMemoryTrimTimer )
+    {
+        /* Waits for a running trim before the managers go away. */
+        AiaAtomic_Store_u32( &aiaClient->idleMemoryTrimDelayMs, 0 );
+        AiaTimer( Destroy )( &aiaClient->idleMemoryTrimTimer );
+    }
+#endif
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    /* Waits for running directive workers before the managers go away. */
+    if( aiaClient->dispatcher )
+    {
+        AiaDispatcher_SetParallelDirectives( aiaClient->dispatcher, false );
+    }
+#endif
+
+#if defined( AIA_ENABLE_PERSISTENT_MQTT_SUBSCRIPTIONS ) || \
+    defined( AIA_ENABLE_MQTT_MUX )
+    /* Releases the subscriptions, and the route of a shared connection, before
+     * the handlers they route to go away. */
+    AiaConnectionManager_Destroy( aiaClient->connectionManager );
+    aiaClient->connectionManager = NULL;
+#endif
+
 #ifdef AIA_ENABLE_ALERTS
     AiaAlertManager_Destroy( aiaClient->alertManager );
 #endif
@@ -673,6 +1237,7 @@ void AiaClient_Destroy( AiaClient_t* aiaClient )
     AiaCapabilitiesSender_Destroy( aiaClient->capabilitiesSender );
     AiaDispatcher_Destroy( aiaClient->dispatcher );
     AiaExceptionManager_Destroy( aiaClient->exceptionManager );
+    AiaExceptionLimiter_Destroy( aiaClient->exceptionLimiter );
     AiaConnectionManager_Destroy( aiaClient->connectionManager );
     AiaRegulator_Destroy( aiaClient->capabiliitiesPublishRegulator,
                           destroyJsonChunk, NULL );
@@ -680,6 +1245,13 @@ void AiaClient_Destroy( AiaClient_t* aiaClient )
     AiaEmitter_Destroy( aiaClient->eventEmitter );
     AiaEmitter_Destroy( aiaClient->capabilitiesPublishEmitter );
     AiaSecretManager_Destroy( aiaClient->secretManager );
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    /* Restores the caller's group if AiaClient_Create() failed part way. */
+    const void* currentTimerGroup = AiaTimerService_SetCurrentGroup( NULL );
+    AiaTimerService_SetCurrentGroup( currentTimerGroup == aiaClient
+                                         ? aiaClient->previousTimerGroup
+                                         : currentTimerGroup );
+#endif
     AiaFree( aiaClient );
 }
 
@@ -692,28 +1264,34 @@ bool AiaClient_Connect( AiaClient_t* aiaClient )
         return false;
     }
 
+    AiaAtomic_Store_u32( &aiaClient->bootstrapStage,
+                         AIA_CLIENT_BOOTSTRAP_IDLE );
     return AiaConnectionManager_Connect( aiaClient->connectionManager );
 }
 
-bool AiaClient_Disconnect( void* userData, int code, const char* description )
+bool AiaClient_ConnectAndBootstrap( AiaClient_t* aiaClient )
 {
-    AiaClient_t* aiaClient = (AiaClient_t*)userData;
     AiaAssert( aiaClient );
     if( !aiaClient )
     {
-        AiaLogWarn( "Null aiaClient" );
+        AiaLogError( "Null aiaClient" );
         return false;
     }
 
-    /* TODO: ADSER-1685 Use code, refactor connectionManager to take in enums
-     * rather than c strings for code. */
-    (void)code;
-    return AiaConnectionManager_Disconnect(
-        aiaClient->connectionManager, AIA_CONNECTION_DISCONNECT_GOING_OFFLINE,
-        description );
+    AiaAtomic_Store_u32( &aiaClient->bootstrapStage,
+                         AIA_CLIENT_BOOTSTRAP_CONNECTING );
+    if( !AiaConnectionManager_Connect( aiaClient->connectionManager ) )
+    {
+        AiaAtomic_Store_u32( &aiaClient->bootstrapStage,
+                             AIA_CLIENT_BOOTSTRAP_IDLE );
+        return false;
+    }
+    return true;
 }
 
-bool AiaClient_PublishCapabilities( AiaClient_t* aiaClient )
+#ifdef AIA_ENABLE_WARM_RECONNECT
+bool AiaClient_SetWarmReconnectWindow( AiaClient_t* aiaClient,
+                                       AiaDurationMs_t windowMs )
 {
     AiaAssert( aiaClient );
     if( !aiaClient )
@@ -722,21 +1300,266 @@ bool AiaClient_PublishCapabilities( AiaClient_t* aiaClient )
         return false;
     }
 
-    return AiaCapabilitiesSender_PublishCapabilities(
-        aiaClient->capabilitiesSender );
+    AiaAtomic_Store_u32( &aiaClient->warmReconnectWindowMs, windowMs );
+    return true;
 }
 
-#ifdef AIA_ENABLE_SPEAKER
-
-void AiaClient_StopSpeaker( AiaClient_t* aiaClient )
+bool AiaClient_ReconnectWarm( AiaClient_t* aiaClient )
 {
     AiaAssert( aiaClient );
     if( !aiaClient )
     {
-        AiaLogWarn( "Null aiaClient" );
-        return;
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    if( !AiaAtomicBool_Load( &aiaClient->isWarmReconnectPending ) )
+    {
+        AiaLogError( "No state kept from a disconnection" );
+        return false;
+    }
+
+    uint32_t elapsedMs = (uint32_t)AiaClock( GetTimeMs )() -
+                         AiaAtomic_Load_u32( &aiaClient->disconnectedAtMs );
+    uint32_t windowMs = AiaAtomic_Load_u32( &aiaClient->warmReconnectWindowMs );
+    if( elapsedMs > windowMs )
+    {
+        AiaLogInfo( "Warm reconnect window elapsed, elapsedMs=%" PRIu32
+                    ", windowMs=%" PRIu32,
+                    elapsedMs, windowMs );
+        return false;
+    }
+
+    AiaAtomic_Store_u32( &aiaClient->bootstrapStage,
+                         AIA_CLIENT_BOOTSTRAP_IDLE );
+    return AiaConnectionManager_Connect( aiaClient->connectionManager );
+}
+#endif
+
+size_t AiaClient_TrimMemory( AiaClient_t* aiaClient,
+                             AiaClientTrimLevel_t level )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return 0;
+    }
+
+    size_t released = AiaDispatcher_TrimMemory( aiaClient->dispatcher );
+#ifdef AIA_ENABLE_SPEAKER
+    released += AiaSpeakerManager_TrimMemory( aiaClient->speakerManager );
+#endif
+#ifdef AIA_ENABLE_MICROPHONE
+    released += AiaRegulator_TrimMemory( aiaClient->microphoneRegulator,
+                                         trimEmitterMemory,
+                                         aiaClient->microphoneEmitter );
+#endif
+    if( level == AIA_CLIENT_TRIM_MEMORY_COMPLETE )
+    {
+        released += AiaRegulator_TrimMemory( aiaClient->eventRegulator,
+                                             trimEmitterMemory,
+                                             aiaClient->eventEmitter );
+        released += AiaRegulator_TrimMemory(
+            aiaClient->capabiliitiesPublishRegulator, trimEmitterMemory,
+            aiaClient->capabilitiesPublishEmitter );
+    }
+    AiaLogDebug( "Trimmed memory, level=%d, released=%zu", level, released );
+    return released;
+}
+
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+bool AiaClient_SetIdleMemoryTrimDelay( AiaClient_t* aiaClient,
+                                       AiaDurationMs_t delayMs )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+
+    AiaAtomic_Store_u32( &aiaClient->idleMemoryTrimDelayMs, delayMs );
+    if( delayMs &&
+        AiaUXManager_GetUXState( aiaClient->uxManager ) == AIA_UX_IDLE &&
+        !AiaTimer( Arm )( &aiaClient->idleMemoryTrimTimer, delayMs, 0 ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed" );
+        return false;
+    }
+    return true;
+}
+
+static void AiaClient_IdleMemoryTrimRoutine( void* context )
+{
+    AiaClient_t* client = (AiaClient_t*)context;
+    uint32_t delayMs = AiaAtomic_Load_u32( &client->idleMemoryTrimDelayMs );
+    uint32_t idleMs = (uint32_t)AiaClock( GetTimeMs )() -
+                      AiaAtomic_Load_u32( &client->idleSinceMs );
+
+    /* A later return to idle re-arms the timer for its own delay. */
+    if( !delayMs ||
+        AiaUXManager_GetUXState( client->uxManager ) != AIA_UX_IDLE ||
+        idleMs < delayMs )
+    {
+        return;
+    }
+    AiaClient_TrimMemory( client, AIA_CLIENT_TRIM_MEMORY_IDLE );
+}
+#endif
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+void AiaClient_MarkSteadyState( AiaClient_t* aiaClient )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return;
+    }
+    AiaLogInfo( "Guarding hot paths against allocations" );
+    AiaMemoryGuard_MarkSteadyState( true );
+}
+#endif
+
+bool AiaClient_SetEventCoalescing( AiaClient_t* aiaClient,
+                                   AiaMessageSupersedeKey_t key,
+                                   bool isEnabled )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    return AiaRegulator_SetSupersedeKeyEnabled( aiaClient->eventRegulator, key,
+                                                isEnabled );
+}
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+bool AiaClient_SetEventMaxAge( AiaClient_t* aiaClient,
+                               AiaMessageSupersedeKey_t key,
+                               AiaDurationMs_t maxAgeMs )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    return AiaRegulator_SetMaxAge( aiaClient->eventRegulator, key, maxAgeMs );
+}
+#endif
+
+bool AiaClient_SaveSession( AiaClient_t* aiaClient,
+                            AiaClientSession_t* session )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    if( !session )
+    {
+        AiaLogError( "Null session" );
+        return false;
+    }
+
+    memset( session, 0, sizeof( *session ) );
+    session->version = AIA_CLIENT_SESSION_VERSION;
+    session->isCapabilitiesAccepted = AiaCapabilitiesSender_GetAcceptedDigest(
+        aiaClient->capabilitiesSender, &session->capabilitiesDigest );
+#ifdef AIA_ENABLE_SPEAKER
+    session->volume = AiaSpeakerManager_GetVolume( aiaClient->speakerManager );
+#endif
+    return true;
+}
+
+bool AiaClient_RestoreSession( AiaClient_t* aiaClient,
+                               const AiaClientSession_t* session )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    if( !session )
+    {
+        AiaLogError( "Null session" );
+        return false;
+    }
+    if( session->version != AIA_CLIENT_SESSION_VERSION )
+    {
+        AiaLogError( "Unsupported session, version=%" PRIu32,
+                     session->version );
+        return false;
+    }
+
+#ifdef AIA_ENABLE_SPEAKER
+    if( !AiaSpeakerManager_RestoreVolume( aiaClient->speakerManager,
+                                          session->volume ) )
+    {
+        AiaLogError( "AiaSpeakerManager_RestoreVolume failed" );
+        return false;
+    }
+#endif
+    if( session->isCapabilitiesAccepted &&
+        !AiaCapabilitiesSender_RestoreAccepted( aiaClient->capabilitiesSender,
+                                                session->capabilitiesDigest ) )
+    {
+        AiaLogInfo( "Capabilities will be published again" );
+    }
+    return true;
+}
+
+bool AiaClient_Disconnect( void* userData, int code, const char* description )
+{
+    AiaClient_t* aiaClient = (AiaClient_t*)userData;
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return false;
+    }
+
+    /* TODO: ADSER-1685 Use code, refactor connectionManager to take in enums
+     * rather than c strings for code. */
+    (void)code;
+    return AiaConnectionManager_Disconnect(
+        aiaClient->connectionManager, AIA_CONNECTION_DISCONNECT_GOING_OFFLINE,
+        description );
+}
+
+bool AiaClient_PublishCapabilities( AiaClient_t* aiaClient )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
     }
+
+    return AiaCapabilitiesSender_PublishCapabilities(
+        aiaClient->capabilitiesSender );
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+
+void AiaClient_StopSpeaker( AiaClient_t* aiaClient )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return;
+    }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_STOP_SPEAKER };
+    AiaClient_QueueCommand( aiaClient, &command );
+#else
     AiaSpeakerManager_StopPlayback( aiaClient->speakerManager );
+#endif
 }
 
 void AiaClient_OnSpeakerReady( AiaClient_t* aiaClient )
@@ -747,7 +1570,25 @@ void AiaClient_OnSpeakerReady( AiaClient_t* aiaClient )
         AiaLogWarn( "Null aiaClient" );
         return;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_SPEAKER_READY };
+    AiaClient_QueueCommand( aiaClient, &command );
+#else
     AiaSpeakerManager_OnSpeakerReady( aiaClient->speakerManager );
+#endif
+}
+
+void AiaClient_SetSpeakerPlayoutLatency( AiaClient_t* aiaClient,
+                                         AiaDurationMs_t latencyMs )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return;
+    }
+    AiaSpeakerManager_SetPlayoutLatency( aiaClient->speakerManager,
+                                         latencyMs );
 }
 
 bool AiaClient_ChangeVolume( AiaClient_t* aiaClient, uint8_t newVolume )
@@ -758,8 +1599,19 @@ bool AiaClient_ChangeVolume( AiaClient_t* aiaClient, uint8_t newVolume )
         AiaLogWarn( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    if( newVolume < AIA_MIN_VOLUME || newVolume > AIA_MAX_VOLUME )
+    {
+        AiaLogError( "Invalid volume, volume=%" PRIu8, newVolume );
+        return false;
+    }
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_CHANGE_VOLUME,
+                                   .volume = newVolume };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaSpeakerManager_ChangeVolume( aiaClient->speakerManager,
                                            newVolume );
+#endif
 }
 
 bool AiaClient_AdjustVolume( AiaClient_t* aiaClient, int8_t delta )
@@ -770,7 +1622,13 @@ bool AiaClient_AdjustVolume( AiaClient_t* aiaClient, int8_t delta )
         AiaLogWarn( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_ADJUST_VOLUME,
+                                   .volumeDelta = delta };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaSpeakerManager_AdjustVolume( aiaClient->speakerManager, delta );
+#endif
 }
 
 #endif
@@ -786,8 +1644,15 @@ bool AiaClient_HoldToTalkStart( AiaClient_t* aiaClient,
         AiaLogWarn( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type =
+                                       AIA_CLIENT_COMMAND_HOLD_TO_TALK_START,
+                                   .beginIndex = index };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaMicrophoneManager_HoldToTalkStart( aiaClient->microphoneManager,
                                                  index );
+#endif
 }
 
 void AiaClient_CloseMicrophone( AiaClient_t* aiaClient )
@@ -798,7 +1663,13 @@ void AiaClient_CloseMicrophone( AiaClient_t* aiaClient )
         AiaLogWarn( "Null aiaClient" );
         return;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type =
+                                       AIA_CLIENT_COMMAND_CLOSE_MICROPHONE };
+    AiaClient_QueueCommand( aiaClient, &command );
+#else
     AiaMicrophoneManager_CloseMicrophone( aiaClient->microphoneManager );
+#endif
 }
 
 bool AiaClient_TapToTalkStart( AiaClient_t* aiaClient,
@@ -811,8 +1682,16 @@ bool AiaClient_TapToTalkStart( AiaClient_t* aiaClient,
         AiaLogWarn( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type =
+                                       AIA_CLIENT_COMMAND_TAP_TO_TALK_START,
+                                   .beginIndex = index,
+                                   .profile = profile };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaMicrophoneManager_TapToTalkStart( aiaClient->microphoneManager,
                                                 index, profile );
+#endif
 }
 
 bool AiaClient_WakeWordStart( AiaClient_t* aiaClient,
@@ -827,8 +1706,68 @@ bool AiaClient_WakeWordStart( AiaClient_t* aiaClient,
         AiaLogWarn( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    /* Only one wake word is supported, so it is checked here rather than
+     * copied into the queue. */
+    if( !wakeWord || strcmp( wakeWord, AIA_ALEXA_WAKE_WORD ) != 0 )
+    {
+        AiaLogError( "Unsupported wake word" );
+        return false;
+    }
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_WAKE_WORD_START,
+                                   .beginIndex = beginIndex,
+                                   .endIndex = endIndex,
+                                   .profile = profile };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaMicrophoneManager_WakeWordStart(
         aiaClient->microphoneManager, beginIndex, endIndex, profile, wakeWord );
+#endif
+}
+
+bool AiaClient_SetMicrophoneProcessing(
+    AiaClient_t* aiaClient, const AiaMicrophoneProcessing_t* processing )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return false;
+    }
+    return AiaMicrophoneManager_SetProcessing( aiaClient->microphoneManager,
+                                               processing );
+}
+
+bool AiaClient_GetMicrophoneEnergy( AiaClient_t* aiaClient,
+                                    AiaPcmEnergy_t* energy )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return false;
+    }
+    AiaAssert( energy );
+    if( !energy )
+    {
+        AiaLogWarn( "Null energy" );
+        return false;
+    }
+    AiaMicrophoneManager_GetEnergy( aiaClient->microphoneManager, energy );
+    return true;
+}
+
+bool AiaClient_SetMicrophoneEncoder( AiaClient_t* aiaClient,
+                                     const AiaMicrophoneEncoder_t* encoder )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogWarn( "Null aiaClient" );
+        return false;
+    }
+    return AiaMicrophoneManager_SetEncoder( aiaClient->microphoneManager,
+                                            encoder );
 }
 #endif
 
@@ -841,7 +1780,8 @@ bool AiaClient_WakeWordStart( AiaClient_t* aiaClient,
  */
 static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
 {
-#ifndef AIA_ENABLE_ALERTS
+#if !defined AIA_ENABLE_ALERTS && \
+    ( !defined AIA_ENABLE_SPEAKER || !defined AIA_LOAD_VOLUME )
     (void)aiaClient;
 #endif
     static const char* AIA_SYNCHRONIZE_STATE_EVENT_FORMAT =
@@ -864,7 +1804,11 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
     /* clang-format on */
 
 #if defined AIA_ENABLE_SPEAKER && defined AIA_LOAD_VOLUME
-    AiaJsonLongType storedVolume = (AiaJsonLongType)AIA_LOAD_VOLUME();
+    /* The current volume rather than the persisted one, which lags behind
+     * while stores are coalesced or after @c AiaClient_RestoreSession(). */
+    AiaJsonLongType currentVolume =
+        (AiaJsonLongType)AiaSpeakerManager_GetVolume(
+            aiaClient->speakerManager );
 #endif
 #ifdef AIA_ENABLE_ALERTS
     uint8_t* alertsArray;
@@ -877,7 +1821,7 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
 #if defined AIA_ENABLE_SPEAKER && defined AIA_LOAD_VOLUME && \
     !defined AIA_ENABLE_ALERTS
     int numCharsRequired =
-        snprintf( NULL, 0, AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, storedVolume );
+        snprintf( NULL, 0, AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, currentVolume );
     if( numCharsRequired < 0 )
     {
         AiaLogError( "snprintf failed" );
@@ -885,7 +1829,7 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
     }
     char payloadBuffer[ numCharsRequired + 1 ];
     if( snprintf( payloadBuffer, numCharsRequired + 1,
-                  AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, storedVolume ) < 0 )
+                  AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, currentVolume ) < 0 )
     {
         AiaLogError( "snprintf failed" );
         return NULL;
@@ -915,7 +1859,7 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
 #if defined AIA_ENABLE_SPEAKER && defined AIA_LOAD_VOLUME && \
     defined AIA_ENABLE_ALERTS
     int numCharsRequired =
-        snprintf( NULL, 0, AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, storedVolume,
+        snprintf( NULL, 0, AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, currentVolume,
                   alertsArrayLen, alertsArray );
     if( numCharsRequired < 0 )
     {
@@ -925,7 +1869,7 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
     }
     char payloadBuffer[ numCharsRequired + 1 ];
     if( snprintf( payloadBuffer, numCharsRequired + 1,
-                  AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, storedVolume,
+                  AIA_SYNCHRONIZE_STATE_EVENT_FORMAT, currentVolume,
                   alertsArrayLen, alertsArray ) < 0 )
     {
         AiaFree( alertsArray );
@@ -948,20 +1892,27 @@ static AiaJsonMessage_t* generateSynchronizeStateEvent( AiaClient_t* aiaClient )
     return jsonMessage;
 }
 
-bool AiaClient_SynchronizeState( AiaClient_t* aiaClient )
+void AiaClient_SetAsyncUXStateObserver( AiaClient_t* aiaClient, bool isAsync )
 {
     AiaAssert( aiaClient );
     if( !aiaClient )
     {
         AiaLogError( "Null aiaClient" );
-        return false;
+        return;
     }
-#ifdef AIA_ENABLE_ALERTS
+    AiaUXManager_SetAsyncObserver( aiaClient->uxManager, isAsync );
+}
+
+/**
+ * Generates a @c SynchronizeState event and writes it to the event regulator.
+ *
+ * @param aiaClient The @c AiaClient_t to act on.
+ * @return @c true if the event was written, else @c false.
+ */
+static bool AiaClient_PublishSynchronizeState( AiaClient_t* aiaClient )
+{
     AiaJsonMessage_t* synchronizeStateEvent =
         generateSynchronizeStateEvent( aiaClient );
-#else
-    AiaJsonMessage_t* synchronizeStateEvent = generateSynchronizeStateEvent();
-#endif
     if( !synchronizeStateEvent )
     {
         AiaLogError( "Failed to create SynchronizeState event" );
@@ -978,6 +1929,23 @@ bool AiaClient_SynchronizeState( AiaClient_t* aiaClient )
     return true;
 }
 
+bool AiaClient_SynchronizeState( AiaClient_t* aiaClient )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type =
+                                       AIA_CLIENT_COMMAND_SYNCHRONIZE_STATE };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
+    return AiaClient_PublishSynchronizeState( aiaClient );
+#endif
+}
+
 bool AiaClient_OnButtonPressed( AiaClient_t* aiaClient,
                                 AiaButtonCommand_t button )
 {
@@ -987,8 +1955,14 @@ bool AiaClient_OnButtonPressed( AiaClient_t* aiaClient,
         AiaLogError( "Null aiaClient" );
         return false;
     }
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+    AiaClientCommand_t command = { .type = AIA_CLIENT_COMMAND_BUTTON_PRESSED,
+                                   .button = button };
+    return AiaClient_QueueCommand( aiaClient, &command );
+#else
     return AiaButtonCommandSender_OnButtonPressed(
         aiaClient->buttonCommandSender, button );
+#endif
 }
 
 #ifdef AIA_ENABLE_CLOCK
@@ -1004,6 +1978,140 @@ bool AiaClient_SynchronizeClock( AiaClient_t* aiaClient )
 }
 #endif
 
+bool AiaClient_GetMetrics( AiaClient_t* aiaClient,
+                           AiaClientMetrics_t* metrics )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    AiaAssert( metrics );
+    if( !metrics )
+    {
+        AiaLogError( "Null metrics" );
+        return false;
+    }
+
+    AiaSequencer_GetMetrics( aiaClient->dispatcher->directiveSequencer,
+                             &metrics->directiveSequencer );
+#ifdef AIA_ENABLE_SPEAKER
+    AiaSequencer_GetMetrics( aiaClient->dispatcher->speakerSequencer,
+                             &metrics->speakerSequencer );
+    AiaSpeakerManager_GetMetrics( aiaClient->speakerManager,
+                                  &metrics->speaker );
+#endif
+    AiaRegulator_GetMetrics( aiaClient->eventRegulator,
+                             &metrics->eventRegulator );
+    AiaEmitter_GetMetrics( aiaClient->eventEmitter, &metrics->eventEmitter );
+#ifdef AIA_ENABLE_MICROPHONE
+    AiaRegulator_GetMetrics( aiaClient->microphoneRegulator,
+                             &metrics->microphoneRegulator );
+    AiaEmitter_GetMetrics( aiaClient->microphoneEmitter,
+                           &metrics->microphoneEmitter );
+    AiaMicrophoneManager_GetMetrics( aiaClient->microphoneManager,
+                                     &metrics->microphone );
+#endif
+    AiaSecretManager_GetMetrics( aiaClient->secretManager, &metrics->crypto );
+    AiaConnectionManager_GetMetrics( aiaClient->connectionManager,
+                                     &metrics->connection );
+#ifdef AIA_ENABLE_LATENCY_HISTOGRAMS
+    AiaDispatcher_GetDirectiveHandlingTimes(
+        aiaClient->dispatcher, metrics->directiveHandlingTimesMs );
+#endif
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+    metrics->overloadLevel = AiaOverloadGovernor_GetLevel();
+#endif
+    return true;
+}
+
+/**
+ * Checks whether @c emitter published a message within the last @c
+ * AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS.
+ *
+ * @param emitter The @c AiaEmitter_t to check.
+ * @param nowMs The low 32 bits of the current time.
+ * @return @c true if @c emitter published recently or @c false otherwise.
+ */
+static bool AiaClient_HasPublishedRecently( AiaEmitter_t* emitter,
+                                            uint32_t nowMs )
+{
+    AiaEmitterMetrics_t metrics;
+    AiaEmitter_GetMetrics( emitter, &metrics );
+    if( !metrics.messagesPublished )
+    {
+        return false;
+    }
+    /* Unsigned subtraction keeps this correct across wraps of the 32-bit
+     * timestamp. */
+    return nowMs - metrics.lastPublishTimeMs <
+           AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS * 1000u;
+}
+
+uint16_t AiaClient_GetMqttKeepAliveSeconds( AiaClient_t* aiaClient )
+{
+    if( !aiaClient )
+    {
+        return AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS;
+    }
+    if( AiaUXManager_GetUXState( aiaClient->uxManager ) != AIA_UX_IDLE )
+    {
+        return AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS;
+    }
+
+    uint32_t nowMs = (uint32_t)AiaClock( GetTimeMs )();
+    if( AiaClient_HasPublishedRecently( aiaClient->eventEmitter, nowMs ) ||
+        AiaClient_HasPublishedRecently(
+            aiaClient->capabilitiesPublishEmitter, nowMs )
+#ifdef AIA_ENABLE_MICROPHONE
+        || AiaClient_HasPublishedRecently( aiaClient->microphoneEmitter,
+                                           nowMs )
+#endif
+    )
+    {
+        return AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS;
+    }
+    return AIA_MQTT_KEEPALIVE_QUIET_SECONDS;
+}
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+bool AiaClient_SetPlaintextObserver( AiaClient_t* aiaClient,
+                                     AiaSessionTraceObserver_t observer,
+                                     void* userData )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    AiaDispatcher_SetPlaintextObserver( aiaClient->dispatcher, observer,
+                                        userData );
+    return true;
+}
+
+bool AiaClient_ReplayMessage( AiaClient_t* aiaClient,
+                              const AiaSessionTraceRecord_t* record )
+{
+    AiaAssert( aiaClient );
+    if( !aiaClient )
+    {
+        AiaLogError( "Null aiaClient" );
+        return false;
+    }
+    AiaAssert( record );
+    if( !record )
+    {
+        AiaLogError( "Null record" );
+        return false;
+    }
+    return AiaDispatcher_DispatchPlaintext(
+        aiaClient->dispatcher, record->topic, record->sequenceNumber,
+        record->payload, record->payloadSize );
+}
+#endif
+
 #ifdef AIA_ENABLE_ALERTS
 bool AiaClient_DeleteAlert( AiaClient_t* aiaClient, const char* alertToken )
 {
@@ -1074,6 +2182,30 @@ static bool AiaClient_EmitEvent( AiaRegulatorChunk_t* chunk, void* userData )
     return AiaRegulator_Write( client->eventRegulator, chunk );
 }
 
+#ifdef AIA_ENABLE_MICROPHONE
+static bool AiaClient_EmitMicrophoneMessageChunk(
+    AiaRegulatorChunk_t* chunkForMessage, size_t remainingBytes,
+    size_t remainingChunks, void* userData )
+{
+    AiaClient_t* client = (AiaClient_t*)userData;
+    if( !client )
+    {
+        AiaLogError( "Null client" );
+        return false;
+    }
+    if( !emitMessageChunk( chunkForMessage, remainingBytes, remainingChunks,
+                           client->microphoneEmitter ) )
+    {
+        return false;
+    }
+    if( !remainingChunks )
+    {
+        AiaRegulator_Flush( client->eventRegulator );
+    }
+    return true;
+}
+#endif
+
 static void AiaClient_StopPlayback( void* userData )
 {
     AiaClient_t* client = (AiaClient_t*)userData;
@@ -1087,6 +2219,141 @@ static void AiaClient_StopPlayback( void* userData )
 #endif
 }
 
+/**
+ * Publishes the events which follow accepted capabilities during @c
+ * AiaClient_ConnectAndBootstrap().
+ *
+ * @param client The @c AiaClient_t to act on.
+ */
+static void AiaClient_PublishBootstrapEvents( AiaClient_t* client )
+{
+    if( !AiaClient_PublishSynchronizeState( client ) )
+    {
+        AiaLogError( "AiaClient_PublishSynchronizeState failed" );
+    }
+#ifdef AIA_ENABLE_CLOCK
+    if( !AiaClockManager_SynchronizeClock( client->clockManager ) )
+    {
+        AiaLogError( "AiaClockManager_SynchronizeClock failed" );
+    }
+#endif
+}
+
+static void AiaClient_OnConnectionSuccess( void* userData )
+{
+    AiaClient_t* client = (AiaClient_t*)userData;
+    if( !client )
+    {
+        AiaLogError( "Null client" );
+        return;
+    }
+
+    /* Moved on before publishing, since the acknowledgement may arrive before
+     * the publish returns. */
+    if( AiaAtomic_CompareAndSwap_u32(
+            &client->bootstrapStage,
+            AIA_CLIENT_BOOTSTRAP_PUBLISHING_CAPABILITIES,
+            AIA_CLIENT_BOOTSTRAP_CONNECTING ) )
+    {
+        if( AiaCapabilitiesSender_IsAccepted( client->capabilitiesSender ) )
+        {
+            AiaLogDebug( "Capabilities unchanged, not publishing them" );
+            if( AiaAtomic_CompareAndSwap_u32(
+                    &client->bootstrapStage, AIA_CLIENT_BOOTSTRAP_IDLE,
+                    AIA_CLIENT_BOOTSTRAP_PUBLISHING_CAPABILITIES ) )
+            {
+                AiaClient_PublishBootstrapEvents( client );
+            }
+        }
+        else if( !AiaCapabilitiesSender_PublishCapabilities(
+                     client->capabilitiesSender ) )
+        {
+            AiaLogError( "AiaCapabilitiesSender_PublishCapabilities failed" );
+            AiaAtomic_Store_u32( &client->bootstrapStage,
+                                 AIA_CLIENT_BOOTSTRAP_IDLE );
+        }
+    }
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    /* The resynchronizing events are queued behind the events held while
+     * disconnected, then all of them are published. */
+    if( AiaAtomicBool_Load( &client->isWarmReconnectPending ) )
+    {
+        AiaAtomicBool_Clear( &client->isWarmReconnectPending );
+#ifdef AIA_ENABLE_SPEAKER
+        AiaSpeakerManager_OnReconnected( client->speakerManager );
+#endif
+        AiaRegulator_SetPaused( client->eventRegulator, false );
+    }
+#endif
+
+    if( client->onConnectionSuccessCb )
+    {
+        client->onConnectionSuccessCb( client->onConnectionSuccessCbUserData );
+    }
+}
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+static void AiaClient_OnDisconnected( void* userData,
+                                      AiaConnectionOnDisconnectCode_t code )
+{
+    AiaClient_t* client = (AiaClient_t*)userData;
+    if( !client )
+    {
+        AiaLogError( "Null client" );
+        return;
+    }
+
+    if( AiaAtomic_Load_u32( &client->warmReconnectWindowMs ) )
+    {
+        AiaRegulator_SetPaused( client->eventRegulator, true );
+        AiaAtomic_Store_u32( &client->disconnectedAtMs,
+                             (uint32_t)AiaClock( GetTimeMs )() );
+        AiaAtomicBool_Set( &client->isWarmReconnectPending );
+    }
+
+    if( client->onDisconnectedCb )
+    {
+        client->onDisconnectedCb( client->onConnectionSuccessCbUserData, code );
+    }
+}
+#endif
+
+static void AiaClient_OnCapabilitiesStateChanged(
+    AiaCapabilitiesSenderState_t state, const char* description,
+    size_t descriptionLen, void* userData )
+{
+    AiaClient_t* client = (AiaClient_t*)userData;
+    if( !client )
+    {
+        AiaLogError( "Null client" );
+        return;
+    }
+
+    if( state != AIA_CAPABILITIES_STATE_PUBLISHED &&
+        AiaAtomic_CompareAndSwap_u32(
+            &client->bootstrapStage, AIA_CLIENT_BOOTSTRAP_IDLE,
+            AIA_CLIENT_BOOTSTRAP_PUBLISHING_CAPABILITIES ) )
+    {
+        if( state == AIA_CAPABILITIES_STATE_ACCEPTED )
+        {
+            AiaClient_PublishBootstrapEvents( client );
+        }
+        else
+        {
+            AiaLogError( "Capabilities not accepted, state=%s",
+                         AiaCapabilitiesSenderState_ToString( state ) );
+        }
+    }
+
+    if( client->capabilitiesStateObserverCb )
+    {
+        client->capabilitiesStateObserverCb(
+            state, description, descriptionLen,
+            client->capabilitiesStateObserverCbUserData );
+    }
+}
+
 static void AiaClient_SynchronizeTimers( void* userData,
                                          AiaTimepointSeconds_t currentTime )
 {
@@ -1149,6 +2416,19 @@ static void AiaClient_UXStateObserver( AiaUXState_t state, void* userData )
 
     client->uxStateObserverCb( state, client->uxStateObserverCbUserData );
 
+#ifdef AIA_ENABLE_IDLE_MEMORY_TRIM
+    uint32_t delayMs = AiaAtomic_Load_u32( &client->idleMemoryTrimDelayMs );
+    if( state == AIA_UX_IDLE && delayMs )
+    {
+        AiaAtomic_Store_u32( &client->idleSinceMs,
+                             (uint32_t)AiaClock( GetTimeMs )() );
+        if( !AiaTimer( Arm )( &client->idleMemoryTrimTimer, delayMs, 0 ) )
+        {
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+        }
+    }
+#endif
+
 #ifdef AIA_ENABLE_ALERTS
     if( client->alertManager )
     {
@@ -1200,3 +2480,105 @@ static bool AiaClient_StartOfflineAlertTone( const AiaAlertSlot_t* offlineAlert,
     return true;
 }
 #endif
+
+#ifdef AIA_ENABLE_CLIENT_COMMAND_QUEUE
+static bool AiaClient_QueueCommand( AiaClient_t* client,
+                                    const AiaClientCommand_t* command )
+{
+    if( !AiaMpscQueue_Push( client->commandQueue, command ) )
+    {
+        AiaLogError( "Command queue full, dropping command %d",
+                     command->type );
+        return false;
+    }
+
+    if( !AiaAtomicBool_Load( &client->isCommandPending ) )
+    {
+        AiaAtomicBool_Set( &client->isCommandPending );
+        if( !AiaTimer( Arm )( &client->commandWorker, 0, 0 ) )
+        {
+            /* The command stays queued for the next call to apply. */
+            AiaLogWarn( "AiaTimer( Arm ) failed" );
+            AiaAtomicBool_Clear( &client->isCommandPending );
+        }
+    }
+    return true;
+}
+
+/**
+ * Applies one queued public call.
+ *
+ * @param client The @c AiaClient_t to act on.
+ * @param command The call to apply.
+ * @return The result the call would have returned had it been made directly.
+ */
+static bool AiaClient_ApplyCommand( AiaClient_t* client,
+                                    const AiaClientCommand_t* command )
+{
+    switch( command->type )
+    {
+#ifdef AIA_ENABLE_SPEAKER
+        case AIA_CLIENT_COMMAND_STOP_SPEAKER:
+            AiaSpeakerManager_StopPlayback( client->speakerManager );
+            return true;
+        case AIA_CLIENT_COMMAND_SPEAKER_READY:
+            AiaSpeakerManager_OnSpeakerReady( client->speakerManager );
+            return true;
+        case AIA_CLIENT_COMMAND_CHANGE_VOLUME:
+            return AiaSpeakerManager_ChangeVolume( client->speakerManager,
+                                                   command->volume );
+        case AIA_CLIENT_COMMAND_ADJUST_VOLUME:
+            return AiaSpeakerManager_AdjustVolume( client->speakerManager,
+                                                   command->volumeDelta );
+#endif
+#ifdef AIA_ENABLE_MICROPHONE
+        case AIA_CLIENT_COMMAND_HOLD_TO_TALK_START:
+            return AiaMicrophoneManager_HoldToTalkStart(
+                client->microphoneManager, command->beginIndex );
+        case AIA_CLIENT_COMMAND_CLOSE_MICROPHONE:
+            AiaMicrophoneManager_CloseMicrophone( client->microphoneManager );
+            return true;
+        case AIA_CLIENT_COMMAND_TAP_TO_TALK_START:
+            return AiaMicrophoneManager_TapToTalkStart(
+                client->microphoneManager, command->beginIndex,
+                command->profile );
+        case AIA_CLIENT_COMMAND_WAKE_WORD_START:
+            return AiaMicrophoneManager_WakeWordStart(
+                client->microphoneManager, command->beginIndex,
+                command->endIndex, command->profile, AIA_ALEXA_WAKE_WORD );
+#endif
+        case AIA_CLIENT_COMMAND_BUTTON_PRESSED:
+            return AiaButtonCommandSender_OnButtonPressed(
+                client->buttonCommandSender, command->button );
+        case AIA_CLIENT_COMMAND_SYNCHRONIZE_STATE:
+            return AiaClient_PublishSynchronizeState( client );
+    }
+    AiaLogError( "Unknown command %d", command->type );
+    return false;
+}
+
+static void AiaClient_CommandRoutine( void* context )
+{
+    AiaClient_t* client = (AiaClient_t*)context;
+    AiaAssert( client );
+    if( !client )
+    {
+        AiaLogError( "Null client" );
+        return;
+    }
+
+    /* Calls made by callbacks of the commands applied here are queued behind
+     * them and applied by this same run. */
+    AiaMutex( Lock )( &client->commandWorkerMutex );
+    AiaAtomicBool_Clear( &client->isCommandPending );
+    AiaClientCommand_t command;
+    while( AiaMpscQueue_Pop( client->commandQueue, &command ) )
+    {
+        if( !AiaClient_ApplyCommand( client, &command ) )
+        {
+            AiaLogWarn( "Command %d failed", command.type );
+        }
+    }
+    AiaMutex( Unlock )( &client->commandWorkerMutex );
+}
+#endif
@@ -25,8 +25,21 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+/**
+ * Starts the engine which performs requests for @c
+ * AiaLibCurlHttpClient_SendHttpsRequest(). All requests run on one background
+ * thread through a single curl multi handle, which reuses connections,
+ * multiplexes requests over HTTP/2 and shares TLS sessions between them. This
+ * should be called after @c curl_global_init().
+ *
+ * @return @c true if the engine was started or @c false otherwise.
+ */
+bool AiaLibCurlHttpClient_Init();
+
 /**
  * @copyDoc AiaSendHttpsRequest()
+ * @note Callbacks are made from the engine thread started by @c
+ * AiaLibCurlHttpClient_Init().
  */
 bool AiaLibCurlHttpClient_SendHttpsRequest(
     AiaHttpsRequest_t* httpsRequest,
@@ -35,4 +48,22 @@ bool AiaLibCurlHttpClient_SendHttpsRequest(
     AiaHttpsConnectionFailureCallback_t failureCallback,
     void* failureCallbackUserData );
 
+/**
+ * @copyDoc AiaSendHttpsStreamingRequest()
+ */
+bool AiaLibCurlHttpClient_SendHttpsStreamingRequest(
+    AiaHttpsRequest_t* httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void* responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void* failureCallbackUserData );
+
+/**
+ * Stops the engine started by @c AiaLibCurlHttpClient_Init(), closing its
+ * connections. Requests which have not completed are failed. This should be
+ * called before @c curl_global_cleanup().
+ */
+void AiaLibCurlHttpClient_Cleanup();
+
 #endif /* ifndef AIA_LIBCURL_H_ */
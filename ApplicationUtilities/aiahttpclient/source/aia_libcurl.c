@@ -21,12 +21,20 @@
 
 #include <aia_libcurl.h>
 
+#include AiaListDouble( HEADER )
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+
 #include <curl/curl.h>
 
 /* TODO: This is a ballpark estimate. Calculate this more precisely. */
 /** Maximimum length possible in a registration response. */
 #define MAX_RESPONSE_BODY_LEN 250
 
+/** The longest the engine waits for activity before checking for requests and
+ * shutdown, which also wake it up directly. */
+#define AIA_LIBCURL_ENGINE_POLL_TIMEOUT_MS 1000
+
 /**
  * Implements the write callback of LibCurl.
  *
@@ -44,6 +52,15 @@ static size_t AiaLibCurlHttpClient_ResponseBodyCallback( char *ptr, size_t size,
 /** Simple struct to keep track of received data. */
 struct ResponseBodyMemoryStruct
 {
+    /** The easy handle receiving the data. */
+    CURL *curl;
+
+    /** If set, received data is passed to this instead of @c body. */
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback;
+
+    /** User data to pass to @c chunkCallback. */
+    void *chunkCallbackUserData;
+
     /** Buffer in which to write received data into. */
     char body[ MAX_RESPONSE_BODY_LEN ];
 
@@ -52,12 +69,254 @@ struct ResponseBodyMemoryStruct
     size_t bodyLenConsumedSoFar;
 };
 
+/** A request handed to the engine, from submission until its callback. */
+typedef struct AiaLibCurlTransfer
+{
+    /** The link in @c pendingTransfers or @c activeTransfers. */
+    AiaListDouble( Link_t ) link;
+
+    /** The easy handle performing the request. */
+    CURL *curl;
+
+    /** The headers of the request. */
+    struct curl_slist *headers;
+
+    /** The received response. */
+    struct ResponseBodyMemoryStruct body;
+
+    /** A callback for when a response is received from the server. */
+    AiaHttpsConnectionResponseCallback_t responseCallback;
+
+    /** User data to pass to @c responseCallback. */
+    void *responseCallbackUserData;
+
+    /** A callback for when a failure in encountered making the request. */
+    AiaHttpsConnectionFailureCallback_t failureCallback;
+
+    /** User data to pass to @c failureCallback. */
+    void *failureCallbackUserData;
+} AiaLibCurlTransfer_t;
+
+/**
+ * Long-lived engine which performs all requests on one thread through a single
+ * multi handle, so that connections, HTTP/2 streams and TLS sessions are shared
+ * between requests.
+ */
+static struct AiaLibCurlEngine
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Transfers submitted but not yet added to @c multi. */
+    AiaListDouble_t pendingTransfers;
+
+    /** @} */
+
+    /** Transfers added to @c multi, only touched by the engine thread. */
+    AiaListDouble_t activeTransfers;
+
+    /** Drives all transfers and holds the connection cache. */
+    CURLM *multi;
+
+    /** Shares the TLS session and DNS caches between transfers. */
+    CURLSH *share;
+
+    /** Posted by the engine thread as it exits. */
+    AiaSemaphore_t stopped;
+
+    /** Whether the engine is running. */
+    AiaAtomicBool_t isInitialized;
+
+    /** Set to ask the engine thread to exit. */
+    AiaAtomicBool_t isStopping;
+} g_aiaLibCurlEngine;
+
+/**
+ * Submits a HTTPS request to the engine, accumulating the body of the response
+ * unless @c chunkCallback is set.
+ *
+ * @param httpsRequest Information used for sending the HTTPS request.
+ * @param chunkCallback An optional callback for each chunk of the body of the
+ * response.
+ * @param responseCallback A callback for when the response is complete.
+ * @param responseCallbackUserData User data to pass to @c chunkCallback and @c
+ * responseCallback.
+ * @param failureCallback A callback for when a failure in encountered making
+ * the request.
+ * @param failureCallbackUserData User data to pass to @c failureCallback.
+ * @return @c true if the request was submitted successfully or @c false
+ * otherwise.
+ */
+static bool AiaLibCurlHttpClient_Send(
+    AiaHttpsRequest_t *httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void *responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void *failureCallbackUserData );
+
+/**
+ * Configures the easy handle of a transfer for a request.
+ *
+ * @param transfer The transfer to configure.
+ * @param httpsRequest Information used for sending the HTTPS request.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaLibCurlTransfer_Setup( AiaLibCurlTransfer_t *transfer,
+                                      AiaHttpsRequest_t *httpsRequest );
+
+/**
+ * Releases the resources of a transfer.
+ *
+ * @param transfer The transfer to destroy.
+ */
+static void AiaLibCurlTransfer_Destroy( AiaLibCurlTransfer_t *transfer );
+
+/**
+ * Reports the outcome of a transfer to its callbacks and destroys it.
+ *
+ * @param transfer The finished transfer.
+ * @param result The outcome of the transfer.
+ */
+static void AiaLibCurlTransfer_Complete( AiaLibCurlTransfer_t *transfer,
+                                         CURLcode result );
+
+/**
+ * Performs transfers until the engine stops, then fails the transfers which
+ * did not finish.
+ *
+ * @param context Unused.
+ */
+static void AiaLibCurlEngine_Thread( void *context );
+
+bool AiaLibCurlHttpClient_Init()
+{
+    if( AiaAtomicBool_Load( &g_aiaLibCurlEngine.isInitialized ) )
+    {
+        AiaLogError( "HTTP client already initialized." );
+        return false;
+    }
+
+    g_aiaLibCurlEngine.multi = curl_multi_init();
+    if( !g_aiaLibCurlEngine.multi )
+    {
+        AiaLogError( "curl_multi_init failed" );
+        return false;
+    }
+    CURLMcode mres = curl_multi_setopt(
+        g_aiaLibCurlEngine.multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX );
+    if( mres != CURLM_OK )
+    {
+        AiaLogWarn( "HTTP/2 multiplexing unavailable, error=%s",
+                    curl_multi_strerror( mres ) );
+    }
+
+    g_aiaLibCurlEngine.share = curl_share_init();
+    if( !g_aiaLibCurlEngine.share )
+    {
+        AiaLogError( "curl_share_init failed" );
+        curl_multi_cleanup( g_aiaLibCurlEngine.multi );
+        return false;
+    }
+    /* Only the engine thread performs transfers, so the share needs no lock
+     * callbacks. */
+    curl_share_setopt( g_aiaLibCurlEngine.share, CURLSHOPT_SHARE,
+                       CURL_LOCK_DATA_SSL_SESSION );
+    curl_share_setopt( g_aiaLibCurlEngine.share, CURLSHOPT_SHARE,
+                       CURL_LOCK_DATA_DNS );
+
+    if( !AiaMutex( Create )( &g_aiaLibCurlEngine.mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        curl_share_cleanup( g_aiaLibCurlEngine.share );
+        curl_multi_cleanup( g_aiaLibCurlEngine.multi );
+        return false;
+    }
+    if( !AiaSemaphore( Create )( &g_aiaLibCurlEngine.stopped, 0, 1 ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &g_aiaLibCurlEngine.mutex );
+        curl_share_cleanup( g_aiaLibCurlEngine.share );
+        curl_multi_cleanup( g_aiaLibCurlEngine.multi );
+        return false;
+    }
+    AiaListDouble( Create )( &g_aiaLibCurlEngine.pendingTransfers );
+    AiaListDouble( Create )( &g_aiaLibCurlEngine.activeTransfers );
+    AiaAtomicBool_Clear( &g_aiaLibCurlEngine.isStopping );
+
+    if( !Iot_CreateDetachedThread( AiaLibCurlEngine_Thread, NULL,
+                                   IOT_THREAD_DEFAULT_PRIORITY,
+                                   IOT_THREAD_DEFAULT_STACK_SIZE ) )
+    {
+        AiaLogError( "Failed to start the HTTP engine thread." );
+        AiaSemaphore( Destroy )( &g_aiaLibCurlEngine.stopped );
+        AiaMutex( Destroy )( &g_aiaLibCurlEngine.mutex );
+        curl_share_cleanup( g_aiaLibCurlEngine.share );
+        curl_multi_cleanup( g_aiaLibCurlEngine.multi );
+        return false;
+    }
+    AiaAtomicBool_Set( &g_aiaLibCurlEngine.isInitialized );
+    return true;
+}
+
 bool AiaLibCurlHttpClient_SendHttpsRequest(
     AiaHttpsRequest_t *httpsRequest,
     AiaHttpsConnectionResponseCallback_t responseCallback,
     void *responseCallbackUserData,
     AiaHttpsConnectionFailureCallback_t failureCallback,
     void *failureCallbackUserData )
+{
+    return AiaLibCurlHttpClient_Send(
+        httpsRequest, NULL, responseCallback, responseCallbackUserData,
+        failureCallback, failureCallbackUserData );
+}
+
+bool AiaLibCurlHttpClient_SendHttpsStreamingRequest(
+    AiaHttpsRequest_t *httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void *responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void *failureCallbackUserData )
+{
+    if( !chunkCallback )
+    {
+        AiaLogError( "Null chunkCallback" );
+        return false;
+    }
+    return AiaLibCurlHttpClient_Send(
+        httpsRequest, chunkCallback, responseCallback,
+        responseCallbackUserData, failureCallback, failureCallbackUserData );
+}
+
+void AiaLibCurlHttpClient_Cleanup()
+{
+    if( !AiaAtomicBool_Load( &g_aiaLibCurlEngine.isInitialized ) )
+    {
+        AiaLogDebug( "HTTP client not initialized." );
+        return;
+    }
+    AiaAtomicBool_Set( &g_aiaLibCurlEngine.isStopping );
+    curl_multi_wakeup( g_aiaLibCurlEngine.multi );
+    AiaSemaphore( Wait )( &g_aiaLibCurlEngine.stopped );
+
+    AiaAtomicBool_Clear( &g_aiaLibCurlEngine.isInitialized );
+    AiaSemaphore( Destroy )( &g_aiaLibCurlEngine.stopped );
+    AiaMutex( Destroy )( &g_aiaLibCurlEngine.mutex );
+    curl_multi_cleanup( g_aiaLibCurlEngine.multi );
+    curl_share_cleanup( g_aiaLibCurlEngine.share );
+}
+
+static bool AiaLibCurlHttpClient_Send(
+    AiaHttpsRequest_t *httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void *responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void *failureCallbackUserData )
 {
     if( !responseCallback )
     {
@@ -71,12 +330,55 @@ bool AiaLibCurlHttpClient_SendHttpsRequest(
         return false;
     }
 
-    CURL *curl = curl_easy_init();
-    if( !curl )
+    if( !AiaAtomicBool_Load( &g_aiaLibCurlEngine.isInitialized ) )
+    {
+        AiaLogError( "HTTP client not initialized." );
+        return false;
+    }
+
+    AiaLibCurlTransfer_t *transfer =
+        AiaCalloc( 1, sizeof( AiaLibCurlTransfer_t ) );
+    if( !transfer )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaLibCurlTransfer_t ) );
+        return false;
+    }
+    transfer->responseCallback = responseCallback;
+    transfer->responseCallbackUserData = responseCallbackUserData;
+    transfer->failureCallback = failureCallback;
+    transfer->failureCallbackUserData = failureCallbackUserData;
+    transfer->body.chunkCallback = chunkCallback;
+    transfer->body.chunkCallbackUserData = responseCallbackUserData;
+
+    transfer->curl = curl_easy_init();
+    if( !transfer->curl )
     {
         AiaLogError( "curl_easy_init failed" );
+        AiaFree( transfer );
         return false;
     }
+    transfer->body.curl = transfer->curl;
+    if( !AiaLibCurlTransfer_Setup( transfer, httpsRequest ) )
+    {
+        AiaLibCurlTransfer_Destroy( transfer );
+        return false;
+    }
+
+    /* The multi handle is only touched by the engine thread, which picks the
+     * transfer up from here. */
+    AiaMutex( Lock )( &g_aiaLibCurlEngine.mutex );
+    AiaListDouble( InsertTail )( &g_aiaLibCurlEngine.pendingTransfers,
+                                 &transfer->link );
+    AiaMutex( Unlock )( &g_aiaLibCurlEngine.mutex );
+    curl_multi_wakeup( g_aiaLibCurlEngine.multi );
+    return true;
+}
+
+static bool AiaLibCurlTransfer_Setup( AiaLibCurlTransfer_t *transfer,
+                                      AiaHttpsRequest_t *httpsRequest )
+{
+    CURL *curl = transfer->curl;
 
     /* Setting the url to send the request to. */
     CURLcode res = curl_easy_setopt( curl, CURLOPT_URL, httpsRequest->url );
@@ -84,7 +386,6 @@ bool AiaLibCurlHttpClient_SendHttpsRequest(
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_easy_cleanup( curl );
         return false;
     }
 
@@ -94,58 +395,57 @@ bool AiaLibCurlHttpClient_SendHttpsRequest(
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_easy_cleanup( curl );
         return false;
     }
 
+    /* Prefer HTTP/2, and wait for a connection which can be multiplexed rather
+     * than opening another. These are only optimizations, so failing them is
+     * not fatal. */
+    curl_easy_setopt( curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS );
+    curl_easy_setopt( curl, CURLOPT_PIPEWAIT, 1L );
+    curl_easy_setopt( curl, CURLOPT_SHARE, g_aiaLibCurlEngine.share );
+
     /* Adding in headers one by one. */
-    struct curl_slist *list = NULL;
-    struct curl_slist *temp = NULL;
     for( size_t i = 0; i < httpsRequest->headersLen; ++i )
     {
-        /* Note: The string is not deep-copied and must remain valid until this
-         * allocation the transfer is complete. */
-        temp = curl_slist_append( list, httpsRequest->headers[ i ] );
+        /* Note: The string is copied by curl_slist_append(). */
+        struct curl_slist *temp =
+            curl_slist_append( transfer->headers, httpsRequest->headers[ i ] );
         if( !temp )
         {
             AiaLogError( "curl_slist_append failed" );
-            curl_slist_free_all( list );
-            curl_easy_cleanup( curl );
+            return false;
         }
-        list = temp;
+        transfer->headers = temp;
     }
-    res = curl_easy_setopt( curl, CURLOPT_HTTPHEADER, list );
+    res = curl_easy_setopt( curl, CURLOPT_HTTPHEADER, transfer->headers );
     if( res != CURLE_OK )
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
         return false;
     }
 
-    /* Setting the request body. */
-    res = curl_easy_setopt( curl, CURLOPT_POSTFIELDS, httpsRequest->body );
+    /* Setting the request body, which is copied since the transfer outlives
+     * @c httpsRequest. */
+    res = curl_easy_setopt( curl, CURLOPT_COPYPOSTFIELDS, httpsRequest->body );
     if( res != CURLE_OK )
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
         return false;
     }
     switch( httpsRequest->method )
     {
         case AIA_HTTPS_METHOD_POST:
-            /* Using CURLOPT_POSTFIELDS implies setting CURLOPT_POST to 1. */
+            /* Using CURLOPT_COPYPOSTFIELDS implies setting CURLOPT_POST to
+             * 1. */
             break;
         default:
             /* For other types, something like the following should be done:
              * curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT"); */
             AiaLogError( "Unsupported AiaHttpsMethod_t, method=%d",
                          httpsRequest->method );
-            curl_slist_free_all( list );
-            curl_easy_cleanup( curl );
             return false;
     }
 
@@ -156,60 +456,153 @@ bool AiaLibCurlHttpClient_SendHttpsRequest(
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
         return false;
     }
-    struct ResponseBodyMemoryStruct body;
-    memset( &body, 0, sizeof( body ) );
 
     /* Setting user data for @c AiaLibCurlHttpClient_ResponseBodyCallback. */
-    res = curl_easy_setopt( curl, CURLOPT_WRITEDATA, &body );
+    res = curl_easy_setopt( curl, CURLOPT_WRITEDATA, &transfer->body );
     if( res != CURLE_OK )
     {
         AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
         return false;
     }
 
-    /* TODO: ADSER-1897 This is blocking. Update to use multi interface for
-     * non-blocking functionality. */
-    res = curl_easy_perform( curl );
+    /* Lets the engine find the transfer of a finished easy handle. */
+    res = curl_easy_setopt( curl, CURLOPT_PRIVATE, transfer );
     if( res != CURLE_OK )
     {
-        AiaLogError( "curl_easy_perform failed, error=%s",
+        AiaLogError( "curl_easy_setopt failed, error=%s",
                      curl_easy_strerror( res ) );
-        failureCallback( failureCallbackUserData );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
-        return true;
+        return false;
+    }
+    return true;
+}
+
+static void AiaLibCurlTransfer_Destroy( AiaLibCurlTransfer_t *transfer )
+{
+    curl_easy_cleanup( transfer->curl );
+    curl_slist_free_all( transfer->headers );
+    AiaFree( transfer );
+}
+
+static void AiaLibCurlTransfer_Complete( AiaLibCurlTransfer_t *transfer,
+                                         CURLcode result )
+{
+    if( result != CURLE_OK )
+    {
+        AiaLogError( "Transfer failed, error=%s",
+                     curl_easy_strerror( result ) );
+        transfer->failureCallback( transfer->failureCallbackUserData );
+        AiaLibCurlTransfer_Destroy( transfer );
+        return;
     }
 
     /* All data is now received. */
 
     /* Parse response code. */
     long response_code;
-    res = curl_easy_getinfo( curl, CURLINFO_RESPONSE_CODE, &response_code );
+    CURLcode res = curl_easy_getinfo( transfer->curl, CURLINFO_RESPONSE_CODE,
+                                      &response_code );
     if( res != CURLE_OK )
     {
-        AiaLogError( "curl_easy_perform failed, error=%s",
+        AiaLogError( "curl_easy_getinfo failed, error=%s",
                      curl_easy_strerror( res ) );
-        failureCallback( failureCallbackUserData );
-        curl_slist_free_all( list );
-        curl_easy_cleanup( curl );
-        return true;
+        transfer->failureCallback( transfer->failureCallbackUserData );
+        AiaLibCurlTransfer_Destroy( transfer );
+        return;
     }
     AiaHttpsResponse_t response;
-    response.body = body.body;
-    response.bodyLen = body.bodyLenConsumedSoFar;
+    response.body = transfer->body.chunkCallback ? NULL : transfer->body.body;
+    response.bodyLen = transfer->body.bodyLenConsumedSoFar;
     response.status = response_code;
-    responseCallback( &response, responseCallbackUserData );
+    transfer->responseCallback( &response,
+                                transfer->responseCallbackUserData );
+    AiaLibCurlTransfer_Destroy( transfer );
+}
 
-    curl_slist_free_all( list );
-    curl_easy_cleanup( curl );
-    return true;
+static void AiaLibCurlEngine_Thread( void *context )
+{
+    (void)context;
+    AiaListDouble( Link_t ) *link = NULL;
+    while( !AiaAtomicBool_Load( &g_aiaLibCurlEngine.isStopping ) )
+    {
+        /* Add newly submitted transfers. */
+        AiaMutex( Lock )( &g_aiaLibCurlEngine.mutex );
+        while( ( link = AiaListDouble( RemoveHead )(
+                     &g_aiaLibCurlEngine.pendingTransfers ) ) )
+        {
+            AiaLibCurlTransfer_t *transfer = (AiaLibCurlTransfer_t *)link;
+            CURLMcode mres = curl_multi_add_handle( g_aiaLibCurlEngine.multi,
+                                                    transfer->curl );
+            if( mres != CURLM_OK )
+            {
+                AiaLogError( "curl_multi_add_handle failed, error=%s",
+                             curl_multi_strerror( mres ) );
+                AiaMutex( Unlock )( &g_aiaLibCurlEngine.mutex );
+                AiaLibCurlTransfer_Complete( transfer, CURLE_FAILED_INIT );
+                AiaMutex( Lock )( &g_aiaLibCurlEngine.mutex );
+                continue;
+            }
+            AiaListDouble( InsertTail )( &g_aiaLibCurlEngine.activeTransfers,
+                                         &transfer->link );
+        }
+        AiaMutex( Unlock )( &g_aiaLibCurlEngine.mutex );
+
+        int running = 0;
+        CURLMcode mres =
+            curl_multi_perform( g_aiaLibCurlEngine.multi, &running );
+        if( mres != CURLM_OK )
+        {
+            AiaLogError( "curl_multi_perform failed, error=%s",
+                         curl_multi_strerror( mres ) );
+        }
+
+        /* Complete finished transfers. */
+        CURLMsg *message = NULL;
+        int queued = 0;
+        while( ( message = curl_multi_info_read( g_aiaLibCurlEngine.multi,
+                                                 &queued ) ) )
+        {
+            if( message->msg != CURLMSG_DONE )
+            {
+                continue;
+            }
+            AiaLibCurlTransfer_t *transfer = NULL;
+            curl_easy_getinfo( message->easy_handle, CURLINFO_PRIVATE,
+                               (char **)&transfer );
+            CURLcode result = message->data.result;
+            curl_multi_remove_handle( g_aiaLibCurlEngine.multi,
+                                      transfer->curl );
+            AiaListDouble( Remove )( &transfer->link );
+            AiaLibCurlTransfer_Complete( transfer, result );
+        }
+
+        /* Sleeps until there is socket activity, a transfer times out, or
+         * curl_multi_wakeup() is called. */
+        curl_multi_poll( g_aiaLibCurlEngine.multi, NULL, 0,
+                         AIA_LIBCURL_ENGINE_POLL_TIMEOUT_MS, NULL );
+    }
+
+    /* Fail whatever did not finish so that no caller waits forever. */
+    while( ( link = AiaListDouble( RemoveHead )(
+                 &g_aiaLibCurlEngine.activeTransfers ) ) )
+    {
+        AiaLibCurlTransfer_t *transfer = (AiaLibCurlTransfer_t *)link;
+        curl_multi_remove_handle( g_aiaLibCurlEngine.multi, transfer->curl );
+        AiaLibCurlTransfer_Complete( transfer, CURLE_ABORTED_BY_CALLBACK );
+    }
+    AiaMutex( Lock )( &g_aiaLibCurlEngine.mutex );
+    while( ( link = AiaListDouble( RemoveHead )(
+                 &g_aiaLibCurlEngine.pendingTransfers ) ) )
+    {
+        AiaMutex( Unlock )( &g_aiaLibCurlEngine.mutex );
+        AiaLibCurlTransfer_Complete( (AiaLibCurlTransfer_t *)link,
+                                     CURLE_ABORTED_BY_CALLBACK );
+        AiaMutex( Lock )( &g_aiaLibCurlEngine.mutex );
+    }
+    AiaMutex( Unlock )( &g_aiaLibCurlEngine.mutex );
+    AiaSemaphore( Post )( &g_aiaLibCurlEngine.stopped );
 }
 
 static size_t AiaLibCurlHttpClient_ResponseBodyCallback( char *content,
@@ -221,6 +614,15 @@ static size_t AiaLibCurlHttpClient_ResponseBodyCallback( char *content,
     (void)nmemb;
     struct ResponseBodyMemoryStruct *body = userdata;
     size_t contentSizeReceived = size * nmemb;
+    if( body->chunkCallback )
+    {
+        /* The status line has been received by the time the body arrives. */
+        long responseCode = 0;
+        curl_easy_getinfo( body->curl, CURLINFO_RESPONSE_CODE, &responseCode );
+        body->chunkCallback( responseCode, content, contentSizeReceived,
+                             body->chunkCallbackUserData );
+        return contentSizeReceived;
+    }
     if( body->bodyLenConsumedSoFar + contentSizeReceived >
         MAX_RESPONSE_BODY_LEN )
     {
@@ -0,0 +1,140 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_opus_decode_ahead.h
+ * @brief User-facing functions of the @c AiaOpusDecodeAhead_t type
+ */
+
+#ifndef AIA_OPUS_DECODE_AHEAD_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+#define AIA_OPUS_DECODE_AHEAD_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiaopusdecoder/aia_opus_decoder.h>
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The largest Opus frame, in bytes, that can be pushed for decoding. */
+#define AIA_OPUS_DECODE_AHEAD_MAX_FRAME_SIZE 1275
+
+/**
+ * Callback used to hand decoded pcm samples to the platform for playback.
+ *
+ * @param samples Interleaved pcm samples.
+ * @param numSamples The number of samples per channel in @c samples.
+ * @param userData User data associated with this callback.
+ * @return @c true if the samples were accepted, or @c false if the platform
+ * cannot take them right now. In that case, the same samples are offered again
+ * after @c AiaOpusDecodeAhead_OnPcmSinkReady() is called.
+ */
+typedef bool ( *AiaOpusDecodeAheadPlayPcm_t )( const int16_t* samples,
+                                               size_t numSamples,
+                                               void* userData );
+
+/**
+ * Callback used to signal that frames can be pushed again after @c
+ * AiaOpusDecodeAhead_PushFrame() refused one. Applications typically forward
+ * this to @c AiaClient_OnSpeakerReady().
+ *
+ * @param userData User data associated with this callback.
+ */
+typedef void ( *AiaOpusDecodeAheadReady_t )( void* userData );
+
+/**
+ * A decode stage which sits between @c AiaSpeakerManager_t and the platform
+ * speaker. Opus frames pushed by the speaker manager are queued, decoded up to
+ * a configurable number of frames ahead of playback on a dedicated thread, and
+ * handed to the platform as pcm. This keeps decoding time off the speaker
+ * manager's playback thread and lets multicore devices decode on another core.
+ * Methods of this object are thread-safe.
+ */
+typedef struct AiaOpusDecodeAhead AiaOpusDecodeAhead_t;
+
+/**
+ * Allocates and initializes a @c AiaOpusDecodeAhead_t object from the heap and
+ * starts its decoding thread. The returned pointer should be destroyed using
+ * @c AiaOpusDecodeAhead_Destroy().
+ *
+ * @param decoder The decoder to decode frames with. This must remain valid for
+ * the lifetime of the returned object and must not be used elsewhere.
+ * @param numFramesAhead The number of frames that may be queued or decoded
+ * ahead of playback.
+ * @param playPcmCb Callback used to hand decoded pcm to the platform. This is
+ * called from the decoding thread.
+ * @param playPcmCbUserData User data to be passed along with @c playPcmCb.
+ * @param readyCb Callback used to signal that frames can be pushed again. This
+ * is called from the decoding thread.
+ * @param readyCbUserData User data to be passed along with @c readyCb.
+ * @return The newly created @c AiaOpusDecodeAhead_t if successful, or NULL
+ * otherwise.
+ */
+AiaOpusDecodeAhead_t* AiaOpusDecodeAhead_Create(
+    AiaOpusDecoder_t* decoder, size_t numFramesAhead,
+    AiaOpusDecodeAheadPlayPcm_t playPcmCb, void* playPcmCbUserData,
+    AiaOpusDecodeAheadReady_t readyCb, void* readyCbUserData );
+
+/**
+ * Stops the decoding thread, then uninitializes and deallocates an @c
+ * AiaOpusDecodeAhead_t previously created by a call to @c
+ * AiaOpusDecodeAhead_Create(). Frames which have not been played are dropped.
+ *
+ * @param decodeAhead The @c AiaOpusDecodeAhead_t to destroy.
+ */
+void AiaOpusDecodeAhead_Destroy( AiaOpusDecodeAhead_t* decodeAhead );
+
+/**
+ * Queues an Opus frame for decoding. This mirrors @c AiaSpeakerManager_t's @c
+ * AiaPlaySpeakerData_t callback, and may be passed to it directly with the @c
+ * AiaOpusDecodeAhead_t as its user data.
+ *
+ * @param frame The frame to decode.
+ * @param size The size in bytes of the frame.
+ * @param userData The @c AiaOpusDecodeAhead_t to act on.
+ * @return @c true if the frame was queued, or @c false if the queue is full or
+ * the frame is invalid. After a full queue, @c readyCb is called once a frame
+ * has been played.
+ */
+bool AiaOpusDecodeAhead_PushFrame( const void* frame, size_t size,
+                                   void* userData );
+
+/**
+ * Signals that the platform can accept pcm again after @c playPcmCb returned
+ * @c false.
+ *
+ * @param decodeAhead The @c AiaOpusDecodeAhead_t to act on.
+ */
+void AiaOpusDecodeAhead_OnPcmSinkReady( AiaOpusDecodeAhead_t* decodeAhead );
+
+/**
+ * Drops all queued and decoded frames which have not been played, e.g. when
+ * speaker playback is stopped.
+ *
+ * @param decodeAhead The @c AiaOpusDecodeAhead_t to act on.
+ */
+void AiaOpusDecodeAhead_Flush( AiaOpusDecodeAhead_t* decodeAhead );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ifndef AIA_OPUS_DECODE_AHEAD_H_ */
@@ -28,6 +28,21 @@ extern "C" {
 /* The config header is always included first. */
 #include <aia_config.h>
 
+/* Standard includes. */
+#include <stddef.h>
+#include <stdint.h>
+
+/** Sample rate, in Hz, of the PCM data produced by the decoder. */
+#define AIA_OPUS_DECODER_SAMPLE_RATE 48000
+
+/**
+ * The maximum number of samples per channel a single Opus frame can decode
+ * into, which is 120 milliseconds at @c AIA_OPUS_DECODER_SAMPLE_RATE. Output
+ * buffers of this many samples per channel can hold any decoded frame.
+ */
+#define AIA_OPUS_DECODER_MAX_FRAME_SAMPLES \
+    ( AIA_OPUS_DECODER_SAMPLE_RATE * 120 / 1000 )
+
 /**
  * Thin wrapper around libOpus for Opus frame decoding.
  */
@@ -67,6 +82,64 @@ int16_t* AiaOpusDecoder_DecodeFrame( AiaOpusDecoder_t* decoder,
                                      const void* frame, size_t size,
                                      int* numDecodedSamplesOut );
 
+/**
+ * Decodes Opus encoded data provided into a caller-provided buffer. This allows
+ * applications to decode into a statically allocated buffer rather than
+ * allocating one per frame as @c AiaOpusDecoder_DecodeFrame() does.
+ *
+ * @param decoder The AiaOpusDecoder_t to act on.
+ * @param frame The frame to decode.
+ * @param size The size in bytes of the frame.
+ * @param[out] out Buffer to write decoded interleaved pcm samples to.
+ * @param capacity The number of @c int16_t samples @c out can hold.
+ * @return The number of decoded samples per channel written to @c out, or a
+ * negative value on failure.
+ */
+int AiaOpusDecoder_DecodeFrameInto( AiaOpusDecoder_t* decoder,
+                                    const void* frame, size_t size,
+                                    int16_t* out, size_t capacity );
+
+/**
+ * Decodes a run of equally sized contiguous Opus frames into a single
+ * contiguous block of pcm samples in a caller-provided buffer. This mirrors @c
+ * AiaSpeakerManager_t's @c AiaPlaySpeakerDataBatch_t callback.
+ *
+ * @param decoder The AiaOpusDecoder_t to act on.
+ * @param frames The frames to decode.
+ * @param size The size in bytes of all @c frames.
+ * @param frameCount The number of equally sized frames contained in @c frames.
+ * @param[out] out Buffer to write decoded interleaved pcm samples to.
+ * @param capacity The number of @c int16_t samples @c out can hold.
+ * @return The total number of decoded samples per channel written to @c out,
+ * or a negative value on failure. On failure, the contents of @c out are
+ * unspecified.
+ */
+int AiaOpusDecoder_DecodeFrames( AiaOpusDecoder_t* decoder, const void* frames,
+                                 size_t size, size_t frameCount, int16_t* out,
+                                 size_t capacity );
+
+/**
+ * Synthesizes pcm samples in place of lost Opus frames using libOpus packet
+ * loss concealment. This mirrors @c AiaSpeakerManager_t's @c
+ * AiaConcealSpeakerData_t callback.
+ *
+ * @param decoder The AiaOpusDecoder_t to act on.
+ * @param frameSize The size in bytes of each lost frame.
+ * @param frameCount The number of lost frames to conceal.
+ * @param nextFrame The first frame received after the lost frames, or @c NULL
+ * if it is not available. If provided, the last lost frame is recovered from
+ * the forward error correction data embedded in @c nextFrame when present.
+ * Note that @c nextFrame itself is not decoded and should be decoded
+ * afterwards as usual.
+ * @param[out] out Buffer to write synthesized interleaved pcm samples to.
+ * @param capacity The number of @c int16_t samples @c out can hold.
+ * @return The total number of synthesized samples per channel written to @c
+ * out, or a negative value on failure.
+ */
+int AiaOpusDecoder_ConcealFrames( AiaOpusDecoder_t* decoder, size_t frameSize,
+                                  size_t frameCount, const void* nextFrame,
+                                  int16_t* out, size_t capacity );
+
 #ifdef __cplusplus
 }
 #endif
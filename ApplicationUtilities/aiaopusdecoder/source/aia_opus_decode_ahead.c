@@ -0,0 +1,441 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_opus_decode_ahead.c
+ * @brief Implements functions for the AiaOpusDecodeAhead_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aia_capabilities_config.h>
+#include <aiaopusdecoder/aia_opus_decode_ahead.h>
+
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+
+#include <string.h>
+
+/** The number of interleaved samples a slot can hold. */
+#define AIA_OPUS_DECODE_AHEAD_SLOT_CAPACITY \
+    ( AIA_OPUS_DECODER_MAX_FRAME_SAMPLES *  \
+      AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS )
+
+/** A frame in the ring, from being pushed until it has been played. */
+typedef struct AiaOpusDecodeAheadSlot
+{
+    /** The Opus frame as pushed. */
+    uint8_t frame[ AIA_OPUS_DECODE_AHEAD_MAX_FRAME_SIZE ];
+
+    /** The size in bytes of @c frame. */
+    size_t frameSize;
+
+    /** The decoded samples, only touched by the decoding thread. */
+    int16_t pcm[ AIA_OPUS_DECODE_AHEAD_SLOT_CAPACITY ];
+
+    /** The number of samples per channel in @c pcm. */
+    size_t numSamples;
+} AiaOpusDecodeAheadSlot_t;
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaOpusDecodeAhead_t abstraction.
+ */
+struct AiaOpusDecodeAhead
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** Index of the oldest frame in @c slots. */
+    size_t head;
+
+    /** The number of frames in @c slots, starting at @c head. */
+    size_t numQueued;
+
+    /** The number of frames starting at @c head which have been decoded. */
+    size_t numDecoded;
+
+    /** Incremented by each flush, so that the decoding thread can discard the
+     * frame it was working on. */
+    uint32_t epoch;
+
+    /** Whether @c playPcmCb refused samples and is waiting to become ready. */
+    bool isPcmSinkBlocked;
+
+    /** Whether a push was refused since @c readyCb was last called. */
+    bool isPushRefused;
+
+    /** @} */
+
+    /** Posted whenever there may be work for the decoding thread. */
+    AiaSemaphore_t workAvailable;
+
+    /** Posted by the decoding thread as it exits. */
+    AiaSemaphore_t stopped;
+
+    /** Tells the decoding thread to exit. */
+    AiaAtomicBool_t isStopping;
+
+    /** A copy of the frame being decoded, only touched by the decoding
+     * thread. */
+    uint8_t decodingFrame[ AIA_OPUS_DECODE_AHEAD_MAX_FRAME_SIZE ];
+
+    /** The decoder, only used by the decoding thread. */
+    AiaOpusDecoder_t* const decoder;
+
+    /** The ring of frames, with @c numSlots entries. */
+    AiaOpusDecodeAheadSlot_t* const slots;
+
+    /** The number of entries in @c slots. */
+    const size_t numSlots;
+
+    /** Callback used to hand decoded pcm to the platform. */
+    const AiaOpusDecodeAheadPlayPcm_t playPcmCb;
+
+    /** User data to be passed along with @c playPcmCb. */
+    void* const playPcmCbUserData;
+
+    /** Callback used to signal that frames can be pushed again. */
+    const AiaOpusDecodeAheadReady_t readyCb;
+
+    /** User data to be passed along with @c readyCb. */
+    void* const readyCbUserData;
+};
+
+/**
+ * Routine of the decoding thread.
+ *
+ * @param context The @c AiaOpusDecodeAhead_t to act on.
+ */
+static void AiaOpusDecodeAhead_Thread( void* context );
+
+/**
+ * Hands the oldest decoded frame to @c playPcmCb.
+ *
+ * @param decodeAhead The @c AiaOpusDecodeAhead_t to act on.
+ * @return @c true if a frame was consumed, or @c false if there was nothing to
+ * play or the platform refused it.
+ */
+static bool AiaOpusDecodeAhead_PlayNext( AiaOpusDecodeAhead_t* decodeAhead );
+
+/**
+ * Decodes the oldest frame which has not been decoded yet.
+ *
+ * @param decodeAhead The @c AiaOpusDecodeAhead_t to act on.
+ * @return @c true if a frame was consumed, or @c false if there was nothing to
+ * decode.
+ */
+static bool AiaOpusDecodeAhead_DecodeNext( AiaOpusDecodeAhead_t* decodeAhead );
+
+AiaOpusDecodeAhead_t* AiaOpusDecodeAhead_Create(
+    AiaOpusDecoder_t* decoder, size_t numFramesAhead,
+    AiaOpusDecodeAheadPlayPcm_t playPcmCb, void* playPcmCbUserData,
+    AiaOpusDecodeAheadReady_t readyCb, void* readyCbUserData )
+{
+    if( !decoder )
+    {
+        AiaLogError( "Null decoder" );
+        return NULL;
+    }
+    if( !numFramesAhead )
+    {
+        AiaLogError( "Invalid numFramesAhead" );
+        return NULL;
+    }
+    if( !playPcmCb )
+    {
+        AiaLogError( "Null playPcmCb" );
+        return NULL;
+    }
+    if( !readyCb )
+    {
+        AiaLogError( "Null readyCb" );
+        return NULL;
+    }
+
+    AiaOpusDecodeAhead_t* decodeAhead =
+        AiaCalloc( 1, sizeof( AiaOpusDecodeAhead_t ) );
+    if( !decodeAhead )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaOpusDecodeAhead_t ) );
+        return NULL;
+    }
+    AiaOpusDecodeAheadSlot_t* slots =
+        AiaCalloc( numFramesAhead, sizeof( AiaOpusDecodeAheadSlot_t ) );
+    if( !slots )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     numFramesAhead * sizeof( AiaOpusDecodeAheadSlot_t ) );
+        AiaFree( decodeAhead );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &decodeAhead->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( slots );
+        AiaFree( decodeAhead );
+        return NULL;
+    }
+    if( !AiaSemaphore( Create )( &decodeAhead->workAvailable, 0,
+                                 UINT32_MAX ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &decodeAhead->mutex );
+        AiaFree( slots );
+        AiaFree( decodeAhead );
+        return NULL;
+    }
+    if( !AiaSemaphore( Create )( &decodeAhead->stopped, 0, 1 ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaSemaphore( Destroy )( &decodeAhead->workAvailable );
+        AiaMutex( Destroy )( &decodeAhead->mutex );
+        AiaFree( slots );
+        AiaFree( decodeAhead );
+        return NULL;
+    }
+
+    *(AiaOpusDecoder_t**)&decodeAhead->decoder = decoder;
+    *(AiaOpusDecodeAheadSlot_t**)&decodeAhead->slots = slots;
+    *(size_t*)&decodeAhead->numSlots = numFramesAhead;
+    *(AiaOpusDecodeAheadPlayPcm_t*)&decodeAhead->playPcmCb = playPcmCb;
+    *(void**)&decodeAhead->playPcmCbUserData = playPcmCbUserData;
+    *(AiaOpusDecodeAheadReady_t*)&decodeAhead->readyCb = readyCb;
+    *(void**)&decodeAhead->readyCbUserData = readyCbUserData;
+    AiaAtomicBool_Clear( &decodeAhead->isStopping );
+
+    if( !Iot_CreateDetachedThread( AiaOpusDecodeAhead_Thread, decodeAhead,
+                                   IOT_THREAD_DEFAULT_PRIORITY,
+                                   IOT_THREAD_DEFAULT_STACK_SIZE ) )
+    {
+        AiaLogError( "Failed to start the decoding thread." );
+        AiaSemaphore( Destroy )( &decodeAhead->stopped );
+        AiaSemaphore( Destroy )( &decodeAhead->workAvailable );
+        AiaMutex( Destroy )( &decodeAhead->mutex );
+        AiaFree( slots );
+        AiaFree( decodeAhead );
+        return NULL;
+    }
+    return decodeAhead;
+}
+
+void AiaOpusDecodeAhead_Destroy( AiaOpusDecodeAhead_t* decodeAhead )
+{
+    if( !decodeAhead )
+    {
+        AiaLogDebug( "Null decodeAhead." );
+        return;
+    }
+    AiaAtomicBool_Set( &decodeAhead->isStopping );
+    AiaSemaphore( Post )( &decodeAhead->workAvailable );
+    AiaSemaphore( Wait )( &decodeAhead->stopped );
+
+    if( decodeAhead->numQueued )
+    {
+        AiaLogDebug( "Dropping %zu frames.", decodeAhead->numQueued );
+    }
+    AiaSemaphore( Destroy )( &decodeAhead->stopped );
+    AiaSemaphore( Destroy )( &decodeAhead->workAvailable );
+    AiaMutex( Destroy )( &decodeAhead->mutex );
+    AiaFree( decodeAhead->slots );
+    AiaFree( decodeAhead );
+}
+
+bool AiaOpusDecodeAhead_PushFrame( const void* frame, size_t size,
+                                   void* userData )
+{
+    AiaOpusDecodeAhead_t* decodeAhead = (AiaOpusDecodeAhead_t*)userData;
+    if( !decodeAhead )
+    {
+        AiaLogError( "Null decodeAhead" );
+        return false;
+    }
+    if( !frame )
+    {
+        AiaLogError( "Null frame" );
+        return false;
+    }
+    if( size > AIA_OPUS_DECODE_AHEAD_MAX_FRAME_SIZE )
+    {
+        AiaLogError( "Frame too large, size=%zu, max=%d", size,
+                     AIA_OPUS_DECODE_AHEAD_MAX_FRAME_SIZE );
+        return false;
+    }
+
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    if( decodeAhead->numQueued == decodeAhead->numSlots )
+    {
+        decodeAhead->isPushRefused = true;
+        AiaMutex( Unlock )( &decodeAhead->mutex );
+        return false;
+    }
+    AiaOpusDecodeAheadSlot_t* slot =
+        &decodeAhead->slots[ ( decodeAhead->head + decodeAhead->numQueued ) %
+                             decodeAhead->numSlots ];
+    memcpy( slot->frame, frame, size );
+    slot->frameSize = size;
+    ++decodeAhead->numQueued;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+
+    AiaSemaphore( Post )( &decodeAhead->workAvailable );
+    return true;
+}
+
+void AiaOpusDecodeAhead_OnPcmSinkReady( AiaOpusDecodeAhead_t* decodeAhead )
+{
+    if( !decodeAhead )
+    {
+        AiaLogError( "Null decodeAhead" );
+        return;
+    }
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    decodeAhead->isPcmSinkBlocked = false;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+    AiaSemaphore( Post )( &decodeAhead->workAvailable );
+}
+
+void AiaOpusDecodeAhead_Flush( AiaOpusDecodeAhead_t* decodeAhead )
+{
+    if( !decodeAhead )
+    {
+        AiaLogError( "Null decodeAhead" );
+        return;
+    }
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    decodeAhead->head = 0;
+    decodeAhead->numQueued = 0;
+    decodeAhead->numDecoded = 0;
+    ++decodeAhead->epoch;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+
+    /* Wake the decoding thread so that a refused push is signalled. */
+    AiaSemaphore( Post )( &decodeAhead->workAvailable );
+}
+
+static void AiaOpusDecodeAhead_Thread( void* context )
+{
+    AiaOpusDecodeAhead_t* decodeAhead = (AiaOpusDecodeAhead_t*)context;
+    while( true )
+    {
+        AiaSemaphore( Wait )( &decodeAhead->workAvailable );
+        if( AiaAtomicBool_Load( &decodeAhead->isStopping ) )
+        {
+            break;
+        }
+
+        /* Playing takes priority, and decoding one frame at a time between
+         * attempts keeps a slow decode from delaying ready samples. */
+        bool progressed = true;
+        while( progressed )
+        {
+            progressed = AiaOpusDecodeAhead_PlayNext( decodeAhead );
+            progressed |= AiaOpusDecodeAhead_DecodeNext( decodeAhead );
+
+            AiaMutex( Lock )( &decodeAhead->mutex );
+            bool isReady = decodeAhead->isPushRefused &&
+                           decodeAhead->numQueued < decodeAhead->numSlots;
+            if( isReady )
+            {
+                decodeAhead->isPushRefused = false;
+            }
+            AiaMutex( Unlock )( &decodeAhead->mutex );
+            if( isReady )
+            {
+                decodeAhead->readyCb( decodeAhead->readyCbUserData );
+            }
+        }
+    }
+    AiaSemaphore( Post )( &decodeAhead->stopped );
+}
+
+static bool AiaOpusDecodeAhead_PlayNext( AiaOpusDecodeAhead_t* decodeAhead )
+{
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    if( decodeAhead->isPcmSinkBlocked || !decodeAhead->numDecoded )
+    {
+        AiaMutex( Unlock )( &decodeAhead->mutex );
+        return false;
+    }
+    AiaOpusDecodeAheadSlot_t* slot = &decodeAhead->slots[ decodeAhead->head ];
+    uint32_t epoch = decodeAhead->epoch;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+
+    /* Only this thread writes pcm, so it can be read without the lock. Frames
+     * which failed to decode are dropped. */
+    bool accepted = !slot->numSamples ||
+                    decodeAhead->playPcmCb( slot->pcm, slot->numSamples,
+                                            decodeAhead->playPcmCbUserData );
+
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    if( epoch != decodeAhead->epoch )
+    {
+        AiaMutex( Unlock )( &decodeAhead->mutex );
+        return true;
+    }
+    if( !accepted )
+    {
+        decodeAhead->isPcmSinkBlocked = true;
+        AiaMutex( Unlock )( &decodeAhead->mutex );
+        return false;
+    }
+    decodeAhead->head = ( decodeAhead->head + 1 ) % decodeAhead->numSlots;
+    --decodeAhead->numQueued;
+    --decodeAhead->numDecoded;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+    return true;
+}
+
+static bool AiaOpusDecodeAhead_DecodeNext( AiaOpusDecodeAhead_t* decodeAhead )
+{
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    if( decodeAhead->numDecoded == decodeAhead->numQueued )
+    {
+        AiaMutex( Unlock )( &decodeAhead->mutex );
+        return false;
+    }
+    AiaOpusDecodeAheadSlot_t* slot =
+        &decodeAhead->slots[ ( decodeAhead->head + decodeAhead->numDecoded ) %
+                             decodeAhead->numSlots ];
+    /* A flush lets pushes reuse the slot, so decode from a copy. */
+    size_t frameSize = slot->frameSize;
+    memcpy( decodeAhead->decodingFrame, slot->frame, frameSize );
+    uint32_t epoch = decodeAhead->epoch;
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+
+    int numDecodedSamples = AiaOpusDecoder_DecodeFrameInto(
+        decodeAhead->decoder, decodeAhead->decodingFrame, frameSize, slot->pcm,
+        AIA_OPUS_DECODE_AHEAD_SLOT_CAPACITY );
+    if( numDecodedSamples < 0 )
+    {
+        AiaLogError( "AiaOpusDecoder_DecodeFrameInto failed, size=%zu",
+                     frameSize );
+        numDecodedSamples = 0;
+    }
+    slot->numSamples = numDecodedSamples;
+
+    AiaMutex( Lock )( &decodeAhead->mutex );
+    if( epoch == decodeAhead->epoch )
+    {
+        ++decodeAhead->numDecoded;
+    }
+    AiaMutex( Unlock )( &decodeAhead->mutex );
+    return true;
+}
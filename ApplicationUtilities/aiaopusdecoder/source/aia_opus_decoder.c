@@ -28,9 +28,6 @@
 
 #include <opus/opus.h>
 
-/* Default sample rate. */
-#define AIA_DECODE_SAMPLE_RATE 48000
-
 /**
  * Underlying struct that contains all the data required to present the @c
  * AiaOpusDecoder_t abstraction.
@@ -41,6 +38,15 @@ struct AiaOpusDecoder
     OpusDecoder* decoder;
 };
 
+/**
+ * Calculates the number of samples per channel a frame decodes into based on
+ * its size and the configured bitrate.
+ *
+ * @param size The size in bytes of the frame.
+ * @return The number of samples per channel the frame decodes into.
+ */
+static int AiaOpusDecoder_GetFrameSamples( size_t size );
+
 AiaOpusDecoder_t* AiaOpusDecoder_Create()
 {
 #ifndef AIA_ENABLE_SPEAKER
@@ -64,9 +70,9 @@ AiaOpusDecoder_t* AiaOpusDecoder_Create()
         return NULL;
     }
 
-    int error =
-        opus_decoder_init( aiaOpusDecoder->decoder, AIA_DECODE_SAMPLE_RATE,
-                           AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS );
+    int error = opus_decoder_init( aiaOpusDecoder->decoder,
+                                   AIA_OPUS_DECODER_SAMPLE_RATE,
+                                   AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS );
     if( error != OPUS_OK )
     {
         AiaLogError( "opus_decoder_init failed, error=%d", error );
@@ -90,6 +96,15 @@ void AiaOpusDecoder_Destroy( AiaOpusDecoder_t* aiaOpusDecoder )
     AiaFree( aiaOpusDecoder );
 }
 
+static int AiaOpusDecoder_GetFrameSamples( size_t size )
+{
+    int totalBits = size * 8;
+    AiaDurationMs_t frameDuration =
+        totalBits /
+        ( AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND / AIA_MS_PER_SECOND );
+    return AIA_OPUS_DECODER_SAMPLE_RATE * frameDuration / AIA_MS_PER_SECOND;
+}
+
 int16_t* AiaOpusDecoder_DecodeFrame( AiaOpusDecoder_t* aiaOpusDecoder,
                                      const void* frame, size_t size,
                                      int* numDecodedSamplesOut )
@@ -104,29 +119,19 @@ int16_t* AiaOpusDecoder_DecodeFrame( AiaOpusDecoder_t* aiaOpusDecoder,
         AiaLogError( "Null numDecodedSamplesOut" );
         return NULL;
     }
-    int totalBits = size * 8;
-    AiaDurationMs_t frameDuration =
-        totalBits /
-        ( AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND / AIA_MS_PER_SECOND );
-    int frameSize = AIA_DECODE_SAMPLE_RATE * frameDuration / AIA_MS_PER_SECOND;
-
-    /* TODO: ADSER-1693 This is seriously inefficient, should be a buffer passed
-     * by user that can be a static buffer. */
-    int16_t* pcmBytes = AiaCalloc(
-        frameSize * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS, sizeof( int16_t ) );
+    size_t capacity = AiaOpusDecoder_GetFrameSamples( size ) *
+                      AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS;
+    int16_t* pcmBytes = AiaCalloc( capacity, sizeof( int16_t ) );
     if( !pcmBytes )
     {
         AiaLogError( "AiaCalloc failed, bytes=%zu",
-                     frameSize * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS *
-                         sizeof( int16_t ) );
+                     capacity * sizeof( int16_t ) );
         return NULL;
     }
-    int numDecodedSamples = opus_decode( aiaOpusDecoder->decoder, frame, size,
-                                         pcmBytes, frameSize, 0 );
+    int numDecodedSamples = AiaOpusDecoder_DecodeFrameInto(
+        aiaOpusDecoder, frame, size, pcmBytes, capacity );
     if( numDecodedSamples < 0 )
     {
-        AiaLogError( "opus_decode failed, error=%s",
-                     opus_strerror( numDecodedSamples ) );
         AiaFree( pcmBytes );
         return NULL;
     }
@@ -134,3 +139,116 @@ int16_t* AiaOpusDecoder_DecodeFrame( AiaOpusDecoder_t* aiaOpusDecoder,
     *numDecodedSamplesOut = numDecodedSamples;
     return pcmBytes;
 }
+
+int AiaOpusDecoder_DecodeFrameInto( AiaOpusDecoder_t* aiaOpusDecoder,
+                                    const void* frame, size_t size,
+                                    int16_t* out, size_t capacity )
+{
+    if( !aiaOpusDecoder )
+    {
+        AiaLogError( "Null aiaOpusDecoder" );
+        return -1;
+    }
+    if( !out )
+    {
+        AiaLogError( "Null out" );
+        return -1;
+    }
+    size_t frameSize = AiaOpusDecoder_GetFrameSamples( size );
+    if( frameSize * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS > capacity )
+    {
+        AiaLogError( "Insufficient capacity, required=%zu, capacity=%zu",
+                     frameSize * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS,
+                     capacity );
+        return -1;
+    }
+    int numDecodedSamples = opus_decode( aiaOpusDecoder->decoder, frame, size,
+                                         out, frameSize, 0 );
+    if( numDecodedSamples < 0 )
+    {
+        AiaLogError( "opus_decode failed, error=%s",
+                     opus_strerror( numDecodedSamples ) );
+        return -1;
+    }
+    return numDecodedSamples;
+}
+
+int AiaOpusDecoder_DecodeFrames( AiaOpusDecoder_t* aiaOpusDecoder,
+                                 const void* frames, size_t size,
+                                 size_t frameCount, int16_t* out,
+                                 size_t capacity )
+{
+    if( !frameCount || size % frameCount )
+    {
+        AiaLogError( "Invalid frameCount, size=%zu, frameCount=%zu", size,
+                     frameCount );
+        return -1;
+    }
+    size_t frameBytes = size / frameCount;
+    const uint8_t* frame = frames;
+    int totalDecodedSamples = 0;
+    for( size_t i = 0; i < frameCount; ++i )
+    {
+        int numDecodedSamples = AiaOpusDecoder_DecodeFrameInto(
+            aiaOpusDecoder, frame, frameBytes, out, capacity );
+        if( numDecodedSamples < 0 )
+        {
+            AiaLogError( "Failed to decode frame, index=%zu", i );
+            return -1;
+        }
+        size_t numDecodedValues =
+            numDecodedSamples * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS;
+        out += numDecodedValues;
+        capacity -= numDecodedValues;
+        frame += frameBytes;
+        totalDecodedSamples += numDecodedSamples;
+    }
+    return totalDecodedSamples;
+}
+
+int AiaOpusDecoder_ConcealFrames( AiaOpusDecoder_t* aiaOpusDecoder,
+                                  size_t frameSize, size_t frameCount,
+                                  const void* nextFrame, int16_t* out,
+                                  size_t capacity )
+{
+    if( !aiaOpusDecoder )
+    {
+        AiaLogError( "Null aiaOpusDecoder" );
+        return -1;
+    }
+    if( !out )
+    {
+        AiaLogError( "Null out" );
+        return -1;
+    }
+    size_t frameSamples = AiaOpusDecoder_GetFrameSamples( frameSize );
+    if( frameSamples * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS * frameCount >
+        capacity )
+    {
+        AiaLogError( "Insufficient capacity, required=%zu, capacity=%zu",
+                     frameSamples * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS *
+                         frameCount,
+                     capacity );
+        return -1;
+    }
+
+    int totalDecodedSamples = 0;
+    for( size_t i = 0; i < frameCount; ++i )
+    {
+        /* A NULL packet requests packet loss concealment, while decoding the
+         * next packet with decode_fec set recovers the frame preceding it. */
+        bool useFec = nextFrame && i + 1 == frameCount;
+        int numDecodedSamples =
+            opus_decode( aiaOpusDecoder->decoder, useFec ? nextFrame : NULL,
+                         useFec ? frameSize : 0, out, frameSamples, useFec );
+        if( numDecodedSamples < 0 )
+        {
+            AiaLogError( "opus_decode failed, error=%s",
+                         opus_strerror( numDecodedSamples ) );
+            return -1;
+        }
+        out += numDecodedSamples * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS;
+        totalDecodedSamples += numDecodedSamples;
+    }
+    return totalDecodedSamples;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_opus_encoder.h
+ * @brief User-facing functions of the @c AiaOpusEncoder_t type
+ */
+
+#ifndef AIA_OPUS_ENCODER_H_
+#ifdef __cplusplus
+extern "C" {
+#endif
+#define AIA_OPUS_ENCODER_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_utils.h>
+#include <aiamicrophonemanager/aia_microphone_manager.h>
+
+/* Standard includes. */
+#include <stddef.h>
+#include <stdint.h>
+
+/** Duration in milliseconds of each encoded Opus frame. */
+#define AIA_OPUS_ENCODER_FRAME_DURATION_MS 20
+
+/** The number of microphone samples encoded into each Opus frame. */
+#define AIA_OPUS_ENCODER_FRAME_SAMPLES                                      \
+    ( AIA_MICROPHONE_SAMPLE_RATE_HZ * AIA_OPUS_ENCODER_FRAME_DURATION_MS / \
+      AIA_MS_PER_SECOND )
+
+/**
+ * Thin wrapper around libOpus for constant bitrate encoding of microphone
+ * samples.
+ */
+typedef struct AiaOpusEncoder AiaOpusEncoder_t;
+
+/**
+ * Allocates and initializes a @c AiaOpusEncoder_t object from the heap. The
+ * encoder is configured for speech at @c
+ * AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND. The returned pointer should be
+ * destroyed using @c AiaOpusEncoder_Destroy().
+ *
+ * @return The newly created @c AiaOpusEncoder_t if successful, or NULL
+ * otherwise.
+ */
+AiaOpusEncoder_t* AiaOpusEncoder_Create();
+
+/**
+ * Uninitializes and deallocates an @c AiaOpusEncoder_t previously created by
+ * a call to @c AiaOpusEncoder_Create().
+ *
+ * @param encoder The @c AiaOpusEncoder_t to destroy.
+ */
+void AiaOpusEncoder_Destroy( AiaOpusEncoder_t* encoder );
+
+/**
+ * Returns the size in bytes of each encoded Opus frame.
+ *
+ * @return The size in bytes of each encoded frame.
+ */
+size_t AiaOpusEncoder_GetFrameBytes();
+
+/**
+ * Encodes a run of contiguous frames of @c AIA_OPUS_ENCODER_FRAME_SAMPLES
+ * samples each into contiguous Opus frames of @c AiaOpusEncoder_GetFrameBytes()
+ * bytes each. This mirrors @c AiaMicrophoneManager_t's @c
+ * AiaMicrophoneEncodeFrames_t callback.
+ *
+ * @param samples The samples to encode.
+ * @param frameCount The number of frames in @c samples.
+ * @param[out] out Buffer to write the encoded frames to.
+ * @param userData The @c AiaOpusEncoder_t to act on.
+ * @return @c true if all frames were encoded or @c false otherwise. On
+ * failure, the contents of @c out are unspecified.
+ */
+bool AiaOpusEncoder_EncodeFrames( const int16_t* samples, size_t frameCount,
+                                  uint8_t* out, void* userData );
+
+/**
+ * Describes @c encoder for installation with @c
+ * AiaMicrophoneManager_SetEncoder() or @c AiaClient_SetMicrophoneEncoder().
+ *
+ * @param encoder The @c AiaOpusEncoder_t to act on.
+ * @param[out] microphoneEncoder The description of @c encoder.
+ */
+void AiaOpusEncoder_GetMicrophoneEncoder(
+    AiaOpusEncoder_t* encoder, AiaMicrophoneEncoder_t* microphoneEncoder );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ifndef AIA_OPUS_ENCODER_H_ */
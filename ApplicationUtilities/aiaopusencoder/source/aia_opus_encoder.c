@@ -0,0 +1,176 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_opus_encoder.c
+ * @brief Implements functions for the AiaOpusEncoder_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aia_capabilities_config.h>
+#include <aiacore/aia_utils.h>
+#include <aiaopusencoder/aia_opus_encoder.h>
+
+#include <opus/opus.h>
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaOpusEncoder_t abstraction.
+ */
+struct AiaOpusEncoder
+{
+    /** Underlying libOpus encoder. */
+    OpusEncoder* encoder;
+};
+
+AiaOpusEncoder_t* AiaOpusEncoder_Create()
+{
+#ifndef AIA_ENABLE_MICROPHONE
+#error "Microphone capability must be enabled"
+#endif
+#ifndef AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE
+#error "Microphone audio encoder bitrate must be configured"
+#endif
+    AiaOpusEncoder_t* aiaOpusEncoder =
+        AiaCalloc( 1, sizeof( AiaOpusEncoder_t ) );
+    if( !aiaOpusEncoder )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaOpusEncoder_t ) );
+        return NULL;
+    }
+
+    int size =
+        opus_encoder_get_size( AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS );
+    aiaOpusEncoder->encoder = AiaCalloc( 1, size );
+    if( !aiaOpusEncoder->encoder )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%d.", size );
+        AiaFree( aiaOpusEncoder );
+        return NULL;
+    }
+
+    int error = opus_encoder_init(
+        aiaOpusEncoder->encoder, AIA_MICROPHONE_SAMPLE_RATE_HZ,
+        AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS, OPUS_APPLICATION_VOIP );
+    if( error != OPUS_OK )
+    {
+        AiaLogError( "opus_encoder_init failed, error=%d", error );
+        AiaFree( aiaOpusEncoder->encoder );
+        AiaFree( aiaOpusEncoder );
+        return NULL;
+    }
+
+    /* Constant bitrate keeps every frame the same size, as advertised. */
+    if( opus_encoder_ctl(
+            aiaOpusEncoder->encoder,
+            OPUS_SET_BITRATE(
+                (opus_int32)AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND ) ) !=
+            OPUS_OK ||
+        opus_encoder_ctl( aiaOpusEncoder->encoder, OPUS_SET_VBR( 0 ) ) !=
+            OPUS_OK ||
+        opus_encoder_ctl( aiaOpusEncoder->encoder,
+                          OPUS_SET_SIGNAL( OPUS_SIGNAL_VOICE ) ) != OPUS_OK )
+    {
+        AiaLogError( "opus_encoder_ctl failed" );
+        AiaFree( aiaOpusEncoder->encoder );
+        AiaFree( aiaOpusEncoder );
+        return NULL;
+    }
+
+    return aiaOpusEncoder;
+}
+
+void AiaOpusEncoder_Destroy( AiaOpusEncoder_t* aiaOpusEncoder )
+{
+    AiaAssert( aiaOpusEncoder );
+    if( !aiaOpusEncoder )
+    {
+        AiaLogError( "Null encoder" );
+        return;
+    }
+    AiaFree( aiaOpusEncoder->encoder );
+    AiaFree( aiaOpusEncoder );
+}
+
+size_t AiaOpusEncoder_GetFrameBytes()
+{
+    return AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND *
+           AIA_OPUS_ENCODER_FRAME_DURATION_MS / 8 / AIA_MS_PER_SECOND;
+}
+
+bool AiaOpusEncoder_EncodeFrames( const int16_t* samples, size_t frameCount,
+                                  uint8_t* out, void* userData )
+{
+    AiaOpusEncoder_t* aiaOpusEncoder = (AiaOpusEncoder_t*)userData;
+    if( !aiaOpusEncoder )
+    {
+        AiaLogError( "Null aiaOpusEncoder" );
+        return false;
+    }
+    if( !samples || !out )
+    {
+        AiaLogError( "Null buffer" );
+        return false;
+    }
+    size_t frameBytes = AiaOpusEncoder_GetFrameBytes();
+    for( size_t i = 0; i < frameCount; ++i )
+    {
+        opus_int32 encodedBytes =
+            opus_encode( aiaOpusEncoder->encoder, samples,
+                         AIA_OPUS_ENCODER_FRAME_SAMPLES, out, frameBytes );
+        if( encodedBytes < 0 )
+        {
+            AiaLogError( "opus_encode failed, error=%s",
+                         opus_strerror( encodedBytes ) );
+            return false;
+        }
+        /* Frames which need fewer bytes than the bitrate allows are padded so
+         * that they can be delimited by size alone. */
+        if( (size_t)encodedBytes < frameBytes )
+        {
+            int error = opus_packet_pad( out, encodedBytes, frameBytes );
+            if( error != OPUS_OK )
+            {
+                AiaLogError( "opus_packet_pad failed, error=%s",
+                             opus_strerror( error ) );
+                return false;
+            }
+        }
+        samples += AIA_OPUS_ENCODER_FRAME_SAMPLES *
+                   AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS;
+        out += frameBytes;
+    }
+    return true;
+}
+
+void AiaOpusEncoder_GetMicrophoneEncoder(
+    AiaOpusEncoder_t* aiaOpusEncoder,
+    AiaMicrophoneEncoder_t* microphoneEncoder )
+{
+    AiaAssert( microphoneEncoder );
+    if( !microphoneEncoder )
+    {
+        AiaLogError( "Null microphoneEncoder" );
+        return;
+    }
+    microphoneEncoder->encodeFrames = AiaOpusEncoder_EncodeFrames;
+    microphoneEncoder->userData = aiaOpusEncoder;
+    microphoneEncoder->frameSamples = AIA_OPUS_ENCODER_FRAME_SAMPLES;
+    microphoneEncoder->frameBytes = AiaOpusEncoder_GetFrameBytes();
+}
@@ -50,6 +50,24 @@ typedef struct AiaPortAudioMicrophoneRecorder AiaPortAudioMicrophoneRecorder_t;
 AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
     AiaDataStreamWriter_t* bufferWriter );
 
+/**
+ * Creates an @c AiaPortAudioMicrophoneRecorder_t which is fed by PortAudio's
+ * stream callback instead of polling the stream with a timer. Captured samples
+ * are copied straight into space reserved in the underlying buffer, so there is
+ * no intermediate buffer and captures are not batched up by the polling
+ * cadence. Samples which arrive while the buffer is full are dropped. The
+ * returned pointer should be destroyed using @c
+ * AiaPortAudioMicrophoneRecorder_Destroy().
+ *
+ * @param bufferWriter The writer to use to write microphone data into an @c
+ * AiaDataStreamBuffer_t. This is written to from PortAudio's callback thread.
+ * @return A newly created @c AiaPortAudioMicrophoneRecorder_t if successful or
+ * @c NULL otherwise.
+ */
+AiaPortAudioMicrophoneRecorder_t*
+    AiaPortAudioMicrophoneRecorder_CreateCallbackDriven(
+        AiaDataStreamWriter_t* bufferWriter );
+
 /**
  * Uninitializes and deallocates an @c AiaPortAudioMicrophoneRecorder_t
  * previously created by a call to
@@ -29,6 +29,8 @@
 #include AiaMutex( HEADER )
 #include AiaTimer( HEADER )
 
+#include <string.h>
+
 /** Number of channels format of microphone data. */
 static const int NUM_INPUT_CHANNELS = 1;
 
@@ -49,6 +51,24 @@ static const double SAMPLE_RATE = 16000;
 static void AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask(
     void* userData );
 
+/**
+ * PortAudio stream callback used when callback driven. This copies the
+ * captured samples straight into space reserved in the underlying buffer.
+ * Samples which do not fit are dropped.
+ *
+ * @param input The @c frameCount frames of captured samples.
+ * @param output Unused, since there are no output channels.
+ * @param frameCount Number of frames captured.
+ * @param timeInfo Unused.
+ * @param statusFlags Unused.
+ * @param userData The @c AiaPortAudioMicrophoneRecorder_t.
+ * @return @c paContinue, to keep the stream running.
+ */
+static int AiaPortAudioMicrophoneRecorder_CaptureCallback(
+    const void* input, void* output, unsigned long frameCount,
+    const PaStreamCallbackTimeInfo* timeInfo,
+    PaStreamCallbackFlags statusFlags, void* userData );
+
 /**
  * A thin wrapper around PortAudio used for recording microphone data.
  */
@@ -71,12 +91,27 @@ struct AiaPortAudioMicrophoneRecorder
     /** @} */
 
     /** Timer used to periodically capture and write available microphone data.
-     */
+     * This is only created when not callback driven. */
     AiaTimer_t captureMicrophoneTimer;
+
+    /** Whether samples are delivered by PortAudio's stream callback rather than
+     * read by @c captureMicrophoneTimer. */
+    bool callbackDriven;
 };
 
-AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
-    AiaDataStreamWriter_t* bufferWriter )
+/**
+ * Creates an @c AiaPortAudioMicrophoneRecorder_t.
+ *
+ * @param bufferWriter The writer to use to write microphone data into an @c
+ * AiaDataStreamBuffer_t.
+ * @param callbackDriven Whether PortAudio should deliver samples from its
+ * stream callback rather than have them read by a timer.
+ * @return A newly created @c AiaPortAudioMicrophoneRecorder_t if successful or
+ * @c NULL otherwise.
+ */
+static AiaPortAudioMicrophoneRecorder_t*
+    AiaPortAudioMicrophoneRecorder_CreateInternal(
+        AiaDataStreamWriter_t* bufferWriter, bool callbackDriven )
 {
     if( !bufferWriter )
     {
@@ -121,10 +156,13 @@ AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
     }
 
     recorder->bufferWriter = bufferWriter;
+    recorder->callbackDriven = callbackDriven;
 
-    err = Pa_OpenDefaultStream( &recorder->paStream, NUM_INPUT_CHANNELS,
-                                NUM_OUTPUT_CHANNELS, paInt16, SAMPLE_RATE,
-                                paFramesPerBufferUnspecified, NULL, NULL );
+    err = Pa_OpenDefaultStream(
+        &recorder->paStream, NUM_INPUT_CHANNELS, NUM_OUTPUT_CHANNELS, paInt16,
+        SAMPLE_RATE, paFramesPerBufferUnspecified,
+        callbackDriven ? AiaPortAudioMicrophoneRecorder_CaptureCallback : NULL,
+        recorder );
     if( err != paNoError )
     {
         AiaLogError( "Failed to open PortAudio default stream, errorCode=%s",
@@ -135,6 +173,11 @@ AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
         return NULL;
     }
 
+    if( callbackDriven )
+    {
+        return recorder;
+    }
+
     if( !AiaTimer( Create )(
             &recorder->captureMicrophoneTimer,
             AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask, recorder ) )
@@ -162,6 +205,19 @@ AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
     return recorder;
 }
 
+AiaPortAudioMicrophoneRecorder_t* AiaPortAudioMicrophoneRecorder_Create(
+    AiaDataStreamWriter_t* bufferWriter )
+{
+    return AiaPortAudioMicrophoneRecorder_CreateInternal( bufferWriter, false );
+}
+
+AiaPortAudioMicrophoneRecorder_t*
+    AiaPortAudioMicrophoneRecorder_CreateCallbackDriven(
+        AiaDataStreamWriter_t* bufferWriter )
+{
+    return AiaPortAudioMicrophoneRecorder_CreateInternal( bufferWriter, true );
+}
+
 void AiaPortAudioMicrophoneRecorder_Destroy(
     AiaPortAudioMicrophoneRecorder_t* recorder )
 {
@@ -172,7 +228,10 @@ void AiaPortAudioMicrophoneRecorder_Destroy(
         return;
     }
 
-    AiaTimer( Destroy )( &recorder->captureMicrophoneTimer );
+    if( !recorder->callbackDriven )
+    {
+        AiaTimer( Destroy )( &recorder->captureMicrophoneTimer );
+    }
 
     AiaMutex( Lock )( &recorder->mutex );
     Pa_CloseStream( recorder->paStream );
@@ -210,10 +269,37 @@ void AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask( void* userData )
         return;
     }
 
-    /* TODO: ADSER-1692 Double copy here, optimize. */
-    int16_t buf[ numFramesAvailableToRead ];
-    PaError err =
-        Pa_ReadStream( recorder->paStream, buf, numFramesAvailableToRead );
+    /* Capture directly into the microphone buffer. */
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t numFramesReserved = AiaDataStreamWriter_Reserve(
+        recorder->bufferWriter, spans, numFramesAvailableToRead );
+    if( numFramesReserved <= 0 )
+    {
+        AiaMutex( Unlock )( &recorder->mutex );
+        AiaLogError( "Failed to reserve stream, error=%s",
+                     AiaDataStreamWriter_ErrorToString( numFramesReserved ) );
+        return;
+    }
+
+    PaError err = paNoError;
+    for( size_t i = 0; i < AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS; ++i )
+    {
+        if( !spans[ i ].nWords )
+        {
+            continue;
+        }
+        PaError spanErr = Pa_ReadStream( recorder->paStream, spans[ i ].data,
+                                         spans[ i ].nWords );
+        if( spanErr != paNoError && spanErr != paInputOverflowed )
+        {
+            err = spanErr;
+            break;
+        }
+        if( spanErr == paInputOverflowed )
+        {
+            err = spanErr;
+        }
+    }
     AiaMutex( Unlock )( &recorder->mutex );
     if( err != paNoError )
     {
@@ -221,6 +307,7 @@ void AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask( void* userData )
         {
             AiaLogError( "Pa_ReadStream failed, errorCode=%s",
                          Pa_GetErrorText( err ) );
+            AiaDataStreamWriter_Publish( recorder->bufferWriter, 0 );
             return;
         }
         else
@@ -229,8 +316,8 @@ void AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask( void* userData )
         }
     }
 
-    ssize_t writeReturnCode = AiaDataStreamWriter_Write(
-        recorder->bufferWriter, buf, numFramesAvailableToRead );
+    ssize_t writeReturnCode =
+        AiaDataStreamWriter_Publish( recorder->bufferWriter, numFramesReserved );
     if( writeReturnCode <= 0 )
     {
         AiaLogError( "Failed to write to stream, error=%s",
@@ -239,6 +326,44 @@ void AiaPortAudioMicrophoneRecorder_MicrophoneCaptureTask( void* userData )
     }
 }
 
+static int AiaPortAudioMicrophoneRecorder_CaptureCallback(
+    const void* input, void* output, unsigned long frameCount,
+    const PaStreamCallbackTimeInfo* timeInfo,
+    PaStreamCallbackFlags statusFlags, void* userData )
+{
+    (void)output;
+    (void)timeInfo;
+    (void)statusFlags;
+    AiaPortAudioMicrophoneRecorder_t* recorder =
+        (AiaPortAudioMicrophoneRecorder_t*)userData;
+    const uint8_t* samples = (const uint8_t*)input;
+    if( !samples )
+    {
+        return paContinue;
+    }
+
+    /* PortAudio owns the capture buffer, so this is the only copy. */
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    ssize_t numFramesReserved = AiaDataStreamWriter_Reserve(
+        recorder->bufferWriter, spans, frameCount );
+    if( numFramesReserved <= 0 )
+    {
+        return paContinue;
+    }
+    for( size_t i = 0; i < AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS; ++i )
+    {
+        if( !spans[ i ].nWords )
+        {
+            continue;
+        }
+        size_t spanBytes = spans[ i ].nWords * AIA_MICROPHONE_BUFFER_WORD_SIZE;
+        memcpy( spans[ i ].data, samples, spanBytes );
+        samples += spanBytes;
+    }
+    AiaDataStreamWriter_Publish( recorder->bufferWriter, numFramesReserved );
+    return paContinue;
+}
+
 bool AiaPortAudioMicrophoneRecorder_StartStreamingMicrophoneData(
     AiaPortAudioMicrophoneRecorder_t* recorder )
 {
@@ -28,6 +28,8 @@ extern "C" {
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+
 #include <portaudio.h>
 
 /** Sample rate of output data. */
@@ -61,6 +63,24 @@ typedef struct AiaPortAudioSpeaker AiaPortAudioSpeaker_t;
 AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
     AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData );
 
+/**
+ * Creates an @c AiaPortAudioSpeaker_t which feeds PortAudio from its stream
+ * callback instead of with blocking writes. Pushed data is queued in a
+ * lock-free ring which the callback drains, so output latency does not depend
+ * on the cadence at which data is pushed. The returned pointer should be
+ * destroyed using @c AiaPortAudioSpeaker_Destroy().
+ *
+ * @param speakerReady Callback that will be invoked when the @c
+ * AiaPortAudioSpeaker_t is ready for new frames to be fed again. This is
+ * invoked from PortAudio's callback thread once the ring drains to its
+ * low-water mark, so it must not block.
+ * @param speakerReadyUserData User data associated with @c speakerReady.
+ * @return A newly created @c AiaPortAudioSpeaker_t if successful or
+ * @c NULL otherwise.
+ */
+AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_CreateCallbackDriven(
+    AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData );
+
 /**
  * Uninitializes and deallocates an @c AiaPortAudioSpeaker_t
  * previously created by a call to
@@ -91,6 +111,65 @@ bool AiaPortAudioSpeaker_PlaySpeakerData( AiaPortAudioSpeaker_t* speaker,
 void AiaPortAudioSpeaker_SetNewVolume( AiaPortAudioSpeaker_t* speaker,
                                        uint8_t volume );
 
+/**
+ * Sets whether volume changes are ramped in over a few milliseconds of
+ * playback rather than applied at once, which avoids audible zipper noise.
+ * Ramping is enabled by default.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @param enabled Whether to ramp volume changes.
+ */
+void AiaPortAudioSpeaker_SetVolumeRampEnabled( AiaPortAudioSpeaker_t* speaker,
+                                               bool enabled );
+
+/**
+ * Estimates how long samples pushed now will take to be heard, from the
+ * device's output latency plus any samples still waiting to be consumed.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @return The playout latency in milliseconds.
+ */
+AiaDurationMs_t AiaPortAudioSpeaker_GetPlayoutLatencyMs(
+    AiaPortAudioSpeaker_t* speaker );
+
+/**
+ * Creates a reader of the echo reference signal, which is every sample handed
+ * to the audio device after volume is applied, including silence played when
+ * no data is buffered. Each word of the stream is one frame of @c
+ * AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS 16-bit samples, so an echo canceller
+ * can read it alongside the microphone reader without copying through the
+ * application. The reader must be destroyed using @c
+ * AiaDataStreamReader_Destroy() before @c speaker is destroyed.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @param policy The policy to use for reading from the stream.
+ * @return The newly created reader, starting with the next frame played, or
+ * @c NULL if @c speaker was not created by @c
+ * AiaPortAudioSpeaker_CreateCallbackDriven() or no more readers are allowed.
+ * @note The reference signal is written from PortAudio's callback, so a reader
+ * which falls behind by more than the reference buffer is overrun rather than
+ * stalling playback.
+ */
+AiaDataStreamReader_t* AiaPortAudioSpeaker_CreateReferenceReader(
+    AiaPortAudioSpeaker_t* speaker, AiaDataStreamReaderPolicy_t policy );
+
+/**
+ * Estimates when a frame of the echo reference signal reaches the audio
+ * device's output, on the @c AiaClock( GetTimeMs )() timeline, to align it
+ * with microphone capture.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @param index The absolute index of the frame, as given by @c
+ * AiaDataStreamReader_Tell() on a reader created by @c
+ * AiaPortAudioSpeaker_CreateReferenceReader().
+ * @param[out] playoutMs The time at which the frame is played.
+ * @return @c true if the time was estimated or @c false if nothing has been
+ * played yet.
+ */
+bool AiaPortAudioSpeaker_GetReferencePlayoutTime(
+    AiaPortAudioSpeaker_t* speaker, AiaDataStreamIndex_t index,
+    AiaTimepointMs_t* playoutMs );
+
 #ifdef __cplusplus
 }
 #endif
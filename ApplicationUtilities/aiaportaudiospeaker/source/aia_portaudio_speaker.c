@@ -25,17 +25,79 @@
 #include <aiaportaudiospeaker/aia_portaudio_speaker.h>
 
 #include <aiacore/aia_volume_constants.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
 #include <aiaspeakermanager/aia_speaker_manager.h>
 
+#include AiaClock( HEADER )
 #include AiaMutex( HEADER )
 #include AiaTimer( HEADER )
 
+#include <string.h>
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h>
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
 /** Not recording anything in this component, so no input channels. */
 static const int NUM_INPUT_CHANNELS = 0;
 
 /** Number of channels in output data. */
 static const int NUM_OUTPUT_CHANNELS = AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS;
 
+/** Gain applied at @c AIA_MAX_VOLUME, in Q15 fixed point. */
+static const int32_t UNITY_GAIN_Q15 = 1 << 15;
+
+/**
+ * Capacity, in samples, of the ring consumed by PortAudio's callback when
+ * callback driven. This must be a power of two.
+ */
+#define RING_BUFFER_SAMPLES ( (uint32_t)8192 )
+
+/**
+ * Number of buffered samples at or below which a callback driven speaker that
+ * rejected data signals that it is ready for data again.
+ */
+static const uint32_t RING_BUFFER_LOW_WATER_MARK_SAMPLES =
+    RING_BUFFER_SAMPLES / 2;
+
+/**
+ * Capacity, in frames, of the echo reference signal when callback driven. This
+ * must be a power of two.
+ */
+#define REFERENCE_BUFFER_FRAMES ( (size_t)16384 )
+
+/** Maximum number of readers of the echo reference signal. */
+static const size_t MAX_REFERENCE_READERS = 2;
+
+/** Duration over which volume changes are ramped, when enabled. */
+static const uint32_t VOLUME_RAMP_DURATION_MS = 5;
+
+/**
+ * Computes the gain to apply at a given volume.
+ *
+ * @param volume The volume, between @c AIA_MIN_VOLUME and @c AIA_MAX_VOLUME,
+ * inclusive.
+ * @return The gain in Q15 fixed point, between 0 and @c UNITY_GAIN_Q15,
+ * inclusive.
+ */
+static int32_t AiaPortAudioSpeaker_GetGainQ15( uint8_t volume );
+
+/**
+ * Scales samples by a constant gain. This is vectorized where NEON or SSE2 is
+ * available, and matches the scalar fallback bit for bit.
+ *
+ * @param in Samples to scale.
+ * @param[out] out Buffer to write the scaled samples into, which may not
+ * overlap @c in.
+ * @param numSamples Number of samples in @c in and @c out.
+ * @param gainQ15 Gain in Q15 fixed point, which must be less than @c
+ * UNITY_GAIN_Q15.
+ */
+static void AiaPortAudioSpeaker_ApplyGain( const int16_t* in, int16_t* out,
+                                           size_t numSamples, int16_t gainQ15 );
+
 /**
  * Task that polls for space in the buffer. This task runs at
  * @c AIA_SPEAKER_FRAME_PUSH_CADENCE_MS / 4 (arbitrary). It is important that
@@ -46,6 +108,24 @@ static const int NUM_OUTPUT_CHANNELS = AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS;
  */
 static void AiaPortAudioSpeaker_PollForBufferSpaceTask( void* userData );
 
+/**
+ * PortAudio stream callback used when callback driven. This copies buffered
+ * samples out of the ring, plays silence if the ring runs dry, and invokes @c
+ * speakerReady once a speaker that rejected data drains to its low-water mark.
+ *
+ * @param input Unused, since there are no input channels.
+ * @param output Buffer to write @c frameCount frames of samples into.
+ * @param frameCount Number of frames requested.
+ * @param timeInfo Times at which PortAudio will play @c output.
+ * @param statusFlags Unused.
+ * @param userData The @c AiaPortAudioSpeaker_t.
+ * @return @c paContinue, to keep the stream running.
+ */
+static int AiaPortAudioSpeaker_PlaybackCallback(
+    const void* input, void* output, unsigned long frameCount,
+    const PaStreamCallbackTimeInfo* timeInfo,
+    PaStreamCallbackFlags statusFlags, void* userData );
+
 /**
  * Underlying struct that contains all the data required to present the @c
  * AiaPortAudioSpeaker_t abstraction.
@@ -77,16 +157,155 @@ struct AiaPortAudioSpeaker
     /** The volume to play at, between @c AIA_MIN_VOLUME and @c AIA_MAX_VOLUME,
      * inclusive.*/
     uint8_t volume;
+
+    /** Gain most recently applied to samples, in Q15 fixed point. This only
+     * differs from the gain of @c volume while a volume change is ramping. */
+    int32_t gainQ15;
+
+    /** Gain at which the current volume ramp started, in Q15 fixed point. */
+    int32_t rampStartGainQ15;
+
+    /** Number of samples of the current volume ramp played so far. */
+    size_t rampPosition;
+
+    /** Number of samples over which volume changes are ramped, or zero if
+     * volume changes are applied immediately. */
+    size_t rampLengthSamples;
+
+    /** Scratch buffer holding volume adjusted samples. */
+    int16_t* scratchBuffer;
+
+    /** Capacity of @c scratchBuffer, in samples. */
+    size_t scratchBufferSamples;
     /** @} */
 
+    /** @name Variables shared with PortAudio's callback when callback driven.
+     * These are only accessed atomically, since the callback must not block
+     * on @c mutex. */
+    /** @{ */
+
+    /** Ring of @c RING_BUFFER_SAMPLES samples consumed by PortAudio's callback,
+     * or @c NULL if the speaker writes to PortAudio directly. */
+    int16_t* ringBuffer;
+
+    /** Free-running count of samples written to @c ringBuffer. */
+    uint32_t ringBufferWriteIndex;
+
+    /** Free-running count of samples read from @c ringBuffer. */
+    uint32_t ringBufferReadIndex;
+
+    /** Whether @c ringBuffer rejected data and @c speakerReady is owed. */
+    AiaAtomicBool_t ringBufferOverflowed;
+
+    /** Number of samples of space to wait for when @c ringBuffer rejected
+     * data. */
+    uint32_t numSamplesOfSpaceToWaitFor;
+
+    /** Incremented before and after PortAudio's callback updates the playout
+     * anchor below, so readers can retry if they see an odd or changed
+     * value. */
+    uint32_t referenceAnchorSequence;
+
+    /** Low 32 bits of the index of the first frame of the reference signal
+     * written by the latest callback. */
+    uint32_t referenceAnchorIndex;
+
+    /** Time, relative to @c referenceEpochMs, at which that frame is played. */
+    uint32_t referenceAnchorMs;
+    /** @} */
+
+    /** Echo reference signal written by PortAudio's callback, or @c NULL if
+     * the speaker writes to PortAudio directly. */
+    AiaDataStreamBuffer_t* referenceBuffer;
+
+    /** Memory backing @c referenceBuffer. */
+    void* referenceBufferMemory;
+
+    /** Writer used by PortAudio's callback to write @c referenceBuffer. This
+     * is nonblockable so that it never waits on a reader. */
+    AiaDataStreamWriter_t* referenceWriter;
+
+    /** Time from which @c referenceAnchorMs is measured. */
+    AiaTimepointMs_t referenceEpochMs;
+
     /** Timer which polls for space in the buffer. This is crucial when the
      * buffer overflows and a callback to the SDK is required for data to flow
      * again. */
     AiaTimer_t pollForBufferSpaceTimer;
 };
 
-AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
-    AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData )
+/**
+ * Creates @c speaker->referenceBuffer and its writer.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @return @c true if successful or @c false otherwise.
+ */
+static bool AiaPortAudioSpeaker_CreateReferenceBuffer(
+    AiaPortAudioSpeaker_t* speaker )
+{
+    size_t wordSize = NUM_OUTPUT_CHANNELS * sizeof( int16_t );
+    speaker->referenceBufferMemory =
+        AiaCalloc( REFERENCE_BUFFER_FRAMES, wordSize );
+    if( !speaker->referenceBufferMemory )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     REFERENCE_BUFFER_FRAMES * wordSize );
+        return false;
+    }
+    speaker->referenceBuffer = AiaDataStreamBuffer_Create(
+        speaker->referenceBufferMemory, REFERENCE_BUFFER_FRAMES * wordSize,
+        wordSize, MAX_REFERENCE_READERS );
+    if( !speaker->referenceBuffer )
+    {
+        AiaLogError( "AiaDataStreamBuffer_Create failed" );
+        AiaFree( speaker->referenceBufferMemory );
+        return false;
+    }
+    speaker->referenceWriter = AiaDataStreamBuffer_CreateWriter(
+        speaker->referenceBuffer, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE,
+        false );
+    if( !speaker->referenceWriter )
+    {
+        AiaLogError( "AiaDataStreamBuffer_CreateWriter failed" );
+        AiaDataStreamBuffer_Destroy( speaker->referenceBuffer );
+        AiaFree( speaker->referenceBufferMemory );
+        return false;
+    }
+    speaker->referenceEpochMs = AiaClock( GetTimeMs )();
+    return true;
+}
+
+/**
+ * Destroys @c speaker->referenceBuffer and its writer, if they were created.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ */
+static void AiaPortAudioSpeaker_DestroyReferenceBuffer(
+    AiaPortAudioSpeaker_t* speaker )
+{
+    if( !speaker->referenceBuffer )
+    {
+        return;
+    }
+    AiaDataStreamWriter_Destroy( speaker->referenceWriter );
+    AiaDataStreamBuffer_Destroy( speaker->referenceBuffer );
+    AiaFree( speaker->referenceBufferMemory );
+}
+
+/**
+ * Creates an @c AiaPortAudioSpeaker_t.
+ *
+ * @param speakerReady Callback that will be invoked when the @c
+ * AiaPortAudioSpeaker_t is ready for new frames to be fed again.
+ * @param speakerReadyUserData User data associated with @c speakerReady.
+ * @param callbackDriven Whether to feed PortAudio from its stream callback
+ * rather than with blocking writes.
+ * @return A newly created @c AiaPortAudioSpeaker_t if successful or
+ * @c NULL otherwise.
+ */
+static AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_CreateInternal(
+    AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData,
+    bool callbackDriven )
 {
     PaError err;
     err = Pa_Initialize();
@@ -106,22 +325,81 @@ AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
         return NULL;
     }
 
+    /* Initialized up front since PortAudio's callback may run as soon as the
+     * stream starts. */
+    *(AiaOnSpeakerReadyForDataAgainCb*)&( speaker->speakerReady ) =
+        speakerReady;
+    *(void**)&speaker->speakerReadyUserData = speakerReadyUserData;
+    speaker->volume = AIA_DEFAULT_VOLUME;
+    speaker->gainQ15 = AiaPortAudioSpeaker_GetGainQ15( speaker->volume );
+    speaker->rampLengthSamples =
+        (size_t)( SAMPLE_RATE * VOLUME_RAMP_DURATION_MS / 1000 ) *
+        NUM_OUTPUT_CHANNELS;
+
+    /* Sized for one push of speaker data; longer pushes are scaled in
+     * chunks. */
+    speaker->scratchBufferSamples =
+        (size_t)( SAMPLE_RATE * AIA_SPEAKER_FRAME_PUSH_CADENCE_MS / 1000 ) *
+        NUM_OUTPUT_CHANNELS;
+    speaker->scratchBuffer =
+        AiaCalloc( speaker->scratchBufferSamples, sizeof( int16_t ) );
+    if( !speaker->scratchBuffer )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu",
+                     speaker->scratchBufferSamples * sizeof( int16_t ) );
+        AiaFree( speaker );
+        Pa_Terminate();
+        return NULL;
+    }
+
+    if( callbackDriven )
+    {
+        speaker->ringBuffer =
+            AiaCalloc( RING_BUFFER_SAMPLES, sizeof( int16_t ) );
+        if( !speaker->ringBuffer )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu",
+                         RING_BUFFER_SAMPLES * sizeof( int16_t ) );
+            AiaFree( speaker->scratchBuffer );
+            AiaFree( speaker );
+            Pa_Terminate();
+            return NULL;
+        }
+        if( !AiaPortAudioSpeaker_CreateReferenceBuffer( speaker ) )
+        {
+            AiaLogError( "AiaPortAudioSpeaker_CreateReferenceBuffer failed" );
+            AiaFree( speaker->ringBuffer );
+            AiaFree( speaker->scratchBuffer );
+            AiaFree( speaker );
+            Pa_Terminate();
+            return NULL;
+        }
+    }
+
     if( !AiaMutex( Create )( &speaker->mutex, false ) )
     {
         AiaLogError( "AiaMutex( Create ) failed." );
+        AiaPortAudioSpeaker_DestroyReferenceBuffer( speaker );
+        AiaFree( speaker->ringBuffer );
+        AiaFree( speaker->scratchBuffer );
         AiaFree( speaker );
         Pa_Terminate();
         return NULL;
     }
 
-    err = Pa_OpenDefaultStream( &speaker->paStream, NUM_INPUT_CHANNELS,
-                                NUM_OUTPUT_CHANNELS, paInt16, SAMPLE_RATE,
-                                paFramesPerBufferUnspecified, NULL, NULL );
+    err = Pa_OpenDefaultStream(
+        &speaker->paStream, NUM_INPUT_CHANNELS, NUM_OUTPUT_CHANNELS, paInt16,
+        SAMPLE_RATE, paFramesPerBufferUnspecified,
+        callbackDriven ? AiaPortAudioSpeaker_PlaybackCallback : NULL,
+        callbackDriven ? speaker : NULL );
     if( err != paNoError )
     {
         AiaLogError( "Failed to open PortAudio default stream, errorCode=%d",
                      err );
         AiaMutex( Destroy )( &speaker->mutex );
+        AiaPortAudioSpeaker_DestroyReferenceBuffer( speaker );
+        AiaFree( speaker->ringBuffer );
+        AiaFree( speaker->scratchBuffer );
         AiaFree( speaker );
         Pa_Terminate();
         return NULL;
@@ -133,11 +411,20 @@ AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
         AiaLogError( "Pa_StartStream failed, errorCode=%d", err );
         Pa_CloseStream( speaker->paStream );
         AiaMutex( Destroy )( &speaker->mutex );
+        AiaPortAudioSpeaker_DestroyReferenceBuffer( speaker );
+        AiaFree( speaker->ringBuffer );
+        AiaFree( speaker->scratchBuffer );
         AiaFree( speaker );
         Pa_Terminate();
         return NULL;
     }
 
+    /* PortAudio's callback signals readiness, so there is nothing to poll. */
+    if( callbackDriven )
+    {
+        return speaker;
+    }
+
     if( !AiaTimer( Create )( &speaker->pollForBufferSpaceTimer,
                              AiaPortAudioSpeaker_PollForBufferSpaceTask,
                              speaker ) )
@@ -145,6 +432,7 @@ AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
         AiaLogError( "Failed to create pollForBufferSpaceTimer" );
         Pa_CloseStream( speaker->paStream );
         AiaMutex( Destroy )( &speaker->mutex );
+        AiaFree( speaker->scratchBuffer );
         AiaFree( speaker );
         Pa_Terminate();
         return NULL;
@@ -157,19 +445,29 @@ AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
         AiaTimer( Destroy )( &speaker->pollForBufferSpaceTimer );
         Pa_CloseStream( speaker->paStream );
         AiaMutex( Destroy )( &speaker->mutex );
+        AiaFree( speaker->scratchBuffer );
         AiaFree( speaker );
         Pa_Terminate();
         return NULL;
     }
 
-    *(AiaOnSpeakerReadyForDataAgainCb*)&( speaker->speakerReady ) =
-        speakerReady;
-    *(void**)&speaker->speakerReadyUserData = speakerReadyUserData;
-    speaker->volume = AIA_DEFAULT_VOLUME;
-
     return speaker;
 }
 
+AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_Create(
+    AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData )
+{
+    return AiaPortAudioSpeaker_CreateInternal( speakerReady,
+                                               speakerReadyUserData, false );
+}
+
+AiaPortAudioSpeaker_t* AiaPortAudioSpeaker_CreateCallbackDriven(
+    AiaOnSpeakerReadyForDataAgainCb speakerReady, void* speakerReadyUserData )
+{
+    return AiaPortAudioSpeaker_CreateInternal( speakerReady,
+                                               speakerReadyUserData, true );
+}
+
 void AiaPortAudioSpeaker_Destroy( AiaPortAudioSpeaker_t* speaker )
 {
     AiaAssert( speaker );
@@ -178,17 +476,140 @@ void AiaPortAudioSpeaker_Destroy( AiaPortAudioSpeaker_t* speaker )
         AiaLogError( "Null speaker" );
         return;
     }
-    AiaTimer( Destroy )( &speaker->pollForBufferSpaceTimer );
+    if( !speaker->ringBuffer )
+    {
+        AiaTimer( Destroy )( &speaker->pollForBufferSpaceTimer );
+    }
 
     AiaMutex( Lock )( &speaker->mutex );
     Pa_CloseStream( speaker->paStream );
     AiaMutex( Unlock )( &speaker->mutex );
 
     AiaMutex( Destroy )( &speaker->mutex );
+    AiaPortAudioSpeaker_DestroyReferenceBuffer( speaker );
+    AiaFree( speaker->ringBuffer );
+    AiaFree( speaker->scratchBuffer );
     AiaFree( speaker );
     Pa_Terminate();
 }
 
+/**
+ * Applies @c speaker's volume to samples, continuing any ramp in progress.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @param buf Samples to apply the volume to.
+ * @param numSamples Number of samples in @c buf, which must not exceed the
+ * capacity of @c speaker->scratchBuffer.
+ * @return Either @c buf if it can be played unmodified, or @c
+ * speaker->scratchBuffer holding the volume adjusted samples.
+ * @note This method must be called while @c speaker->mutex is locked.
+ */
+static const int16_t* AiaPortAudioSpeaker_ApplyVolumeLocked(
+    AiaPortAudioSpeaker_t* speaker, const int16_t* buf, size_t numSamples )
+{
+    /* Note: This reference implementation is scaled to a linear volume
+     * curve. In real implementations, the volume curve may need to be
+     * adjusted for different platforms to ensure an adequately low volume
+     * at the low end and consistent user-perceived volume increments across
+     * the range. Ideally, this would be mapped to a system/device volume
+     * API rather than modifying in software, but PortAudio lacks an API for
+     * this. */
+    const int32_t targetGainQ15 =
+        AiaPortAudioSpeaker_GetGainQ15( speaker->volume );
+    int16_t* out = speaker->scratchBuffer;
+    size_t i = 0;
+    if( speaker->gainQ15 != targetGainQ15 )
+    {
+        const int32_t rampDeltaQ15 = targetGainQ15 - speaker->rampStartGainQ15;
+        for( ; i < numSamples &&
+               speaker->rampPosition < speaker->rampLengthSamples;
+             ++i )
+        {
+            ++speaker->rampPosition;
+            speaker->gainQ15 =
+                speaker->rampStartGainQ15 +
+                rampDeltaQ15 * (int32_t)speaker->rampPosition /
+                    (int32_t)speaker->rampLengthSamples;
+            out[ i ] = (int16_t)( ( (int32_t)buf[ i ] * speaker->gainQ15 ) >>
+                                  15 );
+        }
+    }
+    else if( targetGainQ15 == UNITY_GAIN_Q15 )
+    {
+        return buf;
+    }
+
+    if( targetGainQ15 == UNITY_GAIN_Q15 )
+    {
+        memcpy( out + i, buf + i, ( numSamples - i ) * sizeof( int16_t ) );
+    }
+    else
+    {
+        AiaPortAudioSpeaker_ApplyGain( buf + i, out + i, numSamples - i,
+                                       (int16_t)targetGainQ15 );
+    }
+    return out;
+}
+
+/**
+ * Applies @c speaker's volume to samples and queues them in @c
+ * speaker->ringBuffer for PortAudio's callback to consume.
+ *
+ * @param speaker The @c AiaPortAudioSpeaker_t to act on.
+ * @param buf Samples to queue.
+ * @param numSamples Number of samples in @c buf.
+ * @return @c true if all samples were queued or @c false if there was not
+ * enough space, in which case @c speakerReady will be invoked once there is.
+ * @note This method must be called while @c speaker->mutex is locked.
+ */
+static bool AiaPortAudioSpeaker_WriteToRingBufferLocked(
+    AiaPortAudioSpeaker_t* speaker, const int16_t* buf, size_t numSamples )
+{
+    if( numSamples > RING_BUFFER_SAMPLES )
+    {
+        AiaLogError( "Too many samples to buffer, given=%zu, capacity=%u",
+                     numSamples, (unsigned)RING_BUFFER_SAMPLES );
+        return false;
+    }
+
+    /* Only this producer advances the write index. */
+    uint32_t writeIndex = speaker->ringBufferWriteIndex;
+    uint32_t numSamplesBuffered =
+        writeIndex - AiaAtomic_Load_u32( &speaker->ringBufferReadIndex );
+    if( RING_BUFFER_SAMPLES - numSamplesBuffered < numSamples )
+    {
+        AiaLogDebug(
+            "Not enough space to consume all frames, available=%u, given=%zu",
+            (unsigned)( RING_BUFFER_SAMPLES - numSamplesBuffered ),
+            numSamples );
+        /* Published before the flag, which is what the callback checks. */
+        AiaAtomic_Store_u32( &speaker->numSamplesOfSpaceToWaitFor,
+                             (uint32_t)numSamples );
+        AiaAtomicBool_Set( &speaker->ringBufferOverflowed );
+        return false;
+    }
+
+    size_t numSamplesWritten = 0;
+    while( numSamplesWritten < numSamples )
+    {
+        size_t numSamplesToWrite = AiaMin( numSamples - numSamplesWritten,
+                                           speaker->scratchBufferSamples );
+        const int16_t* samples = AiaPortAudioSpeaker_ApplyVolumeLocked(
+            speaker, buf + numSamplesWritten, numSamplesToWrite );
+        size_t ringOffset = writeIndex & ( RING_BUFFER_SAMPLES - 1 );
+        size_t firstSpan =
+            AiaMin( numSamplesToWrite, RING_BUFFER_SAMPLES - ringOffset );
+        memcpy( speaker->ringBuffer + ringOffset, samples,
+                firstSpan * sizeof( int16_t ) );
+        memcpy( speaker->ringBuffer, samples + firstSpan,
+                ( numSamplesToWrite - firstSpan ) * sizeof( int16_t ) );
+        writeIndex += numSamplesToWrite;
+        numSamplesWritten += numSamplesToWrite;
+    }
+    AiaAtomic_Store_u32( &speaker->ringBufferWriteIndex, writeIndex );
+    return true;
+}
+
 bool AiaPortAudioSpeaker_PlaySpeakerData( AiaPortAudioSpeaker_t* speaker,
                                           const int16_t* buf,
                                           size_t numSamples )
@@ -202,13 +623,12 @@ bool AiaPortAudioSpeaker_PlaySpeakerData( AiaPortAudioSpeaker_t* speaker,
 
     AiaMutex( Lock )( &speaker->mutex );
 
-    /* Volume adjusted input buffer. */
-    int16_t* volumeAdjustedBuffer = AiaCalloc( numSamples, sizeof( int16_t ) );
-    if( !volumeAdjustedBuffer )
+    if( speaker->ringBuffer )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu",
-                     sizeof( int16_t ) * numSamples );
-        return false;
+        bool written = AiaPortAudioSpeaker_WriteToRingBufferLocked(
+            speaker, buf, numSamples );
+        AiaMutex( Unlock )( &speaker->mutex );
+        return written;
     }
 
     /* Get number of frames that can be written without blocking. */
@@ -218,7 +638,6 @@ bool AiaPortAudioSpeaker_PlaySpeakerData( AiaPortAudioSpeaker_t* speaker,
     {
         AiaLogError( "Pa_GetStreamWriteAvailable failed, error=%ld",
                      numFramesAvailableToWrite );
-        AiaFree( volumeAdjustedBuffer );
         AiaMutex( Unlock )( &speaker->mutex );
         return false;
     }
@@ -231,49 +650,34 @@ bool AiaPortAudioSpeaker_PlaySpeakerData( AiaPortAudioSpeaker_t* speaker,
             numFramesAvailableToWrite, numSamples );
         speaker->speakerOverflowed = true;
         speaker->numSamplesOfSpaceToPollFor = numSamples;
-        AiaFree( volumeAdjustedBuffer );
         AiaMutex( Unlock )( &speaker->mutex );
         return false;
     }
 
-    PaError err;
-    if( speaker->volume == AIA_MAX_VOLUME )
+    size_t numSamplesWritten = 0;
+    while( numSamplesWritten < numSamples )
     {
-        err = Pa_WriteStream( speaker->paStream, buf, numSamples );
-    }
-    else
-    {
-        /* Note: This reference implementation is scaled to a linear volume
-         * curve. In real implementations, the volume curve may need to be
-         * adjusted for different platforms to ensure an adequately low volume
-         * at the low end and consistent user-perceived volume increments across
-         * the range. Ideally, this would be mapped to a system/device volume
-         * API rather than modifying
-         * in software, but PortAudio lacks an API for this. */
-        for( size_t i = 0; i < numSamples; ++i )
+        size_t numSamplesToWrite = AiaMin( numSamples - numSamplesWritten,
+                                           speaker->scratchBufferSamples );
+        const int16_t* samples = AiaPortAudioSpeaker_ApplyVolumeLocked(
+            speaker, buf + numSamplesWritten, numSamplesToWrite );
+        PaError err =
+            Pa_WriteStream( speaker->paStream, samples, numSamplesToWrite );
+        if( err != paNoError )
         {
-            volumeAdjustedBuffer[ i ] =
-                buf[ i ] * speaker->volume / AIA_MAX_VOLUME;
-        }
-
-        err = Pa_WriteStream( speaker->paStream, volumeAdjustedBuffer,
-                              numSamples );
-    }
-    if( err != paNoError )
-    {
-        AiaLogDebug( "Pa_WriteStream failed, errorCode=%s",
-                     Pa_GetErrorText( err ) );
-        if( err != paOutputUnderflowed )
-        {
-            AiaLogError( "Pa_WriteStream failed, errorCode=%s",
+            AiaLogDebug( "Pa_WriteStream failed, errorCode=%s",
                          Pa_GetErrorText( err ) );
-            AiaFree( volumeAdjustedBuffer );
-            AiaMutex( Unlock )( &speaker->mutex );
-            return false;
+            if( err != paOutputUnderflowed )
+            {
+                AiaLogError( "Pa_WriteStream failed, errorCode=%s",
+                             Pa_GetErrorText( err ) );
+                AiaMutex( Unlock )( &speaker->mutex );
+                return false;
+            }
         }
+        numSamplesWritten += numSamplesToWrite;
     }
 
-    AiaFree( volumeAdjustedBuffer );
     AiaMutex( Unlock )( &speaker->mutex );
     return true;
 }
@@ -289,9 +693,113 @@ void AiaPortAudioSpeaker_SetNewVolume( AiaPortAudioSpeaker_t* speaker,
 
     AiaMutex( Lock )( &speaker->mutex );
     speaker->volume = volume;
+    if( speaker->rampLengthSamples )
+    {
+        speaker->rampStartGainQ15 = speaker->gainQ15;
+        speaker->rampPosition = 0;
+    }
+    else
+    {
+        speaker->gainQ15 = AiaPortAudioSpeaker_GetGainQ15( volume );
+    }
     AiaMutex( Unlock )( &speaker->mutex );
 }
 
+void AiaPortAudioSpeaker_SetVolumeRampEnabled( AiaPortAudioSpeaker_t* speaker,
+                                               bool enabled )
+{
+    if( !speaker )
+    {
+        AiaLogError( "Null speaker" );
+        return;
+    }
+
+    AiaMutex( Lock )( &speaker->mutex );
+    speaker->rampLengthSamples =
+        enabled ? (size_t)( SAMPLE_RATE * VOLUME_RAMP_DURATION_MS / 1000 ) *
+                      NUM_OUTPUT_CHANNELS
+                : 0;
+    speaker->gainQ15 = AiaPortAudioSpeaker_GetGainQ15( speaker->volume );
+    AiaMutex( Unlock )( &speaker->mutex );
+}
+
+AiaDurationMs_t AiaPortAudioSpeaker_GetPlayoutLatencyMs(
+    AiaPortAudioSpeaker_t* speaker )
+{
+    if( !speaker )
+    {
+        AiaLogError( "Null speaker" );
+        return 0;
+    }
+
+    const PaStreamInfo* info = Pa_GetStreamInfo( speaker->paStream );
+    double latencySeconds = info ? info->outputLatency : 0;
+    if( speaker->ringBuffer )
+    {
+        uint32_t bufferedSamples =
+            AiaAtomic_Load_u32( &speaker->ringBufferWriteIndex ) -
+            AiaAtomic_Load_u32( &speaker->ringBufferReadIndex );
+        latencySeconds +=
+            (double)bufferedSamples / NUM_OUTPUT_CHANNELS / SAMPLE_RATE;
+    }
+    return (AiaDurationMs_t)( latencySeconds * 1000 );
+}
+
+AiaDataStreamReader_t* AiaPortAudioSpeaker_CreateReferenceReader(
+    AiaPortAudioSpeaker_t* speaker, AiaDataStreamReaderPolicy_t policy )
+{
+    if( !speaker )
+    {
+        AiaLogError( "Null speaker" );
+        return NULL;
+    }
+    if( !speaker->referenceBuffer )
+    {
+        AiaLogError( "Reference signal requires a callback driven speaker" );
+        return NULL;
+    }
+    return AiaDataStreamBuffer_CreateReader( speaker->referenceBuffer, policy,
+                                             true );
+}
+
+bool AiaPortAudioSpeaker_GetReferencePlayoutTime(
+    AiaPortAudioSpeaker_t* speaker, AiaDataStreamIndex_t index,
+    AiaTimepointMs_t* playoutMs )
+{
+    if( !speaker || !playoutMs )
+    {
+        AiaLogError( "Null speaker or playoutMs" );
+        return false;
+    }
+    if( !speaker->referenceBuffer )
+    {
+        AiaLogError( "Reference signal requires a callback driven speaker" );
+        return false;
+    }
+
+    uint32_t sequence;
+    uint32_t anchorIndex;
+    uint32_t anchorMs;
+    do
+    {
+        sequence = AiaAtomic_Load_u32( &speaker->referenceAnchorSequence );
+        anchorIndex = AiaAtomic_Load_u32( &speaker->referenceAnchorIndex );
+        anchorMs = AiaAtomic_Load_u32( &speaker->referenceAnchorMs );
+    } while( sequence % 2 ||
+             sequence !=
+                 AiaAtomic_Load_u32( &speaker->referenceAnchorSequence ) );
+    if( !sequence )
+    {
+        return false;
+    }
+
+    /* Frames are played back to back at SAMPLE_RATE from the anchor. */
+    int64_t framesFromAnchor = (int32_t)( (uint32_t)index - anchorIndex );
+    *playoutMs = speaker->referenceEpochMs + anchorMs +
+                 (int64_t)( framesFromAnchor * 1000 / SAMPLE_RATE );
+    return true;
+}
+
 void AiaPortAudioSpeaker_PollForBufferSpaceTask( void* userData )
 {
     AiaPortAudioSpeaker_t* speaker = (AiaPortAudioSpeaker_t*)userData;
@@ -322,3 +830,106 @@ void AiaPortAudioSpeaker_PollForBufferSpaceTask( void* userData )
     speaker->speakerReady( speaker->speakerReadyUserData );
     AiaMutex( Unlock )( &speaker->mutex );
 }
+
+static int AiaPortAudioSpeaker_PlaybackCallback(
+    const void* input, void* output, unsigned long frameCount,
+    const PaStreamCallbackTimeInfo* timeInfo,
+    PaStreamCallbackFlags statusFlags, void* userData )
+{
+    (void)input;
+    (void)statusFlags;
+    AiaPortAudioSpeaker_t* speaker = (AiaPortAudioSpeaker_t*)userData;
+    int16_t* out = (int16_t*)output;
+    size_t numSamples = frameCount * NUM_OUTPUT_CHANNELS;
+
+    /* Only this consumer advances the read index. */
+    uint32_t readIndex = speaker->ringBufferReadIndex;
+    uint32_t numSamplesBuffered =
+        AiaAtomic_Load_u32( &speaker->ringBufferWriteIndex ) - readIndex;
+    size_t numSamplesToRead = AiaMin( numSamples, numSamplesBuffered );
+    size_t ringOffset = readIndex & ( RING_BUFFER_SAMPLES - 1 );
+    size_t firstSpan =
+        AiaMin( numSamplesToRead, RING_BUFFER_SAMPLES - ringOffset );
+    memcpy( out, speaker->ringBuffer + ringOffset,
+            firstSpan * sizeof( int16_t ) );
+    memcpy( out + firstSpan, speaker->ringBuffer,
+            ( numSamplesToRead - firstSpan ) * sizeof( int16_t ) );
+    memset( out + numSamplesToRead, 0,
+            ( numSamples - numSamplesToRead ) * sizeof( int16_t ) );
+    AiaAtomic_Store_u32( &speaker->ringBufferReadIndex,
+                         readIndex + (uint32_t)numSamplesToRead );
+    numSamplesBuffered -= numSamplesToRead;
+
+    /* Anchor the frames about to be written to when PortAudio plays them. */
+    AiaDurationMs_t outputDelayMs = 0;
+    if( timeInfo && timeInfo->outputBufferDacTime > timeInfo->currentTime )
+    {
+        outputDelayMs = (AiaDurationMs_t)(
+            ( timeInfo->outputBufferDacTime - timeInfo->currentTime ) * 1000 );
+    }
+    AiaTimepointMs_t playoutMs = AiaClock( GetTimeMs )() + outputDelayMs;
+    uint32_t sequence = speaker->referenceAnchorSequence;
+    AiaAtomic_Store_u32( &speaker->referenceAnchorSequence, sequence + 1 );
+    AiaAtomic_Store_u32( &speaker->referenceAnchorIndex,
+                         (uint32_t)AiaDataStreamWriter_Tell(
+                             speaker->referenceWriter ) );
+    AiaAtomic_Store_u32(
+        &speaker->referenceAnchorMs,
+        (uint32_t)( playoutMs - speaker->referenceEpochMs ) );
+    AiaAtomic_Store_u32( &speaker->referenceAnchorSequence, sequence + 2 );
+    if( AiaDataStreamWriter_Write( speaker->referenceWriter, out,
+                                   frameCount ) < 0 )
+    {
+        AiaLogDebug( "AiaDataStreamWriter_Write failed" );
+    }
+
+    if( AiaAtomicBool_Load( &speaker->ringBufferOverflowed ) &&
+        numSamplesBuffered <= RING_BUFFER_LOW_WATER_MARK_SAMPLES &&
+        RING_BUFFER_SAMPLES - numSamplesBuffered >=
+            AiaAtomic_Load_u32( &speaker->numSamplesOfSpaceToWaitFor ) )
+    {
+        AiaAtomicBool_Clear( &speaker->ringBufferOverflowed );
+        speaker->speakerReady( speaker->speakerReadyUserData );
+    }
+
+    return paContinue;
+}
+
+static int32_t AiaPortAudioSpeaker_GetGainQ15( uint8_t volume )
+{
+    return (int32_t)volume * UNITY_GAIN_Q15 / AIA_MAX_VOLUME;
+}
+
+static void AiaPortAudioSpeaker_ApplyGain( const int16_t* in, int16_t* out,
+                                           size_t numSamples, int16_t gainQ15 )
+{
+    size_t i = 0;
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+    /* vqdmulhq_s16 computes ( 2 * a * b ) >> 16, which is ( a * b ) >> 15. */
+    const int16x8_t gain = vdupq_n_s16( gainQ15 );
+    for( ; i + 8 <= numSamples; i += 8 )
+    {
+        vst1q_s16( out + i, vqdmulhq_s16( vld1q_s16( in + i ), gain ) );
+    }
+#elif defined( __SSE2__ )
+    /* Recombine the low and high halves of the 32-bit products before
+     * shifting, since SSE2 lacks a rounding-free Q15 multiply. */
+    const __m128i gain = _mm_set1_epi16( gainQ15 );
+    for( ; i + 8 <= numSamples; i += 8 )
+    {
+        const __m128i samples = _mm_loadu_si128( (const __m128i*)( in + i ) );
+        const __m128i lo = _mm_mullo_epi16( samples, gain );
+        const __m128i hi = _mm_mulhi_epi16( samples, gain );
+        const __m128i scaledLo =
+            _mm_srai_epi32( _mm_unpacklo_epi16( lo, hi ), 15 );
+        const __m128i scaledHi =
+            _mm_srai_epi32( _mm_unpackhi_epi16( lo, hi ), 15 );
+        _mm_storeu_si128( (__m128i*)( out + i ),
+                          _mm_packs_epi32( scaledLo, scaledHi ) );
+    }
+#endif
+    for( ; i < numSamples; ++i )
+    {
+        out[ i ] = (int16_t)( ( (int32_t)in[ i ] * gainQ15 ) >> 15 );
+    }
+}
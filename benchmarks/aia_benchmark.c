@@ -0,0 +1,262 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_benchmark.c
+ * @brief Implements functions in aia_benchmark.h
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/aia_encryption_algorithm.h>
+#include <aiacore/aia_json_message.h>
+#include <aiacore/aia_secret_derivation_algorithm.h>
+#include <aiacore/aia_topic.h>
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/* Global config, read by the storage and registration ports. */
+extern const char* g_aiaClientId;
+extern const char* g_aiaAwsAccountId;
+extern const char* g_aiaStorageFolder;
+
+/** The topic root stored by @c AiaBenchmark_ProvisionDevice(). */
+static const char* AIA_BENCHMARK_TOPIC_ROOT =
+    "ais/v1/123456789012/benchmarkClientId";
+
+#ifdef AIA_BENCHMARK_COUNT_ALLOCATIONS
+
+/** The number of calls to @c calloc() made so far. */
+static uint64_t g_allocations;
+
+/** The number of bytes requested from @c calloc() so far. */
+static uint64_t g_allocatedBytes;
+
+/* @c AiaCalloc() is an inline wrapper around @c calloc(), so the linker is
+ * asked to route every @c calloc() call in the SDK libraries through here. */
+void* __real_calloc( size_t count, size_t size );
+
+void* __wrap_calloc( size_t count, size_t size )
+{
+    __atomic_fetch_add( &g_allocations, 1, __ATOMIC_RELAXED );
+    __atomic_fetch_add( &g_allocatedBytes, (uint64_t)count * size,
+                        __ATOMIC_RELAXED );
+    return __real_calloc( count, size );
+}
+
+#endif
+
+/**
+ * Reads the allocation counters.
+ *
+ * @param[out] allocations The number of allocations made so far.
+ * @param[out] allocatedBytes The number of bytes allocated so far.
+ */
+static void AiaBenchmark_ReadAllocations( uint64_t* allocations,
+                                          uint64_t* allocatedBytes )
+{
+#ifdef AIA_BENCHMARK_COUNT_ALLOCATIONS
+    *allocations = __atomic_load_n( &g_allocations, __ATOMIC_RELAXED );
+    *allocatedBytes = __atomic_load_n( &g_allocatedBytes, __ATOMIC_RELAXED );
+#else
+    *allocations = 0;
+    *allocatedBytes = 0;
+#endif
+}
+
+uint64_t AiaBenchmark_GetTimeNs()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+uint64_t AiaBenchmark_GetHeapInUse()
+{
+#if defined( __GLIBC__ ) && \
+    ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif defined( __GLIBC__ )
+    struct mallinfo info = mallinfo();
+    return (uint32_t)info.uordblks + (uint32_t)info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+void AiaBenchmark_StartTimer( AiaBenchmark_t* benchmark )
+{
+    AiaBenchmark_ReadAllocations( &benchmark->startAllocations,
+                                  &benchmark->startAllocatedBytes );
+    benchmark->startNs = AiaBenchmark_GetTimeNs();
+}
+
+void AiaBenchmark_StopTimer( AiaBenchmark_t* benchmark )
+{
+    uint64_t now = AiaBenchmark_GetTimeNs();
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    AiaBenchmark_ReadAllocations( &allocations, &allocatedBytes );
+
+    benchmark->elapsedNs += now - benchmark->startNs;
+    benchmark->allocations += allocations - benchmark->startAllocations;
+    benchmark->allocatedBytes +=
+        allocatedBytes - benchmark->startAllocatedBytes;
+}
+
+uint32_t AiaBenchmark_NextRandom( uint32_t* state )
+{
+    /* xorshift32; quality is irrelevant, only reproducibility matters. */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+bool AiaBenchmark_Run( const AiaBenchmarkOptions_t* options, const char* name,
+                       AiaBenchmarkRoutine_t routine, void* userData )
+{
+    if( options->filter && !strstr( name, options->filter ) )
+    {
+        return true;
+    }
+
+    AiaBenchmark_t warmup;
+    memset( &warmup, 0, sizeof( warmup ) );
+    warmup.iterations = options->iterations / 10 + 1;
+    warmup.options = options;
+    if( !routine( &warmup, userData ) )
+    {
+        printf( "%-40s FAILED\n", name );
+        return false;
+    }
+
+    AiaBenchmark_t benchmark;
+    memset( &benchmark, 0, sizeof( benchmark ) );
+    benchmark.iterations = options->iterations;
+    benchmark.options = options;
+    if( !routine( &benchmark, userData ) )
+    {
+        printf( "%-40s FAILED\n", name );
+        return false;
+    }
+
+    double iterations = (double)benchmark.iterations;
+#ifdef AIA_BENCHMARK_COUNT_ALLOCATIONS
+    printf( "%-40s %10zu %12.1f ns/op %8.2f allocs/op %10.1f B/op\n", name,
+            benchmark.iterations, benchmark.elapsedNs / iterations,
+            benchmark.allocations / iterations,
+            benchmark.allocatedBytes / iterations );
+#else
+    printf( "%-40s %10zu %12.1f ns/op\n", name, benchmark.iterations,
+            benchmark.elapsedNs / iterations );
+#endif
+    return true;
+}
+
+bool AiaBenchmark_ProvisionDevice( char* storageFolder )
+{
+    if( !mkdtemp( storageFolder ) )
+    {
+        AiaLogError( "mkdtemp failed" );
+        return false;
+    }
+    g_aiaStorageFolder = storageFolder;
+    g_aiaClientId = "benchmarkClientId";
+    g_aiaAwsAccountId = "123456789012";
+
+    size_t secretSize =
+        AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) ) );
+    uint8_t secret[ secretSize ];
+    for( size_t i = 0; i < secretSize; ++i )
+    {
+        secret[ i ] = i;
+    }
+    if( !AiaStoreSecret( secret, secretSize ) ||
+        !AiaStoreTopicRoot( (const uint8_t*)AIA_BENCHMARK_TOPIC_ROOT,
+                            strlen( AIA_BENCHMARK_TOPIC_ROOT ) ) )
+    {
+        AiaLogError( "Failed to store the device's secret and topic root" );
+        AiaBenchmark_RemoveDevice( storageFolder );
+        return false;
+    }
+    return true;
+}
+
+void AiaBenchmark_RemoveDevice( const char* storageFolder )
+{
+    DIR* dir = opendir( storageFolder );
+    if( dir )
+    {
+        struct dirent* entry;
+        while( ( entry = readdir( dir ) ) )
+        {
+            if( !strcmp( entry->d_name, "." ) ||
+                !strcmp( entry->d_name, ".." ) )
+            {
+                continue;
+            }
+            size_t pathSize =
+                strlen( storageFolder ) + strlen( entry->d_name ) + 2;
+            char path[ pathSize ];
+            snprintf( path, pathSize, "%s/%s", storageFolder, entry->d_name );
+            unlink( path );
+        }
+        closedir( dir );
+    }
+    rmdir( storageFolder );
+}
+
+/** @c AiaGetNextSequenceNumber_t; sequence numbers never trigger a key
+ * rotation in these benchmarks. */
+static bool AiaBenchmark_GetNextSequenceNumber(
+    AiaTopic_t topic, AiaSequenceNumber_t* nextSequenceNumber, void* userData )
+{
+    (void)topic;
+    (void)userData;
+    *nextSequenceNumber = 0;
+    return true;
+}
+
+/** @c AiaEmitEvent_t dropping events raised by the secret manager. */
+static bool AiaBenchmark_EmitEvent( AiaRegulatorChunk_t* chunk,
+                                    void* userData )
+{
+    (void)userData;
+    AiaJsonMessage_Destroy( AiaJsonMessage_FromMessage( chunk ) );
+    return true;
+}
+
+AiaSecretManager_t* AiaBenchmark_CreateSecretManager()
+{
+    return AiaSecretManager_Create( AiaBenchmark_GetNextSequenceNumber, NULL,
+                                    AiaBenchmark_EmitEvent, NULL );
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_benchmark.h
+ * @brief Harness for timing SDK hot loops and counting their allocations.
+ */
+
+#ifndef AIA_BENCHMARK_H_
+#define AIA_BENCHMARK_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiasecretmanager/aia_secret_manager.h>
+
+#include <stdint.h>
+
+/** Template for the folder created by @c AiaBenchmark_ProvisionDevice(). */
+#define AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE "/tmp/aia_benchmarks_XXXXXX"
+
+/** Options shared by all benchmarks, parsed from the command line. */
+typedef struct AiaBenchmarkOptions
+{
+    /** The number of operations to measure in each benchmark. */
+    size_t iterations;
+
+    /** Only benchmarks whose name contains this string are run, if non-@c
+     * NULL. */
+    const char* filter;
+
+    /** The percentage of sequencer messages delivered out of order. */
+    unsigned int reorderPercent;
+} AiaBenchmarkOptions_t;
+
+/** State of a single benchmark run. */
+typedef struct AiaBenchmark
+{
+    /** The number of operations the routine must perform. */
+    size_t iterations;
+
+    /** The options the benchmark was run with. */
+    const AiaBenchmarkOptions_t* options;
+
+    /** @name Private members, updated by the timer functions. */
+    /** @{ */
+    uint64_t startNs;
+    uint64_t elapsedNs;
+    uint64_t startAllocations;
+    uint64_t allocations;
+    uint64_t startAllocatedBytes;
+    uint64_t allocatedBytes;
+    /** @} */
+} AiaBenchmark_t;
+
+/**
+ * A benchmark routine. It must perform @c benchmark->iterations operations
+ * between a call to @c AiaBenchmark_StartTimer() and a call to @c
+ * AiaBenchmark_StopTimer(), keeping setup and teardown outside of the timed
+ * region.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData The user data passed to @c AiaBenchmark_Run().
+ * @return @c true if all operations succeeded, else @c false.
+ */
+typedef bool ( *AiaBenchmarkRoutine_t )( AiaBenchmark_t* benchmark,
+                                         void* userData );
+
+/**
+ * Runs @c routine once to warm up caches and once more to measure it, then
+ * prints its ns/op, allocations/op and bytes/op.
+ *
+ * @param options The options to run with.
+ * @param name The name to report the results under.
+ * @param routine The routine to run.
+ * @param userData User data to pass to @c routine.
+ * @return @c true if the benchmark was skipped by @c options->filter or
+ * succeeded, else @c false.
+ */
+bool AiaBenchmark_Run( const AiaBenchmarkOptions_t* options, const char* name,
+                       AiaBenchmarkRoutine_t routine, void* userData );
+
+/**
+ * Starts, or resumes, measuring time and allocations.
+ *
+ * @param benchmark The benchmark being run.
+ */
+void AiaBenchmark_StartTimer( AiaBenchmark_t* benchmark );
+
+/**
+ * Stops measuring time and allocations.
+ *
+ * @param benchmark The benchmark being run.
+ */
+void AiaBenchmark_StopTimer( AiaBenchmark_t* benchmark );
+
+/**
+ * Returns a deterministic pseudo-random number, so that benchmarks replay the
+ * same inputs on every run.
+ *
+ * @param[in,out] state The generator state, seeded by the caller.
+ * @return The next number in the sequence.
+ */
+uint32_t AiaBenchmark_NextRandom( uint32_t* state );
+
+/** @return A monotonic timestamp in nanoseconds. */
+uint64_t AiaBenchmark_GetTimeNs();
+
+/**
+ * @return The number of heap bytes the process has allocated and not freed,
+ * as reported by the C library, or 0 where this is not available.
+ */
+uint64_t AiaBenchmark_GetHeapInUse();
+
+/**
+ * Gives the process a device identity, a topic root and a shared secret, as
+ * registration would, kept in a new temporary storage folder.
+ *
+ * @param[in,out] storageFolder A copy of @c
+ * AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE, replaced with the name of the folder
+ * created.
+ * @return @c true on success, else @c false.
+ */
+bool AiaBenchmark_ProvisionDevice( char* storageFolder );
+
+/**
+ * Removes a storage folder created by @c AiaBenchmark_ProvisionDevice().
+ *
+ * @param storageFolder The folder to remove.
+ */
+void AiaBenchmark_RemoveDevice( const char* storageFolder );
+
+/**
+ * Creates a secret manager for the shared secret stored by @c
+ * AiaBenchmark_ProvisionDevice(). It never rotates keys, and drops any events
+ * it raises.
+ *
+ * @return The new secret manager, or @c NULL on failure.
+ */
+AiaSecretManager_t* AiaBenchmark_CreateSecretManager();
+
+/** @name Benchmark groups. */
+/** @{ */
+bool RunAiaDataStreamBenchmarks( const AiaBenchmarkOptions_t* options );
+bool RunAiaSequencerBenchmarks( const AiaBenchmarkOptions_t* options );
+bool RunAiaRegulatorBenchmarks( const AiaBenchmarkOptions_t* options );
+bool RunAiaEmitterBenchmarks( const AiaBenchmarkOptions_t* options );
+bool RunAiaJsonUtilsBenchmarks( const AiaBenchmarkOptions_t* options );
+/** @} */
+
+#endif /* ifndef AIA_BENCHMARK_H_ */
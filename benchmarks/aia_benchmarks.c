@@ -0,0 +1,148 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_benchmarks.c
+ * @brief Benchmark runner for the AiaCore data path.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/aia_crypto_mbedtls.h>
+#include <aiacore/aia_mbedtls_threading.h>
+#include <aiacore/aia_random_mbedtls.h>
+
+#include AiaTaskPool( HEADER )
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** The number of operations measured when @c -i is not given. */
+#define AIA_BENCHMARK_DEFAULT_ITERATIONS 10000
+
+/** The reorder percentage used when @c -r is not given. */
+#define AIA_BENCHMARK_DEFAULT_REORDER_PERCENT 10
+
+/**
+ * Parses command line arguments.
+ *
+ * @param argc Number of arguments passed to main().
+ * @param argv Arguments vector passed to main().
+ * @param[out] options The options to fill in.
+ * @return @c true if the arguments were valid, else @c false.
+ */
+static bool AiaBenchmarks_ParseArguments( int argc, char** argv,
+                                          AiaBenchmarkOptions_t* options )
+{
+    options->iterations = AIA_BENCHMARK_DEFAULT_ITERATIONS;
+    options->filter = NULL;
+    options->reorderPercent = AIA_BENCHMARK_DEFAULT_REORDER_PERCENT;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        const char* option = argv[ i ];
+        if( option[ 0 ] != '-' || option[ 1 ] == '\0' || option[ 2 ] != '\0' ||
+            i + 1 >= argc )
+        {
+            return false;
+        }
+        const char* value = argv[ ++i ];
+        char* end;
+        switch( option[ 1 ] )
+        {
+            /* Number of operations to measure per benchmark. */
+            case 'i':
+                options->iterations = strtoul( value, &end, 10 );
+                if( *end != '\0' || !options->iterations )
+                {
+                    return false;
+                }
+                break;
+
+            /* Only run benchmarks whose name contains the value. */
+            case 'f':
+                options->filter = value;
+                break;
+
+            /* Percentage of sequencer messages delivered out of order. */
+            case 'r':
+                options->reorderPercent = strtoul( value, &end, 10 );
+                if( *end != '\0' || options->reorderPercent > 100 )
+                {
+                    return false;
+                }
+                break;
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+int main( int argc, char** argv )
+{
+    AiaBenchmarkOptions_t options;
+    if( !AiaBenchmarks_ParseArguments( argc, argv, &options ) )
+    {
+        fprintf( stderr,
+                 "Usage: %s [-i <iterations>] [-f <name filter>] "
+                 "[-r <reorder percent>]\n",
+                 argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    AiaMbedtlsThreading_Init();
+    AiaRandomMbedtls_Init();
+    if( !AiaRandomMbedtls_Seed( NULL, 0 ) )
+    {
+        AiaLogError( "AiaRandomMbedtls_Seed failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    if( !AiaCryptoMbedtls_Init() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Init failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    AiaTaskPoolInfo_t taskPoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskPoolInfo );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateSystemTaskPool ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        AiaCryptoMbedtls_Cleanup();
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+
+    bool success = RunAiaDataStreamBenchmarks( &options );
+    success = RunAiaSequencerBenchmarks( &options ) && success;
+    success = RunAiaRegulatorBenchmarks( &options ) && success;
+    success = RunAiaEmitterBenchmarks( &options ) && success;
+    success = RunAiaJsonUtilsBenchmarks( &options ) && success;
+
+    AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    AiaCryptoMbedtls_Cleanup();
+    AiaRandomMbedtls_Cleanup();
+    AiaMbedtlsThreading_Cleanup();
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_data_stream_benchmarks.c
+ * @brief Benchmarks for AiaDataStreamWriter_Write() and
+ * AiaDataStreamReader_Read().
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
+
+#include <string.h>
+
+/** 16-bit samples, as written by the microphone. */
+#define AIA_DATA_STREAM_BENCHMARK_WORD_SIZE 2
+
+/** 10ms of 16kHz audio per write. */
+#define AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS 160
+
+/** One second of audio, so that writes regularly wrap around the buffer. */
+#define AIA_DATA_STREAM_BENCHMARK_BUFFER_WORDS 16000
+
+/** Parameters of a data stream benchmark. */
+typedef struct AiaDataStreamBenchmarkParams
+{
+    /** The number of readers consuming each frame. */
+    size_t numReaders;
+} AiaDataStreamBenchmarkParams_t;
+
+/**
+ * Writes one frame and reads it back with each reader per operation.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData The @c AiaDataStreamBenchmarkParams_t to run with.
+ * @return @c true if every frame was written and read in full, else @c false.
+ */
+static bool AiaDataStreamBenchmark_WriteRead( AiaBenchmark_t* benchmark,
+                                              void* userData )
+{
+    const AiaDataStreamBenchmarkParams_t* params = userData;
+    size_t bufferSize = AIA_DATA_STREAM_BENCHMARK_BUFFER_WORDS *
+                        AIA_DATA_STREAM_BENCHMARK_WORD_SIZE;
+    void* buffer = AiaCalloc( 1, bufferSize );
+    if( !buffer )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", bufferSize );
+        return false;
+    }
+    AiaDataStreamBuffer_t* dataStream = AiaDataStreamBuffer_Create(
+        buffer, bufferSize, AIA_DATA_STREAM_BENCHMARK_WORD_SIZE,
+        params->numReaders );
+    AiaDataStreamWriter_t* writer =
+        dataStream ? AiaDataStreamBuffer_CreateWriter(
+                         dataStream, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE,
+                         false )
+                   : NULL;
+    AiaDataStreamReader_t* readers[ params->numReaders ];
+    memset( readers, 0, sizeof( readers ) );
+    bool success = writer != NULL;
+    for( size_t i = 0; success && i < params->numReaders; ++i )
+    {
+        readers[ i ] = AiaDataStreamBuffer_CreateReader(
+            dataStream, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+        success = readers[ i ] != NULL;
+    }
+
+    uint8_t frame[ AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS *
+                   AIA_DATA_STREAM_BENCHMARK_WORD_SIZE ];
+    memset( frame, 0x5a, sizeof( frame ) );
+    uint8_t readFrame[ sizeof( frame ) ];
+
+    if( success )
+    {
+        AiaBenchmark_StartTimer( benchmark );
+        for( size_t i = 0; success && i < benchmark->iterations; ++i )
+        {
+            success = AiaDataStreamWriter_Write(
+                          writer, frame,
+                          AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS ) ==
+                      AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS;
+            for( size_t j = 0; success && j < params->numReaders; ++j )
+            {
+                success = AiaDataStreamReader_Read(
+                              readers[ j ], readFrame,
+                              AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS ) ==
+                          AIA_DATA_STREAM_BENCHMARK_FRAME_WORDS;
+            }
+        }
+        AiaBenchmark_StopTimer( benchmark );
+    }
+
+    for( size_t i = 0; i < params->numReaders; ++i )
+    {
+        if( readers[ i ] )
+        {
+            AiaDataStreamReader_Destroy( readers[ i ] );
+        }
+    }
+    if( writer )
+    {
+        AiaDataStreamWriter_Destroy( writer );
+    }
+    if( dataStream )
+    {
+        AiaDataStreamBuffer_Destroy( dataStream );
+    }
+    AiaFree( buffer );
+    return success;
+}
+
+bool RunAiaDataStreamBenchmarks( const AiaBenchmarkOptions_t* options )
+{
+    AiaDataStreamBenchmarkParams_t oneReader = { 1 };
+    AiaDataStreamBenchmarkParams_t twoReaders = { 2 };
+    bool success =
+        AiaBenchmark_Run( options, "DataStream/WriteRead/320B/1Reader",
+                          AiaDataStreamBenchmark_WriteRead, &oneReader );
+    success = AiaBenchmark_Run( options, "DataStream/WriteRead/320B/2Readers",
+                                AiaDataStreamBenchmark_WriteRead,
+                                &twoReaders ) &&
+              success;
+    return success;
+}
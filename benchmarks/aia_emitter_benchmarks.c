@@ -0,0 +1,219 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_emitter_benchmarks.c
+ * @brief Benchmarks for AiaEmitter_EmitMessageChunk() with real AES-GCM
+ * encryption by an @c AiaSecretManager_t.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/aia_binary_constants.h>
+#include <aiacore/aia_binary_message.h>
+#include <aiacore/aia_json_message.h>
+#include <aiacore/aia_topic.h>
+#include <aiaemitter/aia_emitter.h>
+
+#include <string.h>
+
+/** 10ms of 16kHz 16-bit audio per microphone chunk. */
+#define AIA_EMITTER_BENCHMARK_AUDIO_SIZE 320
+
+/** A typical event payload. */
+static const char* AIA_EMITTER_BENCHMARK_PAYLOAD =
+    "{\"token\":\"91a3c9d4-7e0b-4f5c-8d2a-6b1e0f3c4a57\","
+    "\"offset\":1234567,\"reason\":\"MEDIA_ERROR\","
+    "\"description\":\"buffer underrun while streaming\"}";
+
+/** Parameters of an emitter benchmark. */
+typedef struct AiaEmitterBenchmarkParams
+{
+    /** The topic to emit on. */
+    AiaTopic_t topic;
+
+    /** The secret manager encrypting messages. */
+    AiaSecretManager_t* secretManager;
+} AiaEmitterBenchmarkParams_t;
+
+/** Publishes nowhere; the connection is not used. */
+bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
+                     const char* topic, size_t topicLength, const void* message,
+                     size_t messageLength )
+{
+    (void)connection;
+    (void)qos;
+    (void)topic;
+    (void)topicLength;
+    (void)message;
+    (void)messageLength;
+    return true;
+}
+
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/** Publishes in place the same way as @c AiaMqttPublish(). */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                           messageLength );
+}
+#endif
+
+/**
+ * Creates a message chunk of the type carried by @c topic.
+ *
+ * @param topic The topic the chunk will be emitted on.
+ * @param index The index of the chunk, used as the microphone offset.
+ * @return The new chunk, or @c NULL on failure.
+ */
+static AiaRegulatorChunk_t* AiaEmitterBenchmark_CreateChunk( AiaTopic_t topic,
+                                                            size_t index )
+{
+    if( AiaTopic_GetType( topic ) == AIA_TOPIC_TYPE_JSON )
+    {
+        return AiaJsonMessage_ToMessage( AiaJsonMessage_Create(
+            "PlaybackFailed", NULL, AIA_EMITTER_BENCHMARK_PAYLOAD ) );
+    }
+
+    AiaBinaryAudioStreamOffset_t offset =
+        index * AIA_EMITTER_BENCHMARK_AUDIO_SIZE;
+    size_t length = sizeof( offset ) + AIA_EMITTER_BENCHMARK_AUDIO_SIZE;
+    uint8_t* data = AiaCalloc( 1, length );
+    if( !data )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", length );
+        return NULL;
+    }
+    for( size_t i = 0; i < sizeof( offset ); ++i )
+    {
+        data[ i ] = offset >> ( i * 8 );
+    }
+    memset( data + sizeof( offset ), 0x5a, AIA_EMITTER_BENCHMARK_AUDIO_SIZE );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_Create(
+        length, AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE, 0, data );
+    if( !binaryMessage )
+    {
+        AiaFree( data );
+        return NULL;
+    }
+    return AiaBinaryMessage_ToMessage( binaryMessage );
+}
+
+/**
+ * Destroys a chunk created by @c AiaEmitterBenchmark_CreateChunk().
+ *
+ * @param topic The topic the chunk was created for.
+ * @param chunk The chunk to destroy.
+ */
+static void AiaEmitterBenchmark_DestroyChunk( AiaTopic_t topic,
+                                              AiaRegulatorChunk_t* chunk )
+{
+    if( AiaTopic_GetType( topic ) == AIA_TOPIC_TYPE_JSON )
+    {
+        AiaJsonMessage_Destroy( AiaJsonMessage_FromMessage( chunk ) );
+    }
+    else
+    {
+        AiaBinaryMessage_Destroy( AiaBinaryMessage_FromMessage( chunk ) );
+    }
+}
+
+/**
+ * Emits @c benchmark->iterations single-chunk messages, each of which is
+ * encrypted and published.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData The @c AiaEmitterBenchmarkParams_t to run with.
+ * @return @c true if every chunk was emitted, else @c false.
+ */
+static bool AiaEmitterBenchmark_Emit( AiaBenchmark_t* benchmark,
+                                      void* userData )
+{
+    const AiaEmitterBenchmarkParams_t* params = userData;
+    size_t iterations = benchmark->iterations;
+
+    /* Mock out the connection, since AiaMqttPublish() never uses it. */
+    AiaEmitter_t* emitter = AiaEmitter_Create(
+        (AiaMqttConnectionPointer_t)params, params->secretManager,
+        params->topic );
+    AiaRegulatorChunk_t** chunks =
+        AiaCalloc( iterations, sizeof( AiaRegulatorChunk_t* ) );
+    bool success = emitter && chunks;
+    for( size_t i = 0; success && i < iterations; ++i )
+    {
+        chunks[ i ] = AiaEmitterBenchmark_CreateChunk( params->topic, i );
+        success = chunks[ i ] != NULL;
+    }
+
+    if( success )
+    {
+        AiaBenchmark_StartTimer( benchmark );
+        for( size_t i = 0; success && i < iterations; ++i )
+        {
+            success = AiaEmitter_EmitMessageChunk( emitter, chunks[ i ], 0, 0 );
+            if( success )
+            {
+                chunks[ i ] = NULL;
+            }
+        }
+        AiaBenchmark_StopTimer( benchmark );
+    }
+
+    for( size_t i = 0; chunks && i < iterations; ++i )
+    {
+        if( chunks[ i ] )
+        {
+            AiaEmitterBenchmark_DestroyChunk( params->topic, chunks[ i ] );
+        }
+    }
+    AiaFree( chunks );
+    AiaEmitter_Destroy( emitter );
+    return success;
+}
+
+bool RunAiaEmitterBenchmarks( const AiaBenchmarkOptions_t* options )
+{
+    /* Give the secret manager a device and a shared secret to work with. */
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    if( !AiaBenchmark_ProvisionDevice( storageFolder ) )
+    {
+        return false;
+    }
+    AiaSecretManager_t* secretManager = AiaBenchmark_CreateSecretManager();
+    if( !secretManager )
+    {
+        AiaLogError( "Failed to set up the secret manager" );
+        AiaBenchmark_RemoveDevice( storageFolder );
+        return false;
+    }
+
+    AiaEmitterBenchmarkParams_t event = { AIA_TOPIC_EVENT, secretManager };
+    AiaEmitterBenchmarkParams_t microphone = { AIA_TOPIC_MICROPHONE,
+                                               secretManager };
+    bool success = AiaBenchmark_Run( options, "Emitter/EmitMessageChunk/Event",
+                                     AiaEmitterBenchmark_Emit, &event );
+    success = AiaBenchmark_Run( options,
+                                "Emitter/EmitMessageChunk/Microphone/320B",
+                                AiaEmitterBenchmark_Emit, &microphone ) &&
+              success;
+
+    AiaSecretManager_Destroy( secretManager );
+    AiaBenchmark_RemoveDevice( storageFolder );
+    return success;
+}
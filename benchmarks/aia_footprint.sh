@@ -0,0 +1,110 @@
+#!/bin/sh
+
+#
+# This script is used to compare the footprint of representative SDK
+# configurations. Each configuration is built in its own folder, then the
+# script reports flash (.text and .rodata) and static RAM (.data and .bss) per
+# library, and the peak and steady-state heap per client over a scripted
+# session run by aia_loopback_load.
+#
+
+# Ingest arguments
+PROJECT_SOURCE_DIR="$1"
+FOOTPRINT_DIR="$2"
+CMAKE_COMMAND="$3"
+SIZE="$4"
+CMAKE_ARGS="$5"
+
+echo "PROJECT_SOURCE_DIR = $PROJECT_SOURCE_DIR"
+echo "FOOTPRINT_DIR = $FOOTPRINT_DIR"
+echo "CMAKE_COMMAND = $CMAKE_COMMAND"
+echo "SIZE = $SIZE"
+echo "CMAKE_ARGS = $CMAKE_ARGS"
+
+# Libraries reported, in dependency order.
+LIBRARIES="aiacore aiasequencer aiaregulator aiaemitter aiasecretmanager \
+aiadispatcher aiaconnectionmanager aiaspeakermanager aiamicrophonemanager \
+aiaalertmanager aiaclockmanager aiauxmanager aiaexceptionmanager \
+aiaregistrationmanager aiaclient"
+
+# Configurations as "<name>:<C flags>:<CMake options>", with words separated by
+# commas.
+CONFIGURATIONS="\
+full:: \
+no-speaker:-DAIA_DISABLE_SPEAKER: \
+no-alerts:-DAIA_DISABLE_ALERTS: \
+no-clock:-DAIA_DISABLE_CLOCK: \
+no-microphone:-DAIA_DISABLE_MICROPHONE: \
+microphone-only:-DAIA_DISABLE_SPEAKER,-DAIA_DISABLE_ALERTS,-DAIA_DISABLE_CLOCK: \
+opus-microphone::-DAIA_OPUS_ENCODER=ON"
+
+# Seconds of scripted session to measure the heap over.
+SESSION_SECONDS=5
+
+mkdir -p "$FOOTPRINT_DIR"
+report="$FOOTPRINT_DIR/footprint.txt"
+: > "$report"
+
+for configuration in $CONFIGURATIONS; do
+    name=$(echo "$configuration" | cut -d: -f1)
+    cflags=$(echo "$configuration" | cut -d: -f2 | tr ',' ' ')
+    options=$(echo "$configuration" | cut -d: -f3 | tr ',' ' ')
+    build="$FOOTPRINT_DIR/$name"
+
+    echo "==> Building $name"
+    mkdir -p "$build"
+    log="$build/build.log"
+    # Word splitting of $options and $CMAKE_ARGS is intended.
+    built=true
+    (cd "$build" && "$CMAKE_COMMAND" "$PROJECT_SOURCE_DIR" \
+        -DCMAKE_BUILD_TYPE=MinSizeRel \
+        -DCMAKE_C_FLAGS="$cflags" \
+        -DAIA_BUILD_BENCHMARKS=ON \
+        $options $CMAKE_ARGS) > "$log" 2>&1 || built=false
+    for target in $LIBRARIES aia_loopback_load; do
+        if $built; then
+            "$CMAKE_COMMAND" --build "$build" --target "$target" \
+                >> "$log" 2>&1 || built=false
+        fi
+    done
+    if ! $built; then
+        echo "$name: build failed, see $log" | tee -a "$report"
+        continue
+    fi
+
+    {
+        echo "== $name"
+        printf "%-24s %10s %10s %10s %10s\n" "library" ".text" ".rodata" \
+               ".data" ".bss"
+    } | tee -a "$report"
+    for library in $LIBRARIES; do
+        archive=$(find "$build" -name "lib$library.a" | head -n 1)
+        if [ -z "$archive" ]; then
+            continue
+        fi
+        "$SIZE" -A "$archive" | awk -v library="$library" '
+            $1 ~ /^\.text/ { text += $2 }
+            $1 ~ /^\.rodata/ { rodata += $2 }
+            $1 ~ /^\.data/ { data += $2 }
+            $1 ~ /^\.bss/ { bss += $2 }
+            END {
+                printf "%-24s %10d %10d %10d %10d\n", library, text, rodata,
+                       data, bss
+            }'
+    done | tee "$build/size.txt" | tee -a "$report"
+    awk '
+        { text += $2; rodata += $3; data += $4; bss += $5 }
+        END {
+            printf "%-24s %10d %10d %10d %10d\n", "total", text, rodata,
+                   data, bss
+            printf "flash=%d static ram=%d\n", text + rodata, data + bss
+        }' "$build/size.txt" | tee -a "$report"
+
+    loopback=$(find "$build" -name aia_loopback_load -type f | head -n 1)
+    if [ -n "$loopback" ]; then
+        "$loopback" -c 1 -d "$SESSION_SECONDS" 2> /dev/null \
+            | grep '^heap:' | tee -a "$report"
+    fi
+done
+
+echo "Report: $report"
@@ -0,0 +1,158 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_json_utils_benchmarks.c
+ * @brief Benchmarks for AiaJsonUtils_GetArrayElement() on directive batches.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/aia_json_utils.h>
+
+#include <string.h>
+
+/* clang-format off */
+/** A batch of directives as published on the directive topic. */
+static const char* AIA_JSON_UTILS_BENCHMARK_DIRECTIVES =
+    "{\"directives\":["
+    "{\"header\":{\"name\":\"OpenSpeaker\",\"messageId\":\"a1b2c3d4\"},"
+        "\"payload\":{\"offset\":1234567}},"
+    "{\"header\":{\"name\":\"SetVolume\",\"messageId\":\"a1b2c3d5\"},"
+        "\"payload\":{\"volume\":55,\"offset\":1234567}},"
+    "{\"header\":{\"name\":\"SetAttentionState\",\"messageId\":\"a1b2c3d6\"},"
+        "\"payload\":{\"state\":\"SPEAKING\",\"offset\":1234567}},"
+    "{\"header\":{\"name\":\"SetAlert\",\"messageId\":\"a1b2c3d7\"},"
+        "\"payload\":{\"token\":\"91a3c9d4-7e0b-4f5c-8d2a-6b1e0f3c4a57\","
+        "\"type\":\"TIMER\",\"scheduledTime\":1589000000,"
+        "\"durationInMilliseconds\":600000}},"
+    "{\"header\":{\"name\":\"SetAlertVolume\",\"messageId\":\"a1b2c3d8\"},"
+        "\"payload\":{\"volume\":80}},"
+    "{\"header\":{\"name\":\"SetClock\",\"messageId\":\"a1b2c3d9\"},"
+        "\"payload\":{\"currentTime\":1589000000}},"
+    "{\"header\":{\"name\":\"CloseSpeaker\",\"messageId\":\"a1b2c3da\"},"
+        "\"payload\":{\"offset\":1298765}},"
+    "{\"header\":{\"name\":\"SetAttentionState\",\"messageId\":\"a1b2c3db\"},"
+        "\"payload\":{\"state\":\"IDLE\"}}"
+    "]}";
+/* clang-format on */
+
+/** The number of directives in @c AIA_JSON_UTILS_BENCHMARK_DIRECTIVES. */
+#define AIA_JSON_UTILS_BENCHMARK_NUM_DIRECTIVES 8
+
+/**
+ * Finds the directives array in @c AIA_JSON_UTILS_BENCHMARK_DIRECTIVES.
+ *
+ * @param[out] array The array.
+ * @param[out] arrayLength The length of @c array.
+ * @return @c true if the array was found, else @c false.
+ */
+static bool AiaJsonUtilsBenchmark_FindDirectives( const char** array,
+                                                  size_t* arrayLength )
+{
+    static const char* KEY = "directives";
+    return AiaFindJsonValue( AIA_JSON_UTILS_BENCHMARK_DIRECTIVES,
+                             strlen( AIA_JSON_UTILS_BENCHMARK_DIRECTIVES ),
+                             KEY, strlen( KEY ), array, arrayLength );
+}
+
+/**
+ * Extracts every directive by index with @c AiaJsonUtils_GetArrayElement() per
+ * operation, as a caller iterating over the batch would.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData Unused.
+ * @return @c true if every directive was found, else @c false.
+ */
+static bool AiaJsonUtilsBenchmark_GetArrayElement( AiaBenchmark_t* benchmark,
+                                                   void* userData )
+{
+    (void)userData;
+    const char* array;
+    size_t arrayLength;
+    if( !AiaJsonUtilsBenchmark_FindDirectives( &array, &arrayLength ) )
+    {
+        return false;
+    }
+
+    bool success = true;
+    AiaBenchmark_StartTimer( benchmark );
+    for( size_t i = 0; success && i < benchmark->iterations; ++i )
+    {
+        for( size_t index = 0;
+             success && index < AIA_JSON_UTILS_BENCHMARK_NUM_DIRECTIVES;
+             ++index )
+        {
+            const char* directive;
+            size_t directiveLength;
+            success = AiaJsonUtils_GetArrayElement(
+                array, arrayLength, index, &directive, &directiveLength );
+        }
+    }
+    AiaBenchmark_StopTimer( benchmark );
+    return success;
+}
+
+/**
+ * Extracts every directive with an @c AiaJsonArrayIterator_t per operation,
+ * as a baseline for @c AiaJsonUtilsBenchmark_GetArrayElement().
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData Unused.
+ * @return @c true if every directive was found, else @c false.
+ */
+static bool AiaJsonUtilsBenchmark_ArrayIterator( AiaBenchmark_t* benchmark,
+                                                 void* userData )
+{
+    (void)userData;
+    const char* array;
+    size_t arrayLength;
+    if( !AiaJsonUtilsBenchmark_FindDirectives( &array, &arrayLength ) )
+    {
+        return false;
+    }
+
+    bool success = true;
+    AiaBenchmark_StartTimer( benchmark );
+    for( size_t i = 0; success && i < benchmark->iterations; ++i )
+    {
+        AiaJsonArrayIterator_t iterator;
+        const char* directive;
+        size_t directiveLength;
+        size_t count = 0;
+        success =
+            AiaJsonArrayIterator_Initialize( &iterator, array, arrayLength );
+        while( success && AiaJsonArrayIterator_Next( &iterator, &directive,
+                                                     &directiveLength ) )
+        {
+            ++count;
+        }
+        success = success && count == AIA_JSON_UTILS_BENCHMARK_NUM_DIRECTIVES;
+    }
+    AiaBenchmark_StopTimer( benchmark );
+    return success;
+}
+
+bool RunAiaJsonUtilsBenchmarks( const AiaBenchmarkOptions_t* options )
+{
+    bool success = AiaBenchmark_Run(
+        options, "JsonUtils/GetArrayElement/8Directives",
+        AiaJsonUtilsBenchmark_GetArrayElement, NULL );
+    success = AiaBenchmark_Run( options, "JsonUtils/ArrayIterator/8Directives",
+                                AiaJsonUtilsBenchmark_ArrayIterator, NULL ) &&
+              success;
+    return success;
+}
@@ -0,0 +1,1586 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_loopback_load.c
+ * @brief Load test running concurrent @c AiaClient_t instances against an
+ * in-process loopback broker.
+ *
+ * Each client is given a fake MQTT connection: @c AiaMqttPublish() is
+ * replaced and the MQTT subscription functions are wrapped so that everything
+ * a client publishes is consumed by the broker, and everything the broker
+ * sends is passed straight to the client's @c messageReceivedCallback(). The
+ * broker acknowledges connections, then replays a synthetic interaction on
+ * every client: a steady speaker stream, a @c SetVolume directive every second
+ * and a hold-to-talk microphone stream. Service messages are encrypted and
+ * client messages decrypted with the same shared secret the clients use, so
+ * that the measured cost includes the real cryptography. The heap in use is
+ * sampled while measuring to report the peak and steady-state heap the
+ * clients hold.
+ *
+ * With @c -n, each direction of every client's connection runs over an @c
+ * AiaNetworkImpairment_t simulating the named profile, polled by the driver.
+ * Latencies are then measured from the broker sending and to it receiving,
+ * so they include the simulated network, and the stages which end within a
+ * synchronous delivery are not measured.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiaclient/aia_client.h>
+#include <aiacore/aia_binary_constants.h>
+#include <aiacore/aia_crypto_mbedtls.h>
+#include <aiacore/aia_mbedtls_threading.h>
+#include <aiacore/aia_message_constants.h>
+#include <aiacore/aia_random_mbedtls.h>
+#include <aiacore/aia_topic.h>
+#include <aiacore/aia_utils.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
+#include <aiamicrophonemanager/aia_microphone_constants.h>
+#include <aianetworkimpairment/aia_network_impairment.h>
+#include <aiasecretmanager/aia_secret_manager.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaTaskPool( HEADER )
+#include AiaTimer( HEADER )
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+/** The number of clients run when @c -c is not given. */
+#define AIA_LOOPBACK_DEFAULT_CLIENTS 10
+
+/** The number of seconds measured when @c -d is not given. */
+#define AIA_LOOPBACK_DEFAULT_DURATION_S 10
+
+/** The number of driver timers used when @c -s is not given. */
+#define AIA_LOOPBACK_DEFAULT_SHARDS 1
+
+/** The period of the driver timers, which capture 10ms of microphone audio
+ * per tick. */
+#define AIA_LOOPBACK_TICK_MS 10
+
+/** The number of samples captured per tick. */
+#define AIA_LOOPBACK_MICROPHONE_FRAME_SAMPLES 160
+
+/** Two seconds of microphone audio. */
+#define AIA_LOOPBACK_MICROPHONE_BUFFER_SAMPLES 32000
+
+/** The size of a 20ms Opus frame at 64kbps. */
+#define AIA_LOOPBACK_SPEAKER_FRAME_SIZE 160
+
+/** The number of speaker frames per speaker message, 100ms of audio. */
+#define AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE 5
+
+/** The number of ticks between speaker messages, sent in real time. */
+#define AIA_LOOPBACK_SPEAKER_MESSAGE_TICKS 10
+
+/** The number of speaker messages sent ahead when the speaker is opened. */
+#define AIA_LOOPBACK_SPEAKER_PREBUFFER_MESSAGES 5
+
+/** The number of ticks between @c SetVolume directives. */
+#define AIA_LOOPBACK_DIRECTIVE_TICKS 100
+
+/** The number of frame timestamps remembered per stream. Must be a power of
+ * two, and cover more audio than any buffer frames can wait in. */
+#define AIA_LOOPBACK_TIMESTAMP_RING_SIZE 1024
+
+/** How long to wait for each client to be acknowledged. */
+#define AIA_LOOPBACK_CONNECT_TIMEOUT_MS 15000
+
+/** The period at which heap usage is sampled while measuring. */
+#define AIA_LOOPBACK_HEAP_SAMPLE_MS 100
+
+/** Four buckets per power of two, up to 2^40 microseconds. */
+#define AIA_LOOPBACK_HISTOGRAM_BUCKETS 160
+
+/** The latency stages reported. */
+typedef enum AiaLoopbackStage
+{
+    /** From a directive message being delivered to the dispatcher returning. */
+    AIA_LOOPBACK_STAGE_DIRECTIVE_HANDLED,
+
+    /** From a @c SetVolume directive being delivered to it being applied. */
+    AIA_LOOPBACK_STAGE_DIRECTIVE_APPLIED,
+
+    /** From a speaker message being delivered to it being sequenced,
+     * decrypted and buffered, all of which happen within the callback. */
+    AIA_LOOPBACK_STAGE_SPEAKER_BUFFERED,
+
+    /** From a speaker frame being buffered to it being played. */
+    AIA_LOOPBACK_STAGE_SPEAKER_PLAYED,
+
+    /** From a microphone frame being captured to it being published. */
+    AIA_LOOPBACK_STAGE_MICROPHONE_PUBLISHED,
+
+    AIA_LOOPBACK_NUM_STAGES
+} AiaLoopbackStage_t;
+
+/** Names of @c AiaLoopbackStage_t values, in order. */
+static const char* const AIA_LOOPBACK_STAGE_NAMES[] = {
+    "directive received->handled", "directive received->applied",
+    "speaker received->buffered", "speaker buffered->played",
+    "microphone captured->published"
+};
+
+/** A log-linear histogram of latencies in microseconds. */
+typedef struct AiaLoopbackHistogram
+{
+    /** Serializes access to the members below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+    uint64_t buckets[ AIA_LOOPBACK_HISTOGRAM_BUCKETS ];
+    uint64_t count;
+    uint64_t sumUs;
+    uint64_t maxUs;
+    /** @} */
+} AiaLoopbackHistogram_t;
+
+/** A client under test and the broker's state for it. */
+typedef struct AiaLoopbackClient
+{
+    /** The client under test. */
+    AiaClient_t* client;
+
+    /** The handler the client subscribed with, on this client's
+     * connection. */
+    AiaNetworkImpairmentMqttHandler_t mqttHandler;
+
+    /** The simulated links from and to the broker, when impaired. */
+    AiaNetworkImpairment_t* downlink;
+    AiaNetworkImpairment_t* uplink;
+
+    /** Set when the client has sent a Connect message the broker has yet to
+     * acknowledge. */
+    AiaAtomicBool_t ackPending;
+
+    /** Set once the client reports that it is connected. */
+    AiaAtomicBool_t connected;
+
+    /** Set while the client is streaming, and the timestamps below are
+     * valid. */
+    AiaAtomicBool_t streaming;
+
+    /** @name Variables only used by the driver. */
+    /** @{ */
+    AiaSequenceNumber_t nextSequenceNumbers[ AIA_NUM_TOPICS ];
+    uint64_t ticks;
+    uint32_t speakerFramesSent;
+    uint8_t volume;
+    /** @} */
+
+    /** Serializes access to the members below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+    uint64_t speakerBufferedNs[ AIA_LOOPBACK_TIMESTAMP_RING_SIZE ];
+    uint64_t microphoneCapturedNs[ AIA_LOOPBACK_TIMESTAMP_RING_SIZE ];
+    uint64_t microphoneFramesCaptured;
+    uint64_t directiveReceivedNs;
+    uint8_t pendingVolume;
+    /** @} */
+
+    /** The microphone stream owned by the application. */
+    void* microphoneBuffer;
+    AiaDataStreamBuffer_t* microphoneStream;
+    AiaDataStreamWriter_t* microphoneWriter;
+    AiaDataStreamReader_t* microphoneReader;
+} AiaLoopbackClient_t;
+
+/** A driver timer and the clients it drives. */
+typedef struct AiaLoopbackShard
+{
+    /** The periodic timer. */
+    AiaTimer_t timer;
+
+    /** Set while a tick is running, so that overlapping ticks are skipped. */
+    AiaAtomicBool_t ticking;
+
+    /** The clients driven by this shard. */
+    AiaLoopbackClient_t** clients;
+    size_t numClients;
+
+    /** The start time of the last tick. */
+    uint64_t lastTickNs;
+} AiaLoopbackShard_t;
+
+/** Latency histograms, indexed by @c AiaLoopbackStage_t. */
+static AiaLoopbackHistogram_t g_histograms[ AIA_LOOPBACK_NUM_STAGES ];
+
+/** The secret manager used by the broker. */
+static AiaSecretManager_t* g_serviceSecretManager;
+
+/** The device topic root every client publishes under. */
+static char* g_deviceTopicRoot;
+static size_t g_deviceTopicRootSize;
+
+/** Messages published by the clients, per topic. */
+static uint32_t g_publishCounts[ AIA_NUM_TOPICS ];
+
+/** Time spent by the broker encrypting and decrypting. */
+static uint64_t g_brokerCryptoNs;
+static AiaMutex_t g_brokerCryptoMutex;
+
+/** Ticks which were skipped or started more than a period late. */
+static uint32_t g_lateTicks;
+
+/** Set while latencies are being recorded. */
+static AiaAtomicBool_t g_measuring;
+
+/** The conditions simulated on every connection, if @c -n was given. */
+static AiaNetworkImpairmentProfile_t g_impairmentProfile;
+static bool g_isImpaired;
+
+/**
+ * Records a latency.
+ *
+ * @param stage The stage measured.
+ * @param startNs The start of the stage.
+ * @param endNs The end of the stage.
+ */
+static void AiaLoopback_Record( AiaLoopbackStage_t stage, uint64_t startNs,
+                                uint64_t endNs )
+{
+    if( !AiaAtomicBool_Load( &g_measuring ) || !startNs )
+    {
+        return;
+    }
+    uint64_t us = endNs > startNs ? ( endNs - startNs ) / 1000 : 0;
+    size_t bucket = us;
+    if( us >= 4 )
+    {
+        size_t log2 = 63 - __builtin_clzll( us );
+        bucket = ( log2 - 1 ) * 4 + ( ( us >> ( log2 - 2 ) ) & 3 );
+    }
+    if( bucket >= AIA_LOOPBACK_HISTOGRAM_BUCKETS )
+    {
+        bucket = AIA_LOOPBACK_HISTOGRAM_BUCKETS - 1;
+    }
+
+    AiaLoopbackHistogram_t* histogram = &g_histograms[ stage ];
+    AiaMutex( Lock )( &histogram->mutex );
+    ++histogram->buckets[ bucket ];
+    ++histogram->count;
+    histogram->sumUs += us;
+    if( us > histogram->maxUs )
+    {
+        histogram->maxUs = us;
+    }
+    AiaMutex( Unlock )( &histogram->mutex );
+}
+
+/**
+ * @param histogram The histogram to read.
+ * @param percent The percentile to find.
+ * @return The lower bound of the bucket holding the percentile, in
+ * microseconds.
+ */
+static uint64_t AiaLoopback_Percentile( const AiaLoopbackHistogram_t* histogram,
+                                        unsigned int percent )
+{
+    uint64_t rank = ( histogram->count * percent + 99 ) / 100;
+    uint64_t seen = 0;
+    for( size_t bucket = 0; bucket < AIA_LOOPBACK_HISTOGRAM_BUCKETS; ++bucket )
+    {
+        seen += histogram->buckets[ bucket ];
+        if( seen >= rank && seen )
+        {
+            if( bucket < 4 )
+            {
+                return bucket;
+            }
+            return (uint64_t)( 4 + bucket % 4 ) << ( bucket / 4 - 1 );
+        }
+    }
+    return histogram->maxUs;
+}
+
+/** Adds the time since @c startNs to the broker's crypto time. */
+static void AiaLoopback_AddCryptoTime( uint64_t startNs )
+{
+    uint64_t elapsedNs = AiaBenchmark_GetTimeNs() - startNs;
+    AiaMutex( Lock )( &g_brokerCryptoMutex );
+    g_brokerCryptoNs += elapsedNs;
+    AiaMutex( Unlock )( &g_brokerCryptoMutex );
+}
+
+/** Writes @c value to @c buffer in little-endian order. */
+static void AiaLoopback_WriteLe( uint8_t* buffer, uint64_t value, size_t size )
+{
+    for( size_t i = 0; i < size; ++i )
+    {
+        buffer[ i ] = value >> ( i * 8 );
+    }
+}
+
+/** @return The little-endian value of @c size bytes at @c buffer. */
+static uint64_t AiaLoopback_ReadLe( const uint8_t* buffer, size_t size )
+{
+    uint64_t value = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        value |= (uint64_t)buffer[ i ] << ( i * 8 );
+    }
+    return value;
+}
+
+/**
+ * Passes a message from the broker to a client, as the MQTT library would.
+ *
+ * @param loopbackClient The client to deliver to.
+ * @param topic The topic the message is on.
+ * @param payload The message.
+ * @param payloadLength The length of @c payload.
+ */
+static void AiaLoopback_Deliver( AiaLoopbackClient_t* loopbackClient,
+                                 AiaTopic_t topic, const void* payload,
+                                 size_t payloadLength )
+{
+    size_t topicNameLength =
+        g_deviceTopicRootSize + AiaTopic_GetLength( topic );
+    char topicName[ topicNameLength ];
+    memcpy( topicName, g_deviceTopicRoot, g_deviceTopicRootSize );
+    memcpy( topicName + g_deviceTopicRootSize, AiaTopic_ToString( topic ),
+            AiaTopic_GetLength( topic ) );
+
+    if( loopbackClient->downlink )
+    {
+        AiaNetworkImpairment_Submit( loopbackClient->downlink,
+                                     AiaClock( GetTimeMs )(), topicName,
+                                     topicNameLength, payload, payloadLength );
+        return;
+    }
+    AiaNetworkImpairment_DeliverToMqttHandler( topicName, topicNameLength,
+                                               payload, payloadLength,
+                                               &loopbackClient->mqttHandler );
+}
+
+/**
+ * Encrypts a message as the service would and passes it to a client.
+ *
+ * @param loopbackClient The client to deliver to.
+ * @param topic The encrypted topic the message is on.
+ * @param body The plaintext following the encrypted sequence number.
+ * @param bodyLength The length of @c body.
+ * @param[out] receivedNs The time the message was delivered.
+ * @return @c true if the message was encrypted and delivered, else @c false.
+ */
+static bool AiaLoopback_DeliverEncrypted( AiaLoopbackClient_t* loopbackClient,
+                                          AiaTopic_t topic,
+                                          const uint8_t* body,
+                                          size_t bodyLength,
+                                          uint64_t* receivedNs )
+{
+    AiaSequenceNumber_t sequenceNumber =
+        loopbackClient->nextSequenceNumbers[ topic ]++;
+    size_t messageLength = AIA_SIZE_OF_COMMON_HEADER + bodyLength;
+    uint8_t message[ messageLength ];
+    uint8_t* iv = message + sizeof( AiaSequenceNumber_t );
+    uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    uint8_t* encrypted = message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    AiaLoopback_WriteLe( message, sequenceNumber, sizeof( sequenceNumber ) );
+    AiaLoopback_WriteLe( encrypted, sequenceNumber, sizeof( sequenceNumber ) );
+    memcpy( encrypted + sizeof( sequenceNumber ), body, bodyLength );
+
+    uint64_t startNs = AiaBenchmark_GetTimeNs();
+    if( !AiaSecretManager_Encrypt(
+            g_serviceSecretManager, topic, sequenceNumber, encrypted,
+            messageLength - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+            encrypted, iv, AIA_COMMON_HEADER_IV_SIZE, mac,
+            AIA_COMMON_HEADER_MAC_SIZE ) )
+    {
+        AiaLogError( "AiaSecretManager_Encrypt failed, topic=%s",
+                     AiaTopic_ToString( topic ) );
+        return false;
+    }
+    AiaLoopback_AddCryptoTime( startNs );
+
+    *receivedNs = AiaBenchmark_GetTimeNs();
+    AiaLoopback_Deliver( loopbackClient, topic, message, messageLength );
+    return true;
+}
+
+/**
+ * Sends a single directive to a client.
+ *
+ * @param loopbackClient The client to send to.
+ * @param name The name of the directive.
+ * @param payload The JSON payload of the directive.
+ * @return @c true if the directive was delivered, else @c false.
+ */
+static bool AiaLoopback_SendDirective( AiaLoopbackClient_t* loopbackClient,
+                                       const char* name, const char* payload )
+{
+    /* clang-format off */
+    static const char* FORMAT =
+        "{\"directives\":[{"
+            "\"header\":{\"name\":\"%s\",\"messageId\":\"%" PRIu32 "\"},"
+            "\"payload\":%s"
+        "}]}";
+    /* clang-format on */
+    AiaSequenceNumber_t messageId =
+        loopbackClient->nextSequenceNumbers[ AIA_TOPIC_DIRECTIVE ];
+    int length = snprintf( NULL, 0, FORMAT, name, messageId, payload );
+    char body[ length + 1 ];
+    snprintf( body, sizeof( body ), FORMAT, name, messageId, payload );
+
+    uint64_t receivedNs;
+    if( !AiaLoopback_DeliverEncrypted( loopbackClient, AIA_TOPIC_DIRECTIVE,
+                                       (const uint8_t*)body, length,
+                                       &receivedNs ) )
+    {
+        return false;
+    }
+    if( !g_isImpaired )
+    {
+        AiaLoopback_Record( AIA_LOOPBACK_STAGE_DIRECTIVE_HANDLED, receivedNs,
+                            AiaBenchmark_GetTimeNs() );
+    }
+    return true;
+}
+
+/**
+ * Sends a @c SetVolume directive with the next volume in a cycle.
+ *
+ * @param loopbackClient The client to send to.
+ * @return @c true if the directive was delivered, else @c false.
+ */
+static bool AiaLoopback_SendSetVolume( AiaLoopbackClient_t* loopbackClient )
+{
+    loopbackClient->volume = loopbackClient->volume % 90 + 10;
+    char payload[ sizeof( "{\"volume\":100}" ) ];
+    snprintf( payload, sizeof( payload ), "{\"volume\":%u}",
+              loopbackClient->volume );
+
+    /* The volume is applied when playback reaches the directive, so record
+     * the delivery time up front. */
+    AiaMutex( Lock )( &loopbackClient->mutex );
+    loopbackClient->pendingVolume = loopbackClient->volume;
+    loopbackClient->directiveReceivedNs = AiaBenchmark_GetTimeNs();
+    AiaMutex( Unlock )( &loopbackClient->mutex );
+    return AiaLoopback_SendDirective( loopbackClient, "SetVolume", payload );
+}
+
+/**
+ * Sends one speaker message of @c AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE
+ * frames, each of which starts with its index in the stream.
+ *
+ * @param loopbackClient The client to send to.
+ * @return @c true if the message was delivered, else @c false.
+ */
+static bool AiaLoopback_SendSpeaker( AiaLoopbackClient_t* loopbackClient )
+{
+    size_t audioLength = AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE *
+                         AIA_LOOPBACK_SPEAKER_FRAME_SIZE;
+    size_t entryLength = sizeof( AiaBinaryAudioStreamOffset_t ) + audioLength;
+    uint8_t body[ AIA_SIZE_OF_BINARY_STREAM_HEADER + entryLength ];
+    memset( body, 0x5a, sizeof( body ) );
+
+    uint8_t* position = body;
+    AiaLoopback_WriteLe( position, entryLength,
+                         sizeof( AiaBinaryMessageLength_t ) );
+    position += sizeof( AiaBinaryMessageLength_t );
+    *position++ = AIA_BINARY_STREAM_SPEAKER_CONTENT_TYPE;
+    *position++ = AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE - 1;
+    memset( position, 0, AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES );
+    position += AIA_BINARY_MESSAGE_NUM_RESERVED_BYTES;
+    uint32_t firstFrame = loopbackClient->speakerFramesSent;
+    AiaLoopback_WriteLe(
+        position, (uint64_t)firstFrame * AIA_LOOPBACK_SPEAKER_FRAME_SIZE,
+        sizeof( AiaBinaryAudioStreamOffset_t ) );
+    position += sizeof( AiaBinaryAudioStreamOffset_t );
+    for( size_t i = 0; i < AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE; ++i )
+    {
+        AiaLoopback_WriteLe( position + i * AIA_LOOPBACK_SPEAKER_FRAME_SIZE,
+                             firstFrame + i, sizeof( uint32_t ) );
+    }
+    loopbackClient->speakerFramesSent +=
+        AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE;
+
+    uint64_t receivedNs;
+    if( !AiaLoopback_DeliverEncrypted( loopbackClient, AIA_TOPIC_SPEAKER, body,
+                                       sizeof( body ), &receivedNs ) )
+    {
+        return false;
+    }
+    uint64_t bufferedNs = AiaBenchmark_GetTimeNs();
+    if( !g_isImpaired )
+    {
+        AiaLoopback_Record( AIA_LOOPBACK_STAGE_SPEAKER_BUFFERED, receivedNs,
+                            bufferedNs );
+    }
+
+    AiaMutex( Lock )( &loopbackClient->mutex );
+    for( size_t i = 0; i < AIA_LOOPBACK_SPEAKER_FRAMES_PER_MESSAGE; ++i )
+    {
+        loopbackClient->speakerBufferedNs[ ( firstFrame + i ) %
+                                           AIA_LOOPBACK_TIMESTAMP_RING_SIZE ] =
+            bufferedNs;
+    }
+    AiaMutex( Unlock )( &loopbackClient->mutex );
+    return true;
+}
+
+/**
+ * Acknowledges a pending Connect message.
+ *
+ * @param loopbackClient The client to acknowledge.
+ */
+static void AiaLoopback_SendConnectionAck( AiaLoopbackClient_t* loopbackClient )
+{
+    static const char* ACK =
+        "{\"header\":{\"name\":\"Acknowledge\",\"messageId\":\"0\"},"
+        "\"payload\":{\"code\":\"CONNECTION_ESTABLISHED\"}}";
+    AiaLoopback_Deliver( loopbackClient, AIA_TOPIC_CONNECTION_FROM_SERVICE, ACK,
+                         strlen( ACK ) );
+}
+
+/**
+ * Opens the speaker, sends the speaker prebuffer and opens the microphone.
+ *
+ * @param loopbackClient The newly connected client.
+ * @return @c true on success, else @c false.
+ */
+static bool AiaLoopback_StartStreaming( AiaLoopbackClient_t* loopbackClient )
+{
+    if( !AiaLoopback_SendDirective( loopbackClient, "OpenSpeaker",
+                                    "{\"offset\":0}" ) )
+    {
+        return false;
+    }
+    for( size_t i = 0; i < AIA_LOOPBACK_SPEAKER_PREBUFFER_MESSAGES; ++i )
+    {
+        if( !AiaLoopback_SendSpeaker( loopbackClient ) )
+        {
+            return false;
+        }
+    }
+    if( !AiaClient_HoldToTalkStart(
+            loopbackClient->client,
+            AiaDataStreamWriter_Tell( loopbackClient->microphoneWriter ) ) )
+    {
+        AiaLogError( "AiaClient_HoldToTalkStart failed" );
+        return false;
+    }
+    AiaAtomicBool_Set( &loopbackClient->streaming );
+    return true;
+}
+
+/**
+ * Captures one tick of microphone audio.
+ *
+ * @param loopbackClient The client to capture for.
+ */
+static void AiaLoopback_CaptureMicrophone( AiaLoopbackClient_t* loopbackClient )
+{
+    uint8_t frame[ AIA_LOOPBACK_MICROPHONE_FRAME_SAMPLES *
+                   AIA_MICROPHONE_BUFFER_WORD_SIZE ];
+    memset( frame, 0x5a, sizeof( frame ) );
+
+    /* Record the capture time first, since the client may publish the frame
+     * as soon as it is written. */
+    AiaMutex( Lock )( &loopbackClient->mutex );
+    uint64_t index = loopbackClient->microphoneFramesCaptured++;
+    loopbackClient
+        ->microphoneCapturedNs[ index % AIA_LOOPBACK_TIMESTAMP_RING_SIZE ] =
+        AiaBenchmark_GetTimeNs();
+    AiaMutex( Unlock )( &loopbackClient->mutex );
+
+    if( AiaDataStreamWriter_Write( loopbackClient->microphoneWriter, frame,
+                                   AIA_LOOPBACK_MICROPHONE_FRAME_SAMPLES ) !=
+        AIA_LOOPBACK_MICROPHONE_FRAME_SAMPLES )
+    {
+        AiaLogError( "AiaDataStreamWriter_Write failed" );
+    }
+}
+
+/**
+ * Advances a client by one tick.
+ *
+ * @param loopbackClient The client to drive.
+ */
+static void AiaLoopback_DriveClient( AiaLoopbackClient_t* loopbackClient )
+{
+    if( g_isImpaired )
+    {
+        AiaTimepointMs_t nowMs = AiaClock( GetTimeMs )();
+        AiaNetworkImpairment_Poll( loopbackClient->uplink, nowMs );
+        AiaNetworkImpairment_Poll( loopbackClient->downlink, nowMs );
+    }
+    if( AiaAtomicBool_Load( &loopbackClient->ackPending ) )
+    {
+        AiaAtomicBool_Clear( &loopbackClient->ackPending );
+        AiaLoopback_SendConnectionAck( loopbackClient );
+        return;
+    }
+    if( !AiaAtomicBool_Load( &loopbackClient->connected ) )
+    {
+        return;
+    }
+    if( !AiaAtomicBool_Load( &loopbackClient->streaming ) )
+    {
+        if( !AiaLoopback_StartStreaming( loopbackClient ) )
+        {
+            AiaLogError( "Failed to start streaming" );
+        }
+        return;
+    }
+
+    uint64_t tick = ++loopbackClient->ticks;
+    AiaLoopback_CaptureMicrophone( loopbackClient );
+    if( tick % AIA_LOOPBACK_SPEAKER_MESSAGE_TICKS == 0 &&
+        !AiaLoopback_SendSpeaker( loopbackClient ) )
+    {
+        AiaLogError( "Failed to send speaker message" );
+    }
+    if( tick % AIA_LOOPBACK_DIRECTIVE_TICKS == 0 &&
+        !AiaLoopback_SendSetVolume( loopbackClient ) )
+    {
+        AiaLogError( "Failed to send SetVolume" );
+    }
+}
+
+/**
+ * Timer routine advancing every client of a shard by one tick.
+ *
+ * @param userData The @c AiaLoopbackShard_t to drive.
+ */
+static void AiaLoopback_Tick( void* userData )
+{
+    AiaLoopbackShard_t* shard = userData;
+    if( !AiaAtomic_CompareAndSwap_u32( &shard->ticking, 1, 0 ) )
+    {
+        AiaAtomic_Add_u32( &g_lateTicks, 1 );
+        return;
+    }
+
+    uint64_t nowNs = AiaBenchmark_GetTimeNs();
+    if( shard->lastTickNs &&
+        nowNs - shard->lastTickNs > 2 * AIA_LOOPBACK_TICK_MS * 1000000ull )
+    {
+        AiaAtomic_Add_u32( &g_lateTicks, 1 );
+    }
+    shard->lastTickNs = nowNs;
+    for( size_t i = 0; i < shard->numClients; ++i )
+    {
+        AiaLoopback_DriveClient( shard->clients[ i ] );
+    }
+    AiaAtomicBool_Clear( &shard->ticking );
+}
+
+/**
+ * Consumes a microphone message published by a client, recording the
+ * latency of the last frame of each entry.
+ *
+ * @param loopbackClient The client that published the message.
+ * @param message The encrypted message.
+ * @param messageLength The length of @c message.
+ */
+static void AiaLoopback_ConsumeMicrophone( AiaLoopbackClient_t* loopbackClient,
+                                           const uint8_t* message,
+                                           size_t messageLength )
+{
+    uint64_t publishedNs = AiaBenchmark_GetTimeNs();
+    if( messageLength < AIA_SIZE_OF_COMMON_HEADER )
+    {
+        AiaLogError( "Microphone message too short, length=%zu",
+                     messageLength );
+        return;
+    }
+    AiaSequenceNumber_t sequenceNumber =
+        AiaLoopback_ReadLe( message, sizeof( sequenceNumber ) );
+    const uint8_t* iv = message + sizeof( AiaSequenceNumber_t );
+    const uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    size_t encryptedLength =
+        messageLength - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    uint8_t plaintext[ encryptedLength ];
+
+    uint64_t startNs = AiaBenchmark_GetTimeNs();
+    if( !AiaSecretManager_Decrypt(
+            g_serviceSecretManager, AIA_TOPIC_MICROPHONE, sequenceNumber,
+            message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+            encryptedLength, plaintext, iv, AIA_COMMON_HEADER_IV_SIZE, mac,
+            AIA_COMMON_HEADER_MAC_SIZE ) )
+    {
+        AiaLogError( "AiaSecretManager_Decrypt failed, sequenceNumber=%" PRIu32,
+                     sequenceNumber );
+        return;
+    }
+    AiaLoopback_AddCryptoTime( startNs );
+
+    size_t position = sizeof( AiaSequenceNumber_t );
+    while( position + AIA_SIZE_OF_BINARY_STREAM_HEADER +
+               sizeof( AiaBinaryAudioStreamOffset_t ) <=
+           encryptedLength )
+    {
+        size_t length = AiaLoopback_ReadLe(
+            plaintext + position, sizeof( AiaBinaryMessageLength_t ) );
+        AiaBinaryMessageType_t type =
+            plaintext[ position + sizeof( AiaBinaryMessageLength_t ) ];
+        position += AIA_SIZE_OF_BINARY_STREAM_HEADER;
+        if( length < sizeof( AiaBinaryAudioStreamOffset_t ) ||
+            position + length > encryptedLength )
+        {
+            AiaLogError( "Malformed microphone entry, length=%zu", length );
+            return;
+        }
+        if( type == AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE )
+        {
+            AiaBinaryAudioStreamOffset_t offset = AiaLoopback_ReadLe(
+                plaintext + position, sizeof( AiaBinaryAudioStreamOffset_t ) );
+            size_t audioLength = length - sizeof( offset );
+            uint64_t lastFrame = ( offset + audioLength ) /
+                                     ( AIA_LOOPBACK_MICROPHONE_FRAME_SAMPLES *
+                                       AIA_MICROPHONE_BUFFER_WORD_SIZE ) -
+                                 1;
+            AiaMutex( Lock )( &loopbackClient->mutex );
+            uint64_t capturedNs =
+                loopbackClient->microphoneCapturedNs
+                    [ lastFrame % AIA_LOOPBACK_TIMESTAMP_RING_SIZE ];
+            AiaMutex( Unlock )( &loopbackClient->mutex );
+            AiaLoopback_Record( AIA_LOOPBACK_STAGE_MICROPHONE_PUBLISHED,
+                                capturedNs, publishedNs );
+        }
+        position += length;
+    }
+}
+
+/**
+ * Consumes a message published by a client, as an @c
+ * AiaNetworkImpairmentDeliverCallback_t.
+ *
+ * @param topic The topic the message was published on.
+ * @param topicLength The length of @c topic.
+ * @param message The message.
+ * @param messageLength The length of @c message.
+ * @param userData The @c AiaLoopbackClient_t that published the message.
+ */
+static void AiaLoopback_Consume( const char* topic, size_t topicLength,
+                                 const void* message, size_t messageLength,
+                                 void* userData )
+{
+    AiaLoopbackClient_t* loopbackClient = userData;
+    AiaTopic_t parsedTopic;
+    if( topicLength < g_deviceTopicRootSize ||
+        strncmp( topic, g_deviceTopicRoot, g_deviceTopicRootSize ) ||
+        !AiaTopic_FromString( topic + g_deviceTopicRootSize,
+                              topicLength - g_deviceTopicRootSize,
+                              &parsedTopic ) )
+    {
+        AiaLogError( "Unexpected topic %.*s", (int)topicLength, topic );
+        return;
+    }
+    AiaAtomic_Add_u32( &g_publishCounts[ parsedTopic ], 1 );
+
+    switch( parsedTopic )
+    {
+        case AIA_TOPIC_CONNECTION_FROM_CLIENT:
+        {
+            /* Copies made by the links are not null-terminated. */
+            char text[ messageLength + 1 ];
+            memcpy( text, message, messageLength );
+            text[ messageLength ] = '\0';
+            if( strstr( text, "\"Connect\"" ) )
+            {
+                /* Acknowledge from the driver, once the client has armed its
+                 * acknowledgement timeout. */
+                AiaAtomicBool_Set( &loopbackClient->ackPending );
+            }
+            break;
+        }
+        case AIA_TOPIC_MICROPHONE:
+            AiaLoopback_ConsumeMicrophone( loopbackClient, message,
+                                           messageLength );
+            break;
+        default:
+            break;
+    }
+}
+
+/** The broker side of every client's publishes. */
+bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
+                     const char* topic, size_t topicLength, const void* message,
+                     size_t messageLength )
+{
+    (void)qos;
+    AiaLoopbackClient_t* loopbackClient = (AiaLoopbackClient_t*)connection;
+    topicLength = topicLength ? topicLength : strlen( topic );
+    messageLength = messageLength ? messageLength : strlen( message );
+    if( loopbackClient->uplink )
+    {
+        return AiaNetworkImpairment_Submit(
+            loopbackClient->uplink, AiaClock( GetTimeMs )(), topic,
+            topicLength, message, messageLength );
+    }
+    AiaLoopback_Consume( topic, topicLength, message, messageLength,
+                         loopbackClient );
+    return true;
+}
+
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/** Publishes in place the same way as @c AiaMqttPublish(). */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                           messageLength );
+}
+#endif
+
+/** Records the handler a client subscribes with; all topics share one. */
+IotMqttError_t __wrap_IotMqtt_TimedSubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)flags;
+    (void)timeoutMs;
+    AiaLoopbackClient_t* loopbackClient = (AiaLoopbackClient_t*)mqttConnection;
+    for( size_t i = 0; i < subscriptionCount; ++i )
+    {
+        loopbackClient->mqttHandler.handler =
+            pSubscriptionList[ i ].callback.function;
+        loopbackClient->mqttHandler.userData =
+            pSubscriptionList[ i ].callback.pCallbackContext;
+    }
+    return IOT_MQTT_SUCCESS;
+}
+
+/** Unsubscribing is a no-op; delivery stops when the driver stops. */
+IotMqttError_t __wrap_IotMqtt_TimedUnsubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)mqttConnection;
+    (void)pSubscriptionList;
+    (void)subscriptionCount;
+    (void)flags;
+    (void)timeoutMs;
+    return IOT_MQTT_SUCCESS;
+}
+
+/** @c AiaConnectionManageronConnectionSuccessCallback_t */
+static void AiaLoopback_OnConnectionSuccess( void* userData )
+{
+    AiaAtomicBool_Set( &( (AiaLoopbackClient_t*)userData )->connected );
+}
+
+/** @c AiaConnectionManagerOnConnectionRejectionCallback_t */
+static void AiaLoopback_OnConnectionRejected(
+    void* userData, AiaConnectionOnConnectionRejectionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Connection rejected, code=%d", code );
+}
+
+/** @c AiaConnectionManagerOnDisconnectedCallback_t */
+static void AiaLoopback_OnDisconnected(
+    void* userData, AiaConnectionOnDisconnectCode_t code )
+{
+    AiaAtomicBool_Clear( &( (AiaLoopbackClient_t*)userData )->connected );
+    AiaLogError( "Disconnected, code=%d", code );
+}
+
+/** @c AiaExceptionManagerOnExceptionCallback_t */
+static void AiaLoopback_OnException( void* userData, AiaExceptionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Exception received, code=%d", code );
+}
+
+/** @c AiaCapabilitiesObserver_t */
+static void AiaLoopback_OnCapabilitiesStateChanged(
+    AiaCapabilitiesSenderState_t state, const char* description,
+    size_t descriptionLen, void* userData )
+{
+    (void)state;
+    (void)description;
+    (void)descriptionLen;
+    (void)userData;
+}
+
+/** @c AiaUXStateObserverCb_t */
+static void AiaLoopback_OnUXStateChanged( AiaUXState_t state, void* userData )
+{
+    (void)state;
+    (void)userData;
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/** @c AiaPlaySpeakerData_t recording when each frame is played. */
+static bool AiaLoopback_PlaySpeakerData( const void* buf, size_t size,
+                                         void* userData )
+{
+    uint64_t playedNs = AiaBenchmark_GetTimeNs();
+    AiaLoopbackClient_t* loopbackClient = userData;
+    if( size < sizeof( uint32_t ) )
+    {
+        return true;
+    }
+    uint32_t frame = AiaLoopback_ReadLe( buf, sizeof( uint32_t ) );
+    AiaMutex( Lock )( &loopbackClient->mutex );
+    uint64_t bufferedNs =
+        loopbackClient
+            ->speakerBufferedNs[ frame % AIA_LOOPBACK_TIMESTAMP_RING_SIZE ];
+    AiaMutex( Unlock )( &loopbackClient->mutex );
+    AiaLoopback_Record( AIA_LOOPBACK_STAGE_SPEAKER_PLAYED, bufferedNs,
+                        playedNs );
+    return true;
+}
+
+/** @c AiaSetVolume_t recording when a @c SetVolume directive is applied. */
+static void AiaLoopback_SetVolume( uint8_t volume, void* userData )
+{
+    uint64_t appliedNs = AiaBenchmark_GetTimeNs();
+    AiaLoopbackClient_t* loopbackClient = userData;
+    AiaMutex( Lock )( &loopbackClient->mutex );
+    uint64_t receivedNs = 0;
+    if( volume == loopbackClient->pendingVolume )
+    {
+        receivedNs = loopbackClient->directiveReceivedNs;
+        loopbackClient->directiveReceivedNs = 0;
+    }
+    AiaMutex( Unlock )( &loopbackClient->mutex );
+    AiaLoopback_Record( AIA_LOOPBACK_STAGE_DIRECTIVE_APPLIED, receivedNs,
+                        appliedNs );
+}
+
+/** @c AiaOfflineAlertPlayback_t */
+static bool AiaLoopback_PlayOfflineAlert( const AiaAlertSlot_t* offlineAlert,
+                                          void* userData )
+{
+    (void)offlineAlert;
+    (void)userData;
+    return true;
+}
+
+/** @c AiaOfflineAlertStop_t */
+static bool AiaLoopback_StopOfflineAlert( void* userData )
+{
+    (void)userData;
+    return true;
+}
+#endif
+
+/**
+ * Destroys a client and its microphone stream.
+ *
+ * @param loopbackClient The client to destroy, which may be partially
+ * created.
+ */
+static void AiaLoopback_DestroyClient( AiaLoopbackClient_t* loopbackClient )
+{
+    if( !loopbackClient )
+    {
+        return;
+    }
+    if( loopbackClient->client )
+    {
+#ifdef AIA_ENABLE_MICROPHONE
+        AiaClient_CloseMicrophone( loopbackClient->client );
+#endif
+        AiaClient_Destroy( loopbackClient->client );
+    }
+    AiaNetworkImpairment_Destroy( loopbackClient->uplink );
+    AiaNetworkImpairment_Destroy( loopbackClient->downlink );
+    if( loopbackClient->microphoneReader )
+    {
+        AiaDataStreamReader_Destroy( loopbackClient->microphoneReader );
+    }
+    if( loopbackClient->microphoneWriter )
+    {
+        AiaDataStreamWriter_Destroy( loopbackClient->microphoneWriter );
+    }
+    if( loopbackClient->microphoneStream )
+    {
+        AiaDataStreamBuffer_Destroy( loopbackClient->microphoneStream );
+    }
+    AiaFree( loopbackClient->microphoneBuffer );
+    AiaMutex( Destroy )( &loopbackClient->mutex );
+    AiaFree( loopbackClient );
+}
+
+/**
+ * Creates a client on a fake connection.
+ *
+ * @param index The index of the client, from which the seeds of its links are
+ * derived so that runs are repeatable.
+ * @return The new client, or @c NULL on failure.
+ */
+static AiaLoopbackClient_t* AiaLoopback_CreateClient( size_t index )
+{
+    AiaLoopbackClient_t* loopbackClient =
+        AiaCalloc( 1, sizeof( AiaLoopbackClient_t ) );
+    if( !loopbackClient )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaLoopbackClient_t ) );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &loopbackClient->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed" );
+        AiaFree( loopbackClient );
+        return NULL;
+    }
+
+    size_t bufferSize = AIA_LOOPBACK_MICROPHONE_BUFFER_SAMPLES *
+                        AIA_MICROPHONE_BUFFER_WORD_SIZE;
+    loopbackClient->microphoneBuffer = AiaCalloc( 1, bufferSize );
+    loopbackClient->microphoneStream =
+        loopbackClient->microphoneBuffer
+            ? AiaDataStreamBuffer_Create( loopbackClient->microphoneBuffer,
+                                          bufferSize,
+                                          AIA_MICROPHONE_BUFFER_WORD_SIZE, 1 )
+            : NULL;
+    if( loopbackClient->microphoneStream )
+    {
+        loopbackClient->microphoneReader = AiaDataStreamBuffer_CreateReader(
+            loopbackClient->microphoneStream,
+            AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+        loopbackClient->microphoneWriter = AiaDataStreamBuffer_CreateWriter(
+            loopbackClient->microphoneStream,
+            AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    }
+    if( !loopbackClient->microphoneReader || !loopbackClient->microphoneWriter )
+    {
+        AiaLogError( "Failed to create the microphone stream" );
+        AiaLoopback_DestroyClient( loopbackClient );
+        return NULL;
+    }
+
+    loopbackClient->mqttHandler.connection =
+        (AiaMqttConnectionPointer_t)loopbackClient;
+    if( g_isImpaired )
+    {
+        loopbackClient->downlink = AiaNetworkImpairment_Create(
+            &g_impairmentProfile, index * 2 + 1,
+            AiaNetworkImpairment_DeliverToMqttHandler,
+            &loopbackClient->mqttHandler );
+        loopbackClient->uplink = AiaNetworkImpairment_Create(
+            &g_impairmentProfile, index * 2 + 2, AiaLoopback_Consume,
+            loopbackClient );
+        if( !loopbackClient->downlink || !loopbackClient->uplink )
+        {
+            AiaLogError( "Failed to create the network links" );
+            AiaLoopback_DestroyClient( loopbackClient );
+            return NULL;
+        }
+    }
+
+    /* The client never looks inside its connection, so it is handed the
+     * loopback client for the overridden MQTT functions to use. */
+    loopbackClient->client = AiaClient_Create(
+        (AiaMqttConnectionPointer_t)loopbackClient,
+        AiaLoopback_OnConnectionSuccess, AiaLoopback_OnConnectionRejected,
+        AiaLoopback_OnDisconnected, loopbackClient,
+        AiaTaskPool( GetSystemTaskPool )(), AiaLoopback_OnException, NULL,
+        AiaLoopback_OnCapabilitiesStateChanged, NULL
+#ifdef AIA_ENABLE_SPEAKER
+        ,
+        AiaLoopback_PlaySpeakerData, loopbackClient, AiaLoopback_SetVolume,
+        loopbackClient, AiaLoopback_PlayOfflineAlert, NULL,
+        AiaLoopback_StopOfflineAlert, NULL
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+        ,
+        NULL
+#endif
+#endif
+        ,
+        AiaLoopback_OnUXStateChanged, NULL
+#ifdef AIA_ENABLE_MICROPHONE
+        ,
+        loopbackClient->microphoneReader
+#endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        ,
+        NULL
+#endif#ifdef AIA_ENABLE_MQTT_MUX
+        ,
+        NULL
+#endif
+    );
+    if( !loopbackClient->client )
+    {
+        AiaLogError( "AiaClient_Create failed" );
+        AiaLoopback_DestroyClient( loopbackClient );
+        return NULL;
+    }
+    return loopbackClient;
+}
+
+/**
+ * Connects a client and waits for the driver to acknowledge it.
+ *
+ * @param loopbackClient The client to connect.
+ * @return @c true if the client connected, else @c false.
+ */
+static bool AiaLoopback_Connect( AiaLoopbackClient_t* loopbackClient )
+{
+    if( !AiaClient_Connect( loopbackClient->client ) )
+    {
+        AiaLogError( "AiaClient_Connect failed" );
+        return false;
+    }
+    for( AiaDurationMs_t waitedMs = 0;
+         !AiaAtomicBool_Load( &loopbackClient->connected );
+         waitedMs += AIA_LOOPBACK_TICK_MS )
+    {
+        if( waitedMs >= AIA_LOOPBACK_CONNECT_TIMEOUT_MS )
+        {
+            AiaLogError( "Timed out waiting for the connection" );
+            return false;
+        }
+        AiaClock( SleepMs )( AIA_LOOPBACK_TICK_MS );
+    }
+    return true;
+}
+
+/** @return The CPU time used by the process so far, in microseconds. */
+static uint64_t AiaLoopback_GetCpuTimeUs()
+{
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) )
+    {
+        return 0;
+    }
+    return ( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000ull +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/**
+ * Prints the results of a run.
+ *
+ * @param numClients The number of clients run.
+ * @param durationS The number of seconds measured.
+ * @param cpuUs The CPU time used while measuring.
+ * @param cryptoNs The time spent by the broker on cryptography while
+ * measuring.
+ */
+static void AiaLoopback_Report( size_t numClients, unsigned int durationS,
+                                uint64_t cpuUs, uint64_t cryptoNs )
+{
+    printf( "%-32s %10s %10s %10s %10s %10s %10s\n", "stage (us)", "count",
+            "mean", "p50", "p90", "p99", "max" );
+    for( size_t stage = 0; stage < AIA_LOOPBACK_NUM_STAGES; ++stage )
+    {
+        AiaLoopbackHistogram_t* histogram = &g_histograms[ stage ];
+        AiaMutex( Lock )( &histogram->mutex );
+        printf( "%-32s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+                " %10" PRIu64 " %10" PRIu64 "\n",
+                AIA_LOOPBACK_STAGE_NAMES[ stage ], histogram->count,
+                histogram->count ? histogram->sumUs / histogram->count : 0,
+                AiaLoopback_Percentile( histogram, 50 ),
+                AiaLoopback_Percentile( histogram, 90 ),
+                AiaLoopback_Percentile( histogram, 99 ), histogram->maxUs );
+        AiaMutex( Unlock )( &histogram->mutex );
+    }
+
+    uint64_t wallUs = durationS * 1000000ull;
+    printf( "\nclients=%zu duration=%us late ticks=%" PRIu32 "\n", numClients,
+            durationS, AiaAtomic_Load_u32( &g_lateTicks ) );
+    printf( "cpu: total=%.1f%% per client=%.2f%% (broker crypto=%.1f%%)\n",
+            100.0 * cpuUs / wallUs, 100.0 * cpuUs / wallUs / numClients,
+            100.0 * cryptoNs / 1000 / wallUs );
+    printf( "published: event=%" PRIu32 " microphone=%" PRIu32 "\n",
+            AiaAtomic_Load_u32( &g_publishCounts[ AIA_TOPIC_EVENT ] ),
+            AiaAtomic_Load_u32( &g_publishCounts[ AIA_TOPIC_MICROPHONE ] ) );
+}
+
+/**
+ * Prints the heap used by the clients while measuring, relative to the heap in
+ * use before they were created.
+ *
+ * @param numClients The number of clients run.
+ * @param baselineBytes The heap in use before the clients were created.
+ * @param peakBytes The most heap sampled in use while measuring.
+ * @param steadyBytes The heap in use at the end of the measurement.
+ */
+static void AiaLoopback_ReportHeap( size_t numClients, uint64_t baselineBytes,
+                                    uint64_t peakBytes, uint64_t steadyBytes )
+{
+    if( !baselineBytes )
+    {
+        return;
+    }
+    peakBytes = peakBytes > baselineBytes ? peakBytes - baselineBytes : 0;
+    steadyBytes =
+        steadyBytes > baselineBytes ? steadyBytes - baselineBytes : 0;
+    printf( "heap: peak=%" PRIu64 " steady=%" PRIu64
+            " per client peak=%" PRIu64 " steady=%" PRIu64 "\n",
+            peakBytes, steadyBytes, peakBytes / numClients,
+            steadyBytes / numClients );
+}
+
+/**
+ * Adds the counters of one direction of a client's connection to a total.
+ *
+ * @param impairment The link to read.
+ * @param[in,out] total The totals to add to.
+ */
+static void AiaLoopback_AddLinkStats( AiaNetworkImpairment_t* impairment,
+                                      AiaNetworkImpairmentStats_t* total )
+{
+    AiaNetworkImpairmentStats_t stats;
+    AiaNetworkImpairment_GetStats( impairment, &stats );
+    total->submitted += stats.submitted;
+    total->dropped += stats.dropped;
+    total->duplicated += stats.duplicated;
+    total->reordered += stats.reordered;
+    total->delivered += stats.delivered;
+    if( stats.maxDelayMs > total->maxDelayMs )
+    {
+        total->maxDelayMs = stats.maxDelayMs;
+    }
+}
+
+/**
+ * Prints the counters kept by the clients and their links since they were
+ * created, which show how the clients coped with the network.
+ *
+ * @param clients The clients run.
+ * @param numClients The number of clients run.
+ */
+static void AiaLoopback_ReportClients( AiaLoopbackClient_t** clients,
+                                       size_t numClients )
+{
+    AiaNetworkImpairmentStats_t links[ 2 ];
+    memset( links, 0, sizeof( links ) );
+#ifdef AIA_ENABLE_SPEAKER
+    uint32_t underruns = 0, buffered = 0, dropped = 0, timeouts = 0;
+#endif
+    for( size_t i = 0; i < numClients; ++i )
+    {
+        if( g_isImpaired )
+        {
+            AiaLoopback_AddLinkStats( clients[ i ]->downlink, &links[ 0 ] );
+            AiaLoopback_AddLinkStats( clients[ i ]->uplink, &links[ 1 ] );
+        }
+#ifdef AIA_ENABLE_SPEAKER
+        AiaClientMetrics_t metrics;
+        if( AiaClient_GetMetrics( clients[ i ]->client, &metrics ) )
+        {
+            underruns += metrics.speaker.underruns;
+            buffered += metrics.speakerSequencer.messagesBuffered;
+            dropped += metrics.speakerSequencer.messagesDropped;
+            timeouts += metrics.speakerSequencer.timeoutsExpired;
+        }
+#endif
+    }
+
+#ifdef AIA_ENABLE_SPEAKER
+    printf( "speaker: underruns=%" PRIu32 " reordered=%" PRIu32
+            " dropped=%" PRIu32 " timeouts=%" PRIu32 "\n",
+            underruns, buffered, dropped, timeouts );
+#endif
+    static const char* const LINK_NAMES[] = { "downlink", "uplink" };
+    for( size_t i = 0; g_isImpaired && i < AiaArrayLength( links ); ++i )
+    {
+        printf( "%s: sent=%" PRIu32 " lost=%" PRIu32 " duplicated=%" PRIu32
+                " reordered=%" PRIu32 " delivered=%" PRIu32
+                " max delay=%" PRIu32 "ms\n",
+                LINK_NAMES[ i ], links[ i ].submitted, links[ i ].dropped,
+                links[ i ].duplicated, links[ i ].reordered,
+                links[ i ].delivered, links[ i ].maxDelayMs );
+    }
+}
+
+/**
+ * Parses a positive integer command line value.
+ *
+ * @param value The value to parse.
+ * @param[out] result The parsed value.
+ * @return @c true if @c value was a positive integer, else @c false.
+ */
+static bool AiaLoopback_ParseCount( const char* value, size_t* result )
+{
+    char* end;
+    *result = strtoul( value, &end, 10 );
+    return *end == '\0' && *result;
+}
+
+/**
+ * Parses command line arguments.
+ *
+ * @param argc Number of arguments passed to main().
+ * @param argv Arguments vector passed to main().
+ * @param[out] numClients The number of clients to run.
+ * @param[out] durationS The number of seconds to measure.
+ * @param[out] numShards The number of driver timers to spread clients over.
+ * @return @c true if the arguments were valid, else @c false.
+ * @note @c -n sets @c g_impairmentProfile and @c g_isImpaired.
+ */
+static bool AiaLoopback_ParseArguments( int argc, char** argv,
+                                        size_t* numClients, size_t* durationS,
+                                        size_t* numShards )
+{
+    *numClients = AIA_LOOPBACK_DEFAULT_CLIENTS;
+    *durationS = AIA_LOOPBACK_DEFAULT_DURATION_S;
+    *numShards = AIA_LOOPBACK_DEFAULT_SHARDS;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        const char* option = argv[ i ];
+        if( option[ 0 ] != '-' || option[ 1 ] == '\0' || option[ 2 ] != '\0' ||
+            i + 1 >= argc )
+        {
+            return false;
+        }
+        const char* value = argv[ ++i ];
+        switch( option[ 1 ] )
+        {
+            /* Number of concurrent clients. */
+            case 'c':
+                if( !AiaLoopback_ParseCount( value, numClients ) )
+                {
+                    return false;
+                }
+                break;
+
+            /* Number of seconds to measure for. */
+            case 'd':
+                if( !AiaLoopback_ParseCount( value, durationS ) )
+                {
+                    return false;
+                }
+                break;
+
+            /* Number of driver timers. */
+            case 's':
+                if( !AiaLoopback_ParseCount( value, numShards ) )
+                {
+                    return false;
+                }
+                break;
+
+            /* Network profile to simulate. */
+            case 'n':
+                if( !AiaNetworkImpairment_GetProfile( value,
+                                                      &g_impairmentProfile ) )
+                {
+                    return false;
+                }
+                g_isImpaired = true;
+                break;
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Runs the load test once the process has been initialized.
+ *
+ * @param numClients The number of clients to run.
+ * @param durationS The number of seconds to measure.
+ * @param numShards The number of driver timers to spread clients over.
+ * @return @c true if every client connected and was run, else @c false.
+ */
+static bool AiaLoopback_Run( size_t numClients, size_t durationS,
+                             size_t numShards )
+{
+    numShards = numShards < numClients ? numShards : numClients;
+    uint64_t baselineHeapBytes = AiaBenchmark_GetHeapInUse();
+    AiaLoopbackClient_t** clients =
+        AiaCalloc( numClients, sizeof( AiaLoopbackClient_t* ) );
+    AiaLoopbackShard_t* shards =
+        AiaCalloc( numShards, sizeof( AiaLoopbackShard_t ) );
+    bool success = clients && shards;
+    for( size_t i = 0; success && i < numShards; ++i )
+    {
+        shards[ i ].clients = clients + i * numClients / numShards;
+        shards[ i ].numClients =
+            ( i + 1 ) * numClients / numShards - i * numClients / numShards;
+    }
+    for( size_t i = 0; success && i < numClients; ++i )
+    {
+        clients[ i ] = AiaLoopback_CreateClient( i );
+        success = clients[ i ] != NULL;
+    }
+
+    size_t numTimers = 0;
+    for( ; success && numTimers < numShards; ++numTimers )
+    {
+        AiaLoopbackShard_t* shard = &shards[ numTimers ];
+        if( !AiaTimer( Create )( &shard->timer, AiaLoopback_Tick, shard ) )
+        {
+            AiaLogError( "AiaTimer( Create ) failed" );
+            success = false;
+            break;
+        }
+        if( !AiaTimer( Arm )( &shard->timer, AIA_LOOPBACK_TICK_MS,
+                              AIA_LOOPBACK_TICK_MS ) )
+        {
+            AiaLogError( "AiaTimer( Arm ) failed" );
+            AiaTimer( Destroy )( &shard->timer );
+            success = false;
+            break;
+        }
+    }
+
+    /* The connection manager keeps its acknowledgement timeout in static job
+     * storage, so clients are connected one at a time. */
+    for( size_t i = 0; success && i < numClients; ++i )
+    {
+        success = AiaLoopback_Connect( clients[ i ] );
+    }
+
+    if( success )
+    {
+        /* Let every client open its speaker and microphone before
+         * measuring. */
+        AiaClock( SleepMs )( 1000 );
+        AiaAtomic_Store_u32( &g_lateTicks, 0 );
+        AiaMutex( Lock )( &g_brokerCryptoMutex );
+        g_brokerCryptoNs = 0;
+        AiaMutex( Unlock )( &g_brokerCryptoMutex );
+        uint64_t startCpuUs = AiaLoopback_GetCpuTimeUs();
+        uint64_t peakHeapBytes = 0;
+        AiaAtomicBool_Set( &g_measuring );
+        for( size_t elapsedMs = 0; elapsedMs < durationS * 1000;
+             elapsedMs += AIA_LOOPBACK_HEAP_SAMPLE_MS )
+        {
+            AiaClock( SleepMs )( AIA_LOOPBACK_HEAP_SAMPLE_MS );
+            uint64_t heapBytes = AiaBenchmark_GetHeapInUse();
+            peakHeapBytes =
+                heapBytes > peakHeapBytes ? heapBytes : peakHeapBytes;
+        }
+        AiaAtomicBool_Clear( &g_measuring );
+        uint64_t cpuUs = AiaLoopback_GetCpuTimeUs() - startCpuUs;
+        uint64_t steadyHeapBytes = AiaBenchmark_GetHeapInUse();
+        AiaMutex( Lock )( &g_brokerCryptoMutex );
+        uint64_t cryptoNs = g_brokerCryptoNs;
+        AiaMutex( Unlock )( &g_brokerCryptoMutex );
+        AiaLoopback_Report( numClients, durationS, cpuUs, cryptoNs );
+        AiaLoopback_ReportHeap( numClients, baselineHeapBytes, peakHeapBytes,
+                                steadyHeapBytes );
+        AiaLoopback_ReportClients( clients, numClients );
+    }
+
+    /* Stop driving the clients, then wait out any tick in flight. */
+    for( size_t i = 0; i < numTimers; ++i )
+    {
+        AiaTimer( Destroy )( &shards[ i ].timer );
+        while( AiaAtomicBool_Load( &shards[ i ].ticking ) )
+        {
+            AiaClock( SleepMs )( 1 );
+        }
+    }
+    for( size_t i = 0; clients && i < numClients; ++i )
+    {
+        AiaLoopback_DestroyClient( clients[ i ] );
+    }
+    AiaFree( shards );
+    AiaFree( clients );
+    return success;
+}
+
+int main( int argc, char** argv )
+{
+    size_t numClients, durationS, numShards;
+    if( !AiaLoopback_ParseArguments( argc, argv, &numClients, &durationS,
+                                     &numShards ) )
+    {
+        fprintf( stderr,
+                 "Usage: %s [-c <clients>] [-d <seconds>] [-s <shards>] "
+                 "[-n none|good-wifi|congested-wifi|lossy-wifi]\n",
+                 argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    AiaMbedtlsThreading_Init();
+    AiaRandomMbedtls_Init();
+    if( !AiaRandomMbedtls_Seed( NULL, 0 ) )
+    {
+        AiaLogError( "AiaRandomMbedtls_Seed failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    if( !AiaCryptoMbedtls_Init() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Init failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    AiaTaskPoolInfo_t taskPoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskPoolInfo );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateSystemTaskPool ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        AiaCryptoMbedtls_Cleanup();
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+
+    bool success = AiaMutex( Create )( &g_brokerCryptoMutex, false );
+    for( size_t i = 0; success && i < AIA_LOOPBACK_NUM_STAGES; ++i )
+    {
+        success = AiaMutex( Create )( &g_histograms[ i ].mutex, false );
+    }
+
+    /* Every client shares one identity, and the broker shares its secret. */
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    bool provisioned =
+        success && AiaBenchmark_ProvisionDevice( storageFolder );
+    g_serviceSecretManager =
+        provisioned ? AiaBenchmark_CreateSecretManager() : NULL;
+    g_deviceTopicRootSize = AiaGetDeviceTopicRootString( NULL, 0 );
+    g_deviceTopicRoot = g_deviceTopicRootSize
+                            ? AiaCalloc( 1, g_deviceTopicRootSize )
+                            : NULL;
+    success = g_serviceSecretManager && g_deviceTopicRoot &&
+              AiaGetDeviceTopicRootString( g_deviceTopicRoot,
+                                           g_deviceTopicRootSize );
+    if( success )
+    {
+        success = AiaLoopback_Run( numClients, durationS, numShards );
+    }
+    else
+    {
+        AiaLogError( "Failed to set up the broker" );
+    }
+
+    AiaFree( g_deviceTopicRoot );
+    AiaSecretManager_Destroy( g_serviceSecretManager );
+    if( provisioned )
+    {
+        AiaBenchmark_RemoveDevice( storageFolder );
+    }
+    AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    AiaCryptoMbedtls_Cleanup();
+    AiaRandomMbedtls_Cleanup();
+    AiaMbedtlsThreading_Cleanup();
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
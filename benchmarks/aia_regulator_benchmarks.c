@@ -0,0 +1,133 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_regulator_benchmarks.c
+ * @brief Benchmarks for AiaRegulator_Write() and the emission it triggers.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiacore/aia_json_message.h>
+#include <aiaregulator/aia_regulator.h>
+
+#include AiaClock( HEADER )
+
+/** The maximum size of an MQTT message on the event topic. */
+#define AIA_REGULATOR_BENCHMARK_MAX_MESSAGE_SIZE 5000
+
+/** How long to wait for the regulator to emit everything before failing. */
+#define AIA_REGULATOR_BENCHMARK_EMIT_TIMEOUT_MS 60000
+
+/** A typical event payload. */
+static const char* AIA_REGULATOR_BENCHMARK_PAYLOAD =
+    "{\"token\":\"91a3c9d4-7e0b-4f5c-8d2a-6b1e0f3c4a57\","
+    "\"offset\":1234567,\"reason\":\"MEDIA_ERROR\","
+    "\"description\":\"buffer underrun while streaming\"}";
+
+/** @c AiaRegulatorEmitMessageChunkCallback_t counting and freeing chunks. */
+static bool AiaRegulatorBenchmark_EmitMessageChunk(
+    AiaRegulatorChunk_t* chunk, size_t remainingBytes, size_t remainingChunks,
+    void* userData )
+{
+    (void)remainingBytes;
+    (void)remainingChunks;
+    AiaJsonMessage_Destroy( AiaJsonMessage_FromMessage( chunk ) );
+    AiaAtomic_Add_u32( (uint32_t*)userData, 1 );
+    return true;
+}
+
+/** @c AiaRegulatorDestroyChunkCallback_t for chunks left in the regulator. */
+static void AiaRegulatorBenchmark_DestroyChunk( AiaRegulatorChunk_t* chunk,
+                                                void* userData )
+{
+    (void)userData;
+    AiaJsonMessage_Destroy( AiaJsonMessage_FromMessage( chunk ) );
+}
+
+/**
+ * Writes @c benchmark->iterations event chunks and waits for all of them to
+ * be emitted. The regulator runs in its default @c AIA_REGULATOR_TRICKLE mode
+ * without a minimum wait, so that the time measured is spent in the regulator
+ * rather than waiting on it.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData Unused.
+ * @return @c true if every chunk was written and emitted, else @c false.
+ */
+static bool AiaRegulatorBenchmark_WriteAndEmit( AiaBenchmark_t* benchmark,
+                                                void* userData )
+{
+    (void)userData;
+    size_t iterations = benchmark->iterations;
+    uint32_t emitted = 0;
+
+    AiaRegulator_t* regulator = AiaRegulator_Create(
+        AIA_REGULATOR_BENCHMARK_MAX_MESSAGE_SIZE,
+        AiaRegulatorBenchmark_EmitMessageChunk, &emitted, 0 );
+    AiaRegulatorChunk_t** chunks =
+        AiaCalloc( iterations, sizeof( AiaRegulatorChunk_t* ) );
+    bool success = regulator && chunks;
+    for( size_t i = 0; success && i < iterations; ++i )
+    {
+        AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create(
+            "PlaybackFailed", NULL, AIA_REGULATOR_BENCHMARK_PAYLOAD );
+        chunks[ i ] = AiaJsonMessage_ToMessage( jsonMessage );
+        success = jsonMessage != NULL;
+    }
+
+    if( success )
+    {
+        AiaBenchmark_StartTimer( benchmark );
+        for( size_t i = 0; success && i < iterations; ++i )
+        {
+            success = AiaRegulator_Write( regulator, chunks[ i ] );
+            if( success )
+            {
+                chunks[ i ] = NULL;
+            }
+        }
+        AiaDurationMs_t waitedMs = 0;
+        while( success && AiaAtomic_Load_u32( &emitted ) < iterations )
+        {
+            if( waitedMs++ == AIA_REGULATOR_BENCHMARK_EMIT_TIMEOUT_MS )
+            {
+                AiaLogError( "Timed out waiting for the regulator to emit." );
+                success = false;
+                break;
+            }
+            AiaClock( SleepMs )( 1 );
+        }
+        AiaBenchmark_StopTimer( benchmark );
+    }
+
+    AiaRegulator_Destroy( regulator, AiaRegulatorBenchmark_DestroyChunk, NULL );
+    for( size_t i = 0; chunks && i < iterations; ++i )
+    {
+        if( chunks[ i ] )
+        {
+            AiaJsonMessage_Destroy( AiaJsonMessage_FromMessage( chunks[ i ] ) );
+        }
+    }
+    AiaFree( chunks );
+    return success;
+}
+
+bool RunAiaRegulatorBenchmarks( const AiaBenchmarkOptions_t* options )
+{
+    return AiaBenchmark_Run( options, "Regulator/WriteAndEmit",
+                             AiaRegulatorBenchmark_WriteAndEmit, NULL );
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_sequencer_benchmarks.c
+ * @brief Benchmarks for AiaSequencer_Write().
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiasequencer/aia_sequencer.h>
+
+#include AiaTaskPool( HEADER )
+
+#include <stdio.h>
+#include <string.h>
+
+/** The size of each sequenced message, including its sequence number. */
+#define AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE 256
+
+/** Enough slots to hold a message that arrived ahead of its predecessor. */
+#define AIA_SEQUENCER_BENCHMARK_MAX_SLOTS 4
+
+/** Long enough that the timeout never fires during a run. */
+#define AIA_SEQUENCER_BENCHMARK_TIMEOUT_MS 60000
+
+/** Fixed seed, so that every run reorders the same messages. */
+#define AIA_SEQUENCER_BENCHMARK_SEED 0x5eed
+
+/** Parameters of a sequencer benchmark. */
+typedef struct AiaSequencerBenchmarkParams
+{
+    /** Whether to hand message ownership over with @c
+     * AiaSequencer_WriteAndAdopt() rather than copy with @c
+     * AiaSequencer_Write(). */
+    bool adopt;
+} AiaSequencerBenchmarkParams_t;
+
+/** @c AiaSequencerMessageSequencedCallback_t counting emitted messages. */
+static void AiaSequencerBenchmark_OnMessageSequenced( void* message,
+                                                     size_t size,
+                                                     void* userData )
+{
+    (void)message;
+    (void)size;
+    ++*(size_t*)userData;
+}
+
+/** @c AiaSequencerTimeoutExpiredCallback_t which should never be called. */
+static void AiaSequencerBenchmark_OnTimeoutExpired( void* userData )
+{
+    (void)userData;
+    AiaLogError( "Sequencer timed out" );
+}
+
+/** @c AiaSequencerGetSequencerNumberCallback_t reading the leading sequence
+ * number of a message. */
+static bool AiaSequencerBenchmark_GetSequenceNumber(
+    AiaSequenceNumber_t* sequenceNumber, void* message, size_t size,
+    void* userData )
+{
+    (void)userData;
+    if( size < sizeof( *sequenceNumber ) )
+    {
+        return false;
+    }
+    memcpy( sequenceNumber, message, sizeof( *sequenceNumber ) );
+    return true;
+}
+
+/**
+ * Writes @c benchmark->iterations messages, swapping adjacent pairs of them
+ * with probability @c reorderPercent, and checks that all of them were
+ * emitted.
+ *
+ * @param benchmark The benchmark being run.
+ * @param userData The @c AiaSequencerBenchmarkParams_t to run with.
+ * @return @c true if every message was sequenced, else @c false.
+ */
+static bool AiaSequencerBenchmark_Write( AiaBenchmark_t* benchmark,
+                                         void* userData )
+{
+    const AiaSequencerBenchmarkParams_t* params = userData;
+    size_t iterations = benchmark->iterations;
+    size_t sequenced = 0;
+
+    AiaSequenceNumber_t* order =
+        AiaCalloc( iterations, sizeof( AiaSequenceNumber_t ) );
+    uint8_t** messages = AiaCalloc( iterations, sizeof( uint8_t* ) );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        AiaSequencerBenchmark_OnMessageSequenced, &sequenced,
+        AiaSequencerBenchmark_OnTimeoutExpired, NULL,
+        AiaSequencerBenchmark_GetSequenceNumber, NULL,
+        AIA_SEQUENCER_BENCHMARK_MAX_SLOTS, 0,
+        AIA_SEQUENCER_BENCHMARK_TIMEOUT_MS,
+        AiaTaskPool( GetSystemTaskPool )() );
+    bool success = order && messages && sequencer;
+
+    /* Build the delivery order and the messages outside of the timer. */
+    uint32_t random = AIA_SEQUENCER_BENCHMARK_SEED;
+    for( size_t i = 0; success && i < iterations; ++i )
+    {
+        order[ i ] = i;
+        if( i > 0 && order[ i - 1 ] == i - 1 &&
+            AiaBenchmark_NextRandom( &random ) % 100 <
+                benchmark->options->reorderPercent )
+        {
+            order[ i - 1 ] = i;
+            order[ i ] = i - 1;
+        }
+    }
+    for( size_t i = 0; success && i < iterations; ++i )
+    {
+        messages[ i ] = AiaCalloc( 1, AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE );
+        if( !messages[ i ] )
+        {
+            success = false;
+            break;
+        }
+        memset( messages[ i ], 0x5a, AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE );
+        memcpy( messages[ i ], &order[ i ], sizeof( order[ i ] ) );
+    }
+
+    if( success )
+    {
+        AiaBenchmark_StartTimer( benchmark );
+        for( size_t i = 0; success && i < iterations; ++i )
+        {
+            if( params->adopt )
+            {
+                success = AiaSequencer_WriteAndAdopt(
+                    sequencer, messages[ i ],
+                    AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE );
+                messages[ i ] = NULL;
+            }
+            else
+            {
+                success = AiaSequencer_Write(
+                    sequencer, messages[ i ],
+                    AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE );
+            }
+        }
+        AiaBenchmark_StopTimer( benchmark );
+        success = success && sequenced == iterations;
+    }
+
+    AiaSequencer_Destroy( sequencer );
+    for( size_t i = 0; messages && i < iterations; ++i )
+    {
+        AiaFree( messages[ i ] );
+    }
+    AiaFree( messages );
+    AiaFree( order );
+    return success;
+}
+
+bool RunAiaSequencerBenchmarks( const AiaBenchmarkOptions_t* options )
+{
+    AiaSequencerBenchmarkParams_t copy = { false };
+    AiaSequencerBenchmarkParams_t adopt = { true };
+    char name[ 64 ];
+
+    snprintf( name, sizeof( name ), "Sequencer/Write/%dB/Reorder%u%%",
+              AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE, options->reorderPercent );
+    bool success =
+        AiaBenchmark_Run( options, name, AiaSequencerBenchmark_Write, &copy );
+
+    snprintf( name, sizeof( name ), "Sequencer/WriteAndAdopt/%dB/Reorder%u%%",
+              AIA_SEQUENCER_BENCHMARK_MESSAGE_SIZE, options->reorderPercent );
+    success = AiaBenchmark_Run( options, name, AiaSequencerBenchmark_Write,
+                                &adopt ) &&
+              success;
+    return success;
+}
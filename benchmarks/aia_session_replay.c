@@ -0,0 +1,590 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_session_replay.c
+ * @brief Replays a recorded session through an @c AiaClient_t.
+ *
+ * Builds with @c AIA_ENABLE_SESSION_RECORDING can record the plaintext of
+ * every message the service sends, which the sample app writes to @c
+ * aia_session.trace. This driver creates a client on a fake connection,
+ * connects it and hands it each recorded message in turn with @c
+ * AiaClient_ReplayMessage(), at the pace they were recorded or, with @c -f, as
+ * fast as the client takes them. Messages are neither sequenced nor
+ * decrypted again, so the time measured per message is that of parsing it and
+ * of the managers handling it. Everything the client publishes is counted and
+ * discarded.
+ *
+ * The client is given a fresh device identity, so replies it would have sent
+ * the service differ from the recorded session's, but its handling of the
+ * messages themselves does not.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiaclient/aia_client.h>
+#include <aiacore/aia_crypto_mbedtls.h>
+#include <aiacore/aia_mbedtls_threading.h>
+#include <aiacore/aia_random_mbedtls.h>
+#include <aiacore/aia_session_trace.h>
+#include <aiacore/aia_topic.h>
+#include <aiacore/aia_utils.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiamicrophonemanager/aia_microphone_constants.h>
+
+#include AiaClock( HEADER )
+#include AiaTaskPool( HEADER )
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** How long to let the client run after the last record, for buffered speaker
+ * audio to play out and events to be published. */
+#define AIA_REPLAY_SETTLE_MS 1000
+
+/** The size of the microphone buffer the client is given, which is never
+ * written to. */
+#define AIA_REPLAY_MICROPHONE_BUFFER_SIZE 3200
+
+/** Timing of the records replayed on one topic. */
+typedef struct AiaReplayTopicStats
+{
+    /** The number of records replayed. */
+    uint32_t count;
+
+    /** The number of records the client failed to handle. */
+    uint32_t failed;
+
+    /** The total size of the payloads replayed. */
+    uint64_t bytes;
+
+    /** The total time spent handling the records. */
+    uint64_t totalNs;
+
+    /** The longest time spent handling one record. */
+    uint64_t maxNs;
+} AiaReplayTopicStats_t;
+
+/** The fake connection the client is given. */
+typedef struct AiaReplayConnection
+{
+    /** Whether the client has been acknowledged. */
+    AiaAtomicBool_t connected;
+
+    /** The number of messages the client published on each topic. */
+    uint32_t publishCounts[ AIA_NUM_TOPICS ];
+} AiaReplayConnection_t;
+
+/** The device topic root, which prefixes every topic published to. */
+static char* g_deviceTopicRoot;
+static size_t g_deviceTopicRootSize;
+
+/** Counts everything a client publishes. */
+bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
+                     const char* topic, size_t topicLength, const void* message,
+                     size_t messageLength )
+{
+    (void)qos;
+    (void)message;
+    (void)messageLength;
+    AiaReplayConnection_t* replayConnection =
+        (AiaReplayConnection_t*)connection;
+    topicLength = topicLength ? topicLength : strlen( topic );
+    AiaTopic_t parsedTopic;
+    if( topicLength < g_deviceTopicRootSize ||
+        strncmp( topic, g_deviceTopicRoot, g_deviceTopicRootSize ) ||
+        !AiaTopic_FromString( topic + g_deviceTopicRootSize,
+                              topicLength - g_deviceTopicRootSize,
+                              &parsedTopic ) )
+    {
+        AiaLogError( "Unexpected topic %.*s", (int)topicLength, topic );
+        return true;
+    }
+    AiaAtomic_Add_u32( &replayConnection->publishCounts[ parsedTopic ], 1 );
+    return true;
+}
+
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/** Publishes in place the same way as @c AiaMqttPublish(). */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                           messageLength );
+}
+#endif
+
+/** Subscribing is a no-op; messages are replayed, not received. */
+IotMqttError_t __wrap_IotMqtt_TimedSubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)mqttConnection;
+    (void)pSubscriptionList;
+    (void)subscriptionCount;
+    (void)flags;
+    (void)timeoutMs;
+    return IOT_MQTT_SUCCESS;
+}
+
+/** Unsubscribing is a no-op; messages are replayed, not received. */
+IotMqttError_t __wrap_IotMqtt_TimedUnsubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)mqttConnection;
+    (void)pSubscriptionList;
+    (void)subscriptionCount;
+    (void)flags;
+    (void)timeoutMs;
+    return IOT_MQTT_SUCCESS;
+}
+
+/** @c AiaConnectionManageronConnectionSuccessCallback_t */
+static void AiaReplay_OnConnectionSuccess( void* userData )
+{
+    AiaAtomicBool_Set( &( (AiaReplayConnection_t*)userData )->connected );
+}
+
+/** @c AiaConnectionManagerOnConnectionRejectionCallback_t */
+static void AiaReplay_OnConnectionRejected(
+    void* userData, AiaConnectionOnConnectionRejectionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Connection rejected, code=%d", code );
+}
+
+/** @c AiaConnectionManagerOnDisconnectedCallback_t */
+static void AiaReplay_OnDisconnected( void* userData,
+                                      AiaConnectionOnDisconnectCode_t code )
+{
+    AiaAtomicBool_Clear( &( (AiaReplayConnection_t*)userData )->connected );
+    AiaLogInfo( "Disconnected, code=%d", code );
+}
+
+/** @c AiaExceptionManagerOnExceptionCallback_t */
+static void AiaReplay_OnException( void* userData, AiaExceptionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Exception received, code=%d", code );
+}
+
+/** @c AiaCapabilitiesObserver_t */
+static void AiaReplay_OnCapabilitiesStateChanged(
+    AiaCapabilitiesSenderState_t state, const char* description,
+    size_t descriptionLen, void* userData )
+{
+    (void)state;
+    (void)description;
+    (void)descriptionLen;
+    (void)userData;
+}
+
+/** @c AiaUXStateObserverCb_t */
+static void AiaReplay_OnUXStateChanged( AiaUXState_t state, void* userData )
+{
+    (void)state;
+    (void)userData;
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/** @c AiaPlaySpeakerData_t accepting every frame. */
+static bool AiaReplay_PlaySpeakerData( const void* buf, size_t size,
+                                       void* userData )
+{
+    (void)buf;
+    (void)size;
+    (void)userData;
+    return true;
+}
+
+/** @c AiaSetVolume_t */
+static void AiaReplay_SetVolume( uint8_t volume, void* userData )
+{
+    (void)volume;
+    (void)userData;
+}
+
+/** @c AiaOfflineAlertPlayback_t */
+static bool AiaReplay_PlayOfflineAlert( const AiaAlertSlot_t* offlineAlert,
+                                        void* userData )
+{
+    (void)offlineAlert;
+    (void)userData;
+    return true;
+}
+
+/** @c AiaOfflineAlertStop_t */
+static bool AiaReplay_StopOfflineAlert( void* userData )
+{
+    (void)userData;
+    return true;
+}
+#endif
+
+/**
+ * Reads a whole file into memory.
+ *
+ * @param path The file to read.
+ * @param[out] size The size of the file.
+ * @return The contents of the file, to be released with @c AiaFree(), or @c
+ * NULL on failure.
+ */
+static uint8_t* AiaReplay_ReadFile( const char* path, size_t* size )
+{
+    FILE* file = fopen( path, "rb" );
+    if( !file )
+    {
+        AiaLogError( "Failed to open %s", path );
+        return NULL;
+    }
+    long length = -1;
+    if( !fseek( file, 0, SEEK_END ) )
+    {
+        length = ftell( file );
+    }
+    uint8_t* contents = NULL;
+    if( length >= 0 && !fseek( file, 0, SEEK_SET ) )
+    {
+        contents = AiaCalloc( 1, length ? length : 1 );
+    }
+    if( contents &&
+        fread( contents, 1, (size_t)length, file ) != (size_t)length )
+    {
+        AiaFree( contents );
+        contents = NULL;
+    }
+    fclose( file );
+    if( !contents )
+    {
+        AiaLogError( "Failed to read %s", path );
+        return NULL;
+    }
+    *size = (size_t)length;
+    return contents;
+}
+
+/**
+ * Replays every record of a trace.
+ *
+ * @param client The client to replay to.
+ * @param trace The trace.
+ * @param size The size of @c trace.
+ * @param isPaced Whether to keep the delays between records.
+ * @param[out] topicStats Timing of the records replayed on each topic.
+ * @return @c true if the whole trace was read, else @c false.
+ */
+static bool AiaReplay_Run( AiaClient_t* client, const uint8_t* trace,
+                           size_t size, bool isPaced,
+                           AiaReplayTopicStats_t* topicStats )
+{
+    size_t position = AiaSessionTrace_ReadHeader( trace, size );
+    if( !position )
+    {
+        return false;
+    }
+
+    AiaTimepointMs_t dueMs = AiaClock( GetTimeMs )();
+    bool isFirst = true;
+    while( position < size )
+    {
+        AiaSessionTraceRecord_t record;
+        size_t recordSize = AiaSessionTrace_ReadRecord(
+            trace + position, size - position, &record );
+        if( !recordSize )
+        {
+            AiaLogError( "Malformed record, offset=%zu.", position );
+            return false;
+        }
+        position += recordSize;
+
+        /* The first delay covers the time before the recorded client
+         * connected, which has already passed here. Later records are due
+         * relative to it, so slow handling is caught up on. */
+        if( isPaced && !isFirst )
+        {
+            dueMs += record.delayMs;
+            AiaTimepointMs_t nowMs = AiaClock( GetTimeMs )();
+            if( dueMs > nowMs )
+            {
+                AiaClock( SleepMs )( dueMs - nowMs );
+            }
+        }
+        isFirst = false;
+
+        uint64_t startNs = AiaBenchmark_GetTimeNs();
+        bool handled = AiaClient_ReplayMessage( client, &record );
+        uint64_t elapsedNs = AiaBenchmark_GetTimeNs() - startNs;
+
+        AiaReplayTopicStats_t* stats = &topicStats[ record.topic ];
+        stats->count++;
+        stats->failed += !handled;
+        stats->bytes += record.payloadSize;
+        stats->totalNs += elapsedNs;
+        stats->maxNs = elapsedNs > stats->maxNs ? elapsedNs : stats->maxNs;
+    }
+    return true;
+}
+
+/**
+ * Prints the results of a replay.
+ *
+ * @param client The client replayed to.
+ * @param connection The client's connection.
+ * @param topicStats Timing of the records replayed on each topic.
+ * @param wallNs The time the replay took.
+ */
+static void AiaReplay_Report( AiaClient_t* client,
+                              AiaReplayConnection_t* connection,
+                              const AiaReplayTopicStats_t* topicStats,
+                              uint64_t wallNs )
+{
+    printf( "%-24s %10s %10s %12s %10s %10s\n", "topic", "records", "failed",
+            "bytes", "mean (us)", "max (us)" );
+    uint64_t handlingNs = 0;
+    for( size_t topic = 0; topic < AIA_NUM_TOPICS; ++topic )
+    {
+        const AiaReplayTopicStats_t* stats = &topicStats[ topic ];
+        if( !stats->count )
+        {
+            continue;
+        }
+        handlingNs += stats->totalNs;
+        printf( "%-24s %10" PRIu32 " %10" PRIu32 " %12" PRIu64 " %10" PRIu64
+                " %10" PRIu64 "\n",
+                AiaTopic_ToString( (AiaTopic_t)topic ), stats->count,
+                stats->failed, stats->bytes,
+                stats->totalNs / stats->count / 1000, stats->maxNs / 1000 );
+    }
+
+    printf( "\nreplay took %.3fs, of which handling %.3fs\n", wallNs / 1e9,
+            handlingNs / 1e9 );
+    printf( "published: event=%" PRIu32 " microphone=%" PRIu32 "\n",
+            AiaAtomic_Load_u32(
+                &connection->publishCounts[ AIA_TOPIC_EVENT ] ),
+            AiaAtomic_Load_u32(
+                &connection->publishCounts[ AIA_TOPIC_MICROPHONE ] ) );
+#ifdef AIA_ENABLE_SPEAKER
+    AiaClientMetrics_t metrics;
+    if( AiaClient_GetMetrics( client, &metrics ) )
+    {
+        printf( "speaker: underruns=%" PRIu32 " overruns=%" PRIu32 "\n",
+                metrics.speaker.underruns, metrics.speaker.overruns );
+    }
+#else
+    (void)client;
+#endif
+}
+
+/**
+ * Replays a trace through a new client.
+ *
+ * @param trace The trace.
+ * @param size The size of @c trace.
+ * @param isPaced Whether to keep the delays between records.
+ * @return @c true if the whole trace was replayed, else @c false.
+ */
+static bool AiaReplay_Session( const uint8_t* trace, size_t size,
+                               bool isPaced )
+{
+    AiaReplayConnection_t connection;
+    memset( &connection, 0, sizeof( connection ) );
+
+    uint8_t microphoneBuffer[ AIA_REPLAY_MICROPHONE_BUFFER_SIZE ];
+    AiaDataStreamBuffer_t* microphoneStream = AiaDataStreamBuffer_Create(
+        microphoneBuffer, sizeof( microphoneBuffer ),
+        AIA_MICROPHONE_BUFFER_WORD_SIZE, 1 );
+    AiaDataStreamReader_t* microphoneReader =
+        microphoneStream ? AiaDataStreamBuffer_CreateReader(
+                               microphoneStream,
+                               AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true )
+                         : NULL;
+    if( !microphoneReader )
+    {
+        AiaLogError( "Failed to create the microphone stream" );
+        if( microphoneStream )
+        {
+            AiaDataStreamBuffer_Destroy( microphoneStream );
+        }
+        return false;
+    }
+
+    /* The client never looks inside its connection, so it is handed the
+     * counters for the overridden MQTT functions to use. */
+    AiaClient_t* client = AiaClient_Create(
+        (AiaMqttConnectionPointer_t)&connection, AiaReplay_OnConnectionSuccess,
+        AiaReplay_OnConnectionRejected, AiaReplay_OnDisconnected, &connection,
+        AiaTaskPool( GetSystemTaskPool )(), AiaReplay_OnException, NULL,
+        AiaReplay_OnCapabilitiesStateChanged, NULL
+#ifdef AIA_ENABLE_SPEAKER
+        ,
+        AiaReplay_PlaySpeakerData, NULL, AiaReplay_SetVolume, NULL,
+        AiaReplay_PlayOfflineAlert, NULL, AiaReplay_StopOfflineAlert, NULL
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+        ,
+        NULL
+#endif
+#endif
+        ,
+        AiaReplay_OnUXStateChanged, NULL
+#ifdef AIA_ENABLE_MICROPHONE
+        ,
+        microphoneReader
+#endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        ,
+        NULL
+#endif#ifdef AIA_ENABLE_MQTT_MUX
+        ,
+        NULL
+#endif
+    );
+
+    bool success = client != NULL;
+    if( !success )
+    {
+        AiaLogError( "AiaClient_Create failed" );
+    }
+    else if( !AiaClient_Connect( client ) )
+    {
+        AiaLogError( "AiaClient_Connect failed" );
+        success = false;
+    }
+
+    if( success )
+    {
+        /* The recorded acknowledgement is replayed like any other message. */
+        AiaReplayTopicStats_t topicStats[ AIA_NUM_TOPICS ];
+        memset( topicStats, 0, sizeof( topicStats ) );
+        uint64_t startNs = AiaBenchmark_GetTimeNs();
+        success = AiaReplay_Run( client, trace, size, isPaced, topicStats );
+        uint64_t wallNs = AiaBenchmark_GetTimeNs() - startNs;
+        if( !AiaAtomicBool_Load( &connection.connected ) )
+        {
+            AiaLogWarn( "Not connected at the end of the trace" );
+        }
+        AiaClock( SleepMs )( AIA_REPLAY_SETTLE_MS );
+        AiaReplay_Report( client, &connection, topicStats, wallNs );
+    }
+
+    if( client )
+    {
+#ifdef AIA_ENABLE_MICROPHONE
+        AiaClient_CloseMicrophone( client );
+#endif
+        AiaClient_Destroy( client );
+    }
+    AiaDataStreamReader_Destroy( microphoneReader );
+    AiaDataStreamBuffer_Destroy( microphoneStream );
+    return success;
+}
+
+int main( int argc, char** argv )
+{
+    bool isPaced = true;
+    const char* path = NULL;
+    if( argc == 3 && !strcmp( argv[ 1 ], "-f" ) )
+    {
+        isPaced = false;
+        path = argv[ 2 ];
+    }
+    else if( argc == 2 && argv[ 1 ][ 0 ] != '-' )
+    {
+        path = argv[ 1 ];
+    }
+    if( !path )
+    {
+        fprintf( stderr, "Usage: %s [-f] <session trace>\n", argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    size_t traceSize = 0;
+    uint8_t* trace = AiaReplay_ReadFile( path, &traceSize );
+    if( !trace )
+    {
+        return EXIT_FAILURE;
+    }
+
+    AiaMbedtlsThreading_Init();
+    AiaRandomMbedtls_Init();
+    if( !AiaRandomMbedtls_Seed( NULL, 0 ) )
+    {
+        AiaLogError( "AiaRandomMbedtls_Seed failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        AiaFree( trace );
+        return EXIT_FAILURE;
+    }
+    if( !AiaCryptoMbedtls_Init() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Init failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        AiaFree( trace );
+        return EXIT_FAILURE;
+    }
+    AiaTaskPoolInfo_t taskPoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskPoolInfo );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateSystemTaskPool ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        AiaCryptoMbedtls_Cleanup();
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        AiaFree( trace );
+        return EXIT_FAILURE;
+    }
+
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    bool provisioned = AiaBenchmark_ProvisionDevice( storageFolder );
+    g_deviceTopicRootSize =
+        provisioned ? AiaGetDeviceTopicRootString( NULL, 0 ) : 0;
+    g_deviceTopicRoot = g_deviceTopicRootSize
+                            ? AiaCalloc( 1, g_deviceTopicRootSize )
+                            : NULL;
+    bool success = g_deviceTopicRoot &&
+                   AiaGetDeviceTopicRootString( g_deviceTopicRoot,
+                                                g_deviceTopicRootSize );
+    if( success )
+    {
+        success = AiaReplay_Session( trace, traceSize, isPaced );
+    }
+    else
+    {
+        AiaLogError( "Failed to provision the device" );
+    }
+
+    AiaFree( g_deviceTopicRoot );
+    if( provisioned )
+    {
+        AiaBenchmark_RemoveDevice( storageFolder );
+    }
+    AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    AiaCryptoMbedtls_Cleanup();
+    AiaRandomMbedtls_Cleanup();
+    AiaMbedtlsThreading_Cleanup();
+    AiaFree( trace );
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,1044 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_startup_latency.c
+ * @brief Measures the time from @c AiaInit() to a client being ready.
+ *
+ * Each iteration initializes the SDK, creates a client and calls @c
+ * AiaClient_ConnectAndBootstrap() against an in-process broker which is
+ * reached over simulated links adding half the round-trip time given with
+ * @c -r in each direction. The broker acknowledges the connection, accepts
+ * capabilities and, once it receives the @c SynchronizeState event, the
+ * client is counted as ready. The time to ready is broken down into the SDK's
+ * initialization, the creation of the client, with each of the phases marked
+ * by @c aia_startup_trace.h, the connection, the acceptance of capabilities
+ * and the @c SynchronizeState event.
+ *
+ * By default every iteration is a cold start on a freshly provisioned device.
+ * With @c -w, the device is provisioned once and primed with an unmeasured
+ * iteration, so that capabilities have already been accepted and are not
+ * published again.
+ */
+
+#include "aia_benchmark.h"
+
+#include <aiaclient/aia_client.h>
+#include <aiacore/aia_crypto_mbedtls.h>
+#include <aiacore/aia_init.h>
+#include <aiacore/aia_mbedtls_threading.h>
+#include <aiacore/aia_message_constants.h>
+#include <aiacore/aia_random_mbedtls.h>
+#include <aiacore/aia_startup_trace.h>
+#include <aiacore/aia_topic.h>
+#include <aiacore/aia_utils.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
+#include <aiamicrophonemanager/aia_microphone_constants.h>
+#include <aianetworkimpairment/aia_network_impairment.h>
+#include <aiasecretmanager/aia_secret_manager.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaTaskPool( HEADER )
+#include AiaTimer( HEADER )
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of iterations measured when @c -i is not given. */
+#define AIA_STARTUP_DEFAULT_ITERATIONS 20
+
+/** The round-trip time to the broker when @c -r is not given. */
+#define AIA_STARTUP_DEFAULT_RTT_MS 50
+
+/** The period at which the links to the broker are polled. */
+#define AIA_STARTUP_POLL_MS 1
+
+/** How long to wait for a client to be ready before giving up. */
+#define AIA_STARTUP_READY_TIMEOUT_MS 15000
+
+/** The size of the microphone buffer each client is given, which is never
+ * written to. */
+#define AIA_STARTUP_MICROPHONE_BUFFER_SIZE 3200
+
+/** The stages the time to ready is broken down into. */
+typedef enum AiaStartupStage
+{
+    /** @c AiaInit(). */
+    AIA_STARTUP_STAGE_INIT,
+
+    /** @c AiaClient_Create(). */
+    AIA_STARTUP_STAGE_CREATE,
+
+    /** From connecting to the connection being acknowledged. */
+    AIA_STARTUP_STAGE_CONNECT,
+
+    /** From the connection being acknowledged to capabilities being
+     * accepted, on cold starts only. */
+    AIA_STARTUP_STAGE_CAPABILITIES,
+
+    /** From the last of the above to the broker receiving @c
+     * SynchronizeState. */
+    AIA_STARTUP_STAGE_SYNCHRONIZE_STATE,
+
+    /** From calling @c AiaInit() to the broker receiving @c
+     * SynchronizeState. */
+    AIA_STARTUP_STAGE_READY,
+
+    /** The number of stages. */
+    AIA_STARTUP_NUM_STAGES
+} AiaStartupStage_t;
+
+/** Names of the stages, indexed by @c AiaStartupStage_t. */
+static const char* const AIA_STARTUP_STAGE_NAMES[] = {
+    "init", "create", "connect", "capabilities", "synchronize state", "ready"
+};
+
+/** Timing of a stage or phase over every iteration. */
+typedef struct AiaStartupStats
+{
+    /** The number of times the stage was timed. */
+    uint32_t count;
+
+    /** The total, shortest and longest time taken. */
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+} AiaStartupStats_t;
+
+/** A client being started and the broker's state for it. */
+typedef struct AiaStartupRun
+{
+    /** The client being started. */
+    AiaClient_t* client;
+
+    /** The handler the client subscribed with. */
+    AiaNetworkImpairmentMqttHandler_t mqttHandler;
+
+    /** The simulated links from and to the broker. */
+    AiaNetworkImpairment_t* downlink;
+    AiaNetworkImpairment_t* uplink;
+
+    /** The timer polling the links. */
+    AiaTimer_t driver;
+
+    /** Set while the links are being polled. */
+    AiaAtomicBool_t polling;
+
+    /** The service's side of the shared secret. */
+    AiaSecretManager_t* serviceSecretManager;
+
+    /** The next sequence number the broker sends capabilities
+     * acknowledgements with, only used by the driver. */
+    AiaSequenceNumber_t nextAcknowledgeSequenceNumber;
+
+    /** @name Times at which the client got to each stage, in nanoseconds, or
+     * zero until it does. Synchronized by @c g_statsMutex. */
+    /** @{ */
+    uint64_t connectedNs;
+    uint64_t acceptedNs;
+    uint64_t readyNs;
+    /** @} */
+} AiaStartupRun_t;
+
+/** Serializes access to the statistics below and to the times in @c
+ * AiaStartupRun_t. */
+static AiaMutex_t g_statsMutex;
+
+/** Timing of each stage, indexed by @c AiaStartupStage_t. */
+static AiaStartupStats_t g_stageStats[ AIA_STARTUP_NUM_STAGES ];
+
+/** Timing of each phase, indexed by @c AiaStartupPhase_t. */
+static AiaStartupStats_t g_phaseStats[ AIA_NUM_STARTUP_PHASES ];
+
+/** The time each phase last began at, indexed by @c AiaStartupPhase_t. */
+static uint64_t g_phaseBeginNs[ AIA_NUM_STARTUP_PHASES ];
+
+/** Set while iterations are being measured rather than primed. */
+static AiaAtomicBool_t g_measuring;
+
+/** The device topic root, which prefixes every topic published to. */
+static char* g_deviceTopicRoot;
+static size_t g_deviceTopicRootSize;
+
+/** Adds a time to the statistics. Must be called with @c g_statsMutex held. */
+static void AiaStartup_AddLocked( AiaStartupStats_t* stats, uint64_t elapsedNs )
+{
+    stats->minNs = !stats->count || elapsedNs < stats->minNs ? elapsedNs
+                                                             : stats->minNs;
+    stats->maxNs = elapsedNs > stats->maxNs ? elapsedNs : stats->maxNs;
+    stats->totalNs += elapsedNs;
+    stats->count++;
+}
+
+/** Sets @c *timeNs to the current time if it has not been set already. */
+static void AiaStartup_Mark( uint64_t* timeNs )
+{
+    uint64_t nowNs = AiaBenchmark_GetTimeNs();
+    AiaMutex( Lock )( &g_statsMutex );
+    *timeNs = *timeNs ? *timeNs : nowNs;
+    AiaMutex( Unlock )( &g_statsMutex );
+}
+
+/** @c AiaStartupTraceObserver_t */
+static void AiaStartup_OnPhase( AiaStartupPhase_t phase, bool isEnd,
+                                void* userData )
+{
+    (void)userData;
+    uint64_t nowNs = AiaBenchmark_GetTimeNs();
+    AiaMutex( Lock )( &g_statsMutex );
+    if( !isEnd )
+    {
+        g_phaseBeginNs[ phase ] = nowNs;
+    }
+    else if( AiaAtomicBool_Load( &g_measuring ) && g_phaseBeginNs[ phase ] )
+    {
+        AiaStartup_AddLocked( &g_phaseStats[ phase ],
+                              nowNs - g_phaseBeginNs[ phase ] );
+    }
+    AiaMutex( Unlock )( &g_statsMutex );
+}
+
+/** Writes @c value to @c buffer in little-endian order. */
+static void AiaStartup_WriteLe( uint8_t* buffer, uint64_t value, size_t size )
+{
+    for( size_t i = 0; i < size; ++i )
+    {
+        buffer[ i ] = value >> ( i * 8 );
+    }
+}
+
+/** @return The little-endian value of @c size bytes at @c buffer. */
+static uint64_t AiaStartup_ReadLe( const uint8_t* buffer, size_t size )
+{
+    uint64_t value = 0;
+    for( size_t i = 0; i < size; ++i )
+    {
+        value |= (uint64_t)buffer[ i ] << ( i * 8 );
+    }
+    return value;
+}
+
+/**
+ * Sends a message from the broker to the client over the downlink.
+ *
+ * @param run The client to send to.
+ * @param topic The topic the message is on.
+ * @param payload The message.
+ * @param payloadLength The length of @c payload.
+ */
+static void AiaStartup_Deliver( AiaStartupRun_t* run, AiaTopic_t topic,
+                                const void* payload, size_t payloadLength )
+{
+    size_t topicNameLength =
+        g_deviceTopicRootSize + AiaTopic_GetLength( topic );
+    char topicName[ topicNameLength ];
+    memcpy( topicName, g_deviceTopicRoot, g_deviceTopicRootSize );
+    memcpy( topicName + g_deviceTopicRootSize, AiaTopic_ToString( topic ),
+            AiaTopic_GetLength( topic ) );
+    AiaNetworkImpairment_Submit( run->downlink, AiaClock( GetTimeMs )(),
+                                 topicName, topicNameLength, payload,
+                                 payloadLength );
+}
+
+/**
+ * Accepts the capabilities the client published, as the service would.
+ *
+ * @param run The client to acknowledge.
+ */
+static void AiaStartup_AcceptCapabilities( AiaStartupRun_t* run )
+{
+    static const char* ACK =
+        "{\"header\":{\"name\":\"Acknowledge\",\"messageId\":\"0\"},"
+        "\"payload\":{\"publishMessageId\":\"0\","
+        "\"code\":\"CAPABILITIES_ACCEPTED\"}}";
+    size_t bodyLength = strlen( ACK );
+    AiaSequenceNumber_t sequenceNumber = run->nextAcknowledgeSequenceNumber++;
+    size_t messageLength = AIA_SIZE_OF_COMMON_HEADER + bodyLength;
+    uint8_t message[ messageLength ];
+    uint8_t* iv = message + sizeof( AiaSequenceNumber_t );
+    uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    uint8_t* encrypted = message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    AiaStartup_WriteLe( message, sequenceNumber, sizeof( sequenceNumber ) );
+    AiaStartup_WriteLe( encrypted, sequenceNumber, sizeof( sequenceNumber ) );
+    memcpy( encrypted + sizeof( sequenceNumber ), ACK, bodyLength );
+    if( !AiaSecretManager_Encrypt(
+            run->serviceSecretManager, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE,
+            sequenceNumber, encrypted,
+            messageLength - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+            encrypted, iv, AIA_COMMON_HEADER_IV_SIZE, mac,
+            AIA_COMMON_HEADER_MAC_SIZE ) )
+    {
+        AiaLogError( "AiaSecretManager_Encrypt failed" );
+        return;
+    }
+    AiaStartup_Deliver( run, AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE, message,
+                        messageLength );
+}
+
+/**
+ * Decrypts an event message published by the client and marks the client
+ * ready if it holds a @c SynchronizeState event.
+ *
+ * @param run The client that published the message.
+ * @param message The encrypted message.
+ * @param messageLength The length of @c message.
+ */
+static void AiaStartup_ConsumeEvent( AiaStartupRun_t* run,
+                                     const uint8_t* message,
+                                     size_t messageLength )
+{
+    if( messageLength < AIA_SIZE_OF_COMMON_HEADER )
+    {
+        AiaLogError( "Event message too short, length=%zu", messageLength );
+        return;
+    }
+    AiaSequenceNumber_t sequenceNumber =
+        AiaStartup_ReadLe( message, sizeof( sequenceNumber ) );
+    const uint8_t* iv = message + sizeof( AiaSequenceNumber_t );
+    const uint8_t* mac = iv + AIA_COMMON_HEADER_IV_SIZE;
+    size_t encryptedLength =
+        messageLength - AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET;
+    char plaintext[ encryptedLength + 1 ];
+    if( !AiaSecretManager_Decrypt(
+            run->serviceSecretManager, AIA_TOPIC_EVENT, sequenceNumber,
+            message + AIA_COMMON_HEADER_ENCRYPTED_SEQUENCE_OFFSET,
+            encryptedLength, (uint8_t*)plaintext, iv,
+            AIA_COMMON_HEADER_IV_SIZE, mac, AIA_COMMON_HEADER_MAC_SIZE ) )
+    {
+        AiaLogError( "AiaSecretManager_Decrypt failed, sequenceNumber=%" PRIu32,
+                     sequenceNumber );
+        return;
+    }
+    plaintext[ encryptedLength ] = '\0';
+    if( strstr( plaintext + sizeof( AiaSequenceNumber_t ),
+                "\"SynchronizeState\"" ) )
+    {
+        AiaStartup_Mark( &run->readyNs );
+    }
+}
+
+/**
+ * Consumes a message published by the client, as an @c
+ * AiaNetworkImpairmentDeliverCallback_t.
+ *
+ * @param topic The topic the message was published on.
+ * @param topicLength The length of @c topic.
+ * @param message The message.
+ * @param messageLength The length of @c message.
+ * @param userData The @c AiaStartupRun_t that published the message.
+ */
+static void AiaStartup_Consume( const char* topic, size_t topicLength,
+                                const void* message, size_t messageLength,
+                                void* userData )
+{
+    AiaStartupRun_t* run = userData;
+    AiaTopic_t parsedTopic;
+    if( topicLength < g_deviceTopicRootSize ||
+        strncmp( topic, g_deviceTopicRoot, g_deviceTopicRootSize ) ||
+        !AiaTopic_FromString( topic + g_deviceTopicRootSize,
+                              topicLength - g_deviceTopicRootSize,
+                              &parsedTopic ) )
+    {
+        AiaLogError( "Unexpected topic %.*s", (int)topicLength, topic );
+        return;
+    }
+
+    switch( parsedTopic )
+    {
+        case AIA_TOPIC_CONNECTION_FROM_CLIENT:
+        {
+            static const char* ACK =
+                "{\"header\":{\"name\":\"Acknowledge\",\"messageId\":\"0\"},"
+                "\"payload\":{\"code\":\"CONNECTION_ESTABLISHED\"}}";
+            /* Copies made by the links are not null-terminated. */
+            char text[ messageLength + 1 ];
+            memcpy( text, message, messageLength );
+            text[ messageLength ] = '\0';
+            if( strstr( text, "\"Connect\"" ) )
+            {
+                AiaStartup_Deliver( run, AIA_TOPIC_CONNECTION_FROM_SERVICE,
+                                    ACK, strlen( ACK ) );
+            }
+            break;
+        }
+        case AIA_TOPIC_CAPABILITIES_PUBLISH:
+            AiaStartup_AcceptCapabilities( run );
+            break;
+        case AIA_TOPIC_EVENT:
+            AiaStartup_ConsumeEvent( run, message, messageLength );
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Timer routine polling the links to and from the broker.
+ *
+ * @param userData The @c AiaStartupRun_t to poll.
+ */
+static void AiaStartup_Poll( void* userData )
+{
+    AiaStartupRun_t* run = userData;
+    if( !AiaAtomic_CompareAndSwap_u32( &run->polling, 1, 0 ) )
+    {
+        return;
+    }
+    AiaTimepointMs_t nowMs = AiaClock( GetTimeMs )();
+    AiaNetworkImpairment_Poll( run->uplink, nowMs );
+    AiaNetworkImpairment_Poll( run->downlink, nowMs );
+    AiaAtomicBool_Clear( &run->polling );
+}
+
+/** Sends everything the client publishes over the uplink. */
+bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
+                     const char* topic, size_t topicLength, const void* message,
+                     size_t messageLength )
+{
+    (void)qos;
+    AiaStartupRun_t* run = (AiaStartupRun_t*)connection;
+    topicLength = topicLength ? topicLength : strlen( topic );
+    messageLength = messageLength ? messageLength : strlen( message );
+    return AiaNetworkImpairment_Submit( run->uplink, AiaClock( GetTimeMs )(),
+                                        topic, topicLength, message,
+                                        messageLength );
+}
+
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/** Publishes in place the same way as @c AiaMqttPublish(). */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                           messageLength );
+}
+#endif
+
+/** Records the handler the client subscribes with; all topics share one. */
+IotMqttError_t __wrap_IotMqtt_TimedSubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)flags;
+    (void)timeoutMs;
+    AiaStartupRun_t* run = (AiaStartupRun_t*)mqttConnection;
+    for( size_t i = 0; i < subscriptionCount; ++i )
+    {
+        run->mqttHandler.handler = pSubscriptionList[ i ].callback.function;
+        run->mqttHandler.userData =
+            pSubscriptionList[ i ].callback.pCallbackContext;
+    }
+    return IOT_MQTT_SUCCESS;
+}
+
+/** Unsubscribing is a no-op; delivery stops when the driver stops. */
+IotMqttError_t __wrap_IotMqtt_TimedUnsubscribe(
+    IotMqttConnection_t mqttConnection,
+    const IotMqttSubscription_t* pSubscriptionList, size_t subscriptionCount,
+    uint32_t flags, uint32_t timeoutMs )
+{
+    (void)mqttConnection;
+    (void)pSubscriptionList;
+    (void)subscriptionCount;
+    (void)flags;
+    (void)timeoutMs;
+    return IOT_MQTT_SUCCESS;
+}
+
+/** @c AiaConnectionManageronConnectionSuccessCallback_t */
+static void AiaStartup_OnConnectionSuccess( void* userData )
+{
+    AiaStartup_Mark( &( (AiaStartupRun_t*)userData )->connectedNs );
+}
+
+/** @c AiaConnectionManagerOnConnectionRejectionCallback_t */
+static void AiaStartup_OnConnectionRejected(
+    void* userData, AiaConnectionOnConnectionRejectionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Connection rejected, code=%d", code );
+}
+
+/** @c AiaConnectionManagerOnDisconnectedCallback_t */
+static void AiaStartup_OnDisconnected( void* userData,
+                                       AiaConnectionOnDisconnectCode_t code )
+{
+    (void)userData;
+    AiaLogInfo( "Disconnected, code=%d", code );
+}
+
+/** @c AiaExceptionManagerOnExceptionCallback_t */
+static void AiaStartup_OnException( void* userData, AiaExceptionCode_t code )
+{
+    (void)userData;
+    AiaLogError( "Exception received, code=%d", code );
+}
+
+/** @c AiaCapabilitiesObserver_t */
+static void AiaStartup_OnCapabilitiesStateChanged(
+    AiaCapabilitiesSenderState_t state, const char* description,
+    size_t descriptionLen, void* userData )
+{
+    (void)description;
+    (void)descriptionLen;
+    if( state == AIA_CAPABILITIES_STATE_ACCEPTED )
+    {
+        AiaStartup_Mark( &( (AiaStartupRun_t*)userData )->acceptedNs );
+    }
+}
+
+/** @c AiaUXStateObserverCb_t */
+static void AiaStartup_OnUXStateChanged( AiaUXState_t state, void* userData )
+{
+    (void)state;
+    (void)userData;
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+/** @c AiaPlaySpeakerData_t accepting every frame. */
+static bool AiaStartup_PlaySpeakerData( const void* buf, size_t size,
+                                        void* userData )
+{
+    (void)buf;
+    (void)size;
+    (void)userData;
+    return true;
+}
+
+/** @c AiaSetVolume_t */
+static void AiaStartup_SetVolume( uint8_t volume, void* userData )
+{
+    (void)volume;
+    (void)userData;
+}
+
+/** @c AiaOfflineAlertPlayback_t */
+static bool AiaStartup_PlayOfflineAlert( const AiaAlertSlot_t* offlineAlert,
+                                         void* userData )
+{
+    (void)offlineAlert;
+    (void)userData;
+    return true;
+}
+
+/** @c AiaOfflineAlertStop_t */
+static bool AiaStartup_StopOfflineAlert( void* userData )
+{
+    (void)userData;
+    return true;
+}
+#endif
+
+/**
+ * Waits for a client to be ready.
+ *
+ * @param run The client to wait for.
+ * @return @c true if the client became ready, else @c false.
+ */
+static bool AiaStartup_WaitReady( AiaStartupRun_t* run )
+{
+    for( AiaDurationMs_t waitedMs = 0;; waitedMs += AIA_STARTUP_POLL_MS )
+    {
+        AiaMutex( Lock )( &g_statsMutex );
+        bool isReady = run->readyNs != 0;
+        AiaMutex( Unlock )( &g_statsMutex );
+        if( isReady )
+        {
+            return true;
+        }
+        if( waitedMs >= AIA_STARTUP_READY_TIMEOUT_MS )
+        {
+            AiaLogError( "Timed out waiting for the client to be ready" );
+            return false;
+        }
+        AiaClock( SleepMs )( AIA_STARTUP_POLL_MS );
+    }
+}
+
+/**
+ * Records the stages of a client which became ready.
+ *
+ * @param run The client.
+ * @param initNs The time @c AiaInit() was called.
+ * @param createNs The time @c AiaClient_Create() was called.
+ * @param connectNs The time @c AiaClient_ConnectAndBootstrap() was called.
+ */
+static void AiaStartup_RecordStages( AiaStartupRun_t* run, uint64_t initNs,
+                                     uint64_t createNs, uint64_t connectNs )
+{
+    AiaMutex( Lock )( &g_statsMutex );
+    AiaStartup_AddLocked( &g_stageStats[ AIA_STARTUP_STAGE_INIT ],
+                          createNs - initNs );
+    AiaStartup_AddLocked( &g_stageStats[ AIA_STARTUP_STAGE_CREATE ],
+                          connectNs - createNs );
+    AiaStartup_AddLocked( &g_stageStats[ AIA_STARTUP_STAGE_CONNECT ],
+                          run->connectedNs - connectNs );
+    uint64_t synchronizeNs = run->connectedNs;
+    if( run->acceptedNs )
+    {
+        AiaStartup_AddLocked( &g_stageStats[ AIA_STARTUP_STAGE_CAPABILITIES ],
+                              run->acceptedNs - run->connectedNs );
+        synchronizeNs = run->acceptedNs;
+    }
+    AiaStartup_AddLocked(
+        &g_stageStats[ AIA_STARTUP_STAGE_SYNCHRONIZE_STATE ],
+        run->readyNs - synchronizeNs );
+    AiaStartup_AddLocked( &g_stageStats[ AIA_STARTUP_STAGE_READY ],
+                          run->readyNs - initNs );
+    AiaMutex( Unlock )( &g_statsMutex );
+}
+
+/**
+ * Stops polling a client's links and destroys the client and its links.
+ *
+ * @param run The client to destroy, which may be partially created.
+ * @param isPolling Whether the driver was armed.
+ */
+static void AiaStartup_Stop( AiaStartupRun_t* run, bool isPolling )
+{
+    /* Stop the driver, then wait out any poll in flight. */
+    if( isPolling )
+    {
+        AiaTimer( Destroy )( &run->driver );
+        while( AiaAtomicBool_Load( &run->polling ) )
+        {
+            AiaClock( SleepMs )( 1 );
+        }
+    }
+    if( run->client )
+    {
+#ifdef AIA_ENABLE_MICROPHONE
+        AiaClient_CloseMicrophone( run->client );
+#endif
+        AiaClient_Destroy( run->client );
+    }
+    AiaNetworkImpairment_Destroy( run->uplink );
+    AiaNetworkImpairment_Destroy( run->downlink );
+    if( run->serviceSecretManager )
+    {
+        AiaSecretManager_Destroy( run->serviceSecretManager );
+    }
+}
+
+/**
+ * Starts a client from @c AiaInit() until it is ready, and records the time
+ * each stage took.
+ *
+ * @param rttMs The round-trip time to the broker.
+ * @param microphoneReader The microphone stream to give the client.
+ * @return @c true if the client became ready, else @c false.
+ */
+static bool AiaStartup_RunOnce( AiaDurationMs_t rttMs,
+                                AiaDataStreamReader_t* microphoneReader )
+{
+    AiaStartupRun_t run;
+    memset( &run, 0, sizeof( run ) );
+    AiaNetworkImpairmentProfile_t profile;
+    memset( &profile, 0, sizeof( profile ) );
+    profile.baseDelayMs = rttMs / 2;
+    profile.jitterDistribution = AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM;
+
+    /* The network and the service are not part of the client, so they are
+     * ready before timing starts. */
+    run.mqttHandler.connection = (AiaMqttConnectionPointer_t)&run;
+    run.downlink =
+        AiaNetworkImpairment_Create( &profile, 1,
+                                     AiaNetworkImpairment_DeliverToMqttHandler,
+                                     &run.mqttHandler );
+    run.uplink =
+        AiaNetworkImpairment_Create( &profile, 2, AiaStartup_Consume, &run );
+    run.serviceSecretManager = AiaBenchmark_CreateSecretManager();
+    if( !run.downlink || !run.uplink || !run.serviceSecretManager )
+    {
+        AiaLogError( "Failed to set up the broker" );
+        AiaStartup_Stop( &run, false );
+        return false;
+    }
+    if( !AiaTimer( Create )( &run.driver, AiaStartup_Poll, &run ) )
+    {
+        AiaLogError( "AiaTimer( Create ) failed" );
+        AiaStartup_Stop( &run, false );
+        return false;
+    }
+    if( !AiaTimer( Arm )( &run.driver, AIA_STARTUP_POLL_MS,
+                          AIA_STARTUP_POLL_MS ) )
+    {
+        AiaLogError( "AiaTimer( Arm ) failed" );
+        AiaStartup_Stop( &run, true );
+        return false;
+    }
+
+    uint64_t initNs = AiaBenchmark_GetTimeNs();
+    AiaInit();
+    uint64_t createNs = AiaBenchmark_GetTimeNs();
+    /* The client never looks inside its connection, so it is handed the run
+     * for the overridden MQTT functions to use. */
+    run.client = AiaClient_Create(
+        (AiaMqttConnectionPointer_t)&run, AiaStartup_OnConnectionSuccess,
+        AiaStartup_OnConnectionRejected, AiaStartup_OnDisconnected, &run,
+        AiaTaskPool( GetSystemTaskPool )(), AiaStartup_OnException, NULL,
+        AiaStartup_OnCapabilitiesStateChanged, &run
+#ifdef AIA_ENABLE_SPEAKER
+        ,
+        AiaStartup_PlaySpeakerData, NULL, AiaStartup_SetVolume, NULL,
+        AiaStartup_PlayOfflineAlert, NULL, AiaStartup_StopOfflineAlert, NULL
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+        ,
+        NULL
+#endif
+#endif
+        ,
+        AiaStartup_OnUXStateChanged, NULL
+#ifdef AIA_ENABLE_MICROPHONE
+        ,
+        microphoneReader
+#endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        ,
+        NULL
+#endif#ifdef AIA_ENABLE_MQTT_MUX
+        ,
+        NULL
+#endif
+    );
+#ifndef AIA_ENABLE_MICROPHONE
+    (void)microphoneReader;
+#endif
+    uint64_t connectNs = AiaBenchmark_GetTimeNs();
+
+    bool success = run.client != NULL;
+    if( !success )
+    {
+        AiaLogError( "AiaClient_Create failed" );
+    }
+    else if( !AiaClient_ConnectAndBootstrap( run.client ) )
+    {
+        AiaLogError( "AiaClient_ConnectAndBootstrap failed" );
+        success = false;
+    }
+    else if( AiaStartup_WaitReady( &run ) )
+    {
+        if( AiaAtomicBool_Load( &g_measuring ) )
+        {
+            AiaStartup_RecordStages( &run, initNs, createNs, connectNs );
+        }
+    }
+    else
+    {
+        success = false;
+    }
+
+    AiaStartup_Stop( &run, true );
+    AiaCleanup();
+    return success;
+}
+
+/**
+ * Starts a client on a freshly provisioned device.
+ *
+ * @param rttMs The round-trip time to the broker.
+ * @param microphoneReader The microphone stream to give the client.
+ * @return @c true if the client became ready, else @c false.
+ */
+static bool AiaStartup_RunCold( AiaDurationMs_t rttMs,
+                                AiaDataStreamReader_t* microphoneReader )
+{
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    if( !AiaBenchmark_ProvisionDevice( storageFolder ) )
+    {
+        AiaLogError( "Failed to provision the device" );
+        return false;
+    }
+    bool success = AiaStartup_RunOnce( rttMs, microphoneReader );
+    AiaBenchmark_RemoveDevice( storageFolder );
+    return success;
+}
+
+/** Prints one line of timings. */
+static void AiaStartup_PrintStats( const char* name,
+                                   const AiaStartupStats_t* stats )
+{
+    if( !stats->count )
+    {
+        return;
+    }
+    printf( "%-28s %8" PRIu32 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+            name, stats->count, stats->totalNs / stats->count / 1000,
+            stats->minNs / 1000, stats->maxNs / 1000 );
+}
+
+/**
+ * Prints the time each stage and phase took.
+ *
+ * @param iterations The number of iterations measured.
+ * @param rttMs The round-trip time to the broker.
+ * @param isWarm Whether capabilities had been accepted before each start.
+ */
+static void AiaStartup_Report( size_t iterations, AiaDurationMs_t rttMs,
+                               bool isWarm )
+{
+    printf( "%zu %s starts, rtt=%" PRIu32 "ms\n\n", iterations,
+            isWarm ? "warm" : "cold", (uint32_t)rttMs );
+    printf( "%-28s %8s %10s %10s %10s\n", "stage (us)", "count", "mean", "min",
+            "max" );
+    AiaMutex( Lock )( &g_statsMutex );
+    for( size_t stage = 0; stage < AIA_STARTUP_NUM_STAGES; ++stage )
+    {
+        AiaStartup_PrintStats( AIA_STARTUP_STAGE_NAMES[ stage ],
+                               &g_stageStats[ stage ] );
+        if( stage != AIA_STARTUP_STAGE_CREATE )
+        {
+            continue;
+        }
+        /* Phases are nested in the creation of the client, except for loads
+         * which a component defers until it is first used. */
+        for( size_t phase = 0; phase < AIA_NUM_STARTUP_PHASES; ++phase )
+        {
+            char name[ 32 ];
+            snprintf( name, sizeof( name ), "  %s",
+                      AiaStartupPhase_ToString( (AiaStartupPhase_t)phase ) );
+            AiaStartup_PrintStats( name, &g_phaseStats[ phase ] );
+        }
+    }
+    AiaMutex( Unlock )( &g_statsMutex );
+}
+
+/**
+ * Parses a non-negative integer command line value.
+ *
+ * @param value The value to parse.
+ * @param[out] result The parsed value.
+ * @return @c true if @c value was a non-negative integer, else @c false.
+ */
+static bool AiaStartup_ParseValue( const char* value, size_t* result )
+{
+    char* end;
+    *result = strtoul( value, &end, 10 );
+    return *value != '\0' && *value != '-' && *end == '\0';
+}
+
+/**
+ * Parses command line arguments.
+ *
+ * @param argc Number of arguments passed to main().
+ * @param argv Arguments vector passed to main().
+ * @param[out] iterations The number of starts to measure.
+ * @param[out] rttMs The round-trip time to the broker.
+ * @param[out] isWarm Whether to measure warm starts.
+ * @return @c true if the arguments were valid, else @c false.
+ */
+static bool AiaStartup_ParseArguments( int argc, char** argv,
+                                       size_t* iterations, size_t* rttMs,
+                                       bool* isWarm )
+{
+    *iterations = AIA_STARTUP_DEFAULT_ITERATIONS;
+    *rttMs = AIA_STARTUP_DEFAULT_RTT_MS;
+    *isWarm = false;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        const char* option = argv[ i ];
+        if( option[ 0 ] != '-' || option[ 1 ] == '\0' || option[ 2 ] != '\0' )
+        {
+            return false;
+        }
+        /* Warm starts. */
+        if( option[ 1 ] == 'w' )
+        {
+            *isWarm = true;
+            continue;
+        }
+        if( i + 1 >= argc )
+        {
+            return false;
+        }
+        const char* value = argv[ ++i ];
+        switch( option[ 1 ] )
+        {
+            /* Number of starts to measure. */
+            case 'i':
+                if( !AiaStartup_ParseValue( value, iterations ) ||
+                    !*iterations )
+                {
+                    return false;
+                }
+                break;
+
+            /* Round-trip time in milliseconds. */
+            case 'r':
+                if( !AiaStartup_ParseValue( value, rttMs ) )
+                {
+                    return false;
+                }
+                break;
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Runs the benchmark once the process has been initialized.
+ *
+ * @param iterations The number of starts to measure.
+ * @param rttMs The round-trip time to the broker.
+ * @param isWarm Whether to measure warm starts.
+ * @return @c true if every client became ready, else @c false.
+ */
+static bool AiaStartup_Run( size_t iterations, AiaDurationMs_t rttMs,
+                            bool isWarm )
+{
+    uint8_t microphoneBuffer[ AIA_STARTUP_MICROPHONE_BUFFER_SIZE ];
+    AiaDataStreamBuffer_t* microphoneStream = AiaDataStreamBuffer_Create(
+        microphoneBuffer, sizeof( microphoneBuffer ),
+        AIA_MICROPHONE_BUFFER_WORD_SIZE, 1 );
+    AiaDataStreamReader_t* microphoneReader =
+        microphoneStream ? AiaDataStreamBuffer_CreateReader(
+                               microphoneStream,
+                               AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true )
+                         : NULL;
+    if( !microphoneReader )
+    {
+        AiaLogError( "Failed to create the microphone stream" );
+        if( microphoneStream )
+        {
+            AiaDataStreamBuffer_Destroy( microphoneStream );
+        }
+        return false;
+    }
+
+    /* Warm starts share one device, which is primed by a first start so that
+     * its capabilities are accepted. */
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    bool provisioned =
+        isWarm && AiaBenchmark_ProvisionDevice( storageFolder );
+    bool success = !isWarm || provisioned;
+    if( !success )
+    {
+        AiaLogError( "Failed to provision the device" );
+    }
+    else if( isWarm )
+    {
+        success = AiaStartup_RunOnce( rttMs, microphoneReader );
+    }
+
+    AiaAtomicBool_Set( &g_measuring );
+    for( size_t i = 0; success && i < iterations; ++i )
+    {
+        success = isWarm ? AiaStartup_RunOnce( rttMs, microphoneReader )
+                         : AiaStartup_RunCold( rttMs, microphoneReader );
+    }
+    AiaAtomicBool_Clear( &g_measuring );
+    if( success )
+    {
+        AiaStartup_Report( iterations, rttMs, isWarm );
+    }
+
+    if( provisioned )
+    {
+        AiaBenchmark_RemoveDevice( storageFolder );
+    }
+    AiaDataStreamReader_Destroy( microphoneReader );
+    AiaDataStreamBuffer_Destroy( microphoneStream );
+    return success;
+}
+
+int main( int argc, char** argv )
+{
+    size_t iterations, rttMs;
+    bool isWarm;
+    if( !AiaStartup_ParseArguments( argc, argv, &iterations, &rttMs,
+                                    &isWarm ) )
+    {
+        fprintf( stderr, "Usage: %s [-i <iterations>] [-r <rtt ms>] [-w]\n",
+                 argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    AiaMbedtlsThreading_Init();
+    AiaRandomMbedtls_Init();
+    if( !AiaRandomMbedtls_Seed( NULL, 0 ) )
+    {
+        AiaLogError( "AiaRandomMbedtls_Seed failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    if( !AiaCryptoMbedtls_Init() )
+    {
+        AiaLogError( "AiaCryptoMbedtls_Init failed" );
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+    AiaTaskPoolInfo_t taskPoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskPoolInfo );
+    if( !AiaTaskPoolSucceeded( error ) )
+    {
+        AiaLogError( "AiaTaskPool( CreateSystemTaskPool ) failed, error=%s",
+                     AiaTaskPool( strerror )( error ) );
+        AiaCryptoMbedtls_Cleanup();
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return EXIT_FAILURE;
+    }
+
+    /* Every device shares one topic root. */
+    char storageFolder[] = AIA_BENCHMARK_STORAGE_FOLDER_TEMPLATE;
+    bool provisioned = AiaBenchmark_ProvisionDevice( storageFolder );
+    g_deviceTopicRootSize =
+        provisioned ? AiaGetDeviceTopicRootString( NULL, 0 ) : 0;
+    g_deviceTopicRoot = g_deviceTopicRootSize
+                            ? AiaCalloc( 1, g_deviceTopicRootSize )
+                            : NULL;
+    bool success = g_deviceTopicRoot &&
+                   AiaGetDeviceTopicRootString( g_deviceTopicRoot,
+                                                g_deviceTopicRootSize );
+    if( provisioned )
+    {
+        AiaBenchmark_RemoveDevice( storageFolder );
+    }
+
+    success = success && AiaMutex( Create )( &g_statsMutex, false );
+    if( success )
+    {
+        AiaStartupTrace_SetObserver( AiaStartup_OnPhase, NULL );
+        success = AiaStartup_Run( iterations, rttMs, isWarm );
+        AiaStartupTrace_SetObserver( NULL, NULL );
+        AiaMutex( Destroy )( &g_statsMutex );
+    }
+    else
+    {
+        AiaLogError( "Failed to set up the benchmark" );
+    }
+
+    AiaFree( g_deviceTopicRoot );
+    AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    AiaCryptoMbedtls_Cleanup();
+    AiaRandomMbedtls_Cleanup();
+    AiaMbedtlsThreading_Cleanup();
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -5,6 +5,19 @@
 #     -DAIA_EMIT_SENSITIVE_LOGS=ON
 # Note that this option is only honored in DEBUG builds.
 #
+# To compile out every log site below a given level, include the following
+# option on the cmake command line (one of NONE, ERROR, WARN, INFO or DEBUG):
+#     -DAIA_LOG_MIN_LEVEL=INFO
+#
+# To record logs into a binary ring instead of formatting them at the call
+# site, include the following option on the cmake command line:
+#     -DAIA_LOG_DEFERRED=ON
+#
+# To call the platform's AiaTrace_Begin()/AiaTrace_End() hooks at each stage of
+# the speaker and microphone pipelines, include the following option on the
+# cmake command line:
+#     -DAIA_TRACE=ON
+#
 
 option(AIA_EMIT_SENSITIVE_LOGS "Enable Logging of sensitive information." OFF)
 
@@ -12,3 +25,22 @@ if (AIA_EMIT_SENSITIVE_LOGS)
         message("WARNING: Logging of sensitive information enabled!")
         add_definitions("-DAIA_EMIT_SENSITIVE_LOGS")
 endif()
+
+set(AIA_LOG_MIN_LEVEL "DEBUG" CACHE STRING "Lowest log level compiled into the SDK.")
+set_property(CACHE AIA_LOG_MIN_LEVEL PROPERTY STRINGS NONE ERROR WARN INFO DEBUG)
+if (NOT AIA_LOG_MIN_LEVEL MATCHES "^(NONE|ERROR|WARN|INFO|DEBUG)$")
+        message(FATAL_ERROR "AIA_LOG_MIN_LEVEL must be one of NONE, ERROR, WARN, INFO or DEBUG.")
+endif()
+add_definitions("-DAIA_LOG_MIN_LEVEL=IOT_LOG_${AIA_LOG_MIN_LEVEL}")
+
+option(AIA_LOG_DEFERRED "Record logs into a binary ring for deferred formatting." OFF)
+
+if (AIA_LOG_DEFERRED)
+        add_definitions("-DAIA_ENABLE_DEFERRED_LOGGING")
+endif()
+
+option(AIA_TRACE "Call platform tracing hooks at each audio pipeline stage." OFF)
+
+if (AIA_TRACE)
+        add_definitions("-DAIA_ENABLE_TRACE")
+endif()
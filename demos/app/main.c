@@ -108,7 +108,7 @@ int main( int argc, const char* argv[] )
     IotMqttConnectInfo_t connectInfo = IOT_MQTT_CONNECT_INFO_INITIALIZER;
     connectInfo.awsIotMqttMode = true;
     connectInfo.cleanSession = true;
-    connectInfo.keepAliveSeconds = 60;
+    connectInfo.keepAliveSeconds = AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS;
 
     connectInfo.pClientIdentifier = thingName;
     connectInfo.clientIdentifierLength = (uint16_t)strlen( thingName );
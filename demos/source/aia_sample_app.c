@@ -55,12 +55,25 @@
 #include <aiaopusdecoder/aia_opus_decoder.h>
 #endif
 
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+#include <aiaopusdecoder/aia_opus_decode_ahead.h>
+#endif
+
+#ifdef AIA_OPUS_ENCODER
+#include <aiaopusencoder/aia_opus_encoder.h>
+#endif
+
 #ifdef AIA_LIBCURL_HTTP_CLIENT
+#include <aia_libcurl.h>
 #include <curl/curl.h>
 #endif
 
 #include AiaTaskPool( HEADER )
 #include AiaTimer( HEADER )
+#ifdef AIA_ENABLE_SESSION_RECORDING
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#endif
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -82,12 +95,12 @@ char* g_aiaLwaClientId;
 #ifdef AIA_PORTAUDIO_SPEAKER
 /**
  * Sample app pushes speaker data through PortAudio speaker which publishes
- * @c SAMPLE_RATE samples per second. We calculate here how long it takes in
- * milliseconds to publish all the samples in a given alert tone frame.
+ * @c SAMPLE_RATE samples per second. We calculate here how many samples of
+ * alert tone to push every @c AIA_SPEAKER_FRAME_PUSH_CADENCE_MS.
  */
-#define AIA_ALERT_TONE_FRAME_LENGTH_IN_MS \
-    ( ( AiaDurationMs_t )(                \
-        ( AIA_ALERT_TONE_FRAME_LENGTH * AIA_MS_PER_SECOND ) / SAMPLE_RATE ) )
+#define AIA_ALERT_TONE_SAMPLES_PER_PUSH                               \
+    ( (size_t)( ( SAMPLE_RATE * AIA_SPEAKER_FRAME_PUSH_CADENCE_MS ) / \
+                AIA_MS_PER_SECOND ) )
 #endif
 
 /** Buffer size in bytes; */
@@ -97,6 +110,11 @@ static const size_t MIC_BUFFER_SIZE_IN_BYTES =
 /** Arbitrary. */
 static const size_t MIC_NUM_READERS = 2;
 
+#ifdef AIA_ENABLE_SESSION_RECORDING
+/** The file sessions are recorded to, in the working directory. */
+static const char* SESSION_TRACE_PATH = "aia_session.trace";
+#endif
+
 /** @name Methods that simply print states to stdout. */
 /** @{ */
 static void onAiaConnectionSuccessfulSimpleUI( void* userData );
@@ -179,6 +197,28 @@ static void onPlayOfflineAlertTone( void* userData );
 static bool onStopOfflineAlertTone( void* userData );
 #endif
 
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+/**
+ * Callback from the underlying @c AiaOpusDecodeAhead_t to play decoded speaker
+ * frames.
+ *
+ * @param samples The samples to play.
+ * @param numSamples The number of samples per channel in @c samples.
+ * @param userData Context for this callback.
+ * @return @c true if the samples were accepted or @c false otherwise.
+ */
+static bool onDecodedSpeakerFrameReady( const int16_t* samples,
+                                        size_t numSamples, void* userData );
+
+/**
+ * Callback from the underlying @c AiaOpusDecodeAhead_t once it can accept
+ * speaker frames again.
+ *
+ * @param userData Context for this callback.
+ */
+static void onOpusDecodeAheadReady( void* userData );
+#endif
+
 /* clang-format off */
 static const char* HELP_MESSAGE =
 "\n"
@@ -241,6 +281,16 @@ static void processCommand( char c, bool* exit, AiaSampleApp_t* sampleApp );
  */
 static bool initAiaClient( AiaSampleApp_t* sampleApp );
 
+/**
+ * Installs an Opus encoder for streamed microphone samples when Opus is the
+ * advertised microphone format.
+ *
+ * @param sampleApp The @c AiaSampleApp_t to act on.
+ * @return @c true if the encoder was installed or is not needed, or @c false
+ * otherwise.
+ */
+static bool setMicrophoneEncoder( AiaSampleApp_t* sampleApp );
+
 /**
  * Register with AIA.
  *
@@ -248,6 +298,17 @@ static bool initAiaClient( AiaSampleApp_t* sampleApp );
  */
 static bool registerAia( AiaSampleApp_t* sampleApp );
 
+#ifdef AIA_ENABLE_SESSION_RECORDING
+/**
+ * Opens @c SESSION_TRACE_PATH, if it is not open yet, and records the messages
+ * the client receives to it.
+ *
+ * @param sampleApp Pointer to the sample app.
+ * @return @c true if recording started, or @c false otherwise.
+ */
+static bool startSessionRecording( AiaSampleApp_t* sampleApp );
+#endif
+
 /**
  * Container of all components necessary for the client to run.
  */
@@ -289,6 +350,10 @@ struct AiaSampleApp
     /** Whether to skip publishing events to Aia service */
     AiaAtomicBool_t shouldPublishEvent;
 
+    /** Whether the service rejected the persisted registration, which must
+     * then be refreshed before connecting again. */
+    AiaAtomicBool_t isRegistrationStale;
+
 #ifdef AIA_ENABLE_SPEAKER
     /** Whether speaker is ready to accept new frames */
     AiaAtomicBool_t isSpeakerReady;
@@ -306,17 +371,46 @@ struct AiaSampleApp
 
     /** Keeps track of the time offline alert playback started at */
     AiaTimepointSeconds_t offlineAlertPlaybackStartTime;
+
+    /** Offset into the looping alert tone that the next push starts at. */
+    size_t offlineAlertTonePosition;
 #endif
 
 #ifdef AIA_OPUS_DECODER
     /** Opus decoder to decode speaker frames into PCM data. */
     AiaOpusDecoder_t* opusDecoder;
+
+    /** Buffer that speaker frames are decoded into before being played. */
+    int16_t pcmSamples[ AIA_OPUS_DECODER_MAX_FRAME_SAMPLES *
+                        AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS ];
+#endif
+
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+    /** Decodes speaker frames ahead of playback on its own thread. */
+    AiaOpusDecodeAhead_t* opusDecodeAhead;
+#endif
+
+#ifdef AIA_OPUS_ENCODER
+    /** Opus encoder to encode microphone samples before they are streamed. */
+    AiaOpusEncoder_t* opusEncoder;
 #endif
 
 #ifdef AIA_PORTAUDIO_SPEAKER
     /** PortAudio based speaker to play PCM data. */
     AiaPortAudioSpeaker_t* portAudioSpeaker;
 #endif
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    /** The file every session of the run is recorded to, or @c NULL before
+     * the first client is created. */
+    FILE* sessionTrace;
+
+    /** Serializes records written from the threads handling each topic. */
+    AiaMutex_t sessionTraceMutex;
+
+    /** When the last record was written. */
+    AiaTimepointMs_t lastRecordTimeMs;
+#endif
 };
 
 AiaSampleApp_t* AiaSampleApp_Create( AiaMqttConnectionPointer_t mqttConnection,
@@ -324,6 +418,12 @@ AiaSampleApp_t* AiaSampleApp_Create( AiaMqttConnectionPointer_t mqttConnection,
 {
 #ifdef AIA_LIBCURL_HTTP_CLIENT
     curl_global_init( CURL_GLOBAL_ALL );
+    if( !AiaLibCurlHttpClient_Init() )
+    {
+        AiaLogError( "AiaLibCurlHttpClient_Init failed" );
+        curl_global_cleanup();
+        return NULL;
+    }
 #endif
 
     /* Enabled mbed TLS threading layer. */
@@ -427,12 +527,15 @@ AiaSampleApp_t* AiaSampleApp_Create( AiaMqttConnectionPointer_t mqttConnection,
     }
 
 #ifdef AIA_PORTAUDIO_MICROPHONE
+    /* The microphone writer never blocks, so it is safe to write to from
+     * PortAudio's callback thread. */
     sampleApp->portAudioMicrophoneRecorder =
-        AiaPortAudioMicrophoneRecorder_Create(
+        AiaPortAudioMicrophoneRecorder_CreateCallbackDriven(
             sampleApp->microphoneBufferWriter );
     if( !sampleApp->portAudioMicrophoneRecorder )
     {
-        AiaLogError( "AiaPortAudioMicrophoneRecorder_Create failed" );
+        AiaLogError(
+            "AiaPortAudioMicrophoneRecorder_CreateCallbackDriven failed" );
         AiaDataStreamWriter_Destroy( sampleApp->microphoneBufferWriter );
         AiaDataStreamReader_Destroy( sampleApp->microphoneBufferReader );
         AiaDataStreamBuffer_Destroy( sampleApp->microphoneBuffer );
@@ -536,7 +639,35 @@ AiaSampleApp_t* AiaSampleApp_Create( AiaMqttConnectionPointer_t mqttConnection,
     }
 #endif
 
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+    sampleApp->opusDecodeAhead = AiaOpusDecodeAhead_Create(
+        sampleApp->opusDecoder, AIA_OPUS_DECODE_AHEAD_FRAMES,
+        onDecodedSpeakerFrameReady, sampleApp, onOpusDecodeAheadReady,
+        sampleApp );
+    if( !sampleApp->opusDecodeAhead )
+    {
+        AiaLogError( "AiaOpusDecodeAhead_Create failed" );
+        AiaTimer( Destroy )( &sampleApp->offlineAlertPlaybackTimer );
+        AiaPortAudioSpeaker_Destroy( sampleApp->portAudioSpeaker );
+        AiaOpusDecoder_Destroy( sampleApp->opusDecoder );
+#ifdef AIA_PORTAUDIO_MICROPHONE
+        AiaPortAudioMicrophoneRecorder_Destroy(
+            sampleApp->portAudioMicrophoneRecorder );
+#endif
+        AiaDataStreamWriter_Destroy( sampleApp->microphoneBufferWriter );
+        AiaDataStreamReader_Destroy( sampleApp->microphoneBufferReader );
+        AiaDataStreamBuffer_Destroy( sampleApp->microphoneBuffer );
+        AiaFree( sampleApp->rawMicrophoneBuffer );
+        AiaFree( sampleApp );
+        AiaCryptoMbedtls_Cleanup();
+        AiaRandomMbedtls_Cleanup();
+        AiaMbedtlsThreading_Cleanup();
+        return NULL;
+    }
+#endif
+
     AiaAtomicBool_Clear( &sampleApp->shouldPublishEvent );
+    AiaAtomicBool_Clear( &sampleApp->isRegistrationStale );
 
 #ifdef AIA_ENABLE_SPEAKER
     AiaAtomicBool_Set( &sampleApp->isSpeakerReady );
@@ -569,6 +700,9 @@ void AiaSampleApp_Destroy( AiaSampleApp_t* sampleApp )
     }
 #endif
 
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+    AiaOpusDecodeAhead_Destroy( sampleApp->opusDecodeAhead );
+#endif
 #ifdef AIA_PORTAUDIO_SPEAKER
     AiaPortAudioSpeaker_Destroy( sampleApp->portAudioSpeaker );
 #endif
@@ -583,6 +717,19 @@ void AiaSampleApp_Destroy( AiaSampleApp_t* sampleApp )
     {
         AiaClient_Destroy( sampleApp->aiaClient );
     }
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    if( sampleApp->sessionTrace )
+    {
+        fclose( sampleApp->sessionTrace );
+        AiaMutex( Destroy )( &sampleApp->sessionTraceMutex );
+    }
+#endif
+#ifdef AIA_OPUS_ENCODER
+    if( sampleApp->opusEncoder )
+    {
+        AiaOpusEncoder_Destroy( sampleApp->opusEncoder );
+    }
+#endif
 
     AiaDataStreamWriter_Destroy( sampleApp->microphoneBufferWriter );
     AiaDataStreamReader_Destroy( sampleApp->microphoneBufferReader );
@@ -594,6 +741,7 @@ void AiaSampleApp_Destroy( AiaSampleApp_t* sampleApp )
     AiaRandomMbedtls_Cleanup();
     AiaMbedtlsThreading_Cleanup();
 #ifdef AIA_LIBCURL_HTTP_CLIENT
+    AiaLibCurlHttpClient_Cleanup();
     curl_global_cleanup();
 #endif
 }
@@ -607,6 +755,19 @@ void AiaSampleApp_Run( AiaSampleApp_t* sampleApp )
         return;
     }
     printHelpMessageSimpleUI();
+
+    /* Warm start: connect right away with a persisted registration, and only
+     * register again if the service rejects it. */
+    if( AiaRegistrationManager_IsRegistered() )
+    {
+        AiaLogInfo( "Connecting to Aia with the persisted registration" );
+        if( !initAiaClient( sampleApp ) ||
+            !AiaClient_ConnectAndBootstrap( sampleApp->aiaClient ) )
+        {
+            AiaLogError( "Failed to connect to Aia" );
+        }
+    }
+
     printCommandPrompt();
     bool exit = false;
     int lastCommand = '\n';
@@ -631,6 +792,33 @@ void AiaSampleApp_Run( AiaSampleApp_t* sampleApp )
     }
 }
 
+static bool setMicrophoneEncoder( AiaSampleApp_t* sampleApp )
+{
+#ifdef AIA_OPUS_ENCODER
+    if( !sampleApp->opusEncoder )
+    {
+        sampleApp->opusEncoder = AiaOpusEncoder_Create();
+        if( !sampleApp->opusEncoder )
+        {
+            AiaLogError( "AiaOpusEncoder_Create failed" );
+            return false;
+        }
+    }
+    AiaMicrophoneEncoder_t microphoneEncoder;
+    AiaOpusEncoder_GetMicrophoneEncoder( sampleApp->opusEncoder,
+                                         &microphoneEncoder );
+    if( !AiaClient_SetMicrophoneEncoder( sampleApp->aiaClient,
+                                         &microphoneEncoder ) )
+    {
+        AiaLogError( "AiaClient_SetMicrophoneEncoder failed" );
+        return false;
+    }
+#else
+    (void)sampleApp;
+#endif
+    return true;
+}
+
 static bool initAiaClient( AiaSampleApp_t* sampleApp )
 {
     AiaLogInfo( "Initializing client." );
@@ -644,12 +832,23 @@ static bool initAiaClient( AiaSampleApp_t* sampleApp )
         onSpeakerFramePushedForPlayback, sampleApp, onSpeakerVolumeChanged,
         sampleApp, onStartOfflineAlertTone, sampleApp, onStopOfflineAlertTone,
         sampleApp
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+        ,
+        NULL
+#endif
 #endif
         ,
         onUXStateChangedSimpleUI, NULL
 #ifdef AIA_ENABLE_MICROPHONE
         ,
         sampleApp->microphoneBufferReader
+#endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        ,
+        NULL
+#endif#ifdef AIA_ENABLE_MQTT_MUX
+        ,
+        NULL
 #endif
     );
 
@@ -659,8 +858,78 @@ static bool initAiaClient( AiaSampleApp_t* sampleApp )
         return false;
     }
 
-    return true;
+#ifdef AIA_ENABLE_SESSION_RECORDING
+    if( !startSessionRecording( sampleApp ) )
+    {
+        return false;
+    }
+#endif
+
+    return setMicrophoneEncoder( sampleApp );
+}
+
+#ifdef AIA_ENABLE_SESSION_RECORDING
+/** @c AiaSessionTraceObserver_t appending each message to the session trace. */
+static void onPlaintextReceived( AiaTopic_t topic,
+                                 AiaSequenceNumber_t sequenceNumber,
+                                 const void* plaintext, size_t size,
+                                 void* userData )
+{
+    AiaSampleApp_t* sampleApp = (AiaSampleApp_t*)userData;
+    AiaMutex( Lock )( &sampleApp->sessionTraceMutex );
+    AiaTimepointMs_t nowMs = AiaClock( GetTimeMs )();
+    AiaSessionTraceRecord_t record = {
+        (AiaDurationMs_t)( nowMs - sampleApp->lastRecordTimeMs ), topic,
+        sequenceNumber, plaintext, size
+    };
+    sampleApp->lastRecordTimeMs = nowMs;
+    uint8_t header[ AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE ];
+    size_t headerSize =
+        AiaSessionTrace_WriteRecordHeader( &record, header, sizeof( header ) );
+    if( !headerSize ||
+        fwrite( header, 1, headerSize, sampleApp->sessionTrace ) !=
+            headerSize ||
+        fwrite( plaintext, 1, size, sampleApp->sessionTrace ) != size )
+    {
+        AiaLogError( "Failed to record message, topic=%s.",
+                     AiaTopic_ToString( topic ) );
+    }
+    AiaMutex( Unlock )( &sampleApp->sessionTraceMutex );
+}
+
+static bool startSessionRecording( AiaSampleApp_t* sampleApp )
+{
+    if( !sampleApp->sessionTrace )
+    {
+        if( !AiaMutex( Create )( &sampleApp->sessionTraceMutex, false ) )
+        {
+            AiaLogError( "AiaMutex( Create ) failed" );
+            return false;
+        }
+        uint8_t header[ AIA_SESSION_TRACE_HEADER_SIZE ];
+        size_t headerSize =
+            AiaSessionTrace_WriteHeader( header, sizeof( header ) );
+        sampleApp->sessionTrace = fopen( SESSION_TRACE_PATH, "wb" );
+        if( !sampleApp->sessionTrace ||
+            fwrite( header, 1, headerSize, sampleApp->sessionTrace ) !=
+                headerSize )
+        {
+            AiaLogError( "Failed to open %s", SESSION_TRACE_PATH );
+            if( sampleApp->sessionTrace )
+            {
+                fclose( sampleApp->sessionTrace );
+                sampleApp->sessionTrace = NULL;
+            }
+            AiaMutex( Destroy )( &sampleApp->sessionTraceMutex );
+            return false;
+        }
+        sampleApp->lastRecordTimeMs = AiaClock( GetTimeMs )();
+        AiaLogInfo( "Recording sessions to %s", SESSION_TRACE_PATH );
+    }
+    return AiaClient_SetPlaintextObserver( sampleApp->aiaClient,
+                                           onPlaintextReceived, sampleApp );
 }
+#endif
 
 static bool registerAia( AiaSampleApp_t* sampleApp )
 {
@@ -781,7 +1050,7 @@ void processCommand( char c, bool* exit, AiaSampleApp_t* sampleApp )
                 return;
             }
             AiaLogInfo( "Connecting to Aia" );
-            if( !AiaClient_Connect( sampleApp->aiaClient ) )
+            if( !AiaClient_ConnectAndBootstrap( sampleApp->aiaClient ) )
             {
                 AiaLogError( "Failed to connect to Aia" );
                 *exit = true;
@@ -806,6 +1075,32 @@ void processCommand( char c, bool* exit, AiaSampleApp_t* sampleApp )
             *exit = false;
             return;
         case 'r':
+            if( sampleApp->aiaClient &&
+                AiaAtomicBool_Load( &sampleApp->isRegistrationStale ) )
+            {
+                /* The client holds the rejected shared secret; recreate it
+                 * once registration has been refreshed. */
+                AiaClient_Destroy( sampleApp->aiaClient );
+                sampleApp->aiaClient = NULL;
+                AiaLogInfo( "Refreshing registration with Aia" );
+                if( !registerAia( sampleApp ) ||
+                    !AiaRegistrationManager_IsRegistered() )
+                {
+                    AiaLogError( "Registration Failed" );
+                }
+                else if( !initAiaClient( sampleApp ) ||
+                         !AiaClient_ConnectAndBootstrap(
+                             sampleApp->aiaClient ) )
+                {
+                    AiaLogError( "Failed to connect to Aia" );
+                }
+                else
+                {
+                    AiaAtomicBool_Clear( &sampleApp->isRegistrationStale );
+                }
+                *exit = false;
+                return;
+            }
             if( sampleApp->aiaClient )
             {
                 AiaLogInfo(
@@ -1044,12 +1339,23 @@ static void onAiaDisconnectedSimpleUI( void* userData,
         onSpeakerFramePushedForPlayback, sampleApp, onSpeakerVolumeChanged,
         sampleApp, onStartOfflineAlertTone, sampleApp, onStopOfflineAlertTone,
         sampleApp
+#ifdef AIA_ENABLE_RUNTIME_SPEAKER_BUFFER
+        ,
+        NULL
+#endif
 #endif
         ,
         onUXStateChangedSimpleUI, NULL
 #ifdef AIA_ENABLE_MICROPHONE
         ,
         sampleApp->microphoneBufferReader
+#endif
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+        ,
+        NULL
+#endif#ifdef AIA_ENABLE_MQTT_MUX
+        ,
+        NULL
 #endif
     );
 
@@ -1058,6 +1364,7 @@ static void onAiaDisconnectedSimpleUI( void* userData,
         AiaLogError( "AiaClient_Create failed" );
         return;
     }
+    setMicrophoneEncoder( sampleApp );
 }
 
 static void onAiaConnectionRejectedSimpleUI(
@@ -1073,6 +1380,12 @@ static void onAiaConnectionRejectedSimpleUI(
 
     AiaAtomicBool_Clear( &sampleApp->shouldPublishEvent );
     AiaLogInfo( "Aia connection rejected, code=%d", code );
+    if( code == AIA_CONNECTION_ON_CONNECTION_REJECTION_INVALID_ACCOUNT_ID ||
+        code == AIA_CONNECTION_ON_CONNECTION_REJECTION_INVALID_CLIENT_ID )
+    {
+        AiaAtomicBool_Set( &sampleApp->isRegistrationStale );
+        AiaLogInfo( "Persisted registration rejected, use 'r' to refresh it" );
+    }
 }
 
 static void onAiaExceptionReceivedSimpleUI( void* userData,
@@ -1102,7 +1415,9 @@ static void onPortAudioSpeakerReadyAgain( void* userData )
         return;
     }
     AiaAtomicBool_Set( &sampleApp->isSpeakerReady );
-#ifdef AIA_ENABLE_SPEAKER
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+    AiaOpusDecodeAhead_OnPcmSinkReady( sampleApp->opusDecodeAhead );
+#elif defined( AIA_ENABLE_SPEAKER )
     AiaClient_OnSpeakerReady( sampleApp->aiaClient );
 #endif
 }
@@ -1120,14 +1435,20 @@ static bool onSpeakerFramePushedForPlayback( const void* buf, size_t size,
     }
     AiaLogDebug( "Received speaker frame for playback, size=%zu", size );
 
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+    return AiaOpusDecodeAhead_PushFrame( buf, size,
+                                         sampleApp->opusDecodeAhead );
+#endif
+
     int16_t* pcmSamples = NULL;
 #ifdef AIA_OPUS_DECODER
-    int decodedSamples = 0;
-    pcmSamples = AiaOpusDecoder_DecodeFrame( sampleApp->opusDecoder, buf, size,
-                                             &decodedSamples );
-    if( !pcmSamples )
+    pcmSamples = sampleApp->pcmSamples;
+    int decodedSamples = AiaOpusDecoder_DecodeFrameInto(
+        sampleApp->opusDecoder, buf, size, pcmSamples,
+        sizeof( sampleApp->pcmSamples ) / sizeof( pcmSamples[ 0 ] ) );
+    if( decodedSamples < 0 )
     {
-        AiaLogError( "AiaOpusDecoder_DecodeFrame failed" );
+        AiaLogError( "AiaOpusDecoder_DecodeFrameInto failed" );
         return false;
     }
 #endif
@@ -1136,13 +1457,40 @@ static bool onSpeakerFramePushedForPlayback( const void* buf, size_t size,
 #ifdef AIA_PORTAUDIO_SPEAKER
     ret = AiaPortAudioSpeaker_PlaySpeakerData( sampleApp->portAudioSpeaker,
                                                pcmSamples, decodedSamples );
+    AiaDurationMs_t latencyMs =
+        AiaPortAudioSpeaker_GetPlayoutLatencyMs( sampleApp->portAudioSpeaker );
+    AiaClient_SetSpeakerPlayoutLatency( sampleApp->aiaClient, latencyMs );
 #endif
-    if( pcmSamples )
+    return ret;
+}
+
+#ifdef AIA_OPUS_DECODE_AHEAD_FRAMES
+static bool onDecodedSpeakerFrameReady( const int16_t* samples,
+                                        size_t numSamples, void* userData )
+{
+    AiaSampleApp_t* sampleApp = (AiaSampleApp_t*)userData;
+    AiaAssert( sampleApp );
+    if( !sampleApp )
     {
-        AiaFree( pcmSamples );
+        AiaLogError( "Null sampleApp" );
+        return false;
     }
-    return ret;
+    return AiaPortAudioSpeaker_PlaySpeakerData( sampleApp->portAudioSpeaker,
+                                                samples, numSamples );
+}
+
+static void onOpusDecodeAheadReady( void* userData )
+{
+    AiaSampleApp_t* sampleApp = (AiaSampleApp_t*)userData;
+    AiaAssert( sampleApp );
+    if( !sampleApp )
+    {
+        AiaLogError( "Null sampleApp" );
+        return;
+    }
+    AiaClient_OnSpeakerReady( sampleApp->aiaClient );
 }
+#endif
 
 static void onSpeakerVolumeChanged( uint8_t newVolume, void* userData )
 {
@@ -1222,6 +1570,7 @@ static bool onStartOfflineAlertTone( const AiaAlertSlot_t* offlineAlert,
 
     /* Set the time we started offline alert playback */
     sampleApp->offlineAlertPlaybackStartTime = AiaClock_GetTimeSinceNTPEpoch();
+    sampleApp->offlineAlertTonePosition = 0;
 
     AiaLogDebug( "Playing offline alert tone for %s",
                  AiaAlertType_ToString( offlineAlert->alertType ) );
@@ -1308,23 +1657,12 @@ static void onPlayOfflineAlertTone( void* userData )
         return;
     }
 
-    /* Variables needed to play the offline alert tone */
-    size_t numFrames = 0;
-    size_t frameLength = 0;
-
     /* Check for correct alert type */
     switch( offlineAlert->alertType )
     {
         case AIA_ALERT_TYPE_ALARM:
         case AIA_ALERT_TYPE_REMINDER:
         case AIA_ALERT_TYPE_TIMER:
-#ifdef AIA_PORTAUDIO_SPEAKER
-            numFrames = AIA_SPEAKER_FRAME_PUSH_CADENCE_MS /
-                        AIA_ALERT_TONE_FRAME_LENGTH_IN_MS;
-            /* Make sure we are pushing at least one frame */
-            numFrames = numFrames > 0 ? numFrames : 1;
-#endif
-            frameLength = AIA_ALERT_TONE_FRAME_LENGTH;
             break;
         default:
             AiaLogError( "Unknown alert type:%" PRIu32,
@@ -1338,18 +1676,22 @@ static void onPlayOfflineAlertTone( void* userData )
             return;
     }
 
-    for( size_t i = 0; i < numFrames; ++i )
-    {
 #ifdef AIA_PORTAUDIO_SPEAKER
-        if( !AiaPortAudioSpeaker_PlaySpeakerData(
-                sampleApp->portAudioSpeaker, AIA_ALERT_TONE, frameLength ) )
-        {
-            AiaLogDebug( "Failed to play offline alert buffer" );
-            AiaAtomicBool_Clear( &sampleApp->isSpeakerReady );
-            return;
-        }
-#endif
+    /* Push exactly one cadence worth of the looping tone, so that playback
+     * neither drifts ahead of nor falls behind the speaker. */
+    int16_t samples[ AIA_ALERT_TONE_SAMPLES_PER_PUSH ];
+    size_t position = sampleApp->offlineAlertTonePosition;
+    AiaAlertTone_Fill( samples, AIA_ALERT_TONE_SAMPLES_PER_PUSH, &position );
+    if( !AiaPortAudioSpeaker_PlaySpeakerData(
+            sampleApp->portAudioSpeaker, samples,
+            AIA_ALERT_TONE_SAMPLES_PER_PUSH ) )
+    {
+        AiaLogDebug( "Failed to play offline alert buffer" );
+        AiaAtomicBool_Clear( &sampleApp->isSpeakerReady );
+        return;
     }
+    sampleApp->offlineAlertTonePosition = position;
+#endif
 
     return;
 }
@@ -24,6 +24,7 @@ extern "C" {
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Tests whether @c EXPRESSION is true, and terminates the application if it is
@@ -50,9 +51,137 @@ static inline void AiaCriticalFailure()
 /** How often data will be published on the /event topic. */
 static const AiaDurationMs_t EVENT_PUBLISH_RATE = MICROPHONE_PUBLISH_RATE;
 
+/**
+ * How many messages may be published back to back on the /event topic after it
+ * has been idle. The sustained rate is still one per @c EVENT_PUBLISH_RATE.
+ */
+static const size_t EVENT_PUBLISH_MAX_BURST = 4;
+
+/**
+ * How many messages each emitter may hand off and not yet have published when
+ * asynchronous publishing is enabled with the @c AIA_ASYNC_PUBLISH option.
+ */
+static const size_t AIA_EMITTER_MAX_IN_FLIGHT = 4;
+
+/**
+ * How many calls an @c AiaClient_t may have queued and not yet applied when
+ * built with the @c AIA_CLIENT_COMMAND_QUEUE option. This must be a power of
+ * two.
+ */
+static const size_t AIA_CLIENT_COMMAND_QUEUE_SIZE = 16;
+
+/**
+ * How long the UX state of an @c AiaClient_t must stay idle before it releases
+ * reclaimable buffers when built with the @c AIA_IDLE_MEMORY_TRIM option.
+ */
+static const AiaDurationMs_t AIA_CLIENT_IDLE_MEMORY_TRIM_DELAY_MS = 30000;
+
+/**
+ * How long buffer state, volume and speaker marker events may stay queued
+ * before an @c AiaClient_t drops them when built with the @c AIA_EVENT_EXPIRY
+ * option.  The state they report is sent again on reconnect.
+ */
+static const AiaDurationMs_t AIA_CLIENT_STALE_EVENT_MAX_AGE_MS = 30000;
+
+/**
+ * How many @c MALFORMED_MESSAGE @c ExceptionEncountered events may be sent back
+ * to back by a client, and how often one more may be sent after that. Reports
+ * beyond this rate are coalesced into the next event sent on the same topic.
+ */
+static const size_t AIA_EXCEPTION_EVENT_BURST = 5;
+static const AiaDurationMs_t AIA_EXCEPTION_EVENT_REFILL_INTERVAL_MS = 1000;
+
 /** How many slots to be used in a sequencing buffer. */
 static const size_t AIA_SEQUENCER_SLOTS = 4;
 
+/**
+ * Size of the pooled storage backing each sequencing buffer slot. Buffered
+ * messages up to this size are stored without a heap allocation, so this
+ * follows @c AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE, which @c aia_config.h includes
+ * before this is expanded. The pool is allocated the first time a sequencer
+ * has to buffer an out of order message.
+ */
+#define AIA_SEQUENCER_SLOT_POOL_DATA_SIZE \
+    ( (size_t)AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE )
+
+/**
+ * Bounds within which sequencing buffer slots and timeouts are adapted when
+ * auto-tuning is enabled with the @c AIA_SEQUENCER_AUTO_TUNING option.
+ */
+static const size_t AIA_SEQUENCER_MIN_SLOTS = 2;
+static const size_t AIA_SEQUENCER_MAX_SLOTS = 16;
+static const uint32_t AIA_SEQUENCER_MIN_TIMEOUT_MS = 2000;
+static const uint32_t AIA_SEQUENCER_MAX_TIMEOUT_MS = 30000;
+
+/** Pipeline stages reported through @c AiaTrace_Begin() and @c AiaTrace_End().
+ */
+typedef enum AiaTraceStage
+{
+    /** An MQTT message arrived on the speaker topic. */
+    AIA_TRACE_SPEAKER_RECEIVE,
+
+    /** A speaker message waited in the sequencer for its turn. */
+    AIA_TRACE_SPEAKER_SEQUENCE,
+
+    /** A speaker message was validated and decrypted. */
+    AIA_TRACE_SPEAKER_DECRYPT,
+
+    /** A speaker content entry was written into the speaker buffer. */
+    AIA_TRACE_SPEAKER_BUFFER_WRITE,
+
+    /** A speaker frame was pushed to the platform speaker. */
+    AIA_TRACE_SPEAKER_PLAY,
+
+    /** A @c SpeakerMarkerEncountered event was emitted. */
+    AIA_TRACE_SPEAKER_MARKER,
+
+    /** A microphone chunk was read from the capture buffer. */
+    AIA_TRACE_MICROPHONE_CAPTURE,
+
+    /** A microphone chunk waited in the regulator. */
+    AIA_TRACE_MICROPHONE_REGULATE,
+
+    /** A microphone chunk was serialized into an MQTT message. */
+    AIA_TRACE_MICROPHONE_EMIT,
+
+    /** An MQTT message was published on the microphone topic. */
+    AIA_TRACE_MICROPHONE_PUBLISH
+} AiaTraceStage_t;
+
+/** Tag value used when a trace event's sequence number is not known. */
+#define AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN UINT32_MAX
+
+/** Tag value used when a trace event's stream offset is not known. */
+#define AIA_TRACE_OFFSET_UNKNOWN UINT64_MAX
+
+#ifdef AIA_ENABLE_TRACE
+/**
+ * Tracing hooks implemented by the platform, e.g. to export Perfetto or Chrome
+ * trace events.  Each event is tagged with the topic sequence number and the
+ * binary stream offset it relates to, whichever are known at that stage, so
+ * that events for the same audio can be correlated across threads.  Speaker
+ * stages ahead of @c AIA_TRACE_SPEAKER_BUFFER_WRITE only know the sequence
+ * number, while @c AIA_TRACE_SPEAKER_BUFFER_WRITE carries both.
+ *
+ * These are called on the SDK's hot paths and must return quickly.
+ *
+ * @param stage The pipeline stage.
+ * @param sequenceNumber The sequence number of the message, or @c
+ * AIA_TRACE_SEQUENCE_NUMBER_UNKNOWN.
+ * @param offset The binary stream offset of the audio, or @c
+ * AIA_TRACE_OFFSET_UNKNOWN.
+ */
+/** @{ */
+void AiaTrace_Begin( AiaTraceStage_t stage, uint32_t sequenceNumber,
+                     uint64_t offset );
+void AiaTrace_End( AiaTraceStage_t stage, uint32_t sequenceNumber,
+                   uint64_t offset );
+/** @} */
+#else
+#define AiaTrace_Begin( stage, sequenceNumber, offset )
+#define AiaTrace_End( stage, sequenceNumber, offset )
+#endif
+
 #ifdef __cplusplus
 }
 #endif
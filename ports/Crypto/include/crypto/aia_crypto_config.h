@@ -128,6 +128,172 @@ static inline bool AiaCrypto_Decrypt( const uint8_t* inputData,
                                      tag, tagLen );
 }
 
+/**
+ * An independently keyed encryption/decryption context. Operations on
+ * different contexts may proceed in parallel without re-keying, but callers
+ * must serialize access to a given context.
+ */
+typedef AiaCryptoMbedtlsContext_t AiaCryptoContext_t;
+
+/**
+ * Allocates and initializes an @c AiaCryptoContext_t. A key must be set using
+ * @c AiaCrypto_SetContextKey() before the context can be used. The returned
+ * pointer should be destroyed using @c AiaCrypto_DestroyContext().
+ *
+ * @return The newly created @c AiaCryptoContext_t if successful, or @c NULL
+ * otherwise.
+ */
+AiaCryptoContext_t* AiaCrypto_CreateContext();
+
+/**
+ * Sets the key for encryption/decryption functions using @c context.
+ *
+ * @param context The context to set the key for.
+ * @param encryptKey The encryption key to use.
+ * @param encryptKeySize The size of @c encryptKey (in bytes).
+ * @param encryptAlgorithm The encryption algorithm to use.
+ *
+ * @return @c true if the key is set successfully, else @c false.
+ */
+bool AiaCrypto_SetContextKey( AiaCryptoContext_t* context,
+                              const uint8_t* encryptKey, size_t encryptKeySize,
+                              const AiaEncryptionAlgorithm_t encryptAlgorithm );
+
+/**
+ * Encrypts given input data using the key set on @c context. Unlike @c
+ * AiaCrypto_Encrypt(), 96-bit IVs are not drawn at random for each call but
+ * built from a random field chosen when the key is set and a counter, which
+ * never repeat together for a given key.
+ *
+ * @param context The context to encrypt with.
+ * @copydetails AiaCrypto_Encrypt()
+ */
+bool AiaCrypto_EncryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   uint8_t* iv, size_t ivLen, uint8_t* tag,
+                                   const size_t tagLen );
+
+/**
+ * Decrypts given encrypted data using the key set on @c context.
+ *
+ * @param context The context to decrypt with.
+ * @copydetails AiaCrypto_Decrypt()
+ */
+bool AiaCrypto_DecryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   const uint8_t* iv, const size_t ivLen,
+                                   const uint8_t* tag, const size_t tagLen );
+
+/**
+ * Uninitializes and deallocates an @c AiaCryptoContext_t previously created by
+ * a call to @c AiaCrypto_CreateContext().
+ *
+ * @param context The context to destroy.
+ */
+void AiaCrypto_DestroyContext( AiaCryptoContext_t* context );
+
+/**
+ * A region of a message processed by an asynchronous request. Requests carry a
+ * scatter/gather list of regions, e.g. a header and a payload held in separate
+ * buffers, which are processed as one contiguous message.
+ */
+typedef AiaCryptoMbedtlsSegment_t AiaCryptoSegment_t;
+
+/**
+ * Decrypts the concatenation of @c segments using the key set on @c context,
+ * completing before this returns. Unlike @c
+ * AiaCrypto_SubmitDecryptWithContext(), this lets callers decrypt directly into
+ * memory which they may only hold for the duration of the call.
+ *
+ * @param context The context to decrypt with.
+ * @param segments The regions of the message to decrypt.
+ * @param numSegments The number of entries in @c segments.
+ * @param iv The initialization vector of the message.
+ * @param ivLen The length of @c iv.
+ * @param tag The tag to verify.
+ * @param tagLen The length of @c tag.
+ * @return @c true if decryption is successful, else @c false. If the tag does
+ * not match, the output of every segment is zeroed.
+ */
+bool AiaCrypto_DecryptSegmentsWithContext( AiaCryptoContext_t* context,
+                                           const AiaCryptoSegment_t* segments,
+                                           size_t numSegments,
+                                           const uint8_t* iv, size_t ivLen,
+                                           const uint8_t* tag, size_t tagLen );
+
+/**
+ * Called exactly once when a request submitted to @c
+ * AiaCrypto_SubmitEncryptWithContext() or @c
+ * AiaCrypto_SubmitDecryptWithContext() completes. This may be called from any
+ * thread, including from within the submitting call.
+ *
+ * @param success Whether the request succeeded.
+ * @param userData Context associated with the request.
+ */
+typedef void ( *AiaCryptoOnComplete_t )( bool success, void* userData );
+
+/** An asynchronous encryption or decryption request. */
+typedef struct AiaCryptoRequest
+{
+    /** The regions of the message to process. */
+    const AiaCryptoSegment_t* segments;
+
+    /** The number of entries in @c segments. */
+    size_t numSegments;
+
+    /** The initialization vector, written by encryption and read by
+     * decryption. */
+    uint8_t* iv;
+
+    /** The length of @c iv. */
+    size_t ivLen;
+
+    /** The tag, written by encryption and verified by decryption. */
+    uint8_t* tag;
+
+    /** The length of @c tag. */
+    size_t tagLen;
+
+    /** Called when the request completes. */
+    AiaCryptoOnComplete_t onComplete;
+
+    /** Context passed to @c onComplete. */
+    void* userData;
+} AiaCryptoRequest_t;
+
+/**
+ * Submits a request to encrypt a message with the key set on @c context, for
+ * example to a hardware accelerator. The key is captured at submission, so @c
+ * context may be re-keyed or used for further submissions immediately. Requests
+ * submitted to the same context complete in submission order.
+ *
+ * The @c request structure and its @c segments array may be released as soon
+ * as this returns, but the buffers they point to must remain valid until @c
+ * onComplete is called. The default implementation encrypts synchronously and
+ * calls @c onComplete before returning.
+ *
+ * @param context The context to encrypt with.
+ * @param request The request to submit.
+ * @return @c true if the request was submitted and @c onComplete will be
+ * called, else @c false.
+ */
+bool AiaCrypto_SubmitEncryptWithContext( AiaCryptoContext_t* context,
+                                         const AiaCryptoRequest_t* request );
+
+/**
+ * Submits a request to decrypt a message with the key set on @c context. See
+ * @c AiaCrypto_SubmitEncryptWithContext() for the ordering and lifetime rules.
+ *
+ * @param context The context to decrypt with.
+ * @param request The request to submit.
+ * @return @c true if the request was submitted and @c onComplete will be
+ * called, else @c false.
+ */
+bool AiaCrypto_SubmitDecryptWithContext( AiaCryptoContext_t* context,
+                                         const AiaCryptoRequest_t* request );
+
 /**
  * Generates a key pair intended for the specified shared secret calculation.
  *
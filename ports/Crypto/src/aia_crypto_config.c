@@ -28,3 +28,108 @@ bool AiaCrypto_SetKey( const uint8_t* encryptKey, size_t encryptKeySize,
     return AiaCryptoMbedtls_SetKey( encryptKey, encryptKeySize,
                                     encryptAlgorithm );
 }
+
+AiaCryptoContext_t* AiaCrypto_CreateContext()
+{
+    return AiaCryptoMbedtls_CreateContext();
+}
+
+bool AiaCrypto_SetContextKey( AiaCryptoContext_t* context,
+                              const uint8_t* encryptKey, size_t encryptKeySize,
+                              const AiaEncryptionAlgorithm_t encryptAlgorithm )
+{
+    return AiaCryptoMbedtls_SetContextKey( context, encryptKey, encryptKeySize,
+                                           encryptAlgorithm );
+}
+
+bool AiaCrypto_EncryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   uint8_t* iv, size_t ivLen, uint8_t* tag,
+                                   const size_t tagLen )
+{
+    return AiaCryptoMbedtls_EncryptWithContext(
+        context, inputData, inputLen, outputData, iv, ivLen, tag, tagLen );
+}
+
+bool AiaCrypto_DecryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   const uint8_t* iv, const size_t ivLen,
+                                   const uint8_t* tag, const size_t tagLen )
+{
+    return AiaCryptoMbedtls_DecryptWithContext(
+        context, inputData, inputLen, outputData, iv, ivLen, tag, tagLen );
+}
+
+void AiaCrypto_DestroyContext( AiaCryptoContext_t* context )
+{
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+bool AiaCrypto_DecryptSegmentsWithContext( AiaCryptoContext_t* context,
+                                           const AiaCryptoSegment_t* segments,
+                                           size_t numSegments,
+                                           const uint8_t* iv, size_t ivLen,
+                                           const uint8_t* tag, size_t tagLen )
+{
+    return AiaCryptoMbedtls_DecryptSegmentsWithContext(
+        context, segments, numSegments, iv, ivLen, tag, tagLen );
+}
+
+/**
+ * Validates a request passed to @c AiaCrypto_SubmitEncryptWithContext() or @c
+ * AiaCrypto_SubmitDecryptWithContext().
+ *
+ * @param context The context the request was submitted to.
+ * @param request The request to validate.
+ * @return @c true if the request may be processed, else @c false.
+ */
+static bool AiaCrypto_ValidateRequest( AiaCryptoContext_t* context,
+                                       const AiaCryptoRequest_t* request )
+{
+    if( !context )
+    {
+        AiaLogError( "Null context." );
+        return false;
+    }
+    if( !request )
+    {
+        AiaLogError( "Null request." );
+        return false;
+    }
+    if( !request->onComplete )
+    {
+        AiaLogError( "Null onComplete." );
+        return false;
+    }
+    return true;
+}
+
+bool AiaCrypto_SubmitEncryptWithContext( AiaCryptoContext_t* context,
+                                         const AiaCryptoRequest_t* request )
+{
+    if( !AiaCrypto_ValidateRequest( context, request ) )
+    {
+        return false;
+    }
+    bool success = AiaCryptoMbedtls_EncryptSegmentsWithContext(
+        context, request->segments, request->numSegments, request->iv,
+        request->ivLen, request->tag, request->tagLen );
+    request->onComplete( success, request->userData );
+    return true;
+}
+
+bool AiaCrypto_SubmitDecryptWithContext( AiaCryptoContext_t* context,
+                                         const AiaCryptoRequest_t* request )
+{
+    if( !AiaCrypto_ValidateRequest( context, request ) )
+    {
+        return false;
+    }
+    bool success = AiaCryptoMbedtls_DecryptSegmentsWithContext(
+        context, request->segments, request->numSegments, request->iv,
+        request->ivLen, request->tag, request->tagLen );
+    request->onComplete( success, request->userData );
+    return true;
+}
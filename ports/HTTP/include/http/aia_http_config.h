@@ -91,6 +91,21 @@ typedef void ( *AiaHttpsConnectionFailureCallback_t )( void* userData );
 typedef void ( *AiaHttpsConnectionResponseCallback_t )(
     AiaHttpsResponse_t* httpsResponse, void* userData );
 
+/**
+ * This callback function is used as the body of a response is received from
+ * the server, before the response is complete. Chunks are delivered in order
+ * and are not retained once this returns.
+ * @note Implementations are not required to be thread-safe.
+ *
+ * @param status The response code received.
+ * @param chunk The next bytes of the body of the response.
+ * @param chunkLen Length of @c chunk.
+ * @param userData Optional user data pointer which was provided alongside the
+ * callback.
+ */
+typedef void ( *AiaHttpsConnectionResponseChunkCallback_t )(
+    size_t status, const char* chunk, size_t chunkLen, void* userData );
+
 /**
  * Sends a HTTPS request. Implementation must be using HTTP/1.1 and follow
  * redirects.
@@ -113,6 +128,35 @@ bool AiaSendHttpsRequest( AiaHttpsRequest_t* httpsRequest,
                           void* responseCallbackUserData,
                           AiaHttpsConnectionFailureCallback_t failureCallback,
                           void* failureCallbackUserData );
+
+/**
+ * Sends a HTTPS request like @c AiaSendHttpsRequest(), but passes the body of
+ * the response to @c chunkCallback as it is received instead of accumulating
+ * it. The @c AiaHttpsResponse_t later passed to @c responseCallback has a @c
+ * NULL body.
+ * @note A callback to @c responseCallback or @c failureCallback will only be
+ * made if @c true is returned. Calls to @c chunkCallback may be followed by a
+ * call to @c failureCallback if the request fails before it completes.
+ * @note Implementations are not required to be thread-safe.
+ *
+ * @param httpsRequest Information used for sending the HTTPS request.
+ * @param chunkCallback A callback for each chunk of the body of the response.
+ * @param responseCallback A callback for when the response is complete.
+ * @param responseCallbackUserData User data to pass to @c chunkCallback and @c
+ * responseCallback.
+ * @param failureCallback A callback for when a failure in encountered making
+ * the request.
+ * @param failureCallbackUserData User data to pass to @c failureCallback.
+ * @return @c true if the request was able to be performed successfully or @c
+ * false otherwise.
+ */
+bool AiaSendHttpsStreamingRequest(
+    AiaHttpsRequest_t* httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void* responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void* failureCallbackUserData );
 /** @} */
 
 #ifdef __cplusplus
@@ -34,3 +34,16 @@ bool AiaSendHttpsRequest( AiaHttpsRequest_t* httpsRequest,
         httpsRequest, responseCallback, responseCallbackUserData,
         failureCallback, failureCallbackUserData );
 }
+
+bool AiaSendHttpsStreamingRequest(
+    AiaHttpsRequest_t* httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void* responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void* failureCallbackUserData )
+{
+    return AiaLibCurlHttpClient_SendHttpsStreamingRequest(
+        httpsRequest, chunkCallback, responseCallback,
+        responseCallbackUserData, failureCallback, failureCallbackUserData );
+}
@@ -34,6 +34,7 @@ extern "C" {
 #include <types/iot_mqtt_types.h>
 #include <types/iot_taskpool_types.h>
 
+#include <stdint.h>
 #include <string.h>
 
 /** Simple macro to stringify a parameter. */
@@ -45,26 +46,88 @@ extern "C" {
  */
 #define AIA_TOSTRING( x ) AIA_STRINGIFY( x )
 
+/**
+ * Minimum level compiled into the SDK.  Log sites below this level expand to
+ * dead code which the compiler removes entirely, so neither the call nor its
+ * argument evaluation remains in the binary.  Arguments are still
+ * type-checked against their format strings.
+ */
+#ifndef AIA_LOG_MIN_LEVEL
+#define AIA_LOG_MIN_LEVEL IOT_LOG_DEBUG
+#endif
+
+/** Compiles out a log site while keeping its arguments referenced. */
+#define AIA_LOG_DISCARD( ... )     \
+    do                             \
+    {                              \
+        if( 0 )                    \
+        {                          \
+            AiaLog( __VA_ARGS__ ); \
+        }                          \
+    } while( 0 )
+
 /**
  * Simple printf-style logging macros which automatically prepends the file
  * name and line number.
  */
 /** @{ */
 #define IOT_LOG_LEVEL_AIA IOT_LOG_DEBUG
+#ifdef AIA_ENABLE_DEFERRED_LOGGING
+#define AiaLog( Level, ... ) AiaLogDeferred_Record( Level, __VA_ARGS__ )
+#else
 #define AiaLog( Level, ... ) \
     IotLog_Generic( IOT_LOG_LEVEL_AIA, "AIA", Level, NULL, __VA_ARGS__ )
+#endif
+
+#if AIA_LOG_MIN_LEVEL >= IOT_LOG_DEBUG && \
+    defined( AIA_ENABLE_OVERLOAD_GOVERNOR )
+/**
+ * Set by the overload governor while debug logging is shed. This is read with
+ * a plain load, since a stale value only lets through or drops a few logs.
+ */
+extern uint32_t g_aiaLogDebugShed;
+
+#define AiaLogDebug( ... )                                           \
+    do                                                               \
+    {                                                                \
+        if( !*(volatile uint32_t*)&g_aiaLogDebugShed )               \
+        {                                                            \
+            AiaLog( IOT_LOG_DEBUG,                                   \
+                    __FILE__ ":" AIA_TOSTRING( __LINE__ ) ": "       \
+                        __VA_ARGS__ );                               \
+        }                                                            \
+    } while( 0 )
+#elif AIA_LOG_MIN_LEVEL >= IOT_LOG_DEBUG
 #define AiaLogDebug( ... ) \
     AiaLog( IOT_LOG_DEBUG, \
             __FILE__ ":" AIA_TOSTRING( __LINE__ ) ": " __VA_ARGS__ )
+#else
+#define AiaLogDebug( ... ) AIA_LOG_DISCARD( IOT_LOG_DEBUG, __VA_ARGS__ )
+#endif
+
+#if AIA_LOG_MIN_LEVEL >= IOT_LOG_ERROR
 #define AiaLogError( ... ) \
     AiaLog( IOT_LOG_ERROR, \
             __FILE__ ":" AIA_TOSTRING( __LINE__ ) ": " __VA_ARGS__ )
+#else
+#define AiaLogError( ... ) AIA_LOG_DISCARD( IOT_LOG_ERROR, __VA_ARGS__ )
+#endif
+
+#if AIA_LOG_MIN_LEVEL >= IOT_LOG_INFO
 #define AiaLogInfo( ... ) AiaLog( IOT_LOG_INFO, __VA_ARGS__ )
+#else
+#define AiaLogInfo( ... ) AIA_LOG_DISCARD( IOT_LOG_INFO, __VA_ARGS__ )
+#endif
+
+#if AIA_LOG_MIN_LEVEL >= IOT_LOG_WARN
 #define AiaLogWarn( ... ) \
     AiaLog( IOT_LOG_WARN, \
             __FILE__ ":" AIA_TOSTRING( __LINE__ ) ": " __VA_ARGS__ )
+#else
+#define AiaLogWarn( ... ) AIA_LOG_DISCARD( IOT_LOG_WARN, __VA_ARGS__ )
+#endif
 
-#ifdef AIA_EMIT_SENSITIVE_LOGS
+#if defined( AIA_EMIT_SENSITIVE_LOGS ) && AIA_LOG_MIN_LEVEL >= IOT_LOG_DEBUG
 
 #define AIA_SENSITIVE_TAG "AIA_SENSITIVE"
 #define AiaLogSensitive( ... )                                             \
@@ -77,6 +140,101 @@ extern "C" {
 #endif
 /** @} */
 
+#ifdef AIA_ENABLE_DEFERRED_LOGGING
+/**
+ * Deferred logging.  Instead of formatting on the calling thread, each @c
+ * AiaLog() call records the address of its format string (which doubles as a
+ * stable format ID that can be resolved against the binary's symbol table)
+ * together with the raw argument values into a fixed-size, lock-free ring.
+ * Records are formatted later by @c AiaLogDeferred_Decode(), either in process
+ * after @c AiaLogDeferred_Drain() or offline from a raw dump of the records.
+ *
+ * When producers outrun the consumer the oldest records are overwritten; the
+ * consumer sees this as a gap in @c AiaLogDeferredRecord_t.sequence.
+ */
+/** @{ */
+
+/** Number of records in the ring.  Must be a power of two. */
+#ifndef AIA_LOG_DEFERRED_RING_SIZE
+#define AIA_LOG_DEFERRED_RING_SIZE 256
+#endif
+
+/** Maximum number of argument words captured per record. */
+#ifndef AIA_LOG_DEFERRED_MAX_ARGS
+#define AIA_LOG_DEFERRED_MAX_ARGS 8
+#endif
+
+/** Bytes reserved per record for copies of string arguments. */
+#ifndef AIA_LOG_DEFERRED_MAX_STRING_BYTES
+#define AIA_LOG_DEFERRED_MAX_STRING_BYTES 48
+#endif
+
+/** A single captured log call. */
+typedef struct AiaLogDeferredRecord
+{
+    /** Monotonic record number, starting at 1. */
+    uint32_t sequence;
+
+    /** The @c IOT_LOG_* level of the call. */
+    uint8_t level;
+
+    /** Number of valid entries in @c args. */
+    uint8_t numArgs;
+
+    /** Number of valid bytes in @c strings. */
+    uint8_t stringBytes;
+
+    /** Set if the call had more arguments or string data than fit. */
+    uint8_t truncated;
+
+    /** The format string; its address is the format ID. */
+    const char* format;
+
+    /**
+     * Raw argument values in format order.  Integers are widened to 64 bits,
+     * doubles are stored bit-for-bit and string arguments hold their length
+     * within @c strings.
+     */
+    uint64_t args[ AIA_LOG_DEFERRED_MAX_ARGS ];
+
+    /** Concatenated copies of string arguments. */
+    char strings[ AIA_LOG_DEFERRED_MAX_STRING_BYTES ];
+} AiaLogDeferredRecord_t;
+
+/**
+ * Captures a log call into the ring.  Safe to call concurrently from any
+ * thread; never blocks and never allocates.
+ *
+ * @param level The @c IOT_LOG_* level of the call.
+ * @param format The printf-style format string.
+ */
+void AiaLogDeferred_Record( int level, const char* format, ... );
+
+/**
+ * Copies completed records out of the ring, oldest first.  Only one thread
+ * may drain at a time.
+ *
+ * @param[out] records Destination for the records.
+ * @param maxRecords Capacity of @c records.
+ * @return The number of records copied.
+ */
+size_t AiaLogDeferred_Drain( AiaLogDeferredRecord_t* records,
+                             size_t maxRecords );
+
+/**
+ * Formats a drained record.  The record's format string must be resolvable
+ * in the calling process.
+ *
+ * @param record The record to format.
+ * @param[out] buffer Destination for the NUL-terminated message.
+ * @param bufferSize Size of @c buffer.
+ * @return The length of the formatted message, excluding the terminator.
+ */
+size_t AiaLogDeferred_Decode( const AiaLogDeferredRecord_t* record,
+                              char* buffer, size_t bufferSize );
+/** @} */
+#endif
+
 /** Macros and typedefs for task pool. */
 /** @{ */
 typedef IotTaskPoolInfo_t AiaTaskPoolInfo_t;
@@ -84,7 +242,12 @@ typedef IotTaskPoolError_t AiaTaskPoolError_t;
 typedef IotTaskPoolJobStatus_t AiaTaskPoolJobStatus_t;
 typedef IotTaskPoolJobStorage_t AiaTaskPoolJobStorage_t;
 typedef IotTaskPoolJob_t AiaTaskPoolJob_t;
+#ifndef AIA_ENABLE_VIRTUAL_TIME
 #define AiaTaskPool( MEMBER ) IotTaskPool_##MEMBER
+#else
+/* Deferred jobs follow the virtual clock, see @c AiaVirtualTime_RunUntil(). */
+#define AiaTaskPool( MEMBER ) AiaVirtualTime_TaskPool##MEMBER
+#endif
 #define AiaTaskPool_t AiaTaskPool( t )
 #define IotTaskPool_HEADER <iot_taskpool.h>
 #define IotTaskPool_INITIALIZER IOT_TASKPOOL_INITIALIZER
@@ -180,6 +343,34 @@ static inline uint32_t AiaAtomic_Add_u32( uint32_t* operand, uint32_t addendum )
     return Atomic_Add_u32( operand, addendum );
 }
 
+/**
+ * A function which atomically stores a value if the operand still holds an
+ * expected value.
+ *
+ * @param[in,out] operand Pointer to the value to update.
+ * @param[in] newValue Value to store.
+ * @param[in] expected Value @c operand must hold for the store to happen.
+ *
+ * @return @c true if @c newValue was stored, else @c false.
+ */
+static inline bool AiaAtomic_CompareAndSwap_u32( uint32_t* operand,
+                                                 uint32_t newValue,
+                                                 uint32_t expected )
+{
+    return Atomic_CompareAndSwap_u32( operand, newValue, expected ) == 1;
+}
+
+#ifndef AIA_CACHE_LINE_SIZE
+/**
+ * Size in bytes of a data cache line on the target. State written by different
+ * threads, such as the writer and reader cursors of an @c
+ * AiaDataStreamBuffer_t, is kept at least this far apart so that the threads
+ * do not false-share a line. Override this when targeting cores with a
+ * different line size.
+ */
+#define AIA_CACHE_LINE_SIZE 64
+#endif
+
 /**
  * An unsigned, integral type used to represent indexes in the stream. Note that
  * @c AiaDataStreamIndex_t wrapping is not checked for,so this type must
@@ -216,6 +407,23 @@ static inline void AiaDataStreamAtomicIndex_Store(
     AiaAtomic_Store_u32( operand, newValue );
 }
 
+/**
+ * A function used to atomically store a value into an @c AiaDataStreamIndex_t
+ * if it still holds an expected value.
+ *
+ * @param[in,out] operand Pointer to the index to update.
+ * @param[in] newValue Value to store.
+ * @param[in] expected Value @c operand must hold for the store to happen.
+ *
+ * @return @c true if @c newValue was stored, else @c false.
+ */
+static inline bool AiaDataStreamAtomicIndex_CompareAndSwap(
+    AiaDataStreamIndex_t* operand, AiaDataStreamIndex_t newValue,
+    AiaDataStreamIndex_t expected )
+{
+    return Atomic_CompareAndSwap_u32( operand, newValue, expected ) == 1;
+}
+
 /**
  * A function which performs an arithmetic atomic addition operation.
  *
@@ -255,12 +463,137 @@ static inline AiaAtomicBool_t AiaAtomicBool_Load( AiaAtomicBool_t* operand )
     return AiaAtomic_Load_u32( operand );
 }
 
+#ifndef AIA_ENABLE_MUTEX_STATS
 /** Macros for mutexes. */
 /** @{ */
 #define AiaMutex( MEMBER ) IotMutex_##MEMBER
 #define IotMutex_HEADER <platform/iot_threads.h>
 #define AiaMutex_t AiaMutex( t )
 /** @} */
+#else
+
+/**
+ * @name Instrumented mutexes.
+ *
+ * When built with @c AIA_ENABLE_MUTEX_STATS (the @c AIA_MUTEX_STATS CMake
+ * option), every @c AiaMutex_t wraps an @c IotMutex_t and counts its
+ * acquisitions, the acquisitions which had to wait for another thread, and
+ * the time spent waiting for and holding it. Mutexes are named by the file
+ * and line that created them, so all the instances of a component, such as
+ * the mutex of every @c AiaRegulator_t, are counted together.
+ *
+ * Counters are cumulative since the first mutex of a site was created and
+ * wrap on overflow, like the ones of @c AiaClient_GetMetrics(). Each
+ * acquisition costs two reads of the monotonic clock and a few atomic
+ * operations, which skews timings of the locks it measures slightly, so this
+ * is meant for profiling builds.
+ */
+/** @{ */
+
+/** The maximum number of sites tracked. Mutexes created from any further
+ * sites are counted against the last, whose file is "other". */
+#define AIA_MUTEX_STATS_MAX_SITES 64
+
+/** Lock usage of all the mutexes created from one site. */
+typedef struct AiaMutexStats
+{
+    /** The file which created the mutexes. */
+    const char* file;
+
+    /** The line of @c file which created the mutexes. */
+    uint32_t line;
+
+    /** The number of mutexes created. */
+    uint32_t instances;
+
+    /** The number of times a mutex was acquired. Recursive acquisitions by
+     * the thread already holding it are not counted. */
+    uint32_t acquisitions;
+
+    /** The number of acquisitions which waited for another thread. */
+    uint32_t contendedAcquisitions;
+
+    /** The total time spent waiting by contended acquisitions, in
+     * microseconds. */
+    uint32_t totalWaitUs;
+
+    /** The longest time spent waiting by an acquisition, in microseconds. */
+    uint32_t maxWaitUs;
+
+    /** The total time a mutex was held, in microseconds. */
+    uint32_t totalHoldUs;
+
+    /** The longest time a mutex was held, in microseconds. */
+    uint32_t maxHoldUs;
+} AiaMutexStats_t;
+
+/** A mutex whose usage is counted. Treat as opaque. */
+typedef struct AiaMutexStatsMutex
+{
+    /** The underlying mutex. */
+    IotMutex_t mutex;
+
+    /** The counters of the site which created the mutex. */
+    AiaMutexStats_t* stats;
+
+    /** How many times the thread holding the mutex acquired it. */
+    uint32_t depth;
+
+    /** When the mutex was acquired by the thread holding it. */
+    uint64_t acquiredUs;
+} AiaMutex_t;
+
+/**
+ * Creates a mutex on behalf of a site. Use @c AiaMutex( Create ) rather than
+ * calling this directly.
+ *
+ * @param mutex The mutex to initialize.
+ * @param recursive Whether the mutex may be acquired recursively.
+ * @param file The file creating the mutex.
+ * @param line The line of @c file creating the mutex.
+ * @return @c true if the mutex was created, else @c false.
+ */
+bool AiaMutexStats_CreateMutex( AiaMutex_t* mutex, bool recursive,
+                                const char* file, uint32_t line );
+
+/**
+ * Destroys a mutex.
+ *
+ * @param mutex The mutex to destroy.
+ */
+void AiaMutexStats_MutexDestroy( AiaMutex_t* mutex );
+
+/**
+ * Acquires a mutex, blocking until it is available.
+ *
+ * @param mutex The mutex to acquire.
+ */
+void AiaMutexStats_MutexLock( AiaMutex_t* mutex );
+
+/**
+ * Releases a mutex.
+ *
+ * @param mutex The mutex to release.
+ */
+void AiaMutexStats_MutexUnlock( AiaMutex_t* mutex );
+
+/**
+ * Takes a snapshot of lock usage.
+ *
+ * @param[out] sites Usage of each site, in the order they first created a
+ * mutex, if non-@c NULL.
+ * @param maxSites The number of elements in @c sites.
+ * @return The number of sites tracked, which may be more than @c maxSites.
+ */
+size_t AiaMutexStats_Get( AiaMutexStats_t* sites, size_t maxSites );
+
+#define AiaMutex( MEMBER ) AiaMutexStats_Mutex##MEMBER
+#define AiaMutexStats_MutexHEADER <iot/aia_iot_config.h>
+#define AiaMutexStats_MutexCreate( mutex, recursive ) \
+    AiaMutexStats_CreateMutex( mutex, recursive, __FILE__, __LINE__ )
+/** @} */
+
+#endif /* AIA_ENABLE_MUTEX_STATS */
 
 /** Macros for Semaphores. */
 /** @{ */
@@ -297,9 +630,197 @@ static inline AiaAtomicBool_t AiaAtomicBool_Load( AiaAtomicBool_t* operand )
 #define IotListDouble_ForEach IotContainers_ForEach
 /** @} */
 
-#define AiaClock( MEMBER ) IotClock_##MEMBER
 #define IotClock_HEADER <platform/iot_clock.h>
 
+#ifndef AIA_ENABLE_VIRTUAL_TIME
+#define AiaClock( MEMBER ) IotClock_##MEMBER
+#else
+
+#if defined( AIA_ENABLE_SHARED_TIMERS ) || \
+    defined( AIA_ENABLE_REALTIME_TIMERS )
+#error "AIA_ENABLE_VIRTUAL_TIME replaces the shared and realtime timers."
+#endif
+
+#include <iot_linear_containers.h>
+
+/**
+ * @name Virtual time.
+ *
+ * When built with @c AIA_ENABLE_VIRTUAL_TIME (the @c AIA_VIRTUAL_TIME CMake
+ * option), @c AiaClock( GetTimeMs ) returns a simulated clock which only moves
+ * when the application advances it, and every @c AiaTimer_t expiration and
+ * deferred task pool job is an event on a deterministic event loop driven by
+ * that clock.  @c AiaVirtualTime_RunUntil() jumps from one deadline to the
+ * next, running each routine on the calling thread in deadline order, so
+ * days of alerts, sequencer timeouts, backoff and offline alert checks
+ * simulate in as long as their routines take to run.  This is meant for soak
+ * and simulation builds, never for devices.
+ *
+ * @c AiaClock( SleepMs ) advances the clock by running the loop, unless the
+ * loop is already being run (from a routine, or another thread), in which case
+ * it only moves the clock forward.  Task pool jobs scheduled without a delay,
+ * semaphore timeouts and the timers internal to the IoT SDK still run in real
+ * time.
+ */
+/** @{ */
+
+/** Value of the virtual clock at startup, away from zero so that code
+ * subtracting durations from the current time does not wrap. */
+#ifndef AIA_VIRTUAL_TIME_START_MS
+#define AIA_VIRTUAL_TIME_START_MS 1000000
+#endif
+
+/** A timer driven by the virtual clock.  Treat as opaque. */
+typedef struct AiaVirtualTimeTimer
+{
+    /** Link in the deadline queue. */
+    AiaListDouble( Link_t ) link;
+
+    /** Routine to run on expiration. */
+    void ( *routine )( void* );
+
+    /** Argument passed to @c routine. */
+    void* context;
+
+    /** Virtual time of the next expiration. */
+    AiaTimepointMs_t deadlineMs;
+
+    /** Period of subsequent expirations, or zero for a one-shot timer. */
+    uint32_t periodMs;
+
+    /** Set while the timer is in the deadline queue. */
+    bool isArmed;
+
+    /** Set while the event loop is running @c routine. */
+    bool isRunning;
+
+    /** Set between creation and destruction. */
+    bool isCreated;
+} AiaTimer_t;
+
+/**
+ * Returns the current virtual time.
+ *
+ * @return Milliseconds on the virtual clock, starting at @c
+ * AIA_VIRTUAL_TIME_START_MS.
+ */
+AiaTimepointMs_t AiaVirtualTime_GetTimeMs();
+
+/**
+ * Advances the virtual clock by @c sleepTimeMs, see the description above.
+ *
+ * @param sleepTimeMs The duration to advance the clock by.
+ */
+void AiaVirtualTime_SleepMs( uint32_t sleepTimeMs );
+
+/**
+ * Runs the routines of every timer and deferred job due at or before @c
+ * timepoint in deadline order, advancing the clock to each deadline, then
+ * leaves the clock at @c timepoint (or later, if it already was).  Routines
+ * which arm timers due before @c timepoint are run by the same call.  If
+ * another thread is running the loop, this only moves the clock forward.
+ *
+ * @param timepoint The virtual time to advance to.
+ * @return The number of routines run.
+ */
+size_t AiaVirtualTime_RunUntil( AiaTimepointMs_t timepoint );
+
+/**
+ * Shorthand for @c AiaVirtualTime_RunUntil() @c durationMs from now.
+ *
+ * @param durationMs The duration to advance the clock by.
+ * @return The number of routines run.
+ */
+size_t AiaVirtualTime_RunFor( AiaDurationMs_t durationMs );
+
+/**
+ * Jumps the clock to the earliest pending deadline and runs every routine due
+ * at that time.
+ *
+ * @return @c false if nothing was pending or another thread is running the
+ * loop, else @c true.
+ */
+bool AiaVirtualTime_RunNext();
+
+/**
+ * Creates a disarmed timer.
+ *
+ * @param timer The timer to initialize.
+ * @param routine Routine to run on expiration.
+ * @param context Argument passed to @c routine.
+ * @return @c true on success, else @c false.
+ */
+bool AiaVirtualTime_TimerCreate( AiaTimer_t* timer, void ( *routine )( void* ),
+                                 void* context );
+
+/**
+ * (Re)arms a timer, cancelling any pending expiration.
+ *
+ * @param timer The timer to arm.
+ * @param relativeTimeoutMs Virtual delay until the first expiration.  Zero
+ * runs the routine the next time the loop runs, without advancing the clock.
+ * @param periodMs Period of subsequent expirations, or zero for one-shot.
+ * @return @c true on success, else @c false.
+ */
+bool AiaVirtualTime_TimerArm( AiaTimer_t* timer, uint32_t relativeTimeoutMs,
+                              uint32_t periodMs );
+
+/**
+ * Destroys a timer.  If its routine is running, this waits for it to return
+ * unless called from the routine itself.
+ *
+ * @param timer The timer to destroy.
+ */
+void AiaVirtualTime_TimerDestroy( AiaTimer_t* timer );
+
+/**
+ * Creates a task pool job, as @c IotTaskPool_CreateJob() does, and remembers
+ * its routine so that a deferred schedule can run it in virtual time.
+ */
+IotTaskPoolError_t AiaVirtualTime_TaskPoolCreateJob(
+    IotTaskPoolRoutine_t userCallback, void* pUserContext,
+    IotTaskPoolJobStorage_t* const pJobStorage, IotTaskPoolJob_t* const pJob );
+
+/**
+ * Runs a job created with @c AiaVirtualTime_TaskPoolCreateJob() on the event
+ * loop once @c timeMs have passed on the virtual clock.
+ */
+IotTaskPoolError_t AiaVirtualTime_TaskPoolScheduleDeferred(
+    IotTaskPool_t taskPool, IotTaskPoolJob_t job, uint32_t timeMs );
+
+/**
+ * Cancels a job scheduled with @c AiaVirtualTime_TaskPoolScheduleDeferred(),
+ * failing with @c IOT_TASKPOOL_CANCEL_FAILED if it is already running or done.
+ * Other jobs are passed to @c IotTaskPool_TryCancel().
+ */
+IotTaskPoolError_t AiaVirtualTime_TaskPoolTryCancel(
+    IotTaskPool_t taskPool, IotTaskPoolJob_t job,
+    IotTaskPoolJobStatus_t* const pStatus );
+
+#define AiaClock( MEMBER ) AiaVirtualTime_##MEMBER
+#define AiaVirtualTime_HEADER <iot/aia_iot_config.h>
+#define AiaTimer( MEMBER ) AiaVirtualTime_Timer##MEMBER
+#define AiaVirtualTime_TimerHEADER <iot/aia_iot_config.h>
+#define AiaVirtualTime_TaskPoolt IotTaskPool_t
+#define AiaVirtualTime_TaskPoolHEADER IotTaskPool_HEADER
+#define AiaVirtualTime_TaskPoolINITIALIZER IotTaskPool_INITIALIZER
+#define AiaVirtualTime_TaskPoolINFO_INITIALIZER IotTaskPool_INFO_INITIALIZER
+#define AiaVirtualTime_TaskPoolJOB_STORAGE_INITIALIZER \
+    IotTaskPool_JOB_STORAGE_INITIALIZER
+#define AiaVirtualTime_TaskPoolJOB_INITIALIZER IotTaskPool_JOB_INITIALIZER
+#define AiaVirtualTime_TaskPoolCreateSystemTaskPool \
+    IotTaskPool_CreateSystemTaskPool
+#define AiaVirtualTime_TaskPoolGetSystemTaskPool IotTaskPool_GetSystemTaskPool
+#define AiaVirtualTime_TaskPoolCreate IotTaskPool_Create
+#define AiaVirtualTime_TaskPoolDestroy IotTaskPool_Destroy
+#define AiaVirtualTime_TaskPoolSchedule IotTaskPool_Schedule
+#define AiaVirtualTime_TaskPoolstrerror IotTaskPool_strerror
+/** @} */
+
+#endif /* AIA_ENABLE_VIRTUAL_TIME */
+
+#if !defined( AIA_ENABLE_SHARED_TIMERS ) && \
+    !defined( AIA_ENABLE_VIRTUAL_TIME )
 /** Macros and typedefs for timers. */
 /** @{ */
 #define AiaTimerConcat( MEMBER ) AiaClock( Timer##MEMBER )
@@ -307,6 +828,298 @@ static inline AiaAtomicBool_t AiaAtomicBool_Load( AiaAtomicBool_t* operand )
 #define IotClock_TimerHEADER IotClock_HEADER
 typedef IotTimer_t AiaTimer_t;
 /** @} */
+#elif defined( AIA_ENABLE_SHARED_TIMERS )
+
+#include <iot_linear_containers.h>
+
+/**
+ * @name Shared timer service.
+ *
+ * When built with @c AIA_ENABLE_SHARED_TIMERS (the @c AIA_SHARED_TIMERS CMake
+ * option), every @c AiaTimer_t in the process is driven by a single
+ * hierarchical timer wheel advanced by one tick thread, and expirations run on
+ * a fixed pool of worker threads rather than a platform timer (and often a
+ * thread) per expiration.  Thread count and timer overhead are therefore
+ * independent of the number of @c AiaClient_t instances, which suits gateways
+ * hosting many device sessions in one process.
+ *
+ * Timers belong to a group, normally the @c AiaClient_t that created them.
+ * Workers take expirations round-robin across groups, so a client with a burst
+ * of expirations cannot starve the others.  A timer joins the calling thread's
+ * current group when it is created: @c AiaClient_Create() sets this for the
+ * timers it creates, and workers set it while running a timer's routine.
+ * Applications calling into a client from their own threads may set it with
+ * @c AiaTimerService_SetCurrentGroup().
+ *
+ * @c AiaTimerService_Init() must be called before the first @c AiaTimer_t is
+ * created.  The task pool passed to @c AiaClient_Create() may likewise be
+ * shared by all clients.
+ *
+ * On many-core hosts @c AiaTimerService_InitShards() instead splits the
+ * service into shards, each with its own wheel, lock, tick thread and workers,
+ * optionally pinned to one CPU per shard.  A group lives on one shard for its
+ * lifetime: the calling thread's current shard when its first timer is
+ * created (see @c AiaTimerService_SetCurrentShard()), else the shard with the
+ * fewest groups.  Service threads make their own shard current, so timers
+ * created by a routine stay on its shard.  Applications which also give each
+ * shard its own task pool, and call @c AiaTimerService_SetCurrentShard()
+ * before @c AiaClient_Create(), keep a client's timer and task work on one
+ * core.
+ */
+/** @{ */
+
+/** Resolution of the timer wheel. */
+#ifndef AIA_TIMER_SERVICE_TICK_MS
+#define AIA_TIMER_SERVICE_TICK_MS 5
+#endif
+
+/** Number of worker threads used when zero is passed to @c
+ * AiaTimerService_Init(). */
+#define AIA_TIMER_SERVICE_DEFAULT_WORKERS 4
+
+/** Passed to @c AiaTimerService_InitShards() to leave threads unpinned. */
+#define AIA_TIMER_SERVICE_ANY_CPU -1
+
+/** Passed to @c AiaTimerService_SetCurrentShard() to let the service place
+ * new groups. */
+#define AIA_TIMER_SERVICE_ANY_SHARD SIZE_MAX
+
+struct AiaTimerServiceGroup;
+
+/** A timer driven by the shared timer service.  Treat as opaque. */
+typedef struct AiaTimerServiceTimer
+{
+    /** Link in a wheel slot or a group's ready list. */
+    AiaListDouble( Link_t ) link;
+
+    /** Routine to run on expiration. */
+    void ( *routine )( void* );
+
+    /** Argument passed to @c routine. */
+    void* context;
+
+    /** Wheel tick at which the timer next expires. */
+    uint64_t expiryTick;
+
+    /** Period in ticks, or zero for a one-shot timer. */
+    uint32_t periodTicks;
+
+    /** One of the internal timer states. */
+    uint8_t state;
+
+    /** Set while a worker is running @c routine. */
+    bool isRunning;
+
+    /** Set if the timer expired again while @c routine was running. */
+    bool isRunPending;
+
+    /** The group the timer belongs to. */
+    struct AiaTimerServiceGroup* group;
+} AiaTimer_t;
+
+/**
+ * Starts the tick thread and worker pool.
+ *
+ * @param numWorkers Number of worker threads, or zero for @c
+ * AIA_TIMER_SERVICE_DEFAULT_WORKERS.
+ * @return @c true if the service is running, else @c false.
+ */
+bool AiaTimerService_Init( size_t numWorkers );
+
+/**
+ * Starts the service as independent shards.
+ *
+ * @param numShards Number of shards, typically one per core serving clients.
+ * @param numWorkers Number of worker threads per shard, or zero for one per
+ * shard (or @c AIA_TIMER_SERVICE_DEFAULT_WORKERS if @c numShards is one).
+ * @param firstCpu CPU to pin shard 0's threads to, with shard @c i pinned to
+ * @c firstCpu + @c i, or @c AIA_TIMER_SERVICE_ANY_CPU.  Pinning is only
+ * supported on Linux.
+ * @return @c true if the service is running, else @c false.
+ */
+bool AiaTimerService_InitShards( size_t numShards, size_t numWorkers,
+                                 int firstCpu );
+
+/**
+ * Stops the tick thread and worker pool.  All timers must have been destroyed.
+ */
+void AiaTimerService_Shutdown( void );
+
+/**
+ * Sets the group that timers created on the calling thread join.
+ *
+ * @param group Identifies the group, typically the owning @c AiaClient_t.
+ * @return The calling thread's previous group.
+ */
+const void* AiaTimerService_SetCurrentGroup( const void* group );
+
+/**
+ * Sets the shard that groups first created on the calling thread are placed
+ * on.  Has no effect on groups which already exist.
+ *
+ * @param shard Index of the shard, or @c AIA_TIMER_SERVICE_ANY_SHARD.
+ * @return The calling thread's previous shard.
+ */
+size_t AiaTimerService_SetCurrentShard( size_t shard );
+
+/**
+ * Creates a disarmed timer.
+ *
+ * @param timer The timer to initialize.
+ * @param routine Routine to run on expiration.
+ * @param context Argument passed to @c routine.
+ * @return @c true on success, else @c false.
+ */
+bool AiaTimerService_TimerCreate( AiaTimer_t* timer, void ( *routine )( void* ),
+                                  void* context );
+
+/**
+ * (Re)arms a timer, cancelling any pending expiration.
+ *
+ * @param timer The timer to arm.
+ * @param relativeTimeoutMs Delay until the first expiration.  Zero runs the
+ * routine as soon as a worker is available.
+ * @param periodMs Period of subsequent expirations, or zero for one-shot.
+ * @return @c true on success, else @c false.
+ */
+bool AiaTimerService_TimerArm( AiaTimer_t* timer, uint32_t relativeTimeoutMs,
+                               uint32_t periodMs );
+
+/**
+ * Destroys a timer.  If its routine is running on another thread, this waits
+ * for it to return.  A routine may destroy its own timer, which may then be
+ * freed before the routine returns.
+ *
+ * @param timer The timer to destroy.
+ */
+void AiaTimerService_TimerDestroy( AiaTimer_t* timer );
+
+#define AiaTimer( MEMBER ) AiaTimerService_Timer##MEMBER
+#define AiaTimerService_TimerHEADER <iot/aia_iot_config.h>
+/** @} */
+
+#endif /* AIA_ENABLE_SHARED_TIMERS */
+
+#ifndef AIA_ENABLE_REALTIME_TIMERS
+/** Macros and typedefs for audio-critical timers, which are regular timers
+ * unless @c AIA_ENABLE_REALTIME_TIMERS is defined. */
+/** @{ */
+#define AiaRealtimeTimer( MEMBER ) AiaTimer( MEMBER )
+typedef AiaTimer_t AiaRealtimeTimer_t;
+/** @} */
+#else
+
+#include <iot_linear_containers.h>
+
+/**
+ * @name Realtime scheduler.
+ *
+ * When built with @c AIA_ENABLE_REALTIME_TIMERS (the @c AIA_REALTIME_TIMERS
+ * CMake option), the timers that pace audio (the regulators' emits and the
+ * speaker manager's frame pushes) are @c AiaRealtimeTimer_t instances driven by
+ * one dedicated scheduler thread.  The thread keeps a queue of armed timers
+ * ordered by deadline and runs each routine itself, so audio timing is not
+ * delayed by alerts, sequencer timeouts or other background timers sharing the
+ * regular timer threads.  The thread can be given a realtime priority and
+ * pinned to a CPU.
+ *
+ * Routines run one at a time on the scheduler thread, so they must not block.
+ *
+ * @c AiaRealtimeScheduler_Init() must be called before the first @c
+ * AiaRealtimeTimer_t is created.
+ */
+/** @{ */
+
+/** Passed to @c AiaRealtimeScheduler_Init() to leave the thread's scheduling
+ * priority unchanged. */
+#define AIA_REALTIME_SCHEDULER_DEFAULT_PRIORITY 0
+
+/** Passed to @c AiaRealtimeScheduler_Init() to let the thread run on any
+ * CPU. */
+#define AIA_REALTIME_SCHEDULER_ANY_CPU -1
+
+/** A timer driven by the realtime scheduler.  Treat as opaque. */
+typedef struct AiaRealtimeSchedulerTimer
+{
+    /** Link in the scheduler's deadline queue. */
+    AiaListDouble( Link_t ) link;
+
+    /** Routine to run on expiration. */
+    void ( *routine )( void* );
+
+    /** Argument passed to @c routine. */
+    void* context;
+
+    /** Monotonic time at which the timer next expires. */
+    uint64_t deadlineMs;
+
+    /** Period in milliseconds, or zero for a one-shot timer. */
+    uint32_t periodMs;
+
+    /** Set while the timer is in the deadline queue. */
+    bool isArmed;
+
+    /** Set while the scheduler thread is running @c routine. */
+    bool isRunning;
+
+    /** Set once the timer has been created and until it is destroyed. */
+    bool isCreated;
+} AiaRealtimeTimer_t;
+
+/**
+ * Starts the scheduler thread.
+ *
+ * @param priority @c SCHED_FIFO priority for the thread, or @c
+ * AIA_REALTIME_SCHEDULER_DEFAULT_PRIORITY to keep the default policy.
+ * @param cpu CPU to pin the thread to, or @c AIA_REALTIME_SCHEDULER_ANY_CPU.
+ * @return @c true if the scheduler is running, else @c false.
+ * @note Failing to apply @c priority or @c cpu (e.g. for lack of privileges)
+ * is logged but does not fail initialization.
+ */
+bool AiaRealtimeScheduler_Init( int priority, int cpu );
+
+/**
+ * Stops the scheduler thread.  All timers must have been destroyed.
+ */
+void AiaRealtimeScheduler_Shutdown( void );
+
+/**
+ * Creates a disarmed timer.
+ *
+ * @param timer The timer to initialize.
+ * @param routine Routine to run on expiration.
+ * @param context Argument passed to @c routine.
+ * @return @c true on success, else @c false.
+ */
+bool AiaRealtimeScheduler_TimerCreate( AiaRealtimeTimer_t* timer,
+                                       void ( *routine )( void* ),
+                                       void* context );
+
+/**
+ * (Re)arms a timer, cancelling any pending expiration.
+ *
+ * @param timer The timer to arm.
+ * @param relativeTimeoutMs Delay until the first expiration.
+ * @param periodMs Period of subsequent expirations, or zero for one-shot.
+ * @return @c true on success, else @c false.
+ */
+bool AiaRealtimeScheduler_TimerArm( AiaRealtimeTimer_t* timer,
+                                    uint32_t relativeTimeoutMs,
+                                    uint32_t periodMs );
+
+/**
+ * Destroys a timer.  If its routine is running, this waits for it to return
+ * unless called from the routine itself.
+ *
+ * @param timer The timer to destroy.
+ */
+void AiaRealtimeScheduler_TimerDestroy( AiaRealtimeTimer_t* timer );
+
+#define AiaRealtimeTimer( MEMBER ) AiaRealtimeScheduler_Timer##MEMBER
+#define AiaRealtimeScheduler_TimerHEADER <iot/aia_iot_config.h>
+/** @} */
+
+#endif /* AIA_ENABLE_REALTIME_TIMERS */
 
 /**
  * Typedefs to handle MQTT communications.
@@ -316,6 +1129,7 @@ typedef IotMqttConnection_t AiaMqttConnectionPointer_t;
 typedef IotMqttQos_t AiaMqttQos_t;
 typedef IotMqttCallbackParam_t AiaMqttCallbackParam_t;
 static const AiaMqttQos_t AIA_MQTT_QOS0 = IOT_MQTT_QOS_0;
+static const AiaMqttQos_t AIA_MQTT_QOS1 = IOT_MQTT_QOS_1;
 /** @} */
 
 /**
@@ -323,6 +1137,19 @@ static const AiaMqttQos_t AIA_MQTT_QOS0 = IOT_MQTT_QOS_0;
  */
 #define MQTT_TIMEOUT_MS 5000
 
+/**
+ * MQTT keepalive intervals, in seconds, chosen by @c
+ * AiaClient_GetMqttKeepAliveSeconds() when connecting.  The active interval is
+ * used while an interaction is in progress or messages were published within
+ * the last active interval; the quiet interval is used otherwise, to cut
+ * PINGREQ traffic on idle devices.  AWS IoT accepts keepalives of up to 1200
+ * seconds.
+ */
+/** @{ */
+#define AIA_MQTT_KEEPALIVE_ACTIVE_SECONDS 60
+#define AIA_MQTT_KEEPALIVE_QUIET_SECONDS 1200
+/** @} */
+
 /**
  * Retry for QOS 1 MQTT operations.
  */
@@ -336,6 +1163,16 @@ static const size_t MQTT_RETRY_LIMIT = 10;
  */
 typedef void ( *AiaMqttTopicHandler_t )( void*, AiaMqttCallbackParam_t* );
 
+/**
+ * Following type is used to hand several messages received on one topic to
+ * their handler at once, e.g. publishes which a receive task drained from the
+ * network back to back, in the order they were received. The messages only
+ * need to remain valid for the duration of the call.
+ */
+typedef void ( *AiaMqttBatchTopicHandler_t )( void*,
+                                              AiaMqttCallbackParam_t* const*,
+                                              size_t );
+
 /**
  * Subscribes to a given MQTT connection topic with the provided parameters.
  *
@@ -411,6 +1248,39 @@ bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
                      const char* topic, size_t topicLength, const void* message,
                      size_t messageLength );
 
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/**
+ * The most bytes an MQTT PUBLISH packet adds in front of its payload: the
+ * fixed header (a type byte and up to four bytes of remaining length), the
+ * length-prefixed topic and a packet identifier.
+ *
+ * @param topicLength The length of the topic the packet is published to.
+ */
+#define AIA_MQTT_PUBLISH_HEADROOM( topicLength ) \
+    ( 1 + 4 + 2 + ( topicLength ) + 2 )
+
+/**
+ * Publishes to a given MQTT topic like @c AiaMqttPublish(), but frames the
+ * PUBLISH packet in the bytes reserved in front of @c message so that a QoS 0
+ * packet is sent with a single write and without copying @c message into a
+ * packet buffer. QoS 1 messages are handed to @c AiaMqttPublish(), since the
+ * MQTT library must keep those for retransmission.
+ *
+ * @param connection Pointer to the MQTT connection to use for the publish.
+ * @param qos Quality of Service for publish.
+ * @param topic The topic to publish to.
+ * @param topicLength The length of @c topic.
+ * @param message The message to publish, preceded by at least @c
+ *     AIA_MQTT_PUBLISH_HEADROOM( topicLength ) bytes which may be overwritten.
+ * @param messageLength The length of @c message.
+ * @return @c true if publish is successful, else @c false.
+ */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,10 @@
 
 #include <iot/aia_iot_config.h>
 
+#ifdef AIA_ENABLE_OVERLOAD_GOVERNOR
+uint32_t g_aiaLogDebugShed;
+#endif
+
 bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
                      const char* topic, size_t topicLength, const void* message,
                      size_t messageLength )
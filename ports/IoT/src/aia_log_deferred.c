@@ -0,0 +1,599 @@
+/*
+ * Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_log_deferred.c
+ * @brief Lock-free binary log ring used when @c AIA_ENABLE_DEFERRED_LOGGING is
+ * defined.
+ */
+
+#include <iot/aia_iot_config.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if( AIA_LOG_DEFERRED_RING_SIZE & ( AIA_LOG_DEFERRED_RING_SIZE - 1 ) ) != 0
+#error "AIA_LOG_DEFERRED_RING_SIZE must be a power of two."
+#endif
+
+/** Marks a ring slot which is currently being written. */
+#define AIA_LOG_DEFERRED_SLOT_BUSY 0
+
+/** How a conversion's value is captured. */
+typedef enum AiaLogDeferredArgType
+{
+    AIA_LOG_DEFERRED_ARG_NONE,
+    AIA_LOG_DEFERRED_ARG_SIGNED,
+    AIA_LOG_DEFERRED_ARG_UNSIGNED,
+    AIA_LOG_DEFERRED_ARG_DOUBLE,
+    AIA_LOG_DEFERRED_ARG_POINTER,
+    AIA_LOG_DEFERRED_ARG_STRING,
+    AIA_LOG_DEFERRED_ARG_UNSUPPORTED
+} AiaLogDeferredArgType_t;
+
+/** Length modifiers which change how a vararg must be read. */
+typedef enum AiaLogDeferredLength
+{
+    AIA_LOG_DEFERRED_LENGTH_DEFAULT,
+    AIA_LOG_DEFERRED_LENGTH_LONG,
+    AIA_LOG_DEFERRED_LENGTH_LONG_LONG,
+    AIA_LOG_DEFERRED_LENGTH_INTMAX,
+    AIA_LOG_DEFERRED_LENGTH_SIZE,
+    AIA_LOG_DEFERRED_LENGTH_PTRDIFF,
+    AIA_LOG_DEFERRED_LENGTH_LONG_DOUBLE
+} AiaLogDeferredLength_t;
+
+/** A parsed printf conversion specification. */
+typedef struct AiaLogDeferredSpec
+{
+    /** First character after the '%'. */
+    const char* flags;
+
+    /** Number of flag characters. */
+    size_t flagsLength;
+
+    /** Literal width text, if any and not '*'. */
+    const char* width;
+
+    /** Number of characters in @c width. */
+    size_t widthLength;
+
+    /** Set if the width is passed as an argument. */
+    bool widthStar;
+
+    /** Set if a precision was given. */
+    bool hasPrecision;
+
+    /** Literal precision, if given and not '*'. */
+    int precision;
+
+    /** Set if the precision is passed as an argument. */
+    bool precisionStar;
+
+    /** The length modifier. */
+    AiaLogDeferredLength_t length;
+
+    /** The conversion character. */
+    char conversion;
+
+    /** How the value is captured. */
+    AiaLogDeferredArgType_t type;
+
+    /** First character after the specification. */
+    const char* end;
+} AiaLogDeferredSpec_t;
+
+/** The ring of records. */
+static AiaLogDeferredRecord_t
+    g_aiaLogDeferredRing[ AIA_LOG_DEFERRED_RING_SIZE ];
+
+/** Ticket of the next record to be written, shared by all producers. */
+static uint32_t g_aiaLogDeferredNextTicket;
+
+/** Ticket of the next record to be drained, owned by the consumer. */
+static uint32_t g_aiaLogDeferredNextRead;
+
+/**
+ * Parses the conversion specification following a '%'.
+ *
+ * @param spec Points at the character following the '%'.
+ * @param[out] out The parsed specification.
+ */
+static void AiaLogDeferred_ParseSpec( const char* spec,
+                                      AiaLogDeferredSpec_t* out )
+{
+    memset( out, 0, sizeof( *out ) );
+
+    out->flags = spec;
+    while( *spec && strchr( "-+ #0", *spec ) )
+    {
+        ++spec;
+    }
+    out->flagsLength = spec - out->flags;
+
+    if( *spec == '*' )
+    {
+        out->widthStar = true;
+        ++spec;
+    }
+    else
+    {
+        out->width = spec;
+        while( *spec >= '0' && *spec <= '9' )
+        {
+            ++spec;
+        }
+        out->widthLength = spec - out->width;
+    }
+
+    if( *spec == '.' )
+    {
+        out->hasPrecision = true;
+        ++spec;
+        if( *spec == '*' )
+        {
+            out->precisionStar = true;
+            ++spec;
+        }
+        else
+        {
+            while( *spec >= '0' && *spec <= '9' )
+            {
+                out->precision = out->precision * 10 + ( *spec - '0' );
+                ++spec;
+            }
+        }
+    }
+
+    switch( *spec )
+    {
+        case 'h':
+            ++spec;
+            if( *spec == 'h' )
+            {
+                ++spec;
+            }
+            break;
+        case 'l':
+            ++spec;
+            out->length = AIA_LOG_DEFERRED_LENGTH_LONG;
+            if( *spec == 'l' )
+            {
+                ++spec;
+                out->length = AIA_LOG_DEFERRED_LENGTH_LONG_LONG;
+            }
+            break;
+        case 'j':
+            ++spec;
+            out->length = AIA_LOG_DEFERRED_LENGTH_INTMAX;
+            break;
+        case 'z':
+            ++spec;
+            out->length = AIA_LOG_DEFERRED_LENGTH_SIZE;
+            break;
+        case 't':
+            ++spec;
+            out->length = AIA_LOG_DEFERRED_LENGTH_PTRDIFF;
+            break;
+        case 'L':
+            ++spec;
+            out->length = AIA_LOG_DEFERRED_LENGTH_LONG_DOUBLE;
+            break;
+        default:
+            break;
+    }
+
+    out->conversion = *spec;
+    switch( *spec )
+    {
+        case '%':
+            out->type = AIA_LOG_DEFERRED_ARG_NONE;
+            break;
+        case 'd':
+        case 'i':
+            out->type = AIA_LOG_DEFERRED_ARG_SIGNED;
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+            out->type = AIA_LOG_DEFERRED_ARG_UNSIGNED;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            out->type = out->length == AIA_LOG_DEFERRED_LENGTH_LONG_DOUBLE
+                            ? AIA_LOG_DEFERRED_ARG_UNSUPPORTED
+                            : AIA_LOG_DEFERRED_ARG_DOUBLE;
+            break;
+        case 'p':
+            out->type = AIA_LOG_DEFERRED_ARG_POINTER;
+            break;
+        case 's':
+            out->type = AIA_LOG_DEFERRED_ARG_STRING;
+            break;
+        default:
+            out->type = AIA_LOG_DEFERRED_ARG_UNSUPPORTED;
+            break;
+    }
+    out->end = *spec ? spec + 1 : spec;
+}
+
+/**
+ * Reads an integer vararg of the given length.
+ *
+ * @param args The argument list.
+ * @param length The length modifier of the conversion.
+ * @param isSigned Whether the conversion is signed.
+ * @return The value widened to 64 bits.
+ */
+static uint64_t AiaLogDeferred_ReadInteger( va_list* args,
+                                            AiaLogDeferredLength_t length,
+                                            bool isSigned )
+{
+    switch( length )
+    {
+        case AIA_LOG_DEFERRED_LENGTH_LONG:
+            return isSigned ? (uint64_t)va_arg( *args, long )
+                            : (uint64_t)va_arg( *args, unsigned long );
+        case AIA_LOG_DEFERRED_LENGTH_LONG_LONG:
+            return isSigned ? (uint64_t)va_arg( *args, long long )
+                            : (uint64_t)va_arg( *args, unsigned long long );
+        case AIA_LOG_DEFERRED_LENGTH_INTMAX:
+            return isSigned ? (uint64_t)va_arg( *args, intmax_t )
+                            : (uint64_t)va_arg( *args, uintmax_t );
+        case AIA_LOG_DEFERRED_LENGTH_SIZE:
+            return (uint64_t)va_arg( *args, size_t );
+        case AIA_LOG_DEFERRED_LENGTH_PTRDIFF:
+            return (uint64_t)va_arg( *args, ptrdiff_t );
+        default:
+            return isSigned ? (uint64_t)va_arg( *args, int )
+                            : (uint64_t)va_arg( *args, unsigned int );
+    }
+}
+
+void AiaLogDeferred_Record( int level, const char* format, ... )
+{
+    uint32_t ticket = AiaAtomic_Add_u32( &g_aiaLogDeferredNextTicket, 1 );
+    AiaLogDeferredRecord_t* record =
+        &g_aiaLogDeferredRing[ ticket & ( AIA_LOG_DEFERRED_RING_SIZE - 1 ) ];
+
+    AiaAtomic_Store_u32( &record->sequence, AIA_LOG_DEFERRED_SLOT_BUSY );
+    record->level = (uint8_t)level;
+    record->numArgs = 0;
+    record->stringBytes = 0;
+    record->truncated = 0;
+    record->format = format;
+
+    va_list args;
+    va_start( args, format );
+    const char* cursor = format;
+    while( format && ( cursor = strchr( cursor, '%' ) ) )
+    {
+        AiaLogDeferredSpec_t spec;
+        AiaLogDeferred_ParseSpec( cursor + 1, &spec );
+        cursor = spec.end;
+
+        size_t needed = ( spec.widthStar ? 1 : 0 ) +
+                        ( spec.precisionStar ? 1 : 0 ) +
+                        ( spec.type != AIA_LOG_DEFERRED_ARG_NONE ? 1 : 0 );
+        if( spec.type == AIA_LOG_DEFERRED_ARG_UNSUPPORTED ||
+            record->numArgs + needed > AIA_LOG_DEFERRED_MAX_ARGS )
+        {
+            record->truncated = 1;
+            break;
+        }
+
+        int precision = spec.precision;
+        if( spec.widthStar )
+        {
+            record->args[ record->numArgs++ ] =
+                (uint64_t)(int64_t)va_arg( args, int );
+        }
+        if( spec.precisionStar )
+        {
+            precision = va_arg( args, int );
+            record->args[ record->numArgs++ ] = (uint64_t)(int64_t)precision;
+        }
+
+        switch( spec.type )
+        {
+            case AIA_LOG_DEFERRED_ARG_SIGNED:
+            case AIA_LOG_DEFERRED_ARG_UNSIGNED:
+                record->args[ record->numArgs++ ] = AiaLogDeferred_ReadInteger(
+                    &args, spec.length,
+                    spec.type == AIA_LOG_DEFERRED_ARG_SIGNED );
+                break;
+            case AIA_LOG_DEFERRED_ARG_DOUBLE:
+            {
+                double value = va_arg( args, double );
+                memcpy( &record->args[ record->numArgs++ ], &value,
+                        sizeof( value ) );
+                break;
+            }
+            case AIA_LOG_DEFERRED_ARG_POINTER:
+                record->args[ record->numArgs++ ] =
+                    (uint64_t)(uintptr_t)va_arg( args, void* );
+                break;
+            case AIA_LOG_DEFERRED_ARG_STRING:
+            {
+                /* Strings are copied since they rarely outlive the call. */
+                const char* string = va_arg( args, const char* );
+                size_t available =
+                    AIA_LOG_DEFERRED_MAX_STRING_BYTES - record->stringBytes;
+                size_t length = 0;
+                if( !string )
+                {
+                    string = "(null)";
+                }
+
+                /* With a precision, @c string need not be terminated, so no
+                 * byte at or past the precision may be read. */
+                bool hasBound = spec.hasPrecision && precision >= 0;
+                size_t limit = available;
+                if( hasBound && (size_t)precision < limit )
+                {
+                    limit = (size_t)precision;
+                }
+                while( length < limit && string[ length ] )
+                {
+                    ++length;
+                }
+                if( length == available &&
+                    ( !hasBound || length < (size_t)precision ) &&
+                    string[ length ] )
+                {
+                    record->truncated = 1;
+                }
+                memcpy( record->strings + record->stringBytes, string, length );
+                record->stringBytes += (uint8_t)length;
+                record->args[ record->numArgs++ ] = length;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    va_end( args );
+
+    AiaAtomic_Store_u32( &record->sequence, ticket + 1 );
+}
+
+size_t AiaLogDeferred_Drain( AiaLogDeferredRecord_t* records,
+                             size_t maxRecords )
+{
+    if( !records )
+    {
+        return 0;
+    }
+
+    uint32_t end = AiaAtomic_Load_u32( &g_aiaLogDeferredNextTicket );
+    uint32_t ticket = g_aiaLogDeferredNextRead;
+    if( end - ticket > AIA_LOG_DEFERRED_RING_SIZE )
+    {
+        ticket = end - AIA_LOG_DEFERRED_RING_SIZE;
+    }
+
+    size_t copied = 0;
+    for( ; ticket != end && copied < maxRecords; ++ticket )
+    {
+        AiaLogDeferredRecord_t* slot =
+            &g_aiaLogDeferredRing[ ticket &
+                                   ( AIA_LOG_DEFERRED_RING_SIZE - 1 ) ];
+        uint32_t sequence = AiaAtomic_Load_u32( &slot->sequence );
+        if( sequence == AIA_LOG_DEFERRED_SLOT_BUSY )
+        {
+            /* Still being written; pick it up on the next drain. */
+            break;
+        }
+        if( sequence != ticket + 1 )
+        {
+            /* Overwritten by a newer record. */
+            continue;
+        }
+        records[ copied ] = *slot;
+        if( AiaAtomic_Load_u32( &slot->sequence ) != sequence )
+        {
+            continue;
+        }
+        records[ copied++ ].sequence = sequence;
+    }
+    g_aiaLogDeferredNextRead = ticket;
+
+    return copied;
+}
+
+/**
+ * Advances the write offset into a bounded buffer, clamping on truncation.
+ *
+ * @param bufferSize Size of the destination buffer.
+ * @param[in,out] offset Current length of the text in the buffer.
+ * @param written Return value of the @c snprintf() which produced the text.
+ */
+static void AiaLogDeferred_Advance( size_t bufferSize, size_t* offset,
+                                    int written )
+{
+    if( written < 0 )
+    {
+        return;
+    }
+    *offset += (size_t)written;
+    if( *offset >= bufferSize )
+    {
+        *offset = bufferSize - 1;
+    }
+}
+
+size_t AiaLogDeferred_Decode( const AiaLogDeferredRecord_t* record,
+                              char* buffer, size_t bufferSize )
+{
+    if( !record || !buffer || !bufferSize )
+    {
+        return 0;
+    }
+    buffer[ 0 ] = '\0';
+    if( !record->format )
+    {
+        return 0;
+    }
+
+    size_t offset = 0;
+    size_t arg = 0;
+    size_t stringOffset = 0;
+    const char* cursor = record->format;
+    while( *cursor && offset < bufferSize - 1 )
+    {
+        const char* percent = strchr( cursor, '%' );
+        size_t literal =
+            percent ? (size_t)( percent - cursor ) : strlen( cursor );
+        AiaLogDeferred_Advance( bufferSize, &offset,
+                                snprintf( buffer + offset, bufferSize - offset,
+                                          "%.*s", (int)literal, cursor ) );
+        if( !percent )
+        {
+            break;
+        }
+
+        AiaLogDeferredSpec_t spec;
+        AiaLogDeferred_ParseSpec( percent + 1, &spec );
+        cursor = spec.end;
+        if( spec.type == AIA_LOG_DEFERRED_ARG_NONE )
+        {
+            AiaLogDeferred_Advance(
+                bufferSize, &offset,
+                snprintf( buffer + offset, bufferSize - offset, "%%" ) );
+            continue;
+        }
+        size_t needed = ( spec.widthStar ? 1 : 0 ) +
+                        ( spec.precisionStar ? 1 : 0 ) + 1;
+        if( spec.type == AIA_LOG_DEFERRED_ARG_UNSUPPORTED ||
+            arg + needed > record->numArgs )
+        {
+            break;
+        }
+
+        /* Rebuild the specification with widths resolved and integers
+         * normalized to 64 bits. */
+        char conversion[ 32 ];
+        size_t length = 0;
+        conversion[ length++ ] = '%';
+        memcpy( conversion + length, spec.flags, spec.flagsLength );
+        length += spec.flagsLength;
+        if( spec.widthStar )
+        {
+            length += snprintf( conversion + length,
+                                sizeof( conversion ) - length, "%d",
+                                (int)(int64_t)record->args[ arg++ ] );
+        }
+        else
+        {
+            memcpy( conversion + length, spec.width, spec.widthLength );
+            length += spec.widthLength;
+        }
+        int precision = spec.precision;
+        if( spec.precisionStar )
+        {
+            precision = (int)(int64_t)record->args[ arg++ ];
+        }
+        if( spec.type == AIA_LOG_DEFERRED_ARG_STRING )
+        {
+            length += snprintf( conversion + length,
+                                sizeof( conversion ) - length, ".*s" );
+        }
+        else
+        {
+            if( spec.hasPrecision && precision >= 0 )
+            {
+                length += snprintf( conversion + length,
+                                    sizeof( conversion ) - length, ".%d",
+                                    precision );
+            }
+            if( spec.type == AIA_LOG_DEFERRED_ARG_SIGNED ||
+                ( spec.type == AIA_LOG_DEFERRED_ARG_UNSIGNED &&
+                  spec.conversion != 'c' ) )
+            {
+                conversion[ length++ ] = 'l';
+                conversion[ length++ ] = 'l';
+            }
+            conversion[ length++ ] = spec.conversion;
+        }
+        conversion[ length ] = '\0';
+
+        uint64_t value = record->args[ arg++ ];
+        int written = 0;
+        switch( spec.type )
+        {
+            case AIA_LOG_DEFERRED_ARG_SIGNED:
+                written = snprintf( buffer + offset, bufferSize - offset,
+                                    conversion, (long long)value );
+                break;
+            case AIA_LOG_DEFERRED_ARG_UNSIGNED:
+                if( spec.conversion == 'c' )
+                {
+                    written = snprintf( buffer + offset, bufferSize - offset,
+                                        conversion, (int)value );
+                }
+                else
+                {
+                    written = snprintf( buffer + offset, bufferSize - offset,
+                                        conversion, (unsigned long long)value );
+                }
+                break;
+            case AIA_LOG_DEFERRED_ARG_DOUBLE:
+            {
+                double number;
+                memcpy( &number, &value, sizeof( number ) );
+                written = snprintf( buffer + offset, bufferSize - offset,
+                                    conversion, number );
+                break;
+            }
+            case AIA_LOG_DEFERRED_ARG_POINTER:
+                written = snprintf( buffer + offset, bufferSize - offset,
+                                    conversion, (void*)(uintptr_t)value );
+                break;
+            case AIA_LOG_DEFERRED_ARG_STRING:
+                if( stringOffset + value > record->stringBytes )
+                {
+                    value = record->stringBytes - stringOffset;
+                }
+                written = snprintf( buffer + offset, bufferSize - offset,
+                                    conversion, (int)value,
+                                    record->strings + stringOffset );
+                stringOffset += value;
+                break;
+            default:
+                break;
+        }
+        AiaLogDeferred_Advance( bufferSize, &offset, written );
+    }
+
+    if( record->truncated )
+    {
+        AiaLogDeferred_Advance(
+            bufferSize, &offset,
+            snprintf( buffer + offset, bufferSize - offset, "..." ) );
+    }
+
+    return offset;
+}
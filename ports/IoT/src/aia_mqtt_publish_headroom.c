@@ -0,0 +1,106 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mqtt_publish_headroom.c
+ * @brief In-place MQTT publishing used when @c
+ * AIA_ENABLE_MQTT_PUBLISH_HEADROOM is defined.
+ */
+
+#include <iot/aia_iot_config.h>
+
+/* The MQTT library does not expose its network connection, so the connection
+ * internals are needed to send a packet framed here. */
+#include <standard/mqtt/src/private/iot_mqtt_internal.h>
+
+/** The type and flags byte of a QoS 0 PUBLISH packet. */
+#define AIA_MQTT_PUBLISH_QOS0_HEADER 0x30
+
+/** The largest remaining length an MQTT packet may encode. */
+#define AIA_MQTT_MAX_REMAINING_LENGTH 268435455
+
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    if( !connection )
+    {
+        AiaLogError( "Null connection." );
+        return false;
+    }
+    if( !topic || !topicLength || topicLength > UINT16_MAX )
+    {
+        AiaLogError( "Invalid topic." );
+        return false;
+    }
+    if( !message || !messageLength )
+    {
+        AiaLogError( "Invalid message." );
+        return false;
+    }
+    if( AIA_MQTT_QOS0 != qos )
+    {
+        return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                               messageLength );
+    }
+    size_t remainingLength = 2 + topicLength + messageLength;
+    if( remainingLength > AIA_MQTT_MAX_REMAINING_LENGTH )
+    {
+        AiaLogError( "Message too large, messageLength=%zu.", messageLength );
+        return false;
+    }
+
+    /* Write the topic right in front of the message, then the remaining
+     * length and type byte in front of that. */
+    uint8_t* packet = message - topicLength;
+    memcpy( packet, topic, topicLength );
+    *--packet = (uint8_t)topicLength;
+    *--packet = (uint8_t)( topicLength >> 8 );
+    uint8_t encodedLength[ 4 ];
+    size_t encodedLengthSize = 0;
+    do
+    {
+        encodedLength[ encodedLengthSize ] = remainingLength % 128;
+        remainingLength /= 128;
+        if( remainingLength )
+        {
+            encodedLength[ encodedLengthSize ] |= 0x80;
+        }
+        ++encodedLengthSize;
+    } while( remainingLength );
+    packet -= encodedLengthSize;
+    memcpy( packet, encodedLength, encodedLengthSize );
+    *--packet = AIA_MQTT_PUBLISH_QOS0_HEADER;
+    size_t packetSize = message + messageLength - packet;
+
+    _mqttConnection_t* mqttConnection = (_mqttConnection_t*)connection;
+    if( !_IotMqtt_IncrementConnectionReferences( mqttConnection ) )
+    {
+        AiaLogError( "Connection is closed." );
+        return false;
+    }
+    size_t sent = mqttConnection->pNetworkInterface->send(
+        mqttConnection->pNetworkConnection, packet, packetSize );
+    _IotMqtt_DecrementConnectionReferences( mqttConnection );
+    if( sent != packetSize )
+    {
+        AiaLogError( "Send failed, sent=%zu, packetSize=%zu.", sent,
+                     packetSize );
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mutex_stats.c
+ * @brief Instrumented mutexes used when @c AIA_ENABLE_MUTEX_STATS is defined.
+ */
+
+#include <iot/aia_iot_config.h>
+
+#include <string.h>
+#include <time.h>
+
+/** The file of the site mutexes are counted under once every other slot is
+ * taken. */
+static const char* AIA_MUTEX_STATS_OTHER_SITE = "other";
+
+/** @name Variables synchronized by g_spinLock. */
+/** @{ */
+
+/** Usage per site, of which the first @c g_numSites are in use. Only the file
+ * and line of a site are synchronized, its counters are updated atomically. */
+static AiaMutexStats_t g_sites[ AIA_MUTEX_STATS_MAX_SITES ];
+static size_t g_numSites;
+
+/** @} */
+
+/** Simple spin lock guarding the sites above. It is only taken when a mutex
+ * is created and when statistics are read, never when a mutex is locked. */
+static AiaAtomicBool_t g_spinLock = false;
+
+static void AiaMutexStats_Lock()
+{
+    while( !AiaAtomic_CompareAndSwap_u32( &g_spinLock, 1, 0 ) )
+    {
+        /* spin lock, inefficient */
+    }
+}
+
+static void AiaMutexStats_Unlock()
+{
+    AiaAtomicBool_Clear( &g_spinLock );
+}
+
+/**
+ * @return The time elapsed on the monotonic clock, in microseconds. The
+ * millisecond resolution of @c AiaClock( GetTimeMs ) is too coarse for the
+ * critical sections of the SDK, most of which are held for far less.
+ */
+static uint64_t AiaMutexStats_GetTimeUs()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+/**
+ * Raises @c *max to @c value if it is lower.
+ *
+ * @param[in,out] max The maximum to update.
+ * @param value The new sample.
+ */
+static void AiaMutexStats_UpdateMax( uint32_t* max, uint32_t value )
+{
+    uint32_t current = AiaAtomic_Load_u32( max );
+    while( value > current &&
+           !AiaAtomic_CompareAndSwap_u32( max, value, current ) )
+    {
+        current = AiaAtomic_Load_u32( max );
+    }
+}
+
+/**
+ * Saturates a duration to the range of the counters.
+ *
+ * @param durationUs The duration, in microseconds.
+ * @return @c durationUs, or @c UINT32_MAX if it is larger.
+ */
+static uint32_t AiaMutexStats_ClampDuration( uint64_t durationUs )
+{
+    return durationUs > UINT32_MAX ? UINT32_MAX : (uint32_t)durationUs;
+}
+
+/**
+ * Finds the slot for a site, claiming a new one if needed.
+ * @note Must be called with @c g_spinLock held.
+ *
+ * @param file The file creating a mutex.
+ * @param line The line of @c file creating a mutex.
+ * @return The counters of the site.
+ */
+static AiaMutexStats_t* AiaMutexStats_FindSiteLocked( const char* file,
+                                                      uint32_t line )
+{
+    for( size_t i = 0; i < g_numSites; ++i )
+    {
+        if( g_sites[ i ].line == line && !strcmp( g_sites[ i ].file, file ) )
+        {
+            return &g_sites[ i ];
+        }
+    }
+
+    size_t index = g_numSites;
+    if( index == AIA_MUTEX_STATS_MAX_SITES - 1 )
+    {
+        file = AIA_MUTEX_STATS_OTHER_SITE;
+        line = 0;
+    }
+    else if( index == AIA_MUTEX_STATS_MAX_SITES )
+    {
+        return &g_sites[ AIA_MUTEX_STATS_MAX_SITES - 1 ];
+    }
+    g_sites[ index ].file = file;
+    g_sites[ index ].line = line;
+    ++g_numSites;
+    return &g_sites[ index ];
+}
+
+bool AiaMutexStats_CreateMutex( AiaMutex_t* mutex, bool recursive,
+                                const char* file, uint32_t line )
+{
+    if( !IotMutex_Create( &mutex->mutex, recursive ) )
+    {
+        return false;
+    }
+    AiaMutexStats_Lock();
+    mutex->stats = AiaMutexStats_FindSiteLocked( file, line );
+    AiaMutexStats_Unlock();
+    mutex->depth = 0;
+    mutex->acquiredUs = 0;
+    AiaAtomic_Add_u32( &mutex->stats->instances, 1 );
+    return true;
+}
+
+void AiaMutexStats_MutexDestroy( AiaMutex_t* mutex )
+{
+    IotMutex_Destroy( &mutex->mutex );
+}
+
+void AiaMutexStats_MutexLock( AiaMutex_t* mutex )
+{
+    /* Only acquisitions which find the mutex taken pay for timing the wait. */
+    uint64_t nowUs;
+    if( IotMutex_TryLock( &mutex->mutex ) )
+    {
+        nowUs = AiaMutexStats_GetTimeUs();
+    }
+    else
+    {
+        uint64_t startUs = AiaMutexStats_GetTimeUs();
+        IotMutex_Lock( &mutex->mutex );
+        nowUs = AiaMutexStats_GetTimeUs();
+        uint32_t waitUs = AiaMutexStats_ClampDuration( nowUs - startUs );
+        AiaMutexStats_t* stats = mutex->stats;
+        AiaAtomic_Add_u32( &stats->contendedAcquisitions, 1 );
+        AiaAtomic_Add_u32( &stats->totalWaitUs, waitUs );
+        AiaMutexStats_UpdateMax( &stats->maxWaitUs, waitUs );
+    }
+
+    /* The depth is only touched by the thread holding the mutex. */
+    if( !mutex->depth++ )
+    {
+        mutex->acquiredUs = nowUs;
+        AiaAtomic_Add_u32( &mutex->stats->acquisitions, 1 );
+    }
+}
+
+void AiaMutexStats_MutexUnlock( AiaMutex_t* mutex )
+{
+    if( !--mutex->depth )
+    {
+        uint32_t holdUs = AiaMutexStats_ClampDuration(
+            AiaMutexStats_GetTimeUs() - mutex->acquiredUs );
+        AiaAtomic_Add_u32( &mutex->stats->totalHoldUs, holdUs );
+        AiaMutexStats_UpdateMax( &mutex->stats->maxHoldUs, holdUs );
+    }
+    IotMutex_Unlock( &mutex->mutex );
+}
+
+size_t AiaMutexStats_Get( AiaMutexStats_t* sites, size_t maxSites )
+{
+    AiaMutexStats_Lock();
+    size_t numSites = g_numSites;
+    for( size_t i = 0; sites && i < numSites && i < maxSites; ++i )
+    {
+        AiaMutexStats_t* site = &g_sites[ i ];
+        sites[ i ].file = site->file;
+        sites[ i ].line = site->line;
+        sites[ i ].instances = AiaAtomic_Load_u32( &site->instances );
+        sites[ i ].acquisitions = AiaAtomic_Load_u32( &site->acquisitions );
+        sites[ i ].contendedAcquisitions =
+            AiaAtomic_Load_u32( &site->contendedAcquisitions );
+        sites[ i ].totalWaitUs = AiaAtomic_Load_u32( &site->totalWaitUs );
+        sites[ i ].maxWaitUs = AiaAtomic_Load_u32( &site->maxWaitUs );
+        sites[ i ].totalHoldUs = AiaAtomic_Load_u32( &site->totalHoldUs );
+        sites[ i ].maxHoldUs = AiaAtomic_Load_u32( &site->maxHoldUs );
+    }
+    AiaMutexStats_Unlock();
+    return numSites;
+}
@@ -0,0 +1,350 @@
+/*
+ * Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_realtime_scheduler.c
+ * @brief Dedicated deadline-ordered timer thread used when @c
+ * AIA_ENABLE_REALTIME_TIMERS is defined.
+ */
+
+#ifdef __linux__
+/* For pthread_setaffinity_np(). */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <iot/aia_iot_config.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+
+#include <string.h>
+
+/** Longest time the scheduler thread sleeps without checking for shutdown. */
+#define AIA_REALTIME_SCHEDULER_MAX_SLEEP_MS 1000
+
+/** State of the realtime scheduler. */
+static struct
+{
+    /** Protects everything below. */
+    AiaMutex_t mutex;
+
+    /** Wakes the scheduler thread when the earliest deadline moves. */
+    AiaSemaphore_t wake;
+
+    /** Armed timers, in deadline order. */
+    AiaListDouble_t timers;
+
+    /** Number of created timers which have not been destroyed. */
+    size_t numTimers;
+
+    /** Requested @c SCHED_FIFO priority. */
+    int priority;
+
+    /** Requested CPU affinity. */
+    int cpu;
+
+    /** Set once @c AiaRealtimeScheduler_Init() has succeeded. */
+    AiaAtomicBool_t isInitialized;
+
+    /** Set to ask the scheduler thread to exit. */
+    AiaAtomicBool_t isStopping;
+
+    /** Set while the scheduler thread has not exited. */
+    AiaAtomicBool_t isRunning;
+} g_aiaRealtimeScheduler;
+
+/** Timer whose routine the current thread is running, if any. */
+static __thread AiaRealtimeTimer_t* t_aiaRealtimeSchedulerCurrentTimer;
+
+/**
+ * Inserts an armed timer into the deadline queue, after any timers with the
+ * same deadline.
+ *
+ * @param timer The timer to insert.
+ * @note Must be called with @c g_aiaRealtimeScheduler.mutex held.
+ */
+static void AiaRealtimeScheduler_InsertLocked( AiaRealtimeTimer_t* timer )
+{
+    AiaListDouble( Link_t )* link = NULL;
+    AiaListDouble( Link_t )* previous = NULL;
+    AiaListDouble( ForEach )( &g_aiaRealtimeScheduler.timers, link )
+    {
+        if( ( (AiaRealtimeTimer_t*)link )->deadlineMs > timer->deadlineMs )
+        {
+            break;
+        }
+        previous = link;
+    }
+    if( previous )
+    {
+        AiaListDouble( InsertAfter )( previous, &timer->link );
+    }
+    else
+    {
+        AiaListDouble( InsertHead )( &g_aiaRealtimeScheduler.timers,
+                                     &timer->link );
+        /* The earliest deadline moved. */
+        AiaSemaphore( Post )( &g_aiaRealtimeScheduler.wake );
+    }
+    timer->isArmed = true;
+}
+
+/**
+ * Removes a timer from the deadline queue if it is armed.
+ *
+ * @param timer The timer to remove.
+ * @note Must be called with @c g_aiaRealtimeScheduler.mutex held.
+ */
+static void AiaRealtimeScheduler_RemoveLocked( AiaRealtimeTimer_t* timer )
+{
+    if( timer->isArmed )
+    {
+        AiaListDouble( Remove )( &timer->link );
+        timer->isArmed = false;
+    }
+}
+
+/** Applies the requested priority and CPU affinity to the calling thread. */
+static void AiaRealtimeScheduler_ConfigureThread()
+{
+#ifdef __linux__
+    if( g_aiaRealtimeScheduler.priority !=
+        AIA_REALTIME_SCHEDULER_DEFAULT_PRIORITY )
+    {
+        struct sched_param param;
+        memset( &param, 0, sizeof( param ) );
+        param.sched_priority = g_aiaRealtimeScheduler.priority;
+        int error =
+            pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+        if( error )
+        {
+            AiaLogWarn( "Failed to set priority, priority=%d, error=%d.",
+                        g_aiaRealtimeScheduler.priority, error );
+        }
+    }
+    if( g_aiaRealtimeScheduler.cpu != AIA_REALTIME_SCHEDULER_ANY_CPU )
+    {
+        cpu_set_t cpus;
+        CPU_ZERO( &cpus );
+        CPU_SET( g_aiaRealtimeScheduler.cpu, &cpus );
+        int error =
+            pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus );
+        if( error )
+        {
+            AiaLogWarn( "Failed to set affinity, cpu=%d, error=%d.",
+                        g_aiaRealtimeScheduler.cpu, error );
+        }
+    }
+#else
+    if( g_aiaRealtimeScheduler.priority !=
+            AIA_REALTIME_SCHEDULER_DEFAULT_PRIORITY ||
+        g_aiaRealtimeScheduler.cpu != AIA_REALTIME_SCHEDULER_ANY_CPU )
+    {
+        AiaLogWarn( "Priority and affinity are not supported here." );
+    }
+#endif
+}
+
+/**
+ * Runs timers as their deadlines pass until the scheduler stops.
+ *
+ * @param context Unused.
+ */
+static void AiaRealtimeScheduler_Thread( void* context )
+{
+    (void)context;
+    AiaRealtimeScheduler_ConfigureThread();
+
+    AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+    while( !AiaAtomicBool_Load( &g_aiaRealtimeScheduler.isStopping ) )
+    {
+        AiaRealtimeTimer_t* timer = (AiaRealtimeTimer_t*)AiaListDouble(
+            PeekHead )( &g_aiaRealtimeScheduler.timers );
+        AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+        if( !timer || timer->deadlineMs > now )
+        {
+            AiaDurationMs_t sleepMs = AIA_REALTIME_SCHEDULER_MAX_SLEEP_MS;
+            if( timer && timer->deadlineMs - now < sleepMs )
+            {
+                sleepMs = (AiaDurationMs_t)( timer->deadlineMs - now );
+            }
+            AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+            AiaSemaphore( TimedWait )( &g_aiaRealtimeScheduler.wake, sleepMs );
+            AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+            continue;
+        }
+
+        AiaRealtimeScheduler_RemoveLocked( timer );
+        timer->isRunning = true;
+        AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+
+        t_aiaRealtimeSchedulerCurrentTimer = timer;
+        timer->routine( timer->context );
+        t_aiaRealtimeSchedulerCurrentTimer = NULL;
+
+        AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+        timer->isRunning = false;
+        if( !timer->isArmed && timer->periodMs )
+        {
+            timer->deadlineMs += timer->periodMs;
+            AiaRealtimeScheduler_InsertLocked( timer );
+        }
+    }
+    AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+    AiaAtomicBool_Clear( &g_aiaRealtimeScheduler.isRunning );
+}
+
+/** Waits for the scheduler thread to exit after @c isStopping is set. */
+static void AiaRealtimeScheduler_JoinThread()
+{
+    AiaSemaphore( Post )( &g_aiaRealtimeScheduler.wake );
+    while( AiaAtomicBool_Load( &g_aiaRealtimeScheduler.isRunning ) )
+    {
+        AiaClock( SleepMs )( 1 );
+    }
+}
+
+bool AiaRealtimeScheduler_Init( int priority, int cpu )
+{
+    if( AiaAtomicBool_Load( &g_aiaRealtimeScheduler.isInitialized ) )
+    {
+        AiaLogError( "Realtime scheduler already initialized." );
+        return false;
+    }
+
+    if( !AiaMutex( Create )( &g_aiaRealtimeScheduler.mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        return false;
+    }
+    if( !AiaSemaphore( Create )( &g_aiaRealtimeScheduler.wake, 0,
+                                 INT32_MAX ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &g_aiaRealtimeScheduler.mutex );
+        return false;
+    }
+    AiaListDouble( Create )( &g_aiaRealtimeScheduler.timers );
+    g_aiaRealtimeScheduler.numTimers = 0;
+    g_aiaRealtimeScheduler.priority = priority;
+    g_aiaRealtimeScheduler.cpu = cpu;
+    AiaAtomicBool_Clear( &g_aiaRealtimeScheduler.isStopping );
+
+    AiaAtomicBool_Set( &g_aiaRealtimeScheduler.isRunning );
+    if( !Iot_CreateDetachedThread( AiaRealtimeScheduler_Thread, NULL,
+                                   IOT_THREAD_DEFAULT_PRIORITY,
+                                   IOT_THREAD_DEFAULT_STACK_SIZE ) )
+    {
+        AiaLogError( "Failed to start the scheduler thread." );
+        AiaAtomicBool_Clear( &g_aiaRealtimeScheduler.isRunning );
+        AiaSemaphore( Destroy )( &g_aiaRealtimeScheduler.wake );
+        AiaMutex( Destroy )( &g_aiaRealtimeScheduler.mutex );
+        return false;
+    }
+
+    AiaAtomicBool_Set( &g_aiaRealtimeScheduler.isInitialized );
+    return true;
+}
+
+void AiaRealtimeScheduler_Shutdown( void )
+{
+    if( !AiaAtomicBool_Load( &g_aiaRealtimeScheduler.isInitialized ) )
+    {
+        return;
+    }
+    if( g_aiaRealtimeScheduler.numTimers )
+    {
+        AiaLogWarn( "Shutting down with timers still in use, count=%zu.",
+                    g_aiaRealtimeScheduler.numTimers );
+    }
+    AiaAtomicBool_Set( &g_aiaRealtimeScheduler.isStopping );
+    AiaRealtimeScheduler_JoinThread();
+    AiaSemaphore( Destroy )( &g_aiaRealtimeScheduler.wake );
+    AiaMutex( Destroy )( &g_aiaRealtimeScheduler.mutex );
+    AiaAtomicBool_Clear( &g_aiaRealtimeScheduler.isInitialized );
+}
+
+bool AiaRealtimeScheduler_TimerCreate( AiaRealtimeTimer_t* timer,
+                                       void ( *routine )( void* ),
+                                       void* context )
+{
+    if( !timer || !routine )
+    {
+        AiaLogError( "Null %s.", timer ? "routine" : "timer" );
+        return false;
+    }
+    if( !AiaAtomicBool_Load( &g_aiaRealtimeScheduler.isInitialized ) )
+    {
+        AiaLogError( "AiaRealtimeScheduler_Init() has not been called." );
+        return false;
+    }
+
+    memset( timer, 0, sizeof( *timer ) );
+    timer->routine = routine;
+    timer->context = context;
+    timer->isCreated = true;
+
+    AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+    ++g_aiaRealtimeScheduler.numTimers;
+    AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+    return true;
+}
+
+bool AiaRealtimeScheduler_TimerArm( AiaRealtimeTimer_t* timer,
+                                    uint32_t relativeTimeoutMs,
+                                    uint32_t periodMs )
+{
+    if( !timer || !timer->isCreated )
+    {
+        AiaLogError( "Invalid timer." );
+        return false;
+    }
+
+    AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+    AiaRealtimeScheduler_RemoveLocked( timer );
+    timer->deadlineMs = AiaClock( GetTimeMs )() + relativeTimeoutMs;
+    timer->periodMs = periodMs;
+    AiaRealtimeScheduler_InsertLocked( timer );
+    AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+    return true;
+}
+
+void AiaRealtimeScheduler_TimerDestroy( AiaRealtimeTimer_t* timer )
+{
+    if( !timer || !timer->isCreated )
+    {
+        return;
+    }
+
+    AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+    AiaRealtimeScheduler_RemoveLocked( timer );
+    timer->periodMs = 0;
+
+    /* A routine may destroy its own timer; anyone else waits for it. */
+    while( timer->isRunning && t_aiaRealtimeSchedulerCurrentTimer != timer )
+    {
+        AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+        AiaClock( SleepMs )( 1 );
+        AiaMutex( Lock )( &g_aiaRealtimeScheduler.mutex );
+        AiaRealtimeScheduler_RemoveLocked( timer );
+    }
+    timer->isCreated = false;
+    --g_aiaRealtimeScheduler.numTimers;
+    AiaMutex( Unlock )( &g_aiaRealtimeScheduler.mutex );
+}
@@ -0,0 +1,813 @@
+/*
+ * Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_timer_service.c
+ * @brief Sharded timer wheels and worker pools used when @c
+ * AIA_ENABLE_SHARED_TIMERS is defined.
+ */
+
+#ifdef __linux__
+/* For pthread_setaffinity_np(). */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <iot/aia_iot_config.h>
+#include <memory/aia_memory_config.h>
+
+#include AiaClock( HEADER )
+#include AiaMutex( HEADER )
+#include AiaSemaphore( HEADER )
+
+/** Number of bits of the tick count resolved by each wheel level. */
+#define AIA_TIMER_SERVICE_SLOT_BITS 6
+
+/** Number of slots in each wheel level. */
+#define AIA_TIMER_SERVICE_SLOTS ( 1u << AIA_TIMER_SERVICE_SLOT_BITS )
+
+/** Number of wheel levels.  Four levels of 64 slots span 2^24 ticks. */
+#define AIA_TIMER_SERVICE_LEVELS 4
+
+/** Longest delay, in ticks, the wheel can hold before re-cascading. */
+#define AIA_TIMER_SERVICE_MAX_TICKS                                     \
+    ( ( (uint64_t)1 << ( AIA_TIMER_SERVICE_SLOT_BITS *                  \
+                         AIA_TIMER_SERVICE_LEVELS ) ) -                 \
+      1 )
+
+/** Marks a timer which has been created but not armed. */
+#define AIA_TIMER_SERVICE_TIMER_IDLE 0
+
+/** Marks a timer waiting in a wheel slot. */
+#define AIA_TIMER_SERVICE_TIMER_ARMED 1
+
+/** Marks a timer waiting in its group's ready list. */
+#define AIA_TIMER_SERVICE_TIMER_READY 2
+
+/** Timers sharing a group are served round-robin against other groups. */
+typedef struct AiaTimerServiceGroup
+{
+    /** Link in @c g_aiaTimerService.groups. */
+    AiaListDouble( Link_t ) link;
+
+    /** Link in the shard's @c activeGroups while timers are ready. */
+    AiaListDouble( Link_t ) activeLink;
+
+    /** Identifies the group. */
+    const void* id;
+
+    /** Number of timers in the group. */
+    size_t numTimers;
+
+    /** Expired timers waiting for a worker. */
+    AiaListDouble_t ready;
+
+    /** The shard the group's timers run on. */
+    struct AiaTimerServiceShard* shard;
+} AiaTimerServiceGroup_t;
+
+/** A timer wheel with its own tick thread and workers. */
+typedef struct AiaTimerServiceShard
+{
+    /** Protects everything below. */
+    AiaMutex_t mutex;
+
+    /** Wakes workers when timers become ready. */
+    AiaSemaphore_t workAvailable;
+
+    /** The wheel levels. */
+    AiaListDouble_t wheel[ AIA_TIMER_SERVICE_LEVELS ]
+                         [ AIA_TIMER_SERVICE_SLOTS ];
+
+    /** Ticks processed so far. */
+    uint64_t currentTick;
+
+    /** Groups with ready timers, in service order. */
+    AiaListDouble_t activeGroups;
+
+    /** Number of groups placed on the shard. Protected by @c
+     * g_aiaTimerService.mutex. */
+    size_t numGroups;
+
+    /** Index of the shard. */
+    size_t index;
+
+    /** CPU the shard's threads are pinned to, or @c
+     * AIA_TIMER_SERVICE_ANY_CPU. */
+    int cpu;
+
+    /** Keeps the next shard's @c mutex off this shard's last cache line. */
+    uint8_t padding[ AIA_CACHE_LINE_SIZE ];
+} AiaTimerServiceShard_t;
+
+/** State of the timer service. */
+static struct
+{
+    /** Protects @c groups and the groups' timer counts. */
+    AiaMutex_t mutex;
+
+    /** All groups with at least one timer. */
+    AiaListDouble_t groups;
+
+    /** The shards. */
+    AiaTimerServiceShard_t* shards;
+
+    /** Number of entries in @c shards. */
+    size_t numShards;
+
+    /** Number of worker threads started per shard. */
+    size_t numWorkers;
+
+    /** Set once @c AiaTimerService_InitShards() has succeeded. */
+    AiaAtomicBool_t isInitialized;
+
+    /** Set to ask the tick threads and workers to exit. */
+    AiaAtomicBool_t isStopping;
+
+    /** Number of service threads which have not exited yet. */
+    uint32_t numThreadsRunning;
+} g_aiaTimerService;
+
+/** Group that timers created on the current thread join. */
+static __thread const void* t_aiaTimerServiceCurrentGroup;
+
+/** Shard that groups created on the current thread are placed on, plus one,
+ * or zero to leave it to the service. */
+static __thread size_t t_aiaTimerServiceCurrentShard;
+
+/** Timer whose routine the current thread is running, if any.  Cleared if the
+ * routine destroys it, after which its memory may already have been freed. */
+static __thread AiaTimer_t* t_aiaTimerServiceCurrentTimer;
+
+/**
+ * Converts a duration to wheel ticks, rounding up.
+ *
+ * @param durationMs The duration.
+ * @return The duration in ticks.
+ */
+static uint64_t AiaTimerService_MsToTicks( uint32_t durationMs )
+{
+    return ( (uint64_t)durationMs + AIA_TIMER_SERVICE_TICK_MS - 1 ) /
+           AIA_TIMER_SERVICE_TICK_MS;
+}
+
+/**
+ * Places an armed timer in the wheel slot matching its expiry.
+ *
+ * @param shard The timer's shard.
+ * @param timer The timer to insert.
+ * @note Must be called with @c shard->mutex held.
+ */
+static void AiaTimerService_InsertLocked( AiaTimerServiceShard_t* shard,
+                                          AiaTimer_t* timer )
+{
+    uint64_t expiryTick = timer->expiryTick;
+    if( expiryTick <= shard->currentTick )
+    {
+        expiryTick = shard->currentTick + 1;
+    }
+    uint64_t delta = expiryTick - shard->currentTick;
+    if( delta > AIA_TIMER_SERVICE_MAX_TICKS )
+    {
+        /* Parked in the top level and re-inserted when it cascades. */
+        expiryTick = shard->currentTick + AIA_TIMER_SERVICE_MAX_TICKS;
+        delta = AIA_TIMER_SERVICE_MAX_TICKS;
+    }
+
+    size_t level = 0;
+    while( level < AIA_TIMER_SERVICE_LEVELS - 1 &&
+           delta >= ( (uint64_t)1 << ( AIA_TIMER_SERVICE_SLOT_BITS *
+                                       ( level + 1 ) ) ) )
+    {
+        ++level;
+    }
+    size_t slot = ( expiryTick >> ( AIA_TIMER_SERVICE_SLOT_BITS * level ) ) &
+                  ( AIA_TIMER_SERVICE_SLOTS - 1 );
+
+    AiaListDouble( InsertTail )( &shard->wheel[ level ][ slot ], &timer->link );
+    timer->state = AIA_TIMER_SERVICE_TIMER_ARMED;
+}
+
+/**
+ * Queues an expired timer for a worker.
+ *
+ * @param shard The timer's shard.
+ * @param timer The timer to queue.
+ * @note Must be called with @c shard->mutex held.
+ */
+static void AiaTimerService_QueueLocked( AiaTimerServiceShard_t* shard,
+                                         AiaTimer_t* timer )
+{
+    if( timer->isRunning )
+    {
+        /* Runs again once the current invocation returns. */
+        timer->isRunPending = true;
+        return;
+    }
+
+    AiaTimerServiceGroup_t* group = timer->group;
+    if( AiaListDouble( IsEmpty )( &group->ready ) )
+    {
+        AiaListDouble( InsertTail )( &shard->activeGroups,
+                                     &group->activeLink );
+    }
+    AiaListDouble( InsertTail )( &group->ready, &timer->link );
+    timer->state = AIA_TIMER_SERVICE_TIMER_READY;
+    AiaSemaphore( Post )( &shard->workAvailable );
+}
+
+/**
+ * Removes a timer from the wheel or its group's ready list.
+ *
+ * @param timer The timer to remove.
+ * @note Must be called with the timer's shard's @c mutex held.
+ */
+static void AiaTimerService_RemoveLocked( AiaTimer_t* timer )
+{
+    if( timer->state == AIA_TIMER_SERVICE_TIMER_IDLE )
+    {
+        return;
+    }
+    AiaListDouble( Remove )( &timer->link );
+    if( timer->state == AIA_TIMER_SERVICE_TIMER_READY &&
+        AiaListDouble( IsEmpty )( &timer->group->ready ) )
+    {
+        AiaListDouble( Remove )( &timer->group->activeLink );
+    }
+    timer->state = AIA_TIMER_SERVICE_TIMER_IDLE;
+}
+
+/**
+ * Moves every timer out of a wheel slot.
+ *
+ * @param[out] destination An empty list to receive the timers.
+ * @param source The wheel slot to empty.
+ */
+static void AiaTimerService_MoveAll( AiaListDouble_t* destination,
+                                     AiaListDouble_t* source )
+{
+    AiaListDouble( Link_t )* link = NULL;
+    while( ( link = AiaListDouble( RemoveHead )( source ) ) )
+    {
+        AiaListDouble( InsertTail )( destination, link );
+    }
+}
+
+/**
+ * Advances a wheel by one tick, cascading higher levels and queueing expired
+ * timers.
+ *
+ * @param shard The shard to advance.
+ * @note Must be called with @c shard->mutex held.
+ */
+static void AiaTimerService_AdvanceLocked( AiaTimerServiceShard_t* shard )
+{
+    uint64_t tick = ++shard->currentTick;
+
+    /* Redistribute the next slot of each level whose lower levels wrapped. */
+    for( size_t level = 1; level < AIA_TIMER_SERVICE_LEVELS; ++level )
+    {
+        if( tick & ( ( (uint64_t)1 << ( AIA_TIMER_SERVICE_SLOT_BITS *
+                                        level ) ) -
+                     1 ) )
+        {
+            break;
+        }
+        size_t slot = ( tick >> ( AIA_TIMER_SERVICE_SLOT_BITS * level ) ) &
+                      ( AIA_TIMER_SERVICE_SLOTS - 1 );
+        AiaListDouble_t cascading;
+        AiaListDouble( Create )( &cascading );
+        AiaTimerService_MoveAll( &cascading, &shard->wheel[ level ][ slot ] );
+        AiaListDouble( Link_t )* link = NULL;
+        while( ( link = AiaListDouble( RemoveHead )( &cascading ) ) )
+        {
+            AiaTimerService_InsertLocked( shard, (AiaTimer_t*)link );
+        }
+    }
+
+    AiaListDouble_t* expiring =
+        &shard->wheel[ 0 ][ tick & ( AIA_TIMER_SERVICE_SLOTS - 1 ) ];
+    AiaListDouble_t expired;
+    AiaListDouble( Create )( &expired );
+    AiaTimerService_MoveAll( &expired, expiring );
+    AiaListDouble( Link_t )* link = NULL;
+    while( ( link = AiaListDouble( RemoveHead )( &expired ) ) )
+    {
+        AiaTimer_t* timer = (AiaTimer_t*)link;
+        timer->state = AIA_TIMER_SERVICE_TIMER_IDLE;
+        if( timer->expiryTick > tick )
+        {
+            /* Parked beyond the wheel's range. */
+            AiaTimerService_InsertLocked( shard, timer );
+            continue;
+        }
+
+        /* Periodic timers go back into the wheel once their routine has
+         * run. */
+        AiaTimerService_QueueLocked( shard, timer );
+    }
+}
+
+/**
+ * Pins the calling thread to its shard's CPU, if one was requested, and makes
+ * the shard the thread's current shard.
+ *
+ * @param shard The shard the thread serves.
+ */
+static void AiaTimerService_ConfigureThread( AiaTimerServiceShard_t* shard )
+{
+    t_aiaTimerServiceCurrentShard = shard->index + 1;
+    if( shard->cpu == AIA_TIMER_SERVICE_ANY_CPU )
+    {
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO( &cpus );
+    CPU_SET( shard->cpu, &cpus );
+    int error = pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus );
+    if( error )
+    {
+        AiaLogWarn( "Failed to set affinity, shard=%zu, cpu=%d, error=%d.",
+                    shard->index, shard->cpu, error );
+    }
+#else
+    AiaLogWarn( "Affinity is not supported here." );
+#endif
+}
+
+/**
+ * Advances a shard's wheel in real time until the service stops.
+ *
+ * @param context The shard.
+ */
+static void AiaTimerService_TickThread( void* context )
+{
+    AiaTimerServiceShard_t* shard = context;
+    AiaTimerService_ConfigureThread( shard );
+    AiaTimepointMs_t nextTickMs =
+        AiaClock( GetTimeMs )() + AIA_TIMER_SERVICE_TICK_MS;
+    while( !AiaAtomicBool_Load( &g_aiaTimerService.isStopping ) )
+    {
+        AiaTimepointMs_t now = AiaClock( GetTimeMs )();
+        if( now < nextTickMs )
+        {
+            AiaClock( SleepMs )( (uint32_t)( nextTickMs - now ) );
+            continue;
+        }
+
+        /* Catch up on ticks missed while descheduled. */
+        AiaMutex( Lock )( &shard->mutex );
+        while( nextTickMs <= now )
+        {
+            AiaTimerService_AdvanceLocked( shard );
+            nextTickMs += AIA_TIMER_SERVICE_TICK_MS;
+        }
+        AiaMutex( Unlock )( &shard->mutex );
+    }
+    AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning, (uint32_t)-1 );
+}
+
+/**
+ * Runs a shard's ready timers, one per group in turn, until the service stops.
+ *
+ * @param context The shard.
+ */
+static void AiaTimerService_WorkerThread( void* context )
+{
+    AiaTimerServiceShard_t* shard = context;
+    AiaTimerService_ConfigureThread( shard );
+    while( true )
+    {
+        AiaSemaphore( Wait )( &shard->workAvailable );
+        if( AiaAtomicBool_Load( &g_aiaTimerService.isStopping ) )
+        {
+            break;
+        }
+
+        AiaMutex( Lock )( &shard->mutex );
+        AiaListDouble( Link_t )* activeLink = NULL;
+        while( ( activeLink =
+                     AiaListDouble( RemoveHead )( &shard->activeGroups ) ) )
+        {
+            AiaTimerServiceGroup_t* group = IotLink_Container(
+                AiaTimerServiceGroup_t, activeLink, activeLink );
+            AiaTimer_t* timer =
+                (AiaTimer_t*)AiaListDouble( RemoveHead )( &group->ready );
+            if( !AiaListDouble( IsEmpty )( &group->ready ) )
+            {
+                /* Other groups go first before this one's next timer. */
+                AiaListDouble( InsertTail )( &shard->activeGroups,
+                                             &group->activeLink );
+            }
+            timer->state = AIA_TIMER_SERVICE_TIMER_IDLE;
+            timer->isRunning = true;
+            const void* groupId = group->id;
+            AiaMutex( Unlock )( &shard->mutex );
+
+            const void* previousGroup =
+                AiaTimerService_SetCurrentGroup( groupId );
+            t_aiaTimerServiceCurrentTimer = timer;
+            timer->routine( timer->context );
+            bool isDestroyed = !t_aiaTimerServiceCurrentTimer;
+            t_aiaTimerServiceCurrentTimer = NULL;
+            AiaTimerService_SetCurrentGroup( previousGroup );
+
+            AiaMutex( Lock )( &shard->mutex );
+            if( isDestroyed )
+            {
+                /* Destroyed by its routine, so must not be touched again. */
+                continue;
+            }
+            timer->isRunning = false;
+            if( timer->state != AIA_TIMER_SERVICE_TIMER_IDLE )
+            {
+                /* Re-armed by its routine. */
+            }
+            else if( timer->isRunPending )
+            {
+                timer->isRunPending = false;
+                AiaTimerService_QueueLocked( shard, timer );
+            }
+            else if( timer->periodTicks )
+            {
+                timer->expiryTick += timer->periodTicks;
+                AiaTimerService_InsertLocked( shard, timer );
+            }
+        }
+        AiaMutex( Unlock )( &shard->mutex );
+    }
+    AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning, (uint32_t)-1 );
+}
+
+/** Waits for all service threads to exit after @c isStopping is set. */
+static void AiaTimerService_JoinThreads()
+{
+    for( size_t i = 0; i < g_aiaTimerService.numShards; ++i )
+    {
+        for( size_t j = 0; j < g_aiaTimerService.numWorkers; ++j )
+        {
+            AiaSemaphore( Post )(
+                &g_aiaTimerService.shards[ i ].workAvailable );
+        }
+    }
+    while( AiaAtomic_Load_u32( &g_aiaTimerService.numThreadsRunning ) )
+    {
+        AiaClock( SleepMs )( AIA_TIMER_SERVICE_TICK_MS );
+    }
+}
+
+/**
+ * Initializes a shard and starts its tick thread and workers.
+ *
+ * @param shard The shard to start.
+ * @param index Index of the shard.
+ * @param cpu CPU to pin the shard's threads to, or @c
+ * AIA_TIMER_SERVICE_ANY_CPU.
+ * @return @c true if the shard's synchronization objects were created, even if
+ * not all of its threads started, else @c false.
+ * @note Failing to start a thread is reported through @c isStopping.
+ */
+static bool AiaTimerService_StartShard( AiaTimerServiceShard_t* shard,
+                                        size_t index, int cpu )
+{
+    if( !AiaMutex( Create )( &shard->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        return false;
+    }
+    if( !AiaSemaphore( Create )( &shard->workAvailable, 0, INT32_MAX ) )
+    {
+        AiaLogError( "AiaSemaphore( Create ) failed." );
+        AiaMutex( Destroy )( &shard->mutex );
+        return false;
+    }
+    for( size_t level = 0; level < AIA_TIMER_SERVICE_LEVELS; ++level )
+    {
+        for( size_t slot = 0; slot < AIA_TIMER_SERVICE_SLOTS; ++slot )
+        {
+            AiaListDouble( Create )( &shard->wheel[ level ][ slot ] );
+        }
+    }
+    AiaListDouble( Create )( &shard->activeGroups );
+    shard->currentTick = 0;
+    shard->numGroups = 0;
+    shard->index = index;
+    shard->cpu = cpu;
+
+    AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning, 1 );
+    if( !Iot_CreateDetachedThread( AiaTimerService_TickThread, shard,
+                                   IOT_THREAD_DEFAULT_PRIORITY,
+                                   IOT_THREAD_DEFAULT_STACK_SIZE ) )
+    {
+        AiaLogError( "Failed to start the tick thread, shard=%zu.", index );
+        AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning,
+                           (uint32_t)-1 );
+        AiaAtomicBool_Set( &g_aiaTimerService.isStopping );
+        return true;
+    }
+    for( size_t i = 0; i < g_aiaTimerService.numWorkers; ++i )
+    {
+        AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning, 1 );
+        if( !Iot_CreateDetachedThread( AiaTimerService_WorkerThread, shard,
+                                       IOT_THREAD_DEFAULT_PRIORITY,
+                                       IOT_THREAD_DEFAULT_STACK_SIZE ) )
+        {
+            AiaLogError( "Failed to start worker %zu, shard=%zu.", i, index );
+            AiaAtomic_Add_u32( &g_aiaTimerService.numThreadsRunning,
+                               (uint32_t)-1 );
+            AiaAtomicBool_Set( &g_aiaTimerService.isStopping );
+            return true;
+        }
+    }
+    return true;
+}
+
+/**
+ * Destroys the synchronization objects of the first @c numShards shards and
+ * frees them.
+ *
+ * @param numShards Number of shards started.
+ * @note The service's threads must have exited.
+ */
+static void AiaTimerService_DestroyShards( size_t numShards )
+{
+    for( size_t i = 0; i < numShards; ++i )
+    {
+        AiaSemaphore( Destroy )( &g_aiaTimerService.shards[ i ].workAvailable );
+        AiaMutex( Destroy )( &g_aiaTimerService.shards[ i ].mutex );
+    }
+    AiaFree( g_aiaTimerService.shards );
+    g_aiaTimerService.shards = NULL;
+    g_aiaTimerService.numShards = 0;
+}
+
+bool AiaTimerService_Init( size_t numWorkers )
+{
+    return AiaTimerService_InitShards( 1, numWorkers,
+                                       AIA_TIMER_SERVICE_ANY_CPU );
+}
+
+bool AiaTimerService_InitShards( size_t numShards, size_t numWorkers,
+                                 int firstCpu )
+{
+    if( AiaAtomicBool_Load( &g_aiaTimerService.isInitialized ) )
+    {
+        AiaLogError( "Timer service already initialized." );
+        return false;
+    }
+    if( !numShards )
+    {
+        AiaLogError( "No shards." );
+        return false;
+    }
+    if( !numWorkers )
+    {
+        numWorkers = numShards > 1 ? 1 : AIA_TIMER_SERVICE_DEFAULT_WORKERS;
+    }
+
+    if( !AiaMutex( Create )( &g_aiaTimerService.mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        return false;
+    }
+    g_aiaTimerService.shards =
+        AiaCalloc( numShards, sizeof( AiaTimerServiceShard_t ) );
+    if( !g_aiaTimerService.shards )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     numShards * sizeof( AiaTimerServiceShard_t ) );
+        AiaMutex( Destroy )( &g_aiaTimerService.mutex );
+        return false;
+    }
+    AiaListDouble( Create )( &g_aiaTimerService.groups );
+    g_aiaTimerService.numWorkers = numWorkers;
+    AiaAtomicBool_Clear( &g_aiaTimerService.isStopping );
+    AiaAtomic_Store_u32( &g_aiaTimerService.numThreadsRunning, 0 );
+
+    size_t numStarted = 0;
+    while( numStarted < numShards &&
+           !AiaAtomicBool_Load( &g_aiaTimerService.isStopping ) &&
+           AiaTimerService_StartShard(
+               &g_aiaTimerService.shards[ numStarted ], numStarted,
+               firstCpu == AIA_TIMER_SERVICE_ANY_CPU
+                   ? AIA_TIMER_SERVICE_ANY_CPU
+                   : firstCpu + (int)numStarted ) )
+    {
+        ++numStarted;
+    }
+    g_aiaTimerService.numShards = numStarted;
+    if( numStarted < numShards ||
+        AiaAtomicBool_Load( &g_aiaTimerService.isStopping ) )
+    {
+        AiaAtomicBool_Set( &g_aiaTimerService.isStopping );
+        AiaTimerService_JoinThreads();
+        AiaTimerService_DestroyShards( numStarted );
+        AiaMutex( Destroy )( &g_aiaTimerService.mutex );
+        return false;
+    }
+
+    AiaAtomicBool_Set( &g_aiaTimerService.isInitialized );
+    return true;
+}
+
+void AiaTimerService_Shutdown( void )
+{
+    if( !AiaAtomicBool_Load( &g_aiaTimerService.isInitialized ) )
+    {
+        return;
+    }
+    if( !AiaListDouble( IsEmpty )( &g_aiaTimerService.groups ) )
+    {
+        AiaLogWarn( "Shutting down with timers still in use." );
+    }
+    AiaAtomicBool_Set( &g_aiaTimerService.isStopping );
+    AiaTimerService_JoinThreads();
+    AiaTimerService_DestroyShards( g_aiaTimerService.numShards );
+    AiaMutex( Destroy )( &g_aiaTimerService.mutex );
+    AiaAtomicBool_Clear( &g_aiaTimerService.isInitialized );
+}
+
+const void* AiaTimerService_SetCurrentGroup( const void* group )
+{
+    const void* previousGroup = t_aiaTimerServiceCurrentGroup;
+    t_aiaTimerServiceCurrentGroup = group;
+    return previousGroup;
+}
+
+size_t AiaTimerService_SetCurrentShard( size_t shard )
+{
+    size_t previousShard = t_aiaTimerServiceCurrentShard
+                               ? t_aiaTimerServiceCurrentShard - 1
+                               : AIA_TIMER_SERVICE_ANY_SHARD;
+    t_aiaTimerServiceCurrentShard =
+        shard == AIA_TIMER_SERVICE_ANY_SHARD ? 0 : shard + 1;
+    return previousShard;
+}
+
+/**
+ * Picks the shard for a new group: the calling thread's current shard if it
+ * has one, else the shard with the fewest groups.
+ *
+ * @return The shard.
+ * @note Must be called with @c g_aiaTimerService.mutex held.
+ */
+static AiaTimerServiceShard_t* AiaTimerService_PlaceGroupLocked()
+{
+    if( t_aiaTimerServiceCurrentShard )
+    {
+        if( t_aiaTimerServiceCurrentShard <= g_aiaTimerService.numShards )
+        {
+            return &g_aiaTimerService
+                        .shards[ t_aiaTimerServiceCurrentShard - 1 ];
+        }
+        AiaLogWarn( "No such shard, shard=%zu.",
+                    t_aiaTimerServiceCurrentShard - 1 );
+    }
+    AiaTimerServiceShard_t* shard = &g_aiaTimerService.shards[ 0 ];
+    for( size_t i = 1; i < g_aiaTimerService.numShards; ++i )
+    {
+        if( g_aiaTimerService.shards[ i ].numGroups < shard->numGroups )
+        {
+            shard = &g_aiaTimerService.shards[ i ];
+        }
+    }
+    return shard;
+}
+
+bool AiaTimerService_TimerCreate( AiaTimer_t* timer, void ( *routine )( void* ),
+                                  void* context )
+{
+    if( !timer || !routine )
+    {
+        AiaLogError( "Null %s.", timer ? "routine" : "timer" );
+        return false;
+    }
+    if( !AiaAtomicBool_Load( &g_aiaTimerService.isInitialized ) )
+    {
+        AiaLogError( "AiaTimerService_Init() has not been called." );
+        return false;
+    }
+
+    memset( timer, 0, sizeof( *timer ) );
+    timer->routine = routine;
+    timer->context = context;
+    timer->state = AIA_TIMER_SERVICE_TIMER_IDLE;
+
+    AiaMutex( Lock )( &g_aiaTimerService.mutex );
+    AiaTimerServiceGroup_t* group = NULL;
+    AiaListDouble( Link_t )* link = NULL;
+    AiaListDouble( ForEach )( &g_aiaTimerService.groups, link )
+    {
+        AiaTimerServiceGroup_t* candidate =
+            IotLink_Container( AiaTimerServiceGroup_t, link, link );
+        if( candidate->id == t_aiaTimerServiceCurrentGroup )
+        {
+            group = candidate;
+            break;
+        }
+    }
+    if( !group )
+    {
+        group = AiaCalloc( 1, sizeof( AiaTimerServiceGroup_t ) );
+        if( !group )
+        {
+            AiaMutex( Unlock )( &g_aiaTimerService.mutex );
+            AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                         sizeof( AiaTimerServiceGroup_t ) );
+            return false;
+        }
+        group->id = t_aiaTimerServiceCurrentGroup;
+        AiaListDouble( Create )( &group->ready );
+        group->shard = AiaTimerService_PlaceGroupLocked();
+        ++group->shard->numGroups;
+        AiaListDouble( InsertTail )( &g_aiaTimerService.groups, &group->link );
+    }
+    ++group->numTimers;
+    timer->group = group;
+    AiaMutex( Unlock )( &g_aiaTimerService.mutex );
+    return true;
+}
+
+bool AiaTimerService_TimerArm( AiaTimer_t* timer, uint32_t relativeTimeoutMs,
+                               uint32_t periodMs )
+{
+    if( !timer || !timer->group )
+    {
+        AiaLogError( "Invalid timer." );
+        return false;
+    }
+
+    AiaTimerServiceShard_t* shard = timer->group->shard;
+    AiaMutex( Lock )( &shard->mutex );
+    AiaTimerService_RemoveLocked( timer );
+    timer->isRunPending = false;
+    timer->periodTicks = (uint32_t)AiaTimerService_MsToTicks( periodMs );
+    if( !relativeTimeoutMs )
+    {
+        timer->expiryTick = shard->currentTick;
+        AiaTimerService_QueueLocked( shard, timer );
+    }
+    else
+    {
+        timer->expiryTick = shard->currentTick +
+                            AiaTimerService_MsToTicks( relativeTimeoutMs );
+        AiaTimerService_InsertLocked( shard, timer );
+    }
+    AiaMutex( Unlock )( &shard->mutex );
+    return true;
+}
+
+void AiaTimerService_TimerDestroy( AiaTimer_t* timer )
+{
+    if( !timer || !timer->group )
+    {
+        return;
+    }
+
+    AiaTimerServiceGroup_t* group = timer->group;
+    AiaTimerServiceShard_t* shard = group->shard;
+    AiaMutex( Lock )( &shard->mutex );
+    AiaTimerService_RemoveLocked( timer );
+    timer->periodTicks = 0;
+    timer->isRunPending = false;
+
+    /* A routine may destroy its own timer; anyone else waits for it. */
+    while( timer->isRunning && t_aiaTimerServiceCurrentTimer != timer )
+    {
+        AiaMutex( Unlock )( &shard->mutex );
+        AiaClock( SleepMs )( 1 );
+        AiaMutex( Lock )( &shard->mutex );
+        AiaTimerService_RemoveLocked( timer );
+    }
+    if( t_aiaTimerServiceCurrentTimer == timer )
+    {
+        /* Tells the worker not to touch the timer after its routine. */
+        t_aiaTimerServiceCurrentTimer = NULL;
+    }
+    timer->group = NULL;
+    AiaMutex( Unlock )( &shard->mutex );
+
+    AiaMutex( Lock )( &g_aiaTimerService.mutex );
+    if( !--group->numTimers )
+    {
+        AiaListDouble( Remove )( &group->link );
+        --shard->numGroups;
+        AiaFree( group );
+    }
+    AiaMutex( Unlock )( &g_aiaTimerService.mutex );
+}
@@ -0,0 +1,492 @@
+/*
+ * Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_virtual_time.c
+ * @brief Simulated clock and deterministic timer event loop used when @c
+ * AIA_ENABLE_VIRTUAL_TIME is defined.
+ */
+
+#include <iot/aia_iot_config.h>
+
+#include AiaMutex( HEADER )
+#include <memory/aia_memory_config.h>
+
+#include <iot_taskpool.h>
+/* Waits for routines on other threads use the real clock. */
+#include <platform/iot_clock.h>
+
+#include <string.h>
+
+/** Values of @c g_aiaVirtualTime.state. */
+enum
+{
+    AIA_VIRTUAL_TIME_UNINITIALIZED,
+    AIA_VIRTUAL_TIME_INITIALIZING,
+    AIA_VIRTUAL_TIME_READY
+};
+
+/** A deferred task pool job, run by the event loop through its timer. */
+typedef struct AiaVirtualTimeJob
+{
+    /** Runs the job; first, so that a timer can be cast back to its job. */
+    AiaTimer_t timer;
+
+    /** Link in @c g_aiaVirtualTime.jobs. */
+    AiaListDouble( Link_t ) link;
+
+    /** The job, which identifies this record. */
+    IotTaskPoolJob_t job;
+
+    /** The task pool passed to @c AiaVirtualTime_TaskPoolScheduleDeferred(). */
+    IotTaskPool_t taskPool;
+
+    /** The routine passed to @c AiaVirtualTime_TaskPoolCreateJob(). */
+    IotTaskPoolRoutine_t routine;
+
+    /** Argument passed to @c routine. */
+    void* context;
+} AiaVirtualTimeJob_t;
+
+/** State of the virtual clock. */
+static struct
+{
+    /** One of the @c AIA_VIRTUAL_TIME_* values, initialized on first use. */
+    uint32_t state;
+
+    /** Protects everything below. */
+    AiaMutex_t mutex;
+
+    /** The current virtual time. */
+    AiaTimepointMs_t nowMs;
+
+    /** Armed timers, in deadline order. */
+    AiaListDouble_t timers;
+
+    /** Jobs created with @c AiaVirtualTime_TaskPoolCreateJob(). */
+    AiaListDouble_t jobs;
+
+    /** Set while a thread runs the event loop. */
+    bool isLooping;
+
+    /** Set when the timer whose routine is running destroys itself. */
+    bool isRunningTimerDestroyed;
+} g_aiaVirtualTime;
+
+/** Timer whose routine the current thread is running, if any. */
+static __thread AiaTimer_t* t_aiaVirtualTimeCurrentTimer;
+
+/** Locks @c g_aiaVirtualTime.mutex, initializing the clock on first use. */
+static void AiaVirtualTime_Lock()
+{
+    uint32_t* state = &g_aiaVirtualTime.state;
+    while( AiaAtomic_Load_u32( state ) != AIA_VIRTUAL_TIME_READY )
+    {
+        if( !AiaAtomic_CompareAndSwap_u32( state,
+                                           AIA_VIRTUAL_TIME_INITIALIZING,
+                                           AIA_VIRTUAL_TIME_UNINITIALIZED ) )
+        {
+            IotClock_SleepMs( 1 );
+            continue;
+        }
+        if( !AiaMutex( Create )( &g_aiaVirtualTime.mutex, false ) )
+        {
+            AiaLogError( "AiaMutex( Create ) failed." );
+            AiaAtomic_Store_u32( state, AIA_VIRTUAL_TIME_UNINITIALIZED );
+            IotClock_SleepMs( 1 );
+            continue;
+        }
+        g_aiaVirtualTime.nowMs = AIA_VIRTUAL_TIME_START_MS;
+        AiaListDouble( Create )( &g_aiaVirtualTime.timers );
+        AiaListDouble( Create )( &g_aiaVirtualTime.jobs );
+        AiaAtomic_Store_u32( state, AIA_VIRTUAL_TIME_READY );
+    }
+    AiaMutex( Lock )( &g_aiaVirtualTime.mutex );
+}
+
+/** Unlocks @c g_aiaVirtualTime.mutex. */
+static void AiaVirtualTime_Unlock()
+{
+    AiaMutex( Unlock )( &g_aiaVirtualTime.mutex );
+}
+
+/**
+ * Moves the clock forward to @c timepoint; the clock never moves backward.
+ *
+ * @param timepoint The virtual time to advance to.
+ * @note Must be called with @c g_aiaVirtualTime.mutex held.
+ */
+static void AiaVirtualTime_AdvanceLocked( AiaTimepointMs_t timepoint )
+{
+    if( timepoint > g_aiaVirtualTime.nowMs )
+    {
+        g_aiaVirtualTime.nowMs = timepoint;
+    }
+}
+
+/**
+ * Inserts an armed timer into the deadline queue, after any timers with the
+ * same deadline.
+ *
+ * @param timer The timer to insert.
+ * @note Must be called with @c g_aiaVirtualTime.mutex held.
+ */
+static void AiaVirtualTime_InsertLocked( AiaTimer_t* timer )
+{
+    AiaListDouble( Link_t )* link = NULL;
+    AiaListDouble( Link_t )* previous = NULL;
+    AiaListDouble( ForEach )( &g_aiaVirtualTime.timers, link )
+    {
+        if( ( (AiaTimer_t*)link )->deadlineMs > timer->deadlineMs )
+        {
+            break;
+        }
+        previous = link;
+    }
+    if( previous )
+    {
+        AiaListDouble( InsertAfter )( previous, &timer->link );
+    }
+    else
+    {
+        AiaListDouble( InsertHead )( &g_aiaVirtualTime.timers, &timer->link );
+    }
+    timer->isArmed = true;
+}
+
+/**
+ * Removes a timer from the deadline queue if it is armed.
+ *
+ * @param timer The timer to remove.
+ * @note Must be called with @c g_aiaVirtualTime.mutex held.
+ */
+static void AiaVirtualTime_RemoveLocked( AiaTimer_t* timer )
+{
+    if( timer->isArmed )
+    {
+        AiaListDouble( Remove )( &timer->link );
+        timer->isArmed = false;
+    }
+}
+
+/**
+ * Runs a deferred job; the routine of every job's timer.
+ *
+ * @param context The @c AiaVirtualTimeJob_t to run.
+ */
+static void AiaVirtualTime_RunJob( void* context )
+{
+    AiaVirtualTimeJob_t* job = context;
+
+    /* The routine may create and schedule the same job again. */
+    AiaVirtualTime_Lock();
+    IotTaskPool_t taskPool = job->taskPool;
+    IotTaskPoolJob_t taskPoolJob = job->job;
+    IotTaskPoolRoutine_t routine = job->routine;
+    void* routineContext = job->context;
+    AiaVirtualTime_Unlock();
+
+    routine( taskPool, taskPoolJob, routineContext );
+}
+
+/**
+ * Finds the record of a job.
+ *
+ * @param taskPoolJob The job to look for.
+ * @return The record, or @c NULL if there is none.
+ * @note Must be called with @c g_aiaVirtualTime.mutex held.
+ */
+static AiaVirtualTimeJob_t* AiaVirtualTime_FindJobLocked(
+    IotTaskPoolJob_t taskPoolJob )
+{
+    AiaListDouble( Link_t )* link = NULL;
+    AiaListDouble( ForEach )( &g_aiaVirtualTime.jobs, link )
+    {
+        AiaVirtualTimeJob_t* job =
+            IotLink_Container( AiaVirtualTimeJob_t, link, link );
+        if( job->job == taskPoolJob )
+        {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Forgets a job which is neither armed nor running.
+ *
+ * @param job The record to free.
+ * @note Must be called with @c g_aiaVirtualTime.mutex held.
+ */
+static void AiaVirtualTime_FreeJobLocked( AiaVirtualTimeJob_t* job )
+{
+    AiaListDouble( Remove )( &job->link );
+    AiaFree( job );
+}
+
+AiaTimepointMs_t AiaVirtualTime_GetTimeMs()
+{
+    AiaVirtualTime_Lock();
+    AiaTimepointMs_t now = g_aiaVirtualTime.nowMs;
+    AiaVirtualTime_Unlock();
+    return now;
+}
+
+void AiaVirtualTime_SleepMs( uint32_t sleepTimeMs )
+{
+    AiaVirtualTime_RunFor( sleepTimeMs );
+}
+
+size_t AiaVirtualTime_RunUntil( AiaTimepointMs_t timepoint )
+{
+    AiaVirtualTime_Lock();
+    if( g_aiaVirtualTime.isLooping )
+    {
+        AiaVirtualTime_AdvanceLocked( timepoint );
+        AiaVirtualTime_Unlock();
+        return 0;
+    }
+    g_aiaVirtualTime.isLooping = true;
+
+    size_t numRun = 0;
+    AiaTimer_t* timer = NULL;
+    while( ( timer = (AiaTimer_t*)AiaListDouble( PeekHead )(
+                 &g_aiaVirtualTime.timers ) ) &&
+           timer->deadlineMs <= timepoint )
+    {
+        AiaVirtualTime_AdvanceLocked( timer->deadlineMs );
+        AiaVirtualTime_RemoveLocked( timer );
+        timer->isRunning = true;
+        g_aiaVirtualTime.isRunningTimerDestroyed = false;
+        AiaVirtualTime_Unlock();
+
+        t_aiaVirtualTimeCurrentTimer = timer;
+        timer->routine( timer->context );
+        t_aiaVirtualTimeCurrentTimer = NULL;
+        ++numRun;
+
+        AiaVirtualTime_Lock();
+        if( g_aiaVirtualTime.isRunningTimerDestroyed )
+        {
+            /* The timer may have been freed along with its owner. */
+            continue;
+        }
+        timer->isRunning = false;
+        if( !timer->isArmed && timer->periodMs )
+        {
+            timer->deadlineMs += timer->periodMs;
+            AiaVirtualTime_InsertLocked( timer );
+        }
+        else if( !timer->isArmed && timer->routine == AiaVirtualTime_RunJob )
+        {
+            AiaVirtualTime_FreeJobLocked( (AiaVirtualTimeJob_t*)timer );
+        }
+    }
+
+    AiaVirtualTime_AdvanceLocked( timepoint );
+    g_aiaVirtualTime.isLooping = false;
+    AiaVirtualTime_Unlock();
+    return numRun;
+}
+
+size_t AiaVirtualTime_RunFor( AiaDurationMs_t durationMs )
+{
+    return AiaVirtualTime_RunUntil( AiaVirtualTime_GetTimeMs() + durationMs );
+}
+
+bool AiaVirtualTime_RunNext()
+{
+    AiaVirtualTime_Lock();
+    AiaTimer_t* timer =
+        (AiaTimer_t*)AiaListDouble( PeekHead )( &g_aiaVirtualTime.timers );
+    if( !timer || g_aiaVirtualTime.isLooping )
+    {
+        AiaVirtualTime_Unlock();
+        return false;
+    }
+    AiaTimepointMs_t timepoint = timer->deadlineMs;
+    AiaVirtualTime_Unlock();
+
+    AiaVirtualTime_RunUntil( timepoint );
+    return true;
+}
+
+bool AiaVirtualTime_TimerCreate( AiaTimer_t* timer, void ( *routine )( void* ),
+                                 void* context )
+{
+    if( !timer || !routine )
+    {
+        AiaLogError( "Null %s.", timer ? "routine" : "timer" );
+        return false;
+    }
+
+    memset( timer, 0, sizeof( *timer ) );
+    timer->routine = routine;
+    timer->context = context;
+    timer->isCreated = true;
+    return true;
+}
+
+bool AiaVirtualTime_TimerArm( AiaTimer_t* timer, uint32_t relativeTimeoutMs,
+                              uint32_t periodMs )
+{
+    if( !timer || !timer->isCreated )
+    {
+        AiaLogError( "Invalid timer." );
+        return false;
+    }
+
+    AiaVirtualTime_Lock();
+    AiaVirtualTime_RemoveLocked( timer );
+    timer->deadlineMs = g_aiaVirtualTime.nowMs + relativeTimeoutMs;
+    timer->periodMs = periodMs;
+    AiaVirtualTime_InsertLocked( timer );
+    AiaVirtualTime_Unlock();
+    return true;
+}
+
+void AiaVirtualTime_TimerDestroy( AiaTimer_t* timer )
+{
+    if( !timer || !timer->isCreated )
+    {
+        return;
+    }
+
+    AiaVirtualTime_Lock();
+    AiaVirtualTime_RemoveLocked( timer );
+    timer->periodMs = 0;
+
+    /* A routine may destroy its own timer; anyone else waits for it. */
+    if( t_aiaVirtualTimeCurrentTimer == timer )
+    {
+        g_aiaVirtualTime.isRunningTimerDestroyed = true;
+    }
+    while( timer->isRunning && t_aiaVirtualTimeCurrentTimer != timer )
+    {
+        AiaVirtualTime_Unlock();
+        IotClock_SleepMs( 1 );
+        AiaVirtualTime_Lock();
+        AiaVirtualTime_RemoveLocked( timer );
+    }
+    timer->isCreated = false;
+    AiaVirtualTime_Unlock();
+}
+
+IotTaskPoolError_t AiaVirtualTime_TaskPoolCreateJob(
+    IotTaskPoolRoutine_t userCallback, void* pUserContext,
+    IotTaskPoolJobStorage_t* const pJobStorage, IotTaskPoolJob_t* const pJob )
+{
+    IotTaskPoolError_t error =
+        IotTaskPool_CreateJob( userCallback, pUserContext, pJobStorage, pJob );
+    if( error != IOT_TASKPOOL_SUCCESS )
+    {
+        return error;
+    }
+
+    AiaVirtualTime_Lock();
+    AiaVirtualTimeJob_t* job = AiaVirtualTime_FindJobLocked( *pJob );
+    if( !job )
+    {
+        job = AiaCalloc( 1, sizeof( AiaVirtualTimeJob_t ) );
+        if( !job )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                         sizeof( AiaVirtualTimeJob_t ) );
+            AiaVirtualTime_Unlock();
+            return IOT_TASKPOOL_NO_MEMORY;
+        }
+        AiaVirtualTime_TimerCreate( &job->timer, AiaVirtualTime_RunJob, job );
+        job->job = *pJob;
+        AiaListDouble( InsertTail )( &g_aiaVirtualTime.jobs, &job->link );
+    }
+    AiaVirtualTime_RemoveLocked( &job->timer );
+    job->routine = userCallback;
+    job->context = pUserContext;
+    AiaVirtualTime_Unlock();
+    return IOT_TASKPOOL_SUCCESS;
+}
+
+IotTaskPoolError_t AiaVirtualTime_TaskPoolScheduleDeferred(
+    IotTaskPool_t taskPool, IotTaskPoolJob_t job, uint32_t timeMs )
+{
+    AiaVirtualTime_Lock();
+    AiaVirtualTimeJob_t* virtualJob = AiaVirtualTime_FindJobLocked( job );
+    if( !virtualJob )
+    {
+        AiaVirtualTime_Unlock();
+        AiaLogError( "Job not created with AiaTaskPool( CreateJob )." );
+        return IOT_TASKPOOL_BAD_PARAMETER;
+    }
+    if( virtualJob->timer.isArmed )
+    {
+        AiaVirtualTime_Unlock();
+        return IOT_TASKPOOL_ILLEGAL_OPERATION;
+    }
+
+    /* Jobs without a delay run on the task pool, as nothing waits for them in
+     * virtual time. */
+    if( !timeMs )
+    {
+        if( !virtualJob->timer.isRunning )
+        {
+            AiaVirtualTime_FreeJobLocked( virtualJob );
+        }
+        AiaVirtualTime_Unlock();
+        return IotTaskPool_Schedule( taskPool, job, 0 );
+    }
+
+    virtualJob->taskPool = taskPool;
+    virtualJob->timer.deadlineMs = g_aiaVirtualTime.nowMs + timeMs;
+    virtualJob->timer.periodMs = 0;
+    AiaVirtualTime_InsertLocked( &virtualJob->timer );
+    AiaVirtualTime_Unlock();
+    return IOT_TASKPOOL_SUCCESS;
+}
+
+IotTaskPoolError_t AiaVirtualTime_TaskPoolTryCancel(
+    IotTaskPool_t taskPool, IotTaskPoolJob_t job,
+    IotTaskPoolJobStatus_t* const pStatus )
+{
+    AiaVirtualTime_Lock();
+    AiaVirtualTimeJob_t* virtualJob = AiaVirtualTime_FindJobLocked( job );
+    if( !virtualJob )
+    {
+        AiaVirtualTime_Unlock();
+        return IotTaskPool_TryCancel( taskPool, job, pStatus );
+    }
+
+    IotTaskPoolError_t error = IOT_TASKPOOL_CANCEL_FAILED;
+    IotTaskPoolJobStatus_t status = virtualJob->timer.isRunning
+                                        ? IOT_TASKPOOL_STATUS_EXECUTING
+                                        : IOT_TASKPOOL_STATUS_COMPLETED;
+    if( virtualJob->timer.isArmed )
+    {
+        AiaVirtualTime_RemoveLocked( &virtualJob->timer );
+        if( !virtualJob->timer.isRunning )
+        {
+            AiaVirtualTime_FreeJobLocked( virtualJob );
+        }
+        error = IOT_TASKPOOL_SUCCESS;
+        status = IOT_TASKPOOL_STATUS_CANCELED;
+    }
+    AiaVirtualTime_Unlock();
+
+    if( pStatus )
+    {
+        *pStatus = status;
+    }
+    return error;
+}
@@ -22,6 +22,273 @@ extern "C" {
 
 #include <stdlib.h>
 
+#ifdef AIA_ENABLE_MEMORY_STATS
+
+#include <stddef.h>
+
+/**
+ * @name Instrumented allocator.
+ *
+ * When built with @c AIA_ENABLE_MEMORY_STATS (the @c AIA_MEMORY_STATS CMake
+ * option), every allocation is tagged with the subsystem that made it and
+ * live and peak byte counts are kept per subsystem. The subsystem is the name
+ * of the folder holding the file that calls @c AiaCalloc(), such as
+ * "aiasequencer", unless that file defines @c AIA_MEMORY_TAG to a string of
+ * its own before including @c aia_config.h.
+ *
+ * Each allocation carries a small header, so memory must only ever be
+ * released with @c AiaFree().
+ */
+/** @{ */
+
+#ifndef AIA_MEMORY_TAG
+#define AIA_MEMORY_TAG __FILE__
+#endif
+
+/** The maximum number of subsystems tracked. Allocations from any further
+ * subsystems are counted against the last, which is named "other". */
+#define AIA_MEMORY_STATS_MAX_SUBSYSTEMS 32
+
+/** The maximum length of a subsystem name. Longer names are truncated. */
+#define AIA_MEMORY_STATS_MAX_NAME_LENGTH 31
+
+/** Heap usage of a subsystem, or of the process as a whole. */
+typedef struct AiaMemoryStats
+{
+    /** The name of the subsystem. */
+    char subsystem[ AIA_MEMORY_STATS_MAX_NAME_LENGTH + 1 ];
+
+    /** The number of bytes currently allocated. */
+    size_t liveBytes;
+
+    /** The highest value @c liveBytes has reached. */
+    size_t peakBytes;
+
+    /** The number of allocations not yet released. */
+    size_t liveAllocations;
+
+    /** The number of allocations made so far. */
+    size_t totalAllocations;
+} AiaMemoryStats_t;
+
+/**
+ * Called from within @c AiaCalloc() whenever the total number of live bytes
+ * reaches a new peak at least the requested step above the last one
+ * reported. Implementations must not allocate memory.
+ *
+ * @param peakBytes The new peak of the total number of live bytes.
+ * @param subsystem The subsystem whose allocation reached the peak.
+ * @param userData User data passed to @c
+ * AiaMemoryStats_SetHighWaterMarkCallback().
+ */
+typedef void ( *AiaMemoryHighWaterMarkCallback_t )( size_t peakBytes,
+                                                    const char* subsystem,
+                                                    void* userData );
+
+/**
+ * Allocates zero'd memory on behalf of @c tag. Use @c AiaCalloc() rather than
+ * calling this directly.
+ *
+ * @param count The number of elements to allocate.
+ * @param size The size (in bytes) of each element.
+ * @param tag The path of the calling file, or the name of a subsystem.
+ * @return A @c void pointer to the allocated memory, or @c NULL if the memory
+ * cannot be allocated.
+ */
+void* AiaMemory_Calloc( size_t count, size_t size, const char* tag );
+
+/**
+ * Allocates zero'd memory.  Memory allocated using this function should be
+ * released using a call to @c AiaFree().
+ *
+ * @param count The number of elements to allocate.
+ * @param size The size (in bytes) of each element.
+ * @return A @c void pointer to the allocated memory, or @c NULL if the memory
+ * cannot be allocated.
+ */
+#define AiaCalloc( count, size ) \
+    AiaMemory_Calloc( count, size, AIA_MEMORY_TAG )
+
+/** Releases memory allocated by a call to @c AiaCalloc(). */
+void AiaFree( void* ptr );
+
+/**
+ * Takes a snapshot of heap usage.
+ *
+ * @param[out] total Usage of the process as a whole, if non-@c NULL.
+ * @param[out] subsystems Usage of each subsystem, in the order they first
+ * allocated, if non-@c NULL.
+ * @param maxSubsystems The number of elements in @c subsystems.
+ * @return The number of subsystems tracked, which may be more than @c
+ * maxSubsystems.
+ */
+size_t AiaMemoryStats_Get( AiaMemoryStats_t* total,
+                           AiaMemoryStats_t* subsystems,
+                           size_t maxSubsystems );
+
+/**
+ * Sets the callback to be notified of new heap high-water marks, replacing any
+ * previous one. Only peaks above the current one are reported.
+ *
+ * @param callback The callback, or @c NULL to stop notifications.
+ * @param stepBytes How far above the last reported peak a new peak must be to
+ * be reported.
+ * @param userData User data to pass to @c callback.
+ */
+void AiaMemoryStats_SetHighWaterMarkCallback(
+    AiaMemoryHighWaterMarkCallback_t callback, size_t stepBytes,
+    void* userData );
+
+/** @} */
+
+#elif defined( AIA_ENABLE_MEMORY_ARENA )
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @name Static-arena allocator.
+ *
+ * When built with @c AIA_ENABLE_MEMORY_ARENA (the @c AIA_MEMORY_ARENA CMake
+ * option), @c AiaCalloc() serves each request from the smallest of a set of
+ * fixed-size block classes, all carved out of the single arena passed to
+ * @c AiaMemoryArena_Init(). The SDK then never touches the heap, and running
+ * out of blocks is deterministic and visible through @c
+ * AiaMemoryArena_GetStats() rather than a fragmentation failure hours later.
+ *
+ * @c AiaCalloc() is shared by the whole process, so the arena must be
+ * installed before the first SDK call, typically before @c AiaClient_Create().
+ * Until then allocations come from the heap, and they may still be released
+ * with @c AiaFree() afterwards.
+ *
+ * Memory must only ever be released with @c AiaFree().
+ */
+/** @{ */
+
+/** The maximum number of block classes an arena can be split into. */
+#define AIA_MEMORY_ARENA_MAX_CLASSES 8
+
+/**
+ * A starting point for the classes of an arena, sized for the SDK's own
+ * allocations: list nodes and small objects, message headers and JSON events,
+ * microphone chunks of @c AIA_MICROPHONE_CHUNK_SIZE_SAMPLES samples, MQTT
+ * payloads of up to @c AIA_SYSTEM_MQTT_MESSAGE_MAX_SIZE bytes, and finally
+ * the few buffers allocated once per client, such as the sequencer slot pools
+ * and the speaker buffer. Tune the counts, and the last size, for the product
+ * using @c AiaMemoryArena_GetStats().
+ */
+#define AIA_MEMORY_ARENA_DEFAULT_CLASSES                            \
+    {                                                               \
+        { 64, 512 }, { 512, 128 }, { 4096, 16 }, { 6144, 16 },      \
+        { 32768, 4 }, { 65536, 4 }                                  \
+    }
+
+/** What @c AiaCalloc() does when every block of the fitting class is used. */
+typedef enum AiaMemoryArenaOverflowPolicy
+{
+    /** Fail the allocation. */
+    AIA_MEMORY_ARENA_OVERFLOW_FAIL,
+
+    /** Use a block of the next larger class with one free. */
+    AIA_MEMORY_ARENA_OVERFLOW_LARGER_CLASS,
+
+    /** Use a larger class and, failing that, fall back to the heap. */
+    AIA_MEMORY_ARENA_OVERFLOW_HEAP
+} AiaMemoryArenaOverflowPolicy_t;
+
+/** A class of equally sized blocks. */
+typedef struct AiaMemoryArenaClass
+{
+    /** The largest allocation (in bytes) a block of this class can serve. */
+    size_t blockSize;
+
+    /** The number of blocks of this class. */
+    size_t numBlocks;
+} AiaMemoryArenaClass_t;
+
+/** Usage of a block class. */
+typedef struct AiaMemoryArenaClassStats
+{
+    /** The largest allocation (in bytes) a block of this class can serve. */
+    size_t blockSize;
+
+    /** The number of blocks of this class. */
+    size_t numBlocks;
+
+    /** The number of blocks currently allocated. */
+    size_t blocksInUse;
+
+    /** The highest value @c blocksInUse has reached. */
+    size_t peakBlocksInUse;
+
+    /** The number of allocations that fitted this class but found it full,
+     * whether or not the overflow policy then served them elsewhere. */
+    size_t overflows;
+} AiaMemoryArenaClassStats_t;
+
+/**
+ * Computes the size of the arena needed to hold @c classes, including
+ * per-block headers and alignment slack.
+ *
+ * @param classes The block classes.
+ * @param numClasses The number of elements in @c classes.
+ * @return The required size in bytes, or @c 0 if it overflows a @c size_t.
+ */
+size_t AiaMemoryArena_GetRequiredSize( const AiaMemoryArenaClass_t* classes,
+                                       size_t numClasses );
+
+/**
+ * Installs @c arena as the backing store of @c AiaCalloc(). This can only be
+ * done once per process.
+ *
+ * @param arena The memory to carve blocks out of. It must outlive every
+ * allocation made from it.
+ * @param arenaSize The size of @c arena. Must be at least @c
+ * AiaMemoryArena_GetRequiredSize() of @c classes.
+ * @param classes The block classes, in strictly increasing order of @c
+ * blockSize. The array is copied.
+ * @param numClasses The number of elements in @c classes, at most @c
+ * AIA_MEMORY_ARENA_MAX_CLASSES.
+ * @param overflowPolicy What to do when a class runs out of blocks.
+ * @return @c true if the arena was installed, else @c false.
+ */
+bool AiaMemoryArena_Init( void* arena, size_t arenaSize,
+                          const AiaMemoryArenaClass_t* classes,
+                          size_t numClasses,
+                          AiaMemoryArenaOverflowPolicy_t overflowPolicy );
+
+/**
+ * Takes a snapshot of arena usage.
+ *
+ * @param[out] stats Usage of each class, in the order passed to @c
+ * AiaMemoryArena_Init(), if non-@c NULL.
+ * @param maxClasses The number of elements in @c stats.
+ * @param[out] heapAllocations The number of allocations currently served by
+ * the heap, if non-@c NULL.
+ * @return The number of classes in the arena, which is @c 0 before @c
+ * AiaMemoryArena_Init().
+ */
+size_t AiaMemoryArena_GetStats( AiaMemoryArenaClassStats_t* stats,
+                                size_t maxClasses, size_t* heapAllocations );
+
+/**
+ * Allocates zero'd memory.  Memory allocated using this function should be
+ * released using a call to @c AiaFree().
+ *
+ * @param count The number of elements to allocate.
+ * @param size The size (in bytes) of each element.
+ * @return A @c void pointer to the allocated memory, or @c NULL if the memory
+ * cannot be allocated.
+ */
+void* AiaCalloc( size_t count, size_t size );
+
+/** Releases memory allocated by a call to @c AiaCalloc(). */
+void AiaFree( void* ptr );
+
+/** @} */
+
+#else
+
 /**
  * Allocates zero'd memory.  Memory allocated using this function should be
  * released using a call to @c AiaFree().
@@ -42,6 +309,213 @@ static inline void AiaFree( void* ptr )
     free( ptr );
 }
 
+#endif /* AIA_ENABLE_MEMORY_STATS, AIA_ENABLE_MEMORY_ARENA */
+
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @name Prefaulted memory.
+ *
+ * When built with @c AIA_ENABLE_MEMORY_PREFAULT (the @c AIA_MEMORY_PREFAULT
+ * CMake option, Linux only), memory on the audio path can be faulted in, and
+ * optionally locked into RAM, before it is first used, so that the first
+ * interaction after boot or a long idle does not pay page faults later ones
+ * do not. @c AiaClient_Create() does this for the audio buffers the SDK owns,
+ * or for the whole arena with @c AIA_ENABLE_MEMORY_ARENA. The application can
+ * do the same for the buffers it owns, such as the microphone buffer and the
+ * codec state.
+ */
+/** @{ */
+
+/**
+ * Whether @c AiaClient_Create() also locks the memory it prefaults into RAM.
+ * Locking needs @c CAP_IPC_LOCK or a large enough @c RLIMIT_MEMLOCK, without
+ * which the memory is only prefaulted.
+ */
+static const bool AIA_MEMORY_PREFAULT_LOCK = true;
+
+/** Footprint of prefaulted memory. */
+typedef struct AiaMemoryPrefaultStats
+{
+    /** The number of bytes currently prefaulted, in whole pages. */
+    size_t prefaultedBytes;
+
+    /** The number of bytes the process has locked into RAM, as reported by the
+     * kernel. This includes memory locked outside of the SDK. */
+    size_t lockedBytes;
+} AiaMemoryPrefaultStats_t;
+
+/**
+ * Faults in the pages spanning @c memory without changing its contents, and
+ * optionally locks them into RAM. The memory may already be in use.
+ *
+ * @param memory The start of the memory.
+ * @param size The size of the memory in bytes.
+ * @param lock Whether to also lock the pages into RAM.
+ * @return @c true if the pages were prefaulted and, if requested, locked, else
+ * @c false. The pages are still prefaulted if only locking failed.
+ * @note Memory prefaulted this way must be passed to @c AiaMemory_Unprefault()
+ * before it is released.
+ */
+bool AiaMemory_Prefault( void* memory, size_t size, bool lock );
+
+/**
+ * Undoes @c AiaMemory_Prefault(), unlocking the pages which lie entirely
+ * within @c memory. Pages shared with neighbouring memory stay locked.
+ *
+ * @param memory The memory passed to @c AiaMemory_Prefault().
+ * @param size The size passed to @c AiaMemory_Prefault().
+ */
+void AiaMemory_Unprefault( void* memory, size_t size );
+
+/**
+ * Reports the footprint of prefaulted memory.
+ *
+ * @param[out] stats The footprint.
+ */
+void AiaMemory_GetPrefaultStats( AiaMemoryPrefaultStats_t* stats );
+
+#ifdef AIA_ENABLE_MEMORY_ARENA
+/**
+ * Prefaults the whole arena installed with @c AiaMemoryArena_Init(), which
+ * covers every allocation the SDK makes from it. Calls after the first do
+ * nothing.
+ *
+ * @param lock Whether to also lock the arena into RAM.
+ * @return @c true on success, else @c false, including if no arena has been
+ * installed.
+ */
+bool AiaMemoryArena_Prefault( bool lock );
+#endif
+
+/** @} */
+
+#endif /* AIA_ENABLE_MEMORY_PREFAULT */
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @name Allocation guard.
+ *
+ * When built with @c AIA_ENABLE_ALLOCATION_GUARD (the @c AIA_ALLOCATION_GUARD
+ * CMake option), the SDK marks the code it runs for every audio frame or
+ * message as hot paths. Once @c AiaMemoryGuard_MarkSteadyState() has been
+ * called, typically through @c AiaClient_MarkSteadyState(), every @c
+ * AiaCalloc() made on a hot path is recorded with its call site, and
+ * optionally asserted on, so that allocations creeping back onto these paths
+ * are caught as soon as they are introduced.
+ *
+ * This is a debug and performance aid: each @c AiaCalloc() pays a check.
+ */
+/** @{ */
+
+/** The maximum number of distinct call sites recorded. Further call sites are
+ * only counted. */
+#define AIA_MEMORY_GUARD_MAX_CALL_SITES 16
+
+/** The code paths which should not allocate in steady state. */
+typedef enum AiaMemoryGuardHotPath
+{
+    /** Handing speaker topic messages from MQTT to the speaker sequencer. */
+    AIA_MEMORY_GUARD_SPEAKER_RECEIVE,
+
+    /** Pushing frames from the speaker buffer to the speaker. */
+    AIA_MEMORY_GUARD_SPEAKER_PUSH,
+
+    /** Reading and publishing microphone data. */
+    AIA_MEMORY_GUARD_MICROPHONE_STREAMING,
+
+    /** Emitting regulated messages, from the regulator's timer. */
+    AIA_MEMORY_GUARD_REGULATOR_EMIT
+} AiaMemoryGuardHotPath_t;
+
+/** An @c AiaCalloc() call site found on a hot path in steady state. */
+typedef struct AiaMemoryGuardCallSite
+{
+    /** The file and line of the call. */
+    const char* file;
+    int line;
+
+    /** The hot path the call was made on. */
+    AiaMemoryGuardHotPath_t hotPath;
+
+    /** The number of calls made from this call site. */
+    size_t count;
+} AiaMemoryGuardCallSite_t;
+
+/**
+ * Marks the start of a hot path on the calling thread. Hot paths may nest, in
+ * which case calls are attributed to the outermost.
+ *
+ * @param hotPath The hot path.
+ */
+void AiaMemoryGuard_Begin( AiaMemoryGuardHotPath_t hotPath );
+
+/**
+ * Marks the end of a hot path started with @c AiaMemoryGuard_Begin().
+ *
+ * @param hotPath The hot path.
+ */
+void AiaMemoryGuard_End( AiaMemoryGuardHotPath_t hotPath );
+
+/**
+ * Starts guarding hot paths against allocations.
+ *
+ * @param assertOnAllocation Whether to also @c assert() on each allocation
+ * recorded, which stops test builds at the offending call.
+ */
+void AiaMemoryGuard_MarkSteadyState( bool assertOnAllocation );
+
+/** Stops guarding hot paths, e.g. while reconfiguring. */
+void AiaMemoryGuard_ClearSteadyState( void );
+
+/**
+ * Reports the allocations recorded on hot paths.
+ *
+ * @param[out] callSites The call sites recorded, in the order they were first
+ * recorded, if non-@c NULL.
+ * @param maxCallSites The number of elements in @c callSites.
+ * @param[out] total The total number of allocations recorded, including those
+ * from call sites past @c AIA_MEMORY_GUARD_MAX_CALL_SITES, if non-@c NULL.
+ * @return The number of call sites recorded, which may be more than @c
+ * maxCallSites.
+ */
+size_t AiaMemoryGuard_GetCallSites( AiaMemoryGuardCallSite_t* callSites,
+                                    size_t maxCallSites, size_t* total );
+
+/**
+ * Records an allocation if it is made on a hot path in steady state. Called by
+ * @c AiaCalloc().
+ *
+ * @param file The file of the call.
+ * @param line The line of the call.
+ */
+void AiaMemoryGuard_OnAllocation( const char* file, int line );
+
+#ifdef AIA_ENABLE_MEMORY_STATS
+#undef AiaCalloc
+#define AiaCalloc( count, size )                         \
+    ( AiaMemoryGuard_OnAllocation( __FILE__, __LINE__ ), \
+      AiaMemory_Calloc( count, size, AIA_MEMORY_TAG ) )
+#else
+#define AiaCalloc( count, size )                         \
+    ( AiaMemoryGuard_OnAllocation( __FILE__, __LINE__ ), \
+      AiaCalloc( count, size ) )
+#endif
+
+/** @} */
+
+#else
+#define AiaMemoryGuard_Begin( hotPath )
+#define AiaMemoryGuard_End( hotPath )
+#endif /* AIA_ENABLE_ALLOCATION_GUARD */
+
 #ifdef __cplusplus
 }
 #endif
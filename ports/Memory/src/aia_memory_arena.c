@@ -0,0 +1,348 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_arena.c
+ * @brief Implements the static-arena allocator declared in @c
+ * aia_memory_config.h.
+ */
+
+#include <memory/aia_memory_config.h>
+#include <iot/aia_iot_config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+/* This file defines the function the guard's AiaCalloc() macro wraps. */
+#undef AiaCalloc
+#endif
+
+/** Header placed in front of every block, and every heap allocation. */
+typedef union AiaMemoryHeader
+{
+    /** The index of the class the block belongs to while it is allocated, or
+     * @c AIA_MEMORY_ARENA_HEAP for heap allocations. */
+    size_t classIndex;
+
+    /** The next free block of the same class while the block is free. */
+    union AiaMemoryHeader* next;
+
+    /** @name Members forcing the header to keep the allocation aligned. */
+    /** @{ */
+    long double alignLongDouble;
+    uint64_t alignUint64;
+    void* alignPointer;
+    /** @} */
+} AiaMemoryHeader_t;
+
+/** The @c classIndex of allocations served by the heap. */
+#define AIA_MEMORY_ARENA_HEAP SIZE_MAX
+
+/** A block class and its free list. */
+typedef struct AiaMemoryArenaPool
+{
+    /** Usage of the class. */
+    AiaMemoryArenaClassStats_t stats;
+
+    /** The first free block. */
+    AiaMemoryHeader_t* freeList;
+} AiaMemoryArenaPool_t;
+
+/** @name Variables synchronized by g_spinLock. */
+/** @{ */
+
+/** The classes of the arena, of which the first @c g_numPools are in use. */
+static AiaMemoryArenaPool_t g_pools[ AIA_MEMORY_ARENA_MAX_CLASSES ];
+static size_t g_numPools;
+
+/** The overflow policy passed to @c AiaMemoryArena_Init(). */
+static AiaMemoryArenaOverflowPolicy_t g_overflowPolicy;
+
+/** The number of live allocations served by the heap. */
+static size_t g_heapAllocations;
+
+/** The arena passed to @c AiaMemoryArena_Init() and its size. */
+static void* g_arena;
+static size_t g_arenaSize;
+
+/** @} */
+
+/** Simple spin lock guarding the pools above. Allocation is a leaf operation,
+ * so the critical sections are short and never block. */
+static AiaAtomicBool_t g_spinLock = false;
+
+static void AiaMemoryArena_Lock()
+{
+    while( !AiaAtomic_CompareAndSwap_u32( &g_spinLock, 1, 0 ) )
+    {
+        /* spin lock, inefficient */
+    }
+}
+
+static void AiaMemoryArena_Unlock()
+{
+    AiaAtomicBool_Clear( &g_spinLock );
+}
+
+/**
+ * Computes the stride between blocks of a class.
+ *
+ * @param blockSize The block size of the class.
+ * @return The stride in bytes, or @c 0 if it overflows a @c size_t.
+ */
+static size_t AiaMemoryArena_GetStride( size_t blockSize )
+{
+    size_t units = blockSize / sizeof( AiaMemoryHeader_t ) +
+                   ( blockSize % sizeof( AiaMemoryHeader_t ) != 0 );
+    if( units >= SIZE_MAX / sizeof( AiaMemoryHeader_t ) )
+    {
+        return 0;
+    }
+    return ( units + 1 ) * sizeof( AiaMemoryHeader_t );
+}
+
+size_t AiaMemoryArena_GetRequiredSize( const AiaMemoryArenaClass_t* classes,
+                                       size_t numClasses )
+{
+    /* Leave room to realign the start of an arbitrary arena. */
+    size_t required = sizeof( AiaMemoryHeader_t ) - 1;
+    for( size_t i = 0; i < numClasses; ++i )
+    {
+        size_t stride = AiaMemoryArena_GetStride( classes[ i ].blockSize );
+        if( !stride ||
+            ( classes[ i ].numBlocks &&
+              stride > ( SIZE_MAX - required ) / classes[ i ].numBlocks ) )
+        {
+            return 0;
+        }
+        required += stride * classes[ i ].numBlocks;
+    }
+    return required;
+}
+
+bool AiaMemoryArena_Init( void* arena, size_t arenaSize,
+                          const AiaMemoryArenaClass_t* classes,
+                          size_t numClasses,
+                          AiaMemoryArenaOverflowPolicy_t overflowPolicy )
+{
+    if( !arena || !classes || !numClasses ||
+        numClasses > AIA_MEMORY_ARENA_MAX_CLASSES )
+    {
+        return false;
+    }
+    for( size_t i = 1; i < numClasses; ++i )
+    {
+        if( classes[ i ].blockSize <= classes[ i - 1 ].blockSize )
+        {
+            return false;
+        }
+    }
+    size_t required = AiaMemoryArena_GetRequiredSize( classes, numClasses );
+    if( !required || arenaSize < required )
+    {
+        return false;
+    }
+
+    uint8_t* next = arena;
+    size_t misalignment = (uintptr_t)next % sizeof( AiaMemoryHeader_t );
+    if( misalignment )
+    {
+        next += sizeof( AiaMemoryHeader_t ) - misalignment;
+    }
+
+    AiaMemoryArena_Lock();
+    if( g_numPools )
+    {
+        AiaMemoryArena_Unlock();
+        return false;
+    }
+    for( size_t i = 0; i < numClasses; ++i )
+    {
+        AiaMemoryArenaPool_t* pool = &g_pools[ i ];
+        size_t stride = AiaMemoryArena_GetStride( classes[ i ].blockSize );
+        pool->stats.blockSize = classes[ i ].blockSize;
+        pool->stats.numBlocks = classes[ i ].numBlocks;
+        pool->freeList = NULL;
+
+        /* Thread the free list back to front, so blocks are handed out in
+         * address order. */
+        for( size_t block = classes[ i ].numBlocks; block > 0; --block )
+        {
+            AiaMemoryHeader_t* header =
+                (AiaMemoryHeader_t*)( next + ( block - 1 ) * stride );
+            header->next = pool->freeList;
+            pool->freeList = header;
+        }
+        next += stride * classes[ i ].numBlocks;
+    }
+    g_overflowPolicy = overflowPolicy;
+    g_arena = arena;
+    g_arenaSize = arenaSize;
+    g_numPools = numClasses;
+    AiaMemoryArena_Unlock();
+    return true;
+}
+
+/**
+ * Takes a free block from the first class at or after @c first which has one.
+ * @note Must be called with @c g_spinLock held.
+ *
+ * @param first The index of the first class to try.
+ * @param last The index of the last class to try.
+ * @return The header of the block, or @c NULL if every class tried is full.
+ */
+static AiaMemoryHeader_t* AiaMemoryArena_TakeBlockLocked( size_t first,
+                                                          size_t last )
+{
+    for( size_t i = first; i <= last && i < g_numPools; ++i )
+    {
+        AiaMemoryArenaPool_t* pool = &g_pools[ i ];
+        AiaMemoryHeader_t* header = pool->freeList;
+        if( !header )
+        {
+            continue;
+        }
+        pool->freeList = header->next;
+        if( ++pool->stats.blocksInUse > pool->stats.peakBlocksInUse )
+        {
+            pool->stats.peakBlocksInUse = pool->stats.blocksInUse;
+        }
+        header->classIndex = i;
+        return header;
+    }
+    return NULL;
+}
+
+void* AiaCalloc( size_t count, size_t size )
+{
+    if( size && count > ( SIZE_MAX - sizeof( AiaMemoryHeader_t ) ) / size )
+    {
+        return NULL;
+    }
+    size_t bytes = count * size;
+
+    AiaMemoryArena_Lock();
+    size_t fitting = 0;
+    while( fitting < g_numPools && g_pools[ fitting ].stats.blockSize < bytes )
+    {
+        ++fitting;
+    }
+    AiaMemoryHeader_t* header = NULL;
+    bool useHeap = !g_numPools;
+    if( fitting < g_numPools )
+    {
+        header = AiaMemoryArena_TakeBlockLocked( fitting, fitting );
+        if( !header )
+        {
+            ++g_pools[ fitting ].stats.overflows;
+            if( g_overflowPolicy != AIA_MEMORY_ARENA_OVERFLOW_FAIL )
+            {
+                header = AiaMemoryArena_TakeBlockLocked( fitting + 1,
+                                                         g_numPools - 1 );
+            }
+        }
+    }
+    if( !header && g_overflowPolicy == AIA_MEMORY_ARENA_OVERFLOW_HEAP )
+    {
+        useHeap = true;
+    }
+    AiaMemoryArena_Unlock();
+
+    if( header )
+    {
+        memset( header + 1, 0, bytes );
+        return header + 1;
+    }
+    if( !useHeap )
+    {
+        return NULL;
+    }
+
+    header = calloc( 1, sizeof( *header ) + bytes );
+    if( !header )
+    {
+        return NULL;
+    }
+    header->classIndex = AIA_MEMORY_ARENA_HEAP;
+    AiaMemoryArena_Lock();
+    ++g_heapAllocations;
+    AiaMemoryArena_Unlock();
+    return header + 1;
+}
+
+void AiaFree( void* ptr )
+{
+    if( !ptr )
+    {
+        return;
+    }
+    AiaMemoryHeader_t* header = (AiaMemoryHeader_t*)ptr - 1;
+
+    AiaMemoryArena_Lock();
+    if( header->classIndex == AIA_MEMORY_ARENA_HEAP )
+    {
+        --g_heapAllocations;
+        AiaMemoryArena_Unlock();
+        free( header );
+        return;
+    }
+    AiaMemoryArenaPool_t* pool = &g_pools[ header->classIndex ];
+    --pool->stats.blocksInUse;
+    header->next = pool->freeList;
+    pool->freeList = header;
+    AiaMemoryArena_Unlock();
+}
+
+size_t AiaMemoryArena_GetStats( AiaMemoryArenaClassStats_t* stats,
+                                size_t maxClasses, size_t* heapAllocations )
+{
+    AiaMemoryArena_Lock();
+    size_t numPools = g_numPools;
+    for( size_t i = 0; stats && i < numPools && i < maxClasses; ++i )
+    {
+        stats[ i ] = g_pools[ i ].stats;
+    }
+    if( heapAllocations )
+    {
+        *heapAllocations = g_heapAllocations;
+    }
+    AiaMemoryArena_Unlock();
+    return numPools;
+}
+
+#ifdef AIA_ENABLE_MEMORY_PREFAULT
+/** Whether @c AiaMemoryArena_Prefault() has run. */
+static AiaAtomicBool_t g_isPrefaulted = false;
+
+bool AiaMemoryArena_Prefault( bool lock )
+{
+    AiaMemoryArena_Lock();
+    void* arena = g_arena;
+    size_t arenaSize = g_arenaSize;
+    AiaMemoryArena_Unlock();
+    if( !arena )
+    {
+        return false;
+    }
+    /* The arena is shared by every client, so it is only prefaulted once. */
+    if( !AiaAtomic_CompareAndSwap_u32( &g_isPrefaulted, 1, 0 ) )
+    {
+        return true;
+    }
+    return AiaMemory_Prefault( arena, arenaSize, lock );
+}
+#endif
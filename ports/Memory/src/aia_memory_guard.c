@@ -0,0 +1,148 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_guard.c
+ * @brief Implements the allocation guard declared in @c aia_memory_config.h.
+ */
+
+#include <memory/aia_memory_config.h>
+#include <iot/aia_iot_config.h>
+
+#include <assert.h>
+#include <string.h>
+
+/** The hot path the calling thread is on, and how deeply it is nested. */
+static __thread AiaMemoryGuardHotPath_t g_hotPath;
+static __thread size_t g_hotPathDepth;
+
+/** Whether hot paths are guarded, and whether allocations on them assert.
+ * These should only be accessed using atomic operations. */
+static AiaAtomicBool_t g_isSteadyState = false;
+static AiaAtomicBool_t g_isAssertOnAllocation = false;
+
+/** @name Variables synchronized by g_spinLock. */
+/** @{ */
+
+/** The call sites recorded, of which the first @c g_numCallSites are in use. */
+static AiaMemoryGuardCallSite_t g_callSites[ AIA_MEMORY_GUARD_MAX_CALL_SITES ];
+static size_t g_numCallSites;
+
+/** The total number of allocations recorded. */
+static size_t g_total;
+
+/** @} */
+
+/** Simple spin lock guarding the records above. */
+static AiaAtomicBool_t g_spinLock = false;
+
+static void AiaMemoryGuard_Lock()
+{
+    while( !AiaAtomic_CompareAndSwap_u32( &g_spinLock, 1, 0 ) )
+    {
+        /* spin lock, inefficient */
+    }
+}
+
+static void AiaMemoryGuard_Unlock()
+{
+    AiaAtomicBool_Clear( &g_spinLock );
+}
+
+void AiaMemoryGuard_Begin( AiaMemoryGuardHotPath_t hotPath )
+{
+    if( !g_hotPathDepth++ )
+    {
+        g_hotPath = hotPath;
+    }
+}
+
+void AiaMemoryGuard_End( AiaMemoryGuardHotPath_t hotPath )
+{
+    (void)hotPath;
+    if( g_hotPathDepth )
+    {
+        --g_hotPathDepth;
+    }
+}
+
+void AiaMemoryGuard_MarkSteadyState( bool assertOnAllocation )
+{
+    if( assertOnAllocation )
+    {
+        AiaAtomicBool_Set( &g_isAssertOnAllocation );
+    }
+    else
+    {
+        AiaAtomicBool_Clear( &g_isAssertOnAllocation );
+    }
+    AiaAtomicBool_Set( &g_isSteadyState );
+}
+
+void AiaMemoryGuard_ClearSteadyState( void )
+{
+    AiaAtomicBool_Clear( &g_isSteadyState );
+}
+
+size_t AiaMemoryGuard_GetCallSites( AiaMemoryGuardCallSite_t* callSites,
+                                    size_t maxCallSites, size_t* total )
+{
+    AiaMemoryGuard_Lock();
+    for( size_t i = 0; callSites && i < g_numCallSites && i < maxCallSites;
+         ++i )
+    {
+        callSites[ i ] = g_callSites[ i ];
+    }
+    if( total )
+    {
+        *total = g_total;
+    }
+    size_t numCallSites = g_numCallSites;
+    AiaMemoryGuard_Unlock();
+    return numCallSites;
+}
+
+void AiaMemoryGuard_OnAllocation( const char* file, int line )
+{
+    if( !g_hotPathDepth || !AiaAtomicBool_Load( &g_isSteadyState ) )
+    {
+        return;
+    }
+
+    AiaMemoryGuard_Lock();
+    ++g_total;
+    size_t i = 0;
+    while( i < g_numCallSites &&
+           ( g_callSites[ i ].line != line ||
+             g_callSites[ i ].hotPath != g_hotPath ||
+             strcmp( g_callSites[ i ].file, file ) ) )
+    {
+        ++i;
+    }
+    if( i < g_numCallSites )
+    {
+        ++g_callSites[ i ].count;
+    }
+    else if( g_numCallSites < AIA_MEMORY_GUARD_MAX_CALL_SITES )
+    {
+        AiaMemoryGuardCallSite_t callSite = { file, line, g_hotPath, 1 };
+        g_callSites[ g_numCallSites++ ] = callSite;
+    }
+    AiaMemoryGuard_Unlock();
+
+    assert( !AiaAtomicBool_Load( &g_isAssertOnAllocation ) &&
+            "AiaCalloc() on a hot path in steady state" );
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_prefault.c
+ * @brief Implements the prefaulted memory declared in @c aia_memory_config.h.
+ */
+
+#include <memory/aia_memory_config.h>
+#include <iot/aia_iot_config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/** The number of bytes currently prefaulted. Synchronized by g_spinLock. */
+static size_t g_prefaultedBytes;
+
+/** Simple spin lock guarding the count above. */
+static AiaAtomicBool_t g_spinLock = false;
+
+static void AiaMemoryPrefault_Lock()
+{
+    while( !AiaAtomic_CompareAndSwap_u32( &g_spinLock, 1, 0 ) )
+    {
+        /* spin lock, inefficient */
+    }
+}
+
+static void AiaMemoryPrefault_Unlock()
+{
+    AiaAtomicBool_Clear( &g_spinLock );
+}
+
+/**
+ * Rounds @c memory out to the pages spanning it.
+ *
+ * @param memory The start of the memory.
+ * @param size The size of the memory in bytes.
+ * @param[out] length The length of the pages in bytes.
+ * @return The start of the first page.
+ */
+static uint8_t* AiaMemoryPrefault_GetPages( void* memory, size_t size,
+                                            size_t* length )
+{
+    uintptr_t pageSize = (uintptr_t)sysconf( _SC_PAGESIZE );
+    uintptr_t start = (uintptr_t)memory & ~( pageSize - 1 );
+    uintptr_t end = ( (uintptr_t)memory + size + pageSize - 1 ) &
+                    ~( pageSize - 1 );
+    *length = end - start;
+    return (uint8_t*)start;
+}
+
+bool AiaMemory_Prefault( void* memory, size_t size, bool lock )
+{
+    if( !memory || !size )
+    {
+        return false;
+    }
+    size_t length;
+    uint8_t* pages = AiaMemoryPrefault_GetPages( memory, size, &length );
+
+    /* Locking a private mapping also faults its pages in for writing. */
+    bool locked = lock && !mlock( pages, length );
+    if( !locked )
+    {
+#ifdef MADV_POPULATE_WRITE
+        if( madvise( pages, length, MADV_POPULATE_WRITE ) )
+#endif
+        {
+            /* The memory may be in use, so each page is written with an atomic
+             * no-op rather than a plain store. */
+            size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+            for( size_t offset = 0; offset < length; offset += pageSize )
+            {
+                __atomic_fetch_or( pages + offset, 0, __ATOMIC_RELAXED );
+            }
+        }
+    }
+
+    AiaMemoryPrefault_Lock();
+    g_prefaultedBytes += length;
+    AiaMemoryPrefault_Unlock();
+    return locked || !lock;
+}
+
+void AiaMemory_Unprefault( void* memory, size_t size )
+{
+    if( !memory || !size )
+    {
+        return;
+    }
+    size_t length;
+    uint8_t* pages = AiaMemoryPrefault_GetPages( memory, size, &length );
+
+    /* Only pages entirely within the memory are unlocked. */
+    size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+    uint8_t* first = pages + ( pages < (uint8_t*)memory ? pageSize : 0 );
+    uint8_t* last = pages + length;
+    if( last > (uint8_t*)memory + size )
+    {
+        last -= pageSize;
+    }
+    if( first < last )
+    {
+        munlock( first, last - first );
+    }
+
+    AiaMemoryPrefault_Lock();
+    g_prefaultedBytes -= length;
+    AiaMemoryPrefault_Unlock();
+}
+
+void AiaMemory_GetPrefaultStats( AiaMemoryPrefaultStats_t* stats )
+{
+    if( !stats )
+    {
+        return;
+    }
+    AiaMemoryPrefault_Lock();
+    stats->prefaultedBytes = g_prefaultedBytes;
+    AiaMemoryPrefault_Unlock();
+
+    stats->lockedBytes = 0;
+    FILE* status = fopen( "/proc/self/status", "r" );
+    if( !status )
+    {
+        return;
+    }
+    char line[ 128 ];
+    size_t lockedKb;
+    while( fgets( line, sizeof( line ), status ) )
+    {
+        if( sscanf( line, "VmLck: %zu kB", &lockedKb ) == 1 )
+        {
+            stats->lockedBytes = lockedKb * 1024;
+            break;
+        }
+    }
+    fclose( status );
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_stats.c
+ * @brief Implements the instrumented allocator declared in @c
+ * aia_memory_config.h.
+ */
+
+#include <memory/aia_memory_config.h>
+#include <iot/aia_iot_config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Header placed in front of every allocation. */
+typedef union AiaMemoryHeader
+{
+    struct
+    {
+        /** The number of bytes requested. */
+        size_t size;
+
+        /** The index of the subsystem that made the allocation. */
+        size_t subsystem;
+    } allocation;
+
+    /** @name Members forcing the header to keep the allocation aligned. */
+    /** @{ */
+    long double alignLongDouble;
+    uint64_t alignUint64;
+    void* alignPointer;
+    /** @} */
+} AiaMemoryHeader_t;
+
+/** The name allocations are counted under once every other slot is taken. */
+static const char* AIA_MEMORY_STATS_OTHER_SUBSYSTEM = "other";
+
+/** @name Variables synchronized by g_spinLock. */
+/** @{ */
+
+/** Usage per subsystem, of which the first @c g_numSubsystems are in use. */
+static AiaMemoryStats_t g_subsystems[ AIA_MEMORY_STATS_MAX_SUBSYSTEMS ];
+static size_t g_numSubsystems;
+
+/** Usage of the process as a whole. */
+static AiaMemoryStats_t g_total;
+
+/** The last peak passed to @c g_highWaterMarkCallback. */
+static size_t g_lastReportedPeakBytes;
+
+/** The high-water mark callback, its step and its user data. */
+static AiaMemoryHighWaterMarkCallback_t g_highWaterMarkCallback;
+static size_t g_highWaterMarkStepBytes;
+static void* g_highWaterMarkUserData;
+
+/** @} */
+
+/** Simple spin lock guarding the statistics above. Allocation is a leaf
+ * operation, so the critical sections are short and never block. */
+static AiaAtomicBool_t g_spinLock = false;
+
+static void AiaMemoryStats_Lock()
+{
+    while( !AiaAtomic_CompareAndSwap_u32( &g_spinLock, 1, 0 ) )
+    {
+        /* spin lock, inefficient */
+    }
+}
+
+static void AiaMemoryStats_Unlock()
+{
+    AiaAtomicBool_Clear( &g_spinLock );
+}
+
+/**
+ * Finds the subsystem name within an @c AIA_MEMORY_TAG. Paths map to the name
+ * of the folder holding the file; anything else is used as is.
+ *
+ * @param tag The tag to parse.
+ * @param[out] length The length of the name.
+ * @return The start of the name within @c tag.
+ */
+static const char* AiaMemoryStats_ParseTag( const char* tag, size_t* length )
+{
+    const char* end = NULL;
+    const char* start = tag;
+    for( const char* c = tag; *c; ++c )
+    {
+        if( *c == '/' || *c == '\\' )
+        {
+            start = end ? end + 1 : tag;
+            end = c;
+        }
+    }
+    if( !end )
+    {
+        *length = strlen( tag );
+        return tag;
+    }
+    *length = end - start;
+    return start;
+}
+
+/**
+ * Finds the slot for @c tag, claiming a new one if needed.
+ * @note Must be called with @c g_spinLock held.
+ *
+ * @param tag The tag of the allocation.
+ * @return The index of the subsystem in @c g_subsystems.
+ */
+static size_t AiaMemoryStats_FindSubsystemLocked( const char* tag )
+{
+    size_t length;
+    const char* name = AiaMemoryStats_ParseTag( tag, &length );
+    if( length > AIA_MEMORY_STATS_MAX_NAME_LENGTH )
+    {
+        length = AIA_MEMORY_STATS_MAX_NAME_LENGTH;
+    }
+
+    for( size_t i = 0; i < g_numSubsystems; ++i )
+    {
+        if( !strncmp( g_subsystems[ i ].subsystem, name, length ) &&
+            g_subsystems[ i ].subsystem[ length ] == '\0' )
+        {
+            return i;
+        }
+    }
+
+    size_t index = g_numSubsystems;
+    if( index == AIA_MEMORY_STATS_MAX_SUBSYSTEMS - 1 )
+    {
+        name = AIA_MEMORY_STATS_OTHER_SUBSYSTEM;
+        length = strlen( AIA_MEMORY_STATS_OTHER_SUBSYSTEM );
+    }
+    else if( index == AIA_MEMORY_STATS_MAX_SUBSYSTEMS )
+    {
+        return AIA_MEMORY_STATS_MAX_SUBSYSTEMS - 1;
+    }
+    memcpy( g_subsystems[ index ].subsystem, name, length );
+    g_subsystems[ index ].subsystem[ length ] = '\0';
+    ++g_numSubsystems;
+    return index;
+}
+
+/**
+ * Adds an allocation to @c stats.
+ *
+ * @param stats The statistics to update.
+ * @param size The size of the allocation.
+ * @return @c true if @c stats reached a new peak, else @c false.
+ */
+static bool AiaMemoryStats_AddAllocation( AiaMemoryStats_t* stats,
+                                          size_t size )
+{
+    stats->liveBytes += size;
+    ++stats->liveAllocations;
+    ++stats->totalAllocations;
+    if( stats->liveBytes > stats->peakBytes )
+    {
+        stats->peakBytes = stats->liveBytes;
+        return true;
+    }
+    return false;
+}
+
+void* AiaMemory_Calloc( size_t count, size_t size, const char* tag )
+{
+    if( size && count > ( SIZE_MAX - sizeof( AiaMemoryHeader_t ) ) / size )
+    {
+        return NULL;
+    }
+    size_t bytes = count * size;
+    AiaMemoryHeader_t* header = calloc( 1, sizeof( *header ) + bytes );
+    if( !header )
+    {
+        return NULL;
+    }
+
+    AiaMemoryStats_Lock();
+    size_t subsystem = AiaMemoryStats_FindSubsystemLocked( tag );
+    AiaMemoryStats_AddAllocation( &g_subsystems[ subsystem ], bytes );
+    AiaMemoryHighWaterMarkCallback_t callback = NULL;
+    void* userData = NULL;
+    if( AiaMemoryStats_AddAllocation( &g_total, bytes ) &&
+        g_highWaterMarkCallback &&
+        g_total.peakBytes >=
+            g_lastReportedPeakBytes + g_highWaterMarkStepBytes )
+    {
+        g_lastReportedPeakBytes = g_total.peakBytes;
+        callback = g_highWaterMarkCallback;
+        userData = g_highWaterMarkUserData;
+    }
+    size_t peakBytes = g_total.peakBytes;
+    AiaMemoryStats_Unlock();
+
+    /* The name of a claimed slot never changes, so it can be read unlocked. */
+    if( callback )
+    {
+        callback( peakBytes, g_subsystems[ subsystem ].subsystem, userData );
+    }
+
+    header->allocation.size = bytes;
+    header->allocation.subsystem = subsystem;
+    return header + 1;
+}
+
+void AiaFree( void* ptr )
+{
+    if( !ptr )
+    {
+        return;
+    }
+    AiaMemoryHeader_t* header = (AiaMemoryHeader_t*)ptr - 1;
+
+    AiaMemoryStats_Lock();
+    AiaMemoryStats_t* stats = &g_subsystems[ header->allocation.subsystem ];
+    stats->liveBytes -= header->allocation.size;
+    --stats->liveAllocations;
+    g_total.liveBytes -= header->allocation.size;
+    --g_total.liveAllocations;
+    AiaMemoryStats_Unlock();
+
+    free( header );
+}
+
+size_t AiaMemoryStats_Get( AiaMemoryStats_t* total,
+                           AiaMemoryStats_t* subsystems,
+                           size_t maxSubsystems )
+{
+    AiaMemoryStats_Lock();
+    if( total )
+    {
+        *total = g_total;
+    }
+    size_t numSubsystems = g_numSubsystems;
+    for( size_t i = 0; subsystems && i < numSubsystems && i < maxSubsystems;
+         ++i )
+    {
+        subsystems[ i ] = g_subsystems[ i ];
+    }
+    AiaMemoryStats_Unlock();
+    return numSubsystems;
+}
+
+void AiaMemoryStats_SetHighWaterMarkCallback(
+    AiaMemoryHighWaterMarkCallback_t callback, size_t stepBytes,
+    void* userData )
+{
+    AiaMemoryStats_Lock();
+    g_highWaterMarkCallback = callback;
+    g_highWaterMarkStepBytes = stepBytes;
+    g_highWaterMarkUserData = userData;
+    g_lastReportedPeakBytes = g_total.peakBytes;
+    AiaMemoryStats_Unlock();
+}
@@ -26,8 +26,11 @@ extern "C" {
 #define MICROPHONE_PUBLISH_RATE ( (AiaDurationMs_t)50 )
 
 /**
- * The amount of microphone samples that will be published when the microphone
- * is open per @c MICROPHONE_PUBLISH_RATE iteration.
+ * The maximum amount of microphone samples that will be published when the
+ * microphone is open per @c MICROPHONE_PUBLISH_RATE iteration. Right after the
+ * microphone is opened, smaller chunks matching the microphone regulator's
+ * cadence are published so that the first audio reaches the service quickly,
+ * growing to this size as streaming is established.
  *
  * @note 800 samples represents the real time rate for 50 ms. However, in
  * situations involving preroll (wakeword), UPL will benefit from reading faster
@@ -37,6 +40,48 @@ extern "C" {
  */
 static const size_t AIA_MICROPHONE_CHUNK_SIZE_SAMPLES = 1600;
 
+/**
+ * The amount of microphone samples that must be buffered before the microphone
+ * streaming task is woken up by the writer to publish them. Once the reader has
+ * caught up with the writer, chunks are published as soon as this many samples
+ * have been written rather than on the next @c MICROPHONE_PUBLISH_RATE tick.
+ *
+ * @note 800 samples represents the real time rate for 50 ms. This must not
+ * exceed @c AIA_MICROPHONE_CHUNK_SIZE_SAMPLES.
+ */
+static const size_t AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES = 800;
+
+/**
+ * The number of microphone chunk buffers, each holding @c
+ * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES samples, that are preallocated when the
+ * microphone manager is created. Chunks are recycled once they have been
+ * published, so steady-state streaming does not allocate from the heap. If more
+ * chunks than this are awaiting publication (e.g. while the connection is
+ * backed up), additional chunks are allocated from the heap.
+ */
+static const size_t AIA_MICROPHONE_CHUNK_POOL_SIZE = 4;
+
+/**
+ * The amount of microphone data, in bytes, that may be queued in the microphone
+ * regulator before the microphone manager stops reading from the microphone
+ * buffer. Unread audio stays in the microphone buffer rather than being
+ * dropped, and streaming resumes once the queue drains to @c
+ * AIA_MICROPHONE_UPLINK_LOW_WATERMARK_BYTES.
+ *
+ * @note 12800 bytes is @c AIA_MICROPHONE_CHUNK_POOL_SIZE chunks of @c
+ * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES 16-bit samples. The microphone buffer
+ * should hold more audio than this, or overruns will occur before backpressure
+ * applies.
+ */
+static const size_t AIA_MICROPHONE_UPLINK_HIGH_WATERMARK_BYTES = 12800;
+
+/**
+ * The amount of queued microphone data, in bytes, at which streaming resumes
+ * after reaching @c AIA_MICROPHONE_UPLINK_HIGH_WATERMARK_BYTES. This must be
+ * less than @c AIA_MICROPHONE_UPLINK_HIGH_WATERMARK_BYTES.
+ */
+static const size_t AIA_MICROPHONE_UPLINK_LOW_WATERMARK_BYTES = 6400;
+
 #ifdef __cplusplus
 }
 #endif
@@ -103,11 +103,11 @@ bool AiaLoadSecret( uint8_t* sharedSecret, size_t size );
 /** @} */
 
 /**
- * @name Retrieval of local volume. Implementations are not required to
- * be thread-safe. These functions are optional and only required if the device
- * persists volume locally or allows for local offline changes to volume. AIA
- * will use a cached server-side volume if @c AIA_LOAD_VOLUME is not defined. If
- * not desired, delete the below portion.
+ * @name Retrieval and persistent storage of local volume. Implementations are
+ * not required to be thread-safe. These functions are optional and only
+ * required if the device persists volume locally or allows for local offline
+ * changes to volume. AIA will use a cached server-side volume if @c
+ * AIA_LOAD_VOLUME is not defined. If not desired, delete the below portion.
  */
 /** @{ */
 
@@ -121,6 +121,19 @@ uint8_t AiaLoadVolume();
 
 #define AIA_LOAD_VOLUME AiaLoadVolume
 
+/**
+ * Persists the current volume so that it is returned by @c AIA_LOAD_VOLUME
+ * after a restart. Volume changes are written behind, once the volume has
+ * stopped changing for a while, so this is not called for every step of a
+ * slider drag.
+ *
+ * @param volume The volume to persist.
+ * @return @c true on success or @c false otherwise.
+ */
+bool AiaStoreVolume( uint8_t volume );
+
+#define AIA_STORE_VOLUME AiaStoreVolume
+
 /** @} */
 
 /**
@@ -222,6 +235,27 @@ size_t AiaGetAlertsSize();
  */
 bool AiaAlertsBlobExists();
 
+/**
+ * Starts a transaction grouping alert changes. Until @c
+ * AiaCommitAlertTransaction() is called, @c AiaStoreAlert() and @c
+ * AiaDeleteAlert() may defer persisting their changes, so that a batch of
+ * changes costs a single write to persistent storage.
+ *
+ * @return @c true on success or @c false otherwise, in which case no
+ * transaction is open.
+ * @note Transactions do not nest.
+ */
+bool AiaBeginAlertTransaction();
+
+/**
+ * Persists all alert changes made since @c AiaBeginAlertTransaction() and
+ * closes the transaction.
+ *
+ * @return @c true on success or @c false otherwise, in which case the changes
+ * made during the transaction may not have been persisted.
+ */
+bool AiaCommitAlertTransaction();
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,23 +25,43 @@
 
 #include <aia_config.h>
 
+#include <aia_capabilities_config.h>
+
 #include <aiaalertmanager/aia_alert_constants.h>
 #include <aiacore/aia_volume_constants.h>
 
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <unistd.h>
 
 const char* g_aiaClientId;
 const char* g_aiaAwsAccountId;
 const char* g_aiaStorageFolder;
 
+#define AIA_VOLUME_STORAGE_KEY "AiaVolumeStorageKey"
+
 #ifdef AIA_LOAD_VOLUME
 
 uint8_t AiaLoadVolume()
 {
-    /* TODO: ADSER-1741 Provide an actual reference implementation of persisting
-     * device volume. */
-    return AIA_DEFAULT_VOLUME;
+    uint8_t volume;
+    if( !AiaBlobExists( AIA_VOLUME_STORAGE_KEY ) ||
+        !AiaLoadBlob( AIA_VOLUME_STORAGE_KEY, &volume, sizeof( volume ) ) ||
+        volume > AIA_MAX_VOLUME )
+    {
+        return AIA_DEFAULT_VOLUME;
+    }
+    return volume;
+}
+
+#endif
+
+#ifdef AIA_STORE_VOLUME
+
+bool AiaStoreVolume( uint8_t volume )
+{
+    return AiaStoreBlob( AIA_VOLUME_STORAGE_KEY, &volume, sizeof( volume ) );
 }
 
 #endif
@@ -237,112 +257,364 @@ size_t AiaGetBlobSize( const char* key )
 
 #define AIA_ALL_ALERTS_STORAGE_KEY_V0 "AiaAllAlertsStorageKey"
 
-bool AiaStoreAlert( const char* alertToken, size_t alertTokenLen,
-                    AiaTimepointSeconds_t scheduledTime,
-                    AiaDurationMs_t duration, uint8_t alertType )
+/** Key of the blob an alert transaction is staged in before it replaces the
+ * alerts blob. */
+#define AIA_ALL_ALERTS_TRANSACTION_KEY AIA_ALL_ALERTS_STORAGE_KEY_V0 "Staged"
+
+/**
+ * In-memory index of the records in the alerts blob, which lets a single
+ * record be located and rewritten in place rather than rewriting the whole
+ * blob. Records are kept contiguous, and @c tokens mirrors their order.
+ */
+typedef struct AiaAlertsIndex
 {
-    if( !alertToken )
+    /** Whether the index has been loaded from persistent storage. */
+    bool loaded;
+
+    /** Number of records in the alerts blob. */
+    size_t numAlerts;
+
+    /** Number of tokens @c tokens has space for. */
+    size_t capacity;
+
+    /** @c AIA_ALERT_TOKEN_CHARS characters for each record, by slot. */
+    char* tokens;
+
+    /** Contents of the alerts blob, with space for @c capacity records, while
+     * a transaction is open, or @c NULL otherwise. */
+    uint8_t* transaction;
+} AiaAlertsIndex_t;
+
+/** Index of the alerts blob, lazily loaded on first use. */
+static AiaAlertsIndex_t g_aiaAlertsIndex;
+
+/**
+ * Formats the path of the file backing a blob.
+ *
+ * @param[out] filePath Buffer to format the path into, or @c NULL to only
+ * compute its length.
+ * @param size The size of @c filePath.
+ * @param key The key of the blob.
+ * @return The length of the path, or a negative value on failure.
+ */
+static int AiaFormatBlobPath( char* filePath, size_t size, const char* key )
+{
+    return snprintf( filePath, size, PERSISTENT_STORAGE_FILE_PATH_FORMAT,
+                     g_aiaStorageFolder, g_aiaAwsAccountId, g_aiaClientId,
+                     key );
+}
+
+/**
+ * Opens the file backing the alerts blob.
+ *
+ * @param flags Flags to pass to @c open().
+ * @return The file descriptor, or a negative value on failure.
+ */
+static int AiaOpenAlertsFile( int flags )
+{
+    int numCharsRequired =
+        AiaFormatBlobPath( NULL, 0, AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    if( numCharsRequired < 0 )
     {
-        AiaLogError( "Null alertToken" );
-        return false;
+        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
+        return -1;
     }
-    if( alertTokenLen != AIA_ALERT_TOKEN_CHARS )
+    char filePath[ numCharsRequired + 1 ];
+    if( AiaFormatBlobPath( filePath, numCharsRequired + 1,
+                           AIA_ALL_ALERTS_STORAGE_KEY_V0 ) < 0 )
     {
-        AiaLogError( "Invalid alert token length" );
+        AiaLogError( "snprintf failed" );
+        return -1;
+    }
+    int fd = open( filePath, flags, 0644 );
+    if( fd < 0 )
+    {
+        AiaLogError( "open failed: %s", strerror( errno ) );
+    }
+    return fd;
+}
+
+/**
+ * Grows @c g_aiaAlertsIndex, and the open transaction if any, to hold at
+ * least @c numAlerts records.
+ *
+ * @param numAlerts The number of tokens to make space for.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaReserveAlertsIndex( size_t numAlerts )
+{
+    if( numAlerts <= g_aiaAlertsIndex.capacity )
+    {
+        return true;
+    }
+    size_t capacity = g_aiaAlertsIndex.capacity
+                          ? g_aiaAlertsIndex.capacity * 2
+                          : (size_t)AIA_ALERTS_MAX_ALERT_COUNT;
+    if( capacity < numAlerts )
+    {
+        capacity = numAlerts;
+    }
+    char* tokens = AiaCalloc( capacity, AIA_ALERT_TOKEN_CHARS );
+    if( !tokens )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     capacity * AIA_ALERT_TOKEN_CHARS );
         return false;
     }
+    if( g_aiaAlertsIndex.transaction )
+    {
+        uint8_t* transaction =
+            AiaCalloc( capacity, AIA_SIZE_OF_ALERT_IN_BYTES );
+        if( !transaction )
+        {
+            AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                         capacity * AIA_SIZE_OF_ALERT_IN_BYTES );
+            AiaFree( tokens );
+            return false;
+        }
+        memcpy( transaction, g_aiaAlertsIndex.transaction,
+                g_aiaAlertsIndex.numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES );
+        AiaFree( g_aiaAlertsIndex.transaction );
+        g_aiaAlertsIndex.transaction = transaction;
+    }
+    if( g_aiaAlertsIndex.tokens )
+    {
+        memcpy( tokens, g_aiaAlertsIndex.tokens,
+                g_aiaAlertsIndex.numAlerts * AIA_ALERT_TOKEN_CHARS );
+        AiaFree( g_aiaAlertsIndex.tokens );
+    }
+    g_aiaAlertsIndex.tokens = tokens;
+    g_aiaAlertsIndex.capacity = capacity;
+    return true;
+}
+
+/**
+ * Finds the slot of an alert in @c g_aiaAlertsIndex.
+ *
+ * @param alertToken The token of the alert, of @c AIA_ALERT_TOKEN_CHARS
+ * characters.
+ * @return The slot of the alert, or @c g_aiaAlertsIndex.numAlerts if it is not
+ * stored.
+ */
+static size_t AiaFindAlertSlot( const char* alertToken )
+{
+    size_t slot = 0;
+    for( ; slot < g_aiaAlertsIndex.numAlerts; ++slot )
+    {
+        if( !memcmp( g_aiaAlertsIndex.tokens + slot * AIA_ALERT_TOKEN_CHARS,
+                     alertToken, AIA_ALERT_TOKEN_CHARS ) )
+        {
+            break;
+        }
+    }
+    return slot;
+}
 
-    size_t allAlertsBytes = AiaGetAlertsSize();
-    size_t alertsBytesWithNewAlert =
-        allAlertsBytes + AIA_SIZE_OF_ALERT_IN_BYTES;
-    size_t startingOffset = allAlertsBytes;
-    size_t bytePosition;
-    bool updatingExistingAlert = false;
+/**
+ * Loads @c g_aiaAlertsIndex from the alerts blob if it has not been already.
+ * This also repairs a blob left behind by an interrupted @c AiaDeleteAlert().
+ *
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaLoadAlertsIndex()
+{
+    if( g_aiaAlertsIndex.loaded )
+    {
+        return true;
+    }
 
-    /**
-     * Load all alerts from persistent storage. Allocated additional space
-     * for a new alert though in case the token we are trying to insert does
-     * not exist in persistent storage yet.
-     */
-    uint8_t* allAlertsBuffer = AiaCalloc( 1, alertsBytesWithNewAlert );
+    size_t allAlertsBytes = AiaAlertsBlobExists() ? AiaGetAlertsSize() : 0;
+    /* Ignore a partially written trailing record. */
+    size_t numRecords = allAlertsBytes / AIA_SIZE_OF_ALERT_IN_BYTES;
+    allAlertsBytes = numRecords * AIA_SIZE_OF_ALERT_IN_BYTES;
+    uint8_t* allAlertsBuffer = AiaCalloc( 1, allAlertsBytes + 1 );
     if( !allAlertsBuffer )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu.", alertsBytesWithNewAlert );
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", allAlertsBytes + 1 );
         return false;
     }
-
-    if( !AiaLoadAlerts( allAlertsBuffer, allAlertsBytes ) )
+    if( !AiaLoadAlerts( allAlertsBuffer, allAlertsBytes ) ||
+        !AiaReserveAlertsIndex( numRecords ) )
     {
-        AiaLogError( "AiaLoadBlob failed" );
+        AiaLogError( "Failed to load alerts" );
         AiaFree( allAlertsBuffer );
         return false;
     }
 
-    /** Go through the tokens to find the first empty or matching one */
-    for( bytePosition = 0; bytePosition < alertsBytesWithNewAlert;
-         bytePosition += AIA_SIZE_OF_ALERT_IN_BYTES )
+    size_t numAlerts = 0;
+    for( ; numAlerts < numRecords; ++numAlerts )
     {
-        startingOffset = bytePosition;
-        if( '\0' == allAlertsBuffer[ bytePosition ] )
+        const uint8_t* record =
+            allAlertsBuffer + numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES;
+        if( '\0' == record[ 0 ] )
         {
-            /** Found an empty token */
             break;
         }
-        else
+        memcpy( g_aiaAlertsIndex.tokens + numAlerts * AIA_ALERT_TOKEN_CHARS,
+                record, AIA_ALERT_TOKEN_CHARS );
+    }
+    AiaFree( allAlertsBuffer );
+    g_aiaAlertsIndex.numAlerts = numAlerts;
+
+    /* A delete moves the last record into the deleted slot before truncating
+     * it; drop the last record if it was left behind as a duplicate. */
+    if( numAlerts > 1 )
+    {
+        g_aiaAlertsIndex.numAlerts = numAlerts - 1;
+        if( AiaFindAlertSlot( g_aiaAlertsIndex.tokens +
+                              ( numAlerts - 1 ) * AIA_ALERT_TOKEN_CHARS ) ==
+            numAlerts - 1 )
+        {
+            g_aiaAlertsIndex.numAlerts = numAlerts;
+        }
+    }
+
+    if( g_aiaAlertsIndex.numAlerts != numRecords ||
+        allAlertsBytes != AiaGetAlertsSize() )
+    {
+        int fd = AiaOpenAlertsFile( O_WRONLY );
+        if( fd < 0 ||
+            ftruncate( fd, (off_t)( g_aiaAlertsIndex.numAlerts *
+                                    AIA_SIZE_OF_ALERT_IN_BYTES ) ) != 0 )
+        {
+            AiaLogWarn( "Failed to truncate alerts blob" );
+        }
+        if( fd >= 0 )
+        {
+            close( fd );
+        }
+    }
+
+    g_aiaAlertsIndex.loaded = true;
+    return true;
+}
+
+/**
+ * Durably writes bytes to a file at a given offset.
+ *
+ * @param fd The file to write to.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @param offset The offset in the file to write @c data at.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaWriteFileBytes( int fd, const uint8_t* data, size_t size,
+                               off_t offset )
+{
+    size_t bytesWritten = 0;
+    while( bytesWritten < size )
+    {
+        ssize_t result = pwrite( fd, data + bytesWritten, size - bytesWritten,
+                                 offset + (off_t)bytesWritten );
+        if( result < 0 )
         {
-            /** Check if this token matches with what we are trying to insert */
-            if( !strncmp( (const char*)allAlertsBuffer + bytePosition,
-                          alertToken, alertTokenLen ) )
+            if( errno == EINTR )
             {
-                updatingExistingAlert = true;
-                break;
+                continue;
             }
+            AiaLogError( "pwrite failed: %s", strerror( errno ) );
+            return false;
         }
+        bytesWritten += (size_t)result;
+    }
+    if( fsync( fd ) != 0 )
+    {
+        AiaLogError( "fsync failed: %s", strerror( errno ) );
+        return false;
     }
+    return true;
+}
+
+/**
+ * Durably writes a single record of the alerts blob in place.
+ *
+ * @param fd The file backing the alerts blob.
+ * @param slot The slot of the record to write.
+ * @param record The @c AIA_SIZE_OF_ALERT_IN_BYTES bytes of the record.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaWriteAlertRecord( int fd, size_t slot, const uint8_t* record )
+{
+    return AiaWriteFileBytes( fd, record, AIA_SIZE_OF_ALERT_IN_BYTES,
+                              (off_t)( slot * AIA_SIZE_OF_ALERT_IN_BYTES ) );
+}
 
-    /* Check if we have reached the alerts storage limit */
-    if( startingOffset == alertsBytesWithNewAlert )
+bool AiaStoreAlert( const char* alertToken, size_t alertTokenLen,
+                    AiaTimepointSeconds_t scheduledTime,
+                    AiaDurationMs_t duration, uint8_t alertType )
+{
+    if( !alertToken )
     {
-        AiaLogError(
-            "AiaStoreAlert failed: Maximum number of local alerts to store "
-            "reached." );
-        AiaFree( allAlertsBuffer );
+        AiaLogError( "Null alertToken" );
+        return false;
+    }
+    if( alertTokenLen != AIA_ALERT_TOKEN_CHARS )
+    {
+        AiaLogError( "Invalid alert token length" );
+        return false;
+    }
+    if( !AiaLoadAlertsIndex() )
+    {
+        AiaLogError( "AiaLoadAlertsIndex failed" );
         return false;
     }
 
-    /** Write the new alert token */
-    uint8_t* newAlertOffset = allAlertsBuffer + startingOffset;
-    memcpy( newAlertOffset, alertToken, alertTokenLen );
+    /* Overwrite the matching record, or append a new one. */
+    size_t slot = AiaFindAlertSlot( alertToken );
+    if( slot == g_aiaAlertsIndex.numAlerts &&
+        !AiaReserveAlertsIndex( slot + 1 ) )
+    {
+        AiaLogError( "AiaReserveAlertsIndex failed" );
+        return false;
+    }
 
-    /** Write the other fields: scheduledTime, duration, alertType */
-    bytePosition = alertTokenLen;
+    /** Serialize the fields: alertToken, scheduledTime, duration, alertType */
+    uint8_t record[ AIA_SIZE_OF_ALERT_IN_BYTES ];
+    memcpy( record, alertToken, alertTokenLen );
+    size_t bytePosition = alertTokenLen;
     for( size_t i = 0; i < sizeof( AiaTimepointSeconds_t );
          ++i, bytePosition++ )
     {
-        newAlertOffset[ bytePosition ] = ( scheduledTime >> ( i * 8 ) );
+        record[ bytePosition ] = ( scheduledTime >> ( i * 8 ) );
     }
     for( size_t i = 0; i < sizeof( AiaDurationMs_t ); ++i, bytePosition++ )
     {
-        newAlertOffset[ bytePosition ] = ( duration >> ( i * 8 ) );
+        record[ bytePosition ] = ( duration >> ( i * 8 ) );
     }
     for( size_t i = 0; i < sizeof( uint8_t ); ++i, bytePosition++ )
     {
-        newAlertOffset[ bytePosition ] = ( alertType >> ( i * 8 ) );
+        record[ bytePosition ] = ( alertType >> ( i * 8 ) );
     }
 
-    /** Store the new blob in persistent storage */
-    size_t storeSize =
-        ( updatingExistingAlert ? allAlertsBytes : alertsBytesWithNewAlert );
-    /** Store the new blob in persistent storage */
-    if( !AiaStoreBlob( AIA_ALL_ALERTS_STORAGE_KEY_V0, allAlertsBuffer,
-                       storeSize ) )
+    if( g_aiaAlertsIndex.transaction )
     {
-        AiaLogError( "AiaStoreBlob failed" );
-        AiaFree( allAlertsBuffer );
-        return false;
+        memcpy( g_aiaAlertsIndex.transaction +
+                    slot * AIA_SIZE_OF_ALERT_IN_BYTES,
+                record, AIA_SIZE_OF_ALERT_IN_BYTES );
+    }
+    else
+    {
+        int fd = AiaOpenAlertsFile( O_WRONLY | O_CREAT );
+        if( fd < 0 )
+        {
+            AiaLogError( "AiaOpenAlertsFile failed" );
+            return false;
+        }
+        bool written = AiaWriteAlertRecord( fd, slot, record );
+        close( fd );
+        if( !written )
+        {
+            AiaLogError( "AiaWriteAlertRecord failed" );
+            return false;
+        }
     }
 
-    AiaFree( allAlertsBuffer );
+    if( slot == g_aiaAlertsIndex.numAlerts )
+    {
+        memcpy( g_aiaAlertsIndex.tokens + slot * AIA_ALERT_TOKEN_CHARS,
+                alertToken, AIA_ALERT_TOKEN_CHARS );
+        ++g_aiaAlertsIndex.numAlerts;
+    }
     return true;
 }
 
@@ -358,70 +630,69 @@ bool AiaDeleteAlert( const char* alertToken, size_t alertTokenLen )
         AiaLogError( "Invalid alert token length" );
         return false;
     }
+    if( !AiaLoadAlertsIndex() )
+    {
+        AiaLogError( "AiaLoadAlertsIndex failed" );
+        return false;
+    }
 
-    size_t allAlertsBytes = AiaGetAlertsSize();
-    size_t bytePosition;
-    bool deletingExistingAlert = false;
+    size_t slot = AiaFindAlertSlot( alertToken );
+    if( slot == g_aiaAlertsIndex.numAlerts )
+    {
+        return true;
+    }
 
-    /**
-     * Load all alerts from persistent storage.
-     */
-    uint8_t* allAlertsBuffer = AiaCalloc( 1, allAlertsBytes );
-    if( !allAlertsBuffer )
+    size_t lastSlot = g_aiaAlertsIndex.numAlerts - 1;
+    if( g_aiaAlertsIndex.transaction )
     {
-        AiaLogError( "AiaCalloc failed, bytes=%zu.", allAlertsBytes );
-        return false;
+        memmove( g_aiaAlertsIndex.transaction +
+                     slot * AIA_SIZE_OF_ALERT_IN_BYTES,
+                 g_aiaAlertsIndex.transaction +
+                     lastSlot * AIA_SIZE_OF_ALERT_IN_BYTES,
+                 AIA_SIZE_OF_ALERT_IN_BYTES );
+        memmove( g_aiaAlertsIndex.tokens + slot * AIA_ALERT_TOKEN_CHARS,
+                 g_aiaAlertsIndex.tokens + lastSlot * AIA_ALERT_TOKEN_CHARS,
+                 AIA_ALERT_TOKEN_CHARS );
+        --g_aiaAlertsIndex.numAlerts;
+        return true;
     }
 
-    if( !AiaLoadAlerts( allAlertsBuffer, allAlertsBytes ) )
+    int fd = AiaOpenAlertsFile( O_RDWR );
+    if( fd < 0 )
     {
-        AiaLogError( "AiaLoadBlob failed" );
-        AiaFree( allAlertsBuffer );
+        AiaLogError( "AiaOpenAlertsFile failed" );
         return false;
     }
 
-    /** Go through the tokens to find the first empty or matching one */
-    for( bytePosition = 0; bytePosition < allAlertsBytes;
-         bytePosition += AIA_SIZE_OF_ALERT_IN_BYTES )
+    /* Keep the records contiguous by moving the last record into the deleted
+     * slot, then dropping the last slot.  If interrupted in between, the
+     * duplicate last record is dropped by AiaLoadAlertsIndex(). */
+    if( slot != lastSlot )
     {
-        if( '\0' == allAlertsBuffer[ bytePosition ] )
+        uint8_t record[ AIA_SIZE_OF_ALERT_IN_BYTES ];
+        if( pread( fd, record, AIA_SIZE_OF_ALERT_IN_BYTES,
+                   (off_t)( lastSlot * AIA_SIZE_OF_ALERT_IN_BYTES ) ) !=
+                (ssize_t)AIA_SIZE_OF_ALERT_IN_BYTES ||
+            !AiaWriteAlertRecord( fd, slot, record ) )
         {
-            /** Found an empty token */
-            break;
-        }
-        else
-        {
-            /** Check if this token matches with what we are trying to delete */
-            if( !strncmp( (const char*)allAlertsBuffer + bytePosition,
-                          alertToken, alertTokenLen ) )
-            {
-                uint8_t* moveDst = allAlertsBuffer + bytePosition;
-                uint8_t* moveSrc =
-                    allAlertsBuffer + bytePosition + AIA_SIZE_OF_ALERT_IN_BYTES;
-                size_t moveBytes =
-                    allAlertsBytes -
-                    ( bytePosition + AIA_SIZE_OF_ALERT_IN_BYTES );
-                memmove( moveDst, moveSrc, moveBytes );
-                deletingExistingAlert = true;
-                break;
-            }
+            AiaLogError( "Failed to move alert record" );
+            close( fd );
+            return false;
         }
+        memcpy( g_aiaAlertsIndex.tokens + slot * AIA_ALERT_TOKEN_CHARS,
+                g_aiaAlertsIndex.tokens + lastSlot * AIA_ALERT_TOKEN_CHARS,
+                AIA_ALERT_TOKEN_CHARS );
     }
-
-    /** Store the new blob in persistent storage */
-    size_t storeSize =
-        ( deletingExistingAlert ? allAlertsBytes - AIA_SIZE_OF_ALERT_IN_BYTES
-                                : allAlertsBytes );
-    /** Store the new blob */
-    if( !AiaStoreBlob( AIA_ALL_ALERTS_STORAGE_KEY_V0, allAlertsBuffer,
-                       storeSize ) )
+    --g_aiaAlertsIndex.numAlerts;
+    if( ftruncate( fd, (off_t)( lastSlot * AIA_SIZE_OF_ALERT_IN_BYTES ) ) !=
+            0 ||
+        fsync( fd ) != 0 )
     {
-        AiaLogError( "AiaStoreBlob failed" );
-        AiaFree( allAlertsBuffer );
+        AiaLogError( "Failed to truncate alerts blob: %s", strerror( errno ) );
+        close( fd );
         return false;
     }
-
-    AiaFree( allAlertsBuffer );
+    close( fd );
     return true;
 }
 
@@ -491,6 +762,16 @@ bool AiaLoadAlert( char* alertToken, size_t alertTokenLen,
 
 bool AiaLoadAlerts( uint8_t* allAlerts, size_t size )
 {
+    if( g_aiaAlertsIndex.transaction )
+    {
+        if( size > g_aiaAlertsIndex.numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES )
+        {
+            AiaLogError( "Alerts blob smaller than %zu bytes", size );
+            return false;
+        }
+        memcpy( allAlerts, g_aiaAlertsIndex.transaction, size );
+        return true;
+    }
     if( !AiaAlertsBlobExists() )
     {
         if( size != 0 )
@@ -511,10 +792,113 @@ bool AiaLoadAlerts( uint8_t* allAlerts, size_t size )
 
 size_t AiaGetAlertsSize()
 {
+    if( g_aiaAlertsIndex.transaction )
+    {
+        return g_aiaAlertsIndex.numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES;
+    }
     return AiaGetBlobSize( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
 }
 
 bool AiaAlertsBlobExists()
 {
+    if( g_aiaAlertsIndex.transaction )
+    {
+        return true;
+    }
     return AiaBlobExists( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
 }
+
+bool AiaBeginAlertTransaction()
+{
+    if( g_aiaAlertsIndex.transaction )
+    {
+        AiaLogError( "Alert transaction already open" );
+        return false;
+    }
+    if( !AiaLoadAlertsIndex() || !AiaReserveAlertsIndex( 1 ) )
+    {
+        AiaLogError( "Failed to load alerts index" );
+        return false;
+    }
+
+    size_t allAlertsBytes =
+        g_aiaAlertsIndex.numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES;
+    uint8_t* transaction =
+        AiaCalloc( g_aiaAlertsIndex.capacity, AIA_SIZE_OF_ALERT_IN_BYTES );
+    if( !transaction )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     g_aiaAlertsIndex.capacity * AIA_SIZE_OF_ALERT_IN_BYTES );
+        return false;
+    }
+    if( !AiaLoadAlerts( transaction, allAlertsBytes ) )
+    {
+        AiaLogError( "AiaLoadAlerts failed" );
+        AiaFree( transaction );
+        return false;
+    }
+    g_aiaAlertsIndex.transaction = transaction;
+    return true;
+}
+
+bool AiaCommitAlertTransaction()
+{
+    if( !g_aiaAlertsIndex.transaction )
+    {
+        AiaLogError( "No alert transaction open" );
+        return false;
+    }
+    uint8_t* transaction = g_aiaAlertsIndex.transaction;
+    g_aiaAlertsIndex.transaction = NULL;
+
+    int stagedPathLen =
+        AiaFormatBlobPath( NULL, 0, AIA_ALL_ALERTS_TRANSACTION_KEY );
+    int filePathLen =
+        AiaFormatBlobPath( NULL, 0, AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    if( stagedPathLen < 0 || filePathLen < 0 )
+    {
+        AiaLogError( "snprintf failed" );
+        AiaFree( transaction );
+        g_aiaAlertsIndex.loaded = false;
+        return false;
+    }
+    char stagedPath[ stagedPathLen + 1 ];
+    char filePath[ filePathLen + 1 ];
+    AiaFormatBlobPath( stagedPath, sizeof( stagedPath ),
+                       AIA_ALL_ALERTS_TRANSACTION_KEY );
+    AiaFormatBlobPath( filePath, sizeof( filePath ),
+                       AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+
+    /* Stage the whole blob and rename it over the old one, so that a crash
+     * leaves either all or none of the changes persisted. */
+    bool committed = false;
+    int fd = open( stagedPath, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 )
+    {
+        AiaLogError( "open failed: %s", strerror( errno ) );
+    }
+    else
+    {
+        committed = AiaWriteFileBytes(
+            fd, transaction,
+            g_aiaAlertsIndex.numAlerts * AIA_SIZE_OF_ALERT_IN_BYTES, 0 );
+        close( fd );
+        if( committed && rename( stagedPath, filePath ) != 0 )
+        {
+            AiaLogError( "rename failed: %s", strerror( errno ) );
+            committed = false;
+        }
+        if( !committed )
+        {
+            unlink( stagedPath );
+        }
+    }
+    AiaFree( transaction );
+
+    if( !committed )
+    {
+        /* The index reflects the uncommitted changes; reload it. */
+        g_aiaAlertsIndex.loaded = false;
+    }
+    return committed;
+}
@@ -0,0 +1,984 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_storage_config_mmap.c
+ * @brief Implements the functions declared in @c aia_storage_config.h on top of
+ * a single memory-mapped store file. This is an alternative to @c
+ * aia_storage_config.c, selected with the @c AIA_STORAGE_MMAP CMake option.
+ *
+ * The store file is preallocated to @c AIA_MAPPED_STORAGE_FILE_SIZE bytes and
+ * holds a small header, a directory of up to @c AIA_MAPPED_STORAGE_MAX_KEYS
+ * keys and the blobs themselves. It is opened and mapped once, on first use, so
+ * loads are plain reads from the mapping and stores are range writes which are
+ * @c msync()'d before returning.
+ */
+
+#include <storage/aia_storage_config.h>
+
+#include <aia_config.h>
+
+#include <aia_capabilities_config.h>
+
+#include <aiaalertmanager/aia_alert_constants.h>
+#include <aiacore/aia_volume_constants.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char* g_aiaClientId;
+const char* g_aiaAwsAccountId;
+const char* g_aiaStorageFolder;
+
+#ifndef AIA_MAPPED_STORAGE_FILE_SIZE
+/** Size in bytes the store file is preallocated to. */
+#define AIA_MAPPED_STORAGE_FILE_SIZE ( (size_t)( 64 * 1024 ) )
+#endif
+
+#ifndef AIA_MAPPED_STORAGE_MAX_KEYS
+/** Maximum number of distinct keys the store file can hold. */
+#define AIA_MAPPED_STORAGE_MAX_KEYS 16
+#endif
+
+/** Maximum length of a key, including its null terminator. */
+#define AIA_MAPPED_STORAGE_MAX_KEY_LENGTH 40
+
+/** Identifies a formatted store file ("AIAS"). */
+#define AIA_MAPPED_STORAGE_MAGIC ( (uint32_t)0x53414941 )
+
+/** Version of the store file layout. */
+#define AIA_MAPPED_STORAGE_VERSION ( (uint32_t)1 )
+
+/** Header at the start of the store file. */
+typedef struct AiaMappedStorageHeader
+{
+    /** @c AIA_MAPPED_STORAGE_MAGIC once the file has been formatted. */
+    uint32_t magic;
+
+    /** @c AIA_MAPPED_STORAGE_VERSION. */
+    uint32_t version;
+
+    /** Offset of the first unallocated byte of the data region. */
+    uint32_t dataEnd;
+
+    /** Reserved for future use. */
+    uint32_t reserved;
+} AiaMappedStorageHeader_t;
+
+/** Directory entry describing where a blob lives in the store file. */
+typedef struct AiaMappedStorageEntry
+{
+    /** Null-terminated key, or empty if this entry is unused. */
+    char key[ AIA_MAPPED_STORAGE_MAX_KEY_LENGTH ];
+
+    /** Offset of the blob in the store file. */
+    uint32_t offset;
+
+    /** Number of bytes allocated for the blob at @c offset. */
+    uint32_t capacity;
+
+    /** Number of bytes of the blob currently stored. */
+    uint32_t size;
+
+    /** Non-zero if the blob has been stored. */
+    uint32_t exists;
+} AiaMappedStorageEntry_t;
+
+/** Offset of the data region, following the header and directory. */
+#define AIA_MAPPED_STORAGE_DATA_OFFSET \
+    ( sizeof( AiaMappedStorageHeader_t ) + \
+      AIA_MAPPED_STORAGE_MAX_KEYS * sizeof( AiaMappedStorageEntry_t ) )
+
+/** Name the store file is given, in place of a key, in the path format. */
+#define AIA_MAPPED_STORAGE_FILE_NAME "AiaMappedStorage"
+
+/** If using the provided sample storage implementation, this is the filename
+ * format of the persistent storage file that the SDK will read/write from/to.
+ */
+static const char* PERSISTENT_STORAGE_FILE_PATH_FORMAT = "%s/%s_%s_%s.dat";
+
+/** The mapped store file, lazily mapped on first use. */
+static uint8_t* g_aiaMappedStorage;
+
+#define AIA_SHARED_SECRET_STORAGE_KEY "AiaSharedSecretStorageKey"
+
+#define AIA_ALL_ALERTS_STORAGE_KEY_V0 "AiaAllAlertsStorageKey"
+
+/** Whether an alert transaction is open, deferring flushes of alert changes
+ * until it is committed. */
+static bool g_aiaAlertTransactionOpen;
+
+/**
+ * @return The header of the mapped store file.
+ * @note The store file must already be mapped.
+ */
+static AiaMappedStorageHeader_t* AiaMappedStorage_GetHeader()
+{
+    return (AiaMappedStorageHeader_t*)g_aiaMappedStorage;
+}
+
+/**
+ * @return The first entry of the directory of the mapped store file.
+ * @note The store file must already be mapped.
+ */
+static AiaMappedStorageEntry_t* AiaMappedStorage_GetDirectory()
+{
+    return (AiaMappedStorageEntry_t*)( g_aiaMappedStorage +
+                                       sizeof( AiaMappedStorageHeader_t ) );
+}
+
+/**
+ * Synchronously flushes a range of the mapped store file to persistent
+ * storage.
+ *
+ * @param data Start of the range, within the mapping.
+ * @param size Size of the range in bytes.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaMappedStorage_Sync( const void* data, size_t size )
+{
+    /* msync() requires a page-aligned address. */
+    size_t pageSize = (size_t)sysconf( _SC_PAGESIZE );
+    size_t offset = (size_t)( (const uint8_t*)data - g_aiaMappedStorage );
+    size_t alignedOffset = offset - offset % pageSize;
+    if( msync( g_aiaMappedStorage + alignedOffset,
+               size + ( offset - alignedOffset ), MS_SYNC ) != 0 )
+    {
+        AiaLogError( "msync failed: %s", strerror( errno ) );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Finds the directory entry of a key.
+ *
+ * @param key Null-terminated key to look for.
+ * @return The entry of @c key, or @c NULL if it has none.
+ * @note The store file must already be mapped.
+ */
+static AiaMappedStorageEntry_t* AiaMappedStorage_FindEntry( const char* key )
+{
+    AiaMappedStorageEntry_t* directory = AiaMappedStorage_GetDirectory();
+    for( size_t i = 0; i < AIA_MAPPED_STORAGE_MAX_KEYS; ++i )
+    {
+        if( !strncmp( directory[ i ].key, key,
+                      AIA_MAPPED_STORAGE_MAX_KEY_LENGTH ) )
+        {
+            return &directory[ i ];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Drops a duplicate trailing alert record, which is left behind if the device
+ * stops in the middle of @c AiaDeleteAlert().
+ *
+ * @note The store file must already be mapped.
+ */
+static void AiaMappedStorage_RepairAlerts()
+{
+    AiaMappedStorageEntry_t* entry =
+        AiaMappedStorage_FindEntry( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    if( !entry )
+    {
+        return;
+    }
+    uint32_t size = entry->size - entry->size % AIA_SIZE_OF_ALERT_IN_BYTES;
+    if( size >= 2 * AIA_SIZE_OF_ALERT_IN_BYTES )
+    {
+        const uint8_t* records = g_aiaMappedStorage + entry->offset;
+        const uint8_t* last = records + size - AIA_SIZE_OF_ALERT_IN_BYTES;
+        for( const uint8_t* record = records; record < last;
+             record += AIA_SIZE_OF_ALERT_IN_BYTES )
+        {
+            if( !memcmp( record, last, AIA_ALERT_TOKEN_CHARS ) )
+            {
+                size -= AIA_SIZE_OF_ALERT_IN_BYTES;
+                break;
+            }
+        }
+    }
+    if( size != entry->size )
+    {
+        AiaLogWarn( "Repairing alerts blob, size=%" PRIu32
+                    ", repaired=%" PRIu32,
+                    entry->size, size );
+        entry->size = size;
+        AiaMappedStorage_Sync( entry, sizeof( *entry ) );
+    }
+}
+
+/**
+ * Opens, preallocates and maps the store file if it has not been already,
+ * formatting it if it does not hold a store yet.
+ *
+ * @return @c true if the store file is mapped or @c false otherwise.
+ */
+static bool AiaMappedStorage_Map()
+{
+    if( g_aiaMappedStorage )
+    {
+        return true;
+    }
+
+    int numCharsRequired = snprintf(
+        NULL, 0, PERSISTENT_STORAGE_FILE_PATH_FORMAT, g_aiaStorageFolder,
+        g_aiaAwsAccountId, g_aiaClientId, AIA_MAPPED_STORAGE_FILE_NAME );
+    if( numCharsRequired < 0 )
+    {
+        AiaLogError( "snprintf failed, ret=%d", numCharsRequired );
+        return false;
+    }
+    char filePath[ numCharsRequired + 1 ];
+    if( snprintf( filePath, numCharsRequired + 1,
+                  PERSISTENT_STORAGE_FILE_PATH_FORMAT, g_aiaStorageFolder,
+                  g_aiaAwsAccountId, g_aiaClientId,
+                  AIA_MAPPED_STORAGE_FILE_NAME ) < 0 )
+    {
+        AiaLogError( "snprintf failed" );
+        return false;
+    }
+    int fd = open( filePath, O_RDWR | O_CREAT, 0644 );
+    if( fd < 0 )
+    {
+        AiaLogError( "open failed: %s", strerror( errno ) );
+        return false;
+    }
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 )
+    {
+        AiaLogError( "fstat failed: %s", strerror( errno ) );
+        close( fd );
+        return false;
+    }
+    if( (size_t)fileStat.st_size < AIA_MAPPED_STORAGE_FILE_SIZE &&
+        ftruncate( fd, (off_t)AIA_MAPPED_STORAGE_FILE_SIZE ) != 0 )
+    {
+        AiaLogError( "ftruncate failed: %s", strerror( errno ) );
+        close( fd );
+        return false;
+    }
+    void* mapping = mmap( NULL, AIA_MAPPED_STORAGE_FILE_SIZE,
+                          PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    /* The mapping stays valid once the file is closed. */
+    close( fd );
+    if( mapping == MAP_FAILED )
+    {
+        AiaLogError( "mmap failed: %s", strerror( errno ) );
+        return false;
+    }
+    g_aiaMappedStorage = mapping;
+
+    AiaMappedStorageHeader_t* header = AiaMappedStorage_GetHeader();
+    if( header->magic != AIA_MAPPED_STORAGE_MAGIC ||
+        header->version != AIA_MAPPED_STORAGE_VERSION ||
+        header->dataEnd < AIA_MAPPED_STORAGE_DATA_OFFSET ||
+        header->dataEnd > AIA_MAPPED_STORAGE_FILE_SIZE )
+    {
+        AiaLogInfo( "Formatting store file" );
+        memset( g_aiaMappedStorage, 0, AIA_MAPPED_STORAGE_DATA_OFFSET );
+        header->dataEnd = AIA_MAPPED_STORAGE_DATA_OFFSET;
+        header->version = AIA_MAPPED_STORAGE_VERSION;
+        header->magic = AIA_MAPPED_STORAGE_MAGIC;
+        if( !AiaMappedStorage_Sync( g_aiaMappedStorage,
+                                    AIA_MAPPED_STORAGE_DATA_OFFSET ) )
+        {
+            AiaLogError( "Failed to format store file" );
+            munmap( g_aiaMappedStorage, AIA_MAPPED_STORAGE_FILE_SIZE );
+            g_aiaMappedStorage = NULL;
+            return false;
+        }
+    }
+
+    AiaMappedStorage_RepairAlerts();
+    return true;
+}
+
+/**
+ * @param entry A directory entry.
+ * @return Whether @c entry holds an allocation in the data region.
+ */
+static bool AiaMappedStorage_IsAllocated( const AiaMappedStorageEntry_t* entry )
+{
+    return entry->key[ 0 ] && entry->capacity;
+}
+
+/**
+ * Finds the smallest run of free bytes in the data region which can hold @c
+ * capacity bytes. Free bytes are those not allocated to any directory entry,
+ * so the allocation a blob is moved away from becomes free as soon as its
+ * entry points elsewhere.
+ *
+ * @param capacity The number of bytes needed.
+ * @return The offset of the run, or @c 0 if there is none.
+ * @note The store file must already be mapped.
+ */
+static uint32_t AiaMappedStorage_FindFreeExtent( size_t capacity )
+{
+    AiaMappedStorageEntry_t* directory = AiaMappedStorage_GetDirectory();
+    uint32_t bestOffset = 0;
+    size_t bestSize = SIZE_MAX;
+
+    /* Free runs start at the data region or right after an allocation, and
+     * end at the next allocation or the end of the file. */
+    for( size_t i = 0; i <= AIA_MAPPED_STORAGE_MAX_KEYS; ++i )
+    {
+        size_t start = AIA_MAPPED_STORAGE_DATA_OFFSET;
+        if( i < AIA_MAPPED_STORAGE_MAX_KEYS )
+        {
+            if( !AiaMappedStorage_IsAllocated( &directory[ i ] ) )
+            {
+                continue;
+            }
+            start = (size_t)directory[ i ].offset + directory[ i ].capacity;
+        }
+        size_t end = AIA_MAPPED_STORAGE_FILE_SIZE;
+        bool isFree = true;
+        for( size_t j = 0; j < AIA_MAPPED_STORAGE_MAX_KEYS; ++j )
+        {
+            const AiaMappedStorageEntry_t* other = &directory[ j ];
+            if( !AiaMappedStorage_IsAllocated( other ) )
+            {
+                continue;
+            }
+            size_t otherEnd = (size_t)other->offset + other->capacity;
+            if( other->offset <= start && start < otherEnd )
+            {
+                isFree = false;
+                break;
+            }
+            if( other->offset > start && other->offset < end )
+            {
+                end = other->offset;
+            }
+        }
+        if( isFree && end - start >= capacity && end - start < bestSize )
+        {
+            bestOffset = (uint32_t)start;
+            bestSize = end - start;
+        }
+    }
+    return bestOffset;
+}
+
+/**
+ * Makes room in the data region by trimming the spare capacity of every blob
+ * but one, then moving blobs down into free runs below them. A blob is only
+ * moved into a run it does not overlap, and its entry is updated once its
+ * copy has been flushed, so a compaction which is interrupted leaves every
+ * blob intact.
+ *
+ * @param keep The entry whose capacity is kept, or @c NULL.
+ * @note The store file must already be mapped.
+ */
+static void AiaMappedStorage_Compact( const AiaMappedStorageEntry_t* keep )
+{
+    AiaLogInfo( "Compacting store file" );
+    AiaMappedStorageEntry_t* directory = AiaMappedStorage_GetDirectory();
+    for( size_t i = 0; i < AIA_MAPPED_STORAGE_MAX_KEYS; ++i )
+    {
+        AiaMappedStorageEntry_t* entry = &directory[ i ];
+        uint32_t size = entry->exists ? entry->size : 0;
+        if( entry == keep || !AiaMappedStorage_IsAllocated( entry ) ||
+            entry->capacity == size )
+        {
+            continue;
+        }
+        entry->capacity = size;
+        if( !AiaMappedStorage_Sync( entry, sizeof( *entry ) ) )
+        {
+            return;
+        }
+    }
+
+    /* Visit allocations from the lowest offset up, moving each to the end of
+     * the one below it when the two do not overlap. */
+    uint32_t cursor = AIA_MAPPED_STORAGE_DATA_OFFSET;
+    for( ;; )
+    {
+        AiaMappedStorageEntry_t* next = NULL;
+        for( size_t i = 0; i < AIA_MAPPED_STORAGE_MAX_KEYS; ++i )
+        {
+            AiaMappedStorageEntry_t* entry = &directory[ i ];
+            if( AiaMappedStorage_IsAllocated( entry ) &&
+                entry->offset >= cursor &&
+                ( !next || entry->offset < next->offset ) )
+            {
+                next = entry;
+            }
+        }
+        if( !next )
+        {
+            break;
+        }
+        if( next->offset - cursor >= next->capacity )
+        {
+            if( next->exists && next->size )
+            {
+                memcpy( g_aiaMappedStorage + cursor,
+                        g_aiaMappedStorage + next->offset, next->size );
+                if( !AiaMappedStorage_Sync( g_aiaMappedStorage + cursor,
+                                            next->size ) )
+                {
+                    return;
+                }
+            }
+            next->offset = cursor;
+            if( !AiaMappedStorage_Sync( next, sizeof( *next ) ) )
+            {
+                return;
+            }
+        }
+        cursor = next->offset + next->capacity;
+    }
+}
+
+/**
+ * Gets the directory entry of a key with space for at least @c capacity bytes,
+ * creating the entry or moving its blob to a larger allocation as needed. A
+ * moved blob keeps its contents. A blob which outgrows its allocation is given
+ * twice its previous capacity when that fits, so a blob which keeps growing is
+ * only moved a logarithmic number of times.
+ *
+ * @param key Null-terminated key to get the entry of.
+ * @param capacity The number of bytes the blob needs space for.
+ * @return The entry of @c key, or @c NULL on failure.
+ * @note The store file must already be mapped.
+ */
+static AiaMappedStorageEntry_t* AiaMappedStorage_ReserveEntry(
+    const char* key, size_t capacity )
+{
+    AiaMappedStorageEntry_t* entry = AiaMappedStorage_FindEntry( key );
+    if( entry && entry->capacity >= capacity )
+    {
+        return entry;
+    }
+    if( !entry )
+    {
+        if( strlen( key ) >= AIA_MAPPED_STORAGE_MAX_KEY_LENGTH )
+        {
+            AiaLogError( "Key too long, key=%s", key );
+            return NULL;
+        }
+        entry = AiaMappedStorage_FindEntry( "" );
+        if( !entry )
+        {
+            AiaLogError( "Store directory full, key=%s", key );
+            return NULL;
+        }
+    }
+
+    /* The old allocation stays in use until the entry points at the new one,
+     * so that an interrupted move leaves the blob intact. */
+    uint32_t offset = 0;
+    if( entry->capacity && 2 * (size_t)entry->capacity > capacity )
+    {
+        offset = AiaMappedStorage_FindFreeExtent( 2 * entry->capacity );
+        if( offset )
+        {
+            capacity = 2 * entry->capacity;
+        }
+    }
+    if( !offset )
+    {
+        offset = AiaMappedStorage_FindFreeExtent( capacity );
+    }
+    if( !offset )
+    {
+        AiaMappedStorage_Compact( entry );
+        offset = AiaMappedStorage_FindFreeExtent( capacity );
+    }
+    if( !offset )
+    {
+        AiaLogError( "Store file full, key=%s, capacity=%zu", key, capacity );
+        return NULL;
+    }
+    AiaMappedStorageHeader_t* header = AiaMappedStorage_GetHeader();
+    if( offset + capacity > header->dataEnd )
+    {
+        header->dataEnd = offset + (uint32_t)capacity;
+        if( !AiaMappedStorage_Sync( header, sizeof( *header ) ) )
+        {
+            return NULL;
+        }
+    }
+    if( entry->exists && entry->size )
+    {
+        memcpy( g_aiaMappedStorage + offset,
+                g_aiaMappedStorage + entry->offset, entry->size );
+        if( !AiaMappedStorage_Sync( g_aiaMappedStorage + offset,
+                                    entry->size ) )
+        {
+            return NULL;
+        }
+    }
+
+    if( !entry->key[ 0 ] )
+    {
+        strcpy( entry->key, key );
+    }
+    entry->offset = offset;
+    entry->capacity = (uint32_t)capacity;
+    if( !AiaMappedStorage_Sync( entry, sizeof( *entry ) ) )
+    {
+        return NULL;
+    }
+    return entry;
+}
+
+#define AIA_VOLUME_STORAGE_KEY "AiaVolumeStorageKey"
+
+#ifdef AIA_LOAD_VOLUME
+
+uint8_t AiaLoadVolume()
+{
+    uint8_t volume;
+    if( !AiaBlobExists( AIA_VOLUME_STORAGE_KEY ) ||
+        !AiaLoadBlob( AIA_VOLUME_STORAGE_KEY, &volume, sizeof( volume ) ) ||
+        volume > AIA_MAX_VOLUME )
+    {
+        return AIA_DEFAULT_VOLUME;
+    }
+    return volume;
+}
+
+#endif
+
+#ifdef AIA_STORE_VOLUME
+
+bool AiaStoreVolume( uint8_t volume )
+{
+    return AiaStoreBlob( AIA_VOLUME_STORAGE_KEY, &volume, sizeof( volume ) );
+}
+
+#endif
+
+bool AiaStoreSecret( const uint8_t* sharedSecret, size_t size )
+{
+    return AiaStoreBlob( AIA_SHARED_SECRET_STORAGE_KEY, sharedSecret, size );
+}
+
+bool AiaLoadSecret( uint8_t* sharedSecret, size_t size )
+{
+    return AiaLoadBlob( AIA_SHARED_SECRET_STORAGE_KEY, sharedSecret, size );
+}
+
+bool AiaStoreBlob( const char* key, const uint8_t* blob, size_t size )
+{
+    if( !key )
+    {
+        AiaLogError( "Null key" );
+        return false;
+    }
+    if( !blob && size )
+    {
+        AiaLogError( "Null blob" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+    AiaMappedStorageEntry_t* entry = AiaMappedStorage_ReserveEntry( key, size );
+    if( !entry )
+    {
+        AiaLogError( "Failed to store full blob, key=%s", key );
+        return false;
+    }
+    if( size )
+    {
+        memcpy( g_aiaMappedStorage + entry->offset, blob, size );
+        if( !AiaMappedStorage_Sync( g_aiaMappedStorage + entry->offset,
+                                    size ) )
+        {
+            AiaLogError( "Failed to store full blob, key=%s", key );
+            return false;
+        }
+    }
+    entry->size = (uint32_t)size;
+    entry->exists = 1;
+    return AiaMappedStorage_Sync( entry, sizeof( *entry ) );
+}
+
+bool AiaLoadBlob( const char* key, const uint8_t* blob, size_t size )
+{
+    if( !key )
+    {
+        AiaLogError( "Null key" );
+        return false;
+    }
+    if( !blob )
+    {
+        AiaLogError( "Null blob" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+    AiaMappedStorageEntry_t* entry = AiaMappedStorage_FindEntry( key );
+    if( !entry || !entry->exists || entry->size < size )
+    {
+        AiaLogError( "Failed to read full blob, key=%s, size=%zu", key, size );
+        return false;
+    }
+    memcpy( (uint8_t*)blob, g_aiaMappedStorage + entry->offset, size );
+    return true;
+}
+
+bool AiaBlobExists( const char* key )
+{
+    if( !key )
+    {
+        AiaLogError( "Null key" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+    AiaMappedStorageEntry_t* entry = AiaMappedStorage_FindEntry( key );
+    return entry && entry->exists;
+}
+
+size_t AiaGetBlobSize( const char* key )
+{
+    if( !key )
+    {
+        AiaLogError( "Null key" );
+        return 0;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return 0;
+    }
+    AiaMappedStorageEntry_t* entry = AiaMappedStorage_FindEntry( key );
+    if( !entry || !entry->exists )
+    {
+        AiaLogError( "Blob does not exist, key=%s", key );
+        return 0;
+    }
+    return entry->size;
+}
+
+/**
+ * Finds the record of an alert in the alerts blob.
+ *
+ * @param entry The directory entry of the alerts blob.
+ * @param alertToken The token of the alert, of @c AIA_ALERT_TOKEN_CHARS
+ * characters.
+ * @return The offset of the record within the alerts blob, or @c entry->size if
+ * it is not stored.
+ * @note The store file must already be mapped.
+ */
+static uint32_t AiaMappedStorage_FindAlert(
+    const AiaMappedStorageEntry_t* entry, const char* alertToken )
+{
+    const uint8_t* records = g_aiaMappedStorage + entry->offset;
+    uint32_t offset = 0;
+    for( ; offset < entry->size; offset += AIA_SIZE_OF_ALERT_IN_BYTES )
+    {
+        if( !memcmp( records + offset, alertToken, AIA_ALERT_TOKEN_CHARS ) )
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
+/**
+ * Flushes a range of the alerts blob unless an alert transaction is open, in
+ * which case it is flushed by @c AiaCommitAlertTransaction().
+ *
+ * @param data The start of the range to flush.
+ * @param size The size of the range to flush.
+ * @return @c true on success or @c false otherwise.
+ */
+static bool AiaMappedStorage_SyncAlerts( const void* data, size_t size )
+{
+    return g_aiaAlertTransactionOpen || AiaMappedStorage_Sync( data, size );
+}
+
+bool AiaStoreAlert( const char* alertToken, size_t alertTokenLen,
+                    AiaTimepointSeconds_t scheduledTime,
+                    AiaDurationMs_t duration, uint8_t alertType )
+{
+    if( !alertToken )
+    {
+        AiaLogError( "Null alertToken" );
+        return false;
+    }
+    if( alertTokenLen != AIA_ALERT_TOKEN_CHARS )
+    {
+        AiaLogError( "Invalid alert token length" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+
+    /* Overwrite the matching record, or append a new one.  New alert blobs
+     * are given space for the maximum number of alerts up front. */
+    AiaMappedStorageEntry_t* entry =
+        AiaMappedStorage_FindEntry( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    uint32_t offset = entry && entry->exists
+                          ? AiaMappedStorage_FindAlert( entry, alertToken )
+                          : 0;
+    if( !entry || !entry->exists || offset == entry->size )
+    {
+        size_t capacity = offset + AIA_SIZE_OF_ALERT_IN_BYTES;
+        size_t maxAlertsSize =
+            (size_t)AIA_ALERTS_MAX_ALERT_COUNT * AIA_SIZE_OF_ALERT_IN_BYTES;
+        entry = AiaMappedStorage_ReserveEntry(
+            AIA_ALL_ALERTS_STORAGE_KEY_V0,
+            capacity > maxAlertsSize ? capacity : maxAlertsSize );
+        if( !entry )
+        {
+            AiaLogError( "AiaMappedStorage_ReserveEntry failed" );
+            return false;
+        }
+    }
+
+    /** Serialize the fields: alertToken, scheduledTime, duration, alertType */
+    uint8_t* record = g_aiaMappedStorage + entry->offset + offset;
+    memcpy( record, alertToken, alertTokenLen );
+    size_t bytePosition = alertTokenLen;
+    for( size_t i = 0; i < sizeof( AiaTimepointSeconds_t );
+         ++i, bytePosition++ )
+    {
+        record[ bytePosition ] = ( scheduledTime >> ( i * 8 ) );
+    }
+    for( size_t i = 0; i < sizeof( AiaDurationMs_t ); ++i, bytePosition++ )
+    {
+        record[ bytePosition ] = ( duration >> ( i * 8 ) );
+    }
+    for( size_t i = 0; i < sizeof( uint8_t ); ++i, bytePosition++ )
+    {
+        record[ bytePosition ] = ( alertType >> ( i * 8 ) );
+    }
+    if( !AiaMappedStorage_SyncAlerts( record, AIA_SIZE_OF_ALERT_IN_BYTES ) )
+    {
+        AiaLogError( "Failed to store alert" );
+        return false;
+    }
+
+    if( !entry->exists || offset == entry->size )
+    {
+        entry->size = offset + AIA_SIZE_OF_ALERT_IN_BYTES;
+        entry->exists = 1;
+        return AiaMappedStorage_SyncAlerts( entry, sizeof( *entry ) );
+    }
+    return true;
+}
+
+bool AiaDeleteAlert( const char* alertToken, size_t alertTokenLen )
+{
+    if( !alertToken )
+    {
+        AiaLogError( "Null alertToken" );
+        return false;
+    }
+    if( alertTokenLen != AIA_ALERT_TOKEN_CHARS )
+    {
+        AiaLogError( "Invalid alert token length" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+
+    AiaMappedStorageEntry_t* entry =
+        AiaMappedStorage_FindEntry( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    if( !entry || !entry->exists )
+    {
+        return true;
+    }
+    uint32_t offset = AiaMappedStorage_FindAlert( entry, alertToken );
+    if( offset == entry->size )
+    {
+        return true;
+    }
+
+    /* Keep the records contiguous by moving the last record into the deleted
+     * slot, then dropping the last slot.  If interrupted in between, the
+     * duplicate last record is dropped by AiaMappedStorage_RepairAlerts(). */
+    uint32_t lastOffset = entry->size - AIA_SIZE_OF_ALERT_IN_BYTES;
+    if( offset != lastOffset )
+    {
+        uint8_t* records = g_aiaMappedStorage + entry->offset;
+        memcpy( records + offset, records + lastOffset,
+                AIA_SIZE_OF_ALERT_IN_BYTES );
+        if( !AiaMappedStorage_SyncAlerts( records + offset,
+                                          AIA_SIZE_OF_ALERT_IN_BYTES ) )
+        {
+            AiaLogError( "Failed to move alert record" );
+            return false;
+        }
+    }
+    entry->size = lastOffset;
+    return AiaMappedStorage_SyncAlerts( entry, sizeof( *entry ) );
+}
+
+bool AiaLoadAlert( char* alertToken, size_t alertTokenLen,
+                   AiaTimepointSeconds_t* scheduledTime,
+                   AiaDurationMs_t* duration, uint8_t* alertType,
+                   const uint8_t* allAlertsBuffer )
+{
+    if( !alertToken )
+    {
+        AiaLogError( "Null alertToken" );
+        return false;
+    }
+    if( !scheduledTime )
+    {
+        AiaLogError( "Null scheduledTime" );
+        return false;
+    }
+    if( !duration )
+    {
+        AiaLogError( "Null duration" );
+        return false;
+    }
+    if( !alertType )
+    {
+        AiaLogError( "Null alertType" );
+        return false;
+    }
+    if( !allAlertsBuffer )
+    {
+        AiaLogError( "Null allAlertsBuffer" );
+        return false;
+    }
+    if( alertTokenLen != AIA_ALERT_TOKEN_CHARS )
+    {
+        AiaLogError( "Invalid alert token length" );
+        return false;
+    }
+
+    size_t bytePosition = 0;
+    *scheduledTime = 0;
+    *duration = 0;
+    *alertType = 0;
+
+    memcpy( alertToken, allAlertsBuffer, alertTokenLen );
+    bytePosition += alertTokenLen;
+
+    for( size_t i = 0; i < sizeof( AiaTimepointSeconds_t );
+         ++i, ++bytePosition )
+    {
+        *scheduledTime |= (unsigned)allAlertsBuffer[ bytePosition ]
+                          << ( i * 8 );
+    }
+
+    for( size_t i = 0; i < sizeof( AiaDurationMs_t ); ++i, ++bytePosition )
+    {
+        *duration |= (unsigned)allAlertsBuffer[ bytePosition ] << ( i * 8 );
+    }
+
+    for( size_t i = 0; i < sizeof( uint8_t ); ++i, ++bytePosition )
+    {
+        *alertType |= (unsigned)allAlertsBuffer[ bytePosition ] << ( i * 8 );
+    }
+
+    return true;
+}
+
+bool AiaLoadAlerts( uint8_t* allAlerts, size_t size )
+{
+    if( !AiaAlertsBlobExists() )
+    {
+        if( size != 0 )
+        {
+            AiaLogError( "Alerts blob with size %zu does not exist", size );
+            return false;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    else
+    {
+        return AiaLoadBlob( AIA_ALL_ALERTS_STORAGE_KEY_V0, allAlerts, size );
+    }
+}
+
+size_t AiaGetAlertsSize()
+{
+    return AiaGetBlobSize( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+}
+
+bool AiaAlertsBlobExists()
+{
+    return AiaBlobExists( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+}
+
+bool AiaBeginAlertTransaction()
+{
+    if( g_aiaAlertTransactionOpen )
+    {
+        AiaLogError( "Alert transaction already open" );
+        return false;
+    }
+    if( !AiaMappedStorage_Map() )
+    {
+        AiaLogError( "AiaMappedStorage_Map failed" );
+        return false;
+    }
+    g_aiaAlertTransactionOpen = true;
+    return true;
+}
+
+bool AiaCommitAlertTransaction()
+{
+    if( !g_aiaAlertTransactionOpen )
+    {
+        AiaLogError( "No alert transaction open" );
+        return false;
+    }
+    g_aiaAlertTransactionOpen = false;
+
+    AiaMappedStorageEntry_t* entry =
+        AiaMappedStorage_FindEntry( AIA_ALL_ALERTS_STORAGE_KEY_V0 );
+    if( !entry )
+    {
+        return true;
+    }
+    if( entry->size &&
+        !AiaMappedStorage_Sync( g_aiaMappedStorage + entry->offset,
+                                entry->size ) )
+    {
+        AiaLogError( "Failed to flush alerts" );
+        return false;
+    }
+    return AiaMappedStorage_Sync( entry, sizeof( *entry ) );
+}
@@ -29,6 +29,7 @@
 
 #include <aiaalertmanager/aia_alert_slot.h>
 #include <aiaconnectionmanager/aia_connection_constants.h>
+#include <aiacore/aia_binary_constants.h>
 #include <aiacore/capabilities_sender/aia_capabilities_sender_state.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
@@ -131,8 +132,9 @@ typedef void ( *AiaUXStateObserverCb_t )( AiaUXState_t state, void* userData );
 
 /**
  * This function is used to push data from an internal stream to the platform
- * for playback every @c AIA_SPEAKER_FRAME_PUSH_CADENCE_MS. Implementations are
- * expected to be non-blocking and are not required to be thread-safe.
+ * for playback once per frame duration (see @c
+ * AIA_SPEAKER_FRAME_PUSH_CADENCE_MS). Implementations are expected to be
+ * non-blocking and are not required to be thread-safe.
  *
  * @param buf A buffer containing the data to play to be copied.
  * @param size The number of bytes to play.
@@ -150,6 +152,80 @@ typedef void ( *AiaUXStateObserverCb_t )( AiaUXState_t state, void* userData );
 typedef bool ( *AiaPlaySpeakerData_t )( const void* buf, size_t size,
                                         void* userData );
 
+/**
+ * This function is used to push multiple contiguous frames from an internal
+ * stream to the platform for playback in a single invocation. It is an opt-in
+ * alternative to @c AiaPlaySpeakerData_t which trades playback granularity for
+ * fewer wakeups and callback invocations. Implementations are expected to be
+ * non-blocking and are not required to be thread-safe.
+ *
+ * @param buf A buffer containing the data to play to be copied.
+ * @param size The number of bytes to play.
+ * @param frameCount The number of equally sized frames contained in @c buf.
+ * @param userData User data associated with this callback.
+ *
+ * @return @c true if all frames were accepted or @c false if the frames could
+ * not be buffered. Partial acceptance is not supported.
+ * @note If @c false is returned, the same frames will be pushed again once
+ * notified to via @c AiaClient_OnSpeakerReady().
+ * @note Calling back into the @c AiaClient_t from within the same
+ * execution context of this callback will result in a deadlock.
+ */
+typedef bool ( *AiaPlaySpeakerDataBatch_t )( const void* buf, size_t size,
+                                             size_t frameCount,
+                                             void* userData );
+
+/**
+ * This function is used in place of @c AiaPlaySpeakerData_t when speaker frames
+ * were lost (e.g. a speaker topic message never arrived) to have the platform
+ * synthesize audio for them, for example using the decoder's packet loss
+ * concealment. This is invoked at the offset of each lost frame, so that the
+ * buffer keeps playing through the loss instead of underrunning.
+ * Implementations are expected to be non-blocking and are not required to be
+ * thread-safe.
+ *
+ * @param frameSize The size in bytes of the lost frame.
+ * @param frameCount The number of lost frames to synthesize audio for.
+ * @param nextFrame The first frame received after the lost frames, which may
+ * carry forward error correction data for the last of them, or @c NULL if it is
+ * not yet available. This frame will still be pushed for playback as usual.
+ * @param userData User data associated with this callback.
+ *
+ * @return @c true if audio was synthesized or @c false if it could not be
+ * buffered, in which case the lost frames are skipped.
+ * @note Calling back into the @c AiaClient_t from within the same
+ * execution context of this callback will result in a deadlock.
+ */
+typedef bool ( *AiaConcealSpeakerData_t )( size_t frameSize, size_t frameCount,
+                                           const void* nextFrame,
+                                           void* userData );
+
+/**
+ * This function is used to notify the platform that the speaker is about to be
+ * opened, so that it can pre-roll its decoder and wake its audio output before
+ * the first frame is pushed. Implementations are expected to be non-blocking
+ * and are not required to be thread-safe.
+ *
+ * @param offset The offset in the speaker stream playback will start from.
+ * @param userData User data associated with this callback.
+ * @note Calling back into the @c AiaClient_t from within the same
+ * execution context of this callback will result in a deadlock.
+ */
+typedef void ( *AiaPrefetchSpeakerData_t )( AiaBinaryAudioStreamOffset_t offset,
+                                            void* userData );
+
+/**
+ * This function is used to have the platform drop the speaker frames it has
+ * accepted but not yet played, e.g. the PCM queued in its decoder and audio
+ * output, when playback is stopped locally by a barge-in. Implementations are
+ * expected to be non-blocking and are not required to be thread-safe.
+ *
+ * @param userData User data associated with this callback.
+ * @note Calling back into the @c AiaClient_t from within the same
+ * execution context of this callback will result in a deadlock.
+ */
+typedef void ( *AiaFlushSpeakerData_t )( void* userData );
+
 /**
  * This function is used to change the speaker's volume. Implementations are
  * expected to be non-blocking and are not required to be thread-safe.
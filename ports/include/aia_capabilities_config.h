@@ -26,6 +26,12 @@
 
 #include <stdint.h>
 
+/*
+ * Each interface below may also be left out without editing this file by
+ * defining AIA_DISABLE_<INTERFACE>, e.g. -DAIA_DISABLE_SPEAKER, which is how
+ * benchmarks/aia_footprint.sh builds the configurations it compares.
+ */
+
 /**
  * @name "Speaker" interface capabilities.
  *
@@ -34,6 +40,7 @@
  * supported on this device, all below configurations must be deleted entirely.
  */
 /** @{ */
+#ifndef AIA_DISABLE_SPEAKER
 #define AIA_ENABLE_SPEAKER
 #define AIA_AUDIO_BUFFER_SIZE UINT64_C( 60000 )
 static const AiaJsonLongType AIA_AUDIO_BUFFER_OVERRUN_WARN_THRESHOLD =
@@ -44,6 +51,7 @@ static const AiaJsonLongType AIA_AUDIO_BUFFER_UNDERRUN_WARN_THRESHOLD =
 #define AIA_SPEAKER_AUDIO_DECODER_BITRATE_TYPE "CONSTANT"
 static const AiaJsonLongType AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND = 64000;
 #define AIA_SPEAKER_AUDIO_DECODER_NUM_CHANNELS UINT64_C( 1 )
+#endif
 /** @} */
 
 /**
@@ -54,8 +62,20 @@ static const AiaJsonLongType AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND = 64000;
  * supported on this device, all below configurations must be deleted entirely.
  */
 /** @{ */
+#ifndef AIA_DISABLE_MICROPHONE
 #define AIA_ENABLE_MICROPHONE
+#ifdef AIA_OPUS_ENCODER
+/* Microphone audio is encoded with aiaopusencoder into constant bitrate frames,
+ * which must be installed with AiaClient_SetMicrophoneEncoder(). */
+#define AIA_MICROPHONE_AUDIO_ENCODER_FORMAT "OPUS"
+#define AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE "CONSTANT"
+static const AiaJsonLongType AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND =
+    32000;
+#define AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS UINT64_C( 1 )
+#else
 #define AIA_MICROPHONE_AUDIO_ENCODER_FORMAT "AUDIO_L16_RATE_16000_CHANNELS_1"
+#endif
+#endif
 /** @} */
 
 /**
@@ -66,8 +86,10 @@ static const AiaJsonLongType AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND = 64000;
  * supported on this device, all below configurations must be deleted entirely.
  */
 /** @{ */
+#ifndef AIA_DISABLE_ALERTS
 #define AIA_ENABLE_ALERTS
 static const AiaJsonLongType AIA_ALERTS_MAX_ALERT_COUNT = 20;
+#endif
 /** @} */
 
 /**
@@ -78,7 +100,9 @@ static const AiaJsonLongType AIA_ALERTS_MAX_ALERT_COUNT = 20;
  * supported on this device, all below configurations must be deleted entirely.
  */
 /** @{ */
+#ifndef AIA_DISABLE_CLOCK
 #define AIA_ENABLE_CLOCK
+#endif
 /** @} */
 
 /**
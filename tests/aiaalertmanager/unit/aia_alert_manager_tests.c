@@ -30,6 +30,7 @@
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_mbedtls_threading.h>
 #include <aiacore/aia_random_mbedtls.h>
+#include <aiacore/aia_utils.h>
 #include <aiacore/aia_volume_constants.h>
 
 #include <aiamockregulator/aia_mock_regulator.h>
@@ -136,8 +137,47 @@ static void TestDeleteAlertSucceededIsGenerated( const char* token )
     TEST_ASSERT_EQUAL_STRING_LEN( token, alertTokenStr, alertTokenStrLen );
 }
 
+static void TestSetAlertFailedIsGenerated()
+{
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TryWait )( &g_mockRegulator->writeSemaphore ) );
+    AiaListDouble( Link_t )* link = NULL;
+    link = AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
+    AiaListDouble( RemoveHead )( &g_mockRegulator->writtenMessages );
+    TEST_ASSERT_NOT_NULL( link );
+    AiaJsonMessage_t* setAlertFailedMessage = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( setAlertFailedMessage ),
+                               AIA_EVENTS_SET_ALERT_FAILED ),
+                       0 );
+}
+
 static AiaTimepointSeconds_t currentTime = 0;
 
+/** Result to return from the mocked @c AiaCommitAlertTransaction(). */
+static bool g_commitAlertTransactionResult;
+
+/** Number of times alerts were loaded from persistent storage. */
+static size_t g_loadAlertsCount;
+
+/** Number of alerts deleted from persistent storage. */
+static size_t g_deleteAlertCount;
+
+/** Number of alert transactions committed. */
+static size_t g_commitAlertTransactionCount;
+
+/** Time to return from the mocked @c AiaClock_GetTimeSinceNTPEpoch(). */
+static AiaTimepointSeconds_t g_now;
+
+/** Tokens of the alerts returned by the mocked persistent storage. */
+static const char* const* g_storedAlertTokens;
+
+/** Scheduled times of the alerts in @c g_storedAlertTokens. */
+static const AiaTimepointSeconds_t* g_storedAlertTimes;
+
+/** The number of alerts in @c g_storedAlertTokens. */
+static size_t g_numStoredAlerts;
+
 #ifdef AIA_ENABLE_SPEAKER
 static bool SpeakerCheckCallback( void* userData )
 {
@@ -198,9 +238,14 @@ bool AiaStoreAlert( const char* alertToken, size_t alertTokenLen,
 
 bool AiaLoadAlerts( uint8_t* allAlerts, size_t size )
 {
-    (void)allAlerts;
-    (void)size;
-
+    /* Each record only holds the index of a stored alert, plus one. */
+    memset( allAlerts, 0, size );
+    for( size_t i = 0; i < g_numStoredAlerts; ++i )
+    {
+        allAlerts[ i * AIA_SIZE_OF_ALERT_IN_BYTES ] = (uint8_t)( i + 1 );
+    }
+
+    ++g_loadAlertsCount;
     return true;
 }
 
@@ -209,6 +254,7 @@ bool AiaDeleteAlert( const char* alertToken, size_t alertTokenLen )
     (void)alertToken;
     (void)alertTokenLen;
 
+    ++g_deleteAlertCount;
     return true;
 }
 
@@ -217,19 +263,19 @@ bool AiaLoadAlert( char* alertToken, size_t alertTokenLen,
                    AiaDurationMs_t* duration, uint8_t* alertType,
                    const uint8_t* allAlertsBuffer )
 {
-    (void)alertToken;
-    (void)alertTokenLen;
-    (void)scheduledTime;
-    (void)duration;
-    (void)alertType;
-    (void)allAlertsBuffer;
+    size_t i = allAlertsBuffer[ 0 ] - 1;
+    memset( alertToken, 0, alertTokenLen );
+    strncpy( alertToken, g_storedAlertTokens[ i ], alertTokenLen );
+    *scheduledTime = g_storedAlertTimes[ i ];
+    *duration = 100;
+    *alertType = AIA_ALERT_TYPE_TIMER;
 
     return true;
 }
 
 size_t AiaGetAlertsSize()
 {
-    return 0;
+    return g_numStoredAlerts * AIA_SIZE_OF_ALERT_IN_BYTES;
 }
 
 bool AiaAlertsBlobExists()
@@ -237,9 +283,20 @@ bool AiaAlertsBlobExists()
     return true;
 }
 
+bool AiaBeginAlertTransaction()
+{
+    return true;
+}
+
+bool AiaCommitAlertTransaction()
+{
+    ++g_commitAlertTransactionCount;
+    return g_commitAlertTransactionResult;
+}
+
 AiaTimepointSeconds_t AiaClock_GetTimeSinceNTPEpoch()
 {
-    return 0;
+    return g_now;
 }
 
 /*-----------------------------------------------------------*/
@@ -265,6 +322,13 @@ TEST_SETUP( AiaAlertManagerTests )
     TEST_ASSERT_TRUE( g_mockRegulator );
     g_regulator = (AiaRegulator_t*)g_mockRegulator;
 
+    g_commitAlertTransactionResult = true;
+    g_loadAlertsCount = 0;
+    g_deleteAlertCount = 0;
+    g_commitAlertTransactionCount = 0;
+    g_now = 0;
+    g_numStoredAlerts = 0;
+
     /** Create the g_testAlertManager */
     g_testAlertManager = AiaAlertManager_Create(
         g_regulator
@@ -303,12 +367,18 @@ TEST_GROUP_RUNNER( AiaAlertManagerTests )
     RUN_TEST_CASE( AiaAlertManagerTests, DestroyNull );
     RUN_TEST_CASE( AiaAlertManagerTests, BadAlertDirectiveHandling );
     RUN_TEST_CASE( AiaAlertManagerTests, ValidAlertDirectiveHandling );
+    RUN_TEST_CASE( AiaAlertManagerTests, ManyAlertsDirectiveHandling );
+    RUN_TEST_CASE( AiaAlertManagerTests, ShortAlertTokensArePadded );
+    RUN_TEST_CASE( AiaAlertManagerTests, DeferredAlertDirectiveHandling );
     RUN_TEST_CASE( AiaAlertManagerTests, UpdateAlertManagerTime );
 #ifdef AIA_ENABLE_SPEAKER
     RUN_TEST_CASE( AiaAlertManagerTests, UpdateSpeakerBufferState );
 #endif
     RUN_TEST_CASE( AiaAlertManagerTests, DeleteAlert );
     RUN_TEST_CASE( AiaAlertManagerTests, UpdateUXState );
+    RUN_TEST_CASE( AiaAlertManagerTests, AlertsAreLoadedOnce );
+    RUN_TEST_CASE( AiaAlertManagerTests, StoredAlertsAreLoadedInOrder );
+    RUN_TEST_CASE( AiaAlertManagerTests, ExpiredAlertsArePurgedInOneWrite );
 }
 
 TEST( AiaAlertManagerTests, Create )
@@ -602,6 +672,177 @@ TEST( AiaAlertManagerTests, ValidAlertDirectiveHandling )
     TestSetAlertVolumeIsGenerated( 10 );
 }
 
+TEST( AiaAlertManagerTests, ManyAlertsDirectiveHandling )
+{
+    /* clang-format off */
+    static const char* SET_ALERT_FORMAT =
+    "{"
+        "\""AIA_SET_ALERT_TOKEN_KEY"\":\"alrt%04zu\","
+        "\""AIA_SET_ALERT_SCHEDULED_TIME_KEY"\":%" PRIu64 ","
+        "\""AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY"\":100,"
+        "\""AIA_SET_ALERT_TYPE_KEY"\":\"TIMER\""
+    "}";
+    static const char* DELETE_ALERT_FORMAT =
+    "{"
+        "\""AIA_DELETE_ALERT_TOKEN_KEY"\":\"alrt%04zu\""
+    "}";
+    /* clang-format on */
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+    static const size_t NUM_ALERTS = 100;
+    AiaTimepointSeconds_t firstScheduledTime =
+        AiaClock_GetTimeSinceNTPEpoch() + 1000;
+    char payload[ 256 ];
+    char token[ 32 ];
+
+    /* Schedule the alerts out of order. */
+    for( size_t i = 0; i < NUM_ALERTS; ++i )
+    {
+        snprintf( payload, sizeof( payload ), SET_ALERT_FORMAT, i,
+                  firstScheduledTime + ( i * 37 ) % NUM_ALERTS );
+        AiaAlertManager_OnSetAlertDirectiveReceived(
+            g_testAlertManager, payload, strlen( payload ),
+            TEST_SEQUENCE_NUMBER, TEST_INDEX );
+        snprintf( token, sizeof( token ), "\"alrt%04zu\"", i );
+        TestSetAlertSucceededIsGenerated( token );
+    }
+
+    /* Delete every other alert, and reschedule the rest. */
+    for( size_t i = 0; i < NUM_ALERTS; ++i )
+    {
+        if( i % 2 )
+        {
+            snprintf( payload, sizeof( payload ), SET_ALERT_FORMAT, i,
+                      firstScheduledTime + NUM_ALERTS - i );
+            AiaAlertManager_OnSetAlertDirectiveReceived(
+                g_testAlertManager, payload, strlen( payload ),
+                TEST_SEQUENCE_NUMBER, TEST_INDEX );
+            snprintf( token, sizeof( token ), "\"alrt%04zu\"", i );
+            TestSetAlertSucceededIsGenerated( token );
+        }
+        else
+        {
+            snprintf( payload, sizeof( payload ), DELETE_ALERT_FORMAT, i );
+            AiaAlertManager_OnDeleteAlertDirectiveReceived(
+                g_testAlertManager, payload, strlen( payload ),
+                TEST_SEQUENCE_NUMBER, TEST_INDEX );
+            snprintf( token, sizeof( token ), "\"alrt%04zu\"", i );
+            TestDeleteAlertSucceededIsGenerated( token );
+        }
+    }
+
+    uint8_t* alertTokens = NULL;
+    size_t alertTokensSize =
+        AiaAlertManager_GetTokens( g_testAlertManager, &alertTokens );
+    TEST_ASSERT_NOT_NULL( alertTokens );
+    TEST_ASSERT_EQUAL( ( NUM_ALERTS / 2 ) * ( AIA_ALERT_TOKEN_CHARS + 3 ) - 1,
+                       alertTokensSize );
+    for( size_t i = 0; i < NUM_ALERTS; ++i )
+    {
+        snprintf( token, sizeof( token ), "\"alrt%04zu\"", i );
+        if( i % 2 )
+        {
+            TEST_ASSERT_NOT_NULL( strstr( (char*)alertTokens, token ) );
+        }
+        else
+        {
+            TEST_ASSERT_NULL( strstr( (char*)alertTokens, token ) );
+        }
+    }
+    AiaFree( alertTokens );
+}
+
+TEST( AiaAlertManagerTests, ShortAlertTokensArePadded )
+{
+    /* clang-format off */
+    static const char* SET_ALERT_FORMAT =
+    "{"
+        "\""AIA_SET_ALERT_TOKEN_KEY"\":\"%s\","
+        "\""AIA_SET_ALERT_SCHEDULED_TIME_KEY"\":%" PRIu64 ","
+        "\""AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY"\":100,"
+        "\""AIA_SET_ALERT_TYPE_KEY"\":\"TIMER\""
+    "}";
+    /* clang-format on */
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+    AiaTimepointSeconds_t scheduledTime =
+        AiaClock_GetTimeSinceNTPEpoch() + 1000;
+    char payload[ 256 ];
+
+    snprintf( payload, sizeof( payload ), SET_ALERT_FORMAT, "abc",
+              scheduledTime );
+    AiaAlertManager_OnSetAlertDirectiveReceived(
+        g_testAlertManager, payload, strlen( payload ), TEST_SEQUENCE_NUMBER,
+        TEST_INDEX );
+    TestSetAlertSucceededIsGenerated( "\"abc\"" );
+    snprintf( payload, sizeof( payload ), SET_ALERT_FORMAT, "abcdefgh",
+              scheduledTime + 1 );
+    AiaAlertManager_OnSetAlertDirectiveReceived(
+        g_testAlertManager, payload, strlen( payload ), TEST_SEQUENCE_NUMBER,
+        TEST_INDEX );
+    TestSetAlertSucceededIsGenerated( "\"abcdefgh\"" );
+
+    /* Tokens are padded with whitespace so that each takes the same space. */
+    static const char* EXPECTED_TOKENS = "\"abc\"     ,\"abcdefgh\"";
+    uint8_t* alertTokens = NULL;
+    size_t alertTokensSize =
+        AiaAlertManager_GetTokens( g_testAlertManager, &alertTokens );
+    TEST_ASSERT_NOT_NULL( alertTokens );
+    TEST_ASSERT_EQUAL( strlen( EXPECTED_TOKENS ), alertTokensSize );
+    TEST_ASSERT_EQUAL_STRING( EXPECTED_TOKENS, (char*)alertTokens );
+    AiaFree( alertTokens );
+}
+
+TEST( AiaAlertManagerTests, DeferredAlertDirectiveHandling )
+{
+    /* clang-format off */
+    static const char* SET_ALERT_VALID_PAYLOAD =
+    "{"
+        "\""AIA_SET_ALERT_TOKEN_KEY"\":\"abcdefgh\","
+        "\""AIA_SET_ALERT_SCHEDULED_TIME_KEY"\":100,"
+        "\""AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY"\":100,"
+        "\""AIA_SET_ALERT_TYPE_KEY"\":\"TIMER\""
+    "}";
+    static const char* DELETE_ALERT_VALID_PAYLOAD =
+    "{"
+        "\""AIA_DELETE_ALERT_TOKEN_KEY"\":\"ijklmnop\""
+    "}";
+    /* clang-format on */
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+    AiaAlertManager_SetDeferredPersistence( g_testAlertManager, true );
+
+    /* Acknowledgements are held back until the end of the message. */
+    AiaAlertManager_OnSetAlertDirectiveReceived(
+        g_testAlertManager, (void*)SET_ALERT_VALID_PAYLOAD,
+        strlen( SET_ALERT_VALID_PAYLOAD ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaAlertManager_OnDeleteAlertDirectiveReceived(
+        g_testAlertManager, (void*)DELETE_ALERT_VALID_PAYLOAD,
+        strlen( DELETE_ALERT_VALID_PAYLOAD ), TEST_SEQUENCE_NUMBER,
+        TEST_INDEX + 1 );
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TryWait )( &g_mockRegulator->writeSemaphore ) );
+    AiaAlertManager_OnDirectiveBatchHandled( g_testAlertManager,
+                                             TEST_SEQUENCE_NUMBER );
+    TestSetAlertSucceededIsGenerated( "\"abcdefgh\"" );
+    TestDeleteAlertSucceededIsGenerated( "\"ijklmnop\"" );
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TryWait )( &g_mockRegulator->writeSemaphore ) );
+
+    /* A failed commit rolls back to the persisted alerts. */
+    g_commitAlertTransactionResult = false;
+    AiaAlertManager_OnSetAlertDirectiveReceived(
+        g_testAlertManager, (void*)SET_ALERT_VALID_PAYLOAD,
+        strlen( SET_ALERT_VALID_PAYLOAD ), TEST_SEQUENCE_NUMBER + 1,
+        TEST_INDEX );
+    AiaAlertManager_OnDirectiveBatchHandled( g_testAlertManager,
+                                             TEST_SEQUENCE_NUMBER + 1 );
+    TestSetAlertFailedIsGenerated();
+    uint8_t* alertTokens = NULL;
+    TEST_ASSERT_EQUAL(
+        0, AiaAlertManager_GetTokens( g_testAlertManager, &alertTokens ) );
+}
+
 TEST( AiaAlertManagerTests, UpdateAlertManagerTime )
 {
     TEST_ASSERT_FALSE(
@@ -635,3 +876,129 @@ TEST( AiaAlertManagerTests, UpdateUXState )
     AiaAlertManager_UpdateUXState( NULL, AIA_UX_IDLE );
     AiaAlertManager_UpdateUXState( g_testAlertManager, AIA_UX_IDLE );
 }
+
+TEST( AiaAlertManagerTests, AlertsAreLoadedOnce )
+{
+    uint8_t* alertTokens = NULL;
+
+    /* Whether or not the background load ran first, the first use finds the
+     * alerts loaded, and later uses do not load them again. */
+    TEST_ASSERT_EQUAL( 0, AiaAlertManager_GetTokens( g_testAlertManager,
+                                                     &alertTokens ) );
+    TEST_ASSERT_EQUAL( 1, g_loadAlertsCount );
+    TEST_ASSERT_TRUE(
+        AiaAlertManager_UpdateAlertManagerTime( g_testAlertManager, 0 ) );
+    TEST_ASSERT_EQUAL( 0, AiaAlertManager_GetTokens( g_testAlertManager,
+                                                     &alertTokens ) );
+    TEST_ASSERT_EQUAL( 1, g_loadAlertsCount );
+}
+
+TEST( AiaAlertManagerTests, StoredAlertsAreLoadedInOrder )
+{
+    static const char* const TOKENS[] = { "cccccccc", "aaaaaaaa", "dddddddd",
+                                          "bbbbbbbb" };
+    static const AiaTimepointSeconds_t SCHEDULED_TIMES[] = { 3000, 1000, 4000,
+                                                             2000 };
+    g_storedAlertTokens = TOKENS;
+    g_storedAlertTimes = SCHEDULED_TIMES;
+    g_numStoredAlerts = AiaArrayLength( TOKENS );
+
+    /* Alerts are loaded in the background as soon as the manager is created,
+     * so this needs a manager created after the alerts were stored. */
+    AiaAlertManager_t* alertManager = AiaAlertManager_Create(
+        g_regulator
+#ifdef AIA_ENABLE_SPEAKER
+        ,
+        SpeakerCheckCallback, NULL, StartOfflineAlertToneCallback, NULL
+#endif
+        ,
+        UXUpdateCallback, NULL, UXCheckCallback, NULL, DisconnectCallback,
+        NULL );
+    TEST_ASSERT_NOT_NULL( alertManager );
+
+    /* Tokens are listed in heap order, which is the scheduled order right
+     * after loading. */
+    uint8_t* alertTokens = NULL;
+    size_t alertTokensSize =
+        AiaAlertManager_GetTokens( alertManager, &alertTokens );
+    TEST_ASSERT_NOT_NULL( alertTokens );
+    TEST_ASSERT_EQUAL( 4 * ( AIA_ALERT_TOKEN_CHARS + 3 ) - 1,
+                       alertTokensSize );
+    const char* previous = (const char*)alertTokens;
+    static const char* const SORTED_TOKENS[] = {
+        "\"aaaaaaaa\"", "\"bbbbbbbb\"", "\"cccccccc\"", "\"dddddddd\""
+    };
+    for( size_t i = 0; i < AiaArrayLength( SORTED_TOKENS ); ++i )
+    {
+        const char* token = strstr( previous, SORTED_TOKENS[ i ] );
+        TEST_ASSERT_NOT_NULL( token );
+        previous = token;
+    }
+    AiaFree( alertTokens );
+
+    /* Loaded alerts are indexed by token. */
+    static const char* DELETE_ALERT_PAYLOAD =
+        "{\"" AIA_DELETE_ALERT_TOKEN_KEY "\":\"bbbbbbbb\"}";
+    AiaAlertManager_OnDeleteAlertDirectiveReceived(
+        alertManager, DELETE_ALERT_PAYLOAD, strlen( DELETE_ALERT_PAYLOAD ), 0,
+        0 );
+    alertTokensSize = AiaAlertManager_GetTokens( alertManager, &alertTokens );
+    TEST_ASSERT_EQUAL( 3 * ( AIA_ALERT_TOKEN_CHARS + 3 ) - 1,
+                       alertTokensSize );
+    TEST_ASSERT_NULL( strstr( (char*)alertTokens, "\"bbbbbbbb\"" ) );
+    AiaFree( alertTokens );
+
+    AiaAlertManager_Destroy( alertManager );
+}
+
+TEST( AiaAlertManagerTests, ExpiredAlertsArePurgedInOneWrite )
+{
+    /* clang-format off */
+    static const char* SET_ALERT_FORMAT =
+    "{"
+        "\""AIA_SET_ALERT_TOKEN_KEY"\":\"%s\","
+        "\""AIA_SET_ALERT_SCHEDULED_TIME_KEY"\":%" PRIu64 ","
+        "\""AIA_SET_ALERT_DURATION_IN_MILLISECONDS_KEY"\":100,"
+        "\""AIA_SET_ALERT_TYPE_KEY"\":\"TIMER\""
+    "}";
+    /* clang-format on */
+    static const char* TOKENS[] = { "abc", "def", "ghi" };
+    static const AiaTimepointSeconds_t SCHEDULED_TIMES[] = { 10, 20, 10000 };
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+    char payload[ 256 ];
+
+    for( size_t i = 0; i < AiaArrayLength( TOKENS ); ++i )
+    {
+        snprintf( payload, sizeof( payload ), SET_ALERT_FORMAT, TOKENS[ i ],
+                  SCHEDULED_TIMES[ i ] );
+        AiaAlertManager_OnSetAlertDirectiveReceived(
+            g_testAlertManager, payload, strlen( payload ),
+            TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    }
+
+    /* The first two alerts have expired. */
+    g_now = SCHEDULED_TIMES[ 1 ] + AIA_ALERT_EXPIRATION_DURATION + 1;
+    g_deleteAlertCount = 0;
+    g_commitAlertTransactionCount = 0;
+
+    uint8_t* alertTokens = NULL;
+    size_t alertTokensSize =
+        AiaAlertManager_GetTokens( g_testAlertManager, &alertTokens );
+    TEST_ASSERT_NOT_NULL( alertTokens );
+    TEST_ASSERT_EQUAL( AIA_ALERT_TOKEN_CHARS + 2, alertTokensSize );
+    TEST_ASSERT_NULL( strstr( (char*)alertTokens, "\"abc\"" ) );
+    TEST_ASSERT_NULL( strstr( (char*)alertTokens, "\"def\"" ) );
+    TEST_ASSERT_NOT_NULL( strstr( (char*)alertTokens, "\"ghi\"" ) );
+    AiaFree( alertTokens );
+
+    TEST_ASSERT_EQUAL( 2, g_deleteAlertCount );
+    TEST_ASSERT_EQUAL( 1, g_commitAlertTransactionCount );
+
+    /* Nothing is left to purge. */
+    alertTokensSize =
+        AiaAlertManager_GetTokens( g_testAlertManager, &alertTokens );
+    AiaFree( alertTokens );
+    TEST_ASSERT_EQUAL( 2, g_deleteAlertCount );
+    TEST_ASSERT_EQUAL( 1, g_commitAlertTransactionCount );
+}
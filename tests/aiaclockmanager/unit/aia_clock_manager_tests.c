@@ -34,6 +34,8 @@
 #include <aiaclockmanager/aia_clock_manager.h>
 #include <aiaclockmanager/private/aia_clock_manager.h>
 
+#include AiaClock( HEADER )
+
 /* Test framework includes. */
 #include <unity_fixture.h>
 
@@ -170,6 +172,7 @@ TEST_GROUP_RUNNER( AiaClockManagerTests )
     RUN_TEST_CASE( AiaClockManagerTests, SynchronizeClockIsSent );
     RUN_TEST_CASE( AiaClockManagerTests, BadSetClockResultsInException );
     RUN_TEST_CASE( AiaClockManagerTests, GoodSetClockIsHandled );
+    RUN_TEST_CASE( AiaClockManagerTests, SetClockIsDelayCompensated );
 }
 
 /*-----------------------------------------------------------*/
@@ -264,3 +267,24 @@ TEST( AiaClockManagerTests, GoodSetClockIsHandled )
     TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
         &g_observer->numObserversNotifiedSemaphore, 100 ) );
 }
+
+TEST( AiaClockManagerTests, SetClockIsDelayCompensated )
+{
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 1;
+    AiaJsonLongType TEST_TIME = 44;
+    TEST_ASSERT_TRUE( AiaClockManager_SynchronizeClock( g_clockManager ) );
+    TestSynchronizeClockIsGenerated();
+
+    /* Half of this round trip pushes the time into the next second. */
+    AiaClock( SleepMs( 1100 ) );
+    char* setClockDirective = generateSetClock( TEST_TIME );
+    TEST_ASSERT_NOT_NULL( setClockDirective );
+    AiaClockManager_OnSetClockDirectiveReceived(
+        g_clockManager, (void*)setClockDirective, strlen( setClockDirective ),
+        TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( setClockDirective );
+    TEST_ASSERT_EQUAL( TEST_TIME + 1, currentTime );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numObserversNotifiedSemaphore, 100 ) );
+}
@@ -41,6 +41,10 @@
 #define CONNECTION_MANAGER_TEST_DESCRIPTION_PAYLOAD( CODE, DESCRIPTION ) \
     "{\"code\":\"" CODE "\",\"description\":\"" DESCRIPTION "\"}"
 
+#define CONNECTION_MANAGER_TEST_MESSAGE( NAME, PAYLOAD )                   \
+    "{\"header\":{\"name\":\"" NAME "\",\"messageId\":\"abcd1234\"}," \
+    "\"payload\":" PAYLOAD "}"
+
 #define CONNECTION_MANAGER_TEST_DESCRIPTION "TestDescription"
 #define TEST_DEVICE_TOPIC_ROOT "test/topic/root"
 
@@ -278,6 +282,7 @@ TEST_GROUP_RUNNER( AiaConnectionManagerTests )
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckConnectionNoPayload );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckConnectionEstablished );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckWithDescription );
+    RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckMessage );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckUnknownFailure );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckInvalidAccountId );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveAckInvalidClientId );
@@ -294,6 +299,8 @@ TEST_GROUP_RUNNER( AiaConnectionManagerTests )
     RUN_TEST_CASE( AiaConnectionManagerTests,
                    ReceiveDisconnectEncryptionError );
     RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveDisconnectGoingOffline );
+    RUN_TEST_CASE( AiaConnectionManagerTests, ReceiveDisconnectMessage );
+    RUN_TEST_CASE( AiaConnectionManagerTests, SetTopicHandler );
 }
 
 /*-----------------------------------------------------------*/
@@ -435,6 +442,23 @@ TEST( AiaConnectionManagerTests, ReceiveAckWithDescription )
 
 /*-----------------------------------------------------------*/
 
+TEST( AiaConnectionManagerTests, ReceiveAckMessage )
+{
+    char* message = CONNECTION_MANAGER_TEST_MESSAGE(
+        AIA_CONNECTION_ACK_NAME,
+        CONNECTION_MANAGER_TEST_DESCRIPTION_PAYLOAD(
+            AIA_CONNECTION_ACK_UNKNOWN_FAILURE,
+            CONNECTION_MANAGER_TEST_DESCRIPTION ) );
+
+    AiaConnectionManager_OnConnectionAcknowledgementReceived(
+        testConnectionManager, message, strlen( message ) );
+
+    TEST_ASSERT_EQUAL_INT( 0, testObserver->onConnectionSuccessCallCount );
+    TEST_ASSERT_EQUAL_INT( 1, testObserver->onConnectionRejectedCallCount );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( AiaConnectionManagerTests, ReceiveAckUnknownFailure )
 {
     char* payload =
@@ -577,3 +601,35 @@ TEST( AiaConnectionManagerTests, ReceiveDisconnectGoingOffline )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaConnectionManagerTests, ReceiveDisconnectMessage )
+{
+    char* message = CONNECTION_MANAGER_TEST_MESSAGE(
+        AIA_CONNECTION_DISCONNECT_NAME,
+        CONNECTION_MANAGER_TEST_PAYLOAD(
+            AIA_CONNECTION_DISCONNECT_GOING_OFFLINE ) );
+
+    AiaConnectionManager_OnConnectionDisconnectReceived(
+        testConnectionManager, message, strlen( message ) );
+
+    TEST_ASSERT_EQUAL_INT( 1, testObserver->onDisconnectedCallCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaConnectionManagerTests, SetTopicHandler )
+{
+    TEST_ASSERT_FALSE( AiaConnectionManager_SetTopicHandler(
+        NULL, AIA_TOPIC_DIRECTIVE, onMqttMessageReceived, NULL ) );
+    TEST_ASSERT_TRUE( AiaConnectionManager_SetTopicHandler(
+        testConnectionManager, AIA_TOPIC_DIRECTIVE, onMqttMessageReceived,
+        NULL ) );
+    TEST_ASSERT_TRUE( AiaConnectionManager_SetTopicHandler(
+        testConnectionManager, AIA_TOPIC_SPEAKER, NULL, NULL ) );
+
+    /* Outbound topics are not subscribed to. */
+    TEST_ASSERT_FALSE( AiaConnectionManager_SetTopicHandler(
+        testConnectionManager, AIA_TOPIC_EVENT, onMqttMessageReceived, NULL ) );
+}
@@ -35,15 +35,33 @@ void RunAiaCoreTests( bool disableNetworkTests, bool disableLongTests )
 
     RUN_TEST_GROUP( AiaMessageTests );
     RUN_TEST_GROUP( AiaJsonMessageTests );
+    RUN_TEST_GROUP( AiaJsonTemplateTests );
     RUN_TEST_GROUP( AiaBinaryMessageTests );
     RUN_TEST_GROUP( AiaStreamBufferTests );
     RUN_TEST_GROUP( AiaCryptoMbedtlsTests );
+    RUN_TEST_GROUP( AiaKeyPairCacheTests );
     RUN_TEST_GROUP( AiaRandomMbedtlsTests );
     RUN_TEST_GROUP( AiaBackoffTests );
     RUN_TEST_GROUP( AiaJsonUtilsTests );
     RUN_TEST_GROUP( AiaExceptionEncounteredUtilsTests );
+    RUN_TEST_GROUP( AiaExceptionLimiterTests );
+    RUN_TEST_GROUP( AiaHistogramTests );
+    RUN_TEST_GROUP( AiaLwaCredentialCacheTests );
+    RUN_TEST_GROUP( AiaMemoryBudgetTests );
+    RUN_TEST_GROUP( AiaMemoryGuardTests );
+    RUN_TEST_GROUP( AiaOverloadGovernorTests );
     RUN_TEST_GROUP( AiaCapabilitiesTests );
     RUN_TEST_GROUP( AiaUtilsTests );
+    RUN_TEST_GROUP( AiaPcmTests );
+    RUN_TEST_GROUP( AiaPcmResamplerTests );
+    RUN_TEST_GROUP( AiaAudioFeaturesTests );
+    RUN_TEST_GROUP( AiaScratchArenaTests );
+    RUN_TEST_GROUP( AiaSessionTraceTests );
+    RUN_TEST_GROUP( AiaMqttMuxTests );
+    RUN_TEST_GROUP( AiaMpscQueueTests );
+    RUN_TEST_GROUP( AiaContainerTests );
+    RUN_TEST_GROUP( AiaVirtualTimeTests );
+    RUN_TEST_GROUP( AiaTimerServiceTests );
     RUN_TEST_GROUP( AiaButtonCommandTests );
 }
 
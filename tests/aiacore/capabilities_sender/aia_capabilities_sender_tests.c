@@ -31,6 +31,7 @@
 #include <aiacore/aia_json_utils.h>
 #include <aiacore/aia_mbedtls_threading.h>
 #include <aiacore/aia_random_mbedtls.h>
+#include <aiacore/aia_utils.h>
 #include <aiacore/capabilities_sender/aia_capabilities_sender.h>
 #include <aiacore/private/aia_capabilities_sender.h>
 #include <aiatestutilities/aia_test_utilities.h>
@@ -64,6 +65,14 @@ TEST_GROUP_RUNNER( AiaCapabilitiesTests )
                    DoubleCapabilitiesPublishWithoutAckFails );
     RUN_TEST_CASE( AiaCapabilitiesTests,
                    DoubleCapabilitiesPublishWithAckSucceeds );
+    RUN_TEST_CASE( AiaCapabilitiesTests, AcceptedCapabilitiesArePersisted );
+    RUN_TEST_CASE( AiaCapabilitiesTests, RejectedCapabilitiesAreForgotten );
+    RUN_TEST_CASE( AiaCapabilitiesTests, AcceptedDigestRestoresAcceptance );
+    RUN_TEST_CASE( AiaCapabilitiesTests, MismatchedDigestIsNotRestored );
+#ifdef AIA_ENABLE_SPEAKER
+    RUN_TEST_CASE( AiaCapabilitiesTests, CreationWithInvalidSpeakerBuffer );
+    RUN_TEST_CASE( AiaCapabilitiesTests, PublishCapabilitiesWithSpeakerBuffer );
+#endif
 }
 
 /*-----------------------------------------------------------*/
@@ -306,6 +315,43 @@ static void validatePublishedCapabilitiesMessage()
     TEST_ASSERT_EQUAL_STRING_LEN( AIA_MICROPHONE_AUDIO_ENCODER_FORMAT,
                                   microphoneFormat, microphoneFormatLen );
 
+#ifdef AIA_MICROPHONE_AUDIO_ENCODER_BITRATE_TYPE
+    const char* microphoneBitrate = NULL;
+    size_t microphoneBitrateLen = 0;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        audioEncoder, audioEncoderLen,
+        AIA_CAPABILITIES_MICROPHONE_AUDIO_BITRATE,
+        strlen( AIA_CAPABILITIES_MICROPHONE_AUDIO_BITRATE ), &microphoneBitrate,
+        &microphoneBitrateLen ) );
+    TEST_ASSERT_NOT_NULL( microphoneBitrate );
+
+    const char* microphoneBitsPerSecond = NULL;
+    size_t microphoneBitsPerSecondLen = 0;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        microphoneBitrate, microphoneBitrateLen,
+        AIA_CAPABILITIES_MICROPHONE_AUDIO_BITS_PER_SECOND,
+        strlen( AIA_CAPABILITIES_MICROPHONE_AUDIO_BITS_PER_SECOND ),
+        &microphoneBitsPerSecond, &microphoneBitsPerSecondLen ) );
+    AiaJsonLongType microphoneBitsPerSecondLong = 0;
+    TEST_ASSERT_TRUE( AiaExtractLongFromJsonValue(
+        microphoneBitsPerSecond, microphoneBitsPerSecondLen,
+        &microphoneBitsPerSecondLong ) );
+    TEST_ASSERT_EQUAL( microphoneBitsPerSecondLong,
+                       AIA_MICROPHONE_AUDIO_ENCODER_BITS_PER_SECOND );
+
+    const char* microphoneChannels = NULL;
+    size_t microphoneChannelsLen = 0;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        audioEncoder, audioEncoderLen, AIA_CAPABILITIES_MICROPHONE_NUM_CHANNELS,
+        strlen( AIA_CAPABILITIES_MICROPHONE_NUM_CHANNELS ), &microphoneChannels,
+        &microphoneChannelsLen ) );
+    AiaJsonLongType microphoneChannelsLong = 0;
+    TEST_ASSERT_TRUE( AiaExtractLongFromJsonValue(
+        microphoneChannels, microphoneChannelsLen, &microphoneChannelsLong ) );
+    TEST_ASSERT_EQUAL( microphoneChannelsLong,
+                       AIA_MICROPHONE_AUDIO_ENCODER_NUM_CHANNELS );
+#endif
+
 #endif
 
 #ifdef AIA_ENABLE_ALERTS
@@ -514,3 +560,141 @@ TEST( AiaCapabilitiesTests, DoubleCapabilitiesPublishWithAckSucceeds )
                        AIA_CAPABILITIES_STATE_PUBLISHED );
     validatePublishedCapabilitiesMessage();
 }
+
+TEST( AiaCapabilitiesTests, AcceptedCapabilitiesArePersisted )
+{
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_PublishCapabilities( capabilitiesSender ) );
+    validatePublishedCapabilitiesMessage();
+    TEST_ASSERT_FALSE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+    AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
+        capabilitiesSender, (void*)TEST_ACCEPTED_PAYLOAD,
+        strlen( TEST_ACCEPTED_PAYLOAD ) );
+    TEST_ASSERT_TRUE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+
+    /* A sender created after a restart finds them accepted. */
+    AiaCapabilitiesSender_Destroy( capabilitiesSender );
+    capabilitiesSender = AiaCapabilitiesSender_Create(
+        (AiaRegulator_t*)testCapabilitiesRegulator,
+        AiaOnCapabilitiesStateChanged, testObserver );
+    TEST_ASSERT_NOT_NULL( capabilitiesSender );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_CAPABILITIES_STATE_NONE );
+    TEST_ASSERT_TRUE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_CAPABILITIES_STATE_ACCEPTED );
+}
+
+TEST( AiaCapabilitiesTests, RejectedCapabilitiesAreForgotten )
+{
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_PublishCapabilities( capabilitiesSender ) );
+    validatePublishedCapabilitiesMessage();
+    AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
+        capabilitiesSender, (void*)TEST_REJECTED_PAYLOAD,
+        strlen( TEST_REJECTED_PAYLOAD ) );
+    TEST_ASSERT_FALSE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+
+    AiaCapabilitiesSender_Destroy( capabilitiesSender );
+    capabilitiesSender = AiaCapabilitiesSender_Create(
+        (AiaRegulator_t*)testCapabilitiesRegulator,
+        AiaOnCapabilitiesStateChanged, testObserver );
+    TEST_ASSERT_NOT_NULL( capabilitiesSender );
+    TEST_ASSERT_FALSE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_CAPABILITIES_STATE_NONE );
+}
+
+TEST( AiaCapabilitiesTests, AcceptedDigestRestoresAcceptance )
+{
+    uint32_t digest = 0;
+    TEST_ASSERT_FALSE( AiaCapabilitiesSender_GetAcceptedDigest(
+        capabilitiesSender, &digest ) );
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_PublishCapabilities( capabilitiesSender ) );
+    validatePublishedCapabilitiesMessage();
+    AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
+        capabilitiesSender, (void*)TEST_ACCEPTED_PAYLOAD,
+        strlen( TEST_ACCEPTED_PAYLOAD ) );
+    TEST_ASSERT_TRUE( AiaCapabilitiesSender_GetAcceptedDigest(
+        capabilitiesSender, &digest ) );
+
+    AiaCapabilitiesSender_Destroy( capabilitiesSender );
+    capabilitiesSender = AiaCapabilitiesSender_Create(
+        (AiaRegulator_t*)testCapabilitiesRegulator,
+        AiaOnCapabilitiesStateChanged, testObserver );
+    TEST_ASSERT_NOT_NULL( capabilitiesSender );
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_RestoreAccepted( capabilitiesSender, digest ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_CAPABILITIES_STATE_ACCEPTED );
+    TEST_ASSERT_TRUE( AiaCapabilitiesSender_IsAccepted( capabilitiesSender ) );
+}
+
+TEST( AiaCapabilitiesTests, MismatchedDigestIsNotRestored )
+{
+    uint32_t digest = 0;
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_PublishCapabilities( capabilitiesSender ) );
+    validatePublishedCapabilitiesMessage();
+    AiaCapabilitiesSender_OnCapabilitiesAcknowledgeMessageReceived(
+        capabilitiesSender, (void*)TEST_ACCEPTED_PAYLOAD,
+        strlen( TEST_ACCEPTED_PAYLOAD ) );
+    TEST_ASSERT_TRUE( AiaCapabilitiesSender_GetAcceptedDigest(
+        capabilitiesSender, &digest ) );
+
+    AiaCapabilitiesSender_Destroy( capabilitiesSender );
+    capabilitiesSender = AiaCapabilitiesSender_Create(
+        (AiaRegulator_t*)testCapabilitiesRegulator,
+        AiaOnCapabilitiesStateChanged, testObserver );
+    TEST_ASSERT_NOT_NULL( capabilitiesSender );
+    TEST_ASSERT_FALSE( AiaCapabilitiesSender_RestoreAccepted(
+        capabilitiesSender, digest + 1 ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_CAPABILITIES_STATE_NONE );
+}
+
+#ifdef AIA_ENABLE_SPEAKER
+TEST( AiaCapabilitiesTests, CreationWithInvalidSpeakerBuffer )
+{
+    const AiaSpeakerBufferCapabilities_t invalidSpeakerBuffers[] = {
+        { 0, 0, 0 }, { 1000, 1001, 200 }, { 1000, 800, 801 }
+    };
+    for( size_t i = 0; i < AiaArrayLength( invalidSpeakerBuffers ); ++i )
+    {
+        TEST_ASSERT_NULL( AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+            (AiaRegulator_t*)testCapabilitiesRegulator,
+            AiaOnCapabilitiesStateChanged, testObserver,
+            &invalidSpeakerBuffers[ i ] ) );
+    }
+}
+
+TEST( AiaCapabilitiesTests, PublishCapabilitiesWithSpeakerBuffer )
+{
+    const AiaSpeakerBufferCapabilities_t speakerBuffer = { 30000, 24000,
+                                                           6000 };
+    AiaCapabilitiesSender_Destroy( capabilitiesSender );
+    capabilitiesSender = AiaCapabilitiesSender_CreateWithSpeakerBuffer(
+        (AiaRegulator_t*)testCapabilitiesRegulator,
+        AiaOnCapabilitiesStateChanged, testObserver, &speakerBuffer );
+    TEST_ASSERT_NOT_NULL( capabilitiesSender );
+    TEST_ASSERT_TRUE(
+        AiaCapabilitiesSender_PublishCapabilities( capabilitiesSender ) );
+
+    AiaListDouble( Link_t )* link = AiaListDouble( PeekHead )(
+        &testCapabilitiesRegulator->writtenMessages );
+    TEST_ASSERT_NOT_NULL( link );
+    const char* payload =
+        AiaJsonMessage_GetJsonPayload( AiaJsonMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk ) );
+    const char* expectedValues[] = {
+        "\"" AIA_CAPABILITIES_SPEAKER_AUDIO_BUFFER_SIZE "\":30000",
+        "\"" AIA_CAPABILITIES_SPEAKER_AUDIO_OVERRUN_THRESHOLD "\":24000",
+        "\"" AIA_CAPABILITIES_SPEAKER_AUDIO_UNDERRUN_THRESHOLD "\":6000"
+    };
+    for( size_t i = 0; i < AiaArrayLength( expectedValues ); ++i )
+    {
+        TEST_ASSERT_NOT_NULL( strstr( payload, expectedValues[ i ] ) );
+    }
+}
+#endif
@@ -26,6 +26,17 @@
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_reader.h>
 #include <aiacore/data_stream_buffer/aia_data_stream_buffer_writer.h>
+#ifdef AIA_ENABLE_SHARED_DATA_STREAMS
+#include <aiacore/data_stream_buffer/aia_data_stream_shared.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+#include <unistd.h>
+#endif
+
+#include AiaClock( HEADER )
+#include AiaTaskPool( HEADER )
 
 /* Test framework includes. */
 #include <unity_fixture.h>
@@ -57,6 +68,106 @@ TEST_TEAR_DOWN( AiaStreamBufferTests )
 
 /*-----------------------------------------------------------*/
 
+/** Bytes passed to @c testCleanRange(). */
+static size_t g_bytesCleaned;
+
+/** Bytes passed to @c testInvalidateRange(). */
+static size_t g_bytesInvalidated;
+
+/** Records the bytes cleaned by an @c AiaDataStreamBuffer_t. */
+static void testCleanRange( void* data, size_t size, void* userData )
+{
+    TEST_ASSERT_NOT_NULL( data );
+    TEST_ASSERT_EQUAL_PTR( &g_bytesCleaned, userData );
+    g_bytesCleaned += size;
+}
+
+/** Records the bytes invalidated by an @c AiaDataStreamBuffer_t. */
+static void testInvalidateRange( void* data, size_t size, void* userData )
+{
+    TEST_ASSERT_NOT_NULL( data );
+    TEST_ASSERT_EQUAL_PTR( &g_bytesCleaned, userData );
+    g_bytesInvalidated += size;
+}
+
+/** Number of words written by @c testWriteWords(). */
+#define TEST_WAIT_WORDS 4
+
+/** Writes @c TEST_WAIT_WORDS words with the writer passed as @c context. */
+static void testWriteWords( AiaTaskPool_t taskPool, AiaTaskPoolJob_t job,
+                            void* context )
+{
+    (void)taskPool;
+    (void)job;
+    uint16_t words[ TEST_WAIT_WORDS ] = { 0 };
+    TEST_ASSERT_EQUAL( TEST_WAIT_WORDS,
+                       AiaDataStreamWriter_Write(
+                           (AiaDataStreamWriter_t*)context, words,
+                           TEST_WAIT_WORDS ) );
+}
+
+/** Closes the writer passed as @c context. */
+static void testCloseWriter( AiaTaskPool_t taskPool, AiaTaskPoolJob_t job,
+                             void* context )
+{
+    (void)taskPool;
+    (void)job;
+    AiaDataStreamWriter_Close( (AiaDataStreamWriter_t*)context );
+}
+
+/** Runs @c routine on the system task pool after @c delayMs. */
+static void testScheduleJob(
+    void ( *routine )( AiaTaskPool_t, AiaTaskPoolJob_t, void* ), void* context,
+    AiaTaskPoolJobStorage_t* storage, AiaDurationMs_t delayMs )
+{
+    AiaTaskPoolJob_t job;
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded(
+        AiaTaskPool( CreateJob )( routine, context, storage, &job ) ) );
+    TEST_ASSERT_TRUE(
+        AiaTaskPoolSucceeded( AiaTaskPool( ScheduleDeferred )(
+            AiaTaskPool( GetSystemTaskPool )(), job, delayMs ) ) );
+}
+
+/** Word size of the streams read by @c testConsume(). */
+#define TEST_FAN_OUT_WORDSIZE 2
+
+/** Data handed to @c testConsume() by @c AiaDataStreamReader_ReadFanOut(). */
+typedef struct TestConsumed
+{
+    /** The data consumed so far, in order. */
+    uint8_t data[ 16 * TEST_FAN_OUT_WORDSIZE ];
+
+    /** The number of words in @c data. */
+    size_t nWords;
+
+    /** The number of times @c testConsume() was called. */
+    size_t numCalls;
+
+    /** If set, written to by @c testConsume() to overrun the data it is
+     * consuming. */
+    AiaDataStreamWriter_t* overrunWriter;
+} TestConsumed_t;
+
+/** Appends @c data to the @c TestConsumed_t passed as @c userData. */
+static void testConsume( const void* data, size_t nWords, void* userData )
+{
+    TestConsumed_t* consumed = (TestConsumed_t*)userData;
+    TEST_ASSERT_NOT_NULL( data );
+    TEST_ASSERT_TRUE( nWords > 0 );
+    TEST_ASSERT_TRUE( consumed->nWords + nWords <=
+                      sizeof( consumed->data ) / TEST_FAN_OUT_WORDSIZE );
+    memcpy( consumed->data + consumed->nWords * TEST_FAN_OUT_WORDSIZE, data,
+            nWords * TEST_FAN_OUT_WORDSIZE );
+    consumed->nWords += nWords;
+    ++consumed->numCalls;
+    if( consumed->overrunWriter )
+    {
+        uint8_t words[ 16 * TEST_FAN_OUT_WORDSIZE ] = { 0 };
+        TEST_ASSERT_TRUE( AiaDataStreamWriter_Write( consumed->overrunWriter,
+                                                     words, 16 ) > 0 );
+    }
+}
+
 /**
  * @brief Test group runner for AiaMessage_t tests.
  */
@@ -66,6 +177,8 @@ TEST_GROUP_RUNNER( AiaStreamBufferTests )
     RUN_TEST_CASE( AiaStreamBufferTests, CreateWriter );
     RUN_TEST_CASE( AiaStreamBufferTests, CreateReader );
     RUN_TEST_CASE( AiaStreamBufferTests, ReaderRead );
+    RUN_TEST_CASE( AiaStreamBufferTests, ReaderReadWait );
+    RUN_TEST_CASE( AiaStreamBufferTests, ReaderReadFanOut );
     RUN_TEST_CASE( AiaStreamBufferTests, ReaderSeek );
     RUN_TEST_CASE( AiaStreamBufferTests, ReaderTell );
     RUN_TEST_CASE( AiaStreamBufferTests, ReaderClose );
@@ -75,6 +188,20 @@ TEST_GROUP_RUNNER( AiaStreamBufferTests )
     RUN_TEST_CASE( AiaStreamBufferTests, WriterTell );
     RUN_TEST_CASE( AiaStreamBufferTests, WriterClose );
     RUN_TEST_CASE( AiaStreamBufferTests, WriterGetWordSize );
+    RUN_TEST_CASE( AiaStreamBufferTests, SingleReader );
+    RUN_TEST_CASE( AiaStreamBufferTests, OldestIndex );
+    RUN_TEST_CASE( AiaStreamBufferTests, PinnedReader );
+    RUN_TEST_CASE( AiaStreamBufferTests, Resize );
+    RUN_TEST_CASE( AiaStreamBufferTests, CreateWithOptions );
+    RUN_TEST_CASE( AiaStreamBufferTests, Metadata );
+#ifdef AIA_ENABLE_SHARED_DATA_STREAMS
+    RUN_TEST_CASE( AiaStreamBufferTests, SharedReadInPlace );
+    RUN_TEST_CASE( AiaStreamBufferTests, SharedWaitAndClose );
+    RUN_TEST_CASE( AiaStreamBufferTests, SharedOpenRejectsBadGeometry );
+#endif
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+    RUN_TEST_CASE( AiaStreamBufferTests, Mirrored );
+#endif
 }
 
 TEST( AiaStreamBufferTests, Creation )
@@ -478,6 +605,200 @@ TEST( AiaStreamBufferTests, ReaderRead )
     AiaFree( buffer );
 }
 
+TEST( AiaStreamBufferTests, ReaderReadWait )
+{
+    static const size_t WORDSIZE = 2;
+    static const AiaDurationMs_t SHORT_TIMEOUT_MS = 20;
+    static const AiaDurationMs_t LONG_TIMEOUT_MS = 10000;
+
+    AiaTaskPoolInfo_t taskpoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded(
+        AiaTaskPool( CreateSystemTaskPool )( &taskpoolInfo ) ) );
+
+    uint16_t buffer[ 32 ];
+    uint16_t words[ 2 * TEST_WAIT_WORDS ];
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_Create( buffer, sizeof( buffer ), WORDSIZE, 1 );
+    TEST_ASSERT_TRUE( sds );
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+
+    /* Verify bad parameter handling. */
+    TEST_ASSERT_EQUAL(
+        AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID,
+        AiaDataStreamReader_ReadWait( reader, NULL, 1, SHORT_TIMEOUT_MS ) );
+
+    /* The wait times out if nothing is written. */
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK,
+                       AiaDataStreamReader_ReadWait(
+                           reader, words, TEST_WAIT_WORDS, SHORT_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( AiaClock( GetTimeMs )() - startMs >=
+                      SHORT_TIMEOUT_MS / 2 );
+
+    /* Words already available are read without waiting. */
+    TEST_ASSERT_EQUAL( TEST_WAIT_WORDS, AiaDataStreamWriter_Write(
+                                            writer, words, TEST_WAIT_WORDS ) );
+    TEST_ASSERT_EQUAL( TEST_WAIT_WORDS,
+                       AiaDataStreamReader_ReadWait(
+                           reader, words, TEST_WAIT_WORDS, LONG_TIMEOUT_MS ) );
+
+    /* Waiting readers are only woken once all the words they asked for have
+     * been written. */
+    AiaTaskPoolJobStorage_t firstStorage =
+        AiaTaskPool( JOB_STORAGE_INITIALIZER );
+    AiaTaskPoolJobStorage_t secondStorage =
+        AiaTaskPool( JOB_STORAGE_INITIALIZER );
+    testScheduleJob( testWriteWords, writer, &firstStorage, 10 );
+    testScheduleJob( testWriteWords, writer, &secondStorage, 30 );
+    TEST_ASSERT_EQUAL( 2 * TEST_WAIT_WORDS,
+                       AiaDataStreamReader_ReadWait( reader, words,
+                                                     2 * TEST_WAIT_WORDS,
+                                                     LONG_TIMEOUT_MS ) );
+
+    /* Waiting readers are woken when the writer closes. */
+    AiaTaskPoolJobStorage_t closeStorage =
+        AiaTaskPool( JOB_STORAGE_INITIALIZER );
+    testScheduleJob( testCloseWriter, writer, &closeStorage, 10 );
+    startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_CLOSED,
+                       AiaDataStreamReader_ReadWait(
+                           reader, words, TEST_WAIT_WORDS, LONG_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( AiaClock( GetTimeMs )() - startMs < LONG_TIMEOUT_MS );
+
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded(
+        AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() ) ) );
+}
+
+TEST( AiaStreamBufferTests, ReaderReadFanOut )
+{
+    static const size_t WORDSIZE = TEST_FAN_OUT_WORDSIZE;
+    static const size_t WORDCOUNT = 8;
+    static const size_t NUM_CONSUMERS = 2;
+
+    size_t bufferSize = WORDCOUNT * WORDSIZE;
+    void* buffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( buffer );
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_Create( buffer, bufferSize, WORDSIZE, 1 );
+    TEST_ASSERT_TRUE( sds );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+
+    uint8_t* writeBuf = AiaCalloc( 1, 2 * bufferSize );
+    TEST_ASSERT_TRUE( writeBuf );
+    for( size_t i = 0; i < 2 * bufferSize; ++i )
+    {
+        writeBuf[ i ] = (uint8_t)i;
+    }
+
+    TestConsumed_t consumed[ NUM_CONSUMERS ];
+    memset( consumed, 0, sizeof( consumed ) );
+    AiaDataStreamReaderConsumer_t consumers[ NUM_CONSUMERS ];
+    for( size_t i = 0; i < NUM_CONSUMERS; ++i )
+    {
+        consumers[ i ].consume = testConsume;
+        consumers[ i ].userData = &consumed[ i ];
+    }
+
+    /* Verify bad parameter handling. */
+    TEST_ASSERT_EQUAL(
+        AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID,
+        AiaDataStreamReader_ReadFanOut( reader, NULL, NUM_CONSUMERS, 1 ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID,
+                       AiaDataStreamReader_ReadFanOut( reader, consumers, 0,
+                                                       1 ) );
+    consumers[ 1 ].consume = NULL;
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_INVALID,
+                       AiaDataStreamReader_ReadFanOut( reader, consumers,
+                                                       NUM_CONSUMERS, 1 ) );
+    consumers[ 1 ].consume = testConsume;
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK,
+                       AiaDataStreamReader_ReadFanOut( reader, consumers,
+                                                       NUM_CONSUMERS, 1 ) );
+    TEST_ASSERT_EQUAL( 0, consumed[ 0 ].numCalls );
+
+    /* A partial read leaves the rest of the data for the next one, and every
+     * consumer sees the same data. */
+    TEST_ASSERT_EQUAL( WORDCOUNT - 2,
+                       AiaDataStreamWriter_Write( writer, writeBuf,
+                                                  WORDCOUNT - 2 ) );
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamReader_ReadFanOut(
+                              reader, consumers, NUM_CONSUMERS, 2 ) );
+    TEST_ASSERT_EQUAL(
+        2, AiaDataStreamReader_Tell(
+               reader, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    TEST_ASSERT_EQUAL( WORDCOUNT - 4,
+                       AiaDataStreamReader_ReadFanOut(
+                           reader, consumers, NUM_CONSUMERS, WORDCOUNT ) );
+    for( size_t i = 0; i < NUM_CONSUMERS; ++i )
+    {
+        TEST_ASSERT_EQUAL( 2, consumed[ i ].numCalls );
+        TEST_ASSERT_EQUAL( WORDCOUNT - 2, consumed[ i ].nWords );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf, consumed[ i ].data,
+                                       ( WORDCOUNT - 2 ) * WORDSIZE );
+    }
+
+    /* Data which wraps around the end of the buffer is handed over as two
+     * spans. */
+    memset( consumed, 0, sizeof( consumed ) );
+    TEST_ASSERT_EQUAL(
+        4, AiaDataStreamWriter_Write(
+               writer, writeBuf + ( WORDCOUNT - 2 ) * WORDSIZE, 4 ) );
+    TEST_ASSERT_EQUAL( 4, AiaDataStreamReader_ReadFanOut(
+                              reader, consumers, NUM_CONSUMERS, WORDCOUNT ) );
+    for( size_t i = 0; i < NUM_CONSUMERS; ++i )
+    {
+        TEST_ASSERT_EQUAL( 2, consumed[ i ].numCalls );
+        TEST_ASSERT_EQUAL( 4, consumed[ i ].nWords );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf + ( WORDCOUNT - 2 ) * WORDSIZE,
+                                       consumed[ i ].data, 4 * WORDSIZE );
+    }
+
+    /* Data lapped before the read is reported without calling the
+     * consumers. */
+    memset( consumed, 0, sizeof( consumed ) );
+    TEST_ASSERT_EQUAL( WORDCOUNT, AiaDataStreamWriter_Write( writer, writeBuf,
+                                                             WORDCOUNT ) );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamWriter_Write( writer, writeBuf, 1 ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN,
+                       AiaDataStreamReader_ReadFanOut( reader, consumers,
+                                                       NUM_CONSUMERS, 1 ) );
+    TEST_ASSERT_EQUAL( 0, consumed[ 0 ].numCalls );
+
+    /* Data lapped while it is being consumed is reported after the
+     * consumers have been called. */
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Seek(
+        reader, 0, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) );
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamWriter_Write( writer, writeBuf, 2 ) );
+    consumed[ 0 ].overrunWriter = writer;
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_OVERRUN,
+                       AiaDataStreamReader_ReadFanOut( reader, consumers,
+                                                       NUM_CONSUMERS, 2 ) );
+    for( size_t i = 0; i < NUM_CONSUMERS; ++i )
+    {
+        TEST_ASSERT_EQUAL( 2, consumed[ i ].nWords );
+    }
+
+    AiaFree( writeBuf );
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
 TEST( AiaStreamBufferTests, ReaderSeek )
 {
     TEST_ASSERT_TRUE( 1 );
@@ -1221,3 +1542,675 @@ TEST( AiaStreamBufferTests, WriterGetWordSize )
         AiaFree( buffer );
     }
 }
+
+TEST( AiaStreamBufferTests, SingleReader )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WORDCOUNT = 4;
+
+    /* Verify bad parameter handling. */
+    TEST_ASSERT_NULL(
+        AiaDataStreamBuffer_CreateSingleReader( NULL, WORDSIZE, WORDSIZE ) );
+
+    size_t bufferSize = WORDCOUNT * WORDSIZE;
+    void* buffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( buffer );
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_CreateSingleReader( buffer, bufferSize, WORDSIZE );
+    TEST_ASSERT_TRUE( sds );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamBuffer_GetMaxReaders( sds ) );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+
+    /* Only one reader may be attached. */
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true ) );
+
+    uint8_t* writeBuf = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( writeBuf );
+    uint8_t* readBuf = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( readBuf );
+    for( size_t i = 0; i < bufferSize; ++i )
+    {
+        writeBuf[ i ] = (uint8_t)i;
+    }
+
+    /* Fill the buffer; the writer must not overrun the unread data. */
+    TEST_ASSERT_EQUAL(
+        WORDCOUNT, AiaDataStreamWriter_Write( writer, writeBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+                       AiaDataStreamWriter_Write( writer, writeBuf, 1 ) );
+
+    /* Consuming data moves the writer's barrier forward. */
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamReader_Read( reader, readBuf, 1 ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf, readBuf, WORDSIZE );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamWriter_Write( writer, writeBuf, 1 ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+                       AiaDataStreamWriter_Write( writer, writeBuf, 1 ) );
+    TEST_ASSERT_EQUAL( WORDCOUNT,
+                       AiaDataStreamReader_Read( reader, readBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf + WORDSIZE, readBuf,
+                                   WORDSIZE * ( WORDCOUNT - 1 ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(
+        writeBuf, readBuf + WORDSIZE * ( WORDCOUNT - 1 ), WORDSIZE );
+
+    /* Once the reader is gone, the barrier follows the writer again. */
+    TEST_ASSERT_EQUAL(
+        WORDCOUNT, AiaDataStreamWriter_Write( writer, writeBuf, WORDCOUNT ) );
+    AiaDataStreamReader_Destroy( reader );
+    TEST_ASSERT_EQUAL(
+        WORDCOUNT, AiaDataStreamWriter_Write( writer, writeBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+                       AiaDataStreamWriter_Write( writer, writeBuf, 1 ) );
+
+    AiaFree( writeBuf );
+    AiaFree( readBuf );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
+TEST( AiaStreamBufferTests, OldestIndex )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WORDCOUNT = 4;
+    static const size_t OVERWRITTEN = 2;
+
+    size_t bufferSize = WORDCOUNT * WORDSIZE;
+    void* buffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( buffer );
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_Create( buffer, bufferSize, WORDSIZE, 2 );
+    TEST_ASSERT_TRUE( sds );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamReader_GetOldestIndex( reader ) );
+
+    uint8_t* writeBuf = AiaCalloc( 1, bufferSize + OVERWRITTEN * WORDSIZE );
+    TEST_ASSERT_TRUE( writeBuf );
+    uint8_t* readBuf = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( readBuf );
+    for( size_t i = 0; i < bufferSize + OVERWRITTEN * WORDSIZE; ++i )
+    {
+        writeBuf[ i ] = (uint8_t)i;
+    }
+
+    /* Lap the buffer, overwriting its oldest words. */
+    TEST_ASSERT_EQUAL(
+        WORDCOUNT, AiaDataStreamWriter_Write( writer, writeBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamReader_GetOldestIndex( reader ) );
+    TEST_ASSERT_EQUAL( OVERWRITTEN,
+                       AiaDataStreamWriter_Write(
+                           writer, writeBuf + bufferSize, OVERWRITTEN ) );
+
+    /* The oldest words left can be rewound to directly. */
+    AiaDataStreamIndex_t oldest = AiaDataStreamReader_GetOldestIndex( reader );
+    TEST_ASSERT_EQUAL( OVERWRITTEN, oldest );
+    TEST_ASSERT_FALSE( AiaDataStreamReader_Seek(
+        reader, oldest - 1,
+        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Seek(
+        reader, oldest, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    TEST_ASSERT_EQUAL( WORDCOUNT,
+                       AiaDataStreamReader_Read( reader, readBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf + WORDSIZE * oldest, readBuf,
+                                   bufferSize );
+
+    AiaFree( writeBuf );
+    AiaFree( readBuf );
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
+TEST( AiaStreamBufferTests, PinnedReader )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WORDCOUNT = 4;
+    static const size_t PREROLL = 2;
+
+    size_t bufferSize = WORDCOUNT * WORDSIZE;
+    void* buffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( buffer );
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_Create( buffer, bufferSize, WORDSIZE, 2 );
+    TEST_ASSERT_TRUE( sds );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+    AiaDataStreamReader_t* otherReader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( otherReader );
+
+    uint8_t* writeBuf = AiaCalloc( 1, 4 * bufferSize );
+    TEST_ASSERT_TRUE( writeBuf );
+    uint8_t* readBuf = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_TRUE( readBuf );
+    for( size_t i = 0; i < 4 * bufferSize; ++i )
+    {
+        writeBuf[ i ] = (uint8_t)i;
+    }
+
+    /* Rewind over the preroll and pin it. Only one reader may be pinned. */
+    TEST_ASSERT_EQUAL(
+        PREROLL, AiaDataStreamWriter_Write( writer, writeBuf, PREROLL ) );
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Seek(
+        reader, 0, AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Pin( reader ) );
+    TEST_ASSERT_FALSE( AiaDataStreamReader_Pin( otherReader ) );
+
+    /* Even a nonblockable writer stops short of the pinned reader. */
+    TEST_ASSERT_EQUAL( WORDCOUNT - PREROLL,
+                       AiaDataStreamWriter_Write(
+                           writer, writeBuf + PREROLL * WORDSIZE, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+                       AiaDataStreamWriter_Write(
+                           writer, writeBuf + WORDCOUNT * WORDSIZE, 1 ) );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamReader_GetOldestIndex( reader ) );
+
+    /* The pin follows the reader, letting the writer advance. */
+    TEST_ASSERT_EQUAL( PREROLL,
+                       AiaDataStreamReader_Read( reader, readBuf, PREROLL ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf, readBuf, PREROLL * WORDSIZE );
+    TEST_ASSERT_EQUAL( PREROLL, AiaDataStreamWriter_Write(
+                                    writer, writeBuf + WORDCOUNT * WORDSIZE,
+                                    WORDCOUNT ) );
+
+    /* A backward seek of the pinned reader moves the pin back with it, and
+     * cannot reach overwritten data. */
+    TEST_ASSERT_FALSE( AiaDataStreamReader_Seek(
+        reader, PREROLL - 1,
+        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_ABSOLUTE ) );
+    TEST_ASSERT_EQUAL(
+        AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+        AiaDataStreamWriter_Write(
+            writer, writeBuf + ( WORDCOUNT + PREROLL ) * WORDSIZE, 1 ) );
+    TEST_ASSERT_EQUAL( WORDCOUNT,
+                       AiaDataStreamReader_Read( reader, readBuf, WORDCOUNT ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( writeBuf + PREROLL * WORDSIZE, readBuf,
+                                   bufferSize );
+
+    /* Once unpinned, the writer laps the reader again, which can then no longer
+     * be pinned. */
+    AiaDataStreamReader_Unpin( reader );
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Seek(
+        otherReader, 0,
+        AIA_DATA_STREAM_BUFFER_READER_REFERENCE_BEFORE_WRITER ) );
+    TEST_ASSERT_TRUE( AiaDataStreamReader_Pin( otherReader ) );
+    AiaDataStreamReader_Unpin( otherReader );
+    TEST_ASSERT_EQUAL( WORDCOUNT,
+                       AiaDataStreamWriter_Write(
+                           writer,
+                           writeBuf + ( WORDCOUNT + PREROLL ) * WORDSIZE,
+                           WORDCOUNT ) );
+    TEST_ASSERT_EQUAL(
+        1, AiaDataStreamWriter_Write(
+               writer, writeBuf + ( 2 * WORDCOUNT + PREROLL ) * WORDSIZE, 1 ) );
+    TEST_ASSERT_FALSE( AiaDataStreamReader_Pin( reader ) );
+
+    AiaFree( writeBuf );
+    AiaFree( readBuf );
+    AiaDataStreamReader_Destroy( otherReader );
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
+TEST( AiaStreamBufferTests, Resize )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WORDCOUNT = 4;
+    static const size_t GROWN_WORDCOUNT = 7;
+
+    /* Word i of the stream is written from stream + WORDSIZE * i. */
+    uint8_t stream[ 2 * 16 ];
+    for( size_t i = 0; i < sizeof( stream ); ++i )
+    {
+        stream[ i ] = (uint8_t)i;
+    }
+    uint8_t readBuf[ sizeof( stream ) ];
+
+    void* buffer = AiaCalloc( WORDCOUNT, WORDSIZE );
+    TEST_ASSERT_TRUE( buffer );
+    AiaDataStreamBuffer_t* sds = AiaDataStreamBuffer_Create(
+        buffer, WORDCOUNT * WORDSIZE, WORDSIZE, 1 );
+    TEST_ASSERT_TRUE( sds );
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_ALL_OR_NOTHING, false );
+    TEST_ASSERT_TRUE( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, true );
+    TEST_ASSERT_TRUE( reader );
+
+    /* Verify bad parameter handling. */
+    TEST_ASSERT_FALSE(
+        AiaDataStreamBuffer_Resize( NULL, buffer, WORDCOUNT * WORDSIZE ) );
+    TEST_ASSERT_FALSE(
+        AiaDataStreamBuffer_Resize( sds, NULL, WORDCOUNT * WORDSIZE ) );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_Resize( sds, buffer, 1 ) );
+
+    /* Growing keeps unread words at their indices and makes room for more. */
+    TEST_ASSERT_EQUAL( 3, AiaDataStreamWriter_Write( writer, stream, 3 ) );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamReader_Read( reader, readBuf, 1 ) );
+    void* grown = AiaCalloc( GROWN_WORDCOUNT, WORDSIZE );
+    TEST_ASSERT_TRUE( grown );
+    TEST_ASSERT_TRUE( AiaDataStreamBuffer_Resize(
+        sds, grown, GROWN_WORDCOUNT * WORDSIZE ) );
+    AiaFree( buffer );
+    TEST_ASSERT_EQUAL( GROWN_WORDCOUNT,
+                       AiaDataStreamBuffer_GetDataSize( sds ) );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_WOULD_BLOCK,
+                       AiaDataStreamWriter_Write( writer, stream + 3 * WORDSIZE,
+                                                  GROWN_WORDCOUNT - 1 ) );
+    TEST_ASSERT_EQUAL( GROWN_WORDCOUNT - 2,
+                       AiaDataStreamWriter_Write( writer, stream + 3 * WORDSIZE,
+                                                  GROWN_WORDCOUNT - 2 ) );
+    TEST_ASSERT_EQUAL(
+        GROWN_WORDCOUNT,
+        AiaDataStreamReader_Read( reader, readBuf, GROWN_WORDCOUNT ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( stream + WORDSIZE, readBuf,
+                                   GROWN_WORDCOUNT * WORDSIZE );
+
+    /* Shrinking is refused while a reservation is outstanding or unread words
+     * would not fit. */
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamWriter_Reserve( writer, spans, 1 ) );
+    buffer = AiaCalloc( 2, WORDSIZE );
+    TEST_ASSERT_TRUE( buffer );
+    TEST_ASSERT_FALSE(
+        AiaDataStreamBuffer_Resize( sds, buffer, 2 * WORDSIZE ) );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamWriter_Publish( writer, 0 ) );
+    TEST_ASSERT_EQUAL(
+        2, AiaDataStreamWriter_Write( writer, stream + 8 * WORDSIZE, 2 ) );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_Resize( sds, buffer, WORDSIZE ) );
+    TEST_ASSERT_TRUE( AiaDataStreamBuffer_Resize( sds, buffer, 2 * WORDSIZE ) );
+    AiaFree( grown );
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamBuffer_GetDataSize( sds ) );
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamReader_Read( reader, readBuf, 2 ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( stream + 8 * WORDSIZE, readBuf,
+                                   2 * WORDSIZE );
+
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
+TEST( AiaStreamBufferTests, CreateWithOptions )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t ALIGNMENT = 16;
+    static const size_t BUFFER_SIZE = 80;
+
+    uint8_t* buffer = AiaCalloc( 1, BUFFER_SIZE );
+    TEST_ASSERT_TRUE( buffer );
+
+    /* Verify bad parameter handling. */
+    AiaDataStreamBufferOptions_t options = { 0 };
+    options.dataAlignment = 3;
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateWithOptions(
+        buffer, BUFFER_SIZE, WORDSIZE, 1, &options ) );
+
+    /* Heap allocations are aligned for any type, so @c buffer + 1 is odd and
+     * a word no longer fits once it is aligned. */
+    options.dataAlignment = WORDSIZE;
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateWithOptions(
+        buffer + 1, WORDSIZE, WORDSIZE, 1, &options ) );
+
+    /* Between 64 and 72 bytes are left after alignment, which is rounded down
+     * to 32 words. */
+    options.dataAlignment = ALIGNMENT;
+    options.powerOfTwoCapacity = true;
+    options.isExternalMemory = true;
+    options.cleanRange = testCleanRange;
+    options.invalidateRange = testInvalidateRange;
+    options.cacheMaintenanceUserData = &g_bytesCleaned;
+    AiaDataStreamBuffer_t* sds = AiaDataStreamBuffer_CreateWithOptions(
+        buffer + 1, BUFFER_SIZE - 1, WORDSIZE, 1, &options );
+    TEST_ASSERT_TRUE( sds );
+    TEST_ASSERT_EQUAL( 32, AiaDataStreamBuffer_GetDataSize( sds ) );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+
+    /* Reserved space starts at the aligned data and is invalidated when
+     * published, as if written by DMA. */
+    g_bytesCleaned = 0;
+    g_bytesInvalidated = 0;
+    AiaDataStreamWriterSpan_t spans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL( 8, AiaDataStreamWriter_Reserve( writer, spans, 8 ) );
+    TEST_ASSERT_EQUAL( 0, (uintptr_t)spans[ 0 ].data % ALIGNMENT );
+    TEST_ASSERT_EQUAL( 8, AiaDataStreamWriter_Publish( writer, 8 ) );
+    TEST_ASSERT_EQUAL( 8 * WORDSIZE, g_bytesInvalidated );
+    TEST_ASSERT_EQUAL( 0, g_bytesCleaned );
+
+    /* Copied words are cleaned, including across the wrap. */
+    uint16_t words[ 30 ] = { 0 };
+    TEST_ASSERT_EQUAL( 30, AiaDataStreamWriter_Write( writer, words, 30 ) );
+    TEST_ASSERT_EQUAL( 30 * WORDSIZE, g_bytesCleaned );
+    TEST_ASSERT_EQUAL( 8 * WORDSIZE, g_bytesInvalidated );
+
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+    AiaFree( buffer );
+}
+
+TEST( AiaStreamBufferTests, Metadata )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WRITE_WORDS = 4;
+    static const size_t CAPACITY = 4;
+
+    uint16_t buffer[ 32 ];
+    uint16_t words[ 4 ] = { 0 };
+    AiaDataStreamMetadataEntry_t metadata[ 4 ];
+    AiaDataStreamMetadataEntry_t entry;
+
+    /* Verify bad parameter handling. */
+    AiaDataStreamBufferOptions_t options = { 0 };
+    options.metadataCapacity = CAPACITY;
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateWithOptions(
+        buffer, sizeof( buffer ), WORDSIZE, 1, &options ) );
+    options.metadata = metadata;
+    options.metadataCapacity = 1;
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateWithOptions(
+        buffer, sizeof( buffer ), WORDSIZE, 1, &options ) );
+
+    /* Buffers without a ring have no metadata. */
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_Create( buffer, sizeof( buffer ), WORDSIZE, 1 );
+    TEST_ASSERT_TRUE( sds );
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    TEST_ASSERT_FALSE( AiaDataStreamWriter_Mark( writer, 0, 0 ) );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_FindMetadata( sds, 0, &entry ) );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+
+    options.metadataCapacity = CAPACITY;
+    sds = AiaDataStreamBuffer_CreateWithOptions( buffer, sizeof( buffer ),
+                                                 WORDSIZE, 1, &options );
+    TEST_ASSERT_TRUE( sds );
+    writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_TRUE( writer );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_FindMetadata( sds, 0, &entry ) );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_FindMetadata( sds, 0, NULL ) );
+
+    /* Mark each write with the time it was captured at. */
+    for( size_t i = 0; i < CAPACITY - 1; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaDataStreamWriter_Mark( writer, 1000 + i, 1 ) );
+        TEST_ASSERT_EQUAL( WRITE_WORDS, AiaDataStreamWriter_Write(
+                                            writer, words, WRITE_WORDS ) );
+    }
+
+    /* Each word is described by the entry recorded before it was written. */
+    for( size_t i = 0; i < ( CAPACITY - 1 ) * WRITE_WORDS; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaDataStreamBuffer_FindMetadata( sds, i, &entry ) );
+        TEST_ASSERT_EQUAL( i - i % WRITE_WORDS, entry.index );
+        TEST_ASSERT_EQUAL( 1000 + i / WRITE_WORDS, entry.timestamp );
+        TEST_ASSERT_EQUAL( 1, entry.tag );
+    }
+
+    /* Words not written yet are described by the latest entry. */
+    TEST_ASSERT_TRUE( AiaDataStreamBuffer_FindMetadata( sds, 100, &entry ) );
+    TEST_ASSERT_EQUAL( 1002, entry.timestamp );
+
+    /* Several entries may share an index, in which case the last one wins. */
+    TEST_ASSERT_TRUE( AiaDataStreamWriter_Mark( writer, 2000, 2 ) );
+    TEST_ASSERT_TRUE( AiaDataStreamBuffer_FindMetadata(
+        sds, ( CAPACITY - 1 ) * WRITE_WORDS, &entry ) );
+    TEST_ASSERT_EQUAL( 2, entry.tag );
+
+    /* Once the ring is full, the oldest entries are dropped. The entry the
+     * writer would overwrite next is not returned either. */
+    TEST_ASSERT_TRUE( AiaDataStreamWriter_Mark( writer, 3000, 3 ) );
+    TEST_ASSERT_FALSE( AiaDataStreamBuffer_FindMetadata( sds, 0, &entry ) );
+    TEST_ASSERT_FALSE(
+        AiaDataStreamBuffer_FindMetadata( sds, WRITE_WORDS, &entry ) );
+    TEST_ASSERT_TRUE(
+        AiaDataStreamBuffer_FindMetadata( sds, 2 * WRITE_WORDS, &entry ) );
+    TEST_ASSERT_EQUAL( 1002, entry.timestamp );
+    TEST_ASSERT_TRUE( AiaDataStreamBuffer_FindMetadata( sds, 100, &entry ) );
+    TEST_ASSERT_EQUAL( 3, entry.tag );
+
+    /* Closed writers do not record entries. */
+    AiaDataStreamWriter_Close( writer );
+    TEST_ASSERT_FALSE( AiaDataStreamWriter_Mark( writer, 4000, 4 ) );
+
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+}
+
+#ifdef AIA_ENABLE_SHARED_DATA_STREAMS
+/** Name of the segment used by the shared stream tests. */
+#define TEST_SHARED_NAME "/aia_stream_buffer_tests"
+
+/** Words held by the streams of the shared stream tests. */
+#define TEST_SHARED_WORDS 8
+
+TEST( AiaStreamBufferTests, SharedReadInPlace )
+{
+    static const size_t WORD_SIZE = sizeof( uint16_t );
+
+    TEST_ASSERT_NULL(
+        AiaDataStreamShared_Open( TEST_SHARED_NAME "_missing", 1 ) );
+    TEST_ASSERT_NULL( AiaDataStreamSharedWriter_Create( "no_slash", WORD_SIZE,
+                                                        TEST_SHARED_WORDS ) );
+    AiaDataStreamSharedWriter_t* writer = AiaDataStreamSharedWriter_Create(
+        TEST_SHARED_NAME, WORD_SIZE, TEST_SHARED_WORDS );
+    TEST_ASSERT_NOT_NULL( writer );
+
+    /* Words written before the stream is opened are kept. */
+    uint16_t words[] = { 1, 2, 3 };
+    TEST_ASSERT_EQUAL( 3, AiaDataStreamSharedWriter_Write( writer, words, 3 ) );
+
+    AiaDataStreamShared_t* shared =
+        AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 );
+    TEST_ASSERT_NOT_NULL( shared );
+    AiaDataStreamBuffer_t* sds = AiaDataStreamShared_GetBuffer( shared );
+    TEST_ASSERT_EQUAL( TEST_SHARED_WORDS,
+                       AiaDataStreamBuffer_GetDataSize( sds ) );
+    TEST_ASSERT_EQUAL( WORD_SIZE, AiaDataStreamBuffer_GetWordSize( sds ) );
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false ) );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( reader );
+
+    uint16_t read[ TEST_SHARED_WORDS ];
+    TEST_ASSERT_EQUAL(
+        AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK,
+        AiaDataStreamReader_Read( reader, read, TEST_SHARED_WORDS ) );
+    TEST_ASSERT_EQUAL( 3, AiaDataStreamShared_Sync( shared ) );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamShared_Sync( shared ) );
+    TEST_ASSERT_EQUAL(
+        3, AiaDataStreamReader_Read( reader, read, TEST_SHARED_WORDS ) );
+    TEST_ASSERT_EQUAL_UINT16_ARRAY( words, read, 3 );
+
+    /* Words reserved across the end of the segment are written in place. */
+    AiaDataStreamWriterSpan_t
+        writerSpans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL(
+        7, AiaDataStreamSharedWriter_Reserve( writer, writerSpans, 7 ) );
+    TEST_ASSERT_EQUAL( 5, writerSpans[ 0 ].nWords );
+    TEST_ASSERT_EQUAL( 2, writerSpans[ 1 ].nWords );
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID,
+                       AiaDataStreamSharedWriter_Write( writer, words, 1 ) );
+    ( (uint16_t*)writerSpans[ 0 ].data )[ 0 ] = 4;
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_WRITER_ERROR_INVALID,
+                       AiaDataStreamSharedWriter_Publish( writer, 8 ) );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamSharedWriter_Publish( writer, 1 ) );
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamShared_Sync( shared ) );
+
+    AiaDataStreamReaderSpan_t
+        readerSpans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL( 1, AiaDataStreamReader_Peek( reader, readerSpans,
+                                                    TEST_SHARED_WORDS ) );
+    TEST_ASSERT_EQUAL( 4, ( (const uint16_t*)readerSpans[ 0 ].data )[ 0 ] );
+
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamShared_Close( shared );
+    AiaDataStreamSharedWriter_Destroy( writer );
+}
+
+TEST( AiaStreamBufferTests, SharedWaitAndClose )
+{
+    AiaDataStreamSharedWriter_t* writer = AiaDataStreamSharedWriter_Create(
+        TEST_SHARED_NAME, sizeof( uint16_t ), TEST_SHARED_WORDS );
+    TEST_ASSERT_NOT_NULL( writer );
+    AiaDataStreamShared_t* shared =
+        AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 );
+    TEST_ASSERT_NOT_NULL( shared );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        AiaDataStreamShared_GetBuffer( shared ),
+        AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( reader );
+
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamShared_Wait( shared, 10 ) );
+    uint16_t words[ TEST_SHARED_WORDS ] = { 0 };
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamSharedWriter_Write( writer, words, 2 ) );
+    TEST_ASSERT_EQUAL( 2, AiaDataStreamShared_Wait( shared, 1000 ) );
+
+    /* Readers read everything written before seeing the stream closed. */
+    AiaDataStreamSharedWriter_Destroy( writer );
+    TEST_ASSERT_EQUAL( 0, AiaDataStreamShared_Wait( shared, 1000 ) );
+    TEST_ASSERT_EQUAL(
+        2, AiaDataStreamReader_Read( reader, words, TEST_SHARED_WORDS ) );
+    TEST_ASSERT_EQUAL(
+        AIA_DATA_STREAM_BUFFER_READER_ERROR_CLOSED,
+        AiaDataStreamReader_Read( reader, words, TEST_SHARED_WORDS ) );
+
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamShared_Close( shared );
+}
+
+TEST( AiaStreamBufferTests, SharedOpenRejectsBadGeometry )
+{
+    AiaDataStreamSharedWriter_t* writer = AiaDataStreamSharedWriter_Create(
+        TEST_SHARED_NAME, sizeof( uint16_t ), TEST_SHARED_WORDS );
+    TEST_ASSERT_NOT_NULL( writer );
+
+    /* The segment starts with its magic, version, word size and data size. */
+    int fd = shm_open( TEST_SHARED_NAME, O_RDWR, 0 );
+    TEST_ASSERT_TRUE( fd >= 0 );
+    uint32_t* config = mmap( NULL, 4 * sizeof( uint32_t ),
+                             PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    TEST_ASSERT_TRUE( MAP_FAILED != config );
+    uint32_t wordSize = config[ 2 ];
+    uint32_t dataSize = config[ 3 ];
+
+    /* A corrupt segment fails to open instead of being used. */
+    config[ 2 ] = 0;
+    TEST_ASSERT_NULL( AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 ) );
+    config[ 2 ] = wordSize;
+    config[ 3 ] = 0;
+    TEST_ASSERT_NULL( AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 ) );
+    config[ 3 ] = UINT32_MAX;
+    TEST_ASSERT_NULL( AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 ) );
+
+    config[ 3 ] = dataSize;
+    AiaDataStreamShared_t* shared =
+        AiaDataStreamShared_Open( TEST_SHARED_NAME, 1 );
+    TEST_ASSERT_NOT_NULL( shared );
+
+    AiaDataStreamShared_Close( shared );
+    munmap( config, 4 * sizeof( uint32_t ) );
+    AiaDataStreamSharedWriter_Destroy( writer );
+}
+#endif
+
+#ifdef AIA_ENABLE_MIRRORED_DATA_STREAMS
+TEST( AiaStreamBufferTests, Mirrored )
+{
+    static const size_t WORDSIZE = 2;
+    static const size_t WRAP_WORDS = 4;
+
+    /* Verify bad parameter handling. */
+    AiaDataStreamBufferOptions_t options = { 0 };
+    options.powerOfTwoCapacity = true;
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateMirrored( 0, WORDSIZE, 1,
+                                                          NULL ) );
+    TEST_ASSERT_NULL( AiaDataStreamBuffer_CreateMirrored( 1, 3, 1, &options ) );
+
+    /* The data is rounded up to a whole page. */
+    AiaDataStreamBuffer_t* sds =
+        AiaDataStreamBuffer_CreateMirrored( 1, WORDSIZE, 1, &options );
+    TEST_ASSERT_NOT_NULL( sds );
+    size_t dataSize = AiaDataStreamBuffer_GetDataSize( sds );
+    TEST_ASSERT_EQUAL( (size_t)sysconf( _SC_PAGESIZE ) / WORDSIZE, dataSize );
+    uint16_t buffer[ WRAP_WORDS ];
+    TEST_ASSERT_FALSE(
+        AiaDataStreamBuffer_Resize( sds, buffer, sizeof( buffer ) ) );
+
+    AiaDataStreamWriter_t* writer = AiaDataStreamBuffer_CreateWriter(
+        sds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    TEST_ASSERT_NOT_NULL( writer );
+    AiaDataStreamReader_t* reader = AiaDataStreamBuffer_CreateReader(
+        sds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( reader );
+
+    /* Move both cursors to just before the end of the ring. */
+    uint16_t* words = AiaCalloc( dataSize, WORDSIZE );
+    TEST_ASSERT_NOT_NULL( words );
+    size_t leadingWords = dataSize - WRAP_WORDS / 2;
+    TEST_ASSERT_EQUAL(
+        leadingWords, AiaDataStreamWriter_Write( writer, words, leadingWords ) );
+    TEST_ASSERT_EQUAL(
+        leadingWords, AiaDataStreamReader_Read( reader, words, leadingWords ) );
+
+    /* Words written across the end of the ring are peeked as one span. */
+    for( size_t i = 0; i < WRAP_WORDS; ++i )
+    {
+        words[ i ] = i + 1;
+    }
+    TEST_ASSERT_EQUAL( WRAP_WORDS,
+                       AiaDataStreamWriter_Write( writer, words, WRAP_WORDS ) );
+    AiaDataStreamReaderSpan_t
+        readerSpans[ AIA_DATA_STREAM_BUFFER_READER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL( WRAP_WORDS, AiaDataStreamReader_Peek(
+                                       reader, readerSpans, WRAP_WORDS ) );
+    TEST_ASSERT_EQUAL( WRAP_WORDS, readerSpans[ 0 ].nWords );
+    TEST_ASSERT_EQUAL( 0, readerSpans[ 1 ].nWords );
+    TEST_ASSERT_EQUAL_UINT16_ARRAY( words, readerSpans[ 0 ].data,
+                                    WRAP_WORDS );
+    TEST_ASSERT_EQUAL( WRAP_WORDS,
+                       AiaDataStreamReader_Commit( reader, WRAP_WORDS ) );
+
+    /* A reservation of the whole buffer is a single span too. */
+    AiaDataStreamWriterSpan_t
+        writerSpans[ AIA_DATA_STREAM_BUFFER_WRITER_MAX_SPANS ];
+    TEST_ASSERT_EQUAL( dataSize, AiaDataStreamWriter_Reserve(
+                                     writer, writerSpans, dataSize ) );
+    TEST_ASSERT_EQUAL( dataSize, writerSpans[ 0 ].nWords );
+    TEST_ASSERT_EQUAL( 0, writerSpans[ 1 ].nWords );
+    TEST_ASSERT_EQUAL( dataSize,
+                       AiaDataStreamWriter_Publish( writer, dataSize ) );
+
+    AiaFree( words );
+    AiaDataStreamReader_Destroy( reader );
+    AiaDataStreamWriter_Destroy( writer );
+    AiaDataStreamBuffer_Destroy( sds );
+}
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_audio_features_tests.c
+ * @brief Tests for AiaAudioFeatures_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_audio_features.h>
+#include <aiacore/data_stream_buffer/aia_data_stream_buffer.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+/** Number of samples used by tests, 100 milliseconds at 16 kHz. */
+#define TEST_NUM_SAMPLES 1600
+
+/** Number of frames of the default configuration in @c TEST_NUM_SAMPLES. */
+#define TEST_NUM_FRAMES ( 1 + ( TEST_NUM_SAMPLES - 400 ) / 160 )
+
+/** Number of mel bands of the default configuration. */
+#define TEST_NUM_MEL_BANDS 40
+
+/** Front ends are too large to be allocated on the stack. */
+static AiaAudioFeatures_t g_features;
+
+/** A second front end, for computing the expected features. */
+static AiaAudioFeatures_t g_reference;
+
+/** Samples used by tests. */
+static int16_t g_samples[ TEST_NUM_SAMPLES ];
+
+/** Features computed by tests. */
+static float g_output[ TEST_NUM_FRAMES ][ TEST_NUM_MEL_BANDS ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaAudioFeatures tests.
+ */
+TEST_GROUP( AiaAudioFeaturesTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaAudioFeatures tests.
+ */
+TEST_SETUP( AiaAudioFeaturesTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaAudioFeatures tests.
+ */
+TEST_TEAR_DOWN( AiaAudioFeaturesTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaAudioFeatures tests.
+ */
+TEST_GROUP_RUNNER( AiaAudioFeaturesTests )
+{
+    RUN_TEST_CASE( AiaAudioFeaturesTests, InitRejectsInvalidConfig );
+    RUN_TEST_CASE( AiaAudioFeaturesTests, ToneHasMostEnergyInItsBand );
+    RUN_TEST_CASE( AiaAudioFeaturesTests, SilenceIsAtTheEnergyFloor );
+    RUN_TEST_CASE( AiaAudioFeaturesTests, ProcessMatchesCompute );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaAudioFeaturesTests, InitRejectsInvalidConfig )
+{
+    AiaAudioFeaturesConfig_t config;
+    AiaAudioFeatures_GetDefaultConfig( &config );
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, NULL ) );
+
+    AiaAudioFeaturesConfig_t invalid = config;
+    invalid.fftSize = 500;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid.fftSize = 2 * AIA_AUDIO_FEATURES_MAX_FFT_SIZE;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    invalid = config;
+    invalid.frameLength = config.fftSize + 1;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid = config;
+    invalid.hopLength = 0;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid.hopLength = config.frameLength + 1;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    invalid = config;
+    invalid.highFrequency = config.sampleRate;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid.highFrequency = config.lowFrequency;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    invalid = config;
+    invalid.numMelBands = 0;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid.numMelBands = AIA_AUDIO_FEATURES_MAX_MEL_BANDS + 1;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+    invalid = config;
+    invalid.numCoefficients = config.numMelBands + 1;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    invalid = config;
+    invalid.preEmphasis = 1.0f;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    /* Low bands are narrower than the bins of a short FFT. */
+    invalid = config;
+    invalid.fftSize = 16;
+    invalid.frameLength = 16;
+    invalid.hopLength = 16;
+    TEST_ASSERT_FALSE( AiaAudioFeatures_Init( &g_features, &invalid ) );
+
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_features, &config ) );
+    TEST_ASSERT_EQUAL( TEST_NUM_MEL_BANDS * sizeof( float ),
+                       AiaAudioFeatures_GetFrameSize( &g_features ) );
+    config.numCoefficients = 13;
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_features, &config ) );
+    TEST_ASSERT_EQUAL( 13 * sizeof( float ),
+                       AiaAudioFeatures_GetFrameSize( &g_features ) );
+}
+
+TEST( AiaAudioFeaturesTests, ToneHasMostEnergyInItsBand )
+{
+    AiaAudioFeaturesConfig_t config;
+    AiaAudioFeatures_GetDefaultConfig( &config );
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_features, &config ) );
+
+    /* A 1 kHz tone, generated by rotating a phasor by 1/16th of a turn. */
+    double x = 0.0;
+    double y = 8000.0;
+    for( size_t i = 0; i < TEST_NUM_SAMPLES; ++i )
+    {
+        g_samples[ i ] = (int16_t)y;
+        double rotatedX = 0.92387953251128674 * x - 0.38268343236508978 * y;
+        y = 0.38268343236508978 * x + 0.92387953251128674 * y;
+        x = rotatedX;
+    }
+    TEST_ASSERT_TRUE(
+        AiaAudioFeatures_Compute( &g_features, g_samples, g_output[ 0 ] ) );
+
+    /* 1 kHz is 1000 mels, and the centers of the bands are 68.5 mels apart
+     * from 100.2 mels, so the 14th band is the closest. */
+    size_t loudest = 0;
+    for( size_t band = 1; band < TEST_NUM_MEL_BANDS; ++band )
+    {
+        if( g_output[ 0 ][ band ] > g_output[ 0 ][ loudest ] )
+        {
+            loudest = band;
+        }
+    }
+    TEST_ASSERT_EQUAL( 13, loudest );
+}
+
+TEST( AiaAudioFeaturesTests, SilenceIsAtTheEnergyFloor )
+{
+    AiaAudioFeaturesConfig_t config;
+    AiaAudioFeatures_GetDefaultConfig( &config );
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_features, &config ) );
+
+    memset( g_samples, 0, sizeof( g_samples ) );
+    TEST_ASSERT_TRUE(
+        AiaAudioFeatures_Compute( &g_features, g_samples, g_output[ 0 ] ) );
+
+    /* The natural logarithm of FLT_EPSILON is -15.94. */
+    for( size_t band = 0; band < TEST_NUM_MEL_BANDS; ++band )
+    {
+        TEST_ASSERT_TRUE( g_output[ 0 ][ band ] < -15.9f );
+        TEST_ASSERT_TRUE( g_output[ 0 ][ band ] > -16.0f );
+    }
+}
+
+TEST( AiaAudioFeaturesTests, ProcessMatchesCompute )
+{
+    static const size_t CHUNK_SAMPLES = 100;
+    static int16_t pcmBuffer[ TEST_NUM_SAMPLES ];
+    static float featureBuffer[ TEST_NUM_FRAMES ][ TEST_NUM_MEL_BANDS ];
+    static float otherOutput[ TEST_NUM_FRAMES ][ TEST_NUM_MEL_BANDS ];
+
+    AiaAudioFeaturesConfig_t config;
+    AiaAudioFeatures_GetDefaultConfig( &config );
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_features, &config ) );
+    TEST_ASSERT_TRUE( AiaAudioFeatures_Init( &g_reference, &config ) );
+    size_t frameSize = AiaAudioFeatures_GetFrameSize( &g_features );
+
+    AiaDataStreamBuffer_t* pcmStream = AiaDataStreamBuffer_Create(
+        pcmBuffer, sizeof( pcmBuffer ), sizeof( int16_t ), 1 );
+    TEST_ASSERT_NOT_NULL( pcmStream );
+    AiaDataStreamWriter_t* pcmWriter = AiaDataStreamBuffer_CreateWriter(
+        pcmStream, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    AiaDataStreamReader_t* pcmReader = AiaDataStreamBuffer_CreateReader(
+        pcmStream, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( pcmWriter );
+    TEST_ASSERT_NOT_NULL( pcmReader );
+
+    /* Two consumers share the features. */
+    AiaDataStreamBuffer_t* featureStream = AiaDataStreamBuffer_Create(
+        featureBuffer, sizeof( featureBuffer ), frameSize, 2 );
+    TEST_ASSERT_NOT_NULL( featureStream );
+    AiaDataStreamWriter_t* featureWriter = AiaDataStreamBuffer_CreateWriter(
+        featureStream, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE, false );
+    AiaDataStreamReader_t* featureReader = AiaDataStreamBuffer_CreateReader(
+        featureStream, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    AiaDataStreamReader_t* otherFeatureReader =
+        AiaDataStreamBuffer_CreateReader(
+            featureStream, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( featureWriter );
+    TEST_ASSERT_NOT_NULL( featureReader );
+    TEST_ASSERT_NOT_NULL( otherFeatureReader );
+
+    TEST_ASSERT_EQUAL( AIA_DATA_STREAM_BUFFER_READER_ERROR_WOULDBLOCK,
+                       AiaAudioFeatures_Process( &g_features, pcmReader,
+                                                 featureWriter ) );
+
+    /* Hops straddle the chunks the samples are written in. */
+    uint32_t seed = 1;
+    ssize_t numFrames = 0;
+    for( size_t i = 0; i < TEST_NUM_SAMPLES; i += CHUNK_SAMPLES )
+    {
+        for( size_t j = i; j < i + CHUNK_SAMPLES; ++j )
+        {
+            seed = seed * 1103515245 + 12345;
+            g_samples[ j ] = (int16_t)( seed >> 16 );
+        }
+        TEST_ASSERT_EQUAL( (ssize_t)CHUNK_SAMPLES,
+                           AiaDataStreamWriter_Write(
+                               pcmWriter, g_samples + i, CHUNK_SAMPLES ) );
+        ssize_t result = AiaAudioFeatures_Process( &g_features, pcmReader,
+                                                   featureWriter );
+        if( result > 0 )
+        {
+            numFrames += result;
+        }
+    }
+    TEST_ASSERT_EQUAL( TEST_NUM_FRAMES, numFrames );
+
+    TEST_ASSERT_EQUAL(
+        TEST_NUM_FRAMES,
+        AiaDataStreamReader_Read( featureReader, g_output, TEST_NUM_FRAMES ) );
+    TEST_ASSERT_EQUAL( TEST_NUM_FRAMES,
+                       AiaDataStreamReader_Read( otherFeatureReader,
+                                                 otherOutput,
+                                                 TEST_NUM_FRAMES ) );
+    float expected[ TEST_NUM_MEL_BANDS ];
+    for( size_t frame = 0; frame < TEST_NUM_FRAMES; ++frame )
+    {
+        TEST_ASSERT_TRUE( AiaAudioFeatures_Compute(
+            &g_reference, g_samples + frame * config.hopLength, expected ) );
+        TEST_ASSERT_EQUAL_MEMORY( expected, g_output[ frame ], frameSize );
+        TEST_ASSERT_EQUAL_MEMORY( expected, otherOutput[ frame ], frameSize );
+    }
+
+    AiaDataStreamReader_Destroy( otherFeatureReader );
+    AiaDataStreamReader_Destroy( featureReader );
+    AiaDataStreamWriter_Destroy( featureWriter );
+    AiaDataStreamBuffer_Destroy( featureStream );
+    AiaDataStreamReader_Destroy( pcmReader );
+    AiaDataStreamWriter_Destroy( pcmWriter );
+    AiaDataStreamBuffer_Destroy( pcmStream );
+}
@@ -67,6 +67,15 @@ TEST_GROUP_RUNNER( AiaBackoffTests )
     RUN_TEST_CASE( AiaBackoffTests, RetryNumZero );
     RUN_TEST_CASE( AiaBackoffTests, MaxBackoffZero );
     RUN_TEST_CASE( AiaBackoffTests, AllParams );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedBaseBackoffZero );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedMaxBackoffZero );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedFirstRetryWithinBounds );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedFirstRetryVariesAcrossSeeds );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedWithinBounds );
+    RUN_TEST_CASE( AiaBackoffTests, DecorrelatedCappedAtMaxBackoff );
+    RUN_TEST_CASE( AiaBackoffTests, SpreadNullSeed );
+    RUN_TEST_CASE( AiaBackoffTests, SpreadMaxSpreadZero );
+    RUN_TEST_CASE( AiaBackoffTests, SpreadIsDeterministicAndBounded );
 }
 
 /*-----------------------------------------------------------*/
@@ -113,3 +122,146 @@ TEST( AiaBackoffTests, AllParams )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedBaseBackoffZero )
+{
+    TEST_ASSERT_EQUAL(
+        0, AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds( 1000, 0, 1000 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedMaxBackoffZero )
+{
+    TEST_ASSERT_EQUAL(
+        0, AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds( 1000, 1000, 0 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedFirstRetryWithinBounds )
+{
+    AiaDurationMs_t baseBackoff = 1000;
+    AiaDurationMs_t maxBackoff = 100000;
+    for( size_t i = 0; i < 20; i++ )
+    {
+        AiaDurationMs_t backoff =
+            AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                0, baseBackoff, maxBackoff );
+        TEST_ASSERT_GREATER_OR_EQUAL( baseBackoff, backoff );
+        TEST_ASSERT_LESS_OR_EQUAL( baseBackoff * 3, backoff );
+    }
+
+    /* The first retry is still capped at maxBackoff. */
+    TEST_ASSERT_LESS_OR_EQUAL(
+        2 * baseBackoff, AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                             0, baseBackoff, 2 * baseBackoff ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedFirstRetryVariesAcrossSeeds )
+{
+    AiaDurationMs_t baseBackoff = 1000;
+    AiaDurationMs_t maxBackoff = 100000;
+    AiaDurationMs_t firstBackoff = 0;
+    bool isVaried = false;
+
+    /* Each seed stands in for a separate device retrying at the same time. */
+    for( char seed = 'a'; seed <= 'z'; seed++ )
+    {
+        AiaRandomMbedtls_Cleanup();
+        AiaRandomMbedtls_Init();
+        TEST_ASSERT_TRUE( AiaRandomMbedtls_Seed( &seed, sizeof( seed ) ) );
+        AiaDurationMs_t backoff =
+            AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                0, baseBackoff, maxBackoff );
+        if( !firstBackoff )
+        {
+            firstBackoff = backoff;
+        }
+        else if( backoff != firstBackoff )
+        {
+            isVaried = true;
+        }
+    }
+    TEST_ASSERT_TRUE( isVaried );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedWithinBounds )
+{
+    AiaDurationMs_t baseBackoff = 1000;
+    AiaDurationMs_t maxBackoff = 100000;
+    AiaDurationMs_t previousBackoff = 0;
+    bool isNotBase = false;
+
+    for( size_t i = 0; i < 20; i++ )
+    {
+        AiaDurationMs_t backoff =
+            AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                previousBackoff, baseBackoff, maxBackoff );
+        TEST_ASSERT_GREATER_OR_EQUAL( baseBackoff, backoff );
+        TEST_ASSERT_LESS_OR_EQUAL( maxBackoff, backoff );
+        if( previousBackoff )
+        {
+            TEST_ASSERT_LESS_OR_EQUAL( previousBackoff * 3, backoff );
+        }
+        if( backoff != baseBackoff )
+        {
+            isNotBase = true;
+        }
+        previousBackoff = backoff;
+    }
+    TEST_ASSERT_TRUE( isNotBase );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, DecorrelatedCappedAtMaxBackoff )
+{
+    AiaDurationMs_t maxBackoff = 100000;
+    TEST_ASSERT_LESS_OR_EQUAL(
+        maxBackoff, AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                        UINT32_MAX, 1000, maxBackoff ) );
+    TEST_ASSERT_EQUAL( maxBackoff,
+                       AiaBackoff_GetDecorrelatedBackoffTimeMilliseconds(
+                           1000, 2 * maxBackoff, maxBackoff ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, SpreadNullSeed )
+{
+    TEST_ASSERT_EQUAL( 0, AiaBackoff_GetSpreadMilliseconds( NULL, 0, 1000 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, SpreadMaxSpreadZero )
+{
+    static const char* SEED = "testIotClientId";
+    TEST_ASSERT_EQUAL(
+        0, AiaBackoff_GetSpreadMilliseconds( SEED, strlen( SEED ), 0 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaBackoffTests, SpreadIsDeterministicAndBounded )
+{
+    static const char* SEED = "testIotClientId";
+    static const char* OTHER_SEED = "otherIotClientId";
+    AiaDurationMs_t maxSpread = 10000;
+
+    AiaDurationMs_t spread =
+        AiaBackoff_GetSpreadMilliseconds( SEED, strlen( SEED ), maxSpread );
+    TEST_ASSERT_LESS_THAN( maxSpread, spread );
+    TEST_ASSERT_EQUAL( spread, AiaBackoff_GetSpreadMilliseconds(
+                                   SEED, strlen( SEED ), maxSpread ) );
+    TEST_ASSERT_NOT_EQUAL(
+        spread, AiaBackoff_GetSpreadMilliseconds(
+                    OTHER_SEED, strlen( OTHER_SEED ), maxSpread ) );
+}
+
+/*-----------------------------------------------------------*/
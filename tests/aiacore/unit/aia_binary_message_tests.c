@@ -147,6 +147,14 @@ TEST_GROUP_RUNNER( AiaBinaryMessageTests )
     RUN_TEST_CASE( AiaBinaryMessageTests, BuildMessageNullBuffer );
     RUN_TEST_CASE( AiaBinaryMessageTests, BuildMessageWithInsufficientBuffer );
     RUN_TEST_CASE( AiaBinaryMessageTests, BuildMessage );
+    RUN_TEST_CASE( AiaBinaryMessageTests, PoolCreateWithInvalidParameters );
+    RUN_TEST_CASE( AiaBinaryMessageTests,
+                   PoolCreateMessageWithInvalidParameters );
+    RUN_TEST_CASE( AiaBinaryMessageTests, PoolMessagesAreRecycled );
+    RUN_TEST_CASE( AiaBinaryMessageTests, PoolDestroyWithOutstandingMessages );
+    RUN_TEST_CASE( AiaBinaryMessageTests, InlineMessage );
+    RUN_TEST_CASE( AiaBinaryMessageTests, IteratorWalksBuiltMessages );
+    RUN_TEST_CASE( AiaBinaryMessageTests, IteratorRejectsTruncatedEntries );
 }
 
 /*-----------------------------------------------------------*/
@@ -264,3 +272,210 @@ TEST( AiaBinaryMessageTests, BuildMessage )
     AiaFree( messageBuffer );
     AiaBinaryMessage_Destroy( binaryMessage );
 }
+
+TEST( AiaBinaryMessageTests, PoolCreateWithInvalidParameters )
+{
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_Create( 0, TEST_LENGTH ) );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_Create( 1, 0 ) );
+    AiaFree( TEST_DATA );
+}
+
+TEST( AiaBinaryMessageTests, PoolCreateMessageWithInvalidParameters )
+{
+    AiaBinaryMessagePool_t* pool =
+        AiaBinaryMessagePool_Create( 1, TEST_LENGTH );
+    TEST_ASSERT_NOT_NULL( pool );
+    uint8_t* data = AiaBinaryMessagePool_AcquireData( pool );
+    TEST_ASSERT_NOT_NULL( data );
+
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_CreateMessage(
+        pool, TEST_LENGTH, TEST_TYPE, TEST_COUNT, TEST_DATA ) );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_CreateMessage(
+        pool, TEST_LENGTH, TEST_TYPE, TEST_COUNT, data + 1 ) );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_CreateMessage(
+        pool, TEST_LENGTH + 1, TEST_TYPE, TEST_COUNT, data ) );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_CreateMessage(
+        pool, 0, TEST_TYPE, TEST_COUNT, data ) );
+
+    AiaBinaryMessagePool_ReleaseData( pool, data );
+    AiaBinaryMessagePool_Destroy( pool );
+    AiaFree( TEST_DATA );
+}
+
+TEST( AiaBinaryMessageTests, PoolMessagesAreRecycled )
+{
+    AiaBinaryMessagePool_t* pool =
+        AiaBinaryMessagePool_Create( 2, TEST_LENGTH );
+    TEST_ASSERT_NOT_NULL( pool );
+
+    uint8_t* first = AiaBinaryMessagePool_AcquireData( pool );
+    TEST_ASSERT_NOT_NULL( first );
+    uint8_t* second = AiaBinaryMessagePool_AcquireData( pool );
+    TEST_ASSERT_NOT_NULL( second );
+    TEST_ASSERT_NOT_EQUAL( first, second );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_AcquireData( pool ) );
+
+    memcpy( first, TEST_DATA, TEST_LENGTH );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessagePool_CreateMessage(
+        pool, TEST_LENGTH, TEST_TYPE, TEST_COUNT, first );
+    TEST_ASSERT_NOT_NULL( binaryMessage );
+    TEST_ASSERT_EQUAL( TEST_LENGTH,
+                       AiaBinaryMessage_GetLength( binaryMessage ) );
+    TEST_ASSERT_EQUAL( TEST_TYPE, AiaBinaryMessage_GetType( binaryMessage ) );
+    TEST_ASSERT_EQUAL( TEST_COUNT, AiaBinaryMessage_GetCount( binaryMessage ) );
+    TEST_ASSERT_EQUAL( first, AiaBinaryMessage_GetData( binaryMessage ) );
+
+    size_t bufferSize =
+        AiaMessage_GetSize( AiaBinaryMessage_ToConstMessage( binaryMessage ) );
+    TEST_ASSERT_EQUAL( AIA_SIZE_OF_BINARY_STREAM_HEADER + TEST_LENGTH,
+                       bufferSize );
+    uint8_t* messageBuffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_NOT_NULL( messageBuffer );
+    TEST_ASSERT_TRUE( AiaBinaryMessage_BuildMessage(
+        binaryMessage, messageBuffer, bufferSize ) );
+    validateBinaryMessage( messageBuffer, bufferSize, TEST_LENGTH, TEST_TYPE,
+                           TEST_COUNT, TEST_DATA );
+    AiaFree( messageBuffer );
+
+    /* Destroying a pooled message returns it to the pool. */
+    AiaBinaryMessage_Destroy( binaryMessage );
+    TEST_ASSERT_EQUAL( first, AiaBinaryMessagePool_AcquireData( pool ) );
+    TEST_ASSERT_NULL( AiaBinaryMessagePool_AcquireData( pool ) );
+
+    /* Unused buffers can be returned directly. */
+    AiaBinaryMessagePool_ReleaseData( pool, second );
+    TEST_ASSERT_EQUAL( second, AiaBinaryMessagePool_AcquireData( pool ) );
+
+    AiaBinaryMessagePool_ReleaseData( pool, first );
+    AiaBinaryMessagePool_ReleaseData( pool, second );
+    AiaBinaryMessagePool_Destroy( pool );
+    AiaFree( TEST_DATA );
+}
+
+TEST( AiaBinaryMessageTests, PoolDestroyWithOutstandingMessages )
+{
+    AiaBinaryMessagePool_t* pool =
+        AiaBinaryMessagePool_Create( 1, TEST_LENGTH );
+    TEST_ASSERT_NOT_NULL( pool );
+    uint8_t* data = AiaBinaryMessagePool_AcquireData( pool );
+    TEST_ASSERT_NOT_NULL( data );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessagePool_CreateMessage(
+        pool, TEST_LENGTH, TEST_TYPE, TEST_COUNT, data );
+    TEST_ASSERT_NOT_NULL( binaryMessage );
+
+    /* The pool must stay alive until its last message is destroyed. */
+    AiaBinaryMessagePool_Destroy( pool );
+    TEST_ASSERT_EQUAL( data, AiaBinaryMessage_GetData( binaryMessage ) );
+    AiaBinaryMessage_Destroy( binaryMessage );
+    AiaFree( TEST_DATA );
+}
+
+TEST( AiaBinaryMessageTests, InlineMessage )
+{
+    TEST_ASSERT_NULL( AiaBinaryMessage_AllocateInline( 0 ) );
+    TEST_ASSERT_NULL( AiaBinaryMessage_CreateInline( TEST_LENGTH, TEST_TYPE,
+                                                     TEST_COUNT, NULL ) );
+
+    /* Unused buffers can be freed directly. */
+    AiaBinaryMessage_FreeInline(
+        AiaBinaryMessage_AllocateInline( TEST_LENGTH ) );
+
+    uint8_t* data = AiaBinaryMessage_AllocateInline( TEST_LENGTH );
+    TEST_ASSERT_NOT_NULL( data );
+    TEST_ASSERT_NULL( AiaBinaryMessage_CreateInline(
+        TEST_LENGTH + 1, TEST_TYPE, TEST_COUNT, data ) );
+    memcpy( data, TEST_DATA, TEST_LENGTH );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_CreateInline(
+        TEST_LENGTH, TEST_TYPE, TEST_COUNT, data );
+    TEST_ASSERT_NOT_NULL( binaryMessage );
+    TEST_ASSERT_EQUAL( data, AiaBinaryMessage_GetData( binaryMessage ) );
+
+    size_t bufferSize =
+        AiaMessage_GetSize( AiaBinaryMessage_ToConstMessage( binaryMessage ) );
+    uint8_t* messageBuffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_NOT_NULL( messageBuffer );
+    TEST_ASSERT_TRUE( AiaBinaryMessage_BuildMessage(
+        binaryMessage, messageBuffer, bufferSize ) );
+    validateBinaryMessage( messageBuffer, bufferSize, TEST_LENGTH, TEST_TYPE,
+                           TEST_COUNT, TEST_DATA );
+    AiaFree( messageBuffer );
+
+    AiaBinaryMessage_Destroy( binaryMessage );
+    AiaFree( TEST_DATA );
+}
+
+TEST( AiaBinaryMessageTests, IteratorWalksBuiltMessages )
+{
+    AiaBinaryMessage_t* first = AiaBinaryMessage_Create(
+        TEST_LENGTH, TEST_TYPE, TEST_COUNT, (void*)TEST_DATA );
+    TEST_ASSERT_NOT_NULL( first );
+    uint8_t* secondData = AiaCalloc( 1, 1 );
+    TEST_ASSERT_NOT_NULL( secondData );
+    AiaBinaryMessage_t* second =
+        AiaBinaryMessage_Create( 1, TEST_TYPE + 1, 0, secondData );
+    TEST_ASSERT_NOT_NULL( second );
+
+    size_t firstSize =
+        AiaMessage_GetSize( AiaBinaryMessage_ToConstMessage( first ) );
+    size_t secondSize =
+        AiaMessage_GetSize( AiaBinaryMessage_ToConstMessage( second ) );
+    uint8_t* stream = AiaCalloc( 1, firstSize + secondSize );
+    TEST_ASSERT_NOT_NULL( stream );
+    TEST_ASSERT_TRUE(
+        AiaBinaryMessage_BuildMessage( first, stream, firstSize ) );
+    TEST_ASSERT_TRUE( AiaBinaryMessage_BuildMessage(
+        second, stream + firstSize, secondSize ) );
+
+    AiaBinaryStreamIterator_t iterator;
+    AiaBinaryStreamIterator_Init( &iterator, stream, firstSize + secondSize );
+    AiaBinaryStreamEntry_t entry;
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_HasNext( &iterator ) );
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_Next( &iterator, &entry ) );
+    TEST_ASSERT_EQUAL( TEST_LENGTH, entry.length );
+    TEST_ASSERT_EQUAL( TEST_TYPE, entry.type );
+    TEST_ASSERT_EQUAL( TEST_COUNT, entry.count );
+    TEST_ASSERT_EQUAL_PTR( stream + AIA_SIZE_OF_BINARY_STREAM_HEADER,
+                           entry.data );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_DATA, entry.data, TEST_LENGTH );
+
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_HasNext( &iterator ) );
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_Next( &iterator, &entry ) );
+    TEST_ASSERT_EQUAL( 1, entry.length );
+    TEST_ASSERT_EQUAL( TEST_TYPE + 1, entry.type );
+    TEST_ASSERT_EQUAL( 0, entry.count );
+    TEST_ASSERT_FALSE( AiaBinaryStreamIterator_HasNext( &iterator ) );
+
+    AiaFree( stream );
+    AiaBinaryMessage_Destroy( first );
+    AiaBinaryMessage_Destroy( second );
+}
+
+TEST( AiaBinaryMessageTests, IteratorRejectsTruncatedEntries )
+{
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_Create(
+        TEST_LENGTH, TEST_TYPE, TEST_COUNT, (void*)TEST_DATA );
+    TEST_ASSERT_NOT_NULL( binaryMessage );
+    size_t bufferSize =
+        AiaMessage_GetSize( AiaBinaryMessage_ToConstMessage( binaryMessage ) );
+    uint8_t* messageBuffer = AiaCalloc( 1, bufferSize );
+    TEST_ASSERT_NOT_NULL( messageBuffer );
+    TEST_ASSERT_TRUE( AiaBinaryMessage_BuildMessage(
+        binaryMessage, messageBuffer, bufferSize ) );
+
+    AiaBinaryStreamIterator_t iterator;
+    AiaBinaryStreamEntry_t entry;
+
+    /* Too short for the header. */
+    AiaBinaryStreamIterator_Init( &iterator, messageBuffer,
+                                  AIA_SIZE_OF_BINARY_STREAM_HEADER - 1 );
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_HasNext( &iterator ) );
+    TEST_ASSERT_FALSE( AiaBinaryStreamIterator_Next( &iterator, &entry ) );
+
+    /* Too short for the data. */
+    AiaBinaryStreamIterator_Init( &iterator, messageBuffer, bufferSize - 1 );
+    TEST_ASSERT_FALSE( AiaBinaryStreamIterator_Next( &iterator, &entry ) );
+    TEST_ASSERT_TRUE( AiaBinaryStreamIterator_HasNext( &iterator ) );
+
+    AiaFree( messageBuffer );
+    AiaBinaryMessage_Destroy( binaryMessage );
+}
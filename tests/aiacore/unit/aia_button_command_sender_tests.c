@@ -34,6 +34,8 @@
 #include <aiamockregulator/aia_mock_regulator.h>
 #include <aiatestutilities/aia_test_utilities.h>
 
+#include AiaClock( HEADER )
+
 /* Test framework includes. */
 #include <unity_fixture.h>
 
@@ -43,6 +45,9 @@
 static const char* TEST_SALT = "TestSalt";
 static const size_t TEST_SALT_LENGTH = sizeof( TEST_SALT ) - 1;
 
+/** A coalescing window short enough to wait out during a test. */
+static const AiaDurationMs_t TEST_COALESCING_WINDOW_MS = 50;
+
 /** Object used to mock the emission of events. */
 static AiaMockRegulator_t* g_mockEventRegulator;
 static AiaRegulator_t* g_regulator; /* pre-casted copy of g_mockRegulator */
@@ -113,6 +118,7 @@ TEST_GROUP_RUNNER( AiaButtonCommandTests )
     RUN_TEST_CASE( AiaButtonCommandTests,
                    ButtonCommandPressesWithoutLocalStops );
     RUN_TEST_CASE( AiaButtonCommandTests, ButtonCommandPressesWithLocalStops );
+    RUN_TEST_CASE( AiaButtonCommandTests, PressesWithinWindowCoalesce );
 }
 
 /*-----------------------------------------------------------*/
@@ -221,3 +227,51 @@ TEST( AiaButtonCommandTests, ButtonCommandPressesWithLocalStops )
 
     AiaButtonCommandSender_Destroy( buttonCommandSender );
 }
+
+TEST( AiaButtonCommandTests, PressesWithinWindowCoalesce )
+{
+    TEST_ASSERT_FALSE( AiaButtonCommandSender_SetCoalescingWindow(
+        NULL, TEST_COALESCING_WINDOW_MS ) );
+
+    AiaButtonCommandSender_t* buttonCommandSender =
+        AiaButtonCommandSender_Create( g_regulator, AiaMockStopPlayback, NULL );
+    TEST_ASSERT_NOT_NULL( buttonCommandSender );
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_SetCoalescingWindow(
+        buttonCommandSender, TEST_COALESCING_WINDOW_MS ) );
+
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_NEXT ) );
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_STOP ) );
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_PAUSE ) );
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_PREVIOUS ) );
+
+    /* Playback is stopped once per burst, and nothing is sent until the window
+     * ends. */
+    TEST_ASSERT_EQUAL( 1, localStopsCounter );
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TryWait )( &g_mockEventRegulator->writeSemaphore ) );
+
+    AiaClock( SleepMs( 2 * TEST_COALESCING_WINDOW_MS ) );
+    TestButtonCommandIssuedIsGenerated( AIA_BUTTON_PREVIOUS );
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TryWait )( &g_mockEventRegulator->writeSemaphore ) );
+
+    /* A new burst stops playback again. */
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_PAUSE ) );
+    TEST_ASSERT_EQUAL( 2, localStopsCounter );
+    AiaClock( SleepMs( 2 * TEST_COALESCING_WINDOW_MS ) );
+    TestButtonCommandIssuedIsGenerated( AIA_BUTTON_PAUSE );
+
+    /* Disabling the window sends presses immediately again. */
+    TEST_ASSERT_TRUE(
+        AiaButtonCommandSender_SetCoalescingWindow( buttonCommandSender, 0 ) );
+    TEST_ASSERT_TRUE( AiaButtonCommandSender_OnButtonPressed(
+        buttonCommandSender, AIA_BUTTON_PLAY ) );
+    TestButtonCommandIssuedIsGenerated( AIA_BUTTON_PLAY );
+
+    AiaButtonCommandSender_Destroy( buttonCommandSender );
+}
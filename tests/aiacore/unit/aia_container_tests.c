@@ -0,0 +1,134 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_container_tests.c
+ * @brief Tests for the containers generated by aia_container.h.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_container.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Capacity of the containers used by tests. */
+#define TEST_CAPACITY 4
+
+/** An element of the containers used by tests. */
+typedef struct TestElement
+{
+    uint32_t key;
+} TestElement_t;
+
+AIA_DEFINE_RING( TestRing, TestElement_t )
+
+/** Storage of the containers used by tests. */
+static TestElement_t g_storage[ TEST_CAPACITY ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaContainer tests.
+ */
+TEST_GROUP( AiaContainerTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaContainer tests.
+ */
+TEST_SETUP( AiaContainerTests )
+{
+    memset( g_storage, 0, sizeof( g_storage ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaContainer tests.
+ */
+TEST_TEAR_DOWN( AiaContainerTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaContainer tests.
+ */
+TEST_GROUP_RUNNER( AiaContainerTests )
+{
+    RUN_TEST_CASE( AiaContainerTests, RingPopsInPushOrder );
+    RUN_TEST_CASE( AiaContainerTests, RingWrapsAround );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaContainerTests, RingPopsInPushOrder )
+{
+    TestRing_t ring;
+    TestRing_Init( &ring, g_storage, TEST_CAPACITY );
+    TEST_ASSERT_TRUE( TestRing_IsEmpty( &ring ) );
+    TEST_ASSERT_NULL( TestRing_Front( &ring ) );
+    for( uint32_t i = 0; i < TEST_CAPACITY; ++i )
+    {
+        TestElement_t* element = TestRing_PushBack( &ring );
+        TEST_ASSERT_NOT_NULL( element );
+        element->key = i;
+    }
+    TEST_ASSERT_TRUE( TestRing_IsFull( &ring ) );
+    TEST_ASSERT_NULL( TestRing_PushBack( &ring ) );
+    TEST_ASSERT_EQUAL_UINT32( 2, TestRing_At( &ring, 2 )->key );
+    TEST_ASSERT_NULL( TestRing_At( &ring, TEST_CAPACITY ) );
+    for( uint32_t i = 0; i < TEST_CAPACITY; ++i )
+    {
+        TEST_ASSERT_EQUAL_UINT32( i, TestRing_Front( &ring )->key );
+        TestRing_PopFront( &ring );
+    }
+    TEST_ASSERT_TRUE( TestRing_IsEmpty( &ring ) );
+}
+
+TEST( AiaContainerTests, RingWrapsAround )
+{
+    TestRing_t ring;
+    TestRing_Init( &ring, g_storage, TEST_CAPACITY );
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for( size_t lap = 0; lap < 10; ++lap )
+    {
+        /* Alternate between filling the ring and leaving it partly full. */
+        size_t count = lap % 2 ? TEST_CAPACITY : 3;
+        for( size_t i = 0; i < count; ++i )
+        {
+            TestRing_PushBack( &ring )->key = pushed++;
+        }
+        TEST_ASSERT_EQUAL( count, TestRing_Size( &ring ) );
+        while( popped < pushed )
+        {
+            TEST_ASSERT_EQUAL_UINT32( popped++, TestRing_Front( &ring )->key );
+            TestRing_PopFront( &ring );
+        }
+    }
+    TestRing_PushBack( &ring );
+    TestRing_Clear( &ring );
+    TEST_ASSERT_TRUE( TestRing_IsEmpty( &ring ) );
+}
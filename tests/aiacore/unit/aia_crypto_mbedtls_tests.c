@@ -27,10 +27,13 @@
 #include <aiacore/aia_mbedtls_threading.h>
 #include <aiacore/aia_message_constants.h>
 #include <aiacore/aia_secret_derivation_algorithm.h>
+#include <aiacore/aia_utils.h>
 
 /* Test framework includes. */
 #include <unity_fixture.h>
 
+#include <string.h>
+
 #define TEST_IV_LEN 12
 /* Use AES_GCM as the encryption algorithm */
 #define TEST_ENCRYPT_ALG AIA_AES_GCM
@@ -59,6 +62,26 @@ static const unsigned char TEST_INPUT_DATA[ TEST_INPUT_DATA_LEN ] = {
     0x57, 0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55
 };
 
+/* Test Case 15 of the GCM specification encrypts TEST_INPUT_DATA with
+ * TEST_ENCRYPT_KEY and this IV into the ciphertext and tag below. */
+static const unsigned char TEST_KNOWN_IV[ TEST_IV_LEN ] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+};
+
+static const unsigned char TEST_KNOWN_OUTPUT_DATA[ TEST_INPUT_DATA_LEN ] = {
+    0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37,
+    0xa3, 0x2a, 0x84, 0x42, 0x7d, 0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5,
+    0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa, 0x8c,
+    0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10,
+    0x56, 0x82, 0x88, 0x38, 0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a,
+    0x0a, 0xbc, 0xc9, 0xf6, 0x62, 0x89, 0x80, 0x15, 0xad
+};
+
+static const unsigned char TEST_KNOWN_TAG[ TEST_TAG_LEN ] = {
+    0xb0, 0x94, 0xda, 0xc5, 0xd9, 0x34, 0x71, 0xbd,
+    0xec, 0x1a, 0x50, 0x22, 0x70, 0xe3, 0xcc, 0x6c
+};
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -110,6 +133,12 @@ TEST_GROUP_RUNNER( AiaCryptoMbedtlsTests )
     RUN_TEST_CASE( AiaCryptoMbedtlsTests, DecryptWithoutInput );
     RUN_TEST_CASE( AiaCryptoMbedtlsTests, DecryptWithoutOutput );
     RUN_TEST_CASE( AiaCryptoMbedtlsTests, DecryptWithoutTag );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, ContextWithNullArgs );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, ContextEncryptDecryptHappyCase );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, ContextsAreKeyedIndependently );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, ContextIvsAreCounted );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, SegmentsMatchContiguousData );
+    RUN_TEST_CASE( AiaCryptoMbedtlsTests, DecryptKnownAnswer );
     RUN_TEST_CASE( AiaCryptoMbedtlsTests, GenerateKeyPairNullKey );
     RUN_TEST_CASE( AiaCryptoMbedtlsTests, GenerateKeyPairInvalidKeyLength );
     RUN_TEST_CASE( AiaCryptoMbedtlsTests,
@@ -389,6 +418,237 @@ TEST( AiaCryptoMbedtlsTests, DecryptWithInvalidTagLength )
                                                  tag, 100 ) );
 }
 
+TEST( AiaCryptoMbedtlsTests, ContextWithNullArgs )
+{
+    unsigned char iv[ TEST_IV_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    unsigned char outputBuf[ TEST_INPUT_DATA_LEN ];
+
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_SetContextKey(
+        NULL, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_EncryptWithContext(
+        NULL, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_DecryptWithContext(
+        NULL, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    AiaCryptoMbedtls_DestroyContext( NULL );
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_SetContextKey(
+        context, NULL, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN - 1, TEST_ENCRYPT_ALG ) );
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+TEST( AiaCryptoMbedtlsTests, ContextEncryptDecryptHappyCase )
+{
+    unsigned char iv[ TEST_IV_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    unsigned char outputBuf[ TEST_INPUT_DATA_LEN ];
+    unsigned char decrypted[ TEST_INPUT_DATA_LEN ];
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptWithContext(
+        context, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptWithContext(
+        context, outputBuf, TEST_INPUT_DATA_LEN, decrypted, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    /* Data encrypted with a context is interoperable with the global key set
+     * to the same value. */
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_Decrypt( outputBuf, TEST_INPUT_DATA_LEN,
+                                                decrypted, iv, TEST_IV_LEN, tag,
+                                                TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+TEST( AiaCryptoMbedtlsTests, ContextsAreKeyedIndependently )
+{
+    static const unsigned char OTHER_ENCRYPT_KEY[ TEST_KEY_LEN ] = { 0x04 };
+    unsigned char iv[ TEST_IV_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    unsigned char outputBuf[ TEST_INPUT_DATA_LEN ];
+    unsigned char decrypted[ TEST_INPUT_DATA_LEN ];
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+    AiaCryptoMbedtlsContext_t* otherContext = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( otherContext );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        otherContext, OTHER_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+
+    /* Re-keying the global context or another context must not affect the
+     * key used by @c context. */
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetKey( OTHER_ENCRYPT_KEY, TEST_KEY_LEN,
+                                               TEST_ENCRYPT_ALG ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptWithContext(
+        context, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_DecryptWithContext(
+        otherContext, outputBuf, TEST_INPUT_DATA_LEN, decrypted, iv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptWithContext(
+        context, outputBuf, TEST_INPUT_DATA_LEN, decrypted, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    AiaCryptoMbedtls_DestroyContext( otherContext );
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+TEST( AiaCryptoMbedtlsTests, ContextIvsAreCounted )
+{
+    unsigned char firstIv[ TEST_IV_LEN ];
+    unsigned char iv[ TEST_IV_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    unsigned char outputBuf[ TEST_INPUT_DATA_LEN ];
+    unsigned char decrypted[ TEST_INPUT_DATA_LEN ];
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptWithContext(
+        context, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, firstIv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptWithContext(
+        context, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+
+    /* The random field is shared and the trailing counter advances by one. */
+    TEST_ASSERT_EQUAL_MEMORY( firstIv, iv, TEST_IV_LEN - 4 );
+    TEST_ASSERT_EQUAL( 0, firstIv[ TEST_IV_LEN - 1 ] );
+    TEST_ASSERT_EQUAL( 1, iv[ TEST_IV_LEN - 1 ] );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptWithContext(
+        context, outputBuf, TEST_INPUT_DATA_LEN, decrypted, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    /* Setting the key again draws a new random field. */
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptWithContext(
+        context, TEST_INPUT_DATA, TEST_INPUT_DATA_LEN, outputBuf, iv,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( memcmp( firstIv, iv, TEST_IV_LEN ) != 0 );
+
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+TEST( AiaCryptoMbedtlsTests, SegmentsMatchContiguousData )
+{
+    unsigned char iv[ TEST_IV_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    unsigned char outputBuf[ TEST_INPUT_DATA_LEN ];
+    unsigned char decrypted[ TEST_INPUT_DATA_LEN ];
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+
+    /* Segments which straddle block boundaries, like a header and payload
+     * gathered from separate buffers. */
+    AiaCryptoMbedtlsSegment_t segments[ 3 ];
+    const size_t lengths[ 3 ] = { 5, 20, TEST_INPUT_DATA_LEN - 25 };
+    size_t offset = 0;
+    for( size_t i = 0; i < AiaArrayLength( segments ); ++i )
+    {
+        segments[ i ].input = TEST_INPUT_DATA + offset;
+        segments[ i ].output = outputBuf + offset;
+        segments[ i ].length = lengths[ i ];
+        offset += lengths[ i ];
+    }
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_EncryptSegmentsWithContext(
+        context, NULL, AiaArrayLength( segments ), iv, TEST_IV_LEN, tag,
+        TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_EncryptSegmentsWithContext(
+        context, segments, AiaArrayLength( segments ), iv, TEST_IV_LEN, tag,
+        TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptWithContext(
+        context, outputBuf, TEST_INPUT_DATA_LEN, decrypted, iv, TEST_IV_LEN,
+        tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    /* Decrypt in place across the same segments. */
+    offset = 0;
+    for( size_t i = 0; i < AiaArrayLength( segments ); ++i )
+    {
+        segments[ i ].input = outputBuf + offset;
+        offset += lengths[ i ];
+    }
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptSegmentsWithContext(
+        context, segments, AiaArrayLength( segments ), iv, TEST_IV_LEN, tag,
+        TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, outputBuf, TEST_INPUT_DATA_LEN ) );
+
+    /* A mismatched tag is rejected. */
+    tag[ 0 ] ^= 1;
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_DecryptSegmentsWithContext(
+        context, segments, AiaArrayLength( segments ), iv, TEST_IV_LEN, tag,
+        TEST_TAG_LEN ) );
+
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
+TEST( AiaCryptoMbedtlsTests, DecryptKnownAnswer )
+{
+    /* Round trips would not catch an implementation which is consistently
+     * wrong, such as an accelerated kernel. */
+    unsigned char decrypted[ TEST_INPUT_DATA_LEN ];
+    unsigned char tag[ TEST_TAG_LEN ];
+    memcpy( tag, TEST_KNOWN_TAG, sizeof( tag ) );
+
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_Decrypt(
+        TEST_KNOWN_OUTPUT_DATA, TEST_INPUT_DATA_LEN, decrypted, TEST_KNOWN_IV,
+        TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    AiaCryptoMbedtlsContext_t* context = AiaCryptoMbedtls_CreateContext();
+    TEST_ASSERT_NOT_NULL( context );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_SetContextKey(
+        context, TEST_ENCRYPT_KEY, TEST_KEY_LEN, TEST_ENCRYPT_ALG ) );
+    memset( decrypted, 0, sizeof( decrypted ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_DecryptWithContext(
+        context, TEST_KNOWN_OUTPUT_DATA, TEST_INPUT_DATA_LEN, decrypted,
+        TEST_KNOWN_IV, TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    TEST_ASSERT_TRUE(
+        verifyDecryption( TEST_INPUT_DATA, decrypted, TEST_INPUT_DATA_LEN ) );
+
+    /* A message whose tag does not match is not returned. */
+    tag[ TEST_TAG_LEN - 1 ] ^= 1;
+    TEST_ASSERT_FALSE( AiaCryptoMbedtls_DecryptWithContext(
+        context, TEST_KNOWN_OUTPUT_DATA, TEST_INPUT_DATA_LEN, decrypted,
+        TEST_KNOWN_IV, TEST_IV_LEN, tag, TEST_TAG_LEN ) );
+    for( size_t i = 0; i < TEST_INPUT_DATA_LEN; ++i )
+    {
+        TEST_ASSERT_EQUAL_UINT8( 0, decrypted[ i ] );
+    }
+
+    AiaCryptoMbedtls_DestroyContext( context );
+}
+
 TEST( AiaCryptoMbedtlsTests, GenerateKeyPairNullKey )
 {
     uint8_t privateKey[ TEST_GENERATED_KEY_LEN ];
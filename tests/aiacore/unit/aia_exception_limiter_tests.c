@@ -0,0 +1,276 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_exception_limiter_tests.c
+ * @brief Tests for AiaExceptionLimiter_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+/* Aia headers */
+#include <aiacore/aia_events.h>
+#include <aiacore/aia_exception_limiter.h>
+#include <aiacore/aia_json_constants.h>
+#include <aiacore/aia_json_message.h>
+#include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_random_mbedtls.h>
+
+#include <aiamockregulator/aia_mock_regulator.h>
+#include <aiatestutilities/aia_test_utilities.h>
+
+#include AiaClock( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+/*-----------------------------------------------------------*/
+
+/** Sample Seed. */
+static const char* TEST_SALT = "TestSalt";
+static const size_t TEST_SALT_LENGTH = sizeof( TEST_SALT ) - 1;
+
+/** A refill interval long enough that no tokens are returned during a test. */
+static const AiaDurationMs_t TEST_LONG_REFILL_INTERVAL_MS = 60000;
+
+/** A refill interval short enough to wait out during a test. */
+static const AiaDurationMs_t TEST_SHORT_REFILL_INTERVAL_MS = 50;
+
+/** How long a test waits for coalesced reports to be sent. */
+static const AiaDurationMs_t TEST_FLUSH_TIMEOUT_MS = 1000;
+
+/** Object used to mock the emission of events. */
+static AiaMockRegulator_t* g_mockEventRegulator;
+static AiaRegulator_t* g_regulator; /* pre-casted copy of g_mockRegulator */
+
+/**
+ * Counts the events written to @c g_mockEventRegulator since the last call.
+ *
+ * @return The number of events written.
+ */
+static size_t CountWrittenEvents()
+{
+    size_t count = 0;
+    while( AiaSemaphore( TryWait )( &g_mockEventRegulator->writeSemaphore ) )
+    {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * Returns the error description of the last event written to @c
+ * g_mockEventRegulator.
+ *
+ * @param[out] description The description, without its quotes.
+ * @param[out] descriptionLength The length of @c description.
+ * @return @c true if the last event has a description, else @c false.
+ */
+static bool GetLastEventDescription( const char** description,
+                                     size_t* descriptionLength )
+{
+    AiaListDouble( Link_t )* link =
+        AiaListDouble( PeekTail )( &g_mockEventRegulator->writtenMessages );
+    TEST_ASSERT_NOT_NULL( link );
+    AiaJsonMessage_t* event = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL_STRING( AIA_EVENTS_EXCEPTION_ENCOUNTERED,
+                              AiaJsonMessage_GetName( event ) );
+    const char* payload = AiaJsonMessage_GetJsonPayload( event );
+    TEST_ASSERT_NOT_NULL( payload );
+
+    const char* error;
+    size_t errorLength;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        payload, strlen( payload ), AIA_EXCEPTION_ENCOUNTERED_ERROR_KEY,
+        strlen( AIA_EXCEPTION_ENCOUNTERED_ERROR_KEY ), &error, &errorLength ) );
+    if( !AiaFindJsonValue(
+            error, errorLength, AIA_EXCEPTION_ENCOUNTERED_ERROR_DESCRIPTION_KEY,
+            strlen( AIA_EXCEPTION_ENCOUNTERED_ERROR_DESCRIPTION_KEY ),
+            description, descriptionLength ) )
+    {
+        return false;
+    }
+    TEST_ASSERT_TRUE( AiaJsonUtils_UnquoteString( description,
+                                                  descriptionLength ) );
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaExceptionLimiter_t tests.
+ */
+TEST_GROUP( AiaExceptionLimiterTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaExceptionLimiter_t tests.
+ */
+TEST_GROUP_RUNNER( AiaExceptionLimiterTests )
+{
+    RUN_TEST_CASE( AiaExceptionLimiterTests, Creation );
+    RUN_TEST_CASE( AiaExceptionLimiterTests, ReportWithoutLimiter );
+    RUN_TEST_CASE( AiaExceptionLimiterTests, BurstIsSentThenReportsCoalesce );
+    RUN_TEST_CASE( AiaExceptionLimiterTests, CoalescedReportsSentOnRefill );
+    RUN_TEST_CASE( AiaExceptionLimiterTests, ReportsCoalescePerTopic );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaExceptionLimiter_t tests.
+ */
+TEST_SETUP( AiaExceptionLimiterTests )
+{
+    AiaRandomMbedtls_Init();
+    TEST_ASSERT_TRUE( AiaRandomMbedtls_Seed( TEST_SALT, TEST_SALT_LENGTH ) );
+
+    g_mockEventRegulator = AiaMockRegulator_Create();
+    TEST_ASSERT_NOT_NULL( g_mockEventRegulator );
+    g_regulator = (AiaRegulator_t*)g_mockEventRegulator;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaExceptionLimiter_t tests.
+ */
+TEST_TEAR_DOWN( AiaExceptionLimiterTests )
+{
+    AiaMockRegulator_Destroy( g_mockEventRegulator,
+                              AiaTestUtilities_DestroyJsonChunk, NULL );
+    AiaRandomMbedtls_Cleanup();
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaExceptionLimiterTests, Creation )
+{
+    TEST_ASSERT_NULL(
+        AiaExceptionLimiter_Create( NULL, 1, TEST_LONG_REFILL_INTERVAL_MS ) );
+    TEST_ASSERT_NULL( AiaExceptionLimiter_Create(
+        g_regulator, 0, TEST_LONG_REFILL_INTERVAL_MS ) );
+    TEST_ASSERT_NULL( AiaExceptionLimiter_Create( g_regulator, 1, 0 ) );
+
+    AiaExceptionLimiter_t* limiter = AiaExceptionLimiter_Create(
+        g_regulator, 1, TEST_LONG_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( limiter );
+    AiaExceptionLimiter_Destroy( limiter );
+}
+
+TEST( AiaExceptionLimiterTests, ReportWithoutLimiter )
+{
+    TEST_ASSERT_FALSE( AiaExceptionLimiter_ReportMalformedMessage(
+        NULL, 0, 0, AIA_TOPIC_DIRECTIVE ) );
+}
+
+TEST( AiaExceptionLimiterTests, BurstIsSentThenReportsCoalesce )
+{
+    static const size_t TEST_BURST = 3;
+    AiaExceptionLimiter_t* limiter = AiaExceptionLimiter_Create(
+        g_regulator, TEST_BURST, TEST_LONG_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( limiter );
+
+    for( AiaSequenceNumber_t i = 0; i < 10 * TEST_BURST; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+            limiter, i, 0, AIA_TOPIC_DIRECTIVE ) );
+    }
+    TEST_ASSERT_EQUAL( TEST_BURST, CountWrittenEvents() );
+
+    AiaExceptionLimiter_Destroy( limiter );
+}
+
+TEST( AiaExceptionLimiterTests, CoalescedReportsSentOnRefill )
+{
+    AiaExceptionLimiter_t* limiter = AiaExceptionLimiter_Create(
+        g_regulator, 1, TEST_SHORT_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( limiter );
+
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 1, 0, AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 2, 0, AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 3, 0, AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TryWait )(
+        &g_mockEventRegulator->writeSemaphore ) );
+
+    const char* description;
+    size_t descriptionLength;
+    TEST_ASSERT_FALSE(
+        GetLastEventDescription( &description, &descriptionLength ) );
+
+    /* The run is sent without waiting for another report. */
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockEventRegulator->writeSemaphore,
+                                   TEST_FLUSH_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE(
+        GetLastEventDescription( &description, &descriptionLength ) );
+    static const char* EXPECTED_DESCRIPTION =
+        "2 malformed messages, sequence numbers 2 to 3";
+    TEST_ASSERT_EQUAL_STRING_LEN( EXPECTED_DESCRIPTION, description,
+                                  descriptionLength );
+    TEST_ASSERT_EQUAL( strlen( EXPECTED_DESCRIPTION ), descriptionLength );
+
+    AiaClock( SleepMs( 2 * TEST_SHORT_REFILL_INTERVAL_MS ) );
+    TEST_ASSERT_EQUAL( 0, CountWrittenEvents() );
+
+    AiaExceptionLimiter_Destroy( limiter );
+}
+
+TEST( AiaExceptionLimiterTests, ReportsCoalescePerTopic )
+{
+    AiaExceptionLimiter_t* limiter = AiaExceptionLimiter_Create(
+        g_regulator, 1, TEST_SHORT_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( limiter );
+
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 1, 0, AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 7, 0, AIA_TOPIC_SPEAKER ) );
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 2, 0, AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_TRUE( AiaExceptionLimiter_ReportMalformedMessage(
+        limiter, 8, 0, AIA_TOPIC_SPEAKER ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TryWait )(
+        &g_mockEventRegulator->writeSemaphore ) );
+
+    /* Each token sends one run, so the directive report goes out on its own
+     * and the speaker reports follow as one event. */
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockEventRegulator->writeSemaphore,
+                                   TEST_FLUSH_TIMEOUT_MS ) );
+    const char* description;
+    size_t descriptionLength;
+    TEST_ASSERT_FALSE(
+        GetLastEventDescription( &description, &descriptionLength ) );
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockEventRegulator->writeSemaphore,
+                                   TEST_FLUSH_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE(
+        GetLastEventDescription( &description, &descriptionLength ) );
+    TEST_ASSERT_EQUAL_STRING_LEN(
+        "2 malformed messages, sequence numbers 7 to 8", description,
+        descriptionLength );
+
+    AiaExceptionLimiter_Destroy( limiter );
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_histogram_tests.c
+ * @brief Tests for AiaHistogram_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_histogram.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+/** The histogram used by tests. */
+static AiaHistogram_t g_histogram;
+
+/** A snapshot of @c g_histogram. */
+static AiaHistogram_t g_snapshot;
+
+/** Takes a snapshot of @c g_histogram into @c g_snapshot. */
+static void takeSnapshot()
+{
+    AiaHistogram_Snapshot( &g_histogram, &g_snapshot );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaHistogram tests.
+ */
+TEST_GROUP( AiaHistogramTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaHistogram tests.
+ */
+TEST_SETUP( AiaHistogramTests )
+{
+    memset( &g_histogram, 0, sizeof( g_histogram ) );
+    memset( &g_snapshot, 0, sizeof( g_snapshot ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaHistogram tests.
+ */
+TEST_TEAR_DOWN( AiaHistogramTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaHistogram tests.
+ */
+TEST_GROUP_RUNNER( AiaHistogramTests )
+{
+    RUN_TEST_CASE( AiaHistogramTests, EmptyHistogram );
+    RUN_TEST_CASE( AiaHistogramTests, SmallValuesAreExact );
+    RUN_TEST_CASE( AiaHistogramTests, LargeValuesAreWithinABucket );
+    RUN_TEST_CASE( AiaHistogramTests, PercentilesOfUniformValues );
+    RUN_TEST_CASE( AiaHistogramTests, ValuesAboveRangeAreCounted );
+    RUN_TEST_CASE( AiaHistogramTests, Reset );
+    RUN_TEST_CASE( AiaHistogramTests, Serialize );
+    RUN_TEST_CASE( AiaHistogramTests, SerializeIntoSmallBuffer );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaHistogramTests, EmptyHistogram )
+{
+    takeSnapshot();
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaHistogram_GetCount( &g_snapshot ) );
+    TEST_ASSERT_EQUAL_UINT32(
+        0, AiaHistogram_GetValueAtPercentile( &g_snapshot, 50 ) );
+
+    /* Only the largest value is encoded. */
+    uint8_t buffer[ AIA_HISTOGRAM_MAX_SERIALIZED_SIZE ];
+    TEST_ASSERT_EQUAL( 1, AiaHistogram_Serialize( &g_snapshot, buffer,
+                                                  sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL_UINT8( 0, buffer[ 0 ] );
+}
+
+TEST( AiaHistogramTests, SmallValuesAreExact )
+{
+    for( uint32_t value = 0; value < 4; ++value )
+    {
+        memset( &g_histogram, 0, sizeof( g_histogram ) );
+        AiaHistogram_Record( &g_histogram, value );
+        takeSnapshot();
+        TEST_ASSERT_EQUAL_UINT32( 1, AiaHistogram_GetCount( &g_snapshot ) );
+        TEST_ASSERT_EQUAL_UINT32(
+            value, AiaHistogram_GetValueAtPercentile( &g_snapshot, 100 ) );
+    }
+}
+
+TEST( AiaHistogramTests, LargeValuesAreWithinABucket )
+{
+    /* 1000 is counted in the bucket holding 896 to 1023. */
+    AiaHistogram_Record( &g_histogram, 1000 );
+    AiaHistogram_Record( &g_histogram, 5000 );
+    takeSnapshot();
+    TEST_ASSERT_EQUAL_UINT32( 2, AiaHistogram_GetCount( &g_snapshot ) );
+    TEST_ASSERT_EQUAL_UINT32( 5000, g_snapshot.max );
+
+    uint32_t p50 = AiaHistogram_GetValueAtPercentile( &g_snapshot, 50 );
+    TEST_ASSERT_TRUE( p50 >= 1000 );
+    TEST_ASSERT_TRUE( p50 < 1250 );
+
+    /* The top percentile is capped at the largest value recorded. */
+    TEST_ASSERT_EQUAL_UINT32(
+        5000, AiaHistogram_GetValueAtPercentile( &g_snapshot, 100 ) );
+}
+
+TEST( AiaHistogramTests, PercentilesOfUniformValues )
+{
+    for( uint32_t value = 1; value <= 1000; ++value )
+    {
+        AiaHistogram_Record( &g_histogram, value );
+    }
+    takeSnapshot();
+    TEST_ASSERT_EQUAL_UINT32( 1000, AiaHistogram_GetCount( &g_snapshot ) );
+
+    uint32_t p50 = AiaHistogram_GetValueAtPercentile( &g_snapshot, 50 );
+    TEST_ASSERT_TRUE( p50 >= 500 );
+    TEST_ASSERT_TRUE( p50 <= 500 * 5 / 4 );
+    uint32_t p99 = AiaHistogram_GetValueAtPercentile( &g_snapshot, 99 );
+    TEST_ASSERT_TRUE( p99 >= 990 );
+    TEST_ASSERT_TRUE( p99 <= 1000 );
+    TEST_ASSERT_EQUAL_UINT32(
+        1, AiaHistogram_GetValueAtPercentile( &g_snapshot, 0 ) );
+}
+
+TEST( AiaHistogramTests, ValuesAboveRangeAreCounted )
+{
+    AiaHistogram_Record( &g_histogram, UINT32_MAX );
+    AiaHistogram_Record( &g_histogram, 1 << AIA_HISTOGRAM_MAX_VALUE_BITS );
+    takeSnapshot();
+    TEST_ASSERT_EQUAL_UINT32( 2, AiaHistogram_GetCount( &g_snapshot ) );
+    TEST_ASSERT_EQUAL_UINT32( 2,
+                              g_snapshot.counts[ AIA_HISTOGRAM_BUCKETS - 1 ] );
+    TEST_ASSERT_EQUAL_UINT32(
+        UINT32_MAX, AiaHistogram_GetValueAtPercentile( &g_snapshot, 100 ) );
+}
+
+TEST( AiaHistogramTests, Reset )
+{
+    AiaHistogram_Record( &g_histogram, 10 );
+    AiaHistogram_Reset( &g_histogram );
+    takeSnapshot();
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaHistogram_GetCount( &g_snapshot ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, g_snapshot.max );
+}
+
+TEST( AiaHistogramTests, Serialize )
+{
+    AiaHistogram_Record( &g_histogram, 2 );
+    AiaHistogram_Record( &g_histogram, 2 );
+    AiaHistogram_Record( &g_histogram, 200 );
+    takeSnapshot();
+
+    /* The largest value, then the index delta and count of buckets 2 and 26,
+     * which holds 192 to 223. */
+    static const uint8_t expected[] = { 0xc8, 0x01, 2, 2, 24, 1 };
+    TEST_ASSERT_EQUAL( sizeof( expected ),
+                       AiaHistogram_Serialize( &g_snapshot, NULL, 0 ) );
+    uint8_t buffer[ AIA_HISTOGRAM_MAX_SERIALIZED_SIZE ];
+    TEST_ASSERT_EQUAL( sizeof( expected ),
+                       AiaHistogram_Serialize( &g_snapshot, buffer,
+                                               sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( expected, buffer, sizeof( expected ) );
+}
+
+TEST( AiaHistogramTests, SerializeIntoSmallBuffer )
+{
+    AiaHistogram_Record( &g_histogram, 200 );
+    takeSnapshot();
+    size_t size = AiaHistogram_Serialize( &g_snapshot, NULL, 0 );
+    uint8_t buffer[ AIA_HISTOGRAM_MAX_SERIALIZED_SIZE ];
+    TEST_ASSERT_EQUAL(
+        0, AiaHistogram_Serialize( &g_snapshot, buffer, size - 1 ) );
+}
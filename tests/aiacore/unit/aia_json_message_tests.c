@@ -171,6 +171,11 @@ TEST_GROUP_RUNNER( AiaJsonMessageTests )
     RUN_TEST_CASE( AiaJsonMessageTests, BuildMessageWithExactBufferSize );
     RUN_TEST_CASE( AiaJsonMessageTests, BuildMessageWithInsufficientBuffer );
     RUN_TEST_CASE( AiaJsonMessageTests, BuildMessageWithoutBuffer );
+    RUN_TEST_CASE( AiaJsonMessageTests, BuildMessageMatchesGetSize );
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+    RUN_TEST_CASE( AiaJsonMessageTests, BuildMessageAfterSerialize );
+    RUN_TEST_CASE( AiaJsonMessageTests, SerializeWithoutMessage );
+#endif
 }
 
 /*-----------------------------------------------------------*/
@@ -337,3 +342,56 @@ TEST( AiaJsonMessageTests, BuildMessageWithoutBuffer )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaJsonMessageTests, BuildMessageMatchesGetSize )
+{
+    static const char* EXPECTED_MESSAGE =
+        "{\"header\":{\"name\":\"TestMessageName\","
+        "\"messageId\":\"TestMessageId\"},"
+        "\"payload\":{\"" TEST_PAYLOAD_KEY "\":\"" TEST_PAYLOAD_VALUE "\"}}";
+    AiaJsonMessage_t* jsonMessage =
+        AiaJsonMessage_Create( TEST_NAME, TEST_MESSAGE_ID, TEST_PAYLOAD );
+    TEST_ASSERT_EQUAL(
+        strlen( EXPECTED_MESSAGE ),
+        AiaMessage_GetSize( AiaJsonMessage_ToConstMessage( jsonMessage ) ) );
+    char messageBuffer[ 1024 ];
+    TEST_ASSERT_TRUE( AiaJsonMessage_BuildMessage( jsonMessage, messageBuffer,
+                                                   sizeof( messageBuffer ) ) );
+    TEST_ASSERT_EQUAL_STRING( EXPECTED_MESSAGE, messageBuffer );
+
+    AiaJsonMessage_Destroy( jsonMessage );
+}
+
+/*-----------------------------------------------------------*/
+
+#ifdef AIA_ENABLE_PRESERIALIZED_CHUNKS
+TEST( AiaJsonMessageTests, BuildMessageAfterSerialize )
+{
+    AiaJsonMessage_t* jsonMessage =
+        AiaJsonMessage_Create( TEST_NAME, TEST_MESSAGE_ID, TEST_PAYLOAD );
+    char expectedBuffer[ 1024 ];
+    TEST_ASSERT_TRUE( AiaJsonMessage_BuildMessage( jsonMessage, expectedBuffer,
+                                                   sizeof( expectedBuffer ) ) );
+
+    TEST_ASSERT_TRUE( AiaJsonMessage_Serialize( jsonMessage ) );
+    TEST_ASSERT_TRUE( AiaJsonMessage_Serialize( jsonMessage ) );
+    char messageBuffer[ 1024 ];
+    TEST_ASSERT_TRUE( AiaJsonMessage_BuildMessage( jsonMessage, messageBuffer,
+                                                   sizeof( messageBuffer ) ) );
+    TEST_ASSERT_EQUAL_STRING( expectedBuffer, messageBuffer );
+
+    size_t size =
+        AiaMessage_GetSize( AiaJsonMessage_ToConstMessage( jsonMessage ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonMessage_BuildMessage( jsonMessage, messageBuffer, size - 1 ) );
+
+    AiaJsonMessage_Destroy( jsonMessage );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonMessageTests, SerializeWithoutMessage )
+{
+    TEST_ASSERT_FALSE( AiaJsonMessage_Serialize( NULL ) );
+}
+#endif
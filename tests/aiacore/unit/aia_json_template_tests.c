@@ -0,0 +1,163 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_json_template_tests.c
+ * @brief Tests for AiaJsonTemplate_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+/* AiaJsonTemplate_t headers */
+#include <aiacore/aia_json_message.h>
+#include <aiacore/aia_json_template.h>
+#include <aiacore/aia_mbedtls_threading.h>
+#include <aiacore/aia_random_mbedtls.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+/* Standard library includes. */
+#include <string.h>
+
+/*-----------------------------------------------------------*/
+
+/** Sample JSON message name. */
+static const char* TEST_NAME = "TestMessageName";
+
+/** Sample payload segments with two fields. */
+static const AiaJsonTemplateSegment_t TEST_SEGMENTS[] = {
+    AIA_JSON_TEMPLATE_SEGMENT( "{\"first\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( ",\"second\":" ),
+    AIA_JSON_TEMPLATE_SEGMENT( "}" )
+};
+
+/** Salt used to seed the random message IDs. */
+static const char* TEST_SALT = "TestSalt";
+
+/** Length of @c TEST_SALT. */
+static const size_t TEST_SALT_LENGTH = sizeof( TEST_SALT ) - 1;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaJsonTemplate_t tests.
+ */
+TEST_GROUP( AiaJsonTemplateTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaJsonTemplate_t tests.
+ */
+TEST_SETUP( AiaJsonTemplateTests )
+{
+    AiaMbedtlsThreading_Init();
+    AiaRandomMbedtls_Init();
+    TEST_ASSERT_TRUE( AiaRandomMbedtls_Seed( TEST_SALT, TEST_SALT_LENGTH ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaJsonTemplate_t tests.
+ */
+TEST_TEAR_DOWN( AiaJsonTemplateTests )
+{
+    AiaMbedtlsThreading_Cleanup();
+    AiaRandomMbedtls_Cleanup();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaJsonTemplate_t tests.
+ */
+TEST_GROUP_RUNNER( AiaJsonTemplateTests )
+{
+    RUN_TEST_CASE( AiaJsonTemplateTests, RenderFields );
+    RUN_TEST_CASE( AiaJsonTemplateTests, RenderFieldLimits );
+    RUN_TEST_CASE( AiaJsonTemplateTests, RenderWithInsufficientBuffer );
+    RUN_TEST_CASE( AiaJsonTemplateTests, CreateMessage );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonTemplateTests, RenderFields )
+{
+    static const AiaJsonTemplate_t TEMPLATE = { NULL, TEST_SEGMENTS, 2 };
+    const uint64_t fields[] = { 42, 1234567 };
+    char buffer[ 64 ];
+    static const char* EXPECTED = "{\"first\":42,\"second\":1234567}";
+    TEST_ASSERT_EQUAL(
+        strlen( EXPECTED ),
+        AiaJsonTemplate_Render( &TEMPLATE, fields, buffer, sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL_STRING( EXPECTED, buffer );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonTemplateTests, RenderFieldLimits )
+{
+    static const AiaJsonTemplate_t TEMPLATE = { NULL, TEST_SEGMENTS, 2 };
+    const uint64_t fields[] = { 0, UINT64_MAX };
+    char buffer[ 64 ];
+    static const char* EXPECTED =
+        "{\"first\":0,\"second\":18446744073709551615}";
+    TEST_ASSERT_EQUAL(
+        strlen( EXPECTED ),
+        AiaJsonTemplate_Render( &TEMPLATE, fields, buffer, sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL_STRING( EXPECTED, buffer );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonTemplateTests, RenderWithInsufficientBuffer )
+{
+    static const AiaJsonTemplate_t TEMPLATE = { NULL, TEST_SEGMENTS, 2 };
+    const uint64_t fields[] = { 42, 1234567 };
+    static const char* EXPECTED = "{\"first\":42,\"second\":1234567}";
+    char buffer[ 64 ];
+
+    /* There must also be room for the '\0'. */
+    TEST_ASSERT_EQUAL( 0, AiaJsonTemplate_Render( &TEMPLATE, fields, buffer,
+                                                  strlen( EXPECTED ) ) );
+    TEST_ASSERT_EQUAL( 0, AiaJsonTemplate_Render( &TEMPLATE, fields, buffer,
+                                                  strlen( "{\"first\":4" ) ) );
+    TEST_ASSERT_EQUAL( strlen( EXPECTED ),
+                       AiaJsonTemplate_Render( &TEMPLATE, fields, buffer,
+                                               strlen( EXPECTED ) + 1 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonTemplateTests, CreateMessage )
+{
+    static const AiaJsonTemplate_t TEMPLATE = { "TestMessageName",
+                                                TEST_SEGMENTS, 2 };
+    const uint64_t fields[] = { 1, 2 };
+    AiaJsonMessage_t* jsonMessage =
+        AiaJsonTemplate_CreateMessage( &TEMPLATE, fields );
+    TEST_ASSERT_NOT_NULL( jsonMessage );
+    TEST_ASSERT_EQUAL_STRING( TEST_NAME,
+                              AiaJsonMessage_GetName( jsonMessage ) );
+    TEST_ASSERT_EQUAL_STRING( "{\"first\":1,\"second\":2}",
+                              AiaJsonMessage_GetJsonPayload( jsonMessage ) );
+    AiaJsonMessage_Destroy( jsonMessage );
+}
+
+/*-----------------------------------------------------------*/
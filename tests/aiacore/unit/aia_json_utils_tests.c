@@ -23,12 +23,14 @@
 #include <aia_config.h>
 
 #include <aiacore/aia_json_utils.h>
+#include <aiacore/aia_utils.h>
 
 /* Test framework includes. */
 #include <unity_fixture.h>
 
 /* Standard library includes. */
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -89,9 +91,22 @@ TEST_GROUP_RUNNER( AiaJsonUtilsTests )
     RUN_TEST_CASE( AiaJsonUtilsTests, GetArrayElementAfterNestedObject );
     RUN_TEST_CASE( AiaJsonUtilsTests, GetArrayElementObject );
     RUN_TEST_CASE( AiaJsonUtilsTests, GetArrayElementInvalidArray );
+    RUN_TEST_CASE( AiaJsonUtilsTests, GetArrayElementAfterQuotedDelimiters );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorWithNullArgs );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorAllElements );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorEmptyArray );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorQuotedStrings );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorDelimitersAtEveryOffset );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ArrayIteratorMalformedArray );
     RUN_TEST_CASE( AiaJsonUtilsTests, ExtractLong );
     RUN_TEST_CASE( AiaJsonUtilsTests, ExtractLongWithInvalidLong );
     RUN_TEST_CASE( AiaJsonUtilsTests, ExtractLongWithNullArgs );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectWithNullArgs );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectAllMembers );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectEmptyObject );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectMalformedObject );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectTooManyMembers );
+    RUN_TEST_CASE( AiaJsonUtilsTests, ObjectExtractLong );
 }
 
 /*-----------------------------------------------------------*/
@@ -287,6 +302,176 @@ TEST( AiaJsonUtilsTests, GetArrayElementInvalidArray )
 
 /*-----------------------------------------------------------*/
 
+TEST( AiaJsonUtilsTests, GetArrayElementAfterQuotedDelimiters )
+{
+    const char jsonArray[] = "[\"a,]\",\"{b\",c]";
+    const char* jsonValue;
+    size_t jsonValueLength;
+    size_t index = 2;
+    TEST_ASSERT_TRUE(
+        AiaJsonUtils_GetArrayElement( jsonArray, sizeof( jsonArray ) - 1, index,
+                                      &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_EQUAL( 1, jsonValueLength );
+    TEST_ASSERT_EQUAL( 'c', *jsonValue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorWithNullArgs )
+{
+    const char jsonArray[] = "[a]";
+    AiaJsonArrayIterator_t iterator;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_FALSE( AiaJsonArrayIterator_Initialize(
+        NULL, jsonArray, sizeof( jsonArray ) - 1 ) );
+    TEST_ASSERT_FALSE( AiaJsonArrayIterator_Initialize(
+        &iterator, NULL, sizeof( jsonArray ) - 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Initialize( &iterator, jsonArray, 0 ) );
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, jsonArray, sizeof( jsonArray ) - 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( NULL, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, NULL, &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorAllElements )
+{
+    const char jsonArray[] = "[ a, [b,b] ,{c,c},d ]";
+    const char* expected[] = { "a", "[b,b]", "{c,c}", "d" };
+    AiaJsonArrayIterator_t iterator;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, jsonArray, sizeof( jsonArray ) - 1 ) );
+    for( size_t index = 0; index < sizeof( expected ) / sizeof( expected[ 0 ] );
+         ++index )
+    {
+        TEST_ASSERT_TRUE( AiaJsonArrayIterator_Next( &iterator, &jsonValue,
+                                                     &jsonValueLength ) );
+        TEST_ASSERT_EQUAL( strlen( expected[ index ] ), jsonValueLength );
+        TEST_ASSERT_EQUAL_STRING_LEN( expected[ index ], jsonValue,
+                                      jsonValueLength );
+    }
+    TEST_ASSERT_TRUE( iterator.complete );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_TRUE( iterator.complete );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorEmptyArray )
+{
+    const char jsonArray[] = "[ ]";
+    AiaJsonArrayIterator_t iterator;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, jsonArray, sizeof( jsonArray ) - 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_TRUE( iterator.complete );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorQuotedStrings )
+{
+    const char jsonArray[] = "[\"a,b\",{\"c\":\"}]\\\"\"},\"d\"]";
+    const char* expected[] = { "\"a,b\"", "{\"c\":\"}]\\\"\"}", "\"d\"" };
+    AiaJsonArrayIterator_t iterator;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, jsonArray, sizeof( jsonArray ) - 1 ) );
+    for( size_t index = 0; index < sizeof( expected ) / sizeof( expected[ 0 ] );
+         ++index )
+    {
+        TEST_ASSERT_TRUE( AiaJsonArrayIterator_Next( &iterator, &jsonValue,
+                                                     &jsonValueLength ) );
+        TEST_ASSERT_EQUAL( strlen( expected[ index ] ), jsonValueLength );
+        TEST_ASSERT_EQUAL_STRING_LEN( expected[ index ], jsonValue,
+                                      jsonValueLength );
+    }
+    TEST_ASSERT_TRUE( iterator.complete );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorDelimitersAtEveryOffset )
+{
+    /* Elements are classified in blocks of 64 bytes, so shift quotes, escapes
+     * and brackets across every position of a block and past its end. */
+    static const char PADDING[] =
+        "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+        "0123456789";
+    for( int padding = 0; padding < (int)sizeof( PADDING ); ++padding )
+    {
+        char first[ 128 ];
+        char second[ 128 ];
+        char jsonArray[ 272 ];
+        snprintf( first, sizeof( first ), "\"%.*s\\\"],\"", padding,
+                  PADDING );
+        snprintf( second, sizeof( second ), "{\"k\":[1,\"]\"],\"p\":\"%.*s\"}",
+                  padding, PADDING );
+        snprintf( jsonArray, sizeof( jsonArray ), "[%s , %s ]", first, second );
+
+        AiaJsonArrayIterator_t iterator;
+        const char* jsonValue;
+        size_t jsonValueLength;
+        TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+            &iterator, jsonArray, strlen( jsonArray ) ) );
+        TEST_ASSERT_TRUE( AiaJsonArrayIterator_Next( &iterator, &jsonValue,
+                                                     &jsonValueLength ) );
+        TEST_ASSERT_EQUAL( strlen( first ), jsonValueLength );
+        TEST_ASSERT_EQUAL_STRING_LEN( first, jsonValue, jsonValueLength );
+        TEST_ASSERT_TRUE( AiaJsonArrayIterator_Next( &iterator, &jsonValue,
+                                                     &jsonValueLength ) );
+        TEST_ASSERT_EQUAL( strlen( second ), jsonValueLength );
+        TEST_ASSERT_EQUAL_STRING_LEN( second, jsonValue, jsonValueLength );
+        TEST_ASSERT_TRUE( iterator.complete );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ArrayIteratorMalformedArray )
+{
+    const char unterminatedArray[] = "[a,b";
+    const char unbalancedArray[] = "[a,b}]";
+    AiaJsonArrayIterator_t iterator;
+    const char* jsonValue;
+    size_t jsonValueLength;
+
+    TEST_ASSERT_FALSE( AiaJsonArrayIterator_Initialize(
+        &iterator, "a,b]", sizeof( "a,b]" ) - 1 ) );
+
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, unterminatedArray, sizeof( unterminatedArray ) - 1 ) );
+    TEST_ASSERT_TRUE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE( iterator.complete );
+
+    TEST_ASSERT_TRUE( AiaJsonArrayIterator_Initialize(
+        &iterator, unbalancedArray, sizeof( unbalancedArray ) - 1 ) );
+    TEST_ASSERT_TRUE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonArrayIterator_Next( &iterator, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE( iterator.complete );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( AiaJsonUtilsTests, ExtractLong )
 {
     static const char* payload = "{\"testKey\": 100}";
@@ -323,3 +508,129 @@ TEST( AiaJsonUtilsTests, ExtractLongWithNullArgs )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectWithNullArgs )
+{
+    const char jsonObject[] = "{\"a\":1}";
+    AiaJsonObject_t object;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_FALSE(
+        AiaJsonObject_Parse( NULL, jsonObject, sizeof( jsonObject ) - 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonObject_Parse( &object, NULL, sizeof( jsonObject ) - 1 ) );
+    TEST_ASSERT_TRUE(
+        AiaJsonObject_Parse( &object, jsonObject, sizeof( jsonObject ) - 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonObject_FindValue( NULL, "a", 1, &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_FALSE( AiaJsonObject_FindValue( &object, NULL, 1, &jsonValue,
+                                                &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonObject_FindValue( &object, "a", 1, NULL, &jsonValueLength ) );
+    TEST_ASSERT_FALSE(
+        AiaJsonObject_FindValue( &object, "a", 1, &jsonValue, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectAllMembers )
+{
+    const char jsonObject[] =
+        " { \"token\" : \"a,}\\\"b\" , \"time\":12,\"nested\":{\"time\":[1,2]},"
+        "\"list\": [ {} ] } ";
+    const char* expectedKeys[] = { "token", "time", "nested", "list" };
+    const char* expectedValues[] = { "\"a,}\\\"b\"", "12",
+                                     "{\"time\":[1,2]}", "[ {} ]" };
+    AiaJsonObject_t object;
+    const char* jsonValue;
+    size_t jsonValueLength;
+    TEST_ASSERT_TRUE(
+        AiaJsonObject_Parse( &object, jsonObject, sizeof( jsonObject ) - 1 ) );
+    TEST_ASSERT_EQUAL( AiaArrayLength( expectedKeys ), object.numMembers );
+    for( size_t index = 0; index < AiaArrayLength( expectedKeys ); ++index )
+    {
+        TEST_ASSERT_TRUE( AiaJsonObject_FindValue(
+            &object, expectedKeys[ index ], strlen( expectedKeys[ index ] ),
+            &jsonValue, &jsonValueLength ) );
+        TEST_ASSERT_EQUAL( strlen( expectedValues[ index ] ), jsonValueLength );
+        TEST_ASSERT_EQUAL_STRING_LEN( expectedValues[ index ], jsonValue,
+                                      jsonValueLength );
+    }
+
+    /* Only top-level members are indexed. */
+    TEST_ASSERT_TRUE(
+        AiaJsonObject_FindValue( &object, "time", sizeof( "time" ) - 1,
+                                 &jsonValue, &jsonValueLength ) );
+    TEST_ASSERT_EQUAL_STRING_LEN( "12", jsonValue, jsonValueLength );
+    TEST_ASSERT_FALSE( AiaJsonObject_FindValue(
+        &object, "tim", sizeof( "tim" ) - 1, &jsonValue, &jsonValueLength ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectEmptyObject )
+{
+    const char jsonObject[] = "{ }";
+    AiaJsonObject_t object;
+    TEST_ASSERT_TRUE(
+        AiaJsonObject_Parse( &object, jsonObject, sizeof( jsonObject ) - 1 ) );
+    TEST_ASSERT_EQUAL( 0, object.numMembers );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectMalformedObject )
+{
+    const char* malformedObjects[] = {
+        "",          "[1]",          "{\"a\":1",   "{\"a\" 1}",
+        "{a:1}",     "{\"a\":}",     "{\"a\":1,}", "{\"a\":[1}",
+        "{\"a\":1]}", "{\"a\":\"1}"
+    };
+    AiaJsonObject_t object;
+    for( size_t index = 0; index < AiaArrayLength( malformedObjects );
+         ++index )
+    {
+        TEST_ASSERT_FALSE( AiaJsonObject_Parse(
+            &object, malformedObjects[ index ],
+            strlen( malformedObjects[ index ] ) ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectTooManyMembers )
+{
+    char jsonObject[ 8 * ( AIA_JSON_OBJECT_MAX_MEMBERS + 1 ) + 2 ];
+    size_t length = 0;
+    jsonObject[ length++ ] = '{';
+    for( size_t index = 0; index <= AIA_JSON_OBJECT_MAX_MEMBERS; ++index )
+    {
+        length += snprintf( jsonObject + length, sizeof( jsonObject ) - length,
+                            "%s\"%02zu\":1", index ? "," : "", index );
+    }
+    jsonObject[ length++ ] = '}';
+    AiaJsonObject_t object;
+    TEST_ASSERT_FALSE( AiaJsonObject_Parse( &object, jsonObject, length ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaJsonUtilsTests, ObjectExtractLong )
+{
+    static const char* payload = "{\"testKey\": 100, \"badKey\": \"abc\"}";
+    AiaJsonObject_t object;
+    AiaJsonLongType out;
+    TEST_ASSERT_TRUE(
+        AiaJsonObject_Parse( &object, payload, strlen( payload ) ) );
+    TEST_ASSERT_TRUE( AiaJsonObject_ExtractLong(
+        &object, "testKey", sizeof( "testKey" ) - 1, &out ) );
+    TEST_ASSERT_EQUAL( out, 100 );
+    TEST_ASSERT_FALSE( AiaJsonObject_ExtractLong(
+        &object, "badKey", sizeof( "badKey" ) - 1, &out ) );
+    TEST_ASSERT_FALSE( AiaJsonObject_ExtractLong(
+        &object, "noKey", sizeof( "noKey" ) - 1, &out ) );
+    TEST_ASSERT_FALSE( AiaJsonObject_ExtractLong(
+        &object, "testKey", sizeof( "testKey" ) - 1, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
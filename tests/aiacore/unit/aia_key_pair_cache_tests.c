@@ -0,0 +1,191 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_key_pair_cache_tests.c
+ * @brief Tests for AiaKeyPairCache_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_crypto_mbedtls.h>
+#include <aiacore/aia_key_pair_cache.h>
+#include <aiacore/aia_mbedtls_threading.h>
+
+#include AiaClock( HEADER )
+#include AiaTaskPool( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+#define TEST_SECRET_DERIVATION_ALG AIA_ECDH_CURVE_25519_32_BYTE
+#define TEST_GENERATED_KEY_LEN 32
+#define TEST_SHARED_SECRET_LEN 32
+
+/** Short enough that the background generation runs during the tests. */
+#define TEST_DELAY_MS 10
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaKeyPairCache_t tests.
+ */
+TEST_GROUP( AiaKeyPairCacheTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaKeyPairCache_t tests.
+ */
+TEST_SETUP( AiaKeyPairCacheTests )
+{
+    AiaMbedtlsThreading_Init();
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_Init() );
+
+    AiaTaskPoolInfo_t taskpoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskpoolInfo );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( error ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaKeyPairCache_t tests.
+ */
+TEST_TEAR_DOWN( AiaKeyPairCacheTests )
+{
+    AiaTaskPoolError_t error =
+        AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( error ) );
+
+    AiaCryptoMbedtls_Cleanup();
+    AiaMbedtlsThreading_Cleanup();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaKeyPairCache_t tests.
+ */
+TEST_GROUP_RUNNER( AiaKeyPairCacheTests )
+{
+    RUN_TEST_CASE( AiaKeyPairCacheTests, CreateWithInvalidArguments );
+    RUN_TEST_CASE( AiaKeyPairCacheTests, TakeWithInvalidArguments );
+    RUN_TEST_CASE( AiaKeyPairCacheTests, TakenPairsAreDistinctAndValid );
+    RUN_TEST_CASE( AiaKeyPairCacheTests, DestroyWhileGenerating );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaKeyPairCacheTests, CreateWithInvalidArguments )
+{
+    TEST_ASSERT_NULL( AiaKeyPairCache_Create(
+        NULL, TEST_SECRET_DERIVATION_ALG, TEST_GENERATED_KEY_LEN,
+        TEST_GENERATED_KEY_LEN, TEST_DELAY_MS ) );
+    TEST_ASSERT_NULL( AiaKeyPairCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_SECRET_DERIVATION_ALG, 0,
+        TEST_GENERATED_KEY_LEN, TEST_DELAY_MS ) );
+    TEST_ASSERT_NULL( AiaKeyPairCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_SECRET_DERIVATION_ALG,
+        TEST_GENERATED_KEY_LEN, 0, TEST_DELAY_MS ) );
+}
+
+TEST( AiaKeyPairCacheTests, TakeWithInvalidArguments )
+{
+    uint8_t privateKey[ TEST_GENERATED_KEY_LEN ];
+    uint8_t publicKey[ TEST_GENERATED_KEY_LEN ];
+    AiaKeyPairCache_t* cache = AiaKeyPairCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_SECRET_DERIVATION_ALG,
+        sizeof( privateKey ), sizeof( publicKey ), TEST_DELAY_MS );
+    TEST_ASSERT_NOT_NULL( cache );
+
+    TEST_ASSERT_FALSE( AiaKeyPairCache_Take( NULL, privateKey,
+                                             sizeof( privateKey ), publicKey,
+                                             sizeof( publicKey ) ) );
+    TEST_ASSERT_FALSE( AiaKeyPairCache_Take(
+        cache, NULL, sizeof( privateKey ), publicKey, sizeof( publicKey ) ) );
+    TEST_ASSERT_FALSE( AiaKeyPairCache_Take(
+        cache, privateKey, sizeof( privateKey ), NULL, sizeof( publicKey ) ) );
+    TEST_ASSERT_FALSE( AiaKeyPairCache_Take(
+        cache, privateKey, sizeof( privateKey ) - 1, publicKey,
+        sizeof( publicKey ) ) );
+    TEST_ASSERT_FALSE( AiaKeyPairCache_Take( cache, privateKey,
+                                             sizeof( privateKey ), publicKey,
+                                             sizeof( publicKey ) + 1 ) );
+
+    AiaKeyPairCache_Destroy( cache );
+}
+
+TEST( AiaKeyPairCacheTests, TakenPairsAreDistinctAndValid )
+{
+    uint8_t privateKey[ TEST_GENERATED_KEY_LEN ];
+    uint8_t publicKey[ TEST_GENERATED_KEY_LEN ];
+    uint8_t otherPrivateKey[ TEST_GENERATED_KEY_LEN ];
+    uint8_t otherPublicKey[ TEST_GENERATED_KEY_LEN ];
+    AiaKeyPairCache_t* cache = AiaKeyPairCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_SECRET_DERIVATION_ALG,
+        sizeof( privateKey ), sizeof( publicKey ), TEST_DELAY_MS );
+    TEST_ASSERT_NOT_NULL( cache );
+
+    /* The first pair is taken whether or not it was generated in the
+     * background yet, and the second one after it had time to be. */
+    TEST_ASSERT_TRUE( AiaKeyPairCache_Take( cache, privateKey,
+                                            sizeof( privateKey ), publicKey,
+                                            sizeof( publicKey ) ) );
+    AiaClock( SleepMs( TEST_DELAY_MS * 10 ) );
+    TEST_ASSERT_TRUE( AiaKeyPairCache_Take(
+        cache, otherPrivateKey, sizeof( otherPrivateKey ), otherPublicKey,
+        sizeof( otherPublicKey ) ) );
+    TEST_ASSERT_NOT_EQUAL(
+        0, memcmp( privateKey, otherPrivateKey, sizeof( privateKey ) ) );
+    TEST_ASSERT_NOT_EQUAL(
+        0, memcmp( publicKey, otherPublicKey, sizeof( publicKey ) ) );
+
+    /* Both pairs must derive the same secret from each other's public key. */
+    uint8_t sharedSecret[ TEST_SHARED_SECRET_LEN ];
+    uint8_t otherSharedSecret[ TEST_SHARED_SECRET_LEN ];
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_CalculateSharedSecret(
+        privateKey, sizeof( privateKey ), otherPublicKey,
+        sizeof( otherPublicKey ), TEST_SECRET_DERIVATION_ALG, sharedSecret,
+        sizeof( sharedSecret ) ) );
+    TEST_ASSERT_TRUE( AiaCryptoMbedtls_CalculateSharedSecret(
+        otherPrivateKey, sizeof( otherPrivateKey ), publicKey,
+        sizeof( publicKey ), TEST_SECRET_DERIVATION_ALG, otherSharedSecret,
+        sizeof( otherSharedSecret ) ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( sharedSecret, otherSharedSecret,
+                                   sizeof( sharedSecret ) );
+
+    AiaKeyPairCache_Destroy( cache );
+}
+
+TEST( AiaKeyPairCacheTests, DestroyWhileGenerating )
+{
+    /* Destroying a cache must cancel or wait for the pending generation,
+     * whichever state it is in. */
+    for( AiaDurationMs_t delayMs = 0; delayMs < 3; ++delayMs )
+    {
+        AiaKeyPairCache_t* cache = AiaKeyPairCache_Create(
+            AiaTaskPool( GetSystemTaskPool )(), TEST_SECRET_DERIVATION_ALG,
+            TEST_GENERATED_KEY_LEN, TEST_GENERATED_KEY_LEN, delayMs );
+        TEST_ASSERT_NOT_NULL( cache );
+        AiaClock( SleepMs( delayMs ) );
+        AiaKeyPairCache_Destroy( cache );
+    }
+}
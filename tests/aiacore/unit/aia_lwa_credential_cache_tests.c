@@ -0,0 +1,197 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_lwa_credential_cache_tests.c
+ * @brief Tests for AiaLwaCredentialCache_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_lwa_credential_cache.h>
+
+#include AiaClock( HEADER )
+#include AiaTaskPool( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+/** Short enough that background refreshes run during the tests. */
+#define TEST_REFRESH_INTERVAL_MS 10
+
+/** Long enough that nothing expires or is refreshed during the tests. */
+#define TEST_LONG_DURATION_MS 1000000
+
+/** Credentials read by the LWA port. */
+extern char* g_aiaLwaRefreshToken;
+extern char* g_aiaLwaClientId;
+
+/** Values of the LWA port credentials before the tests. */
+static char* g_savedRefreshToken;
+static char* g_savedLwaClientId;
+
+static char TEST_REFRESH_TOKEN[] = "Atzr|refreshToken";
+static char TEST_OTHER_REFRESH_TOKEN[] = "Atzr|otherRefreshToken";
+static char TEST_LWA_CLIENT_ID[] = "amzn1.application-oa2-client.test";
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaLwaCredentialCache_t tests.
+ */
+TEST_GROUP( AiaLwaCredentialCacheTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaLwaCredentialCache_t tests.
+ */
+TEST_SETUP( AiaLwaCredentialCacheTests )
+{
+    AiaTaskPoolInfo_t taskpoolInfo = AiaTaskPool( INFO_INITIALIZER );
+    AiaTaskPoolError_t error =
+        AiaTaskPool( CreateSystemTaskPool )( &taskpoolInfo );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( error ) );
+
+    g_savedRefreshToken = g_aiaLwaRefreshToken;
+    g_savedLwaClientId = g_aiaLwaClientId;
+    g_aiaLwaRefreshToken = TEST_REFRESH_TOKEN;
+    g_aiaLwaClientId = TEST_LWA_CLIENT_ID;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaLwaCredentialCache_t tests.
+ */
+TEST_TEAR_DOWN( AiaLwaCredentialCacheTests )
+{
+    g_aiaLwaRefreshToken = g_savedRefreshToken;
+    g_aiaLwaClientId = g_savedLwaClientId;
+
+    AiaTaskPoolError_t error =
+        AiaTaskPool( Destroy )( AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( error ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaLwaCredentialCache_t tests.
+ */
+TEST_GROUP_RUNNER( AiaLwaCredentialCacheTests )
+{
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, CreateWithInvalidArguments );
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, LoadCopiesPortCredentials );
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, GetWithNullCache );
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, CachedCredentialsAreReused );
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, RefreshedInBackground );
+    RUN_TEST_CASE( AiaLwaCredentialCacheTests, DestroyWhileRefreshing );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaLwaCredentialCacheTests, CreateWithInvalidArguments )
+{
+    TEST_ASSERT_NULL( AiaLwaCredentialCache_Create(
+        NULL, TEST_REFRESH_INTERVAL_MS, TEST_LONG_DURATION_MS ) );
+    TEST_ASSERT_NULL( AiaLwaCredentialCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), 0, TEST_LONG_DURATION_MS ) );
+    TEST_ASSERT_NULL( AiaLwaCredentialCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_REFRESH_INTERVAL_MS,
+        TEST_REFRESH_INTERVAL_MS - 1 ) );
+}
+
+TEST( AiaLwaCredentialCacheTests, LoadCopiesPortCredentials )
+{
+    AiaLwaCredentials_t* credentials = AiaLwaCredentials_Load();
+    TEST_ASSERT_NOT_NULL( credentials );
+    TEST_ASSERT_EQUAL_STRING( TEST_REFRESH_TOKEN, credentials->refreshToken );
+    TEST_ASSERT_EQUAL( sizeof( TEST_REFRESH_TOKEN ),
+                       credentials->refreshTokenLen );
+    TEST_ASSERT_EQUAL_STRING( TEST_LWA_CLIENT_ID, credentials->lwaClientId );
+    TEST_ASSERT_EQUAL( sizeof( TEST_LWA_CLIENT_ID ),
+                       credentials->lwaClientIdLen );
+    AiaLwaCredentials_Destroy( credentials );
+}
+
+TEST( AiaLwaCredentialCacheTests, GetWithNullCache )
+{
+    TEST_ASSERT_NULL( AiaLwaCredentialCache_Get( NULL ) );
+}
+
+TEST( AiaLwaCredentialCacheTests, CachedCredentialsAreReused )
+{
+    AiaLwaCredentialCache_t* cache = AiaLwaCredentialCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_LONG_DURATION_MS,
+        TEST_LONG_DURATION_MS );
+    TEST_ASSERT_NOT_NULL( cache );
+
+    AiaLwaCredentials_t* credentials = AiaLwaCredentialCache_Get( cache );
+    TEST_ASSERT_NOT_NULL( credentials );
+    TEST_ASSERT_EQUAL_STRING( TEST_REFRESH_TOKEN, credentials->refreshToken );
+    AiaLwaCredentials_Destroy( credentials );
+
+    /* Until they expire, credentials are not read from the port again. */
+    g_aiaLwaRefreshToken = TEST_OTHER_REFRESH_TOKEN;
+    credentials = AiaLwaCredentialCache_Get( cache );
+    TEST_ASSERT_NOT_NULL( credentials );
+    TEST_ASSERT_EQUAL_STRING( TEST_REFRESH_TOKEN, credentials->refreshToken );
+    TEST_ASSERT_EQUAL_STRING( TEST_LWA_CLIENT_ID, credentials->lwaClientId );
+    AiaLwaCredentials_Destroy( credentials );
+
+    AiaLwaCredentialCache_Destroy( cache );
+}
+
+TEST( AiaLwaCredentialCacheTests, RefreshedInBackground )
+{
+    AiaLwaCredentialCache_t* cache = AiaLwaCredentialCache_Create(
+        AiaTaskPool( GetSystemTaskPool )(), TEST_REFRESH_INTERVAL_MS,
+        TEST_LONG_DURATION_MS );
+    TEST_ASSERT_NOT_NULL( cache );
+
+    AiaLwaCredentials_t* credentials = AiaLwaCredentialCache_Get( cache );
+    TEST_ASSERT_NOT_NULL( credentials );
+    TEST_ASSERT_EQUAL_STRING( TEST_REFRESH_TOKEN, credentials->refreshToken );
+    AiaLwaCredentials_Destroy( credentials );
+
+    g_aiaLwaRefreshToken = TEST_OTHER_REFRESH_TOKEN;
+    AiaClock( SleepMs( TEST_REFRESH_INTERVAL_MS * 10 ) );
+    credentials = AiaLwaCredentialCache_Get( cache );
+    TEST_ASSERT_NOT_NULL( credentials );
+    TEST_ASSERT_EQUAL_STRING( TEST_OTHER_REFRESH_TOKEN,
+                              credentials->refreshToken );
+    AiaLwaCredentials_Destroy( credentials );
+
+    AiaLwaCredentialCache_Destroy( cache );
+}
+
+TEST( AiaLwaCredentialCacheTests, DestroyWhileRefreshing )
+{
+    /* Destroying a cache must cancel or wait for the pending refresh,
+     * whichever state it is in. */
+    for( AiaDurationMs_t sleepMs = 0; sleepMs < 3; ++sleepMs )
+    {
+        AiaLwaCredentialCache_t* cache = AiaLwaCredentialCache_Create(
+            AiaTaskPool( GetSystemTaskPool )(), 1, TEST_LONG_DURATION_MS );
+        TEST_ASSERT_NOT_NULL( cache );
+        AiaClock( SleepMs( sleepMs ) );
+        AiaLwaCredentialCache_Destroy( cache );
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_budget_tests.c
+ * @brief Tests for AiaMemoryBudget_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_memory_budget.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+/** The limit of budgets used by tests. */
+#define TEST_LIMIT_BYTES 100
+
+/** The budget used by tests. */
+static AiaMemoryBudget_t* g_budget;
+
+/** Usage of @c g_budget. */
+static AiaMemoryBudgetMetrics_t g_metrics;
+
+/** Reads the usage of @c g_budget into @c g_metrics. */
+static void getMetrics()
+{
+    AiaMemoryBudget_GetMetrics( g_budget, &g_metrics );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaMemoryBudget tests.
+ */
+TEST_GROUP( AiaMemoryBudgetTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaMemoryBudget tests.
+ */
+TEST_SETUP( AiaMemoryBudgetTests )
+{
+    g_budget = AiaMemoryBudget_Create( TEST_LIMIT_BYTES );
+    TEST_ASSERT_NOT_NULL( g_budget );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaMemoryBudget tests.
+ */
+TEST_TEAR_DOWN( AiaMemoryBudgetTests )
+{
+    AiaMemoryBudget_Destroy( g_budget );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaMemoryBudget tests.
+ */
+TEST_GROUP_RUNNER( AiaMemoryBudgetTests )
+{
+    RUN_TEST_CASE( AiaMemoryBudgetTests, CreateWithZeroLimit );
+    RUN_TEST_CASE( AiaMemoryBudgetTests, ChargeUpToLimit );
+    RUN_TEST_CASE( AiaMemoryBudgetTests, ChargeOverLimitIsRefused );
+    RUN_TEST_CASE( AiaMemoryBudgetTests, ReleaseMakesRoom );
+    RUN_TEST_CASE( AiaMemoryBudgetTests, ForceChargeOverLimit );
+    RUN_TEST_CASE( AiaMemoryBudgetTests, PeakIsKept );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaMemoryBudgetTests, CreateWithZeroLimit )
+{
+    TEST_ASSERT_NULL( AiaMemoryBudget_Create( 0 ) );
+}
+
+TEST( AiaMemoryBudgetTests, ChargeUpToLimit )
+{
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 40 ) );
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 60 ) );
+    getMetrics();
+    TEST_ASSERT_EQUAL_UINT32( TEST_LIMIT_BYTES, g_metrics.limitBytes );
+    TEST_ASSERT_EQUAL_UINT32( 100, g_metrics.usedBytes );
+    TEST_ASSERT_EQUAL_UINT32( 0, g_metrics.refusals );
+    AiaMemoryBudget_Release( g_budget, 100 );
+}
+
+TEST( AiaMemoryBudgetTests, ChargeOverLimitIsRefused )
+{
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 60 ) );
+    TEST_ASSERT_FALSE( AiaMemoryBudget_Charge( g_budget, 41 ) );
+    TEST_ASSERT_FALSE( AiaMemoryBudget_Charge( g_budget, SIZE_MAX ) );
+    getMetrics();
+    TEST_ASSERT_EQUAL_UINT32( 60, g_metrics.usedBytes );
+    TEST_ASSERT_EQUAL_UINT32( 2, g_metrics.refusals );
+    AiaMemoryBudget_Release( g_budget, 60 );
+}
+
+TEST( AiaMemoryBudgetTests, ReleaseMakesRoom )
+{
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 100 ) );
+    TEST_ASSERT_FALSE( AiaMemoryBudget_Charge( g_budget, 1 ) );
+    AiaMemoryBudget_Release( g_budget, 30 );
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 30 ) );
+    AiaMemoryBudget_Release( g_budget, 100 );
+    getMetrics();
+    TEST_ASSERT_EQUAL_UINT32( 0, g_metrics.usedBytes );
+}
+
+TEST( AiaMemoryBudgetTests, ForceChargeOverLimit )
+{
+    AiaMemoryBudget_ForceCharge( g_budget, 150 );
+    getMetrics();
+    TEST_ASSERT_EQUAL_UINT32( 150, g_metrics.usedBytes );
+
+    /* Nothing more fits until usage is back under the limit. */
+    TEST_ASSERT_FALSE( AiaMemoryBudget_Charge( g_budget, 1 ) );
+    AiaMemoryBudget_Release( g_budget, 60 );
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 10 ) );
+    AiaMemoryBudget_Release( g_budget, 100 );
+}
+
+TEST( AiaMemoryBudgetTests, PeakIsKept )
+{
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 70 ) );
+    AiaMemoryBudget_Release( g_budget, 50 );
+    TEST_ASSERT_TRUE( AiaMemoryBudget_Charge( g_budget, 10 ) );
+    getMetrics();
+    TEST_ASSERT_EQUAL_UINT32( 30, g_metrics.usedBytes );
+    TEST_ASSERT_EQUAL_UINT32( 70, g_metrics.peakBytes );
+    AiaMemoryBudget_Release( g_budget, 30 );
+}
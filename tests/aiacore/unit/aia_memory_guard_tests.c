@@ -0,0 +1,179 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_memory_guard_tests.c
+ * @brief Tests for the allocation guard of @c AIA_ENABLE_ALLOCATION_GUARD
+ * builds.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+
+/** @return The total number of allocations recorded so far. */
+static size_t TestGetTotal()
+{
+    size_t total = 0;
+    AiaMemoryGuard_GetCallSites( NULL, 0, &total );
+    return total;
+}
+
+/**
+ * Finds a recorded call site.
+ *
+ * @param line The line of the call site in this file.
+ * @return The call site, or one with a zero @c count if it was not recorded.
+ */
+static AiaMemoryGuardCallSite_t TestFindCallSite( int line )
+{
+    AiaMemoryGuardCallSite_t callSites[ AIA_MEMORY_GUARD_MAX_CALL_SITES ];
+    size_t numCallSites = AiaMemoryGuard_GetCallSites(
+        callSites, AIA_MEMORY_GUARD_MAX_CALL_SITES, NULL );
+    for( size_t i = 0; i < numCallSites; ++i )
+    {
+        if( callSites[ i ].line == line &&
+            !strcmp( callSites[ i ].file, __FILE__ ) )
+        {
+            return callSites[ i ];
+        }
+    }
+    AiaMemoryGuardCallSite_t notFound = { NULL, 0,
+                                          AIA_MEMORY_GUARD_SPEAKER_RECEIVE, 0 };
+    return notFound;
+}
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for allocation guard tests.
+ */
+TEST_GROUP( AiaMemoryGuardTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for allocation guard tests.
+ */
+TEST_SETUP( AiaMemoryGuardTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for allocation guard tests.
+ */
+TEST_TEAR_DOWN( AiaMemoryGuardTests )
+{
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+    AiaMemoryGuard_ClearSteadyState();
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for allocation guard tests.
+ */
+TEST_GROUP_RUNNER( AiaMemoryGuardTests )
+{
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+    RUN_TEST_CASE( AiaMemoryGuardTests, AllocationOffHotPathIsNotRecorded );
+    RUN_TEST_CASE( AiaMemoryGuardTests,
+                   AllocationBeforeSteadyStateIsNotRecorded );
+    RUN_TEST_CASE( AiaMemoryGuardTests, HotPathAllocationIsRecorded );
+    RUN_TEST_CASE( AiaMemoryGuardTests, NestedHotPathsUseOutermost );
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+#ifdef AIA_ENABLE_ALLOCATION_GUARD
+TEST( AiaMemoryGuardTests, AllocationOffHotPathIsNotRecorded )
+{
+    size_t total = TestGetTotal();
+    AiaMemoryGuard_MarkSteadyState( false );
+    void* memory = AiaCalloc( 1, 8 );
+    TEST_ASSERT_NOT_NULL( memory );
+    AiaFree( memory );
+    TEST_ASSERT_EQUAL( total, TestGetTotal() );
+}
+
+TEST( AiaMemoryGuardTests, AllocationBeforeSteadyStateIsNotRecorded )
+{
+    size_t total = TestGetTotal();
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    void* memory = AiaCalloc( 1, 8 );
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    TEST_ASSERT_NOT_NULL( memory );
+    AiaFree( memory );
+    TEST_ASSERT_EQUAL( total, TestGetTotal() );
+}
+
+TEST( AiaMemoryGuardTests, HotPathAllocationIsRecorded )
+{
+    size_t total = TestGetTotal();
+    AiaMemoryGuard_MarkSteadyState( false );
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    int line = 0;
+    for( size_t i = 0; i < 2; ++i )
+    {
+        line = __LINE__ + 1;
+        void* memory = AiaCalloc( 1, 8 );
+        TEST_ASSERT_NOT_NULL( memory );
+        AiaFree( memory );
+    }
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_PUSH );
+    TEST_ASSERT_EQUAL( total + 2, TestGetTotal() );
+
+    AiaMemoryGuardCallSite_t callSite = TestFindCallSite( line );
+    TEST_ASSERT_EQUAL( 2, callSite.count );
+    TEST_ASSERT_EQUAL( AIA_MEMORY_GUARD_SPEAKER_PUSH, callSite.hotPath );
+}
+
+TEST( AiaMemoryGuardTests, NestedHotPathsUseOutermost )
+{
+    AiaMemoryGuard_MarkSteadyState( false );
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+    AiaMemoryGuard_Begin( AIA_MEMORY_GUARD_REGULATOR_EMIT );
+    int line = __LINE__ + 1;
+    void* memory = AiaCalloc( 1, 8 );
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_REGULATOR_EMIT );
+    AiaMemoryGuard_End( AIA_MEMORY_GUARD_SPEAKER_RECEIVE );
+    TEST_ASSERT_NOT_NULL( memory );
+    AiaFree( memory );
+
+    AiaMemoryGuardCallSite_t callSite = TestFindCallSite( line );
+    TEST_ASSERT_EQUAL( 1, callSite.count );
+    TEST_ASSERT_EQUAL( AIA_MEMORY_GUARD_SPEAKER_RECEIVE, callSite.hotPath );
+
+    /* Nothing is recorded once the outermost hot path has ended. */
+    size_t total = TestGetTotal();
+    memory = AiaCalloc( 1, 8 );
+    TEST_ASSERT_NOT_NULL( memory );
+    AiaFree( memory );
+    TEST_ASSERT_EQUAL( total, TestGetTotal() );
+}
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mpsc_queue_tests.c
+ * @brief Tests for AiaMpscQueue_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_mpsc_queue.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <stdint.h>
+
+/** Capacity of the queue used by tests. */
+#define TEST_QUEUE_CAPACITY 4
+
+/** An element larger than a word, to check elements are copied whole. */
+typedef struct TestElement
+{
+    uint32_t value;
+    uint8_t tag;
+    uint64_t check;
+} TestElement_t;
+
+/** The queue used by tests. */
+static AiaMpscQueue_t* g_queue;
+
+/**
+ * Builds the test element holding a value.
+ *
+ * @param value The value of the element.
+ * @return The element.
+ */
+static TestElement_t makeElement( uint32_t value )
+{
+    TestElement_t element = { value, (uint8_t)value, ~(uint64_t)value };
+    return element;
+}
+
+/**
+ * Pops an element and checks that it holds a value.
+ *
+ * @param value The value the element should hold.
+ */
+static void popAndCheck( uint32_t value )
+{
+    TestElement_t element;
+    TEST_ASSERT_TRUE( AiaMpscQueue_Pop( g_queue, &element ) );
+    TEST_ASSERT_EQUAL_UINT32( value, element.value );
+    TEST_ASSERT_EQUAL_UINT8( (uint8_t)value, element.tag );
+    TEST_ASSERT_TRUE( ~(uint64_t)value == element.check );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaMpscQueue tests.
+ */
+TEST_GROUP( AiaMpscQueueTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaMpscQueue tests.
+ */
+TEST_SETUP( AiaMpscQueueTests )
+{
+    g_queue =
+        AiaMpscQueue_Create( TEST_QUEUE_CAPACITY, sizeof( TestElement_t ) );
+    TEST_ASSERT_NOT_NULL( g_queue );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaMpscQueue tests.
+ */
+TEST_TEAR_DOWN( AiaMpscQueueTests )
+{
+    AiaMpscQueue_Destroy( g_queue );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaMpscQueue tests.
+ */
+TEST_GROUP_RUNNER( AiaMpscQueueTests )
+{
+    RUN_TEST_CASE( AiaMpscQueueTests, CreateWithInvalidParameters );
+    RUN_TEST_CASE( AiaMpscQueueTests, PopFromEmptyQueue );
+    RUN_TEST_CASE( AiaMpscQueueTests, PopsInPushOrder );
+    RUN_TEST_CASE( AiaMpscQueueTests, PushToFullQueue );
+    RUN_TEST_CASE( AiaMpscQueueTests, WrapsAroundManyTimes );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaMpscQueueTests, CreateWithInvalidParameters )
+{
+    TEST_ASSERT_NULL( AiaMpscQueue_Create( 0, sizeof( TestElement_t ) ) );
+    TEST_ASSERT_NULL( AiaMpscQueue_Create( 3, sizeof( TestElement_t ) ) );
+    TEST_ASSERT_NULL( AiaMpscQueue_Create( TEST_QUEUE_CAPACITY, 0 ) );
+}
+
+TEST( AiaMpscQueueTests, PopFromEmptyQueue )
+{
+    TestElement_t element;
+    TEST_ASSERT_FALSE( AiaMpscQueue_Pop( g_queue, &element ) );
+}
+
+TEST( AiaMpscQueueTests, PopsInPushOrder )
+{
+    for( uint32_t i = 0; i < 3; ++i )
+    {
+        TestElement_t element = makeElement( i );
+        TEST_ASSERT_TRUE( AiaMpscQueue_Push( g_queue, &element ) );
+    }
+    for( uint32_t i = 0; i < 3; ++i )
+    {
+        popAndCheck( i );
+    }
+    TestElement_t element;
+    TEST_ASSERT_FALSE( AiaMpscQueue_Pop( g_queue, &element ) );
+}
+
+TEST( AiaMpscQueueTests, PushToFullQueue )
+{
+    for( uint32_t i = 0; i < TEST_QUEUE_CAPACITY; ++i )
+    {
+        TestElement_t element = makeElement( i );
+        TEST_ASSERT_TRUE( AiaMpscQueue_Push( g_queue, &element ) );
+    }
+    TestElement_t overflow = makeElement( TEST_QUEUE_CAPACITY );
+    TEST_ASSERT_FALSE( AiaMpscQueue_Push( g_queue, &overflow ) );
+
+    /* Popping one element frees a slot. */
+    popAndCheck( 0 );
+    TEST_ASSERT_TRUE( AiaMpscQueue_Push( g_queue, &overflow ) );
+    for( uint32_t i = 1; i <= TEST_QUEUE_CAPACITY; ++i )
+    {
+        popAndCheck( i );
+    }
+}
+
+TEST( AiaMpscQueueTests, WrapsAroundManyTimes )
+{
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for( size_t lap = 0; lap < 100; ++lap )
+    {
+        /* Alternate between filling the queue and leaving it partly full. */
+        size_t count = lap % 2 ? TEST_QUEUE_CAPACITY : 3;
+        for( size_t i = 0; i < count; ++i )
+        {
+            TestElement_t element = makeElement( pushed++ );
+            TEST_ASSERT_TRUE( AiaMpscQueue_Push( g_queue, &element ) );
+        }
+        while( popped < pushed )
+        {
+            popAndCheck( popped++ );
+        }
+    }
+}
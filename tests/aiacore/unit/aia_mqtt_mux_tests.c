@@ -0,0 +1,364 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_mqtt_mux_tests.c
+ * @brief Tests for AiaMqttMux_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_mqtt_mux.h>
+
+#include AiaClock( HEADER )
+#include AiaSemaphore( HEADER )
+#include AiaTimer( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+/** A device topic root used by tests. */
+#define TEST_TOPIC_ROOT_A "root/ais/v1/a/"
+
+/** Another device topic root used by tests. */
+#define TEST_TOPIC_ROOT_B "root/ais/v1/b/"
+
+/** Records the messages passed to a route's handler. */
+typedef struct AiaTestMqttMuxRoute
+{
+    /** The number of messages received. */
+    size_t numMessages;
+
+    /** The last message received. */
+    AiaMqttCallbackParam_t* lastMessage;
+} AiaTestMqttMuxRoute_t;
+
+/** @copydoc AiaMqttTopicHandler_t */
+static void messageReceived( void* userData,
+                             AiaMqttCallbackParam_t* callbackParam )
+{
+    AiaTestMqttMuxRoute_t* route = (AiaTestMqttMuxRoute_t*)userData;
+    TEST_ASSERT_NOT_NULL( route );
+    ++route->numMessages;
+    route->lastMessage = callbackParam;
+}
+
+/** State shared with @c removingMessageReceived() and @c
+ * slowMessageReceived(). */
+typedef struct AiaTestMqttMuxCall
+{
+    /** The mux the message was received on. */
+    AiaMqttMux_t* mux;
+
+    /** The message to pass to the mux from @c messageRoutine(). */
+    AiaMqttCallbackParam_t message;
+
+    /** Posted once the handler has started. */
+    AiaSemaphore_t started;
+
+    /** Whether the handler has returned. This should only be accessed using
+     * atomic operations. */
+    AiaAtomicBool_t isDone;
+} AiaTestMqttMuxCall_t;
+
+/** An @c AiaMqttTopicHandler_t which removes @c TEST_TOPIC_ROOT_B. */
+static void removingMessageReceived( void* userData,
+                                     AiaMqttCallbackParam_t* callbackParam )
+{
+    (void)callbackParam;
+    AiaTestMqttMuxCall_t* call = (AiaTestMqttMuxCall_t*)userData;
+    TEST_ASSERT_TRUE( AiaMqttMux_RemoveRoute(
+        call->mux, TEST_TOPIC_ROOT_B, sizeof( TEST_TOPIC_ROOT_B ) - 1 ) );
+    AiaAtomicBool_Set( &call->isDone );
+}
+
+/** An @c AiaMqttTopicHandler_t which takes a while to return. */
+static void slowMessageReceived( void* userData,
+                                 AiaMqttCallbackParam_t* callbackParam )
+{
+    (void)callbackParam;
+    AiaTestMqttMuxCall_t* call = (AiaTestMqttMuxCall_t*)userData;
+    AiaSemaphore( Post )( &call->started );
+    AiaClock( SleepMs )( 50 );
+    AiaAtomicBool_Set( &call->isDone );
+}
+
+/** Passes @c call->message to @c call->mux from a timer thread. */
+static void messageRoutine( void* context )
+{
+    AiaTestMqttMuxCall_t* call = (AiaTestMqttMuxCall_t*)context;
+    AiaMqttMux_MessageReceived( call->mux, &call->message );
+}
+
+/**
+ * Builds a received message on @c topic.
+ *
+ * @param topic The topic of the message.
+ * @param[out] callbackParam The message.
+ */
+static void initMessage( const char* topic,
+                         AiaMqttCallbackParam_t* callbackParam )
+{
+    memset( callbackParam, 0, sizeof( *callbackParam ) );
+    callbackParam->u.message.info.pTopicName = topic;
+    callbackParam->u.message.info.topicNameLength = strlen( topic );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaMqttMux_t tests.
+ */
+TEST_GROUP( AiaMqttMuxTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaMqttMux_t tests.
+ */
+TEST_SETUP( AiaMqttMuxTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaMqttMux_t tests.
+ */
+TEST_TEAR_DOWN( AiaMqttMuxTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaMqttMux_t tests.
+ */
+TEST_GROUP_RUNNER( AiaMqttMuxTests )
+{
+    RUN_TEST_CASE( AiaMqttMuxTests, CreateWithoutBuckets );
+    RUN_TEST_CASE( AiaMqttMuxTests, RoutesByTopicRoot );
+    RUN_TEST_CASE( AiaMqttMuxTests, RoutesToLongestTopicRoot );
+    RUN_TEST_CASE( AiaMqttMuxTests, DropsUnroutedTopics );
+    RUN_TEST_CASE( AiaMqttMuxTests, RejectsInvalidRoutes );
+    RUN_TEST_CASE( AiaMqttMuxTests, RemoveRoute );
+    RUN_TEST_CASE( AiaMqttMuxTests, HandlerMayRemoveOtherRoutes );
+    RUN_TEST_CASE( AiaMqttMuxTests, RemoveRouteWaitsForHandler );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaMqttMuxTests, CreateWithoutBuckets )
+{
+    TEST_ASSERT_NULL( AiaMqttMux_Create( 0 ) );
+}
+
+TEST( AiaMqttMuxTests, RoutesByTopicRoot )
+{
+    /* A single bucket ensures that routes share a chain. */
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 1 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxRoute_t routeA = { 0 };
+    AiaTestMqttMuxRoute_t routeB = { 0 };
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &routeA ) );
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_B,
+                                           sizeof( TEST_TOPIC_ROOT_B ) - 1,
+                                           messageReceived, &routeB ) );
+
+    AiaMqttCallbackParam_t message;
+    initMessage( TEST_TOPIC_ROOT_A "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 1, routeA.numMessages );
+    TEST_ASSERT_EQUAL_PTR( &message, routeA.lastMessage );
+    TEST_ASSERT_EQUAL( 0, routeB.numMessages );
+
+    initMessage( TEST_TOPIC_ROOT_B "connection/fromservice", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 1, routeA.numMessages );
+    TEST_ASSERT_EQUAL( 1, routeB.numMessages );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, RoutesToLongestTopicRoot )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 4 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxRoute_t shortRoute = { 0 };
+    AiaTestMqttMuxRoute_t longRoute = { 0 };
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute(
+        mux, "root/", sizeof( "root/" ) - 1, messageReceived, &shortRoute ) );
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &longRoute ) );
+
+    AiaMqttCallbackParam_t message;
+    initMessage( TEST_TOPIC_ROOT_A "speaker", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 0, shortRoute.numMessages );
+    TEST_ASSERT_EQUAL( 1, longRoute.numMessages );
+
+    initMessage( TEST_TOPIC_ROOT_B "speaker", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 1, shortRoute.numMessages );
+    TEST_ASSERT_EQUAL( 1, longRoute.numMessages );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, DropsUnroutedTopics )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 4 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxRoute_t route = { 0 };
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &route ) );
+
+    AiaMqttCallbackParam_t message;
+    initMessage( TEST_TOPIC_ROOT_B "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    initMessage( "root/ais/v1/a", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    AiaMqttMux_MessageReceived( mux, NULL );
+    AiaMqttMux_MessageReceived( NULL, &message );
+    TEST_ASSERT_EQUAL( 0, route.numMessages );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, RejectsInvalidRoutes )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 4 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxRoute_t route = { 0 };
+
+    TEST_ASSERT_FALSE( AiaMqttMux_AddRoute( NULL, TEST_TOPIC_ROOT_A,
+                                            sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                            messageReceived, &route ) );
+    TEST_ASSERT_FALSE( AiaMqttMux_AddRoute(
+        mux, NULL, sizeof( TEST_TOPIC_ROOT_A ) - 1, messageReceived, &route ) );
+    TEST_ASSERT_FALSE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                            sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                            NULL, &route ) );
+    TEST_ASSERT_FALSE(
+        AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A, 0, messageReceived,
+                             &route ) );
+    /* Topic roots must end with '/'. */
+    TEST_ASSERT_FALSE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                            sizeof( TEST_TOPIC_ROOT_A ) - 2,
+                                            messageReceived, &route ) );
+
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &route ) );
+    TEST_ASSERT_FALSE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                            sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                            messageReceived, &route ) );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, RemoveRoute )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 1 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxRoute_t routeA = { 0 };
+    AiaTestMqttMuxRoute_t routeB = { 0 };
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &routeA ) );
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_B,
+                                           sizeof( TEST_TOPIC_ROOT_B ) - 1,
+                                           messageReceived, &routeB ) );
+
+    TEST_ASSERT_TRUE( AiaMqttMux_RemoveRoute(
+        mux, TEST_TOPIC_ROOT_A, sizeof( TEST_TOPIC_ROOT_A ) - 1 ) );
+    TEST_ASSERT_FALSE( AiaMqttMux_RemoveRoute(
+        mux, TEST_TOPIC_ROOT_A, sizeof( TEST_TOPIC_ROOT_A ) - 1 ) );
+
+    AiaMqttCallbackParam_t message;
+    initMessage( TEST_TOPIC_ROOT_A "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    initMessage( TEST_TOPIC_ROOT_B "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 0, routeA.numMessages );
+    TEST_ASSERT_EQUAL( 1, routeB.numMessages );
+
+    /* The root may be routed again once removed. */
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           messageReceived, &routeA ) );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, HandlerMayRemoveOtherRoutes )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 1 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxCall_t call = { 0 };
+    call.mux = mux;
+    AiaTestMqttMuxRoute_t routeB = { 0 };
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           removingMessageReceived, &call ) );
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_B,
+                                           sizeof( TEST_TOPIC_ROOT_B ) - 1,
+                                           messageReceived, &routeB ) );
+
+    AiaMqttCallbackParam_t message;
+    initMessage( TEST_TOPIC_ROOT_A "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_TRUE( AiaAtomicBool_Load( &call.isDone ) );
+
+    initMessage( TEST_TOPIC_ROOT_B "directive", &message );
+    AiaMqttMux_MessageReceived( mux, &message );
+    TEST_ASSERT_EQUAL( 0, routeB.numMessages );
+
+    AiaMqttMux_Destroy( mux );
+}
+
+TEST( AiaMqttMuxTests, RemoveRouteWaitsForHandler )
+{
+    AiaMqttMux_t* mux = AiaMqttMux_Create( 1 );
+    TEST_ASSERT_NOT_NULL( mux );
+    AiaTestMqttMuxCall_t call = { 0 };
+    call.mux = mux;
+    TEST_ASSERT_TRUE( AiaSemaphore( Create )( &call.started, 0, 1 ) );
+    initMessage( TEST_TOPIC_ROOT_A "directive", &call.message );
+    TEST_ASSERT_TRUE( AiaMqttMux_AddRoute( mux, TEST_TOPIC_ROOT_A,
+                                           sizeof( TEST_TOPIC_ROOT_A ) - 1,
+                                           slowMessageReceived, &call ) );
+
+    AiaTimer_t timer;
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &timer, messageRoutine, &call ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timer, 0, 0 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )( &call.started, 1000 ) );
+
+    TEST_ASSERT_TRUE( AiaMqttMux_RemoveRoute(
+        mux, TEST_TOPIC_ROOT_A, sizeof( TEST_TOPIC_ROOT_A ) - 1 ) );
+    TEST_ASSERT_TRUE( AiaAtomicBool_Load( &call.isDone ) );
+
+    AiaTimer( Destroy )( &timer );
+    AiaSemaphore( Destroy )( &call.started );
+    AiaMqttMux_Destroy( mux );
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_overload_governor_tests.c
+ * @brief Tests for the overload governor.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_overload_governor.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+/**
+ * Reports a window of speaker pushes.
+ *
+ * @param runs The number of runs to report.
+ * @param lateRuns How many of @c runs were late.
+ */
+static void reportWindow( uint32_t runs, uint32_t lateRuns )
+{
+    for( uint32_t i = 0; i < runs; ++i )
+    {
+        AiaOverloadGovernor_ReportTaskRun( AIA_OVERLOAD_TASK_SPEAKER_PUSH,
+                                           i < lateRuns );
+    }
+    AiaOverloadGovernor_EndWindow();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for overload governor tests.
+ */
+TEST_GROUP( AiaOverloadGovernorTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for overload governor tests.
+ */
+TEST_SETUP( AiaOverloadGovernorTests )
+{
+    AiaOverloadGovernor_Reset();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for overload governor tests.
+ */
+TEST_TEAR_DOWN( AiaOverloadGovernorTests )
+{
+    AiaOverloadGovernor_Reset();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for overload governor tests.
+ */
+TEST_GROUP_RUNNER( AiaOverloadGovernorTests )
+{
+    RUN_TEST_CASE( AiaOverloadGovernorTests, NothingShedInitially );
+    RUN_TEST_CASE( AiaOverloadGovernorTests, FewLateRunsShedNothing );
+    RUN_TEST_CASE( AiaOverloadGovernorTests, LateRunsShedInOrder );
+    RUN_TEST_CASE( AiaOverloadGovernorTests, OldQueuesShedWork );
+    RUN_TEST_CASE( AiaOverloadGovernorTests, CalmWindowsRestoreWork );
+    RUN_TEST_CASE( AiaOverloadGovernorTests, LateRunsDelayRestoring );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaOverloadGovernorTests, NothingShedInitially )
+{
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+    TEST_ASSERT_FALSE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_DEBUG_LOGS ) );
+
+    /* An empty window is no pressure. */
+    AiaOverloadGovernor_EndWindow();
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+}
+
+TEST( AiaOverloadGovernorTests, FewLateRunsShedNothing )
+{
+    reportWindow( 100, AIA_OVERLOAD_MISS_PERCENT - 1 );
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+}
+
+TEST( AiaOverloadGovernorTests, LateRunsShedInOrder )
+{
+    reportWindow( 100, AIA_OVERLOAD_MISS_PERCENT );
+    TEST_ASSERT_EQUAL_UINT32( 1, AiaOverloadGovernor_GetLevel() );
+    TEST_ASSERT_TRUE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_DEBUG_LOGS ) );
+    TEST_ASSERT_FALSE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_UX_OBSERVER ) );
+
+    reportWindow( 10, 10 );
+    TEST_ASSERT_TRUE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_UX_OBSERVER ) );
+    TEST_ASSERT_FALSE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_NON_CRITICAL_EVENTS ) );
+
+    /* The level stops at shedding everything. */
+    for( size_t i = 0; i < AIA_OVERLOAD_MAX_LEVEL; ++i )
+    {
+        reportWindow( 10, 10 );
+    }
+    TEST_ASSERT_EQUAL_UINT32( AIA_OVERLOAD_MAX_LEVEL,
+                              AiaOverloadGovernor_GetLevel() );
+    TEST_ASSERT_TRUE(
+        AiaOverloadGovernor_IsShed( AIA_OVERLOAD_WORK_TELEMETRY ) );
+}
+
+TEST( AiaOverloadGovernorTests, OldQueuesShedWork )
+{
+    AiaOverloadGovernor_ReportQueueAge( AIA_OVERLOAD_MAX_QUEUE_AGE_MS - 1 );
+    AiaOverloadGovernor_EndWindow();
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+
+    AiaOverloadGovernor_ReportQueueAge( 1 );
+    AiaOverloadGovernor_ReportQueueAge( AIA_OVERLOAD_MAX_QUEUE_AGE_MS );
+    AiaOverloadGovernor_ReportQueueAge( 1 );
+    AiaOverloadGovernor_EndWindow();
+    TEST_ASSERT_EQUAL_UINT32( 1, AiaOverloadGovernor_GetLevel() );
+}
+
+TEST( AiaOverloadGovernorTests, CalmWindowsRestoreWork )
+{
+    reportWindow( 1, 1 );
+    reportWindow( 1, 1 );
+    TEST_ASSERT_EQUAL_UINT32( 2, AiaOverloadGovernor_GetLevel() );
+
+    for( size_t i = 1; i < AIA_OVERLOAD_CALM_WINDOWS; ++i )
+    {
+        reportWindow( 10, 0 );
+    }
+    TEST_ASSERT_EQUAL_UINT32( 2, AiaOverloadGovernor_GetLevel() );
+    reportWindow( 10, 0 );
+    TEST_ASSERT_EQUAL_UINT32( 1, AiaOverloadGovernor_GetLevel() );
+
+    /* Work comes back one step at a time. */
+    for( size_t i = 0; i < AIA_OVERLOAD_CALM_WINDOWS; ++i )
+    {
+        reportWindow( 10, 0 );
+    }
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+}
+
+TEST( AiaOverloadGovernorTests, LateRunsDelayRestoring )
+{
+    reportWindow( 1, 1 );
+    TEST_ASSERT_EQUAL_UINT32( 1, AiaOverloadGovernor_GetLevel() );
+
+    /* A window with late runs below the threshold neither sheds nor counts
+     * towards restoring. */
+    for( size_t i = 1; i < AIA_OVERLOAD_CALM_WINDOWS; ++i )
+    {
+        reportWindow( 10, 0 );
+    }
+    reportWindow( 100, 1 );
+    for( size_t i = 1; i < AIA_OVERLOAD_CALM_WINDOWS; ++i )
+    {
+        reportWindow( 10, 0 );
+    }
+    TEST_ASSERT_EQUAL_UINT32( 1, AiaOverloadGovernor_GetLevel() );
+    reportWindow( 10, 0 );
+    TEST_ASSERT_EQUAL_UINT32( 0, AiaOverloadGovernor_GetLevel() );
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm_resampler_tests.c
+ * @brief Tests for AiaPcmResampler_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_pcm_resampler.h>
+#include <aiacore/aia_utils.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+/** Number of input frames used by tests, 100 milliseconds at 48 kHz. */
+#define TEST_NUM_FRAMES 4800
+
+/** Resamplers are too large to be allocated on the stack. */
+static AiaPcmResampler_t g_resampler;
+
+/** Input frames used by tests. */
+static int16_t g_input[ TEST_NUM_FRAMES * AIA_PCM_RESAMPLER_MAX_CHANNELS ];
+
+/** Output frames of the first resampling in a test. */
+static int16_t g_output[ TEST_NUM_FRAMES * AIA_PCM_RESAMPLER_MAX_CHANNELS ];
+
+/** Output frames of the second resampling in a test. */
+static int16_t g_otherOutput[ TEST_NUM_FRAMES *
+                              AIA_PCM_RESAMPLER_MAX_CHANNELS ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaPcmResampler tests.
+ */
+TEST_GROUP( AiaPcmResamplerTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaPcmResampler tests.
+ */
+TEST_SETUP( AiaPcmResamplerTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaPcmResampler tests.
+ */
+TEST_TEAR_DOWN( AiaPcmResamplerTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaPcmResampler tests.
+ */
+TEST_GROUP_RUNNER( AiaPcmResamplerTests )
+{
+    RUN_TEST_CASE( AiaPcmResamplerTests, InitRejectsInvalidArguments );
+    RUN_TEST_CASE( AiaPcmResamplerTests, DcPassesAtOutputRate );
+    RUN_TEST_CASE( AiaPcmResamplerTests, StreamingMatchesSingleBlock );
+    RUN_TEST_CASE( AiaPcmResamplerTests, SmallOutputConsumesNothing );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaPcmResamplerTests, InitRejectsInvalidArguments )
+{
+    TEST_ASSERT_FALSE( AiaPcmResampler_Init( &g_resampler, 0, 44100, 1 ) );
+    TEST_ASSERT_FALSE( AiaPcmResampler_Init( &g_resampler, 48000, 0, 1 ) );
+    TEST_ASSERT_FALSE( AiaPcmResampler_Init( &g_resampler, 48000, 44100, 0 ) );
+    TEST_ASSERT_FALSE( AiaPcmResampler_Init(
+        &g_resampler, 48000, 44100, AIA_PCM_RESAMPLER_MAX_CHANNELS + 1 ) );
+    TEST_ASSERT_FALSE( AiaPcmResampler_Init( &g_resampler, 48000, 44101, 1 ) );
+    TEST_ASSERT_TRUE( AiaPcmResampler_Init( &g_resampler, 44100, 48000, 2 ) );
+    TEST_ASSERT_TRUE( AiaPcmResampler_Init( &g_resampler, 48000, 16000, 1 ) );
+}
+
+TEST( AiaPcmResamplerTests, DcPassesAtOutputRate )
+{
+    TEST_ASSERT_TRUE( AiaPcmResampler_Init( &g_resampler, 48000, 44100, 1 ) );
+    for( size_t i = 0; i < TEST_NUM_FRAMES; ++i )
+    {
+        g_input[ i ] = 1000;
+    }
+
+    size_t numOutputFrames = AiaPcmResampler_Process(
+        &g_resampler, g_input, TEST_NUM_FRAMES, g_output, TEST_NUM_FRAMES );
+    TEST_ASSERT_UINT_WITHIN( 1, TEST_NUM_FRAMES * 147 / 160, numOutputFrames );
+
+    /* Once the filter is past the silence it starts from, DC is unchanged. */
+    for( size_t i = AIA_PCM_RESAMPLER_TAPS; i < numOutputFrames; ++i )
+    {
+        TEST_ASSERT_INT_WITHIN( 1, 1000, g_output[ i ] );
+    }
+}
+
+TEST( AiaPcmResamplerTests, StreamingMatchesSingleBlock )
+{
+    static const size_t NUM_CHANNELS = 2;
+    for( size_t i = 0; i < TEST_NUM_FRAMES * NUM_CHANNELS; ++i )
+    {
+        g_input[ i ] = (int16_t)( ( i * 7919 ) % 20000 ) - 10000;
+    }
+
+    TEST_ASSERT_TRUE(
+        AiaPcmResampler_Init( &g_resampler, 44100, 48000, NUM_CHANNELS ) );
+    size_t numOutputFrames = AiaPcmResampler_Process(
+        &g_resampler, g_input, TEST_NUM_FRAMES / 2, g_output, TEST_NUM_FRAMES );
+
+    /* Blocks both shorter and longer than the filter must give the same
+     * output as a single block. */
+    static const size_t BLOCK_FRAMES[] = { 1, 7, 31, 32, 100, 480 };
+    AiaPcmResampler_Reset( &g_resampler );
+    size_t numInputFrames = 0;
+    size_t numOtherOutputFrames = 0;
+    for( size_t block = 0; numInputFrames < TEST_NUM_FRAMES / 2; ++block )
+    {
+        size_t blockFrames =
+            BLOCK_FRAMES[ block % AiaArrayLength( BLOCK_FRAMES ) ];
+        if( blockFrames > TEST_NUM_FRAMES / 2 - numInputFrames )
+        {
+            blockFrames = TEST_NUM_FRAMES / 2 - numInputFrames;
+        }
+        numOtherOutputFrames += AiaPcmResampler_Process(
+            &g_resampler, g_input + numInputFrames * NUM_CHANNELS, blockFrames,
+            g_otherOutput + numOtherOutputFrames * NUM_CHANNELS,
+            TEST_NUM_FRAMES - numOtherOutputFrames );
+        numInputFrames += blockFrames;
+    }
+
+    TEST_ASSERT_EQUAL( numOutputFrames, numOtherOutputFrames );
+    TEST_ASSERT_EQUAL_INT16_ARRAY( g_output, g_otherOutput,
+                                   numOutputFrames * NUM_CHANNELS );
+}
+
+TEST( AiaPcmResamplerTests, SmallOutputConsumesNothing )
+{
+    TEST_ASSERT_TRUE( AiaPcmResampler_Init( &g_resampler, 16000, 48000, 1 ) );
+    for( size_t i = 0; i < TEST_NUM_FRAMES; ++i )
+    {
+        g_input[ i ] = 1000;
+    }
+    size_t maxOutputFrames =
+        AiaPcmResampler_GetMaxOutputFrames( &g_resampler, 100 );
+    TEST_ASSERT_EQUAL( 301, maxOutputFrames );
+    TEST_ASSERT_EQUAL( 0, AiaPcmResampler_Process( &g_resampler, g_input, 100,
+                                                   g_output,
+                                                   maxOutputFrames - 1 ) );
+
+    /* Nothing was consumed, so the output starts from silence. */
+    TEST_ASSERT_EQUAL( 300,
+                       AiaPcmResampler_Process( &g_resampler, g_input, 100,
+                                                g_output, maxOutputFrames ) );
+    TEST_ASSERT_EQUAL_INT16( 0, g_output[ 0 ] );
+}
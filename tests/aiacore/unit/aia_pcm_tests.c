@@ -0,0 +1,219 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_pcm_tests.c
+ * @brief Tests for the PCM utilities in aia_pcm.h.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_pcm.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+/** Number of samples used by tests. */
+#define TEST_NUM_SAMPLES 160
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaPcm tests.
+ */
+TEST_GROUP( AiaPcmTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaPcm tests.
+ */
+TEST_SETUP( AiaPcmTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaPcm tests.
+ */
+TEST_TEAR_DOWN( AiaPcmTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaPcm tests.
+ */
+TEST_GROUP_RUNNER( AiaPcmTests )
+{
+    RUN_TEST_CASE( AiaPcmTests, RemoveDcConvergesToZeroMean );
+    RUN_TEST_CASE( AiaPcmTests, ApplyGainSaturates );
+    RUN_TEST_CASE( AiaPcmTests, MeasureEnergy );
+    RUN_TEST_CASE( AiaPcmTests, MeasureEnergyEmpty );
+    RUN_TEST_CASE( AiaPcmTests, CountZeroCrossings );
+    RUN_TEST_CASE( AiaPcmTests, DownmixAveragesAndSelects );
+    RUN_TEST_CASE( AiaPcmTests, NormalizationGain );
+    RUN_TEST_CASE( AiaPcmTests, FloatRoundTrip );
+    RUN_TEST_CASE( AiaPcmTests, FloatToInt16Saturates );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaPcmTests, RemoveDcConvergesToZeroMean )
+{
+    AiaPcmDcFilter_t filter = { 0 };
+    int16_t samples[ TEST_NUM_SAMPLES ];
+    int32_t sum = 0;
+    for( size_t block = 0; block < 64; ++block )
+    {
+        for( size_t i = 0; i < TEST_NUM_SAMPLES; ++i )
+        {
+            samples[ i ] = 1000 + ( ( i % 2 ) ? 100 : -100 );
+        }
+        AiaPcm_RemoveDc( &filter, samples, TEST_NUM_SAMPLES );
+    }
+    for( size_t i = 0; i < TEST_NUM_SAMPLES; ++i )
+    {
+        sum += samples[ i ];
+    }
+    TEST_ASSERT_INT_WITHIN( 2, 0, sum / (int32_t)TEST_NUM_SAMPLES );
+    TEST_ASSERT_EQUAL_INT( 200, samples[ 1 ] - samples[ 0 ] );
+}
+
+TEST( AiaPcmTests, ApplyGainSaturates )
+{
+    int16_t samples[] = { 0, 100, -100, 20000, -20000, INT16_MAX, INT16_MIN };
+    const size_t numSamples = sizeof( samples ) / sizeof( samples[ 0 ] );
+    AiaPcm_ApplyGain( samples, numSamples, 2 * AIA_PCM_GAIN_UNITY );
+    TEST_ASSERT_EQUAL_INT16( 0, samples[ 0 ] );
+    TEST_ASSERT_EQUAL_INT16( 200, samples[ 1 ] );
+    TEST_ASSERT_EQUAL_INT16( -200, samples[ 2 ] );
+    TEST_ASSERT_EQUAL_INT16( INT16_MAX, samples[ 3 ] );
+    TEST_ASSERT_EQUAL_INT16( INT16_MIN, samples[ 4 ] );
+    TEST_ASSERT_EQUAL_INT16( INT16_MAX, samples[ 5 ] );
+    TEST_ASSERT_EQUAL_INT16( INT16_MIN, samples[ 6 ] );
+
+    AiaPcm_ApplyGain( samples, numSamples, AIA_PCM_GAIN_UNITY / 2 );
+    TEST_ASSERT_EQUAL_INT16( 100, samples[ 1 ] );
+    TEST_ASSERT_EQUAL_INT16( -100, samples[ 2 ] );
+}
+
+TEST( AiaPcmTests, MeasureEnergy )
+{
+    int16_t samples[ TEST_NUM_SAMPLES ];
+    for( size_t i = 0; i < TEST_NUM_SAMPLES; ++i )
+    {
+        samples[ i ] = ( i % 2 ) ? 3000 : -3000;
+    }
+    samples[ 7 ] = INT16_MIN;
+    AiaPcmEnergy_t energy;
+    AiaPcm_MeasureEnergy( samples, 7, &energy );
+    TEST_ASSERT_EQUAL_UINT32( 3000, energy.peak );
+    TEST_ASSERT_EQUAL_UINT32( 3000, energy.rms );
+
+    AiaPcm_MeasureEnergy( samples, TEST_NUM_SAMPLES, &energy );
+    TEST_ASSERT_EQUAL_UINT32( 32768, energy.peak );
+    TEST_ASSERT_TRUE( energy.rms > 3000 );
+}
+
+TEST( AiaPcmTests, MeasureEnergyEmpty )
+{
+    int16_t samples[ 1 ] = { 1000 };
+    AiaPcmEnergy_t energy = { 1, 1 };
+    AiaPcm_MeasureEnergy( samples, 0, &energy );
+    TEST_ASSERT_EQUAL_UINT32( 0, energy.peak );
+    TEST_ASSERT_EQUAL_UINT32( 0, energy.rms );
+}
+
+TEST( AiaPcmTests, CountZeroCrossings )
+{
+    int16_t samples[] = { 100, -100, -5, 0, 7, -32768, 32767, 1 };
+    TEST_ASSERT_EQUAL( 4, AiaPcm_CountZeroCrossings( samples, 8 ) );
+    TEST_ASSERT_EQUAL( 1, AiaPcm_CountZeroCrossings( samples, 2 ) );
+    TEST_ASSERT_EQUAL( 0, AiaPcm_CountZeroCrossings( samples, 1 ) );
+    TEST_ASSERT_EQUAL( 0, AiaPcm_CountZeroCrossings( samples, 0 ) );
+}
+
+TEST( AiaPcmTests, DownmixAveragesAndSelects )
+{
+    const int16_t frames[] = { 100, 300, -32768, -32768, 32767, 32767 };
+    const AiaPcmGain_t average[] = { AIA_PCM_GAIN_UNITY / 2,
+                                     AIA_PCM_GAIN_UNITY / 2 };
+    const AiaPcmGain_t second[] = { 0, AIA_PCM_GAIN_UNITY };
+    const AiaPcmGain_t loud[] = { AIA_PCM_GAIN_UNITY, AIA_PCM_GAIN_UNITY };
+    int16_t out[ 3 ];
+
+    AiaPcm_Downmix( frames, 2, average, out, 3 );
+    TEST_ASSERT_EQUAL_INT16( 200, out[ 0 ] );
+    TEST_ASSERT_EQUAL_INT16( -32768, out[ 1 ] );
+    TEST_ASSERT_EQUAL_INT16( 32767, out[ 2 ] );
+
+    AiaPcm_Downmix( frames, 2, second, out, 3 );
+    TEST_ASSERT_EQUAL_INT16( 300, out[ 0 ] );
+
+    AiaPcm_Downmix( frames, 2, loud, out, 3 );
+    TEST_ASSERT_EQUAL_INT16( 400, out[ 0 ] );
+    TEST_ASSERT_EQUAL_INT16( -32768, out[ 1 ] );
+    TEST_ASSERT_EQUAL_INT16( 32767, out[ 2 ] );
+}
+
+TEST( AiaPcmTests, NormalizationGain )
+{
+    static const AiaPcmGain_t MAX_GAIN = 8 * AIA_PCM_GAIN_UNITY;
+    TEST_ASSERT_EQUAL_UINT16(
+        2 * AIA_PCM_GAIN_UNITY,
+        AiaPcm_GetNormalizationGain( 8000, 16000, MAX_GAIN ) );
+    TEST_ASSERT_EQUAL_UINT16(
+        AIA_PCM_GAIN_UNITY / 2,
+        AiaPcm_GetNormalizationGain( 32000, 16000, MAX_GAIN ) );
+    TEST_ASSERT_EQUAL_UINT16(
+        MAX_GAIN, AiaPcm_GetNormalizationGain( 100, 16000, MAX_GAIN ) );
+    TEST_ASSERT_EQUAL_UINT16(
+        MAX_GAIN, AiaPcm_GetNormalizationGain( 0, 16000, MAX_GAIN ) );
+}
+
+TEST( AiaPcmTests, FloatRoundTrip )
+{
+    int16_t samples[] = { 0, 1, -1, 12345, -12345, INT16_MAX, INT16_MIN };
+    const size_t numSamples = sizeof( samples ) / sizeof( samples[ 0 ] );
+    float floats[ sizeof( samples ) / sizeof( samples[ 0 ] ) ];
+    int16_t roundTrip[ sizeof( samples ) / sizeof( samples[ 0 ] ) ];
+
+    AiaPcm_Int16ToFloat( samples, floats, numSamples );
+    TEST_ASSERT_EQUAL_FLOAT( 0.0f, floats[ 0 ] );
+    TEST_ASSERT_EQUAL_FLOAT( -1.0f, floats[ 6 ] );
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        TEST_ASSERT_TRUE( floats[ i ] >= -1.0f && floats[ i ] < 1.0f );
+    }
+
+    AiaPcm_FloatToInt16( floats, roundTrip, numSamples );
+    TEST_ASSERT_EQUAL_INT16_ARRAY( samples, roundTrip, numSamples );
+}
+
+TEST( AiaPcmTests, FloatToInt16Saturates )
+{
+    float floats[] = { 2.0f, -2.0f, 0.5f, -0.5f };
+    int16_t samples[ 4 ];
+    AiaPcm_FloatToInt16( floats, samples, 4 );
+    TEST_ASSERT_EQUAL_INT16( INT16_MAX, samples[ 0 ] );
+    TEST_ASSERT_EQUAL_INT16( INT16_MIN, samples[ 1 ] );
+    TEST_ASSERT_EQUAL_INT16( 16384, samples[ 2 ] );
+    TEST_ASSERT_EQUAL_INT16( -16384, samples[ 3 ] );
+}
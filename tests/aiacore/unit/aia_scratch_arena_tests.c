@@ -0,0 +1,156 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_scratch_arena_tests.c
+ * @brief Tests for AiaScratchArena_t.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_scratch_arena.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Capacity of the arena used by tests. */
+#define TEST_ARENA_CAPACITY 256
+
+/** The arena used by tests. */
+static AiaScratchArena_t* g_arena;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaScratchArena tests.
+ */
+TEST_GROUP( AiaScratchArenaTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaScratchArena tests.
+ */
+TEST_SETUP( AiaScratchArenaTests )
+{
+    g_arena = AiaScratchArena_Create( TEST_ARENA_CAPACITY );
+    TEST_ASSERT_NOT_NULL( g_arena );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaScratchArena tests.
+ */
+TEST_TEAR_DOWN( AiaScratchArenaTests )
+{
+    AiaScratchArena_Destroy( g_arena );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaScratchArena tests.
+ */
+TEST_GROUP_RUNNER( AiaScratchArenaTests )
+{
+    RUN_TEST_CASE( AiaScratchArenaTests, CreateWithZeroCapacity );
+    RUN_TEST_CASE( AiaScratchArenaTests, AllocationsAreZeroedAndAligned );
+    RUN_TEST_CASE( AiaScratchArenaTests, ResetReusesMemory );
+    RUN_TEST_CASE( AiaScratchArenaTests, OverflowFallsBackToHeap );
+    RUN_TEST_CASE( AiaScratchArenaTests, NullArenaUsesHeap );
+    RUN_TEST_CASE( AiaScratchArenaTests, HighWaterMark );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaScratchArenaTests, CreateWithZeroCapacity )
+{
+    TEST_ASSERT_NULL( AiaScratchArena_Create( 0 ) );
+}
+
+TEST( AiaScratchArenaTests, AllocationsAreZeroedAndAligned )
+{
+    uint8_t* first = AiaScratchArena_Calloc( g_arena, 3, 1 );
+    TEST_ASSERT_NOT_NULL( first );
+    memset( first, 0xff, 3 );
+
+    uint64_t* second = AiaScratchArena_Calloc( g_arena, 2, sizeof( *second ) );
+    TEST_ASSERT_NOT_NULL( second );
+    TEST_ASSERT_EQUAL( 0, (uintptr_t)second % sizeof( *second ) );
+    TEST_ASSERT_EQUAL_UINT64( 0, second[ 0 ] );
+    TEST_ASSERT_EQUAL_UINT64( 0, second[ 1 ] );
+    TEST_ASSERT_TRUE( (uint8_t*)second >= first + 3 );
+
+    AiaScratchArena_Free( g_arena, first );
+    AiaScratchArena_Free( g_arena, second );
+}
+
+TEST( AiaScratchArenaTests, ResetReusesMemory )
+{
+    uint8_t* first = AiaScratchArena_Calloc( g_arena, 16, 1 );
+    TEST_ASSERT_NOT_NULL( first );
+    memset( first, 0xff, 16 );
+
+    AiaScratchArena_Reset( g_arena );
+
+    uint8_t* second = AiaScratchArena_Calloc( g_arena, 16, 1 );
+    TEST_ASSERT_EQUAL_PTR( first, second );
+    for( size_t i = 0; i < 16; ++i )
+    {
+        TEST_ASSERT_EQUAL_UINT8( 0, second[ i ] );
+    }
+}
+
+TEST( AiaScratchArenaTests, OverflowFallsBackToHeap )
+{
+    uint8_t* inArena = AiaScratchArena_Calloc( g_arena, 1, 1 );
+    TEST_ASSERT_NOT_NULL( inArena );
+
+    uint8_t* onHeap = AiaScratchArena_Calloc( g_arena, TEST_ARENA_CAPACITY, 1 );
+    TEST_ASSERT_NOT_NULL( onHeap );
+    memset( onHeap, 0xff, TEST_ARENA_CAPACITY );
+
+    /* Freeing the heap fallback must not affect the arena. */
+    AiaScratchArena_Free( g_arena, onHeap );
+    AiaScratchArena_Free( g_arena, inArena );
+
+    TEST_ASSERT_NULL( AiaScratchArena_Calloc( g_arena, SIZE_MAX, 2 ) );
+}
+
+TEST( AiaScratchArenaTests, NullArenaUsesHeap )
+{
+    uint8_t* memory = AiaScratchArena_Calloc( NULL, 4, 1 );
+    TEST_ASSERT_NOT_NULL( memory );
+    TEST_ASSERT_EQUAL_UINT8( 0, memory[ 3 ] );
+    AiaScratchArena_Free( NULL, memory );
+}
+
+TEST( AiaScratchArenaTests, HighWaterMark )
+{
+    TEST_ASSERT_EQUAL( 0, AiaScratchArena_GetHighWaterMark( g_arena ) );
+
+    TEST_ASSERT_NOT_NULL( AiaScratchArena_Calloc( g_arena, 100, 1 ) );
+    TEST_ASSERT_EQUAL( 100, AiaScratchArena_GetHighWaterMark( g_arena ) );
+
+    AiaScratchArena_Reset( g_arena );
+    TEST_ASSERT_NOT_NULL( AiaScratchArena_Calloc( g_arena, 10, 1 ) );
+    TEST_ASSERT_EQUAL( 100, AiaScratchArena_GetHighWaterMark( g_arena ) );
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_session_trace_tests.c
+ * @brief Tests for reading and writing session traces.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aiacore/aia_session_trace.h>
+#include <aiacore/aia_utils.h>
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for AiaSessionTrace tests.
+ */
+TEST_GROUP( AiaSessionTraceTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for AiaSessionTrace tests.
+ */
+TEST_SETUP( AiaSessionTraceTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for AiaSessionTrace tests.
+ */
+TEST_TEAR_DOWN( AiaSessionTraceTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for AiaSessionTrace tests.
+ */
+TEST_GROUP_RUNNER( AiaSessionTraceTests )
+{
+    RUN_TEST_CASE( AiaSessionTraceTests, HeaderRoundTrip );
+    RUN_TEST_CASE( AiaSessionTraceTests, RejectsForeignHeader );
+    RUN_TEST_CASE( AiaSessionTraceTests, RecordRoundTrip );
+    RUN_TEST_CASE( AiaSessionTraceTests, SmallRecordIsCompact );
+    RUN_TEST_CASE( AiaSessionTraceTests, LargestFieldsFit );
+    RUN_TEST_CASE( AiaSessionTraceTests, RejectsTruncatedRecord );
+    RUN_TEST_CASE( AiaSessionTraceTests, RejectsInvalidTopic );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Writes a record and its payload to a buffer.
+ *
+ * @param record The record to write.
+ * @param[out] buffer The buffer to write to.
+ * @param size The size of @c buffer.
+ * @return The number of bytes written.
+ */
+static size_t writeRecord( const AiaSessionTraceRecord_t* record,
+                           uint8_t* buffer, size_t size )
+{
+    size_t written =
+        AiaSessionTrace_WriteRecordHeader( record, buffer, size );
+    TEST_ASSERT_NOT_EQUAL( 0, written );
+    TEST_ASSERT_TRUE( written + record->payloadSize <= size );
+    if( record->payloadSize )
+    {
+        memcpy( buffer + written, record->payload, record->payloadSize );
+    }
+    return written + record->payloadSize;
+}
+
+TEST( AiaSessionTraceTests, HeaderRoundTrip )
+{
+    uint8_t buffer[ AIA_SESSION_TRACE_HEADER_SIZE ];
+    TEST_ASSERT_EQUAL(
+        0, AiaSessionTrace_WriteHeader( buffer, sizeof( buffer ) - 1 ) );
+    TEST_ASSERT_EQUAL(
+        AIA_SESSION_TRACE_HEADER_SIZE,
+        AiaSessionTrace_WriteHeader( buffer, sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL(
+        AIA_SESSION_TRACE_HEADER_SIZE,
+        AiaSessionTrace_ReadHeader( buffer, sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaSessionTrace_ReadHeader( buffer, sizeof( buffer ) - 1 ) );
+}
+
+TEST( AiaSessionTraceTests, RejectsForeignHeader )
+{
+    uint8_t buffer[ AIA_SESSION_TRACE_HEADER_SIZE ];
+    TEST_ASSERT_EQUAL(
+        AIA_SESSION_TRACE_HEADER_SIZE,
+        AiaSessionTrace_WriteHeader( buffer, sizeof( buffer ) ) );
+
+    buffer[ AIA_SESSION_TRACE_HEADER_SIZE - 1 ]++;
+    TEST_ASSERT_EQUAL( 0,
+                       AiaSessionTrace_ReadHeader( buffer, sizeof( buffer ) ) );
+
+    memcpy( buffer, "RIFF", 4 );
+    TEST_ASSERT_EQUAL( 0,
+                       AiaSessionTrace_ReadHeader( buffer, sizeof( buffer ) ) );
+}
+
+TEST( AiaSessionTraceTests, RecordRoundTrip )
+{
+    static const char DIRECTIVE[] = "{\"directives\":[]}";
+    static const uint8_t AUDIO[] = { 0, 1, 2, 3, 0xfe, 0xff };
+    AiaSessionTraceRecord_t records[] = {
+        { 0, AIA_TOPIC_CONNECTION_FROM_SERVICE, 0, NULL, 0 },
+        { 130, AIA_TOPIC_DIRECTIVE, 7, (const uint8_t*)DIRECTIVE,
+          sizeof( DIRECTIVE ) - 1 },
+        { 20, AIA_TOPIC_SPEAKER, 300, AUDIO, sizeof( AUDIO ) }
+    };
+
+    uint8_t buffer[ 128 ];
+    size_t size = 0;
+    for( size_t i = 0; i < AiaArrayLength( records ); ++i )
+    {
+        size += writeRecord( &records[ i ], buffer + size,
+                             sizeof( buffer ) - size );
+    }
+
+    size_t position = 0;
+    for( size_t i = 0; i < AiaArrayLength( records ); ++i )
+    {
+        AiaSessionTraceRecord_t record;
+        size_t read = AiaSessionTrace_ReadRecord(
+            buffer + position, size - position, &record );
+        TEST_ASSERT_NOT_EQUAL( 0, read );
+        TEST_ASSERT_EQUAL( records[ i ].delayMs, record.delayMs );
+        TEST_ASSERT_EQUAL( records[ i ].topic, record.topic );
+        TEST_ASSERT_EQUAL( records[ i ].sequenceNumber,
+                           record.sequenceNumber );
+        TEST_ASSERT_EQUAL( records[ i ].payloadSize, record.payloadSize );
+        if( record.payloadSize )
+        {
+            TEST_ASSERT_EQUAL_MEMORY( records[ i ].payload, record.payload,
+                                      record.payloadSize );
+        }
+        position += read;
+    }
+    TEST_ASSERT_EQUAL( size, position );
+}
+
+TEST( AiaSessionTraceTests, SmallRecordIsCompact )
+{
+    AiaSessionTraceRecord_t record = { 100, AIA_TOPIC_SPEAKER, 1000, NULL,
+                                       800 };
+    uint8_t buffer[ AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE ];
+    TEST_ASSERT_EQUAL(
+        6, AiaSessionTrace_WriteRecordHeader( &record, buffer,
+                                              sizeof( buffer ) ) );
+}
+
+TEST( AiaSessionTraceTests, LargestFieldsFit )
+{
+    AiaSessionTraceRecord_t record = { UINT32_MAX, AIA_TOPIC_SPEAKER,
+                                       UINT32_MAX, NULL, SIZE_MAX };
+    uint8_t buffer[ AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE ];
+    size_t written =
+        AiaSessionTrace_WriteRecordHeader( &record, buffer, sizeof( buffer ) );
+    TEST_ASSERT_NOT_EQUAL( 0, written );
+    TEST_ASSERT_TRUE( written <= sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( 0, AiaSessionTrace_WriteRecordHeader( &record, buffer,
+                                                             written - 1 ) );
+
+    /* The payload can never fit the buffer it is claimed to be in. */
+    AiaSessionTraceRecord_t read;
+    TEST_ASSERT_EQUAL( 0,
+                       AiaSessionTrace_ReadRecord( buffer, written, &read ) );
+}
+
+TEST( AiaSessionTraceTests, RejectsTruncatedRecord )
+{
+    static const uint8_t PAYLOAD[] = { 1, 2, 3, 4 };
+    AiaSessionTraceRecord_t record = { 1, AIA_TOPIC_DIRECTIVE, 2, PAYLOAD,
+                                       sizeof( PAYLOAD ) };
+    uint8_t buffer[ 32 ];
+    size_t size = writeRecord( &record, buffer, sizeof( buffer ) );
+
+    AiaSessionTraceRecord_t read;
+    for( size_t i = 0; i < size; ++i )
+    {
+        TEST_ASSERT_EQUAL( 0, AiaSessionTrace_ReadRecord( buffer, i, &read ) );
+    }
+    TEST_ASSERT_EQUAL( size,
+                       AiaSessionTrace_ReadRecord( buffer, size, &read ) );
+
+    /* A varint running past 64 bits is malformed. */
+    memset( buffer, 0xff, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaSessionTrace_ReadRecord( buffer, sizeof( buffer ), &read ) );
+}
+
+TEST( AiaSessionTraceTests, RejectsInvalidTopic )
+{
+    AiaSessionTraceRecord_t record = { 0, AIA_NUM_TOPICS, 0, NULL, 0 };
+    uint8_t buffer[ AIA_SESSION_TRACE_MAX_RECORD_HEADER_SIZE ];
+    TEST_ASSERT_EQUAL( 0, AiaSessionTrace_WriteRecordHeader(
+                              &record, buffer, sizeof( buffer ) ) );
+
+    record.topic = AIA_TOPIC_DIRECTIVE;
+    size_t size =
+        AiaSessionTrace_WriteRecordHeader( &record, buffer, sizeof( buffer ) );
+    TEST_ASSERT_NOT_EQUAL( 0, size );
+    buffer[ 1 ] = AIA_NUM_TOPICS;
+    AiaSessionTraceRecord_t read;
+    TEST_ASSERT_EQUAL( 0, AiaSessionTrace_ReadRecord( buffer, size, &read ) );
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_timer_service_tests.c
+ * @brief Tests for the shared timer service of @c AIA_ENABLE_SHARED_TIMERS
+ * builds.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include AiaClock( HEADER )
+#include AiaTimer( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#ifdef AIA_ENABLE_SHARED_TIMERS
+
+/** How long a test waits for its timers to run. */
+#define TEST_TIMEOUT_MS 2000
+
+/** Number of times @c TestCountingRoutine() has run. */
+static uint32_t g_numRuns;
+
+/** Number of timers @c TestSelfDestroyingRoutine() has destroyed. */
+static uint32_t g_numDestroyed;
+
+static void TestCountingRoutine( void* context )
+{
+    (void)context;
+    AiaAtomic_Add_u32( &g_numRuns, 1 );
+}
+
+/** Destroys and frees the heap-allocated timer passed as @c context. */
+static void TestSelfDestroyingRoutine( void* context )
+{
+    AiaTimer_t* timer = context;
+    AiaTimer( Destroy )( timer );
+    AiaFree( timer );
+    AiaAtomic_Add_u32( &g_numDestroyed, 1 );
+}
+
+/** Waits up to @c TEST_TIMEOUT_MS for @c *counter to reach @c expected. */
+static bool TestWaitFor( uint32_t* counter, uint32_t expected )
+{
+    AiaTimepointMs_t deadlineMs = AiaClock( GetTimeMs )() + TEST_TIMEOUT_MS;
+    while( AiaAtomic_Load_u32( counter ) < expected )
+    {
+        if( AiaClock( GetTimeMs )() >= deadlineMs )
+        {
+            return false;
+        }
+        AiaClock( SleepMs )( 1 );
+    }
+    return true;
+}
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for shared timer service tests.
+ */
+TEST_GROUP( AiaTimerServiceTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for shared timer service tests.
+ */
+TEST_SETUP( AiaTimerServiceTests )
+{
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    g_numRuns = 0;
+    g_numDestroyed = 0;
+    TEST_ASSERT_TRUE( AiaTimerService_Init( 1 ) );
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for shared timer service tests.
+ */
+TEST_TEAR_DOWN( AiaTimerServiceTests )
+{
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    AiaTimerService_Shutdown();
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for shared timer service tests.
+ */
+TEST_GROUP_RUNNER( AiaTimerServiceTests )
+{
+#ifdef AIA_ENABLE_SHARED_TIMERS
+    RUN_TEST_CASE( AiaTimerServiceTests, OneShotTimerRunsOnce );
+    RUN_TEST_CASE( AiaTimerServiceTests, RoutineCanDestroyAndFreeItsTimer );
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+#ifdef AIA_ENABLE_SHARED_TIMERS
+TEST( AiaTimerServiceTests, OneShotTimerRunsOnce )
+{
+    AiaTimer_t timer;
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &timer, TestCountingRoutine, NULL ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timer, 10, 0 ) );
+    TEST_ASSERT_TRUE( TestWaitFor( &g_numRuns, 1 ) );
+    AiaClock( SleepMs )( 50 );
+    TEST_ASSERT_EQUAL( 1, AiaAtomic_Load_u32( &g_numRuns ) );
+    AiaTimer( Destroy )( &timer );
+}
+
+TEST( AiaTimerServiceTests, RoutineCanDestroyAndFreeItsTimer )
+{
+    /* Both a one-shot and a periodic timer, whose worker would otherwise
+     * re-insert it after the routine returns. */
+    for( uint32_t periodMs = 0; periodMs <= 10; periodMs += 10 )
+    {
+        AiaTimer_t* timer = AiaCalloc( 1, sizeof( AiaTimer_t ) );
+        TEST_ASSERT_NOT_NULL( timer );
+        TEST_ASSERT_TRUE(
+            AiaTimer( Create )( timer, TestSelfDestroyingRoutine, timer ) );
+        TEST_ASSERT_TRUE( AiaTimer( Arm )( timer, 10, periodMs ) );
+    }
+    TEST_ASSERT_TRUE( TestWaitFor( &g_numDestroyed, 2 ) );
+
+    /* The only worker is still serving other timers. */
+    AiaTimer_t timer;
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &timer, TestCountingRoutine, NULL ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timer, 10, 0 ) );
+    TEST_ASSERT_TRUE( TestWaitFor( &g_numRuns, 1 ) );
+    AiaTimer( Destroy )( &timer );
+    TEST_ASSERT_EQUAL( 2, AiaAtomic_Load_u32( &g_numDestroyed ) );
+}
+#endif
@@ -22,6 +22,7 @@
 /* The config header is always included first. */
 #include <aia_config.h>
 
+#include <aiacore/aia_endian.h>
 #include <aiacore/aia_mbedtls_threading.h>
 #include <aiacore/aia_random_mbedtls.h>
 #include <aiacore/aia_utils.h>
@@ -78,6 +79,8 @@ TEST_GROUP_RUNNER( AiaUtilsTests )
     RUN_TEST_CASE( AiaUtilsTests, AiaGenerateMessageIdWithoutBuffer );
     RUN_TEST_CASE( AiaUtilsTests, AiaGenerateMessageIdWithoutBufferLength );
     RUN_TEST_CASE( AiaUtilsTests, AiaGenerateMessageId );
+    RUN_TEST_CASE( AiaUtilsTests, AiaGenerateMessageIdIsUnique );
+    RUN_TEST_CASE( AiaUtilsTests, AiaEndianLoadsAndStoresLittleEndian );
 }
 
 /*-----------------------------------------------------------*/
@@ -112,3 +115,44 @@ TEST( AiaUtilsTests, AiaGenerateMessageId )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaUtilsTests, AiaGenerateMessageIdIsUnique )
+{
+    static const size_t NUM_IDS = 1000;
+    char( *ids )[ 9 ] = AiaCalloc( NUM_IDS, sizeof( *ids ) );
+    TEST_ASSERT_NOT_NULL( ids );
+    for( size_t i = 0; i < NUM_IDS; ++i )
+    {
+        TEST_ASSERT_TRUE(
+            AiaGenerateMessageId( ids[ i ], sizeof( ids[ i ] ) ) );
+        for( size_t j = 0; j < i; ++j )
+        {
+            TEST_ASSERT_NOT_EQUAL( 0, strcmp( ids[ i ], ids[ j ] ) );
+        }
+    }
+    AiaFree( ids );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaUtilsTests, AiaEndianLoadsAndStoresLittleEndian )
+{
+    static const uint8_t BYTES[] = { 0xFF, 0x01, 0x02, 0x03, 0x04,
+                                     0x05, 0x06, 0x07, 0x08 };
+
+    /* Loads and stores are unaligned. */
+    TEST_ASSERT_EQUAL_HEX16( 0x0201, AiaEndian_LoadLe16( BYTES + 1 ) );
+    TEST_ASSERT_EQUAL_HEX32( 0x04030201, AiaEndian_LoadLe32( BYTES + 1 ) );
+    TEST_ASSERT_TRUE( UINT64_C( 0x0807060504030201 ) ==
+                      AiaEndian_LoadLe64( BYTES + 1 ) );
+
+    uint8_t buffer[ sizeof( BYTES ) ] = { 0xFF };
+    AiaEndian_StoreLe16( buffer + 1, 0x0201 );
+    TEST_ASSERT_EQUAL_MEMORY( BYTES, buffer, 3 );
+    AiaEndian_StoreLe32( buffer + 1, 0x04030201 );
+    TEST_ASSERT_EQUAL_MEMORY( BYTES, buffer, 5 );
+    AiaEndian_StoreLe64( buffer + 1, UINT64_C( 0x0807060504030201 ) );
+    TEST_ASSERT_EQUAL_MEMORY( BYTES, buffer, sizeof( BYTES ) );
+}
+
+/*-----------------------------------------------------------*/
@@ -0,0 +1,258 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_virtual_time_tests.c
+ * @brief Tests for the virtual clock of @c AIA_ENABLE_VIRTUAL_TIME builds.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include AiaClock( HEADER )
+#include AiaTaskPool( HEADER )
+#include AiaTimer( HEADER )
+
+/* Test framework includes. */
+#include <unity_fixture.h>
+
+#include <string.h>
+
+#ifdef AIA_ENABLE_VIRTUAL_TIME
+
+/** One week, which the tests simulate in well under a second. */
+#define TEST_WEEK_MS ( 7ull * 24 * 60 * 60 * 1000 )
+
+/** Maximum number of expirations a test records. */
+#define TEST_MAX_EXPIRATIONS 8
+
+/** Expirations recorded by @c TestRoutine(), in the order they happened. */
+static struct
+{
+    /** Context of each expiration. */
+    uintptr_t contexts[ TEST_MAX_EXPIRATIONS ];
+
+    /** Virtual time of each expiration. */
+    AiaTimepointMs_t timesMs[ TEST_MAX_EXPIRATIONS ];
+
+    /** Number of expirations, which may exceed @c TEST_MAX_EXPIRATIONS. */
+    size_t count;
+} g_expirations;
+
+static void TestRecord( uintptr_t context )
+{
+    if( g_expirations.count < TEST_MAX_EXPIRATIONS )
+    {
+        g_expirations.contexts[ g_expirations.count ] = context;
+        g_expirations.timesMs[ g_expirations.count ] =
+            AiaClock( GetTimeMs )();
+    }
+    ++g_expirations.count;
+}
+
+static void TestRoutine( void* context )
+{
+    TestRecord( (uintptr_t)context );
+}
+
+static void TestSleepingRoutine( void* context )
+{
+    TestRecord( (uintptr_t)context );
+    AiaClock( SleepMs )( 5 );
+}
+
+static void TestJobRoutine( AiaTaskPool_t taskPool, AiaTaskPoolJob_t job,
+                            void* context )
+{
+    (void)taskPool;
+    (void)job;
+    TestRecord( (uintptr_t)context );
+}
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for virtual time tests.
+ */
+TEST_GROUP( AiaVirtualTimeTests );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for virtual time tests.
+ */
+TEST_SETUP( AiaVirtualTimeTests )
+{
+#ifdef AIA_ENABLE_VIRTUAL_TIME
+    memset( &g_expirations, 0, sizeof( g_expirations ) );
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for virtual time tests.
+ */
+TEST_TEAR_DOWN( AiaVirtualTimeTests )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for virtual time tests.
+ */
+TEST_GROUP_RUNNER( AiaVirtualTimeTests )
+{
+#ifdef AIA_ENABLE_VIRTUAL_TIME
+    RUN_TEST_CASE( AiaVirtualTimeTests, ClockOnlyMovesWhenAdvanced );
+    RUN_TEST_CASE( AiaVirtualTimeTests, TimersRunInDeadlineOrder );
+    RUN_TEST_CASE( AiaVirtualTimeTests, PeriodicTimerRunsForAWeek );
+    RUN_TEST_CASE( AiaVirtualTimeTests, RunNextJumpsToNextDeadline );
+    RUN_TEST_CASE( AiaVirtualTimeTests, SleepInRoutineOnlyAdvancesClock );
+    RUN_TEST_CASE( AiaVirtualTimeTests, DeferredJobRunsInVirtualTime );
+    RUN_TEST_CASE( AiaVirtualTimeTests, PendingDeferredJobCanBeCancelled );
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
+#ifdef AIA_ENABLE_VIRTUAL_TIME
+TEST( AiaVirtualTimeTests, ClockOnlyMovesWhenAdvanced )
+{
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_TRUE( startMs == AiaClock( GetTimeMs )() );
+    AiaClock( SleepMs )( 1234 );
+    TEST_ASSERT_TRUE( startMs + 1234 == AiaClock( GetTimeMs )() );
+    TEST_ASSERT_EQUAL( 0, AiaVirtualTime_RunUntil( startMs ) );
+    TEST_ASSERT_TRUE( startMs + 1234 == AiaClock( GetTimeMs )() );
+}
+
+TEST( AiaVirtualTimeTests, TimersRunInDeadlineOrder )
+{
+    AiaTimer_t timers[ 3 ];
+    for( uintptr_t i = 0; i < 3; ++i )
+    {
+        TEST_ASSERT_TRUE(
+            AiaTimer( Create )( &timers[ i ], TestRoutine, (void*)i ) );
+    }
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timers[ 0 ], 300, 0 ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timers[ 1 ], 100, 0 ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timers[ 2 ], 100, 0 ) );
+
+    TEST_ASSERT_EQUAL( 3, AiaVirtualTime_RunFor( 1000 ) );
+    TEST_ASSERT_EQUAL( 3, g_expirations.count );
+    /* Timers with the same deadline run in the order they were armed. */
+    TEST_ASSERT_EQUAL( 1, g_expirations.contexts[ 0 ] );
+    TEST_ASSERT_TRUE( startMs + 100 == g_expirations.timesMs[ 0 ] );
+    TEST_ASSERT_EQUAL( 2, g_expirations.contexts[ 1 ] );
+    TEST_ASSERT_TRUE( startMs + 100 == g_expirations.timesMs[ 1 ] );
+    TEST_ASSERT_EQUAL( 0, g_expirations.contexts[ 2 ] );
+    TEST_ASSERT_TRUE( startMs + 300 == g_expirations.timesMs[ 2 ] );
+    TEST_ASSERT_TRUE( startMs + 1000 == AiaClock( GetTimeMs )() );
+
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaTimer( Destroy )( &timers[ i ] );
+    }
+}
+
+TEST( AiaVirtualTimeTests, PeriodicTimerRunsForAWeek )
+{
+    AiaTimer_t timer;
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &timer, TestRoutine, NULL ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timer, 60000, 60000 ) );
+    AiaVirtualTime_RunFor( TEST_WEEK_MS );
+    TEST_ASSERT_EQUAL( TEST_WEEK_MS / 60000, g_expirations.count );
+    AiaTimer( Destroy )( &timer );
+
+    /* A destroyed timer no longer runs. */
+    AiaVirtualTime_RunFor( TEST_WEEK_MS );
+    TEST_ASSERT_EQUAL( TEST_WEEK_MS / 60000, g_expirations.count );
+}
+
+TEST( AiaVirtualTimeTests, RunNextJumpsToNextDeadline )
+{
+    TEST_ASSERT_FALSE( AiaVirtualTime_RunNext() );
+
+    AiaTimer_t timer;
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &timer, TestRoutine, NULL ) );
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &timer, TEST_WEEK_MS / 7, 0 ) );
+    TEST_ASSERT_TRUE( AiaVirtualTime_RunNext() );
+    TEST_ASSERT_EQUAL( 1, g_expirations.count );
+    TEST_ASSERT_TRUE( startMs + TEST_WEEK_MS / 7 == AiaClock( GetTimeMs )() );
+    TEST_ASSERT_FALSE( AiaVirtualTime_RunNext() );
+    AiaTimer( Destroy )( &timer );
+}
+
+TEST( AiaVirtualTimeTests, SleepInRoutineOnlyAdvancesClock )
+{
+    AiaTimer_t sleeping;
+    AiaTimer_t other;
+    TEST_ASSERT_TRUE(
+        AiaTimer( Create )( &sleeping, TestSleepingRoutine, (void*)0 ) );
+    TEST_ASSERT_TRUE( AiaTimer( Create )( &other, TestRoutine, (void*)1 ) );
+    AiaTimepointMs_t startMs = AiaClock( GetTimeMs )();
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &sleeping, 10, 0 ) );
+    TEST_ASSERT_TRUE( AiaTimer( Arm )( &other, 12, 0 ) );
+
+    /* The sleep moves the clock past the other deadline, which then runs
+     * late rather than from within the sleeping routine. */
+    TEST_ASSERT_EQUAL( 2, AiaVirtualTime_RunFor( 100 ) );
+    TEST_ASSERT_EQUAL( 0, g_expirations.contexts[ 0 ] );
+    TEST_ASSERT_TRUE( startMs + 10 == g_expirations.timesMs[ 0 ] );
+    TEST_ASSERT_EQUAL( 1, g_expirations.contexts[ 1 ] );
+    TEST_ASSERT_TRUE( startMs + 15 == g_expirations.timesMs[ 1 ] );
+
+    AiaTimer( Destroy )( &sleeping );
+    AiaTimer( Destroy )( &other );
+}
+
+TEST( AiaVirtualTimeTests, DeferredJobRunsInVirtualTime )
+{
+    AiaTaskPoolJobStorage_t storage = AiaTaskPool( JOB_STORAGE_INITIALIZER );
+    AiaTaskPoolJob_t job = AiaTaskPool( JOB_INITIALIZER );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( AiaTaskPool( CreateJob )(
+        TestJobRoutine, (void*)7, &storage, &job ) ) );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( AiaTaskPool( ScheduleDeferred )(
+        AiaTaskPool( GetSystemTaskPool )(), job, TEST_WEEK_MS / 7 ) ) );
+
+    AiaVirtualTime_RunFor( TEST_WEEK_MS / 7 - 1 );
+    TEST_ASSERT_EQUAL( 0, g_expirations.count );
+    AiaVirtualTime_RunFor( 1 );
+    TEST_ASSERT_EQUAL( 1, g_expirations.count );
+    TEST_ASSERT_EQUAL( 7, g_expirations.contexts[ 0 ] );
+}
+
+TEST( AiaVirtualTimeTests, PendingDeferredJobCanBeCancelled )
+{
+    AiaTaskPoolJobStorage_t storage = AiaTaskPool( JOB_STORAGE_INITIALIZER );
+    AiaTaskPoolJob_t job = AiaTaskPool( JOB_INITIALIZER );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded(
+        AiaTaskPool( CreateJob )( TestJobRoutine, NULL, &storage, &job ) ) );
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( AiaTaskPool( ScheduleDeferred )(
+        AiaTaskPool( GetSystemTaskPool )(), job, 1000 ) ) );
+
+    TEST_ASSERT_TRUE( AiaTaskPoolSucceeded( AiaTaskPool( TryCancel )(
+        AiaTaskPool( GetSystemTaskPool )(), job, NULL ) ) );
+    AiaVirtualTime_RunFor( 2000 );
+    TEST_ASSERT_EQUAL( 0, g_expirations.count );
+}
+#endif
@@ -49,6 +49,7 @@ static AiaRegulator_t* testRegulator;
 static AiaRegulator_t* testCapabilitiesRegulator;
 static AiaCapabilitiesSender_t* testCapabilitiesSender;
 static AiaSecretManager_t* testSecretManager;
+static AiaExceptionLimiter_t* testExceptionLimiter;
 
 static void AiaOnCapabilitiesStateChanged( AiaCapabilitiesSenderState_t state,
                                            const char* description,
@@ -162,6 +163,10 @@ TEST_GROUP_RUNNER( AiaDispatcherTests )
 #ifdef AIA_ENABLE_SPEAKER
     RUN_TEST_CASE( AiaDispatcherTests, AddHandlerHappyCase );
 #endif
+    RUN_TEST_CASE( AiaDispatcherTests, AddBatchHandlerNullDispatcher );
+    RUN_TEST_CASE( AiaDispatcherTests, AddBatchHandlerNullHandler );
+    RUN_TEST_CASE( AiaDispatcherTests, AddBatchHandlerNullUserData );
+    RUN_TEST_CASE( AiaDispatcherTests, AddBatchHandlerHappyCase );
     RUN_TEST_CASE( AiaDispatcherTests, CallbackNullDispatcher );
     RUN_TEST_CASE( AiaDispatcherTests, CallbackOnInvalidTopic );
     RUN_TEST_CASE( AiaDispatcherTests, CallbackWithEmptyPayload );
@@ -170,6 +175,11 @@ TEST_GROUP_RUNNER( AiaDispatcherTests )
     RUN_TEST_CASE( AiaDispatcherTests, CallbackOnSpeakerTopic );
 #endif
     RUN_TEST_CASE( AiaDispatcherTests, CallbackOnCapabilitiesAcknowledgeTopic );
+    RUN_TEST_CASE( AiaDispatcherTests, CallbackOnDirectiveTopicDecryptInPlace );
+    RUN_TEST_CASE( AiaDispatcherTests, GetTopicHandler );
+    RUN_TEST_CASE( AiaDispatcherTests, TopicHandlerOnDirectiveTopic );
+    RUN_TEST_CASE( AiaDispatcherTests, GetTopicBatchHandler );
+    RUN_TEST_CASE( AiaDispatcherTests, BatchHandlerOnDirectiveTopic );
     RUN_TEST_CASE( AiaDispatcherTests,
                    CallbackOnConnectionFromServiceTopicInvalidPayload );
     RUN_TEST_CASE( AiaDispatcherTests,
@@ -180,6 +190,19 @@ TEST_GROUP_RUNNER( AiaDispatcherTests )
     RUN_TEST_CASE( AiaDispatcherTests, AddSpeakerManagerDispatcherNull );
     RUN_TEST_CASE( AiaDispatcherTests, AddSpeakerManagerNull );
 #endif
+    RUN_TEST_CASE( AiaDispatcherTests, SetDecryptInPlaceNullDispatcher );
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+    RUN_TEST_CASE( AiaDispatcherTests, SetParallelDirectivesNullDispatcher );
+    RUN_TEST_CASE( AiaDispatcherTests, SetParallelDirectivesPerManager );
+#endif
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    RUN_TEST_CASE( AiaDispatcherTests, SetSpeculativeDecryptionNullDispatcher );
+    RUN_TEST_CASE( AiaDispatcherTests, SetSpeculativeDecryptionToggles );
+#endif
+    RUN_TEST_CASE( AiaDispatcherTests, DirectiveFromStringRoundTrips );
+    RUN_TEST_CASE( AiaDispatcherTests, DirectiveFromStringUnknownNames );
+    RUN_TEST_CASE( AiaDispatcherTests, TopicFromStringRoundTrips );
+    RUN_TEST_CASE( AiaDispatcherTests, TopicFromStringUnknownNames );
     RUN_TEST_CASE( AiaDispatcherTests, DestroyNull );
 }
 
@@ -210,10 +233,16 @@ TEST_SETUP( AiaDispatcherTests )
     testSecretManager = AiaSecretManager_Create( NULL, NULL, NULL, NULL );
     TEST_ASSERT_NOT_NULL( testSecretManager );
 
+    /** Create testExceptionLimiter */
+    testExceptionLimiter =
+        AiaExceptionLimiter_Create( testRegulator, AIA_EXCEPTION_EVENT_BURST,
+                                    AIA_EXCEPTION_EVENT_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( testExceptionLimiter );
+
     /** Create the testDispatcher */
-    testDispatcher = AiaDispatcher_Create( AiaTaskPool( GetSystemTaskPool )(),
-                                           testCapabilitiesSender,
-                                           testRegulator, testSecretManager );
+    testDispatcher = AiaDispatcher_Create(
+        AiaTaskPool( GetSystemTaskPool )(), testCapabilitiesSender,
+        testRegulator, testSecretManager, testExceptionLimiter );
     TEST_ASSERT_NOT_NULL( testDispatcher );
     TEST_ASSERT_NOT_NULL( testDispatcher->directiveSequencer );
     TEST_ASSERT_NOT_NULL( testDispatcher->capabilitiesAcknowledgeSequencer );
@@ -236,6 +265,7 @@ TEST_TEAR_DOWN( AiaDispatcherTests )
 {
     AiaSpeakerManager_Destroy( testSpeakerManager );
     AiaDispatcher_Destroy( testDispatcher );
+    AiaExceptionLimiter_Destroy( testExceptionLimiter );
     AiaCapabilitiesSender_Destroy( testCapabilitiesSender );
     AiaMockRegulator_Destroy( (AiaMockRegulator_t*)testCapabilitiesRegulator,
                               AiaTestUtilities_DestroyJsonChunk, NULL );
@@ -252,23 +282,29 @@ TEST( AiaDispatcherTests, Creation )
 {
     AiaDispatcher_t* invalidDispatcher = NULL;
 
+    invalidDispatcher =
+        AiaDispatcher_Create( NULL, testCapabilitiesSender, testRegulator,
+                              testSecretManager, testExceptionLimiter );
+    TEST_ASSERT_NULL( invalidDispatcher );
+
     invalidDispatcher = AiaDispatcher_Create(
-        NULL, testCapabilitiesSender, testRegulator, testSecretManager );
+        AiaTaskPool( GetSystemTaskPool )(), NULL, testRegulator,
+        testSecretManager, testExceptionLimiter );
     TEST_ASSERT_NULL( invalidDispatcher );
 
-    invalidDispatcher =
-        AiaDispatcher_Create( AiaTaskPool( GetSystemTaskPool )(), NULL,
-                              testRegulator, testSecretManager );
+    invalidDispatcher = AiaDispatcher_Create(
+        AiaTaskPool( GetSystemTaskPool )(), testCapabilitiesSender, NULL,
+        testSecretManager, testExceptionLimiter );
     TEST_ASSERT_NULL( invalidDispatcher );
 
-    invalidDispatcher =
-        AiaDispatcher_Create( AiaTaskPool( GetSystemTaskPool )(),
-                              testCapabilitiesSender, NULL, testSecretManager );
+    invalidDispatcher = AiaDispatcher_Create(
+        AiaTaskPool( GetSystemTaskPool )(), testCapabilitiesSender,
+        testRegulator, NULL, testExceptionLimiter );
     TEST_ASSERT_NULL( invalidDispatcher );
 
-    invalidDispatcher =
-        AiaDispatcher_Create( AiaTaskPool( GetSystemTaskPool )(),
-                              testCapabilitiesSender, testRegulator, NULL );
+    invalidDispatcher = AiaDispatcher_Create(
+        AiaTaskPool( GetSystemTaskPool )(), testCapabilitiesSender,
+        testRegulator, testSecretManager, NULL );
     TEST_ASSERT_NULL( invalidDispatcher );
 }
 
@@ -311,6 +347,37 @@ TEST( AiaDispatcherTests, AddHandlerHappyCase )
 }
 #endif
 
+static void TestDirectiveBatchHandler( void* component,
+                                       AiaSequenceNumber_t sequenceNumber )
+{
+    (void)component;
+    (void)sequenceNumber;
+}
+
+TEST( AiaDispatcherTests, AddBatchHandlerNullDispatcher )
+{
+    TEST_ASSERT_FALSE( AiaDispatcher_AddBatchHandler(
+        NULL, TestDirectiveBatchHandler, testDispatcher ) );
+}
+
+TEST( AiaDispatcherTests, AddBatchHandlerNullHandler )
+{
+    TEST_ASSERT_FALSE(
+        AiaDispatcher_AddBatchHandler( testDispatcher, NULL, testDispatcher ) );
+}
+
+TEST( AiaDispatcherTests, AddBatchHandlerNullUserData )
+{
+    TEST_ASSERT_FALSE( AiaDispatcher_AddBatchHandler(
+        testDispatcher, TestDirectiveBatchHandler, NULL ) );
+}
+
+TEST( AiaDispatcherTests, AddBatchHandlerHappyCase )
+{
+    TEST_ASSERT_TRUE( AiaDispatcher_AddBatchHandler(
+        testDispatcher, TestDirectiveBatchHandler, testDispatcher ) );
+}
+
 TEST( AiaDispatcherTests, CallbackNullDispatcher )
 {
     AiaMqttCallbackParam_t* callbackParam = generateCallbackParam(
@@ -361,6 +428,96 @@ TEST( AiaDispatcherTests, CallbackOnCapabilitiesAcknowledgeTopic )
     AiaFree( (void*)callbackParam );
 }
 
+TEST( AiaDispatcherTests, GetTopicHandler )
+{
+    TEST_ASSERT_NOT_NULL(
+        AiaDispatcher_GetTopicHandler( AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_NOT_NULL( AiaDispatcher_GetTopicHandler(
+        AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE ) );
+    TEST_ASSERT_NOT_NULL(
+        AiaDispatcher_GetTopicHandler( AIA_TOPIC_CONNECTION_FROM_SERVICE ) );
+#ifdef AIA_ENABLE_SPEAKER
+    TEST_ASSERT_NOT_NULL( AiaDispatcher_GetTopicHandler( AIA_TOPIC_SPEAKER ) );
+#endif
+
+    /* Outbound topics are not handled. */
+    TEST_ASSERT_NULL( AiaDispatcher_GetTopicHandler( AIA_TOPIC_EVENT ) );
+    TEST_ASSERT_NULL( AiaDispatcher_GetTopicHandler( AIA_TOPIC_MICROPHONE ) );
+}
+
+TEST( AiaDispatcherTests, TopicHandlerOnDirectiveTopic )
+{
+    AiaMqttTopicHandler_t handler =
+        AiaDispatcher_GetTopicHandler( AIA_TOPIC_DIRECTIVE );
+    TEST_ASSERT_NOT_NULL( handler );
+
+    /* The topic is not looked at, since routing is done when subscribing. */
+    AiaMqttCallbackParam_t* callbackParam =
+        generateCallbackParam( "", TEST_PAYLOAD_SINGLE );
+    handler( NULL, callbackParam );
+    handler( testDispatcher, callbackParam );
+    AiaFree( (void*)callbackParam );
+}
+
+TEST( AiaDispatcherTests, GetTopicBatchHandler )
+{
+    TEST_ASSERT_NOT_NULL(
+        AiaDispatcher_GetTopicBatchHandler( AIA_TOPIC_DIRECTIVE ) );
+    TEST_ASSERT_NOT_NULL( AiaDispatcher_GetTopicBatchHandler(
+        AIA_TOPIC_CAPABILITIES_ACKNOWLEDGE ) );
+#ifdef AIA_ENABLE_SPEAKER
+    TEST_ASSERT_NOT_NULL(
+        AiaDispatcher_GetTopicBatchHandler( AIA_TOPIC_SPEAKER ) );
+#endif
+
+    /* Unsequenced topics are handled one message at a time. */
+    TEST_ASSERT_NULL( AiaDispatcher_GetTopicBatchHandler(
+        AIA_TOPIC_CONNECTION_FROM_SERVICE ) );
+    TEST_ASSERT_NULL( AiaDispatcher_GetTopicBatchHandler( AIA_TOPIC_EVENT ) );
+}
+
+TEST( AiaDispatcherTests, BatchHandlerOnDirectiveTopic )
+{
+    AiaMqttBatchTopicHandler_t handler =
+        AiaDispatcher_GetTopicBatchHandler( AIA_TOPIC_DIRECTIVE );
+    TEST_ASSERT_NOT_NULL( handler );
+
+    AiaMqttCallbackParam_t* callbackParams[] = {
+        generateCallbackParam( "", TEST_PAYLOAD_SINGLE ),
+        generateCallbackParam( "", "" ),
+        generateCallbackParam( "", TEST_PAYLOAD_SINGLE )
+    };
+    static const size_t NUM_MESSAGES =
+        sizeof( callbackParams ) / sizeof( callbackParams[ 0 ] );
+    for( size_t i = 0; i < NUM_MESSAGES; ++i )
+    {
+        TEST_ASSERT_NOT_NULL( callbackParams[ i ] );
+    }
+    handler( NULL, callbackParams, NUM_MESSAGES );
+    handler( testDispatcher, NULL, NUM_MESSAGES );
+    handler( testDispatcher, callbackParams, 0 );
+    handler( testDispatcher, callbackParams, NUM_MESSAGES );
+    for( size_t i = 0; i < NUM_MESSAGES; ++i )
+    {
+        AiaFree( (void*)callbackParams[ i ] );
+    }
+}
+
+TEST( AiaDispatcherTests, CallbackOnDirectiveTopicDecryptInPlace )
+{
+    /* Payloads are written to when decrypting in place, so use a copy. */
+    char* payload = AiaCalloc( 1, strlen( TEST_PAYLOAD_SINGLE ) + 1 );
+    TEST_ASSERT_NOT_NULL( payload );
+    strcpy( payload, TEST_PAYLOAD_SINGLE );
+
+    AiaDispatcher_SetDecryptInPlace( testDispatcher, true );
+    AiaMqttCallbackParam_t* callbackParam =
+        generateCallbackParam( TEST_TOPIC_STRING( DIRECTIVE ), payload );
+    messageReceivedCallback( testDispatcher, callbackParam );
+    AiaFree( (void*)callbackParam );
+    AiaFree( payload );
+}
+
 TEST( AiaDispatcherTests, CallbackOnConnectionFromServiceTopicInvalidPayload )
 {
     /** Payload does not have the name field */
@@ -426,6 +583,136 @@ TEST( AiaDispatcherTests, AddSpeakerManagerNull )
 }
 #endif
 
+TEST( AiaDispatcherTests, SetDecryptInPlaceNullDispatcher )
+{
+    /* No asserts just to exercise code path. */
+    AiaDispatcher_SetDecryptInPlace( NULL, true );
+}
+
+#ifdef AIA_ENABLE_PARALLEL_DIRECTIVES
+static void TestDirectiveHandler( void* component, const void* payload,
+                                  size_t size,
+                                  AiaSequenceNumber_t sequenceNumber,
+                                  size_t index )
+{
+    (void)component;
+    (void)payload;
+    (void)size;
+    (void)sequenceNumber;
+    (void)index;
+}
+
+TEST( AiaDispatcherTests, SetParallelDirectivesNullDispatcher )
+{
+    TEST_ASSERT_FALSE( AiaDispatcher_SetParallelDirectives( NULL, true ) );
+}
+
+TEST( AiaDispatcherTests, SetParallelDirectivesPerManager )
+{
+    static int component1;
+    static int component2;
+    TEST_ASSERT_TRUE( AiaDispatcher_AddHandler(
+        testDispatcher, TestDirectiveHandler, AIA_DIRECTIVE_SET_ATTENTION_STATE,
+        &component1 ) );
+    TEST_ASSERT_TRUE( AiaDispatcher_AddHandler( testDispatcher,
+                                                TestDirectiveHandler,
+                                                AIA_DIRECTIVE_EXCEPTION,
+                                                &component2 ) );
+    TEST_ASSERT_TRUE( AiaDispatcher_AddHandler(
+        testDispatcher, TestDirectiveHandler, AIA_DIRECTIVE_ROTATE_SECRET,
+        testSecretManager ) );
+
+    /* The secret manager's directives stay on the sequencer's thread. */
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetParallelDirectives( testDispatcher, true ) );
+    TEST_ASSERT_EQUAL( 2, testDispatcher->numDirectiveWorkers );
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetParallelDirectives( testDispatcher, true ) );
+    TEST_ASSERT_EQUAL( 2, testDispatcher->numDirectiveWorkers );
+
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetParallelDirectives( testDispatcher, false ) );
+    TEST_ASSERT_NULL( testDispatcher->directiveWorkers );
+    TEST_ASSERT_EQUAL( 0, testDispatcher->numDirectiveWorkers );
+}
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+TEST( AiaDispatcherTests, SetSpeculativeDecryptionNullDispatcher )
+{
+    TEST_ASSERT_FALSE( AiaDispatcher_SetSpeculativeDecryption( NULL, true ) );
+}
+
+TEST( AiaDispatcherTests, SetSpeculativeDecryptionToggles )
+{
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetSpeculativeDecryption( testDispatcher, true ) );
+    TEST_ASSERT_NOT_NULL( testDispatcher->speculation );
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetSpeculativeDecryption( testDispatcher, true ) );
+
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetSpeculativeDecryption( testDispatcher, false ) );
+    TEST_ASSERT_NULL( testDispatcher->speculation );
+
+    /* The worker is also stopped when the dispatcher is destroyed. */
+    TEST_ASSERT_TRUE(
+        AiaDispatcher_SetSpeculativeDecryption( testDispatcher, true ) );
+}
+#endif
+
+TEST( AiaDispatcherTests, DirectiveFromStringRoundTrips )
+{
+    for( int i = 0; i < (int)AIA_NUM_DIRECTIVES; ++i )
+    {
+        AiaDirective_t directive = (AiaDirective_t)i;
+        AiaDirective_t parsed = AIA_NUM_DIRECTIVES;
+        TEST_ASSERT_TRUE( AiaDirective_FromString(
+            AiaDirective_ToString( directive ),
+            AiaDirective_GetLength( directive ), &parsed ) );
+        TEST_ASSERT_EQUAL( directive, parsed );
+        parsed = AIA_NUM_DIRECTIVES;
+        TEST_ASSERT_TRUE( AiaDirective_FromString(
+            AiaDirective_ToString( directive ), 0, &parsed ) );
+        TEST_ASSERT_EQUAL( directive, parsed );
+    }
+}
+
+TEST( AiaDispatcherTests, DirectiveFromStringUnknownNames )
+{
+    AiaDirective_t parsed;
+    /* Same hash inputs as "SetAlert" but a different name. */
+    TEST_ASSERT_FALSE( AiaDirective_FromString( "SetAbout", 0, &parsed ) );
+    TEST_ASSERT_FALSE( AiaDirective_FromString( "SetAlart", 0, &parsed ) );
+    TEST_ASSERT_FALSE( AiaDirective_FromString( "", 0, &parsed ) );
+    TEST_ASSERT_FALSE( AiaDirective_FromString( NULL, 0, &parsed ) );
+    TEST_ASSERT_FALSE( AiaDirective_FromString(
+        AIA_DIRECTIVE_EXCEPTION_STRING, 0, NULL ) );
+}
+
+TEST( AiaDispatcherTests, TopicFromStringRoundTrips )
+{
+    for( int i = 0; i < (int)AIA_NUM_TOPICS; ++i )
+    {
+        AiaTopic_t topic = (AiaTopic_t)i;
+        AiaTopic_t parsed = AIA_NUM_TOPICS;
+        TEST_ASSERT_TRUE( AiaTopic_FromString(
+            AiaTopic_ToString( topic ), AiaTopic_GetLength( topic ),
+            &parsed ) );
+        TEST_ASSERT_EQUAL( topic, parsed );
+    }
+}
+
+TEST( AiaDispatcherTests, TopicFromStringUnknownNames )
+{
+    AiaTopic_t parsed;
+    /* Same length as "directive" but a different name. */
+    TEST_ASSERT_FALSE( AiaTopic_FromString( "directivf", 0, &parsed ) );
+    TEST_ASSERT_FALSE(
+        AiaTopic_FromString( "speaker/extra/long", 0, &parsed ) );
+    TEST_ASSERT_FALSE( AiaTopic_FromString( NULL, 0, &parsed ) );
+}
+
 TEST( AiaDispatcherTests, DestroyNull )
 {
     /* No asserts just to exercise code path. */
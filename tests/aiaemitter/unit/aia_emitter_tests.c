@@ -29,6 +29,8 @@
 #include <aiacore/aia_message_constants.h>
 #include <aiaemitter/aia_emitter.h>
 
+#include AiaClock( HEADER )
+
 /* Test framework includes. */
 #include <unity_fixture.h>
 
@@ -82,6 +84,9 @@ typedef struct AiaEmitterTestData
     /** Next sequence number to emit. */
     AiaSequenceNumber_t nextSequenceNumber;
 
+    /** The quality of service messages are expected to be published with. */
+    AiaMqttQos_t expectedQos;
+
     /** An MQTT connection object to use for publishing. */
     AiaMqttConnectionPointer_t mqttConnection;
 
@@ -181,15 +186,19 @@ static bool AiaEmitterTest_ValidateJsonMqttMessage( AiaEmitterTestData_t* data,
     }
 
     /* Extract the individual array elements and validate them. */
-    /* TODO: rework this so that we don't have to rescan the whole array
-     * repeatedly (ADSER-1654) */
-    /* TODO: rework this so that we can distinguish between end-of-array and
-     * other errors (ADSER-1654) */
+    AiaJsonArrayIterator_t iterator;
     const char* arrayElement;
     size_t arrayElementLength;
     size_t index = 0;
-    while( AiaJsonUtils_GetArrayElement( array, arrayLength, index,
-                                         &arrayElement, &arrayElementLength ) )
+    if( !AiaJsonArrayIterator_Initialize( &iterator, array, arrayLength ) )
+    {
+        AiaLogError( "Invalid \"%.*s\" array in message.", arrayNameLength,
+                     arrayName );
+        AiaAtomicBool_Set( &g_aiaEmitterTestData.internalTestFailure );
+        return false;
+    }
+    while( AiaJsonArrayIterator_Next( &iterator, &arrayElement,
+                                      &arrayElementLength ) )
     {
         if( !AiaEmitterTest_ValidateIndividualJsonMessage(
                 data, topic, arrayElement, arrayElementLength ) )
@@ -202,6 +211,13 @@ static bool AiaEmitterTest_ValidateJsonMqttMessage( AiaEmitterTestData_t* data,
         ++index;
     }
 
+    if( !iterator.complete )
+    {
+        AiaLogError( "Malformed json array element %zu.", index );
+        AiaAtomicBool_Set( &g_aiaEmitterTestData.internalTestFailure );
+        return false;
+    }
+
     return true;
 }
 
@@ -325,9 +341,9 @@ bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
         AiaLogError( "Null connection." );
         return false;
     }
-    if( AIA_MQTT_QOS0 != qos )
+    if( data->expectedQos != qos )
     {
-        AiaLogError( "qos (%d) is not QOS0.", qos );
+        AiaLogError( "Unexpected qos (%d != %d).", qos, data->expectedQos );
         AiaAtomicBool_Set( &data->internalTestFailure );
         return false;
     }
@@ -463,6 +479,20 @@ bool AiaMqttPublish( AiaMqttConnectionPointer_t connection, AiaMqttQos_t qos,
     return false;
 }
 
+#ifdef AIA_ENABLE_MQTT_PUBLISH_HEADROOM
+/* Mock in-place publisher, which checks the headroom can be written. */
+bool AiaMqttPublishWithHeadroom( AiaMqttConnectionPointer_t connection,
+                                 AiaMqttQos_t qos, const char* topic,
+                                 size_t topicLength, uint8_t* message,
+                                 size_t messageLength )
+{
+    size_t headroom = AIA_MQTT_PUBLISH_HEADROOM( topicLength );
+    memset( message - headroom, 0xff, headroom );
+    return AiaMqttPublish( connection, qos, topic, topicLength, message,
+                           messageLength );
+}
+#endif
+
 /* Mock secret manager. */
 bool AiaSecretManager_Encrypt( AiaSecretManager_t* secretManager,
                                AiaTopic_t topic,
@@ -540,6 +570,37 @@ bool AiaSecretManager_Encrypt( AiaSecretManager_t* secretManager,
     return true;
 }
 
+/* Mock of the asynchronous encryption, which completes inline using the mock
+ * AiaSecretManager_Encrypt() above. */
+bool AiaSecretManager_SubmitEncrypt( AiaSecretManager_t* secretManager,
+                                     AiaTopic_t topic,
+                                     AiaSequenceNumber_t sequenceNumber,
+                                     const AiaCryptoRequest_t* request )
+{
+    AiaEmitterTestData_t* data = (AiaEmitterTestData_t*)secretManager;
+    if( !data )
+    {
+        AiaLogError( "Null connection." );
+        return false;
+    }
+    if( !request || !request->segments || !request->onComplete )
+    {
+        AiaLogError( "Invalid request." );
+        AiaAtomicBool_Set( &data->internalTestFailure );
+        return false;
+    }
+    bool success = true;
+    for( size_t i = 0; i < request->numSegments && success; ++i )
+    {
+        success = AiaSecretManager_Encrypt(
+            secretManager, topic, sequenceNumber, request->segments[ i ].input,
+            request->segments[ i ].length, request->segments[ i ].output,
+            request->iv, request->ivLen, request->tag, request->tagLen );
+    }
+    request->onComplete( success, request->userData );
+    return true;
+}
+
 /**
  * Generalized test function used by the test cases below which verifies that
  * messages are emitted as expected.
@@ -650,6 +711,7 @@ static void AiaEmitterTest_TestEmitMessages( AiaEmitterTestData_t* data,
     }
 
     /* Should come out as a single MQTT publish with all the AIS messages. */
+    TEST_ASSERT_TRUE( AiaEmitter_FlushPublishes( emitter ) );
     TEST_ASSERT_EQUAL( numMessages,
                        AiaListDouble( Count )( &data->publishedMessages ) );
 
@@ -684,6 +746,33 @@ static void AiaEmitterTest_TestEmitMessages( AiaEmitterTestData_t* data,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * Creates a binary microphone content message.
+ *
+ * @param offset The microphone offset of the audio.
+ * @param audioFill The byte value to fill the audio with.
+ * @param audioSize The number of bytes of audio.
+ * @return The new message.
+ */
+static AiaMessage_t* AiaEmitterTest_CreateMicrophoneContent(
+    AiaBinaryAudioStreamOffset_t offset, uint8_t audioFill, size_t audioSize )
+{
+    size_t length = sizeof( offset ) + audioSize;
+    uint8_t* data = AiaCalloc( 1, length );
+    TEST_ASSERT_NOT_NULL( data );
+    for( size_t i = 0; i < sizeof( offset ); ++i )
+    {
+        data[ i ] = offset >> ( i * 8 );
+    }
+    memset( data + sizeof( offset ), audioFill, audioSize );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_Create(
+        length, AIA_BINARY_STREAM_MICROPHONE_CONTENT_TYPE, 0, data );
+    TEST_ASSERT_NOT_NULL( binaryMessage );
+    return AiaBinaryMessage_ToMessage( binaryMessage );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test setup for AiaEmitter_t tests.
  */
@@ -691,6 +780,7 @@ TEST_SETUP( AiaEmitterTests )
 {
     memset( &g_aiaEmitterTestData, 0, sizeof( g_aiaEmitterTestData ) );
     AiaAtomicBool_Clear( &g_aiaEmitterTestData.internalTestFailure );
+    g_aiaEmitterTestData.expectedQos = AIA_MQTT_QOS0;
 
     AiaListDouble( Create )( &g_aiaEmitterTestData.publishedMessages );
 
@@ -755,7 +845,19 @@ TEST_GROUP_RUNNER( AiaEmitterTests )
     RUN_TEST_CASE( AiaEmitterTests, EmitMultiChunkJsonMessage );
     RUN_TEST_CASE( AiaEmitterTests, EmitSingleChunkBinaryMessage );
     RUN_TEST_CASE( AiaEmitterTests, EmitMultiChunkBinaryMessage );
+    RUN_TEST_CASE( AiaEmitterTests, EmitCoalescedMicrophoneContent );
+    RUN_TEST_CASE( AiaEmitterTests, EnablePayloadBufferReuseWithNullArgs );
+    RUN_TEST_CASE( AiaEmitterTests, EmitBinaryWithPayloadBufferReuse );
+    RUN_TEST_CASE( AiaEmitterTests, EmitArrayJsonWithPayloadBufferReuse );
+    RUN_TEST_CASE( AiaEmitterTests, EmitBinaryAfterTrimMemory );
     RUN_TEST_CASE( AiaEmitterTests, GetNextSequenceNumberWithNullArgs );
+    RUN_TEST_CASE( AiaEmitterTests, EnableAsyncPublishWithInvalidArgs );
+    RUN_TEST_CASE( AiaEmitterTests, EmitBinaryWithAsyncPublish );
+    RUN_TEST_CASE( AiaEmitterTests, EmitArrayJsonWithAsyncPublish );
+    RUN_TEST_CASE( AiaEmitterTests, EmitBinaryAfterTrimMemoryWithAsyncPublish );
+    RUN_TEST_CASE( AiaEmitterTests, SetQosWithInvalidArgs );
+    RUN_TEST_CASE( AiaEmitterTests, EmitArrayJsonWithQos1 );
+    RUN_TEST_CASE( AiaEmitterTests, ReserveAndReleaseSequenceNumbers );
 }
 
 /*-----------------------------------------------------------*/
@@ -853,3 +955,230 @@ TEST( AiaEmitterTests, GetNextSequenceNumberWithNullArgs )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitCoalescedMicrophoneContent )
+{
+    static const size_t AUDIO_SIZE = 4;
+    AiaMessage_t* messages[] = {
+        AiaEmitterTest_CreateMicrophoneContent( 0, 0xa1, AUDIO_SIZE ),
+        AiaEmitterTest_CreateMicrophoneContent( AUDIO_SIZE, 0xa2, AUDIO_SIZE ),
+        AiaEmitterTest_CreateMicrophoneContent( AUDIO_SIZE * 3, 0xa3,
+                                                AUDIO_SIZE )
+    };
+    size_t cumulativeSize = 0;
+    for( size_t i = 0; i < AiaArrayLength( messages ); ++i )
+    {
+        cumulativeSize += AiaMessage_GetSize( messages[ i ] );
+    }
+    for( size_t i = 0; i < AiaArrayLength( messages ); ++i )
+    {
+        cumulativeSize -= AiaMessage_GetSize( messages[ i ] );
+        TEST_ASSERT_TRUE( AiaEmitter_EmitMessageChunk(
+            g_aiaEmitterTestData.binaryEmitter, messages[ i ], cumulativeSize,
+            AiaArrayLength( messages ) - i - 1 ) );
+    }
+
+    /* The first two chunks are contiguous and should share a single entry,
+     * while the third should start a new entry after the gap. */
+    TEST_ASSERT_EQUAL(
+        2, AiaListDouble( Count )( &g_aiaEmitterTestData.publishedMessages ) );
+    AiaEmitterTestQueuedMessage_t* node =
+        (AiaEmitterTestQueuedMessage_t*)AiaListDouble( RemoveHead )(
+            &g_aiaEmitterTestData.publishedMessages );
+    TEST_ASSERT_EQUAL( AIA_SIZE_OF_BINARY_STREAM_HEADER +
+                           sizeof( AiaBinaryAudioStreamOffset_t ) +
+                           AUDIO_SIZE * 2,
+                       node->messageLength );
+    const uint8_t* entry = (const uint8_t*)node->message;
+    const uint8_t* audio = entry + AIA_SIZE_OF_BINARY_STREAM_HEADER +
+                           sizeof( AiaBinaryAudioStreamOffset_t );
+    for( size_t i = 0; i < sizeof( AiaBinaryAudioStreamOffset_t ); ++i )
+    {
+        TEST_ASSERT_EQUAL( 0, entry[ AIA_SIZE_OF_BINARY_STREAM_HEADER + i ] );
+    }
+    for( size_t i = 0; i < AUDIO_SIZE * 2; ++i )
+    {
+        TEST_ASSERT_EQUAL( i < AUDIO_SIZE ? 0xa1 : 0xa2, audio[ i ] );
+    }
+    AiaFree( node );
+
+    node = (AiaEmitterTestQueuedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaEmitterTestData.publishedMessages );
+    TEST_ASSERT_EQUAL( AIA_SIZE_OF_BINARY_STREAM_HEADER +
+                           sizeof( AiaBinaryAudioStreamOffset_t ) + AUDIO_SIZE,
+                       node->messageLength );
+    entry = (const uint8_t*)node->message;
+    TEST_ASSERT_EQUAL( AUDIO_SIZE * 3,
+                       entry[ AIA_SIZE_OF_BINARY_STREAM_HEADER ] );
+    AiaFree( node );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EnablePayloadBufferReuseWithNullArgs )
+{
+    TEST_ASSERT_FALSE( AiaEmitter_EnablePayloadBufferReuse( NULL, 1 ) );
+    TEST_ASSERT_FALSE( AiaEmitter_EnablePayloadBufferReuse(
+        g_aiaEmitterTestData.binaryEmitter, 0 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitBinaryWithPayloadBufferReuse )
+{
+    /* Start with a buffer too small for the messages so that it must grow. */
+    TEST_ASSERT_TRUE( AiaEmitter_EnablePayloadBufferReuse(
+        g_aiaEmitterTestData.binaryEmitter, 1 ) );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 3 - i, true,
+                                         true );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitArrayJsonWithPayloadBufferReuse )
+{
+    /* Start with a buffer too small for the messages so that it must grow. */
+    TEST_ASSERT_TRUE( AiaEmitter_EnablePayloadBufferReuse(
+        g_aiaEmitterTestData.arrayJsonEmitter, 1 ) );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, i + 1, true,
+                                         false );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitBinaryAfterTrimMemory )
+{
+    TEST_ASSERT_EQUAL( 0, AiaEmitter_TrimMemory( NULL ) );
+    TEST_ASSERT_TRUE( AiaEmitter_EnablePayloadBufferReuse(
+        g_aiaEmitterTestData.binaryEmitter, 1 ) );
+    AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 2, true, true );
+    TEST_ASSERT_GREATER_THAN(
+        0, AiaEmitter_TrimMemory( g_aiaEmitterTestData.binaryEmitter ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaEmitter_TrimMemory( g_aiaEmitterTestData.binaryEmitter ) );
+
+    /* The reused buffer is allocated again for the next message. */
+    AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 2, true, true );
+    TEST_ASSERT_GREATER_THAN(
+        0, AiaEmitter_TrimMemory( g_aiaEmitterTestData.binaryEmitter ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EnableAsyncPublishWithInvalidArgs )
+{
+    TEST_ASSERT_FALSE( AiaEmitter_EnableAsyncPublish( NULL, 1 ) );
+    TEST_ASSERT_FALSE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.binaryEmitter, 0 ) );
+    TEST_ASSERT_TRUE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.binaryEmitter, 1 ) );
+    TEST_ASSERT_FALSE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.binaryEmitter, 1 ) );
+    TEST_ASSERT_FALSE( AiaEmitter_FlushPublishes( NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitBinaryWithAsyncPublish )
+{
+    /* A reused buffer too small for the messages must grow in the window. */
+    TEST_ASSERT_TRUE( AiaEmitter_EnablePayloadBufferReuse(
+        g_aiaEmitterTestData.binaryEmitter, 1 ) );
+    TEST_ASSERT_TRUE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.binaryEmitter, 2 ) );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 3 - i, true,
+                                         true );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitArrayJsonWithAsyncPublish )
+{
+    TEST_ASSERT_TRUE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.arrayJsonEmitter, 1 ) );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, i + 1, true,
+                                         false );
+    }
+
+    AiaEmitterMetrics_t metrics;
+    AiaEmitter_GetMetrics( g_aiaEmitterTestData.arrayJsonEmitter, &metrics );
+    TEST_ASSERT_EQUAL( 3, metrics.messagesPublished );
+    TEST_ASSERT_EQUAL( 0, metrics.failures );
+    TEST_ASSERT_LESS_THAN_UINT32(
+        1000, (uint32_t)AiaClock( GetTimeMs )() - metrics.lastPublishTimeMs );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitBinaryAfterTrimMemoryWithAsyncPublish )
+{
+    TEST_ASSERT_TRUE( AiaEmitter_EnableAsyncPublish(
+        g_aiaEmitterTestData.binaryEmitter, 2 ) );
+    AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 2, true, true );
+    TEST_ASSERT_TRUE(
+        AiaEmitter_FlushPublishes( g_aiaEmitterTestData.binaryEmitter ) );
+    TEST_ASSERT_GREATER_THAN(
+        0, AiaEmitter_TrimMemory( g_aiaEmitterTestData.binaryEmitter ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaEmitter_TrimMemory( g_aiaEmitterTestData.binaryEmitter ) );
+
+    /* The window's buffers are allocated again as messages are assembled. */
+    AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 2, true, true );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, SetQosWithInvalidArgs )
+{
+    TEST_ASSERT_FALSE( AiaEmitter_SetQos( NULL, AIA_MQTT_QOS1 ) );
+    TEST_ASSERT_FALSE( AiaEmitter_SetQos( g_aiaEmitterTestData.jsonEmitter,
+                                          (AiaMqttQos_t)-1 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, EmitArrayJsonWithQos1 )
+{
+    TEST_ASSERT_TRUE( AiaEmitter_SetQos( g_aiaEmitterTestData.arrayJsonEmitter,
+                                         AIA_MQTT_QOS1 ) );
+    g_aiaEmitterTestData.expectedQos = AIA_MQTT_QOS1;
+    AiaEmitterTest_TestEmitMessages( &g_aiaEmitterTestData, 2, true, false );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaEmitterTests, ReserveAndReleaseSequenceNumbers )
+{
+    AiaEmitter_t* emitter = g_aiaEmitterTestData.jsonEmitter;
+    AiaSequenceNumber_t first;
+    AiaSequenceNumber_t second;
+    AiaSequenceNumber_t next;
+    TEST_ASSERT_FALSE( AiaEmitter_ReserveSequenceNumber( NULL, &first ) );
+    TEST_ASSERT_FALSE( AiaEmitter_ReserveSequenceNumber( emitter, NULL ) );
+    TEST_ASSERT_FALSE( AiaEmitter_ReleaseSequenceNumber( NULL, 0 ) );
+
+    TEST_ASSERT_TRUE( AiaEmitter_ReserveSequenceNumber( emitter, &first ) );
+    TEST_ASSERT_TRUE( AiaEmitter_ReserveSequenceNumber( emitter, &second ) );
+    TEST_ASSERT_EQUAL( first + 1, second );
+
+    /* Only the latest reservation can be rolled back. */
+    TEST_ASSERT_FALSE( AiaEmitter_ReleaseSequenceNumber( emitter, first ) );
+    TEST_ASSERT_TRUE( AiaEmitter_ReleaseSequenceNumber( emitter, second ) );
+    TEST_ASSERT_TRUE( AiaEmitter_GetNextSequenceNumber( emitter, &next ) );
+    TEST_ASSERT_EQUAL( second, next );
+}
+
+/*-----------------------------------------------------------*/
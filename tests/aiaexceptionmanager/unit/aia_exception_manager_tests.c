@@ -120,6 +120,7 @@ static void TestExceptionPayloadReceived(
 static AiaExceptionManager_t* g_testExceptionManager;
 static AiaTestExceptionManagerObserver_t* g_testObserver;
 static AiaRegulator_t* g_mockRegulator;
+static AiaExceptionLimiter_t* g_exceptionLimiter;
 
 /*-----------------------------------------------------------*/
 
@@ -156,10 +157,15 @@ TEST_SETUP( AiaExceptionManagerTests )
     g_mockRegulator = (AiaRegulator_t*)AiaMockRegulator_Create();
     TEST_ASSERT_NOT_NULL( g_mockRegulator );
 
+    g_exceptionLimiter =
+        AiaExceptionLimiter_Create( g_mockRegulator, AIA_EXCEPTION_EVENT_BURST,
+                                    AIA_EXCEPTION_EVENT_REFILL_INTERVAL_MS );
+    TEST_ASSERT_NOT_NULL( g_exceptionLimiter );
+
     g_testObserver = AiaExceptionManagerTestObserver_Create();
     TEST_ASSERT_TRUE( g_testObserver );
     g_testExceptionManager = AiaExceptionManager_Create(
-        g_mockRegulator, onException, g_testObserver );
+        g_exceptionLimiter, onException, g_testObserver );
     TEST_ASSERT_NOT_NULL( g_testExceptionManager );
 }
 
@@ -172,6 +178,7 @@ TEST_TEAR_DOWN( AiaExceptionManagerTests )
 {
     AiaExceptionManager_Destroy( g_testExceptionManager );
     AiaExceptionManagerTestObserver_Destroy( g_testObserver );
+    AiaExceptionLimiter_Destroy( g_exceptionLimiter );
     AiaMockRegulator_Destroy( (AiaMockRegulator_t*)g_mockRegulator,
                               AiaTestUtilities_DestroyJsonChunk, NULL );
 
@@ -190,10 +197,10 @@ TEST( AiaExceptionManagerTests, CreateNullParams )
 {
     TEST_ASSERT_NULL(
         AiaExceptionManager_Create( NULL, onException, g_testObserver ) );
+    TEST_ASSERT_NOT_NULL( AiaExceptionManager_Create(
+        g_exceptionLimiter, NULL, g_testObserver ) );
     TEST_ASSERT_NOT_NULL(
-        AiaExceptionManager_Create( g_mockRegulator, NULL, g_testObserver ) );
-    TEST_ASSERT_NOT_NULL(
-        AiaExceptionManager_Create( g_mockRegulator, onException, NULL ) );
+        AiaExceptionManager_Create( g_exceptionLimiter, onException, NULL ) );
 }
 
 TEST( AiaExceptionManagerTests, ReceiveExceptionValidFull )
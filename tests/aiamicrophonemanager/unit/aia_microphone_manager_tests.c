@@ -155,10 +155,47 @@ static AiaDataStreamReader_t* reader;
 
 static AiaDataStreamWriter_t* writer;
 
+/** Samples written by tests which need more than a chunk at a time, freed in
+ * teardown.  The chunk size is not a constant expression, so this cannot be
+ * a static array. */
+static int16_t* scratchSamples;
+
 static AiaMicrophoneManager_t* microphoneManager;
 
 static AiaTestMicrophoneStateObserver_t* testObserver;
 
+/** Number of samples per frame of the test encoder. */
+#define TEST_ENCODER_FRAME_SAMPLES 320
+
+/** Size in bytes of each frame produced by the test encoder. */
+#define TEST_ENCODER_FRAME_BYTES 40
+
+/**
+ * Test encoder which fills each frame with the low byte of the index of the
+ * frame's first sample in units of frames. Samples in the test buffer are
+ * equal to their index.
+ */
+static bool testEncodeFrames( const int16_t* samples, size_t frameCount,
+                              uint8_t* out, void* userData )
+{
+    TEST_ASSERT_NULL( userData );
+    for( size_t i = 0; i < frameCount; ++i )
+    {
+        memset( out, (uint16_t)samples[ 0 ] / TEST_ENCODER_FRAME_SAMPLES,
+                TEST_ENCODER_FRAME_BYTES );
+        samples += TEST_ENCODER_FRAME_SAMPLES;
+        out += TEST_ENCODER_FRAME_BYTES;
+    }
+    return true;
+}
+
+/** Counts calls in the @c size_t passed as @c userData. */
+static void testOnEndOfSpeech( void* userData )
+{
+    TEST_ASSERT_NOT_NULL( userData );
+    ++*(size_t*)userData;
+}
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -182,11 +219,23 @@ TEST_GROUP_RUNNER( AiaMicrophoneManagerTests )
     RUN_TEST_CASE( AiaMicrophoneManagerTests, WakeWordNonAlexaFails );
     RUN_TEST_CASE( AiaMicrophoneManagerTests,
                    WakeWordWithoutAmpleSamplesFails );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, WakeWordPrerollOverwrittenFails );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, WakeWordPrerollIsPinned );
     RUN_TEST_CASE( AiaMicrophoneManagerTests, HoldToTalkOpenMicrophoneTimeout );
     RUN_TEST_CASE( AiaMicrophoneManagerTests,
                    HoldToTalkOpenMicrophoneWithinTimeout );
     RUN_TEST_CASE( AiaMicrophoneManagerTests,
                    OpenMicrophoneWithInitiatorEchoedBack )
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, StreamingWakesWhenDataWritten );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests,
+                   ChunkSizeFollowsRegulatorCadence );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, EncodedChunksAreWholeFrames );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests,
+                   VadSuppressesSilenceForTapToTalk );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests,
+                   VadClosesMicrophoneAtEndOfSpeech );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, MultiChannelFramesAreMixedDown );
+    RUN_TEST_CASE( AiaMicrophoneManagerTests, OverrunKeepsOffsetsContinuous );
 }
 
 /*-----------------------------------------------------------*/
@@ -257,6 +306,8 @@ TEST_TEAR_DOWN( AiaMicrophoneManagerTests )
     AiaDataStreamReader_Destroy( reader );
     AiaDataStreamBuffer_Destroy( sds );
     AiaFree( buffer );
+    AiaFree( scratchSamples );
+    scratchSamples = NULL;
     AiaMockRegulator_Destroy( g_mockMicrophoneRegulator,
                               AiaTestUtilities_DestroyBinaryChunk, NULL );
     AiaMockRegulator_Destroy( g_mockEventRegulator,
@@ -790,6 +841,46 @@ TEST( AiaMicrophoneManagerTests, WakeWordWithoutAmpleSamplesFails )
         TEST_PROFILE, AIA_ALEXA_WAKE_WORD ) );
 }
 
+TEST( AiaMicrophoneManagerTests, WakeWordPrerollOverwrittenFails )
+{
+    AiaMicrophoneProfile_t TEST_PROFILE = AIA_MICROPHONE_PROFILE_FAR_FIELD;
+    AiaBinaryAudioStreamOffset_t WW_STREAM_OFFSET_START = 8000;
+    AiaBinaryAudioStreamOffset_t WW_STREAM_OFFSET_END = 16000;
+
+    /* Lap the buffer so that the preroll is no longer in it. */
+    uint16_t TEST_SAMPLES[ BUFFER_SAMPLES_CAPACITY ] = { 0 };
+    TEST_ASSERT_EQUAL( BUFFER_SAMPLES_CAPACITY,
+                       AiaDataStreamWriter_Write( writer, TEST_SAMPLES,
+                                                  BUFFER_SAMPLES_CAPACITY ) );
+
+    TEST_ASSERT_FALSE( AiaMicrophoneManager_WakeWordStart(
+        microphoneManager, WW_STREAM_OFFSET_START, WW_STREAM_OFFSET_END,
+        TEST_PROFILE, AIA_ALEXA_WAKE_WORD ) );
+}
+
+TEST( AiaMicrophoneManagerTests, WakeWordPrerollIsPinned )
+{
+    AiaMicrophoneProfile_t TEST_PROFILE = AIA_MICROPHONE_PROFILE_FAR_FIELD;
+    AiaBinaryAudioStreamOffset_t WW_STREAM_OFFSET_START = 8000;
+    AiaBinaryAudioStreamOffset_t WW_STREAM_OFFSET_END = 16000;
+
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_WakeWordStart(
+        microphoneManager, WW_STREAM_OFFSET_START, WW_STREAM_OFFSET_END,
+        TEST_PROFILE, AIA_ALEXA_WAKE_WORD ) );
+
+    /* The nonblockable writer cannot lap the preroll before it is published. */
+    uint16_t TEST_SAMPLES[ BUFFER_SAMPLES_CAPACITY ] = { 0 };
+    TEST_ASSERT_TRUE( AiaDataStreamWriter_Write( writer, TEST_SAMPLES,
+                                                 BUFFER_SAMPLES_CAPACITY ) <
+                      BUFFER_SAMPLES_CAPACITY );
+
+    /* Closing the microphone releases the pin. */
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+    TEST_ASSERT_EQUAL( BUFFER_SAMPLES_CAPACITY,
+                       AiaDataStreamWriter_Write( writer, TEST_SAMPLES,
+                                                  BUFFER_SAMPLES_CAPACITY ) );
+}
+
 TEST( AiaMicrophoneManagerTests, HoldToTalkOpenMicrophoneTimeout )
 {
     const AiaBinaryAudioStreamOffset_t BUFFER_START_INDEX = 500;
@@ -1292,3 +1383,420 @@ TEST( AiaMicrophoneManagerTests, OpenMicrophoneWithInitiatorEchoedBack )
 
     AiaFree( (void*)openMicrophonePayload );
 }
+
+TEST( AiaMicrophoneManagerTests, StreamingWakesWhenDataWritten )
+{
+    /* Start at the writer so that there is no backlog to drain. */
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_HoldToTalkStart(
+        microphoneManager, BUFFER_SAMPLES_CAPACITY ) );
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TryWait )( &testObserver->currentStateChanged ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState, AIA_MICROPHONE_STATE_OPEN );
+
+    /* Nothing is published while no samples are being written. */
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &g_mockMicrophoneRegulator->writeSemaphore,
+        2 * MICROPHONE_PUBLISH_RATE ) );
+
+    uint16_t samples[ AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES ];
+    AiaBinaryAudioStreamOffset_t streamOffset = 0;
+    AiaDataStreamIndex_t bufferCurrentIndex = BUFFER_SAMPLES_CAPACITY;
+    for( size_t iteration = 0; iteration < 2; ++iteration )
+    {
+        for( size_t i = 0; i < AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES; ++i )
+        {
+            samples[ i ] = bufferCurrentIndex + i;
+        }
+        TEST_ASSERT_EQUAL(
+            AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES,
+            AiaDataStreamWriter_Write(
+                writer, samples, AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES ) );
+
+        /* The chunk is published without waiting for a publish interval. */
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_mockMicrophoneRegulator->writeSemaphore,
+            MICROPHONE_PUBLISH_RATE / 2 ) );
+        AiaListDouble( Link_t )* link = AiaListDouble( RemoveHead )(
+            &g_mockMicrophoneRegulator->writtenMessages );
+        TEST_ASSERT_NOT_NULL( link );
+        AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+        TEST_ASSERT_EQUAL( AiaBinaryMessage_GetLength( binaryMessage ),
+                           sizeof( AiaBinaryAudioStreamOffset_t ) +
+                               ( AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES *
+                                 AIA_MICROPHONE_BUFFER_WORD_SIZE ) );
+        const uint8_t* data = AiaBinaryMessage_GetData( binaryMessage );
+        TEST_ASSERT_EQUAL( getStreamOffsetFromData( data ), streamOffset );
+        const uint16_t* dataInSamples =
+            (const uint16_t*)( data + sizeof( AiaBinaryAudioStreamOffset_t ) );
+        for( size_t i = 0; i < AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES; ++i )
+        {
+            TEST_ASSERT_EQUAL( (uint16_t)( bufferCurrentIndex + i ),
+                               dataInSamples[ i ] );
+        }
+        AiaTestUtilities_DestroyBinaryChunk(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+        AiaFree( link );
+
+        streamOffset += AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES *
+                        AIA_MICROPHONE_BUFFER_WORD_SIZE;
+        bufferCurrentIndex += AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES;
+    }
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+}
+
+TEST( AiaMicrophoneManagerTests, ChunkSizeFollowsRegulatorCadence )
+{
+    /* The regulator emits every 50 ms, which is 800 samples. */
+    g_mockMicrophoneRegulator->minWaitTimeMs = MICROPHONE_PUBLISH_RATE;
+    const size_t CHUNK_OVERHEAD = AIA_SIZE_OF_BINARY_STREAM_HEADER +
+                                  sizeof( AiaBinaryAudioStreamOffset_t );
+
+    /* Chunks start at the regulator's cadence and double up to the maximum.
+     * Once streaming, chunks shrink to top off the message being aggregated by
+     * the regulator, but never below its cadence. */
+    const size_t EXPECTED_CHUNK_SAMPLES[] = { 800, 1600, 1000, 1600 };
+    const size_t REMAINING_SPACE_SAMPLES[] = { 0, 1000, 100, 0 };
+    const size_t NUM_CHUNKS = sizeof( EXPECTED_CHUNK_SAMPLES ) /
+                              sizeof( EXPECTED_CHUNK_SAMPLES[ 0 ] );
+
+    const AiaDataStreamIndex_t BUFFER_START_INDEX = 0;
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_HoldToTalkStart(
+        microphoneManager, BUFFER_START_INDEX ) );
+
+    AiaBinaryAudioStreamOffset_t streamOffset = 0;
+    AiaDataStreamIndex_t bufferCurrentIndex = BUFFER_START_INDEX;
+    for( size_t chunk = 0; chunk < NUM_CHUNKS; ++chunk )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_mockMicrophoneRegulator->writeSemaphore,
+            MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+
+        /* The next chunk is not read until a publish interval from now. */
+        g_mockMicrophoneRegulator->remainingMessageSpace =
+            REMAINING_SPACE_SAMPLES[ chunk ]
+                ? CHUNK_OVERHEAD + ( REMAINING_SPACE_SAMPLES[ chunk ] *
+                                     AIA_MICROPHONE_BUFFER_WORD_SIZE )
+                : 0;
+
+        AiaListDouble( Link_t )* link = AiaListDouble( RemoveHead )(
+            &g_mockMicrophoneRegulator->writtenMessages );
+        TEST_ASSERT_NOT_NULL( link );
+        AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+        TEST_ASSERT_EQUAL( AiaBinaryMessage_GetLength( binaryMessage ),
+                           sizeof( AiaBinaryAudioStreamOffset_t ) +
+                               ( EXPECTED_CHUNK_SAMPLES[ chunk ] *
+                                 AIA_MICROPHONE_BUFFER_WORD_SIZE ) );
+        const uint8_t* data = AiaBinaryMessage_GetData( binaryMessage );
+        TEST_ASSERT_EQUAL( getStreamOffsetFromData( data ), streamOffset );
+        const uint16_t* dataInSamples =
+            (const uint16_t*)( data + sizeof( AiaBinaryAudioStreamOffset_t ) );
+        for( size_t i = 0; i < EXPECTED_CHUNK_SAMPLES[ chunk ]; ++i )
+        {
+            TEST_ASSERT_EQUAL( (uint16_t)( bufferCurrentIndex + i ),
+                               dataInSamples[ i ] );
+        }
+        AiaTestUtilities_DestroyBinaryChunk(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+        AiaFree( link );
+
+        streamOffset +=
+            EXPECTED_CHUNK_SAMPLES[ chunk ] * AIA_MICROPHONE_BUFFER_WORD_SIZE;
+        bufferCurrentIndex += EXPECTED_CHUNK_SAMPLES[ chunk ];
+    }
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+}
+
+TEST( AiaMicrophoneManagerTests, EncodedChunksAreWholeFrames )
+{
+    AiaMicrophoneEncoder_t encoder = { testEncodeFrames, NULL,
+                                       TEST_ENCODER_FRAME_SAMPLES,
+                                       TEST_ENCODER_FRAME_BYTES };
+    AiaMicrophoneEncoder_t invalidEncoder = encoder;
+    invalidEncoder.frameBytes =
+        TEST_ENCODER_FRAME_SAMPLES * AIA_MICROPHONE_BUFFER_WORD_SIZE + 1;
+    TEST_ASSERT_FALSE(
+        AiaMicrophoneManager_SetEncoder( microphoneManager, &invalidEncoder ) );
+    invalidEncoder = encoder;
+    invalidEncoder.frameSamples = AIA_MICROPHONE_NOTIFY_THRESHOLD_SAMPLES + 1;
+    TEST_ASSERT_FALSE(
+        AiaMicrophoneManager_SetEncoder( microphoneManager, &invalidEncoder ) );
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_SetEncoder( microphoneManager, &encoder ) );
+
+    /* The regulator's cadence of 800 samples is rounded down to whole frames,
+     * and full chunks of 1600 samples are already whole frames. */
+    g_mockMicrophoneRegulator->minWaitTimeMs = MICROPHONE_PUBLISH_RATE;
+    const size_t EXPECTED_CHUNK_FRAMES[] = { 2, 5, 5 };
+    const size_t NUM_CHUNKS =
+        sizeof( EXPECTED_CHUNK_FRAMES ) / sizeof( EXPECTED_CHUNK_FRAMES[ 0 ] );
+
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_HoldToTalkStart( microphoneManager, 0 ) );
+    TEST_ASSERT_FALSE(
+        AiaMicrophoneManager_SetEncoder( microphoneManager, NULL ) );
+
+    AiaBinaryAudioStreamOffset_t streamOffset = 0;
+    size_t currentFrame = 0;
+    for( size_t chunk = 0; chunk < NUM_CHUNKS; ++chunk )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_mockMicrophoneRegulator->writeSemaphore,
+            MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+        AiaListDouble( Link_t )* link = AiaListDouble( RemoveHead )(
+            &g_mockMicrophoneRegulator->writtenMessages );
+        TEST_ASSERT_NOT_NULL( link );
+        AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+        TEST_ASSERT_EQUAL(
+            AiaBinaryMessage_GetLength( binaryMessage ),
+            sizeof( AiaBinaryAudioStreamOffset_t ) +
+                ( EXPECTED_CHUNK_FRAMES[ chunk ] * TEST_ENCODER_FRAME_BYTES ) );
+        const uint8_t* data = AiaBinaryMessage_GetData( binaryMessage );
+        TEST_ASSERT_EQUAL( getStreamOffsetFromData( data ), streamOffset );
+        const uint8_t* frames = data + sizeof( AiaBinaryAudioStreamOffset_t );
+        for( size_t i = 0; i < EXPECTED_CHUNK_FRAMES[ chunk ]; ++i )
+        {
+            TEST_ASSERT_EQUAL_UINT8( currentFrame + i,
+                                     frames[ i * TEST_ENCODER_FRAME_BYTES ] );
+        }
+        AiaTestUtilities_DestroyBinaryChunk(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+        AiaFree( link );
+
+        streamOffset +=
+            EXPECTED_CHUNK_FRAMES[ chunk ] * TEST_ENCODER_FRAME_BYTES;
+        currentFrame += EXPECTED_CHUNK_FRAMES[ chunk ];
+    }
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_SetEncoder( microphoneManager, NULL ) );
+}
+
+TEST( AiaMicrophoneManagerTests, VadSuppressesSilenceForTapToTalk )
+{
+    /* Nothing is loud enough to be speech. */
+    AiaMicrophoneVad_t vad = { UINT16_MAX, 0, 100, NULL, NULL, false, true };
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_SetVad( microphoneManager, &vad ) );
+
+    const AiaDataStreamIndex_t BUFFER_START_INDEX =
+        BUFFER_SAMPLES_CAPACITY - AIA_MICROPHONE_CHUNK_SIZE_SAMPLES;
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_TapToTalkStart(
+        microphoneManager, BUFFER_START_INDEX,
+        AIA_MICROPHONE_PROFILE_NEAR_FIELD ) );
+    TEST_ASSERT_FALSE( AiaMicrophoneManager_SetVad( microphoneManager, NULL ) );
+
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &g_mockMicrophoneRegulator->writeSemaphore,
+        2 * MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+    AiaMicrophoneManagerMetrics_t metrics;
+    AiaMicrophoneManager_GetMetrics( microphoneManager, &metrics );
+    TEST_ASSERT_EQUAL( 0, metrics.chunksSent );
+    TEST_ASSERT_TRUE( metrics.chunksSuppressed > 0 );
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_SetVad( microphoneManager, NULL ) );
+}
+
+TEST( AiaMicrophoneManagerTests, VadClosesMicrophoneAtEndOfSpeech )
+{
+    size_t endOfSpeechCount = 0;
+    AiaMicrophoneVad_t vad = {
+        100, 0, 100, testOnEndOfSpeech, &endOfSpeechCount, true, false
+    };
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_SetVad( microphoneManager, &vad ) );
+
+    /* The samples left in the buffer are loud enough to be speech. */
+    const AiaDataStreamIndex_t BUFFER_START_INDEX =
+        BUFFER_SAMPLES_CAPACITY - AIA_MICROPHONE_CHUNK_SIZE_SAMPLES;
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_TapToTalkStart(
+        microphoneManager, BUFFER_START_INDEX,
+        AIA_MICROPHONE_PROFILE_NEAR_FIELD ) );
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TryWait )( &testObserver->currentStateChanged ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState, AIA_MICROPHONE_STATE_OPEN );
+
+    /* Silence for longer than the hangover ends the speech. */
+    const size_t SILENCE_SAMPLES = 2 * AIA_MICROPHONE_CHUNK_SIZE_SAMPLES;
+    scratchSamples = AiaCalloc( SILENCE_SAMPLES, sizeof( int16_t ) );
+    TEST_ASSERT_NOT_NULL( scratchSamples );
+    TEST_ASSERT_EQUAL( SILENCE_SAMPLES,
+                       AiaDataStreamWriter_Write( writer, scratchSamples,
+                                                  SILENCE_SAMPLES ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &testObserver->currentStateChanged, 20 * MICROPHONE_PUBLISH_RATE ) );
+    TEST_ASSERT_EQUAL( testObserver->currentState,
+                       AIA_MICROPHONE_STATE_CLOSED );
+    TEST_ASSERT_EQUAL( 1, endOfSpeechCount );
+}
+
+TEST( AiaMicrophoneManagerTests, MultiChannelFramesAreMixedDown )
+{
+    /* Each frame holds a silent channel and a channel counting up. */
+    static const size_t NUM_CHANNELS = 2;
+    size_t wordSize = NUM_CHANNELS * AIA_MICROPHONE_BUFFER_WORD_SIZE;
+    size_t framesSize = AIA_MICROPHONE_CHUNK_SIZE_SAMPLES * wordSize;
+    scratchSamples = AiaCalloc( 1, framesSize );
+    TEST_ASSERT_NOT_NULL( scratchSamples );
+    int16_t* frames = scratchSamples;
+    for( size_t i = 0; i < AIA_MICROPHONE_CHUNK_SIZE_SAMPLES; ++i )
+    {
+        frames[ i * NUM_CHANNELS ] = 0;
+        frames[ i * NUM_CHANNELS + 1 ] = i;
+    }
+    void* multiChannelBuffer = AiaCalloc( 1, framesSize );
+    TEST_ASSERT_NOT_NULL( multiChannelBuffer );
+    AiaDataStreamBuffer_t* multiChannelSds = AiaDataStreamBuffer_Create(
+        multiChannelBuffer, framesSize, wordSize, 1 );
+    TEST_ASSERT_NOT_NULL( multiChannelSds );
+    AiaDataStreamReader_t* multiChannelReader =
+        AiaDataStreamBuffer_CreateReader(
+            multiChannelSds, AIA_DATA_STREAM_BUFFER_READER_NONBLOCKING, false );
+    TEST_ASSERT_NOT_NULL( multiChannelReader );
+    AiaDataStreamWriter_t* multiChannelWriter =
+        AiaDataStreamBuffer_CreateWriter(
+            multiChannelSds, AIA_DATA_STREAM_BUFFER_WRITER_NONBLOCKABLE,
+            false );
+    TEST_ASSERT_NOT_NULL( multiChannelWriter );
+    TEST_ASSERT_EQUAL( AIA_MICROPHONE_CHUNK_SIZE_SAMPLES,
+                       AiaDataStreamWriter_Write(
+                           multiChannelWriter, frames,
+                           AIA_MICROPHONE_CHUNK_SIZE_SAMPLES ) );
+
+    AiaMicrophonerManager_Destroy( microphoneManager );
+    microphoneManager =
+        AiaMicrophoneManager_Create( g_eventRegulator, g_microphoneRegulator,
+                                     multiChannelReader, NULL, NULL );
+    TEST_ASSERT_NOT_NULL( microphoneManager );
+
+    /* Select the second channel. */
+    const AiaPcmGain_t WEIGHTS[] = { 0, AIA_PCM_GAIN_UNITY };
+    TEST_ASSERT_FALSE( AiaMicrophoneManager_SetChannelWeights(
+        microphoneManager, WEIGHTS, 1 ) );
+    TEST_ASSERT_TRUE( AiaMicrophoneManager_SetChannelWeights(
+        microphoneManager, WEIGHTS, NUM_CHANNELS ) );
+
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_HoldToTalkStart( microphoneManager, 0 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_mockMicrophoneRegulator->writeSemaphore,
+        MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+    AiaListDouble( Link_t )* link = AiaListDouble( RemoveHead )(
+        &g_mockMicrophoneRegulator->writtenMessages );
+    TEST_ASSERT_NOT_NULL( link );
+    AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    const uint8_t* data = AiaBinaryMessage_GetData( binaryMessage );
+    TEST_ASSERT_EQUAL( 0, getStreamOffsetFromData( data ) );
+    size_t numSamples = ( AiaBinaryMessage_GetLength( binaryMessage ) -
+                          sizeof( AiaBinaryAudioStreamOffset_t ) ) /
+                        AIA_MICROPHONE_BUFFER_WORD_SIZE;
+    TEST_ASSERT_TRUE( numSamples > 0 );
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        int16_t sample;
+        memcpy( &sample,
+                data + sizeof( AiaBinaryAudioStreamOffset_t ) +
+                    i * AIA_MICROPHONE_BUFFER_WORD_SIZE,
+                sizeof( sample ) );
+        TEST_ASSERT_EQUAL_INT16( i, sample );
+    }
+    AiaTestUtilities_DestroyBinaryChunk(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+    AiaFree( link );
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+    AiaMicrophonerManager_Destroy( microphoneManager );
+    microphoneManager = NULL;
+    AiaDataStreamWriter_Destroy( multiChannelWriter );
+    AiaDataStreamReader_Destroy( multiChannelReader );
+    AiaDataStreamBuffer_Destroy( multiChannelSds );
+    AiaFree( multiChannelBuffer );
+}
+
+TEST( AiaMicrophoneManagerTests, OverrunKeepsOffsetsContinuous )
+{
+    /* Keep the most recent 100 ms, which is 1600 samples. */
+    static const size_t SAMPLES_KEPT = 1600;
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_SetOverrunRetention( microphoneManager, 100 ) );
+
+    TEST_ASSERT_TRUE(
+        AiaMicrophoneManager_HoldToTalkStart( microphoneManager, 0 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_mockMicrophoneRegulator->writeSemaphore,
+        MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+    AiaListDouble( Link_t )* link = AiaListDouble( RemoveHead )(
+        &g_mockMicrophoneRegulator->writtenMessages );
+    TEST_ASSERT_NOT_NULL( link );
+    AiaBinaryAudioStreamOffset_t expectedOffset =
+        AiaBinaryMessage_GetLength( AiaBinaryMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk ) ) -
+        sizeof( AiaBinaryAudioStreamOffset_t );
+    AiaTestUtilities_DestroyBinaryChunk(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+    AiaFree( link );
+
+    /* Overwrite the whole buffer while its backlog is being published. */
+    static uint16_t samples[ BUFFER_SAMPLES_CAPACITY ];
+    for( size_t i = 0; i < BUFFER_SAMPLES_CAPACITY; ++i )
+    {
+        samples[ i ] = BUFFER_SAMPLES_CAPACITY + i;
+    }
+    TEST_ASSERT_EQUAL( BUFFER_SAMPLES_CAPACITY,
+                       AiaDataStreamWriter_Write( writer, samples,
+                                                  BUFFER_SAMPLES_CAPACITY ) );
+
+    /* Every chunk's offset matches the index of its first sample, and chunks
+     * resume with the most recent samples after the gap. */
+    const AiaDataStreamIndex_t WRITER_INDEX = 2 * BUFFER_SAMPLES_CAPACITY;
+    bool sawGap = false;
+    for( size_t chunk = 0; chunk < 10 && !sawGap; ++chunk )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_mockMicrophoneRegulator->writeSemaphore,
+            MICROPHONE_PUBLISH_RATE + LEEWAY ) );
+        link = AiaListDouble( RemoveHead )(
+            &g_mockMicrophoneRegulator->writtenMessages );
+        TEST_ASSERT_NOT_NULL( link );
+        AiaBinaryMessage_t* binaryMessage = AiaBinaryMessage_FromMessage(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+        const uint8_t* data = AiaBinaryMessage_GetData( binaryMessage );
+        AiaBinaryAudioStreamOffset_t offset = getStreamOffsetFromData( data );
+        uint16_t firstSample;
+        memcpy( &firstSample, data + sizeof( AiaBinaryAudioStreamOffset_t ),
+                sizeof( firstSample ) );
+        TEST_ASSERT_EQUAL(
+            (uint16_t)( offset / AIA_MICROPHONE_BUFFER_WORD_SIZE ),
+            firstSample );
+        if( offset != expectedOffset )
+        {
+            TEST_ASSERT_EQUAL( ( WRITER_INDEX - SAMPLES_KEPT ) *
+                                   AIA_MICROPHONE_BUFFER_WORD_SIZE,
+                               offset );
+            sawGap = true;
+        }
+        else
+        {
+            expectedOffset += AiaBinaryMessage_GetLength( binaryMessage ) -
+                              sizeof( AiaBinaryAudioStreamOffset_t );
+        }
+        AiaTestUtilities_DestroyBinaryChunk(
+            ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk, NULL );
+        AiaFree( link );
+    }
+    TEST_ASSERT_TRUE( sawGap );
+
+    AiaMicrophoneManagerMetrics_t metrics;
+    AiaMicrophoneManager_GetMetrics( microphoneManager, &metrics );
+    TEST_ASSERT_EQUAL( 1, metrics.gaps );
+    TEST_ASSERT_EQUAL( WRITER_INDEX - SAMPLES_KEPT -
+                           expectedOffset / AIA_MICROPHONE_BUFFER_WORD_SIZE,
+                       metrics.samplesSkipped );
+
+    AiaMicrophoneManager_CloseMicrophone( microphoneManager );
+}
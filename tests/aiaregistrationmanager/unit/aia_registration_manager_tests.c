@@ -40,6 +40,7 @@
 #define AIA_REGISTRATION_MANAGER_TEST_DESCRIPTION "testDescription"
 #define AIA_REGISTRATION_MANAGER_TEST_INVALID_RESPONSE \
     "{\"invalid\":\"response\"}"
+#define AIA_REGISTRATION_MANAGER_TEST_CHUNK_SIZE 3
 
 /* clang-format off */
 #define AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS                          \
@@ -51,6 +52,16 @@
              "\"topicRoot\":\"" AIA_REGISTRATION_MANAGER_TEST_TOPIC_ROOT "\""   \
         "}"                                                                     \
     "}"
+#define AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS_FORMATTED                \
+    "{\n"                                                                       \
+    "  \"note\": \"\\\"topicRoot\\\": \\\"wrong\\\"\",\n"                       \
+    "  \"iot\": {\n"                                                            \
+    "    \"topicRoot\" : \"" AIA_REGISTRATION_MANAGER_TEST_TOPIC_ROOT "\"\n"    \
+    "  },\n"                                                                    \
+    "  \"encryption\": {\n"                                                     \
+    "    \"publicKey\": \"" AIA_REGISTRATION_MANAGER_TEST_PUBLIC_KEY "\"\n"     \
+    "  }\n"                                                                     \
+    "}"
 #define AIA_REGISTRATION_MANAGER_TEST_RESPONSE_FAILURE                  \
     "{"                                                                 \
         "\"code\":\"" AIA_REGISTRATION_MANAGER_TEST_CODE                \
@@ -165,6 +176,12 @@ bool AiaLoadTopicRoot( uint8_t* topicRoot, size_t size )
     return testTopicRootStorer->valueToReturn;
 }
 
+size_t AiaGetTopicRootSize()
+{
+    TEST_ASSERT_NOT_NULL( testTopicRootStorer );
+    return testTopicRootStorer->storedTopicRootLen;
+}
+
 bool AiaGetRefreshToken( char* refreshToken, size_t* len )
 {
     if( !len )
@@ -275,11 +292,13 @@ bool AiaGetIotEndpoint( char* iotEndpoint, size_t* len )
     return true;
 }
 
-bool AiaSendHttpsRequest( AiaHttpsRequest_t* httpsRequest,
-                          AiaHttpsConnectionResponseCallback_t responseCallback,
-                          void* responseCallbackUserData,
-                          AiaHttpsConnectionFailureCallback_t failureCallback,
-                          void* failureCallbackUserData )
+bool AiaSendHttpsStreamingRequest(
+    AiaHttpsRequest_t* httpsRequest,
+    AiaHttpsConnectionResponseChunkCallback_t chunkCallback,
+    AiaHttpsConnectionResponseCallback_t responseCallback,
+    void* responseCallbackUserData,
+    AiaHttpsConnectionFailureCallback_t failureCallback,
+    void* failureCallbackUserData )
 {
     (void)httpsRequest;
     if( !aiaRegistrationTestData.isSendRequestSuccess )
@@ -289,10 +308,27 @@ bool AiaSendHttpsRequest( AiaHttpsRequest_t* httpsRequest,
 
     if( aiaRegistrationTestData.isRegisterSuccess )
     {
+        /* Deliver the body in small chunks so that keys and values are split
+         * across them. */
+        for( size_t offset = 0;
+             offset < aiaRegistrationTestData.responseBodyLen;
+             offset += AIA_REGISTRATION_MANAGER_TEST_CHUNK_SIZE )
+        {
+            size_t chunkLen =
+                aiaRegistrationTestData.responseBodyLen - offset;
+            if( chunkLen > AIA_REGISTRATION_MANAGER_TEST_CHUNK_SIZE )
+            {
+                chunkLen = AIA_REGISTRATION_MANAGER_TEST_CHUNK_SIZE;
+            }
+            chunkCallback( aiaRegistrationTestData.responseStatus,
+                           aiaRegistrationTestData.responseBody + offset,
+                           chunkLen, responseCallbackUserData );
+        }
+
         AiaHttpsResponse_t httpsResponse;
         httpsResponse.status = aiaRegistrationTestData.responseStatus;
-        httpsResponse.body = aiaRegistrationTestData.responseBody;
-        httpsResponse.bodyLen = aiaRegistrationTestData.responseBodyLen;
+        httpsResponse.body = NULL;
+        httpsResponse.bodyLen = 0;
 
         responseCallback( &httpsResponse, responseCallbackUserData );
     }
@@ -381,6 +417,8 @@ TEST_GROUP_RUNNER( AiaRegistrationManagerTests )
     RUN_TEST_CASE( AiaRegistrationManagerTests, CreateAndDestroy );
     RUN_TEST_CASE( AiaRegistrationManagerTests, CreateNullParams );
     RUN_TEST_CASE( AiaRegistrationManagerTests, RegisterSuccessResponse );
+    RUN_TEST_CASE( AiaRegistrationManagerTests,
+                   RegisterSuccessResponseFormatted );
     RUN_TEST_CASE( AiaRegistrationManagerTests,
                    RegisterSuccessResponseInvalidBody );
     RUN_TEST_CASE( AiaRegistrationManagerTests, RegisterFailResponse );
@@ -389,6 +427,7 @@ TEST_GROUP_RUNNER( AiaRegistrationManagerTests )
     RUN_TEST_CASE( AiaRegistrationManagerTests, RegisterNullParams );
     RUN_TEST_CASE( AiaRegistrationManagerTests, RegisterSendRequestFail );
     RUN_TEST_CASE( AiaRegistrationManagerTests, RegisterSuccessStorageFail );
+    RUN_TEST_CASE( AiaRegistrationManagerTests, IsRegistered );
 }
 
 /*-----------------------------------------------------------*/
@@ -427,6 +466,28 @@ TEST( AiaRegistrationManagerTests, RegisterSuccessResponse )
 
 /*-----------------------------------------------------------*/
 
+TEST( AiaRegistrationManagerTests, RegisterSuccessResponseFormatted )
+{
+    aiaRegistrationTestData.isSendRequestSuccess = true;
+    aiaRegistrationTestData.isRegisterSuccess = true;
+    aiaRegistrationTestData.responseStatus = 200;
+    aiaRegistrationTestData.responseBody =
+        AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS_FORMATTED;
+    aiaRegistrationTestData.responseBodyLen =
+        sizeof( AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS_FORMATTED ) - 1;
+    TEST_ASSERT_TRUE(
+        AiaRegistrationManager_Register( testRegistrationManager ) );
+
+    TEST_ASSERT_EQUAL( 1, aiaRegistrationTestData.successCallbackCount );
+    TEST_ASSERT_EQUAL( sizeof( AIA_REGISTRATION_MANAGER_TEST_TOPIC_ROOT ) - 1,
+                       testTopicRootStorer->storedTopicRootLen );
+    TEST_ASSERT_EQUAL_MEMORY( AIA_REGISTRATION_MANAGER_TEST_TOPIC_ROOT,
+                              testTopicRootStorer->storedTopicRoot,
+                              testTopicRootStorer->storedTopicRootLen );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( AiaRegistrationManagerTests, RegisterSuccessResponseInvalidBody )
 {
     aiaRegistrationTestData.isSendRequestSuccess = true;
@@ -522,3 +583,28 @@ TEST( AiaRegistrationManagerTests, RegisterSuccessStorageFail )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( AiaRegistrationManagerTests, IsRegistered )
+{
+    TEST_ASSERT_FALSE( AiaRegistrationManager_IsRegistered() );
+
+    aiaRegistrationTestData.isSendRequestSuccess = true;
+    aiaRegistrationTestData.isRegisterSuccess = true;
+    aiaRegistrationTestData.responseStatus = 200;
+    aiaRegistrationTestData.responseBody =
+        AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS;
+    aiaRegistrationTestData.responseBodyLen =
+        sizeof( AIA_REGISTRATION_MANAGER_TEST_RESPONSE_SUCCESS ) - 1;
+    TEST_ASSERT_TRUE(
+        AiaRegistrationManager_Register( testRegistrationManager ) );
+    TEST_ASSERT_EQUAL( 1, aiaRegistrationTestData.successCallbackCount );
+    TEST_ASSERT_TRUE( AiaRegistrationManager_IsRegistered() );
+
+    testSecretStorer->valueToReturn = false;
+    TEST_ASSERT_FALSE( AiaRegistrationManager_IsRegistered() );
+    testSecretStorer->valueToReturn = true;
+    testTopicRootStorer->valueToReturn = false;
+    TEST_ASSERT_FALSE( AiaRegistrationManager_IsRegistered() );
+}
+
+/*-----------------------------------------------------------*/
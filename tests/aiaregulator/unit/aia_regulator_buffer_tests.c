@@ -25,6 +25,10 @@
 /* Aia test headers */
 #include <aiatestutilities/aia_test_utilities.h>
 
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+#include AiaClock( HEADER )
+#endif
+
 /* Aia headers */
 #include <aiacore/aia_json_message.h>
 #include <aiacore/aia_utils.h>
@@ -41,6 +45,11 @@
  */
 static const size_t TEST_MAX_MESSAGE_SIZE = 200;
 
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+/** Maximum age to use in expiry tests. */
+static const AiaDurationMs_t TEST_MAX_AGE_MS = 50;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -147,6 +156,83 @@ static bool RemoveFrontHelperCallback( AiaRegulatorChunk_t* chunkForMessage,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * Helper function for pushing a chunk of a given size, priority and supersede
+ * key onto @c testRegulatorBuffer.
+ *
+ * @param size The size of the chunk to push.
+ * @param priority The priority class of the chunk.
+ * @param key The supersede key of the chunk, or @c 0 for none.
+ */
+static void PushBackWithKeyHelper( size_t size,
+                                   AiaRegulatorPriority_t priority,
+                                   AiaMessageSupersedeKey_t key )
+{
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create( "", "", "" );
+    size_t minSize =
+        AiaMessage_GetSize( AiaJsonMessage_ToConstMessage( jsonMessage ) );
+    AiaJsonMessage_Destroy( jsonMessage );
+
+    TEST_ASSERT_GREATER_OR_EQUAL( minSize, size );
+    char scratch[ 1024 ] = "";
+    TEST_ASSERT_LESS_THAN( sizeof( scratch ), size - minSize );
+    snprintf( scratch, sizeof( scratch ), "%*s", (int)( size - minSize ), " " );
+    scratch[ sizeof( scratch ) - 1 ] = '\0';
+    jsonMessage = AiaJsonMessage_Create( scratch, "", "" );
+    TEST_ASSERT_TRUE( AiaMessage_SetSupersedeKey(
+        AiaJsonMessage_ToMessage( jsonMessage ), key ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_PushBackWithPriority(
+        testRegulatorBuffer, AiaJsonMessage_ToMessage( jsonMessage ),
+        priority ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Helper function for pushing a chunk of a given size and priority onto @c
+ * testRegulatorBuffer.
+ *
+ * @param size The size of the chunk to push.
+ * @param priority The priority class of the chunk.
+ */
+static void PushBackWithPriorityHelper( size_t size,
+                                        AiaRegulatorPriority_t priority )
+{
+    PushBackWithKeyHelper( size, priority, 0 );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Helper function for pushing a chunk of a given size onto @c
+ * testRegulatorBuffer.
+ *
+ * @param size The size of the chunk to push.
+ */
+static void PushBackHelper( size_t size )
+{
+    PushBackWithPriorityHelper( size, AIA_REGULATOR_PRIORITY_NORMAL );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Helper function for removing a message from @c testRegulatorBuffer.
+ *
+ * @param chunkSizes Array of chunk sizes expected to be emitted.
+ * @param numChunks Number of entries in @c chunkSizes.
+ */
+static void RemoveFrontMessageHelper( const size_t* chunkSizes,
+                                      size_t numChunks )
+{
+    RemoveFrontHelperData_t helperData = { chunkSizes, numChunks, 0 };
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_RemoveFront(
+        testRegulatorBuffer, RemoveFrontHelperCallback, &helperData ) );
+    TEST_ASSERT_EQUAL( numChunks, helperData.currentChunk );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * Helper function for testing @c AiaRegulatorBuffer_RemoveFront().
  * @param inputSizes Array of input message sizes to test with.
@@ -163,31 +249,14 @@ static void RemoveFrontHelper( const size_t* inputSizes, size_t numInputs,
                                const size_t* outputNumChunks,
                                size_t numOutputs )
 {
-    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_Create( "", "", "" );
-    size_t minSize =
-        AiaMessage_GetSize( AiaJsonMessage_ToConstMessage( jsonMessage ) );
-    AiaJsonMessage_Destroy( jsonMessage );
-
     for( size_t i = 0; i < numInputs; ++i )
     {
-        TEST_ASSERT_GREATER_OR_EQUAL( minSize, inputSizes[ i ] );
-        char scratch[ 1024 ] = "";
-        TEST_ASSERT_LESS_THAN( sizeof( scratch ), inputSizes[ i ] - minSize );
-        snprintf( scratch, sizeof( scratch ), "%*s",
-                  (int)( inputSizes[ i ] - minSize ), " " );
-        scratch[ sizeof( scratch ) - 1 ] = '\0';
-        AiaJsonMessage_t* jsonMessage =
-            AiaJsonMessage_Create( scratch, "", "" );
-        TEST_ASSERT_TRUE( AiaRegulatorBuffer_PushBack(
-            testRegulatorBuffer, AiaJsonMessage_ToMessage( jsonMessage ) ) );
+        PushBackHelper( inputSizes[ i ] );
     }
 
     for( size_t i = 0; i < numOutputs; ++i )
     {
-        RemoveFrontHelperData_t helperData = { outputChunkSizes[ i ],
-                                               outputNumChunks[ i ], 0 };
-        TEST_ASSERT_TRUE( AiaRegulatorBuffer_RemoveFront(
-            testRegulatorBuffer, RemoveFrontHelperCallback, &helperData ) );
+        RemoveFrontMessageHelper( outputChunkSizes[ i ], outputNumChunks[ i ] );
     }
 }
 
@@ -237,6 +306,19 @@ TEST_GROUP_RUNNER( AiaRegulatorBufferTests )
                    RemoveFrontMultipleMessagesMultipleChunksUnaligned );
     RUN_TEST_CASE( AiaRegulatorBufferTests,
                    RemoveFrontMultipleMessagesMultipleChunksAligned );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, RemoveFrontInterleavedWithPushBack );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, NormalPriorityJumpsLowPriority );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, SupersedeReplacesChunkWithSameKey );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, SupersedeKeepsPriorityOrder );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, SupersedeWithoutCallbackAppends );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, SupersedeDisabledKeyAppends );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, SupersedeInvalidKey );
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+    RUN_TEST_CASE( AiaRegulatorBufferTests, ExpiryDropsStaleChunks );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, ExpiryKeepsPriorityOrder );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, ExpiryWithoutCallbackEmits );
+    RUN_TEST_CASE( AiaRegulatorBufferTests, ExpiryInvalidKey );
+#endif
 }
 
 /*-----------------------------------------------------------*/
@@ -519,3 +601,225 @@ TEST( AiaRegulatorBufferTests,
     RemoveFrontHelper( inputSizes, numInputs, outputChunkSizes, outputNumChunks,
                        numOutputs );
 }
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, RemoveFrontInterleavedWithPushBack )
+{
+    PushBackHelper( 120 );
+    PushBackHelper( 90 );
+    const size_t outputMessage0ChunkSizes[] = { 120 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+
+    /* The remaining chunk should aggregate with chunks pushed afterwards. */
+    PushBackHelper( 50 );
+    PushBackHelper( 100 );
+    TEST_ASSERT_EQUAL( 240, AiaRegulatorBuffer_GetSize( testRegulatorBuffer ) );
+    const size_t outputMessage1ChunkSizes[] = { 90, 50 };
+    RemoveFrontMessageHelper( outputMessage1ChunkSizes,
+                              AiaArrayLength( outputMessage1ChunkSizes ) );
+    const size_t outputMessage2ChunkSizes[] = { 100 };
+    RemoveFrontMessageHelper( outputMessage2ChunkSizes,
+                              AiaArrayLength( outputMessage2ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, NormalPriorityJumpsLowPriority )
+{
+    PushBackWithPriorityHelper( 60, AIA_REGULATOR_PRIORITY_LOW );
+    PushBackWithPriorityHelper( 70, AIA_REGULATOR_PRIORITY_LOW );
+    PushBackHelper( 80 );
+    PushBackHelper( 50 );
+    TEST_ASSERT_EQUAL( 4,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+
+    /* Normal chunks keep their order ahead of the low priority ones, and still
+     * aggregate with them. */
+    const size_t outputMessage0ChunkSizes[] = { 80, 50, 60 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+
+    /* A normal chunk pushed once all normal chunks were emitted still jumps. */
+    PushBackHelper( 90 );
+    const size_t outputMessage1ChunkSizes[] = { 90, 70 };
+    RemoveFrontMessageHelper( outputMessage1ChunkSizes,
+                              AiaArrayLength( outputMessage1ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, SupersedeReplacesChunkWithSameKey )
+{
+    AiaRegulatorBuffer_SetSupersede( testRegulatorBuffer,
+                                     AiaTestUtilities_DestroyJsonChunk, NULL );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackHelper( 70 );
+    PushBackWithKeyHelper( 50, AIA_REGULATOR_PRIORITY_NORMAL, 2 );
+    PushBackWithKeyHelper( 80, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    TEST_ASSERT_EQUAL( 3,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+    TEST_ASSERT_EQUAL( 200, AiaRegulatorBuffer_GetSize( testRegulatorBuffer ) );
+
+    /* The newer chunk is queued behind the chunks written before it. */
+    const size_t outputMessage0ChunkSizes[] = { 70, 50, 80 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, SupersedeKeepsPriorityOrder )
+{
+    AiaRegulatorBuffer_SetSupersede( testRegulatorBuffer,
+                                     AiaTestUtilities_DestroyJsonChunk, NULL );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackWithPriorityHelper( 70, AIA_REGULATOR_PRIORITY_LOW );
+    PushBackWithKeyHelper( 50, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackHelper( 60 );
+    TEST_ASSERT_EQUAL( 3,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+
+    const size_t outputMessage0ChunkSizes[] = { 50, 60, 70 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, SupersedeWithoutCallbackAppends )
+{
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackWithKeyHelper( 80, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    TEST_ASSERT_EQUAL( 2,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+
+    const size_t outputMessage0ChunkSizes[] = { 60, 80 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, SupersedeDisabledKeyAppends )
+{
+    AiaRegulatorBuffer_SetSupersede( testRegulatorBuffer,
+                                     AiaTestUtilities_DestroyJsonChunk, NULL );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+        testRegulatorBuffer, 1, false ) );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackWithKeyHelper( 80, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackWithKeyHelper( 55, AIA_REGULATOR_PRIORITY_NORMAL, 2 );
+    PushBackWithKeyHelper( 50, AIA_REGULATOR_PRIORITY_NORMAL, 2 );
+    TEST_ASSERT_EQUAL( 3,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+
+    /* Re-enabling the key supersedes again. */
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+        testRegulatorBuffer, 1, true ) );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    const size_t outputMessage0ChunkSizes[] = { 80, 50, 60 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, SupersedeInvalidKey )
+{
+    TEST_ASSERT_FALSE( AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+        testRegulatorBuffer, 0, false ) );
+    TEST_ASSERT_FALSE( AiaRegulatorBuffer_SetSupersedeKeyEnabled(
+        testRegulatorBuffer, AIA_MESSAGE_MAX_SUPERSEDE_KEY + 1, false ) );
+    TEST_ASSERT_FALSE(
+        AiaRegulatorBuffer_SetSupersedeKeyEnabled( NULL, 1, false ) );
+}
+
+/*-----------------------------------------------------------*/
+
+#ifdef AIA_ENABLE_EVENT_EXPIRY
+TEST( AiaRegulatorBufferTests, ExpiryDropsStaleChunks )
+{
+    AiaRegulatorBuffer_SetExpiry( testRegulatorBuffer,
+                                  AiaTestUtilities_DestroyJsonChunk, NULL );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_SetMaxAge( testRegulatorBuffer, 1,
+                                                    TEST_MAX_AGE_MS ) );
+    PushBackWithKeyHelper( 100, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackHelper( 90 );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 2 );
+    AiaClock( SleepMs )( 2 * TEST_MAX_AGE_MS );
+
+    /* A fresh chunk with the same key is still sent. */
+    PushBackWithKeyHelper( 70, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+
+    /* The front message is rebuilt without the expired chunk. */
+    const size_t outputMessage0ChunkSizes[] = { 90, 60 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+    TEST_ASSERT_EQUAL( 1,
+                       AiaRegulatorBuffer_GetNumChunks( testRegulatorBuffer ) );
+    TEST_ASSERT_EQUAL( 70, AiaRegulatorBuffer_GetSize( testRegulatorBuffer ) );
+    const size_t outputMessage1ChunkSizes[] = { 70 };
+    RemoveFrontMessageHelper( outputMessage1ChunkSizes,
+                              AiaArrayLength( outputMessage1ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, ExpiryKeepsPriorityOrder )
+{
+    AiaRegulatorBuffer_SetExpiry( testRegulatorBuffer,
+                                  AiaTestUtilities_DestroyJsonChunk, NULL );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_SetMaxAge( testRegulatorBuffer, 1,
+                                                    TEST_MAX_AGE_MS ) );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    PushBackWithKeyHelper( 70, AIA_REGULATOR_PRIORITY_LOW, 1 );
+    PushBackWithPriorityHelper( 80, AIA_REGULATOR_PRIORITY_LOW );
+    AiaClock( SleepMs )( 2 * TEST_MAX_AGE_MS );
+    const size_t outputMessage0ChunkSizes[] = { 80 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+
+    /* Normal chunks still jump ahead of low priority ones afterwards. */
+    PushBackWithPriorityHelper( 55, AIA_REGULATOR_PRIORITY_LOW );
+    PushBackHelper( 50 );
+    const size_t outputMessage1ChunkSizes[] = { 50, 55 };
+    RemoveFrontMessageHelper( outputMessage1ChunkSizes,
+                              AiaArrayLength( outputMessage1ChunkSizes ) );
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_IsEmpty( testRegulatorBuffer ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, ExpiryWithoutCallbackEmits )
+{
+    TEST_ASSERT_TRUE( AiaRegulatorBuffer_SetMaxAge( testRegulatorBuffer, 1,
+                                                    TEST_MAX_AGE_MS ) );
+    PushBackWithKeyHelper( 60, AIA_REGULATOR_PRIORITY_NORMAL, 1 );
+    AiaClock( SleepMs )( 2 * TEST_MAX_AGE_MS );
+
+    const size_t outputMessage0ChunkSizes[] = { 60 };
+    RemoveFrontMessageHelper( outputMessage0ChunkSizes,
+                              AiaArrayLength( outputMessage0ChunkSizes ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorBufferTests, ExpiryInvalidKey )
+{
+    TEST_ASSERT_FALSE( AiaRegulatorBuffer_SetMaxAge( testRegulatorBuffer, 0,
+                                                     TEST_MAX_AGE_MS ) );
+    TEST_ASSERT_FALSE( AiaRegulatorBuffer_SetMaxAge(
+        testRegulatorBuffer, AIA_MESSAGE_MAX_SUPERSEDE_KEY + 1,
+        TEST_MAX_AGE_MS ) );
+    TEST_ASSERT_FALSE(
+        AiaRegulatorBuffer_SetMaxAge( NULL, 1, TEST_MAX_AGE_MS ) );
+}
+#endif
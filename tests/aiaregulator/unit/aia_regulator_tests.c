@@ -357,6 +357,20 @@ TEST_GROUP_RUNNER( AiaRegulatorTests )
     RUN_TEST_CASE( AiaRegulatorTests, BurstModeOneRuntOneMax );
     RUN_TEST_CASE( AiaRegulatorTests, BurstModeTwoMax );
     RUN_TEST_CASE( AiaRegulatorTests, BadEmitAllMessage );
+    RUN_TEST_CASE( AiaRegulatorTests, TrickleModeWritesWhileEmitScheduled );
+    RUN_TEST_CASE( AiaRegulatorTests, TrickleModeWriteAfterIdle );
+    RUN_TEST_CASE( AiaRegulatorTests, SetMaxBurstWithZero );
+    RUN_TEST_CASE( AiaRegulatorTests, MaxBurstEmitsBackToBack );
+    RUN_TEST_CASE( AiaRegulatorTests, SetWatermarksWithInvalidLevels );
+    RUN_TEST_CASE( AiaRegulatorTests, WatermarksBoundQueueWithHysteresis );
+    RUN_TEST_CASE( AiaRegulatorTests, GetMinWaitTimeMs );
+    RUN_TEST_CASE( AiaRegulatorTests, GetRemainingMessageSpace );
+    RUN_TEST_CASE( AiaRegulatorTests, DeferredWriteHeldUntilDeadline );
+    RUN_TEST_CASE( AiaRegulatorTests, DeferredWriteGoesOutWithNormalWrite );
+    RUN_TEST_CASE( AiaRegulatorTests, FlushEmitsDeferredWrite );
+#ifdef AIA_ENABLE_WARM_RECONNECT
+    RUN_TEST_CASE( AiaRegulatorTests, PausedWritesHeldUntilResumed );
+#endif
 }
 
 /*-----------------------------------------------------------*/
@@ -624,3 +638,353 @@ TEST( AiaRegulatorTests, BadEmitAllMessage )
     TEST_ASSERT_TRUE(
         AiaListDouble( IsEmpty )( &g_aiaRegulatorTestData.emitOutput ) );
 }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test writing runt messages while in trickle mode while an emit is already
+ * scheduled.  The later writes should not push the scheduled emit out, and
+ * should be emitted together with it.
+ */
+TEST( AiaRegulatorTests, TrickleModeWritesWhileEmitScheduled )
+{
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c1 ) ) );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    AiaTimepointMs_t t1 = front->timepointMs;
+    DestroyEmittedMessage( front );
+    TEST_ASSERT_TRUE( CheckImmediateEmitTimestamp( t0, t1, "First message" ) );
+
+    AiaJsonMessage_t* c2 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c2 ) ) );
+    AiaClock( SleepMs( TEST_EMIT_DELAY_TIME_MS / 3 ) );
+    AiaJsonMessage_t* c3 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c3 ) ) );
+
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 2 ) );
+    front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    AiaTimepointMs_t t2 = front->timepointMs;
+    DestroyEmittedMessage( front );
+    TEST_ASSERT_TRUE( CheckDelayedEmitTimestamp( t1, t2, "Second message" ) );
+    front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_TRUE(
+        CheckImmediateEmitTimestamp( t2, front->timepointMs, "Third message" ) );
+    DestroyEmittedMessage( front );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test writing a runt message while in trickle mode after the regulator has
+ * gone idle.  Should see an immediate emit.
+ */
+TEST( AiaRegulatorTests, TrickleModeWriteAfterIdle )
+{
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c1 ) ) );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    DestroyEmittedMessage( front );
+
+    AiaClock( SleepMs( TEST_EMIT_DELAY_TIME_MS ) );
+
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaJsonMessage_t* c2 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c2 ) ) );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_TRUE(
+        CheckImmediateEmitTimestamp( t0, front->timepointMs, "Second message" ) );
+    DestroyEmittedMessage( front );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorTests, SetMaxBurstWithZero )
+{
+    TEST_ASSERT_FALSE( AiaRegulator_SetMaxBurst( NULL, 1 ) );
+    TEST_ASSERT_FALSE(
+        AiaRegulator_SetMaxBurst( g_aiaRegulatorTestData.testRegulator, 0 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that a burst of messages which can not aggregate is emitted back to
+ * back while tokens remain, and that the next message waits for a token.
+ */
+TEST( AiaRegulatorTests, MaxBurstEmitsBackToBack )
+{
+    static const size_t TEST_MAX_BURST = 3;
+    TEST_ASSERT_TRUE( AiaRegulator_SetMaxBurst(
+        g_aiaRegulatorTestData.testRegulator, TEST_MAX_BURST ) );
+
+    AiaClock( SleepMs( TEST_EMIT_DELAY_TIME_MS * TEST_MAX_BURST ) );
+    for( size_t i = 0; i <= TEST_MAX_BURST; ++i )
+    {
+        AiaJsonMessage_t* chunk =
+            AiaTestUtilities_CreateJsonMessage( TEST_MAX_MESSAGE_SIZE );
+        TEST_ASSERT_TRUE(
+            AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                AiaJsonMessage_ToMessage( chunk ) ) );
+    }
+
+    AiaClock( SleepMs( TEST_EMIT_NO_DELAY_TIME_MS ) );
+    TEST_ASSERT_EQUAL(
+        TEST_MAX_BURST,
+        AiaListDouble( Count )( &g_aiaRegulatorTestData.emitOutput ) );
+
+    AiaClock( SleepMs( TEST_EMIT_DELAY_TIME_MS ) );
+    TEST_ASSERT_EQUAL(
+        TEST_MAX_BURST + 1,
+        AiaListDouble( Count )( &g_aiaRegulatorTestData.emitOutput ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/** Number of times @c WatermarkCallback was called with @c true. */
+static uint32_t g_aboveHighWatermarkCount;
+
+/** Number of times @c WatermarkCallback was called with @c false. */
+static uint32_t g_belowLowWatermarkCount;
+
+/**
+ * Counts the watermark crossings signalled by a regulator.
+ *
+ * @param isAboveHighWatermark Whether the high watermark was reached.
+ * @param userData Unused.
+ */
+static void WatermarkCallback( bool isAboveHighWatermark, void* userData )
+{
+    (void)userData;
+    AiaAtomic_Add_u32( isAboveHighWatermark ? &g_aboveHighWatermarkCount
+                                            : &g_belowLowWatermarkCount,
+                       1 );
+}
+
+TEST( AiaRegulatorTests, SetWatermarksWithInvalidLevels )
+{
+    TEST_ASSERT_FALSE( AiaRegulator_SetWatermarks(
+        NULL, TEST_MAX_MESSAGE_SIZE, 0, WatermarkCallback, NULL ) );
+    TEST_ASSERT_FALSE( AiaRegulator_SetWatermarks(
+        g_aiaRegulatorTestData.testRegulator, TEST_MAX_MESSAGE_SIZE,
+        TEST_MAX_MESSAGE_SIZE, WatermarkCallback, NULL ) );
+    TEST_ASSERT_TRUE(
+        AiaRegulator_SetWatermarks( g_aiaRegulatorTestData.testRegulator, 0,
+                                    TEST_MAX_MESSAGE_SIZE, NULL, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that writes fail once the high watermark is reached, and that the
+ * callback signals both crossings exactly once.
+ */
+TEST( AiaRegulatorTests, WatermarksBoundQueueWithHysteresis )
+{
+    AiaAtomic_Store_u32( &g_aboveHighWatermarkCount, 0 );
+    AiaAtomic_Store_u32( &g_belowLowWatermarkCount, 0 );
+    TEST_ASSERT_TRUE( AiaRegulator_SetWatermarks(
+        g_aiaRegulatorTestData.testRegulator, 2 * TEST_MAX_MESSAGE_SIZE, 0,
+        WatermarkCallback, NULL ) );
+
+    /* Spend the token so that the following chunks stay queued. */
+    AiaJsonMessage_t* chunk =
+        AiaTestUtilities_CreateJsonMessage( TEST_MAX_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( chunk ) ) );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        chunk = AiaTestUtilities_CreateJsonMessage( TEST_MAX_MESSAGE_SIZE );
+        TEST_ASSERT_TRUE(
+            AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                AiaJsonMessage_ToMessage( chunk ) ) );
+    }
+    TEST_ASSERT_EQUAL( 1, AiaAtomic_Load_u32( &g_aboveHighWatermarkCount ) );
+
+    chunk = AiaTestUtilities_CreateJsonMessage( TEST_MAX_MESSAGE_SIZE );
+    TEST_ASSERT_FALSE(
+        AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                            AiaJsonMessage_ToMessage( chunk ) ) );
+
+    /* The next emit makes room, but the queue stays above the low watermark,
+     * so the high watermark is not signalled again. */
+    TEST_ASSERT_TRUE( AiaRegulator_WriteOrWait(
+        g_aiaRegulatorTestData.testRegulator, AiaJsonMessage_ToMessage( chunk ),
+        TEST_EMIT_DELAY_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1, AiaAtomic_Load_u32( &g_aboveHighWatermarkCount ) );
+    TEST_ASSERT_EQUAL( 0, AiaAtomic_Load_u32( &g_belowLowWatermarkCount ) );
+
+    for( size_t i = 0; i < 3; ++i )
+    {
+        TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    }
+    TEST_ASSERT_EQUAL( 1, AiaAtomic_Load_u32( &g_aboveHighWatermarkCount ) );
+    TEST_ASSERT_EQUAL( 1, AiaAtomic_Load_u32( &g_belowLowWatermarkCount ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( AiaRegulatorTests, GetMinWaitTimeMs )
+{
+    TEST_ASSERT_EQUAL( TEST_EMIT_DELAY_TIME_MS,
+                       AiaRegulator_GetMinWaitTimeMs(
+                           g_aiaRegulatorTestData.testRegulator ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that the remaining message space shrinks while a runt chunk waits to be
+ * aggregated in burst mode.
+ */
+TEST( AiaRegulatorTests, GetRemainingMessageSpace )
+{
+    AiaRegulator_SetEmitMode( g_aiaRegulatorTestData.testRegulator,
+                              AIA_REGULATOR_BURST );
+    TEST_ASSERT_EQUAL( TEST_MAX_MESSAGE_SIZE,
+                       AiaRegulator_GetRemainingMessageSpace(
+                           g_aiaRegulatorTestData.testRegulator ) );
+
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_NOT_NULL( c1 );
+    size_t c1Size = AiaMessage_GetSize( AiaJsonMessage_ToMessage( c1 ) );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c1 ) ) );
+    TEST_ASSERT_EQUAL( TEST_MAX_MESSAGE_SIZE - c1Size,
+                       AiaRegulator_GetRemainingMessageSpace(
+                           g_aiaRegulatorTestData.testRegulator ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that a deferred chunk is held until its deadline when nothing else is
+ * written.
+ */
+TEST( AiaRegulatorTests, DeferredWriteHeldUntilDeadline )
+{
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_WriteWithDeadline(
+        g_aiaRegulatorTestData.testRegulator, AiaJsonMessage_ToMessage( c1 ),
+        TEST_EMIT_DELAY_TIME_MS ) );
+
+    AiaClock( SleepMs( TEST_EMIT_NO_DELAY_TIME_MS ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaListDouble( Count )( &g_aiaRegulatorTestData.emitOutput ) );
+
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_TRUE( CheckDelayedEmitTimestamp( t0, front->timepointMs,
+                                                 "Deferred message" ) );
+    DestroyEmittedMessage( front );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that a deferred chunk goes out together with a chunk which can not wait,
+ * behind it, well before its own deadline.
+ */
+TEST( AiaRegulatorTests, DeferredWriteGoesOutWithNormalWrite )
+{
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_WriteWithDeadline(
+        g_aiaRegulatorTestData.testRegulator, AiaJsonMessage_ToMessage( c1 ),
+        TEST_EMIT_DELAY_TIMEOUT_MS * 4 ) );
+    AiaClock( SleepMs( TEST_EMIT_NO_DELAY_TIME_MS ) );
+    TEST_ASSERT_EQUAL(
+        0, AiaListDouble( Count )( &g_aiaRegulatorTestData.emitOutput ) );
+
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaJsonMessage_t* c2 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c2 ) ) );
+    AiaClock( SleepMs( TEST_EMIT_NO_DELAY_TIME_MS ) );
+    TEST_ASSERT_EQUAL(
+        2, AiaListDouble( Count )( &g_aiaRegulatorTestData.emitOutput ) );
+
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_EQUAL_PTR( AiaJsonMessage_ToMessage( c2 ), front->chunk );
+    TEST_ASSERT_TRUE( CheckImmediateEmitTimestamp( t0, front->timepointMs,
+                                                   "Normal message" ) );
+    DestroyEmittedMessage( front );
+    front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_EQUAL_PTR( AiaJsonMessage_ToMessage( c1 ), front->chunk );
+    TEST_ASSERT_TRUE( CheckImmediateEmitTimestamp( t0, front->timepointMs,
+                                                   "Deferred message" ) );
+    DestroyEmittedMessage( front );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * Test that flushing the regulator emits a deferred chunk immediately.
+ */
+TEST( AiaRegulatorTests, FlushEmitsDeferredWrite )
+{
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_WriteWithDeadline(
+        g_aiaRegulatorTestData.testRegulator, AiaJsonMessage_ToMessage( c1 ),
+        TEST_EMIT_DELAY_TIMEOUT_MS * 4 ) );
+
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaRegulator_Flush( g_aiaRegulatorTestData.testRegulator );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_TRUE( CheckImmediateEmitTimestamp( t0, front->timepointMs,
+                                                   "Deferred message" ) );
+    DestroyEmittedMessage( front );
+}
+
+#ifdef AIA_ENABLE_WARM_RECONNECT
+TEST( AiaRegulatorTests, PausedWritesHeldUntilResumed )
+{
+    AiaRegulator_SetPaused( g_aiaRegulatorTestData.testRegulator, true );
+    AiaJsonMessage_t* c1 =
+        AiaTestUtilities_CreateJsonMessage( TEST_RUNT_MESSAGE_SIZE );
+    TEST_ASSERT_TRUE( AiaRegulator_Write( g_aiaRegulatorTestData.testRegulator,
+                                          AiaJsonMessage_ToMessage( c1 ) ) );
+    AiaRegulator_Flush( g_aiaRegulatorTestData.testRegulator );
+    TEST_ASSERT_FALSE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+
+    AiaTimepointMs_t t0 = AiaClock( GetTimeMs )();
+    AiaRegulator_SetPaused( g_aiaRegulatorTestData.testRegulator, false );
+    TEST_ASSERT_TRUE( WaitForEmit( &g_aiaRegulatorTestData, 1 ) );
+    EmittedMessage_t* front = (EmittedMessage_t*)AiaListDouble( RemoveHead )(
+        &g_aiaRegulatorTestData.emitOutput );
+    TEST_ASSERT_EQUAL_PTR( AiaJsonMessage_ToMessage( c1 ), front->chunk );
+    TEST_ASSERT_TRUE(
+        CheckImmediateEmitTimestamp( t0, front->timepointMs, "Held message" ) );
+    DestroyEmittedMessage( front );
+}
+#endif
@@ -89,22 +89,38 @@ typedef struct AiaMockSecretStorer
     bool valueToReturn;
 } AiaMockSecretStorer_t;
 
-/** Mock type used to intercept calls to @c AiaCrypto_SetKey. */
+/** Mock type used to intercept calls to @c AiaCrypto_SetContextKey and
+ * encryption/decryption using an @c AiaCryptoContext_t. */
 typedef struct AiaMockEncryptor
 {
-    /** Encryption key set by a call to @c AiaCrypto_SetKey. */
+    /** Encryption key set by the most recent call to @c
+     * AiaCrypto_SetContextKey or used by the most recent encryption/decryption.
+     */
     uint8_t* encryptKey;
 
-    /** Size set by a call to @c AiaCrypto_SetKey. */
+    /** Size of @c encryptKey. */
     size_t encryptKeySize;
 
-    /** Encryption algorithm set by a call to @c AiaCrypto_SetKey. */
+    /** Encryption algorithm set by a call to @c AiaCrypto_SetContextKey. */
     AiaEncryptionAlgorithm_t encryptAlgorithm;
 
-    /** Value to return upon calls to @c AiaCrypto_SetKey. */
+    /** Value to return upon calls to @c AiaCrypto_SetContextKey. */
     bool valueToReturn;
+
+    /** Number of calls to @c AiaCrypto_SetContextKey. */
+    size_t numSetContextKeyCalls;
 } AiaMockEncryptor_t;
 
+/** Mock type standing in for an @c AiaCryptoContext_t. */
+typedef struct AiaMockCryptoContext
+{
+    /** Encryption key set on this context by @c AiaCrypto_SetContextKey. */
+    uint8_t* encryptKey;
+
+    /** Size of @c encryptKey. */
+    size_t encryptKeySize;
+} AiaMockCryptoContext_t;
+
 /** Object used to mock the getting of outbound sequence numbers. */
 static AiaMockNextSequenceNumberGetter_t testSequenceNumberGetter;
 
@@ -120,6 +136,9 @@ static AiaMockEncryptor_t* testMockEncryptor;
 /** A test initial shared secret stored using @c testSecretStorer. */
 static const uint8_t INITIAL_SHARED_SECRET[ 32 ] = { 0x08 };
 
+/** How long to wait for a rotated secret to be persisted. */
+static const AiaDurationMs_t PERSISTENCE_TIMEOUT_MS = 1000;
+
 /** The secret manager to test. */
 static AiaSecretManager_t* g_testSecretManager;
 
@@ -142,17 +161,110 @@ bool AiaLoadSecret( uint8_t* sharedSecret, size_t size )
     return testSecretStorer->valueToReturn;
 }
 
-bool AiaCrypto_SetKey( const uint8_t* encryptKey, size_t encryptKeySize,
-                       const AiaEncryptionAlgorithm_t encryptAlgorithm )
+/**
+ * Records @c encryptKey as the key most recently set or used in @c
+ * testMockEncryptor.
+ *
+ * @param encryptKey The key to record.
+ * @param encryptKeySize The size of @c encryptKey.
+ */
+static void AiaMockEncryptor_RecordKey( const uint8_t* encryptKey,
+                                        size_t encryptKeySize )
 {
+    AiaFree( testMockEncryptor->encryptKey );
     testMockEncryptor->encryptKey = AiaCalloc( 1, encryptKeySize );
     TEST_ASSERT_NOT_NULL( testMockEncryptor->encryptKey );
     memcpy( testMockEncryptor->encryptKey, encryptKey, encryptKeySize );
     testMockEncryptor->encryptKeySize = encryptKeySize;
+}
+
+AiaCryptoContext_t* AiaCrypto_CreateContext()
+{
+    AiaMockCryptoContext_t* context =
+        AiaCalloc( 1, sizeof( AiaMockCryptoContext_t ) );
+    TEST_ASSERT_NOT_NULL( context );
+    return (AiaCryptoContext_t*)context;
+}
+
+bool AiaCrypto_SetContextKey( AiaCryptoContext_t* context,
+                              const uint8_t* encryptKey, size_t encryptKeySize,
+                              const AiaEncryptionAlgorithm_t encryptAlgorithm )
+{
+    AiaMockCryptoContext_t* mockContext = (AiaMockCryptoContext_t*)context;
+    TEST_ASSERT_NOT_NULL( mockContext );
+    AiaFree( mockContext->encryptKey );
+    mockContext->encryptKey = AiaCalloc( 1, encryptKeySize );
+    TEST_ASSERT_NOT_NULL( mockContext->encryptKey );
+    memcpy( mockContext->encryptKey, encryptKey, encryptKeySize );
+    mockContext->encryptKeySize = encryptKeySize;
+
+    AiaMockEncryptor_RecordKey( encryptKey, encryptKeySize );
     testMockEncryptor->encryptAlgorithm = encryptAlgorithm;
+    ++testMockEncryptor->numSetContextKeyCalls;
     return testMockEncryptor->valueToReturn;
 }
 
+bool AiaCrypto_EncryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   uint8_t* iv, size_t ivLen, uint8_t* tag,
+                                   const size_t tagLen )
+{
+    (void)inputData;
+    (void)inputLen;
+    (void)outputData;
+    (void)iv;
+    (void)ivLen;
+    (void)tag;
+    (void)tagLen;
+    AiaMockCryptoContext_t* mockContext = (AiaMockCryptoContext_t*)context;
+    TEST_ASSERT_NOT_NULL( mockContext );
+    TEST_ASSERT_NOT_NULL( mockContext->encryptKey );
+    AiaMockEncryptor_RecordKey( mockContext->encryptKey,
+                                mockContext->encryptKeySize );
+    return true;
+}
+
+bool AiaCrypto_DecryptWithContext( AiaCryptoContext_t* context,
+                                   const uint8_t* inputData,
+                                   const size_t inputLen, uint8_t* outputData,
+                                   const uint8_t* iv, const size_t ivLen,
+                                   const uint8_t* tag, const size_t tagLen )
+{
+    (void)inputData;
+    (void)inputLen;
+    (void)outputData;
+    (void)iv;
+    (void)ivLen;
+    (void)tag;
+    (void)tagLen;
+    AiaMockCryptoContext_t* mockContext = (AiaMockCryptoContext_t*)context;
+    TEST_ASSERT_NOT_NULL( mockContext );
+    TEST_ASSERT_NOT_NULL( mockContext->encryptKey );
+    AiaMockEncryptor_RecordKey( mockContext->encryptKey,
+                                mockContext->encryptKeySize );
+    return true;
+}
+
+void AiaCrypto_DestroyContext( AiaCryptoContext_t* context )
+{
+    AiaMockCryptoContext_t* mockContext = (AiaMockCryptoContext_t*)context;
+    TEST_ASSERT_NOT_NULL( mockContext );
+    AiaFree( mockContext->encryptKey );
+    AiaFree( mockContext );
+}
+
+/**
+ * Waits for the @c g_mockEventRegulator to be written to by the secret
+ * manager's persistence worker, leaving the written message in place.
+ */
+static void WaitForPersistence()
+{
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_mockEventRegulator->writeSemaphore, PERSISTENCE_TIMEOUT_MS ) );
+    AiaSemaphore( Post )( &g_mockEventRegulator->writeSemaphore );
+}
+
 /**
  * Used to pull a message out of the @c g_mockEventRegulator and assert that it
  * is an @c AIA_EVENTS_SECRET_ROTATED event
@@ -166,8 +278,8 @@ static void TestSecretRotatedIsGenerated(
     AiaSequenceNumber_t* eventSequenceNumber,
     AiaSequenceNumber_t* microphoneSequenceNumber )
 {
-    TEST_ASSERT_TRUE(
-        AiaSemaphore( TryWait )( &g_mockEventRegulator->writeSemaphore ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_mockEventRegulator->writeSemaphore, PERSISTENCE_TIMEOUT_MS ) );
     AiaListDouble( Link_t )* link = NULL;
     link = AiaListDouble( PeekHead )( &g_mockEventRegulator->writtenMessages );
     AiaListDouble( RemoveHead )( &g_mockEventRegulator->writtenMessages );
@@ -273,6 +385,9 @@ TEST_GROUP_RUNNER( AiaSecretManagerTests )
     RUN_TEST_CASE( AiaSecretManagerTests, SecretStorageFails );
     RUN_TEST_CASE( AiaSecretManagerTests, SecretRotatedIsSent );
     RUN_TEST_CASE( AiaSecretManagerTests, TestAppropriateKeysAreSet );
+    RUN_TEST_CASE( AiaSecretManagerTests, TopicsAreKeyedIndependently );
+    RUN_TEST_CASE( AiaSecretManagerTests, UnpreparedSecretsAreSetOnSwitch );
+    RUN_TEST_CASE( AiaSecretManagerTests, StaleSecretsAreDiscarded );
 }
 
 /*-----------------------------------------------------------*/
@@ -330,6 +445,7 @@ TEST_TEAR_DOWN( AiaSecretManagerTests )
 {
     AiaSecretManager_Destroy( g_testSecretManager );
 
+    AiaFree( testMockEncryptor->encryptKey );
     AiaFree( testMockEncryptor );
     AiaFree( testSecretStorer );
     AiaMockRegulator_Destroy( g_mockEventRegulator,
@@ -525,6 +641,7 @@ TEST( AiaSecretManagerTests, GetNextSequenceNumberFails )
         strlen( rotateSecretEvent ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
     AiaFree( rotateSecretEvent );
 
+    WaitForPersistence();
     AiaTestUtilities_TestInternalExceptionExceptionIsGenerated(
         g_mockEventRegulator );
 }
@@ -561,8 +678,15 @@ TEST( AiaSecretManagerTests, SecretStorageFails )
         strlen( rotateSecretEvent ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
     AiaFree( rotateSecretEvent );
 
+    WaitForPersistence();
     AiaTestUtilities_TestInternalExceptionExceptionIsGenerated(
         g_mockEventRegulator );
+    /* The rotation is abandoned, so the initial secret stays in effect. */
+    AiaSecretManager_Decrypt( g_testSecretManager, AIA_TOPIC_DIRECTIVE,
+                              TEST_DIRECTIVE_SEQUENCE_NUMBER, NULL, 0, NULL,
+                              NULL, 0, NULL, 0 );
+    TEST_ASSERT_EQUAL_MEMORY( INITIAL_SHARED_SECRET,
+                              testMockEncryptor->encryptKey, newSecretLength );
 }
 
 TEST( AiaSecretManagerTests, SecretRotatedIsSent )
@@ -722,3 +846,212 @@ TEST( AiaSecretManagerTests, TestAppropriateKeysAreSet )
     TEST_ASSERT_EQUAL_MEMORY( INITIAL_SHARED_SECRET,
                               testMockEncryptor->encryptKey, newSecretLength );
 }
+
+TEST( AiaSecretManagerTests, TopicsAreKeyedIndependently )
+{
+    size_t newSecretLength =
+        AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) ) );
+    uint8_t TEST_NEW_SECRET[ newSecretLength ];
+    memset( TEST_NEW_SECRET, 4, newSecretLength );
+    size_t newSecretBase64Length =
+        Aia_Base64GetEncodeSize( TEST_NEW_SECRET, newSecretLength );
+    TEST_ASSERT_NOT_EQUAL( 0, newSecretBase64Length );
+    uint8_t BASE64_ENCODED_NEW_SECRET[ newSecretBase64Length ];
+    TEST_ASSERT_TRUE( Aia_Base64Encode( TEST_NEW_SECRET, newSecretLength,
+                                        BASE64_ENCODED_NEW_SECRET,
+                                        newSecretBase64Length ) );
+
+    AiaSequenceNumber_t TEST_DIRECTIVE_SEQUENCE_NUMBER = 44;
+    AiaSequenceNumber_t TEST_SPEAKER_SEQUENCE_NUMBER = 88;
+    char* rotateSecretEvent = generateRotateSecret(
+        BASE64_ENCODED_NEW_SECRET, newSecretBase64Length,
+        TEST_DIRECTIVE_SEQUENCE_NUMBER, TEST_SPEAKER_SEQUENCE_NUMBER );
+    TEST_ASSERT_NOT_NULL( rotateSecretEvent );
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+
+    AiaSequenceNumber_t TEST_OUTBOUND_SEQUENCE_NUMBER = 50;
+    testSequenceNumberGetter.sequenceNumberToReturn =
+        TEST_OUTBOUND_SEQUENCE_NUMBER;
+    AiaSecretManager_OnRotateSecretDirectiveReceived(
+        g_testSecretManager, (void*)rotateSecretEvent,
+        strlen( rotateSecretEvent ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( rotateSecretEvent );
+    AiaSequenceNumber_t eventSequenceNumber = 0;
+    AiaSequenceNumber_t microphoneSequenceNumber = 0;
+    TestSecretRotatedIsGenerated( &eventSequenceNumber,
+                                  &microphoneSequenceNumber );
+
+    /* Move the event topic onto the new secret. Its key was set when the
+     * secret was received, so no key changes are expected in this test. */
+    size_t numSetContextKeyCalls = testMockEncryptor->numSetContextKeyCalls;
+    AiaSecretManager_Encrypt( g_testSecretManager, AIA_TOPIC_EVENT,
+                              eventSequenceNumber, NULL, 0, NULL, NULL, 0, NULL,
+                              0 );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET, testMockEncryptor->encryptKey,
+                              newSecretLength );
+    TEST_ASSERT_EQUAL( numSetContextKeyCalls,
+                       testMockEncryptor->numSetContextKeyCalls );
+
+    /* Interleaving topics which use different secrets should not require
+     * re-keying either topic. */
+    for( size_t i = 0; i < 3; ++i )
+    {
+        AiaSecretManager_Decrypt( g_testSecretManager, AIA_TOPIC_DIRECTIVE,
+                                  TEST_DIRECTIVE_SEQUENCE_NUMBER - 1, NULL, 0,
+                                  NULL, NULL, 0, NULL, 0 );
+        TEST_ASSERT_EQUAL_MEMORY( INITIAL_SHARED_SECRET,
+                                  testMockEncryptor->encryptKey,
+                                  newSecretLength );
+        AiaSecretManager_Encrypt( g_testSecretManager, AIA_TOPIC_EVENT,
+                                  eventSequenceNumber + i, NULL, 0, NULL, NULL,
+                                  0, NULL, 0 );
+        TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET,
+                                  testMockEncryptor->encryptKey,
+                                  newSecretLength );
+    }
+    TEST_ASSERT_EQUAL( numSetContextKeyCalls,
+                       testMockEncryptor->numSetContextKeyCalls );
+
+    /* Unencrypted topics have no key to use. */
+    TEST_ASSERT_FALSE( AiaSecretManager_Encrypt(
+        g_testSecretManager, AIA_TOPIC_CONNECTION_FROM_CLIENT, 0, NULL, 0, NULL,
+        NULL, 0, NULL, 0 ) );
+}
+
+TEST( AiaSecretManagerTests, UnpreparedSecretsAreSetOnSwitch )
+{
+    size_t newSecretLength =
+        AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) ) );
+    uint8_t TEST_NEW_SECRET[ newSecretLength ];
+    memset( TEST_NEW_SECRET, 4, newSecretLength );
+    size_t newSecretBase64Length =
+        Aia_Base64GetEncodeSize( TEST_NEW_SECRET, newSecretLength );
+    TEST_ASSERT_NOT_EQUAL( 0, newSecretBase64Length );
+    uint8_t BASE64_ENCODED_NEW_SECRET[ newSecretBase64Length ];
+    TEST_ASSERT_TRUE( Aia_Base64Encode( TEST_NEW_SECRET, newSecretLength,
+                                        BASE64_ENCODED_NEW_SECRET,
+                                        newSecretBase64Length ) );
+
+    AiaSequenceNumber_t TEST_DIRECTIVE_SEQUENCE_NUMBER = 44;
+    AiaSequenceNumber_t TEST_SPEAKER_SEQUENCE_NUMBER = 88;
+    char* rotateSecretEvent = generateRotateSecret(
+        BASE64_ENCODED_NEW_SECRET, newSecretBase64Length,
+        TEST_DIRECTIVE_SEQUENCE_NUMBER, TEST_SPEAKER_SEQUENCE_NUMBER );
+    TEST_ASSERT_NOT_NULL( rotateSecretEvent );
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+
+    /* Preparing the new secret fails, which should not fail the rotation. */
+    testMockEncryptor->valueToReturn = false;
+    AiaSequenceNumber_t TEST_OUTBOUND_SEQUENCE_NUMBER = 50;
+    testSequenceNumberGetter.sequenceNumberToReturn =
+        TEST_OUTBOUND_SEQUENCE_NUMBER;
+    AiaSecretManager_OnRotateSecretDirectiveReceived(
+        g_testSecretManager, (void*)rotateSecretEvent,
+        strlen( rotateSecretEvent ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( rotateSecretEvent );
+    AiaSequenceNumber_t eventSequenceNumber = 0;
+    AiaSequenceNumber_t microphoneSequenceNumber = 0;
+    TestSecretRotatedIsGenerated( &eventSequenceNumber,
+                                  &microphoneSequenceNumber );
+    testMockEncryptor->valueToReturn = true;
+
+    /* The key is instead set when the event topic switches to the secret. */
+    size_t numSetContextKeyCalls = testMockEncryptor->numSetContextKeyCalls;
+    TEST_ASSERT_TRUE( AiaSecretManager_Encrypt(
+        g_testSecretManager, AIA_TOPIC_EVENT, eventSequenceNumber, NULL, 0,
+        NULL, NULL, 0, NULL, 0 ) );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET, testMockEncryptor->encryptKey,
+                              newSecretLength );
+    TEST_ASSERT_EQUAL( numSetContextKeyCalls + 1,
+                       testMockEncryptor->numSetContextKeyCalls );
+}
+
+TEST( AiaSecretManagerTests, StaleSecretsAreDiscarded )
+{
+    size_t newSecretLength =
+        AiaBytesToHoldBits( AiaEncryptionAlgorithm_GetKeySize(
+            AiaSecretDerivationAlgorithm_ToEncryptionAlgorithm(
+                SECRET_DERIVATION_ALGORITHM ) ) );
+    uint8_t TEST_NEW_SECRET[ newSecretLength ];
+    memset( TEST_NEW_SECRET, 4, newSecretLength );
+    size_t newSecretBase64Length =
+        Aia_Base64GetEncodeSize( TEST_NEW_SECRET, newSecretLength );
+    TEST_ASSERT_NOT_EQUAL( 0, newSecretBase64Length );
+    uint8_t BASE64_ENCODED_NEW_SECRET[ newSecretBase64Length ];
+    TEST_ASSERT_TRUE( Aia_Base64Encode( TEST_NEW_SECRET, newSecretLength,
+                                        BASE64_ENCODED_NEW_SECRET,
+                                        newSecretBase64Length ) );
+
+    AiaSequenceNumber_t TEST_DIRECTIVE_SEQUENCE_NUMBER = 44;
+    AiaSequenceNumber_t TEST_SPEAKER_SEQUENCE_NUMBER = 88;
+    char* rotateSecretEvent = generateRotateSecret(
+        BASE64_ENCODED_NEW_SECRET, newSecretBase64Length,
+        TEST_DIRECTIVE_SEQUENCE_NUMBER, TEST_SPEAKER_SEQUENCE_NUMBER );
+    TEST_ASSERT_NOT_NULL( rotateSecretEvent );
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 4;
+    size_t TEST_INDEX = 44;
+
+    AiaSequenceNumber_t TEST_OUTBOUND_SEQUENCE_NUMBER = 50;
+    testSequenceNumberGetter.sequenceNumberToReturn =
+        TEST_OUTBOUND_SEQUENCE_NUMBER;
+    AiaSecretManager_OnRotateSecretDirectiveReceived(
+        g_testSecretManager, (void*)rotateSecretEvent,
+        strlen( rotateSecretEvent ), TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( rotateSecretEvent );
+    AiaSequenceNumber_t eventSequenceNumber = 0;
+    AiaSequenceNumber_t microphoneSequenceNumber = 0;
+    TestSecretRotatedIsGenerated( &eventSequenceNumber,
+                                  &microphoneSequenceNumber );
+
+    /* Move every topic except the speaker onto the new secret. Outbound topics
+     * all share the same starting sequence number. */
+    for( size_t i = 0; i < AIA_NUM_TOPICS; ++i )
+    {
+        if( !AiaTopic_IsEncrypted( i ) || i == AIA_TOPIC_SPEAKER )
+        {
+            continue;
+        }
+        AiaSequenceNumber_t sequenceNumber = 0;
+        if( i == AIA_TOPIC_DIRECTIVE )
+        {
+            sequenceNumber = TEST_DIRECTIVE_SEQUENCE_NUMBER;
+        }
+        else if( AiaTopic_IsOutbound( i ) )
+        {
+            sequenceNumber = eventSequenceNumber;
+        }
+        AiaSecretManager_Encrypt( g_testSecretManager, i, sequenceNumber, NULL,
+                                  0, NULL, NULL, 0, NULL, 0 );
+        TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET,
+                                  testMockEncryptor->encryptKey,
+                                  newSecretLength );
+    }
+
+    /* The speaker topic may still need the initial secret, so it is kept. */
+#ifdef AIA_ENABLE_SPEAKER
+    AiaSecretManager_Encrypt( g_testSecretManager, AIA_TOPIC_EVENT,
+                              eventSequenceNumber - 1, NULL, 0, NULL, NULL, 0,
+                              NULL, 0 );
+    TEST_ASSERT_EQUAL_MEMORY( INITIAL_SHARED_SECRET,
+                              testMockEncryptor->encryptKey, newSecretLength );
+#endif
+
+    /* Once the speaker topic moves on, the initial secret is discarded and the
+     * oldest remaining secret is used for any earlier sequence numbers. */
+    AiaSecretManager_Decrypt( g_testSecretManager, AIA_TOPIC_SPEAKER,
+                              TEST_SPEAKER_SEQUENCE_NUMBER, NULL, 0, NULL, NULL,
+                              0, NULL, 0 );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET, testMockEncryptor->encryptKey,
+                              newSecretLength );
+    AiaSecretManager_Encrypt( g_testSecretManager, AIA_TOPIC_EVENT,
+                              eventSequenceNumber - 1, NULL, 0, NULL, NULL, 0,
+                              NULL, 0 );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_NEW_SECRET, testMockEncryptor->encryptKey,
+                              newSecretLength );
+}
@@ -25,6 +25,8 @@
 /* Aia headers */
 #include <aiasequencer/aia_sequencer.h>
 
+#include <aianetworkimpairment/aia_network_impairment.h>
+
 #include AiaTaskPool( HEADER )
 #include AiaSemaphore( HEADER )
 
@@ -79,18 +81,37 @@ TEST_GROUP_RUNNER( AiaSequencerTests )
     RUN_TEST_CASE( AiaSequencerTests, SingleMessageOutOfOrderInBuffer );
     RUN_TEST_CASE( AiaSequencerTests, MultipleMessageOutOfOrderInBuffer );
     RUN_TEST_CASE( AiaSequencerTests, MultipleMessageOutOfOrderOutOfBuffer );
+    RUN_TEST_CASE( AiaSequencerTests, BufferedSequenceNumbersParsedOnce );
+    RUN_TEST_CASE( AiaSequencerTests, OutOfOrderMessagesAcrossBufferWrap );
+    RUN_TEST_CASE( AiaSequencerTests, OversizedMessageOutOfOrderInBuffer );
+    RUN_TEST_CASE( AiaSequencerTests, WriteAndAdoptOutOfOrderInBuffer );
+    RUN_TEST_CASE( AiaSequencerTests, TrimMemoryReleasesIdlePool );
 
     RUN_TEST_CASE( AiaSequencerTests, Write );
     RUN_TEST_CASE( AiaSequencerTests, WriteDuplicateBuffer );
     RUN_TEST_CASE( AiaSequencerTests, WriteDropMessage );
     RUN_TEST_CASE( AiaSequencerTests, WriteOverBuffer );
+    RUN_TEST_CASE( AiaSequencerTests, Metrics );
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+    RUN_TEST_CASE( AiaSequencerTests, DropOverMemoryBudget );
+#endif
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+    RUN_TEST_CASE( AiaSequencerTests, PreparedMessagesAreSequenced );
+#endif
+    RUN_TEST_CASE( AiaSequencerTests, ReorderHistograms );
+    RUN_TEST_CASE( AiaSequencerTests, AutoTuningGrowsSlots );
+    RUN_TEST_CASE( AiaSequencerTests, AutoTuningInvalidBounds );
     RUN_TEST_CASE( AiaSequencerTests, WriteManyInOrder );
     RUN_TEST_CASE( AiaSequencerTests, WriteOverUint32Max );
     RUN_TEST_CASE( AiaSequencerTests, Timeout );
     RUN_TEST_CASE( AiaSequencerTests, NoTimeout );
+    RUN_TEST_CASE( AiaSequencerTests, ConsecutiveGapsWithinTimeout );
+    RUN_TEST_CASE( AiaSequencerTests, TimeoutsOfSequencersAreIndependent );
+    RUN_TEST_CASE( AiaSequencerTests, SkipMissing );
     RUN_TEST_CASE( AiaSequencerTests, ResetNextExpectedSequenceNumberBasic );
     RUN_TEST_CASE( AiaSequencerTests,
                    SequenceNumberResetsCorrectlyWhenCallingDuringEmission );
+    RUN_TEST_CASE( AiaSequencerTests, MessagesOverImpairedNetwork );
 }
 
 typedef struct AiaTestSequencerObserver
@@ -104,6 +125,8 @@ typedef struct AiaTestSequencerObserver
      * within @c messageSequencedCallback. */
     AiaSequencer_t* sequencer;
 
+    /** The number of calls to @c getSequencerNumberCallback. */
+    size_t numSequenceNumberLookups;
 } AiaTestSequencerObserver_t;
 
 static AiaTestSequencerObserver_t* AiaTestSequencerObserver_Create()
@@ -157,6 +180,7 @@ static bool getSequencerNumberCallback( AiaSequenceNumber_t* sequenceNumber,
     TEST_ASSERT_NOT_NULL( userData );
     TEST_ASSERT_NOT_NULL( message );
     TEST_ASSERT_GREATER_THAN( 0, size );
+    ( (AiaTestSequencerObserver_t*)userData )->numSequenceNumberLookups++;
     *sequenceNumber = strtoul( (char*)message, NULL, 10 );
     return true;
 }
@@ -276,6 +300,161 @@ TEST( AiaSequencerTests, MultipleMessageOutOfOrderOutOfBuffer )
     AiaTestSequencerObserver_Destroy( observer );
 }
 
+TEST( AiaSequencerTests, BufferedSequenceNumbersParsedOnce )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 4, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "5", sizeof( "5" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+
+    TEST_ASSERT_EQUAL_STRING( "12345", observer->messagesOutputted );
+    TEST_ASSERT_EQUAL( 5, observer->numSequenceNumberLookups );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, OutOfOrderMessagesAcrossBufferWrap )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    /* Each round buffers two messages and leaves the buffer front one slot
+     * further around the ring than the previous round. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "5", sizeof( "5" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "6", sizeof( "6" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "8", sizeof( "8" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "9", sizeof( "9" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "7", sizeof( "7" ) ) );
+
+    TEST_ASSERT_EQUAL_STRING( "123456789", observer->messagesOutputted );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, OversizedMessageOutOfOrderInBuffer )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    /* Larger than a pooled slot, so this is buffered in its own allocation. */
+    size_t oversizedMessageSize = AIA_SEQUENCER_SLOT_POOL_DATA_SIZE + 2;
+    char* oversizedMessage = AiaCalloc( 1, oversizedMessageSize );
+    TEST_ASSERT_NOT_NULL( oversizedMessage );
+    memset( oversizedMessage, ' ', oversizedMessageSize - 1 );
+    oversizedMessage[ 0 ] = '2';
+
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, oversizedMessage,
+                                          oversizedMessageSize ) );
+    AiaFree( oversizedMessage );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+
+    TEST_ASSERT_EQUAL( 3 + AIA_SEQUENCER_SLOT_POOL_DATA_SIZE,
+                       strlen( observer->messagesOutputted ) );
+    TEST_ASSERT_EQUAL( 0, strncmp( observer->messagesOutputted, "12", 2 ) );
+    TEST_ASSERT_EQUAL(
+        '3', observer->messagesOutputted[ strlen( observer->messagesOutputted ) -
+                                          1 ] );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, TrimMemoryReleasesIdlePool )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    /* Nothing is pooled until a message arrives out of order. */
+    TEST_ASSERT_EQUAL( 0, AiaSequencer_TrimMemory( sequencer ) );
+
+    /* A held message keeps the pool. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_EQUAL( 0, AiaSequencer_TrimMemory( sequencer ) );
+
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_EQUAL( 3 * AIA_SEQUENCER_SLOT_POOL_DATA_SIZE,
+                       AiaSequencer_TrimMemory( sequencer ) );
+    TEST_ASSERT_EQUAL( 0, AiaSequencer_TrimMemory( sequencer ) );
+
+    /* The pool is allocated again for the next message out of order. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "1234", observer->messagesOutputted );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+static char* copyMessage( const char* message )
+{
+    char* copy = AiaCalloc( strlen( message ) + 1, sizeof( char ) );
+    TEST_ASSERT_NOT_NULL( copy );
+    strcpy( copy, message );
+    return copy;
+}
+
+TEST( AiaSequencerTests, WriteAndAdoptOutOfOrderInBuffer )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "3" ), sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "3" ), sizeof( "3" ) ) );
+    TEST_ASSERT_FALSE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "5" ), sizeof( "5" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "1" ), sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "0" ), sizeof( "0" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "2" ), sizeof( "2" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_WriteAndAdopt(
+        sequencer, copyMessage( "5" ), sizeof( "5" ) ) );
+
+    TEST_ASSERT_EQUAL_STRING( "123", observer->messagesOutputted );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
 TEST( AiaSequencerTests, Write )
 {
     AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
@@ -309,6 +488,15 @@ TEST( AiaSequencerTests, WriteDuplicateBuffer )
     TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
     TEST_ASSERT_EQUAL_STRING( "", observer->messagesOutputted );
 
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 1, metrics.messagesBuffered );
+    TEST_ASSERT_EQUAL( 1, metrics.duplicatesDropped );
+
+    /* The buffered copy is emitted once. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "0", sizeof( "0" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "01", observer->messagesOutputted );
+
     AiaSequencer_Destroy( sequencer );
     AiaTestSequencerObserver_Destroy( observer );
 }
@@ -349,6 +537,263 @@ TEST( AiaSequencerTests, WriteOverBuffer )
     AiaTestSequencerObserver_Destroy( observer );
 }
 
+TEST( AiaSequencerTests, Metrics )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 2, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 0, metrics.messagesBuffered );
+    TEST_ASSERT_EQUAL( 0, metrics.messagesDropped );
+    TEST_ASSERT_EQUAL( 0, metrics.timeoutsExpired );
+
+    /* Old. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "0", sizeof( "0" ) ) );
+    /* Buffered. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    /* Beyond the buffer. */
+    TEST_ASSERT_FALSE( AiaSequencer_Write( sequencer, "9", sizeof( "9" ) ) );
+    /* In order, emitting the buffered message. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "12", observer->messagesOutputted );
+
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 1, metrics.messagesBuffered );
+    TEST_ASSERT_EQUAL( 2, metrics.messagesDropped );
+    TEST_ASSERT_EQUAL( 0, metrics.timeoutsExpired );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+#ifdef AIA_ENABLE_MEMORY_BUDGET
+TEST( AiaSequencerTests, DropOverMemoryBudget )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+    AiaMemoryBudget_t* budget = AiaMemoryBudget_Create( sizeof( "2" ) );
+    TEST_ASSERT_NOT_NULL( budget );
+    TEST_ASSERT_TRUE( AiaSequencer_SetMemoryBudget( sequencer, budget ) );
+
+    /* Only one message fits in the budget. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_FALSE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+
+    /* In order messages are not charged, and emitting releases the charge. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "123", observer->messagesOutputted );
+
+    AiaMemoryBudgetMetrics_t budgetMetrics;
+    AiaMemoryBudget_GetMetrics( budget, &budgetMetrics );
+    TEST_ASSERT_EQUAL_UINT32( 0, budgetMetrics.usedBytes );
+    TEST_ASSERT_EQUAL_UINT32( 1, budgetMetrics.refusals );
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 1, metrics.messagesDropped );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaMemoryBudget_Destroy( budget );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+#endif
+
+#ifdef AIA_ENABLE_SPECULATIVE_DECRYPTION
+/** The messages offered to @c prepareCallback, concatenated. */
+static char g_messagesOffered[ 100 ];
+
+static void prepareCallback( void* message, size_t size,
+                             AiaSequenceNumber_t sequenceNumber,
+                             void* userData )
+{
+    TEST_ASSERT_NOT_NULL( message );
+    TEST_ASSERT_GREATER_THAN( 0, size );
+    TEST_ASSERT_EQUAL( strtoul( (char*)message, NULL, 10 ), sequenceNumber );
+    TEST_ASSERT_EQUAL_PTR( g_messagesOffered, userData );
+    strcat( g_messagesOffered, message );
+}
+
+/**
+ * Allocates a prepared form of a message.
+ *
+ * @param text The text of the prepared form.
+ * @return A copy of @c text allocated using @c AiaCalloc().
+ */
+static char* createPrepared( const char* text )
+{
+    char* prepared = AiaCalloc( strlen( text ) + 1, 1 );
+    TEST_ASSERT_NOT_NULL( prepared );
+    strcpy( prepared, text );
+    return prepared;
+}
+
+TEST( AiaSequencerTests, PreparedMessagesAreSequenced )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 3, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+    g_messagesOffered[ 0 ] = '\0';
+    TEST_ASSERT_FALSE(
+        AiaSequencer_SetPreparation( sequencer, prepareCallback, NULL, NULL ) );
+    TEST_ASSERT_TRUE( AiaSequencer_SetPreparation(
+        sequencer, prepareCallback, g_messagesOffered,
+        messageSequencedCallback ) );
+
+    /* Only messages which are buffered are offered. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "32", g_messagesOffered );
+
+    char* prepared = createPrepared( "c" );
+    TEST_ASSERT_TRUE( AiaSequencer_Prepare( sequencer, 3, prepared,
+                                            strlen( prepared ) + 1 ) );
+    prepared = createPrepared( "d" );
+    TEST_ASSERT_FALSE( AiaSequencer_Prepare( sequencer, 4, prepared,
+                                             strlen( prepared ) + 1 ) );
+
+    /* Prepared messages are passed to preparedSequencedCb in order. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "32", g_messagesOffered );
+    TEST_ASSERT_EQUAL_STRING( "12c", observer->messagesOutputted );
+
+    /* Messages which have been sequenced can no longer be prepared. */
+    TEST_ASSERT_FALSE( AiaSequencer_Prepare( sequencer, 3, prepared,
+                                             strlen( prepared ) + 1 ) );
+    TEST_ASSERT_FALSE( AiaSequencer_Prepare( sequencer, 4, prepared,
+                                             strlen( prepared ) + 1 ) );
+    AiaFree( prepared );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+#endif
+
+TEST( AiaSequencerTests, ReorderHistograms )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 4, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 4, metrics.slots );
+    TEST_ASSERT_EQUAL( 0, metrics.sequenceTimeoutMs );
+
+    /* Distance one, then distance three. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    /* Fills the gap opened by "2". */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    /* Fills the gap left behind "4". */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "1234", observer->messagesOutputted );
+
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 1, metrics.reorderDistances[ 0 ] );
+    TEST_ASSERT_EQUAL( 1, metrics.reorderDistances[ 1 ] );
+    uint32_t gapsFilled = 0;
+    for( size_t i = 0; i < AIA_SEQUENCER_HISTOGRAM_BUCKETS; ++i )
+    {
+        gapsFilled += metrics.gapFillTimes[ i ];
+    }
+    TEST_ASSERT_EQUAL( 2, gapsFilled );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, AutoTuningGrowsSlots )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 1, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    AiaSequencerAutoTuningConfig_t config;
+    config.minSlots = 1;
+    config.maxSlots = 4;
+    config.minTimeoutMs = 1000;
+    config.maxTimeoutMs = 2000;
+    TEST_ASSERT_TRUE( AiaSequencer_SetAutoTuning( sequencer, &config ) );
+
+    /* Beyond the current buffer but within the bounds. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    /* Beyond the bounds. */
+    TEST_ASSERT_FALSE( AiaSequencer_Write( sequencer, "9", sizeof( "9" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "1234", observer->messagesOutputted );
+
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 3, metrics.slots );
+    TEST_ASSERT_EQUAL( 1, metrics.messagesDropped );
+    /* Created without a timeout, which tuning leaves alone. */
+    TEST_ASSERT_EQUAL( 0, metrics.sequenceTimeoutMs );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, AutoTuningInvalidBounds )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 4, 1, 1000,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    AiaSequencerAutoTuningConfig_t config;
+    config.minSlots = 0;
+    config.maxSlots = 4;
+    config.minTimeoutMs = 1000;
+    config.maxTimeoutMs = 2000;
+    TEST_ASSERT_FALSE( AiaSequencer_SetAutoTuning( sequencer, &config ) );
+    config.minSlots = 5;
+    TEST_ASSERT_FALSE( AiaSequencer_SetAutoTuning( sequencer, &config ) );
+    config.minSlots = 1;
+    config.minTimeoutMs = 0;
+    TEST_ASSERT_FALSE( AiaSequencer_SetAutoTuning( sequencer, &config ) );
+
+    /* Valid bounds clamp the current configuration. */
+    config.maxSlots = 2;
+    config.minTimeoutMs = 1500;
+    TEST_ASSERT_TRUE( AiaSequencer_SetAutoTuning( sequencer, &config ) );
+    AiaSequencerMetrics_t metrics;
+    AiaSequencer_GetMetrics( sequencer, &metrics );
+    TEST_ASSERT_EQUAL( 2, metrics.slots );
+    TEST_ASSERT_EQUAL( 1500, metrics.sequenceTimeoutMs );
+    TEST_ASSERT_TRUE( AiaSequencer_SetAutoTuning( sequencer, NULL ) );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
 TEST( AiaSequencerTests, WriteManyInOrder )
 {
     AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
@@ -533,6 +978,118 @@ TEST( AiaSequencerTests, NoTimeout )
     AiaTestSequencerObserver_Destroy( observer );
 }
 
+TEST( AiaSequencerTests, ConsecutiveGapsWithinTimeout )
+{
+    AiaDurationMs_t timeout = 100;
+
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 1, 0, timeout,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    /* Open and fill a gap, then open another one before the first timer would
+    have expired. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "0", sizeof( "0" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "2", sizeof( "2" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "0123", observer->messagesOutputted );
+
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &observer->timedOutWaitingSemaphore, timeout * 1.2 ) );
+
+    /* A new gap still times out. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "5", sizeof( "5" ) ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &observer->timedOutWaitingSemaphore, timeout * 1.2 ) );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
+TEST( AiaSequencerTests, TimeoutsOfSequencersAreIndependent )
+{
+    AiaDurationMs_t timeout = 100;
+
+    AiaTestSequencerObserver_t* firstObserver =
+        AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( firstObserver );
+    AiaSequencer_t* firstSequencer = AiaSequencer_Create(
+        messageSequencedCallback, firstObserver, timedOutWaitingCallback,
+        firstObserver, getSequencerNumberCallback, firstObserver, 1, 0,
+        timeout, AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( firstSequencer );
+
+    AiaTestSequencerObserver_t* secondObserver =
+        AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( secondObserver );
+    AiaSequencer_t* secondSequencer = AiaSequencer_Create(
+        messageSequencedCallback, secondObserver, timedOutWaitingCallback,
+        secondObserver, getSequencerNumberCallback, secondObserver, 1, 0,
+        timeout, AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( secondSequencer );
+
+    /* Filling the second sequencer's gap must not cancel the first one's
+    timer. */
+    TEST_ASSERT_TRUE(
+        AiaSequencer_Write( firstSequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE(
+        AiaSequencer_Write( secondSequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE(
+        AiaSequencer_Write( secondSequencer, "0", sizeof( "0" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "01", secondObserver->messagesOutputted );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &firstObserver->timedOutWaitingSemaphore, timeout * 1.2 ) );
+    TEST_ASSERT_FALSE( AiaSemaphore( TryWait )(
+        &secondObserver->timedOutWaitingSemaphore ) );
+
+    AiaSequencer_Destroy( secondSequencer );
+    AiaTestSequencerObserver_Destroy( secondObserver );
+    AiaSequencer_Destroy( firstSequencer );
+    AiaTestSequencerObserver_Destroy( firstObserver );
+}
+
+TEST( AiaSequencerTests, SkipMissing )
+{
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, 5, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+
+    TEST_ASSERT_FALSE( AiaSequencer_SkipMissing( sequencer ) );
+
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "1", sizeof( "1" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "4", sizeof( "4" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "5", sizeof( "5" ) ) );
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "7", sizeof( "7" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "1", observer->messagesOutputted );
+
+    /* Skipping 2 and 3 emits up to the next missing message. */
+    TEST_ASSERT_TRUE( AiaSequencer_SkipMissing( sequencer ) );
+    TEST_ASSERT_EQUAL_STRING( "145", observer->messagesOutputted );
+
+    /* Skipped messages arriving late are dropped. */
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "3", sizeof( "3" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "145", observer->messagesOutputted );
+
+    TEST_ASSERT_TRUE( AiaSequencer_SkipMissing( sequencer ) );
+    TEST_ASSERT_EQUAL_STRING( "1457", observer->messagesOutputted );
+    TEST_ASSERT_FALSE( AiaSequencer_SkipMissing( sequencer ) );
+
+    TEST_ASSERT_TRUE( AiaSequencer_Write( sequencer, "8", sizeof( "8" ) ) );
+    TEST_ASSERT_EQUAL_STRING( "14578", observer->messagesOutputted );
+
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
+
 TEST( AiaSequencerTests, ResetNextExpectedSequenceNumberBasic )
 {
     AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
@@ -608,3 +1165,74 @@ TEST( AiaSequencerTests,
     AiaSequencer_Destroy( sequencer );
     AiaTestSequencerObserver_Destroy( observer );
 }
+
+/** @c AiaNetworkImpairmentDeliverCallback_t writing to the observed sequencer.
+ */
+static void deliverToSequencerCallback( const char* topic, size_t topicLength,
+                                        const void* message,
+                                        size_t messageLength, void* userData )
+{
+    (void)topic;
+    (void)topicLength;
+    AiaTestSequencerObserver_t* sequencerObserver =
+        (AiaTestSequencerObserver_t*)userData;
+    /* Duplicates of buffered messages may be refused, which is harmless. */
+    AiaSequencer_Write( sequencerObserver->sequencer, (void*)message,
+                        messageLength );
+}
+
+TEST( AiaSequencerTests, MessagesOverImpairedNetwork )
+{
+    static const AiaSequenceNumber_t NUM_MESSAGES = 50;
+    static const AiaDurationMs_t MESSAGE_INTERVAL_MS = 10;
+    AiaNetworkImpairmentProfile_t profile = {
+        5, 20, AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM, 0, 0, 100, 300, 30,
+        0
+    };
+
+    AiaTestSequencerObserver_t* observer = AiaTestSequencerObserver_Create();
+    TEST_ASSERT_NOT_NULL( observer );
+    AiaSequencer_t* sequencer = AiaSequencer_Create(
+        messageSequencedCallback, observer, timedOutWaitingCallback, observer,
+        getSequencerNumberCallback, observer, NUM_MESSAGES, 1, 0,
+        AiaTaskPool( GetSystemTaskPool )() );
+    TEST_ASSERT_NOT_NULL( sequencer );
+    observer->sequencer = sequencer;
+    AiaNetworkImpairment_t* impairment = AiaNetworkImpairment_Create(
+        &profile, 42, deliverToSequencerCallback, observer );
+    TEST_ASSERT_NOT_NULL( impairment );
+
+    /* The network is driven on simulated time, so the run is the same every
+     * time. */
+    char expectedOutput[ 10000 ] = { 0 };
+    AiaTimepointMs_t nowMs = 0;
+    for( AiaSequenceNumber_t sequenceNumber = 1;
+         sequenceNumber <= NUM_MESSAGES; ++sequenceNumber )
+    {
+        char message[ 50 ];
+        sprintf( message, "%" PRIu32, sequenceNumber );
+        TEST_ASSERT_TRUE( AiaNetworkImpairment_Submit(
+            impairment, nowMs, NULL, 0, message, strlen( message ) + 1 ) );
+        strcat( expectedOutput, message );
+        nowMs += MESSAGE_INTERVAL_MS;
+        AiaNetworkImpairment_Poll( impairment, nowMs );
+    }
+    while( AiaNetworkImpairment_GetNextDeliveryTime( impairment, &nowMs ) )
+    {
+        TEST_ASSERT_GREATER_THAN(
+            0, AiaNetworkImpairment_Poll( impairment, nowMs ) );
+    }
+
+    AiaNetworkImpairmentStats_t stats;
+    AiaNetworkImpairment_GetStats( impairment, &stats );
+    TEST_ASSERT_EQUAL( NUM_MESSAGES, stats.submitted );
+    TEST_ASSERT_EQUAL( 0, stats.dropped );
+    TEST_ASSERT_GREATER_THAN( 0, stats.reordered );
+    TEST_ASSERT_GREATER_THAN( 0, stats.duplicated );
+    TEST_ASSERT_EQUAL( NUM_MESSAGES + stats.duplicated, stats.delivered );
+    TEST_ASSERT_EQUAL_STRING( expectedOutput, observer->messagesOutputted );
+
+    AiaNetworkImpairment_Destroy( impairment );
+    AiaSequencer_Destroy( sequencer );
+    AiaTestSequencerObserver_Destroy( observer );
+}
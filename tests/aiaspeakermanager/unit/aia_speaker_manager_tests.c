@@ -31,6 +31,7 @@
 #include <aiacore/aia_mbedtls_threading.h>
 #include <aiacore/aia_random_mbedtls.h>
 #include <aiacore/aia_topic.h>
+#include <aiacore/aia_utils.h>
 #include <aiacore/aia_volume_constants.h>
 #include <aiaspeakermanager/aia_speaker_manager.h>
 #include <aiaspeakermanager/private/aia_speaker_manager.h>
@@ -66,6 +67,16 @@ static void AiaSpeakerManagerTestObserver_Destroy(
     AiaSpeakerManagerTestObserver_t* observer );
 static bool PlaySpeakerDataCallback( const void* buf, size_t size,
                                      void* userData );
+static bool ConcealSpeakerDataCallback( size_t frameSize, size_t frameCount,
+                                        const void* nextFrame,
+                                        void* userData );
+static void PrefetchSpeakerDataCallback( AiaBinaryAudioStreamOffset_t offset,
+                                         void* userData );
+static void FlushSpeakerDataCallback( void* userData );
+static bool SpillAppendCallback( const uint8_t* data, size_t size,
+                                 void* userData );
+static bool SpillConsumeCallback( uint8_t* data, size_t size, void* userData );
+static void SpillClearCallback( void* userData );
 static void SetVolumeCallback( uint8_t volume, void* userData );
 static bool PlayOfflineAlertCallback( const AiaAlertSlot_t* offlineAlert,
                                       void* userData );
@@ -140,6 +151,8 @@ TEST_GROUP_RUNNER( AiaSpeakerManagerTests )
     RUN_TEST_CASE( AiaSpeakerManagerTests, PlaybackStoppedWhenSpeakerNotOpen );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    SpeakerOpensAtFirstOffsetWhenOffsetReceived );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   SpeakerOpensImmediatelyWhenOffsetAlreadyBuffered );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    SpeakerDoesNotOpenAtFutureOffsetIfOffsetNotReceived );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
@@ -150,6 +163,8 @@ TEST_GROUP_RUNNER( AiaSpeakerManagerTests )
                    MarkersEchoedWhenOffsetsPlayedReachedBasic );
     RUN_TEST_CASE( AiaSpeakerManagerTests, BufferOverrunSentBasic );
     RUN_TEST_CASE( AiaSpeakerManagerTests, OverrunRepeated );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, FullBufferSpillsInsteadOfOverrun );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, OverrunKeepsAudioThatFits );
     RUN_TEST_CASE( AiaSpeakerManagerTests, UnderrunRepeated );
     RUN_TEST_CASE(
         AiaSpeakerManagerTests,
@@ -157,6 +172,12 @@ TEST_GROUP_RUNNER( AiaSpeakerManagerTests )
     RUN_TEST_CASE( AiaSpeakerManagerTests, NullPayloads );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    SpeakerDataStopsPushingWhenRejected );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   SetPlaySpeakerDataBatchCbWithInvalidMaxFrames );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   BatchedSpeakerFramesPushedInSingleInvocation );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   BatchedSpeakerFramesDoNotCrossActionOffset );
     RUN_TEST_CASE( AiaSpeakerManagerTests, PersistedVolumeIsInitialVolume );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    TestLocalAbsoluteVolumeChangeOutsideRange );
@@ -177,6 +198,7 @@ TEST_GROUP_RUNNER( AiaSpeakerManagerTests )
         AiaSpeakerManagerTests,
         TestLocalRelativeVolumeDecrementChangeWhenSpeakerNotOpenOutsideBounds );
     RUN_TEST_CASE( AiaSpeakerManagerTests, NoVolumeChangeResultsInNoEvent );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, LocalVolumeChangesCoalesce );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    SetVolumeWithoutOffsetResultsInImmediateChange );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
@@ -185,22 +207,52 @@ TEST_GROUP_RUNNER( AiaSpeakerManagerTests )
                    SetMultipleVolumesWithFutureOffsetResultsInEventualChange );
     RUN_TEST_CASE( AiaSpeakerManagerTests, InvokeSingleActionAtCurrentOffset );
     RUN_TEST_CASE( AiaSpeakerManagerTests, InvokeSingleActionAtFutureOffset );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   ActionDelayedUntilPlayoutLatencyElapses );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    CanceledActionDoesNotResultInCallback );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    InvokeMultipleActionsAtFutureOffset );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    LocalStoppageResultsInActionInvalidation );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   ActionsInvalidatedInOffsetOrder );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, StopPlaybackFlushesSpeakerPipeline );
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+    RUN_TEST_CASE( AiaSpeakerManagerTests, ElasticBufferGrowsAndShrinks );
+#endif
+    RUN_TEST_CASE( AiaSpeakerManagerTests, TrimMemoryWhileSpeakerClosed );
+#if defined( AIA_ENABLE_MEMORY_PREFAULT ) && \
+    !defined( AIA_SPEAKER_FIXED_FRAME_SIZE )
+    RUN_TEST_CASE( AiaSpeakerManagerTests, PrefaultedBuffersFollowTrimMemory );
+#endif
     RUN_TEST_CASE( AiaSpeakerManagerTests, MalformedSpeakerMessage );
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    RUN_TEST_CASE( AiaSpeakerManagerTests, OtherFrameSizeRejected );
+#endif
+    RUN_TEST_CASE( AiaSpeakerManagerTests, GapRejectedWithoutConcealment );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, GapConcealedWhenEnabled );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   ConsecutiveContentEntriesAreWritten );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   EncryptedContentIsDecryptedIntoBuffer );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   UnderrunWarningClearedPastHysteresisMargin );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    BufferStateEventsNotSentWhenSpeakerClosed );
     RUN_TEST_CASE( AiaSpeakerManagerTests,
                    OlderSpeakerDataOverwrittenWhenSpeakerClosed );
     RUN_TEST_CASE( AiaSpeakerManagerTests, GetCurrentOffset );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   AdaptiveJitterBufferHoldsPlaybackUntilPrefilled );
+    RUN_TEST_CASE( AiaSpeakerManagerTests,
+                   AdaptiveJitterBufferStartsPlaybackAfterPrefillTimeout );
 #ifdef AIA_ENABLE_ALERTS
     RUN_TEST_CASE( AiaSpeakerManagerTests, OfflineAlertPlayback );
 #endif
     RUN_TEST_CASE( AiaSpeakerManagerTests, CanSpeakerStream );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, AddedSinkReceivesSameFrames );
+    RUN_TEST_CASE( AiaSpeakerManagerTests, RejectingSinkHoldsBackFrames );
 }
 
 static const size_t DATA_OVERHEAD_SIZE =
@@ -209,6 +261,15 @@ static const size_t DATA_OVERHEAD_SIZE =
 
 static const uint8_t TEST_FRAME_1[] = { 0, 0, 0, 0 };
 
+/** @return How long the speaker manager takes @c TEST_FRAME_1 to play for. */
+static uint32_t TestFrame1DurationMs()
+{
+    uint32_t durationMs =
+        (uint32_t)( sizeof( TEST_FRAME_1 ) * 8 * AIA_MS_PER_SECOND /
+                    (size_t)AIA_SPEAKER_AUDIO_DECODER_BITS_PER_SECOND );
+    return durationMs ? durationMs : 1;
+}
+
 /** Callers must clean up non NULL returned values using AiaFree(). */
 const char* generateOpenSpeaker( AiaBinaryAudioStreamOffset_t offset )
 {
@@ -394,10 +455,35 @@ struct AiaSpeakerManagerTestObserver
 {
     void* speakerDataReceived[ 1000 ];
     size_t speakerDataReceivedSize;
+    /** Number of frames received in the last batched push. */
+    size_t lastFrameCountPushed;
     /* TODO: Replace with mechanism that allows for running unit tests in
      * non-threaded environments. */
     AiaSemaphore_t numSpeakerFramesPushedSemaphore;
 
+    /** Number of frames synthesized in @c ConcealSpeakerDataCallback(). */
+    size_t framesConcealed;
+    /** Copy of the last next frame received in @c
+     * ConcealSpeakerDataCallback(). */
+    uint8_t lastNextFrame[ 4 ];
+
+    /** Number of calls to @c PrefetchSpeakerDataCallback(). */
+    size_t numPrefetches;
+    /** Last offset received in @c PrefetchSpeakerDataCallback(). */
+    AiaBinaryAudioStreamOffset_t lastPrefetchOffset;
+
+    /** Number of calls to @c FlushSpeakerDataCallback(). */
+    size_t numFlushes;
+
+    /** Backing memory of the spill store. */
+    uint8_t spill[ 2048 ];
+    /** Offset of the first unconsumed byte in @c spill. */
+    size_t spillHead;
+    /** Offset one past the last appended byte in @c spill. */
+    size_t spillTail;
+    /** Number of calls to @c SpillAppendCallback(). */
+    size_t numSpills;
+
     /** Last volume received in callback. */
     uint8_t volume;
     /* TODO: Replace with mechanism that allows for running unit tests in
@@ -499,6 +585,85 @@ static bool PlaySpeakerDataCallback( const void* buf, size_t size,
     return true;
 }
 
+/** Byte pushed in place of each concealed byte of speaker data. */
+static const uint8_t CONCEALED_BYTE = 0xFF;
+
+static bool ConcealSpeakerDataCallback( size_t frameSize, size_t frameCount,
+                                        const void* nextFrame, void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    memset( observer->speakerDataReceived + observer->speakerDataReceivedSize,
+            CONCEALED_BYTE, frameSize * frameCount );
+    observer->speakerDataReceivedSize += frameSize * frameCount;
+    observer->framesConcealed += frameCount;
+    if( nextFrame )
+    {
+        TEST_ASSERT_EQUAL( sizeof( observer->lastNextFrame ), frameSize );
+        memcpy( observer->lastNextFrame, nextFrame, frameSize );
+    }
+    AiaSemaphore( Post )( &observer->numSpeakerFramesPushedSemaphore );
+    return true;
+}
+
+static void PrefetchSpeakerDataCallback( AiaBinaryAudioStreamOffset_t offset,
+                                         void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    ++observer->numPrefetches;
+    observer->lastPrefetchOffset = offset;
+}
+
+static void FlushSpeakerDataCallback( void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    ++observer->numFlushes;
+}
+
+static bool SpillAppendCallback( const uint8_t* data, size_t size,
+                                 void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    if( observer->spillTail + size > sizeof( observer->spill ) )
+    {
+        return false;
+    }
+    memcpy( observer->spill + observer->spillTail, data, size );
+    observer->spillTail += size;
+    ++observer->numSpills;
+    return true;
+}
+
+static bool SpillConsumeCallback( uint8_t* data, size_t size, void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    if( observer->spillHead + size > observer->spillTail )
+    {
+        return false;
+    }
+    memcpy( data, observer->spill + observer->spillHead, size );
+    observer->spillHead += size;
+    return true;
+}
+
+static void SpillClearCallback( void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    observer->spillHead = 0;
+    observer->spillTail = 0;
+}
+
 static void SetVolumeCallback( uint8_t volume, void* userData )
 {
     TEST_ASSERT_TRUE( userData );
@@ -541,6 +706,21 @@ uint8_t AiaLoadVolume()
     return TEST_PERSISTED_VOLUME;
 }
 
+#ifdef AIA_STORE_VOLUME
+/** Last volume passed to @c AiaStoreVolume(). */
+static uint8_t g_storedVolume;
+
+/** Number of calls to @c AiaStoreVolume(). */
+static size_t g_numVolumeStores;
+
+bool AiaStoreVolume( uint8_t volume )
+{
+    g_storedVolume = volume;
+    ++g_numVolumeStores;
+    return true;
+}
+#endif
+
 TEST( AiaSpeakerManagerTests, Create )
 {
     AiaSpeakerManager_t* speakerManager = AiaSpeakerManager_Create(
@@ -670,6 +850,40 @@ TEST( AiaSpeakerManagerTests, SpeakerOpensAtFirstOffsetWhenOffsetReceived )
     AiaFree( (void*)openSpeakerPayload );
 }
 
+TEST( AiaSpeakerManagerTests, SpeakerOpensImmediatelyWhenOffsetAlreadyBuffered )
+{
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    AiaSpeakerManager_SetPrefetchSpeakerDataCb(
+        g_speakerManager, PrefetchSpeakerDataCallback, g_observer );
+
+    /* Buffer the audio before the directive arrives. */
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+    TEST_ASSERT_EQUAL( 1, g_observer->numPrefetches );
+    TEST_ASSERT_EQUAL( TEST_OPEN_SPEAKER_OFFSET,
+                       g_observer->lastPrefetchOffset );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME_1 ),
+                       g_observer->speakerDataReceivedSize );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_FRAME_1, g_observer->speakerDataReceived,
+                              sizeof( TEST_FRAME_1 ) );
+
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
 TEST( AiaSpeakerManagerTests,
       SpeakerDoesNotOpenAtFutureOffsetIfOffsetNotReceived )
 {
@@ -1137,6 +1351,145 @@ TEST( AiaSpeakerManagerTests, BufferOverrunSentBasic )
     }
 }
 
+TEST( AiaSpeakerManagerTests, FullBufferSpillsInsteadOfOverrun )
+{
+    static const size_t FRAME_SIZE = 100;
+    static const size_t NUM_MESSAGES = 8;
+    AiaSpeakerSpillStore_t store;
+    store.append = SpillAppendCallback;
+    store.consume = SpillConsumeCallback;
+    store.clear = SpillClearCallback;
+    store.userData = g_observer;
+    store.capacity = sizeof( g_observer->spill );
+    TEST_ASSERT_TRUE( AiaSpeakerManager_SetSpillStore( g_speakerManager,
+                                                       &store ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+    AiaFree( (void*)openSpeakerPayload );
+
+    /* Once the speaker is open, send more audio than fits in the speaker
+     * buffer in one go. */
+    uint8_t frame[ FRAME_SIZE ];
+    for( size_t i = 0; i < NUM_MESSAGES; ++i )
+    {
+        if( i == 1 )
+        {
+            TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+                &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+        }
+        memset( frame, (int)i, sizeof( frame ) );
+        size_t binaryMessageLength = 0;
+        const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+            frame, sizeof( frame ), 0,
+            TEST_OPEN_SPEAKER_OFFSET + i * sizeof( frame ),
+            &binaryMessageLength );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+            g_speakerManager, binaryMessage, binaryMessageLength, i );
+        AiaFree( (void*)binaryMessage );
+    }
+    TEST_ASSERT_TRUE( g_observer->numSpills > 0 );
+
+    /* Every frame is played in order without the service redriving. */
+    for( size_t i = 1; i < NUM_MESSAGES; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    }
+    TEST_ASSERT_EQUAL( NUM_MESSAGES * FRAME_SIZE,
+                       g_observer->speakerDataReceivedSize );
+    for( size_t i = 0; i < NUM_MESSAGES; ++i )
+    {
+        memset( frame, (int)i, sizeof( frame ) );
+        TEST_ASSERT_EQUAL_MEMORY(
+            frame,
+            (const uint8_t*)( g_observer->speakerDataReceived +
+                              i * FRAME_SIZE ),
+            sizeof( frame ) );
+    }
+    TEST_ASSERT_FALSE( AiaSemaphore( TryWait )(
+        &g_mockSequencer->resetSequenceNumberSemaphore ) );
+    TEST_ASSERT_EQUAL( g_observer->spillHead, g_observer->spillTail );
+}
+
+TEST( AiaSpeakerManagerTests, OverrunKeepsAudioThatFits )
+{
+    static const size_t FRAME_SIZE = 100;
+    static const size_t NUM_FRAMES = 8;
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_SetPartialOverrunAccept( g_speakerManager, true ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+    AiaFree( (void*)openSpeakerPayload );
+
+    uint8_t frame[ FRAME_SIZE ];
+    memset( frame, 0, sizeof( frame ) );
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        frame, sizeof( frame ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+    AiaFree( (void*)binaryMessage );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+
+    /* Send a message with more frames than fit in the speaker buffer. */
+    uint8_t frames[ NUM_FRAMES * FRAME_SIZE ];
+    for( size_t i = 0; i < NUM_FRAMES; ++i )
+    {
+        memset( frames + i * FRAME_SIZE, (int)i + 1, FRAME_SIZE );
+    }
+    binaryMessage = generateBinaryAudioMessageEntry(
+        frames, sizeof( frames ), NUM_FRAMES - 1,
+        TEST_OPEN_SPEAKER_OFFSET + FRAME_SIZE, &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 1 );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_mockSequencer->resetSequenceNumberSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( 1, g_mockSequencer->currentSequenceNumber );
+
+    /* The frames which fit play while the service redrives the message. */
+    size_t framesKept = TEST_BUFFER_SIZE / FRAME_SIZE;
+    for( size_t i = 0; i < NUM_FRAMES - framesKept; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    }
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 1 );
+    AiaFree( (void*)binaryMessage );
+    for( size_t i = NUM_FRAMES - framesKept; i < NUM_FRAMES; ++i )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    }
+
+    /* Every frame is played once and in order. */
+    TEST_ASSERT_EQUAL( ( NUM_FRAMES + 1 ) * FRAME_SIZE,
+                       g_observer->speakerDataReceivedSize );
+    for( size_t i = 0; i <= NUM_FRAMES; ++i )
+    {
+        memset( frame, (int)i, sizeof( frame ) );
+        TEST_ASSERT_EQUAL_MEMORY(
+            frame,
+            (const uint8_t*)( g_observer->speakerDataReceived +
+                              i * FRAME_SIZE ),
+            sizeof( frame ) );
+    }
+    TEST_ASSERT_FALSE( AiaSemaphore( TryWait )(
+        &g_mockSequencer->resetSequenceNumberSemaphore ) );
+}
+
 TEST( AiaSpeakerManagerTests, OverrunRepeated )
 {
     static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
@@ -1765,6 +2118,127 @@ TEST( AiaSpeakerManagerTests, SpeakerDataStopsPushingWhenRejected )
     AiaSpeakerManager_Destroy( speakerManager );
 }
 
+static bool PlaySpeakerDataBatchCallback( const void* buf, size_t size,
+                                          size_t frameCount, void* userData )
+{
+    TEST_ASSERT_TRUE( userData );
+    AiaSpeakerManagerTestObserver_t* observer =
+        (AiaSpeakerManagerTestObserver_t*)userData;
+    TEST_ASSERT_EQUAL( size, frameCount * sizeof( TEST_FRAME_1 ) );
+    observer->lastFrameCountPushed = frameCount;
+    return PlaySpeakerDataCallback( buf, size, userData );
+}
+
+TEST( AiaSpeakerManagerTests, SetPlaySpeakerDataBatchCbWithInvalidMaxFrames )
+{
+    TEST_ASSERT_FALSE( AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+        g_speakerManager, PlaySpeakerDataBatchCallback, g_observer, 0, 0 ) );
+    TEST_ASSERT_TRUE( AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+        g_speakerManager, NULL, NULL, 0, 0 ) );
+}
+
+TEST( AiaSpeakerManagerTests, BatchedSpeakerFramesPushedInSingleInvocation )
+{
+    static const size_t TEST_NUM_FRAMES = 4;
+    TEST_ASSERT_TRUE( AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+        g_speakerManager, PlaySpeakerDataBatchCallback, g_observer,
+        TEST_NUM_FRAMES, 0 ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    uint8_t audio[ sizeof( TEST_FRAME_1 ) * TEST_NUM_FRAMES ];
+    memset( audio, 0, sizeof( audio ) );
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        audio, sizeof( audio ), TEST_NUM_FRAMES - 1, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( TEST_NUM_FRAMES, g_observer->lastFrameCountPushed );
+    TEST_ASSERT_EQUAL( sizeof( audio ), g_observer->speakerDataReceivedSize );
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+    AiaListDouble( Link_t )* link =
+        AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
+    TEST_ASSERT_TRUE( link );
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( jsonMessage ),
+                               AIA_EVENTS_SPEAKER_OPENED ),
+                       0 );
+    const char* payload = AiaJsonMessage_GetJsonPayload( jsonMessage );
+    const char* offset;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        payload, strlen( payload ), AIA_SPEAKER_OPENED_OFFSET_KEY,
+        strlen( AIA_SPEAKER_OPENED_OFFSET_KEY ), &offset, NULL ) );
+    TEST_ASSERT_EQUAL( atoi( offset ), TEST_OPEN_SPEAKER_OFFSET );
+
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+TEST( AiaSpeakerManagerTests, BatchedSpeakerFramesDoNotCrossActionOffset )
+{
+    static const size_t TEST_NUM_FRAMES = 4;
+    static const size_t TEST_NUM_FRAMES_BEFORE_ACTION = 2;
+    TEST_ASSERT_TRUE( AiaSpeakerManager_SetPlaySpeakerDataBatchCb(
+        g_speakerManager, PlaySpeakerDataBatchCallback, g_observer,
+        TEST_NUM_FRAMES, 0 ) );
+
+    AiaTestActionObserver_t* actionObserver = AiaTestActionObserver_Create();
+    TEST_ASSERT_NOT_NULL( actionObserver );
+    TEST_ASSERT_NOT_EQUAL(
+        AIA_INVALID_ACTION_ID,
+        AiaSpeakerManager_InvokeActionAtOffset(
+            g_speakerManager,
+            sizeof( TEST_FRAME_1 ) * TEST_NUM_FRAMES_BEFORE_ACTION,
+            TestInvokeAction, actionObserver ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    uint8_t audio[ sizeof( TEST_FRAME_1 ) * TEST_NUM_FRAMES ];
+    memset( audio, 0, sizeof( audio ) );
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        audio, sizeof( audio ), TEST_NUM_FRAMES - 1, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( TEST_NUM_FRAMES_BEFORE_ACTION,
+                       g_observer->lastFrameCountPushed );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &actionObserver->actionInvokedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( TEST_NUM_FRAMES - TEST_NUM_FRAMES_BEFORE_ACTION,
+                       g_observer->lastFrameCountPushed );
+    TEST_ASSERT_EQUAL( sizeof( audio ), g_observer->speakerDataReceivedSize );
+
+    AiaTestActionObserver_Destroy( actionObserver );
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
 TEST( AiaSpeakerManagerTests, PersistedVolumeIsInitialVolume )
 {
     TEST_ASSERT_TRUE(
@@ -2083,35 +2557,94 @@ TEST( AiaSpeakerManagerTests, NoVolumeChangeResultsInNoEvent )
         AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
 }
 
-TEST( AiaSpeakerManagerTests, SetVolumeWithoutOffsetResultsInImmediateChange )
+TEST( AiaSpeakerManagerTests, LocalVolumeChangesCoalesce )
 {
     TEST_ASSERT_TRUE(
         AiaSemaphore( TimedWait )( &g_observer->volumeSemaphore, 100 ) );
     TEST_ASSERT_EQUAL( g_observer->volume, TEST_PERSISTED_VOLUME );
+#ifdef AIA_STORE_VOLUME
+    g_numVolumeStores = 0;
+#endif
 
-    uint8_t TEST_VOLUME = 75;
-
-    char* setVolumeDirective = generateSetVolumeWithoutOffset( TEST_VOLUME );
-    TEST_ASSERT_NOT_NULL( setVolumeDirective );
-    AiaSpeakerManager_OnSetVolumeDirectiveReceived(
-        g_speakerManager, (void*)setVolumeDirective,
-        strlen( setVolumeDirective ), 0, 0 );
-    AiaFree( setVolumeDirective );
+    AiaSpeakerVolumeCoalescingConfig_t config;
+    config.settleMs = 50;
+    config.storeDelayMs = 100;
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_SetVolumeCoalescing( g_speakerManager, &config ) );
 
+    /* Every change is applied to the speaker immediately. */
+    static const uint8_t TEST_VOLUMES[] = { 10, 20, 30 };
+    for( size_t i = 0; i < sizeof( TEST_VOLUMES ); ++i )
+    {
+        TEST_ASSERT_TRUE( AiaSpeakerManager_ChangeVolume( g_speakerManager,
+                                                          TEST_VOLUMES[ i ] ) );
+        TEST_ASSERT_TRUE(
+            AiaSemaphore( TimedWait )( &g_observer->volumeSemaphore, 100 ) );
+        TEST_ASSERT_EQUAL( TEST_VOLUMES[ i ], g_observer->volume );
+    }
+    TEST_ASSERT_TRUE( AiaSpeakerManager_AdjustVolume( g_speakerManager, 5 ) );
     TEST_ASSERT_TRUE(
         AiaSemaphore( TimedWait )( &g_observer->volumeSemaphore, 100 ) );
-    TEST_ASSERT_EQUAL( g_observer->volume, TEST_VOLUME );
+    TEST_ASSERT_EQUAL( 35, g_observer->volume );
 
+    /* Only the settled volume is reported. */
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TryWait )( &g_mockRegulator->writeSemaphore ) );
     TEST_ASSERT_TRUE(
-        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 200 ) );
     AiaListDouble( Link_t )* link = NULL;
     link = AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
     AiaListDouble( RemoveHead )( &g_mockRegulator->writtenMessages );
     TEST_ASSERT_TRUE( link );
     AiaJsonMessage_t* jsonMessage = AiaJsonMessage_FromMessage(
         ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
-    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( jsonMessage ),
-                               AIA_EVENTS_VOLUME_CHANGED ),
+    TEST_ASSERT_EQUAL_STRING( AIA_EVENTS_VOLUME_CHANGED,
+                              AiaJsonMessage_GetName( jsonMessage ) );
+    const char* payload = AiaJsonMessage_GetJsonPayload( jsonMessage );
+    const char* volume;
+    TEST_ASSERT_TRUE( AiaFindJsonValue(
+        payload, strlen( payload ), AIA_VOLUME_CHANGED_VOLUME_KEY,
+        strlen( AIA_VOLUME_CHANGED_VOLUME_KEY ), &volume, NULL ) );
+    TEST_ASSERT_EQUAL( 35, atoi( volume ) );
+
+    /* The settled volume is persisted once. */
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 200 ) );
+#ifdef AIA_STORE_VOLUME
+    TEST_ASSERT_EQUAL( 1, g_numVolumeStores );
+    TEST_ASSERT_EQUAL( 35, g_storedVolume );
+#endif
+}
+
+TEST( AiaSpeakerManagerTests, SetVolumeWithoutOffsetResultsInImmediateChange )
+{
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_observer->volumeSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( g_observer->volume, TEST_PERSISTED_VOLUME );
+
+    uint8_t TEST_VOLUME = 75;
+
+    char* setVolumeDirective = generateSetVolumeWithoutOffset( TEST_VOLUME );
+    TEST_ASSERT_NOT_NULL( setVolumeDirective );
+    AiaSpeakerManager_OnSetVolumeDirectiveReceived(
+        g_speakerManager, (void*)setVolumeDirective,
+        strlen( setVolumeDirective ), 0, 0 );
+    AiaFree( setVolumeDirective );
+
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_observer->volumeSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( g_observer->volume, TEST_VOLUME );
+
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+    AiaListDouble( Link_t )* link = NULL;
+    link = AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
+    AiaListDouble( RemoveHead )( &g_mockRegulator->writtenMessages );
+    TEST_ASSERT_TRUE( link );
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( jsonMessage ),
+                               AIA_EVENTS_VOLUME_CHANGED ),
                        0 );
     const char* payload = AiaJsonMessage_GetJsonPayload( jsonMessage );
 
@@ -2438,6 +2971,47 @@ TEST( AiaSpeakerManagerTests, InvokeSingleActionAtFutureOffset )
         &actionObserver->actionInvokedSemaphore, 100 ) );
 }
 
+TEST( AiaSpeakerManagerTests, ActionDelayedUntilPlayoutLatencyElapses )
+{
+    static const AiaDurationMs_t TEST_PLAYOUT_LATENCY_MS = 500;
+    AiaSpeakerManager_SetPlayoutLatency( g_speakerManager,
+                                         TEST_PLAYOUT_LATENCY_MS );
+    AiaTestActionObserver_t* actionObserver = AiaTestActionObserver_Create();
+    TEST_ASSERT_NOT_NULL( actionObserver );
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_ACTION_ID,
+                           AiaSpeakerManager_InvokeActionAtOffset(
+                               g_speakerManager, sizeof( TEST_FRAME_1 ),
+                               TestInvokeAction, actionObserver ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+
+    /* The frame has been pushed but not yet heard. */
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &actionObserver->actionInvokedSemaphore, 200 ) );
+
+    /* Action gets invoked once the latency has elapsed. */
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &actionObserver->actionInvokedSemaphore, 500 ) );
+
+    AiaTestActionObserver_Destroy( actionObserver );
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
 TEST( AiaSpeakerManagerTests, CanceledActionDoesNotResultInCallback )
 {
     AiaTestActionObserver_t* actionObserver = AiaTestActionObserver_Create();
@@ -2646,6 +3220,561 @@ TEST( AiaSpeakerManagerTests, LocalStoppageResultsInActionInvalidation )
         &actionObserver->actionInvokedSemaphore, 100 ) );
 }
 
+/** The number of actions scheduled by @c ActionsInvalidatedInOffsetOrder. */
+#define TEST_NUM_ORDERED_ACTIONS 20
+
+/** Indices of the actions invalidated, in order of invalidation. */
+static size_t g_invalidatedActions[ TEST_NUM_ORDERED_ACTIONS ];
+
+/** The number of entries in @c g_invalidatedActions. */
+static size_t g_numInvalidatedActions;
+
+static void TestRecordInvalidatedAction( bool actionValid, void* userData )
+{
+    TEST_ASSERT_FALSE( actionValid );
+    TEST_ASSERT_TRUE( g_numInvalidatedActions < TEST_NUM_ORDERED_ACTIONS );
+    g_invalidatedActions[ g_numInvalidatedActions++ ] = *(size_t*)userData;
+}
+
+TEST( AiaSpeakerManagerTests, ActionsInvalidatedInOffsetOrder )
+{
+    static size_t indices[ TEST_NUM_ORDERED_ACTIONS ];
+    AiaSpeakerActionHandle_t handles[ TEST_NUM_ORDERED_ACTIONS ];
+    g_numInvalidatedActions = 0;
+
+    /* Schedule in descending offset order, with pairs sharing an offset. */
+    for( size_t i = 0; i < TEST_NUM_ORDERED_ACTIONS; ++i )
+    {
+        indices[ i ] = i;
+        handles[ i ] = AiaSpeakerManager_InvokeActionAtOffset(
+            g_speakerManager,
+            ( TEST_NUM_ORDERED_ACTIONS - i / 2 ) * sizeof( TEST_FRAME_1 ),
+            TestRecordInvalidatedAction, &indices[ i ] );
+        TEST_ASSERT_NOT_EQUAL( AIA_INVALID_ACTION_ID, handles[ i ] );
+    }
+    for( size_t i = 0; i < TEST_NUM_ORDERED_ACTIONS; i += 4 )
+    {
+        AiaSpeakerManager_CancelAction( g_speakerManager, handles[ i ] );
+    }
+
+    AiaSpeakerManager_StopPlayback( g_speakerManager );
+
+    /* Later pairs have earlier offsets, and actions sharing an offset are
+     * invalidated in the order they were scheduled. */
+    size_t expected = 0;
+    for( size_t pair = TEST_NUM_ORDERED_ACTIONS / 2; pair-- > 0; )
+    {
+        for( size_t i = 2 * pair; i < 2 * pair + 2; ++i )
+        {
+            if( i % 4 )
+            {
+                TEST_ASSERT_TRUE( expected < g_numInvalidatedActions );
+                TEST_ASSERT_EQUAL( i, g_invalidatedActions[ expected ] );
+                ++expected;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL( expected, g_numInvalidatedActions );
+
+    /* Handles of actions which are no longer scheduled are ignored, even once
+     * their slots have been reused. */
+    AiaTestActionObserver_t* actionObserver = AiaTestActionObserver_Create();
+    TEST_ASSERT_NOT_NULL( actionObserver );
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_ACTION_ID,
+                           AiaSpeakerManager_InvokeActionAtOffset(
+                               g_speakerManager, 0, TestInvokeAction,
+                               actionObserver ) );
+    for( size_t i = 0; i < TEST_NUM_ORDERED_ACTIONS; ++i )
+    {
+        AiaSpeakerManager_CancelAction( g_speakerManager, handles[ i ] );
+    }
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &actionObserver->actionInvokedSemaphore, 100 ) );
+    AiaTestActionObserver_Destroy( actionObserver );
+}
+
+/** Schedules another action, passed as @c userData, when invalidated. */
+static void TestRescheduleInvalidatedAction( bool actionValid, void* userData )
+{
+    TEST_ASSERT_FALSE( actionValid );
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_ACTION_ID,
+                           AiaSpeakerManager_InvokeActionAtOffset(
+                               g_speakerManager, sizeof( TEST_FRAME_1 ),
+                               TestRecordInvalidatedAction, userData ) );
+}
+
+TEST( AiaSpeakerManagerTests, StopPlaybackFlushesSpeakerPipeline )
+{
+    static size_t index = 0;
+    g_numInvalidatedActions = 0;
+    AiaSpeakerManager_SetFlushSpeakerDataCb(
+        g_speakerManager, FlushSpeakerDataCallback, g_observer );
+
+    /* Buffer audio which is never played. */
+    for( size_t i = 0; i < 2; ++i )
+    {
+        size_t binaryMessageLength = 0;
+        const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+            TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0,
+            i * sizeof( TEST_FRAME_1 ), &binaryMessageLength );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+            g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+        AiaFree( (void*)binaryMessage );
+    }
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_ACTION_ID,
+                           AiaSpeakerManager_InvokeActionAtOffset(
+                               g_speakerManager, sizeof( TEST_FRAME_1 ),
+                               TestRescheduleInvalidatedAction, &index ) );
+    TEST_ASSERT_EQUAL( 0,
+                       AiaSpeakerManager_GetCurrentOffset( g_speakerManager ) );
+
+    /* Buffered audio is skipped and the platform is asked to drop its own. */
+    AiaSpeakerManager_StopPlayback( g_speakerManager );
+    TEST_ASSERT_EQUAL( 2 * sizeof( TEST_FRAME_1 ),
+                       AiaSpeakerManager_GetCurrentOffset( g_speakerManager ) );
+    TEST_ASSERT_EQUAL( 1, g_observer->numFlushes );
+
+    /* Actions scheduled while others are invalidated are kept. */
+    TEST_ASSERT_EQUAL( 0, g_numInvalidatedActions );
+    AiaSpeakerManager_StopPlayback( g_speakerManager );
+    TEST_ASSERT_EQUAL( 1, g_numInvalidatedActions );
+    TEST_ASSERT_EQUAL( index, g_invalidatedActions[ 0 ] );
+    TEST_ASSERT_EQUAL( 2, g_observer->numFlushes );
+}
+
+#ifdef AIA_ENABLE_ELASTIC_SPEAKER_BUFFER
+TEST( AiaSpeakerManagerTests, ElasticBufferGrowsAndShrinks )
+{
+    static const size_t BUFFER_SIZE = 4 * AIA_SPEAKER_BUFFER_SEGMENT_SIZE;
+    static const size_t FRAME_SIZE = 1024;
+    static const size_t NUM_MESSAGES = 10;
+    AiaSpeakerManager_t* speakerManager = AiaSpeakerManager_Create(
+        BUFFER_SIZE, 8 * BUFFER_SIZE / 10, 2 * BUFFER_SIZE / 10,
+        PlaySpeakerDataCallback, g_observer, g_sequencer, g_regulator,
+        SetVolumeCallback, g_observer, PlayOfflineAlertCallback, g_observer,
+        StopOfflineAlertCallback, g_observer, NotifyObservers, g_observer );
+    TEST_ASSERT_NOT_NULL( speakerManager );
+
+    /* The buffer starts with a single segment. */
+    AiaSpeakerManagerMetrics_t metrics;
+    AiaSpeakerManager_GetMetrics( speakerManager, &metrics );
+    TEST_ASSERT_EQUAL( AIA_SPEAKER_BUFFER_SEGMENT_SIZE, metrics.bufferSize );
+
+    /* It grows by whole segments as audio is buffered. */
+    uint8_t frame[ FRAME_SIZE ];
+    memset( frame, 0, sizeof( frame ) );
+    for( size_t i = 0; i < NUM_MESSAGES; ++i )
+    {
+        size_t binaryMessageLength = 0;
+        const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+            frame, sizeof( frame ), 0, i * sizeof( frame ),
+            &binaryMessageLength );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+            speakerManager, binaryMessage, binaryMessageLength, i );
+        AiaFree( (void*)binaryMessage );
+    }
+    AiaSpeakerManager_GetMetrics( speakerManager, &metrics );
+    TEST_ASSERT_EQUAL( NUM_MESSAGES * FRAME_SIZE, metrics.bufferedBytes );
+    TEST_ASSERT_EQUAL( 3 * AIA_SPEAKER_BUFFER_SEGMENT_SIZE,
+                       metrics.bufferSize );
+    TEST_ASSERT_EQUAL( 0,
+                       AiaSpeakerManager_GetCurrentOffset( speakerManager ) );
+
+    /* Segments are kept for a while after the buffer drains, in case the
+     * speaker is opened again, ... */
+    AiaSpeakerManager_StopPlayback( speakerManager );
+    AiaSpeakerManager_GetMetrics( speakerManager, &metrics );
+    TEST_ASSERT_EQUAL( 0, metrics.bufferedBytes );
+    TEST_ASSERT_EQUAL( 3 * AIA_SPEAKER_BUFFER_SEGMENT_SIZE,
+                       metrics.bufferSize );
+
+    /* ... and trimming returns them right away. */
+    TEST_ASSERT_GREATER_OR_EQUAL(
+        2 * AIA_SPEAKER_BUFFER_SEGMENT_SIZE,
+        AiaSpeakerManager_TrimMemory( speakerManager ) );
+    AiaSpeakerManager_GetMetrics( speakerManager, &metrics );
+    TEST_ASSERT_EQUAL( AIA_SPEAKER_BUFFER_SEGMENT_SIZE, metrics.bufferSize );
+    TEST_ASSERT_EQUAL( NUM_MESSAGES * FRAME_SIZE,
+                       AiaSpeakerManager_GetCurrentOffset( speakerManager ) );
+
+    AiaSpeakerManager_Destroy( speakerManager );
+}
+#endif
+
+TEST( AiaSpeakerManagerTests, TrimMemoryWhileSpeakerClosed )
+{
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    TEST_ASSERT_EQUAL( 0, AiaSpeakerManager_TrimMemory( NULL ) );
+
+    /* Frames are staged once the first one sets the frame size. */
+    TEST_ASSERT_EQUAL( 0, AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+    /* Single frames are staged in storage that is never released. */
+    TEST_ASSERT_EQUAL( 0, AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+#else
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME_1 ),
+                       AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+#endif
+    TEST_ASSERT_EQUAL( 0, AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+
+    /* The staging buffer is allocated again when the speaker opens. */
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME_1 ),
+                       g_observer->speakerDataReceivedSize );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_FRAME_1, g_observer->speakerDataReceived,
+                              sizeof( TEST_FRAME_1 ) );
+    TEST_ASSERT_EQUAL( 0, AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+#if defined( AIA_ENABLE_MEMORY_PREFAULT ) && \
+    !defined( AIA_SPEAKER_FIXED_FRAME_SIZE )
+TEST( AiaSpeakerManagerTests, PrefaultedBuffersFollowTrimMemory )
+{
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    AiaMemoryPrefaultStats_t before;
+    AiaMemory_GetPrefaultStats( &before );
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_PrefaultBuffers( g_speakerManager, false ) );
+    TEST_ASSERT_FALSE(
+        AiaSpeakerManager_PrefaultBuffers( g_speakerManager, false ) );
+    AiaMemoryPrefaultStats_t prefaulted;
+    AiaMemory_GetPrefaultStats( &prefaulted );
+    TEST_ASSERT_TRUE( prefaulted.prefaultedBytes > before.prefaultedBytes );
+
+    /* The staging buffer stops being prefaulted once it is released... */
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+    AiaMemoryPrefaultStats_t staged;
+    AiaMemory_GetPrefaultStats( &staged );
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME_1 ),
+                       AiaSpeakerManager_TrimMemory( g_speakerManager ) );
+    AiaMemoryPrefaultStats_t trimmed;
+    AiaMemory_GetPrefaultStats( &trimmed );
+    TEST_ASSERT_TRUE( trimmed.prefaultedBytes < staged.prefaultedBytes );
+
+    /* ...and is prefaulted again when it is allocated again. */
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_FRAME_1, g_observer->speakerDataReceived,
+                              sizeof( TEST_FRAME_1 ) );
+    AiaMemoryPrefaultStats_t reallocated;
+    AiaMemory_GetPrefaultStats( &reallocated );
+    TEST_ASSERT_TRUE( reallocated.prefaultedBytes > trimmed.prefaultedBytes );
+
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+#endif
+
+TEST( AiaSpeakerManagerTests, GapRejectedWithoutConcealment )
+{
+    TEST_ASSERT_FALSE( AiaSpeakerManager_CanConcealGaps( g_speakerManager ) );
+
+    size_t firstMessageLength = 0;
+    const uint8_t* firstMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, 0, &firstMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, firstMessage, firstMessageLength, 0 );
+
+    size_t gapMessageLength = 0;
+    const uint8_t* gapMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, 2 * sizeof( TEST_FRAME_1 ),
+        &gapMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, gapMessage, gapMessageLength, 2 );
+
+    AiaTestUtilities_TestMalformedMessageExceptionIsGenerated( g_mockRegulator,
+                                                               2, 0 );
+    AiaFree( (void*)gapMessage );
+    AiaFree( (void*)firstMessage );
+}
+
+TEST( AiaSpeakerManagerTests, GapConcealedWhenEnabled )
+{
+    static const uint8_t FRAME_BEFORE_GAP[] = { 1, 1, 1, 1 };
+    static const uint8_t FRAME_AFTER_GAP[] = { 3, 3, 3, 3 };
+    static const size_t FRAME_SIZE = sizeof( FRAME_BEFORE_GAP );
+    AiaSpeakerManager_SetConcealSpeakerDataCb(
+        g_speakerManager, ConcealSpeakerDataCallback, g_observer );
+    TEST_ASSERT_TRUE( AiaSpeakerManager_CanConcealGaps( g_speakerManager ) );
+
+    const char* openSpeakerPayload = generateOpenSpeaker( 0 );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    /* The message carrying the second frame is lost. */
+    size_t firstMessageLength = 0;
+    const uint8_t* firstMessage = generateBinaryAudioMessageEntry(
+        FRAME_BEFORE_GAP, FRAME_SIZE, 0, 0, &firstMessageLength );
+    size_t lastMessageLength = 0;
+    const uint8_t* lastMessage = generateBinaryAudioMessageEntry(
+        FRAME_AFTER_GAP, FRAME_SIZE, 0, 2 * FRAME_SIZE, &lastMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, firstMessage, firstMessageLength, 0 );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, lastMessage, lastMessageLength, 2 );
+
+    size_t expectedFramesPushed = 3;
+    while( expectedFramesPushed )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+        --expectedFramesPushed;
+    }
+
+    /* Playback continues through the gap with audio synthesized from the
+     * frame that follows it. */
+    TEST_ASSERT_EQUAL( 1, g_observer->framesConcealed );
+    TEST_ASSERT_EQUAL_MEMORY( FRAME_AFTER_GAP, g_observer->lastNextFrame,
+                              FRAME_SIZE );
+    TEST_ASSERT_EQUAL( 3 * FRAME_SIZE, g_observer->speakerDataReceivedSize );
+    TEST_ASSERT_EQUAL_MEMORY( FRAME_BEFORE_GAP, g_observer->speakerDataReceived,
+                              FRAME_SIZE );
+    const uint8_t* concealed =
+        (const uint8_t*)( g_observer->speakerDataReceived + FRAME_SIZE );
+    for( size_t i = 0; i < FRAME_SIZE; ++i )
+    {
+        TEST_ASSERT_EQUAL_UINT8( CONCEALED_BYTE, concealed[ i ] );
+    }
+    TEST_ASSERT_EQUAL_MEMORY( FRAME_AFTER_GAP,
+                              g_observer->speakerDataReceived + 2 * FRAME_SIZE,
+                              FRAME_SIZE );
+
+    /* Only the SpeakerOpened event is sent; the gap is not reported as a
+     * malformed message. */
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+    AiaListDouble( Link_t )* link =
+        AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
+    AiaListDouble( RemoveHead )( &g_mockRegulator->writtenMessages );
+    TEST_ASSERT_TRUE( link );
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( jsonMessage ),
+                               AIA_EVENTS_SPEAKER_OPENED ),
+                       0 );
+    TEST_ASSERT_TRUE(
+        AiaListDouble( IsEmpty )( &g_mockRegulator->writtenMessages ) );
+
+    AiaFree( (void*)lastMessage );
+    AiaFree( (void*)firstMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+TEST( AiaSpeakerManagerTests, ConsecutiveContentEntriesAreWritten )
+{
+    static const uint8_t FRAMES[][ 4 ] = { { 1, 1, 1, 1 },
+                                           { 2, 2, 2, 2 },
+                                           { 3, 3, 3, 3 } };
+    static const size_t FRAME_SIZE = sizeof( FRAMES[ 0 ] );
+    static const size_t NUM_FRAMES = sizeof( FRAMES ) / sizeof( FRAMES[ 0 ] );
+
+    const char* openSpeakerPayload = generateOpenSpeaker( 0 );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    /* A single message carrying contiguous entries is coalesced into one write
+     * to the speaker buffer. */
+    uint8_t message[ 256 ];
+    size_t messageLength = 0;
+    for( size_t i = 0; i < NUM_FRAMES; ++i )
+    {
+        size_t entryLength = 0;
+        const uint8_t* entry = generateBinaryAudioMessageEntry(
+            FRAMES[ i ], FRAME_SIZE, 0, i * FRAME_SIZE, &entryLength );
+        TEST_ASSERT_TRUE( messageLength + entryLength <= sizeof( message ) );
+        memcpy( message + messageLength, entry, entryLength );
+        messageLength += entryLength;
+        AiaFree( (void*)entry );
+    }
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived( g_speakerManager, message,
+                                                     messageLength, 0 );
+
+    size_t expectedFramesPushed = NUM_FRAMES;
+    while( expectedFramesPushed )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+        --expectedFramesPushed;
+    }
+    TEST_ASSERT_EQUAL( NUM_FRAMES * FRAME_SIZE,
+                       g_observer->speakerDataReceivedSize );
+    for( size_t i = 0; i < NUM_FRAMES; ++i )
+    {
+        TEST_ASSERT_EQUAL_MEMORY( FRAMES[ i ],
+                                  g_observer->speakerDataReceived +
+                                      i * FRAME_SIZE,
+                                  FRAME_SIZE );
+    }
+
+    /* Only the SpeakerOpened event is sent. */
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+    TEST_ASSERT_FALSE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+/** A plaintext Binary Stream handed out by @c copyPlaintext(). */
+typedef struct TestPlaintext
+{
+    /** The Binary Stream. */
+    const uint8_t* data;
+
+    /** The size of @c data. */
+    size_t size;
+
+    /** Whether the "decryption" is authentic. */
+    bool authentic;
+
+    /** The number of times @c copyPlaintext() was called. */
+    size_t numCalls;
+} TestPlaintext_t;
+
+/** Stands in for decryption by copying a @c TestPlaintext_t into @c regions. */
+static bool copyPlaintext( const AiaSpeakerManagerPlaintextRegion_t* regions,
+                           size_t numRegions, void* userData )
+{
+    TestPlaintext_t* plaintext = (TestPlaintext_t*)userData;
+    ++plaintext->numCalls;
+    size_t position = 0;
+    for( size_t i = 0; i < numRegions; ++i )
+    {
+        TEST_ASSERT_TRUE( position + regions[ i ].size <= plaintext->size );
+        memcpy( regions[ i ].data, plaintext->data + position,
+                regions[ i ].size );
+        position += regions[ i ].size;
+    }
+    TEST_ASSERT_EQUAL( plaintext->size, position );
+    return plaintext->authentic;
+}
+
+TEST( AiaSpeakerManagerTests, EncryptedContentIsDecryptedIntoBuffer )
+{
+    static const uint8_t FRAMES[][ 4 ] = { { 1, 1, 1, 1 }, { 2, 2, 2, 2 } };
+    static const size_t FRAME_SIZE = sizeof( FRAMES[ 0 ] );
+
+    const char* openSpeakerPayload = generateOpenSpeaker( 0 );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    size_t firstLength = 0;
+    const uint8_t* first = generateBinaryAudioMessageEntry(
+        FRAMES[ 0 ], FRAME_SIZE, 0, 0, &firstLength );
+    TestPlaintext_t plaintext = { first, firstLength, true, 0 };
+
+    /* The frame size is not known until a message has been decrypted. */
+    TEST_ASSERT_FALSE( AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+        g_speakerManager, firstLength, 0, copyPlaintext, &plaintext ) );
+    TEST_ASSERT_EQUAL( 0, plaintext.numCalls );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived( g_speakerManager, first,
+                                                     firstLength, 0 );
+
+    size_t secondLength = 0;
+    const uint8_t* second = generateBinaryAudioMessageEntry(
+        FRAMES[ 1 ], FRAME_SIZE, 0, FRAME_SIZE, &secondLength );
+    plaintext.data = second;
+    plaintext.size = secondLength;
+
+    /* Nothing is published unless the message is authentic. */
+    plaintext.authentic = false;
+    TEST_ASSERT_FALSE( AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+        g_speakerManager, secondLength, 1, copyPlaintext, &plaintext ) );
+    TEST_ASSERT_EQUAL( 1, plaintext.numCalls );
+
+    plaintext.authentic = true;
+    TEST_ASSERT_TRUE( AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+        g_speakerManager, secondLength, 1, copyPlaintext, &plaintext ) );
+    TEST_ASSERT_EQUAL( 2, plaintext.numCalls );
+
+    size_t expectedFramesPushed = 2;
+    while( expectedFramesPushed )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+        --expectedFramesPushed;
+    }
+    TEST_ASSERT_EQUAL( 2 * FRAME_SIZE, g_observer->speakerDataReceivedSize );
+    for( size_t i = 0; i < 2; ++i )
+    {
+        TEST_ASSERT_EQUAL_MEMORY( FRAMES[ i ],
+                                  g_observer->speakerDataReceived +
+                                      i * FRAME_SIZE,
+                                  FRAME_SIZE );
+    }
+
+    AiaFree( (void*)first );
+    AiaFree( (void*)second );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+TEST( AiaSpeakerManagerTests, UnderrunWarningClearedPastHysteresisMargin )
+{
+    static const size_t FRAME_SIZE = 50;
+    static const size_t CLEAR_MARGIN = 100;
+    uint8_t frame[ FRAME_SIZE ];
+    memset( frame, 0, sizeof( frame ) );
+
+    AiaSpeakerBufferStateHysteresisConfig_t hysteresis = { CLEAR_MARGIN, 0,
+                                                           0 };
+    TEST_ASSERT_FALSE(
+        AiaSpeakerManager_SetBufferStateHysteresis( NULL, NULL ) );
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_SetBufferStateHysteresis( g_speakerManager,
+                                                    &hysteresis ) );
+
+    /* The speaker is closed, so the buffer only fills. */
+    AiaBinaryAudioStreamOffset_t offset = 0;
+    static const size_t NUM_FRAMES = 5;
+    size_t expectedNotifications[] = { 1, 0, 0, 0, 1 };
+    for( size_t i = 0; i < NUM_FRAMES; ++i )
+    {
+        size_t binaryMessageLength = 0;
+        const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+            frame, FRAME_SIZE, 0, offset, &binaryMessageLength );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+            g_speakerManager, binaryMessage, binaryMessageLength, i );
+        AiaFree( (void*)binaryMessage );
+        offset += FRAME_SIZE;
+
+        size_t notifications = 0;
+        while( AiaSemaphore( TryWait )(
+            &g_observer->numObserversNotifiedSemaphore ) )
+        {
+            ++notifications;
+        }
+        TEST_ASSERT_EQUAL( expectedNotifications[ i ], notifications );
+    }
+}
+
 TEST( AiaSpeakerManagerTests, MalformedSpeakerMessage )
 {
     static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
@@ -2664,6 +3793,24 @@ TEST( AiaSpeakerManagerTests, MalformedSpeakerMessage )
     AiaFree( (void*)binaryMessage );
 }
 
+#ifdef AIA_SPEAKER_FIXED_FRAME_SIZE
+TEST( AiaSpeakerManagerTests, OtherFrameSizeRejected )
+{
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    uint8_t frame[ AIA_SPEAKER_FIXED_FRAME_SIZE + 1 ] = { 0 };
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        frame, sizeof( frame ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    AiaTestUtilities_TestMalformedMessageExceptionIsGenerated( g_mockRegulator,
+                                                               0, 1 );
+    AiaFree( (void*)binaryMessage );
+}
+#endif
+
 TEST( AiaSpeakerManagerTests, BufferStateEventsNotSentWhenSpeakerClosed )
 {
     AiaSequenceNumber_t speakerSequenceNumberToSend = 0;
@@ -2843,6 +3990,92 @@ TEST( AiaSpeakerManagerTests, GetCurrentOffset )
     AiaFree( (void*)openSpeakerPayload );
 }
 
+TEST( AiaSpeakerManagerTests, AdaptiveJitterBufferHoldsPlaybackUntilPrefilled )
+{
+    static const size_t TEST_NUM_PREFILL_FRAMES = 3;
+    const AiaSpeakerJitterBufferConfig_t TEST_CONFIG = {
+        TEST_NUM_PREFILL_FRAMES * TestFrame1DurationMs(), 0, 10000
+    };
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_SetAdaptiveJitterBuffer( g_speakerManager,
+                                                   &TEST_CONFIG ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    for( size_t i = 0; i < TEST_NUM_PREFILL_FRAMES; ++i )
+    {
+        TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+            &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+        TEST_ASSERT_TRUE(
+            AiaListDouble( IsEmpty )( &g_mockRegulator->writtenMessages ) );
+
+        size_t binaryMessageLength = 0;
+        const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+            TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0,
+            TEST_OPEN_SPEAKER_OFFSET + i * sizeof( TEST_FRAME_1 ),
+            &binaryMessageLength );
+        AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+            g_speakerManager, binaryMessage, binaryMessageLength, i );
+        AiaFree( (void*)binaryMessage );
+    }
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE(
+        AiaSemaphore( TimedWait )( &g_mockRegulator->writeSemaphore, 100 ) );
+    AiaListDouble( Link_t )* link =
+        AiaListDouble( PeekHead )( &g_mockRegulator->writtenMessages );
+    TEST_ASSERT_TRUE( link );
+    AiaJsonMessage_t* jsonMessage = AiaJsonMessage_FromMessage(
+        ( (AiaMockRegulatorWrittenMessage_t*)link )->chunk );
+    TEST_ASSERT_EQUAL( strcmp( AiaJsonMessage_GetName( jsonMessage ),
+                               AIA_EVENTS_SPEAKER_OPENED ),
+                       0 );
+
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+TEST( AiaSpeakerManagerTests,
+      AdaptiveJitterBufferStartsPlaybackAfterPrefillTimeout )
+{
+    const AiaSpeakerJitterBufferConfig_t TEST_CONFIG = {
+        100 * TestFrame1DurationMs(), 0, 5 * TestFrame1DurationMs()
+    };
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_SetAdaptiveJitterBuffer( g_speakerManager,
+                                                   &TEST_CONFIG ) );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 500 ) );
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME_1 ),
+                       g_observer->speakerDataReceivedSize );
+
+    TEST_ASSERT_TRUE( AiaSpeakerManager_SetAdaptiveJitterBuffer(
+        g_speakerManager, NULL ) );
+
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
 #ifdef AIA_ENABLE_ALERTS
 TEST( AiaSpeakerManagerTests, OfflineAlertPlayback )
 {
@@ -2909,3 +4142,121 @@ TEST( AiaSpeakerManagerTests, CanSpeakerStream )
     AiaFree( (void*)binaryMessage );
     AiaFree( (void*)openSpeakerPayload );
 }
+
+TEST( AiaSpeakerManagerTests, AddedSinkReceivesSameFrames )
+{
+    AiaSpeakerManagerTestObserver_t* sinkObserver =
+        AiaSpeakerManagerTestObserver_Create();
+    TEST_ASSERT_NOT_NULL( sinkObserver );
+    AiaSpeakerSinkId_t sinkId = AiaSpeakerManager_AddSink(
+        g_speakerManager, PlaySpeakerDataCallback, sinkObserver );
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_SPEAKER_SINK_ID, sinkId );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    static const uint8_t TEST_FRAME[] = { 1, 2, 3, 4 };
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME, sizeof( TEST_FRAME ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &sinkObserver->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( sizeof( TEST_FRAME ),
+                       sinkObserver->speakerDataReceivedSize );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_FRAME, sinkObserver->speakerDataReceived,
+                              sizeof( TEST_FRAME ) );
+
+    TEST_ASSERT_TRUE(
+        AiaSpeakerManager_RemoveSink( g_speakerManager, sinkId ) );
+    TEST_ASSERT_FALSE(
+        AiaSpeakerManager_RemoveSink( g_speakerManager, sinkId ) );
+
+    AiaSpeakerManager_Destroy( g_speakerManager );
+    g_speakerManager = NULL;
+    AiaSpeakerManagerTestObserver_Destroy( sinkObserver );
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)openSpeakerPayload );
+}
+
+/** Whether @c RejectableSinkCallback rejects the frames it records. */
+static bool g_rejectSinkFrames;
+
+static bool RejectableSinkCallback( const void* buf, size_t size,
+                                    void* userData )
+{
+    PlaySpeakerDataCallback( buf, size, userData );
+    return !g_rejectSinkFrames;
+}
+
+TEST( AiaSpeakerManagerTests, RejectingSinkHoldsBackFrames )
+{
+    AiaSpeakerManagerTestObserver_t* sinkObserver =
+        AiaSpeakerManagerTestObserver_Create();
+    TEST_ASSERT_NOT_NULL( sinkObserver );
+    g_rejectSinkFrames = true;
+    AiaSpeakerSinkId_t sinkId = AiaSpeakerManager_AddSink(
+        g_speakerManager, RejectableSinkCallback, sinkObserver );
+    TEST_ASSERT_NOT_EQUAL( AIA_INVALID_SPEAKER_SINK_ID, sinkId );
+
+    static const AiaBinaryAudioStreamOffset_t TEST_OPEN_SPEAKER_OFFSET = 0;
+    const char* openSpeakerPayload =
+        generateOpenSpeaker( TEST_OPEN_SPEAKER_OFFSET );
+    AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
+        g_speakerManager, (void*)openSpeakerPayload,
+        strlen( openSpeakerPayload ), 0, 0 );
+
+    size_t binaryMessageLength = 0;
+    const uint8_t* binaryMessage = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0, TEST_OPEN_SPEAKER_OFFSET,
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage, binaryMessageLength, 0 );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &sinkObserver->numSpeakerFramesPushedSemaphore, 100 ) );
+
+    const uint8_t* binaryMessage2 = generateBinaryAudioMessageEntry(
+        TEST_FRAME_1, sizeof( TEST_FRAME_1 ), 0,
+        TEST_OPEN_SPEAKER_OFFSET + sizeof( TEST_FRAME_1 ),
+        &binaryMessageLength );
+    AiaSpeakerManager_OnSpeakerTopicMessageReceived(
+        g_speakerManager, binaryMessage2, binaryMessageLength, 0 );
+
+    /* Nothing more is read until the slowest speaker is ready. */
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &sinkObserver->numSpeakerFramesPushedSemaphore, 100 ) );
+
+    /* The rejected frame is pushed again to the added speaker only. */
+    g_rejectSinkFrames = false;
+    AiaSpeakerManager_OnSinkReady( g_speakerManager, sinkId );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &sinkObserver->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &sinkObserver->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_FALSE( AiaSemaphore( TimedWait )(
+        &g_observer->numSpeakerFramesPushedSemaphore, 100 ) );
+    TEST_ASSERT_EQUAL( 2 * sizeof( TEST_FRAME_1 ),
+                       g_observer->speakerDataReceivedSize );
+
+    AiaSpeakerManager_Destroy( g_speakerManager );
+    g_speakerManager = NULL;
+    AiaSpeakerManagerTestObserver_Destroy( sinkObserver );
+    AiaFree( (void*)binaryMessage );
+    AiaFree( (void*)binaryMessage2 );
+    AiaFree( (void*)openSpeakerPayload );
+}
@@ -54,6 +54,7 @@ static void AiaOnUXStateChanged( AiaUXState_t state, void* userData )
     TEST_ASSERT_NOT_NULL( userData );
     AiaTestUXStateObserver_t* observer = (AiaTestUXStateObserver_t*)userData;
     observer->currentState = state;
+    AiaSemaphore( Post )( &observer->numObserversNotifiedSemaphore );
 }
 
 static AiaTestUXStateObserver_t* AiaTestUXStateObserver_Create()
@@ -202,6 +203,8 @@ TEST_GROUP_RUNNER( AiaUXManagerTests )
 #endif
     RUN_TEST_CASE( AiaUXManagerTests,
                    TestGetUXStateWhenMicrophoneClosedWithoutOffset );
+    RUN_TEST_CASE( AiaUXManagerTests, TestUnchangedStateIsNotNotified );
+    RUN_TEST_CASE( AiaUXManagerTests, TestAsyncObserverIsNotifiedOfLatestState );
 }
 
 /*-----------------------------------------------------------*/
@@ -594,3 +597,61 @@ TEST( AiaUXManagerTests, TestGetUXStateWhenMicrophoneClosedWithoutOffset )
     TEST_ASSERT_EQUAL( AIA_UX_THINKING,
                        AiaUXManager_GetUXState( g_testUxManager ) );
 }
+
+TEST( AiaUXManagerTests, TestUnchangedStateIsNotNotified )
+{
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 44;
+    size_t TEST_INDEX = 44;
+    for( size_t i = 0; i < 2; ++i )
+    {
+        char* setAttentionState =
+            generateSetAttentionStateWithoutOffset( AIA_UX_THINKING );
+        TEST_ASSERT_NOT_NULL( setAttentionState );
+        AiaUXManager_OnSetAttentionStateDirectiveReceived(
+            g_testUxManager, setAttentionState, strlen( setAttentionState ),
+            TEST_SEQUENCE_NUMBER, TEST_INDEX );
+        AiaFree( setAttentionState );
+    }
+    TEST_ASSERT_EQUAL( AIA_UX_THINKING, g_testObserver->currentState );
+    TEST_ASSERT_TRUE( AiaSemaphore( TryWait )(
+        &g_testObserver->numObserversNotifiedSemaphore ) );
+    TEST_ASSERT_FALSE( AiaSemaphore( TryWait )(
+        &g_testObserver->numObserversNotifiedSemaphore ) );
+}
+
+TEST( AiaUXManagerTests, TestAsyncObserverIsNotifiedOfLatestState )
+{
+    static const uint32_t NOTIFICATION_TIMEOUT_MS = 1000;
+    AiaSequenceNumber_t TEST_SEQUENCE_NUMBER = 44;
+    size_t TEST_INDEX = 44;
+    AiaUXManager_SetAsyncObserver( g_testUxManager, true );
+
+    char* setAttentionState =
+        generateSetAttentionStateWithoutOffset( AIA_UX_THINKING );
+    TEST_ASSERT_NOT_NULL( setAttentionState );
+    AiaUXManager_OnSetAttentionStateDirectiveReceived(
+        g_testUxManager, setAttentionState, strlen( setAttentionState ),
+        TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( setAttentionState );
+    setAttentionState =
+        generateSetAttentionStateWithoutOffset( AIA_UX_DO_NOT_DISTURB );
+    TEST_ASSERT_NOT_NULL( setAttentionState );
+    AiaUXManager_OnSetAttentionStateDirectiveReceived(
+        g_testUxManager, setAttentionState, strlen( setAttentionState ),
+        TEST_SEQUENCE_NUMBER, TEST_INDEX );
+    AiaFree( setAttentionState );
+
+    /* The intermediate state may have been coalesced away. */
+    TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+        &g_testObserver->numObserversNotifiedSemaphore,
+        NOTIFICATION_TIMEOUT_MS ) );
+    if( g_testObserver->currentState != AIA_UX_DO_NOT_DISTURB )
+    {
+        TEST_ASSERT_TRUE( AiaSemaphore( TimedWait )(
+            &g_testObserver->numObserversNotifiedSemaphore,
+            NOTIFICATION_TIMEOUT_MS ) );
+    }
+    TEST_ASSERT_EQUAL( AIA_UX_DO_NOT_DISTURB, g_testObserver->currentState );
+    TEST_ASSERT_EQUAL( AIA_UX_DO_NOT_DISTURB,
+                       AiaUXManager_GetUXState( g_testUxManager ) );
+}
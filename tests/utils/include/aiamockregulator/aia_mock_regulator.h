@@ -36,6 +36,12 @@ typedef struct AiaMockRegulator
     AiaListDouble_t writtenMessages;
 
     AiaSemaphore_t writeSemaphore;
+
+    /** Value returned by @c AiaRegulator_GetMinWaitTimeMs(). */
+    AiaDurationMs_t minWaitTimeMs;
+
+    /** Value returned by @c AiaRegulator_GetRemainingMessageSpace(). */
+    size_t remainingMessageSpace;
 } AiaMockRegulator_t;
 
 /** Structure for holding emitted messages and when they were emitted. */
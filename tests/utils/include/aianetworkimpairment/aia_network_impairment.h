@@ -0,0 +1,260 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_network_impairment.h
+ * @brief Simulated network link delaying, reordering, duplicating, dropping
+ * and rate limiting MQTT messages, for tests and benchmarks.
+ *
+ * An @c AiaNetworkImpairment_t sits on one direction of a fake connection.
+ * Messages are submitted to it in place of being published or delivered, and
+ * handed to its delivery callback by @c AiaNetworkImpairment_Poll() once the
+ * simulated link lets them through:
+ *
+ * - Inbound, @c AiaNetworkImpairment_MessageReceivedCallback() is subscribed
+ *   in place of the client's handler, and @c
+ *   AiaNetworkImpairment_DeliverToMqttHandler() passes messages on to it.
+ * - Outbound, a test's replacement @c AiaMqttPublish() submits to an
+ *   impairment whose callback consumes what the client published.
+ *
+ * Every random decision is drawn from a PRNG seeded at creation, and time is
+ * passed in by the caller, so a run driven with the same seed and the same
+ * times delivers the same messages in the same order.
+ */
+
+#ifndef AIA_NETWORK_IMPAIRMENT_H_
+#define AIA_NETWORK_IMPAIRMENT_H_
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+/** The distributions the random part of a link's delay can follow. */
+typedef enum AiaNetworkImpairmentDistribution
+{
+    /** Evenly spread between zero and the jitter. */
+    AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM,
+
+    /** Exponentially distributed with the jitter as its mean, giving the long
+     * tail of a link which is contended or retransmitting. */
+    AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_EXPONENTIAL
+} AiaNetworkImpairmentDistribution_t;
+
+/** The conditions simulated by an @c AiaNetworkImpairment_t. Probabilities are
+ * given per thousand messages. */
+typedef struct AiaNetworkImpairmentProfile
+{
+    /** The delay every message is given. */
+    AiaDurationMs_t baseDelayMs;
+
+    /** The scale of the random delay added to @c baseDelayMs. */
+    AiaDurationMs_t jitterMs;
+
+    /** The distribution of the random delay. */
+    AiaNetworkImpairmentDistribution_t jitterDistribution;
+
+    /** The chance of losing a message after one which was delivered. */
+    uint32_t lossPerMille;
+
+    /** The chance of losing a message after one which was lost, to simulate
+     * bursts of loss. Zero uses @c lossPerMille. */
+    uint32_t burstLossPerMille;
+
+    /** The chance of delivering a message twice. */
+    uint32_t duplicatePerMille;
+
+    /** The chance of holding a message back by @c reorderDelayMs, letting the
+     * messages after it overtake it. Other messages are delivered in the
+     * order they were submitted, as they would be over a single TCP
+     * connection. */
+    uint32_t reorderPerMille;
+
+    /** How long reordered messages are held back. */
+    AiaDurationMs_t reorderDelayMs;
+
+    /** The rate at which messages are serialized onto the link, or zero for
+     * no limit. Messages queue behind each other at this rate before being
+     * delayed. */
+    uint32_t bandwidthBytesPerSecond;
+} AiaNetworkImpairmentProfile_t;
+
+/** Counters kept by an @c AiaNetworkImpairment_t. */
+typedef struct AiaNetworkImpairmentStats
+{
+    /** The number of messages submitted. */
+    uint32_t submitted;
+
+    /** The number of messages lost. */
+    uint32_t dropped;
+
+    /** The number of extra copies of messages queued. */
+    uint32_t duplicated;
+
+    /** The number of messages and copies held back to be reordered. */
+    uint32_t reordered;
+
+    /** The number of messages and copies passed to the delivery callback. */
+    uint32_t delivered;
+
+    /** The largest delay between a message being submitted and delivered. */
+    AiaDurationMs_t maxDelayMs;
+} AiaNetworkImpairmentStats_t;
+
+/**
+ * Called by @c AiaNetworkImpairment_Poll() for each message the link lets
+ * through.
+ *
+ * @param topic The topic the message was submitted on.
+ * @param topicLength The length of @c topic.
+ * @param message The message, which is only valid during the call.
+ * @param messageLength The length of @c message.
+ * @param userData Context passed to @c AiaNetworkImpairment_Create().
+ */
+typedef void ( *AiaNetworkImpairmentDeliverCallback_t )( const char* topic,
+                                                          size_t topicLength,
+                                                          const void* message,
+                                                          size_t messageLength,
+                                                          void* userData );
+
+/**
+ * Opaque handle to a simulated link.
+ */
+typedef struct AiaNetworkImpairment AiaNetworkImpairment_t;
+
+/**
+ * Looks up one of the built-in profiles:
+ *
+ * - @c none delivers every message in order without delay.
+ * - @c good-wifi adds a few milliseconds of delay and rare loss.
+ * - @c congested-wifi adds long-tailed delay, bursty loss, duplication,
+ *   reordering and a 2Mbps bandwidth cap.
+ * - @c lossy-wifi adds moderate delay and frequent, bursty loss.
+ *
+ * @param name The name of the profile.
+ * @param[out] profile The profile.
+ * @return @c true if @c name is a built-in profile, else @c false.
+ */
+bool AiaNetworkImpairment_GetProfile( const char* name,
+                                      AiaNetworkImpairmentProfile_t* profile );
+
+/**
+ * Creates a simulated link.
+ *
+ * @param profile The conditions to simulate, which are copied.
+ * @param seed The seed of the PRNG making every random decision.
+ * @param deliver The callback passed the messages the link lets through.
+ * @param deliverUserData Context passed to @c deliver.
+ * @return The new link, or @c NULL on failure.
+ */
+AiaNetworkImpairment_t* AiaNetworkImpairment_Create(
+    const AiaNetworkImpairmentProfile_t* profile, uint32_t seed,
+    AiaNetworkImpairmentDeliverCallback_t deliver, void* deliverUserData );
+
+/**
+ * Destroys a link, dropping any messages still in flight.
+ *
+ * @param impairment The link to destroy.
+ */
+void AiaNetworkImpairment_Destroy( AiaNetworkImpairment_t* impairment );
+
+/**
+ * Sends a copy of a message over the link. Messages lost by the link are
+ * accepted all the same, as a real network would.
+ *
+ * @param impairment The link to send over.
+ * @param nowMs The current time.
+ * @param topic The topic of the message.
+ * @param topicLength The length of @c topic.
+ * @param message The message.
+ * @param messageLength The length of @c message.
+ * @return @c true if the message was accepted, else @c false.
+ */
+bool AiaNetworkImpairment_Submit( AiaNetworkImpairment_t* impairment,
+                                  AiaTimepointMs_t nowMs, const char* topic,
+                                  size_t topicLength, const void* message,
+                                  size_t messageLength );
+
+/**
+ * Delivers every message due by @c nowMs, in order. Messages are delivered
+ * without any lock held, so the callback may submit further messages.
+ *
+ * @param impairment The link to act on.
+ * @param nowMs The current time.
+ * @return The number of messages delivered.
+ * @note Only one thread should poll a link at a time, or the order in which
+ * messages are delivered is lost.
+ */
+size_t AiaNetworkImpairment_Poll( AiaNetworkImpairment_t* impairment,
+                                  AiaTimepointMs_t nowMs );
+
+/**
+ * Finds when the next message in flight is due.
+ *
+ * @param impairment The link to act on.
+ * @param[out] deliveryMs The time the next message is due.
+ * @return @c true if a message is in flight, else @c false.
+ */
+bool AiaNetworkImpairment_GetNextDeliveryTime(
+    AiaNetworkImpairment_t* impairment, AiaTimepointMs_t* deliveryMs );
+
+/**
+ * Takes a snapshot of the counters of a link.
+ *
+ * @param impairment The link to act on.
+ * @param[out] stats The counters of @c impairment.
+ */
+void AiaNetworkImpairment_GetStats( AiaNetworkImpairment_t* impairment,
+                                    AiaNetworkImpairmentStats_t* stats );
+
+/** The MQTT handler an inbound link delivers to. */
+typedef struct AiaNetworkImpairmentMqttHandler
+{
+    /** The handler the client subscribed with. */
+    AiaMqttTopicHandler_t handler;
+
+    /** The context the client subscribed with. */
+    void* userData;
+
+    /** The connection the messages are delivered on. */
+    AiaMqttConnectionPointer_t connection;
+} AiaNetworkImpairmentMqttHandler_t;
+
+/**
+ * An @c AiaNetworkImpairmentDeliverCallback_t passing messages to an MQTT
+ * handler at QoS 0, as the MQTT library would.
+ *
+ * @param topic The topic of the message.
+ * @param topicLength The length of @c topic.
+ * @param message The message.
+ * @param messageLength The length of @c message.
+ * @param userData The @c AiaNetworkImpairmentMqttHandler_t to deliver to.
+ */
+void AiaNetworkImpairment_DeliverToMqttHandler( const char* topic,
+                                                size_t topicLength,
+                                                const void* message,
+                                                size_t messageLength,
+                                                void* userData );
+
+/**
+ * An @c AiaMqttTopicHandler_t submitting received messages to a link at the
+ * current time, to be subscribed in place of @c messageReceivedCallback().
+ *
+ * @param callbackArg The @c AiaNetworkImpairment_t to submit to.
+ * @param callbackParam The received message.
+ */
+void AiaNetworkImpairment_MessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam );
+
+#endif /* ifndef AIA_NETWORK_IMPAIRMENT_H_ */
@@ -78,3 +78,55 @@ bool AiaRegulator_Write( AiaRegulator_t* regulator, AiaRegulatorChunk_t* chunk )
     AiaSemaphore( Post )( &mockRegulator->writeSemaphore );
     return true;
 }
+
+bool AiaRegulator_WriteWithPriority( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaRegulatorPriority_t priority )
+{
+    (void)priority;
+    return AiaRegulator_Write( regulator, chunk );
+}
+
+bool AiaRegulator_WriteWithDeadline( AiaRegulator_t* regulator,
+                                     AiaRegulatorChunk_t* chunk,
+                                     AiaDurationMs_t maxDelayMs )
+{
+    (void)maxDelayMs;
+    return AiaRegulator_Write( regulator, chunk );
+}
+
+void AiaRegulator_Flush( AiaRegulator_t* regulator )
+{
+    (void)regulator;
+}
+
+bool AiaRegulator_WriteOrWait( AiaRegulator_t* regulator,
+                               AiaRegulatorChunk_t* chunk,
+                               AiaDurationMs_t timeoutMs )
+{
+    (void)timeoutMs;
+    return AiaRegulator_Write( regulator, chunk );
+}
+
+bool AiaRegulator_SetWatermarks(
+    AiaRegulator_t* regulator, size_t highWatermarkBytes,
+    size_t lowWatermarkBytes, AiaRegulatorWatermarkCallback_t watermarkCallback,
+    void* watermarkCallbackUserData )
+{
+    (void)regulator;
+    (void)highWatermarkBytes;
+    (void)lowWatermarkBytes;
+    (void)watermarkCallback;
+    (void)watermarkCallbackUserData;
+    return true;
+}
+
+AiaDurationMs_t AiaRegulator_GetMinWaitTimeMs( const AiaRegulator_t* regulator )
+{
+    return ( (const AiaMockRegulator_t*)regulator )->minWaitTimeMs;
+}
+
+size_t AiaRegulator_GetRemainingMessageSpace( AiaRegulator_t* regulator )
+{
+    return ( (AiaMockRegulator_t*)regulator )->remainingMessageSpace;
+}
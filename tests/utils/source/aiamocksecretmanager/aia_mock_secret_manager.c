@@ -111,3 +111,26 @@ bool AiaSecretManager_Decrypt( AiaSecretManager_t* secretManager,
 
     return true;
 }
+
+bool AiaSecretManager_DecryptSegments( AiaSecretManager_t* secretManager,
+                                       AiaTopic_t topic,
+                                       AiaSequenceNumber_t sequenceNumber,
+                                       const AiaCryptoSegment_t* segments,
+                                       size_t numSegments, const uint8_t* iv,
+                                       size_t ivLen, const uint8_t* tag,
+                                       size_t tagLen )
+{
+    (void)secretManager;
+    (void)topic;
+    (void)sequenceNumber;
+    (void)segments;
+    (void)numSegments;
+    (void)iv;
+    (void)ivLen;
+    (void)tag;
+    (void)tagLen;
+
+    /* Nothing is decrypted, so callers fall back to AiaSecretManager_Decrypt().
+     */
+    return false;
+}
@@ -95,3 +95,20 @@ bool AiaSequencer_Write( AiaSequencer_t* sequencer, void* message, size_t size )
 
     return true;
 }
+
+bool AiaSequencer_WriteAndAdopt( AiaSequencer_t* sequencer, void* message,
+                                 size_t size )
+{
+    (void)sequencer;
+    (void)size;
+    AiaFree( message );
+
+    return true;
+}
+
+bool AiaSequencer_SkipMissing( AiaSequencer_t* sequencer )
+{
+    (void)sequencer;
+
+    return false;
+}
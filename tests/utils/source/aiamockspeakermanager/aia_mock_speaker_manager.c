@@ -80,6 +80,19 @@ void AiaSpeakerManager_OnSpeakerTopicMessageReceived(
     (void)sequenceNumber;
 }
 
+bool AiaSpeakerManager_OnEncryptedSpeakerTopicMessageReceived(
+    AiaSpeakerManager_t* speakerManager, size_t size,
+    AiaSequenceNumber_t sequenceNumber,
+    AiaSpeakerManagerDecryptCallback_t decrypt, void* userData )
+{
+    (void)speakerManager;
+    (void)size;
+    (void)sequenceNumber;
+    (void)decrypt;
+    (void)userData;
+    return false;
+}
+
 void AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
     void* manager, const void* payload, size_t size,
     AiaSequenceNumber_t sequenceNumber, size_t index )
@@ -91,7 +104,7 @@ void AiaSpeakerManager_OnOpenSpeakerDirectiveReceived(
     (void)index;
 }
 
-void* AiaSpeakerManager_InvokeActionAtOffset(
+AiaSpeakerActionHandle_t AiaSpeakerManager_InvokeActionAtOffset(
     AiaSpeakerManager_t* speakerManager, AiaBinaryAudioStreamOffset_t offset,
     void ( *action )( bool, void* userData ), void* userData )
 {
@@ -101,7 +114,7 @@ void* AiaSpeakerManager_InvokeActionAtOffset(
     ( (AiaMockSpeakerManager_t*)speakerManager )->currentActionOffset = offset;
     ( (AiaMockSpeakerManager_t*)speakerManager )->currentActionUserData =
         userData;
-    return speakerManager;
+    return 1;
 }
 
 void AiaSpeakerManager_CancelAction( AiaSpeakerManager_t* speakerManager,
@@ -117,3 +130,9 @@ AiaBinaryAudioStreamOffset_t AiaSpeakerManager_GetCurrentOffset(
     (void)speakerManager;
     return 0;
 }
+
+bool AiaSpeakerManager_CanConcealGaps( AiaSpeakerManager_t* speakerManager )
+{
+    (void)speakerManager;
+    return false;
+}
@@ -0,0 +1,563 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file aia_network_impairment.c
+ * @brief Implements functions for the AiaNetworkImpairment_t type.
+ */
+
+/* The config header is always included first. */
+#include <aia_config.h>
+
+#include <aianetworkimpairment/aia_network_impairment.h>
+#include <aiacore/aia_utils.h>
+
+#include AiaClock( HEADER )
+#include AiaListDouble( HEADER )
+#include AiaMutex( HEADER )
+
+#include <string.h>
+
+/** ln( 2 ) in 16.16 fixed point. */
+#define AIA_NETWORK_IMPAIRMENT_LN2_Q16 45426
+
+/** A built-in profile. */
+typedef struct AiaNetworkImpairmentNamedProfile
+{
+    const char* name;
+    AiaNetworkImpairmentProfile_t profile;
+} AiaNetworkImpairmentNamedProfile_t;
+
+/** The built-in profiles, loosely modelled on home Wi-Fi. */
+static const AiaNetworkImpairmentNamedProfile_t
+    AIA_NETWORK_IMPAIRMENT_PROFILES[] = {
+        { "none",
+          { 0, 0, AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM, 0, 0, 0, 0, 0,
+            0 } },
+        { "good-wifi",
+          { 5, 5, AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM, 1, 0, 0, 0, 0,
+            0 } },
+        { "congested-wifi",
+          { 20, 30, AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_EXPONENTIAL, 10, 250,
+            5, 20, 50, 250000 } },
+        { "lossy-wifi",
+          { 10, 20, AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM, 50, 300, 10,
+            10, 30, 0 } }
+    };
+
+/** A message in flight. */
+typedef struct AiaNetworkImpairmentMessage
+{
+    /** The link in the queue of messages in flight. */
+    AiaListDouble( Link_t ) link;
+
+    /** The time the message was submitted, in microseconds. */
+    uint64_t submittedUs;
+
+    /** The time the message is due, in microseconds. */
+    uint64_t deliveryUs;
+
+    /** The length of the topic. */
+    size_t topicLength;
+
+    /** The length of the message. */
+    size_t messageLength;
+
+    /** The topic, followed by the message. */
+    uint8_t data[];
+} AiaNetworkImpairmentMessage_t;
+
+/**
+ * Underlying struct that contains all the data required to present the @c
+ * AiaNetworkImpairment_t abstraction.
+ */
+struct AiaNetworkImpairment
+{
+    /** Mutex for synchronizing access to variables in the group below. */
+    AiaMutex_t mutex;
+
+    /** @name Variables synchronized by mutex. */
+    /** @{ */
+
+    /** The messages in flight, in delivery order. */
+    AiaListDouble_t messages;
+
+    /** The state of the PRNG. */
+    uint32_t random;
+
+    /** Whether the last message submitted was lost. */
+    bool lastLost;
+
+    /** When the link finishes serializing the messages submitted so far, in
+     * microseconds. */
+    uint64_t busyUntilUs;
+
+    /** When the last message which was not reordered is due, in
+     * microseconds. Later messages are not delivered before it. */
+    uint64_t lastDeliveryUs;
+
+    /** The counters of the link. */
+    AiaNetworkImpairmentStats_t stats;
+
+    /** @} */
+
+    /** The conditions simulated. */
+    const AiaNetworkImpairmentProfile_t profile;
+
+    /** The callback messages are delivered to. */
+    const AiaNetworkImpairmentDeliverCallback_t deliver;
+
+    /** Context passed to @c deliver. */
+    void* const deliverUserData;
+};
+
+/**
+ * Advances the PRNG of a link, an xorshift32 generator.
+ *
+ * @param impairment The link to act on.
+ * @return The next random number, which is never zero.
+ * @note Must be called with @c impairment->mutex held.
+ */
+static uint32_t AiaNetworkImpairment_NextRandomLocked(
+    AiaNetworkImpairment_t* impairment )
+{
+    uint32_t x = impairment->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    impairment->random = x;
+    return x;
+}
+
+/**
+ * Makes a random decision.
+ *
+ * @param impairment The link to act on.
+ * @param perMille The chance of the decision being @c true, per thousand.
+ * @return The decision.
+ * @note Must be called with @c impairment->mutex held.
+ */
+static bool AiaNetworkImpairment_RollLocked( AiaNetworkImpairment_t* impairment,
+                                             uint32_t perMille )
+{
+    return perMille &&
+           AiaNetworkImpairment_NextRandomLocked( impairment ) % 1000 <
+               perMille;
+}
+
+/**
+ * Computes -log2( value / 2^32 ) without the math library.
+ *
+ * @param value A non-zero value.
+ * @return The result in 16.16 fixed point.
+ */
+static uint32_t AiaNetworkImpairment_NegativeLog2( uint32_t value )
+{
+    /* Normalize value to x in [1, 2) in 1.31 fixed point, so that
+     * value / 2^32 = x / 2^( shift + 1 ). */
+    uint32_t shift = 0;
+    while( !( value & 0x80000000u ) )
+    {
+        value <<= 1;
+        ++shift;
+    }
+
+    /* Each squaring of x doubles its logarithm, exposing one more bit of its
+     * fraction. */
+    uint64_t x = value;
+    uint32_t fraction = 0;
+    for( int bit = 15; bit >= 0; --bit )
+    {
+        x = ( x * x ) >> 31;
+        if( x >= ( (uint64_t)2 << 31 ) )
+        {
+            x >>= 1;
+            fraction |= 1u << bit;
+        }
+    }
+    return ( ( shift + 1 ) << 16 ) - fraction;
+}
+
+/**
+ * Draws the random part of a message's delay.
+ *
+ * @param impairment The link to act on.
+ * @return The delay in microseconds.
+ * @note Must be called with @c impairment->mutex held.
+ */
+static uint64_t AiaNetworkImpairment_DrawJitterUsLocked(
+    AiaNetworkImpairment_t* impairment )
+{
+    uint64_t jitterUs = (uint64_t)impairment->profile.jitterMs * 1000;
+    if( !jitterUs )
+    {
+        return 0;
+    }
+    uint32_t random = AiaNetworkImpairment_NextRandomLocked( impairment );
+    switch( impairment->profile.jitterDistribution )
+    {
+        case AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_EXPONENTIAL:
+            /* Inverse transform sampling: -mean * ln( U ). */
+            return ( jitterUs * AiaNetworkImpairment_NegativeLog2( random ) *
+                     AIA_NETWORK_IMPAIRMENT_LN2_Q16 ) >>
+                   32;
+        case AIA_NETWORK_IMPAIRMENT_DISTRIBUTION_UNIFORM:
+            break;
+    }
+    return random % ( jitterUs + 1 );
+}
+
+/**
+ * Queues one copy of a message, working out when it is due.
+ *
+ * @param impairment The link to act on.
+ * @param nowUs The current time, in microseconds.
+ * @param topic The topic of the message.
+ * @param topicLength The length of @c topic.
+ * @param message The message.
+ * @param messageLength The length of @c message.
+ * @return @c true if the copy was queued, else @c false.
+ * @note Must be called with @c impairment->mutex held.
+ */
+static bool AiaNetworkImpairment_QueueLocked(
+    AiaNetworkImpairment_t* impairment, uint64_t nowUs, const char* topic,
+    size_t topicLength, const void* message, size_t messageLength )
+{
+    size_t size =
+        sizeof( AiaNetworkImpairmentMessage_t ) + topicLength + messageLength;
+    AiaNetworkImpairmentMessage_t* queued = AiaCalloc( 1, size );
+    if( !queued )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.", size );
+        return false;
+    }
+    queued->submittedUs = nowUs;
+    queued->topicLength = topicLength;
+    queued->messageLength = messageLength;
+    if( topicLength )
+    {
+        memcpy( queued->data, topic, topicLength );
+    }
+    if( messageLength )
+    {
+        memcpy( queued->data + topicLength, message, messageLength );
+    }
+
+    /* The message leaves once the link has serialized it behind every
+     * message before it. */
+    const AiaNetworkImpairmentProfile_t* profile = &impairment->profile;
+    uint64_t sentUs =
+        impairment->busyUntilUs > nowUs ? impairment->busyUntilUs : nowUs;
+    if( profile->bandwidthBytesPerSecond )
+    {
+        sentUs += ( (uint64_t)( topicLength + messageLength ) * 1000000 ) /
+                  profile->bandwidthBytesPerSecond;
+    }
+    impairment->busyUntilUs = sentUs;
+
+    uint64_t deliveryUs = sentUs + (uint64_t)profile->baseDelayMs * 1000 +
+                          AiaNetworkImpairment_DrawJitterUsLocked( impairment );
+    if( AiaNetworkImpairment_RollLocked( impairment,
+                                         profile->reorderPerMille ) )
+    {
+        deliveryUs += (uint64_t)profile->reorderDelayMs * 1000;
+        ++impairment->stats.reordered;
+    }
+    else
+    {
+        if( deliveryUs < impairment->lastDeliveryUs )
+        {
+            deliveryUs = impairment->lastDeliveryUs;
+        }
+        impairment->lastDeliveryUs = deliveryUs;
+    }
+    queued->deliveryUs = deliveryUs;
+
+    /* Insert after any messages due at the same time, so that they keep the
+     * order they were submitted in. */
+    AiaListDouble( Link_t )* link = NULL;
+    AiaListDouble( Link_t )* previous = NULL;
+    AiaListDouble( ForEach )( &impairment->messages, link )
+    {
+        if( ( (AiaNetworkImpairmentMessage_t*)link )->deliveryUs > deliveryUs )
+        {
+            break;
+        }
+        previous = link;
+    }
+    if( previous )
+    {
+        AiaListDouble( InsertAfter )( previous, &queued->link );
+    }
+    else
+    {
+        AiaListDouble( InsertHead )( &impairment->messages, &queued->link );
+    }
+    return true;
+}
+
+bool AiaNetworkImpairment_GetProfile( const char* name,
+                                      AiaNetworkImpairmentProfile_t* profile )
+{
+    if( !name || !profile )
+    {
+        AiaLogError( "Null %s.", name ? "profile" : "name" );
+        return false;
+    }
+    for( size_t i = 0; i < AiaArrayLength( AIA_NETWORK_IMPAIRMENT_PROFILES );
+         ++i )
+    {
+        if( !strcmp( name, AIA_NETWORK_IMPAIRMENT_PROFILES[ i ].name ) )
+        {
+            *profile = AIA_NETWORK_IMPAIRMENT_PROFILES[ i ].profile;
+            return true;
+        }
+    }
+    AiaLogError( "Unknown profile, name=%s", name );
+    return false;
+}
+
+AiaNetworkImpairment_t* AiaNetworkImpairment_Create(
+    const AiaNetworkImpairmentProfile_t* profile, uint32_t seed,
+    AiaNetworkImpairmentDeliverCallback_t deliver, void* deliverUserData )
+{
+    if( !profile )
+    {
+        AiaLogError( "Null profile." );
+        return NULL;
+    }
+    if( !deliver )
+    {
+        AiaLogError( "Null deliver." );
+        return NULL;
+    }
+    if( profile->lossPerMille > 1000 || profile->burstLossPerMille > 1000 ||
+        profile->duplicatePerMille > 1000 || profile->reorderPerMille > 1000 )
+    {
+        AiaLogError( "Invalid probability." );
+        return NULL;
+    }
+
+    AiaNetworkImpairment_t* impairment =
+        AiaCalloc( 1, sizeof( AiaNetworkImpairment_t ) );
+    if( !impairment )
+    {
+        AiaLogError( "AiaCalloc failed, bytes=%zu.",
+                     sizeof( AiaNetworkImpairment_t ) );
+        return NULL;
+    }
+    if( !AiaMutex( Create )( &impairment->mutex, false ) )
+    {
+        AiaLogError( "AiaMutex( Create ) failed." );
+        AiaFree( impairment );
+        return NULL;
+    }
+    AiaListDouble( Create )( &impairment->messages );
+
+    /* Small seeds start xorshift32 off with a run of small numbers, so the
+     * seed is mixed first. Zero would stick at zero and is avoided. */
+    uint32_t random = seed + 0x9e3779b9u;
+    random = ( random ^ ( random >> 16 ) ) * 0x85ebca6bu;
+    random = ( random ^ ( random >> 13 ) ) * 0xc2b2ae35u;
+    random ^= random >> 16;
+    impairment->random = random ? random : 1;
+    *(AiaNetworkImpairmentProfile_t*)&impairment->profile = *profile;
+    *(AiaNetworkImpairmentDeliverCallback_t*)&impairment->deliver = deliver;
+    *(void**)&impairment->deliverUserData = deliverUserData;
+    return impairment;
+}
+
+void AiaNetworkImpairment_Destroy( AiaNetworkImpairment_t* impairment )
+{
+    if( !impairment )
+    {
+        AiaLogDebug( "Null impairment." );
+        return;
+    }
+    AiaListDouble( Link_t )* link;
+    while( ( link = AiaListDouble( RemoveHead )( &impairment->messages ) ) )
+    {
+        AiaFree( link );
+    }
+    AiaMutex( Destroy )( &impairment->mutex );
+    AiaFree( impairment );
+}
+
+bool AiaNetworkImpairment_Submit( AiaNetworkImpairment_t* impairment,
+                                  AiaTimepointMs_t nowMs, const char* topic,
+                                  size_t topicLength, const void* message,
+                                  size_t messageLength )
+{
+    if( !impairment )
+    {
+        AiaLogError( "Null impairment." );
+        return false;
+    }
+    if( ( !topic && topicLength ) || ( !message && messageLength ) )
+    {
+        AiaLogError( "Null %s.", topic ? "message" : "topic" );
+        return false;
+    }
+
+    uint64_t nowUs = (uint64_t)nowMs * 1000;
+    bool success = true;
+    AiaMutex( Lock )( &impairment->mutex );
+    ++impairment->stats.submitted;
+    uint32_t lossPerMille = impairment->lastLost &&
+                                    impairment->profile.burstLossPerMille
+                                ? impairment->profile.burstLossPerMille
+                                : impairment->profile.lossPerMille;
+    impairment->lastLost =
+        AiaNetworkImpairment_RollLocked( impairment, lossPerMille );
+    if( impairment->lastLost )
+    {
+        ++impairment->stats.dropped;
+    }
+    else
+    {
+        success = AiaNetworkImpairment_QueueLocked(
+            impairment, nowUs, topic, topicLength, message, messageLength );
+        if( success &&
+            AiaNetworkImpairment_RollLocked(
+                impairment, impairment->profile.duplicatePerMille ) &&
+            AiaNetworkImpairment_QueueLocked( impairment, nowUs, topic,
+                                              topicLength, message,
+                                              messageLength ) )
+        {
+            ++impairment->stats.duplicated;
+        }
+    }
+    AiaMutex( Unlock )( &impairment->mutex );
+    return success;
+}
+
+size_t AiaNetworkImpairment_Poll( AiaNetworkImpairment_t* impairment,
+                                  AiaTimepointMs_t nowMs )
+{
+    if( !impairment )
+    {
+        AiaLogError( "Null impairment." );
+        return 0;
+    }
+
+    uint64_t nowUs = (uint64_t)nowMs * 1000;
+    size_t numDelivered = 0;
+    while( true )
+    {
+        AiaMutex( Lock )( &impairment->mutex );
+        AiaNetworkImpairmentMessage_t* message =
+            (AiaNetworkImpairmentMessage_t*)AiaListDouble( PeekHead )(
+                &impairment->messages );
+        if( !message || message->deliveryUs > nowUs )
+        {
+            AiaMutex( Unlock )( &impairment->mutex );
+            break;
+        }
+        AiaListDouble( Remove )( &message->link );
+        ++impairment->stats.delivered;
+        AiaDurationMs_t delayMs =
+            ( message->deliveryUs - message->submittedUs ) / 1000;
+        if( delayMs > impairment->stats.maxDelayMs )
+        {
+            impairment->stats.maxDelayMs = delayMs;
+        }
+        AiaMutex( Unlock )( &impairment->mutex );
+
+        impairment->deliver( (const char*)message->data, message->topicLength,
+                             message->data + message->topicLength,
+                             message->messageLength,
+                             impairment->deliverUserData );
+        AiaFree( message );
+        ++numDelivered;
+    }
+    return numDelivered;
+}
+
+bool AiaNetworkImpairment_GetNextDeliveryTime(
+    AiaNetworkImpairment_t* impairment, AiaTimepointMs_t* deliveryMs )
+{
+    if( !impairment || !deliveryMs )
+    {
+        AiaLogError( "Null %s.", impairment ? "deliveryMs" : "impairment" );
+        return false;
+    }
+    AiaMutex( Lock )( &impairment->mutex );
+    AiaNetworkImpairmentMessage_t* message =
+        (AiaNetworkImpairmentMessage_t*)AiaListDouble( PeekHead )(
+            &impairment->messages );
+    if( message )
+    {
+        /* Round up, so that polling at this time delivers the message. */
+        *deliveryMs = ( message->deliveryUs + 999 ) / 1000;
+    }
+    AiaMutex( Unlock )( &impairment->mutex );
+    return message != NULL;
+}
+
+void AiaNetworkImpairment_GetStats( AiaNetworkImpairment_t* impairment,
+                                    AiaNetworkImpairmentStats_t* stats )
+{
+    if( !impairment || !stats )
+    {
+        AiaLogError( "Null %s.", impairment ? "stats" : "impairment" );
+        return;
+    }
+    AiaMutex( Lock )( &impairment->mutex );
+    *stats = impairment->stats;
+    AiaMutex( Unlock )( &impairment->mutex );
+}
+
+void AiaNetworkImpairment_DeliverToMqttHandler( const char* topic,
+                                                size_t topicLength,
+                                                const void* message,
+                                                size_t messageLength,
+                                                void* userData )
+{
+    AiaNetworkImpairmentMqttHandler_t* mqttHandler = userData;
+    AiaAssert( mqttHandler );
+    if( !mqttHandler )
+    {
+        AiaLogError( "Null mqttHandler." );
+        return;
+    }
+
+    AiaMqttCallbackParam_t callbackParam;
+    memset( &callbackParam, 0, sizeof( callbackParam ) );
+    callbackParam.mqttConnection = mqttHandler->connection;
+    callbackParam.u.message.info.qos = AIA_MQTT_QOS0;
+    callbackParam.u.message.info.pTopicName = topic;
+    callbackParam.u.message.info.topicNameLength = topicLength;
+    callbackParam.u.message.info.pPayload = message;
+    callbackParam.u.message.info.payloadLength = messageLength;
+    mqttHandler->handler( mqttHandler->userData, &callbackParam );
+}
+
+void AiaNetworkImpairment_MessageReceivedCallback(
+    void* callbackArg, AiaMqttCallbackParam_t* callbackParam )
+{
+    AiaNetworkImpairment_t* impairment = callbackArg;
+    if( !callbackParam )
+    {
+        AiaLogError( "Null callbackParam." );
+        return;
+    }
+    AiaNetworkImpairment_Submit(
+        impairment, AiaClock( GetTimeMs )(),
+        callbackParam->u.message.info.pTopicName,
+        callbackParam->u.message.info.topicNameLength,
+        callbackParam->u.message.info.pPayload,
+        callbackParam->u.message.info.payloadLength );
+}